@@ -49,6 +49,9 @@ class RadioWizardConan(ConanFile):
       # DSP
       self.requires("liquid-dsp/1.6.0")
 
+      # Compression — spectrum frames sent over PubSub
+      self.requires("lz4/1.9.4")
+
       # Qt 6 — for RealTimeGraphs widget library
       self.requires("qt/6.10.1")
 
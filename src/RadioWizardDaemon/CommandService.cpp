@@ -0,0 +1,724 @@
+// Project headers
+#include "CommandService.h"
+#include "GeneralLogger.h"
+#include "HighBandwidthPublisher.h"
+#include "HighBandwidthSubscriber.h"
+
+// System headers
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* DEFAULT_NAME           = "RadioWizard";
+constexpr const char* DEFAULT_GROUP          = "239.192.1.2";
+constexpr int DEFAULT_PORT                   = 5671;
+constexpr const char* DEFAULT_COMMAND_TOPIC  = "Command";
+constexpr const char* DEFAULT_RESPONSE_TOPIC = "CommandResponse";
+constexpr std::size_t MIN_FFT_SIZE           = 16;
+constexpr std::size_t MAX_FFT_SIZE           = std::size_t{1} << 20;
+
+// Setting keys shared by CONFIGURE and QUERY.
+constexpr std::string_view KEY_CENTER_FREQUENCY = "center_frequency_hz";
+constexpr std::string_view KEY_SAMPLE_RATE      = "sample_rate_hz";
+constexpr std::string_view KEY_AUTO_GAIN        = "auto_gain";
+constexpr std::string_view KEY_GAIN             = "gain_tenths_db";
+constexpr std::string_view KEY_FFT_SIZE         = "fft_size";
+constexpr std::string_view KEY_FFT_OVERLAP      = "fft_overlap_percent";
+constexpr std::string_view KEY_SPECTRUM_RATE    = "spectrum_rate_hz";
+constexpr std::string_view KEY_FFT_AVERAGE      = "fft_average_alpha";
+constexpr std::string_view KEY_VFO_PREFIX       = "vfo.";
+constexpr std::string_view KEY_VFO_OFFSET       = "center_offset_hz";
+constexpr std::string_view KEY_VFO_BANDWIDTH    = "bandwidth_hz";
+constexpr std::string_view KEY_RUNNING          = "running";
+
+// START with mode "snapshot": initial_config keys.
+constexpr std::string_view MODE_SNAPSHOT        = "snapshot";
+constexpr std::string_view KEY_SNAPSHOT_PATH    = "path";
+constexpr std::string_view KEY_SNAPSHOT_FORMAT  = "format";
+constexpr std::string_view KEY_SNAPSHOT_PRE     = "pre_sec";
+constexpr std::string_view KEY_SNAPSHOT_POST    = "post_sec";
+
+// One VFO's part of a CONFIGURE command.
+struct VfoChange
+{
+   std::optional<double> centerOffsetHz;
+   std::optional<double> bandwidthHz;
+};
+
+// Everything a CONFIGURE command asks for, parsed before any of it is applied.
+struct Changes
+{
+   std::optional<uint64_t> centerFreqHz;
+   std::optional<uint32_t> sampleRateHz;
+   std::optional<bool> autoGain;
+   std::optional<int> gainTenthsDb;
+   std::optional<std::size_t> fftSize;
+   std::optional<float> fftOverlapPercent;
+   std::optional<float> spectrumRateHz;
+   std::optional<float> fftAverageAlpha;
+   std::map<std::size_t, VfoChange> vfos;
+};
+
+// Parse the whole of `text` as a number.
+template <typename T>
+bool parseNumber(std::string_view text, T& value)
+{
+   const char* end      = text.data() + text.size();
+   const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+   return !text.empty() && ec == std::errc{} && ptr == end;
+}
+
+bool parseBool(std::string_view text, bool& value)
+{
+   if (text == "true" || text == "1")
+   {
+      value = true;
+      return true;
+   }
+   if (text == "false" || text == "0")
+   {
+      value = false;
+      return true;
+   }
+   return false;
+}
+
+template <typename T>
+bool parseInto(std::string_view text, std::optional<T>& target)
+{
+   T value{};
+   if (!parseNumber(text, value))
+   {
+      return false;
+   }
+   target = value;
+   return true;
+}
+
+// parseInto() for floating-point settings: "nan" and "inf" parse, but are never valid.
+template <typename T>
+bool parseFinite(std::string_view text, std::optional<T>& target)
+{
+   return parseInto(text, target) && std::isfinite(*target);
+}
+
+// Parse "vfo.<n>.<field>" into `changes`.
+bool parseVfoSetting(std::string_view key, std::string_view value, std::size_t vfoCount,
+                     Changes& changes)
+{
+   key.remove_prefix(KEY_VFO_PREFIX.size());
+   const auto dot = key.find('.');
+   std::size_t index = 0;
+   if (dot == std::string_view::npos || !parseNumber(key.substr(0, dot), index) ||
+       index >= vfoCount)
+   {
+      return false;
+   }
+   const std::string_view field = key.substr(dot + 1);
+   VfoChange& change = changes.vfos[index];
+   if (field == KEY_VFO_OFFSET)
+   {
+      return parseFinite(value, change.centerOffsetHz);
+   }
+   if (field == KEY_VFO_BANDWIDTH)
+   {
+      return parseFinite(value, change.bandwidthHz) && *change.bandwidthHz > 0.0;
+   }
+   return false;
+}
+
+// Parse one CONFIGURE setting into `changes`; false if the key or value is invalid.
+bool parseSetting(std::string_view key, std::string_view value, std::size_t vfoCount,
+                  Changes& changes)
+{
+   if (key == KEY_CENTER_FREQUENCY)
+   {
+      return parseInto(value, changes.centerFreqHz) && *changes.centerFreqHz > 0;
+   }
+   if (key == KEY_SAMPLE_RATE)
+   {
+      return parseInto(value, changes.sampleRateHz) && *changes.sampleRateHz > 0;
+   }
+   if (key == KEY_AUTO_GAIN)
+   {
+      bool enabled = false;
+      if (!parseBool(value, enabled))
+      {
+         return false;
+      }
+      changes.autoGain = enabled;
+      return true;
+   }
+   if (key == KEY_GAIN)
+   {
+      return parseInto(value, changes.gainTenthsDb);
+   }
+   if (key == KEY_FFT_SIZE)
+   {
+      return parseInto(value, changes.fftSize) && std::has_single_bit(*changes.fftSize) &&
+             *changes.fftSize >= MIN_FFT_SIZE && *changes.fftSize <= MAX_FFT_SIZE;
+   }
+   if (key == KEY_FFT_OVERLAP)
+   {
+      return parseFinite(value, changes.fftOverlapPercent) && *changes.fftOverlapPercent >= 0.0F &&
+             *changes.fftOverlapPercent <= SdrEngine::SdrEngine::MAX_FFT_OVERLAP_PERCENT;
+   }
+   if (key == KEY_SPECTRUM_RATE)
+   {
+      return parseFinite(value, changes.spectrumRateHz) && *changes.spectrumRateHz >= 0.0F;
+   }
+   if (key == KEY_FFT_AVERAGE)
+   {
+      return parseFinite(value, changes.fftAverageAlpha) && *changes.fftAverageAlpha >= 0.0F &&
+             *changes.fftAverageAlpha < 1.0F;
+   }
+   if (key.starts_with(KEY_VFO_PREFIX))
+   {
+      return parseVfoSetting(key, value, vfoCount, changes);
+   }
+   return false;
+}
+
+std::string vfoKey(std::size_t index, std::string_view field)
+{
+   std::string key(KEY_VFO_PREFIX);
+   key += std::to_string(index);
+   key += '.';
+   key += field;
+   return key;
+}
+
+int64_t microsecondsBetween(Clock::time_point from, Clock::time_point to)
+{
+   return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+int64_t systemTimeMs()
+{
+   return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void setFailure(messages::CommandResponse& response, messages::ResponseStatus status,
+                const std::string& message)
+{
+   response.set_success(false);
+   response.set_status(status);
+   response.set_message(message);
+   response.mutable_error()->set_category(messages::ResponseStatus_Name(status));
+   response.mutable_error()->set_details(message);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+CommandService::CommandService(SdrEngine::SdrEngine& engine, std::vector<int> vfoIds,
+                               messages::ControlSettings settings)
+   : _engine{engine},
+     _vfoIds{std::move(vfoIds)},
+     _settings{std::move(settings)},
+     _responseTopic{_settings.response_topic().empty() ? DEFAULT_RESPONSE_TOPIC
+                                                        : _settings.response_topic()}
+{
+}
+
+CommandService::~CommandService()
+{
+   stop();
+}
+
+// ============================================================================
+// Start / stop
+// ============================================================================
+
+bool CommandService::start()
+{
+   stop();
+
+   const std::string name  = _settings.name().empty() ? DEFAULT_NAME : _settings.name();
+   const std::string group =
+      _settings.multicast_group().empty() ? DEFAULT_GROUP : _settings.multicast_group();
+   const auto port =
+      static_cast<uint16_t>((_settings.port() > 0) ? _settings.port() : DEFAULT_PORT);
+   const std::string commandTopic =
+      _settings.command_topic().empty() ? DEFAULT_COMMAND_TOPIC : _settings.command_topic();
+
+   {
+      const std::lock_guard<std::mutex> lock(_statsMutex);
+      _stats = {};
+   }
+
+   _publisher = std::make_unique<HighBandwidthPublisher>(name, group, port, 1400,
+                                                         _settings.interface_address());
+   _subscriber = std::make_unique<HighBandwidthSubscriber>(name, group, port, 1000,
+                                                           _settings.interface_address());
+   // Commands are applied on the receive thread: no queue between a retune
+   // and the device.
+   _subscriber->subscribeView(commandTopic,
+                              [this](std::string_view /*topic*/, std::string_view data)
+                              {
+                                 onCommand(data);
+                              });
+   if (!_subscriber->start())
+   {
+      GPERROR("Command service could not join {}:{}", group, port);
+      _subscriber.reset();
+      _publisher.reset();
+      return false;
+   }
+
+   // Only the newest block matters to the effect check; never hold up the engine.
+   _iqListenerId = _engine.iqDataHandler().registerListener(
+      [this](const std::shared_ptr<const SdrEngine::IqBuffer>& buffer)
+      {
+         if (buffer)
+         {
+            onIqBuffer(*buffer);
+         }
+      },
+      CommonUtils::ListenerOptions{CommonUtils::DispatchMode::DedicatedThread,
+                                   CommonUtils::OverflowPolicy::LatestOnly, 1, nullptr});
+
+   GPINFO("Accepting commands on {}:{} topic \"{}\", answering on \"{}\"", group, port,
+          commandTopic, _responseTopic);
+   return true;
+}
+
+void CommandService::stop()
+{
+   if (_subscriber)
+   {
+      _subscriber->stop();
+   }
+   if (_iqListenerId >= 0)
+   {
+      _engine.iqDataHandler().unregisterListener(_iqListenerId);
+      _iqListenerId = -1;
+   }
+   {
+      const std::lock_guard<std::mutex> lock(_pendingMutex);
+      finishPendingLocked(messages::RESPONSE_STATUS_ACCEPTED,
+                          "Applied; the service stopped before the retune showed", Clock::now());
+   }
+   _subscriber.reset();
+   _publisher.reset();
+}
+
+CommandService::Stats CommandService::stats() const
+{
+   const std::lock_guard<std::mutex> lock(_statsMutex);
+   return _stats;
+}
+
+// ============================================================================
+// Commands
+// ============================================================================
+
+void CommandService::onCommand(std::string_view data)
+{
+   const auto received = Clock::now();
+
+   messages::Command command;
+   if (!command.ParseFromArray(data.data(), static_cast<int>(data.size())))
+   {
+      GPWARN("Discarded a command that does not parse ({} bytes)", data.size());
+      const std::lock_guard<std::mutex> lock(_statsMutex);
+      ++_stats.rejected;
+      return;
+   }
+   if (!_settings.target().empty() && !command.target().empty() &&
+       command.target() != _settings.target())
+   {
+      const std::lock_guard<std::mutex> lock(_statsMutex);
+      ++_stats.ignored;
+      return;
+   }
+
+   const std::lock_guard<std::mutex> commandLock(_commandMutex);
+   {
+      // One retune is measured at a time; a newer command supersedes it.
+      const std::lock_guard<std::mutex> lock(_pendingMutex);
+      finishPendingLocked(messages::RESPONSE_STATUS_ACCEPTED,
+                          "Applied; superseded before the retune showed", received);
+   }
+
+   messages::CommandResponse response;
+   response.set_command_id(command.command_id());
+   response.set_success(true);
+   response.set_status(messages::RESPONSE_STATUS_OK);
+   if (command.issued_at_ms() > 0)
+   {
+      (*response.mutable_result_data())["transit_ms"] =
+         std::to_string(systemTimeMs() - command.issued_at_ms());
+   }
+
+   bool retuned = false;
+   switch (command.type())
+   {
+   case messages::COMMAND_TYPE_CONFIGURE:
+      retuned = configure(command, response);
+      break;
+   case messages::COMMAND_TYPE_QUERY:
+      query(command, response);
+      break;
+   case messages::COMMAND_TYPE_START:
+      snapshot(command, response);
+      break;
+   default:
+      setFailure(response, messages::RESPONSE_STATUS_INVALID,
+                 "Unsupported command type " + messages::CommandType_Name(command.type()));
+      break;
+   }
+
+   const int64_t applyUs = microsecondsBetween(received, Clock::now());
+   (*response.mutable_result_data())["apply_us"] = std::to_string(applyUs);
+   response.set_execution_time_ms(applyUs / 1000);
+   {
+      const std::lock_guard<std::mutex> lock(_statsMutex);
+      ++_stats.commands;
+      _stats.rejected += response.success() ? 0U : 1U;
+      _stats.lastApplyUs = applyUs;
+      _stats.maxApplyUs  = std::max(_stats.maxApplyUs, applyUs);
+   }
+   if (!response.success())
+   {
+      GPWARN("Command {} rejected: {}", command.command_id(), response.message());
+   }
+
+   if (retuned)
+   {
+      // Answered by onIqBuffer() once the new tuning reaches the stream.
+      auto pending          = std::make_unique<PendingRetune>();
+      pending->response     = std::move(response);
+      pending->received     = received;
+      pending->deadline     = received + ((command.timeout_ms() > 0)
+                                             ? std::chrono::milliseconds(command.timeout_ms())
+                                             : DEFAULT_EFFECT_TIMEOUT);
+      pending->centerFreqHz = static_cast<double>(_engine.getCenterFrequency());
+      pending->sampleRateHz = static_cast<double>(_engine.getSampleRate());
+      const std::lock_guard<std::mutex> lock(_pendingMutex);
+      _pending = std::move(pending);
+      _hasPending.store(true, std::memory_order_release);
+      return;
+   }
+   reply(response);
+}
+
+bool CommandService::configure(const messages::Command& command,
+                               messages::CommandResponse& response)
+{
+   if (!command.has_configure_params())
+   {
+      setFailure(response, messages::RESPONSE_STATUS_INVALID, "configure_params missing");
+      return false;
+   }
+
+   // Validate everything first, so a bad command leaves the engine untouched.
+   Changes changes;
+   for (const auto& [key, value] : command.configure_params().settings())
+   {
+      if (!parseSetting(key, value, _vfoIds.size(), changes))
+      {
+         setFailure(response, messages::RESPONSE_STATUS_INVALID,
+                    "Invalid setting " + key + "=\"" + value + "\"");
+         return false;
+      }
+   }
+   // A VFO offset must stay inside the band the new (or current) rate covers.
+   const double nyquistHz =
+      static_cast<double>(changes.sampleRateHz.value_or(_engine.getSampleRate())) / 2.0;
+   for (const auto& [index, change] : changes.vfos)
+   {
+      if (change.centerOffsetHz && std::abs(*change.centerOffsetHz) > nyquistHz)
+      {
+         setFailure(response, messages::RESPONSE_STATUS_INVALID,
+                    vfoKey(index, KEY_VFO_OFFSET) + " is outside +/-" +
+                       std::to_string(nyquistHz) + " Hz");
+         return false;
+      }
+   }
+
+   std::string rejected;
+   const auto check = [&rejected](bool accepted, std::string_view key)
+   {
+      if (!accepted)
+      {
+         rejected += rejected.empty() ? "" : ", ";
+         rejected += key;
+      }
+   };
+
+   // The rate goes first so VFOs and the retune check see the final rate.
+   if (changes.sampleRateHz)
+   {
+      check(_engine.setSampleRate(*changes.sampleRateHz), KEY_SAMPLE_RATE);
+   }
+   if (changes.centerFreqHz)
+   {
+      check(_engine.setCenterFrequency(*changes.centerFreqHz), KEY_CENTER_FREQUENCY);
+   }
+   if (changes.autoGain)
+   {
+      check(_engine.setAutoGain(*changes.autoGain), KEY_AUTO_GAIN);
+   }
+   if (changes.gainTenthsDb)
+   {
+      check(_engine.setGain(*changes.gainTenthsDb), KEY_GAIN);
+   }
+   if (changes.fftSize)
+   {
+      _engine.setFftSize(*changes.fftSize);
+   }
+   if (changes.fftOverlapPercent)
+   {
+      _engine.setFftOverlapPercent(*changes.fftOverlapPercent);
+   }
+   if (changes.spectrumRateHz)
+   {
+      _engine.setSpectrumOutputRate(*changes.spectrumRateHz);
+   }
+   if (changes.fftAverageAlpha)
+   {
+      _engine.setFftAverageAlpha(*changes.fftAverageAlpha);
+   }
+
+   // A new rate reconfigures every VFO's filter, tuned or not.
+   const auto inputRate = static_cast<double>(_engine.getSampleRate());
+   for (std::size_t n = 0; n < _vfoIds.size(); ++n)
+   {
+      const auto change = changes.vfos.find(n);
+      if (change == changes.vfos.end() && !changes.sampleRateHz)
+      {
+         continue;
+      }
+      const auto vfo = _engine.vfo(_vfoIds[n]);
+      if (!vfo)
+      {
+         check(false, vfoKey(n, KEY_VFO_OFFSET));
+         continue;
+      }
+      double offsetHz    = vfo->getCenterOffset();
+      double bandwidthHz = vfo->getBandwidth();
+      if (change != changes.vfos.end())
+      {
+         offsetHz    = change->second.centerOffsetHz.value_or(offsetHz);
+         bandwidthHz = change->second.bandwidthHz.value_or(bandwidthHz);
+      }
+      vfo->configure(offsetHz, bandwidthHz, inputRate);
+   }
+
+   if (!rejected.empty())
+   {
+      setFailure(response, messages::RESPONSE_STATUS_FAILED, "Device rejected " + rejected);
+      return false;
+   }
+   return (changes.centerFreqHz || changes.sampleRateHz) && _engine.isRunning();
+}
+
+void CommandService::snapshot(const messages::Command& command,
+                              messages::CommandResponse& response)
+{
+   if (command.start_params().mode() != MODE_SNAPSHOT)
+   {
+      setFailure(response, messages::RESPONSE_STATUS_INVALID,
+                 "Unsupported start mode \"" + command.start_params().mode() + "\"");
+      return;
+   }
+
+   SdrEngine::SnapshotRequest request;
+   for (const auto& [key, value] : command.start_params().initial_config())
+   {
+      bool valid = true;
+      if (key == KEY_SNAPSHOT_PATH)
+      {
+         request.path = value;
+      }
+      else if (key == KEY_SNAPSHOT_FORMAT)
+      {
+         valid = value == "sigmf" || value == "raw" || value == "vita49";
+         request.format = (value == "raw")      ? SdrEngine::RecordingFormat::Raw
+                          : (value == "vita49") ? SdrEngine::RecordingFormat::Vita49
+                                                : SdrEngine::RecordingFormat::SigMf;
+      }
+      else if (key == KEY_SNAPSHOT_PRE)
+      {
+         valid = parseNumber(value, request.preSec) && std::isfinite(request.preSec) &&
+                 request.preSec >= 0.0;
+      }
+      else if (key == KEY_SNAPSHOT_POST)
+      {
+         valid = parseNumber(value, request.postSec) && std::isfinite(request.postSec) &&
+                 request.postSec >= 0.0;
+      }
+      else
+      {
+         valid = false;
+      }
+      if (!valid)
+      {
+         setFailure(response, messages::RESPONSE_STATUS_INVALID,
+                    "Invalid snapshot setting " + key + "=\"" + value + "\"");
+         return;
+      }
+   }
+   if (request.path.empty())
+   {
+      setFailure(response, messages::RESPONSE_STATUS_INVALID, "Snapshot path missing");
+      return;
+   }
+
+   if (!_engine.triggerSnapshot(request))
+   {
+      setFailure(response, messages::RESPONSE_STATUS_FAILED,
+                 "Snapshot refused (engine stopped, no history, or too many pending)");
+      return;
+   }
+   // The file is complete `post_sec` from now.
+   response.set_status(messages::RESPONSE_STATUS_ACCEPTED);
+   (*response.mutable_result_data())[std::string(KEY_SNAPSHOT_PATH)] = request.path;
+}
+
+void CommandService::query(const messages::Command& command,
+                           messages::CommandResponse& response) const
+{
+   std::map<std::string, std::string> values{
+      {std::string(KEY_CENTER_FREQUENCY), std::to_string(_engine.getCenterFrequency())},
+      {std::string(KEY_SAMPLE_RATE), std::to_string(_engine.getSampleRate())},
+      {std::string(KEY_GAIN), std::to_string(_engine.getGain())},
+      {std::string(KEY_FFT_SIZE), std::to_string(_engine.getFftSize())},
+      {std::string(KEY_FFT_OVERLAP), std::to_string(_engine.getFftOverlapPercent())},
+      {std::string(KEY_SPECTRUM_RATE), std::to_string(_engine.getSpectrumOutputRate())},
+      {std::string(KEY_FFT_AVERAGE), std::to_string(_engine.getFftAverageAlpha())},
+      {std::string(KEY_RUNNING), _engine.isRunning() ? "true" : "false"},
+   };
+   for (std::size_t n = 0; n < _vfoIds.size(); ++n)
+   {
+      if (const auto vfo = _engine.vfo(_vfoIds[n]))
+      {
+         values[vfoKey(n, KEY_VFO_OFFSET)]    = std::to_string(vfo->getCenterOffset());
+         values[vfoKey(n, KEY_VFO_BANDWIDTH)] = std::to_string(vfo->getBandwidth());
+      }
+   }
+
+   auto& result = *response.mutable_result_data();
+   const auto& fields = command.query_params().query_fields();
+   if (fields.empty())
+   {
+      result.insert(values.begin(), values.end());
+      return;
+   }
+   std::string unknown;
+   for (const auto& field : fields)
+   {
+      const auto it = values.find(field);
+      if (it == values.end())
+      {
+         unknown += unknown.empty() ? "" : ", ";
+         unknown += field;
+         continue;
+      }
+      result[it->first] = it->second;
+   }
+   if (!unknown.empty())
+   {
+      setFailure(response, messages::RESPONSE_STATUS_NOT_FOUND, "Unknown fields " + unknown);
+   }
+}
+
+// ============================================================================
+// Retune effect
+// ============================================================================
+
+void CommandService::onIqBuffer(const SdrEngine::IqBuffer& buffer)
+{
+   if (!_hasPending.load(std::memory_order_acquire))
+   {
+      return;
+   }
+   const auto now = Clock::now();
+   const std::lock_guard<std::mutex> lock(_pendingMutex);
+   if (!_pending)
+   {
+      return;
+   }
+   if (buffer.centerFreqHz == _pending->centerFreqHz &&
+       buffer.sampleRateHz == _pending->sampleRateHz)
+   {
+      finishPendingLocked(messages::RESPONSE_STATUS_OK, {}, now);
+   }
+   else if (now >= _pending->deadline)
+   {
+      finishPendingLocked(messages::RESPONSE_STATUS_TIMEOUT,
+                          "Applied, but no I/Q at the new tuning within the timeout", now);
+   }
+}
+
+void CommandService::finishPendingLocked(messages::ResponseStatus status,
+                                         const std::string& message, Clock::time_point now)
+{
+   if (!_pending)
+   {
+      return;
+   }
+   auto& response = _pending->response;
+   const int64_t effectUs = microsecondsBetween(_pending->received, now);
+   if (status == messages::RESPONSE_STATUS_OK)
+   {
+      (*response.mutable_result_data())["effect_us"] = std::to_string(effectUs);
+      response.set_execution_time_ms(effectUs / 1000);
+      const bool overTarget = effectUs > RETUNE_TARGET.count();
+      {
+         const std::lock_guard<std::mutex> lock(_statsMutex);
+         ++_stats.retunes;
+         _stats.retunesOverTarget += overTarget ? 1U : 0U;
+         _stats.lastEffectUs = effectUs;
+         _stats.maxEffectUs  = std::max(_stats.maxEffectUs, effectUs);
+         _stats.totalEffectUs += effectUs;
+      }
+      if (overTarget)
+      {
+         GPWARN("Retune {} took {} us to show (target {} us)", response.command_id(), effectUs,
+                RETUNE_TARGET.count());
+      }
+   }
+   else if (status == messages::RESPONSE_STATUS_TIMEOUT)
+   {
+      setFailure(response, status, message);
+      const std::lock_guard<std::mutex> lock(_statsMutex);
+      ++_stats.effectTimeouts;
+   }
+   else
+   {
+      // Applied, but the effect was not measured.
+      response.set_status(status);
+      response.set_message(message);
+   }
+
+   reply(response);
+   _pending.reset();
+   _hasPending.store(false, std::memory_order_release);
+}
+
+void CommandService::reply(messages::CommandResponse& response)
+{
+   response.set_responded_at_ms(systemTimeMs());
+   if (_publisher && !_publisher->publish(_responseTopic, response))
+   {
+      GPWARN("Response to command {} not sent", response.command_id());
+   }
+}
@@ -0,0 +1,179 @@
+#ifndef COMMANDSERVICE_H_
+#define COMMANDSERVICE_H_
+
+// Project headers
+#include "SdrEngine.h"
+#include "commands.pb.h"
+#include "configuration.pb.h"
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class HighBandwidthPublisher;
+class HighBandwidthSubscriber;
+
+/**
+ * @class CommandService
+ * @brief Remote control of a running SdrEngine over PubSub (commands.proto).
+ *
+ * Commands arrive on the control group's command topic and are applied on
+ * the subscriber's receive thread, straight into the engine's setters, so
+ * the stream never stops.  Every command addressed to this daemon gets one
+ * CommandResponse on the response topic, carrying the command's id.
+ *
+ * Supported commands:
+ *   - COMMAND_TYPE_CONFIGURE — `configure_params.settings`, keys:
+ *       center_frequency_hz, sample_rate_hz, auto_gain, gain_tenths_db,
+ *       fft_size, fft_overlap_percent, spectrum_rate_hz, fft_average_alpha,
+ *       vfo.<n>.center_offset_hz, vfo.<n>.bandwidth_hz
+ *     (n = VFO index in configuration order).  Every value is parsed before
+ *     anything is applied, so a malformed command changes nothing.
+ *   - COMMAND_TYPE_QUERY — the same keys in `result_data` (all of them, or
+ *     those listed in `query_params.query_fields`).
+ *   - COMMAND_TYPE_START with `start_params.mode` "snapshot" — write the
+ *     I/Q around now to a file (SdrEngine::triggerSnapshot()), keys in
+ *     `start_params.initial_config`: path (required), format (sigmf, raw or
+ *     vita49), pre_sec, post_sec.  Answered with RESPONSE_STATUS_ACCEPTED
+ *     while the file is still being written.
+ *
+ * Latency: `result_data["apply_us"]` is the time from receipt to the last
+ * setter returning.  A retune (centre frequency or sample rate) is only
+ * answered once the first I/Q block at the new tuning leaves the engine;
+ * `result_data["effect_us"]` is then the command-to-effect time, which
+ * should stay below RETUNE_TARGET.  A retune that shows no effect within
+ * the command's timeout (DEFAULT_EFFECT_TIMEOUT if none) is answered with
+ * RESPONSE_STATUS_TIMEOUT.
+ *
+ * Thread-safety: start() / stop() / stats() from any thread.
+ */
+class CommandService
+{
+public:
+   /// Command-to-effect time a retune should stay within.
+   static constexpr std::chrono::microseconds RETUNE_TARGET{10'000};
+
+   /// How long a retune may take to show before it is answered with a timeout.
+   static constexpr std::chrono::milliseconds DEFAULT_EFFECT_TIMEOUT{1'000};
+
+   /**
+    * @class Stats
+    * @brief Command counters and latencies since start().
+    */
+   struct Stats
+   {
+      uint64_t commands{0};          ///< Commands addressed to this daemon.
+      uint64_t ignored{0};           ///< Commands for another target.
+      uint64_t rejected{0};          ///< Unparsable, invalid or failed commands.
+      uint64_t retunes{0};           ///< Retunes whose effect was seen.
+      uint64_t retunesOverTarget{0}; ///< ... of which slower than RETUNE_TARGET.
+      uint64_t effectTimeouts{0};    ///< Retunes answered with a timeout.
+      int64_t lastApplyUs{0};        ///< Receipt to applied, newest command.
+      int64_t maxApplyUs{0};
+      int64_t lastEffectUs{0};       ///< Receipt to first retuned I/Q block.
+      int64_t maxEffectUs{0};
+      int64_t totalEffectUs{0};      ///< Sum over `retunes`.
+
+      /**
+       * @brief Get the mean command-to-effect time of the retunes.
+       * @return Mean in microseconds, or 0 before the first retune.
+       */
+      [[nodiscard]] double meanEffectUs() const
+      {
+         return (retunes > 0) ? static_cast<double>(totalEffectUs) / static_cast<double>(retunes)
+                              : 0.0;
+      }
+   };
+
+   /**
+    * @brief Construct an idle service.
+    * @param engine    Engine to control; must outlive the service.
+    * @param vfoIds    Engine ids of the VFOs, in configuration order.
+    * @param settings  Control group, topics and target.
+    */
+   CommandService(SdrEngine::SdrEngine& engine, std::vector<int> vfoIds,
+                  messages::ControlSettings settings);
+
+   /** @brief Stop receiving commands. */
+   ~CommandService();
+
+   // Non-copyable, non-movable (the subscriber and engine hold callbacks).
+   CommandService(const CommandService&) = delete;
+   CommandService& operator=(const CommandService&) = delete;
+   CommandService(CommandService&&) = delete;
+   CommandService& operator=(CommandService&&) = delete;
+
+   /**
+    * @brief Join the control group and start accepting commands.
+    * @return true if the subscriber started.
+    */
+   [[nodiscard]] bool start();
+
+   /** @brief Stop accepting commands; a retune still waiting is answered. */
+   void stop();
+
+   /**
+    * @brief Get the command counters.
+    * @return Counters since start().
+    */
+   [[nodiscard]] Stats stats() const;
+
+private:
+   // A retune waiting for the first I/Q block at the new tuning.
+   struct PendingRetune
+   {
+      messages::CommandResponse response;
+      std::chrono::steady_clock::time_point received;
+      std::chrono::steady_clock::time_point deadline;
+      double centerFreqHz{0.0};
+      double sampleRateHz{0.0};
+   };
+
+   // Parse and execute one serialized Command (receive thread).
+   void onCommand(std::string_view data);
+
+   // Apply a CONFIGURE command; true if it retuned the device.
+   bool configure(const messages::Command& command, messages::CommandResponse& response);
+
+   // Trigger a snapshot for a START command.
+   void snapshot(const messages::Command& command, messages::CommandResponse& response);
+
+   // Fill the requested QUERY fields.
+   void query(const messages::Command& command, messages::CommandResponse& response) const;
+
+   // Watch the I/Q stream for the pending retune (engine listener thread).
+   void onIqBuffer(const SdrEngine::IqBuffer& buffer);
+
+   // Answer the pending retune, if any.  Caller holds _pendingMutex.
+   void finishPendingLocked(messages::ResponseStatus status, const std::string& message,
+                            std::chrono::steady_clock::time_point now);
+
+   // Stamp and publish a response.
+   void reply(messages::CommandResponse& response);
+
+   SdrEngine::SdrEngine& _engine;
+   const std::vector<int> _vfoIds;
+   const messages::ControlSettings _settings;
+   std::string _responseTopic;
+
+   std::unique_ptr<HighBandwidthPublisher> _publisher;
+   std::unique_ptr<HighBandwidthSubscriber> _subscriber;
+   int _iqListenerId{-1};
+
+   std::mutex _commandMutex;                // Serialises command execution.
+
+   std::mutex _pendingMutex;
+   std::unique_ptr<PendingRetune> _pending; // Guarded by _pendingMutex.
+   std::atomic<bool> _hasPending{false};    // Lets the I/Q listener skip the lock.
+
+   mutable std::mutex _statsMutex;
+   Stats _stats;                            // Guarded by _statsMutex.
+};
+
+#endif // COMMANDSERVICE_H_
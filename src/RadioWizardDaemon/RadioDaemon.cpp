@@ -0,0 +1,392 @@
+// Project headers
+#include "RadioDaemon.h"
+#include "FftProcessor.h"
+#include "GeneralLogger.h"
+#include "HighBandwidthPublisher.h"
+#include "MemoryBudget.h"
+
+// Third-party headers
+#include <google/protobuf/text_format.h>
+
+// System headers
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+
+SdrEngine::RecordingFormat toRecordingFormat(messages::RecordingFileFormat format)
+{
+   switch (format)
+   {
+   case messages::RECORDING_FILE_FORMAT_RAW:
+      return SdrEngine::RecordingFormat::Raw;
+   case messages::RECORDING_FILE_FORMAT_VITA49:
+      return SdrEngine::RecordingFormat::Vita49;
+   default:
+      return SdrEngine::RecordingFormat::SigMf;
+   }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+RadioDaemon::RadioDaemon(messages::SdrDaemonConfig config)
+   : _config{std::move(config)}
+{
+}
+
+RadioDaemon::~RadioDaemon()
+{
+   stop();
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+bool RadioDaemon::loadConfig(const std::string& path, messages::ApplicationConfig& config,
+                             std::string* error)
+{
+   std::ifstream file(path);
+   if (!file)
+   {
+      if (error != nullptr)
+      {
+         *error = "cannot open " + path;
+      }
+      return false;
+   }
+   std::ostringstream text;
+   text << file.rdbuf();
+   if (!google::protobuf::TextFormat::ParseFromString(text.str(), &config))
+   {
+      if (error != nullptr)
+      {
+         *error = "cannot parse " + path + " as a text-format ApplicationConfig";
+      }
+      return false;
+   }
+   return true;
+}
+
+void RadioDaemon::configureEngine()
+{
+   if (!_config.fftw_wisdom_path().empty())
+   {
+      std::ignore = SdrEngine::FftProcessor::loadWisdom(_config.fftw_wisdom_path());
+   }
+   for (const auto& [account, bytes] : _config.memory_budgets())
+   {
+      CommonUtils::MemoryRegistry::instance().setBudget(account, static_cast<size_t>(bytes));
+   }
+   switch (_config.fft_backend())
+   {
+   case messages::FFT_BACKEND_FFTW:
+      _engine.setFftBackend(SdrEngine::FftBackend::Fftw);
+      break;
+   case messages::FFT_BACKEND_BUILTIN:
+      _engine.setFftBackend(SdrEngine::FftBackend::Builtin);
+      break;
+   default:
+      _engine.setFftBackend(SdrEngine::FftBackend::Auto);
+      break;
+   }
+   if (_config.center_frequency_hz() != 0)
+   {
+      std::ignore = _engine.setCenterFrequency(_config.center_frequency_hz());
+   }
+   if (_config.sample_rate_hz() != 0)
+   {
+      std::ignore = _engine.setSampleRate(_config.sample_rate_hz());
+   }
+   if (_config.fft_size() != 0)
+   {
+      _engine.setFftSize(_config.fft_size());
+   }
+   _engine.setFftOverlapPercent(_config.fft_overlap_percent());
+   _engine.setSpectrumOutputRate(_config.spectrum_rate_hz());
+   _engine.setFftAverageAlpha(_config.fft_average_alpha());
+   if (_config.load_control_target() > 0.0F)
+   {
+      SdrEngine::FftLoadConfig loadControl;
+      loadControl.targetUtilization = _config.load_control_target();
+      _engine.setLoadControlConfig(loadControl);
+      _engine.setLoadControlEnabled(true);
+   }
+
+   if (_config.channelizer_channels() != 0)
+   {
+      if (_engine.configureChannelizer(_config.channelizer_channels()))
+      {
+         _engine.setChannelizerEnabled(true);
+      }
+      else
+      {
+         GPERROR("Channelizer with {} channels rejected", _config.channelizer_channels());
+      }
+   }
+
+   for (const auto& vfo : _config.vfos())
+   {
+      _vfoIds.push_back(_engine.addVfo(vfo.center_offset_hz(), vfo.bandwidth_hz()));
+   }
+
+   _engine.setSampleRingStorage(_config.sample_ring_cs16() ? SdrEngine::IqStorage::Cs16
+                                                           : SdrEngine::IqStorage::Cf32);
+   _engine.configureSnapshots(_config.snapshot().history_sec(),
+                              _config.snapshot().cs16() ? SdrEngine::SnapshotStorage::Cs16
+                                                        : SdrEngine::SnapshotStorage::Cf32);
+}
+
+// ============================================================================
+// Start / stop
+// ============================================================================
+
+bool RadioDaemon::start(std::unique_ptr<SdrEngine::ISdrDevice> device)
+{
+   if (_engine.isRunning())
+   {
+      GPWARN("RadioDaemon already running");
+      return false;
+   }
+
+   configureEngine();
+   _engine.setDevice(std::move(device));
+   if (!_engine.start(_config.device_index()))
+   {
+      GPERROR("Failed to start the SDR pipeline on device {}", _config.device_index());
+      return false;
+   }
+
+   // Gain is applied to the open device.
+   if (_config.auto_gain())
+   {
+      std::ignore = _engine.setAutoGain(true);
+   }
+   else if (_config.gain_tenths_db() != 0)
+   {
+      std::ignore = _engine.setAutoGain(false);
+      std::ignore = _engine.setGain(_config.gain_tenths_db());
+   }
+
+   startStreaming();
+   startRecordings();
+   startCommands();
+   GPINFO("RadioDaemon running: {:.6f} MHz, {} S/s, FFT {}, {} channels, {} VFOs, "
+          "{} recordings",
+          _engine.getCenterFrequencyMHz(), _engine.getSampleRate(), _engine.getFftSize(),
+          _engine.getChannelizerChannelCount(), _vfoIds.size(), _recorders.size());
+   return true;
+}
+
+void RadioDaemon::stop()
+{
+   // Detach the consumers first so no frame is in flight when the engine stops.
+   if (_commands)
+   {
+      _commands->stop();
+   }
+   _commands.reset();
+   for (auto& recorder : _recorders)
+   {
+      recorder->detach();
+      recorder->stop();
+   }
+   _recorders.clear();
+   if (_bridge)
+   {
+      _bridge->detachAll();
+   }
+   _bridge.reset();
+   _publisher.reset();
+
+   if (_engine.isRunning())
+   {
+      _engine.stop();
+      if (!_config.fftw_wisdom_path().empty() &&
+          !SdrEngine::FftProcessor::saveWisdom(_config.fftw_wisdom_path()))
+      {
+         GPWARN("Could not save FFTW wisdom to {}", _config.fftw_wisdom_path());
+      }
+   }
+   for (const int id : _vfoIds)
+   {
+      std::ignore = _engine.removeVfo(id);
+   }
+   _vfoIds.clear();
+}
+
+bool RadioDaemon::isRunning() const
+{
+   return _engine.isRunning();
+}
+
+SdrEngine::SdrEngine& RadioDaemon::engine()
+{
+   return _engine;
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+void RadioDaemon::startStreaming()
+{
+   const auto& streaming = _config.streaming();
+   if (!streaming.enabled())
+   {
+      return;
+   }
+
+   const std::string name = streaming.name().empty() ? "RadioWizard" : streaming.name();
+   const std::string group =
+      streaming.multicast_group().empty() ? "239.192.1.1" : streaming.multicast_group();
+   const auto port = static_cast<uint16_t>((streaming.port() > 0) ? streaming.port() : 5670);
+   _publisher = std::make_unique<HighBandwidthPublisher>(name, group, port, 1400,
+                                                         streaming.interface_address());
+
+   SdrStreaming::BridgeOptions options;
+   if (streaming.max_spectrum_rate_hz() > 0.0)
+   {
+      options.maxSpectrumRateHz = streaming.max_spectrum_rate_hz();
+   }
+   if (streaming.iq_cf32())
+   {
+      options.iqEncoding = messages::IQ_ENCODING_CF32;
+   }
+   _bridge = std::make_unique<SdrStreaming::SdrPubSubBridge>(*_publisher, options);
+
+   if (!streaming.spectrum_topic().empty())
+   {
+      _bridge->attachSpectrum(_engine.spectrumDataHandler(), streaming.spectrum_topic());
+   }
+   if (!streaming.iq_topic().empty())
+   {
+      _bridge->attachIq(_engine.iqDataHandler(), streaming.iq_topic());
+   }
+   if (!streaming.channel_topic_prefix().empty())
+   {
+      for (std::size_t c = 0; c < _engine.getChannelizerChannelCount(); ++c)
+      {
+         _bridge->attachIq(_engine.channelizerDataHandler(c),
+                           streaming.channel_topic_prefix() + std::to_string(c));
+      }
+   }
+   if (!streaming.vfo_topic_prefix().empty())
+   {
+      for (std::size_t n = 0; n < _vfoIds.size(); ++n)
+      {
+         _bridge->attachIq(_engine.vfo(_vfoIds[n])->iqDataHandler(),
+                           streaming.vfo_topic_prefix() + std::to_string(n));
+      }
+   }
+   GPINFO("Streaming on {}:{} as \"{}\"", group, port, name);
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+CommonUtils::DataHandler<std::shared_ptr<const SdrEngine::IqBuffer>>* RadioDaemon::recordingSource(
+   const messages::RecordingSettings& recording)
+{
+   switch (recording.source())
+   {
+   case messages::RECORDING_SOURCE_CHANNEL:
+      if (recording.index() < _engine.getChannelizerChannelCount())
+      {
+         return &_engine.channelizerDataHandler(recording.index());
+      }
+      return nullptr;
+   case messages::RECORDING_SOURCE_VFO:
+      if (recording.index() < _vfoIds.size())
+      {
+         return &_engine.vfo(_vfoIds[recording.index()])->iqDataHandler();
+      }
+      return nullptr;
+   default:
+      return &_engine.iqDataHandler();
+   }
+}
+
+void RadioDaemon::startRecordings()
+{
+   for (const auto& recording : _config.recordings())
+   {
+      auto* source = recordingSource(recording);
+      if (source == nullptr)
+      {
+         GPERROR("Recording {} skipped: source {} #{} does not exist", recording.path(),
+                 messages::RecordingSource_Name(recording.source()), recording.index());
+         continue;
+      }
+      auto recorder = std::make_unique<SdrEngine::IqRecorder>();
+      if (!recorder->start(recording.path(), toRecordingFormat(recording.format()),
+                           recording.direct_io(),
+                           recording.cs16() ? SdrEngine::IqStorage::Cs16
+                                            : SdrEngine::IqStorage::Cf32))
+      {
+         GPERROR("Recording {} could not be started", recording.path());
+         continue;
+      }
+      recorder->attach(*source);
+      GPINFO("Recording {} to {}", messages::RecordingSource_Name(recording.source()),
+             recorder->getDataPath());
+      _recorders.push_back(std::move(recorder));
+   }
+}
+
+// ============================================================================
+// Remote control
+// ============================================================================
+
+void RadioDaemon::startCommands()
+{
+   if (!_config.control().enabled())
+   {
+      return;
+   }
+   _commands = std::make_unique<CommandService>(_engine, _vfoIds, _config.control());
+   if (!_commands->start())
+   {
+      _commands.reset();
+   }
+}
+
+// ============================================================================
+// Status
+// ============================================================================
+
+void RadioDaemon::logStatus() const
+{
+   _engine.logHealthStats();
+   if (_bridge)
+   {
+      const auto stats = _bridge->stats();
+      GPINFO("Streaming: {} spectra ({} skipped), {} I/Q frames, {} failures, {:.1f} MB",
+             stats.spectrumFramesSent, stats.spectrumFramesSkipped, stats.iqFramesSent,
+             stats.publishFailures, static_cast<double>(stats.payloadBytes) / 1.0e6);
+   }
+   for (const auto& recorder : _recorders)
+   {
+      const auto stats = recorder->stats();
+      GPINFO("Recording {}: {:.1f} MB at {:.1f} MB/s, {} samples dropped, {} write errors",
+             recorder->getDataPath(), static_cast<double>(stats.bytesWritten) / 1.0e6,
+             stats.throughputMBps(), stats.droppedSamples, stats.writeErrors);
+   }
+   if (_commands)
+   {
+      const auto stats = _commands->stats();
+      GPINFO("Commands: {} ({} rejected, {} for others), {} retunes in {:.0f} us mean / "
+             "{} us max ({} over target, {} timed out)",
+             stats.commands, stats.rejected, stats.ignored, stats.retunes, stats.meanEffectUs(),
+             stats.maxEffectUs, stats.retunesOverTarget, stats.effectTimeouts);
+   }
+}
@@ -0,0 +1,116 @@
+#ifndef RADIODAEMON_H_
+#define RADIODAEMON_H_
+
+// Project headers
+#include "CommandService.h"
+#include "IqRecorder.h"
+#include "ISdrDevice.h"
+#include "SdrEngine.h"
+#include "SdrPubSubBridge.h"
+#include "configuration.pb.h"
+
+// System headers
+#include <memory>
+#include <string>
+#include <vector>
+
+class HighBandwidthPublisher;
+
+/**
+ * @class RadioDaemon
+ * @brief Headless SDR host: ISdrDevice → SdrEngine → PubSub bridge and I/Q recorders.
+ *
+ * Everything is set from the `sdr` section of an ApplicationConfig
+ * (configuration.proto); no Qt is linked, so there is no event loop or
+ * rendering cost.  start() applies the configuration to the engine, starts
+ * the pipeline, then attaches the SdrPubSubBridge and the IqRecorders to
+ * the engine's DataHandlers, and, if configured, a CommandService that
+ * retunes the running engine remotely.  Nothing on the start path plans more than
+ * the one configured FFT size; with an FFTW wisdom file even that is a
+ * lookup, so the daemon streams well within a second of launch.
+ *
+ * Thread-safety: start() / stop() from one controlling thread.
+ */
+class RadioDaemon
+{
+public:
+   /**
+    * @brief Construct an idle daemon.
+    * @param config  Pipeline settings (the ApplicationConfig `sdr` section).
+    */
+   explicit RadioDaemon(messages::SdrDaemonConfig config);
+
+   /** @brief Stop the pipeline if running. */
+   ~RadioDaemon();
+
+   // Non-copyable, non-movable (the engine and bridge hold listeners).
+   RadioDaemon(const RadioDaemon&) = delete;
+   RadioDaemon& operator=(const RadioDaemon&) = delete;
+   RadioDaemon(RadioDaemon&&) = delete;
+   RadioDaemon& operator=(RadioDaemon&&) = delete;
+
+   /**
+    * @brief Configure the engine, start the pipeline, streaming and recordings.
+    * @param device  Device to capture from (normally a SoapySdrDevice).
+    * @return true if the pipeline runs; a failed recording or publisher is
+    *         logged but does not stop the capture.
+    */
+   [[nodiscard]] bool start(std::unique_ptr<SdrEngine::ISdrDevice> device);
+
+   /** @brief Stop commands, recordings and streaming, then the pipeline. */
+   void stop();
+
+   /**
+    * @brief Check if the pipeline runs.
+    * @return true between a successful start() and stop().
+    */
+   [[nodiscard]] bool isRunning() const;
+
+   /** @brief Log stream health, recording, bridge and command counters. */
+   void logStatus() const;
+
+   /**
+    * @brief Get the engine, e.g. to register further listeners.
+    * @return The daemon's engine.
+    */
+   [[nodiscard]] SdrEngine::SdrEngine& engine();
+
+   /**
+    * @brief Read an ApplicationConfig in protobuf text format.
+    * @param path    Configuration file.
+    * @param config  Receives the parsed configuration.
+    * @param error   Receives the reason on failure (may be null).
+    * @return true if the file was read and parsed.
+    */
+   static bool loadConfig(const std::string& path, messages::ApplicationConfig& config,
+                          std::string* error);
+
+private:
+   // Apply the tuning, FFT, channelizer and VFO settings before start.
+   void configureEngine();
+
+   // Create the publisher and attach the configured streams.
+   void startStreaming();
+
+   // Start every configured recording.
+   void startRecordings();
+
+   // Start accepting remote commands, if configured.
+   void startCommands();
+
+   // Stream a recording takes, or null if it names no existing stream.
+   CommonUtils::DataHandler<std::shared_ptr<const SdrEngine::IqBuffer>>* recordingSource(
+      const messages::RecordingSettings& recording);
+
+   const messages::SdrDaemonConfig _config;
+   SdrEngine::SdrEngine _engine;
+   std::vector<int> _vfoIds;                           // In configuration order.
+
+   // Declared after the engine so they detach before its handlers go away.
+   std::unique_ptr<HighBandwidthPublisher> _publisher;
+   std::unique_ptr<SdrStreaming::SdrPubSubBridge> _bridge;
+   std::vector<std::unique_ptr<SdrEngine::IqRecorder>> _recorders;
+   std::unique_ptr<CommandService> _commands;
+};
+
+#endif // RADIODAEMON_H_
@@ -0,0 +1,126 @@
+// Project headers
+#include "RadioDaemon.h"
+#include "GeneralLogger.h"
+#include "Profiler.h"
+#include "SoapySdrDevice.h"
+#include "StackTrace.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include <pthread.h>
+
+namespace
+{
+
+// How often the health counters are logged while running.
+constexpr std::time_t STATUS_INTERVAL_S = 10;
+
+// spdlog levels use the same order as messages::LogLevel.
+void applyLogLevel(const messages::ApplicationConfig& config)
+{
+   if (config.has_logging() && CommonUtils::GeneralLogger::s_generalLogger)
+   {
+      CommonUtils::GeneralLogger::s_generalLogger->set_level(
+         static_cast<spdlog::level::level_enum>(config.logging().level()));
+   }
+}
+
+} // anonymous namespace
+
+/**
+ * RadioWizardDaemon — headless capture, channelization and streaming.
+ *
+ * Usage: RadioWizardDaemon <config.textproto>
+ *
+ * The configuration is a text-format messages::ApplicationConfig; its
+ * `sdr` section describes the pipeline.  Runs until SIGINT or SIGTERM.
+ */
+int main(int argc, char* argv[])
+{
+   const auto launched = std::chrono::steady_clock::now();
+
+   // Block the shutdown signals before any thread starts, so every thread
+   // inherits the mask and only the sigtimedwait() below receives them.
+   sigset_t shutdownSignals;
+   sigemptyset(&shutdownSignals);
+   sigaddset(&shutdownSignals, SIGINT);
+   sigaddset(&shutdownSignals, SIGTERM);
+   pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr);
+
+   CommonUtils::GeneralLogger logger;
+   logger.init("RadioWizardDaemon");
+   CommonUtils::StackTrace::setPostCrashHook([](int sig)
+   {
+      GPCRIT("Caught fatal signal {} — see stderr for stack trace", sig);
+      if (CommonUtils::GeneralLogger::s_generalLogger)
+      {
+         CommonUtils::GeneralLogger::s_generalLogger->flush();
+      }
+   });
+   CommonUtils::StackTrace::installSignalHandlers();
+
+   // Same environment hooks as RadioWizardMain (see ThreadConfig / Profiler).
+   const char* threadConfigPath = std::getenv("RADIOWIZARD_THREADS");
+   std::string threadConfigError;
+   if (threadConfigPath != nullptr &&
+       !CommonUtils::ThreadConfig::instance().loadFile(threadConfigPath, &threadConfigError))
+   {
+      GPERROR("Thread configuration {} ignored: {}", threadConfigPath, threadConfigError);
+   }
+   CommonUtils::configureCurrentThread("Daemon");
+   const char* profilePath = std::getenv("RADIOWIZARD_PROFILE");
+   if (profilePath != nullptr)
+   {
+      CommonUtils::Profiler::setEnabled(true);
+   }
+
+   if (argc < 2)
+   {
+      GPERROR("Usage: {} <config.textproto>", argv[0]);
+      return EXIT_FAILURE;
+   }
+   messages::ApplicationConfig config;
+   std::string configError;
+   if (!RadioDaemon::loadConfig(argv[1], config, &configError))
+   {
+      GPERROR("Configuration not loaded: {}", configError);
+      return EXIT_FAILURE;
+   }
+   applyLogLevel(config);
+
+   RadioDaemon daemon(config.sdr());
+   if (!daemon.start(std::make_unique<SdrEngine::SoapySdrDevice>()))
+   {
+      return EXIT_FAILURE;
+   }
+   GPINFO("Started \"{}\" in {} ms", config.profile_name(),
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - launched).count());
+
+   const timespec statusInterval{STATUS_INTERVAL_S, 0};
+   int signal = -1;
+   while (signal != SIGINT && signal != SIGTERM)
+   {
+      signal = sigtimedwait(&shutdownSignals, nullptr, &statusInterval);
+      if (signal < 0)
+      {
+         daemon.logStatus();
+      }
+   }
+
+   GPINFO("Caught signal {}, shutting down", signal);
+   daemon.logStatus();
+   daemon.stop();
+   if (profilePath != nullptr && !CommonUtils::Profiler::writeChromeTrace(profilePath))
+   {
+      GPERROR("Could not write profile to {}", profilePath);
+   }
+   return EXIT_SUCCESS;
+}
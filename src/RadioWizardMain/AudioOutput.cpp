@@ -8,66 +8,59 @@
 
 // System headers
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <span>
 
 // ============================================================================
-// AudioBuffer — QIODevice wrapping a thread-safe ring buffer
+// AudioBuffer — QIODevice over a lock-free SPSC ring
 // ============================================================================
 
-AudioBuffer::AudioBuffer(size_t capacity, QObject* parent)
+AudioBuffer::AudioBuffer(size_t channels, size_t primeSamples, size_t capacity, QObject* parent)
    : QIODevice(parent)
-   , _ring(capacity, 0.0F)
-   , _capacity(capacity)
+   , _ring(capacity)
+   , _channels(std::max<size_t>(channels, 1))
+   , _primeSamples(std::min(primeSamples, _ring.capacity()))
 {
 }
 
-void AudioBuffer::feedSamples(const std::vector<float>& samples)
+void AudioBuffer::clear()
 {
-   const std::lock_guard lock(_mutex);
-   for (const float sample : samples)
-   {
-      if (_count < _capacity)
-      {
-         _ring[_writePos] = sample;
-         _writePos = (_writePos + 1) % _capacity;
-         ++_count;
-      }
-      // Drop samples if ring is full (prevents unbounded growth).
-   }
+   _ring.reset(_ring.capacity());
+   _primed.store(false);
+   _primeSilenceSamples.store(0);
 }
 
-void AudioBuffer::clear()
+uint64_t AudioBuffer::silenceFrames() const
 {
-   const std::lock_guard lock(_mutex);
-   _readPos = 0;
-   _writePos = 0;
-   _count = 0;
+   return (_primeSilenceSamples.load(std::memory_order_relaxed) + _ring.underrunSamples()) / _channels;
 }
 
 qint64 AudioBuffer::readData(char* data, qint64 maxlen)
 {
-   const std::lock_guard lock(_mutex);
-
-   auto maxFloats = static_cast<size_t>(maxlen) / sizeof(float);
-   const size_t toCopy = std::min(maxFloats, _count);
+   // Whole frames only, so channels never swap after a short read.
+   const size_t frameBytes = _channels * sizeof(float);
+   const size_t count = (static_cast<size_t>(maxlen) / frameBytes) * _channels;
    auto* dest = reinterpret_cast<float*>(data);
 
-   for (size_t i = 0; i < toCopy; ++i)
+   if (!_primed.load(std::memory_order_relaxed))
    {
-      dest[i] = _ring[_readPos];
-      _readPos = (_readPos + 1) % _capacity;
+      if (_ring.available() < _primeSamples)
+      {
+         std::memset(dest, 0, count * sizeof(float));
+         _primeSilenceSamples.fetch_add(count, std::memory_order_relaxed);
+         return static_cast<qint64>(count * sizeof(float));
+      }
+      _primed.store(true, std::memory_order_relaxed);
    }
-   _count -= toCopy;
 
-   // Zero-fill remainder so silence plays instead of underrun artifacts.
-   const size_t remaining = maxFloats - toCopy;
-   if (remaining > 0)
+   // Zero-fill on underrun so silence plays instead of artifacts, then
+   // wait for the target fill again rather than stuttering.
+   if (_ring.readOrSilence(dest, count) < count)
    {
-      std::memset(dest + toCopy, 0, remaining * sizeof(float));
+      _primed.store(false, std::memory_order_relaxed);
    }
-
-   maxFloats *= sizeof(float);
-   return static_cast<qint64>(maxFloats);
+   return static_cast<qint64>(count * sizeof(float));
 }
 
 qint64 AudioBuffer::writeData(const char* /*data*/, qint64 /*len*/)
@@ -77,8 +70,7 @@ qint64 AudioBuffer::writeData(const char* /*data*/, qint64 /*len*/)
 
 qint64 AudioBuffer::bytesAvailable() const
 {
-   const std::lock_guard lock(_mutex);
-   return static_cast<qint64>(_count * sizeof(float))
+   return static_cast<qint64>(_ring.available() * sizeof(float))
         + QIODevice::bytesAvailable();
 }
 
@@ -89,7 +81,6 @@ qint64 AudioBuffer::bytesAvailable() const
 AudioOutput::AudioOutput(double sampleRate, int numChannels)
    : _sampleRate(sampleRate)
    , _numChannels(numChannels)
-   , _buffer(std::make_unique<AudioBuffer>(RING_CAPACITY))
 {
 }
 
@@ -121,8 +112,35 @@ bool AudioOutput::start()
       return false;
    }
 
+   // Low latency: the target covers sink buffer and ring together.
+   double sinkSeconds = 0.0;
+   double ringSeconds = _targetLatency;
+   if (_lowLatency)
+   {
+      sinkSeconds = std::max(_targetLatency * SINK_LATENCY_SHARE, MIN_SINK_BUFFER_S);
+      ringSeconds = std::max(_targetLatency - sinkSeconds, MIN_SINK_BUFFER_S);
+   }
+
+   const auto channels = static_cast<size_t>(_numChannels);
+   const double targetFrames = ringSeconds * _sampleRate;
+   const auto ringFrames = static_cast<size_t>(
+      std::max(targetFrames * static_cast<double>(RING_TARGET_MULTIPLE), MIN_RING_SECONDS * _sampleRate));
+   {
+      const std::lock_guard lock(_pushMutex);
+      _buffer = std::make_unique<AudioBuffer>(channels, static_cast<size_t>(targetFrames) * channels,
+                                              ringFrames * channels);
+      _drift.configure(channels, targetFrames);
+      _writtenFrames = 0;
+      _lastSourceTime = {};
+      _lastPushTime = {};
+   }
+
    _audioSink = std::make_unique<QAudioSink>(device, format);
    _audioSink->setVolume(static_cast<qreal>(_volume.load()));
+   if (sinkSeconds > 0.0)
+   {
+      _audioSink->setBufferSize(format.bytesForDuration(static_cast<qint64>(sinkSeconds * 1.0e6)));
+   }
 
    // Open the buffer for reading (pull mode — QAudioSink reads from here).
    _buffer->open(QIODevice::ReadOnly);
@@ -137,8 +155,11 @@ bool AudioOutput::start()
    }
 
    _playing.store(true);
-   GPINFO("AudioOutput started at {:.0f} Hz, {} channel(s)",
-          _sampleRate, _numChannels);
+   GPINFO("AudioOutput started at {:.0f} Hz, {} channel(s), ring target {:.1f} ms, "
+          "sink buffer {:.1f} ms{}",
+          _sampleRate, _numChannels, ringSeconds * 1000.0,
+          static_cast<double>(format.durationForBytes(static_cast<qint32>(_audioSink->bufferSize()))) * 1.0e-3,
+          _lowLatency ? " (low latency)" : "");
    return true;
 }
 
@@ -156,11 +177,15 @@ void AudioOutput::stop()
       _audioSink->stop();
    }
 
+   const std::lock_guard lock(_pushMutex);
    if (_buffer->isOpen())
    {
       _buffer->close();
    }
 
+   const AudioOutputStats stats = collectStats();
+   GPINFO("AudioOutput: {} underrun(s), {} sample(s) dropped, final rate correction {:+.0f} ppm",
+          stats.underruns, stats.overflowSamples, (stats.resampleRatio - 1.0) * 1.0e6);
    _buffer->clear();
 
    GPINFO("AudioOutput stopped");
@@ -175,14 +200,62 @@ bool AudioOutput::isPlaying() const
 // Sample input
 // ============================================================================
 
-void AudioOutput::pushSamples(const std::vector<float>& samples)
+void AudioOutput::pushSamples(const std::vector<float>& samples,
+                              std::chrono::steady_clock::time_point sourceTime)
 {
    if (samples.empty() || !_playing.load())
    {
       return;
    }
 
-   _buffer->feedSamples(samples);
+   const std::lock_guard lock(_pushMutex);
+   const auto channels = static_cast<size_t>(_numChannels);
+   const size_t frames = samples.size() / channels;
+   SdrEngine::AudioRing& ring = _buffer->ring();
+
+   // The fill level steers the rate correction applied to this block,
+   // which is resampled straight into the ring.
+   const size_t fill = ring.available() / channels;
+   const auto regions = ring.prepareWrite(_drift.outputBound(frames) * channels);
+   const size_t generated = _drift.process(samples.data(), frames, fill, regions.first, regions.second);
+   commitRendered(generated, regions, sourceTime);
+}
+
+void AudioOutput::pushAudio(const SdrEngine::DemodAudio& audio)
+{
+   const size_t frames = std::min(audio.left.size(), audio.right.size());
+   if (frames == 0 || !_playing.load())
+   {
+      return;
+   }
+
+   const std::lock_guard lock(_pushMutex);
+   const auto channels = static_cast<size_t>(_numChannels);
+   SdrEngine::AudioRing& ring = _buffer->ring();
+
+   const std::array<const float*, 2> planes = {audio.left.data(), audio.right.data()};
+   const size_t fill = ring.available() / channels;
+   const auto regions = ring.prepareWrite(_drift.outputBound(frames) * channels);
+   const size_t generated = _drift.processPlanar(std::span(planes.data(), std::min<size_t>(channels, 2)),
+                                                 frames, fill, regions.first, regions.second);
+   commitRendered(generated, regions, audio.sourceTime);
+}
+
+void AudioOutput::commitRendered(size_t generatedFrames, const SdrEngine::AudioRing::WriteRegions& regions,
+                                 std::chrono::steady_clock::time_point sourceTime)
+{
+   const auto channels = static_cast<size_t>(_numChannels);
+   const size_t stored = std::min(generatedFrames, regions.size() / channels);
+   SdrEngine::AudioRing& ring = _buffer->ring();
+   ring.commitWrite(stored * channels);
+   if (stored < generatedFrames)
+   {
+      ring.recordOverflow((generatedFrames - stored) * channels);
+   }
+
+   _writtenFrames += stored;
+   _lastSourceTime = sourceTime;
+   _lastPushTime = std::chrono::steady_clock::now();
 }
 
 void AudioOutput::setVolume(float volume)
@@ -193,3 +266,75 @@ void AudioOutput::setVolume(float volume)
       _audioSink->setVolume(static_cast<qreal>(_volume.load()));
    }
 }
+
+void AudioOutput::setTargetLatency(double seconds)
+{
+   _targetLatency = std::max(seconds, 0.001);
+}
+
+void AudioOutput::setLowLatencyMode(bool enabled)
+{
+   _lowLatency = enabled;
+}
+
+bool AudioOutput::isLowLatencyMode() const
+{
+   return _lowLatency;
+}
+
+// ============================================================================
+// Stats
+// ============================================================================
+
+AudioOutputStats AudioOutput::getStats() const
+{
+   const std::lock_guard lock(_pushMutex);
+   return collectStats();
+}
+
+AudioOutputStats AudioOutput::collectStats() const
+{
+   AudioOutputStats stats;
+   if (!_buffer)
+   {
+      return stats;
+   }
+   const double framesPerSecond = _sampleRate;
+   const SdrEngine::AudioRing& ring = _buffer->ring();
+   const uint64_t queuedFrames = ring.available() / static_cast<size_t>(_numChannels);
+   stats.fillSeconds         = static_cast<double>(queuedFrames) / framesPerSecond;
+   stats.smoothedFillSeconds = _drift.getSmoothedFill() / framesPerSecond;
+   stats.targetSeconds       = _drift.getTargetFill() / framesPerSecond;
+   stats.resampleRatio       = _drift.getRatio();
+   stats.underruns           = ring.underrunCount();
+   stats.overflowSamples     = ring.overflowCount();
+
+   if (!_audioSink)
+   {
+      return stats;
+   }
+
+   // Sink frame index at which the newest pushed sample will play: ring
+   // frames before it plus the silence handed out so far.  The sink has
+   // processed up to `processed`; what it pulled beyond that is queued in
+   // its buffer.
+   const uint64_t silence = _buffer->silenceFrames();
+   const double processed = static_cast<double>(_audioSink->processedUSecs()) * 1.0e-6 * framesPerSecond;
+   const auto pulled = static_cast<double>(_writtenFrames - queuedFrames + silence);
+   const auto newestIndex = static_cast<double>(_writtenFrames + silence);
+   const auto frameBytes = static_cast<double>(static_cast<size_t>(_numChannels) * sizeof(float));
+   stats.sinkBufferSeconds = static_cast<double>(_audioSink->bufferSize()) / frameBytes / framesPerSecond;
+   stats.sinkQueuedSeconds = std::max(pulled - processed, 0.0) / framesPerSecond;
+
+   if (_lastSourceTime != std::chrono::steady_clock::time_point{})
+   {
+      stats.pipelineSeconds = std::chrono::duration<double>(_lastPushTime - _lastSourceTime).count();
+      const double ahead = (newestIndex - processed) / framesPerSecond;
+      if (ahead >= 0.0)
+      {
+         const auto now = std::chrono::steady_clock::now();
+         stats.endToEndSeconds = std::chrono::duration<double>(now - _lastSourceTime).count() + ahead;
+      }
+   }
+   return stats;
+}
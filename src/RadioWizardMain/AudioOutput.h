@@ -1,49 +1,84 @@
 #ifndef AUDIOOUTPUT_H_
 #define AUDIOOUTPUT_H_
 
+// Project headers
+#include "AudioDriftCompensator.h"
+#include "AudioRing.h"
+#include "Demodulator.h"
+
 // Third-party headers (Qt)
 #include <QAudioSink>
 #include <QIODevice>
 
 // System headers
 #include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <vector>
 
 /**
  * @class AudioBuffer
- * @brief QIODevice subclass wrapping a thread-safe ring buffer for audio data.
+ * @brief QIODevice subclass wrapping a lock-free SPSC ring for audio data.
  *
  * Used internally by AudioOutput in pull mode — QAudioSink reads PCM data
- * from this device, while samples are fed from any thread via feedSamples().
+ * from this device, while one producer thread renders into its ring.
+ * Playback starts (and restarts after an underrun) only once the ring
+ * holds the target fill, so the drift compensator begins at its set point.
  */
 class AudioBuffer : public QIODevice
 {
    Q_OBJECT
 
 public:
-   explicit AudioBuffer(size_t capacity, QObject* parent = nullptr);
-
-   /// Feed interleaved float samples from any thread.
-   void feedSamples(const std::vector<float>& samples);
+   /**
+    * @param channels       Interleaved channels per frame.
+    * @param primeSamples   Samples to buffer before playback (re)starts.
+    * @param capacity       Ring capacity in samples.
+    */
+   AudioBuffer(size_t channels, size_t primeSamples, size_t capacity, QObject* parent = nullptr);
 
-   /// Reset the ring buffer to empty.
+   /// Reset the ring buffer to empty and clear its counters.
    void clear();
 
+   /// The ring shared with QAudioSink; the producer thread writes into it.
+   [[nodiscard]] SdrEngine::AudioRing& ring() { return _ring; }
+   [[nodiscard]] const SdrEngine::AudioRing& ring() const { return _ring; }
+
+   /// Frames of silence handed to the sink (priming and underruns).
+   [[nodiscard]] uint64_t silenceFrames() const;
+
 protected:
    qint64 readData(char* data, qint64 maxlen) override;
    qint64 writeData(const char* data, qint64 len) override;
    [[nodiscard]] qint64 bytesAvailable() const override;
 
 private:
-   mutable std::mutex _mutex;
-   std::vector<float> _ring;
-   size_t _readPos{0};
-   size_t _writePos{0};
-   size_t _count{0};
-   size_t _capacity;
+   SdrEngine::AudioRing _ring;
+   size_t _channels;
+   size_t _primeSamples;
+   std::atomic<bool> _primed{false};   // Consumer side; cleared by clear().
+   std::atomic<uint64_t> _primeSilenceSamples{0};
+};
+
+/**
+ * @class AudioOutputStats
+ * @brief Snapshot of AudioOutput's buffer health and latency.
+ */
+struct AudioOutputStats
+{
+   double fillSeconds{0.0};           ///< Audio queued in the ring right now.
+   double smoothedFillSeconds{0.0};   ///< Fill level the drift compensator acts on.
+   double targetSeconds{0.0};         ///< Fill level the compensator steers to.
+   double resampleRatio{1.0};         ///< Current output/input rate correction.
+   uint64_t underruns{0};             ///< Sink reads the ring could not satisfy.
+   uint64_t overflowSamples{0};       ///< Samples dropped because the ring was full.
+   double sinkBufferSeconds{0.0};     ///< QAudioSink buffer size in use.
+   double sinkQueuedSeconds{0.0};     ///< Pulled by the sink but not yet processed.
+   double pipelineSeconds{-1.0};      ///< Source time to push of the newest block (< 0: unknown).
+   double endToEndSeconds{-1.0};      ///< Source time to playout of the newest block (< 0: unknown).
 };
 
 /**
@@ -54,10 +89,30 @@ private:
  * Usage:
  *   1. Construct with desired sample rate.
  *   2. Call start() to begin playback.
- *   3. Feed samples via pushSamples() from any thread.
+ *   3. Feed samples via pushAudio() or pushSamples() from any thread.
  *   4. Call stop() to halt.
  *
- * Thread-safety: pushSamples() is thread-safe.
+ * Samples pass through an AudioDriftCompensator into a lock-free AudioRing
+ * that the sink pulls from, so the sound card's callback never takes a
+ * lock and the SDR / sound card clock drift is absorbed by a sub-percent
+ * rate correction that holds the fill level at the target latency.  The
+ * compensator renders straight into the ring's reserved regions, and
+ * pushAudio() interleaves a DemodAudio block in that same pass: one copy
+ * from demodulator output to the sink's ring.
+ *
+ * In low-latency mode the target latency is the budget for the whole
+ * audio path: it is split between the QAudioSink buffer and the ring fill,
+ * instead of leaving the sink at its (typically much larger) default.
+ *
+ * End-to-end latency is measured for the newest pushed block: the time
+ * since its source timestamp (IqBuffer::sourceTime()), plus the audio still
+ * ahead of its last sample — the ring, silence inserted so far, and what
+ * the sink has pulled but not yet processed (`processedUSecs()`).
+ * Buffering inside the platform audio stack is not visible to Qt and is
+ * not included.
+ *
+ * Thread-safety: pushAudio() and pushSamples() are thread-safe.  Call start(), stop() and
+ * getStats() from the thread that owns the sink (the GUI thread).
  */
 class AudioOutput
 {
@@ -106,9 +161,23 @@ public:
     * For stereo: samples are interleaved [L, R, L, R, ...].
     * For mono: single stream of samples.
     *
-    * @param samples  Float audio samples (normalised to [-1, 1]).
+    * @param samples     Float audio samples (normalised to [-1, 1]).
+    * @param sourceTime  When the samples' source I/Q arrived (default:
+    *                    unknown, no end-to-end latency measurement).
+    */
+   void pushSamples(const std::vector<float>& samples,
+                    std::chrono::steady_clock::time_point sourceTime = {});
+
+   /**
+    * @brief Push a demodulated block, interleaving L/R while it is written
+    *        into the ring (no intermediate buffer).
+    *
+    * Mono output plays the left channel.  Safe to call from any thread.
+    *
+    * @param audio  Demodulator output; its `sourceTime` feeds the
+    *               end-to-end latency measurement.
     */
-   void pushSamples(const std::vector<float>& samples);
+   void pushAudio(const SdrEngine::DemodAudio& audio);
 
    /**
     * @brief Set the playback volume.
@@ -116,16 +185,78 @@ public:
     */
    void setVolume(float volume);
 
+   /**
+    * @brief Set the target latency: the ring fill held by the drift
+    *        compensator, or in low-latency mode the ring plus sink buffer.
+    * Takes effect on the next start().
+    * @param seconds  Target latency in seconds.
+    */
+   void setTargetLatency(double seconds);
+
+   /**
+    * @brief Size the sink buffer and ring from the target latency.
+    * Takes effect on the next start().
+    * @param enabled  true for low-latency mode.
+    */
+   void setLowLatencyMode(bool enabled);
+
+   /**
+    * @brief Check if low-latency mode is selected.
+    * @return true if the next start() sizes the sink from the target.
+    */
+   [[nodiscard]] bool isLowLatencyMode() const;
+
+   /**
+    * @brief Get the buffer fill level, glitch counters and latency.
+    * @return Stats snapshot.
+    */
+   [[nodiscard]] AudioOutputStats getStats() const;
+
+   /// Default fill level held by the drift compensator.
+   static constexpr double DEFAULT_TARGET_LATENCY_S = 0.05;
+
+   /// Audio-path budget for live monitoring (antenna to speaker < 30 ms).
+   static constexpr double LOW_LATENCY_TARGET_S = 0.02;
+
+   /// Share of the low-latency budget given to the sink buffer.
+   static constexpr double SINK_LATENCY_SHARE = 0.5;
+
+   /// Smallest sink buffer requested; below this most backends glitch.
+   static constexpr double MIN_SINK_BUFFER_S = 0.005;
+
 private:
-   static constexpr size_t RING_CAPACITY = 512UL * 1024UL; // ~5 s stereo @ 48 kHz
+   /// Ring capacity in multiples of the target fill.
+   static constexpr size_t RING_TARGET_MULTIPLE = 8;
+
+   /// Smallest ring, so a small target still absorbs bursty producers.
+   static constexpr double MIN_RING_SECONDS = 0.5;
+
+   // Build a stats snapshot; caller holds _pushMutex.
+   [[nodiscard]] AudioOutputStats collectStats() const;
+
+   // Publish the frames rendered into `regions` and record the block's
+   // source time; caller holds _pushMutex.
+   void commitRendered(size_t generatedFrames, const SdrEngine::AudioRing::WriteRegions& regions,
+                       std::chrono::steady_clock::time_point sourceTime);
 
    double _sampleRate;
    int _numChannels;
+   double _targetLatency{DEFAULT_TARGET_LATENCY_S};
+   bool _lowLatency{false};
    std::atomic<float> _volume{0.8F};
    std::atomic<bool> _playing{false};
 
    std::unique_ptr<QAudioSink> _audioSink;
    std::unique_ptr<AudioBuffer> _buffer;
+
+   // Producer side.
+   mutable std::mutex _pushMutex;
+   SdrEngine::AudioDriftCompensator _drift;   // Guarded by _pushMutex.
+
+   // Latency bookkeeping for the newest pushed block, guarded by _pushMutex.
+   uint64_t _writtenFrames{0};                           // Frames written to the ring since start().
+   std::chrono::steady_clock::time_point _lastSourceTime;
+   std::chrono::steady_clock::time_point _lastPushTime;
 };
 
 #endif // AUDIOOUTPUT_H_
@@ -2,9 +2,11 @@
 #include <MainWindow.h>
 #include "AudioOutput.h"
 #include "Demodulator.h"
+#include "FftProcessor.h"
 #include "GeneralLogger.h"
 #include "SoapySdrDevice.h"
 #include "SdrCommonUtils.h"
+#include "ThreadConfig.h"
 
 // Generated UI header
 #include "./ui_MainWindow.h"
@@ -12,19 +14,27 @@
 // Third-party headers
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDir>
 #include <QGridLayout>
 #include <QLabel>
 #include <QMetaObject>
 #include <QPushButton>
 #include <QSlider>
+#include <QStandardPaths>
+#include <QTimer>
 
 // System headers
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <fstream>
 #include <memory>
+#include <span>
 #include <string>
+#include <utility>
 
 namespace
 {
@@ -38,6 +48,106 @@ constexpr std::array<uint32_t, NUM_SAMPLE_RATES> SAMPLE_RATES = {
 constexpr size_t NUM_FFT_SIZES = 8;
 constexpr std::array<size_t, NUM_FFT_SIZES> FFT_SIZES = {2048, 4096, 8192, 16384, 32768, 65536, 131072, 262144};
 
+/// Points handed to the spectrum, waterfall and detailed widgets per frame.
+constexpr size_t DISPLAY_POINTS = 2048;
+
+/// I/Q handed to the constellation and oscilloscope: contiguous blocks of
+/// this many samples, at most this many per second, whatever the rate.
+constexpr size_t DISPLAY_IQ_BLOCK           = 4096;
+constexpr double DISPLAY_IQ_SAMPLES_PER_SEC = 131'072.0;
+constexpr double DISPLAY_IQ_FRAMES_PER_SEC  = 30.0;
+
+/// FFTW wisdom cache, so FFT plans are measured once rather than every launch.
+std::string fftWisdomPath()
+{
+   const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+   QDir().mkpath(dir);
+   return (dir + "/fftw_wisdom.dat").toStdString();
+}
+
+/// Last probed device list, shown at startup while the hardware is probed.
+std::string deviceCachePath()
+{
+   const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+   QDir().mkpath(dir);
+   return (dir + "/devices.txt").toStdString();
+}
+
+// One device per line: index, name, manufacturer, product and serial,
+// separated by tabs.
+std::vector<SdrEngine::DeviceInfo> loadDeviceCache()
+{
+   std::vector<SdrEngine::DeviceInfo> devices;
+   std::ifstream in(deviceCachePath());
+   std::string line;
+   while (std::getline(in, line))
+   {
+      std::array<std::string, 5> fields;
+      std::size_t field = 0;
+      for (const char c : line)
+      {
+         if (c != '\t')
+         {
+            fields[field] += c;
+         }
+         else if (++field == fields.size())
+         {
+            break;
+         }
+      }
+      SdrEngine::DeviceInfo info;
+      const auto [end, ec] = std::from_chars(fields[0].data(),
+                                             fields[0].data() + fields[0].size(), info.index);
+      if (field != fields.size() - 1 || ec != std::errc{} || info.index < 0)
+      {
+         continue;
+      }
+      info.name         = std::move(fields[1]);
+      info.manufacturer = std::move(fields[2]);
+      info.product      = std::move(fields[3]);
+      info.serial       = std::move(fields[4]);
+      devices.push_back(std::move(info));
+   }
+   return devices;
+}
+
+void saveDeviceCache(const std::vector<SdrEngine::DeviceInfo>& devices)
+{
+   const auto clean = [](std::string text)
+   {
+      std::replace_if(text.begin(), text.end(), [](char c) { return c == '\t' || c == '\n'; },
+                      ' ');
+      return text;
+   };
+   std::ofstream out(deviceCachePath(), std::ios::trunc);
+   for (const auto& info : devices)
+   {
+      out << info.index << '\t' << clean(info.name) << '\t' << clean(info.manufacturer) << '\t'
+          << clean(info.product) << '\t' << clean(info.serial) << '\n';
+   }
+}
+
+/// Disk budget of the waterfall scrollback: hours of a typical spectrum.
+constexpr size_t WATERFALL_SCROLLBACK_BYTES = size_t{512} << 20;
+
+/// Waterfall scrollback cache file (unlinked by the widget once open).
+std::string waterfallCachePath()
+{
+   const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+   QDir().mkpath(dir);
+   return (dir + "/waterfall_scrollback.bin").toStdString();
+}
+
+/// Constellation / oscilloscope listeners draw on their own thread and only
+/// the newest block, so plotting never delays demodulation on the same stream.
+CommonUtils::ListenerOptions plotListenerOptions()
+{
+   CommonUtils::ListenerOptions options;
+   options.mode     = CommonUtils::DispatchMode::DedicatedThread;
+   options.overflow = CommonUtils::OverflowPolicy::LatestOnly;
+   return options;
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -71,10 +181,34 @@ MainWindow::MainWindow(QWidget* parent)
               [this](int index) { applyDeviceSelection(index); });
       connect(_refreshDevicesBtn, &QPushButton::clicked, this,
               [this]() { refreshDevices(); });
+
+      // Low-latency audio toggle and its latency readout.
+      _lowLatencyCheck = new QCheckBox("Low latency", this);
+      _lowLatencyCheck->setToolTip("Size the audio buffers for live monitoring (< 30 ms)");
+      _audioLatencyLabel = new QLabel(this);
+      gridLayout->addWidget(_lowLatencyCheck, 20, 0);
+      gridLayout->addWidget(_audioLatencyLabel, 20, 1);
+
+      connect(_lowLatencyCheck, &QCheckBox::toggled, this, [this](bool checked)
+      {
+         // Device-read stamps let the latency readout start at the antenna.
+         _engine.setLatencyTracingEnabled(checked);
+         if (_ui->_demodButton->isChecked())
+         {
+            startDemod();
+         }
+      });
    }
 
-   // Auto-detect connected devices and select the first one.
+   _audioStatsTimer = new QTimer(this);
+   _audioStatsTimer->setInterval(500);
+   connect(_audioStatsTimer, &QTimer::timeout, this, [this]() { updateAudioStats(); });
+
+   // Show the last known devices at once and probe the hardware in the
+   // background; SoapySDR can take seconds to probe every module.
    refreshDevices();
+   showDevices(SdrEngine::SoapySdrDevice::hasProbed() ? SdrEngine::SoapySdrDevice::cachedDevices()
+                                                       : loadDeviceCache());
 
    // Populate sample rate combo box.
    for (const auto sampleRate : SAMPLE_RATES)
@@ -89,10 +223,18 @@ MainWindow::MainWindow(QWidget* parent)
       _ui->_fftSizeCombo->addItem(QString::number(fftSize));
    }
 
+   // Load FFTW wisdom before any large plan is built, then prepare the
+   // remaining combo sizes in the background.
+   SdrEngine::FftProcessor::loadWisdom(fftWisdomPath());
+
    // Set defaults that match the UI initial values.
    _engine.setCenterFrequency(92'100'000);
    _engine.setSampleRate(2'400'000);
    _engine.setFftSize(65536);
+   _engine.setSpectrumPyramidEnabled(true);
+   _engine.setSpectrumLevelsEnabled(true);
+   _engine.setZoomFftEnabled(true);
+   _engine.prepareFftSizes({FFT_SIZES.begin(), FFT_SIZES.end()});
    _ui->_oscilloscopeWidget->setSampleRate(2'400'000);
    onCenterFreqChanged(_engine.getCenterFrequencyMHz());
 
@@ -107,6 +249,7 @@ MainWindow::MainWindow(QWidget* parent)
    _ui->_spectrurmWidget->setDbRange(-120.0F, 0.0F);
    _ui->_waterfallWidget->setInputIsDb(true);
    _ui->_waterfallWidget->setDbRange(-120.0F, 0.0F);
+   _ui->_waterfallWidget->enableScrollback(waterfallCachePath(), WATERFALL_SCROLLBACK_BYTES);
    _ui->_detailedSpectrumWidget->setInputIsDb(true);
    _ui->_detailedSpectrumWidget->setDbRange(-120.0F, 0.0F);
    _ui->_detailedSpectrumWidget->setGridLines(6, 4);
@@ -168,6 +311,12 @@ MainWindow::MainWindow(QWidget* parent)
       static_cast<float>(_ui->_constellationFadeSlider->value()) / 10.0F);
    connect(_ui->_maxHoldCheckBox, &QCheckBox::toggled,
            _ui->_spectrurmWidget, &RealTimeGraphs::SpectrumWidget::setMaxHoldEnabled);
+   connect(_ui->_maxHoldCheckBox, &QCheckBox::toggled, this,
+           [this](bool checked) { _engine.setMaxHoldEnabled(checked); });
+   connect(_ui->_minHoldCheckBox, &QCheckBox::toggled,
+           _ui->_spectrurmWidget, &RealTimeGraphs::SpectrumWidget::setMinHoldEnabled);
+   connect(_ui->_minHoldCheckBox, &QCheckBox::toggled, this,
+           [this](bool checked) { _engine.setMinHoldEnabled(checked); });
    connect(_ui->_bwCursorButton, &QPushButton::toggled,
            this, &MainWindow::onBwCursorToggled);
    connect(_ui->_demodButton, &QPushButton::toggled,
@@ -261,6 +410,12 @@ MainWindow::~MainWindow()
    {
       _engine.stop();
    }
+   SdrEngine::FftProcessor::saveWisdom(fftWisdomPath());
+   // Its completion is queued to this window; Qt drops it once we are gone.
+   if (_probeThread.joinable())
+   {
+      _probeThread.join();
+   }
    delete _ui;
 }
 
@@ -273,7 +428,7 @@ void MainWindow::onStartStopToggled(bool checked)
    if (checked)
    {
       connectDataHandlers();
-      if (_engine.start())
+      if (_engine.start(_selectedDeviceIndex))
       {
          _ui->_startStopButton->setText("Stop");
          if (_deviceCombo != nullptr)
@@ -328,7 +483,7 @@ void MainWindow::onStartStopToggled(bool checked)
       }
       if (_refreshDevicesBtn != nullptr)
       {
-         _refreshDevicesBtn->setEnabled(true);
+         _refreshDevicesBtn->setEnabled(!_probing);
       }
    }
 }
@@ -464,6 +619,7 @@ void MainWindow::onBwCursorToggled(bool checked)
       updateDemodButtonState();
 
       _engine.setChannelFilterEnabled(false);
+      _engine.clearMeasurementBand();
 
       // Clear the detailed spectrum widget.
       _ui->_detailedSpectrumWidget->setData({});
@@ -493,6 +649,7 @@ void MainWindow::onBwCursorLocked(double xData)
 
    _engine.configureChannelFilterFromMinMax(minFreqHz, maxFreqHz);
    _engine.setChannelFilterEnabled(true);
+   _engine.setMeasurementBand(minFreqHz, maxFreqHz);
 
    // Switch constellation to display filtered IQ data.
    switchToFilteredIq();
@@ -501,7 +658,7 @@ void MainWindow::onBwCursorLocked(double xData)
    _ui->_detailedSpectrumWidget->setFrequencyRange(0.0, bwHz);
    if (_lastSpectrumData)
    {
-      updateDetailedSpectrum();
+      updateDetailedSpectrum(*_lastSpectrumData);
    }
 
    updateDemodButtonState();
@@ -517,6 +674,7 @@ void MainWindow::onBwCursorUnlocked()
 {
    _bwCursorLocked = false;
    _engine.setChannelFilterEnabled(false);
+   _engine.clearMeasurementBand();
 
    // Clear the detailed spectrum widget.
    _ui->_detailedSpectrumWidget->setData({});
@@ -554,12 +712,13 @@ void MainWindow::onBwCursorHalfWidthChanged(double halfWidthHz)
       const double maxFreqHz = channelCenterHz + (bwHz / 2.0);
 
       _engine.configureChannelFilterFromMinMax(minFreqHz, maxFreqHz);
+      _engine.setMeasurementBand(minFreqHz, maxFreqHz);
 
       // Update the detailed spectrum widget's frequency range and data.
       _ui->_detailedSpectrumWidget->setFrequencyRange(0.0, halfWidthHz * 2.0);
       if (_lastSpectrumData)
       {
-         updateDetailedSpectrum();
+         updateDetailedSpectrum(*_lastSpectrumData);
       }
 
       // Reconfigure demod if active (bandwidth changed).
@@ -608,7 +767,7 @@ void MainWindow::startDemod()
       return;
    }
 
-   // Configure Demodulator with the channel filter output rate.
+   // Demodulate at the channel filter output rate.
    const double channelRate = _engine.channelFilter().getOutputSampleRate();
    if (channelRate <= 0.0)
    {
@@ -619,10 +778,14 @@ void MainWindow::startDemod()
 
    const auto mode = selectedDemodMode();
    constexpr double AUDIO_RATE = SdrEngine::Demodulator::DEFAULT_AUDIO_RATE;
-   _demod.configure(mode, channelRate, AUDIO_RATE);
 
    // Create and start stereo audio output.
    _audioOutput = std::make_unique<AudioOutput>(AUDIO_RATE, 2);
+   if ((_lowLatencyCheck != nullptr) && _lowLatencyCheck->isChecked())
+   {
+      _audioOutput->setLowLatencyMode(true);
+      _audioOutput->setTargetLatency(AudioOutput::LOW_LATENCY_TARGET_S);
+   }
    if (!_audioOutput->start())
    {
       GPERROR("Demod: failed to start audio output");
@@ -631,29 +794,23 @@ void MainWindow::startDemod()
       return;
    }
 
-   // Register a listener on the filtered IQ data handler to feed the demod.
-   _demodListenerId = _engine.filteredIqDataHandler().registerListener(
-      [this](const std::shared_ptr<const SdrEngine::IqBuffer>& iqData)
+   // Demodulation runs on the engine's executor; the filtered IQ listener
+   // only queues each block, so it never holds up the other listeners.
+   auto& executor = _engine.demodExecutor();
+   _demodChannelId = executor.addChannel(mode, channelRate, AUDIO_RATE);
+   const auto channel = executor.channel(_demodChannelId);
+
+   _audioListenerId = channel->audioDataHandler().registerListener(
+      [this](const std::shared_ptr<const SdrEngine::DemodAudio>& audio)
       {
          try
          {
-            auto audio = _demod.demodulate(iqData->samples);
-            if (audio.left.empty() || !_audioOutput ||
-                !_audioOutput->isPlaying())
+            if (!_audioOutput || !_audioOutput->isPlaying())
             {
                return;
             }
-
-            // Interleave L and R into a single buffer.
-            const size_t frames = std::min(audio.left.size(),
-                                           audio.right.size());
-            std::vector<float> interleaved(frames * 2);
-            for (size_t i = 0; i < frames; ++i)
-            {
-               interleaved[(i * 2)] = audio.left[i];
-               interleaved[((i * 2) + 1)] = audio.right[i];
-            }
-            _audioOutput->pushSamples(interleaved);
+            // Interleaved straight into the audio ring.
+            _audioOutput->pushAudio(*audio);
          }
          catch (std::exception& ex)
          {
@@ -661,6 +818,15 @@ void MainWindow::startDemod()
          }
       });
 
+   _demodListenerId = _engine.filteredIqDataHandler().registerListener(
+      [this, channelId = _demodChannelId](
+         const std::shared_ptr<const SdrEngine::IqBuffer>& iqData)
+      {
+         _engine.demodExecutor().submit(channelId, iqData);
+      });
+
+   _audioStatsTimer->start();
+
    GPINFO("Demod started: mode={}, channel={:.0f} Hz → audio={:.0f} Hz",
           SdrEngine::demodModeName(mode), channelRate, AUDIO_RATE);
 }
@@ -674,14 +840,59 @@ void MainWindow::stopDemod()
       _demodListenerId = -1;
    }
 
+   // Drop the demod channel; its audio handler stops with it.
+   if (_demodChannelId >= 0)
+   {
+      auto& executor = _engine.demodExecutor();
+      if (const auto channel = executor.channel(_demodChannelId))
+      {
+         channel->audioDataHandler().unregisterListener(_audioListenerId);
+      }
+      executor.removeChannel(_demodChannelId);
+      _demodChannelId = -1;
+      _audioListenerId = -1;
+   }
+
    // Stop and destroy audio output.
+   _audioStatsTimer->stop();
+   if (_audioLatencyLabel != nullptr)
+   {
+      _audioLatencyLabel->clear();
+   }
    if (_audioOutput)
    {
       _audioOutput->stop();
       _audioOutput.reset();
    }
+}
 
-   _demod.reset();
+void MainWindow::updateAudioStats()
+{
+   if (!_audioOutput || (_audioLatencyLabel == nullptr))
+   {
+      return;
+   }
+   const AudioOutputStats stats = _audioOutput->getStats();
+   const QString endToEnd = (stats.endToEndSeconds >= 0.0)
+                               ? QString::number(stats.endToEndSeconds * 1000.0, 'f', 1) + " ms"
+                               : QString("—");
+   _audioLatencyLabel->setText(QString("%1 (ring %2, sink %3)")
+                                  .arg(endToEnd)
+                                  .arg(stats.fillSeconds * 1000.0, 0, 'f', 1)
+                                  .arg(stats.sinkQueuedSeconds * 1000.0, 0, 'f', 1));
+   _audioLatencyLabel->setToolTip(
+      QString("Antenna to speaker: %1\nPipeline (source to audio push): %2 ms\n"
+              "Ring fill: %3 ms (target %4 ms)\nSink queued: %5 ms of %6 ms\n"
+              "Rate correction: %7 ppm\nUnderruns: %8, dropped samples: %9")
+         .arg(endToEnd)
+         .arg(stats.pipelineSeconds * 1000.0, 0, 'f', 1)
+         .arg(stats.fillSeconds * 1000.0, 0, 'f', 1)
+         .arg(stats.targetSeconds * 1000.0, 0, 'f', 1)
+         .arg(stats.sinkQueuedSeconds * 1000.0, 0, 'f', 1)
+         .arg(stats.sinkBufferSeconds * 1000.0, 0, 'f', 1)
+         .arg((stats.resampleRatio - 1.0) * 1.0e6, 0, 'f', 0)
+         .arg(stats.underruns)
+         .arg(stats.overflowSamples));
 }
 
 void MainWindow::updateDemodButtonState()
@@ -719,17 +930,40 @@ void MainWindow::connectDataHandlers()
       {
          try
          {
-            const auto decimated =
-               SdrEngine::decimateSpectrum(specData->magnitudesDb);
-            _ui->_spectrurmWidget->setData(decimated);
-            _ui->_waterfallWidget->addRow(decimated);
-
-            // Cache the full spectrum for the detailed widget.
-            _lastSpectrumData = specData;
-            if (_bwCursorLocked)
+            // The engine's pyramid already holds a peak-preserving tier
+            // of display size; read it in place.
+            const auto view = SdrEngine::selectSpectrumView(
+               *specData, 0, specData->magnitudesDb.size(), DISPLAY_POINTS);
+            // Holds have no pyramid: decimate them on the stack.
+            std::array<float, DISPLAY_POINTS> maxHold{};
+            std::array<float, DISPLAY_POINTS> minHold{};
+            const std::size_t maxHoldPoints =
+               SdrEngine::decimateSpectrum(specData->maxHoldDb, maxHold);
+            const std::size_t minHoldPoints =
+               SdrEngine::decimateSpectrum(specData->minHoldDb, minHold);
+            _ui->_spectrurmWidget->setData(view.maxDb,
+                                           std::span(maxHold).first(maxHoldPoints),
+                                           std::span(minHold).first(minHoldPoints));
+            _ui->_waterfallWidget->addRow(view.maxDb);
+
+            // The engine measures the locked band; the overlay only shows it.
+            const auto& levels = specData->levels;
+            if (levels.valid && levels.hasBand)
             {
-               updateDetailedSpectrum();
+               QMetaObject::invokeMethod(
+                  _ui->_spectrurmWidget,
+                  [widget = _ui->_spectrurmWidget, floorDb = levels.noiseFloorDb,
+                   powerDb = levels.bandPowerDb]()
+                  {
+                     widget->setBandwidthLevels(static_cast<double>(floorDb),
+                                                static_cast<double>(powerDb));
+                  },
+                  Qt::QueuedConnection);
             }
+
+            // Cache the full spectrum for the detailed widget until the
+            // zoom spectrum of a newly locked channel arrives.
+            _lastSpectrumData = specData;
          }
          catch (std::exception &exception)
          {
@@ -741,7 +975,37 @@ void MainWindow::connectDataHandlers()
          }
       });
 
+   // --- Zoom spectrum of the locked channel → detailed SpectrumWidget ---
+   _engine.setPublishPolicy(SdrEngine::EnginePublisher::ZoomSpectrum,
+                            CommonUtils::OverflowPolicy::LatestOnly);
+   _zoomSpectrumListenerId = _engine.zoomSpectrumDataHandler().registerListener(
+      [this](const std::shared_ptr<const SdrEngine::SpectrumData>& specData)
+      {
+         updateDetailedSpectrum(*specData);
+      },
+      plotListenerOptions());
+
    // --- I/Q data → ConstellationWidget + OscilloscopeWidget ---
+   // The plots take the engine's display tap rather than every full-rate
+   // frame.  Snapshots keep each block at the stream rate, so the scope's
+   // time axis and the constellation's consecutive points stay true.  A
+   // backlog is never worth drawing: keep just the newest frame.
+   SdrEngine::DisplayTapConfig tap;
+   tap.mode            = SdrEngine::DisplayTapMode::Snapshot;
+   tap.snapshotSamples = DISPLAY_IQ_BLOCK;
+   tap.samplesPerSec   = DISPLAY_IQ_SAMPLES_PER_SEC;
+   tap.framesPerSec    = DISPLAY_IQ_FRAMES_PER_SEC;
+   _engine.setDisplayTapConfig(tap);
+   _engine.setDisplayTapEnabled(true);
+   _engine.setPublishPolicy(SdrEngine::EnginePublisher::DisplayIq,
+                            CommonUtils::OverflowPolicy::LatestOnly);
+   _displayIqListenerId = _engine.displayIqDataHandler().registerListener(
+      [this](const std::shared_ptr<const SdrEngine::IqBuffer>& iqData)
+      {
+         _ui->_constellationWidget->setData(iqData->samples);
+         _ui->_oscilloscopeWidget->setData(iqData->samples);
+      },
+      plotListenerOptions());
    switchToUnfilteredIq();
 }
 
@@ -752,16 +1016,17 @@ void MainWindow::disconnectDataHandlers()
       _engine.spectrumDataHandler().unregisterListener(_spectrumListenerId);
       _spectrumListenerId = -1;
    }
-   if (_iqListenerId >= 0)
+   if (_zoomSpectrumListenerId >= 0)
    {
-      _engine.iqDataHandler().unregisterListener(_iqListenerId);
-      _iqListenerId = -1;
+      _engine.zoomSpectrumDataHandler().unregisterListener(_zoomSpectrumListenerId);
+      _zoomSpectrumListenerId = -1;
    }
-   if (_filteredIqListenerId >= 0)
+   if (_displayIqListenerId >= 0)
    {
-      _engine.filteredIqDataHandler().unregisterListener(_filteredIqListenerId);
-      _filteredIqListenerId = -1;
+      _engine.displayIqDataHandler().unregisterListener(_displayIqListenerId);
+      _displayIqListenerId = -1;
    }
+   _engine.setDisplayTapEnabled(false);
 }
 
 // ============================================================================
@@ -769,24 +1034,10 @@ void MainWindow::disconnectDataHandlers()
 // ============================================================================
 void MainWindow::switchToUnfilteredIq()
 {
-   // Unregister filtered listener if active.
-   if (_filteredIqListenerId >= 0)
-   {
-      _engine.filteredIqDataHandler().unregisterListener(_filteredIqListenerId);
-      _filteredIqListenerId = -1;
-   }
-
-   // Register unfiltered listener if not already active.
-   if (_iqListenerId < 0)
-   {
-      _iqListenerId = _engine.iqDataHandler().registerListener(
-         [this](const std::shared_ptr<const SdrEngine::IqBuffer>& iqData)
-         {
-            _ui->_constellationWidget->setData(iqData->samples);
-            _ui->_oscilloscopeWidget->setData(iqData->samples);
-         });
-      GPINFO("Switched constellation + oscilloscope to unfiltered I/Q data");
-   }
+   auto tap   = _engine.getDisplayTapConfig();
+   tap.source = SdrEngine::DisplayTapSource::Wideband;
+   _engine.setDisplayTapConfig(tap);
+   GPINFO("Switched constellation + oscilloscope to unfiltered I/Q data");
 
    _ui->_oscilloscopeWidget->setSampleRate(
       static_cast<double>(_engine.getSampleRate()));
@@ -794,24 +1045,10 @@ void MainWindow::switchToUnfilteredIq()
 
 void MainWindow::switchToFilteredIq()
 {
-   // Unregister unfiltered listener if active.
-   if (_iqListenerId >= 0)
-   {
-      _engine.iqDataHandler().unregisterListener(_iqListenerId);
-      _iqListenerId = -1;
-   }
-
-   // Register filtered listener if not already active.
-   if (_filteredIqListenerId < 0)
-   {
-      _filteredIqListenerId = _engine.filteredIqDataHandler().registerListener(
-         [this](const std::shared_ptr<const SdrEngine::IqBuffer>& iqData)
-         {
-            _ui->_constellationWidget->setData(iqData->samples);
-            _ui->_oscilloscopeWidget->setData(iqData->samples);
-         });
-      GPINFO("Switched constellation + oscilloscope to filtered I/Q data");
-   }
+   auto tap   = _engine.getDisplayTapConfig();
+   tap.source = SdrEngine::DisplayTapSource::ChannelFilter;
+   _engine.setDisplayTapConfig(tap);
+   GPINFO("Switched constellation + oscilloscope to filtered I/Q data");
 
    const double channelRate = _engine.channelFilter().getOutputSampleRate();
    if (channelRate > 0.0)
@@ -823,48 +1060,56 @@ void MainWindow::switchToFilteredIq()
 // ============================================================================
 // Detailed spectrum (BW-cursor zoom)
 // ============================================================================
-void MainWindow::updateDetailedSpectrum()
+void MainWindow::updateDetailedSpectrum(const SdrEngine::SpectrumData& frame)
 {
-   if (!_lastSpectrumData || !_bwCursorLocked)
+   if (!_bwCursorLocked)
    {
       return;
    }
 
-   const auto& bins = _lastSpectrumData->magnitudesDb;
-   const auto totalBins = bins.size();
+   const auto totalBins = frame.magnitudesDb.size();
    if (totalBins == 0)
    {
       return;
    }
 
-   // The cursor position is a [0, 1] fraction of the bandwidth.
-   // Convert to a bin index range.  Use the spectrum data's own bandwidth
-   // so the extraction is always consistent with the cached FFT frame.
-   const double sampleRate = _lastSpectrumData->bandwidthHz;
-   const double hzPerBin = sampleRate / static_cast<double>(totalBins);
+   // The cursor position is a [0, 1] fraction of the tuned bandwidth.
+   // Convert it to an absolute frequency, then to a bin index range in
+   // the frame's own span, so wideband and zoom frames are cut alike.
+   const double channelCenterHz =
+      static_cast<double>(_engine.getCenterFrequency()) +
+      ((_bwCursorLockedX - 0.5) * static_cast<double>(_engine.getSampleRate()));
+   const double hzPerBin = frame.bandwidthHz / static_cast<double>(totalBins);
+   const double frameStartHz = frame.centerFreqHz - (frame.bandwidthHz / 2.0);
 
-   const double cursorCenterBin =
-      _bwCursorLockedX * static_cast<double>(totalBins);
+   const double cursorCenterBin = (channelCenterHz - frameStartHz) / hzPerBin;
    const double halfWidthBins = _bwCursorHalfWidthHz / hzPerBin;
 
    auto startBin = static_cast<size_t>(
       std::max(0.0, cursorCenterBin - halfWidthBins));
    auto endBin = static_cast<size_t>(
-      std::min(static_cast<double>(totalBins),
-               cursorCenterBin + halfWidthBins));
+      std::clamp(cursorCenterBin + halfWidthBins, 0.0, static_cast<double>(totalBins)));
 
    if (endBin <= startBin)
    {
       return;
    }
 
-   // Extract only the bins within the cursor region.
-   const std::vector<float> region(bins.begin() + static_cast<ptrdiff_t>(startBin),
-                                   bins.begin() + static_cast<ptrdiff_t>(endBin));
-
-   // Decimate the extracted region for display.
-   const auto decimated = SdrEngine::decimateSpectrum(region);
-   _ui->_detailedSpectrumWidget->setData(decimated);
+   // Read the cursor region in place from the finest tier that fits the
+   // widget; if the pyramid is not deep enough, decimate on the stack.
+   // setData() copies into the widget's existing buffer.
+   const auto view = SdrEngine::selectSpectrumView(frame, startBin, endBin - startBin,
+                                                   DISPLAY_POINTS);
+   if (view.maxDb.size() <= DISPLAY_POINTS)
+   {
+      _ui->_detailedSpectrumWidget->setData(view.maxDb);
+   }
+   else
+   {
+      std::array<float, DISPLAY_POINTS> points{};
+      const std::size_t count = SdrEngine::decimateSpectrum(view.maxDb, points);
+      _ui->_detailedSpectrumWidget->setData(std::span(points).first(count));
+   }
 }
 
 // ============================================================================
@@ -885,31 +1130,79 @@ uint32_t MainWindow::sampleRateFromIndex(int index)
 
 void MainWindow::refreshDevices()
 {
-   if (_engine.isRunning())
+   if (_engine.isRunning() || _deviceCombo == nullptr || _probing)
    {
       return;
    }
+   _probing = true;
+   if (_refreshDevicesBtn != nullptr)
+   {
+      _refreshDevicesBtn->setEnabled(false);
+   }
+
+   // The previous probe has finished (its completion cleared _probing).
+   if (_probeThread.joinable())
+   {
+      _probeThread.join();
+   }
+
+   // Scan all SoapySDR devices (RTL-SDR, Pluto, HackRF, etc.).  The result
+   // is cached, so starting the selected device does not probe again.
+   _probeThread = std::thread([this]()
+   {
+      CommonUtils::configureCurrentThread("RadioWizard.deviceProbe");
+      auto devices = SdrEngine::SoapySdrDevice::probeDevices();
+      QMetaObject::invokeMethod(
+         this,
+         [this, devices = std::move(devices)]() mutable
+         {
+            _probing = false;
+            if (_refreshDevicesBtn != nullptr && !_engine.isRunning())
+            {
+               _refreshDevicesBtn->setEnabled(true);
+            }
+            GPINFO("Device scan found {} device(s)", devices.size());
+            saveDeviceCache(devices);
+            showDevices(std::move(devices));
+         },
+         Qt::QueuedConnection);
+   });
+}
+
+void MainWindow::showDevices(std::vector<SdrEngine::DeviceInfo> devices)
+{
    if (_deviceCombo == nullptr)
    {
       return;
    }
 
+   // Keep the selected device across the update; indices may have moved.
+   std::size_t select = 0;
+   const int current  = _deviceCombo->currentIndex();
+   if (current >= 0 && static_cast<std::size_t>(current) < _detectedDevices.size())
+   {
+      const auto& previous = _detectedDevices[static_cast<std::size_t>(current)].info;
+      const auto it = std::find_if(devices.begin(), devices.end(), [&](const auto& info)
+                                   { return info.name == previous.name &&
+                                            info.serial == previous.serial; });
+      if (it != devices.end())
+      {
+         select = static_cast<std::size_t>(it - devices.begin());
+      }
+   }
+
    // Block signals while repopulating so we don't trigger applyDeviceSelection
    // for every intermediate state.
    _deviceCombo->blockSignals(true);
    _deviceCombo->clear();
    _detectedDevices.clear();
 
-   // Scan all SoapySDR devices (RTL-SDR, Pluto, HackRF, etc.)
+   for (auto& info : devices)
    {
-      const SdrEngine::SoapySdrDevice probe;
-      for (auto& info : probe.enumerateDevices())
-      {
-         DetectedDevice entry;
-         entry.backend = DeviceBackend::SoapySdr;
-         entry.info    = std::move(info);
-         _detectedDevices.push_back(std::move(entry));
-      }
+      DetectedDevice entry;
+      entry.backend = DeviceBackend::SoapySdr;
+      entry.info    = std::move(info);
+      _detectedDevices.push_back(std::move(entry));
    }
 
    // Populate the combo box.
@@ -926,19 +1219,17 @@ void MainWindow::refreshDevices()
 
    if (_detectedDevices.empty())
    {
-      _deviceCombo->addItem("(no devices found)");
+      _deviceCombo->addItem(_probing ? "(scanning...)" : "(no devices found)");
    }
 
    _deviceCombo->blockSignals(false);
 
-   // Auto-select the first device.
    if (!_detectedDevices.empty())
    {
-      _deviceCombo->setCurrentIndex(0);
-      applyDeviceSelection(0);
+      const auto index = static_cast<int>(select);
+      _deviceCombo->setCurrentIndex(index);
+      applyDeviceSelection(index);
    }
-
-   GPINFO("Device scan found {} device(s)", _detectedDevices.size());
 }
 
 void MainWindow::applyDeviceSelection(int comboIndex)
@@ -953,7 +1244,8 @@ void MainWindow::applyDeviceSelection(int comboIndex)
       return;
    }
 
-   const auto& dev = _detectedDevices[static_cast<std::size_t>(comboIndex)];
-   static_cast<void>(dev); // All devices use SoapySDR now.
+   // All devices use SoapySDR now; open() takes the cached probe arguments.
+   const auto& dev      = _detectedDevices[static_cast<std::size_t>(comboIndex)];
+   _selectedDeviceIndex = dev.info.index;
    _engine.setDevice(std::make_unique<SdrEngine::SoapySdrDevice>());
 }
@@ -12,10 +12,14 @@
 
 // System headers
 #include <memory>
+#include <thread>
 #include <vector>
 
+class QCheckBox;
 class QComboBox;
+class QLabel;
 class QPushButton;
+class QTimer;
 
 QT_BEGIN_NAMESPACE
 
@@ -75,10 +79,10 @@ private:
    // Remove DataHandler listeners on shutdown.
    void disconnectDataHandlers();
 
-   // Switch constellation plot to use unfiltered IQ data.
+   // Feed the constellation and oscilloscope from the unfiltered IQ data.
    void switchToUnfilteredIq();
 
-   // Switch constellation plot to use filtered IQ data.
+   // Feed the constellation and oscilloscope from the filtered IQ data.
    void switchToFilteredIq();
 
    // Start demodulation and audio playback.
@@ -90,21 +94,30 @@ private:
    // Update Demod button/combo enabled state based on BW cursor lock.
    void updateDemodButtonState();
 
+   // Show the audio output's latency and fill telemetry.
+   void updateAudioStats();
+
    // Get the currently selected DemodMode from the combo box.
    [[nodiscard]] SdrEngine::DemodMode selectedDemodMode() const;
 
    // Map the sample-rate combo index to Hz.
    static uint32_t sampleRateFromIndex(int index);
 
-   // Scan all device backends and populate the device combo box.
+   // Probe the device backends on a background thread; the combo box is
+   // repopulated when the probe finishes.  No-op while a probe runs.
    void refreshDevices();
 
+   // Fill the device combo box, keeping the current device selected if it
+   // is still listed (else the first).
+   void showDevices(std::vector<SdrEngine::DeviceInfo> devices);
+
    // Apply the combo-box selection: create the right device and inject it.
    void applyDeviceSelection(int comboIndex);
 
-   // Extract the BW-cursor region from the cached spectrum, decimate, and
-   // send to the detailed spectrum widget with a relative-offset X-axis.
-   void updateDetailedSpectrum();
+   // Show the BW-cursor region of `frame` (wideband or zoom spectrum) in
+   // the detailed spectrum widget, read from the frame's pyramid without
+   // allocating.
+   void updateDetailedSpectrum(const SdrEngine::SpectrumData& frame);
 
    // Identifies which backend + hardware index a combo entry refers to.
    enum class DeviceBackend : uint8_t { SoapySdr };
@@ -118,11 +131,14 @@ private:
    QComboBox* _deviceCombo{nullptr};
    QPushButton* _refreshDevicesBtn{nullptr};
    std::vector<DetectedDevice> _detectedDevices;
+   int _selectedDeviceIndex{0};   // Backend index of the combo selection.
+   std::thread _probeThread;      // Joined before the window goes away.
+   bool _probing{false};          // GUI thread only.
    SdrEngine::SdrEngine _engine;
 
    int _spectrumListenerId{-1};
-   int _iqListenerId{-1};
-   int _filteredIqListenerId{-1};
+   int _displayIqListenerId{-1};
+   int _zoomSpectrumListenerId{-1};
 
    // Cached bandwidth cursor state for channel filter configuration.
    double _bwCursorHalfWidthHz{100'000.0};
@@ -131,10 +147,14 @@ private:
    // Last full spectrum data, cached for extracting the cursor region.
    std::shared_ptr<const SdrEngine::SpectrumData> _lastSpectrumData;
 
-   // Demodulation and audio output.
-   SdrEngine::Demodulator _demod;
+   // Demodulation (a channel on the engine's DemodExecutor) and audio output.
+   int _demodChannelId{-1};
    std::unique_ptr<AudioOutput> _audioOutput;
    int _demodListenerId{-1};
+   int _audioListenerId{-1};
+   QCheckBox* _lowLatencyCheck{nullptr};
+   QLabel* _audioLatencyLabel{nullptr};
+   QTimer* _audioStatsTimer{nullptr};
    bool _bwCursorLocked{false};
 };
 
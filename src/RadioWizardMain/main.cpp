@@ -1,12 +1,17 @@
 #include "MainWindow.h"
 
 #include "GeneralLogger.h"
+#include "Profiler.h"
 #include "StackTrace.h"
+#include "ThreadConfig.h"
 
 #include <QApplication>
 #include <QPalette>
 #include <QStyleFactory>
 
+#include <cstdlib>
+#include <string>
+
 int main(int argc, char* argv[])
 {
    CommonUtils::GeneralLogger logger;
@@ -29,6 +34,25 @@ int main(int argc, char* argv[])
    });
    CommonUtils::StackTrace::installSignalHandlers();
 
+   // RADIOWIZARD_THREADS=<file>: per-role CPU affinity and real-time
+   // priority (see ThreadConfig), applied as each thread starts.
+   const char* threadConfigPath = std::getenv("RADIOWIZARD_THREADS");
+   std::string threadConfigError;
+   if (threadConfigPath != nullptr &&
+       !CommonUtils::ThreadConfig::instance().loadFile(threadConfigPath, &threadConfigError))
+   {
+      GPERROR("Thread configuration {} ignored: {}", threadConfigPath, threadConfigError);
+   }
+   CommonUtils::configureCurrentThread("GUI");
+
+   // RADIOWIZARD_PROFILE=<file.json>: record profiling zones and write a
+   // Chrome trace (chrome://tracing, ui.perfetto.dev) on exit.
+   const char* profilePath = std::getenv("RADIOWIZARD_PROFILE");
+   if (profilePath != nullptr)
+   {
+      CommonUtils::Profiler::setEnabled(true);
+   }
+
    const QApplication a(argc, argv);
 
    // Apply a dark color palette to the entire application.
@@ -60,6 +84,12 @@ int main(int argc, char* argv[])
 
    MainWindow w;
    w.show();
-   return QApplication::exec();
+   const int result = QApplication::exec();
+
+   if (profilePath != nullptr && !CommonUtils::Profiler::writeChromeTrace(profilePath))
+   {
+      GPERROR("Could not write profile to {}", profilePath);
+   }
+   return result;
 }
 
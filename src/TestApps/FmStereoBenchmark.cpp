@@ -0,0 +1,268 @@
+// =============================================================================
+// FmStereoBenchmark
+// =============================================================================
+// Compares the CPU cost of the two FM stereo demodulation chains:
+//   Per-sample  - the original Demodulator path: liquid-dsp pilot band-pass,
+//                 NCO PLL and L+R / L-R FIR filters pushed one sample at a
+//                 time, then de-emphasis and resampling at the full
+//                 composite rate.
+//   Block       - Demodulator::demodulateInto() with FmStereoDecoder: block
+//                 pilot filter, table-driven 38 kHz carrier, decimating
+//                 DspKernels FIR, then de-emphasis and resampling at the
+//                 decimated rate.
+// Both run freqdem on the same FM stereo broadcast signal.  Reports ns per
+// input sample and the share of one core each stereo channel needs in real
+// time at the given channel rate.
+//
+// Usage: ./FmStereoBenchmark [seconds] [channelRate]
+//        seconds     - Seconds of signal demodulated per test (default: 20)
+//        channelRate - Composite sample rate in Hz (default: 240000)
+// =============================================================================
+
+#include "Demodulator.h"
+#include "DspKernels.h"
+#include "GeneralLogger.h"
+#include "SdrTypes.h"
+
+#include <liquid/liquid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr std::size_t BLOCK_SAMPLES = 8192;
+constexpr double AUDIO_RATE = 48000.0;
+
+// 1 kHz on the left, 3 kHz on the right, 10 % pilot, 75 kHz deviation.
+std::vector<SdrEngine::IqSample> generateBroadcast(std::size_t samples, double rate)
+{
+   std::vector<SdrEngine::IqSample> iq(samples);
+   double phase = 0.0;
+   for (std::size_t i = 0; i < samples; ++i)
+   {
+      const double t = static_cast<double>(i) / rate;
+      const double left = std::sin(2.0 * std::numbers::pi * 1000.0 * t);
+      const double right = std::sin(2.0 * std::numbers::pi * 3000.0 * t);
+      const double pilot = 2.0 * std::numbers::pi * 19000.0 * t;
+      const double mpx = (0.45 * (left + right)) + (0.45 * (left - right) * std::sin(2.0 * pilot)) +
+                         (0.1 * std::sin(pilot));
+      phase += 2.0 * std::numbers::pi * 75000.0 * mpx / rate;
+      iq[i] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+   }
+   return iq;
+}
+
+// The per-sample chain Demodulator ran before FmStereoDecoder, kept here
+// as the reference.
+class PerSampleStereo
+{
+public:
+   explicit PerSampleStereo(double rate)
+   {
+      const auto fs = static_cast<float>(rate);
+      _fmDemod = freqdem_create(static_cast<float>(75000.0 / rate));
+
+      constexpr unsigned int BPF_LEN = 127;
+      const float f0 = (19000.0F - 250.0F) / fs;
+      const float f1 = (19000.0F + 250.0F) / fs;
+      const float delta = 0.002F;
+      float bands[6] = {0.0F, f0 - delta, f0, f1, f1 + delta, 0.5F};
+      float des[3] = {0.0F, 1.0F, 0.0F};
+      float weights[3] = {1.0F, 1.0F, 1.0F};
+      std::vector<float> h(BPF_LEN);
+      firdespm_run(BPF_LEN, 3, bands, des, weights, nullptr, LIQUID_FIRDESPM_BANDPASS, h.data());
+      _pilotBpf = firfilt_rrrf_create(h.data(), BPF_LEN);
+
+      _pilotPll = nco_crcf_create(LIQUID_NCO);
+      nco_crcf_set_frequency(_pilotPll, 2.0F * std::numbers::pi_v<float> * 19000.0F / fs);
+      nco_crcf_pll_set_bandwidth(_pilotPll, 0.002F);
+
+      constexpr unsigned int LPF_LEN = 65;
+      std::vector<float> lpf(LPF_LEN);
+      liquid_firdes_kaiser(LPF_LEN, 15000.0F / fs, 60.0F, 0.0F, lpf.data());
+      _monoLpf = firfilt_rrrf_create(lpf.data(), LPF_LEN);
+      _diffLpf = firfilt_rrrf_create(lpf.data(), LPF_LEN);
+
+      const auto alpha = static_cast<float>(std::exp(-1.0 / (75.0e-6 * rate)));
+      float b[2] = {1.0F - alpha, 0.0F};
+      float a[2] = {1.0F, -alpha};
+      _deemphasisL = iirfilt_rrrf_create(b, 2, a, 2);
+      _deemphasisR = iirfilt_rrrf_create(b, 2, a, 2);
+
+      _resamplerL = msresamp_rrrf_create(static_cast<float>(AUDIO_RATE / rate), 60.0F);
+      _resamplerR = msresamp_rrrf_create(static_cast<float>(AUDIO_RATE / rate), 60.0F);
+
+      _composite.resize(BLOCK_SAMPLES);
+      _left.resize(BLOCK_SAMPLES);
+      _right.resize(BLOCK_SAMPLES);
+      _audioL.resize(BLOCK_SAMPLES);
+      _audioR.resize(BLOCK_SAMPLES);
+   }
+
+   ~PerSampleStereo()
+   {
+      freqdem_destroy(_fmDemod);
+      firfilt_rrrf_destroy(_pilotBpf);
+      nco_crcf_destroy(_pilotPll);
+      firfilt_rrrf_destroy(_monoLpf);
+      firfilt_rrrf_destroy(_diffLpf);
+      iirfilt_rrrf_destroy(_deemphasisL);
+      iirfilt_rrrf_destroy(_deemphasisR);
+      msresamp_rrrf_destroy(_resamplerL);
+      msresamp_rrrf_destroy(_resamplerR);
+   }
+
+   PerSampleStereo(const PerSampleStereo&) = delete;
+   PerSampleStereo& operator=(const PerSampleStereo&) = delete;
+   PerSampleStereo(PerSampleStereo&&) = delete;
+   PerSampleStereo& operator=(PerSampleStereo&&) = delete;
+
+   unsigned int process(const SdrEngine::IqSample* iq, unsigned int n)
+   {
+      freqdem_demodulate_block(
+         _fmDemod, const_cast<liquid_float_complex*>(reinterpret_cast<const liquid_float_complex*>(iq)),
+         n, _composite.data());
+
+      for (unsigned int i = 0; i < n; ++i)
+      {
+         const float x = _composite[i];
+         float mono = 0.0F;
+         firfilt_rrrf_push(_monoLpf, x);
+         firfilt_rrrf_execute(_monoLpf, &mono);
+
+         float pilot = 0.0F;
+         firfilt_rrrf_push(_pilotBpf, x);
+         firfilt_rrrf_execute(_pilotBpf, &pilot);
+
+         liquid_float_complex nco;
+         nco_crcf_cexpf(_pilotPll, &nco);
+         nco_crcf_pll_step(_pilotPll, pilot * nco.imag());
+         nco_crcf_step(_pilotPll);
+
+         const float cos2theta = (2.0F * nco.real() * nco.real()) - 1.0F;
+         float diff = 0.0F;
+         firfilt_rrrf_push(_diffLpf, x * cos2theta * 2.0F);
+         firfilt_rrrf_execute(_diffLpf, &diff);
+
+         float outL = 0.0F;
+         float outR = 0.0F;
+         iirfilt_rrrf_execute(_deemphasisL, (mono + diff) * 0.5F, &outL);
+         iirfilt_rrrf_execute(_deemphasisR, (mono - diff) * 0.5F, &outR);
+         _left[i] = outL;
+         _right[i] = outR;
+      }
+
+      unsigned int framesL = 0;
+      unsigned int framesR = 0;
+      msresamp_rrrf_execute(_resamplerL, _left.data(), n, _audioL.data(), &framesL);
+      msresamp_rrrf_execute(_resamplerR, _right.data(), n, _audioR.data(), &framesR);
+      return std::min(framesL, framesR);
+   }
+
+private:
+   freqdem_s* _fmDemod{nullptr};
+   firfilt_rrrf_s* _pilotBpf{nullptr};
+   nco_crcf_s* _pilotPll{nullptr};
+   firfilt_rrrf_s* _monoLpf{nullptr};
+   firfilt_rrrf_s* _diffLpf{nullptr};
+   iirfilt_rrrf_s* _deemphasisL{nullptr};
+   iirfilt_rrrf_s* _deemphasisR{nullptr};
+   msresamp_rrrf_s* _resamplerL{nullptr};
+   msresamp_rrrf_s* _resamplerR{nullptr};
+   std::vector<float> _composite;
+   std::vector<float> _left;
+   std::vector<float> _right;
+   std::vector<float> _audioL;
+   std::vector<float> _audioR;
+};
+
+void logResult(const char* path, double nsPerSample, double rate, double baselineNs)
+{
+   // A channel at `rate` S/s keeps a core busy ns * rate / 1e9 of the time.
+   GPINFO("{:<14s}{:<14.2f}{:<18.2f}{:<10.2f}", path, nsPerSample, nsPerSample * rate * 1.0e-7,
+          baselineNs / nsPerSample);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char* argv[]) // NOLINT
+{
+   CommonUtils::GeneralLogger logger;
+   logger.init("FmStereoBenchmark");
+
+   double seconds = 20.0;
+   double rate = 240000.0;
+   if (argc > 1) { seconds = std::stod(argv[1]); }
+   if (argc > 2) { rate = std::stod(argv[2]); }
+   seconds = std::max(seconds, 1.0);
+   rate = std::max(rate, SdrEngine::FmStereoDecoder::MIN_INPUT_RATE);
+
+   // One second of signal, demodulated over and over.
+   const auto signal = generateBroadcast(static_cast<std::size_t>(rate) / BLOCK_SAMPLES * BLOCK_SAMPLES,
+                                         rate);
+   const auto blocks = static_cast<std::size_t>(seconds * rate) / BLOCK_SAMPLES;
+   const auto totalSamples = static_cast<double>(blocks * BLOCK_SAMPLES);
+
+   GPINFO("==========================================================");
+   GPINFO("FM Stereo Demodulation Benchmark");
+   GPINFO("==========================================================");
+   GPINFO("  Kernel ISA:       {}", SdrEngine::dspKernelIsa());
+   GPINFO("  Channel rate:     {:.0f} Hz", rate);
+   GPINFO("  Block size:       {} samples", BLOCK_SAMPLES);
+   GPINFO("  Signal:           {:.1f} s", seconds);
+   GPINFO("==========================================================");
+   GPINFO("{:<14s}{:<14s}{:<18s}{:<10s}", "Path", "ns/sample", "% core/channel", "Speed-up");
+   GPINFO("{}", std::string(56, '-'));
+
+   // ----- Per-sample liquid-dsp chain -----
+   PerSampleStereo reference(rate);
+   auto start = std::chrono::steady_clock::now();
+   for (std::size_t b = 0; b < blocks; ++b)
+   {
+      const std::size_t offset = (b * BLOCK_SAMPLES) % signal.size();
+      static_cast<void>(reference.process(signal.data() + offset, BLOCK_SAMPLES));
+   }
+   const double referenceNs =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+      totalSamples;
+
+   // ----- Block decoder in Demodulator -----
+   SdrEngine::Demodulator demod;
+   demod.configure(SdrEngine::DemodMode::FmStereo, rate, AUDIO_RATE, BLOCK_SAMPLES);
+   std::vector<float> interleaved(2 * demod.maxOutputFrames(BLOCK_SAMPLES));
+   start = std::chrono::steady_clock::now();
+   for (std::size_t b = 0; b < blocks; ++b)
+   {
+      const std::size_t offset = (b * BLOCK_SAMPLES) % signal.size();
+      static_cast<void>(demod.demodulateInto(
+         std::span<const SdrEngine::IqSample>(signal.data() + offset, BLOCK_SAMPLES), interleaved));
+   }
+   const double blockNs =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+      totalSamples;
+
+   logResult("per-sample", referenceNs, rate, referenceNs);
+   logResult("block", blockNs, rate, referenceNs);
+
+   GPINFO("==========================================================");
+   GPINFO("Benchmark complete.");
+   GPINFO("==========================================================");
+
+   return 0;
+}
@@ -0,0 +1,183 @@
+// =============================================================================
+// IqConversionBenchmark
+// =============================================================================
+// Compares the CPU cost of the two ways device samples reach the SdrEngine
+// sample ring:
+//   CF32 path   - the driver converts native integers to a float buffer
+//                 (scalar, as SoapySDR does for CF32 streams), then the
+//                 engine copies that buffer into the ring.
+//   Native path - the engine converts the native CS8 / CS16 block straight
+//                 into the ring's free regions with the DspKernels, with
+//                 and without the fused DC blocker.
+// Reports ns per sample and the share of one core needed per MS/s.
+//
+// Usage: ./IqConversionBenchmark [iterations]
+//        iterations - Number of blocks streamed per test (default: 20000)
+// =============================================================================
+
+#include "DspKernels.h"
+#include "GeneralLogger.h"
+#include "IqSampleRing.h"
+#include "SdrTypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr std::size_t BLOCK_SAMPLES = 16384;
+constexpr std::size_t RING_SAMPLES  = 1U << 20;
+
+template <typename Int>
+std::vector<Int> generateBlock(std::size_t samples, uint32_t seed = 12345)
+{
+   std::vector<Int> block(2 * samples);
+   std::mt19937 gen(seed);
+   std::uniform_int_distribution<int> dist(std::numeric_limits<Int>::min(),
+                                           std::numeric_limits<Int>::max());
+   std::generate(block.begin(), block.end(), [&] { return static_cast<Int>(dist(gen)); });
+   return block;
+}
+
+// What the driver does for a CF32 stream: one scalar pass to floats.
+template <typename Int>
+void driverConvertToCf32(const Int* src, float* dst, std::size_t values, float scale)
+{
+   for (std::size_t i = 0; i < values; ++i)
+   {
+      dst[i] = static_cast<float>(src[i]) * scale;
+   }
+}
+
+// Mirror of SdrEngine::onIqData(): convert (and optionally DC-block)
+// straight into the ring.
+void nativeIntoRing(SdrEngine::IqSampleRing& ring, const SdrEngine::RawIqBlock& block,
+                    SdrEngine::DcBlockerState* dc)
+{
+   const auto regions = ring.prepareWrite(block.numSamples);
+   if (dc != nullptr)
+   {
+      SdrEngine::convertToIqDcBlocked(block, 0, regions.first.data(), regions.first.size(), *dc);
+      SdrEngine::convertToIqDcBlocked(block, regions.first.size(), regions.second.data(),
+                                      regions.second.size(), *dc);
+   }
+   else
+   {
+      SdrEngine::convertToIq(block, 0, regions.first.data(), regions.first.size());
+      SdrEngine::convertToIq(block, regions.first.size(), regions.second.data(),
+                             regions.second.size());
+   }
+   ring.commitWrite(regions.size());
+}
+
+void logHeader()
+{
+   GPINFO("{:<8s}{:<14s}{:<14s}{:<16s}{:<10s}", "Format", "Path", "ns/sample", "% core/(MS/s)",
+          "Speed-up");
+   GPINFO("{}", std::string(62, '-'));
+}
+
+void logResult(const char* format, const char* path, double nsPerSample, double baselineNs)
+{
+   // 1 MS/s at `ns` per sample keeps a core busy ns * 1e6 / 1e9 of the time.
+   GPINFO("{:<8s}{:<14s}{:<14.3f}{:<16.3f}{:<10.2f}", format, path, nsPerSample,
+          nsPerSample * 0.1, baselineNs / nsPerSample);
+}
+
+template <typename Int>
+void runFormat(const char* name, SdrEngine::IqSampleFormat format, float fullScale,
+               int iterations)
+{
+   const auto raw = generateBlock<Int>(BLOCK_SAMPLES);
+   const SdrEngine::RawIqBlock block{raw.data(), format, BLOCK_SAMPLES, fullScale};
+   const auto totalSamples = static_cast<double>(BLOCK_SAMPLES) * iterations;
+
+   SdrEngine::IqSampleRing ring(RING_SAMPLES);
+   std::vector<SdrEngine::IqSample> cf32(BLOCK_SAMPLES);
+
+   // ----- CF32 path: driver conversion + ring copy -----
+   auto start = std::chrono::steady_clock::now();
+   for (int i = 0; i < iterations; ++i)
+   {
+      driverConvertToCf32(raw.data(), reinterpret_cast<float*>(cf32.data()), raw.size(),
+                          1.0F / fullScale);
+      std::ignore = ring.write(cf32.data(), cf32.size());
+      ring.consume(ring.available());
+   }
+   const double cf32Ns =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+      totalSamples;
+
+   // ----- Native path: vectorised conversion into the ring -----
+   start = std::chrono::steady_clock::now();
+   for (int i = 0; i < iterations; ++i)
+   {
+      nativeIntoRing(ring, block, nullptr);
+      ring.consume(ring.available());
+   }
+   const double nativeNs =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+      totalSamples;
+
+   // ----- Native path with the fused DC blocker -----
+   SdrEngine::DcBlockerState dc{SdrEngine::dcBlockerAlpha(0.01F, 2.4e6), {}};
+   start = std::chrono::steady_clock::now();
+   for (int i = 0; i < iterations; ++i)
+   {
+      nativeIntoRing(ring, block, &dc);
+      ring.consume(ring.available());
+   }
+   const double dcNs =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+      totalSamples;
+
+   logResult(name, "CF32", cf32Ns, cf32Ns);
+   logResult(name, "native", nativeNs, cf32Ns);
+   logResult(name, "native+DC", dcNs, cf32Ns);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char* argv[]) // NOLINT
+{
+   CommonUtils::GeneralLogger logger;
+   logger.init("IqConversionBenchmark");
+
+   int iterations = 20000;
+   if (argc > 1) { iterations = std::stoi(argv[1]); }
+   iterations = std::max(iterations, 1);
+
+   GPINFO("==========================================================");
+   GPINFO("I/Q Conversion Benchmark");
+   GPINFO("==========================================================");
+   GPINFO("  Kernel ISA:       {}", SdrEngine::dspKernelIsa());
+   GPINFO("  Block size:       {} samples", BLOCK_SAMPLES);
+   GPINFO("  Blocks per test:  {}", iterations);
+   GPINFO("==========================================================");
+
+   logHeader();
+   runFormat<int8_t>("CS8", SdrEngine::IqSampleFormat::CS8, 128.0F, iterations);
+   runFormat<int16_t>("CS16", SdrEngine::IqSampleFormat::CS16, 32768.0F, iterations);
+
+   GPINFO("==========================================================");
+   GPINFO("Benchmark complete.");
+   GPINFO("==========================================================");
+
+   return 0;
+}
@@ -0,0 +1,386 @@
+// =============================================================================
+// PubSubBenchmark
+// =============================================================================
+// Measures what the HighBandwidth UDP transport sustains on this host.  A
+// publisher and a subscriber run in one process; every combination of
+// message size, publisher MTU and send rate is streamed for a fixed time
+// and reports:
+//   throughput  - payload Mbit/s delivered to the subscriber's handler
+//   loss        - share of published messages never delivered
+//   CPU per GB  - process CPU seconds (publisher + subscriber) per GB
+//                 delivered
+//   latency     - one-way publish-to-handler percentiles, from the send
+//                 timestamp carried in each message
+// Messages are messages::IqFrame; the handler reads only `timestamp_ns`,
+// without copying the payload, so it costs next to nothing.
+//
+// Usage: ./PubSubBenchmark [--sizes 1K,16K,256K,1M,16M] [--mtus 1400,8972]
+//                          [--rates 0,1000] [--seconds 2] [--group 239.192.1.1]
+//                          [--port 5690] [--json results.json]
+//        sizes   - Payload sizes, with optional K / M suffix (1 KB to 16 MB)
+//        mtus    - Publisher MTUs in bytes
+//        rates   - Pacing rates in Mbit/s; 0 sends as fast as possible
+//        seconds - Streaming time per case
+//        group   - Multicast group (the subscriber joins it, the publisher
+//                  sends to it on the default interface)
+//        json    - Also write every case to this file, for regression tracking
+// =============================================================================
+
+#include "GeneralLogger.h"
+#include "HighBandwidthPublisher.h"
+#include "HighBandwidthSubscriber.h"
+#include "LatencyHistogram.h"
+
+#include <signal_data.pb.h>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr const char* TOPIC = "frames";
+constexpr int REASSEMBLY_TIMEOUT_MS = 2000;
+constexpr int RECEIVE_BUFFER_BYTES = 64 << 20;
+
+struct Options
+{
+   std::vector<std::size_t> sizes{1U << 10, 16U << 10, 256U << 10, 1U << 20, 16U << 20};
+   std::vector<std::size_t> mtus{1400, 8972};
+   std::vector<double> ratesMbps{0.0, 1000.0};
+   double seconds{2.0};
+   std::string group{"239.192.1.1"};
+   uint16_t port{5690};
+   std::string jsonPath;
+};
+
+struct CaseResult
+{
+   std::size_t size{0};
+   std::size_t mtu{0};
+   double rateMbps{0.0};
+   uint64_t sent{0};
+   uint64_t received{0};
+   double seconds{0.0};
+   double throughputMbps{0.0};
+   double lossPercent{0.0};
+   double cpuSecondsPerGb{0.0};
+   CommonUtils::LatencySummary latency;
+};
+
+/// "64K" -> 65536, "16M" -> 16777216.
+std::size_t parseSize(const std::string& text)
+{
+   std::size_t suffix = 0;
+   const std::size_t value = std::stoul(text, &suffix);
+   if (suffix < text.size())
+   {
+      switch (text[suffix])
+      {
+         case 'k':
+         case 'K':
+            return value << 10;
+         case 'm':
+         case 'M':
+            return value << 20;
+         default:
+            break;
+      }
+   }
+   return value;
+}
+
+template <typename T, typename Parse>
+std::vector<T> parseList(const std::string& text, Parse parse)
+{
+   std::vector<T> values;
+   std::size_t begin = 0;
+   while (begin <= text.size())
+   {
+      const std::size_t end = std::min(text.find(',', begin), text.size());
+      if (end > begin)
+      {
+         values.push_back(parse(text.substr(begin, end - begin)));
+      }
+      begin = end + 1;
+   }
+   return values;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) // NOLINT
+{
+   for (int i = 1; i + 1 < argc; i += 2)
+   {
+      const std::string key = argv[i];
+      const std::string value = argv[i + 1];
+      if (key == "--sizes") { options.sizes = parseList<std::size_t>(value, parseSize); }
+      else if (key == "--mtus") { options.mtus = parseList<std::size_t>(value, parseSize); }
+      else if (key == "--rates")
+      {
+         options.ratesMbps = parseList<double>(value, [](const std::string& s) { return std::stod(s); });
+      }
+      else if (key == "--seconds") { options.seconds = std::stod(value); }
+      else if (key == "--group") { options.group = value; }
+      else if (key == "--port") { options.port = static_cast<uint16_t>(std::stoul(value)); }
+      else if (key == "--json") { options.jsonPath = value; }
+      else
+      {
+         GPERROR("Unknown option {}", key);
+         return false;
+      }
+   }
+   return (argc % 2) == 1;
+}
+
+/// User + system CPU time of the whole process.
+double processCpuSeconds()
+{
+   rusage usage{};
+   getrusage(RUSAGE_SELF, &usage);
+   const auto seconds = [](const timeval& tv)
+   { return static_cast<double>(tv.tv_sec) + (static_cast<double>(tv.tv_usec) * 1e-6); };
+   return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+int64_t nowNs()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Read IqFrame `timestamp_ns` (field 2, serialized ahead of the payload)
+/// without parsing the samples.
+bool readSendTimestamp(std::string_view data, int64_t& timestampNs)
+{
+   using google::protobuf::internal::WireFormatLite;
+   google::protobuf::io::CodedInputStream in(reinterpret_cast<const uint8_t*>(data.data()),
+                                             static_cast<int>(std::min<std::size_t>(data.size(), 64)));
+   timestampNs = 0;
+   while (const uint32_t tag = in.ReadTag())
+   {
+      const int field = WireFormatLite::GetTagFieldNumber(tag);
+      uint64_t value = 0;
+      if (field > 2 || !in.ReadVarint64(&value))
+      {
+         break;   // Everything from field 3 on is tuning and payload
+      }
+      if (field == 2)
+      {
+         timestampNs = static_cast<int64_t>(value);
+      }
+   }
+   return timestampNs != 0;
+}
+
+/// Delivery counters shared with the subscriber's receive thread.
+struct Receiver
+{
+   std::atomic<uint64_t> received{0};
+   std::atomic<uint64_t> payloadBytes{0};
+   std::atomic<int64_t> lastArrivalNs{0};
+   CommonUtils::LatencyHistogram latency;
+};
+
+CaseResult runCase(const Options& options, std::size_t size, std::size_t mtu, double rateMbps)
+{
+   CaseResult result;
+   result.size = size;
+   result.mtu = mtu;
+   result.rateMbps = rateMbps;
+
+   // ----- Subscriber -----
+   Receiver receiver;
+   HighBandwidthSubscriber subscriber("PubSubBench", options.group, options.port, REASSEMBLY_TIMEOUT_MS);
+   subscriber.setReceiveBufferSize(RECEIVE_BUFFER_BYTES);
+   subscriber.setMaxDatagramSize(std::max<std::size_t>(mtu, 9216));
+   subscriber.subscribeView(TOPIC, [&receiver](std::string_view, std::string_view data)
+   {
+      int64_t sentNs = 0;
+      if (!readSendTimestamp(data, sentNs))
+      {
+         return;
+      }
+      const int64_t arrivalNs = nowNs();
+      receiver.latency.record(std::chrono::nanoseconds(arrivalNs - sentNs));
+      receiver.payloadBytes.fetch_add(data.size(), std::memory_order_relaxed);
+      receiver.lastArrivalNs.store(arrivalNs, std::memory_order_relaxed);
+      receiver.received.fetch_add(1, std::memory_order_relaxed);
+   });
+   if (!subscriber.start())
+   {
+      GPERROR("Subscriber failed to start on {}:{}", options.group, options.port);
+      return result;
+   }
+
+   // ----- Publisher -----
+   HighBandwidthPublisher publisher("PubSubBench", options.group, options.port, mtu);
+   if (rateMbps > 0.0)
+   {
+      publisher.setPacingRate(static_cast<uint64_t>(rateMbps * 1e6 / 8.0));
+   }
+   messages::IqFrame frame;
+   frame.set_encoding(messages::IQ_ENCODING_CS16);
+   frame.mutable_samples()->assign(size, '\x5A');
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(100));
+   const double cpuStart = processCpuSeconds();
+   const int64_t startNs = nowNs();
+   const int64_t endNs = startNs + static_cast<int64_t>(options.seconds * 1e9);
+   while (nowNs() < endNs)
+   {
+      frame.set_sequence(result.sent);
+      frame.set_timestamp_ns(nowNs());
+      if (publisher.publish(TOPIC, frame))
+      {
+         ++result.sent;
+      }
+   }
+
+   // Drain: stop once nothing has arrived for 200 ms (or everything has)
+   int64_t lastCount = -1;
+   while (receiver.received.load() < result.sent &&
+          static_cast<int64_t>(receiver.received.load()) != lastCount)
+   {
+      lastCount = static_cast<int64_t>(receiver.received.load());
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+   }
+   const double cpuSeconds = processCpuSeconds() - cpuStart;
+   subscriber.stop();
+
+   // ----- Results -----
+   result.received = receiver.received.load();
+   const int64_t lastNs = std::max(receiver.lastArrivalNs.load(), endNs);
+   result.seconds = static_cast<double>(lastNs - startNs) * 1e-9;
+   const auto bytes = static_cast<double>(receiver.payloadBytes.load());
+   result.throughputMbps = bytes * 8.0 / result.seconds / 1e6;
+   result.lossPercent = result.sent == 0 ? 0.0
+                           : 100.0 * static_cast<double>(result.sent - std::min(result.received, result.sent)) /
+                                static_cast<double>(result.sent);
+   result.cpuSecondsPerGb = bytes > 0.0 ? cpuSeconds / (bytes / 1e9) : 0.0;
+   result.latency = receiver.latency.summary();
+   return result;
+}
+
+std::string formatSize(std::size_t bytes)
+{
+   if (bytes >= (1U << 20) && bytes % (1U << 20) == 0) { return std::to_string(bytes >> 20) + "M"; }
+   if (bytes >= (1U << 10) && bytes % (1U << 10) == 0) { return std::to_string(bytes >> 10) + "K"; }
+   return std::to_string(bytes);
+}
+
+void logHeader()
+{
+   GPINFO("{:<7s}{:<6s}{:<8s}{:<9s}{:<10s}{:<8s}{:<10s}{:<10s}{:<10s}{:<10s}", "Size", "MTU", "Rate",
+          "Msgs", "Mbit/s", "Loss %", "CPU s/GB", "p50 us", "p99 us", "max us");
+   GPINFO("{}", std::string(88, '-'));
+}
+
+void logResult(const CaseResult& r)
+{
+   const std::string rate = r.rateMbps > 0.0 ? fmt::format("{:.0f}", r.rateMbps) : "max";
+   GPINFO("{:<7s}{:<6d}{:<8s}{:<9d}{:<10.1f}{:<8.2f}{:<10.3f}{:<10.1f}{:<10.1f}{:<10.1f}", formatSize(r.size),
+          r.mtu, rate, r.received, r.throughputMbps, r.lossPercent, r.cpuSecondsPerGb, r.latency.p50Us,
+          r.latency.p99Us, r.latency.maxUs);
+}
+
+bool writeJson(const std::string& path, const std::vector<CaseResult>& results)
+{
+   std::ofstream out(path);
+   if (!out)
+   {
+      return false;
+   }
+   out << "{\n  \"benchmark\": \"PubSubBenchmark\",\n  \"cases\": [\n";
+   for (std::size_t i = 0; i < results.size(); ++i)
+   {
+      const CaseResult& r = results[i];
+      out << fmt::format("    {{\"size_bytes\": {}, \"mtu\": {}, \"rate_mbps\": {}, \"sent\": {}, "
+                         "\"received\": {}, \"seconds\": {:.3f}, \"throughput_mbps\": {:.3f}, "
+                         "\"loss_percent\": {:.4f}, \"cpu_seconds_per_gb\": {:.4f}, "
+                         "\"latency_us\": {{\"mean\": {:.2f}, \"p50\": {:.2f}, \"p90\": {:.2f}, "
+                         "\"p99\": {:.2f}, \"max\": {:.2f}}}}}{}\n",
+                         r.size, r.mtu, r.rateMbps, r.sent, r.received, r.seconds, r.throughputMbps,
+                         r.lossPercent, r.cpuSecondsPerGb, r.latency.meanUs, r.latency.p50Us,
+                         r.latency.p90Us, r.latency.p99Us, r.latency.maxUs,
+                         i + 1 < results.size() ? "," : "");
+   }
+   out << "  ]\n}\n";
+   return static_cast<bool>(out);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char* argv[]) // NOLINT
+{
+   CommonUtils::GeneralLogger logger;
+   logger.init("PubSubBenchmark");
+
+   Options options;
+   if (!parseOptions(argc, argv, options))
+   {
+      GPERROR("Usage: {} [--sizes 1K,16M] [--mtus 1400,8972] [--rates 0,1000] [--seconds 2] "
+              "[--group 239.192.1.1] [--port 5690] [--json results.json]",
+              argv[0]);
+      return 1;
+   }
+
+   GPINFO("==========================================================");
+   GPINFO("PubSub Benchmark (HighBandwidth UDP, one process)");
+   GPINFO("==========================================================");
+   GPINFO("  Group:            {}:{}", options.group, options.port);
+   GPINFO("  Time per case:    {} s", options.seconds);
+   GPINFO("  Cases:            {}", options.sizes.size() * options.mtus.size() * options.ratesMbps.size());
+   GPINFO("==========================================================");
+
+   std::vector<CaseResult> results;
+   logHeader();
+   for (const std::size_t size : options.sizes)
+   {
+      for (const std::size_t mtu : options.mtus)
+      {
+         for (const double rate : options.ratesMbps)
+         {
+            results.push_back(runCase(options, size, mtu, rate));
+            logResult(results.back());
+         }
+      }
+   }
+
+   if (!options.jsonPath.empty())
+   {
+      if (!writeJson(options.jsonPath, results))
+      {
+         GPERROR("Failed to write {}", options.jsonPath);
+         return 1;
+      }
+      GPINFO("Results written to {}", options.jsonPath);
+   }
+
+   GPINFO("==========================================================");
+   GPINFO("Benchmark complete.");
+   GPINFO("==========================================================");
+
+   return 0;
+}
@@ -0,0 +1,462 @@
+// =============================================================================
+// RealTimeGraphsBenchmark
+// =============================================================================
+// Measures what the RealTimeGraphs widgets cost to paint.  Each widget is fed
+// synthetic data and painted offscreen (QWidget::render into a QImage), one
+// data update per frame, as fast as it goes.  For every combination of widget,
+// window size and load it reports:
+//   paint     - render() time percentiles per frame
+//   FPS       - frames (update + paint) achieved per second
+//   CPU       - process CPU time over wall time while the case runs
+// Spectrum and waterfall are loaded by bin count; constellation, density and
+// oscilloscope by sample rate, delivered in one block per frame at --fps.
+//
+// Usage: ./RealTimeGraphsBenchmark [--widgets spectrum,waterfall,constellation,
+//                                   density,oscilloscope] [--bins 1K,4K,64K]
+//                                  [--rates 1M,10M] [--sizes 800x400,1920x1080]
+//                                  [--fps 30] [--frames 300] [--json results.json]
+//        widgets - Widgets to measure (density: constellation in density mode)
+//        bins    - Spectrum / waterfall bins per row, with optional K / M suffix
+//        rates   - I/Q sample rates in S/s, with optional K / M suffix
+//        sizes   - Widget sizes in pixels
+//        fps     - Data frame rate the sample rates are split at
+//        frames  - Frames measured per case (after a short warm-up)
+//        json    - Also write every case to this file, for regression tracking
+// Runs on the offscreen Qt platform unless QT_QPA_PLATFORM says otherwise.
+// =============================================================================
+
+// Project headers
+#include "ConstellationWidget.h"
+#include "GeneralLogger.h"
+#include "LatencyHistogram.h"
+#include "OscilloscopeWidget.h"
+#include "SpectrumWidget.h"
+#include "WaterfallWidget.h"
+
+// Third-party headers
+#include <QApplication>
+#include <QImage>
+#include <QSize>
+
+// System headers
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr int WARMUP_FRAMES = 10;
+
+/// Distinct synthetic frames cycled through, generated before timing.
+constexpr std::size_t SYNTHETIC_FRAMES = 32;
+
+constexpr float TWO_PI = 2.0F * std::numbers::pi_v<float>;
+
+struct Options
+{
+   std::vector<std::string> widgets{"spectrum", "waterfall", "constellation", "density",
+                                    "oscilloscope"};
+   std::vector<std::size_t> bins{1U << 10, 4U << 10, 64U << 10};
+   std::vector<std::size_t> rates{1'000'000, 10'000'000};
+   std::vector<QSize> sizes{QSize(800, 400), QSize(1920, 1080)};
+   double fps{30.0};
+   int frames{300};
+   std::string jsonPath;
+};
+
+struct CaseResult
+{
+   std::string widget;
+   QSize size;
+   std::string load;        ///< "4096 bins" or "10 MS/s"
+   int frames{0};
+   double seconds{0.0};
+   double fps{0.0};
+   double cpuPercent{0.0};
+   CommonUtils::LatencySummary paint;
+};
+
+/// "64K" -> 64 * kilo, "10M" -> 10 * kilo * kilo (kilo: 1024 for bins, 1000 for rates).
+std::size_t parseCount(const std::string& text, std::size_t kilo)
+{
+   std::size_t suffix = 0;
+   const std::size_t value = std::stoul(text, &suffix);
+   if (suffix < text.size())
+   {
+      switch (text[suffix])
+      {
+         case 'k':
+         case 'K':
+            return value * kilo;
+         case 'm':
+         case 'M':
+            return value * kilo * kilo;
+         default:
+            break;
+      }
+   }
+   return value;
+}
+
+/// "1920x1080" -> QSize(1920, 1080).
+QSize parseWindowSize(const std::string& text)
+{
+   const std::size_t x = text.find('x');
+   if (x == std::string::npos)
+   {
+      return {};
+   }
+   return {std::stoi(text.substr(0, x)), std::stoi(text.substr(x + 1))};
+}
+
+template <typename T, typename Parse>
+std::vector<T> parseList(const std::string& text, Parse parse)
+{
+   std::vector<T> values;
+   std::size_t begin = 0;
+   while (begin <= text.size())
+   {
+      const std::size_t end = std::min(text.find(',', begin), text.size());
+      if (end > begin)
+      {
+         values.push_back(parse(text.substr(begin, end - begin)));
+      }
+      begin = end + 1;
+   }
+   return values;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) // NOLINT
+{
+   for (int i = 1; i + 1 < argc; i += 2)
+   {
+      const std::string key = argv[i];
+      const std::string value = argv[i + 1];
+      if (key == "--widgets")
+      {
+         options.widgets = parseList<std::string>(value, [](const std::string& s) { return s; });
+      }
+      else if (key == "--bins")
+      {
+         options.bins = parseList<std::size_t>(value, [](const std::string& s)
+                                               { return parseCount(s, 1024); });
+      }
+      else if (key == "--rates")
+      {
+         options.rates = parseList<std::size_t>(value, [](const std::string& s)
+                                                { return parseCount(s, 1000); });
+      }
+      else if (key == "--sizes") { options.sizes = parseList<QSize>(value, parseWindowSize); }
+      else if (key == "--fps") { options.fps = std::stod(value); }
+      else if (key == "--frames") { options.frames = std::stoi(value); }
+      else if (key == "--json") { options.jsonPath = value; }
+      else
+      {
+         GPERROR("Unknown option {}", key);
+         return false;
+      }
+   }
+   const bool sizesValid =
+      std::ranges::all_of(options.sizes, [](const QSize& s) { return !s.isEmpty(); });
+   return (argc % 2) == 1 && sizesValid && options.fps > 0.0 && options.frames > 0;
+}
+
+/// User + system CPU time of the whole process.
+double processCpuSeconds()
+{
+   rusage usage{};
+   getrusage(RUSAGE_SELF, &usage);
+   const auto seconds = [](const timeval& tv)
+   { return static_cast<double>(tv.tv_sec) + (static_cast<double>(tv.tv_usec) * 1e-6); };
+   return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+// ============================================================================
+// Synthetic data
+// ============================================================================
+
+/// dB spectra: a noise floor, a carrier drifting across the band and a few
+/// fixed narrow tones.
+std::vector<std::vector<float>> generateSpectra(std::size_t bins)
+{
+   std::mt19937 gen(7);
+   std::normal_distribution<float> noise(-100.0F, 3.0F);
+   std::vector<std::vector<float>> frames(SYNTHETIC_FRAMES, std::vector<float>(bins));
+   const auto width = static_cast<float>(bins);
+   for (std::size_t f = 0; f < SYNTHETIC_FRAMES; ++f)
+   {
+      const float centre = width * static_cast<float>(f) / static_cast<float>(SYNTHETIC_FRAMES);
+      const float sigma  = std::max(2.0F, width / 200.0F);
+      for (std::size_t i = 0; i < bins; ++i)
+      {
+         const float dist = (static_cast<float>(i) - centre) / sigma;
+         float db = noise(gen) + (60.0F * std::exp(-0.5F * dist * dist));
+         if (i % ((bins / 8) + 1) == 0)
+         {
+            db = std::max(db, -40.0F);
+         }
+         frames[f][i] = db;
+      }
+   }
+   return frames;
+}
+
+/// Noisy QPSK blocks with a slowly rotating phase.
+std::vector<std::vector<std::complex<float>>> generateIq(std::size_t samples)
+{
+   std::mt19937 gen(11);
+   std::normal_distribution<float> noise(0.0F, 0.08F);
+   std::uniform_int_distribution<int> symbol(0, 3);
+   std::vector<std::vector<std::complex<float>>> frames(
+      SYNTHETIC_FRAMES, std::vector<std::complex<float>>(samples));
+   for (std::size_t f = 0; f < SYNTHETIC_FRAMES; ++f)
+   {
+      const float rotation = TWO_PI * static_cast<float>(f) / 360.0F;
+      for (auto& sample : frames[f])
+      {
+         const float phase = (TWO_PI * (static_cast<float>(symbol(gen)) + 0.5F) / 4.0F) + rotation;
+         sample = std::polar(0.7F, phase) + std::complex<float>(noise(gen), noise(gen));
+      }
+   }
+   return frames;
+}
+
+// ============================================================================
+// Cases
+// ============================================================================
+
+/// Feed frame `index` to the widget.
+using FeedFn = std::function<void(std::size_t index)>;
+
+CaseResult runCase(const Options& options, QWidget& widget, const FeedFn& feed,
+                   const std::string& name, const std::string& load, const QSize& size)
+{
+   CaseResult result;
+   result.widget = name;
+   result.size   = size;
+   result.load   = load;
+
+   // Shown, so resize and polish events arrive, but never on a screen
+   widget.setAttribute(Qt::WA_DontShowOnScreen);
+   widget.resize(size);
+   widget.show();
+   QApplication::processEvents();
+
+   QImage target(size, QImage::Format_ARGB32_Premultiplied);
+   for (int i = 0; i < WARMUP_FRAMES; ++i)
+   {
+      feed(static_cast<std::size_t>(i));
+      widget.render(&target);
+   }
+
+   CommonUtils::LatencyHistogram paint;
+   const double cpuStart = processCpuSeconds();
+   const auto start = std::chrono::steady_clock::now();
+   for (int i = 0; i < options.frames; ++i)
+   {
+      feed(static_cast<std::size_t>(i));
+      const auto paintStart = std::chrono::steady_clock::now();
+      widget.render(&target);
+      paint.record(std::chrono::steady_clock::now() - paintStart);
+   }
+   const auto elapsed = std::chrono::steady_clock::now() - start;
+   result.seconds    = std::chrono::duration<double>(elapsed).count();
+   result.cpuPercent = 100.0 * (processCpuSeconds() - cpuStart) / result.seconds;
+   result.frames     = options.frames;
+   result.fps        = static_cast<double>(options.frames) / result.seconds;
+   result.paint      = paint.summary();
+   return result;
+}
+
+std::vector<CaseResult> runWidget(const Options& options, const std::string& name)
+{
+   std::vector<CaseResult> results;
+   if (name == "spectrum" || name == "waterfall")
+   {
+      for (const std::size_t bins : options.bins)
+      {
+         const auto spectra = generateSpectra(bins);
+         const std::string load = std::to_string(bins) + " bins";
+         for (const QSize& size : options.sizes)
+         {
+            if (name == "spectrum")
+            {
+               RealTimeGraphs::SpectrumWidget widget;
+               widget.setInputIsDb(true);
+               widget.setDbRange(-120.0F, 0.0F);
+               results.push_back(runCase(
+                  options, widget,
+                  [&](std::size_t i) { widget.setData(spectra[i % SYNTHETIC_FRAMES]); }, name, load,
+                  size));
+            }
+            else
+            {
+               RealTimeGraphs::WaterfallWidget widget;
+               widget.setInputIsDb(true);
+               widget.setDbRange(-120.0F, 0.0F);
+               results.push_back(runCase(
+                  options, widget,
+                  [&](std::size_t i) { widget.addRow(spectra[i % SYNTHETIC_FRAMES]); }, name, load,
+                  size));
+            }
+         }
+      }
+      return results;
+   }
+
+   for (const std::size_t rate : options.rates)
+   {
+      const auto samples = std::max<std::size_t>(
+         1, static_cast<std::size_t>(static_cast<double>(rate) / options.fps));
+      const auto blocks = generateIq(samples);
+      const std::string load = fmt::format("{:g} MS/s", static_cast<double>(rate) / 1e6);
+      for (const QSize& size : options.sizes)
+      {
+         if (name == "constellation" || name == "density")
+         {
+            RealTimeGraphs::ConstellationWidget widget;
+            if (name == "density")
+            {
+               widget.setDisplayMode(RealTimeGraphs::ConstellationWidget::DisplayMode::Density);
+            }
+            results.push_back(runCase(
+               options, widget,
+               [&](std::size_t i) { widget.setData(blocks[i % SYNTHETIC_FRAMES]); }, name, load,
+               size));
+         }
+         else if (name == "oscilloscope")
+         {
+            RealTimeGraphs::OscilloscopeWidget widget;
+            widget.setSampleRate(static_cast<double>(rate));
+            results.push_back(runCase(
+               options, widget,
+               [&](std::size_t i) { widget.setData(blocks[i % SYNTHETIC_FRAMES]); }, name, load,
+               size));
+         }
+         else
+         {
+            GPERROR("Unknown widget {}", name);
+            return results;
+         }
+      }
+   }
+   return results;
+}
+
+void logHeader()
+{
+   GPINFO("{:<15s}{:<11s}{:<13s}{:<8s}{:<10s}{:<10s}{:<10s}{:<10s}{:<9s}{:<8s}", "Widget", "Size",
+          "Load", "Frames", "p50 ms", "p90 ms", "p99 ms", "max ms", "FPS", "CPU %");
+   GPINFO("{}", std::string(104, '-'));
+}
+
+void logResult(const CaseResult& r)
+{
+   const std::string size = fmt::format("{}x{}", r.size.width(), r.size.height());
+   GPINFO("{:<15s}{:<11s}{:<13s}{:<8d}{:<10.3f}{:<10.3f}{:<10.3f}{:<10.3f}{:<9.1f}{:<8.1f}",
+          r.widget, size, r.load, r.frames, r.paint.p50Us / 1e3, r.paint.p90Us / 1e3,
+          r.paint.p99Us / 1e3, r.paint.maxUs / 1e3, r.fps, r.cpuPercent);
+}
+
+bool writeJson(const std::string& path, const std::vector<CaseResult>& results)
+{
+   std::ofstream out(path);
+   if (!out)
+   {
+      return false;
+   }
+   out << "{\n  \"benchmark\": \"RealTimeGraphsBenchmark\",\n  \"cases\": [\n";
+   for (std::size_t i = 0; i < results.size(); ++i)
+   {
+      const CaseResult& r = results[i];
+      out << fmt::format("    {{\"widget\": \"{}\", \"width\": {}, \"height\": {}, "
+                         "\"load\": \"{}\", \"frames\": {}, \"seconds\": {:.3f}, "
+                         "\"fps\": {:.2f}, \"cpu_percent\": {:.1f}, "
+                         "\"paint_us\": {{\"mean\": {:.2f}, \"p50\": {:.2f}, \"p90\": {:.2f}, "
+                         "\"p99\": {:.2f}, \"max\": {:.2f}}}}}{}\n",
+                         r.widget, r.size.width(), r.size.height(), r.load, r.frames, r.seconds,
+                         r.fps, r.cpuPercent, r.paint.meanUs, r.paint.p50Us, r.paint.p90Us,
+                         r.paint.p99Us, r.paint.maxUs, i + 1 < results.size() ? "," : "");
+   }
+   out << "  ]\n}\n";
+   return static_cast<bool>(out);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char* argv[]) // NOLINT
+{
+   CommonUtils::GeneralLogger logger;
+   logger.init("RealTimeGraphsBenchmark");
+
+   Options options;
+   if (!parseOptions(argc, argv, options))
+   {
+      GPERROR("Usage: {} [--widgets spectrum,waterfall,constellation,density,oscilloscope] "
+              "[--bins 1K,4K,64K] [--rates 1M,10M] [--sizes 800x400,1920x1080] [--fps 30] "
+              "[--frames 300] [--json results.json]",
+              argv[0]);
+      return 1;
+   }
+
+   if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+   {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+   }
+   QApplication app(argc, argv);
+
+   GPINFO("==========================================================");
+   GPINFO("RealTimeGraphs Benchmark (offscreen raster paint)");
+   GPINFO("==========================================================");
+   GPINFO("  Platform:         {}", QApplication::platformName().toStdString());
+   GPINFO("  Frames per case:  {} (+{} warm-up)", options.frames, WARMUP_FRAMES);
+   GPINFO("  I/Q frame rate:   {} fps", options.fps);
+   GPINFO("==========================================================");
+
+   std::vector<CaseResult> results;
+   logHeader();
+   for (const std::string& widget : options.widgets)
+   {
+      for (const CaseResult& result : runWidget(options, widget))
+      {
+         logResult(result);
+         results.push_back(result);
+      }
+   }
+
+   if (!options.jsonPath.empty())
+   {
+      if (!writeJson(options.jsonPath, results))
+      {
+         GPERROR("Failed to write {}", options.jsonPath);
+         return 1;
+      }
+      GPINFO("Results written to {}", options.jsonPath);
+   }
+
+   GPINFO("==========================================================");
+   GPINFO("Benchmark complete.");
+   GPINFO("==========================================================");
+
+   return 0;
+}
@@ -160,6 +160,19 @@ int main(int argc, char* argv[]) // NOLINT
    QObject::connect(maxHoldCheck, &QCheckBox::toggled, spectrum,
                     &RealTimeGraphs::SpectrumWidget::setMaxHoldEnabled);
 
+   // Raster, OpenGL, or the waterfall rasterized on a worker thread
+   auto* backendCombo = new QComboBox;
+   backendCombo->addItems({"Raster", "OpenGL", "Threaded Waterfall"});
+   abToolbar->addWidget(backendCombo);
+   QObject::connect(backendCombo, &QComboBox::currentIndexChanged, [spectrum, waterfall](int idx)
+   {
+      using RenderBackend = RealTimeGraphs::PlotWidgetBase::RenderBackend;
+      const auto backend = static_cast<RenderBackend>(idx);
+      spectrum->setRenderBackend((backend == RenderBackend::Threaded) ? RenderBackend::Raster
+                                                                      : backend);
+      waterfall->setRenderBackend(backend);
+   });
+
    abToolbar->addStretch();
    abLayout->addLayout(abToolbar);
 
@@ -195,11 +208,20 @@ int main(int argc, char* argv[]) // NOLINT
    QObject::connect(waterfall, &RealTimeGraphs::WaterfallWidget::requestPeerCursorClear, spectrum,
                     &RealTimeGraphs::SpectrumWidget::clearMeasCursors);
 
-   // Constellation doesn't use a color map, but we keep the layout consistent
+   // Constellation page, laid out like the others
    auto* constPage = new QWidget;
    auto* constLayout = new QVBoxLayout(constPage);
    auto* constToolbar = new QHBoxLayout;
    constToolbar->addWidget(new QLabel("I/Q Constellation — rotating QPSK + noise"));
+
+   auto* densityCheck = new QCheckBox("Density");
+   densityCheck->setStyleSheet("QCheckBox { color: #B4B4BE; }");
+   constToolbar->addWidget(densityCheck);
+   QObject::connect(densityCheck, &QCheckBox::toggled, [constellation](bool checked)
+   {
+      using DisplayMode = RealTimeGraphs::ConstellationWidget::DisplayMode;
+      constellation->setDisplayMode(checked ? DisplayMode::Density : DisplayMode::Points);
+   });
    constToolbar->addStretch();
    constLayout->addLayout(constToolbar);
 
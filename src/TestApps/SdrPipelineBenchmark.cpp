@@ -0,0 +1,605 @@
+// =============================================================================
+// SdrPipelineBenchmark
+// =============================================================================
+// Measures what the whole SdrEngine pipeline sustains.  A SyntheticSdrDevice
+// (or a looping FileSdrDevice) delivers I/Q in flood mode, back to back, so
+// the engine runs as fast as its slowest stage; samples it cannot take are
+// dropped at the sample ring.  Every stream that is enabled has a listener, so
+// frames are published and dispatched as in the applications.  For every
+// combination of FFT size and VFO count it reports, over the measured window:
+//   MS/s      - samples processed per second (delivered minus ring drops)
+//   stages    - busy time of each pipeline stage, as % of one core
+//   CPU       - process CPU time over wall time
+//   allocs    - heap allocations per second and per million samples
+//   latency   - device read -> last listener percentiles (spectrum, I/Q,
+//               filtered I/Q)
+//
+// Usage: ./SdrPipelineBenchmark [--source synthetic|<capture file>]
+//                               [--format cf32|cs16|cs8|vita49] [--rate 20M]
+//                               [--fft 2K,16K] [--window blackman|hann|flattop|rect]
+//                               [--average 0.5] [--channel-bw 200K]
+//                               [--demod none|fm|fmstereo|am] [--vfos 0,4]
+//                               [--seconds 5] [--json results.json]
+//        source     - Synthetic FM carriers and noise, or a capture played in a loop
+//        format     - Layout of the capture file
+//        rate       - Sample rate the engine is configured for (DSP parameters only;
+//                     flood mode delivers as fast as the pipeline takes samples)
+//        fft        - FFT sizes, with optional K suffix
+//        window     - FFT window function
+//        average    - Spectrum averaging alpha, 0 = off
+//        channel-bw - Channel filter bandwidth in Hz, 0 = off
+//        demod      - Demodulator on every VFO
+//        vfos       - VFO counts; VFOs sit on the synthetic carriers
+//        seconds    - Measured time per case (after a one-second warm-up)
+//        json       - Also write every case to this file, to compare commits
+// =============================================================================
+
+// Project headers
+#include "FileSdrDevice.h"
+#include "GeneralLogger.h"
+#include "LatencyHistogram.h"
+#include "SdrEngine.h"
+#include "SyntheticSdrDevice.h"
+
+// System headers
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+} // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+   allocations.fetch_add(1, std::memory_order_relaxed);
+   if (void* p = std::malloc(size == 0 ? 1 : size))
+   {
+      return p;
+   }
+   throw std::bad_alloc();
+}
+
+// Out of line, so GCC does not pair the inlined free() with a new-expression
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+   ::operator delete(p);
+}
+
+namespace
+{
+
+using SdrEngine::DemodMode;
+using SdrEngine::IqFileFormat;
+using SdrEngine::PipelineStageStats;
+using SdrEngine::WindowFunction;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr auto WARMUP = std::chrono::seconds(1);
+
+/// Spacing of the synthetic FM carriers (and the VFOs on them).
+constexpr double CARRIER_SPACING_HZ = 400'000.0;
+
+/// Bandwidth of each VFO.
+constexpr double VFO_BANDWIDTH_HZ = 200'000.0;
+
+struct Options
+{
+   std::string source{"synthetic"};
+   IqFileFormat format{IqFileFormat::CF32};
+   uint32_t rate{20'000'000};
+   std::vector<std::size_t> fftSizes{2048, 16384};
+   WindowFunction window{WindowFunction::BlackmanHarris};
+   std::string windowName{"blackman"};
+   float average{0.5F};
+   double channelBw{200'000.0};
+   std::optional<DemodMode> demod{DemodMode::FmMono};
+   std::string demodName{"fm"};
+   std::vector<std::size_t> vfoCounts{0, 4};
+   double seconds{5.0};
+   std::string jsonPath;
+};
+
+/// One stage's share of the measured window.
+struct StageResult
+{
+   const char* name{""};
+   uint64_t frames{0};
+   double busyMs{0.0};
+   double corePercent{0.0};   ///< Busy time over wall time.
+};
+
+struct CaseResult
+{
+   std::size_t fftSize{0};
+   std::size_t vfos{0};
+   double seconds{0.0};
+   uint64_t samples{0};          ///< Processed (delivered minus ring drops).
+   uint64_t droppedSamples{0};   ///< Dropped at the sample ring.
+   double msps{0.0};
+   double cpuPercent{0.0};
+   uint64_t allocations{0};
+   double allocsPerSecond{0.0};
+   double allocsPerMsample{0.0};
+   uint64_t poolMisses{0};       ///< Output frames the engine's pools had to allocate.
+   std::vector<StageResult> stages;
+   CommonUtils::LatencySummary spectrumLatency;
+   CommonUtils::LatencySummary iqLatency;
+   CommonUtils::LatencySummary filteredIqLatency;
+};
+
+/// "16K" -> 16 * kilo, "20M" -> 20 * kilo * kilo.
+std::size_t parseCount(const std::string& text, std::size_t kilo)
+{
+   std::size_t suffix = 0;
+   const std::size_t value = std::stoul(text, &suffix);
+   if (suffix < text.size())
+   {
+      switch (text[suffix])
+      {
+         case 'k':
+         case 'K':
+            return value * kilo;
+         case 'm':
+         case 'M':
+            return value * kilo * kilo;
+         default:
+            break;
+      }
+   }
+   return value;
+}
+
+std::vector<std::size_t> parseCounts(const std::string& text, std::size_t kilo)
+{
+   std::vector<std::size_t> values;
+   std::size_t begin = 0;
+   while (begin <= text.size())
+   {
+      const std::size_t end = std::min(text.find(',', begin), text.size());
+      if (end > begin)
+      {
+         values.push_back(parseCount(text.substr(begin, end - begin), kilo));
+      }
+      begin = end + 1;
+   }
+   return values;
+}
+
+bool parseWindow(const std::string& text, WindowFunction& window)
+{
+   if (text == "blackman") { window = WindowFunction::BlackmanHarris; }
+   else if (text == "hann") { window = WindowFunction::Hanning; }
+   else if (text == "flattop") { window = WindowFunction::FlatTop; }
+   else if (text == "rect") { window = WindowFunction::Rectangular; }
+   else { return false; }
+   return true;
+}
+
+bool parseDemod(const std::string& text, std::optional<DemodMode>& demod)
+{
+   if (text == "none") { demod.reset(); }
+   else if (text == "fm") { demod = DemodMode::FmMono; }
+   else if (text == "fmstereo") { demod = DemodMode::FmStereo; }
+   else if (text == "am") { demod = DemodMode::AM; }
+   else { return false; }
+   return true;
+}
+
+bool parseFormat(const std::string& text, IqFileFormat& format)
+{
+   if (text == "cf32") { format = IqFileFormat::CF32; }
+   else if (text == "cs16") { format = IqFileFormat::CS16; }
+   else if (text == "cs8") { format = IqFileFormat::CS8; }
+   else if (text == "vita49") { format = IqFileFormat::Vita49; }
+   else { return false; }
+   return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) // NOLINT
+{
+   bool valid = true;
+   for (int i = 1; i + 1 < argc; i += 2)
+   {
+      const std::string key = argv[i];
+      const std::string value = argv[i + 1];
+      if (key == "--source") { options.source = value; }
+      else if (key == "--format") { valid = valid && parseFormat(value, options.format); }
+      else if (key == "--rate")
+      {
+         options.rate = static_cast<uint32_t>(parseCount(value, 1000));
+      }
+      else if (key == "--fft") { options.fftSizes = parseCounts(value, 1024); }
+      else if (key == "--window")
+      {
+         valid = valid && parseWindow(value, options.window);
+         options.windowName = value;
+      }
+      else if (key == "--average") { options.average = std::stof(value); }
+      else if (key == "--channel-bw")
+      {
+         options.channelBw = static_cast<double>(parseCount(value, 1000));
+      }
+      else if (key == "--demod")
+      {
+         valid = valid && parseDemod(value, options.demod);
+         options.demodName = value;
+      }
+      else if (key == "--vfos") { options.vfoCounts = parseCounts(value, 1000); }
+      else if (key == "--seconds") { options.seconds = std::stod(value); }
+      else if (key == "--json") { options.jsonPath = value; }
+      else
+      {
+         GPERROR("Unknown option {}", key);
+         return false;
+      }
+   }
+   return valid && (argc % 2) == 1 && options.rate > 0 && !options.fftSizes.empty() &&
+          !options.vfoCounts.empty() && options.seconds > 0.0;
+}
+
+/// User + system CPU time of the whole process.
+double processCpuSeconds()
+{
+   rusage usage{};
+   getrusage(RUSAGE_SELF, &usage);
+   const auto seconds = [](const timeval& tv)
+   { return static_cast<double>(tv.tv_sec) + (static_cast<double>(tv.tv_usec) * 1e-6); };
+   return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+/// Offset of carrier / VFO `index` from the centre: 1, -1, 2, -2, ... spacings.
+double carrierOffsetHz(std::size_t index)
+{
+   const auto step = static_cast<double>((index / 2) + 1) * CARRIER_SPACING_HZ;
+   return (index % 2 == 0) ? step : -step;
+}
+
+/// Carriers that fit in the band, at most `count`.
+std::size_t carriersInBand(const Options& options, std::size_t count)
+{
+   const auto perSide =
+      static_cast<std::size_t>((static_cast<double>(options.rate) / 2.0 - VFO_BANDWIDTH_HZ) /
+                               CARRIER_SPACING_HZ);
+   return std::min(count, 2 * perSide);
+}
+
+// ============================================================================
+// Device
+// ============================================================================
+
+std::unique_ptr<SdrEngine::ISdrDevice> makeDevice(const Options& options)
+{
+   if (options.source != "synthetic")
+   {
+      auto device = std::make_unique<SdrEngine::FileSdrDevice>(options.source, options.format);
+      device->setPacing(SdrEngine::PlaybackPacing::AsFastAsPossible);
+      device->setLooping(true);
+      return device;
+   }
+
+   // FM broadcast-like carriers under every possible VFO, plus a noise floor.
+   std::vector<SdrEngine::SyntheticSignal> signals;
+   const std::size_t carriers = carriersInBand(options, 16);
+   for (std::size_t c = 0; c < carriers; ++c)
+   {
+      SdrEngine::SyntheticSignal signal;
+      signal.type         = SdrEngine::SyntheticSignalType::FmCarrier;
+      signal.offsetHz     = carrierOffsetHz(c);
+      signal.amplitude    = 0.05F;
+      signal.deviationHz  = 75'000.0;
+      signal.modulationHz = 1'000.0;
+      signals.push_back(signal);
+   }
+
+   auto device = std::make_unique<SdrEngine::SyntheticSdrDevice>();
+   if (!device->setSignals(std::move(signals)) || !device->setNoiseLevel(0.01F))
+   {
+      GPWARN("SyntheticSdrDevice rejected the benchmark signals");
+   }
+   device->setPacing(SdrEngine::PlaybackPacing::AsFastAsPossible);
+   return device;
+}
+
+// ============================================================================
+// Cases
+// ============================================================================
+
+/// Counters sampled at the start and end of the measured window.
+struct Sample
+{
+   std::chrono::steady_clock::time_point time;
+   double cpuSeconds{0.0};
+   uint64_t allocations{0};
+   SdrEngine::EngineHealthStats health;
+   SdrEngine::PipelineStats pipeline;
+   uint64_t poolMisses{0};
+};
+
+uint64_t poolMisses(const SdrEngine::EngineFramePoolStats& pools)
+{
+   return pools.iq.misses + pools.filteredIq.misses + pools.channelizer.misses +
+          pools.spectrum.misses + pools.zoomSpectrum.misses + pools.detections.misses +
+          pools.displayIq.misses;
+}
+
+Sample takeSample(const SdrEngine::SdrEngine& engine)
+{
+   Sample sample;
+   sample.time        = std::chrono::steady_clock::now();
+   sample.cpuSeconds  = processCpuSeconds();
+   sample.allocations = allocations.load(std::memory_order_relaxed);
+   sample.health      = engine.getHealthStats();
+   sample.pipeline    = engine.getPipelineStats();
+   sample.poolMisses  = poolMisses(engine.getFramePoolStats());
+   return sample;
+}
+
+StageResult stageDelta(const char* name, const PipelineStageStats& begin,
+                       const PipelineStageStats& end, double seconds)
+{
+   StageResult stage;
+   stage.name        = name;
+   stage.frames      = end.frames - begin.frames;
+   stage.busyMs      = static_cast<double>(end.busyNs - begin.busyNs) / 1e6;
+   stage.corePercent = stage.busyMs / 10.0 / seconds;
+   return stage;
+}
+
+std::optional<CaseResult> runCase(const Options& options, std::size_t fftSize,
+                                  std::size_t vfoCount)
+{
+   SdrEngine::SdrEngine engine("Benchmark");
+   engine.setDevice(makeDevice(options));
+   std::ignore = engine.setSampleRate(options.rate);
+   engine.setFftSize(fftSize);
+   engine.setWindowFunction(options.window);
+   engine.setFftAverageAlpha(options.average);
+   engine.setLatencyTracingEnabled(true);
+
+   // A listener on every enabled stream, so frames are dispatched as in the
+   // applications.  They do nothing: the pipeline is what is measured.
+   std::ignore = engine.spectrumDataHandler().registerListener(
+      [](const std::shared_ptr<const SdrEngine::SpectrumData>&) {});
+   std::ignore = engine.iqDataHandler().registerListener(
+      [](const std::shared_ptr<const SdrEngine::IqBuffer>&) {});
+   if (options.channelBw > 0.0)
+   {
+      engine.configureChannelFilter(carrierOffsetHz(0), options.channelBw);
+      engine.setChannelFilterEnabled(true);
+      std::ignore = engine.filteredIqDataHandler().registerListener(
+         [](const std::shared_ptr<const SdrEngine::IqBuffer>&) {});
+   }
+
+   const std::size_t vfos = carriersInBand(options, vfoCount);
+   if (vfos < vfoCount)
+   {
+      GPWARN("Only {} VFOs fit at {} S/s", vfos, options.rate);
+   }
+   for (std::size_t v = 0; v < vfos; ++v)
+   {
+      const auto vfo = engine.vfo(engine.addVfo(carrierOffsetHz(v), VFO_BANDWIDTH_HZ));
+      std::ignore = vfo->iqDataHandler().registerListener(
+         [](const std::shared_ptr<const SdrEngine::IqBuffer>&) {});
+      if (options.demod.has_value())
+      {
+         vfo->setDemodulator(*options.demod);
+         std::ignore = vfo->audioDataHandler().registerListener(
+            [](const std::shared_ptr<const SdrEngine::DemodAudio>&) {});
+      }
+   }
+
+   if (!engine.start())
+   {
+      GPERROR("Failed to start the engine on {}", options.source);
+      return std::nullopt;
+   }
+   std::this_thread::sleep_for(WARMUP);
+   engine.resetLatencyStats();
+
+   const Sample begin = takeSample(engine);
+   std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+   const Sample end = takeSample(engine);
+   const SdrEngine::EngineLatencyStats latency = engine.getLatencyStats();
+   engine.stop();
+
+   CaseResult result;
+   result.fftSize = fftSize;
+   result.vfos    = vfos;
+   result.seconds = std::chrono::duration<double>(end.time - begin.time).count();
+   const uint64_t delivered =
+      end.health.device.samplesReceived - begin.health.device.samplesReceived;
+   result.droppedSamples   = end.health.ringOverflowSamples - begin.health.ringOverflowSamples;
+   result.samples          = delivered - std::min(delivered, result.droppedSamples);
+   result.msps             = static_cast<double>(result.samples) / result.seconds / 1e6;
+   result.cpuPercent       = 100.0 * (end.cpuSeconds - begin.cpuSeconds) / result.seconds;
+   result.allocations      = end.allocations - begin.allocations;
+   result.allocsPerSecond  = static_cast<double>(result.allocations) / result.seconds;
+   result.allocsPerMsample = (result.samples == 0)
+                                ? 0.0
+                                : static_cast<double>(result.allocations) * 1e6 /
+                                     static_cast<double>(result.samples);
+   result.poolMisses = end.poolMisses - begin.poolMisses;
+
+   const auto& b = begin.pipeline;
+   const auto& e = end.pipeline;
+   result.stages = {stageDelta("conditioning", b.conditioning, e.conditioning, result.seconds),
+                    stageDelta("fft", b.fft, e.fft, result.seconds),
+                    stageDelta("channel_filter", b.channelFilter, e.channelFilter, result.seconds),
+                    stageDelta("channelizer", b.channelizer, e.channelizer, result.seconds),
+                    stageDelta("vfos", b.vfos, e.vfos, result.seconds),
+                    stageDelta("detector", b.detector, e.detector, result.seconds)};
+   result.spectrumLatency   = latency.spectrum.endToEnd;
+   result.iqLatency         = latency.iq.endToEnd;
+   result.filteredIqLatency = latency.filteredIq.endToEnd;
+   return result;
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+void logHeader()
+{
+   GPINFO("{:<8s}{:<6s}{:<9s}{:<8s}{:<8s}{:<8s}{:<8s}{:<8s}{:<10s}{:<10s}{:<10s}", "FFT", "VFOs",
+          "MS/s", "CPU %", "cond %", "fft %", "chan %", "vfo %", "alloc/s", "spec p99",
+          "iq p99");
+   GPINFO("{}", std::string(95, '-'));
+}
+
+void logResult(const CaseResult& r)
+{
+   GPINFO("{:<8d}{:<6d}{:<9.2f}{:<8.1f}{:<8.1f}{:<8.1f}{:<8.1f}{:<8.1f}{:<10.0f}{:<10.2f}"
+          "{:<10.2f}",
+          r.fftSize, r.vfos, r.msps, r.cpuPercent, r.stages[0].corePercent,
+          r.stages[1].corePercent, r.stages[2].corePercent, r.stages[4].corePercent,
+          r.allocsPerSecond, r.spectrumLatency.p99Us / 1e3, r.iqLatency.p99Us / 1e3);
+   if (r.droppedSamples > 0)
+   {
+      GPINFO("        ring dropped {} samples ({:.1f}%): the pipeline is the bottleneck",
+             r.droppedSamples,
+             100.0 * static_cast<double>(r.droppedSamples) /
+                static_cast<double>(r.samples + r.droppedSamples));
+   }
+}
+
+std::string latencyJson(const CommonUtils::LatencySummary& s)
+{
+   return fmt::format("{{\"count\": {}, \"mean\": {:.2f}, \"p50\": {:.2f}, \"p90\": {:.2f}, "
+                      "\"p99\": {:.2f}, \"max\": {:.2f}}}",
+                      s.count, s.meanUs, s.p50Us, s.p90Us, s.p99Us, s.maxUs);
+}
+
+bool writeJson(const std::string& path, const Options& options,
+               const std::vector<CaseResult>& results)
+{
+   std::ofstream out(path);
+   if (!out)
+   {
+      return false;
+   }
+   out << fmt::format("{{\n  \"benchmark\": \"SdrPipelineBenchmark\",\n"
+                      "  \"source\": \"{}\", \"rate\": {}, \"window\": \"{}\", "
+                      "\"average\": {}, \"channel_bw\": {}, \"demod\": \"{}\",\n"
+                      "  \"cases\": [\n",
+                      options.source, options.rate, options.windowName, options.average,
+                      options.channelBw, options.demodName);
+   for (std::size_t i = 0; i < results.size(); ++i)
+   {
+      const CaseResult& r = results[i];
+      std::string stages;
+      for (const StageResult& s : r.stages)
+      {
+         stages += fmt::format("{}\"{}\": {{\"frames\": {}, \"busy_ms\": {:.1f}, "
+                               "\"core_percent\": {:.1f}}}",
+                               stages.empty() ? "" : ", ", s.name, s.frames, s.busyMs,
+                               s.corePercent);
+      }
+      out << fmt::format(
+         "    {{\"fft_size\": {}, \"vfos\": {}, \"seconds\": {:.3f}, \"samples\": {}, "
+         "\"dropped_samples\": {}, \"msps\": {:.3f}, \"cpu_percent\": {:.1f},\n"
+         "     \"allocations\": {}, \"allocs_per_second\": {:.1f}, "
+         "\"allocs_per_msample\": {:.2f}, \"pool_misses\": {},\n"
+         "     \"stages\": {{{}}},\n"
+         "     \"latency_us\": {{\"spectrum\": {}, \"iq\": {}, \"filtered_iq\": {}}}}}{}\n",
+         r.fftSize, r.vfos, r.seconds, r.samples, r.droppedSamples, r.msps, r.cpuPercent,
+         r.allocations, r.allocsPerSecond, r.allocsPerMsample, r.poolMisses, stages,
+         latencyJson(r.spectrumLatency), latencyJson(r.iqLatency),
+         latencyJson(r.filteredIqLatency), i + 1 < results.size() ? "," : "");
+   }
+   out << "  ]\n}\n";
+   return static_cast<bool>(out);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char* argv[]) // NOLINT
+{
+   CommonUtils::GeneralLogger logger;
+   logger.init("SdrPipelineBenchmark");
+
+   Options options;
+   if (!parseOptions(argc, argv, options))
+   {
+      GPERROR("Usage: {} [--source synthetic|<capture file>] [--format cf32|cs16|cs8|vita49] "
+              "[--rate 20M] [--fft 2K,16K] [--window blackman|hann|flattop|rect] "
+              "[--average 0.5] [--channel-bw 200K] [--demod none|fm|fmstereo|am] "
+              "[--vfos 0,4] [--seconds 5] [--json results.json]",
+              argv[0]);
+      return 1;
+   }
+
+   GPINFO("==========================================================");
+   GPINFO("SdrEngine Pipeline Benchmark (flood mode)");
+   GPINFO("==========================================================");
+   GPINFO("  Source:           {}", options.source);
+   GPINFO("  Sample rate:      {} S/s (DSP configuration)", options.rate);
+   GPINFO("  Window / average: {} / {}", options.windowName, options.average);
+   GPINFO("  Channel filter:   {}",
+          options.channelBw > 0.0 ? fmt::format("{} Hz", options.channelBw) : "off");
+   GPINFO("  VFO demodulator:  {}", options.demodName);
+   GPINFO("  Time per case:    {} s (+{} s warm-up)", options.seconds, WARMUP.count());
+   GPINFO("==========================================================");
+
+   std::vector<CaseResult> results;
+   logHeader();
+   for (const std::size_t fftSize : options.fftSizes)
+   {
+      for (const std::size_t vfos : options.vfoCounts)
+      {
+         const auto result = runCase(options, fftSize, vfos);
+         if (!result.has_value())
+         {
+            return 1;
+         }
+         logResult(*result);
+         results.push_back(*result);
+      }
+   }
+
+   if (!options.jsonPath.empty())
+   {
+      if (!writeJson(options.jsonPath, options, results))
+      {
+         GPERROR("Failed to write {}", options.jsonPath);
+         return 1;
+      }
+      GPINFO("Results written to {}", options.jsonPath);
+   }
+
+   GPINFO("==========================================================");
+   GPINFO("Benchmark complete.");
+   GPINFO("==========================================================");
+
+   return 0;
+}
@@ -8,25 +8,42 @@
 // Modes:
 //   generate  - Create a .v49 file from synthetic waveform + context
 //   inspect   - Decode a .v49 file and print packet details
+//   index     - Build (or reuse) the packet index and print the time span
+//   decode    - Convert every signal data sample to a raw cf32 file, in parallel
 //   roundtrip - Read a .v49 file, decode, re-encode, and compare
 //
+// Files are memory-mapped through Vita49FileReader, so captures of many
+// gigabytes open without being read into memory.
+//
 // Usage:
 //   ./Vita49FileCodec generate <output.v49> [numSamples] [freqHz]
 //   ./Vita49FileCodec inspect  <input.v49>
+//   ./Vita49FileCodec index    <input.v49>
+//   ./Vita49FileCodec decode   <input.v49> <output.cf32> [threads]
 //   ./Vita49FileCodec roundtrip <input.v49>
 // =============================================================================
 
+#include "FileSink.h"
 #include "GeneralLogger.h"
 #include "Vita49Codec.h"
+#include "Vita49FileReader.h"
+#include "WorkerPool.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
+#include <initializer_list>
 #include <numbers>
+#include <span>
 #include <string>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace
 {
@@ -36,42 +53,24 @@ constexpr double PI = std::numbers::pi;
 // File I/O
 // ============================================================================
 
-std::vector<uint8_t> readFile(const std::string& path)
+// Packets are appended through the sink's buffers as they come, so they
+// never need concatenating first.
+bool writeFile(const std::string& path, std::initializer_list<std::span<const uint8_t>> packets)
 {
-   std::ifstream file(path, std::ios::binary | std::ios::ate);
-   if (!file.is_open())
-   {
-      GPERROR("Cannot open file: {}", path);
-      return {};
-   }
+   constexpr std::size_t SINK_BUFFER_BYTES = std::size_t{1} << 20;
+   constexpr std::size_t SINK_BUFFER_COUNT = 4;
 
-   auto fileSize = file.tellg();
-   if (fileSize <= 0)
-   {
-      return {};
-   }
-
-   file.seekg(0);
-   std::vector<uint8_t> data(static_cast<size_t>(fileSize));
-   file.read(reinterpret_cast<char*>(data.data()),
-             static_cast<std::streamsize>(fileSize));
-
-   return data;
-}
-
-bool writeFile(const std::string& path, const std::vector<uint8_t>& data)
-{
-   std::ofstream file(path, std::ios::binary | std::ios::trunc);
-   if (!file.is_open())
+   CommonUtils::FileSink sink(SINK_BUFFER_BYTES, SINK_BUFFER_COUNT);
+   if (!sink.open(path))
    {
       GPERROR("Cannot create file: {}", path);
       return false;
    }
-
-   file.write(reinterpret_cast<const char*>(data.data()),
-              static_cast<std::streamsize>(data.size()));
-
-   return file.good();
+   for (const auto& packet : packets)
+   {
+      sink.append(packet.data(), packet.size());
+   }
+   return sink.close();
 }
 
 // ============================================================================
@@ -239,10 +238,10 @@ void logSampleSummary(const Vita49_2::IQSamples& samples)
 
 int doInspect(const std::string& path)
 {
-   auto data = readFile(path);
-   if (data.empty())
+   Vita49_2::Vita49FileReader reader(Vita49_2::ByteOrder::BigEndian);
+   if (!reader.open(path))
    {
-      GPERROR("File is empty or unreadable: {}", path);
+      GPERROR("Cannot inspect: {}", reader.error());
       return 1;
    }
 
@@ -250,29 +249,29 @@ int doInspect(const std::string& path)
    GPINFO("VITA 49.2 File Inspector");
    GPINFO("==========================================================");
    GPINFO("File:  {}", path);
-   GPINFO("Size:  {} bytes", data.size());
+   GPINFO("Size:  {} bytes", reader.bytes().size());
    GPINFO("==========================================================");
 
-   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
-   auto packets = codec.parseStream(data.data(), data.size());
-
-   GPINFO("Decoded {} packet(s):", packets.size());
+   GPINFO("Indexed {} packet(s):", reader.packetCount());
 
    size_t totalSamples = 0;
    int idx = 0;
+   Vita49_2::IQSamples samples;
 
-   for (const auto& pkt : packets)
+   while (const auto packet = reader.next())
    {
-      logHeader(pkt.header, idx);
+      logHeader(packet->header(), idx);
 
-      if (pkt.type == Vita49_2::ParsedPacket::Type::SignalData)
+      if (packet->isSignalData())
       {
-         logSampleSummary(pkt.samples);
-         totalSamples += pkt.samples.size();
+         samples.resize(packet->sampleCount());
+         packet->decodeSamples(samples);
+         logSampleSummary(samples);
+         totalSamples += samples.size();
       }
-      else if (pkt.type == Vita49_2::ParsedPacket::Type::Context)
+      else if (const auto fields = packet->contextFields())
       {
-         logContextFields(pkt.contextFields);
+         logContextFields(*fields);
       }
       else
       {
@@ -282,13 +281,132 @@ int doInspect(const std::string& path)
       ++idx;
    }
 
+   if (reader.indexedBytes() < reader.bytes().size())
+   {
+      GPWARN("Truncated or malformed packet at byte {}, ignoring the rest",
+             reader.indexedBytes());
+   }
+
    GPINFO("==========================================================");
-   GPINFO("Total: {} packets, {} I/Q samples", packets.size(), totalSamples);
+   GPINFO("Total: {} packets, {} I/Q samples", reader.packetCount(), totalSamples);
    GPINFO("==========================================================");
 
    return 0;
 }
 
+// ============================================================================
+// Index — build or reuse the sidecar index and summarise it
+// ============================================================================
+
+int doIndex(const std::string& path)
+{
+   Vita49_2::Vita49FileReader reader(Vita49_2::ByteOrder::BigEndian);
+   if (!reader.open(path))
+   {
+      GPERROR("Cannot index: {}", reader.error());
+      return 1;
+   }
+
+   size_t signalPackets = 0;
+   uint64_t totalSamples = 0;
+   const Vita49_2::PacketIndexEntry* first = nullptr;
+   const Vita49_2::PacketIndexEntry* last  = nullptr;
+   for (const auto& entry : reader.index())
+   {
+      if (Vita49_2::isDataPacket(entry.packetType))
+      {
+         ++signalPackets;
+         totalSamples += entry.sampleCount;
+      }
+      if (entry.hasTimestamp())
+      {
+         first = (first == nullptr) ? &entry : first;
+         last  = &entry;
+      }
+   }
+
+   GPINFO("==========================================================");
+   GPINFO("File:            {}", path);
+   GPINFO("Index:           {} ({})", Vita49_2::Vita49FileReader::sidecarPath(path),
+          reader.indexFromSidecar() ? "reused" : "built");
+   GPINFO("Packets:         {} ({} signal data)", reader.packetCount(), signalPackets);
+   GPINFO("I/Q samples:     {}", totalSamples);
+   if (first != nullptr)
+   {
+      GPINFO("First timestamp: {} + {}", first->integerTimestamp, first->fractionalTimestamp);
+      GPINFO("Last timestamp:  {} + {}", last->integerTimestamp, last->fractionalTimestamp);
+   }
+   GPINFO("==========================================================");
+   return 0;
+}
+
+// ============================================================================
+// Decode — all signal data to a raw cf32 file, across a worker pool
+// ============================================================================
+
+int doDecode(const std::string& path, const std::string& outputPath, size_t threads)
+{
+   Vita49_2::Vita49FileReader reader(Vita49_2::ByteOrder::BigEndian);
+   if (!reader.open(path))
+   {
+      GPERROR("Cannot decode: {}", reader.error());
+      return 1;
+   }
+
+   const uint64_t totalSamples = reader.sampleCount(0, reader.packetCount());
+   const size_t outputBytes = static_cast<size_t>(totalSamples) * sizeof(Vita49_2::IQSample);
+   if (outputBytes == 0)
+   {
+      GPERROR("No signal data in {}", path);
+      return 1;
+   }
+
+   // The samples are decoded straight into the mapped output file
+   const int fd = ::open(outputPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+   if (fd < 0)
+   {
+      GPERROR("Cannot create file: {} ({})", outputPath, std::strerror(errno));
+      return 1;
+   }
+   void* mapping = MAP_FAILED;
+   if (::ftruncate(fd, static_cast<off_t>(outputBytes)) == 0)
+   {
+      mapping = ::mmap(nullptr, outputBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   }
+   if (mapping == MAP_FAILED)
+   {
+      GPERROR("Cannot map {} bytes of {} ({})", outputBytes, outputPath, std::strerror(errno));
+      ::close(fd);
+      return 1;
+   }
+
+   // The calling thread decodes too
+   CommonUtils::WorkerPool pool(std::max<size_t>(threads, 1) - 1);
+   const auto parallelFor = [&pool](size_t count, const std::function<void(size_t)>& task)
+   {
+      pool.run(count, task);
+   };
+
+   const auto start = std::chrono::steady_clock::now();
+   const size_t decoded = reader.decodeSamples(
+      0, reader.packetCount(),
+      {static_cast<Vita49_2::IQSample*>(mapping), static_cast<size_t>(totalSamples)},
+      Vita49_2::DEFAULT_SCALE_FACTOR, parallelFor);
+   const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+   ::munmap(mapping, outputBytes);
+   ::close(fd);
+
+   GPINFO("==========================================================");
+   GPINFO("Input:    {} ({} packets)", path, reader.packetCount());
+   GPINFO("Output:   {} ({} bytes cf32)", outputPath, outputBytes);
+   GPINFO("Threads:  {}", pool.workerCount() + 1);
+   GPINFO("Decoded:  {} I/Q samples in {:.3f} s ({:.1f} MSa/s)", decoded, elapsed.count(),
+          static_cast<double>(decoded) / std::max(elapsed.count(), 1e-9) / 1e6);
+   GPINFO("==========================================================");
+   return (decoded == totalSamples) ? 0 : 1;
+}
+
 // ============================================================================
 // Generate — create a synthetic .v49 file
 // ============================================================================
@@ -334,19 +452,14 @@ int doGenerate(const std::string& path, size_t numSamples, double freqHz)
    auto signalBytes = codec.encodeSignalData(STREAM_ID, samples, 1,
       Vita49_2::TSI::UTC, Vita49_2::TSF::RealTime, 1738886400, 0);
 
-   // 3) Concatenate context + signal data
-   std::vector<uint8_t> output;
-   output.reserve(contextBytes.size() + signalBytes.size());
-   output.insert(output.end(), contextBytes.begin(), contextBytes.end());
-   output.insert(output.end(), signalBytes.begin(), signalBytes.end());
-
-   if (!writeFile(path, output))
+   // 3) Context + signal data
+   if (!writeFile(path, {contextBytes, signalBytes}))
    {
       return 1;
    }
 
    GPINFO("Written {} bytes ({} context + {} signal data)",
-          output.size(), contextBytes.size(), signalBytes.size());
+          contextBytes.size() + signalBytes.size(), contextBytes.size(), signalBytes.size());
 
    return 0;
 }
@@ -357,12 +470,13 @@ int doGenerate(const std::string& path, size_t numSamples, double freqHz)
 
 int doRoundTrip(const std::string& path)
 {
-   auto data = readFile(path);
-   if (data.empty())
+   Vita49_2::Vita49FileReader reader(Vita49_2::ByteOrder::BigEndian);
+   if (!reader.open(path))
    {
-      GPERROR("File is empty or unreadable: {}", path);
+      GPERROR("Cannot read: {}", reader.error());
       return 1;
    }
+   const auto data = reader.bytes();
 
    GPINFO("==========================================================");
    GPINFO("VITA 49.2 File Round-Trip Test");
@@ -494,16 +608,21 @@ void printUsage(const char* progName)
    GPINFO("Usage:");
    GPINFO("  {} generate <output.v49> [numSamples] [freqHz]", progName);
    GPINFO("  {} inspect  <input.v49>", progName);
+   GPINFO("  {} index    <input.v49>", progName);
+   GPINFO("  {} decode   <input.v49> <output.cf32> [threads]", progName);
    GPINFO("  {} roundtrip <input.v49>", progName);
    GPINFO("");
    GPINFO("Modes:");
    GPINFO("  generate  - Create a .v49 file with synthetic tone + context");
    GPINFO("  inspect   - Decode and print packet details from a .v49 file");
+   GPINFO("  index     - Build or reuse the .v49idx packet index and summarise it");
+   GPINFO("  decode    - Decode all signal data to interleaved float32 I/Q");
    GPINFO("  roundtrip - Read, decode, re-encode, and compare");
    GPINFO("");
    GPINFO("Defaults:");
    GPINFO("  numSamples = 10000");
    GPINFO("  freqHz     = 1000.0");
+   GPINFO("  threads    = one per core");
 }
 
 } // anonymous namespace
@@ -538,6 +657,21 @@ int main(int argc, char* argv[]) // NOLINT
    {
       return doInspect(filePath);
    }
+   if (mode == "index")
+   {
+      return doIndex(filePath);
+   }
+   if (mode == "decode")
+   {
+      if (argc < 4)
+      {
+         printUsage(argv[0]);
+         return 1;
+      }
+      size_t threads = CommonUtils::WorkerPool::defaultWorkerCount() + 1;
+      if (argc > 4) { threads = static_cast<size_t>(std::stoul(argv[4])); }
+      return doDecode(filePath, argv[3], threads);
+   }
    if (mode == "roundtrip")
    {
       return doRoundTrip(filePath);
@@ -1,25 +1,60 @@
 // =============================================================================
 // Vita49PerfBenchmark
 // =============================================================================
-// Measures VITA 49.2 encode and decode throughput at various sample sizes.
-// Reports samples/sec, MB/sec, and packets/sec.
+// Microbenchmark suite for the VITA 49.2 codec.  Every case processes one
+// batch of packets per repetition (about a million samples, or 4096 context
+// packets) and sweeps:
+//   signal data   - samples per packet, byte order, header options (none,
+//                   timestamps, timestamps + trailer) and operation:
+//                     packetize - encode into a reused buffer
+//                     parse     - Vita49Codec::parseStream (allocating)
+//                     view      - PacketView::decodeSamples into a reused buffer
+//                     scan      - header fields only, no sample conversion
+//                     sequence  - scan through a PacketSequencer (window 4)
+//   context       - field set (rate, tuning, all) x encode / decode
+//   formats       - payload format x packetize / parse, with the round-trip
+//                   quantization error
+//   threads       - every case on 1 .. N threads at once, each with its own
+//                   buffers, for scaling
+// Each case runs `warmup` untimed repetitions, then `iterations` timed ones,
+// and reports ns/packet (mean, p50, p99 over repetitions), GB/s of packet
+// bytes and MSa/s.
 //
-// Usage: ./Vita49PerfBenchmark [iterations]
-//        iterations - Number of timing iterations per test (default: 100)
+// Usage: ./Vita49PerfBenchmark [--iterations 100] [--warmup 10]
+//                              [--threads 1,8] [--filter signal/parse]
+//                              [--json results.json]
+//        iterations - Timed repetitions per case
+//        warmup     - Untimed repetitions before timing
+//        threads    - Thread counts to run every case with (default: 1 and
+//                     every hardware thread)
+//        filter     - Only run cases whose name contains this text
+//        json       - Also write every case to this file, with the CPU and
+//                     sample kernel ISA, to compare commits and CPU targets
 // =============================================================================
 
 #include "GeneralLogger.h"
+#include "PacketSequencer.h"
+#include "SampleConversion.h"
 #include "Vita49Codec.h"
+#include "WorkerPool.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <complex>
+#include <cstddef>
 #include <cstdint>
-#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <random>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
-#include <cerrno>
 
 namespace
 {
@@ -28,6 +63,52 @@ namespace
 // Helpers
 // ============================================================================
 
+constexpr uint32_t STREAM_ID           = 0xBEEF;
+constexpr size_t BATCH_SAMPLES         = 1U << 20;   ///< Samples per signal data batch
+constexpr size_t MIN_BATCH_PACKETS     = 16;
+constexpr size_t CONTEXT_BATCH_PACKETS = 4096;
+
+struct Options
+{
+   int iterations{100};
+   int warmup{10};
+   std::vector<size_t> threads;
+   std::string filter;
+   std::string jsonPath;
+};
+
+/// What one case runs: its parameters, and a factory for per-thread batch runners
+struct Case
+{
+   std::string name;
+   std::string group;
+   std::string operation;
+   std::string byteOrder;
+   std::string header;              ///< Signal data header options
+   std::string contextFields;       ///< Context field set
+   std::string payloadFormat;
+   size_t samplesPerPacket{0};
+   size_t packets{0};               ///< Packets per batch
+   size_t bytes{0};                 ///< Packet bytes per batch
+   size_t samples{0};               ///< I/Q samples per batch
+   std::optional<double> errorDbfs; ///< Round-trip quantization error (formats)
+   std::function<std::function<void()>()> makeRunner;
+};
+
+struct CaseResult
+{
+   const Case* spec{nullptr};
+   size_t threads{1};
+   double meanNs{0.0};              ///< ns/packet
+   double p50Ns{0.0};
+   double p99Ns{0.0};
+   double gbPerSecond{0.0};
+   double msamplesPerSecond{0.0};
+};
+
+/// Keeps benchmarked results observable so the work is not optimized away
+std::atomic<uint64_t> sink{0};
+
 /// Generate random I/Q signal (amplitude 0.8 to stay within int16 range)
 Vita49_2::IQSamples generateTestSignal(size_t count, uint32_t seed = 12345)
 {
@@ -42,142 +123,517 @@ Vita49_2::IQSamples generateTestSignal(size_t count, uint32_t seed = 12345)
    return samples;
 }
 
-struct BenchResult
+template <typename T, typename Parse>
+std::vector<T> parseList(const std::string& text, Parse parse)
 {
-   double encodeMs;          ///< Total encode time in ms
-   double decodeMs;          ///< Total decode time in ms
-   size_t totalSamples;      ///< Total samples processed
-   size_t totalBytes;        ///< Total encoded bytes
-   size_t totalPackets;      ///< Total packets produced
-   int iterations;
-};
+   std::vector<T> values;
+   size_t begin = 0;
+   while (begin <= text.size())
+   {
+      const size_t end = std::min(text.find(',', begin), text.size());
+      if (end > begin)
+      {
+         values.push_back(parse(text.substr(begin, end - begin)));
+      }
+      begin = end + 1;
+   }
+   return values;
+}
 
-void logHeader()
+bool parseOptions(int argc, char* argv[], Options& options) // NOLINT
+{
+   for (int i = 1; i + 1 < argc; i += 2)
+   {
+      const std::string key = argv[i];
+      const std::string value = argv[i + 1];
+      if (key == "--iterations") { options.iterations = std::max(std::stoi(value), 1); }
+      else if (key == "--warmup") { options.warmup = std::max(std::stoi(value), 0); }
+      else if (key == "--threads")
+      {
+         options.threads = parseList<size_t>(value, [](const std::string& s) { return std::stoul(s); });
+      }
+      else if (key == "--filter") { options.filter = value; }
+      else if (key == "--json") { options.jsonPath = value; }
+      else
+      {
+         GPERROR("Unknown option {}", key);
+         return false;
+      }
+   }
+   return (argc % 2) == 1;
+}
+
+const char* orderName(Vita49_2::ByteOrder order)
+{
+   return (order == Vita49_2::ByteOrder::BigEndian) ? "be" : "le";
+}
+
+const char* formatName(Vita49_2::PayloadFormat format)
 {
-   GPINFO("{:<14s}{:<12s}{:<14s}{:<14s}{:<12s}{:<14s}{:<14s}{:<10s}",
-          "Samples", "Enc(ms)", "Enc(MSa/s)", "Enc(MB/s)",
-          "Dec(ms)", "Dec(MSa/s)", "Dec(MB/s)", "Packets");
-   GPINFO("{}", std::string(100, '-'));
+   switch (format)
+   {
+      case Vita49_2::PayloadFormat::Int8:        return "int8";
+      case Vita49_2::PayloadFormat::Int12Packed: return "int12";
+      case Vita49_2::PayloadFormat::Float32:     return "float32";
+      default:                                   return "int16";
+   }
+}
+
+/// RMS error of an encode/decode round trip, in dB relative to full scale
+double roundTripErrorDb(const Vita49_2::Vita49Codec& codec, const Vita49_2::IQSamples& samples)
+{
+   const auto encoded = codec.encodeSignalData(0, samples);
+   const auto packets = codec.parseStream(encoded.data(), encoded.size());
+
+   double squared = 0.0;
+   size_t index   = 0;
+   for (const auto& packet : packets)
+   {
+      for (const auto& sample : packet.samples)
+      {
+         squared += std::norm(std::complex<double>(sample - samples[index++]));
+      }
+   }
+   const double rms = std::sqrt(squared / static_cast<double>(2 * samples.size()));
+   return (rms > 0.0) ? 20.0 * std::log10(rms) : -std::numeric_limits<double>::infinity();
 }
 
-void logResult(size_t sampleCount, const BenchResult& r)
+// ============================================================================
+// Signal data cases
+// ============================================================================
+
+/// Header options of a signal data case
+struct HeaderOptions
 {
-   double avgEncMs = r.encodeMs / r.iterations;
-   double avgDecMs = r.decodeMs / r.iterations;
+   const char* name;
+   Vita49_2::TSI tsi;
+   Vita49_2::TSF tsf;
+   bool trailer;
+};
 
-   double encMSaPerSec = (static_cast<double>(r.totalSamples) / r.iterations) /
-                          (avgEncMs * 1000.0);   // mega-samples/sec
-   double decMSaPerSec = (static_cast<double>(r.totalSamples) / r.iterations) /
-                          (avgDecMs * 1000.0);
+constexpr HeaderOptions HEADER_OPTIONS[] = {
+   {"plain", Vita49_2::TSI::None, Vita49_2::TSF::None, false},
+   {"ts", Vita49_2::TSI::UTC, Vita49_2::TSF::RealTime, false},
+   {"ts-trailer", Vita49_2::TSI::UTC, Vita49_2::TSF::RealTime, true},
+};
 
-   double encMBps = (static_cast<double>(r.totalBytes) / r.iterations) /
-                    (avgEncMs * 1000.0);   // MB/sec
-   double decMBps = (static_cast<double>(r.totalBytes) / r.iterations) /
-                    (avgDecMs * 1000.0);
+/// Packet layout of a signal data case
+struct SignalLayout
+{
+   Vita49_2::ByteOrder order;
+   HeaderOptions header;
+   Vita49_2::PayloadFormat format;
+   size_t samplesPerPacket;
+};
 
-   size_t pktsPerIter = r.totalPackets / static_cast<size_t>(r.iterations);
+Vita49_2::Vita49Codec makeCodec(const SignalLayout& layout)
+{
+   Vita49_2::Vita49Codec codec(layout.order);
+   codec.setPayloadFormat(layout.format);
+   return codec;
+}
 
-   GPINFO("{:<14}{:<12.3f}{:<14.2f}{:<14.2f}{:<12.3f}{:<14.2f}{:<14.2f}{:<10}",
-          sampleCount, avgEncMs, encMSaPerSec, encMBps,
-          avgDecMs, decMSaPerSec, decMBps, pktsPerIter);
+Vita49_2::SignalDataStream makeStream(const SignalLayout& layout)
+{
+   Vita49_2::SignalDataStream stream;
+   stream.streamId            = STREAM_ID;
+   stream.tsiType             = layout.header.tsi;
+   stream.tsfType             = layout.header.tsf;
+   stream.intTimestamp        = 1'700'000'000;
+   stream.sampleRateHz        = 10.0e6;
+   stream.maxSamplesPerPacket = layout.samplesPerPacket;
+   stream.includeTrailer      = layout.header.trailer;
+   return stream;
 }
 
-BenchResult runBenchmark(Vita49_2::Vita49Codec& codec,
-                         const Vita49_2::IQSamples& samples,
-                         uint32_t streamId,
-                         int iterations)
+Case makeSignalCase(const std::string& group, const std::string& operation, const SignalLayout& layout)
 {
-   BenchResult result{};
-   result.iterations    = iterations;
-   result.totalSamples  = samples.size() * static_cast<size_t>(iterations);
+   // Packet size limits may split the requested packets further
+   const size_t packets = std::max(BATCH_SAMPLES / layout.samplesPerPacket, MIN_BATCH_PACKETS);
+
+   auto samples = std::make_shared<const Vita49_2::IQSamples>(
+      generateTestSignal(packets * layout.samplesPerPacket));
+   const auto codec = makeCodec(layout);
+   auto stream = makeStream(layout);
+   auto encoded = std::make_shared<std::vector<uint8_t>>();
+   (void)codec.packetizeSignalData(stream, *samples, *encoded);
+
+   Case c;
+   c.group            = group;
+   c.operation        = operation;
+   c.byteOrder        = orderName(layout.order);
+   c.header           = layout.header.name;
+   c.payloadFormat    = formatName(layout.format);
+   c.samplesPerPacket = layout.samplesPerPacket;
+   c.packets          = static_cast<size_t>(std::ranges::distance(
+      codec.viewStream(encoded->data(), encoded->size())));
+   c.bytes            = encoded->size();
+   c.samples          = samples->size();
+   c.name = fmt::format("{}/{}/{}/{}/{}/spp{}", group, operation, c.byteOrder, c.header,
+                        c.payloadFormat, c.samplesPerPacket);
+
+   if (operation == "packetize")
+   {
+      c.makeRunner = [layout, samples, bytes = c.bytes]() -> std::function<void()>
+      {
+         auto out = std::make_shared<std::vector<uint8_t>>(bytes);
+         return [layout, samples, out]
+         {
+            auto state = makeStream(layout);
+            sink.fetch_add(makeCodec(layout).packetizeSignalData(state, *samples, std::span<uint8_t>(*out)),
+                           std::memory_order_relaxed);
+         };
+      };
+   }
+   else if (operation == "parse")
+   {
+      c.makeRunner = [layout, encoded]() -> std::function<void()>
+      {
+         return [layout, encoded]
+         {
+            const auto parsed = makeCodec(layout).parseStream(encoded->data(), encoded->size());
+            sink.fetch_add(parsed.size(), std::memory_order_relaxed);
+         };
+      };
+   }
+   else if (operation == "view")
+   {
+      c.makeRunner = [layout, encoded]() -> std::function<void()>
+      {
+         auto out = std::make_shared<Vita49_2::IQSamples>(layout.samplesPerPacket);
+         return [layout, encoded, out]
+         {
+            size_t decoded = 0;
+            for (const auto& packet : makeCodec(layout).viewStream(encoded->data(), encoded->size()))
+            {
+               decoded += packet.decodeSamples(*out);
+            }
+            sink.fetch_add(decoded, std::memory_order_relaxed);
+         };
+      };
+   }
+   else if (operation == "sequence")
+   {
+      c.makeRunner = [layout, encoded]() -> std::function<void()>
+      {
+         return [layout, encoded]
+         {
+            uint64_t timestamps = 0;
+            Vita49_2::PacketSequencer sequencer(
+               [&timestamps](const Vita49_2::PacketView& packet)
+               {
+                  timestamps += packet.header().fractionalTimestamp.value_or(packet.header().packetCount);
+               },
+               {}, 4);
+            for (const auto& packet : makeCodec(layout).viewStream(encoded->data(), encoded->size()))
+            {
+               sequencer.push(packet);
+            }
+            sink.fetch_add(timestamps + sequencer.lostPackets(), std::memory_order_relaxed);
+         };
+      };
+   }
+   else   // scan
+   {
+      c.makeRunner = [layout, encoded]() -> std::function<void()>
+      {
+         return [layout, encoded]
+         {
+            uint64_t timestamps = 0;
+            for (const auto& packet : makeCodec(layout).viewStream(encoded->data(), encoded->size()))
+            {
+               timestamps += packet.header().fractionalTimestamp.value_or(packet.header().packetCount);
+            }
+            sink.fetch_add(timestamps, std::memory_order_relaxed);
+         };
+      };
+   }
+   return c;
+}
 
-   // ----- Encode benchmark -----
-   std::vector<std::vector<uint8_t>> encodedBuffers;
-   encodedBuffers.reserve(static_cast<size_t>(iterations));
+// ============================================================================
+// Context cases
+// ============================================================================
 
-   auto encStart = std::chrono::steady_clock::now();
-   for (int i = 0; i < iterations; ++i)
+Vita49_2::ContextFields contextFieldSet(const std::string& name)
+{
+   Vita49_2::ContextFields fields;
+   fields.sampleRate = 1.0e6;
+   if (name == "rate")
    {
-      encodedBuffers.push_back(codec.encodeSignalData(streamId, samples));
+      return fields;
    }
-   auto encEnd = std::chrono::steady_clock::now();
-   result.encodeMs = std::chrono::duration<double, std::milli>(encEnd - encStart).count();
 
-   // Compute total bytes
-   for (const auto& buf : encodedBuffers)
+   fields.rfFrequency   = 2.4e9;
+   fields.bandwidth     = 20.0e6;
+   fields.gain          = 15.25;
+   fields.payloadFormat = Vita49_2::PayloadFormat::Int16;
+   if (name == "tuning")
    {
-      result.totalBytes += buf.size();
+      return fields;
    }
 
-   // ----- Decode benchmark -----
-   auto decStart = std::chrono::steady_clock::now();
-   for (int i = 0; i < iterations; ++i)
+   fields.changeIndicator  = true;
+   fields.referencePointId = 0x00ABCDEF;
+   fields.ifRefFrequency   = 70.0e6;
+   fields.rfFreqOffset     = 100.0e3;
+   fields.ifBandOffset     = -5.0e3;
+   fields.referenceLevel   = -30.5;
+   fields.overRangeCount   = 42;
+   return fields;
+}
+
+Case makeContextCase(const std::string& operation, const std::string& fieldSet)
+{
+   const auto fields = contextFieldSet(fieldSet);
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+
+   auto encoded = std::make_shared<std::vector<uint8_t>>();
+   for (size_t i = 0; i < CONTEXT_BATCH_PACKETS; ++i)
    {
-      auto packets = codec.parseStream(
-         encodedBuffers[static_cast<size_t>(i)].data(),
-         encodedBuffers[static_cast<size_t>(i)].size());
-      result.totalPackets += packets.size();
+      const auto packet = codec.encodeContext(STREAM_ID, fields, static_cast<uint8_t>(i & 0xF));
+      encoded->insert(encoded->end(), packet.begin(), packet.end());
    }
-   auto decEnd = std::chrono::steady_clock::now();
-   result.decodeMs = std::chrono::duration<double, std::milli>(decEnd - decStart).count();
 
-   return result;
+   Case c;
+   c.group         = "context";
+   c.operation     = operation;
+   c.byteOrder     = orderName(Vita49_2::ByteOrder::BigEndian);
+   c.contextFields = fieldSet;
+   c.packets       = CONTEXT_BATCH_PACKETS;
+   c.bytes         = encoded->size();
+   c.name          = fmt::format("context/{}/{}/{}", operation, c.byteOrder, fieldSet);
+
+   if (operation == "encode")
+   {
+      c.makeRunner = [fields]() -> std::function<void()>
+      {
+         return [fields]
+         {
+            const Vita49_2::Vita49Codec encoder(Vita49_2::ByteOrder::BigEndian);
+            size_t bytes = 0;
+            for (size_t i = 0; i < CONTEXT_BATCH_PACKETS; ++i)
+            {
+               bytes += encoder.encodeContext(STREAM_ID, fields, static_cast<uint8_t>(i & 0xF)).size();
+            }
+            sink.fetch_add(bytes, std::memory_order_relaxed);
+         };
+      };
+   }
+   else   // decode
+   {
+      c.makeRunner = [encoded]() -> std::function<void()>
+      {
+         return [encoded]
+         {
+            const Vita49_2::Vita49Codec decoder(Vita49_2::ByteOrder::BigEndian);
+            sink.fetch_add(decoder.parseStream(encoded->data(), encoded->size()).size(),
+                           std::memory_order_relaxed);
+         };
+      };
+   }
+   return c;
 }
 
-BenchResult runContextBenchmark(Vita49_2::Vita49Codec& codec,
-                                uint32_t streamId,
-                                int iterations)
+// ============================================================================
+// Suite
+// ============================================================================
+
+std::vector<Case> buildSuite()
 {
-   // Build a context with all supported fields
-   Vita49_2::ContextFields fields;
-   fields.changeIndicator = true;
-   fields.referencePointId = 0x00ABCDEF;
-   fields.bandwidth      = 20.0e6;
-   fields.ifRefFrequency = 70.0e6;
-   fields.rfFrequency    = 2.4e9;
-   fields.rfFreqOffset   = 100.0e3;
-   fields.ifBandOffset   = -5.0e3;
-   fields.referenceLevel = -30.5;
-   fields.gain           = 15.25;
-   fields.overRangeCount = 42;
-   fields.sampleRate     = 1.0e6;
+   using Vita49_2::ByteOrder;
+   using Vita49_2::PayloadFormat;
+
+   std::vector<Case> cases;
+
+   // Signal data: samples per packet x byte order x header options x operation
+   for (const char* operation : {"packetize", "parse", "view", "scan", "sequence"})
+   {
+      for (const ByteOrder order : {ByteOrder::BigEndian, ByteOrder::LittleEndian})
+      {
+         for (const HeaderOptions& header : HEADER_OPTIONS)
+         {
+            for (const size_t spp : {64UL, 256UL, 1024UL, 8192UL, 65533UL})
+            {
+               cases.push_back(makeSignalCase("signal", operation,
+                                              {order, header, PayloadFormat::Int16, spp}));
+            }
+         }
+      }
+   }
+
+   // Context packets: field set x encode / decode
+   for (const char* operation : {"encode", "decode"})
+   {
+      for (const char* fieldSet : {"rate", "tuning", "all"})
+      {
+         cases.push_back(makeContextCase(operation, fieldSet));
+      }
+   }
 
-   BenchResult result{};
-   result.iterations = iterations;
-   result.totalSamples = 0;
+   // Payload formats: link bytes and speed against quantization error
+   for (const PayloadFormat format : {PayloadFormat::Int16, PayloadFormat::Int12Packed,
+                                      PayloadFormat::Int8, PayloadFormat::Float32})
+   {
+      const SignalLayout layout{ByteOrder::BigEndian, HEADER_OPTIONS[0], format, 1024};
+      const double errorDbfs = roundTripErrorDb(makeCodec(layout), generateTestSignal(100000));
+      for (const char* operation : {"packetize", "parse"})
+      {
+         cases.push_back(makeSignalCase("format", operation, layout));
+         cases.back().errorDbfs = errorDbfs;
+      }
+   }
 
-   // Encode
-   std::vector<std::vector<uint8_t>> encodedBuffers;
-   encodedBuffers.reserve(static_cast<size_t>(iterations));
+   return cases;
+}
 
-   auto encStart = std::chrono::steady_clock::now();
-   for (int i = 0; i < iterations; ++i)
+CaseResult runCase(const Case& spec, size_t threads, const Options& options,
+                   CommonUtils::WorkerPool& pool)
+{
+   std::vector<std::function<void()>> runners;
+   for (size_t i = 0; i < threads; ++i)
    {
-      encodedBuffers.push_back(codec.encodeContext(streamId, fields));
+      runners.push_back(spec.makeRunner());
    }
-   auto encEnd = std::chrono::steady_clock::now();
-   result.encodeMs = std::chrono::duration<double, std::milli>(encEnd - encStart).count();
+   const std::function<void(size_t)> task = [&runners](size_t i) { runners[i](); };
+   const auto batch = [&]
+   {
+      if (threads == 1)
+      {
+         runners[0]();
+      }
+      else
+      {
+         pool.run(threads, task);
+      }
+   };
 
-   for (const auto& buf : encodedBuffers)
+   for (int i = 0; i < options.warmup; ++i)
    {
-      result.totalBytes += buf.size();
+      batch();
    }
 
-   // Decode
-   auto decStart = std::chrono::steady_clock::now();
-   for (int i = 0; i < iterations; ++i)
+   // ns/packet of every repetition, across all threads' packets
+   const double packets = static_cast<double>(spec.packets * threads);
+   std::vector<double> nsPerPacket;
+   nsPerPacket.reserve(static_cast<size_t>(options.iterations));
+   double totalNs = 0.0;
+   for (int i = 0; i < options.iterations; ++i)
    {
-      auto packets = codec.parseStream(
-         encodedBuffers[static_cast<size_t>(i)].data(),
-         encodedBuffers[static_cast<size_t>(i)].size());
-      result.totalPackets += packets.size();
+      const auto start = std::chrono::steady_clock::now();
+      batch();
+      const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      totalNs += ns;
+      nsPerPacket.push_back(ns / packets);
    }
-   auto decEnd = std::chrono::steady_clock::now();
-   result.decodeMs = std::chrono::duration<double, std::milli>(decEnd - decStart).count();
+   std::sort(nsPerPacket.begin(), nsPerPacket.end());
 
+   const auto percentile = [&nsPerPacket](double fraction)
+   {
+      const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(nsPerPacket.size())));
+      return nsPerPacket[std::clamp<size_t>(rank, 1, nsPerPacket.size()) - 1];
+   };
+
+   CaseResult result;
+   result.spec    = &spec;
+   result.threads = threads;
+   result.meanNs  = totalNs / (packets * options.iterations);
+   result.p50Ns   = percentile(0.50);
+   result.p99Ns   = percentile(0.99);
+   const double seconds = totalNs * 1e-9;
+   result.gbPerSecond = static_cast<double>(spec.bytes * threads) * options.iterations / seconds / 1e9;
+   result.msamplesPerSecond =
+      static_cast<double>(spec.samples * threads) * options.iterations / seconds / 1e6;
    return result;
 }
 
+// ============================================================================
+// Reporting
+// ============================================================================
+
+void logHeader()
+{
+   GPINFO("{:<52s}{:<5s}{:<12s}{:<12s}{:<12s}{:<10s}{:<12s}{:<10s}", "Case", "Thr", "ns/pkt",
+          "p50", "p99", "GB/s", "MSa/s", "Err(dBFS)");
+   GPINFO("{}", std::string(125, '-'));
+}
+
+void logResult(const CaseResult& r)
+{
+   const std::string error = r.spec->errorDbfs.has_value() ? fmt::format("{:.1f}", *r.spec->errorDbfs) : "";
+   GPINFO("{:<52s}{:<5d}{:<12.1f}{:<12.1f}{:<12.1f}{:<10.3f}{:<12.1f}{:<10s}", r.spec->name, r.threads,
+          r.meanNs, r.p50Ns, r.p99Ns, r.gbPerSecond, r.msamplesPerSecond, error);
+}
+
+/// Model name of the first CPU, for telling results of different hosts apart
+std::string cpuModel()
+{
+   std::ifstream cpuinfo("/proc/cpuinfo");
+   std::string line;
+   while (std::getline(cpuinfo, line))
+   {
+      if (line.starts_with("model name"))
+      {
+         const size_t colon = line.find(':');
+         return (colon != std::string::npos) ? line.substr(line.find_first_not_of(' ', colon + 1)) : line;
+      }
+   }
+   return "unknown";
+}
+
+std::string jsonString(const std::string& text)
+{
+   std::string quoted = "\"";
+   for (const char ch : text)
+   {
+      if (ch == '"' || ch == '\\')
+      {
+         quoted += '\\';
+      }
+      quoted += ch;
+   }
+   return quoted + "\"";
+}
+
+std::string jsonNumber(double value)
+{
+   return std::isfinite(value) ? fmt::format("{:.4f}", value) : "null";
+}
+
+bool writeJson(const std::string& path, const Options& options, const std::vector<CaseResult>& results)
+{
+   std::ofstream out(path);
+   if (!out)
+   {
+      return false;
+   }
+   out << fmt::format("{{\n  \"benchmark\": \"Vita49PerfBenchmark\",\n  \"cpu\": {},\n  \"isa\": {},\n"
+                      "  \"hardware_threads\": {},\n  \"compiler\": {},\n  \"iterations\": {},\n"
+                      "  \"warmup\": {},\n  \"cases\": [\n",
+                      jsonString(cpuModel()), jsonString(Vita49_2::sampleConversionIsa()),
+                      std::thread::hardware_concurrency(), jsonString(__VERSION__), options.iterations,
+                      options.warmup);
+   for (size_t i = 0; i < results.size(); ++i)
+   {
+      const CaseResult& r = results[i];
+      const Case& c = *r.spec;
+      out << fmt::format("    {{\"name\": {}, \"group\": {}, \"operation\": {}, \"byte_order\": {}, "
+                         "\"header\": {}, \"context_fields\": {}, \"payload_format\": {}, "
+                         "\"samples_per_packet\": {}, \"threads\": {}, \"packets_per_iteration\": {}, "
+                         "\"bytes_per_iteration\": {}, \"ns_per_packet\": {{\"mean\": {}, \"p50\": {}, "
+                         "\"p99\": {}}}, \"gb_per_s\": {}, \"msamples_per_s\": {}, \"error_dbfs\": {}}}{}\n",
+                         jsonString(c.name), jsonString(c.group), jsonString(c.operation),
+                         jsonString(c.byteOrder), jsonString(c.header), jsonString(c.contextFields),
+                         jsonString(c.payloadFormat), c.samplesPerPacket, r.threads, c.packets, c.bytes,
+                         jsonNumber(r.meanNs), jsonNumber(r.p50Ns), jsonNumber(r.p99Ns),
+                         jsonNumber(r.gbPerSecond), jsonNumber(r.msamplesPerSecond),
+                         c.errorDbfs.has_value() ? jsonNumber(*c.errorDbfs) : "null",
+                         i + 1 < results.size() ? "," : "");
+   }
+   out << "  ]\n}\n";
+   return static_cast<bool>(out);
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -189,59 +645,65 @@ int main(int argc, char* argv[]) // NOLINT
    CommonUtils::GeneralLogger logger;
    logger.init("Vita49PerfBenchmark");
 
-   int iterations = 100;
-   if (argc > 1) { iterations = std::stoi(argv[1]); }
-   iterations = std::max(iterations, 1);
+   Options options;
+   if (!parseOptions(argc, argv, options))
+   {
+      GPERROR("Usage: {} [--iterations 100] [--warmup 10] [--threads 1,8] [--filter signal/parse] "
+              "[--json results.json]",
+              argv[0]);
+      return 1;
+   }
+   if (options.threads.empty())
+   {
+      options.threads = {1, std::max<size_t>(std::thread::hardware_concurrency(), 1)};
+   }
+   std::sort(options.threads.begin(), options.threads.end());
+   options.threads.erase(std::unique(options.threads.begin(), options.threads.end()), options.threads.end());
+   std::erase(options.threads, 0);
 
-   constexpr uint32_t STREAM_ID = 0xBEEF;
+   std::vector<Case> cases = buildSuite();
+   std::erase_if(cases, [&options](const Case& c) { return c.name.find(options.filter) == std::string::npos; });
 
    GPINFO("==========================================================");
    GPINFO("VITA 49.2 Performance Benchmark");
    GPINFO("==========================================================");
-   GPINFO("  Iterations per size: {}", iterations);
+   GPINFO("  Iterations per case: {} (+{} warmup)", options.iterations, options.warmup);
+   std::string threadCounts;
+   for (const size_t threads : options.threads)
+   {
+      threadCounts += (threadCounts.empty() ? "" : ",") + std::to_string(threads);
+   }
+   GPINFO("  Thread counts:       {}", threadCounts);
+   GPINFO("  Cases:               {}", cases.size() * options.threads.size());
+   GPINFO("  Sample kernel ISA:   {}", Vita49_2::sampleConversionIsa());
    GPINFO("==========================================================");
 
-   // ----- Signal Data — BigEndian -----
-   GPINFO("[Signal Data — BigEndian]");
+   std::vector<CaseResult> results;
+   for (const size_t threads : options.threads)
    {
-      Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
-      logHeader();
-
-      for (const size_t sz : {100UL, 1000UL, 10000UL, 50000UL, 100000UL, 500000UL, 1000000UL})
+      CommonUtils::WorkerPool pool(threads - 1);
+      std::string group;
+      for (const Case& c : cases)
       {
-         auto samples = generateTestSignal(sz);
-         auto result  = runBenchmark(codec, samples, STREAM_ID, iterations);
-         logResult(sz, result);
+         if (c.group != group)
+         {
+            group = c.group;
+            GPINFO("[{} — {} thread(s)]", group, threads);
+            logHeader();
+         }
+         results.push_back(runCase(c, threads, options, pool));
+         logResult(results.back());
       }
    }
 
-   // ----- Signal Data — LittleEndian -----
-   GPINFO("[Signal Data — LittleEndian]");
+   if (!options.jsonPath.empty())
    {
-      Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::LittleEndian);
-      logHeader();
-
-      for (const size_t sz : {100UL, 1000UL, 10000UL, 100000UL, 1000000UL})
+      if (!writeJson(options.jsonPath, options, results))
       {
-         auto samples = generateTestSignal(sz);
-         auto result  = runBenchmark(codec, samples, STREAM_ID, iterations);
-         logResult(sz, result);
+         GPERROR("Failed to write {}", options.jsonPath);
+         return 1;
       }
-   }
-
-   // ----- Context Packets -----
-   GPINFO("[Context Packets — BigEndian, all fields]");
-   {
-      Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
-
-      auto result = runContextBenchmark(codec, STREAM_ID, iterations * 10);
-
-      double avgEncUs = (result.encodeMs / result.iterations) * 1000.0;
-      double avgDecUs = (result.decodeMs / result.iterations) * 1000.0;
-
-      GPINFO("  Encode: {:.2f} us/packet ({:.0f} bytes)",
-             avgEncUs, static_cast<double>(result.totalBytes) / result.iterations);
-      GPINFO("  Decode: {:.2f} us/packet", avgDecUs);
+      GPINFO("Results written to {}", options.jsonPath);
    }
 
    GPINFO("==========================================================");
@@ -0,0 +1,189 @@
+#ifndef COMMONUTILS_BOUNDEDQUEUE_H_
+#define COMMONUTILS_BOUNDEDQUEUE_H_
+
+// System headers
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace CommonUtils
+{
+
+/**
+ * @class BoundedQueue
+ * @brief Thread-safe, fixed-capacity FIFO that connects pipeline stages.
+ *
+ * `push()` blocks while the queue is full, so a slow consumer applies
+ * back-pressure to its producer instead of letting memory grow without
+ * bound.  `close()` wakes every waiter: further pushes fail, and `pop()`
+ * drains what is left before returning `std::nullopt`.
+ *
+ * Thread-safety: any number of producers and consumers.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+   /**
+    * @brief Construct an open, empty queue.
+    * @throws std::invalid_argument if capacity is zero.
+    */
+   explicit BoundedQueue(std::size_t capacity)
+      : _capacity{capacity}
+   {
+      if (capacity == 0)
+      {
+         throw std::invalid_argument("BoundedQueue capacity must be > 0");
+      }
+   }
+
+   // Non-copyable, non-movable (waiters hold references to the mutex).
+   BoundedQueue(const BoundedQueue&) = delete;
+   BoundedQueue& operator=(const BoundedQueue&) = delete;
+   BoundedQueue(BoundedQueue&&) = delete;
+   BoundedQueue& operator=(BoundedQueue&&) = delete;
+   ~BoundedQueue() = default;
+
+   /**
+    * @brief Append an item, blocking while the queue is full.
+    * @return false if the queue was closed before space became available.
+    */
+   bool push(T item)
+   {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _notFull.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+      if (_closed)
+      {
+         return false;
+      }
+      enqueueLocked(std::move(item));
+      lock.unlock();
+      _notEmpty.notify_one();
+      return true;
+   }
+
+   /**
+    * @brief Append an item without blocking.
+    * @return false if the queue is full or closed.
+    */
+   bool tryPush(T item)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(_mutex);
+         if (_closed || _items.size() >= _capacity)
+         {
+            return false;
+         }
+         enqueueLocked(std::move(item));
+      }
+      _notEmpty.notify_one();
+      return true;
+   }
+
+   /**
+    * @brief Remove the oldest item, blocking while the queue is empty.
+    * @return The item, or std::nullopt once the queue is closed and drained.
+    */
+   [[nodiscard]] std::optional<T> pop()
+   {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+      if (_items.empty())
+      {
+         return std::nullopt;
+      }
+      T item = std::move(_items.front());
+      _items.pop_front();
+      lock.unlock();
+      _notFull.notify_one();
+      return item;
+   }
+
+   /**
+    * @brief Remove the oldest item without blocking.
+    * @return The item, or std::nullopt if the queue is empty.
+    */
+   [[nodiscard]] std::optional<T> tryPop()
+   {
+      std::optional<T> item;
+      {
+         const std::lock_guard<std::mutex> lock(_mutex);
+         if (_items.empty())
+         {
+            return std::nullopt;
+         }
+         item.emplace(std::move(_items.front()));
+         _items.pop_front();
+      }
+      _notFull.notify_one();
+      return item;
+   }
+
+   /** @brief Reject further pushes and wake all blocked producers / consumers. */
+   void close()
+   {
+      {
+         const std::lock_guard<std::mutex> lock(_mutex);
+         _closed = true;
+      }
+      _notFull.notify_all();
+      _notEmpty.notify_all();
+   }
+
+   /** @brief Discard any queued items, clear the high-water mark, and reopen. */
+   void reopen()
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _items.clear();
+      _highWater = 0;
+      _closed    = false;
+   }
+
+   /** @brief Return true once close() has been called (until reopen()). */
+   [[nodiscard]] bool isClosed() const
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      return _closed;
+   }
+
+   /** @brief Return the number of queued items. */
+   [[nodiscard]] std::size_t size() const
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      return _items.size();
+   }
+
+   /** @brief Return the largest size() observed since construction / reopen(). */
+   [[nodiscard]] std::size_t highWaterMark() const
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      return _highWater;
+   }
+
+   /** @brief Return the maximum number of items the queue can hold. */
+   [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+private:
+   void enqueueLocked(T&& item)
+   {
+      _items.push_back(std::move(item));
+      _highWater = std::max(_highWater, _items.size());
+   }
+
+   const std::size_t _capacity;
+   mutable std::mutex _mutex;
+   std::condition_variable _notFull;
+   std::condition_variable _notEmpty;
+   std::deque<T> _items;
+   std::size_t _highWater{0};
+   bool _closed{false};
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_BOUNDEDQUEUE_H_
@@ -3,8 +3,11 @@
 
 // System headers
 #include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace CommonUtils
@@ -15,6 +18,10 @@ namespace CommonUtils
  * @brief Thread-unsafe, fixed-capacity circular buffer for time-series history.
  * Stores the most recent `capacity` elements; older entries are silently
  * overwritten.
+ *
+ * A power-of-two capacity wraps indices with a mask instead of a modulo.
+ * Bulk pushes copy in at most two contiguous runs, and spans() exposes the
+ * contents in place, so readers need not copy them out with toVector().
  */
 template <typename T>
 class CircularBuffer
@@ -27,6 +34,7 @@ public:
    explicit CircularBuffer(std::size_t capacity)
       : _data(capacity)
       , _capacity{capacity}
+      , _mask{std::has_single_bit(capacity) ? capacity - 1 : 0}
    {
       if (capacity == 0)
       {
@@ -38,26 +46,47 @@ public:
    void push(const T& value)
    {
       _data[_head] = value;
-      _head = (_head + 1) % _capacity;
+      _head = wrap(_head + 1);
       if (_size < _capacity)
       {
          ++_size;
       }
    }
 
-   /** @brief Push a range of elements. */
-   void push(const T* data, std::size_t count)
+   /**
+    * @brief Push a range of elements, overwriting the oldest if full.
+    *
+    * Copies in at most two contiguous runs; of a range longer than the
+    * capacity only the last `capacity` elements are copied.
+    */
+   void push(std::span<const T> values)
    {
-      for (std::size_t i = 0; i < count; ++i)
+      if (values.size() >= _capacity)
       {
-         push(data[i]);
+         std::copy(values.end() - static_cast<std::ptrdiff_t>(_capacity), values.end(), _data.begin());
+         _head = 0;
+         _size = _capacity;
+         return;
       }
+
+      const std::size_t first = std::min(values.size(), _capacity - _head);
+      const auto split = values.begin() + static_cast<std::ptrdiff_t>(first);
+      std::copy(values.begin(), split, _data.begin() + static_cast<std::ptrdiff_t>(_head));
+      std::copy(split, values.end(), _data.begin());
+      _head = wrap(_head + values.size());
+      _size = std::min(_size + values.size(), _capacity);
+   }
+
+   /** @brief Push a range of elements. */
+   void push(const T* data, std::size_t count)
+   {
+      push(std::span<const T>(data, count));
    }
 
    /** @brief Push a vector of elements. */
    void push(const std::vector<T>& values)
    {
-      push(values.data(), values.size());
+      push(std::span<const T>(values));
    }
 
    /** @brief Access element by logical index (0 = oldest). */
@@ -83,18 +112,33 @@ public:
       {
          throw std::out_of_range("CircularBuffer::back called on empty buffer");
       }
-      return _data[(_head + _capacity - 1) % _capacity];
+      return _data[wrap(_head + _capacity - 1)];
+   }
+
+   /**
+    * @brief Get the stored elements in place as two contiguous runs.
+    * @return {older, newer}: iterate `first` then `second` for chronological
+    *         order; `second` is empty unless the contents wrap around.
+    *         Invalidated by the next push() or clear().
+    */
+   [[nodiscard]] std::pair<std::span<const T>, std::span<const T>> spans() const
+   {
+      const std::span<const T> all(_data);
+      if (_size < _capacity)
+      {
+         return {all.first(_size), {}};
+      }
+      return {all.subspan(_head), all.first(_head)};
    }
 
    /** @brief Copy all stored elements in chronological order into a vector. */
    [[nodiscard]] std::vector<T> toVector() const
    {
+      const auto [older, newer] = spans();
       std::vector<T> result;
       result.reserve(_size);
-      for (std::size_t i = 0; i < _size; ++i)
-      {
-         result.push_back((*this)[i]);
-      }
+      result.insert(result.end(), older.begin(), older.end());
+      result.insert(result.end(), newer.begin(), newer.end());
       return result;
    }
 
@@ -124,11 +168,18 @@ private:
       {
          return logicalIndex;
       }
-      return (_head + logicalIndex) % _capacity;
+      return wrap(_head + logicalIndex);
+   }
+
+   // Reduce an index in [0, 2 * capacity) to [0, capacity).
+   [[nodiscard]] std::size_t wrap(std::size_t index) const
+   {
+      return (_mask != 0) ? (index & _mask) : (index % _capacity);
    }
 
    std::vector<T> _data;
    std::size_t _capacity;
+   std::size_t _mask;   // capacity - 1 for a power-of-two capacity, else 0.
    std::size_t _head{0};
    std::size_t _size{0};
 };
@@ -1,20 +1,72 @@
 #ifndef COMMONUTILS_DATAHANDLER_H_
 #define COMMONUTILS_DATAHANDLER_H_
 
+// Project headers
+#include "DataHandlerStats.h"
+#include "LatencyHistogram.h"
+#include "MemoryBudget.h"
+#include "TaskPool.h"
+#include "ThreadConfig.h"
+
 // System headers
 #include <atomic>
+#include <algorithm>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <map>
-
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <string>
 #include <thread>
+#include <utility>
 
 namespace CommonUtils
 {
 
+/**
+ * @brief What DataHandler::signalData() does when the queue is full.
+ */
+enum class OverflowPolicy : std::uint8_t
+{
+   Unbounded,    ///< Never drop or wait; the queue grows without limit (default).
+   LatestOnly,   ///< Keep only the newest item; a queued item is replaced (coalesced).
+   DropOldest,   ///< Keep at most `capacity` items; the oldest is dropped.
+   DropNewest,   ///< Keep at most `capacity` items; the incoming item is dropped.
+   Block         ///< Wait until the worker makes room (producer is held back).
+};
+
+/**
+ * @brief Where DataHandler runs a listener.
+ */
+enum class DispatchMode : std::uint8_t
+{
+   Inline,            ///< On the handler's worker thread, one listener after another (default).
+   DedicatedThread,   ///< On the listener's own thread, fed by its own bounded queue.
+   SharedPool         ///< As tasks on a TaskPool, fed by its own bounded queue.
+};
+
+/**
+ * @class ListenerOptions
+ * @brief How a DataHandler listener is dispatched.
+ *
+ * `overflow` and `capacity` bound the listener's own queue (not used for
+ * Inline) exactly as DataHandler::setOverflowPolicy() bounds the shared one.
+ */
+struct ListenerOptions
+{
+   DispatchMode mode{DispatchMode::Inline};
+   OverflowPolicy overflow{OverflowPolicy::DropOldest};
+   std::size_t capacity{8};
+   TaskPool* pool{nullptr};   ///< SharedPool only; nullptr = TaskPool::shared().
+   TaskPriority priority{TaskPriority::Display};   ///< SharedPool only: priority of its tasks.
+};
+
 /**
  * @class DataHandler
  * @brief Thread-safe queue that dispatches data to registered listeners.
@@ -22,19 +74,60 @@ namespace CommonUtils
  * Listeners register an std::function to be called when new data is
  * signalled.  All listener callbacks are invoked on a dedicated worker
  * thread, decoupling the producer from the consumers.
+ *
+ * By default the queue is unbounded.  A policy given to the constructor
+ * (or later to setOverflowPolicy()) bounds it so a slow listener either
+ * loses frames (counted by droppedCount(); coalescedCount() is the share
+ * superseded under LatestOnly) or, with OverflowPolicy::Block, throttles
+ * the producer.  The worker is only woken when the queue becomes
+ * non-empty, not for every item.
+ *
+ * Listeners run inline on the worker by default, so a slow one delays the
+ * rest.  A listener registered with DispatchMode::DedicatedThread or
+ * DispatchMode::SharedPool instead gets its own bounded queue (see
+ * ListenerOptions) that the worker only hands items to; it then sees items
+ * in order, never concurrently with itself, and drops (or blocks) on its
+ * own when it falls behind.  Listeners may register and unregister
+ * listeners, themselves included, from their callbacks.
+ *
+ * stats() reports the queue latency, backlog, dispatch rate and each
+ * listener's callback time; the cost is a few clock reads and relaxed
+ * atomic increments per item.  A handler named with setName() can also be
+ * queried through DataHandlerRegistry.
+ *
+ * setMemoryAccounting() also reports the bytes held by queued items to the
+ * MemoryRegistry, and keeps the queue within the budget for its account
+ * by coalescing (dropping the oldest items, the newest is always kept).
  */
 template <typename T>
 class DataHandler
 {
 public:
    using Listener = std::function<void(const T&)>;
+   using TimePoint = std::chrono::steady_clock::time_point;
+   /// Called after each item was dispatched, with when the first listener
+   /// started and the last one returned.
+   using DispatchObserver = std::function<void(const T&, TimePoint start, TimePoint end)>;
 
    /**
     * @brief Construct a DataHandler and start the worker thread.
     */
-   DataHandler() : _stopFlag(false)
+   DataHandler() : DataHandler(OverflowPolicy::Unbounded)
+   {
+   }
+
+   /**
+    * @brief Construct a bounded DataHandler and start the worker thread.
+    * @param policy   Overflow behaviour (see setOverflowPolicy()).
+    * @param capacity Maximum queued items for the bounded policies.
+    */
+   explicit DataHandler(OverflowPolicy policy, size_t capacity = 1)
+      : _policy(policy)
+      , _capacity(boundedCapacity(policy, capacity))
+      , _stopFlag(false)
    {
       _workerThread = std::thread(&DataHandler::processData, this);
+      ThreadConfig::instance().apply(_workerThread, "DataHandler");
    }
 
    /**
@@ -42,16 +135,34 @@ public:
     */
    ~DataHandler()
    {
-      _stopFlag = true;
-      _condVar.notify_all();
-      if (_workerThread.joinable())
+      if (_registered)
       {
-         _workerThread.join();
+         DataHandlerRegistry::instance().remove(this);
+      }
+      {
+         const std::lock_guard<std::mutex> lock(_cvMutex);
+         _stopFlag = true;
       }
+      _condVar.notify_all();
+      _spaceCondVar.notify_all();
 
+      // Close the queued listeners before joining the worker: one blocked
+      // on a full Block listener queue only returns once it is closed.
+      std::shared_ptr<const ListenerMap> listeners;
       {
          const std::lock_guard<std::mutex> lock(_listenersMutex);
-         _listeners.clear();
+         listeners = std::exchange(_listeners, std::make_shared<const ListenerMap>());
+      }
+      for (const auto& entry : *listeners)
+      {
+         if (entry.second.channel)
+         {
+            entry.second.channel->close();
+         }
+      }
+      if (_workerThread.joinable())
+      {
+         _workerThread.join();
       }
 
       while (!_dataQueue.empty())
@@ -67,17 +178,171 @@ public:
    /**
     * @brief Push new data to the queue and notify the worker thread.
     *
-    * @param data The data item to enqueue.
+    * When the queue is full the overflow policy decides whether queued
+    * items are dropped or the caller waits for room.
+    *
+    * @param data The data item to enqueue (copied).
     */
    void signalData(const T& data)
+   {
+      emplace(data);
+   }
+
+   /**
+    * @brief As signalData(const T&), moving the item into the queue.
+    * @param data The data item to enqueue.
+    */
+   void signalData(T&& data)
+   {
+      emplace(std::move(data));
+   }
+
+   /**
+    * @brief As signalData(), constructing the item in place in the queue.
+    *
+    * The item is only constructed if the overflow policy admits it.
+    *
+    * @param args Constructor arguments of T.
+    */
+   template <typename... Args>
+   void emplace(Args&&... args)
    {
       if (_stopFlag) return;
 
-      const std::lock_guard<std::mutex> lock(_cvMutex);
+      bool wasEmpty = false;
       {
-         _dataQueue.push(data);
+         std::unique_lock<std::mutex> lock(_cvMutex);
+         if (_policy == OverflowPolicy::Block)
+         {
+            _spaceCondVar.wait(lock, [this] {
+               return _stopFlag || _policy != OverflowPolicy::Block ||
+                      _dataQueue.size() < _capacity;
+            });
+            if (_stopFlag) return;
+         }
+         if (_policy == OverflowPolicy::DropNewest && _dataQueue.size() >= _capacity)
+         {
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+         }
+         trimTo(_capacity - 1);
+         wasEmpty = _dataQueue.empty();
+         _dataQueue.emplace(std::chrono::steady_clock::now(), std::forward<Args>(args)...);
+         if (_memory)
+         {
+            accountNewest();
+         }
+         _highWater = std::max(_highWater, _dataQueue.size());
+      }
+      // The worker only sleeps on an empty queue.
+      if (wasEmpty)
+      {
+         _condVar.notify_one();
       }
-      _condVar.notify_one();
+   }
+
+   /**
+    * @brief Bound the queue and choose what happens when it is full.
+    *
+    * Items already queued beyond the new capacity are dropped (and
+    * counted) for the dropping policies; the oldest go first.
+    *
+    * @param policy   Overflow behaviour.
+    * @param capacity Maximum queued items (ignored for Unbounded; forced
+    *                 to 1 for LatestOnly; at least 1 otherwise).
+    */
+   void setOverflowPolicy(OverflowPolicy policy, size_t capacity = 1)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(_cvMutex);
+         _policy   = policy;
+         _capacity = boundedCapacity(policy, capacity);
+         trimTo(_capacity);
+      }
+      _spaceCondVar.notify_all();
+   }
+
+   /**
+    * @brief Get the overflow policy.
+    * @return Policy set by setOverflowPolicy() (Unbounded by default).
+    */
+   [[nodiscard]] OverflowPolicy overflowPolicy() const
+   {
+      const std::lock_guard<std::mutex> lock(_cvMutex);
+      return _policy;
+   }
+
+   /**
+    * @brief Get the queue capacity used by the bounded policies.
+    * @return Maximum queued items.
+    */
+   [[nodiscard]] size_t capacity() const
+   {
+      const std::lock_guard<std::mutex> lock(_cvMutex);
+      return _capacity;
+   }
+
+   /**
+    * @brief Account the queued items' memory and coalesce when over budget.
+    *
+    * From now on every queued item is weighed with `itemBytes` and the
+    * total reported to the MemoryRegistry as `account`.  While the queue
+    * holds more than the budget for that account, signalData() drops the
+    * oldest queued items (counted as coalesced) until it fits or only the
+    * new item is left.  Items already queued are not weighed.
+    *
+    * @param account    MemoryRegistry name, e.g. "engine.iqQueue".
+    * @param itemBytes  Bytes one item keeps alive (heap payload included).
+    */
+   void setMemoryAccounting(std::string account, std::function<size_t(const T&)> itemBytes)
+   {
+      auto memory = std::make_unique<MemoryAccount>(std::move(account), MemoryRelief::Coalesce);
+      const std::lock_guard<std::mutex> lock(_cvMutex);
+      _itemBytes = std::move(itemBytes);
+      _memory    = std::move(memory);
+      _memory->setBytes(_queuedBytes);
+   }
+
+   /**
+    * @brief Get the number of items dropped by the overflow policy.
+    * @return Items discarded since construction, including coalesced ones.
+    */
+   [[nodiscard]] std::uint64_t droppedCount() const
+   {
+      return _droppedCount.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Get the number of items superseded under LatestOnly or the memory budget.
+    * @return Coalesced items since construction (a subset of droppedCount()).
+    */
+   [[nodiscard]] std::uint64_t coalescedCount() const
+   {
+      return _coalescedCount.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Get the number of items waiting for the worker thread.
+    *
+    * Unlike watermarkInfo(), this does not wait for a running listener.
+    *
+    * @return Queued item count.
+    */
+   [[nodiscard]] size_t queuedCount() const
+   {
+      const std::lock_guard<std::mutex> lock(_cvMutex);
+      return _dataQueue.size();
+   }
+
+   /**
+    * @brief Get the deepest the queue has been.
+    * @return Largest number of items queued at once since construction or
+    *         the last resetStats().
+    */
+   [[nodiscard]] size_t highWaterMark() const
+   {
+      const std::lock_guard<std::mutex> lock(_cvMutex);
+      return _highWater;
    }
 
    /**
@@ -87,24 +352,105 @@ public:
     * @return A unique registration ID, or -1 if the handler is stopped.
     */
    int registerListener(const Listener& listener)
+   {
+      return registerListener(listener, ListenerOptions{});
+   }
+
+   /**
+    * @brief Register a listener callback with a dispatch mode.
+    *
+    * @param listener Callback invoked for each item.
+    * @param options  Dispatch mode and, for the queued modes, queue bound.
+    * @return A unique registration ID, or -1 if the handler is stopped.
+    */
+   int registerListener(const Listener& listener, const ListenerOptions& options)
    {
       if (_stopFlag) return -1;
+      auto metrics = std::make_shared<ListenerMetrics>();
+      std::shared_ptr<ListenerChannel> channel;
+      if (options.mode != DispatchMode::Inline)
+      {
+         channel = std::make_shared<ListenerChannel>(listener, options, metrics);
+         channel->start();
+      }
       const std::lock_guard<std::mutex> lock(_listenersMutex);
       _nextListenerId++;
-      _listeners[_nextListenerId] = listener;
+      auto updated = std::make_shared<ListenerMap>(*_listeners);
+      (*updated)[_nextListenerId] = ListenerEntry{listener, std::move(channel), metrics};
+      _listeners = std::move(updated);
+      {
+         const std::lock_guard<std::mutex> metricsLock(_metricsMutex);
+         _listenerMetrics[_nextListenerId] = std::move(metrics);
+      }
       return _nextListenerId;
    }
 
    /**
     * @brief Unregister a listener by its registration ID.
     *
+    * Once this returns the listener is not called again: a running inline
+    * dispatch, or a queued listener's current call, is waited for (unless
+    * this is called from that dispatch or call).
+    *
     * @param id The registration ID returned by registerListener().
     */
    void unregisterListener(int id)
    {
       if (_stopFlag) return;
-      const std::lock_guard<std::mutex> lock(_listenersMutex);
-      _listeners.erase(id);
+      std::shared_ptr<ListenerChannel> channel;
+      {
+         const std::lock_guard<std::mutex> lock(_listenersMutex);
+         const auto it = _listeners->find(id);
+         if (it == _listeners->end())
+         {
+            return;
+         }
+         channel = it->second.channel;
+         auto updated = std::make_shared<ListenerMap>(*_listeners);
+         updated->erase(id);
+         _listeners = std::move(updated);
+      }
+      {
+         const std::lock_guard<std::mutex> lock(_metricsMutex);
+         _listenerMetrics.erase(id);
+      }
+      if (channel)
+      {
+         channel->close();
+      }
+      else if (std::this_thread::get_id() != _workerThread.get_id())
+      {
+         const std::lock_guard<std::mutex> waitForDispatch(_dispatchMutex);
+      }
+   }
+
+   /**
+    * @brief Get the items a queued listener's own overflow policy dropped.
+    *
+    * @param id The registration ID returned by registerListener().
+    * @return Dropped items, or 0 for inline or unknown listeners.
+    */
+   [[nodiscard]] std::uint64_t listenerDroppedCount(int id) const
+   {
+      const std::lock_guard<std::mutex> lock(_metricsMutex);
+      const auto it = _listenerMetrics.find(id);
+      return (it != _listenerMetrics.end()) ? it->second->dropped.load(std::memory_order_relaxed) : 0;
+   }
+
+   /**
+    * @brief Install (or, with an empty function, remove) a dispatch observer.
+    *
+    * The observer runs on the worker thread after every listener has seen
+    * an item, e.g. to measure queueing and listener latency.  Queued
+    * (non-inline) listeners count as having seen it once it is handed to
+    * their queue.  Waits for a running dispatch to finish.
+    *
+    * @param observer Callback, or {} to remove it.
+    */
+   void setDispatchObserver(DispatchObserver observer)
+   {
+      const std::lock_guard<std::mutex> lock(_dispatchMutex);
+      _dispatchObserver = std::move(observer);
    }
 
    /**
@@ -116,16 +462,364 @@ public:
    {
       if (_stopFlag) return {0, 0};
 
-      const std::lock_guard<std::mutex> lock(_listenersMutex);
-      return {_listeners.size(), _dataQueue.size()};
+      const size_t queued = queuedCount();
+      const std::lock_guard<std::mutex> lock(_metricsMutex);
+      return {_listenerMetrics.size(), queued};
+   }
+
+   /**
+    * @brief Name the handler and register it with DataHandlerRegistry.
+    * The worker thread takes the ThreadConfig role "DataHandler.<name>".
+    * @param name Name to report in stats() and look the handler up by.
+    */
+   void setName(std::string name)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(_cvMutex);
+         _name = name;
+      }
+      ThreadConfig::instance().apply(_workerThread, "DataHandler." + name);
+      DataHandlerRegistry::instance().add(this, std::move(name), [this] { return stats(); });
+      _registered = true;
+   }
+
+   /**
+    * @brief Get the name given by setName().
+    * @return Handler name (empty if unnamed).
+    */
+   [[nodiscard]] std::string name() const
+   {
+      const std::lock_guard<std::mutex> lock(_cvMutex);
+      return _name;
+   }
+
+   /**
+    * @brief Get throughput, backlog and latency statistics.
+    *
+    * Never waits for a running listener.
+    *
+    * @return Statistics since construction or the last resetStats().
+    */
+   [[nodiscard]] DataHandlerStats stats() const
+   {
+      DataHandlerStats out;
+      TimePoint since;
+      {
+         const std::lock_guard<std::mutex> lock(_cvMutex);
+         out.name          = _name;
+         out.queued        = _dataQueue.size();
+         out.maxQueueDepth = _highWater;
+         out.queuedBytes   = _queuedBytes;
+         since             = _statsSince;
+      }
+      out.dispatched   = _dispatchedCount.load(std::memory_order_relaxed);
+      out.dropped      = droppedCount();
+      out.coalesced    = coalescedCount();
+      out.queueLatency = _queueLatency.summary();
+
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - since;
+      if (elapsed.count() > 0.0)
+      {
+         out.itemsPerSecond = static_cast<double>(out.dispatched) / elapsed.count();
+      }
+
+      const std::lock_guard<std::mutex> lock(_metricsMutex);
+      out.listeners.reserve(_listenerMetrics.size());
+      for (const auto& [id, metrics] : _listenerMetrics)
+      {
+         out.listeners.push_back(ListenerStats{
+            id, metrics->dropped.load(std::memory_order_relaxed), metrics->callbackTime.summary()});
+      }
+      return out;
+   }
+
+   /**
+    * @brief Restart the statistics period: clears the latency histograms and
+    *        dispatch count, and sets the maximum depth to the current one.
+    *
+    * Drop counts are cumulative and are not reset.
+    */
+   void resetStats()
+   {
+      {
+         const std::lock_guard<std::mutex> lock(_cvMutex);
+         _highWater  = _dataQueue.size();
+         _statsSince = std::chrono::steady_clock::now();
+         _dispatchedCount.store(0, std::memory_order_relaxed);
+         _queueLatency.reset();
+      }
+      const std::lock_guard<std::mutex> lock(_metricsMutex);
+      for (const auto& entry : _listenerMetrics)
+      {
+         entry.second->callbackTime.reset();
+      }
    }
 
 private:
+   // Per-listener counters, shared with its channel and read by stats()
+   // without waiting for a dispatch.
+   struct ListenerMetrics
+   {
+      LatencyHistogram callbackTime;
+      std::atomic<std::uint64_t> dropped{0};
+   };
+
+   // An item and when signalData() queued it.
+   struct QueuedItem
+   {
+      template <typename... Args>
+      explicit QueuedItem(TimePoint at, Args&&... args)
+         : enqueued(at)
+         , item(std::forward<Args>(args)...)
+      {
+      }
+
+      TimePoint enqueued;
+      T item;
+      size_t bytes{0};   // Weight under setMemoryAccounting().
+   };
+
+   static void invokeListener(const Listener& listener, const T& data, ListenerMetrics& metrics)
+   {
+      const TimePoint start = std::chrono::steady_clock::now();
+      try
+      {
+         listener(data);
+      }
+      catch (const std::exception& e)
+      {
+         std::cerr << "Listener threw an std::exception! " << e.what() << '\n';
+      }
+      catch (...)
+      {
+         std::cerr << "Listener threw an unknown exception!\n";
+      }
+      metrics.callbackTime.record(std::chrono::steady_clock::now() - start);
+   }
+
+   /**
+    * Own queue of a DedicatedThread / SharedPool listener, drained by its
+    * thread or by one pool task at a time (so calls never overlap).  The
+    * thread and pool tasks hold a reference, so the channel outlives them
+    * even if the listener unregisters itself.
+    */
+   class ListenerChannel : public std::enable_shared_from_this<ListenerChannel>
+   {
+   public:
+      /// Items one pool task delivers before yielding its pool thread.
+      static constexpr size_t POOL_BATCH = 16;
+
+      ListenerChannel(Listener listener, const ListenerOptions& options,
+                      std::shared_ptr<ListenerMetrics> metrics)
+         : _listener(std::move(listener))
+         , _metrics(std::move(metrics))
+         , _policy(options.overflow)
+         , _capacity(boundedCapacity(options.overflow, options.capacity))
+         , _pool(options.mode != DispatchMode::SharedPool ? nullptr
+                 : (options.pool != nullptr ? options.pool : &TaskPool::shared()))
+         , _priority(options.priority)
+      {
+      }
+
+      // Start the dedicated thread; call once the channel is owned by a shared_ptr.
+      void start()
+      {
+         if (_pool == nullptr)
+         {
+            _thread = std::thread([self = this->shared_from_this()] { self->threadLoop(); });
+            ThreadConfig::instance().apply(_thread, "DataHandler.listener");
+         }
+      }
+
+      void push(const T& data)
+      {
+         bool schedule = false;
+         {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_policy == OverflowPolicy::Block)
+            {
+               _space.wait(lock, [this] { return _closed || _queue.size() < _capacity; });
+            }
+            if (_closed) return;
+            if (_policy != OverflowPolicy::Unbounded && _policy != OverflowPolicy::Block &&
+                _queue.size() >= _capacity)
+            {
+               _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+               if (_policy == OverflowPolicy::DropNewest) return;
+               _queue.pop_front();
+            }
+            _queue.push_back(data);
+            schedule   = (_pool != nullptr) && !_scheduled;
+            _scheduled = _scheduled || schedule;
+         }
+         if (schedule)
+         {
+            _pool->post([self = this->shared_from_this()] { self->drain(); }, {_priority});
+         }
+         else
+         {
+            _ready.notify_one();
+         }
+      }
+
+      // Stop delivery and wait for a running call, unless called from it.
+      void close()
+      {
+         {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _closed = true;
+            _queue.clear();
+            _ready.notify_all();
+            _space.notify_all();
+            if (_pool != nullptr && _runner != std::this_thread::get_id())
+            {
+               _idle.wait(lock, [this] { return !_scheduled; });
+            }
+         }
+         if (_thread.joinable())
+         {
+            if (_thread.get_id() == std::this_thread::get_id())
+            {
+               _thread.detach();
+            }
+            else
+            {
+               _thread.join();
+            }
+         }
+      }
+
+   private:
+      void threadLoop()
+      {
+         std::unique_lock<std::mutex> lock(_mutex);
+         while (true)
+         {
+            _ready.wait(lock, [this] { return _closed || !_queue.empty(); });
+            if (_closed) return;
+            const T data = std::move(_queue.front());
+            _queue.pop_front();
+            lock.unlock();
+            _space.notify_one();
+            invokeListener(_listener, data, *_metrics);
+            lock.lock();
+         }
+      }
+
+      void drain()
+      {
+         std::unique_lock<std::mutex> lock(_mutex);
+         _runner = std::this_thread::get_id();
+         for (size_t n = 0; n < POOL_BATCH && !_closed && !_queue.empty(); ++n)
+         {
+            const T data = std::move(_queue.front());
+            _queue.pop_front();
+            lock.unlock();
+            _space.notify_one();
+            invokeListener(_listener, data, *_metrics);
+            lock.lock();
+         }
+         _runner = {};
+         if (!_closed && !_queue.empty())
+         {
+            // Yield the pool thread to other listeners, then carry on.
+            lock.unlock();
+            _pool->post([self = this->shared_from_this()] { self->drain(); }, {_priority});
+            return;
+         }
+         _scheduled = false;
+         _idle.notify_all();
+      }
+
+      const Listener _listener;
+      const std::shared_ptr<ListenerMetrics> _metrics;
+      const OverflowPolicy _policy;
+      const size_t _capacity;
+      TaskPool* const _pool;                // nullptr: dedicated thread.
+      const TaskPriority _priority;         // Pool: priority of drain() tasks.
+
+      std::mutex _mutex;
+      std::condition_variable _ready;       // Dedicated thread: item queued or closed.
+      std::condition_variable _space;       // Block policy: item taken or closed.
+      std::condition_variable _idle;        // Pool: no task scheduled any more.
+      std::deque<T> _queue;
+      bool _closed{false};
+      bool _scheduled{false};               // Pool: a drain() task is queued or running.
+      std::thread::id _runner;              // Pool: thread running drain().
+      std::thread _thread;
+   };
+
+   struct ListenerEntry
+   {
+      Listener listener;
+      std::shared_ptr<ListenerChannel> channel;   // nullptr: inline.
+      std::shared_ptr<ListenerMetrics> metrics;
+   };
+
+   using ListenerMap = std::map<int, ListenerEntry>;
+
+   static size_t boundedCapacity(OverflowPolicy policy, size_t capacity)
+   {
+      return (policy == OverflowPolicy::LatestOnly) ? 1 : std::max<size_t>(capacity, 1);
+   }
+
+   // Drop the oldest items until at most `limit` remain (dropping policies
+   // only); caller holds _cvMutex.
+   void trimTo(size_t limit)
+   {
+      if (_policy != OverflowPolicy::LatestOnly && _policy != OverflowPolicy::DropOldest &&
+          _policy != OverflowPolicy::DropNewest)
+      {
+         return;
+      }
+      while (_dataQueue.size() > limit)
+      {
+         popFront();
+         _droppedCount.fetch_add(1, std::memory_order_relaxed);
+         if (_policy == OverflowPolicy::LatestOnly)
+         {
+            _coalescedCount.fetch_add(1, std::memory_order_relaxed);
+         }
+      }
+   }
+
+   // Remove the oldest item and its weight; caller holds _cvMutex.
+   void popFront()
+   {
+      _queuedBytes -= _dataQueue.front().bytes;
+      _dataQueue.pop();
+      if (_memory)
+      {
+         _memory->setBytes(_queuedBytes);
+      }
+   }
+
+   // Weigh the item just queued, then coalesce down to the memory budget;
+   // caller holds _cvMutex.
+   void accountNewest()
+   {
+      QueuedItem& newest = _dataQueue.back();
+      newest.bytes = _itemBytes(newest.item);
+      _queuedBytes += newest.bytes;
+      if (!_memory->fits(_queuedBytes) && _dataQueue.size() > 1)
+      {
+         _memory->recordRelief();
+         while (!_memory->fits(_queuedBytes) && _dataQueue.size() > 1)
+         {
+            popFront();
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            _coalescedCount.fetch_add(1, std::memory_order_relaxed);
+         }
+      }
+      _memory->setBytes(_queuedBytes);
+   }
+
    void processData()
    {
       while (!_stopFlag)
       {
-         T data;
+         std::optional<T> data;
+         TimePoint enqueued;
          {
             std::unique_lock<std::mutex> lock(_cvMutex);
             _condVar.wait(lock, [this] { return !_dataQueue.empty() || _stopFlag; });
@@ -133,39 +827,86 @@ private:
             {
                return;
             }
-            data = _dataQueue.front();
-            _dataQueue.pop();
+            enqueued = _dataQueue.front().enqueued;
+            data.emplace(std::move(_dataQueue.front().item));
+            popFront();
          }
-         notifyListeners(data);
+         _spaceCondVar.notify_one();
+         notifyListeners(*data, enqueued);
       }
    }
 
-   void notifyListeners(const T& data)
+   void notifyListeners(const T& data, TimePoint enqueued)
    {
-      const std::lock_guard<std::mutex> lock(_listenersMutex);
-      for (const auto& listener : _listeners)
+      // Snapshots are taken under _dispatchMutex so unregisterListener()
+      // either waits for this dispatch or is already excluded from it.
+      std::unique_lock<std::mutex> dispatchLock(_dispatchMutex);
+      std::shared_ptr<const ListenerMap> listeners = listenerSnapshot();
+      const TimePoint start = std::chrono::steady_clock::now();
+      _queueLatency.record(start - enqueued);
+      _dispatchedCount.fetch_add(1, std::memory_order_relaxed);
+
+      const bool queued = std::any_of(listeners->begin(), listeners->end(),
+                                      [](const auto& entry) { return entry.second.channel != nullptr; });
+      if (queued)
       {
-         try
+         // Handed over holding no lock: a Block listener may wait here for
+         // its own thread, which may be (un)registering listeners.  A
+         // channel closed since the snapshot ignores the item.
+         dispatchLock.unlock();
+         for (const auto& entry : *listeners)
          {
-            listener.second(data);
-         }
-         catch (const std::exception& e)
-         {
-            std::cerr << "Listener threw an std::exception! " << e.what() << '\n';
+            if (entry.second.channel)
+            {
+               entry.second.channel->push(data);
+            }
          }
-         catch (...)
+         dispatchLock.lock();
+         listeners = listenerSnapshot();
+      }
+      for (const auto& entry : *listeners)
+      {
+         if (!entry.second.channel)
          {
-            std::cerr << "Listener threw an unknown exception!\n";
+            invokeListener(entry.second.listener, data, *entry.second.metrics);
          }
       }
+      if (_dispatchObserver)
+      {
+         _dispatchObserver(data, start, std::chrono::steady_clock::now());
+      }
+   }
+
+   std::shared_ptr<const ListenerMap> listenerSnapshot()
+   {
+      const std::lock_guard<std::mutex> lock(_listenersMutex);
+      return _listeners;
    }
 
-   std::mutex _listenersMutex;
-   std::map<int, Listener> _listeners;
+   std::mutex _listenersMutex;                // Guards the pointer, not the map.
+   std::shared_ptr<const ListenerMap> _listeners{std::make_shared<const ListenerMap>()};
+   std::mutex _dispatchMutex;                 // Held by the worker while it calls listeners.
+   DispatchObserver _dispatchObserver;        // Guarded by _dispatchMutex.
    int _nextListenerId = 123;
-   std::queue<T> _dataQueue;
-   std::mutex _cvMutex;
+   mutable std::mutex _metricsMutex;          // Guards _listenerMetrics; never held during dispatch.
+   std::map<int, std::shared_ptr<ListenerMetrics>> _listenerMetrics;
+   std::queue<QueuedItem> _dataQueue;
+   mutable std::mutex _cvMutex;
    std::condition_variable _condVar;
+   std::condition_variable _spaceCondVar;     // Block policy: signalled when an item is taken.
+   OverflowPolicy _policy{OverflowPolicy::Unbounded};
+   size_t _capacity{1};
+   size_t _highWater{0};
+   size_t _queuedBytes{0};                    // Sum of QueuedItem::bytes.
+   std::function<size_t(const T&)> _itemBytes;
+   std::unique_ptr<MemoryAccount> _memory;    // nullptr until setMemoryAccounting().
+   std::atomic<std::uint64_t> _droppedCount{0};
+   std::atomic<std::uint64_t> _coalescedCount{0};
+   std::string _name;
+   TimePoint _statsSince{std::chrono::steady_clock::now()};
+   LatencyHistogram _queueLatency;
+   std::atomic<std::uint64_t> _dispatchedCount{0};
+   std::atomic<bool> _registered{false};
    std::thread _workerThread;
    std::atomic<bool> _stopFlag;
 };
@@ -0,0 +1,60 @@
+#include "DataHandlerStats.h"
+
+// System headers
+#include <algorithm>
+#include <utility>
+
+namespace CommonUtils
+{
+
+DataHandlerRegistry& DataHandlerRegistry::instance()
+{
+   static DataHandlerRegistry registry;
+   return registry;
+}
+
+void DataHandlerRegistry::add(const void* handler, std::string name, StatsSource source)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = std::find_if(_entries.begin(), _entries.end(),
+                                [handler](const Entry& entry) { return entry.handler == handler; });
+   if (it != _entries.end())
+   {
+      it->name   = std::move(name);
+      it->source = std::move(source);
+      return;
+   }
+   _entries.push_back(Entry{handler, std::move(name), std::move(source)});
+}
+
+void DataHandlerRegistry::remove(const void* handler)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   std::erase_if(_entries, [handler](const Entry& entry) { return entry.handler == handler; });
+}
+
+std::optional<DataHandlerStats> DataHandlerRegistry::stats(const std::string& name) const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = std::find_if(_entries.begin(), _entries.end(),
+                                [&name](const Entry& entry) { return entry.name == name; });
+   if (it == _entries.end())
+   {
+      return std::nullopt;
+   }
+   return it->source();
+}
+
+std::vector<DataHandlerStats> DataHandlerRegistry::allStats() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   std::vector<DataHandlerStats> out;
+   out.reserve(_entries.size());
+   for (const auto& entry : _entries)
+   {
+      out.push_back(entry.source());
+   }
+   return out;
+}
+
+} // namespace CommonUtils
@@ -0,0 +1,112 @@
+#ifndef COMMONUTILS_DATAHANDLERSTATS_H_
+#define COMMONUTILS_DATAHANDLERSTATS_H_
+
+// Project headers
+#include "LatencyHistogram.h"
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @class ListenerStats
+ * @brief Callback cost of one DataHandler listener.
+ */
+struct ListenerStats
+{
+   int id{-1};                   ///< Registration ID.
+   uint64_t dropped{0};          ///< Items its own queue dropped (queued dispatch modes only).
+   LatencySummary callback;      ///< Time spent in the callback per item.
+};
+
+/**
+ * @class DataHandlerStats
+ * @brief Throughput, backlog and latency of one DataHandler since its last
+ *        resetStats().
+ */
+struct DataHandlerStats
+{
+   std::string name;                     ///< Set by DataHandler::setName() (empty if unnamed).
+   uint64_t dispatched{0};               ///< Items handed to the listeners.
+   uint64_t dropped{0};                  ///< Items discarded by the overflow policy (since construction).
+   uint64_t coalesced{0};                ///< Of those, items superseded (LatestOnly, memory budget).
+   size_t queued{0};                     ///< Items waiting right now.
+   size_t maxQueueDepth{0};              ///< Deepest backlog.
+   size_t queuedBytes{0};                ///< Weight of queued items (setMemoryAccounting() only).
+   double itemsPerSecond{0.0};           ///< Dispatch rate over the stats period.
+   LatencySummary queueLatency;          ///< signalData() → dispatch start.
+   std::vector<ListenerStats> listeners; ///< One entry per registered listener.
+};
+
+/**
+ * @class DataHandlerRegistry
+ * @brief Process-wide directory of named DataHandlers, so their statistics
+ *        can be looked up by name (e.g. to find the bottleneck consumer).
+ *
+ * DataHandler::setName() registers the handler and its destructor removes
+ * it; names need not be unique.
+ *
+ * Thread-safety: all methods are thread-safe.  Statistics sources run with
+ * the registry locked, so they must not call back into the registry.
+ */
+class DataHandlerRegistry
+{
+public:
+   using StatsSource = std::function<DataHandlerStats()>;
+
+   /**
+    * @brief Get the process-wide registry.
+    * @return Registry instance.
+    */
+   [[nodiscard]] static DataHandlerRegistry& instance();
+
+   /**
+    * @brief Add (or rename) `handler`.
+    * @param handler  Identity of the handler (its address).
+    * @param name     Name to look it up by.
+    * @param source   Returns the handler's current statistics.
+    */
+   void add(const void* handler, std::string name, StatsSource source);
+
+   /**
+    * @brief Remove `handler`; waits for a statistics query in progress.
+    * @param handler  Identity passed to add().
+    */
+   void remove(const void* handler);
+
+   /**
+    * @brief Get the statistics of the first handler called `name`.
+    * @param name  Handler name.
+    * @return Statistics, or std::nullopt if no handler has that name.
+    */
+   [[nodiscard]] std::optional<DataHandlerStats> stats(const std::string& name) const;
+
+   /**
+    * @brief Get the statistics of every registered handler.
+    * @return One entry per handler, in registration order.
+    */
+   [[nodiscard]] std::vector<DataHandlerStats> allStats() const;
+
+private:
+   struct Entry
+   {
+      const void* handler;
+      std::string name;
+      StatsSource source;
+   };
+
+   mutable std::mutex _mutex;
+   std::vector<Entry> _entries;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_DATAHANDLERSTATS_H_
@@ -0,0 +1,627 @@
+#include "FileSink.h"
+#include "GeneralLogger.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace CommonUtils
+{
+
+namespace
+{
+
+// user_data of the NOP that stops the completion thread.
+constexpr uint64_t STOP_TAG = ~uint64_t{0};
+
+// Logging is optional here: sinks may be used before (or without) a logger.
+template <typename... Args>
+void warn(spdlog::format_string_t<Args...> format, Args&&... args)
+{
+   if (GeneralLogger::s_generalLogger)
+   {
+      GPWARN(format, std::forward<Args>(args)...);
+   }
+}
+
+unsigned loadAcquire(const unsigned* value)
+{
+   return std::atomic_ref<const unsigned>(*value).load(std::memory_order_acquire);
+}
+
+void storeRelease(unsigned* value, unsigned next)
+{
+   std::atomic_ref<unsigned>(*value).store(next, std::memory_order_release);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// io_uring (raw system calls, no liburing)
+// ============================================================================
+
+struct FileSink::Uring
+{
+   Uring() = default;
+   ~Uring()
+   {
+      if (sqes != MAP_FAILED)
+      {
+         ::munmap(sqes, sqesBytes);
+      }
+      if (cqMap != MAP_FAILED && cqMap != sqMap)
+      {
+         ::munmap(cqMap, cqBytes);
+      }
+      if (sqMap != MAP_FAILED)
+      {
+         ::munmap(sqMap, sqBytes);
+      }
+      if (fd >= 0)
+      {
+         ::close(fd);
+      }
+   }
+   Uring(const Uring&) = delete;
+   Uring& operator=(const Uring&) = delete;
+   Uring(Uring&&) = delete;
+   Uring& operator=(Uring&&) = delete;
+
+   // Set up a ring of at least `entries` and register the pool buffers
+   // (nullptr if io_uring is unavailable).
+   static std::unique_ptr<Uring> create(unsigned entries, std::byte* memory,
+                                        std::size_t bufferBytes, std::size_t bufferCount)
+   {
+      io_uring_params params{};
+      auto ring = std::make_unique<Uring>();
+      ring->fd  = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+      if (ring->fd < 0)
+      {
+         return nullptr;
+      }
+
+      ring->sqBytes = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+      ring->cqBytes = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+      const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (single)
+      {
+         ring->sqBytes = ring->cqBytes = std::max(ring->sqBytes, ring->cqBytes);
+      }
+      constexpr int PROT  = PROT_READ | PROT_WRITE;
+      constexpr int FLAGS = MAP_SHARED | MAP_POPULATE;
+      ring->sqMap = ::mmap(nullptr, ring->sqBytes, PROT, FLAGS, ring->fd, IORING_OFF_SQ_RING);
+      ring->cqMap = single ? ring->sqMap
+                           : ::mmap(nullptr, ring->cqBytes, PROT, FLAGS, ring->fd,
+                                    IORING_OFF_CQ_RING);
+      ring->sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+      ring->sqes = ::mmap(nullptr, ring->sqesBytes, PROT, FLAGS, ring->fd, IORING_OFF_SQES);
+      if (ring->sqMap == MAP_FAILED || ring->cqMap == MAP_FAILED || ring->sqes == MAP_FAILED)
+      {
+         return nullptr;
+      }
+
+      auto* sq      = static_cast<std::byte*>(ring->sqMap);
+      auto* cq      = static_cast<std::byte*>(ring->cqMap);
+      ring->sqHead  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+      ring->sqTail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+      ring->sqMask  = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+      ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+      ring->sqSize  = params.sq_entries;
+      ring->cqHead  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+      ring->cqTail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+      ring->cqMask  = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+      ring->cqes    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+      // Registration pins the pool once instead of per write; it fails
+      // beyond RLIMIT_MEMLOCK, where plain writes still work.
+      std::vector<iovec> buffers(bufferCount);
+      for (std::size_t i = 0; i < bufferCount; ++i)
+      {
+         buffers[i].iov_base = memory + (i * bufferBytes);
+         buffers[i].iov_len  = bufferBytes;
+      }
+      ring->fixed = ::syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS,
+                              buffers.data(), static_cast<unsigned>(bufferCount)) == 0;
+      return ring;
+   }
+
+   // Next free submission entry, zeroed (nullptr if the queue is full).
+   io_uring_sqe* nextSqe()
+   {
+      const unsigned tail = *sqTail;
+      if (tail - loadAcquire(sqHead) >= sqSize)
+      {
+         return nullptr;
+      }
+      auto* sqe = static_cast<io_uring_sqe*>(sqes) + (tail & sqMask);
+      *sqe      = io_uring_sqe{};
+      sqArray[tail & sqMask] = tail & sqMask;
+      return sqe;
+   }
+
+   // Publish the entry from nextSqe() and submit it.
+   bool push()
+   {
+      storeRelease(sqTail, *sqTail + 1);
+      while (::syscall(__NR_io_uring_enter, fd, 1U, 0U, 0U, nullptr, 0) < 0)
+      {
+         if (errno != EINTR)
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   // Block until at least one completion is queued.
+   void waitCompletion() const
+   {
+      ::syscall(__NR_io_uring_enter, fd, 0U, 1U, IORING_ENTER_GETEVENTS, nullptr, 0);
+   }
+
+   int fd{-1};
+   bool fixed{false};
+   void* sqMap{MAP_FAILED};
+   void* cqMap{MAP_FAILED};
+   void* sqes{MAP_FAILED};
+   std::size_t sqBytes{0};
+   std::size_t cqBytes{0};
+   std::size_t sqesBytes{0};
+   unsigned* sqHead{nullptr};
+   unsigned* sqTail{nullptr};
+   unsigned* sqArray{nullptr};
+   unsigned sqMask{0};
+   unsigned sqSize{0};
+   unsigned* cqHead{nullptr};
+   unsigned* cqTail{nullptr};
+   unsigned cqMask{0};
+   io_uring_cqe* cqes{nullptr};
+};
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+void FileSink::AlignedFree::operator()(std::byte* p) const
+{
+   std::free(p);
+}
+
+FileSink::FileSink(std::size_t bufferBytes, std::size_t bufferCount)
+   : _bufferBytes{std::max(ALIGNMENT, ((bufferBytes + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT)}
+   , _bufferCount{std::max<std::size_t>(bufferCount, 1)}
+   , _memory{static_cast<std::byte*>(std::aligned_alloc(ALIGNMENT, _bufferBytes * _bufferCount))}
+   , _writes(_bufferCount)
+{
+}
+
+FileSink::~FileSink()
+{
+   close();
+}
+
+// ============================================================================
+// File
+// ============================================================================
+
+bool FileSink::open(const std::string& path, bool directIo)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (_fd >= 0)
+   {
+      warn("FileSink::open() — {} is still open", _path);
+      return false;
+   }
+
+   constexpr int FLAGS = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+   _directIo = directIo;
+   _fd = _directIo ? ::open(path.c_str(), FLAGS | O_DIRECT, 0644) : -1;
+   if (_directIo && _fd < 0)
+   {
+      warn("FileSink: O_DIRECT unavailable for {} ({}), using buffered writes", path,
+           std::strerror(errno));
+      _directIo = false;
+   }
+   if (_fd < 0)
+   {
+      _fd = ::open(path.c_str(), FLAGS, 0644);
+   }
+   if (_fd < 0)
+   {
+      return false;
+   }
+
+   _path = path;
+   _free.clear();
+   for (std::size_t i = _bufferCount; i > 0; --i)
+   {
+      _free.push_back(i - 1);   // acquire() takes from the back: 0 first.
+   }
+   _pending.clear();
+   _inFlight     = 0;
+   _peakInFlight = 0;
+   _offset       = 0;
+   _appendBuffer = nullptr;
+   _appendBytes  = 0;
+   _stopping     = false;
+   _bytesWritten.store(0, std::memory_order_relaxed);
+   _completedWrites.store(0, std::memory_order_relaxed);
+   _writeErrors.store(0, std::memory_order_relaxed);
+
+   // One entry per buffer plus the stop NOP.
+   _uring = Uring::create(static_cast<unsigned>(_bufferCount + 1), _memory.get(), _bufferBytes,
+                          _bufferCount);
+   _thread = _uring ? std::thread(&FileSink::completionThread, this)
+                    : std::thread(&FileSink::writerThread, this);
+   return true;
+}
+
+bool FileSink::close()
+{
+   std::unique_lock<std::mutex> lock(_mutex);
+   if (_fd < 0)
+   {
+      return true;
+   }
+   const bool flushed = flushAppendLocked(lock);
+   drainLocked(lock);
+
+   _stopping = true;
+   if (_uring)
+   {
+      io_uring_sqe* sqe = _uring->nextSqe();
+      sqe->opcode       = IORING_OP_NOP;
+      sqe->user_data    = STOP_TAG;
+      _uring->push();
+   }
+   _queued.notify_all();
+   lock.unlock();
+   _thread.join();
+   lock.lock();
+
+   ::close(_fd);
+   _fd = -1;
+   _uring.reset();
+   lock.unlock();
+   _freed.notify_all();   // acquire(true) callers give up.
+   if (!flushed)
+   {
+      notifyFailed();
+   }
+   return _writeErrors.load(std::memory_order_relaxed) == 0;
+}
+
+bool FileSink::isOpen() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _fd >= 0;
+}
+
+bool FileSink::directIo() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _directIo;
+}
+
+bool FileSink::usesUring() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _uring != nullptr;
+}
+
+void FileSink::setWriteHandler(WriteHandler handler)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _handler = std::move(handler);
+}
+
+// ============================================================================
+// Buffers
+// ============================================================================
+
+std::size_t FileSink::freeCount() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _free.size();
+}
+
+std::byte* FileSink::acquire(bool wait)
+{
+   std::unique_lock<std::mutex> lock(_mutex);
+   if (wait)
+   {
+      _freed.wait(lock, [this] { return !_free.empty() || _fd < 0; });
+   }
+   if (_fd < 0 || _free.empty())
+   {
+      return nullptr;
+   }
+   const std::size_t index = _free.back();
+   _free.pop_back();
+   return _memory.get() + (index * _bufferBytes);
+}
+
+void FileSink::release(std::byte* buffer)
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _free.push_back(indexOf(buffer));
+   }
+   _freed.notify_all();
+}
+
+std::size_t FileSink::indexOf(const std::byte* buffer) const
+{
+   return static_cast<std::size_t>(buffer - _memory.get()) / _bufferBytes;
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+void FileSink::submit(std::byte* buffer, std::size_t bytes)
+{
+   std::unique_lock<std::mutex> lock(_mutex);
+   const std::size_t index = indexOf(buffer);
+   if (_fd < 0 || bytes == 0)
+   {
+      _free.push_back(index);
+      lock.unlock();
+      _freed.notify_all();
+      return;
+   }
+
+   bool ok = flushAppendLocked(lock);
+   ok      = startLocked(lock, index, std::min(bytes, _bufferBytes)) && ok;
+   lock.unlock();
+   if (!ok)
+   {
+      _freed.notify_all();
+      notifyFailed();
+   }
+}
+
+bool FileSink::append(const void* data, std::size_t bytes)
+{
+   const auto* source = static_cast<const std::byte*>(data);
+   std::unique_lock<std::mutex> lock(_mutex);
+   bool ok = true;
+   while (bytes > 0)
+   {
+      if (_appendBuffer == nullptr)
+      {
+         _freed.wait(lock, [this] { return !_free.empty() || _fd < 0; });
+         if (_fd < 0)
+         {
+            return false;
+         }
+         _appendBuffer = _memory.get() + (_free.back() * _bufferBytes);
+         _appendBytes  = 0;
+         _free.pop_back();
+      }
+      const std::size_t count = std::min(bytes, _bufferBytes - _appendBytes);
+      std::memcpy(_appendBuffer + _appendBytes, source, count);
+      _appendBytes += count;
+      source += count;
+      bytes -= count;
+      if (_appendBytes == _bufferBytes)
+      {
+         ok = flushAppendLocked(lock) && ok;
+      }
+   }
+   lock.unlock();
+   if (!ok)
+   {
+      _freed.notify_all();
+      notifyFailed();
+   }
+   return true;
+}
+
+FileSinkStats FileSink::stats() const
+{
+   FileSinkStats out;
+   out.bytesWritten = _bytesWritten.load(std::memory_order_relaxed);
+   out.writes       = _completedWrites.load(std::memory_order_relaxed);
+   out.writeErrors  = _writeErrors.load(std::memory_order_relaxed);
+   const std::lock_guard<std::mutex> lock(_mutex);
+   out.peakInFlight = _peakInFlight;
+   return out;
+}
+
+bool FileSink::flushAppendLocked(std::unique_lock<std::mutex>& lock)
+{
+   if (_appendBuffer == nullptr)
+   {
+      return true;
+   }
+   const std::size_t index = indexOf(_appendBuffer);
+   const std::size_t bytes = _appendBytes;
+   _appendBuffer           = nullptr;
+   _appendBytes            = 0;
+   if (bytes == 0)
+   {
+      _free.push_back(index);
+      return true;
+   }
+   return startLocked(lock, index, bytes);
+}
+
+bool FileSink::startLocked(std::unique_lock<std::mutex>& lock, std::size_t index,
+                           std::size_t bytes)
+{
+   // Only the final write of a file can be partial.  O_DIRECT needs whole
+   // pages, so finish the file with a buffered write.
+   if (_directIo && (bytes % ALIGNMENT) != 0)
+   {
+      drainLocked(lock);
+      ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) & ~O_DIRECT);
+      _directIo = false;
+   }
+
+   Write& write = _writes[index];
+   write        = Write{index, _offset, bytes, 0};
+   _offset += bytes;
+   ++_inFlight;
+   _peakInFlight = std::max(_peakInFlight, _inFlight);
+   if (!issueLocked(write))
+   {
+      finishLocked(index, false);
+      return false;
+   }
+   return true;
+}
+
+bool FileSink::issueLocked(const Write& write)
+{
+   if (!_uring)
+   {
+      _pending.push_back(write.index);
+      _queued.notify_one();
+      return true;
+   }
+
+   io_uring_sqe* sqe = _uring->nextSqe();
+   if (sqe == nullptr)
+   {
+      return false;   // Cannot happen: one entry per buffer.
+   }
+   sqe->opcode    = _uring->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+   sqe->fd        = _fd;
+   sqe->addr      = reinterpret_cast<uint64_t>(_memory.get() + (write.index * _bufferBytes) +
+                                               write.done);
+   sqe->len       = static_cast<uint32_t>(write.bytes - write.done);
+   sqe->off       = write.offset + write.done;
+   sqe->buf_index = static_cast<uint16_t>(write.index);
+   sqe->user_data = write.index;
+   return _uring->push();
+}
+
+void FileSink::finishLocked(std::size_t index, bool ok)
+{
+   if (ok)
+   {
+      _completedWrites.fetch_add(1, std::memory_order_relaxed);
+   }
+   else if (_writeErrors.fetch_add(1, std::memory_order_relaxed) == 0)
+   {
+      warn("FileSink: write to {} failed: {}", _path, std::strerror(errno));
+   }
+   _free.push_back(index);
+   --_inFlight;
+}
+
+void FileSink::notifyFailed()
+{
+   if (_handler)
+   {
+      _handler(0, false);
+   }
+}
+
+void FileSink::complete(std::size_t index, long result)
+{
+   std::size_t written = 0;
+   bool ok             = false;
+   {
+      std::unique_lock<std::mutex> lock(_mutex);
+      Write& write = _writes[index];
+      if (result > 0)
+      {
+         write.done += static_cast<std::size_t>(result);
+         _bytesWritten.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+      }
+      if ((result > 0 && write.done < write.bytes) || result == -EINTR || result == -EAGAIN)
+      {
+         // Short or interrupted: queue the rest.
+         if (issueLocked(write))
+         {
+            return;
+         }
+      }
+      else
+      {
+         errno = (result < 0) ? static_cast<int>(-result) : EIO;
+         ok    = result > 0;
+      }
+      written = write.done;
+      finishLocked(index, ok);
+   }
+   _freed.notify_all();
+   if (_handler)
+   {
+      _handler(ok ? written : 0, ok);
+   }
+}
+
+void FileSink::drainLocked(std::unique_lock<std::mutex>& lock)
+{
+   _freed.wait(lock, [this] { return _inFlight == 0; });
+}
+
+void FileSink::completionThread()
+{
+   configureCurrentThread("FileSink");
+   Uring& ring = *_uring;
+   while (true)
+   {
+      ring.waitCompletion();
+
+      bool stop     = false;
+      unsigned head = *ring.cqHead;
+      const unsigned tail = loadAcquire(ring.cqTail);
+      for (; head != tail; ++head)
+      {
+         const io_uring_cqe& cqe = ring.cqes[head & ring.cqMask];
+         if (cqe.user_data == STOP_TAG)
+         {
+            stop = true;
+            continue;
+         }
+         complete(static_cast<std::size_t>(cqe.user_data), cqe.res);
+      }
+      storeRelease(ring.cqHead, head);
+      if (stop)
+      {
+         return;
+      }
+   }
+}
+
+void FileSink::writerThread()
+{
+   configureCurrentThread("FileSink");
+   std::unique_lock<std::mutex> lock(_mutex);
+   while (true)
+   {
+      _queued.wait(lock, [this] { return _stopping || !_pending.empty(); });
+      if (_pending.empty())
+      {
+         return;   // Stopped and drained.
+      }
+      const std::size_t index = _pending.front();
+      _pending.pop_front();
+      const Write write = _writes[index];
+      lock.unlock();
+
+      const ssize_t written =
+         ::pwrite(_fd, _memory.get() + (index * _bufferBytes) + write.done,
+                  write.bytes - write.done, static_cast<off_t>(write.offset + write.done));
+      complete(index, (written < 0) ? -errno : written);
+      lock.lock();
+   }
+}
+
+} // namespace CommonUtils
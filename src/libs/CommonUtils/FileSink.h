@@ -0,0 +1,266 @@
+#ifndef COMMONUTILS_FILESINK_H_
+#define COMMONUTILS_FILESINK_H_
+
+// System headers
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @class FileSinkStats
+ * @brief Snapshot of a FileSink's writes since open().
+ */
+struct FileSinkStats
+{
+   uint64_t bytesWritten{0};    ///< Bytes the kernel reported written.
+   uint64_t writes{0};          ///< Buffers fully written.
+   uint64_t writeErrors{0};     ///< Buffers that failed (their data is lost).
+   std::size_t peakInFlight{0}; ///< Most buffers queued or being written at once.
+};
+
+/**
+ * @class FileSink
+ * @brief Sequential file writer keeping several large writes in flight,
+ *        through io_uring with registered buffers.
+ *
+ * The sink owns a pool of page-aligned buffers.  A producer takes one with
+ * acquire(), fills it and hands it back with submit(): the write is queued
+ * at the end of the file and submit() returns at once; when the kernel
+ * completes it, the buffer goes back to the pool.  Up to bufferCount()
+ * writes are in flight, so the disk is kept busy while the producer fills
+ * the next buffer.  Nothing is copied on the way: with O_DIRECT the device
+ * reads the buffer the producer wrote into.
+ *
+ * append() is the copying front end for variable-size output (e.g. VITA 49
+ * packets): it packs the bytes into pool buffers and submits them as they
+ * fill.  Do not mix the two on one file except through submit(), which
+ * first flushes what append() has packed.
+ *
+ * The buffers are registered with the ring (IORING_OP_WRITE_FIXED), so the
+ * kernel does not map them per write.  Where io_uring is unavailable
+ * (old kernel, seccomp) or registration fails (RLIMIT_MEMLOCK), the sink
+ * falls back to plain io_uring writes or to a thread running pwrite(), with
+ * the same behaviour.
+ *
+ * With O_DIRECT every write but the last must be a whole number of pages;
+ * a shorter one waits for the writes in flight, then drops O_DIRECT to
+ * finish the file.
+ *
+ * Thread-safety: all methods may be called from any thread.  The write
+ * handler runs on the sink's completion thread.
+ */
+class FileSink
+{
+public:
+   /** @brief Buffer alignment and size granule (O_DIRECT needs both). */
+   static constexpr std::size_t ALIGNMENT = 4096;
+
+   /**
+    * @brief Called after each completed write, once its buffer is back in the pool.
+    * @param bytes  Bytes written from the buffer (0 on failure).
+    * @param ok     false if the write failed.
+    */
+   using WriteHandler = std::function<void(std::size_t bytes, bool ok)>;
+
+   /**
+    * @brief Allocate the buffer pool.
+    * @param bufferBytes  Size of each buffer; rounded up to a whole ALIGNMENT.
+    * @param bufferCount  Number of buffers (at least 1).
+    */
+   FileSink(std::size_t bufferBytes, std::size_t bufferCount);
+
+   /** @brief close() the file. */
+   ~FileSink();
+
+   // Non-copyable, non-movable (the completion thread holds `this`).
+   FileSink(const FileSink&) = delete;
+   FileSink& operator=(const FileSink&) = delete;
+   FileSink(FileSink&&) = delete;
+   FileSink& operator=(FileSink&&) = delete;
+
+   // -- File ------------------------------------------------------------------
+
+   /**
+    * @brief Create (truncate) the output file.
+    * @param path      File to write.
+    * @param directIo  Bypass the page cache with O_DIRECT; falls back to
+    *                  buffered writes where unsupported.
+    * @return true on success, false if already open or the file cannot be created.
+    */
+   [[nodiscard]] bool open(const std::string& path, bool directIo = false);
+
+   /**
+    * @brief Flush append(), wait for every write in flight and close the file.
+    * @return true if every write since open() succeeded.
+    */
+   bool close();
+
+   /**
+    * @brief Check if a file is open.
+    * @return true between open() and close().
+    */
+   [[nodiscard]] bool isOpen() const;
+
+   /**
+    * @brief Check if the file is written with O_DIRECT.
+    * @return false after fallback or once a partial tail dropped it.
+    */
+   [[nodiscard]] bool directIo() const;
+
+   /**
+    * @brief Check if writes go through io_uring.
+    * @return false when the pwrite() thread is used.
+    */
+   [[nodiscard]] bool usesUring() const;
+
+   /**
+    * @brief Set the handler told about each completed write.  Only while closed.
+    * @param handler  Handler, or nullptr.
+    */
+   void setWriteHandler(WriteHandler handler);
+
+   // -- Buffers ---------------------------------------------------------------
+
+   /** @brief Get the size of each pool buffer. */
+   [[nodiscard]] std::size_t bufferBytes() const { return _bufferBytes; }
+
+   /** @brief Get the number of pool buffers. */
+   [[nodiscard]] std::size_t bufferCount() const { return _bufferCount; }
+
+   /**
+    * @brief Get the number of buffers in the pool right now.
+    * @return Buffers acquire() can return without waiting.
+    */
+   [[nodiscard]] std::size_t freeCount() const;
+
+   /**
+    * @brief Take a buffer from the pool.
+    * @param wait  Wait for a write to complete if the pool is empty.
+    * @return Buffer of bufferBytes(), or nullptr if none is free (and
+    *         `wait` is false) or the sink is not open.
+    */
+   [[nodiscard]] std::byte* acquire(bool wait = false);
+
+   /**
+    * @brief Return an acquired buffer unwritten.
+    * @param buffer  Buffer from acquire().
+    */
+   void release(std::byte* buffer);
+
+   /**
+    * @brief Get the position of a buffer in the pool.
+    * @param buffer  Buffer from acquire().
+    * @return Index in [0, bufferCount()).
+    */
+   [[nodiscard]] std::size_t indexOf(const std::byte* buffer) const;
+
+   // -- Writing ---------------------------------------------------------------
+
+   /**
+    * @brief Queue an acquired buffer for writing at the end of the file.
+    * The buffer returns to the pool once written.
+    * @param buffer  Buffer from acquire().
+    * @param bytes   Bytes to write from its start (0 just releases it).
+    */
+   void submit(std::byte* buffer, std::size_t bytes);
+
+   /**
+    * @brief Copy bytes to the end of the file through the pool, waiting
+    *        for a buffer when all are in flight.
+    * @param data   Bytes to write.
+    * @param bytes  Number of bytes.
+    * @return false if the sink is not open.
+    */
+   bool append(const void* data, std::size_t bytes);
+
+   /**
+    * @brief Get the write counters since open().
+    * @return Counters.
+    */
+   [[nodiscard]] FileSinkStats stats() const;
+
+private:
+   struct Uring;
+
+   // A buffer being written.
+   struct Write
+   {
+      std::size_t index{0};
+      uint64_t offset{0};
+      std::size_t bytes{0};
+      std::size_t done{0};
+   };
+
+   // Queue buffer `index` for writing at the end of the file, _mutex held.
+   // false if the backend refused it (the buffer is then back in the pool).
+   bool startLocked(std::unique_lock<std::mutex>& lock, std::size_t index, std::size_t bytes);
+
+   // Hand the unwritten rest of a write to the backend, _mutex held.
+   bool issueLocked(const Write& write);
+
+   // Put buffer `index` back in the pool, _mutex held.
+   void finishLocked(std::size_t index, bool ok);
+
+   // Account a finished write (or part of one); resubmits short writes.
+   void complete(std::size_t index, long result);
+
+   // Submit the partly packed append() buffer, _mutex held.
+   bool flushAppendLocked(std::unique_lock<std::mutex>& lock);
+
+   // Call the write handler for a failed write, _mutex not held.
+   void notifyFailed();
+
+   // Wait until no write is in flight, _mutex held.
+   void drainLocked(std::unique_lock<std::mutex>& lock);
+
+   void completionThread();   // io_uring: reap completions.
+   void writerThread();       // Fallback: pwrite() queued buffers in order.
+
+   const std::size_t _bufferBytes;
+   const std::size_t _bufferCount;
+
+   struct AlignedFree
+   {
+      void operator()(std::byte* p) const;
+   };
+   std::unique_ptr<std::byte[], AlignedFree> _memory;
+
+   mutable std::mutex _mutex;
+   std::condition_variable _freed;       // A buffer went back to the pool / a write ended.
+   std::condition_variable _queued;      // Fallback: a write was queued.
+   std::vector<std::size_t> _free;       // Pool (indices).
+   std::vector<Write> _writes;           // Per buffer, while in flight.
+   std::deque<std::size_t> _pending;     // Fallback: queued, in file order.
+   std::size_t _inFlight{0};
+   bool _stopping{false};
+   std::string _path;
+   int _fd{-1};
+   bool _directIo{false};
+   uint64_t _offset{0};                  // End of the file once queued writes land.
+   std::byte* _appendBuffer{nullptr};    // Partly packed by append().
+   std::size_t _appendBytes{0};
+   WriteHandler _handler;
+
+   std::unique_ptr<Uring> _uring;        // nullptr: fallback thread.
+   std::thread _thread;
+
+   std::atomic<uint64_t> _bytesWritten{0};
+   std::atomic<uint64_t> _completedWrites{0};
+   std::atomic<uint64_t> _writeErrors{0};
+   std::size_t _peakInFlight{0};         // Guarded by _mutex.
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_FILESINK_H_
@@ -1,7 +1,9 @@
 #include "GeneralLogger.h"
+#include "LockFreeDataHandler.h"
 
 #include <chrono>
 #include <cstddef>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,11 +18,56 @@
 namespace CommonUtils
 {
 
+namespace
+{
+
+/**
+ * Worker that formats and logs the *_LIMITED macros' messages, so real-time
+ * threads only push a closure onto a lock-free queue.
+ */
+class DeferredLogWorker
+{
+public:
+    DeferredLogWorker()
+    {
+        _queue.registerListener([](const std::function<void()>& task) { task(); });
+    }
+
+    static DeferredLogWorker& instance()
+    {
+        static DeferredLogWorker worker;
+        return worker;
+    }
+
+    void post(std::function<void()> task) { _queue.signalData(std::move(task)); }
+
+private:
+    LockFreeDataHandler<std::function<void()>> _queue;
+};
+
+constexpr auto DEFERRED_FLUSH_TIMEOUT = std::chrono::seconds(2);
+
+} // anonymous namespace
+
 std::shared_ptr<spdlog::async_logger> GeneralLogger::s_generalLogger;
 std::shared_ptr<spdlog::async_logger> GeneralLogger::s_traceLogger;
 
+void GeneralLogger::postDeferred(std::function<void()> task)
+{
+    DeferredLogWorker::instance().post(std::move(task));
+}
+
+void GeneralLogger::flushDeferred()
+{
+    auto done = std::make_shared<std::promise<void>>();
+    auto flushed = done->get_future();
+    postDeferred([done] { done->set_value(); });
+    flushed.wait_for(DEFERRED_FLUSH_TIMEOUT);
+}
+
 GeneralLogger::~GeneralLogger()
 {
+    flushDeferred();
     s_generalLogger->info("General Logger Destructor");
     s_traceLogger->dump_backtrace();
     s_traceLogger->flush();
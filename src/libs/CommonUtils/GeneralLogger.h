@@ -6,9 +6,23 @@
  * @brief Provides a general-purpose async logging facility using spdlog.
  */
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
+// Calls below SPDLOG_ACTIVE_LEVEL are compiled out.  The build sets it from
+// the LOG_ACTIVE_LEVEL CMake cache variable; default: keep everything.
+#ifndef SPDLOG_ACTIVE_LEVEL
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
 #include "spdlog/spdlog.h"
 #include "spdlog/async.h"
 
@@ -40,6 +54,64 @@
 /** @brief Log a trace message to the backtrace ring-buffer (exception-safe). */
 #define GPTRACE(...) try { SPDLOG_LOGGER_TRACE(CommonUtils::GeneralLogger::s_traceLogger, __VA_ARGS__); } catch (...) { }
 
+/**
+ * @brief Rate-limited, deferred-format log call for real-time threads.
+ *
+ * Each call site logs at most `perSecond` messages per second and counts
+ * the rest; the next message that gets through reports how many were
+ * suppressed.  The calling thread only copies the arguments onto a
+ * lock-free queue — formatting and the spdlog call happen on a worker.
+ * Arguments are copied by value; C strings and string views are copied into
+ * a std::string.
+ */
+#define GP_LOG_LIMITED(level, perSecond, ...)                                                           \
+    try                                                                                                  \
+    {                                                                                                    \
+        static CommonUtils::LogRateLimiter gpRateLimiter(perSecond);                                     \
+        std::uint64_t gpSuppressed = 0;                                                                  \
+        if (gpRateLimiter.allow(gpSuppressed))                                                           \
+        {                                                                                                \
+            CommonUtils::GeneralLogger::logDeferred(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, \
+                                                    level, gpSuppressed, __VA_ARGS__);                   \
+        }                                                                                                \
+    }                                                                                                    \
+    catch (...) { }
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+/** @brief Rate-limited critical message; see GP_LOG_LIMITED. */
+#define GPCRIT_LIMITED(perSecond, ...) GP_LOG_LIMITED(spdlog::level::critical, perSecond, __VA_ARGS__)
+#else
+#define GPCRIT_LIMITED(perSecond, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+/** @brief Rate-limited error message; see GP_LOG_LIMITED. */
+#define GPERROR_LIMITED(perSecond, ...) GP_LOG_LIMITED(spdlog::level::err, perSecond, __VA_ARGS__)
+#else
+#define GPERROR_LIMITED(perSecond, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+/** @brief Rate-limited warning message; see GP_LOG_LIMITED. */
+#define GPWARN_LIMITED(perSecond, ...) GP_LOG_LIMITED(spdlog::level::warn, perSecond, __VA_ARGS__)
+#else
+#define GPWARN_LIMITED(perSecond, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+/** @brief Rate-limited informational message; see GP_LOG_LIMITED. */
+#define GPINFO_LIMITED(perSecond, ...) GP_LOG_LIMITED(spdlog::level::info, perSecond, __VA_ARGS__)
+#else
+#define GPINFO_LIMITED(perSecond, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+/** @brief Rate-limited debug message; see GP_LOG_LIMITED. */
+#define GPDEBUG_LIMITED(perSecond, ...) GP_LOG_LIMITED(spdlog::level::debug, perSecond, __VA_ARGS__)
+#else
+#define GPDEBUG_LIMITED(perSecond, ...) (void)0
+#endif
+
 /** @} */ // end of LoggingMacros
 
 namespace CommonUtils
@@ -49,6 +121,58 @@ namespace CommonUtils
 static constexpr std::string_view GENERALLOGGER_NAME = "generalLogger";
 /** @brief Name identifier for the trace logger. */
 static constexpr std::string_view TRACELOGGER_NAME = "traceLogger";
+/** @brief Default per-call-site budget for the *_LIMITED macros on real-time threads. */
+static constexpr std::uint32_t HOT_PATH_LOGS_PER_SECOND = 5;
+
+/**
+ * @class LogRateLimiter
+ * @brief Per-call-site budget of log messages per one-second window.
+ *
+ * Lock-free; concurrent callers may overshoot the budget by a message or
+ * two at a window boundary.
+ */
+class LogRateLimiter
+{
+public:
+    /**
+     * @brief Construct a limiter.
+     * @param perSecond Messages allowed per one-second window.
+     */
+    explicit LogRateLimiter(std::uint32_t perSecond) : _perSecond(perSecond) {}
+
+    /**
+     * @brief Take one message from this window's budget.
+     * @param suppressed Set to the messages refused since the last allowed
+     *                   one (only when allowed).
+     * @return true if the message may be logged.
+     */
+    bool allow(std::uint64_t& suppressed)
+    {
+        const std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        std::int64_t start = _windowStart.load(std::memory_order_relaxed);
+        if (now - start >= WINDOW_NS &&
+            _windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        {
+            _inWindow.store(0, std::memory_order_relaxed);
+        }
+        if (_inWindow.fetch_add(1, std::memory_order_relaxed) < _perSecond)
+        {
+            suppressed = _suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        _suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    static constexpr std::int64_t WINDOW_NS = 1'000'000'000;
+
+    const std::uint32_t _perSecond;
+    std::atomic<std::int64_t> _windowStart{std::numeric_limits<std::int64_t>::min() / 2};
+    std::atomic<std::uint32_t> _inWindow{0};
+    std::atomic<std::uint64_t> _suppressed{0};
+};
 
 /**
  * @class GeneralLogger
@@ -99,6 +223,52 @@ public:
      */
     void init(const std::string &logNameBase);
 
+    /**
+     * @brief Queue a message to be formatted and logged on the deferred-log
+     *        worker (used by the *_LIMITED macros).
+     *
+     * Never formats on the calling thread.  Dropped if the general logger is
+     * not initialised or filters out `level`.
+     *
+     * @param loc        Call site.
+     * @param level      Log level.
+     * @param suppressed Earlier messages from this site that were dropped.
+     * @param fmt        fmt format string (checked at compile time).
+     * @param args       Arguments, copied by value.
+     */
+    template <typename... Args>
+    static void logDeferred(spdlog::source_loc loc, spdlog::level::level_enum level, std::uint64_t suppressed,
+                            spdlog::format_string_t<Args...> fmt, Args&&... args)
+    {
+        const auto logger = s_generalLogger;
+        if (!logger || !logger->should_log(level))
+        {
+            return;
+        }
+        postDeferred([logger, loc, level, suppressed, format = spdlog::string_view_t(fmt),
+                      values = std::make_tuple(DeferredArg<Args>(std::forward<Args>(args))...)]
+        {
+            std::apply([&](const auto&... value)
+            {
+                std::string message = fmt::vformat(format, fmt::make_format_args(value...));
+                if (suppressed > 0)
+                {
+                    logger->log(loc, level, "{} ({} similar messages suppressed)", message, suppressed);
+                }
+                else
+                {
+                    logger->log(loc, level, "{}", message);
+                }
+            }, values);
+        });
+    }
+
+    /**
+     * @brief Block until every message queued by logDeferred() so far has
+     *        been handed to spdlog.
+     */
+    static void flushDeferred();
+
     /** @brief Shared pointer to the general async logger instance. */
     // NOLINTNEXTLINE(readability-identifier-naming)
     static std::shared_ptr<spdlog::async_logger> s_generalLogger;
@@ -108,6 +278,16 @@ public:
     static std::shared_ptr<spdlog::async_logger> s_traceLogger;
 
 private:
+    // Stored form of a deferred argument: by value, with C strings and string
+    // views copied so they cannot dangle.
+    template <typename T>
+    using DeferredArg = std::conditional_t<
+        std::is_convertible_v<std::decay_t<T>, std::string_view> && !std::is_same_v<std::decay_t<T>, std::string>,
+        std::string, std::decay_t<T>>;
+
+    /** @brief Run `task` on the deferred-log worker, in FIFO order. */
+    static void postDeferred(std::function<void()> task);
+
     /** @brief Log message format pattern. */
     static constexpr std::string_view LOG_PATTERN = "%Y%m%d_%H%M%S.%e [%t][%s::%! %# %l] %v";
     /** @brief Flag indicating whether the logger has been initialized. */
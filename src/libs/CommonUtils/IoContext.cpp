@@ -0,0 +1,431 @@
+#include "IoContext.h"
+#include "GeneralLogger.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace CommonUtils
+{
+
+namespace
+{
+
+constexpr int MAX_EVENTS = 64;
+
+// The context whose loop runs on the calling thread, if any.
+thread_local const IoContext* t_context = nullptr;
+
+template <typename... Args>
+void warn(spdlog::format_string_t<Args...> format, Args&&... args)
+{
+   if (GeneralLogger::s_generalLogger)
+   {
+      GPWARN(format, std::forward<Args>(args)...);
+   }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Awaitables
+// ============================================================================
+
+IoContext::FdAwaiter::FdAwaiter(IoContext& context, int fd, bool write,
+                                std::chrono::milliseconds timeout)
+   : _context{context}
+{
+   _waiter.fd      = fd;
+   _waiter.write   = write;
+   _waiter.timeout = timeout;
+}
+
+bool IoContext::FdAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+   _waiter.handle = handle;
+   return _context.suspend(_waiter);
+}
+
+IoContext::SleepAwaiter::SleepAwaiter(IoContext& context, Clock::duration delay)
+   : _context{context}
+{
+   _waiter.timeout = delay;
+}
+
+void IoContext::SleepAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+   _waiter.handle = handle;
+   _context.suspend(_waiter);
+}
+
+IoContext::FdAwaiter IoContext::readable(int fd, std::chrono::milliseconds timeout)
+{
+   return FdAwaiter(*this, fd, false, timeout);
+}
+
+IoContext::FdAwaiter IoContext::writable(int fd, std::chrono::milliseconds timeout)
+{
+   return FdAwaiter(*this, fd, true, timeout);
+}
+
+IoContext::SleepAwaiter IoContext::sleepFor(Clock::duration delay)
+{
+   return SleepAwaiter(*this, delay);
+}
+
+// ============================================================================
+// IoContext
+// ============================================================================
+
+IoContext::IoContext(std::string role) : _role{std::move(role)}
+{
+   _epoll = ::epoll_create1(EPOLL_CLOEXEC);
+   _event = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+   if (_epoll < 0 || _event < 0)
+   {
+      const int error = errno;
+      if (_epoll >= 0)
+      {
+         ::close(_epoll);
+      }
+      if (_event >= 0)
+      {
+         ::close(_event);
+      }
+      throw std::system_error(error, std::generic_category(), "IoContext");
+   }
+
+   epoll_event event{};
+   event.events  = EPOLLIN;
+   event.data.fd = _event;
+   ::epoll_ctl(_epoll, EPOLL_CTL_ADD, _event, &event);
+
+   _thread = std::thread(&IoContext::loop, this);
+}
+
+IoContext::~IoContext()
+{
+   stop();
+   _thread.join();
+
+   // Whatever is still suspended here will never resume: free the frames
+   // (a coroutine waiting on a descriptor with a timeout appears twice).
+   std::vector<std::coroutine_handle<>> frames;
+   for (const auto& [fd, state] : _fds)
+   {
+      for (const Waiter* waiter : {state.reader, state.writer})
+      {
+         if (waiter != nullptr)
+         {
+            frames.push_back(waiter->handle);
+         }
+      }
+   }
+   for (const auto& [deadline, waiter] : _timers)
+   {
+      frames.push_back(waiter->handle);
+   }
+   frames.insert(frames.end(), _spawned.begin(), _spawned.end());
+   std::sort(frames.begin(), frames.end(),
+             [](auto a, auto b) { return a.address() < b.address(); });
+   frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+
+   _fds.clear();
+   _timers.clear();
+   _spawned.clear();
+   _posted.clear();
+   for (auto frame : frames)
+   {
+      frame.destroy();
+   }
+
+   ::close(_event);
+   ::close(_epoll);
+}
+
+void IoContext::spawn(IoTask task)
+{
+   bool wasIdle = false;
+   {
+      const std::lock_guard<std::mutex> lock(_postMutex);
+      if (_stopped)
+      {
+         return;   // `task` destroys the coroutine.
+      }
+      wasIdle = _posted.empty() && _spawned.empty();
+      _spawned.push_back(task.release());
+   }
+   if (wasIdle)
+   {
+      notify();
+   }
+}
+
+void IoContext::post(std::function<void()> fn)
+{
+   bool wasIdle = false;
+   {
+      const std::lock_guard<std::mutex> lock(_postMutex);
+      if (_stopped)
+      {
+         return;
+      }
+      wasIdle = _posted.empty() && _spawned.empty();
+      _posted.push_back(std::move(fn));
+   }
+   if (wasIdle)
+   {
+      notify();
+   }
+}
+
+void IoContext::stop()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_postMutex);
+      _stopped = true;
+   }
+   _stopping.store(true);
+   notify();
+}
+
+bool IoContext::isLoopThread() const
+{
+   return t_context == this;
+}
+
+std::size_t IoContext::waitingCount() const
+{
+   return _waiting.load(std::memory_order_relaxed);
+}
+
+void IoContext::forget(int fd)
+{
+   const auto it = _fds.find(fd);
+   if (it == _fds.end())
+   {
+      return;
+   }
+   if (it->second.added)
+   {
+      ::epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, nullptr);
+   }
+   _fds.erase(it);
+}
+
+void IoContext::notify() const
+{
+   const std::uint64_t one = 1;
+   [[maybe_unused]] const auto written = ::write(_event, &one, sizeof(one));
+}
+
+bool IoContext::arm(int fd, FdState& state)
+{
+   epoll_event event{};
+   event.events  = EPOLLONESHOT;
+   event.data.fd = fd;
+   if (state.reader != nullptr)
+   {
+      event.events |= EPOLLIN;
+   }
+   if (state.writer != nullptr)
+   {
+      event.events |= EPOLLOUT;
+   }
+
+   // A descriptor closed without forget() and reused is unknown to epoll
+   // again: fall back to adding it.
+   if (state.added && ::epoll_ctl(_epoll, EPOLL_CTL_MOD, fd, &event) == 0)
+   {
+      return true;
+   }
+   if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event) == 0)
+   {
+      state.added = true;
+      return true;
+   }
+   warn("IoContext '{}': cannot watch fd {}: {}", _role, fd, std::strerror(errno));
+   return false;
+}
+
+bool IoContext::suspend(Waiter& waiter)
+{
+   if (waiter.fd >= 0)
+   {
+      FdState& state = _fds[waiter.fd];
+      Waiter*& slot  = waiter.write ? state.writer : state.reader;
+      slot           = &waiter;
+      if (!arm(waiter.fd, state))
+      {
+         slot          = nullptr;
+         waiter.result = IoWait::Ready;   // Let the caller's I/O call report it.
+         return false;
+      }
+   }
+   if (waiter.fd < 0 || waiter.timeout > Clock::duration::zero())
+   {
+      waiter.timer = _timers.emplace(Clock::now() + waiter.timeout, &waiter);
+      waiter.timed = true;
+   }
+   _waiting.fetch_add(1, std::memory_order_relaxed);
+   return true;
+}
+
+void IoContext::dispatch(int fd, std::uint32_t events)
+{
+   const auto it = _fds.find(fd);
+   if (it == _fds.end())
+   {
+      return;
+   }
+   FdState& state       = it->second;
+   const bool failed    = (events & (EPOLLERR | EPOLLHUP)) != 0;
+   Waiter* const reader = (failed || (events & EPOLLIN) != 0) ? state.reader : nullptr;
+   Waiter* const writer = (failed || (events & EPOLLOUT) != 0) ? state.writer : nullptr;
+   if (reader != nullptr)
+   {
+      state.reader = nullptr;
+   }
+   if (writer != nullptr)
+   {
+      state.writer = nullptr;
+   }
+   // One-shot disarmed the descriptor: re-arm for the other direction.
+   if (state.reader != nullptr || state.writer != nullptr)
+   {
+      arm(fd, state);
+   }
+
+   for (Waiter* waiter : {reader, writer})
+   {
+      if (waiter == nullptr)
+      {
+         continue;
+      }
+      if (waiter->timed)
+      {
+         _timers.erase(waiter->timer);
+         waiter->timed = false;
+      }
+      waiter->result = IoWait::Ready;
+      _waiting.fetch_sub(1, std::memory_order_relaxed);
+      waiter->handle.resume();
+   }
+}
+
+int IoContext::runTimers()
+{
+   // Collect first: resumed coroutines may add timers that are already due
+   // (sleepFor(0)), which must wait for the next pass.
+   const auto now = Clock::now();
+   _expired.clear();
+   while (!_timers.empty() && _timers.begin()->first <= now)
+   {
+      Waiter* waiter = _timers.begin()->second;
+      _timers.erase(_timers.begin());
+      waiter->timed = false;
+      if (waiter->fd >= 0)
+      {
+         // Leave epoll armed: a late event finds no waiter and is ignored.
+         if (const auto it = _fds.find(waiter->fd); it != _fds.end())
+         {
+            (waiter->write ? it->second.writer : it->second.reader) = nullptr;
+         }
+         waiter->result = IoWait::Timeout;
+      }
+      _expired.push_back(waiter);
+   }
+
+   for (Waiter* waiter : _expired)
+   {
+      _waiting.fetch_sub(1, std::memory_order_relaxed);
+      waiter->handle.resume();
+      if (_stopping.load())
+      {
+         return 0;
+      }
+   }
+
+   if (_timers.empty())
+   {
+      return -1;
+   }
+   const auto wait = _timers.begin()->first - Clock::now();
+   return static_cast<int>(std::max<std::chrono::milliseconds::rep>(
+      std::chrono::ceil<std::chrono::milliseconds>(wait).count(), 0));
+}
+
+void IoContext::runPosted()
+{
+   std::deque<std::function<void()>> posted;
+   std::deque<std::coroutine_handle<>> spawned;
+   {
+      const std::lock_guard<std::mutex> lock(_postMutex);
+      posted.swap(_posted);
+      spawned.swap(_spawned);
+   }
+   for (auto& fn : posted)
+   {
+      fn();
+   }
+   while (!spawned.empty() && !_stopping.load())
+   {
+      const auto handle = spawned.front();
+      spawned.pop_front();
+      handle.resume();
+   }
+   // Stopped part-way: the destructor frees the ones not started.
+   if (!spawned.empty())
+   {
+      const std::lock_guard<std::mutex> lock(_postMutex);
+      _spawned.insert(_spawned.begin(), spawned.begin(), spawned.end());
+   }
+}
+
+void IoContext::loop()
+{
+   t_context = this;
+   configureCurrentThread(_role);
+
+   std::array<epoll_event, MAX_EVENTS> events{};
+   while (!_stopping.load())
+   {
+      runPosted();
+      const int timeout = runTimers();
+      if (_stopping.load())
+      {
+         break;
+      }
+
+      const int count = ::epoll_wait(_epoll, events.data(), MAX_EVENTS, timeout);
+      if (count < 0)
+      {
+         if (errno != EINTR)
+         {
+            warn("IoContext '{}': epoll_wait failed: {}", _role, std::strerror(errno));
+         }
+         continue;
+      }
+      for (int i = 0; i < count && !_stopping.load(); ++i)
+      {
+         const auto& event = events[static_cast<std::size_t>(i)];
+         if (event.data.fd == _event)
+         {
+            std::uint64_t value = 0;
+            [[maybe_unused]] const auto read = ::read(_event, &value, sizeof(value));
+            continue;
+         }
+         dispatch(event.data.fd, event.events);
+      }
+   }
+}
+
+} // namespace CommonUtils
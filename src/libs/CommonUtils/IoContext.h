@@ -0,0 +1,302 @@
+#ifndef COMMONUTILS_IOCONTEXT_H_
+#define COMMONUTILS_IOCONTEXT_H_
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @class IoTask
+ * @brief Fire-and-forget coroutine run by an IoContext.
+ *
+ * A coroutine returning IoTask starts suspended; IoContext::spawn() hands
+ * it to a context, whose thread runs it until it finishes.  The frame
+ * frees itself on completion, or is destroyed with the context if it is
+ * still waiting then.  Exceptions escaping the coroutine terminate.
+ */
+class IoTask
+{
+public:
+   struct promise_type
+   {
+      IoTask get_return_object()
+      {
+         return IoTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { std::terminate(); }
+   };
+
+   IoTask(IoTask&& other) noexcept : _handle{std::exchange(other._handle, {})} {}
+   IoTask& operator=(IoTask&&) = delete;
+   IoTask(const IoTask&) = delete;
+   IoTask& operator=(const IoTask&) = delete;
+
+   /** @brief Destroy the coroutine if it was never spawned. */
+   ~IoTask()
+   {
+      if (_handle)
+      {
+         _handle.destroy();
+      }
+   }
+
+private:
+   friend class IoContext;
+
+   explicit IoTask(std::coroutine_handle<promise_type> handle) : _handle{handle} {}
+
+   // Give up ownership to a context.
+   std::coroutine_handle<> release() { return std::exchange(_handle, {}); }
+
+   std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * @brief Outcome of waiting on a file descriptor.
+ */
+enum class IoWait : std::uint8_t
+{
+   Ready,     ///< The descriptor is readable / writable (or has an error to report).
+   Timeout    ///< The timeout passed first.
+};
+
+/**
+ * @class IoContext
+ * @brief epoll event loop on one thread, running IoTask coroutines that
+ *        await socket readiness and timers.
+ *
+ * Instead of one blocking thread per socket, each with its own poll() /
+ * timeout loop, receivers are written as coroutines:
+ * @code
+ *   IoTask receive(IoContext& io, int fd)
+ *   {
+ *      while (running)
+ *      {
+ *         if (co_await io.readable(fd, 100ms) == IoWait::Ready)
+ *         {
+ *            ::recvmmsg(fd, ..., MSG_DONTWAIT, nullptr);
+ *         }
+ *      }
+ *      io.forget(fd);
+ *   }
+ *   io.spawn(receive(io, fd));
+ * @endcode
+ * and any number of them share the context's thread.  Processes with many
+ * streams run a few contexts (e.g. one per core set) and spread the
+ * streams over them.
+ *
+ * Waits are level-triggered readiness (epoll one-shot): a Ready result
+ * can be spurious, so sockets must be non-blocking and EAGAIN is simply
+ * awaited again.  One coroutine at a time may wait on a descriptor per
+ * direction, and forget() must be called (from the context's thread)
+ * before the descriptor is closed.
+ *
+ * Awaitables must only be co_awaited by coroutines running on the
+ * context's thread (started by spawn()).  Coroutines still waiting when
+ * the context is destroyed are destroyed with it, so their locals'
+ * destructors run on the destroying thread.
+ *
+ * Thread-safety: spawn(), post() and stop() may be called from any
+ * thread; everything else only from the context's thread.
+ */
+class IoContext
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   /**
+    * @brief Start the event loop thread.
+    * @param role  ThreadConfig role of the loop thread.
+    */
+   explicit IoContext(std::string role = "IoContext");
+
+   /** @brief stop(), join the thread and destroy any waiting coroutines. */
+   ~IoContext();
+
+   // Non-copyable, non-movable (the thread holds `this`).
+   IoContext(const IoContext&) = delete;
+   IoContext& operator=(const IoContext&) = delete;
+   IoContext(IoContext&&) = delete;
+   IoContext& operator=(IoContext&&) = delete;
+
+   /**
+    * @brief Run a coroutine on the context's thread.
+    * @param task  Coroutine, not yet started.
+    */
+   void spawn(IoTask task);
+
+   /**
+    * @brief Run a function on the context's thread.
+    * @param fn  Called once, in posting order with other posts.
+    */
+   void post(std::function<void()> fn);
+
+   /**
+    * @brief Leave the event loop; waiting coroutines no longer resume.
+    * Queued and further posts are dropped.
+    */
+   void stop();
+
+   /**
+    * @brief Check if the calling thread is the context's thread.
+    * @return true inside spawned coroutines and posted functions.
+    */
+   [[nodiscard]] bool isLoopThread() const;
+
+   /**
+    * @brief Get the number of coroutines currently waiting on a descriptor
+    *        or timer (for diagnostics).
+    * @return Waiting coroutines.
+    */
+   [[nodiscard]] std::size_t waitingCount() const;
+
+   // -- Awaitables (context thread only) ---------------------------------------
+
+   class FdAwaiter;
+   class SleepAwaiter;
+
+   /**
+    * @brief Wait until `fd` is readable.
+    * @param fd       Non-blocking descriptor.
+    * @param timeout  Longest wait; zero or negative waits indefinitely.
+    * @return Awaitable yielding IoWait.
+    */
+   [[nodiscard]] FdAwaiter readable(int fd, std::chrono::milliseconds timeout = {});
+
+   /**
+    * @brief Wait until `fd` is writable.
+    * @param fd       Non-blocking descriptor.
+    * @param timeout  Longest wait; zero or negative waits indefinitely.
+    * @return Awaitable yielding IoWait.
+    */
+   [[nodiscard]] FdAwaiter writable(int fd, std::chrono::milliseconds timeout = {});
+
+   /**
+    * @brief Resume after a delay (a zero delay yields to other work).
+    * @param delay  Time to wait.
+    * @return Awaitable.
+    */
+   [[nodiscard]] SleepAwaiter sleepFor(Clock::duration delay);
+
+   /**
+    * @brief Remove `fd` from the event loop; call before closing it.
+    * @param fd  Descriptor no coroutine is waiting on.
+    */
+   void forget(int fd);
+
+   // A coroutine suspended on a descriptor and / or a timer.
+   struct Waiter
+   {
+      std::coroutine_handle<> handle;
+      IoWait result{IoWait::Ready};
+      int fd{-1};                    // -1: timer only.
+      bool write{false};
+      Clock::duration timeout{};     // Not positive: no timer.
+      bool timed{false};             // `timer` is in _timers.
+      std::multimap<Clock::time_point, Waiter*>::iterator timer;
+   };
+
+   /** @brief Awaitable returned by readable() / writable(). */
+   class FdAwaiter
+   {
+   public:
+      bool await_ready() const noexcept { return false; }
+      bool await_suspend(std::coroutine_handle<> handle);
+      IoWait await_resume() const noexcept { return _waiter.result; }
+
+   private:
+      friend class IoContext;
+      FdAwaiter(IoContext& context, int fd, bool write, std::chrono::milliseconds timeout);
+
+      IoContext& _context;
+      Waiter _waiter;
+   };
+
+   /** @brief Awaitable returned by sleepFor(). */
+   class SleepAwaiter
+   {
+   public:
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> handle);
+      void await_resume() const noexcept {}
+
+   private:
+      friend class IoContext;
+      SleepAwaiter(IoContext& context, Clock::duration delay);
+
+      IoContext& _context;
+      Waiter _waiter;
+   };
+
+private:
+   // Waiters of one registered descriptor.
+   struct FdState
+   {
+      Waiter* reader{nullptr};
+      Waiter* writer{nullptr};
+      bool added{false};   // Known to epoll.
+   };
+
+   void loop();
+
+   // (Re-)arm epoll for the waiters of `fd`.
+   bool arm(int fd, FdState& state);
+
+   // Resume the waiters of one epoll event.
+   void dispatch(int fd, std::uint32_t events);
+
+   // Suspend `waiter` on its descriptor and / or a timer; false if the
+   // descriptor cannot be watched (the coroutine then resumes at once).
+   bool suspend(Waiter& waiter);
+
+   // Run every expired timer; return the epoll timeout until the next one.
+   int runTimers();
+
+   // Run the queued posts and spawns.
+   void runPosted();
+
+   // Wake the loop from another thread.
+   void notify() const;
+
+   const std::string _role;
+   int _epoll{-1};
+   int _event{-1};   // eventfd for posts and stop().
+
+   // Context thread only.
+   std::unordered_map<int, FdState> _fds;
+   std::multimap<Clock::time_point, Waiter*> _timers;
+   std::vector<Waiter*> _expired;
+   std::atomic<std::size_t> _waiting{0};
+
+   // Posts and spawns from any thread.
+   mutable std::mutex _postMutex;
+   std::deque<std::function<void()>> _posted;
+   std::deque<std::coroutine_handle<>> _spawned;
+   bool _stopped{false};   // Guarded by _postMutex.
+   std::atomic<bool> _stopping{false};
+
+   std::thread _thread;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_IOCONTEXT_H_
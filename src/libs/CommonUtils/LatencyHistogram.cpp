@@ -0,0 +1,131 @@
+// Project headers
+#include "LatencyHistogram.h"
+
+// System headers
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace CommonUtils
+{
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration elapsed)
+{
+   const auto signedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+   const auto ns       = static_cast<uint64_t>(std::max<int64_t>(signedNs, 0));
+
+   _buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+   _count.fetch_add(1, std::memory_order_relaxed);
+   _sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+   uint64_t previous = _maxNs.load(std::memory_order_relaxed);
+   while (ns > previous &&
+          !_maxNs.compare_exchange_weak(previous, ns, std::memory_order_relaxed))
+   {
+   }
+}
+
+void LatencyHistogram::reset()
+{
+   for (auto& bucket : _buckets)
+   {
+      bucket.store(0, std::memory_order_relaxed);
+   }
+   _count.store(0, std::memory_order_relaxed);
+   _sumNs.store(0, std::memory_order_relaxed);
+   _maxNs.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+uint64_t LatencyHistogram::count() const
+{
+   return _count.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::percentileNs(double fraction) const
+{
+   // Sum the buckets rather than trusting _count, which may run ahead of
+   // them while record() is in flight on another thread.
+   std::array<uint64_t, BUCKET_COUNT> counts{};
+   uint64_t total = 0;
+   for (std::size_t b = 0; b < BUCKET_COUNT; ++b)
+   {
+      counts[b] = _buckets[b].load(std::memory_order_relaxed);
+      total += counts[b];
+   }
+   if (total == 0)
+   {
+      return 0.0;
+   }
+
+   const double clamped = std::clamp(fraction, 0.0, 1.0);
+   const auto rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(total))));
+   uint64_t seen = 0;
+   for (std::size_t b = 0; b < BUCKET_COUNT; ++b)
+   {
+      seen += counts[b];
+      if (seen >= rank)
+      {
+         // The bucket midpoint can overshoot the largest sample.
+         return std::min(bucketMidpointNs(b),
+                         static_cast<double>(_maxNs.load(std::memory_order_relaxed)));
+      }
+   }
+   return static_cast<double>(_maxNs.load(std::memory_order_relaxed));
+}
+
+LatencySummary LatencyHistogram::summary() const
+{
+   LatencySummary out;
+   out.count = count();
+   if (out.count == 0)
+   {
+      return out;
+   }
+   out.meanUs = static_cast<double>(_sumNs.load(std::memory_order_relaxed)) /
+                static_cast<double>(out.count) / 1.0e3;
+   out.p50Us = percentileNs(0.50) / 1.0e3;
+   out.p90Us = percentileNs(0.90) / 1.0e3;
+   out.p99Us = percentileNs(0.99) / 1.0e3;
+   out.maxUs = static_cast<double>(_maxNs.load(std::memory_order_relaxed)) / 1.0e3;
+   return out;
+}
+
+// ============================================================================
+// Bucket layout
+// ============================================================================
+
+std::size_t LatencyHistogram::bucketOf(uint64_t ns)
+{
+   // Values below SUB_BUCKETS get one exact bucket each; above that, every
+   // octave [2^e, 2^(e+1)) is split by the SUB_BITS bits below its MSB.
+   if (ns < SUB_BUCKETS)
+   {
+      return static_cast<std::size_t>(ns);
+   }
+   const auto exponent = static_cast<std::size_t>(std::bit_width(ns)) - 1;
+   const auto sub = static_cast<std::size_t>(ns >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+   return ((exponent - SUB_BITS + 1) * SUB_BUCKETS) + sub;
+}
+
+double LatencyHistogram::bucketMidpointNs(std::size_t bucket)
+{
+   if (bucket < SUB_BUCKETS)
+   {
+      return static_cast<double>(bucket);
+   }
+   const std::size_t exponent = (bucket / SUB_BUCKETS) + SUB_BITS - 1;
+   const std::size_t sub      = bucket % SUB_BUCKETS;
+   const double width = std::ldexp(1.0, static_cast<int>(exponent - SUB_BITS));
+   return (static_cast<double>(SUB_BUCKETS + sub) * width) + (width / 2.0);
+}
+
+} // namespace CommonUtils
@@ -0,0 +1,90 @@
+#ifndef COMMONUTILS_LATENCYHISTOGRAM_H_
+#define COMMONUTILS_LATENCYHISTOGRAM_H_
+
+// System headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace CommonUtils
+{
+
+/**
+ * @class LatencySummary
+ * @brief Percentiles of one LatencyHistogram, in microseconds.
+ */
+struct LatencySummary
+{
+   uint64_t count{0};   ///< Samples recorded.
+   double meanUs{0.0};
+   double p50Us{0.0};
+   double p90Us{0.0};
+   double p99Us{0.0};
+   double maxUs{0.0};   ///< Largest sample, exact.
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Lock-free log-linear histogram of durations.
+ *
+ * Every power-of-two range of nanoseconds is split into SUB_BUCKETS linear
+ * buckets, so any recorded value is reported within 1 / SUB_BUCKETS of its
+ * true value over the whole 1 ns .. centuries range, in a fixed 4 KiB of
+ * counters.  record() is a handful of relaxed atomic increments and never
+ * allocates, so it can be called from real-time threads.
+ *
+ * Thread-safety: record() may be called from any number of threads;
+ * summary() may run concurrently and sees a consistent-enough view.
+ */
+class LatencyHistogram
+{
+public:
+   /** @brief Linear buckets per power of two. */
+   static constexpr std::size_t SUB_BUCKETS = 8;
+
+   /**
+    * @brief Record one duration.  Negative durations count as zero.
+    * @param elapsed  Duration to record.
+    */
+   void record(std::chrono::steady_clock::duration elapsed);
+
+   /** @brief Zero all counters.  Not synchronised with concurrent record(). */
+   void reset();
+
+   /**
+    * @brief Get the number of recorded durations.
+    * @return Sample count.
+    */
+   [[nodiscard]] uint64_t count() const;
+
+   /**
+    * @brief Estimate a percentile.
+    * @param fraction  Percentile as a fraction in [0, 1] (0.99 = p99).
+    * @return Duration in nanoseconds (bucket midpoint), or 0 if empty.
+    */
+   [[nodiscard]] double percentileNs(double fraction) const;
+
+   /**
+    * @brief Get count, mean, p50 / p90 / p99 and maximum.
+    * @return Summary in microseconds.
+    */
+   [[nodiscard]] LatencySummary summary() const;
+
+private:
+   static constexpr std::size_t SUB_BITS     = 3;   // log2(SUB_BUCKETS)
+   static constexpr std::size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+   [[nodiscard]] static std::size_t bucketOf(uint64_t ns);
+   [[nodiscard]] static double bucketMidpointNs(std::size_t bucket);
+
+   std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets{};
+   std::atomic<uint64_t> _count{0};
+   std::atomic<uint64_t> _sumNs{0};
+   std::atomic<uint64_t> _maxNs{0};
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_LATENCYHISTOGRAM_H_
@@ -0,0 +1,286 @@
+#ifndef COMMONUTILS_LOCKFREEDATAHANDLER_H_
+#define COMMONUTILS_LOCKFREEDATAHANDLER_H_
+
+// Project headers
+#include "MpscQueue.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @class LockFreeDataHandler
+ * @brief DataHandler variant for high item rates: lock-free enqueue and
+ *        batched dispatch.
+ *
+ * signalData() pushes onto an MpscQueue and touches no mutex or condition
+ * variable; the worker is only woken (one futex call) when it has gone to
+ * sleep on an empty queue.  Each wake-up drains up to MAX_BATCH items and
+ * dispatches them against one snapshot of the listener list, which
+ * registerListener() / unregisterListener() replace copy-on-write — so the
+ * worker takes its locks once per batch rather than once per item.
+ *
+ * The queue is unbounded and there is no overflow policy: use DataHandler
+ * where a slow listener must not grow memory, and this class where the
+ * listeners keep up but the per-item synchronisation cost matters.
+ *
+ * Thread-safety: every public method is thread-safe.  unregisterListener()
+ * waits for a batch in progress, so it must not be called from a listener.
+ */
+template <typename T>
+class LockFreeDataHandler
+{
+public:
+   using Listener = std::function<void(const T&)>;
+
+   /// Most items dispatched per listener snapshot.
+   static constexpr std::size_t MAX_BATCH = 256;
+
+   /**
+    * @brief Construct the handler and start the worker thread.
+    */
+   LockFreeDataHandler()
+      : _listeners{std::make_shared<const ListenerList>()}
+   {
+      _workerThread = std::thread(&LockFreeDataHandler::processData, this);
+      ThreadConfig::instance().apply(_workerThread, "LockFreeDataHandler");
+   }
+
+   /**
+    * @brief Stop the worker thread; items still queued are discarded.
+    */
+   ~LockFreeDataHandler()
+   {
+      _stopFlag.store(true);
+      wakeWorker();
+      if (_workerThread.joinable())
+      {
+         _workerThread.join();
+      }
+   }
+
+   // Non-copyable, non-movable (the worker thread holds `this`).
+   LockFreeDataHandler(const LockFreeDataHandler&) = delete;
+   LockFreeDataHandler& operator=(const LockFreeDataHandler&) = delete;
+   LockFreeDataHandler(LockFreeDataHandler&&) = delete;
+   LockFreeDataHandler& operator=(LockFreeDataHandler&&) = delete;
+
+   /**
+    * @brief Enqueue an item for the listeners.  Never blocks.
+    * @param data The data item to enqueue (copied).
+    */
+   void signalData(const T& data)
+   {
+      emplace(data);
+   }
+
+   /**
+    * @brief As signalData(const T&), moving the item into the queue.
+    * @param data The data item to enqueue.
+    */
+   void signalData(T&& data)
+   {
+      emplace(std::move(data));
+   }
+
+   /**
+    * @brief As signalData(), constructing the item in place in the queue.
+    * @param args Constructor arguments of T.
+    */
+   template <typename... Args>
+   void emplace(Args&&... args)
+   {
+      if (_stopFlag.load(std::memory_order_relaxed)) return;
+
+      _queue.emplace(std::forward<Args>(args)...);
+      // Pairs with the fence in waitForData(): either the worker sees the
+      // item before sleeping, or we see that it is asleep.  Only the
+      // producer that clears the flag pays for the wake-up.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (_sleeping.load(std::memory_order_relaxed) && _sleeping.exchange(false))
+      {
+         wakeWorker();
+      }
+   }
+
+   /**
+    * @brief Register a listener callback for new data.
+    *
+    * Takes effect from the next batch.
+    *
+    * @param listener Callback invoked (on the worker thread) for each item.
+    * @return A unique registration ID, or -1 if the handler is stopped.
+    */
+   int registerListener(const Listener& listener)
+   {
+      if (_stopFlag) return -1;
+      const std::lock_guard<std::mutex> lock(_listenersMutex);
+      auto updated = std::make_shared<ListenerList>(*_listeners);
+      updated->emplace_back(++_nextListenerId, listener);
+      _listeners = std::move(updated);
+      return _nextListenerId;
+   }
+
+   /**
+    * @brief Unregister a listener by its registration ID.
+    *
+    * Waits for a batch in progress, so the listener is not called once
+    * this returns.
+    *
+    * @param id The registration ID returned by registerListener().
+    */
+   void unregisterListener(int id)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(_listenersMutex);
+         auto updated = std::make_shared<ListenerList>(*_listeners);
+         std::erase_if(*updated, [id](const auto& entry) { return entry.first == id; });
+         _listeners = std::move(updated);
+      }
+      const std::lock_guard<std::mutex> waitForBatch(_dispatchMutex);
+   }
+
+   /**
+    * @brief Get the number of registered listeners.
+    * @return Listener count.
+    */
+   [[nodiscard]] size_t listenerCount() const
+   {
+      const std::lock_guard<std::mutex> lock(_listenersMutex);
+      return _listeners->size();
+   }
+
+   /**
+    * @brief Get the number of items dispatched to the listeners.
+    * @return Items dispatched since construction.
+    */
+   [[nodiscard]] std::uint64_t deliveredCount() const
+   {
+      return _deliveredCount.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Get the number of batches dispatched.
+    *
+    * deliveredCount() / batchCount() is the mean batch size: near 1 while
+    * the listeners keep up, growing as the worker falls behind.
+    *
+    * @return Batches since construction.
+    */
+   [[nodiscard]] std::uint64_t batchCount() const
+   {
+      return _batchCount.load(std::memory_order_relaxed);
+   }
+
+private:
+   using ListenerList = std::vector<std::pair<int, Listener>>;
+
+   void processData()
+   {
+      std::vector<T> batch;
+      batch.reserve(MAX_BATCH);
+      while (!_stopFlag.load())
+      {
+         while (batch.size() < MAX_BATCH)
+         {
+            auto item = _queue.tryPop();
+            if (!item)
+            {
+               break;
+            }
+            batch.push_back(std::move(*item));
+         }
+         if (batch.empty())
+         {
+            waitForData();
+            continue;
+         }
+         dispatch(batch);
+         batch.clear();
+      }
+   }
+
+   void waitForData()
+   {
+      const std::uint32_t seq = _wakeSeq.load();
+      _sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (_queue.empty() && !_stopFlag.load())
+      {
+         _wakeSeq.wait(seq);
+      }
+      _sleeping.store(false, std::memory_order_relaxed);
+   }
+
+   void wakeWorker()
+   {
+      _wakeSeq.fetch_add(1);
+      _wakeSeq.notify_one();
+   }
+
+   void dispatch(const std::vector<T>& batch)
+   {
+      // The snapshot is taken under _dispatchMutex so unregisterListener()
+      // either waits for this batch or is already excluded from it.
+      const std::lock_guard<std::mutex> dispatchLock(_dispatchMutex);
+      std::shared_ptr<const ListenerList> listeners;
+      {
+         const std::lock_guard<std::mutex> lock(_listenersMutex);
+         listeners = _listeners;
+      }
+
+      for (const T& data : batch)
+      {
+         for (const auto& listener : *listeners)
+         {
+            try
+            {
+               listener.second(data);
+            }
+            catch (const std::exception& e)
+            {
+               std::cerr << "Listener threw an std::exception! " << e.what() << '\n';
+            }
+            catch (...)
+            {
+               std::cerr << "Listener threw an unknown exception!\n";
+            }
+         }
+      }
+      _deliveredCount.fetch_add(batch.size(), std::memory_order_relaxed);
+      _batchCount.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   MpscQueue<T> _queue;
+
+   mutable std::mutex _listenersMutex;            // Guards the pointer, not the list.
+   std::shared_ptr<const ListenerList> _listeners;
+   int _nextListenerId = 123;
+   std::mutex _dispatchMutex;                     // Held by the worker for a batch.
+
+   // Worker sleep / wake-up: the worker publishes `_sleeping` and waits on
+   // `_wakeSeq`; producers only bump the sequence when it is asleep.
+   std::atomic<bool> _sleeping{false};
+   std::atomic<std::uint32_t> _wakeSeq{0};
+
+   std::atomic<std::uint64_t> _deliveredCount{0};
+   std::atomic<std::uint64_t> _batchCount{0};
+   std::atomic<bool> _stopFlag{false};
+   std::thread _workerThread;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_LOCKFREEDATAHANDLER_H_
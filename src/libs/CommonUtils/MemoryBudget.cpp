@@ -0,0 +1,217 @@
+#include "MemoryBudget.h"
+
+// Project headers
+#include "GeneralLogger.h"
+
+// System headers
+#include <algorithm>
+#include <utility>
+
+namespace CommonUtils
+{
+
+namespace
+{
+
+// Raise `peak` to at least `value`.
+void raisePeak(std::atomic<size_t>& peak, size_t value)
+{
+   size_t seen = peak.load(std::memory_order_relaxed);
+   while (seen < value && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+   {
+   }
+}
+
+} // anonymous namespace
+
+const char* memoryReliefName(MemoryRelief relief)
+{
+   switch (relief)
+   {
+   case MemoryRelief::DropHistory:
+      return "drop-history";
+   case MemoryRelief::Coalesce:
+      return "coalesce";
+   case MemoryRelief::ShrinkPersistence:
+      return "shrink-persistence";
+   }
+   return "unknown";
+}
+
+// ============================================================================
+// MemoryAccount
+// ============================================================================
+
+MemoryAccount::MemoryAccount(std::string name, MemoryRelief relief)
+   : _name{std::move(name)}
+   , _relief{relief}
+{
+   MemoryRegistry::instance().add(this);
+}
+
+MemoryAccount::~MemoryAccount()
+{
+   setBytes(0);
+   MemoryRegistry::instance().remove(this);
+}
+
+void MemoryAccount::setBytes(size_t bytes)
+{
+   changed(_bytes.exchange(bytes, std::memory_order_relaxed), bytes);
+}
+
+void MemoryAccount::addBytes(size_t bytes)
+{
+   const size_t before = _bytes.fetch_add(bytes, std::memory_order_relaxed);
+   changed(before, before + bytes);
+}
+
+void MemoryAccount::subBytes(size_t bytes)
+{
+   size_t before = _bytes.load(std::memory_order_relaxed);
+   while (!_bytes.compare_exchange_weak(before, before - std::min(before, bytes),
+                                        std::memory_order_relaxed))
+   {
+   }
+   changed(before, before - std::min(before, bytes));
+}
+
+MemoryAccountStats MemoryAccount::stats() const
+{
+   MemoryAccountStats out;
+   out.name         = _name;
+   out.relief       = _relief;
+   out.currentBytes = bytes();
+   out.peakBytes    = _peak.load(std::memory_order_relaxed);
+   out.budgetBytes  = budget();
+   out.reliefs      = _reliefs.load(std::memory_order_relaxed);
+   return out;
+}
+
+void MemoryAccount::changed(size_t before, size_t after)
+{
+   raisePeak(_peak, after);
+   MemoryRegistry::instance().changed(before, after);
+}
+
+// ============================================================================
+// MemoryRegistry
+// ============================================================================
+
+MemoryRegistry& MemoryRegistry::instance()
+{
+   static MemoryRegistry registry;
+   return registry;
+}
+
+void MemoryRegistry::setBudget(const std::string& name, size_t bytes)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (bytes == 0)
+   {
+      _budgets.erase(name);
+   }
+   else
+   {
+      _budgets[name] = bytes;
+   }
+   for (MemoryAccount* account : _accounts)
+   {
+      if (account->_name == name)
+      {
+         account->_budget.store(bytes, std::memory_order_relaxed);
+      }
+   }
+}
+
+size_t MemoryRegistry::budget(const std::string& name) const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = _budgets.find(name);
+   return (it != _budgets.end()) ? it->second : 0;
+}
+
+std::vector<MemoryAccountStats> MemoryRegistry::allStats() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   std::vector<MemoryAccountStats> out;
+   out.reserve(_accounts.size());
+   for (const MemoryAccount* account : _accounts)
+   {
+      out.push_back(account->stats());
+   }
+   return out;
+}
+
+MemoryTotals MemoryRegistry::totals() const
+{
+   MemoryTotals out;
+   const std::lock_guard<std::mutex> lock(_mutex);
+   for (const MemoryAccount* account : _accounts)
+   {
+      out.currentBytes += account->bytes();
+      out.overBudget += account->overBudget() ? 1U : 0U;
+      out.reliefs += account->_reliefs.load(std::memory_order_relaxed);
+   }
+   out.accounts  = _accounts.size();
+   out.peakBytes = std::max(_totalPeak.load(std::memory_order_relaxed), out.currentBytes);
+   return out;
+}
+
+void MemoryRegistry::logStats() const
+{
+   const MemoryTotals total = totals();
+   GPINFO("Memory: {:.1f} MiB in {} accounts (peak {:.1f} MiB), {} over budget, {} reliefs",
+          static_cast<double>(total.currentBytes) / (1024.0 * 1024.0), total.accounts,
+          static_cast<double>(total.peakBytes) / (1024.0 * 1024.0), total.overBudget,
+          total.reliefs);
+
+   for (const MemoryAccountStats& account : allStats())
+   {
+      if (account.currentBytes == 0 && account.reliefs == 0)
+      {
+         continue;
+      }
+      if (account.budgetBytes != 0 && account.currentBytes > account.budgetBytes)
+      {
+         GPWARN("Memory {}: {} bytes (peak {}) over its budget of {}, {} x {}", account.name,
+                account.currentBytes, account.peakBytes, account.budgetBytes, account.reliefs,
+                memoryReliefName(account.relief));
+      }
+      else
+      {
+         GPINFO("Memory {}: {} bytes (peak {}, budget {}), {} x {}", account.name,
+                account.currentBytes, account.peakBytes, account.budgetBytes, account.reliefs,
+                memoryReliefName(account.relief));
+      }
+   }
+}
+
+void MemoryRegistry::add(MemoryAccount* account)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = _budgets.find(account->_name);
+   account->_budget.store(it != _budgets.end() ? it->second : 0, std::memory_order_relaxed);
+   _accounts.push_back(account);
+}
+
+void MemoryRegistry::remove(MemoryAccount* account)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   std::erase(_accounts, account);
+}
+
+void MemoryRegistry::changed(size_t before, size_t after)
+{
+   if (after >= before)
+   {
+      raisePeak(_totalPeak, _totalBytes.fetch_add(after - before, std::memory_order_relaxed) +
+                               (after - before));
+   }
+   else
+   {
+      _totalBytes.fetch_sub(before - after, std::memory_order_relaxed);
+   }
+}
+
+} // namespace CommonUtils
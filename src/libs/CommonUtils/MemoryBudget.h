@@ -0,0 +1,208 @@
+#ifndef COMMONUTILS_MEMORYBUDGET_H_
+#define COMMONUTILS_MEMORYBUDGET_H_
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @brief How a subsystem gives memory back when its account is over budget.
+ */
+enum class MemoryRelief : uint8_t
+{
+   DropHistory,         ///< Forget the oldest retained data (waterfall rows, partial messages).
+   Coalesce,            ///< Keep only the newest queued items.
+   ShrinkPersistence    ///< Retain fewer points for display persistence.
+};
+
+/**
+ * @brief Get a relief policy's display name.
+ * @return "drop-history", "coalesce" or "shrink-persistence".
+ */
+[[nodiscard]] const char* memoryReliefName(MemoryRelief relief);
+
+/**
+ * @class MemoryAccountStats
+ * @brief Memory held by one MemoryAccount.
+ */
+struct MemoryAccountStats
+{
+   std::string name;                            ///< Subsystem, e.g. "waterfall.history".
+   MemoryRelief relief{MemoryRelief::DropHistory};
+   size_t currentBytes{0};                      ///< Held right now.
+   size_t peakBytes{0};                         ///< Most held at once since construction.
+   size_t budgetBytes{0};                       ///< Budget for the name (0 = unlimited).
+   uint64_t reliefs{0};                         ///< Times the subsystem degraded to fit the budget.
+};
+
+/**
+ * @class MemoryTotals
+ * @brief Memory held by every MemoryAccount together.
+ */
+struct MemoryTotals
+{
+   size_t currentBytes{0};    ///< Held right now.
+   size_t peakBytes{0};       ///< Most held at once by all accounts together.
+   size_t accounts{0};        ///< Live accounts.
+   size_t overBudget{0};      ///< Accounts holding more than their budget right now.
+   uint64_t reliefs{0};       ///< Degradations of the live accounts.
+};
+
+/**
+ * @class MemoryAccount
+ * @brief Bytes one subsystem instance holds, checked against the budget for
+ *        its name.
+ *
+ * The owner reports what it holds with setBytes() (or addBytes() /
+ * subBytes()) whenever its storage changes and asks overBudget() or fits()
+ * before growing.  When it is over, it applies its own relief (dropping
+ * history, coalescing, shrinking persistence) and calls recordRelief();
+ * the account only keeps score, it never frees anything itself.
+ *
+ * Accounts register with MemoryRegistry for their lifetime; names need not
+ * be unique (every waterfall has a "waterfall.history" account, each with
+ * the whole budget).
+ *
+ * Thread-safety: every method is thread-safe and lock-free.
+ */
+class MemoryAccount
+{
+public:
+   /**
+    * @param name    Subsystem name that budgets are set for.
+    * @param relief  What the owner does when over budget (reported in stats).
+    */
+   MemoryAccount(std::string name, MemoryRelief relief);
+   ~MemoryAccount();
+
+   MemoryAccount(const MemoryAccount&) = delete;
+   MemoryAccount& operator=(const MemoryAccount&) = delete;
+   MemoryAccount(MemoryAccount&&) = delete;
+   MemoryAccount& operator=(MemoryAccount&&) = delete;
+
+   /** @brief Report the bytes held now. */
+   void setBytes(size_t bytes);
+
+   /** @brief Report `bytes` more held. */
+   void addBytes(size_t bytes);
+
+   /** @brief Report `bytes` released (clamped at zero). */
+   void subBytes(size_t bytes);
+
+   /** @brief Bytes held now. */
+   [[nodiscard]] size_t bytes() const { return _bytes.load(std::memory_order_relaxed); }
+
+   /** @brief Budget for the account's name (0 = unlimited). */
+   [[nodiscard]] size_t budget() const { return _budget.load(std::memory_order_relaxed); }
+
+   /** @brief true if more than the budget is held. */
+   [[nodiscard]] bool overBudget() const
+   {
+      const size_t limit = budget();
+      return limit != 0 && bytes() > limit;
+   }
+
+   /** @brief true if holding `total` bytes would stay within the budget. */
+   [[nodiscard]] bool fits(size_t total) const
+   {
+      const size_t limit = budget();
+      return limit == 0 || total <= limit;
+   }
+
+   /** @brief Count one degradation applied to stay within the budget. */
+   void recordRelief() { _reliefs.fetch_add(1, std::memory_order_relaxed); }
+
+   /** @brief Snapshot for MemoryRegistry::allStats(). */
+   [[nodiscard]] MemoryAccountStats stats() const;
+
+   /** @brief Subsystem name. */
+   [[nodiscard]] const std::string& name() const { return _name; }
+
+private:
+   friend class MemoryRegistry;
+
+   // Record the change from `before` to `after` in the peak and registry total.
+   void changed(size_t before, size_t after);
+
+   const std::string _name;
+   const MemoryRelief _relief;
+   std::atomic<size_t> _bytes{0};
+   std::atomic<size_t> _peak{0};
+   std::atomic<size_t> _budget{0};
+   std::atomic<uint64_t> _reliefs{0};
+};
+
+/**
+ * @class MemoryRegistry
+ * @brief Process-wide directory of MemoryAccounts and the budgets per
+ *        subsystem name.
+ *
+ * setBudget() applies to existing and future accounts of that name; every
+ * instance gets the whole budget.  allStats() and totals() feed the stats
+ * APIs, and logStats() writes one line per account (SdrEngine health
+ * logging calls it).
+ *
+ * Thread-safety: all methods are thread-safe.
+ */
+class MemoryRegistry
+{
+public:
+   /**
+    * @brief Get the process-wide registry.
+    * @return Registry instance.
+    */
+   [[nodiscard]] static MemoryRegistry& instance();
+
+   /**
+    * @brief Set the budget for every account called `name`.
+    * @param name   Subsystem name.
+    * @param bytes  Budget in bytes; 0 removes it.
+    */
+   void setBudget(const std::string& name, size_t bytes);
+
+   /**
+    * @brief Get the budget for `name`.
+    * @return Budget in bytes, 0 if none is set.
+    */
+   [[nodiscard]] size_t budget(const std::string& name) const;
+
+   /**
+    * @brief Get every live account's usage.
+    * @return One entry per account, in registration order.
+    */
+   [[nodiscard]] std::vector<MemoryAccountStats> allStats() const;
+
+   /**
+    * @brief Get the usage of all accounts together.
+    * @return Totals; the peak covers accounts that no longer exist.
+    */
+   [[nodiscard]] MemoryTotals totals() const;
+
+   /** @brief Log the totals and each account holding memory or over budget. */
+   void logStats() const;
+
+private:
+   friend class MemoryAccount;
+
+   void add(MemoryAccount* account);
+   void remove(MemoryAccount* account);
+   void changed(size_t before, size_t after);
+
+   mutable std::mutex _mutex;
+   std::vector<MemoryAccount*> _accounts;
+   std::map<std::string, size_t> _budgets;
+   std::atomic<size_t> _totalBytes{0};
+   std::atomic<size_t> _totalPeak{0};
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_MEMORYBUDGET_H_
@@ -0,0 +1,129 @@
+#ifndef COMMONUTILS_MPSCQUEUE_H_
+#define COMMONUTILS_MPSCQUEUE_H_
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace CommonUtils
+{
+
+/**
+ * @class MpscQueue
+ * @brief Unbounded, lock-free multi-producer / single-consumer FIFO.
+ *
+ * A linked list of heap nodes (D. Vyukov's node-based MPSC design): a push
+ * is one allocation, one atomic exchange and one store, and never waits
+ * for other producers or the consumer.  The consumer pops without any
+ * atomic read-modify-write.
+ *
+ * A producer that has swapped itself in but not yet linked its node makes
+ * the queue briefly look empty (or end early) to the consumer; the item
+ * becomes visible as soon as the link is stored.  There is no blocking
+ * pop — pair the queue with a wake-up mechanism (see LockFreeDataHandler).
+ *
+ * Thread-safety: push() from any number of threads; tryPop() and empty()
+ * from a single consumer thread only.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+   MpscQueue()
+      : _head{new Node}
+      , _tail{_head.load(std::memory_order_relaxed)}
+   {
+   }
+
+   // Non-copyable, non-movable (producers hold the head pointer).
+   MpscQueue(const MpscQueue&) = delete;
+   MpscQueue& operator=(const MpscQueue&) = delete;
+   MpscQueue(MpscQueue&&) = delete;
+   MpscQueue& operator=(MpscQueue&&) = delete;
+
+   /**
+    * @brief Free every node, discarding items still queued.
+    * No producer or consumer may be active.
+    */
+   ~MpscQueue()
+   {
+      Node* node = _tail;
+      while (node != nullptr)
+      {
+         Node* next = node->next.load(std::memory_order_relaxed);
+         delete node;
+         node = next;
+      }
+   }
+
+   /**
+    * @brief Append an item.  Never blocks (but allocates one node).
+    * @param item  Item to enqueue.
+    */
+   void push(T item)
+   {
+      emplace(std::move(item));
+   }
+
+   /**
+    * @brief Append an item constructed in place from `args`.
+    * @param args  Constructor arguments of T.
+    */
+   template <typename... Args>
+   void emplace(Args&&... args)
+   {
+      Node* node = new Node;
+      node->value.emplace(std::forward<Args>(args)...);
+      Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+      prev->next.store(node, std::memory_order_release);
+   }
+
+   /**
+    * @brief Remove the oldest item, if one is visible.
+    * @return The item, or std::nullopt if the queue looks empty.
+    */
+   std::optional<T> tryPop()
+   {
+      Node* next = _tail->next.load(std::memory_order_acquire);
+      if (next == nullptr)
+      {
+         return std::nullopt;
+      }
+      // `next` becomes the new stub; its value moves out to the caller.
+      std::optional<T> item{std::in_place, std::move(*next->value)};
+      next->value.reset();
+      delete _tail;
+      _tail = next;
+      return item;
+   }
+
+   /**
+    * @brief Check if no item is visible to the consumer.
+    * @return true if tryPop() would return std::nullopt.
+    */
+   [[nodiscard]] bool empty() const
+   {
+      return _tail->next.load(std::memory_order_acquire) == nullptr;
+   }
+
+private:
+   struct Node
+   {
+      std::atomic<Node*> next{nullptr};
+      std::optional<T> value;
+   };
+
+   static constexpr std::size_t CACHE_LINE = 64;
+
+   // Producers swap the head; the consumer owns the tail (the stub node
+   // whose successor is the oldest item).  Separate cache lines keep them
+   // from false-sharing.
+   alignas(CACHE_LINE) std::atomic<Node*> _head;
+   alignas(CACHE_LINE) Node* _tail;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_MPSCQUEUE_H_
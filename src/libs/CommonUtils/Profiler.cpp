@@ -0,0 +1,248 @@
+#include "Profiler.h"
+#include "SpscRingBuffer.h"
+
+// Third-party headers
+#include "spdlog/fmt/fmt.h"
+
+// System headers
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils
+{
+
+std::atomic<bool> Profiler::s_enabled{false};
+const std::chrono::steady_clock::time_point Profiler::s_epoch = std::chrono::steady_clock::now();
+
+namespace
+{
+
+// One thread's zones.  The owning thread is the ring's producer; exports,
+// under the registry mutex, are its consumer.
+struct ThreadBuffer
+{
+   SpscRingBuffer<ProfileEvent> events;   // Allocated on first record().
+   std::atomic<std::uint64_t> dropped{0};
+   std::atomic<bool> exited{false};
+   std::uint64_t tid{0};
+   std::string name;                      // Guarded by the registry mutex.
+};
+
+struct Registry
+{
+   std::mutex mutex;
+   std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+   std::uint64_t nextTid{1};
+   std::uint64_t exitedDropped{0};        // Drops of buffers already removed.
+};
+
+// Never destroyed: threads may still exit after static destruction.
+Registry& registry()
+{
+   static auto* instance = new Registry;
+   return *instance;
+}
+
+// Marks the buffer for removal (after its last export) on thread exit.
+struct ThreadSlot
+{
+   std::shared_ptr<ThreadBuffer> buffer;
+
+   ~ThreadSlot()
+   {
+      if (buffer)
+      {
+         buffer->exited.store(true, std::memory_order_release);
+      }
+   }
+};
+
+thread_local ThreadSlot t_slot;
+
+ThreadBuffer& threadBuffer()
+{
+   if (!t_slot.buffer)
+   {
+      auto buffer = std::make_shared<ThreadBuffer>();
+      Registry& reg = registry();
+      const std::lock_guard<std::mutex> lock(reg.mutex);
+      buffer->tid = reg.nextTid++;
+      reg.buffers.push_back(buffer);
+      t_slot.buffer = std::move(buffer);
+   }
+   return *t_slot.buffer;
+}
+
+void appendEscaped(std::string& out, const char* text)
+{
+   for (const char* c = text; *c != '\0'; ++c)
+   {
+      if (*c == '"' || *c == '\\')
+      {
+         out += '\\';
+         out += *c;
+      }
+      else if (static_cast<unsigned char>(*c) < 0x20)
+      {
+         out += ' ';
+      }
+      else
+      {
+         out += *c;
+      }
+   }
+}
+
+// Drain every buffer, calling `sink` per event; drop buffers of exited
+// threads once drained.  Called with the registry mutex held.
+template <typename Sink>
+void drainLocked(Registry& reg, Sink&& sink)
+{
+   for (const auto& buffer : reg.buffers)
+   {
+      while (true)
+      {
+         const auto regions = buffer->events.peek(buffer->events.capacity());
+         if (regions.size() == 0)
+         {
+            break;
+         }
+         for (const auto& event : regions.first)
+         {
+            sink(*buffer, event);
+         }
+         for (const auto& event : regions.second)
+         {
+            sink(*buffer, event);
+         }
+         buffer->events.consume(regions.size());
+      }
+   }
+   std::erase_if(reg.buffers, [&reg](const std::shared_ptr<ThreadBuffer>& buffer) {
+      if (!buffer->exited.load(std::memory_order_acquire) || buffer->events.available() != 0)
+      {
+         return false;
+      }
+      reg.exitedDropped += buffer->dropped.load(std::memory_order_relaxed);
+      return true;
+   });
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void Profiler::setEnabled(bool enabled)
+{
+   s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(std::string name)
+{
+   ThreadBuffer& buffer = threadBuffer();
+   Registry& reg = registry();
+   const std::lock_guard<std::mutex> lock(reg.mutex);
+   buffer.name = std::move(name);
+}
+
+void Profiler::record(const char* name, std::int64_t startNs, std::int64_t endNs)
+{
+   ThreadBuffer& buffer = threadBuffer();
+   if (buffer.events.capacity() == 0)
+   {
+      // Exports only read under the mutex, so resizing under it is safe.
+      Registry& reg = registry();
+      const std::lock_guard<std::mutex> lock(reg.mutex);
+      buffer.events.reset(EVENTS_PER_THREAD);
+   }
+   const ProfileEvent event{name, startNs, endNs - startNs};
+   if (buffer.events.write(&event, 1) == 0)
+   {
+      buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+   }
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+
+std::string Profiler::chromeTraceJson()
+{
+   std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+   bool first = true;
+   const auto separate = [&out, &first] {
+      if (!first)
+      {
+         out += ",\n";
+      }
+      first = false;
+   };
+
+   Registry& reg = registry();
+   const std::lock_guard<std::mutex> lock(reg.mutex);
+   for (const auto& buffer : reg.buffers)
+   {
+      if (!buffer->name.empty())
+      {
+         separate();
+         out += fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":")",
+                            buffer->tid);
+         appendEscaped(out, buffer->name.c_str());
+         out += "\"}}";
+      }
+   }
+   drainLocked(reg, [&](const ThreadBuffer& buffer, const ProfileEvent& event) {
+      separate();
+      out += R"({"name":")";
+      appendEscaped(out, event.name);
+      // Chrome trace times are microseconds; keep nanosecond precision.
+      fmt::format_to(std::back_inserter(out), R"(","ph":"X","pid":1,"tid":{},"ts":{}.{:03},"dur":{}.{:03}}})",
+                     buffer.tid, event.startNs / 1000, event.startNs % 1000,
+                     event.durationNs / 1000, event.durationNs % 1000);
+   });
+   out += "]}\n";
+   return out;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+   std::ofstream file(path, std::ios::trunc);
+   if (!file)
+   {
+      return false;
+   }
+   file << chromeTraceJson();
+   return static_cast<bool>(file);
+}
+
+std::uint64_t Profiler::droppedCount()
+{
+   Registry& reg = registry();
+   const std::lock_guard<std::mutex> lock(reg.mutex);
+   std::uint64_t total = reg.exitedDropped;
+   for (const auto& buffer : reg.buffers)
+   {
+      total += buffer->dropped.load(std::memory_order_relaxed);
+   }
+   return total;
+}
+
+void Profiler::clear()
+{
+   Registry& reg = registry();
+   const std::lock_guard<std::mutex> lock(reg.mutex);
+   drainLocked(reg, [](const ThreadBuffer&, const ProfileEvent&) {});
+   for (const auto& buffer : reg.buffers)
+   {
+      buffer->dropped.store(0, std::memory_order_relaxed);
+   }
+   reg.exitedDropped = 0;
+}
+
+} // namespace CommonUtils
@@ -2,9 +2,11 @@
 #include <chrono>
 #include <utility>
 
-SnoozableTimer::SnoozableTimer(std::function<void ()> function, int snoozePeriodMs)
+SnoozableTimer::SnoozableTimer(std::function<void ()> function, int snoozePeriodMs,
+                               CommonUtils::TimerWheel* wheel)
     : _function(std::move(function))
     , _snoozePeriodMs(snoozePeriodMs)
+    , _wheel(wheel)
 {
 
 }
@@ -18,6 +20,15 @@ void SnoozableTimer::start()
 {
     if (_isRunning) return;
 
+    if (_wheel != nullptr)
+    {
+        // One-shot that stays registered, so snooze() can re-arm it.
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _isRunning = true;
+        _wheelTimer = _wheel->schedule(std::chrono::milliseconds(_snoozePeriodMs), _function);
+        return;
+    }
+
     _executionTime = std::chrono::high_resolution_clock::now() +
                       std::chrono::milliseconds(_snoozePeriodMs);
 
@@ -44,9 +55,17 @@ void SnoozableTimer::start()
 
 void SnoozableTimer::stop()
 {
+    CommonUtils::TimerWheel::TimerId wheelTimer = CommonUtils::TimerWheel::INVALID_TIMER;
     {
         const std::lock_guard<std::mutex> lock(_mutex);
         _isRunning = false;
+        std::swap(wheelTimer, _wheelTimer);
+    }
+
+    // Outside the lock: cancel() waits for a running callback.
+    if (wheelTimer != CommonUtils::TimerWheel::INVALID_TIMER)
+    {
+        _wheel->cancel(wheelTimer);
     }
 
     _cv.notify_all();
@@ -59,6 +78,11 @@ void SnoozableTimer::stop()
 void SnoozableTimer::snooze()
 {
     const std::lock_guard<std::mutex> lock(_mutex);
+    if (_wheelTimer != CommonUtils::TimerWheel::INVALID_TIMER)
+    {
+        _wheel->reschedule(_wheelTimer, std::chrono::milliseconds(_snoozePeriodMs));
+        return;
+    }
     auto lcTimeNow = std::chrono::high_resolution_clock::now() +
             std::chrono::milliseconds(_snoozePeriodMs);
     _executionTime = lcTimeNow;
@@ -8,6 +8,9 @@
 #include <mutex>
 #include <thread>
 
+// Project headers
+#include "TimerWheel.h"
+
 /**
  * @class SnoozableTimer
  * @brief Timer that executes a callback after a snooze period, with the
@@ -15,6 +18,10 @@
  *
  * Once started, the timer counts down for the configured snooze period.
  * Calling snooze() resets the deadline to NOW + snoozePeriod.
+ *
+ * By default the timer owns a thread while started.  Constructed with a
+ * TimerWheel, it registers there instead and snooze() is an O(1) move of
+ * its wheel slot.
  */
 class SnoozableTimer
 {
@@ -24,8 +31,11 @@ public:
     *
     * @param function       Callback to invoke when the timer expires.
     * @param snoozePeriodMs Initial snooze period in milliseconds.
+    * @param wheel          Wheel to run on (e.g. &TimerWheel::shared());
+    *                       must outlive the timer.  nullptr: own a thread.
     */
-   SnoozableTimer(std::function<void()> function, int snoozePeriodMs);
+   SnoozableTimer(std::function<void()> function, int snoozePeriodMs,
+                  CommonUtils::TimerWheel* wheel = nullptr);
 
    /**
     * @brief Destroy the timer, stopping it if running.
@@ -67,6 +77,8 @@ private:
    std::thread _thread;
    int _snoozePeriodMs;
    bool _isRunning = false;
+   CommonUtils::TimerWheel* _wheel;
+   CommonUtils::TimerWheel::TimerId _wheelTimer{CommonUtils::TimerWheel::INVALID_TIMER};
 };
 
 #endif // SNOOZABLETIMER_H_
@@ -0,0 +1,212 @@
+#ifndef COMMONUTILS_SPSCRINGBUFFER_H_
+#define COMMONUTILS_SPSCRINGBUFFER_H_
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @class SpscRingBuffer
+ * @brief Preallocated, lock-free single-producer / single-consumer ring for
+ *        streaming elements between two threads.
+ *
+ * The capacity is a power of two, so positions wrap with a mask.  The
+ * producer reserves up to two contiguous regions (before and after the
+ * wrap point), writes into them in place and commits; the consumer peeks
+ * up to two regions, uses them in place and consumes.  write() / read()
+ * copy through the same regions.  Neither side takes a lock or allocates
+ * after reset().
+ *
+ * A full ring never overwrites: prepareWrite() returns only the free space
+ * and write() reports how many elements fit, leaving drop accounting to
+ * the caller.  Unlike CircularBuffer, the consumer removes what it reads.
+ *
+ * Thread-safety: exactly one producer thread and one consumer thread may
+ * operate concurrently.  reset() must only be called while neither is
+ * active.
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+   /**
+    * @class Regions
+    * @brief Up to two contiguous spans covering a logical range of the ring.
+    *
+    * `second` is empty unless the range wraps past the end of storage.
+    */
+   template <typename U>
+   struct Regions
+   {
+      std::span<U> first;
+      std::span<U> second;
+
+      /** @brief Total number of elements covered by both spans. */
+      [[nodiscard]] std::size_t size() const { return first.size() + second.size(); }
+   };
+
+   using WriteRegions = Regions<T>;
+   using ReadRegions  = Regions<const T>;
+
+   /**
+    * @brief Construct a ring holding at least `minCapacity` elements.
+    * The capacity is rounded up to the next power of two.  A capacity of
+    * zero leaves the ring unallocated until reset() is called.
+    */
+   explicit SpscRingBuffer(std::size_t minCapacity = 0)
+   {
+      reset(minCapacity);
+   }
+
+   // Non-copyable, non-movable (atomics are shared between threads).
+   SpscRingBuffer(const SpscRingBuffer&) = delete;
+   SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+   SpscRingBuffer(SpscRingBuffer&&) = delete;
+   SpscRingBuffer& operator=(SpscRingBuffer&&) = delete;
+   ~SpscRingBuffer() = default;
+
+   /**
+    * @brief Reallocate (if needed) and empty the ring.
+    * Not thread-safe — call only while no producer or consumer is running.
+    * @param minCapacity  Minimum number of elements the ring must hold.
+    */
+   void reset(std::size_t minCapacity)
+   {
+      const std::size_t capacity = (minCapacity == 0) ? 0 : std::bit_ceil(minCapacity);
+      if (capacity != _buffer.size())
+      {
+         _buffer.assign(capacity, T{});
+         _buffer.shrink_to_fit();
+      }
+      _mask = (capacity == 0) ? 0 : capacity - 1;
+
+      _writePos.store(0, std::memory_order_relaxed);
+      _readPos.store(0, std::memory_order_relaxed);
+   }
+
+   /** @brief Storage capacity in elements (always a power of two, or zero). */
+   [[nodiscard]] std::size_t capacity() const { return _buffer.size(); }
+
+   /** @brief Number of elements ready to be read. */
+   [[nodiscard]] std::size_t available() const
+   {
+      return _writePos.load(std::memory_order_acquire) - _readPos.load(std::memory_order_acquire);
+   }
+
+   /** @brief Number of elements that can be written. */
+   [[nodiscard]] std::size_t freeSpace() const { return _buffer.size() - available(); }
+
+   /** @brief Elements committed since reset() (the producer's position). */
+   [[nodiscard]] std::size_t writeCount() const { return _writePos.load(std::memory_order_acquire); }
+
+   /** @brief Elements consumed since reset() (the consumer's position). */
+   [[nodiscard]] std::size_t readCount() const { return _readPos.load(std::memory_order_acquire); }
+
+   // -- Producer side -------------------------------------------------------
+
+   /**
+    * @brief Reserve space for up to `count` elements.
+    * The returned regions may be shorter than requested if the ring is
+    * nearly full.  Follow with commitWrite().
+    */
+   [[nodiscard]] WriteRegions prepareWrite(std::size_t count)
+   {
+      const std::size_t writePos = _writePos.load(std::memory_order_relaxed);
+      const std::size_t readPos  = _readPos.load(std::memory_order_acquire);
+      return regionsOf(std::span<T>(_buffer), writePos & _mask,
+                       std::min(count, _buffer.size() - (writePos - readPos)));
+   }
+
+   /** @brief Publish `count` elements previously written via prepareWrite(). */
+   void commitWrite(std::size_t count)
+   {
+      _writePos.store(_writePos.load(std::memory_order_relaxed) + count, std::memory_order_release);
+   }
+
+   /**
+    * @brief Copy up to `count` elements into the ring.
+    * @return Number of elements written; the rest did not fit.
+    */
+   std::size_t write(const T* values, std::size_t count)
+   {
+      const auto regions = prepareWrite(count);
+      std::copy_n(values, regions.first.size(), regions.first.begin());
+      std::copy_n(values + regions.first.size(), regions.second.size(), regions.second.begin());
+      commitWrite(regions.size());
+      return regions.size();
+   }
+
+   // -- Consumer side -------------------------------------------------------
+
+   /**
+    * @brief View up to `count` readable elements in place without consuming
+    *        them.  Follow with consume() once the data has been used.
+    */
+   [[nodiscard]] ReadRegions peek(std::size_t count) const
+   {
+      const std::size_t readPos  = _readPos.load(std::memory_order_relaxed);
+      const std::size_t writePos = _writePos.load(std::memory_order_acquire);
+      return regionsOf(std::span<const T>(_buffer), readPos & _mask, std::min(count, writePos - readPos));
+   }
+
+   /** @brief Release up to `count` elements previously returned by peek(). */
+   void consume(std::size_t count)
+   {
+      const std::size_t readPos  = _readPos.load(std::memory_order_relaxed);
+      const std::size_t writePos = _writePos.load(std::memory_order_acquire);
+      _readPos.store(readPos + std::min(count, writePos - readPos), std::memory_order_release);
+   }
+
+   /**
+    * @brief Copy up to `count` elements out of the ring and consume them.
+    * @return Number of elements read.
+    */
+   std::size_t read(T* dest, std::size_t count)
+   {
+      const auto regions = peek(count);
+      std::copy(regions.first.begin(), regions.first.end(), dest);
+      std::copy(regions.second.begin(), regions.second.end(), dest + regions.first.size());
+      consume(regions.size());
+      return regions.size();
+   }
+
+   /** @brief Discard everything readable.  Consumer side. */
+   void drain()
+   {
+      _readPos.store(_writePos.load(std::memory_order_acquire), std::memory_order_release);
+   }
+
+private:
+   static constexpr std::size_t CACHE_LINE = 64;
+
+   // Split `count` elements from physical index `start` at the wrap point.
+   template <typename U>
+   [[nodiscard]] static Regions<U> regionsOf(std::span<U> storage, std::size_t start, std::size_t count)
+   {
+      if (count == 0)
+      {
+         return {};
+      }
+      const std::size_t first = std::min(count, storage.size() - start);
+      return {storage.subspan(start, first), storage.first(count - first)};
+   }
+
+   std::vector<T> _buffer;
+   std::size_t _mask{0};
+
+   // Monotonic positions; the physical index is `pos & _mask`.  Kept on
+   // separate cache lines so producer and consumer do not false-share.
+   alignas(CACHE_LINE) std::atomic<std::size_t> _writePos{0};
+   alignas(CACHE_LINE) std::atomic<std::size_t> _readPos{0};
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_SPSCRINGBUFFER_H_
@@ -0,0 +1,282 @@
+#include "TaskPool.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <algorithm>
+#include <utility>
+
+namespace CommonUtils
+{
+
+namespace
+{
+
+// The pool and worker index of the calling thread, if it is a worker.
+thread_local const TaskPool* t_pool = nullptr;
+thread_local std::size_t t_worker   = 0;
+
+} // anonymous namespace
+
+// ============================================================================
+// TaskHandle
+// ============================================================================
+
+struct TaskHandle::State
+{
+   // A task to post once this one has run, completing `state`.
+   struct Continuation
+   {
+      std::shared_ptr<State> state;
+      std::function<void()> task;
+      TaskOptions options;
+   };
+
+   explicit State(TaskPool& owner) : pool{owner} {}
+
+   TaskPool& pool;
+   std::mutex mutex;
+   std::condition_variable finished;
+   bool done{false};
+   std::vector<Continuation> next;
+};
+
+bool TaskHandle::done() const
+{
+   const std::lock_guard<std::mutex> lock(_state->mutex);
+   return _state->done;
+}
+
+void TaskHandle::wait() const
+{
+   std::unique_lock<std::mutex> lock(_state->mutex);
+   _state->finished.wait(lock, [this] { return _state->done; });
+}
+
+TaskHandle TaskHandle::then(std::function<void()> task, TaskOptions options) const
+{
+   auto next = std::make_shared<State>(_state->pool);
+   {
+      const std::lock_guard<std::mutex> lock(_state->mutex);
+      if (!_state->done)
+      {
+         _state->next.push_back(State::Continuation{next, std::move(task), options});
+         return TaskHandle(next);
+      }
+   }
+   schedule(next, std::move(task), options);
+   return TaskHandle(next);
+}
+
+void TaskHandle::schedule(std::shared_ptr<State> state, std::function<void()> task,
+                          TaskOptions options)
+{
+   TaskPool& pool = state->pool;
+   pool.post(
+      [state = std::move(state), task = std::move(task)]
+      {
+         task();
+         std::vector<State::Continuation> next;
+         {
+            const std::lock_guard<std::mutex> lock(state->mutex);
+            state->done = true;
+            next.swap(state->next);
+         }
+         state->finished.notify_all();
+         for (auto& continuation : next)
+         {
+            schedule(std::move(continuation.state), std::move(continuation.task),
+                     continuation.options);
+         }
+      },
+      options);
+}
+
+// ============================================================================
+// TaskPool
+// ============================================================================
+
+TaskPool::TaskPool(std::size_t threads)
+{
+   threads = std::max<std::size_t>(threads, 1);
+   _workers.reserve(threads);
+   for (std::size_t i = 0; i < threads; ++i)
+   {
+      _workers.push_back(std::make_unique<Worker>());
+   }
+   _threads.reserve(threads);
+   for (std::size_t i = 0; i < threads; ++i)
+   {
+      _threads.emplace_back(&TaskPool::workerLoop, this, i);
+   }
+}
+
+TaskPool::~TaskPool()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_sleepMutex);
+      _stopping = true;
+   }
+   _work.notify_all();
+   for (auto& thread : _threads)
+   {
+      thread.join();
+   }
+}
+
+void TaskPool::post(Task task, TaskOptions options)
+{
+   const auto priority = static_cast<std::size_t>(options.priority);
+   const bool pinned   = options.worker != TaskOptions::ANY_WORKER;
+   std::size_t index   = 0;
+   if (pinned)
+   {
+      index = options.worker % _workers.size();
+   }
+   else if (t_pool == this)
+   {
+      index = t_worker;
+   }
+   else
+   {
+      index = _nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+   }
+
+   Worker& worker = *_workers[index];
+   {
+      const std::lock_guard<std::mutex> lock(worker.mutex);
+      if (pinned)
+      {
+         worker.pinned[priority].push_back(std::move(task));
+         worker.pinnedCount.fetch_add(1);
+      }
+      else
+      {
+         worker.tasks[priority].push_back(std::move(task));
+         _stealable.fetch_add(1);
+      }
+   }
+   wake(pinned);
+}
+
+TaskHandle TaskPool::submit(Task task, TaskOptions options)
+{
+   auto state = std::make_shared<TaskHandle::State>(*this);
+   TaskHandle::schedule(state, std::move(task), options);
+   return TaskHandle(std::move(state));
+}
+
+std::size_t TaskPool::threadCount() const
+{
+   return _threads.size();
+}
+
+std::uint64_t TaskPool::stealCount() const
+{
+   return _steals.load(std::memory_order_relaxed);
+}
+
+TaskPool& TaskPool::shared()
+{
+   static TaskPool pool(std::max(2U, std::thread::hardware_concurrency() / 2));
+   return pool;
+}
+
+void TaskPool::wake(bool pinned)
+{
+   {
+      // Taking the lock orders this check after a worker's predicate check,
+      // so a worker about to sleep either sees the new task or is notified.
+      const std::lock_guard<std::mutex> lock(_sleepMutex);
+      if (_sleepers == 0)
+      {
+         return;
+      }
+   }
+   // Only the owner can run a pinned task; wake every sleeper to reach it.
+   if (pinned)
+   {
+      _work.notify_all();
+   }
+   else
+   {
+      _work.notify_one();
+   }
+}
+
+bool TaskPool::takeTask(std::size_t index, Task& task)
+{
+   Worker& own = *_workers[index];
+   for (std::size_t priority = 0; priority < TASK_PRIORITY_COUNT; ++priority)
+   {
+      // Own pinned tasks, then own tasks, both in posting order: a task
+      // that re-posts itself to yield goes behind what is already queued.
+      {
+         const std::lock_guard<std::mutex> lock(own.mutex);
+         if (auto& pinned = own.pinned[priority]; !pinned.empty())
+         {
+            task = std::move(pinned.front());
+            pinned.pop_front();
+            own.pinnedCount.fetch_sub(1);
+            return true;
+         }
+         if (auto& tasks = own.tasks[priority]; !tasks.empty())
+         {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            _stealable.fetch_sub(1);
+            return true;
+         }
+      }
+      if (_stealable.load() == 0)
+      {
+         continue;
+      }
+      // Steal the oldest task at this priority from the next busy worker.
+      for (std::size_t offset = 1; offset < _workers.size(); ++offset)
+      {
+         Worker& victim = *_workers[(index + offset) % _workers.size()];
+         const std::lock_guard<std::mutex> lock(victim.mutex);
+         if (auto& tasks = victim.tasks[priority]; !tasks.empty())
+         {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            _stealable.fetch_sub(1);
+            _steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+void TaskPool::workerLoop(std::size_t index)
+{
+   t_pool   = this;
+   t_worker = index;
+   configureCurrentThread("TaskPool");
+
+   const Worker& own = *_workers[index];
+   Task task;
+   while (true)
+   {
+      if (takeTask(index, task))
+      {
+         task();
+         task = nullptr;
+         continue;
+      }
+
+      std::unique_lock<std::mutex> lock(_sleepMutex);
+      const auto hasWork = [this, &own]
+      { return _stealable.load() > 0 || own.pinnedCount.load() > 0; };
+      if (_stopping && !hasWork())
+      {
+         return;
+      }
+      ++_sleepers;
+      _work.wait(lock, [this, &hasWork] { return _stopping || hasWork(); });
+      --_sleepers;
+   }
+}
+
+} // namespace CommonUtils
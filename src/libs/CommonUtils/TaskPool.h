@@ -0,0 +1,225 @@
+#ifndef COMMONUTILS_TASKPOOL_H_
+#define COMMONUTILS_TASKPOOL_H_
+
+// System headers
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @brief Scheduling class of a TaskPool task; a free thread always takes
+ *        the most urgent queued task first.
+ */
+enum class TaskPriority : std::uint8_t
+{
+   RealTime,       ///< Sample-rate DSP that must keep up with the stream.
+   Display,        ///< Rendering and listener callbacks (default).
+   Housekeeping    ///< Statistics, cleanup, anything that can wait.
+};
+
+/** @brief Number of TaskPriority levels. */
+inline constexpr std::size_t TASK_PRIORITY_COUNT = 3;
+
+/**
+ * @class TaskOptions
+ * @brief How TaskPool schedules one task.
+ */
+struct TaskOptions
+{
+   /** @brief `worker` value for a task any thread may run. */
+   static constexpr std::size_t ANY_WORKER = ~std::size_t{0};
+
+   TaskPriority priority{TaskPriority::Display};
+
+   /// Run only on this worker (index < threadCount()), e.g. to keep a
+   /// stage's state in one core's cache; never stolen.  ANY_WORKER: any.
+   std::size_t worker{ANY_WORKER};
+};
+
+class TaskPool;
+
+/**
+ * @class TaskHandle
+ * @brief Completion of a task posted with TaskPool::submit(), for waiting
+ *        and chaining continuations.
+ *
+ * A default-constructed handle is empty (valid() is false).
+ *
+ * Thread-safety: all methods may be called from any thread.
+ */
+class TaskHandle
+{
+public:
+   TaskHandle() = default;
+
+   /** @brief true if the handle refers to a task. */
+   [[nodiscard]] bool valid() const { return _state != nullptr; }
+
+   /** @brief true once the task has run.  The handle must be valid(). */
+   [[nodiscard]] bool done() const;
+
+   /**
+    * @brief Block until the task has run.  Do not call from a task of the
+    * same pool: it holds that thread while the task may still be queued.
+    */
+   void wait() const;
+
+   /**
+    * @brief Post `task` once this one has run (immediately if it already has).
+    * The handle must be valid().
+    * @param task     Continuation.
+    * @param options  Its priority and affinity.
+    * @return Handle of the continuation, which can be chained in turn.
+    */
+   TaskHandle then(std::function<void()> task, TaskOptions options = {}) const;
+
+private:
+   friend class TaskPool;
+   struct State;
+
+   explicit TaskHandle(std::shared_ptr<State> state) : _state{std::move(state)} {}
+
+   // Post `task` on the state's pool; completing it posts the continuations.
+   static void schedule(std::shared_ptr<State> state, std::function<void()> task,
+                        TaskOptions options);
+
+   std::shared_ptr<State> _state;
+};
+
+/**
+ * @class TaskPool
+ * @brief Work-stealing threads running fire-and-forget tasks by priority.
+ *
+ * Where WorkerPool splits one loop across threads and waits for it,
+ * TaskPool runs independent tasks posted from anywhere, e.g. the
+ * DataHandler listeners registered with DispatchMode::SharedPool.
+ * shared() is a process-wide instance, so stages share one bounded set of
+ * threads instead of each starting its own.
+ *
+ * Every worker owns one deque per TaskPriority.  A task posted by a worker
+ * goes to its own deques, others are spread round-robin.  A free worker
+ * takes the most urgent task it can find: its own oldest at that priority
+ * or else another worker's oldest (stealing), before looking at the next
+ * priority down.  Tasks given a `TaskOptions::worker` wait in that
+ * worker's pinned deques, which are never stolen.  Each deque is FIFO, so
+ * a task that re-posts itself from a worker runs after the tasks already
+ * queued there at its priority: long-running drains (DataHandler
+ * listeners, HighBandwidthSubscriber topics) yield that way.  Across
+ * workers order is not guaranteed; a stage that needs ordering serialises
+ * itself (as DataHandler listeners do).
+ *
+ * submit() additionally returns a TaskHandle to wait on or to chain
+ * continuations with then().
+ *
+ * Tasks still queued when the pool is destroyed are run before the
+ * threads exit (a task pinned during destruction to a worker that has
+ * already exited is dropped).  Tasks must not throw.  Workers apply the
+ * ThreadConfig role "TaskPool" (affinity, real-time priority).
+ *
+ * Thread-safety: post() and submit() may be called from any thread,
+ * including tasks.
+ */
+class TaskPool
+{
+public:
+   using Task = std::function<void()>;
+
+   /**
+    * @brief Start `threads` worker threads.
+    * @param threads  Number of threads (at least 1).
+    */
+   explicit TaskPool(std::size_t threads);
+
+   /** @brief Run the remaining tasks, then stop and join every thread. */
+   ~TaskPool();
+
+   // Non-copyable, non-movable (threads hold `this`).
+   TaskPool(const TaskPool&) = delete;
+   TaskPool& operator=(const TaskPool&) = delete;
+   TaskPool(TaskPool&&) = delete;
+   TaskPool& operator=(TaskPool&&) = delete;
+
+   /**
+    * @brief Queue a task for the next free thread.
+    * @param task     Callable to run once.
+    * @param options  Priority and affinity (a worker index beyond
+    *                 threadCount() wraps around).
+    */
+   void post(Task task, TaskOptions options = {});
+
+   /**
+    * @brief post() returning a handle for waiting and continuations.
+    * @param task     Callable to run once.
+    * @param options  Priority and affinity.
+    * @return Handle completed once the task has run.
+    */
+   TaskHandle submit(Task task, TaskOptions options = {});
+
+   /**
+    * @brief Get the number of worker threads.
+    * @return Thread count.
+    */
+   [[nodiscard]] std::size_t threadCount() const;
+
+   /**
+    * @brief Get the number of tasks taken from another worker's deques.
+    * @return Steals since construction.
+    */
+   [[nodiscard]] std::uint64_t stealCount() const;
+
+   /**
+    * @brief Get the process-wide pool, started on first use with
+    *        `max(2, hardware_concurrency() / 2)` threads.
+    * @return Shared pool.
+    */
+   [[nodiscard]] static TaskPool& shared();
+
+private:
+   static constexpr std::size_t CACHE_LINE = 64;
+
+   // One worker's queues.  Owner pushes at the back; owner and thieves
+   // take from the front.
+   struct alignas(CACHE_LINE) Worker
+   {
+      std::mutex mutex;
+      std::array<std::deque<Task>, TASK_PRIORITY_COUNT> tasks;
+      std::array<std::deque<Task>, TASK_PRIORITY_COUNT> pinned;
+      std::atomic<std::size_t> pinnedCount{0};
+   };
+
+   void workerLoop(std::size_t index);
+
+   // Take the most urgent task for worker `index`, stealing if needed.
+   bool takeTask(std::size_t index, Task& task);
+
+   // Wake a sleeping worker for a new task (all of them for a pinned one).
+   void wake(bool pinned);
+
+   std::vector<std::unique_ptr<Worker>> _workers;
+   std::atomic<std::size_t> _nextWorker{0};     // Round-robin for outside posts.
+   std::atomic<std::size_t> _stealable{0};      // Queued unpinned tasks.
+   std::atomic<std::uint64_t> _steals{0};
+
+   std::mutex _sleepMutex;
+   std::condition_variable _work;
+   std::size_t _sleepers{0};                    // Guarded by _sleepMutex.
+   bool _stopping{false};                       // Guarded by _sleepMutex.
+
+   std::vector<std::thread> _threads;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_TASKPOOL_H_
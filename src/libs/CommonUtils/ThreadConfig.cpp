@@ -0,0 +1,300 @@
+#include "ThreadConfig.h"
+#include "GeneralLogger.h"
+#include "Profiler.h"
+
+// System headers
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <tuple>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace CommonUtils
+{
+
+namespace
+{
+
+constexpr std::size_t OS_THREAD_NAME_MAX = 15;
+constexpr int MAX_PRIORITY = 99;
+
+// Logging is optional here: threads may start before (or without) a logger.
+template <typename... Args>
+void warn(spdlog::format_string_t<Args...> format, Args&&... args)
+{
+   if (GeneralLogger::s_generalLogger)
+   {
+      GPWARN(format, std::forward<Args>(args)...);
+   }
+}
+
+bool parseInt(std::string_view text, int& value)
+{
+   const auto* end = text.data() + text.size();
+   const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+   return ec == std::errc{} && ptr == end;
+}
+
+// "2,3,8-11" → {2, 3, 8, 9, 10, 11}.
+bool parseCpuList(std::string_view text, std::vector<int>& cpus)
+{
+   cpus.clear();
+   while (!text.empty())
+   {
+      const auto comma = text.find(',');
+      const std::string_view item = text.substr(0, comma);
+      text = (comma == std::string_view::npos) ? std::string_view{} : text.substr(comma + 1);
+
+      const auto dash = item.find('-');
+      int first = 0;
+      int last  = 0;
+      if (!parseInt(item.substr(0, dash), first) ||
+          (dash != std::string_view::npos && !parseInt(item.substr(dash + 1), last)))
+      {
+         return false;
+      }
+      if (dash == std::string_view::npos)
+      {
+         last = first;
+      }
+      if (first < 0 || last < first)
+      {
+         return false;
+      }
+      for (int cpu = first; cpu <= last; ++cpu)
+      {
+         cpus.push_back(cpu);
+      }
+   }
+   return !cpus.empty();
+}
+
+bool parseLine(const std::string& line, std::string& role, ThreadSettings& settings, std::string& error)
+{
+   std::istringstream fields(line);
+   fields >> role;
+   std::string field;
+   while (fields >> field)
+   {
+      const auto equals = field.find('=');
+      const std::string key = field.substr(0, equals);
+      const std::string_view value = (equals == std::string::npos)
+                                        ? std::string_view{}
+                                        : std::string_view(field).substr(equals + 1);
+      bool valid = false;
+      if (key == "cpus")
+      {
+         valid = parseCpuList(value, settings.cpus);
+      }
+      else if (key == "numa")
+      {
+         valid = parseInt(value, settings.numaNode) && settings.numaNode >= 0;
+      }
+      else if (key == "priority")
+      {
+         valid = parseInt(value, settings.realtimePriority) && settings.realtimePriority >= 0 &&
+                 settings.realtimePriority <= MAX_PRIORITY;
+      }
+      if (!valid)
+      {
+         error = "bad setting '" + field + "' for " + role;
+         return false;
+      }
+   }
+   return true;
+}
+
+#ifdef __linux__
+// CPUs of a NUMA node, from sysfs; empty if the node does not exist.
+std::vector<int> numaNodeCpus(int node)
+{
+   std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+   std::string list;
+   std::vector<int> cpus;
+   if (std::getline(file, list))
+   {
+      std::ignore = parseCpuList(list, cpus);
+   }
+   return cpus;
+}
+
+bool applySettings(pthread_t handle, const std::string& role, const ThreadSettings& settings)
+{
+   bool ok = true;
+   const std::vector<int> cpus = !settings.cpus.empty() ? settings.cpus
+                               : (settings.numaNode >= 0 ? numaNodeCpus(settings.numaNode)
+                                                         : std::vector<int>{});
+   if (settings.numaNode >= 0 && settings.cpus.empty() && cpus.empty())
+   {
+      warn("Thread {}: NUMA node {} not found", role, settings.numaNode);
+      ok = false;
+   }
+   if (!cpus.empty())
+   {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (const int cpu : cpus)
+      {
+         if (cpu < CPU_SETSIZE)
+         {
+            CPU_SET(static_cast<std::size_t>(cpu), &set);
+         }
+      }
+      const int rc = pthread_setaffinity_np(handle, sizeof(set), &set);
+      if (rc != 0)
+      {
+         warn("Thread {}: cannot set CPU affinity (error {})", role, rc);
+         ok = false;
+      }
+   }
+   if (settings.realtimePriority > 0)
+   {
+      sched_param param{};
+      param.sched_priority = std::clamp(settings.realtimePriority, sched_get_priority_min(SCHED_FIFO),
+                                        sched_get_priority_max(SCHED_FIFO));
+      const int rc = pthread_setschedparam(handle, SCHED_FIFO, &param);
+      if (rc != 0)
+      {
+         warn("Thread {}: cannot set SCHED_FIFO priority {} (error {})", role,
+              param.sched_priority, rc);
+         ok = false;
+      }
+   }
+   return ok;
+}
+
+bool configure(pthread_t handle, const std::string& role, const std::optional<ThreadSettings>& settings)
+{
+   pthread_setname_np(handle, role.substr(0, OS_THREAD_NAME_MAX).c_str());
+   return !settings || applySettings(handle, role, *settings);
+}
+#endif
+
+} // anonymous namespace
+
+ThreadConfig& ThreadConfig::instance()
+{
+   static ThreadConfig config;
+   return config;
+}
+
+void ThreadConfig::set(std::string role, ThreadSettings settings)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = std::find_if(_entries.begin(), _entries.end(),
+                                [&role](const auto& entry) { return entry.first == role; });
+   if (it != _entries.end())
+   {
+      it->second = std::move(settings);
+      return;
+   }
+   _entries.emplace_back(std::move(role), std::move(settings));
+}
+
+void ThreadConfig::clear()
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _entries.clear();
+}
+
+std::optional<ThreadSettings> ThreadConfig::settingsFor(const std::string& role) const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const ThreadSettings* best = nullptr;
+   std::size_t bestPrefix = 0;
+   for (const auto& [pattern, settings] : _entries)
+   {
+      if (pattern == role)
+      {
+         return settings;
+      }
+      if (!pattern.empty() && pattern.back() == '*')
+      {
+         const std::size_t prefix = pattern.size() - 1;
+         if (role.compare(0, prefix, pattern, 0, prefix) == 0 && (best == nullptr || prefix > bestPrefix))
+         {
+            best       = &settings;
+            bestPrefix = prefix;
+         }
+      }
+   }
+   return (best != nullptr) ? std::optional<ThreadSettings>(*best) : std::nullopt;
+}
+
+bool ThreadConfig::load(const std::string& text, std::string* error)
+{
+   std::vector<std::pair<std::string, ThreadSettings>> parsed;
+   std::istringstream lines(text);
+   std::string line;
+   int lineNumber = 0;
+   while (std::getline(lines, line))
+   {
+      ++lineNumber;
+      line = line.substr(0, line.find('#'));
+      if (line.find_first_not_of(" \t\r") == std::string::npos)
+      {
+         continue;
+      }
+      std::string role;
+      ThreadSettings settings;
+      std::string lineError;
+      if (!parseLine(line, role, settings, lineError))
+      {
+         if (error != nullptr)
+         {
+            *error = "line " + std::to_string(lineNumber) + ": " + lineError;
+         }
+         return false;
+      }
+      parsed.emplace_back(std::move(role), std::move(settings));
+   }
+   for (auto& [role, settings] : parsed)
+   {
+      set(std::move(role), std::move(settings));
+   }
+   return true;
+}
+
+bool ThreadConfig::loadFile(const std::string& path, std::string* error)
+{
+   std::ifstream file(path);
+   if (!file)
+   {
+      if (error != nullptr)
+      {
+         *error = "cannot open " + path;
+      }
+      return false;
+   }
+   std::stringstream text;
+   text << file.rdbuf();
+   return load(text.str(), error);
+}
+
+bool ThreadConfig::applyToCurrentThread(const std::string& role) const
+{
+   Profiler::setThreadName(role);
+#ifdef __linux__
+   return configure(pthread_self(), role, settingsFor(role));
+#else
+   return !settingsFor(role);
+#endif
+}
+
+bool ThreadConfig::apply(std::thread& thread, const std::string& role) const
+{
+#ifdef __linux__
+   return configure(thread.native_handle(), role, settingsFor(role));
+#else
+   std::ignore = thread;
+   return !settingsFor(role);
+#endif
+}
+
+} // namespace CommonUtils
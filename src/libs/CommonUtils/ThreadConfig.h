@@ -0,0 +1,129 @@
+#ifndef COMMONUTILS_THREADCONFIG_H_
+#define COMMONUTILS_THREADCONFIG_H_
+
+// System headers
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @struct ThreadSettings
+ * @brief Scheduling applied to threads of one role.
+ */
+struct ThreadSettings
+{
+   std::vector<int> cpus;      ///< CPUs to pin to; empty: see numaNode.
+   int numaNode{-1};           ///< Pin to this node's CPUs when `cpus` is empty; -1: no pinning.
+   int realtimePriority{0};    ///< 1-99: SCHED_FIFO at this priority; 0: leave the OS default.
+
+   bool operator==(const ThreadSettings&) const = default;
+};
+
+/**
+ * @class ThreadConfig
+ * @brief Process-wide table of thread roles → affinity / real-time priority,
+ *        applied by each subsystem as it starts a thread.
+ *
+ * Roles are dotted names chosen by the thread's owner, e.g.
+ * "SoapySdr.stream", "SdrEngine.fft" or "DataHandler.SdrEngine.spectrum".
+ * A role matches its exact entry, else the longest entry ending in `*`
+ * whose prefix it starts with ("SdrEngine.*").
+ *
+ * Applying a role always sets the OS thread name (first 15 characters,
+ * as shown by top / gdb) and, for the calling thread, the Profiler track
+ * name; affinity and priority change only for configured roles.
+ * Failures (e.g. SCHED_FIFO without CAP_SYS_NICE or rtprio limits) are
+ * logged and reported, and leave the thread running as it was.
+ *
+ * Configuration text, one role per line (`#` starts a comment):
+ * @code
+ *   SoapySdr.stream   cpus=2 priority=80
+ *   SdrEngine.*       numa=0
+ *   DataHandler.*     cpus=4-7,12
+ * @endcode
+ *
+ * Thread-safety: all methods may be called from any thread.  Settings
+ * changed later apply to threads started (or re-applied) afterwards.
+ */
+class ThreadConfig
+{
+public:
+   /** @brief Get the process-wide configuration (empty until set or loaded). */
+   [[nodiscard]] static ThreadConfig& instance();
+
+   /**
+    * @brief Configure a role (or `prefix*` pattern), replacing any entry.
+    * @param role      Role or pattern.
+    * @param settings  Settings for matching threads.
+    */
+   void set(std::string role, ThreadSettings settings);
+
+   /** @brief Remove every entry. */
+   void clear();
+
+   /**
+    * @brief Look up the settings that apply to a role.
+    * @param role  Thread role.
+    * @return Matching settings, or nullopt if unconfigured.
+    */
+   [[nodiscard]] std::optional<ThreadSettings> settingsFor(const std::string& role) const;
+
+   /**
+    * @brief Add the entries of configuration text (see class description).
+    * Nothing is added if any line is malformed.
+    * @param text   Configuration text.
+    * @param error  Set to a description of the first bad line on failure.
+    * @return false on a malformed line.
+    */
+   bool load(const std::string& text, std::string* error = nullptr);
+
+   /**
+    * @brief Add the entries of a configuration file.
+    * @param path   File to read.
+    * @param error  Set to a description of the failure.
+    * @return false if the file cannot be read or is malformed.
+    */
+   bool loadFile(const std::string& path, std::string* error = nullptr);
+
+   /**
+    * @brief Name the calling thread and apply its role's settings.
+    * @param role  Thread role.
+    * @return false if pinning or priority could not be applied.
+    */
+   bool applyToCurrentThread(const std::string& role) const;
+
+   /**
+    * @brief Name a running thread and apply its role's settings.
+    * @param thread  Thread to configure (must be joinable).
+    * @param role    Thread role.
+    * @return false if pinning or priority could not be applied.
+    */
+   bool apply(std::thread& thread, const std::string& role) const;
+
+private:
+   ThreadConfig() = default;
+
+   mutable std::mutex _mutex;
+   std::vector<std::pair<std::string, ThreadSettings>> _entries;
+};
+
+/**
+ * @brief Shorthand for ThreadConfig::instance().applyToCurrentThread(role),
+ *        called first thing in a thread's entry function.
+ * @param role  Thread role.
+ * @return false if pinning or priority could not be applied.
+ */
+inline bool configureCurrentThread(const std::string& role)
+{
+   return ThreadConfig::instance().applyToCurrentThread(role);
+}
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_THREADCONFIG_H_
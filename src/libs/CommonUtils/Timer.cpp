@@ -3,18 +3,30 @@
 namespace CommonUtils
 {
 
-Timer::Timer() : _isRunning(false)
+Timer::Timer(TimerWheel* wheel) : _isRunning(false), _wheel(wheel)
 {
 
 }
 
 void Timer::startOneShot(const std::function<void ()> &func, unsigned int interval)
 {
-    if (_isRunning)
+    if (_isRunning || _wheelTimer != TimerWheel::INVALID_TIMER)
     {
         stop();
     }
     _isRunning = true;
+    if (_wheel != nullptr)
+    {
+        _wheelTimer = _wheel->schedule(std::chrono::milliseconds(interval), [this, func]()
+        {
+            if (_isRunning)
+            {
+                func();
+            }
+            _isRunning = false;
+        });
+        return;
+    }
     _thread = std::thread([this, func, interval]()
     {
         std::unique_lock<std::mutex> lock(_mutex);
@@ -32,11 +44,17 @@ void Timer::startOneShot(const std::function<void ()> &func, unsigned int interv
 
 void Timer::startPeriodic(const std::function<void ()> &func, unsigned int interval)
 {
-    if (_isRunning)
+    if (_isRunning || _wheelTimer != TimerWheel::INVALID_TIMER)
     {
         stop();
     }
     _isRunning = true;
+    if (_wheel != nullptr)
+    {
+        _wheelTimer = _wheel->schedule(std::chrono::milliseconds(interval), func,
+                                       std::chrono::milliseconds(interval));
+        return;
+    }
     _thread = std::thread([this, func, interval]()
     {
         while (_isRunning)
@@ -61,6 +79,12 @@ void Timer::stop()
         _isRunning = false;
     }
 
+    if (_wheelTimer != TimerWheel::INVALID_TIMER)
+    {
+        _wheel->cancel(_wheelTimer);
+        _wheelTimer = TimerWheel::INVALID_TIMER;
+    }
+
     _cv.notify_all();
     if (_thread.joinable())
     {
@@ -8,6 +8,9 @@
 #include <mutex>
 #include <thread>
 
+// Project headers
+#include "TimerWheel.h"
+
 namespace CommonUtils
 {
 
@@ -16,14 +19,20 @@ namespace CommonUtils
  * @brief Simple timer that can execute a function after a specified amount
  *        of time, or periodically.  Designed for easy cancellation and
  *        destruction.
+ *
+ * By default each running timer owns a thread.  Constructed with a
+ * TimerWheel, it registers there instead and owns no thread.
  */
 class Timer
 {
 public:
    /**
     * @brief Construct a cancelable timer.
+    *
+    * @param wheel  Wheel to run on (e.g. &TimerWheel::shared()); must
+    *               outlive the timer.  nullptr: use a thread per start.
     */
-   Timer();
+   explicit Timer(TimerWheel* wheel = nullptr);
 
    /**
     * @brief Destroy the timer, cancelling any pending operation.
@@ -60,6 +69,8 @@ private:
    std::thread _thread;
    std::mutex _mutex;
    std::condition_variable _cv;
+   TimerWheel* _wheel;
+   TimerWheel::TimerId _wheelTimer{TimerWheel::INVALID_TIMER};
 };
 
 } // namespace CommonUtils
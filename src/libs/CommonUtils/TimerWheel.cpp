@@ -0,0 +1,395 @@
+#include "TimerWheel.h"
+#include "TaskPool.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace CommonUtils
+{
+
+namespace
+{
+
+constexpr std::uint64_t NO_EVENT = std::numeric_limits<std::uint64_t>::max();
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, std::size_t callbackThreads)
+   : _tick(std::max(tick, std::chrono::milliseconds(1)))
+   , _epoch(std::chrono::steady_clock::now())
+   , _wakeTick(NO_EVENT)
+{
+   if (callbackThreads > 0)
+   {
+      _pool = std::make_unique<TaskPool>(callbackThreads);
+   }
+   _thread = std::thread(&TimerWheel::wheelLoop, this);
+}
+
+TimerWheel::~TimerWheel()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+      for (auto& [id, entry] : _entries)
+      {
+         moveTo(*entry, _idle);
+         entry->cancelled = true;
+      }
+   }
+   _wake.notify_all();
+   if (_thread.joinable())
+   {
+      _thread.join();
+   }
+   // Runs (and skips) callbacks still queued, and waits for running ones.
+   _pool.reset();
+}
+
+TimerWheel& TimerWheel::shared()
+{
+   static TimerWheel wheel;
+   return wheel;
+}
+
+// ============================================================================
+// Timer management
+// ============================================================================
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, Callback callback,
+                                         std::chrono::milliseconds period)
+{
+   bool wake = false;
+   TimerId id = INVALID_TIMER;
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      auto entry      = std::make_shared<Entry>();
+      entry->id       = ++_nextId;
+      entry->callback = std::move(callback);
+      entry->period   = periodTicks(period);
+      entry->node     = _idle.insert(_idle.end(), entry.get());
+      entry->slot     = &_idle;
+
+      catchUpIfIdle();
+      entry->expiry = ticksFromNow(delay);
+      file(*entry);
+      wake = entry->expiry < _wakeTick;
+      id   = entry->id;
+      _entries.emplace(id, std::move(entry));
+   }
+   if (wake)
+   {
+      _wake.notify_one();
+   }
+   return id;
+}
+
+bool TimerWheel::reschedule(TimerId id, std::chrono::milliseconds delay)
+{
+   bool wake = false;
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      const auto it = _entries.find(id);
+      if (it == _entries.end())
+      {
+         return false;
+      }
+      Entry& entry = *it->second;
+      catchUpIfIdle();
+      entry.expiry = ticksFromNow(delay);
+      file(entry);
+      wake = entry.expiry < _wakeTick;
+   }
+   if (wake)
+   {
+      _wake.notify_one();
+   }
+   return true;
+}
+
+bool TimerWheel::setPeriod(TimerId id, std::chrono::milliseconds period)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = _entries.find(id);
+   if (it == _entries.end())
+   {
+      return false;
+   }
+   it->second->period = periodTicks(period);
+   return true;
+}
+
+bool TimerWheel::disarm(TimerId id)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto it = _entries.find(id);
+   if (it == _entries.end())
+   {
+      return false;
+   }
+   moveTo(*it->second, _idle);
+   return true;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+   std::unique_lock<std::mutex> lock(_mutex);
+   const auto it = _entries.find(id);
+   if (it == _entries.end())
+   {
+      return false;
+   }
+   const std::shared_ptr<Entry> entry = it->second;
+   _entries.erase(it);
+   moveTo(*entry, _idle);
+   _idle.erase(entry->node);
+   entry->slot      = nullptr;
+   entry->cancelled = true;
+
+   // A callback cancelling its own timer must not wait for itself.
+   if (entry->runner != std::this_thread::get_id())
+   {
+      _finished.wait(lock, [&entry] { return entry->running == 0; });
+   }
+   return true;
+}
+
+std::size_t TimerWheel::timerCount() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _entries.size();
+}
+
+// ============================================================================
+// Wheel internals (called with _mutex held)
+// ============================================================================
+
+std::uint64_t TimerWheel::tickAt(std::chrono::steady_clock::time_point time) const
+{
+   if (time <= _epoch)
+   {
+      return 0;
+   }
+   return static_cast<std::uint64_t>((time - _epoch) / _tick);
+}
+
+std::chrono::steady_clock::time_point TimerWheel::timeOf(std::uint64_t tick) const
+{
+   return _epoch + (_tick * static_cast<std::int64_t>(tick));
+}
+
+std::uint64_t TimerWheel::periodTicks(std::chrono::milliseconds period) const
+{
+   // Round up; a zero period stays zero (one-shot).
+   return (period.count() > 0) ? static_cast<std::uint64_t>((period + _tick - std::chrono::milliseconds(1)) / _tick) : 0;
+}
+
+std::uint64_t TimerWheel::ticksFromNow(std::chrono::milliseconds delay) const
+{
+   // Round up, and never into a tick that has already been processed.
+   const auto due = std::chrono::steady_clock::now() + std::max(delay, std::chrono::milliseconds(0)) - _epoch;
+   const auto ticks = static_cast<std::uint64_t>((due + _tick - std::chrono::nanoseconds(1)) / _tick);
+   return std::max(ticks, _currentTick + 1);
+}
+
+void TimerWheel::catchUpIfIdle()
+{
+   // With nothing armed the wheel thread sleeps without advancing; jump
+   // straight to now rather than stepping through every skipped tick.
+   if (_armed == 0)
+   {
+      _currentTick = std::max(_currentTick, tickAt(std::chrono::steady_clock::now()));
+   }
+}
+
+void TimerWheel::moveTo(Entry& entry, Slot& slot)
+{
+   const bool wasArmed = (entry.slot != &_idle);
+   const bool nowArmed = (&slot != &_idle);
+   slot.splice(slot.end(), *entry.slot, entry.node);
+   entry.slot = &slot;
+   if (wasArmed != nowArmed)
+   {
+      _armed = nowArmed ? _armed + 1 : _armed - 1;
+   }
+}
+
+void TimerWheel::file(Entry& entry)
+{
+   const std::uint64_t delta = entry.expiry - _currentTick;
+   if (delta < LEVEL0_SLOTS)
+   {
+      moveTo(entry, _level0[entry.expiry & (LEVEL0_SLOTS - 1)]);
+      return;
+   }
+   for (std::size_t level = 0; level < UPPER_LEVELS; ++level)
+   {
+      const std::size_t shift = LEVEL0_BITS + (LEVELN_BITS * level);
+      if (delta < (std::uint64_t{LEVELN_SLOTS} << shift))
+      {
+         moveTo(entry, _upper[level][(entry.expiry >> shift) & (LEVELN_SLOTS - 1)]);
+         return;
+      }
+   }
+   // Beyond the top level: park in its furthest slot and re-file from there.
+   const std::size_t topShift = LEVEL0_BITS + (LEVELN_BITS * (UPPER_LEVELS - 1));
+   const std::uint64_t parked = _currentTick + (std::uint64_t{LEVELN_SLOTS} << topShift) - 1;
+   moveTo(entry, _upper[UPPER_LEVELS - 1][(parked >> topShift) & (LEVELN_SLOTS - 1)]);
+}
+
+void TimerWheel::cascade(std::size_t level)
+{
+   const std::size_t shift = LEVEL0_BITS + (LEVELN_BITS * level);
+   Slot& slot = _upper[level][(_currentTick >> shift) & (LEVELN_SLOTS - 1)];
+   Slot pending;
+   pending.splice(pending.end(), slot);
+   for (Entry* entry : pending)
+   {
+      entry->slot = &pending;
+   }
+   while (!pending.empty())
+   {
+      file(*pending.front());
+   }
+}
+
+std::uint64_t TimerWheel::nextEventTick() const
+{
+   if (_armed == 0)
+   {
+      return NO_EVENT;
+   }
+   // The next occupied first-level slot before the wrap, else the wrap
+   // itself (where the next cascade happens).
+   const std::uint64_t wrap = (_currentTick | (LEVEL0_SLOTS - 1)) + 1;
+   for (std::uint64_t tick = _currentTick + 1; tick < wrap; ++tick)
+   {
+      if (!_level0[tick & (LEVEL0_SLOTS - 1)].empty())
+      {
+         return tick;
+      }
+   }
+   return wrap;
+}
+
+void TimerWheel::advanceTo(std::uint64_t target, Due& due)
+{
+   catchUpIfIdle();
+   while (_currentTick < target)
+   {
+      ++_currentTick;
+      if ((_currentTick & (LEVEL0_SLOTS - 1)) == 0)
+      {
+         // Higher levels move down only when the level below wraps too.
+         for (std::size_t level = 0; level < UPPER_LEVELS; ++level)
+         {
+            cascade(level);
+            const std::size_t shift = LEVEL0_BITS + (LEVELN_BITS * level);
+            if (((_currentTick >> shift) & (LEVELN_SLOTS - 1)) != 0)
+            {
+               break;
+            }
+         }
+      }
+
+      Slot& slot = _level0[_currentTick & (LEVEL0_SLOTS - 1)];
+      while (!slot.empty())
+      {
+         Entry& entry = *slot.front();
+         if (entry.period > 0)
+         {
+            entry.expiry = _currentTick + entry.period;
+            file(entry);
+         }
+         else
+         {
+            moveTo(entry, _idle);
+         }
+         // A callback still running or queued from an earlier call is not
+         // started again; that call is skipped.
+         if (entry.running == 0 && !entry.queued)
+         {
+            entry.queued = true;
+            due.push_back(_entries.at(entry.id));
+         }
+      }
+   }
+}
+
+// ============================================================================
+// Wheel thread
+// ============================================================================
+
+void TimerWheel::runOne(const std::shared_ptr<Entry>& entry)
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      entry->queued = false;
+      if (entry->cancelled)
+      {
+         return;
+      }
+      ++entry->running;
+      entry->runner = std::this_thread::get_id();
+   }
+   entry->callback();
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      --entry->running;
+      entry->runner = std::thread::id{};
+   }
+   _finished.notify_all();
+}
+
+void TimerWheel::run(const Due& due)
+{
+   for (const auto& entry : due)
+   {
+      if (_pool)
+      {
+         _pool->post([this, entry] { runOne(entry); });
+      }
+      else
+      {
+         runOne(entry);
+      }
+   }
+}
+
+void TimerWheel::wheelLoop()
+{
+   configureCurrentThread("TimerWheel");
+   std::unique_lock<std::mutex> lock(_mutex);
+   while (!_stopping)
+   {
+      Due due;
+      advanceTo(tickAt(std::chrono::steady_clock::now()), due);
+      if (!due.empty())
+      {
+         _wakeTick = _currentTick;
+         lock.unlock();
+         run(due);
+         lock.lock();
+         continue;
+      }
+
+      _wakeTick = nextEventTick();
+      if (_wakeTick == NO_EVENT)
+      {
+         _wake.wait(lock);
+      }
+      else
+      {
+         _wake.wait_until(lock, timeOf(_wakeTick));
+      }
+   }
+}
+
+} // namespace CommonUtils
@@ -0,0 +1,190 @@
+#ifndef COMMONUTILS_TIMERWHEEL_H_
+#define COMMONUTILS_TIMERWHEEL_H_
+
+// System headers
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace CommonUtils
+{
+
+class TaskPool;
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel that runs any number of one-shot and
+ *        periodic timers from one thread.
+ *
+ * Time advances in ticks (default 1 ms).  Timers due within 256 ticks sit
+ * in the 256 slots of the first level; later ones sit in one of four
+ * 64-slot levels, each covering 64 times the span of the level below, and
+ * move down a level as their slot comes round (about 18.6 hours ahead at a
+ * 1 ms tick; anything further is parked on the top level and re-filed).
+ * schedule(), reschedule() and cancel() unlink and relink one list node —
+ * O(1) and allocation-free apart from schedule().
+ *
+ * The wheel thread sleeps until the next occupied first-level slot (or
+ * the next cascade), so idle timers cost no wake-ups.  Callbacks run on
+ * the wheel thread, or on an owned TaskPool when constructed with
+ * `callbackThreads > 0`; they should be short and must not throw.
+ *
+ * A timer stays registered after a one-shot fires (idle, ready for
+ * reschedule()) until cancel().
+ *
+ * Thread-safety: all methods may be called from any thread, including
+ * from a timer callback.
+ */
+class TimerWheel
+{
+public:
+   using TimerId  = std::uint64_t;
+   using Callback = std::function<void()>;
+
+   /** @brief Never returned by schedule(). */
+   static constexpr TimerId INVALID_TIMER = 0;
+
+   /**
+    * @brief Start the wheel thread.
+    * @param tick             Timer resolution (at least 1 ms).
+    * @param callbackThreads  0: run callbacks on the wheel thread;
+    *                         otherwise on a TaskPool of this many threads.
+    */
+   explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(1),
+                       std::size_t callbackThreads = 0);
+
+   /** @brief Cancel every timer, wait for running callbacks and stop. */
+   ~TimerWheel();
+
+   // Non-copyable, non-movable (the wheel thread holds `this`).
+   TimerWheel(const TimerWheel&) = delete;
+   TimerWheel& operator=(const TimerWheel&) = delete;
+   TimerWheel(TimerWheel&&) = delete;
+   TimerWheel& operator=(TimerWheel&&) = delete;
+
+   /**
+    * @brief Register a timer.
+    * @param delay     Time until the first call (rounded up to whole ticks).
+    * @param callback  Function to call.
+    * @param period    Interval between later calls; zero for a one-shot.
+    * @return ID for reschedule() / cancel().
+    */
+   TimerId schedule(std::chrono::milliseconds delay, Callback callback,
+                    std::chrono::milliseconds period = std::chrono::milliseconds(0));
+
+   /**
+    * @brief Move a timer's next call to `delay` from now, whether it is
+    *        pending, idle after a one-shot, or running.  O(1).
+    * @param id     Timer to move.
+    * @param delay  Time until the next call.
+    * @return false if `id` is not registered.
+    */
+   bool reschedule(TimerId id, std::chrono::milliseconds delay);
+
+   /**
+    * @brief Change a timer's period (zero: one-shot), effective after its
+    *        next call.
+    * @return false if `id` is not registered.
+    */
+   bool setPeriod(TimerId id, std::chrono::milliseconds period);
+
+   /**
+    * @brief Stop calls to a timer without unregistering it; reschedule()
+    *        arms it again.
+    * @return false if `id` is not registered.
+    */
+   bool disarm(TimerId id);
+
+   /**
+    * @brief Unregister a timer.  Waits for its callback if it is running
+    *        on another thread.
+    * @return false if `id` is not registered.
+    */
+   bool cancel(TimerId id);
+
+   /**
+    * @brief Get the number of registered timers.
+    * @return Armed plus idle timers.
+    */
+   [[nodiscard]] std::size_t timerCount() const;
+
+   /**
+    * @brief Get the process-wide wheel (1 ms tick, callbacks on its own
+    *        thread), started on first use.
+    * @return Shared wheel.
+    */
+   [[nodiscard]] static TimerWheel& shared();
+
+private:
+   static constexpr std::size_t LEVEL0_BITS  = 8;
+   static constexpr std::size_t LEVELN_BITS  = 6;
+   static constexpr std::size_t LEVEL0_SLOTS = std::size_t{1} << LEVEL0_BITS;
+   static constexpr std::size_t LEVELN_SLOTS = std::size_t{1} << LEVELN_BITS;
+   static constexpr std::size_t UPPER_LEVELS = 4;
+
+   struct Entry;
+   using Slot = std::list<Entry*>;
+
+   struct Entry
+   {
+      TimerId id{INVALID_TIMER};
+      Callback callback;
+      std::uint64_t expiry{0};       // Absolute tick of the next call.
+      std::uint64_t period{0};       // Ticks; 0 = one-shot.
+      Slot* slot{nullptr};           // Slot holding `node`, or &_idle.
+      Slot::iterator node;
+      int running{0};                // Callbacks in progress.
+      bool queued{false};            // Due, waiting for runOne().
+      bool cancelled{false};
+      std::thread::id runner;        // Thread of the running callback.
+   };
+
+   using Due = std::vector<std::shared_ptr<Entry>>;
+
+   [[nodiscard]] std::uint64_t periodTicks(std::chrono::milliseconds period) const;
+   [[nodiscard]] std::uint64_t ticksFromNow(std::chrono::milliseconds delay) const;
+   [[nodiscard]] std::uint64_t tickAt(std::chrono::steady_clock::time_point time) const;
+   [[nodiscard]] std::chrono::steady_clock::time_point timeOf(std::uint64_t tick) const;
+   [[nodiscard]] std::uint64_t nextEventTick() const;
+   void catchUpIfIdle();
+
+   void file(Entry& entry);
+   void moveTo(Entry& entry, Slot& slot);
+   void cascade(std::size_t level);
+   void advanceTo(std::uint64_t tick, Due& due);
+   void run(const Due& due);
+   void runOne(const std::shared_ptr<Entry>& entry);
+   void wheelLoop();
+
+   const std::chrono::milliseconds _tick;
+   const std::chrono::steady_clock::time_point _epoch;
+
+   mutable std::mutex _mutex;
+   std::condition_variable _wake;      // Wheel thread: earlier timer or stop.
+   std::condition_variable _finished;  // cancel(): a callback returned.
+   std::array<Slot, LEVEL0_SLOTS> _level0;
+   std::array<std::array<Slot, LEVELN_SLOTS>, UPPER_LEVELS> _upper;
+   Slot _idle;                         // Registered but not armed.
+   std::size_t _armed{0};              // Entries in a wheel slot.
+   std::unordered_map<TimerId, std::shared_ptr<Entry>> _entries;
+   std::uint64_t _currentTick{0};     // Last tick processed.
+   std::uint64_t _wakeTick{0};        // Tick the wheel thread sleeps until.
+   TimerId _nextId{INVALID_TIMER};
+   bool _stopping{false};
+
+   std::unique_ptr<TaskPool> _pool;
+   std::thread _thread;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_TIMERWHEEL_H_
@@ -0,0 +1,101 @@
+#include "WorkerPool.h"
+#include "ThreadConfig.h"
+
+namespace CommonUtils
+{
+
+WorkerPool::WorkerPool(std::size_t workers)
+{
+   _threads.reserve(workers);
+   for (std::size_t i = 0; i < workers; ++i)
+   {
+      _threads.emplace_back(&WorkerPool::workerLoop, this);
+   }
+}
+
+WorkerPool::~WorkerPool()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+   }
+   _work.notify_all();
+   for (auto& thread : _threads)
+   {
+      thread.join();
+   }
+}
+
+void WorkerPool::run(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   if (_threads.empty() || count == 1)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         task(i);
+      }
+      return;
+   }
+
+   const std::lock_guard<std::mutex> runLock(_runMutex);
+   std::unique_lock<std::mutex> lock(_mutex);
+   _task      = &task;
+   _count     = count;
+   _next      = 0;
+   _remaining = count;
+   _work.notify_all();
+
+   // The caller works too, then waits for tasks still running elsewhere.
+   drainLocked(lock);
+   _done.wait(lock, [this] { return _remaining == 0; });
+   _task  = nullptr;
+   _count = 0;
+}
+
+std::size_t WorkerPool::workerCount() const
+{
+   return _threads.size();
+}
+
+std::size_t WorkerPool::defaultWorkerCount()
+{
+   const unsigned int hardware = std::thread::hardware_concurrency();
+   return (hardware > 1) ? hardware - 1 : 0;
+}
+
+void WorkerPool::workerLoop()
+{
+   configureCurrentThread("WorkerPool");
+   std::unique_lock<std::mutex> lock(_mutex);
+   while (true)
+   {
+      _work.wait(lock, [this] { return _stopping || _next < _count; });
+      if (_stopping)
+      {
+         return;
+      }
+      drainLocked(lock);
+   }
+}
+
+void WorkerPool::drainLocked(std::unique_lock<std::mutex>& lock)
+{
+   while (_next < _count)
+   {
+      const std::size_t index = _next++;
+      const auto* task        = _task;
+      lock.unlock();
+      (*task)(index);
+      lock.lock();
+      if (--_remaining == 0)
+      {
+         _done.notify_all();
+      }
+   }
+}
+
+} // namespace CommonUtils
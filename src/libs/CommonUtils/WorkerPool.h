@@ -0,0 +1,87 @@
+#ifndef COMMONUTILS_WORKERPOOL_H_
+#define COMMONUTILS_WORKERPOOL_H_
+
+// System headers
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CommonUtils
+{
+
+/**
+ * @class WorkerPool
+ * @brief Fixed set of worker threads for fork-join parallel loops.
+ *
+ * `run(count, task)` calls `task(0) .. task(count - 1)` spread over the
+ * workers and the calling thread, and returns once every call finished.
+ * Workers sleep on a condition variable between runs.  A pool with zero
+ * workers runs everything inline on the caller.
+ *
+ * Tasks must not throw.
+ *
+ * Thread-safety: concurrent run() calls are serialised.
+ */
+class WorkerPool
+{
+public:
+   /**
+    * @brief Start `workers` worker threads.
+    * @param workers  Number of threads besides the caller (0 = inline).
+    */
+   explicit WorkerPool(std::size_t workers);
+
+   /** @brief Stop and join every worker. */
+   ~WorkerPool();
+
+   // Non-copyable, non-movable (workers hold `this`).
+   WorkerPool(const WorkerPool&) = delete;
+   WorkerPool& operator=(const WorkerPool&) = delete;
+   WorkerPool(WorkerPool&&) = delete;
+   WorkerPool& operator=(WorkerPool&&) = delete;
+
+   /**
+    * @brief Run `task(i)` for every i in [0, count) and wait for all of them.
+    * @param count  Number of task invocations.
+    * @param task   Invoked once per index, possibly concurrently.
+    */
+   void run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+   /**
+    * @brief Get the number of worker threads.
+    * @return Worker threads, excluding the caller of run().
+    */
+   [[nodiscard]] std::size_t workerCount() const;
+
+   /**
+    * @brief Worker count that, with the caller, uses every hardware thread.
+    * @return `hardware_concurrency() - 1`, or 0 if unknown.
+    */
+   [[nodiscard]] static std::size_t defaultWorkerCount();
+
+private:
+   void workerLoop();
+
+   // Claim and run tasks until none are left.  Called with `lock` held.
+   void drainLocked(std::unique_lock<std::mutex>& lock);
+
+   std::mutex _runMutex;   // Serialises run() callers.
+   std::mutex _mutex;
+   std::condition_variable _work;
+   std::condition_variable _done;
+
+   const std::function<void(std::size_t)>* _task{nullptr};
+   std::size_t _count{0};       ///< Tasks in the current run.
+   std::size_t _next{0};        ///< Next unclaimed task index.
+   std::size_t _remaining{0};   ///< Tasks not yet finished.
+   bool _stopping{false};
+
+   std::vector<std::thread> _threads;
+};
+
+} // namespace CommonUtils
+
+#endif // COMMONUTILS_WORKERPOOL_H_
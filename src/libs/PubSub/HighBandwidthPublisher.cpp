@@ -1,19 +1,56 @@
 #include "HighBandwidthPublisher.h"
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <netinet/udp.h>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <vector>
 
 #include "GeneralLogger.h"
+#include "ThreadConfig.h"
+
+namespace
+{
+
+// Per-thread send scratch, reused so publishing does not allocate per fragment.
+struct SendScratch
+{
+    std::vector<uint8_t> serialized;      ///< Serialized message; keeps its size between calls
+    std::vector<FragmentHeader> headers;
+    std::vector<iovec> iovecs;            ///< Fragment f uses [iovecStart[f], iovecStart[f + 1])
+    std::vector<size_t> iovecStart;
+    std::vector<mmsghdr> messages;
+    std::vector<size_t> firstFragment;    ///< First fragment carried by messages[i]
+    std::vector<size_t> messageBytes;     ///< UDP payload bytes of messages[i]
+    std::vector<uint8_t> parity;          ///< XOR parity bodies, one max-payload slot per group
+    std::vector<size_t> parityLength;     ///< Longest fragment body of each group
+    std::vector<uint16_t> lengthXor;      ///< XOR of each group's fragment body lengths
+};
+
+thread_local SendScratch t_scratch;
+
+// Send errors that mean the kernel or route cannot segment for us.
+bool isGsoError(int error)
+{
+    return error == EIO || error == EINVAL || error == EMSGSIZE || error == EOPNOTSUPP;
+}
+
+} // anonymous namespace
+
 HighBandwidthPublisher::HighBandwidthPublisher(const std::string &name,
                                                const std::string &multicastAddr,
                                                uint16_t port,
                                                size_t mtu,
                                                const std::string &interfaceAddr) :
     _name(name),
+    _topicPrefix(name + "/"),
     _port(port),
     _mtu(mtu),
     _maxPayloadPerFragment(mtu - sizeof(FragmentHeader))
@@ -71,14 +108,29 @@ HighBandwidthPublisher::HighBandwidthPublisher(const std::string &name,
         }
     }
 
-    GPINFO("HighBandwidthPublisher created with name '{}' publishing to {}:{} (MTU: {}, max payload/fragment: {})",
-           name, multicastAddr, port, mtu, _maxPayloadPerFragment);
+#ifdef UDP_SEGMENT
+    // Let the kernel split runs of full-MTU fragments (Linux 4.18+).
+    _gsoSegments = std::min(MAX_GSO_SEGMENTS, MAX_UDP_PAYLOAD / _mtu);
+    const int gsoSize = static_cast<int>(_mtu);
+    if (_gsoSegments > 1 &&
+        setsockopt(_socket, SOL_UDP, UDP_SEGMENT, &gsoSize, sizeof(gsoSize)) == 0)
+    {
+        _gsoEnabled.store(true);
+    }
+#endif
+
+    GPINFO("HighBandwidthPublisher created with name '{}' publishing to {}:{} (MTU: {}, max payload/fragment: {}, GSO: {})",
+           name, multicastAddr, port, mtu, _maxPayloadPerFragment, gsoEnabled() ? "on" : "off");
     _running.store(true);
 }
 
 HighBandwidthPublisher::~HighBandwidthPublisher()
 {
     _running.store(false);
+    if (_nackThread.joinable())
+    {
+        _nackThread.join();
+    }
     if (_socket >= 0)
     {
         close(_socket);
@@ -93,93 +145,485 @@ bool HighBandwidthPublisher::publish(const std::string &topic,
         return false;
     }
 
-    // Serialize the protobuf message
-    std::string serialized;
-    if (!message.SerializeToString(&serialized))
+    // Serialize the protobuf message into the reused per-thread buffer
+    const size_t size = message.ByteSizeLong();
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        GPERROR("Message too large to serialize: {} bytes", size);
+        return false;
+    }
+    std::vector<uint8_t> &serialized = t_scratch.serialized;
+    if (serialized.size() < size)
+    {
+        serialized.resize(size);
+    }
+    if (!message.SerializeToArray(serialized.data(), static_cast<int>(size)))
     {
         GPERROR("Failed to serialize protobuf message");
         return false;
     }
 
-    // Create namespaced topic
-    std::string namespacedTopic = _name + "/" + topic;
+    return sendFragments(topic, serialized.data(), size);
+}
 
-    // Calculate total data size: topic (in first fragment) + serialized message
+bool HighBandwidthPublisher::sendFragments(std::string_view topic, const uint8_t *payload, size_t size)
+{
     // First fragment: [header][topic][payload_start]
     // Other fragments: [header][payload_continuation]
-    const size_t topicSize = namespacedTopic.size();
-    const size_t totalPayloadSize = serialized.size();
-    
-    // Calculate number of fragments needed
-    // First fragment has less payload space due to topic
+    // Every fragment but the last is therefore exactly _mtu bytes.
+    // The namespaced topic goes out as two iovecs: cached prefix + topic.
+    const size_t topicSize = _topicPrefix.size() + topic.size();
     const size_t firstFragPayloadSpace = _maxPayloadPerFragment - topicSize;
     size_t numFragmentsCalc = 1;
-    
-    if (totalPayloadSize > firstFragPayloadSpace)
+
+    if (size > firstFragPayloadSpace)
     {
-        const size_t remaining = totalPayloadSize - firstFragPayloadSpace;
+        const size_t remaining = size - firstFragPayloadSpace;
         numFragmentsCalc += (remaining + _maxPayloadPerFragment - 1) / _maxPayloadPerFragment;
     }
 
     if (numFragmentsCalc > 65535)
     {
         GPERROR("Message too large: would require {} fragments", numFragmentsCalc);
+        _sendFailures.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
 
     const auto numFragments = static_cast<std::uint16_t>(numFragmentsCalc);
+    const size_t groupSize = (numFragments > 1) ? fecGroupSize() : 0;
+    const size_t numGroups = (groupSize > 0) ? (numFragments + groupSize - 1) / groupSize : 0;
+    const size_t numDatagrams = numFragments + numGroups;
 
     // Get unique message ID
     const uint32_t messageId = _messageIdCounter.fetch_add(1);
+    if (_historyCapacity.load(std::memory_order_relaxed) > 0)
+    {
+        recordHistory(messageId, topic, payload, size, numFragments, static_cast<uint16_t>(groupSize));
+    }
 
-    // Send fragments
-    std::vector<uint8_t> packet(_mtu);
+    // Describe every fragment as iovecs into the header array, topic and
+    // payload; nothing is copied.
+    SendScratch &scratch = t_scratch;
+    scratch.headers.resize(numDatagrams);
+    scratch.iovecs.clear();
+    scratch.iovecStart.clear();
     size_t payloadOffset = 0;
 
     for (std::uint16_t fragNum = 0; fragNum < numFragments; ++fragNum)
     {
-        auto* header = reinterpret_cast<FragmentHeader*>(packet.data());
-        header->messageId = messageId;
-        header->fragmentNum = fragNum;
-        header->totalFragments = numFragments;
-        header->topicLen = (fragNum == 0) ? static_cast<uint16_t>(topicSize) : 0;
-        header->reserved = 0;
+        FragmentHeader &header = scratch.headers[fragNum];
+        header.messageId = messageId;
+        header.fragmentNum = fragNum;
+        header.totalFragments = numFragments;
+        header.topicLen = (fragNum == 0 || groupSize > 0) ? static_cast<uint16_t>(topicSize) : 0;
+        header.fec = static_cast<uint16_t>(groupSize);
 
-        size_t packetDataOffset = sizeof(FragmentHeader);
-        size_t bytesToSend = 0;
+        scratch.iovecStart.push_back(scratch.iovecs.size());
+        scratch.iovecs.push_back({&header, sizeof(FragmentHeader)});
 
+        size_t payloadInThisFrag = std::min(size - payloadOffset, _maxPayloadPerFragment);
         if (fragNum == 0)
         {
             // First fragment: include topic
-            memcpy(packet.data() + packetDataOffset, namespacedTopic.data(), topicSize);
-            packetDataOffset += topicSize;
-            
-            // Add as much payload as fits
-            const size_t payloadInFirstFrag = std::min(totalPayloadSize, firstFragPayloadSpace);
-            memcpy(packet.data() + packetDataOffset, serialized.data(), payloadInFirstFrag);
-            bytesToSend = sizeof(FragmentHeader) + topicSize + payloadInFirstFrag;
-            payloadOffset = payloadInFirstFrag;
+            payloadInThisFrag = std::min(size, firstFragPayloadSpace);
+            scratch.iovecs.push_back({_topicPrefix.data(), _topicPrefix.size()});
+            if (!topic.empty())
+            {
+                scratch.iovecs.push_back({const_cast<char*>(topic.data()), topic.size()});
+            }
         }
-        else
+        if (payloadInThisFrag > 0)
+        {
+            scratch.iovecs.push_back({const_cast<uint8_t*>(payload + payloadOffset), payloadInThisFrag});
+        }
+        payloadOffset += payloadInThisFrag;
+    }
+    if (numGroups > 0)
+    {
+        addParityFragments(messageId, numFragments, groupSize, numGroups);
+    }
+    scratch.iovecStart.push_back(scratch.iovecs.size());
+
+    size_t nextFragment = 0;
+    size_t sentBytes = 0;
+    while (nextFragment < numDatagrams)
+    {
+        // One datagram per fragment, or with GSO one super-datagram per
+        // run of up to _gsoSegments fragments.  A run never spans the
+        // short last data fragment and the parity fragments after it.
+        const size_t perMessage = gsoEnabled() ? _gsoSegments : 1;
+        scratch.messages.clear();
+        scratch.firstFragment.clear();
+        scratch.messageBytes.clear();
+        for (size_t first = nextFragment; first < numDatagrams;)
         {
-            // Subsequent fragments: only payload
-            const size_t remainingPayload = totalPayloadSize - payloadOffset;
-            const size_t payloadInThisFrag = std::min(remainingPayload, _maxPayloadPerFragment);
-            memcpy(packet.data() + packetDataOffset, serialized.data() + payloadOffset, payloadInThisFrag);
-            bytesToSend = sizeof(FragmentHeader) + payloadInThisFrag;
-            payloadOffset += payloadInThisFrag;
+            const size_t runLimit = (first < numFragments) ? numFragments : numDatagrams;
+            const size_t end = std::min(first + perMessage, runLimit);
+            mmsghdr message{};
+            message.msg_hdr.msg_name = &_multicastAddr;
+            message.msg_hdr.msg_namelen = sizeof(_multicastAddr);
+            message.msg_hdr.msg_iov = &scratch.iovecs[scratch.iovecStart[first]];
+            message.msg_hdr.msg_iovlen = scratch.iovecStart[end] - scratch.iovecStart[first];
+            scratch.messages.push_back(message);
+            scratch.firstFragment.push_back(first);
+            size_t bytes = 0;
+            for (size_t i = scratch.iovecStart[first]; i < scratch.iovecStart[end]; ++i)
+            {
+                bytes += scratch.iovecs[i].iov_len;
+            }
+            scratch.messageBytes.push_back(bytes);
+            first = end;
         }
 
-        // Send the packet
-        const ssize_t sent = sendto(_socket, packet.data(), bytesToSend, 0,
-                                    reinterpret_cast<struct sockaddr*>(&_multicastAddr),
-                                    sizeof(_multicastAddr));
-        if (sent < 0)
+        size_t done = 0;
+        int error = 0;
+        while (done < scratch.messages.size())
+        {
+            size_t batch = std::min(MAX_MESSAGES_PER_SEND, scratch.messages.size() - done);
+            size_t batchBytes = 0;
+            if (softwarePacing())
+            {
+                // Release at most one burst per call, at least one datagram
+                const size_t burst = _pacingBurst.load(std::memory_order_relaxed);
+                size_t count = 0;
+                while (count < batch && (count == 0 || batchBytes + scratch.messageBytes[done + count] <= burst))
+                {
+                    batchBytes += scratch.messageBytes[done + count];
+                    ++count;
+                }
+                batch = count;
+                pace(batchBytes);
+            }
+            const int sent = sendmmsg(_socket, &scratch.messages[done], static_cast<unsigned int>(batch), 0);
+            if (sent > 0)
+            {
+                for (size_t i = done; i < done + static_cast<size_t>(sent); ++i)
+                {
+                    sentBytes += scratch.messageBytes[i];
+                }
+                done += static_cast<size_t>(sent);
+            }
+            else if (errno != EINTR)
+            {
+                error = errno;
+                break;
+            }
+        }
+        if (done == scratch.messages.size())
         {
-            GPERROR("Failed to send fragment {}: {}", fragNum, errno);
+            _parityFragmentsSent.fetch_add(numGroups, std::memory_order_relaxed);
+            _fragmentsSent.fetch_add(numDatagrams, std::memory_order_relaxed);
+            _bytesSent.fetch_add(sentBytes, std::memory_order_relaxed);
+            _messagesSent.fetch_add(1, std::memory_order_relaxed);
+            recordTopicBytes(topic, sentBytes);
+            return true;
+        }
+
+        if (perMessage == 1 || !isGsoError(error))
+        {
+            GPERROR_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND, "Failed to send fragment {}: {}",
+                            scratch.firstFragment[done], error);
+            _bytesSent.fetch_add(sentBytes, std::memory_order_relaxed);
+            _sendFailures.fetch_add(1, std::memory_order_relaxed);
+            recordTopicBytes(topic, sentBytes);
             return false;
         }
+
+        // Resend the rest one datagram per fragment.
+        disableGso(error);
+        nextFragment = scratch.firstFragment[done];
     }
 
     return true;
 }
+
+void HighBandwidthPublisher::addParityFragments(uint32_t messageId, size_t numFragments,
+                                                size_t groupSize, size_t numGroups)
+{
+    // XOR each data fragment's body (everything after its header) into its
+    // group's slot; shorter bodies are implicitly zero-padded.
+    SendScratch &scratch = t_scratch;
+    scratch.parity.assign(numGroups * _maxPayloadPerFragment, 0);
+    scratch.parityLength.assign(numGroups, 0);
+    scratch.lengthXor.assign(numGroups, 0);
+    for (size_t fragNum = 0; fragNum < numFragments; ++fragNum)
+    {
+        const size_t group = fragNum / groupSize;
+        uint8_t *out = scratch.parity.data() + (group * _maxPayloadPerFragment);
+        size_t length = 0;
+        const size_t end = (fragNum + 1 < numFragments) ? scratch.iovecStart[fragNum + 1] : scratch.iovecs.size();
+        for (size_t i = scratch.iovecStart[fragNum] + 1; i < end; ++i)
+        {
+            const auto *in = static_cast<const uint8_t*>(scratch.iovecs[i].iov_base);
+            for (size_t b = 0; b < scratch.iovecs[i].iov_len; ++b)
+            {
+                out[length + b] ^= in[b];
+            }
+            length += scratch.iovecs[i].iov_len;
+        }
+        scratch.lengthXor[group] ^= static_cast<uint16_t>(length);
+        scratch.parityLength[group] = std::max(scratch.parityLength[group], length);
+    }
+
+    for (size_t group = 0; group < numGroups; ++group)
+    {
+        FragmentHeader &header = scratch.headers[numFragments + group];
+        header.messageId = messageId;
+        header.fragmentNum = static_cast<uint16_t>(group);
+        header.totalFragments = static_cast<uint16_t>(numFragments);
+        header.topicLen = scratch.lengthXor[group];
+        header.fec = static_cast<uint16_t>(FEC_PARITY_FLAG | groupSize);
+
+        scratch.iovecStart.push_back(scratch.iovecs.size());
+        scratch.iovecs.push_back({&header, sizeof(FragmentHeader)});
+        scratch.iovecs.push_back({scratch.parity.data() + (group * _maxPayloadPerFragment),
+                                  scratch.parityLength[group]});
+    }
+}
+
+void HighBandwidthPublisher::setRetransmitHistory(size_t bytes)
+{
+    {
+        const std::lock_guard<std::mutex> lock(_historyMutex);
+        _historyCapacity = bytes;
+        while (_historyBytes > _historyCapacity)
+        {
+            auto oldest = _history.find(_historyOrder.front());
+            _historyBytes -= oldest->second.wire.size();
+            _history.erase(oldest);
+            _historyOrder.pop_front();
+        }
+    }
+    if (bytes > 0 && _socket >= 0 && !_nackThread.joinable())
+    {
+        _nackThread = std::thread(&HighBandwidthPublisher::nackLoop, this);
+    }
+}
+
+size_t HighBandwidthPublisher::historyMemoryUsage() const
+{
+    const std::lock_guard<std::mutex> lock(_historyMutex);
+    return _historyBytes;
+}
+
+void HighBandwidthPublisher::recordHistory(uint32_t messageId, std::string_view topic, const uint8_t *payload,
+                                           size_t size, uint16_t numFragments, uint16_t fecGroupSize)
+{
+    const size_t wireSize = _topicPrefix.size() + topic.size() + size;
+    const std::lock_guard<std::mutex> lock(_historyMutex);
+    if (wireSize > _historyCapacity)
+    {
+        return;  // Reliable mode off, or the message alone exceeds the history
+    }
+
+    // Evict the oldest messages, reusing the last evicted buffer
+    std::string wire;
+    while (_historyBytes + wireSize > _historyCapacity)
+    {
+        auto oldest = _history.find(_historyOrder.front());
+        _historyBytes -= oldest->second.wire.size();
+        wire = std::move(oldest->second.wire);
+        _history.erase(oldest);
+        _historyOrder.pop_front();
+    }
+    wire.assign(_topicPrefix);
+    wire.append(topic);
+    wire.append(reinterpret_cast<const char*>(payload), size);
+
+    HistoryEntry &entry = _history[messageId];
+    _historyBytes += wireSize - entry.wire.size();
+    if (entry.wire.empty())
+    {
+        _historyOrder.push_back(messageId);
+    }
+    entry.wire = std::move(wire);
+    entry.topicSize = static_cast<uint16_t>(_topicPrefix.size() + topic.size());
+    entry.numFragments = numFragments;
+    entry.fecGroupSize = fecGroupSize;
+}
+
+void HighBandwidthPublisher::nackLoop()
+{
+    CommonUtils::configureCurrentThread("PubSub." + _name + ".nack");
+
+    std::vector<uint8_t> buffer(sizeof(NackHeader) + (MAX_NACK_FRAGMENTS * sizeof(uint16_t)));
+    while (_running.load())
+    {
+        // Poll with timeout to allow checking _running flag
+        pollfd pfd{_socket, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+        sockaddr_in sender{};
+        socklen_t senderLen = sizeof(sender);
+        const ssize_t len = recvfrom(_socket, buffer.data(), buffer.size(), MSG_DONTWAIT,
+                                     reinterpret_cast<sockaddr*>(&sender), &senderLen);
+        if (len >= static_cast<ssize_t>(sizeof(NackHeader)))
+        {
+            handleNack(buffer.data(), static_cast<size_t>(len), sender);
+        }
+    }
+}
+
+void HighBandwidthPublisher::handleNack(const uint8_t *nack, size_t len, const sockaddr_in &sender)
+{
+    NackHeader header{};
+    std::memcpy(&header, nack, sizeof(header));
+    if (header.magic != NACK_MAGIC || len < sizeof(NackHeader) + (header.count * sizeof(uint16_t)))
+    {
+        return;
+    }
+    _nacksReceived.fetch_add(1, std::memory_order_relaxed);
+
+    const std::lock_guard<std::mutex> lock(_historyMutex);
+    const auto it = _history.find(header.messageId);
+    if (it == _history.end())
+    {
+        return;  // Evicted: the subscriber's reassembly will time out
+    }
+    const HistoryEntry &entry = it->second;
+
+    // Rebuild each fragment exactly as first sent: every fragment but the
+    // last carries _maxPayloadPerFragment bytes of topic + payload
+    for (size_t i = 0; i < header.count; ++i)
+    {
+        uint16_t fragNum = 0;
+        std::memcpy(&fragNum, nack + sizeof(NackHeader) + (i * sizeof(uint16_t)), sizeof(fragNum));
+        if (fragNum >= entry.numFragments)
+        {
+            continue;
+        }
+        FragmentHeader fragment{};
+        fragment.messageId = header.messageId;
+        fragment.fragmentNum = fragNum;
+        fragment.totalFragments = entry.numFragments;
+        fragment.topicLen = (fragNum == 0 || entry.fecGroupSize > 0) ? entry.topicSize : 0;
+        fragment.fec = entry.fecGroupSize;
+
+        const size_t offset = fragNum * _maxPayloadPerFragment;
+        iovec iov[2] = {{&fragment, sizeof(fragment)},
+                        {const_cast<char*>(entry.wire.data()) + offset,
+                         std::min(_maxPayloadPerFragment, entry.wire.size() - offset)}};
+        msghdr message{};
+        message.msg_name = const_cast<sockaddr_in*>(&sender);
+        message.msg_namelen = sizeof(sender);
+        message.msg_iov = iov;
+        message.msg_iovlen = 2;
+        if (sendmsg(_socket, &message, 0) >= 0)
+        {
+            _retransmittedFragments.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void HighBandwidthPublisher::setPacingRate(uint64_t bytesPerSecond, size_t burstBytes)
+{
+    {
+        const std::lock_guard<std::mutex> lock(_pacingMutex);
+        _pacingRate.store(bytesPerSecond, std::memory_order_relaxed);
+        _pacingBurst.store(burstBytes > 0 ? std::max(burstBytes, _mtu) : DEFAULT_BURST_FRAGMENTS * _mtu,
+                           std::memory_order_relaxed);
+        _tokens = static_cast<double>(_pacingBurst.load(std::memory_order_relaxed));
+        _lastRefill = std::chrono::steady_clock::now();
+    }
+    if (_kernelPacing.load(std::memory_order_relaxed))
+    {
+        setKernelPacing(true);
+    }
+}
+
+bool HighBandwidthPublisher::setKernelPacing(bool enabled)
+{
+#ifdef SO_MAX_PACING_RATE
+    const uint64_t rate = _pacingRate.load(std::memory_order_relaxed);
+    // ~0 removes the limit
+    const uint64_t value = (enabled && rate > 0) ? rate : ~uint64_t{0};
+    if (_socket >= 0 && setsockopt(_socket, SOL_SOCKET, SO_MAX_PACING_RATE, &value, sizeof(value)) == 0)
+    {
+        _kernelPacing.store(enabled && rate > 0, std::memory_order_relaxed);
+        return true;
+    }
+    GPWARN("SO_MAX_PACING_RATE refused (error {}), pacing in software", errno);
+#endif
+    _kernelPacing.store(false, std::memory_order_relaxed);
+    return !enabled;
+}
+
+void HighBandwidthPublisher::pace(size_t bytes)
+{
+    std::chrono::steady_clock::duration wait{};
+    {
+        // Take the tokens now, going into debt if needed, so concurrent
+        // publishers queue up behind each other instead of all waking at once
+        const std::lock_guard<std::mutex> lock(_pacingMutex);
+        const double rate = static_cast<double>(_pacingRate.load(std::memory_order_relaxed));
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>(now - _lastRefill).count();
+        _lastRefill = now;
+        _tokens = std::min(_tokens + (elapsed * rate),
+                           static_cast<double>(_pacingBurst.load(std::memory_order_relaxed)));
+        _tokens -= static_cast<double>(bytes);
+        if (_tokens < 0)
+        {
+            wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(-_tokens / rate));
+        }
+    }
+    if (wait.count() > 0)
+    {
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+void HighBandwidthPublisher::recordTopicBytes(std::string_view topic, size_t bytes)
+{
+    const std::lock_guard<std::mutex> lock(_topicStatsMutex);
+    auto it = _topicStats.find(topic);
+    if (it == _topicStats.end())
+    {
+        it = _topicStats.emplace(std::string(topic), TopicBandwidth{}).first;
+    }
+    ++it->second.messages;
+    it->second.bytes += bytes;
+}
+
+std::unordered_map<std::string, HighBandwidthPublisher::TopicBandwidth> HighBandwidthPublisher::topicBandwidth() const
+{
+    const std::lock_guard<std::mutex> lock(_topicStatsMutex);
+    return {_topicStats.begin(), _topicStats.end()};
+}
+
+HighBandwidthPublisher::Stats HighBandwidthPublisher::stats() const
+{
+    Stats stats;
+    stats.messagesSent = _messagesSent.load(std::memory_order_relaxed);
+    stats.bytesSent = _bytesSent.load(std::memory_order_relaxed);
+    stats.fragmentsSent = _fragmentsSent.load(std::memory_order_relaxed);
+    stats.sendFailures = _sendFailures.load(std::memory_order_relaxed);
+    stats.parityFragmentsSent = parityFragmentsSent();
+    stats.nacksReceived = nackCount();
+    stats.retransmittedFragments = retransmittedFragmentCount();
+    stats.historyBytes = historyMemoryUsage();
+    return stats;
+}
+
+void HighBandwidthPublisher::setFecGroupSize(size_t dataFragments)
+{
+    // A group of one would let a message lose every data fragment, topic length included
+    const size_t groupSize = (dataFragments == 0) ? 0 : std::clamp<size_t>(dataFragments, 2, FEC_GROUP_MASK);
+    _fecGroupSize.store(groupSize, std::memory_order_relaxed);
+}
+
+void HighBandwidthPublisher::disableGso(int error)
+{
+    if (!_gsoEnabled.exchange(false))
+    {
+        return;
+    }
+#ifdef UDP_SEGMENT
+    const int off = 0;
+    setsockopt(_socket, SOL_UDP, UDP_SEGMENT, &off, sizeof(off));
+#endif
+    GPWARN("UDP segmentation offload refused (error {}), sending fragments individually", error);
+}
@@ -2,8 +2,16 @@
 #define HIGHBANDWIDTHPUBLISHER_H
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <netinet/in.h>
 
 #include <google/protobuf/message.h>
@@ -14,16 +22,46 @@
  *
  * This 12-byte header is prepended to each UDP packet to enable
  * reassembly of large messages that exceed the MTU.
+ *
+ * With forward error correction (see HighBandwidthPublisher::setFecGroupSize())
+ * data fragments carry the parity group size in `fec` and the topic length
+ * in every fragment.  Each group of that many consecutive data fragments is
+ * followed by one parity fragment (`fec` has FEC_PARITY_FLAG set,
+ * `fragmentNum` is the group index, `topicLen` is the XOR of the group's
+ * fragment lengths) whose body is the XOR of the group's fragment bodies,
+ * each zero-padded to the longest.  Any one lost fragment of a group can
+ * be rebuilt from the others and the parity.
  */
 struct FragmentHeader
 {
     uint32_t messageId;      ///< Unique ID for this message (groups fragments together)
-    uint16_t fragmentNum;    ///< Fragment number (0-based index)
-    uint16_t totalFragments; ///< Total number of fragments in the message
-    uint16_t topicLen;       ///< Length of topic string (only meaningful in fragment 0)
+    uint16_t fragmentNum;    ///< Fragment number (0-based index), or parity group index
+    uint16_t totalFragments; ///< Total number of data fragments in the message
+    uint16_t topicLen;       ///< Length of topic string (fragment 0, or every data fragment with FEC)
+    uint16_t fec;            ///< FEC group size (0 = none), FEC_PARITY_FLAG on parity fragments
+} __attribute__((packed));
+
+constexpr uint16_t FEC_PARITY_FLAG = 0x8000;    ///< FragmentHeader::fec bit of parity fragments
+constexpr uint16_t FEC_GROUP_MASK = 0x7FFF;     ///< FragmentHeader::fec bits holding the group size
+
+/**
+ * @class NackHeader
+ * @brief Header of a negative acknowledgement, sent by a subscriber to the
+ *        publisher's address to request lost fragments.
+ *
+ * Followed by `count` little-endian uint16_t data fragment numbers.
+ */
+struct NackHeader
+{
+    uint32_t magic;          ///< NACK_MAGIC
+    uint32_t messageId;      ///< Message whose fragments are missing
+    uint16_t count;          ///< Number of fragment numbers that follow
     uint16_t reserved;       ///< Padding for alignment
 } __attribute__((packed));
 
+constexpr uint32_t NACK_MAGIC = 0x4B43414E;     ///< "NACK" in little-endian byte order
+constexpr size_t MAX_NACK_FRAGMENTS = 256;      ///< Fragment numbers per NACK datagram
+
 /**
  * @class HighBandwidthPublisher
  * @brief High-bandwidth publisher using raw UDP multicast.
@@ -44,10 +82,39 @@ struct FragmentHeader
  *       - High message throughput is required
  *       - Examples: sensor data, video frames, telemetry, real-time state updates
  * 
+ * Messages are serialized straight into a per-thread buffer that is reused
+ * across calls, and fragments are never copied: each one is an iovec list
+ * (header, cached namespace prefix, topic, payload slice) pointing into
+ * that buffer, and a message's
+ * fragments go out in batches of `sendmmsg` calls.  Where the kernel
+ * supports UDP generic segmentation offload (`UDP_SEGMENT`), runs of
+ * full-MTU fragments are handed over as one super-datagram that the
+ * kernel (or NIC) splits, so a 1 MB message costs a single syscall.
+ * Subscribers see the same datagrams either way.
+ *
+ * Optional XOR parity (setFecGroupSize()) lets subscribers rebuild one lost
+ * fragment per group of K without retransmission, at the cost of one extra
+ * datagram per K fragments.
+ *
+ * setPacingRate() spreads fragments out with a token bucket (bytes/s plus
+ * a burst allowance) shared by every publishing thread, so large messages
+ * do not overrun switch and receiver buffers; setKernelPacing() hands the
+ * same rate to the kernel (`SO_MAX_PACING_RATE`, honoured by the fq
+ * qdisc) instead.  topicBandwidth() reports the bytes sent per topic.
+ *
+ * Reliable mode (setRetransmitHistory()) keeps recent messages in a
+ * bounded history and resends the fragments a subscriber lists in a NACK
+ * (see NackHeader) straight back to that subscriber.
+ *
  * @see HighBandwidthSubscriber for the corresponding subscriber class
  */
+// Forward declaration for friend test class
+class HighBandwidthPublisherTest;
+
 class HighBandwidthPublisher
 {
+    friend class HighBandwidthPublisherTest;
+
 public:
     /**
      * @brief Construct a high-bandwidth UDP multicast publisher.
@@ -100,8 +167,201 @@ public:
      */
     [[nodiscard]] uint16_t port() const { return _port; }
 
+    /**
+     * @brief Check whether fragments are sent with UDP segmentation offload.
+     * @return true if the kernel accepted `UDP_SEGMENT` and no send has
+     *         since failed with it (the publisher then falls back).
+     */
+    [[nodiscard]] bool gsoEnabled() const { return _gsoEnabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Send one XOR parity fragment per `dataFragments` data fragments.
+     *
+     * Applies to messages of more than one fragment.  Smaller groups
+     * survive more loss at a higher bandwidth cost (K data + 1 parity).
+     *
+     * @param dataFragments Group size K, clamped to [2, FEC_GROUP_MASK]; 0 disables parity
+     */
+    void setFecGroupSize(size_t dataFragments);
+
+    /**
+     * @brief Get the parity group size.
+     * @return Data fragments per parity fragment, or 0 if parity is off
+     */
+    [[nodiscard]] size_t fecGroupSize() const { return _fecGroupSize.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of parity fragments sent.
+     * @return Parity fragments handed to the network stack since construction
+     */
+    [[nodiscard]] uint64_t parityFragmentsSent() const { return _parityFragmentsSent.load(std::memory_order_relaxed); }
+
+    /**
+     * @struct TopicBandwidth
+     * @brief Traffic sent on one topic.
+     */
+    struct TopicBandwidth
+    {
+        uint64_t messages{0};   ///< Messages published
+        uint64_t bytes{0};      ///< UDP payload bytes sent (headers, data and parity)
+    };
+
+    /**
+     * @brief Limit the send rate with a token bucket.
+     *
+     * Fragments are released at most one burst at a time, and a publish
+     * that exceeds the tokens available sleeps until the bucket refills.
+     *
+     * @param bytesPerSecond Sustained rate in UDP payload bytes/s; 0 disables pacing
+     * @param burstBytes Bucket size (at least one MTU); 0 uses DEFAULT_BURST_FRAGMENTS MTUs
+     */
+    void setPacingRate(uint64_t bytesPerSecond, size_t burstBytes = 0);
+
+    /**
+     * @brief Get the pacing rate.
+     * @return Bytes/s set by setPacingRate(), or 0 if pacing is off
+     */
+    [[nodiscard]] uint64_t pacingRate() const { return _pacingRate.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Pace in the kernel with `SO_MAX_PACING_RATE` instead of the token bucket.
+     *
+     * Takes effect only where the egress qdisc paces (fq); the kernel
+     * follows later setPacingRate() calls.
+     *
+     * @param enabled true to hand the pacing rate to the kernel
+     * @return false if the kernel refused (software pacing stays in use)
+     */
+    bool setKernelPacing(bool enabled);
+
+    /**
+     * @brief Get the traffic sent per topic.
+     * @return Topic (without namespace) -> messages and bytes sent since construction
+     */
+    [[nodiscard]] std::unordered_map<std::string, TopicBandwidth> topicBandwidth() const;
+
+    static constexpr size_t DEFAULT_BURST_FRAGMENTS = 16;   ///< Default burst, in MTUs
+
+    /**
+     * @brief Keep recent messages for retransmission on NACK.
+     *
+     * The oldest messages are evicted once the history would exceed
+     * `bytes`; a NACK for an evicted message is ignored.  The first call
+     * with a non-zero size starts a thread that listens for NACKs on the
+     * publisher's socket.
+     *
+     * @param bytes History capacity in bytes; 0 disables reliable mode
+     */
+    void setRetransmitHistory(size_t bytes);
+
+    /**
+     * @brief Get the memory held by the retransmit history.
+     * @return Bytes of message data currently kept
+     */
+    [[nodiscard]] size_t historyMemoryUsage() const;
+
+    /**
+     * @brief Get the number of NACKs received.
+     * @return Valid NACK datagrams since construction
+     */
+    [[nodiscard]] uint64_t nackCount() const { return _nacksReceived.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of fragments resent in answer to NACKs.
+     * @return Retransmitted fragments since construction
+     */
+    [[nodiscard]] uint64_t retransmittedFragmentCount() const { return _retransmittedFragments.load(std::memory_order_relaxed); }
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the publisher's transport counters.
+     */
+    struct Stats
+    {
+        uint64_t messagesSent{0};           ///< Messages fully handed to the network stack
+        uint64_t bytesSent{0};              ///< UDP payload bytes sent (headers, data and parity)
+        uint64_t fragmentsSent{0};          ///< Datagrams sent, parity included
+        uint64_t sendFailures{0};           ///< Messages not (fully) sent: too large or send error
+        uint64_t parityFragmentsSent{0};    ///< See parityFragmentsSent()
+        uint64_t nacksReceived{0};          ///< See nackCount()
+        uint64_t retransmittedFragments{0}; ///< See retransmittedFragmentCount()
+        size_t historyBytes{0};             ///< See historyMemoryUsage()
+    };
+
+    /**
+     * @brief Get the transport counters.
+     * @return Counters since construction; safe to call while publishing
+     */
+    [[nodiscard]] Stats stats() const;
+
 private:
+    static constexpr size_t MAX_MESSAGES_PER_SEND = 64;  ///< mmsghdrs per sendmmsg call
+    static constexpr size_t MAX_GSO_SEGMENTS = 64;       ///< Kernel UDP_MAX_SEGMENTS (older kernels)
+    static constexpr size_t MAX_UDP_PAYLOAD = 65507;     ///< Largest IPv4 UDP payload
+
+    /**
+     * @brief Fragment and send one serialized message.
+     * @param topic The topic without namespace (fragment 0 carries prefix + topic)
+     * @param payload Serialized message bytes
+     * @param size Number of payload bytes
+     * @return true if every fragment was handed to the network stack
+     */
+    bool sendFragments(std::string_view topic, const uint8_t *payload, size_t size);
+
+    /**
+     * @brief Append one XOR parity fragment per group to the send scratch.
+     * @param messageId Message the parity belongs to
+     * @param numFragments Number of data fragments already described
+     * @param groupSize Data fragments per group
+     * @param numGroups Number of groups (parity fragments)
+     */
+    void addParityFragments(uint32_t messageId, size_t numFragments, size_t groupSize, size_t numGroups);
+
+    /**
+     * @brief Check whether fragments go through the token bucket.
+     */
+    [[nodiscard]] bool softwarePacing() const
+    {
+        return _pacingRate.load(std::memory_order_relaxed) > 0 && !_kernelPacing.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Take `bytes` tokens, sleeping until the bucket covers them.
+     */
+    void pace(size_t bytes);
+
+    /**
+     * @brief Add a publish to its topic's bandwidth counters.
+     */
+    void recordTopicBytes(std::string_view topic, size_t bytes);
+
+    /**
+     * @brief Copy a sent message into the retransmit history, evicting the oldest.
+     */
+    void recordHistory(uint32_t messageId, std::string_view topic, const uint8_t *payload, size_t size,
+                       uint16_t numFragments, uint16_t fecGroupSize);
+
+    /**
+     * @brief Background thread function answering NACKs.
+     */
+    void nackLoop();
+
+    /**
+     * @brief Resend the fragments listed in a NACK to its sender.
+     * @param nack Received datagram (NackHeader + fragment numbers)
+     * @param len Datagram length
+     * @param sender Address the NACK came from
+     */
+    void handleNack(const uint8_t *nack, size_t len, const sockaddr_in &sender);
+
+    /**
+     * @brief Turn off UDP segmentation offload after the kernel refused it.
+     * @param error errno of the failed send
+     */
+    void disableGso(int error);
+
     std::string _name;                          ///< Namespace for topic isolation
+    std::string _topicPrefix;                   ///< "<name>/", prepended to every topic
     uint16_t _port;                             ///< UDP port number
     size_t _mtu;                                ///< Maximum transmission unit
     size_t _maxPayloadPerFragment;              ///< Max payload bytes per fragment
@@ -109,6 +369,52 @@ private:
     struct sockaddr_in _multicastAddr;          ///< Multicast destination address
     std::atomic<uint32_t> _messageIdCounter{0}; ///< Counter for unique message IDs
     std::atomic<bool> _running{false};          ///< Running state flag
+    size_t _gsoSegments{0};                     ///< Fragments per GSO super-datagram
+    std::atomic<bool> _gsoEnabled{false};       ///< UDP_SEGMENT accepted by the kernel
+    std::atomic<size_t> _fecGroupSize{0};       ///< Data fragments per parity fragment (0 = off)
+    std::atomic<uint64_t> _parityFragmentsSent{0}; ///< Parity fragments sent
+    std::atomic<uint64_t> _messagesSent{0};     ///< Messages sent completely
+    std::atomic<uint64_t> _bytesSent{0};        ///< UDP payload bytes sent
+    std::atomic<uint64_t> _fragmentsSent{0};    ///< Datagrams sent
+    std::atomic<uint64_t> _sendFailures{0};     ///< Messages that failed to send
+
+    /**
+     * @struct HistoryEntry
+     * @brief A sent message as needed to rebuild any of its fragments.
+     */
+    struct HistoryEntry
+    {
+        std::string wire;            ///< Namespaced topic + payload, as laid out over the fragments
+        uint16_t topicSize{0};       ///< Namespaced topic length
+        uint16_t numFragments{0};    ///< Data fragments
+        uint16_t fecGroupSize{0};    ///< FragmentHeader::fec of the data fragments
+    };
+
+    /// Hash allowing topic lookup by std::string_view.
+    struct TopicHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view topic) const noexcept { return std::hash<std::string_view>{}(topic); }
+    };
+
+    std::mutex _pacingMutex;                                  ///< Protects the token bucket
+    std::atomic<uint64_t> _pacingRate{0};                     ///< Bytes/s (0 = no pacing)
+    std::atomic<size_t> _pacingBurst{0};                      ///< Bucket size in bytes
+    std::atomic<bool> _kernelPacing{false};                   ///< SO_MAX_PACING_RATE in use
+    double _tokens{0};                                        ///< Bytes that may be sent now (negative = debt)
+    std::chrono::steady_clock::time_point _lastRefill;        ///< Last token refill
+
+    mutable std::mutex _topicStatsMutex;                      ///< Protects _topicStats
+    std::unordered_map<std::string, TopicBandwidth, TopicHash, std::equal_to<>> _topicStats; ///< Per-topic traffic
+
+    mutable std::mutex _historyMutex;                         ///< Protects the history
+    std::unordered_map<uint32_t, HistoryEntry> _history;      ///< Message ID -> sent message
+    std::deque<uint32_t> _historyOrder;                       ///< Message IDs, oldest first
+    std::atomic<size_t> _historyCapacity{0};                  ///< Byte limit (0 = reliable mode off)
+    size_t _historyBytes{0};                                  ///< Bytes of message data kept
+    std::thread _nackThread;                                  ///< Answers NACKs once reliable mode is on
+    std::atomic<uint64_t> _nacksReceived{0};                  ///< Valid NACKs received
+    std::atomic<uint64_t> _retransmittedFragments{0};         ///< Fragments resent
 };
 
 #endif // HIGHBANDWIDTHPUBLISHER_H
@@ -1,15 +1,153 @@
 #include "HighBandwidthSubscriber.h"
 #include "HighBandwidthPublisher.h"  // For FragmentHeader definition
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <array>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <iostream>
+#include <linux/filter.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <poll.h>
 #include <utility>
 
 #include <GeneralLogger.h>
+#include <TaskPool.h>
+#include <ThreadConfig.h>
+
+namespace
+{
+
+// Heap bytes one incomplete message holds (reassembly buffer, parity, bookkeeping).
+size_t reassemblyBytes(const PartialMessage &partial)
+{
+    size_t bytes = sizeof(PartialMessage) + partial.data.capacity() + partial.pendingLast.capacity() +
+                   (partial.receivedBits.capacity() * sizeof(uint64_t)) +
+                   (partial.parity.capacity() * sizeof(std::string)) +
+                   (partial.parityLengthXor.capacity() * sizeof(uint16_t));
+    for (const auto &parity : partial.parity)
+    {
+        bytes += parity.capacity();
+    }
+    return bytes;
+}
+
+} // anonymous namespace
+
+/**
+ * Bounded queue of one topic's messages, drained by one pool task at a
+ * time so the topic's handler sees them in order and never concurrently.
+ * Pool tasks hold a reference, so the queue outlives a re-subscription.
+ */
+class HighBandwidthSubscriber::TopicQueue : public std::enable_shared_from_this<TopicQueue>
+{
+public:
+    /// Messages one pool task handles before yielding its pool thread.
+    static constexpr size_t POOL_BATCH = 16;
+
+    TopicQueue(CommonUtils::TaskPool &pool, size_t capacity, MessageViewHandler handler) :
+        _pool(pool),
+        _capacity(std::max<size_t>(capacity, 1)),
+        _handler(std::move(handler))
+    {
+    }
+
+    void setHandler(MessageViewHandler handler)
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _handler = std::move(handler);
+    }
+
+    // Copy a message in; false if the queue is full.
+    bool push(std::string_view topic, std::string_view payload)
+    {
+        bool schedule = false;
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            if (_queue.size() >= _capacity)
+            {
+                return false;
+            }
+            std::string data;
+            if (!_spare.empty())
+            {
+                data = std::move(_spare.back());
+                _spare.pop_back();
+            }
+            data.assign(topic);
+            data.append(payload);
+            _queue.push_back({std::move(data), topic.size()});
+            schedule = !_scheduled;
+            _scheduled = true;
+        }
+        if (schedule)
+        {
+            _pool.post([self = shared_from_this()] { self->drain(); });
+        }
+        return true;
+    }
+
+    // Wait until every queued message has been handled.
+    void waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this] { return !_scheduled; });
+    }
+
+private:
+    struct Message
+    {
+        std::string data;   ///< Topic + payload
+        size_t topicLen;
+    };
+
+    void drain()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const MessageViewHandler handler = _handler;
+        for (size_t n = 0; n < POOL_BATCH && !_queue.empty(); ++n)
+        {
+            Message message = std::move(_queue.front());
+            _queue.pop_front();
+            lock.unlock();
+            if (handler)
+            {
+                const std::string_view data(message.data);
+                handler(data.substr(0, message.topicLen), data.substr(message.topicLen));
+            }
+            lock.lock();
+            if (_spare.size() < MAX_SPARE)
+            {
+                _spare.push_back(std::move(message.data));
+            }
+        }
+        if (!_queue.empty())
+        {
+            // Yield the pool thread to other topics, then carry on.
+            lock.unlock();
+            _pool.post([self = shared_from_this()] { self->drain(); });
+            return;
+        }
+        _scheduled = false;
+        _idle.notify_all();
+    }
+
+    static constexpr size_t MAX_SPARE = 8;   ///< Message buffers kept for reuse
+
+    CommonUtils::TaskPool &_pool;
+    const size_t _capacity;
+
+    std::mutex _mutex;
+    std::condition_variable _idle;   ///< No drain() task scheduled any more
+    MessageViewHandler _handler;
+    std::deque<Message> _queue;
+    std::vector<std::string> _spare;
+    bool _scheduled{false};          ///< A drain() task is queued or running
+};
 
 HighBandwidthSubscriber::HighBandwidthSubscriber(const std::string &name,
                                                  const std::string &multicastAddr,
@@ -22,25 +160,94 @@ HighBandwidthSubscriber::HighBandwidthSubscriber(const std::string &name,
     _port(port),
     _reassemblyTimeoutMs(reassemblyTimeoutMs)
 {
+    setShardCount(1);
 }
 
 HighBandwidthSubscriber::~HighBandwidthSubscriber()
 {
     stop();
-
-    if (_socket >= 0)
-    {
-        close(_socket);
-    }
+    closeSockets();
 }
 
 void HighBandwidthSubscriber::subscribe(const std::string &topic, MessageHandler handler)
+{
+    subscribeView(topic, [handler = std::move(handler)](std::string_view msgTopic, std::string_view data) {
+        handler(std::string(msgTopic), std::string(data));
+    });
+}
+
+void HighBandwidthSubscriber::subscribeView(const std::string &topic, MessageViewHandler handler)
 {
     // Create namespaced topic
     const std::string namespacedTopic = _name + "/" + topic;
 
     const std::lock_guard<std::mutex> lock(_handlersMutex);
-    _handlers[namespacedTopic] = std::move(handler);
+    auto &subscription = _handlers[namespacedTopic];
+    subscription.handler = std::move(handler);
+    if (subscription.queue)
+    {
+        // Keep the queue so messages already queued stay in order
+        subscription.queue->setHandler(subscription.handler);
+    }
+    else if (_handlerPool != nullptr)
+    {
+        subscription.queue = std::make_shared<TopicQueue>(*_handlerPool, _handlerQueueCapacity, subscription.handler);
+    }
+}
+
+bool HighBandwidthSubscriber::setNackInterval(int intervalMs)
+{
+    if (_running.load())
+    {
+        return false;
+    }
+    _nackIntervalMs = std::max(intervalMs, 0);
+    return true;
+}
+
+bool HighBandwidthSubscriber::setBusyPoll(int spinBudgetUs)
+{
+    if (_running.load())
+    {
+        return false;
+    }
+    _busyPollUs = std::max(spinBudgetUs, 0);
+    return true;
+}
+
+bool HighBandwidthSubscriber::setHandlerExecutor(CommonUtils::TaskPool *pool, size_t queueCapacity)
+{
+    if (_running.load())
+    {
+        return false;
+    }
+    const std::lock_guard<std::mutex> lock(_handlersMutex);
+    _handlerPool = pool;
+    _handlerQueueCapacity = queueCapacity;
+    for (auto &[topic, subscription] : _handlers)
+    {
+        subscription.queue = (pool != nullptr)
+            ? std::make_shared<TopicQueue>(*pool, queueCapacity, subscription.handler)
+            : nullptr;
+    }
+    return true;
+}
+
+bool HighBandwidthSubscriber::setShardCount(size_t count)
+{
+    if (_running.load())
+    {
+        return false;
+    }
+    closeSockets();
+    _shards.clear();
+    count = std::clamp<size_t>(count, 1, MAX_SHARDS);
+    for (size_t i = 0; i < count; ++i)
+    {
+        _shards.push_back(std::make_unique<Shard>());
+        _shards.back()->index = i;
+    }
+    return true;
 }
 
 bool HighBandwidthSubscriber::start()
@@ -50,20 +257,111 @@ bool HighBandwidthSubscriber::start()
         return true;
     }
 
+    // Sockets are bound in shard order: a reuseport group numbers its
+    // sockets the same way, which the steering program below relies on.
+    closeSockets();
+    for (auto &shard : _shards)
+    {
+        shard->socket = openSocket(shard->index == 0);
+        if (shard->socket < 0)
+        {
+            closeSockets();
+            return false;
+        }
+    }
+
+    if (_shards.size() > 1)
+    {
+        // Multicast datagrams reach every socket of the group and each
+        // shard keeps its own messages.  Steer unicast datagrams, which
+        // reach one socket only, to the owning shard the same way.
+        sock_filter code[] = {
+            {BPF_LD | BPF_B | BPF_ABS, 0, 0, 0},                              // A = datagram byte 0
+            {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(_shards.size())},
+            {BPF_RET | BPF_A, 0, 0, 0},
+        };
+        sock_fprog program{static_cast<unsigned short>(std::size(code)), code};
+        if (setsockopt(_shards.front()->socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+                       &program, sizeof(program)) < 0)
+        {
+            GPWARN("Failed to attach reuseport steering ({}); unicast senders need a single shard", errno);
+        }
+    }
+
+    GPINFO("HighBandwidthSubscriber joined multicast group {}:{} with {} receive shard(s)",
+           _multicastAddr, _port, _shards.size());
+    if (_busyPollUs > 0)
+    {
+        GPINFO("HighBandwidthSubscriber busy-polling ({} us spin budget); pin PubSub.{}.receive* to isolated cores",
+               _busyPollUs, _name);
+    }
+
+    _shouldStop.store(false);
+    _running.store(true);
+
+    for (auto &shard : _shards)
+    {
+        shard->receiveThread = std::thread(&HighBandwidthSubscriber::receiveLoop, this, std::ref(*shard));
+    }
+
+    // Expire (and NACK) incomplete messages off the receive path
+    const std::chrono::milliseconds housekeeping(housekeepingIntervalMs());
+    _housekeepingTimer = CommonUtils::TimerWheel::shared().schedule(
+        housekeeping, [this] { cleanupStaleMessages(); }, housekeeping);
+
+    return true;
+}
+
+int HighBandwidthSubscriber::openSocket(bool reportReceiveBuffer)
+{
     // Create UDP socket
-    _socket = socket(AF_INET, SOCK_DGRAM, 0);
-    if (_socket < 0)
+    const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
     {
         GPERROR("Failed to create UDP socket: ", errno);
-        return false;
+        return -1;
     }
 
     // Allow multiple sockets to use the same port
     int reuse = 1;
-    if (setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0)
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0)
     {
         GPERROR("Failed to set SO_REUSEADDR: ", errno);
     }
+    if (_shards.size() > 1 && setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0)
+    {
+        GPERROR("Failed to set SO_REUSEPORT: {}", errno);
+        close(sock);
+        return -1;
+    }
+
+    // Apply the requested receive buffer and record what the kernel granted
+    if (_requestedReceiveBufferSize > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &_requestedReceiveBufferSize,
+                   sizeof(_requestedReceiveBufferSize)) < 0)
+    {
+        GPERROR("Failed to set SO_RCVBUF to {}: {}", _requestedReceiveBufferSize, errno);
+    }
+    if (_busyPollUs > 0 && setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &_busyPollUs, sizeof(_busyPollUs)) < 0)
+    {
+        // Above net.core.busy_read without CAP_NET_ADMIN; the spin still works
+        GPWARN("Failed to set SO_BUSY_POLL to {} us: {}", _busyPollUs, errno);
+    }
+    int granted = 0;
+    socklen_t grantedLen = sizeof(granted);
+    if (reportReceiveBuffer && getsockopt(sock, SOL_SOCKET, SO_RCVBUF, &granted, &grantedLen) == 0)
+    {
+        _receiveBufferSize.store(granted);
+        if (granted < _requestedReceiveBufferSize)
+        {
+            GPWARN("SO_RCVBUF: requested {} bytes, granted {} (raise net.core.rmem_max)",
+                   _requestedReceiveBufferSize, granted);
+        }
+        else if (_requestedReceiveBufferSize > 0)
+        {
+            GPINFO("SO_RCVBUF: requested {} bytes, granted {}", _requestedReceiveBufferSize, granted);
+        }
+    }
 
     // Bind to the multicast port
     struct sockaddr_in localAddr;
@@ -72,12 +370,11 @@ bool HighBandwidthSubscriber::start()
     localAddr.sin_port = htons(_port);
     localAddr.sin_addr.s_addr = htonl(INADDR_ANY);
 
-    if (bind(_socket, reinterpret_cast<struct sockaddr*>(&localAddr), sizeof(localAddr)) < 0)
+    if (bind(sock, reinterpret_cast<struct sockaddr*>(&localAddr), sizeof(localAddr)) < 0)
     {
         GPERROR("Failed to bind socket to port {} : {}", _port, errno);
-        close(_socket);
-        _socket = -1;
-        return false;
+        close(sock);
+        return -1;
     }
 
     // Join the multicast group
@@ -85,9 +382,8 @@ bool HighBandwidthSubscriber::start()
     if (inet_pton(AF_INET, _multicastAddr.c_str(), &mreq.imr_multiaddr) != 1)
     {
         GPERROR("Invalid multicast address: {}", _multicastAddr);
-        close(_socket);
-        _socket = -1;
-        return false;
+        close(sock);
+        return -1;
     }
     mreq.imr_interface.s_addr = htonl(INADDR_ANY);
 
@@ -97,29 +393,32 @@ bool HighBandwidthSubscriber::start()
         if (inet_pton(AF_INET, _interfaceAddr.c_str(), &mreq.imr_interface) != 1)
         {
             GPERROR("Invalid interface address: {}", _interfaceAddr);
-            close(_socket);
-            _socket = -1;
-            return false;
+            close(sock);
+            return -1;
         }
         GPINFO("Joining multicast group on interface {}", _interfaceAddr);
     }
 
-    if (setsockopt(_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
     {
         GPERROR("Failed to join multicast group: {}", errno);
-        close(_socket);
-        _socket = -1;
-        return false;
+        close(sock);
+        return -1;
     }
 
-    GPINFO("HighBandwidthSubscriber joined multicast group {}:{}", _multicastAddr, _port);
-
-    _shouldStop.store(false);
-    _running.store(true);
-
-    _receiveThread = std::thread(&HighBandwidthSubscriber::receiveLoop, this);
+    return sock;
+}
 
-    return true;
+void HighBandwidthSubscriber::closeSockets()
+{
+    for (auto &shard : _shards)
+    {
+        if (shard->socket >= 0)
+        {
+            close(shard->socket);
+            shard->socket = -1;
+        }
+    }
 }
 
 void HighBandwidthSubscriber::stop()
@@ -132,72 +431,168 @@ void HighBandwidthSubscriber::stop()
     _shouldStop.store(true);
     _running.store(false);
 
-    if (_receiveThread.joinable())
+    // Waits for a cleanup in progress, which may still send NACKs
+    CommonUtils::TimerWheel::shared().cancel(_housekeepingTimer);
+    _housekeepingTimer = CommonUtils::TimerWheel::INVALID_TIMER;
+
+    for (auto &shard : _shards)
+    {
+        if (shard->receiveThread.joinable())
+        {
+            shard->receiveThread.join();
+        }
+    }
+
+    // Let the handler executor finish what the receive threads queued
+    std::vector<std::shared_ptr<TopicQueue>> queues;
     {
-        _receiveThread.join();
+        const std::lock_guard<std::mutex> lock(_handlersMutex);
+        for (const auto &[topic, subscription] : _handlers)
+        {
+            if (subscription.queue)
+            {
+                queues.push_back(subscription.queue);
+            }
+        }
+    }
+    for (const auto &queue : queues)
+    {
+        queue->waitIdle();
     }
 }
 
-void HighBandwidthSubscriber::receiveLoop()
+void HighBandwidthSubscriber::receiveLoop(Shard &shard)
 {
-    std::vector<uint8_t> buffer(65535);  // Max UDP packet size
-    auto lastCleanup = std::chrono::steady_clock::now();
+    const bool sharded = _shards.size() > 1;
+    CommonUtils::configureCurrentThread("PubSub." + _name + ".receive" +
+                                        (sharded ? "." + std::to_string(shard.index) : std::string()));
+
+    // Ring of datagram slots, filled by one recvmmsg per wake-up
+    const size_t slotSize = _maxDatagramSize;
+    std::vector<uint8_t> slots(RECEIVE_BATCH * slotSize);
+    std::vector<iovec> iovecs(RECEIVE_BATCH);
+    std::vector<sockaddr_in> sources(RECEIVE_BATCH);
+    std::vector<mmsghdr> messages(RECEIVE_BATCH);
+    for (size_t i = 0; i < RECEIVE_BATCH; ++i)
+    {
+        iovecs[i].iov_base = slots.data() + (i * slotSize);
+        iovecs[i].iov_len = slotSize;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &sources[i];
+    }
+
+    auto lastDatagram = std::chrono::steady_clock::now();
+    bool moreQueued = false;
 
     while (_running.load() && !_shouldStop.load())
     {
-        // Poll with timeout to allow checking _running flag
-        struct pollfd pfd;
-        pfd.fd = _socket;
-        pfd.events = POLLIN;
-        
-        const int ret = poll(&pfd, 1, 100);  // 100ms timeout
-        
-        if (ret < 0)
+        // A full batch means more datagrams are likely queued: skip the wait
+        if (!moreQueued && !waitForDatagrams(shard, lastDatagram))
         {
-            if (errno != EINTR)
-            {
-                GPERROR("poll() failed: {}", errno);
-            }
             continue;
         }
 
-        if (ret == 0)
+        // Receive up to RECEIVE_BATCH datagrams
+        for (auto &message : messages)
         {
-            // Timeout - clean up stale partial messages
-            auto now = std::chrono::steady_clock::now();
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCleanup).count() > 500)
-            {
-                cleanupStaleMessages();
-                lastCleanup = now;
-            }
-            continue;
+            message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
         }
-
-        // Receive packet
-        const ssize_t received = recv(_socket, buffer.data(), buffer.size(), 0);
+        const int received = recvmmsg(shard.socket, messages.data(), RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
         if (received < 0)
         {
-            if (errno != EINTR && errno != EAGAIN)
+            if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
             {
-                GPERROR("recv() failed: {}", errno);
+                GPERROR_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND, "recvmmsg() failed: {}", errno);
             }
+            moreQueued = false;
             continue;
         }
+        moreQueued = std::cmp_equal(received, RECEIVE_BATCH);
+        if (_busyPollUs > 0 && received > 0)
+        {
+            lastDatagram = std::chrono::steady_clock::now();
+        }
 
-        if (std::cmp_greater_equal(received, sizeof(FragmentHeader)))
+        for (int i = 0; i < received; ++i)
         {
-            processFragment(buffer.data(), static_cast<size_t>(received));
+            const mmsghdr &message = messages[static_cast<size_t>(i)];
+            if ((message.msg_hdr.msg_flags & MSG_TRUNC) != 0)
+            {
+                // Counted once, by the shard owning the message
+                const auto* truncated = static_cast<const uint8_t*>(iovecs[static_cast<size_t>(i)].iov_base);
+                if (!sharded || &shardFor(truncated) == &shard)
+                {
+                    ++shard.counters.droppedFragments;
+                }
+                GPWARN_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND,
+                               "Dropped datagram larger than {} bytes; raise setMaxDatagramSize()",
+                               slotSize);
+                continue;
+            }
+            const auto* datagram = static_cast<const uint8_t*>(iovecs[static_cast<size_t>(i)].iov_base);
+            if (message.msg_len < sizeof(FragmentHeader))
+            {
+                continue;
+            }
+            // Every shard gets a copy of each multicast datagram; keep only ours
+            Shard &owner = shardFor(datagram);
+            if (sharded && &owner != &shard)
+            {
+                continue;
+            }
+            processFragment(owner, datagram, message.msg_len, &sources[static_cast<size_t>(i)]);
         }
     }
 }
 
+bool HighBandwidthSubscriber::waitForDatagrams(Shard &shard, std::chrono::steady_clock::time_point lastDatagram) const
+{
+    // Busy poll: go straight to the non-blocking receive while within budget
+    if (_busyPollUs > 0 &&
+        std::chrono::steady_clock::now() - lastDatagram < std::chrono::microseconds(_busyPollUs))
+    {
+        return true;
+    }
+
+    // Poll with timeout to allow checking _running flag
+    struct pollfd pfd;
+    pfd.fd = shard.socket;
+    pfd.events = POLLIN;
+
+    const int ret = poll(&pfd, 1, POLL_TIMEOUT_MS);
+    if (ret < 0 && errno != EINTR)
+    {
+        GPERROR_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND, "poll() failed: {}", errno);
+    }
+    return ret > 0;
+}
+
+int HighBandwidthSubscriber::housekeepingIntervalMs() const
+{
+    // NACKs are sent from the same housekeeping, so it must tick often enough
+    return (_nackIntervalMs > 0)
+        ? std::clamp(_nackIntervalMs / 2, 1, HOUSEKEEPING_INTERVAL_MS)
+        : HOUSEKEEPING_INTERVAL_MS;
+}
+
 void HighBandwidthSubscriber::cleanupStaleMessages()
 {
-    const std::lock_guard<std::mutex> lock(_reassemblyMutex);
+    size_t held = 0;
+    for (auto &shard : _shards)
+    {
+        held += cleanupStaleMessages(*shard);
+    }
+    _reassemblyMemory.setBytes(held);
+}
+
+size_t HighBandwidthSubscriber::cleanupStaleMessages(Shard &shard)
+{
+    const std::lock_guard<std::mutex> lock(shard.reassemblyMutex);
     auto now = std::chrono::steady_clock::now();
     
-    auto it = _partialMessages.begin();
-    while (it != _partialMessages.end())
+    auto it = shard.partialMessages.begin();
+    while (it != shard.partialMessages.end())
     {
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
             now - it->second.firstFragmentTime).count();
@@ -205,20 +600,218 @@ void HighBandwidthSubscriber::cleanupStaleMessages()
         if (elapsed > _reassemblyTimeoutMs)
         {
             // Discard incomplete message
-            it = _partialMessages.erase(it);
+            ++shard.counters.expiredMessages;
+            releaseBuffer(shard, std::move(it->second.data));
+            it = shard.partialMessages.erase(it);
+            continue;
         }
-        else
+
+        // Ask the publisher again for what is still missing
+        PartialMessage &partial = it->second;
+        const auto sinceRequest = now - std::max(partial.firstFragmentTime, partial.lastNackTime);
+        if (_nackIntervalMs > 0 && partial.source.sin_family == AF_INET &&
+            sinceRequest >= std::chrono::milliseconds(_nackIntervalMs))
+        {
+            sendNack(shard, it->first, partial);
+            partial.lastNackTime = now;
+        }
+        ++it;
+    }
+    return enforceMemoryBudget(shard);
+}
+
+size_t HighBandwidthSubscriber::enforceMemoryBudget(Shard &shard)
+{
+    size_t pooled = 0;
+    for (const auto &buffer : shard.bufferPool)
+    {
+        pooled += buffer.capacity();
+    }
+    size_t held = pooled;
+    for (const auto &entry : shard.partialMessages)
+    {
+        held += reassemblyBytes(entry.second);
+    }
+
+    const size_t budget = _reassemblyMemory.budget();
+    const size_t share = budget / _shards.size();
+    if (budget == 0 || held <= share)
+    {
+        return held;
+    }
+
+    // Idle buffers go first, then the oldest incomplete messages
+    _reassemblyMemory.recordRelief();
+    shard.bufferPool.clear();
+    held -= pooled;
+
+    std::vector<std::pair<std::chrono::steady_clock::time_point, uint32_t>> byAge;
+    byAge.reserve(shard.partialMessages.size());
+    for (const auto &[messageId, partial] : shard.partialMessages)
+    {
+        byAge.emplace_back(partial.firstFragmentTime, messageId);
+    }
+    std::sort(byAge.begin(), byAge.end());
+    for (const auto &entry : byAge)
+    {
+        if (held <= share)
         {
-            ++it;
+            break;
         }
+        const auto it = shard.partialMessages.find(entry.second);
+        held -= reassemblyBytes(it->second);
+        shard.partialMessages.erase(it);
+        shard.counters.evictedMessages.fetch_add(1, std::memory_order_relaxed);
     }
+    return held;
+}
+
+HighBandwidthSubscriber::Shard &HighBandwidthSubscriber::shardFor(const uint8_t *datagram)
+{
+    // Byte 0 is the low byte of the message ID (the steering program reads the same byte)
+    return *_shards[datagram[0] % _shards.size()];
 }
 
 void HighBandwidthSubscriber::processFragment(const uint8_t *data, size_t len)
 {
+    if (len >= sizeof(FragmentHeader))
+    {
+        processFragment(shardFor(data), data, len);
+    }
+}
+
+void HighBandwidthSubscriber::sendNack(Shard &shard, uint32_t messageId, PartialMessage &partial)
+{
+    std::array<uint8_t, sizeof(NackHeader) + (MAX_NACK_FRAGMENTS * sizeof(uint16_t))> nack{};
+    uint16_t count = 0;
+    for (size_t fragNum = 0; fragNum < partial.totalFragments && count < MAX_NACK_FRAGMENTS; ++fragNum)
+    {
+        if (!hasFragment(partial, fragNum))
+        {
+            const auto value = static_cast<uint16_t>(fragNum);
+            std::memcpy(nack.data() + sizeof(NackHeader) + (count * sizeof(uint16_t)), &value, sizeof(value));
+            ++count;
+        }
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    const NackHeader header{NACK_MAGIC, messageId, count, 0};
+    std::memcpy(nack.data(), &header, sizeof(header));
+
+    if (sendto(shard.socket, nack.data(), sizeof(NackHeader) + (count * sizeof(uint16_t)), 0,
+               reinterpret_cast<const sockaddr*>(&partial.source), sizeof(partial.source)) >= 0)
+    {
+        ++_nacksSent;
+        _nackedFragments += count;
+    }
+}
+
+void HighBandwidthSubscriber::rememberCompleted(Shard &shard, uint32_t messageId)
+{
+    if (shard.completed.insert(messageId).second)
+    {
+        shard.completedOrder.push_back(messageId);
+        if (shard.completedOrder.size() > COMPLETED_HISTORY)
+        {
+            shard.completed.erase(shard.completedOrder.front());
+            shard.completedOrder.pop_front();
+        }
+    }
+}
+
+void HighBandwidthSubscriber::trackSource(const sockaddr_in *source, uint32_t messageId)
+{
+    if (source == nullptr || source->sin_family != AF_INET)
+    {
+        return;
+    }
+    const uint64_t key = (uint64_t{ntohl(source->sin_addr.s_addr)} << 16) | ntohs(source->sin_port);
+    const std::lock_guard<std::mutex> lock(_sourcesMutex);
+    auto [it, added] = _sources.try_emplace(key);
+    SourceState &state = it->second;
+    if (!added)
+    {
+        // Wrapping distance from the highest ID seen
+        const uint32_t ahead = messageId - state.highestId;
+        const uint32_t behind = state.highestId - messageId;
+        if (ahead != 0 && ahead < SOURCE_RESTART_WINDOW)
+        {
+            state.missingIds += ahead - 1;
+            state.highestId = messageId;
+        }
+        else if (behind != 0 && behind < SOURCE_RESTART_WINDOW)
+        {
+            // Reordered, or a message counted missing arrived after all
+            ++state.lateIds;
+            state.missingIds -= std::min<uint64_t>(state.missingIds, 1);
+        }
+        else if (ahead != 0)
+        {
+            state.highestId = messageId;   // Publisher restarted its IDs
+        }
+    }
+    else
+    {
+        state.highestId = messageId;
+    }
+    ++state.messages;
+}
+
+HighBandwidthSubscriber::Stats HighBandwidthSubscriber::stats() const
+{
+    Stats stats;
+    for (const auto &shard : _shards)
+    {
+        const Shard::Counters &counters = shard->counters;
+        stats.datagramsReceived += counters.datagrams.load(std::memory_order_relaxed);
+        stats.bytesReceived += counters.bytes.load(std::memory_order_relaxed);
+        stats.messagesReceived += counters.messages.load(std::memory_order_relaxed);
+        stats.droppedFragments += counters.droppedFragments.load(std::memory_order_relaxed);
+        stats.duplicateFragments += counters.duplicateFragments.load(std::memory_order_relaxed);
+        stats.expiredMessages += counters.expiredMessages.load(std::memory_order_relaxed);
+        stats.discardedMessages += counters.discardedMessages.load(std::memory_order_relaxed);
+        stats.evictedMessages += counters.evictedMessages.load(std::memory_order_relaxed);
+    }
+    stats.recoveredFragments = recoveredFragmentCount();
+    stats.recoveredMessages = recoveredMessageCount();
+    stats.nacksSent = nackCount();
+    stats.nackedFragments = nackedFragmentCount();
+    stats.handlerQueueDrops = droppedMessageCount();
+    stats.reassemblyTime = _reassemblyTime.summary();
+
+    const std::lock_guard<std::mutex> lock(_sourcesMutex);
+    stats.sources.reserve(_sources.size());
+    for (const auto &[key, state] : _sources)
+    {
+        in_addr address{};
+        address.s_addr = htonl(static_cast<uint32_t>(key >> 16));
+        std::array<char, INET_ADDRSTRLEN> text{};
+        inet_ntop(AF_INET, &address, text.data(), text.size());
+
+        SourceStats source;
+        source.address = std::string(text.data()) + ":" + std::to_string(key & 0xFFFF);
+        source.messages = state.messages;
+        source.missingIds = state.missingIds;
+        source.lateIds = state.lateIds;
+        source.lastMessageId = state.highestId;
+        stats.sources.push_back(std::move(source));
+    }
+    return stats;
+}
+
+void HighBandwidthSubscriber::processFragment(Shard &shard, const uint8_t *data, size_t len,
+                                              const sockaddr_in *source)
+{
+    Shard::Counters &counters = shard.counters;
+    counters.datagrams.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(len, std::memory_order_relaxed);
+
     // Validate minimum packet size
     if (len < sizeof(FragmentHeader))
     {
+        ++counters.droppedFragments;
         return;  // Too small to be a valid fragment
     }
 
@@ -230,82 +823,360 @@ void HighBandwidthSubscriber::processFragment(const uint8_t *data, size_t len)
     const std::uint16_t fragNum = header->fragmentNum;
     const std::uint16_t totalFrags = header->totalFragments;
     const std::uint16_t topicLen = header->topicLen;
+    const bool isParity = (header->fec & FEC_PARITY_FLAG) != 0;
+
+    if (fragNum >= totalFrags)
+    {
+        ++counters.droppedFragments;
+        return;  // Malformed
+    }
 
-    const std::lock_guard<std::mutex> lock(_reassemblyMutex);
+    // Unfragmented message: deliver straight from the receive buffer
+    if (totalFrags == 1)
+    {
+        if (topicLen > payloadLen || isParity)
+        {
+            ++counters.droppedFragments;
+            return;
+        }
+        trackSource(source, messageId);
+        counters.messages.fetch_add(1, std::memory_order_relaxed);
+        const auto* chars = reinterpret_cast<const char*>(payload);
+        deliverMessage(std::string_view(chars, topicLen),
+                       std::string_view(chars + topicLen, payloadLen - topicLen));
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(shard.reassemblyMutex);
     // Get or create partial message entry
-    auto &partial = _partialMessages[messageId];
+    auto it = shard.partialMessages.try_emplace(messageId).first;
+    auto &partial = it->second;
     
-    if (partial.fragments.empty())
+    if (partial.totalFragments == 0)
     {
+        if (_nackIntervalMs > 0 && shard.completed.contains(messageId))
+        {
+            // Late retransmission of a delivered message
+            ++counters.duplicateFragments;
+            shard.partialMessages.erase(it);
+            return;
+        }
+        trackSource(source, messageId);
         // First fragment for this message ID
         partial.totalFragments = totalFrags;
-        partial.fragments.resize(totalFrags);
+        partial.receivedBits.assign(static_cast<size_t>((totalFrags + 63) / 64), 0);
         partial.firstFragmentTime = std::chrono::steady_clock::now();
+        if (source != nullptr)
+        {
+            partial.source = *source;
+        }
     }
 
     // Check consistency
-    if (partial.totalFragments != totalFrags)
+    const uint16_t groupSize = header->fec & FEC_GROUP_MASK;
+    if (partial.totalFragments != totalFrags || (groupSize != 0 && partial.fecGroupSize != 0 &&
+                                                 partial.fecGroupSize != groupSize))
     {
         // Inconsistent fragment count - discard
-        _partialMessages.erase(messageId);
+        ++counters.droppedFragments;
+        ++counters.discardedMessages;
+        releaseBuffer(shard, std::move(partial.data));
+        shard.partialMessages.erase(it);
         return;
     }
-
-    // Check if we already have this fragment
-    if (partial.receivedFragments.contains(fragNum))
+    if (groupSize != 0 && partial.fecGroupSize == 0)
     {
-        return;  // Duplicate
+        partial.fecGroupSize = groupSize;
+        partial.parity.resize(static_cast<size_t>((totalFrags + groupSize - 1) / groupSize));
+        partial.parityLengthXor.resize(partial.parity.size());
     }
 
-    // Process fragment content
-    if (fragNum == 0)
+    bool consistent = true;
+    size_t group = 0;
+    if (isParity)
     {
-        // First fragment contains topic
-        if (topicLen > payloadLen)
+        group = fragNum;
+        if (groupSize == 0 || group >= partial.parity.size())
+        {
+            consistent = false;
+        }
+        else if (!partial.parity[group].empty())
         {
-            _partialMessages.erase(messageId);
+            ++counters.duplicateFragments;
             return;
         }
-        partial.topic = std::string(reinterpret_cast<const char*>(payload), topicLen);
-        partial.fragments[0] = std::string(reinterpret_cast<const char*>(payload + topicLen), 
-                                            payloadLen - topicLen);
+        else
+        {
+            consistent = addParity(partial, *header, payload, payloadLen);
+        }
     }
     else
     {
-        partial.fragments[fragNum] = std::string(reinterpret_cast<const char*>(payload), payloadLen);
+        // Check if we already have this fragment
+        if (hasFragment(partial, fragNum))
+        {
+            ++counters.duplicateFragments;
+            return;
+        }
+
+        // With parity every data fragment carries the topic length
+        if (fragNum == 0 || (groupSize != 0 && partial.topicLen == 0))
+        {
+            partial.topicLen = topicLen;
+        }
+        if (partial.data.empty() && fragNum + 1 < totalFrags)
+        {
+            partial.data = takeBuffer(shard);
+        }
+        consistent = placeFragment(partial, fragNum, payload, payloadLen);
+        if (consistent)
+        {
+            partial.receivedBits[fragNum / 64] |= uint64_t{1} << (fragNum % 64);
+            ++partial.receivedCount;
+        }
+        group = (partial.fecGroupSize != 0) ? fragNum / partial.fecGroupSize : 0;
+    }
+
+    if (consistent && partial.fecGroupSize != 0 && partial.receivedCount < totalFrags)
+    {
+        if (partial.data.empty())
+        {
+            partial.data = takeBuffer(shard);
+        }
+        consistent = recoverFragment(partial, group);
+    }
+    if (!consistent)
+    {
+        ++counters.droppedFragments;
+        ++counters.discardedMessages;
+        releaseBuffer(shard, std::move(partial.data));
+        shard.partialMessages.erase(it);
+        return;
     }
 
-    partial.receivedFragments.insert(fragNum);
     // Check if message is complete
-    if (partial.receivedFragments.size() == totalFrags)
+    if (partial.receivedCount == totalFrags)
     {
-        // Reassemble payload
-        std::string fullPayload;
-        for (const auto &frag : partial.fragments)
+        if (partial.topicLen > partial.totalSize)
+        {
+            ++counters.discardedMessages;
+            releaseBuffer(shard, std::move(partial.data));
+            shard.partialMessages.erase(it);
+            return;
+        }
+        _reassemblyTime.record(std::chrono::steady_clock::now() - partial.firstFragmentTime);
+        counters.messages.fetch_add(1, std::memory_order_relaxed);
+        if (partial.recoveredCount > 0)
         {
-            fullPayload += frag;
+            _recoveredFragments += partial.recoveredCount;
+            ++_recoveredMessages;
         }
-
-        const std::string topic = partial.topic;
-        _partialMessages.erase(messageId);
+        if (_nackIntervalMs > 0)
+        {
+            rememberCompleted(shard, messageId);
+        }
+        std::string assembled = std::move(partial.data);
+        const size_t msgTopicLen = partial.topicLen;
+        const size_t totalSize = partial.totalSize;
+        shard.partialMessages.erase(it);
 
         // Release lock before calling handler
-        _reassemblyMutex.unlock();
-        deliverMessage(topic, fullPayload);
-        _reassemblyMutex.lock();
+        lock.unlock();
+        deliverMessage(std::string_view(assembled.data(), msgTopicLen),
+                       std::string_view(assembled.data() + msgTopicLen, totalSize - msgTopicLen));
+        lock.lock();
+        releaseBuffer(shard, std::move(assembled));
+    }
+}
+
+bool HighBandwidthSubscriber::addParity(PartialMessage &partial, const FragmentHeader &header,
+                                        const uint8_t *data, size_t len)
+{
+    if (len == 0)
+    {
+        return false;
+    }
+    const size_t group = header.fragmentNum;
+    partial.parity[group].assign(reinterpret_cast<const char*>(data), len);
+    partial.parityLengthXor[group] = header.topicLen;
+    return true;
+}
+
+bool HighBandwidthSubscriber::recoverFragment(PartialMessage &partial, size_t group)
+{
+    const std::string &parity = partial.parity[group];
+    const size_t first = group * partial.fecGroupSize;
+    const size_t end = std::min<size_t>(first + partial.fecGroupSize, partial.totalFragments);
+    const size_t lastFrag = partial.totalFragments - 1U;
+
+    size_t missing = end;
+    for (size_t fragNum = first; fragNum < end; ++fragNum)
+    {
+        if (!hasFragment(partial, fragNum))
+        {
+            if (missing != end)
+            {
+                return true;  // More than one missing: wait for more fragments
+            }
+            missing = fragNum;
+        }
+    }
+    if (missing == end || parity.empty())
+    {
+        return true;  // Nothing to rebuild, or no parity yet
+    }
+    // The missing fragment's offset must be known, unless it is the last
+    if (missing != lastFrag && partial.fragmentSize == 0)
+    {
+        // The parity body is as long as the group's full fragments
+        partial.fragmentSize = parity.size();
+        partial.data.resize(partial.totalFragments * parity.size());
+        if (hasFragment(partial, lastFrag) && partial.totalSize == 0)
+        {
+            const std::string last = std::move(partial.pendingLast);
+            if (!placeFragment(partial, static_cast<uint16_t>(lastFrag),
+                               reinterpret_cast<const uint8_t*>(last.data()), last.size()))
+            {
+                return false;
+            }
+        }
+    }
+
+    // XOR the parity with every other fragment of the group
+    std::string rebuilt = parity;
+    uint16_t length = partial.parityLengthXor[group];
+    for (size_t fragNum = first; fragNum < end; ++fragNum)
+    {
+        if (fragNum == missing)
+        {
+            continue;
+        }
+        std::string_view body;
+        if (fragNum != lastFrag)
+        {
+            body = std::string_view(partial.data).substr(fragNum * partial.fragmentSize, partial.fragmentSize);
+        }
+        else if (partial.totalSize == 0)
+        {
+            body = partial.pendingLast;
+        }
+        else
+        {
+            body = std::string_view(partial.data).substr(lastFrag * partial.fragmentSize,
+                                                         partial.totalSize - (lastFrag * partial.fragmentSize));
+        }
+        if (body.size() > rebuilt.size())
+        {
+            return false;
+        }
+        for (size_t b = 0; b < body.size(); ++b)
+        {
+            rebuilt[b] = static_cast<char>(rebuilt[b] ^ body[b]);
+        }
+        length ^= static_cast<uint16_t>(body.size());
     }
+    if (length > rebuilt.size() ||
+        !placeFragment(partial, static_cast<uint16_t>(missing),
+                       reinterpret_cast<const uint8_t*>(rebuilt.data()), length))
+    {
+        return false;
+    }
+    partial.receivedBits[missing / 64] |= uint64_t{1} << (missing % 64);
+    ++partial.receivedCount;
+    ++partial.recoveredCount;
+    return true;
 }
 
-void HighBandwidthSubscriber::deliverMessage(const std::string &topic, const std::string &payload)
+bool HighBandwidthSubscriber::placeFragment(PartialMessage &partial, uint16_t fragNum,
+                                            const uint8_t *data, size_t len)
 {
-    MessageHandler handler;
+    const size_t lastFrag = partial.totalFragments - 1U;
+    if (fragNum == lastFrag)
+    {
+        if (partial.fragmentSize == 0)
+        {
+            // Offset unknown until a full fragment arrives
+            partial.pendingLast.assign(reinterpret_cast<const char*>(data), len);
+            return true;
+        }
+        if (len > partial.fragmentSize)
+        {
+            return false;
+        }
+        std::memcpy(partial.data.data() + (lastFrag * partial.fragmentSize), data, len);
+        partial.totalSize = (lastFrag * partial.fragmentSize) + len;
+        return true;
+    }
+
+    // Every other fragment is full: fragment 0 carries topic + payload
+    if (partial.fragmentSize == 0)
+    {
+        if (len == 0)
+        {
+            return false;
+        }
+        partial.fragmentSize = len;
+        // A pooled buffer keeps its size, so only bytes beyond it are zero-filled
+        partial.data.resize(partial.totalFragments * len);
+    }
+    if (len != partial.fragmentSize)
+    {
+        return false;
+    }
+    std::memcpy(partial.data.data() + (fragNum * partial.fragmentSize), data, len);
+
+    // Place a last fragment that arrived first
+    const bool lastPending = (partial.receivedBits[lastFrag / 64] & (uint64_t{1} << (lastFrag % 64))) != 0;
+    if (lastPending && partial.totalSize == 0)
+    {
+        const std::string last = std::move(partial.pendingLast);
+        return placeFragment(partial, static_cast<uint16_t>(lastFrag),
+                             reinterpret_cast<const uint8_t*>(last.data()), last.size());
+    }
+    return true;
+}
+
+std::string HighBandwidthSubscriber::takeBuffer(Shard &shard)
+{
+    if (shard.bufferPool.empty())
+    {
+        return {};
+    }
+    std::string buffer = std::move(shard.bufferPool.back());
+    shard.bufferPool.pop_back();
+    return buffer;
+}
+
+void HighBandwidthSubscriber::releaseBuffer(Shard &shard, std::string buffer)
+{
+    if (!buffer.empty() && shard.bufferPool.size() < MAX_POOLED_BUFFERS)
+    {
+        shard.bufferPool.push_back(std::move(buffer));
+    }
+}
+
+void HighBandwidthSubscriber::deliverMessage(std::string_view topic, std::string_view payload)
+{
+    MessageViewHandler handler;
     {
         const std::lock_guard<std::mutex> lock(_handlersMutex);
         auto it = _handlers.find(topic);
-        if (it != _handlers.end())
+        if (it == _handlers.end())
         {
-            handler = it->second;
+            return;
+        }
+        if (it->second.queue)
+        {
+            // Handed to the executor: the receive thread only copies
+            if (!it->second.queue->push(topic, payload))
+            {
+                ++_droppedMessages;
+                GPWARN_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND,
+                               "Dropped message on {}: handler queue full", topic);
+            }
+            return;
         }
+        handler = it->second.handler;
     }
 
     if (handler)
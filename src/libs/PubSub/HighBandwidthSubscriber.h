@@ -3,32 +3,60 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <netinet/in.h>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <LatencyHistogram.h>
+#include <MemoryBudget.h>
+#include <TimerWheel.h>
+
 // Forward declaration - FragmentHeader is defined in HighBandwidthPublisher.h
 struct FragmentHeader;
 
+namespace CommonUtils
+{
+class TaskPool;
+}
+
 /**
  * @class PartialMessage
  * @brief Structure to hold partially reassembled messages.
  *
  * Used internally to buffer incoming fragments until a complete
- * message can be reconstructed and delivered.
+ * message can be reconstructed and delivered.  Fragments are copied
+ * once, straight into one contiguous buffer laid out as on the wire
+ * (topic, then payload): every fragment but the last carries
+ * `fragmentSize` bytes, so fragment k lands at k × fragmentSize.
+ * Parity fragments (see FragmentHeader) are kept per group until the
+ * group is complete, so one missing fragment per group can be rebuilt.
  */
 struct PartialMessage
 {
-    std::string                  topic;                      ///< Topic extracted from fragment 0
-    std::vector<std::string>     fragments;                  ///< Fragment payloads indexed by fragment number
-    std::unordered_set<uint16_t> receivedFragments;          ///< Set of received fragment numbers
-    uint16_t                     totalFragments;             ///< Expected total number of fragments
+    std::string                  data;                       ///< Topic + payload (pooled buffer)
+    std::vector<uint64_t>        receivedBits;               ///< Bitset of received fragment numbers
+    uint16_t                     receivedCount{0};           ///< Number of fragments received
+    uint16_t                     totalFragments{0};          ///< Expected total number of fragments
+    uint16_t                     topicLen{0};                ///< Topic length from fragment 0
+    size_t                       fragmentSize{0};            ///< Bytes per non-last fragment (0 = not yet known)
+    size_t                       totalSize{0};               ///< Topic + payload bytes (known once the last fragment is placed)
+    std::string                  pendingLast;                ///< Last fragment if it arrived before fragmentSize was known
+    uint16_t                     fecGroupSize{0};            ///< Data fragments per parity group (0 = no parity seen)
+    std::vector<std::string>     parity;                     ///< Parity body per group (empty = not received)
+    std::vector<uint16_t>        parityLengthXor;            ///< XOR of each group's fragment lengths
+    uint16_t                     recoveredCount{0};          ///< Fragments rebuilt from parity
+    sockaddr_in                  source{};                   ///< Publisher address (sin_family 0 = unknown)
+    std::chrono::steady_clock::time_point lastNackTime;      ///< When missing fragments were last requested
     std::chrono::steady_clock::time_point firstFragmentTime; ///< Timestamp of first fragment arrival
 };
 
@@ -39,6 +67,47 @@ struct PartialMessage
  * This class provides fast message reception optimized for high-bandwidth,
  * high-frequency data. It uses raw UDP multicast sockets and handles
  * automatic reassembly of fragmented messages.
+ *
+ * The receive thread drains the socket with `recvmmsg` into a preallocated
+ * ring of RECEIVE_BATCH datagram slots, so one wake-up takes in up to that
+ * many fragments with a single syscall.  Datagrams larger than a slot
+ * (see setMaxDatagramSize()) are dropped and reported.
+ *
+ * setShardCount() spreads reception over N `SO_REUSEPORT` sockets, each
+ * with its own receive thread and the reassembly state of the message IDs
+ * it owns (by the ID's low byte), so reassembly and handlers run on N
+ * cores.  Every socket gets its own copy of a multicast datagram and drops
+ * the ones it does not own; unicast datagrams are steered to the owner by
+ * a reuseport BPF program.  Handlers may then run concurrently.
+ *
+ * By default handlers run on the receive thread.  setHandlerExecutor()
+ * moves them to a TaskPool: each completed message is copied into its
+ * topic's bounded queue, so the receive thread only does I/O and
+ * reassembly, and messages of one topic are still handled in order and
+ * never concurrently.
+ *
+ * With setNackInterval() a message still missing fragments after the
+ * interval is NACKed (see NackHeader) to the publisher's address, every
+ * interval until the reassembly timeout; a publisher in reliable mode
+ * resends just those fragments.  Fragments of a message completed
+ * recently are then ignored, so late retransmissions are not delivered twice.
+ *
+ * Incomplete messages are expired (and NACKed) by a periodic timer on the
+ * shared CommonUtils::TimerWheel, never by the receive threads, so
+ * housekeeping never sits between a datagram and its handler.
+ *
+ * The reassembly state (incomplete messages and idle buffers) is accounted
+ * as MEMORY_ACCOUNT in the CommonUtils::MemoryRegistry.  When housekeeping
+ * finds it over budget, idle buffers are freed and then the oldest
+ * incomplete messages are dropped (counted as evicted) until it fits.
+ *
+ * setBusyPoll() trades a core for wake-up latency: the receive thread
+ * spins on non-blocking receives instead of sleeping in poll().
+ *
+ * stats() reports what would otherwise vanish silently: malformed and
+ * duplicate fragments, messages that expired or were discarded, the time
+ * from first fragment to complete message, and gaps in each publisher's
+ * message IDs.
  * 
  * @warning Message delivery is **unreliable**. Messages may be:
  *          - Lost entirely if any fragment is dropped
@@ -69,6 +138,14 @@ public:
      */
     using MessageHandler = std::function<void(const std::string &topic, const std::string &data)>;
 
+    /**
+     * @brief Zero-copy callback type for message handlers.
+     *
+     * @param topic The full namespaced topic string
+     * @param data The reassembled message payload; valid only during the call
+     */
+    using MessageViewHandler = std::function<void(std::string_view topic, std::string_view data)>;
+
     /**
      * @brief Construct a high-bandwidth UDP multicast subscriber.
      * 
@@ -99,16 +176,198 @@ public:
      * 
      * @note Thread-safe. Can be called before or after start().
      * 
-     * @warning The handler is called from the receive thread. Keep handlers
-     *          fast to avoid dropping incoming packets.
+     * @warning Without setHandlerExecutor() the handler is called from the
+     *          receive thread. Keep handlers fast to avoid dropping incoming
+     *          packets.
      */
     void subscribe(const std::string &topic, MessageHandler handler);
 
+    /**
+     * @brief Subscribe to a topic with a zero-copy callback handler.
+     *
+     * The handler sees the payload in the reassembly buffer (or, for a
+     * single-fragment message, the receive slot) without any copy; with
+     * setHandlerExecutor(), in the topic queue's copy.
+     *
+     * @param topic The topic name to subscribe to (without namespace prefix)
+     * @param handler Callback function invoked when a complete message is received
+     */
+    void subscribeView(const std::string &topic, MessageViewHandler handler);
+
+    /**
+     * @brief Request a socket receive buffer size, applied by start().
+     *
+     * A larger buffer absorbs bursts while handlers run.  The kernel may
+     * grant less (Linux caps it at net.core.rmem_max); see
+     * receiveBufferSize().
+     *
+     * @param bytes Requested SO_RCVBUF size; 0 keeps the OS default
+     */
+    void setReceiveBufferSize(int bytes) { _requestedReceiveBufferSize = bytes; }
+
+    /**
+     * @brief Get the socket receive buffer size actually granted.
+     * @return SO_RCVBUF as reported by the kernel after start() (Linux
+     *         reports twice the usable size), or 0 before start()
+     */
+    [[nodiscard]] int receiveBufferSize() const { return _receiveBufferSize.load(); }
+
+    /**
+     * @brief Set the largest datagram accepted, applied by start().
+     * @param bytes Size of each receive slot; must cover the publisher's MTU
+     */
+    void setMaxDatagramSize(size_t bytes) { _maxDatagramSize = bytes; }
+
+    /**
+     * @brief Set the number of receive shards (sockets + threads), used by start().
+     *
+     * @param count Number of shards, clamped to [1, MAX_SHARDS]
+     * @return false if called while running (the setting is unchanged)
+     */
+    bool setShardCount(size_t count);
+
+    /**
+     * @brief Get the number of receive shards.
+     * @return Number of sockets / receive threads used by start()
+     */
+    [[nodiscard]] size_t shardCount() const { return _shards.size(); }
+
+    static constexpr size_t MAX_SHARDS = 64;    ///< Upper bound for setShardCount()
+
+    /**
+     * @brief Run handlers on a TaskPool instead of the receive thread(s).
+     *
+     * Each topic gets a queue of `queueCapacity` messages drained by one
+     * pool task at a time.  When a topic's queue is full the newest
+     * message is dropped and counted (see droppedMessageCount()).  stop()
+     * waits until queued messages have been handled.
+     *
+     * @param pool Pool to run handlers on; nullptr runs them on the receive thread
+     * @param queueCapacity Messages queued per topic (at least 1)
+     * @return false if called while running (the setting is unchanged)
+     */
+    bool setHandlerExecutor(CommonUtils::TaskPool *pool,
+                            size_t queueCapacity = DEFAULT_HANDLER_QUEUE_CAPACITY);
+
+    /**
+     * @brief Get the number of messages dropped because a topic queue was full.
+     * @return Messages dropped since construction
+     */
+    [[nodiscard]] uint64_t droppedMessageCount() const { return _droppedMessages.load(); }
+
+    static constexpr size_t DEFAULT_HANDLER_QUEUE_CAPACITY = 256;   ///< Default setHandlerExecutor() capacity
+
+    /**
+     * @brief Request lost fragments from the publisher (reliable mode).
+     *
+     * Should be well below the reassembly timeout so several requests fit
+     * in it.  Needs a publisher with HighBandwidthPublisher::setRetransmitHistory().
+     *
+     * @param intervalMs Time a message may miss fragments before (and between)
+     *        NACKs; 0 (default) disables NACKs
+     * @return false if called while running (the setting is unchanged)
+     */
+    bool setNackInterval(int intervalMs);
+
+    /**
+     * @brief Spin on the socket instead of sleeping, for tens-of-microsecond wake-ups.
+     *
+     * The receive thread polls with non-blocking recvmmsg() calls, and
+     * sets SO_BUSY_POLL so each call also polls the device queue (raising
+     * it above net.core.busy_read needs CAP_NET_ADMIN; the spin works
+     * without).  After `spinBudgetUs` without a datagram it falls back to
+     * poll() until the next one, so an idle stream does not burn the core
+     * forever.  Pin the receive thread ("PubSub.<name>.receive[.<shard>]")
+     * to an isolated core with CommonUtils::ThreadConfig.
+     *
+     * @param spinBudgetUs Idle time spent spinning before blocking; 0 (default) disables
+     * @return false if called while running (the setting is unchanged)
+     */
+    bool setBusyPoll(int spinBudgetUs);
+
+    /**
+     * @brief Get the busy-poll spin budget.
+     * @return Microseconds set by setBusyPoll() (0 = off)
+     */
+    [[nodiscard]] int busyPollBudget() const { return _busyPollUs; }
+
+    /**
+     * @brief Get the number of NACKs sent.
+     * @return NACK datagrams sent since construction
+     */
+    [[nodiscard]] uint64_t nackCount() const { return _nacksSent.load(); }
+
+    /**
+     * @brief Get the number of fragments requested by NACKs.
+     * @return Fragment numbers listed in NACKs since construction
+     */
+    [[nodiscard]] uint64_t nackedFragmentCount() const { return _nackedFragments.load(); }
+
+    /**
+     * @brief Get the number of fragments rebuilt from parity fragments.
+     * @return Lost fragments recovered without retransmission since construction
+     */
+    [[nodiscard]] uint64_t recoveredFragmentCount() const { return _recoveredFragments.load(); }
+
+    /**
+     * @brief Get the number of messages that were only complete thanks to parity.
+     * @return Delivered messages with at least one rebuilt fragment
+     */
+    [[nodiscard]] uint64_t recoveredMessageCount() const { return _recoveredMessages.load(); }
+
+    /**
+     * @struct SourceStats
+     * @brief Message IDs seen from one publisher (sender address).
+     *
+     * IDs are counted when a message's first fragment arrives, so
+     * `missingIds` are messages of which no fragment arrived at all.
+     */
+    struct SourceStats
+    {
+        std::string address;        ///< Publisher as "ip:port"
+        uint64_t messages{0};       ///< Distinct message IDs seen
+        uint64_t missingIds{0};     ///< IDs skipped and not (yet) seen
+        uint64_t lateIds{0};        ///< IDs seen after a higher one (reordered or filled a gap)
+        uint32_t lastMessageId{0};  ///< Highest message ID seen
+    };
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the subscriber's transport counters.
+     */
+    struct Stats
+    {
+        uint64_t datagramsReceived{0};      ///< Fragments received, parity included
+        uint64_t bytesReceived{0};          ///< UDP payload bytes received
+        uint64_t messagesReceived{0};       ///< Complete messages (subscribed topic or not)
+        uint64_t droppedFragments{0};       ///< Malformed, oversized or inconsistent fragments
+        uint64_t duplicateFragments{0};     ///< Fragments received twice, or after their message completed
+        uint64_t expiredMessages{0};        ///< Incomplete messages discarded at the reassembly timeout
+        uint64_t discardedMessages{0};      ///< Incomplete messages discarded as inconsistent
+        uint64_t evictedMessages{0};        ///< Incomplete messages dropped to fit the memory budget
+        uint64_t recoveredFragments{0};     ///< See recoveredFragmentCount()
+        uint64_t recoveredMessages{0};      ///< See recoveredMessageCount()
+        uint64_t nacksSent{0};              ///< See nackCount()
+        uint64_t nackedFragments{0};        ///< See nackedFragmentCount()
+        uint64_t handlerQueueDrops{0};      ///< See droppedMessageCount()
+        CommonUtils::LatencySummary reassemblyTime;   ///< First fragment to complete message (multi-fragment only)
+        std::vector<SourceStats> sources;   ///< Per publisher, in no particular order
+    };
+
+    /**
+     * @brief Get the transport counters.
+     * @return Counters since construction; safe to call while receiving
+     */
+    [[nodiscard]] Stats stats() const;
+
+    /// CommonUtils::MemoryRegistry name of the reassembly state's account.
+    static constexpr const char *MEMORY_ACCOUNT = "pubsub.reassembly";
+
     /**
      * @brief Start receiving messages.
      * 
-     * Creates the UDP socket, joins the multicast group, and starts the
-     * background receive thread.
+     * Creates the UDP socket(s), joins the multicast group, and starts the
+     * background receive thread(s).
      * 
      * @return true if started successfully
      * @return false if socket creation or multicast join failed
@@ -118,7 +377,8 @@ public:
     /**
      * @brief Stop receiving messages.
      * 
-     * Signals the receive thread to stop and waits for it to exit.
+     * Signals the receive thread to stop and waits for it to exit, then
+     * for queued messages to be handled (see setHandlerExecutor()).
      * Incomplete messages in the reassembly buffer are discarded.
      */
     void stop();
@@ -134,46 +394,248 @@ public:
      */
     [[nodiscard]] std::uint16_t port() const { return _port; }
 private:
+    /**
+     * @struct Shard
+     * @brief One receive socket and thread, with the reassembly state of
+     *        the message IDs it owns.
+     */
+    struct Shard
+    {
+        /// Transport counters, per shard so receive threads never share a cache line
+        struct Counters
+        {
+            std::atomic<uint64_t> datagrams{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> messages{0};
+            std::atomic<uint64_t> droppedFragments{0};
+            std::atomic<uint64_t> duplicateFragments{0};
+            std::atomic<uint64_t> expiredMessages{0};
+            std::atomic<uint64_t> discardedMessages{0};
+            std::atomic<uint64_t> evictedMessages{0};
+        };
+
+        size_t index{0};                                              ///< Position in _shards
+        int socket{-1};                                               ///< UDP socket file descriptor
+        std::thread receiveThread;                                    ///< Background receive thread
+        std::unordered_map<uint32_t, PartialMessage> partialMessages; ///< Reassembly buffer
+        std::mutex reassemblyMutex;                                   ///< Protects reassembly state
+        std::vector<std::string> bufferPool;                          ///< Idle reassembly buffers
+        std::unordered_set<uint32_t> completed;                       ///< Recently delivered IDs (NACKs on)
+        std::deque<uint32_t> completedOrder;                          ///< Same IDs, oldest first
+        Counters counters;                                            ///< See stats()
+    };
+
+    /**
+     * @struct SourceState
+     * @brief Message ID tracking for one publisher.
+     */
+    struct SourceState
+    {
+        uint64_t messages{0};       ///< Distinct message IDs seen
+        uint64_t missingIds{0};     ///< IDs skipped and not seen since
+        uint64_t lateIds{0};        ///< IDs below the highest seen
+        uint32_t highestId{0};      ///< Highest message ID seen
+    };
+
+    class TopicQueue;
+
+    /**
+     * @struct Subscription
+     * @brief A topic's handler and, with a handler executor, its queue.
+     */
+    struct Subscription
+    {
+        MessageViewHandler handler;         ///< Handler called inline (no executor)
+        std::shared_ptr<TopicQueue> queue;  ///< Executor queue, or nullptr
+    };
+
+    /**
+     * @brief Create, bind and join one receive socket.
+     * @param reportReceiveBuffer Record the SO_RCVBUF granted for this socket
+     * @return The socket, or -1 on failure
+     */
+    int openSocket(bool reportReceiveBuffer);
+
+    /**
+     * @brief Close every shard's socket.
+     */
+    void closeSockets();
+
     /**
      * @brief Background thread function for receiving packets.
+     * @param shard The shard whose socket this thread drains
      */
-    void receiveLoop();
+    void receiveLoop(Shard &shard);
 
     /**
-     * @brief Clean up incomplete messages that have timed out.
+     * @brief Wait for the next datagram, spinning first in busy-poll mode.
+     * @param shard The shard whose socket to wait on
+     * @param lastDatagram When the shard last received a datagram
+     * @return true if the socket is readable (or may be: busy poll), false on timeout
+     */
+    bool waitForDatagrams(Shard &shard, std::chrono::steady_clock::time_point lastDatagram) const;
+
+    /**
+     * @brief Clean up incomplete messages that have timed out, in every shard,
+     *        and report the reassembly memory.
+     *
+     * Runs on the timer wheel every housekeepingIntervalMs() while started.
      */
     void cleanupStaleMessages();
 
     /**
-     * @brief Process a received fragment and reassemble if complete.
+     * @brief Clean up incomplete messages that have timed out.
+     * @param shard The shard to clean up
+     * @return Bytes the shard's reassembly state holds afterwards
+     */
+    size_t cleanupStaleMessages(Shard &shard);
+
+    /**
+     * @brief Free idle buffers, then the oldest incomplete messages, until
+     *        the shard is within its share of the memory budget (its
+     *        reassembly lock held).
+     * @param shard The shard to trim
+     * @return Bytes the shard's reassembly state holds afterwards
+     */
+    size_t enforceMemoryBudget(Shard &shard);
+
+    /**
+     * @brief Get the stale cleanup period.
+     * @return HOUSEKEEPING_INTERVAL_MS, or faster so NACKs are sent on time
+     */
+    [[nodiscard]] int housekeepingIntervalMs() const;
+
+    /**
+     * @brief Get the shard that owns a datagram's message ID.
+     * @param datagram Raw datagram (at least a FragmentHeader)
+     */
+    Shard &shardFor(const uint8_t *datagram);
+
+    /**
+     * @brief Process a received fragment in its owning shard.
      * @param data Pointer to raw packet data
      * @param len Length of packet data
      */
     void processFragment(const uint8_t *data, size_t len);
 
+    /**
+     * @brief Process a received fragment and reassemble if complete.
+     * @param shard The shard owning the fragment's message ID
+     * @param data Pointer to raw packet data
+     * @param len Length of packet data
+     * @param source Sender address, kept for NACKs (nullptr = unknown)
+     */
+    void processFragment(Shard &shard, const uint8_t *data, size_t len, const sockaddr_in *source = nullptr);
+
+    /**
+     * @brief NACK the missing fragments of a partial message (reassembly lock held).
+     */
+    void sendNack(Shard &shard, uint32_t messageId, PartialMessage &partial);
+
+    /**
+     * @brief Remember a delivered message ID so late fragments are ignored (reassembly lock held).
+     */
+    static void rememberCompleted(Shard &shard, uint32_t messageId);
+
+    /**
+     * @brief Account a new message ID from a publisher (once per message).
+     * @param source Sender address (nullptr = unknown, not tracked)
+     * @param messageId ID of the message's first fragment to arrive
+     */
+    void trackSource(const sockaddr_in *source, uint32_t messageId);
+
     /**
      * @brief Deliver a complete message to the appropriate handler.
      * @param topic The full namespaced topic
      * @param payload The reassembled message payload
      */
-    void deliverMessage(const std::string &topic, const std::string &payload);
+    void deliverMessage(std::string_view topic, std::string_view payload);
+
+    /**
+     * @brief Copy a fragment into its partial message (reassembly lock held).
+     * @return false if the fragment is inconsistent with the message
+     */
+    static bool placeFragment(PartialMessage &partial, uint16_t fragNum, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Store a parity fragment (reassembly lock held).
+     * @return false if it is inconsistent with the message
+     */
+    static bool addParity(PartialMessage &partial, const FragmentHeader &header, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Rebuild the one missing fragment of a group from its parity (reassembly lock held).
+     * @param partial Message being reassembled
+     * @param group Parity group index
+     * @return false if the rebuilt fragment is inconsistent with the message
+     */
+    static bool recoverFragment(PartialMessage &partial, size_t group);
+
+    /**
+     * @brief Check whether a fragment has been received or rebuilt.
+     */
+    static bool hasFragment(const PartialMessage &partial, size_t fragNum)
+    {
+        return (partial.receivedBits[fragNum / 64] & (uint64_t{1} << (fragNum % 64))) != 0;
+    }
+
+    /**
+     * @brief Take a reassembly buffer from a shard's pool (its reassembly lock held).
+     */
+    static std::string takeBuffer(Shard &shard);
+
+    /**
+     * @brief Return a reassembly buffer to a shard's pool (its reassembly lock held).
+     */
+    static void releaseBuffer(Shard &shard, std::string buffer);
+
+    /// Hash allowing handler lookup by std::string_view.
+    struct TopicHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view topic) const noexcept { return std::hash<std::string_view>{}(topic); }
+    };
+
+    static constexpr size_t MAX_POOLED_BUFFERS = 8;             ///< Reassembly buffers kept for reuse
+
+    static constexpr size_t RECEIVE_BATCH = 64;                 ///< Datagram slots per recvmmsg
+    static constexpr size_t DEFAULT_MAX_DATAGRAM_SIZE = 9216;   ///< Covers jumbo-frame MTUs
+    static constexpr size_t COMPLETED_HISTORY = 1024;           ///< Delivered IDs remembered per shard
+    static constexpr int HOUSEKEEPING_INTERVAL_MS = 500;        ///< Stale cleanup period (NACKs may tick faster)
+    static constexpr int POLL_TIMEOUT_MS = 100;                 ///< Longest poll() sleep (stop checks)
+    static constexpr uint32_t SOURCE_RESTART_WINDOW = 1U << 20; ///< ID jump treated as a publisher restart
 
     std::string _name;              ///< Namespace for topic filtering
     std::string _multicastAddr;     ///< Multicast group address
     std::string _interfaceAddr;     ///< Local interface address for multicast
     uint16_t _port;                 ///< UDP port number
     int _reassemblyTimeoutMs;       ///< Timeout for incomplete messages
-    int _socket{-1};                ///< UDP socket file descriptor
     std::atomic<bool> _running{false};    ///< Running state flag
     std::atomic<bool> _shouldStop{false}; ///< Stop request flag
+    int _requestedReceiveBufferSize{0};   ///< SO_RCVBUF to request (0 = OS default)
+    std::atomic<int> _receiveBufferSize{0};   ///< SO_RCVBUF granted by the kernel
+    size_t _maxDatagramSize{DEFAULT_MAX_DATAGRAM_SIZE};   ///< Receive slot size
 
-    std::unordered_map<std::string, MessageHandler> _handlers; ///< Topic -> handler map
-    std::mutex _handlersMutex;                                  ///< Protects _handlers
+    std::unordered_map<std::string, Subscription, TopicHash, std::equal_to<>> _handlers; ///< Topic -> handler map
+    std::mutex _handlersMutex;                                  ///< Protects _handlers and the executor settings
+    CommonUtils::TaskPool *_handlerPool{nullptr};               ///< Handler executor (nullptr = inline)
+    size_t _handlerQueueCapacity{DEFAULT_HANDLER_QUEUE_CAPACITY}; ///< Messages queued per topic
+    std::atomic<uint64_t> _droppedMessages{0};                  ///< Messages dropped by full topic queues
+    std::atomic<uint64_t> _recoveredFragments{0};               ///< Fragments rebuilt from parity
+    std::atomic<uint64_t> _recoveredMessages{0};                ///< Messages completed thanks to parity
+    int _nackIntervalMs{0};                                     ///< NACK delay / period (0 = NACKs off)
+    std::atomic<uint64_t> _nacksSent{0};                        ///< NACK datagrams sent
+    std::atomic<uint64_t> _nackedFragments{0};                  ///< Fragment numbers requested
+    int _busyPollUs{0};                                         ///< Busy-poll spin budget (0 = off)
+    CommonUtils::TimerWheel::TimerId _housekeepingTimer{CommonUtils::TimerWheel::INVALID_TIMER}; ///< Stale cleanup timer
 
-    std::unordered_map<uint32_t, PartialMessage> _partialMessages; ///< Reassembly buffer
-    std::mutex _reassemblyMutex;                                    ///< Protects reassembly buffer
+    std::vector<std::unique_ptr<Shard>> _shards;                ///< Receive shards (at least one)
+    CommonUtils::MemoryAccount _reassemblyMemory{MEMORY_ACCOUNT,
+                                                 CommonUtils::MemoryRelief::DropHistory}; ///< Reassembly state at the last housekeeping
 
-    std::thread _receiveThread;     ///< Background receive thread
+    CommonUtils::LatencyHistogram _reassemblyTime;              ///< First fragment to complete message
+    std::unordered_map<uint64_t, SourceState> _sources;         ///< Address << 16 | port -> ID tracking
+    mutable std::mutex _sourcesMutex;                           ///< Protects _sources
 };
 
 #endif // HIGHBANDWIDTHSUBSCRIBER_H
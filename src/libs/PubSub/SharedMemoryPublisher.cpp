@@ -0,0 +1,89 @@
+#include "SharedMemoryPublisher.h"
+
+#include <cstring>
+#include <limits>
+
+#include "GeneralLogger.h"
+
+SharedMemoryPublisher::SharedMemoryPublisher(const std::string &name, size_t capacity) :
+    _name(name),
+    _topicPrefix(name + "/"),
+    _ring(SharedMemoryRing::create(SharedMemoryRing::segmentName(name), capacity))
+{
+    if (_ring)
+    {
+        GPINFO("SharedMemoryPublisher created with name '{}' (segment {}, {} bytes)",
+               name, SharedMemoryRing::segmentName(name), _ring->capacity());
+    }
+}
+
+SharedMemoryPublisher::~SharedMemoryPublisher() = default;
+
+bool SharedMemoryPublisher::publish(const std::string &topic, const google::protobuf::Message &message)
+{
+    const size_t size = message.ByteSizeLong();
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        GPERROR("Message too large to serialize: {} bytes", size);
+        return false;
+    }
+    // Serialize straight into the ring
+    return write(topic, size, [&message, size](uint8_t *destination) {
+        return message.SerializeToArray(destination, static_cast<int>(size));
+    });
+}
+
+bool SharedMemoryPublisher::publishBytes(std::string_view topic, const uint8_t *payload, size_t size)
+{
+    return write(topic, size, [payload, size](uint8_t *destination) {
+        if (size > 0)
+        {
+            std::memcpy(destination, payload, size);
+        }
+        return true;
+    });
+}
+
+template <typename Fill>
+bool SharedMemoryPublisher::write(std::string_view topic, size_t size, Fill &&fill)
+{
+    if (!_ring)
+    {
+        return false;
+    }
+    const size_t topicSize = _topicPrefix.size() + topic.size();
+    const size_t recordSize = sizeof(SharedMemoryMessageHeader) + topicSize + size;
+
+    const std::lock_guard<std::mutex> lock(_publishMutex);
+    uint8_t *record = _ring->reserve(recordSize);
+    if (record == nullptr)
+    {
+        ++_dropped;
+        if (recordSize > _ring->maxRecordSize())
+        {
+            GPERROR_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND,
+                            "Message on {} too large for shared memory: {} bytes (max {})",
+                            topic, recordSize, _ring->maxRecordSize());
+        }
+        else
+        {
+            GPWARN_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND,
+                           "Dropped message on {}: shared-memory ring full", topic);
+        }
+        return false;
+    }
+
+    const SharedMemoryMessageHeader header{static_cast<uint32_t>(topicSize), 0};
+    std::memcpy(record, &header, sizeof(header));
+    uint8_t *topicStart = record + sizeof(header);
+    std::memcpy(topicStart, _topicPrefix.data(), _topicPrefix.size());
+    std::memcpy(topicStart + _topicPrefix.size(), topic.data(), topic.size());
+    if (!fill(topicStart + topicSize))
+    {
+        GPERROR("Failed to serialize protobuf message");
+        return false;   // Nothing committed; the space is reused
+    }
+    _ring->commit();
+    ++_published;
+    return true;
+}
@@ -0,0 +1,135 @@
+#ifndef SHAREDMEMORYPUBLISHER_H
+#define SHAREDMEMORYPUBLISHER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <google/protobuf/message.h>
+
+#include "SharedMemoryRing.h"
+
+/**
+ * @class SharedMemoryMessageHeader
+ * @brief Prefix of every message in a SharedMemoryRing record, followed by
+ *        the namespaced topic and the payload.
+ */
+struct SharedMemoryMessageHeader
+{
+    uint32_t topicLen;       ///< Length of the namespaced topic
+    uint32_t reserved;       ///< Padding for alignment
+};
+
+/**
+ * @class SharedMemoryPublisher
+ * @brief Same-host publisher writing into a shared-memory ring.
+ *
+ * The same-host counterpart of HighBandwidthPublisher, with the same
+ * publish() API and `<name>/<topic>` namespacing: each message is
+ * serialized straight into a SharedMemoryRing segment named after the
+ * namespace (see SharedMemoryRing::segmentName()), with no fragmentation,
+ * socket or extra copy.  SharedMemorySubscriber instances on the host read
+ * it in place.
+ *
+ * Readers never see partial messages.  A message that does not fit
+ * because the slowest subscriber has not consumed enough of the ring is
+ * dropped and counted (see droppedMessageCount()): a stalled subscriber
+ * never blocks the publisher.  Size the ring for the slowest subscriber's
+ * longest stall.
+ *
+ * @note One publisher per namespace and host: a new publisher replaces the
+ *       segment, and subscribers of the old one move over to it.
+ *
+ * @see SharedMemorySubscriber for the corresponding subscriber class
+ */
+// Forward declaration for friend test class
+class SharedMemoryPublisherTest;
+
+class SharedMemoryPublisher
+{
+    friend class SharedMemoryPublisherTest;
+
+public:
+    /**
+     * @brief Construct a publisher and create its shared-memory segment.
+     *
+     * @param name Namespace for topic isolation (subscribers must use the same)
+     * @param capacity Ring bytes, rounded up to a power of two; a message may
+     *        take up to a quarter of it
+     */
+    explicit SharedMemoryPublisher(const std::string &name, size_t capacity = SharedMemoryRing::DEFAULT_CAPACITY);
+
+    /**
+     * @brief Destructor - closes and removes the segment.
+     */
+    ~SharedMemoryPublisher();
+
+    SharedMemoryPublisher(const SharedMemoryPublisher &) = delete;
+    SharedMemoryPublisher &operator=(const SharedMemoryPublisher &) = delete;
+
+    /**
+     * @brief Publish a protobuf message to a topic.
+     *
+     * @param topic The topic name (will be prefixed with namespace)
+     * @param message The protobuf message to publish
+     * @return true if the message was written to the ring
+     * @return false if the segment is unavailable, the message is too large
+     *         or the ring is full
+     *
+     * @note Thread-safe; concurrent publishers are serialized.
+     */
+    bool publish(const std::string &topic, const google::protobuf::Message &message);
+
+    /**
+     * @brief Check whether the segment was created.
+     * @return true if messages can be published
+     */
+    [[nodiscard]] bool isOpen() const { return _ring != nullptr; }
+
+    /**
+     * @brief Get the number of messages written to the ring.
+     * @return Messages published since construction
+     */
+    [[nodiscard]] uint64_t publishedCount() const { return _published.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of messages dropped because the ring was full.
+     * @return Messages dropped since construction
+     */
+    [[nodiscard]] uint64_t droppedMessageCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the namespace name.
+     * @return The namespace string
+     */
+    const std::string &name() const { return _name; }
+
+private:
+    /**
+     * @brief Reserve, fill and commit one message in the ring.
+     * @param topic Topic without namespace
+     * @param size Payload bytes
+     * @param fill Writes the payload to the given address
+     * @return false if the message was not written
+     */
+    template <typename Fill>
+    bool write(std::string_view topic, size_t size, Fill &&fill);
+
+    /**
+     * @brief Publish raw payload bytes (as publish() does after serializing).
+     */
+    bool publishBytes(std::string_view topic, const uint8_t *payload, size_t size);
+
+    std::string _name;                          ///< Namespace for topic isolation
+    std::string _topicPrefix;                   ///< "<name>/", prepended to every topic
+    std::unique_ptr<SharedMemoryRing> _ring;    ///< Shared-memory segment (nullptr = creation failed)
+    std::mutex _publishMutex;                   ///< Serializes writers (the ring has one producer)
+    std::atomic<uint64_t> _published{0};        ///< Messages written
+    std::atomic<uint64_t> _dropped{0};          ///< Messages dropped (ring full)
+};
+
+#endif // SHAREDMEMORYPUBLISHER_H
@@ -0,0 +1,357 @@
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+#include <GeneralLogger.h>
+
+namespace
+{
+
+constexpr uint32_t SEGMENT_MAGIC = 0x47505348;   // "HSPG"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr size_t CACHE_LINE = 64;
+constexpr size_t RECORD_ALIGN = 8;
+constexpr size_t MIN_CAPACITY = 4096;
+constexpr mode_t SEGMENT_MODE = 0600;   // Owner only: readers run as the producer's user
+
+constexpr uint64_t alignRecord(uint64_t bytes)
+{
+    return (bytes + RECORD_ALIGN - 1) & ~uint64_t{RECORD_ALIGN - 1};
+}
+
+bool processAlive(pid_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+long futex(std::atomic<uint32_t> *word, int op, uint32_t value, const timespec *timeout)
+{
+    // Not FUTEX_PRIVATE_FLAG: waiters and wakers are in different processes
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, timeout, nullptr, 0);
+}
+
+} // anonymous namespace
+
+// Lock-free 32/64-bit atomics are plain memory, so they work across processes.
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free);
+
+/**
+ * Layout of the mapped segment; the ring data follows it.  Fields written
+ * by different parties sit on separate cache lines.
+ */
+struct SharedMemoryRing::Segment
+{
+    struct alignas(CACHE_LINE) ReaderSlot
+    {
+        std::atomic<int32_t> pid;        ///< Owning process; 0 = free, -1 = being claimed
+        std::atomic<uint64_t> readPos;   ///< Next byte to read
+    };
+
+    std::atomic<uint32_t> magic;         ///< SEGMENT_MAGIC once initialised
+    uint32_t version;
+    uint64_t capacity;
+    int32_t producerPid;
+    std::atomic<uint32_t> closed;        ///< Set by the producer when it goes away
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> writePos;   ///< Bytes committed
+    alignas(CACHE_LINE) std::atomic<uint32_t> sequence;   ///< Futex word, bumped per commit
+    std::atomic<uint32_t> waiters;                        ///< Readers sleeping on `sequence`
+    ReaderSlot readers[MAX_READERS];
+};
+
+SharedMemoryRing::SharedMemoryRing(std::string name, Segment *segment, size_t mappedSize, bool owner) :
+    _name(std::move(name)),
+    _segment(segment),
+    _mappedSize(mappedSize),
+    _capacity(segment->capacity),
+    _owner(owner),
+    _pid(getpid())
+{
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    if (_owner)
+    {
+        _segment->closed.store(1, std::memory_order_release);
+        _segment->sequence.fetch_add(1);
+        futex(&_segment->sequence, FUTEX_WAKE, INT_MAX, nullptr);
+        shm_unlink(_name.c_str());
+    }
+    munmap(_segment, _mappedSize);
+}
+
+std::string SharedMemoryRing::segmentName(std::string_view ns)
+{
+    std::string name = "/PubSub." + std::string(ns);
+    std::replace(name.begin() + 1, name.end(), '/', '_');
+    return name;
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::create(const std::string &name, size_t capacity)
+{
+    capacity = std::bit_ceil(std::max(capacity, MIN_CAPACITY));
+    const size_t mappedSize = sizeof(Segment) + capacity;
+
+    // Readers of a segment left by an earlier producer move on to ours; a
+    // producer still running keeps its segment
+    if (auto previous = open(name))
+    {
+        if (!previous->isClosed())
+        {
+            GPERROR("Shared memory segment {} is in use by process {}", name, previous->_segment->producerPid);
+            return nullptr;
+        }
+        previous->_segment->closed.store(1, std::memory_order_release);
+        previous->_segment->sequence.fetch_add(1);
+        futex(&previous->_segment->sequence, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+    shm_unlink(name.c_str());
+
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SEGMENT_MODE);
+    if (fd < 0)
+    {
+        GPERROR("Failed to create shared memory segment {}: {}", name, errno);
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(mappedSize)) < 0)
+    {
+        GPERROR("Failed to size shared memory segment {} to {} bytes: {}", name, mappedSize, errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void *mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        GPERROR("Failed to map shared memory segment {}: {}", name, errno);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    // The file is zero-filled; readers only trust it once the magic is set
+    auto *segment = new (mapped) Segment{};
+    segment->version = SEGMENT_VERSION;
+    segment->capacity = capacity;
+    segment->producerPid = getpid();
+    segment->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(name, segment, mappedSize, true));
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::open(const std::string &name)
+{
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) < 0 || std::cmp_less(info.st_size, sizeof(Segment) + MIN_CAPACITY))
+    {
+        close(fd);   // Not (yet) sized by its producer
+        return nullptr;
+    }
+    const auto mappedSize = static_cast<size_t>(info.st_size);
+    void *mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    auto *segment = static_cast<Segment *>(mapped);
+    if (segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC || segment->version != SEGMENT_VERSION ||
+        segment->capacity != mappedSize - sizeof(Segment) || !std::has_single_bit(segment->capacity))
+    {
+        munmap(mapped, mappedSize);
+        return nullptr;
+    }
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(name, segment, mappedSize, false));
+}
+
+uint8_t *SharedMemoryRing::data() const
+{
+    return reinterpret_cast<uint8_t *>(_segment) + sizeof(Segment);
+}
+
+bool SharedMemoryRing::isClosed() const
+{
+    return _corrupt || _segment->closed.load(std::memory_order_acquire) != 0 || !processAlive(_segment->producerPid);
+}
+
+uint64_t SharedMemoryRing::slowestReader(bool reclaim)
+{
+    uint64_t slowest = _segment->writePos.load(std::memory_order_relaxed);
+    for (auto &slot : _segment->readers)
+    {
+        // Slots being claimed are skipped: attachReader() re-checks its position
+        const int32_t pid = slot.pid.load(std::memory_order_acquire);
+        if (pid <= 0)
+        {
+            continue;
+        }
+        if (reclaim && !processAlive(pid))
+        {
+            int32_t expected = pid;
+            slot.pid.compare_exchange_strong(expected, 0);
+            continue;
+        }
+        slowest = std::min(slowest, slot.readPos.load(std::memory_order_acquire));
+    }
+    return slowest;
+}
+
+uint8_t *SharedMemoryRing::reserve(size_t size)
+{
+    if (size > maxRecordSize())
+    {
+        return nullptr;
+    }
+    const uint64_t pos = _segment->writePos.load(std::memory_order_relaxed);
+    const uint64_t recordBytes = alignRecord(sizeof(RecordHeader) + size);
+    const uint64_t untilEnd = _capacity - (pos & (_capacity - 1));
+    // A record never wraps: fill the end of the ring and start over
+    const uint64_t needed = (recordBytes > untilEnd) ? untilEnd + recordBytes : recordBytes;
+
+    if (pos + needed - slowestReader(false) > _capacity && pos + needed - slowestReader(true) > _capacity)
+    {
+        return nullptr;
+    }
+
+    uint64_t recordPos = pos;
+    if (recordBytes > untilEnd)
+    {
+        auto *filler = reinterpret_cast<RecordHeader *>(data() + (pos & (_capacity - 1)));
+        filler->size = static_cast<uint32_t>(untilEnd - sizeof(RecordHeader));
+        filler->padding = 1;
+        recordPos = pos + untilEnd;
+    }
+    _reservedPos = recordPos;
+    _reservedEnd = pos + needed;
+    _reservedSize = size;
+    return data() + (recordPos & (_capacity - 1)) + sizeof(RecordHeader);
+}
+
+void SharedMemoryRing::commit()
+{
+    auto *header = reinterpret_cast<RecordHeader *>(data() + (_reservedPos & (_capacity - 1)));
+    header->size = static_cast<uint32_t>(_reservedSize);
+    header->padding = 0;
+    _segment->writePos.store(_reservedEnd, std::memory_order_release);
+
+    // Pairs with waitForData(): a reader registered as waiting either sees
+    // the new sequence or is woken
+    _segment->sequence.fetch_add(1);
+    if (_segment->waiters.load() > 0)
+    {
+        futex(&_segment->sequence, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+}
+
+int SharedMemoryRing::attachReader()
+{
+    for (size_t i = 0; i < MAX_READERS; ++i)
+    {
+        auto &slot = _segment->readers[i];
+        int32_t expected = 0;
+        if (!slot.pid.compare_exchange_strong(expected, -1))
+        {
+            continue;
+        }
+        slot.readPos.store(_segment->writePos.load(std::memory_order_acquire), std::memory_order_release);
+        slot.pid.store(_pid, std::memory_order_release);
+        // The producer may have lapped the position before it saw the slot
+        const uint64_t writePos = _segment->writePos.load(std::memory_order_acquire);
+        if (writePos - slot.readPos.load(std::memory_order_relaxed) > _capacity)
+        {
+            slot.readPos.store(writePos, std::memory_order_release);
+        }
+        _peekedEnd[i] = 0;
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void SharedMemoryRing::detachReader(int reader)
+{
+    _segment->readers[reader].pid.store(0, std::memory_order_release);
+}
+
+std::span<const uint8_t> SharedMemoryRing::peek(int reader)
+{
+    auto &slot = _segment->readers[reader];
+    uint64_t pos = slot.readPos.load(std::memory_order_relaxed);
+    const uint64_t writePos = _segment->writePos.load(std::memory_order_acquire);
+    while (pos != writePos && !_corrupt)
+    {
+        // Every field here is shared memory: check it before trusting it
+        const size_t offset = pos & (_capacity - 1);
+        if (writePos - pos > _capacity || offset % RECORD_ALIGN != 0)
+        {
+            markCorrupt(pos);
+            break;
+        }
+        const auto *header = reinterpret_cast<const RecordHeader *>(data() + offset);
+        const RecordHeader record{header->size, header->padding};
+        const uint64_t end = pos + alignRecord(sizeof(RecordHeader) + record.size);
+        // Records stop at the end of the ring; only filler reaches it
+        if ((record.padding == 0 && record.size > maxRecordSize()) ||
+            offset + sizeof(RecordHeader) + record.size > _capacity || end > writePos)
+        {
+            markCorrupt(pos);
+            break;
+        }
+        if (record.padding != 0)
+        {
+            pos = end;
+            slot.readPos.store(pos, std::memory_order_release);
+            continue;
+        }
+        _peekedEnd[reader] = end;
+        return {reinterpret_cast<const uint8_t *>(header + 1), record.size};
+    }
+    return {};
+}
+
+void SharedMemoryRing::markCorrupt(uint64_t pos)
+{
+    _corrupt = true;
+    GPERROR("Shared memory segment {} has a corrupt record at {}; closing it", _name, pos);
+}
+
+void SharedMemoryRing::consume(int reader)
+{
+    _segment->readers[reader].readPos.store(_peekedEnd[reader], std::memory_order_release);
+}
+
+void SharedMemoryRing::waitForData(int reader, std::chrono::milliseconds timeout)
+{
+    const uint32_t sequence = _segment->sequence.load();
+    if (_segment->readers[reader].readPos.load(std::memory_order_relaxed) !=
+            _segment->writePos.load(std::memory_order_acquire) ||
+        _segment->closed.load(std::memory_order_acquire) != 0)
+    {
+        return;
+    }
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    const timespec limit{static_cast<time_t>(seconds.count()),
+                         static_cast<long>(std::chrono::nanoseconds(timeout - seconds).count())};
+    _segment->waiters.fetch_add(1);
+    futex(&_segment->sequence, FUTEX_WAIT, sequence, &limit);
+    _segment->waiters.fetch_sub(1);
+}
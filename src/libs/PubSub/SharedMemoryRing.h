@@ -0,0 +1,193 @@
+#ifndef SHAREDMEMORYRING_H
+#define SHAREDMEMORYRING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+/**
+ * @class SharedMemoryRing
+ * @brief Lock-free single-producer / multi-consumer ring of variable-size
+ *        records in a POSIX shared-memory segment (`shm_open`).
+ *
+ * One process creates the segment and writes; up to MAX_READERS readers,
+ * in any process on the host, attach and each see every record written
+ * after they attached.  Records are written and read in place: the
+ * producer reserves space, fills it and commits; a reader peeks the next
+ * record, uses it where it lies and consumes it.
+ *
+ * The ring never overwrites a record a live reader has not consumed:
+ * reserve() fails instead, leaving drop accounting to the caller.  Slots
+ * of readers whose process has died are reclaimed when the ring is full.
+ * Readers sleep on a futex in the segment, which the producer wakes only
+ * when someone is waiting.
+ *
+ * Thread-safety: one producer thread at a time (callers serialise);
+ * each reader index is used by one thread at a time.
+ */
+class SharedMemoryRing
+{
+public:
+    static constexpr size_t MAX_READERS = 16;                    ///< Reader slots per segment
+    static constexpr size_t DEFAULT_CAPACITY = size_t{64} << 20; ///< Ring bytes (64 MiB)
+
+    /**
+     * @brief Create (or replace) a segment and open it for writing.
+     *
+     * The segment is readable and writable by its owner only.  An existing
+     * segment of the same name whose producer has exited is marked closed,
+     * so its readers move on, and unlinked; one whose producer is still
+     * running is left alone and creation fails.  The segment is marked
+     * closed and unlinked again when the returned ring is destroyed.
+     *
+     * @param name Segment name (see segmentName())
+     * @param capacity Ring bytes, rounded up to a power of two
+     * @return The ring, or nullptr on failure (logged)
+     */
+    static std::unique_ptr<SharedMemoryRing> create(const std::string &name, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Open an existing segment for reading.
+     * @param name Segment name (see segmentName())
+     * @return The ring, or nullptr if no live segment exists
+     */
+    static std::unique_ptr<SharedMemoryRing> open(const std::string &name);
+
+    /**
+     * @brief Get the segment name used for a PubSub namespace.
+     * @param ns Namespace
+     * @return "/PubSub.<ns>", with any further '/' replaced
+     */
+    static std::string segmentName(std::string_view ns);
+
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing &) = delete;
+    SharedMemoryRing &operator=(const SharedMemoryRing &) = delete;
+
+    /**
+     * @brief Get the ring size.
+     * @return Ring bytes
+     */
+    [[nodiscard]] size_t capacity() const { return _capacity; }
+
+    /**
+     * @brief Get the largest record reserve() accepts.
+     * @return Record bytes (a quarter of the ring)
+     */
+    [[nodiscard]] size_t maxRecordSize() const { return (_capacity / 4) - sizeof(RecordHeader); }
+
+    // ------------------------------------------------------------------
+    // Producer
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Reserve space for the next record.
+     * @param size Record bytes
+     * @return Where to write the record, or nullptr if it is too large or
+     *         the slowest reader has not made room (nothing is reserved)
+     */
+    uint8_t *reserve(size_t size);
+
+    /**
+     * @brief Make the reserved record visible to readers and wake them.
+     */
+    void commit();
+
+    // ------------------------------------------------------------------
+    // Readers
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Claim a reader slot, starting at the next record written.
+     * @return Reader index, or -1 if every slot is taken
+     */
+    int attachReader();
+
+    /**
+     * @brief Release a reader slot.
+     * @param reader Index from attachReader()
+     */
+    void detachReader(int reader);
+
+    /**
+     * @brief Get the reader's next record without consuming it.
+     *
+     * A record that does not fit the ring (too large, or running past its
+     * end or the write position) closes the segment for this ring object:
+     * peek() returns nothing more and isClosed() turns true.
+     *
+     * @param reader Index from attachReader()
+     * @return The record in the segment, or an empty span if none is ready
+     */
+    std::span<const uint8_t> peek(int reader);
+
+    /**
+     * @brief Consume the record returned by peek().
+     * @param reader Index from attachReader()
+     */
+    void consume(int reader);
+
+    /**
+     * @brief Sleep until a record may be ready, or for at most `timeout`.
+     * @param reader Index from attachReader()
+     * @param timeout Longest sleep
+     */
+    void waitForData(int reader, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Check whether the producer closed the segment or died, or a
+     *        corrupt record was found.
+     * @return true once no more records will be read
+     */
+    [[nodiscard]] bool isClosed() const;
+
+private:
+    struct Segment;
+
+    /**
+     * @struct RecordHeader
+     * @brief Prefix of every record; records are 8-byte aligned.
+     */
+    struct RecordHeader
+    {
+        uint32_t size;      ///< Record bytes after the header
+        uint32_t padding;   ///< Non-zero: filler up to the end of the ring
+    };
+
+    SharedMemoryRing(std::string name, Segment *segment, size_t mappedSize, bool owner);
+
+    /**
+     * @brief Lowest read position of the live readers, reclaiming dead ones.
+     * @param reclaim Free the slots of readers whose process has exited
+     */
+    uint64_t slowestReader(bool reclaim);
+
+    uint8_t *data() const;
+
+    /**
+     * @brief Stop reading a segment holding an invalid record (logged).
+     * @param pos Position of the record
+     */
+    void markCorrupt(uint64_t pos);
+
+    std::string _name;          ///< Segment name
+    Segment *_segment;          ///< Mapped segment
+    size_t _mappedSize;         ///< Bytes mapped
+    size_t _capacity;           ///< Ring bytes (power of two)
+    bool _owner;                ///< Created (and unlinks) the segment
+    pid_t _pid;                 ///< This process, stored in claimed reader slots
+    uint64_t _reservedPos{0};   ///< Producer: position of the reserved record
+    uint64_t _reservedEnd{0};   ///< Producer: position after it (and any filler)
+    size_t _reservedSize{0};    ///< Producer: record bytes reserved
+    uint64_t _peekedEnd[MAX_READERS]{};   ///< Per reader: position after the peeked record
+    bool _corrupt{false};       ///< Readers: an invalid record was found
+};
+
+#endif // SHAREDMEMORYRING_H
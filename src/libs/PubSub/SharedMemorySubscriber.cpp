@@ -0,0 +1,134 @@
+#include "SharedMemorySubscriber.h"
+#include "SharedMemoryPublisher.h"  // For SharedMemoryMessageHeader
+#include "SharedMemoryRing.h"
+
+#include <chrono>
+#include <cstring>
+
+#include <GeneralLogger.h>
+#include <ThreadConfig.h>
+
+SharedMemorySubscriber::SharedMemorySubscriber(const std::string &name) :
+    _name(name),
+    _segmentName(SharedMemoryRing::segmentName(name))
+{
+}
+
+SharedMemorySubscriber::~SharedMemorySubscriber()
+{
+    stop();
+}
+
+void SharedMemorySubscriber::subscribe(const std::string &topic, MessageHandler handler)
+{
+    subscribeView(topic, [handler = std::move(handler)](std::string_view msgTopic, std::string_view data) {
+        handler(std::string(msgTopic), std::string(data));
+    });
+}
+
+void SharedMemorySubscriber::subscribeView(const std::string &topic, MessageViewHandler handler)
+{
+    const std::lock_guard<std::mutex> lock(_handlersMutex);
+    _handlers[_name + "/" + topic] = std::move(handler);
+}
+
+bool SharedMemorySubscriber::start()
+{
+    if (_running.exchange(true))
+    {
+        return true;
+    }
+    _receiveThread = std::thread(&SharedMemorySubscriber::receiveLoop, this);
+    GPINFO("SharedMemorySubscriber '{}' started (segment {})", _name, _segmentName);
+    return true;
+}
+
+void SharedMemorySubscriber::stop()
+{
+    if (!_running.exchange(false))
+    {
+        return;
+    }
+    if (_receiveThread.joinable())
+    {
+        _receiveThread.join();
+    }
+}
+
+void SharedMemorySubscriber::receiveLoop()
+{
+    CommonUtils::configureCurrentThread("PubSub." + _name + ".shm");
+
+    while (_running.load())
+    {
+        auto ring = SharedMemoryRing::open(_segmentName);
+        if (ring && ring->isClosed())
+        {
+            ring.reset();   // Left behind by a publisher that died
+        }
+        const int reader = ring ? ring->attachReader() : -1;
+        if (reader < 0)
+        {
+            if (ring)
+            {
+                GPWARN_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND,
+                               "No free reader slot in shared memory segment {}", _segmentName);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(RECONNECT_INTERVAL_MS));
+            continue;
+        }
+        _connected.store(true);
+
+        while (_running.load())
+        {
+            const auto record = ring->peek(reader);
+            if (!record.empty())
+            {
+                deliverRecord(std::string_view(reinterpret_cast<const char *>(record.data()), record.size()));
+                ring->consume(reader);
+                continue;
+            }
+            // Drained: leave once the publisher has gone, otherwise sleep
+            if (ring->isClosed())
+            {
+                break;
+            }
+            ring->waitForData(reader, std::chrono::milliseconds(WAIT_TIMEOUT_MS));
+        }
+
+        _connected.store(false);
+        ring->detachReader(reader);
+    }
+}
+
+void SharedMemorySubscriber::deliverRecord(std::string_view record)
+{
+    SharedMemoryMessageHeader header{};
+    if (record.size() < sizeof(header))
+    {
+        return;
+    }
+    std::memcpy(&header, record.data(), sizeof(header));
+    if (header.topicLen > record.size() - sizeof(header))
+    {
+        return;
+    }
+    _received.fetch_add(1, std::memory_order_relaxed);
+    const std::string_view topic = record.substr(sizeof(header), header.topicLen);
+    const std::string_view payload = record.substr(sizeof(header) + header.topicLen);
+
+    MessageViewHandler handler;
+    {
+        const std::lock_guard<std::mutex> lock(_handlersMutex);
+        auto it = _handlers.find(topic);
+        if (it == _handlers.end())
+        {
+            return;
+        }
+        handler = it->second;
+    }
+    if (handler)
+    {
+        handler(topic, payload);
+    }
+}
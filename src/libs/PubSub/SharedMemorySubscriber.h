@@ -0,0 +1,150 @@
+#ifndef SHAREDMEMORYSUBSCRIBER_H
+#define SHAREDMEMORYSUBSCRIBER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+class SharedMemoryRing;
+
+/**
+ * @class SharedMemorySubscriber
+ * @brief Same-host subscriber reading a SharedMemoryPublisher's ring in place.
+ *
+ * The same-host counterpart of HighBandwidthSubscriber, with the same
+ * subscribe() / subscribeView() API and namespacing.  The receive thread
+ * sleeps on the segment's futex and hands each message to its topic's
+ * handler straight from shared memory: subscribeView() handlers get
+ * zero-copy views of IQ and spectrum frames, and the ring space is only
+ * released to the publisher once the handler returns.
+ *
+ * The subscriber may start before its publisher: the receive thread
+ * opens the segment once it exists, and reopens it when a publisher
+ * restarts.  It starts with the next message written, like joining a
+ * multicast group.
+ *
+ * @warning A handler that runs for long holds back the publisher, which
+ *          drops messages (for every subscriber) once the ring is full.
+ *
+ * @see SharedMemoryPublisher for the corresponding publisher class
+ */
+class SharedMemorySubscriber
+{
+public:
+    /**
+     * @brief Callback type for message handlers.
+     *
+     * @param topic The full namespaced topic string
+     * @param data The message payload (serialized protobuf)
+     */
+    using MessageHandler = std::function<void(const std::string &topic, const std::string &data)>;
+
+    /**
+     * @brief Zero-copy callback type for message handlers.
+     *
+     * @param topic The full namespaced topic string
+     * @param data The message payload in shared memory; valid only during the call
+     */
+    using MessageViewHandler = std::function<void(std::string_view topic, std::string_view data)>;
+
+    /**
+     * @brief Construct a shared-memory subscriber.
+     * @param name Namespace for topic isolation (must match publisher's namespace)
+     */
+    explicit SharedMemorySubscriber(const std::string &name);
+
+    /**
+     * @brief Destructor - stops receiving and detaches from the segment.
+     */
+    ~SharedMemorySubscriber();
+
+    SharedMemorySubscriber(const SharedMemorySubscriber &) = delete;
+    SharedMemorySubscriber &operator=(const SharedMemorySubscriber &) = delete;
+
+    /**
+     * @brief Subscribe to a topic with a callback handler.
+     *
+     * @param topic The topic name to subscribe to (without namespace prefix)
+     * @param handler Callback function invoked, on the receive thread, for each message
+     *
+     * @note Thread-safe. Can be called before or after start().
+     */
+    void subscribe(const std::string &topic, MessageHandler handler);
+
+    /**
+     * @brief Subscribe to a topic with a zero-copy callback handler.
+     *
+     * @param topic The topic name to subscribe to (without namespace prefix)
+     * @param handler Callback function invoked, on the receive thread, for each message
+     */
+    void subscribeView(const std::string &topic, MessageViewHandler handler);
+
+    /**
+     * @brief Start the receive thread.
+     * @return true (the segment is opened whenever it becomes available)
+     */
+    bool start();
+
+    /**
+     * @brief Stop the receive thread and detach from the segment.
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the subscriber is attached to a publisher's segment.
+     * @return true while reading a live segment
+     */
+    [[nodiscard]] bool isConnected() const { return _connected.load(); }
+
+    /**
+     * @brief Get the number of messages read from the ring.
+     * @return Messages received (subscribed topic or not) since construction
+     */
+    [[nodiscard]] uint64_t receivedCount() const { return _received.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the namespace name.
+     * @return The namespace string used for topic filtering
+     */
+    const std::string &name() const { return _name; }
+
+private:
+    /**
+     * @brief Background thread function: open, read and reopen the segment.
+     */
+    void receiveLoop();
+
+    /**
+     * @brief Deliver one ring record to its topic's handler.
+     * @param record SharedMemoryMessageHeader, topic and payload
+     */
+    void deliverRecord(std::string_view record);
+
+    /// Hash allowing handler lookup by std::string_view.
+    struct TopicHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view topic) const noexcept { return std::hash<std::string_view>{}(topic); }
+    };
+
+    static constexpr int RECONNECT_INTERVAL_MS = 100;   ///< Segment open retry period
+    static constexpr int WAIT_TIMEOUT_MS = 100;         ///< Longest futex sleep (stop / liveness checks)
+
+    std::string _name;                          ///< Namespace for topic filtering
+    std::string _segmentName;                   ///< Shared-memory segment name
+    std::atomic<bool> _running{false};          ///< Running state flag
+    std::atomic<bool> _connected{false};        ///< Attached to a live segment
+    std::atomic<uint64_t> _received{0};         ///< Messages read
+    std::thread _receiveThread;                 ///< Background receive thread
+
+    std::unordered_map<std::string, MessageViewHandler, TopicHash, std::equal_to<>> _handlers; ///< Topic -> handler map
+    std::mutex _handlersMutex;                  ///< Protects _handlers
+};
+
+#endif // SHAREDMEMORYSUBSCRIBER_H
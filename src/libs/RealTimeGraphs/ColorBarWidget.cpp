@@ -1,11 +1,14 @@
 #include "ColorBarWidget.h"
 
+#include <QImage>
 #include <QLabel>
 #include <QPainter>
 #include <QPaintEvent>
 #include <QVBoxLayout>
 
 #include <algorithm>
+#include <cstdint>
+#include <vector>
 
 namespace RealTimeGraphs
 {
@@ -66,14 +69,19 @@ void ColorBarStrip::paintEvent(QPaintEvent* /*event*/)
       return;
    }
 
-   // Gradient strip — top = high value, bottom = low value
-   for (int y = 0; y < barHeight; ++y)
+   // Gradient strip — top = high value, bottom = low value.  One pixel
+   // column colored in a single pass, stretched to the bar width.
+   const auto rows = static_cast<std::size_t>(barHeight);
+   std::vector<float> norms(rows);
+   for (std::size_t y = 0; y < rows; ++y)
    {
-      const float norm = 1.0F - (static_cast<float>(y) / static_cast<float>(barHeight));
-      const Color c = _colorMap.map(norm);
-      painter.fillRect(barLeft, barTop + y, BAR_WIDTH, 1,
-                       QColor(c.r, c.g, c.b, c.a));
+      norms[y] = 1.0F - (static_cast<float>(y) / static_cast<float>(barHeight));
    }
+   std::vector<uint32_t> pixels(rows);
+   _colorMap.mapRow(norms, pixels, 0.0F, 1.0F);
+   const QImage strip(reinterpret_cast<const uchar*>(pixels.data()), 1, barHeight,
+                      static_cast<qsizetype>(sizeof(uint32_t)), QImage::Format_RGBA8888);
+   painter.drawImage(QRect(barLeft, barTop, BAR_WIDTH, barHeight), strip);
 
    // Border
    painter.setPen(QColor(100, 100, 110));
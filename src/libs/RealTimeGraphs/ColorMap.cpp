@@ -1,11 +1,139 @@
 #include "ColorMap.h"
 
 #include <algorithm>
+#include <bit>
 #include <cmath>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define REALTIMEGRAPHS_COLORMAP_AVX2 1
+#include <immintrin.h>
+#endif
+
 namespace RealTimeGraphs
 {
 
+namespace
+{
+
+static_assert(sizeof(Color) == sizeof(uint32_t), "Color must be packed RGBA8");
+
+constexpr float MAX_INDEX = 255.0F;
+
+// ============================================================================
+// Row kernels — every path normalises and rounds the same way as map()
+// ============================================================================
+
+float inverseRange(float minDb, float maxDb)
+{
+   return (maxDb > minDb) ? 1.0F / (maxDb - minDb) : 0.0F;
+}
+
+uint32_t levelOf(float db, float minDb, float invRange)
+{
+   // max(0, NaN) is 0
+   const float t = std::min(1.0F, std::max(0.0F, (db - minDb) * invRange));
+   return static_cast<uint32_t>(t * MAX_INDEX);
+}
+
+void mapRowScalar(const float* db, uint32_t* out, std::size_t n, float minDb, float invRange,
+                  const uint32_t* lut)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      out[i] = lut[levelOf(db[i], minDb, invRange)];
+   }
+}
+
+void colorizeRowScalar(const uint8_t* levels, uint32_t* out, std::size_t n, const uint32_t* lut)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      out[i] = lut[levels[i]];
+   }
+}
+
+void quantizeRowScalar(const float* db, uint8_t* levels, std::size_t n, float minDb,
+                       float invRange)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      levels[i] = static_cast<uint8_t>(levelOf(db[i], minDb, invRange));
+   }
+}
+
+#if defined(REALTIMEGRAPHS_COLORMAP_AVX2)
+
+bool cpuHasAvx2()
+{
+   static const bool HAS_AVX2 = __builtin_cpu_supports("avx2") != 0;
+   return HAS_AVX2;
+}
+
+// LUT indices of 8 dB values, as levelOf()
+__attribute__((target("avx2"))) __m256i levels8Avx2(const float* db, __m256 minDb, __m256 invRange)
+{
+   const __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(db), minDb), invRange);
+   // maxps returns its second operand if either is NaN: NaN becomes 0
+   const __m256 clamped = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()),
+                                        _mm256_set1_ps(1.0F));
+   return _mm256_cvttps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(MAX_INDEX)));
+}
+
+__attribute__((target("avx2")))
+void mapRowAvx2(const float* db, uint32_t* out, std::size_t n, float minDb, float invRange,
+                const uint32_t* lut)
+{
+   const __m256 mn  = _mm256_set1_ps(minDb);
+   const __m256 inv = _mm256_set1_ps(invRange);
+   const auto* table = reinterpret_cast<const int*>(lut);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256i pixels = _mm256_i32gather_epi32(table, levels8Avx2(db + i, mn, inv), 4);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), pixels);
+   }
+   mapRowScalar(db + i, out + i, n - i, minDb, invRange, lut);
+}
+
+__attribute__((target("avx2")))
+void colorizeRowAvx2(const uint8_t* levels, uint32_t* out, std::size_t n, const uint32_t* lut)
+{
+   const auto* table = reinterpret_cast<const int*>(lut);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256i index = _mm256_cvtepu8_epi32(
+         _mm_loadl_epi64(reinterpret_cast<const __m128i*>(levels + i)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                          _mm256_i32gather_epi32(table, index, 4));
+   }
+   colorizeRowScalar(levels + i, out + i, n - i, lut);
+}
+
+__attribute__((target("avx2")))
+void quantizeRowAvx2(const float* db, uint8_t* levels, std::size_t n, float minDb,
+                     float invRange)
+{
+   const __m256 mn  = _mm256_set1_ps(minDb);
+   const __m256 inv = _mm256_set1_ps(invRange);
+   // After packing, each 128-bit lane starts with its four levels
+   const __m256i firstOfLanes = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256i index = levels8Avx2(db + i, mn, inv);
+      const __m256i words = _mm256_packus_epi32(index, index);
+      const __m256i bytes = _mm256_packus_epi16(words, words);
+      const __m256i eight = _mm256_permutevar8x32_epi32(bytes, firstOfLanes);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(levels + i), _mm256_castsi256_si128(eight));
+   }
+   quantizeRowScalar(db + i, levels + i, n - i, minDb, invRange);
+}
+
+#endif // REALTIMEGRAPHS_COLORMAP_AVX2
+
+} // namespace
+
 // ============================================================================
 // Construction
 // ============================================================================
@@ -34,6 +162,11 @@ ColorMap::ColorMap(Palette palette)
          break;
    }
    _name = paletteName(palette);
+
+   for (std::size_t i = 0; i < _lut.size(); ++i)
+   {
+      _packedLut[i] = std::bit_cast<uint32_t>(_lut[i]);
+   }
 }
 
 // ============================================================================
@@ -48,6 +181,49 @@ Color ColorMap::map(float t) const
    return _lut[index];
 }
 
+void ColorMap::mapRow(std::span<const float> db, std::span<uint32_t> outRgba, float minDb,
+                      float maxDb) const
+{
+   const std::size_t n = std::min(db.size(), outRgba.size());
+   const float invRange = inverseRange(minDb, maxDb);
+#if defined(REALTIMEGRAPHS_COLORMAP_AVX2)
+   if (cpuHasAvx2())
+   {
+      mapRowAvx2(db.data(), outRgba.data(), n, minDb, invRange, _packedLut.data());
+      return;
+   }
+#endif
+   mapRowScalar(db.data(), outRgba.data(), n, minDb, invRange, _packedLut.data());
+}
+
+void ColorMap::colorizeRow(std::span<const uint8_t> levels, std::span<uint32_t> outRgba) const
+{
+   const std::size_t n = std::min(levels.size(), outRgba.size());
+#if defined(REALTIMEGRAPHS_COLORMAP_AVX2)
+   if (cpuHasAvx2())
+   {
+      colorizeRowAvx2(levels.data(), outRgba.data(), n, _packedLut.data());
+      return;
+   }
+#endif
+   colorizeRowScalar(levels.data(), outRgba.data(), n, _packedLut.data());
+}
+
+void ColorMap::quantizeRow(std::span<const float> db, std::span<uint8_t> levels, float minDb,
+                           float maxDb)
+{
+   const std::size_t n = std::min(db.size(), levels.size());
+   const float invRange = inverseRange(minDb, maxDb);
+#if defined(REALTIMEGRAPHS_COLORMAP_AVX2)
+   if (cpuHasAvx2())
+   {
+      quantizeRowAvx2(db.data(), levels.data(), n, minDb, invRange);
+      return;
+   }
+#endif
+   quantizeRowScalar(db.data(), levels.data(), n, minDb, invRange);
+}
+
 std::size_t ColorMap::paletteCount()
 {
    return 6;
@@ -5,6 +5,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -29,6 +30,10 @@ struct Color
  *
  * Each map is a 256-entry lookup table (LUT).  Call `map(t)` with a
  * normalised value in [0, 1] to retrieve the corresponding color.
+ *
+ * The row functions do the same for a whole row in one pass, writing
+ * packed RGBA (QImage::Format_RGBA8888 pixels): normalisation, LUT index
+ * and a gather from the packed LUT, with AVX2 where the CPU has it.
  */
 class ColorMap
 {
@@ -56,6 +61,30 @@ public:
    /** @brief Direct access to the 256-entry LUT. */
    [[nodiscard]] const std::array<Color, 256>& lut() const { return _lut; }
 
+   /** @brief The LUT as packed RGBA pixels, byte order r, g, b, a in memory. */
+   [[nodiscard]] const std::array<uint32_t, 256>& packedLut() const { return _packedLut; }
+
+   /**
+    * @brief Color a row of dB values: `map((db - minDb) / (maxDb - minDb))` each.
+    * NaN maps like the minimum.
+    * @param outRgba  Packed pixels, at least `db.size()`.
+    */
+   void mapRow(std::span<const float> db, std::span<uint32_t> outRgba, float minDb,
+               float maxDb) const;
+
+   /**
+    * @brief Color a row of LUT indices (e.g. quantizeRow() output).
+    * @param outRgba  Packed pixels, at least `levels.size()`.
+    */
+   void colorizeRow(std::span<const uint8_t> levels, std::span<uint32_t> outRgba) const;
+
+   /**
+    * @brief The LUT indices mapRow() would use, e.g. to store rows compactly.
+    * @param levels  At least `db.size()`.
+    */
+   static void quantizeRow(std::span<const float> db, std::span<uint8_t> levels, float minDb,
+                           float maxDb);
+
    /** @brief Human-readable name of the active palette. */
    [[nodiscard]] const std::string& name() const { return _name; }
 
@@ -82,6 +111,7 @@ private:
    void buildGradient(const std::vector<std::pair<float, Color>>& stops);
 
    std::array<Color, 256> _lut{};
+   std::array<uint32_t, 256> _packedLut{};   ///< _lut as packed pixels
    std::string _name;
 };
 
@@ -0,0 +1,161 @@
+#include "ConstellationDensity.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace RealTimeGraphs
+{
+
+namespace
+{
+
+// The counts are rescaled once a new sample weighs this much (well within
+// float range for the sum of a cell)
+constexpr float MAX_WEIGHT = 1.0e12F;
+
+// Beyond this many time constants without samples the old counts are
+// negligible (e^-28 < 1e-12): start over instead of growing the weight
+constexpr double MAX_DECAY_STEPS = 28.0;
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+ConstellationDensity::ConstellationDensity(std::size_t gridSize, float axisRange,
+                                           double decaySeconds)
+   : _gridSize{gridSize}
+   , _axisRange{axisRange}
+   , _decaySeconds{decaySeconds}
+   , _counts((gridSize * gridSize) + 1, 0.0F)
+{
+}
+
+void ConstellationDensity::setAxisRange(float range)
+{
+   _axisRange = range;
+   clear();
+}
+
+void ConstellationDensity::setDecayTime(double seconds)
+{
+   _decaySeconds = seconds;
+}
+
+void ConstellationDensity::clear()
+{
+   std::ranges::fill(_counts, 0.0F);
+   _weight = 1.0F;
+   _empty  = true;
+}
+
+// ============================================================================
+// Binning
+// ============================================================================
+
+void ConstellationDensity::accumulate(std::span<const std::complex<float>> samples,
+                                      Clock::time_point now)
+{
+   if (samples.empty() || _gridSize == 0)
+   {
+      return;
+   }
+
+   if (!_empty)
+   {
+      const double steps = std::chrono::duration<double>(now - _lastTime).count() / _decaySeconds;
+      if (steps > MAX_DECAY_STEPS)
+      {
+         clear();
+      }
+      else if (steps > 0.0)
+      {
+         _weight *= static_cast<float>(std::exp(steps));
+         if (_weight > MAX_WEIGHT)
+         {
+            renormalise();
+         }
+      }
+   }
+   _lastTime = now;
+   _empty    = false;
+
+   // Pass 1, vectorized: the cell of each sample, or the discard cell
+   const auto cellsPerAxis = static_cast<uint32_t>(_gridSize);
+   const auto discard      = cellsPerAxis * cellsPerAxis;
+   const auto size         = static_cast<float>(_gridSize);
+   const float lastCell    = size - 1.0F;
+   const float scale       = size / (2.0F * _axisRange);
+   const float range       = _axisRange;
+
+   _cells.resize(samples.size());
+   const auto* iq = reinterpret_cast<const float*>(samples.data());
+   uint32_t* cells = _cells.data();
+   for (std::size_t k = 0; k < samples.size(); ++k)
+   {
+      const float x = (iq[2 * k] + range) * scale;
+      const float y = (range - iq[(2 * k) + 1]) * scale;   // row 0 at +Q
+      // Non-short-circuit: a branch here would stop the vectorizer
+      const bool inside = (x >= 0.0F) & (x < size) & (y >= 0.0F) & (y < size);
+
+      // max(0, NaN) is 0, so the conversions are defined for any sample
+      const auto column = static_cast<uint32_t>(std::min(lastCell, std::max(0.0F, x)));
+      const auto row    = static_cast<uint32_t>(std::min(lastCell, std::max(0.0F, y)));
+      cells[k] = inside ? (row * cellsPerAxis) + column : discard;
+   }
+
+   // Pass 2: the counts
+   for (const uint32_t cell : _cells)
+   {
+      _counts[cell] += _weight;
+   }
+}
+
+// ============================================================================
+// Display
+// ============================================================================
+
+void ConstellationDensity::levels(std::span<uint8_t> out, Clock::time_point now) const
+{
+   const std::size_t cellCount = _gridSize * _gridSize;
+   const std::span<const float> grid(_counts.data(), cellCount);
+   const float peak = grid.empty() ? 0.0F : std::ranges::max(grid);
+   if (_empty || peak <= 0.0F)
+   {
+      std::ranges::fill(out, uint8_t{0});
+      return;
+   }
+
+   // The counts decay further while no samples arrive
+   const double idle = std::chrono::duration<double>(now - _lastTime).count();
+   const auto fade = static_cast<float>(std::exp(-std::max(idle, 0.0) / _decaySeconds));
+
+   // Level 1 .. 255 over the dynamic range below the peak; 0 below it
+   const float toRatio = DYNAMIC_RANGE * fade / peak;
+   const float toLevel = 254.0F / std::log(DYNAMIC_RANGE);
+   const std::size_t count = std::min(out.size(), cellCount);
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      const float ratio = grid[i] * toRatio;
+      out[i] = (ratio >= 1.0F)
+                  ? static_cast<uint8_t>(1.0F + std::min(254.0F, std::log(ratio) * toLevel))
+                  : uint8_t{0};
+   }
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+void ConstellationDensity::renormalise()
+{
+   const float inverse = 1.0F / _weight;
+   for (float& count : _counts)
+   {
+      count *= inverse;
+   }
+   _weight = 1.0F;
+}
+
+} // namespace RealTimeGraphs
@@ -0,0 +1,93 @@
+#ifndef CONSTELLATIONDENSITY_H_
+#define CONSTELLATIONDENSITY_H_
+
+// System headers
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class ConstellationDensity
+ * @brief Exponentially decaying 2-D histogram of I/Q samples.
+ *
+ * Every sample is counted in a square grid over `[-range, +range]` on both
+ * axes, so the display shows the whole sample population rather than a
+ * selection of it.  Binning is two passes: cell indices for the batch in a
+ * branch-free loop the compiler vectorizes (samples outside the range go to
+ * a discard cell past the grid), then the counts.
+ *
+ * Counts decay with a time constant without touching the grid per batch:
+ * instead, the weight of a new sample grows by `exp(dt / decay)`, and the
+ * grid is rescaled only when the weight gets large.  Paint cost is the grid
+ * size, whatever the sample rate.
+ *
+ * Thread-safety: none; ConstellationWidget guards it with its mutex.
+ */
+class ConstellationDensity
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   /** @brief Default cells per axis. */
+   static constexpr std::size_t DEFAULT_GRID_SIZE = 256;
+
+   /**
+    * @param gridSize      Cells per axis.
+    * @param axisRange     Half-width of the binned I and Q range.
+    * @param decaySeconds  Time constant of the count decay.
+    */
+   explicit ConstellationDensity(std::size_t gridSize = DEFAULT_GRID_SIZE,
+                                 float axisRange = 1.5F, double decaySeconds = 5.0);
+
+   /** @brief Set the binned range; clears the counts, which no longer fit. */
+   void setAxisRange(float range);
+
+   /** @brief Set the time constant of the count decay. */
+   void setDecayTime(double seconds);
+
+   /** @brief Count a batch of samples arriving at `now`. */
+   void accumulate(std::span<const std::complex<float>> samples, Clock::time_point now);
+
+   /** @brief Drop all counts. */
+   void clear();
+
+   [[nodiscard]] std::size_t gridSize() const { return _gridSize; }
+   [[nodiscard]] float axisRange() const { return _axisRange; }
+
+   /**
+    * @brief Quantize the grid into display levels at `now`.
+    *
+    * Levels are logarithmic in the count relative to the peak cell, over
+    * DYNAMIC_RANGE, and fade with the decay while no samples arrive.  An
+    * empty cell is level 0.
+    *
+    * @param out  `gridSize() x gridSize()` levels, row 0 at +Q, column 0 at -I.
+    */
+   void levels(std::span<uint8_t> out, Clock::time_point now) const;
+
+   /** @brief Ratio of the peak count to the smallest visible count. */
+   static constexpr float DYNAMIC_RANGE = 1000.0F;
+
+private:
+   // Rescale the counts so a new sample weighs 1 again.
+   void renormalise();
+
+   std::size_t _gridSize;
+   float _axisRange;
+   double _decaySeconds;
+   std::vector<float> _counts;          ///< gridSize^2 cells + 1 discard cell
+   std::vector<uint32_t> _cells;        ///< Cell index per sample of a batch
+   float _weight{1.0F};                 ///< Weight of a sample arriving now
+   Clock::time_point _lastTime{};
+   bool _empty{true};
+};
+
+} // namespace RealTimeGraphs
+
+#endif // CONSTELLATIONDENSITY_H_
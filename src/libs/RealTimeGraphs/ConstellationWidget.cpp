@@ -1,16 +1,29 @@
 #include "ConstellationWidget.h"
 #include "CommonGuiUtils.h"
 
+#include <Profiler.h>
+
 #include <QPainter>
 #include <QPaintEvent>
 #include <QWheelEvent>
 
 #include <algorithm>
+#include <array>
 #include <numeric>
+#include <span>
+#include <utility>
 
 namespace RealTimeGraphs
 {
 
+namespace
+{
+
+// Fewest points a memory budget shrinks persistence to (one setData() batch)
+constexpr std::size_t MIN_BUDGET_DEPTH = 64;
+
+} // namespace
+
 // ============================================================================
 // Construction
 // ============================================================================
@@ -18,7 +31,10 @@ namespace RealTimeGraphs
 ConstellationWidget::ConstellationWidget(QWidget* parent, int historySize)
    : QWidget(parent)
    , _points(static_cast<std::size_t>(historySize))
+   , _persistenceDepth(static_cast<std::size_t>(historySize))
 {
+   _memory.setBytes(_points.capacity() * sizeof(TimedPoint));
+   fitPersistenceToBudget();
    setMinimumSize(ConstellationWidget::minimumSizeHint());
    setAttribute(Qt::WA_OpaquePaintEvent);
 }
@@ -33,6 +49,23 @@ void ConstellationWidget::setData(const std::vector<std::complex<float>>& sample
    {
       return;
    }
+
+   // Density mode counts every sample; the grid is the persistence
+   bool binned = false;
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      if (_displayMode == DisplayMode::Density)
+      {
+         _density.accumulate(samples, Clock::now());
+         binned = true;
+      }
+   }
+   if (binned)
+   {
+      _renderClient.markDirty();
+      return;
+   }
+
    constexpr std::size_t MAX_POINTS = 64;
 
    // Build an index list sorted by descending magnitude so we keep the
@@ -49,70 +82,105 @@ void ConstellationWidget::setData(const std::vector<std::complex<float>>& sample
                         return std::norm(samples[a]) > std::norm(samples[b]);
                      });
 
+   const auto now = Clock::now();
+   std::array<TimedPoint, MAX_POINTS> batch;
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      batch[i] = {now, samples[indices[i]]};
+   }
    {
       const std::lock_guard<std::mutex> lock(_mutex);
-      auto now = Clock::now();
-      for (std::size_t i = 0; i < count; ++i)
-      {
-         _points.push({now, samples[indices[i]]});
-      }
+      fitPersistenceToBudget();
+      _points.push(std::span<const TimedPoint>(batch.data(), count));
    }
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setAxisRange(float range)
 {
-   _axisRange = range;
-   safeUpdate(this);
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _axisRange = range;
+      _density.setAxisRange(range);
+   }
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setPointSize(int size)
 {
    _pointSize = size;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setPersistence(bool enable)
 {
    _persistence = enable;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setPersistenceDepth(int depth)
 {
    const std::lock_guard<std::mutex> lock(_mutex);
-   _points = CommonUtils::CircularBuffer<TimedPoint>(static_cast<std::size_t>(depth));
-   safeUpdate(this);
+   _persistenceDepth = static_cast<std::size_t>(depth);
+   _points = CommonUtils::CircularBuffer<TimedPoint>(_persistenceDepth);
+   _memory.setBytes(_points.capacity() * sizeof(TimedPoint));
+   fitPersistenceToBudget();
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setDotColor(const QColor& color)
 {
    _dotColor = color;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setGridEnabled(bool enable)
 {
    _gridEnabled = enable;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setFadeAmount(int amount)
 {
    _fadeAmount = std::clamp(amount, 0, 255);
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setFadeTime(float seconds)
 {
-   _fadeTimeSec = std::clamp(seconds, 0.5F, 30.0F);
-   safeUpdate(this);
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _fadeTimeSec = std::clamp(seconds, 0.5F, 30.0F);
+      _density.setDecayTime(static_cast<double>(_fadeTimeSec));
+   }
+   _renderClient.markDirty();
+}
+
+void ConstellationWidget::setDisplayMode(DisplayMode mode)
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _displayMode = mode;
+      _density.clear();
+   }
+   _renderClient.markDirty();
+}
+
+ConstellationWidget::DisplayMode ConstellationWidget::displayMode() const
+{
+   return _displayMode;
+}
+
+void ConstellationWidget::setColorMap(ColorMap::Palette palette)
+{
+   _colorMap = ColorMap(palette);
+   _renderClient.markDirty();
 }
 
 void ConstellationWidget::setPaused(bool paused)
 {
    _paused = paused;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 bool ConstellationWidget::isPaused() const
@@ -131,6 +199,7 @@ QSize ConstellationWidget::minimumSizeHint() const
 
 void ConstellationWidget::paintEvent(QPaintEvent* /*event*/)
 {
+   GPPROFILE_SCOPE("ConstellationWidget::paintEvent");
    QPainter painter(this);
    painter.setRenderHint(QPainter::Antialiasing, true);
 
@@ -151,7 +220,14 @@ void ConstellationWidget::paintEvent(QPaintEvent* /*event*/)
    {
       drawGrid(painter, plotArea);
    }
-   drawPoints(painter, plotArea);
+   if (_displayMode == DisplayMode::Density)
+   {
+      drawDensity(painter, plotArea);
+   }
+   else
+   {
+      drawPoints(painter, plotArea);
+   }
 }
 
 void ConstellationWidget::wheelEvent(QWheelEvent* event)
@@ -168,7 +244,11 @@ void ConstellationWidget::wheelEvent(QWheelEvent* event)
    }
 
    const float factor = (deltaY > 0) ? (1.0F / ZOOM_FACTOR) : ZOOM_FACTOR;
-   _axisRange = std::clamp(_axisRange * factor, MIN_AXIS_RANGE, MAX_AXIS_RANGE);
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _axisRange = std::clamp(_axisRange * factor, MIN_AXIS_RANGE, MAX_AXIS_RANGE);
+      _density.setAxisRange(_axisRange);
+   }
 
    update();
    event->accept();
@@ -228,8 +308,7 @@ void ConstellationWidget::drawPoints(QPainter& painter, const QRect& area)
 {
    const std::lock_guard<std::mutex> lock(_mutex);
 
-   auto count = _points.size();
-   if (count == 0)
+   if (_points.empty())
    {
       return;
    }
@@ -239,39 +318,98 @@ void ConstellationWidget::drawPoints(QPainter& painter, const QRect& area)
    auto now = Clock::now();
    auto fadeUs = static_cast<long long>(_fadeTimeSec * 1.0e6F);
 
-   for (std::size_t i = 0; i < count; ++i)
+   // Oldest first, straight from the buffer's storage.
+   const auto [older, newer] = _points.spans();
+   for (const std::span<const TimedPoint> run : {older, newer})
    {
-      const auto& [timestamp, sample] = _points[i];
-      const QPoint pos = mapToPixel(sample.real(), sample.imag(), area);
-
-      // Check if point is within plot area
-      if (!area.contains(pos))
+      for (const auto& [timestamp, sample] : run)
       {
-         continue;
-      }
+         const QPoint pos = mapToPixel(sample.real(), sample.imag(), area);
 
-      if (_persistence)
-      {
-         // Time-based fade: compute age as fraction of fade time
-         auto ageUs = std::chrono::duration_cast<std::chrono::microseconds>(
-                         now - timestamp).count();
-         if (ageUs >= fadeUs)
+         // Check if point is within plot area
+         if (!area.contains(pos))
          {
-            continue; // fully faded out
+            continue;
          }
-         const float ageFrac = static_cast<float>(ageUs) / static_cast<float>(fadeUs);
-         int alpha = static_cast<int>((1.0F - ageFrac) * 255.0F);
-         alpha = std::clamp(alpha, 0, 255);
-         painter.setBrush(QColor(_dotColor.red(), _dotColor.green(),
-                                 _dotColor.blue(), alpha));
+
+         if (_persistence)
+         {
+            // Time-based fade: compute age as fraction of fade time
+            auto ageUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            now - timestamp).count();
+            if (ageUs >= fadeUs)
+            {
+               continue; // fully faded out
+            }
+            const float ageFrac = static_cast<float>(ageUs) / static_cast<float>(fadeUs);
+            int alpha = static_cast<int>((1.0F - ageFrac) * 255.0F);
+            alpha = std::clamp(alpha, 0, 255);
+            painter.setBrush(QColor(_dotColor.red(), _dotColor.green(),
+                                    _dotColor.blue(), alpha));
+         }
+         else
+         {
+            painter.setBrush(_dotColor);
+         }
+
+         painter.drawEllipse(pos, _pointSize, _pointSize);
       }
-      else
+   }
+}
+
+void ConstellationWidget::drawDensity(QPainter& painter, const QRect& area)
+{
+   const auto gridSize = static_cast<int>(_density.gridSize());
+   _densityLevels.resize(_density.gridSize() * _density.gridSize());
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _density.levels(_densityLevels, Clock::now());
+   }
+
+   if (_densityImage.width() != gridSize || _densityImage.height() != gridSize)
+   {
+      _densityImage = QImage(gridSize, gridSize, QImage::Format_RGBA8888);
+   }
+
+   // Level 0 (no samples) stays transparent over the background and grid
+   const auto width = static_cast<std::size_t>(gridSize);
+   for (int row = 0; row < gridSize; ++row)
+   {
+      const std::span<const uint8_t> levels(
+         _densityLevels.data() + (static_cast<std::size_t>(row) * width), width);
+      auto* scanLine = reinterpret_cast<uint32_t*>(_densityImage.scanLine(row));
+      _colorMap.colorizeRow(levels, std::span<uint32_t>(scanLine, width));
+      for (std::size_t c = 0; c < width; ++c)
       {
-         painter.setBrush(_dotColor);
+         scanLine[c] = (levels[c] == 0) ? 0U : scanLine[c];
       }
+   }
+
+   painter.drawImage(area, _densityImage);
+}
 
-      painter.drawEllipse(pos, _pointSize, _pointSize);
+void ConstellationWidget::fitPersistenceToBudget()
+{
+   const std::size_t budget = _memory.budget();
+   const std::size_t depth =
+      (budget == 0) ? _persistenceDepth
+                    : std::min(_persistenceDepth,
+                               std::max(budget / sizeof(TimedPoint), MIN_BUDGET_DEPTH));
+   if (depth == _points.capacity())
+   {
+      return;
+   }
+   if (depth < _points.capacity())
+   {
+      _memory.recordRelief();
    }
+
+   CommonUtils::CircularBuffer<TimedPoint> points(depth);
+   const auto [older, newer] = _points.spans();
+   points.push(older);
+   points.push(newer);
+   _points = std::move(points);
+   _memory.setBytes(_points.capacity() * sizeof(TimedPoint));
 }
 
 QPoint ConstellationWidget::mapToPixel(float i, float q, const QRect& area) const
@@ -3,13 +3,19 @@
 
 // Project headers
 #include "CircularBuffer.h"
+#include "ColorMap.h"
+#include "ConstellationDensity.h"
+#include "MemoryBudget.h"
+#include "RenderClock.h"
 
 // Third-party headers
+#include <QImage>
 #include <QWidget>
 
 // System headers
 #include <chrono>
 #include <complex>
+#include <cstdint>
 #include <mutex>
 #include <utility>
 #include <vector>
@@ -24,12 +30,30 @@ namespace RealTimeGraphs
  * Renders a 2-D scatter plot of complex samples: the real part (I) on the
  * X-axis and the imaginary part (Q) on the Y-axis.  Recent points are
  * drawn brighter; older points fade toward the background.
+ *
+ * In Density mode every sample is binned into a ConstellationDensity grid
+ * on the data thread instead, and the grid is drawn as one image through
+ * the ColorMap: paint cost no longer depends on the sample rate.
+ *
+ * The persistence buffer is accounted as MEMORY_ACCOUNT in the
+ * MemoryRegistry; under a budget it keeps fewer points than the depth set
+ * (the newest ones), and grows back if the budget is raised.
  */
 class ConstellationWidget : public QWidget
 {
    Q_OBJECT
 
 public:
+   /** @brief How samples are shown. */
+   enum class DisplayMode : std::uint8_t
+   {
+      Points,    ///< The strongest samples of each batch, fading with age
+      Density    ///< A decaying 2-D histogram of all samples
+   };
+
+   /** @brief MemoryRegistry name of the persistence buffer's account. */
+   static constexpr const char* MEMORY_ACCOUNT = "constellation.persistence";
+
    /**
     * @param historySize  Number of recent I/Q samples to display.
     * @param parent       Parent widget.
@@ -52,7 +76,7 @@ public:
    /** @brief Enable or disable persistence (fading trail effect). */
    void setPersistence(bool enable);
 
-   /** @brief Set persistence depth (how many samples to keep). */
+   /** @brief Set persistence depth (how many samples to keep, memory budget permitting). */
    void setPersistenceDepth(int depth);
 
    /** @brief Set dot color (recent samples). */
@@ -74,6 +98,15 @@ public:
     */
    void setFadeTime(float seconds);
 
+   /** @brief Switch between points and the density histogram; clears the histogram. */
+   void setDisplayMode(DisplayMode mode);
+
+   /** @brief Returns the current display mode. */
+   [[nodiscard]] DisplayMode displayMode() const;
+
+   /** @brief Set the palette of the density histogram. */
+   void setColorMap(ColorMap::Palette palette);
+
    /** @brief Pause or resume live data updates. */
    void setPaused(bool paused);
 
@@ -91,10 +124,15 @@ private:
    void drawBackground(QPainter& painter, const QRect& area);
    void drawGrid(QPainter& painter, const QRect& area);
    void drawPoints(QPainter& painter, const QRect& area);
+   void drawDensity(QPainter& painter, const QRect& area);
 
    // Map an I/Q value to a pixel position within the plot area.
    [[nodiscard]] QPoint mapToPixel(float i, float q, const QRect& area) const;
 
+   // Resize the persistence buffer to the depth the budget allows, keeping
+   // the newest points; caller holds _mutex.
+   void fitPersistenceToBudget();
+
    using Clock     = std::chrono::steady_clock;
    using TimePoint  = Clock::time_point;
    using TimedPoint = std::pair<TimePoint, std::complex<float>>;
@@ -102,6 +140,9 @@ private:
    std::mutex _mutex;
    bool _paused{false};
    CommonUtils::CircularBuffer<TimedPoint> _points;
+   std::size_t _persistenceDepth;   ///< Depth asked for; _points may hold fewer under a budget
+   CommonUtils::MemoryAccount _memory{MEMORY_ACCOUNT,
+                                      CommonUtils::MemoryRelief::ShrinkPersistence};
 
    float _axisRange{1.5F};
    int _pointSize{3};
@@ -111,6 +152,17 @@ private:
    int _fadeAmount{255};  ///< 0 = no fade (all opaque), 255 = full fade (oldest invisible)
    float _fadeTimeSec{5.0F};  ///< Seconds for a point to fade from full opacity to zero
 
+   // Density mode: the histogram (guarded by _mutex), its levels and image
+   // (GUI thread)
+   DisplayMode _displayMode{DisplayMode::Points};
+   ConstellationDensity _density;
+   ColorMap _colorMap{ColorMap::Palette::Inferno};
+   std::vector<uint8_t> _densityLevels;
+   QImage _densityImage;
+
+   // Repaints at most once per frame, however often data arrives
+   RenderClock::Client _renderClient{[this]() { update(); }};
+
    // Layout margins
    static constexpr int MARGIN_LEFT   = 40;
    static constexpr int MARGIN_RIGHT  = 10;
@@ -0,0 +1,145 @@
+#include "EnvelopePyramid.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace RealTimeGraphs
+{
+
+namespace
+{
+
+using Extent = EnvelopePyramid::Extent;
+
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+// Identity of merge(): any sample widens it to that sample
+constexpr Extent EMPTY_EXTENT{{INF, INF}, {-INF, -INF}};
+
+// Widen `into` by `from`.  A NaN in `from` loses every comparison, so it
+// is ignored, as the envelope scan always did.
+void merge(Extent& into, const Extent& from)
+{
+   into.lo = {std::min(into.lo.real(), from.lo.real()),
+              std::min(into.lo.imag(), from.lo.imag())};
+   into.hi = {std::max(into.hi.real(), from.hi.real()),
+              std::max(into.hi.imag(), from.hi.imag())};
+}
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+EnvelopePyramid::EnvelopePyramid(std::size_t capacity)
+   : _capacity{capacity}
+{
+   constexpr std::size_t COARSEST = blockSize(LEVEL_COUNT - 1);
+   if (capacity == 0 || capacity % COARSEST != 0)
+   {
+      throw std::invalid_argument(
+         "EnvelopePyramid capacity must be a multiple of the coarsest block");
+   }
+
+   for (std::size_t level = 0; level < LEVEL_COUNT; ++level)
+   {
+      _levels[level].assign(capacity / blockSize(level), EMPTY_EXTENT);
+   }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void EnvelopePyramid::update(std::span<const std::complex<float>> ring, std::size_t begin,
+                             std::size_t count)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   count = std::min(count, _capacity);
+
+   // Level by level, so a block's children are current when it is rebuilt
+   for (std::size_t level = 0; level < LEVEL_COUNT; ++level)
+   {
+      const std::size_t size   = blockSize(level);
+      const std::size_t blocks = _levels[level].size();
+      const std::size_t first  = begin / size;
+      const std::size_t last   = (begin + count - 1) / size;   // may be past the wrap
+      const std::size_t touched = std::min(last - first + 1, blocks);
+      for (std::size_t k = 0; k < touched; ++k)
+      {
+         rebuildBlock(ring, level, (first + k) % blocks);
+      }
+   }
+}
+
+EnvelopePyramid::Extent EnvelopePyramid::extent(std::span<const std::complex<float>> ring,
+                                                std::size_t begin, std::size_t count) const
+{
+   Extent result = EMPTY_EXTENT;
+   count = std::min(count, _capacity);
+   const std::size_t head = std::min(count, _capacity - begin);
+   accumulate(ring, begin, begin + head, result);
+   accumulate(ring, 0, count - head, result);
+   return result;
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+void EnvelopePyramid::rebuildBlock(std::span<const std::complex<float>> ring, std::size_t level,
+                                   std::size_t block)
+{
+   Extent result = EMPTY_EXTENT;
+   const std::size_t first = block * FANOUT;
+   if (level == 0)
+   {
+      for (const auto& sample : ring.subspan(first, FANOUT))
+      {
+         merge(result, Extent{sample, sample});
+      }
+   }
+   else
+   {
+      const auto& children = _levels[level - 1];
+      for (std::size_t i = first; i < first + FANOUT; ++i)
+      {
+         merge(result, children[i]);
+      }
+   }
+   _levels[level][block] = result;
+}
+
+void EnvelopePyramid::accumulate(std::span<const std::complex<float>> ring, std::size_t begin,
+                                 std::size_t end, Extent& extent) const
+{
+   // Take the coarsest block that starts here and fits, else one sample
+   std::size_t pos = begin;
+   while (pos < end)
+   {
+      bool merged = false;
+      for (std::size_t level = LEVEL_COUNT; level-- > 0;)
+      {
+         const std::size_t size = blockSize(level);
+         if (pos % size == 0 && end - pos >= size)
+         {
+            merge(extent, _levels[level][pos / size]);
+            pos += size;
+            merged = true;
+            break;
+         }
+      }
+      if (!merged)
+      {
+         merge(extent, Extent{ring[pos], ring[pos]});
+         ++pos;
+      }
+   }
+}
+
+} // namespace RealTimeGraphs
@@ -0,0 +1,93 @@
+#ifndef ENVELOPEPYRAMID_H_
+#define ENVELOPEPYRAMID_H_
+
+// System headers
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class EnvelopePyramid
+ * @brief Min/max mipmap over a ring of I/Q samples.
+ *
+ * Keeps the I and Q extent of every aligned block of 16, 256 and 4096
+ * samples of a ring the caller owns.  Blocks follow the ring's physical
+ * layout, so a write only recomputes the blocks it touched, bottom up.
+ * The extent of any range is then assembled from the coarsest blocks that
+ * fit inside it, plus at most 15 of each finer size and raw samples at the
+ * ends: a few dozen reads whatever the range length, and exact.
+ *
+ * Thread-safety: none; OscilloscopeWidget guards it with its mutex.
+ */
+class EnvelopePyramid
+{
+public:
+   /** @brief Componentwise extent: `lo` holds min I and min Q, `hi` the maxima. */
+   struct Extent
+   {
+      std::complex<float> lo;
+      std::complex<float> hi;
+   };
+
+   /** @brief Blocks per block of the next level, and samples per finest block. */
+   static constexpr std::size_t FANOUT = 16;
+
+   /** @brief Levels: blocks of 16, 256 and 4096 samples. */
+   static constexpr std::size_t LEVEL_COUNT = 3;
+
+   /**
+    * @param capacity  Ring size in samples.
+    * @throws std::invalid_argument if capacity is not a positive multiple of
+    *         the coarsest block.
+    */
+   explicit EnvelopePyramid(std::size_t capacity);
+
+   /**
+    * @brief Recompute the blocks over samples just written to the ring.
+    * @param ring   The ring, `capacity` samples.
+    * @param begin  Physical index of the first sample written.
+    * @param count  Samples written from there, wrapping at the end.
+    */
+   void update(std::span<const std::complex<float>> ring, std::size_t begin, std::size_t count);
+
+   /**
+    * @brief Extent of a ring range.
+    * @param ring   The ring the blocks were computed over.
+    * @param begin  Physical index of the first sample.
+    * @param count  Sample count (> 0), wrapping at the end.
+    */
+   [[nodiscard]] Extent extent(std::span<const std::complex<float>> ring,
+                               std::size_t begin, std::size_t count) const;
+
+private:
+   // Samples per block of a level.
+   [[nodiscard]] static constexpr std::size_t blockSize(std::size_t level)
+   {
+      std::size_t size = FANOUT;
+      for (std::size_t l = 0; l < level; ++l)
+      {
+         size *= FANOUT;
+      }
+      return size;
+   }
+
+   // Recompute one block from the ring (level 0) or the level below.
+   void rebuildBlock(std::span<const std::complex<float>> ring, std::size_t level,
+                     std::size_t block);
+
+   // Extent of a range that does not wrap.
+   void accumulate(std::span<const std::complex<float>> ring, std::size_t begin,
+                   std::size_t end, Extent& extent) const;
+
+   std::size_t _capacity;
+   std::array<std::vector<Extent>, LEVEL_COUNT> _levels;
+};
+
+} // namespace RealTimeGraphs
+
+#endif // ENVELOPEPYRAMID_H_
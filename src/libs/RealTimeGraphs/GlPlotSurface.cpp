@@ -0,0 +1,149 @@
+#include "GlPlotSurface.h"
+
+#include <GeneralLogger.h>
+
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QSurfaceFormat>
+
+#include <utility>
+
+namespace RealTimeGraphs
+{
+
+namespace
+{
+
+// The shaders are GLSL 3.30 core
+constexpr int GL_MAJOR = 3;
+constexpr int GL_MINOR = 3;
+
+// Multisampling smooths the spectrum trace like QPainter antialiasing
+constexpr int SAMPLES = 4;
+
+constexpr GLsizei LUT_SIZE = 256;
+
+// The LUT is uploaded as is: one RGBA texel per Color
+static_assert(sizeof(Color) == 4, "Color must be packed RGBA8");
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+GlPlotSurface::GlPlotSurface(QWidget* parent, PaintHandler onPaint,
+                             InitializeHandler onInitialize, ReleaseHandler onRelease)
+   : QOpenGLWidget(parent)
+   , _onPaint{std::move(onPaint)}
+   , _onInitialize{std::move(onInitialize)}
+   , _onRelease{std::move(onRelease)}
+{
+   QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+   format.setVersion(GL_MAJOR, GL_MINOR);
+   format.setProfile(QSurfaceFormat::CoreProfile);
+   format.setSamples(SAMPLES);
+   setFormat(format);
+
+   // The host widget handles all input
+   setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+GlPlotSurface::~GlPlotSurface()
+{
+   release();
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+QRect GlPlotSurface::glViewport(const QRect& area) const
+{
+   const qreal ratio = devicePixelRatioF();
+   return {qRound(area.left() * ratio),
+           qRound((height() - area.top() - area.height()) * ratio),
+           qRound(area.width() * ratio),
+           qRound(area.height() * ratio)};
+}
+
+std::unique_ptr<QOpenGLShaderProgram> GlPlotSurface::buildProgram(const char* vertexSource,
+                                                                  const char* fragmentSource)
+{
+   auto program = std::make_unique<QOpenGLShaderProgram>();
+   if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexSource) ||
+       !program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentSource) ||
+       !program->link())
+   {
+      GPWARN("GlPlotSurface: shader program failed: {}", program->log().toStdString());
+      return nullptr;
+   }
+   return program;
+}
+
+GLuint GlPlotSurface::createLutTexture(QOpenGLExtraFunctions& gl)
+{
+   GLuint texture = 0;
+   gl.glGenTextures(1, &texture);
+   gl.glBindTexture(GL_TEXTURE_2D, texture);
+   gl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+   gl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+   gl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+   gl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+   gl.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, LUT_SIZE, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                   nullptr);
+   return texture;
+}
+
+void GlPlotSurface::uploadLut(QOpenGLExtraFunctions& gl, GLuint texture,
+                              const ColorMap& colorMap)
+{
+   gl.glBindTexture(GL_TEXTURE_2D, texture);
+   gl.glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+   gl.glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LUT_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                      colorMap.lut().data());
+}
+
+// ============================================================================
+// QOpenGLWidget
+// ============================================================================
+
+void GlPlotSurface::initializeGL()
+{
+   // Reparenting to another window destroys the context: free the host's
+   // resources with it; initializeGL() runs again on the new one.
+   connect(context(), &QOpenGLContext::aboutToBeDestroyed,
+           this, &GlPlotSurface::release, Qt::UniqueConnection);
+
+   _initialized = true;
+   _failed = !_onInitialize();
+   if (_failed)
+   {
+      GPWARN("GlPlotSurface: OpenGL {}.{} resources unavailable", GL_MAJOR, GL_MINOR);
+   }
+}
+
+void GlPlotSurface::paintGL()
+{
+   QPainter painter(this);
+   _onPaint(painter);
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+void GlPlotSurface::release()
+{
+   if (!_initialized)
+   {
+      return;
+   }
+   _initialized = false;
+
+   makeCurrent();
+   _onRelease();
+   doneCurrent();
+}
+
+} // namespace RealTimeGraphs
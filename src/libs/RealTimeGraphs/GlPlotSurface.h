@@ -0,0 +1,94 @@
+#ifndef GLPLOTSURFACE_H_
+#define GLPLOTSURFACE_H_
+
+// Project headers
+#include "ColorMap.h"
+
+// Third-party headers
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLWidget>
+
+// System headers
+#include <functional>
+#include <memory>
+
+class QPainter;
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class GlPlotSurface
+ * @brief OpenGL surface a plot widget paints through when GPU rendering is on.
+ *
+ * The surface covers its host plot widget and is transparent for mouse
+ * events, so the host keeps handling input.  A frame is painted by the
+ * host's paint handler with a QPainter on the surface: margins, labels and
+ * the cursor overlay are drawn as in the raster path, and the plot content
+ * between `beginNativePainting()` / `endNativePainting()` with the host's
+ * GL renderer.  The host creates its renderer in the initialize handler and
+ * destroys it in the release handler; both run with the context current.
+ */
+class GlPlotSurface : public QOpenGLWidget
+{
+   Q_OBJECT
+
+public:
+   using PaintHandler = std::function<void(QPainter&)>;
+   using InitializeHandler = std::function<bool()>;
+   using ReleaseHandler = std::function<void()>;
+
+   /**
+    * @param parent        Host plot widget; the surface covers it.
+    * @param onPaint       Paints a frame.
+    * @param onInitialize  Creates the GL resources; false if they cannot be.
+    * @param onRelease     Destroys the GL resources.
+    */
+   GlPlotSurface(QWidget* parent, PaintHandler onPaint, InitializeHandler onInitialize,
+                 ReleaseHandler onRelease);
+   ~GlPlotSurface() override;
+
+   GlPlotSurface(const GlPlotSurface&) = delete;
+   GlPlotSurface& operator=(const GlPlotSurface&) = delete;
+
+   /** @brief True once the initialize handler has failed. */
+   [[nodiscard]] bool failed() const { return _failed; }
+
+   /**
+    * @brief GL viewport of a rectangle in widget coordinates: device pixels,
+    * origin at the bottom left.
+    */
+   [[nodiscard]] QRect glViewport(const QRect& area) const;
+
+   /**
+    * @brief Compile and link a program from GLSL sources.
+    * @return The program, or nullptr (with the log written) on failure.
+    */
+   [[nodiscard]] static std::unique_ptr<QOpenGLShaderProgram> buildProgram(
+      const char* vertexSource, const char* fragmentSource);
+
+   /** @brief Create a 256 x 1 RGBA texture for a ColorMap LUT. */
+   [[nodiscard]] static GLuint createLutTexture(QOpenGLExtraFunctions& gl);
+
+   /** @brief Upload a ColorMap's LUT into a texture from createLutTexture(). */
+   static void uploadLut(QOpenGLExtraFunctions& gl, GLuint texture, const ColorMap& colorMap);
+
+protected:
+   void initializeGL() override;
+   void paintGL() override;
+
+private:
+   // Run the release handler once, with the context current.
+   void release();
+
+   PaintHandler _onPaint;
+   InitializeHandler _onInitialize;
+   ReleaseHandler _onRelease;
+   bool _initialized{false};
+   bool _failed{false};
+};
+
+} // namespace RealTimeGraphs
+
+#endif // GLPLOTSURFACE_H_
@@ -1,16 +1,16 @@
 #include "OscilloscopeWidget.h"
 #include "CommonGuiUtils.h"
 
+#include <Profiler.h>
+
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPaintEvent>
 #include <QResizeEvent>
-#include <QTimer>
 #include <QWheelEvent>
 
 #include <algorithm>
 #include <cmath>
-#include <limits>
 
 namespace RealTimeGraphs
 {
@@ -54,20 +54,6 @@ OscilloscopeWidget::OscilloscopeWidget(QWidget* parent)
 
    _capture.resize(CAPTURE_CAPACITY);
    _scratch.reserve(4096);
-
-   // Repaint at most ~60 Hz regardless of incoming data rate.
-   _repaintTimer = new QTimer(this);
-   _repaintTimer->setTimerType(Qt::PreciseTimer);
-   _repaintTimer->setInterval(16);   // ~60 Hz
-   connect(_repaintTimer, &QTimer::timeout, this, [this]()
-   {
-      if (_dirty)
-      {
-         _dirty = false;
-         update();
-      }
-   });
-   _repaintTimer->start();
 }
 
 // ============================================================================
@@ -101,6 +87,7 @@ void OscilloscopeWidget::setData(const std::vector<std::complex<float>>& samples
          n = CAPTURE_CAPACITY;
       }
 
+      const auto begin = _captureHead;
       const auto tailSpace = CAPTURE_CAPACITY - _captureHead;
       const auto first = std::min(n, tailSpace);
       std::copy(src, src + first, _capture.begin()
@@ -111,18 +98,19 @@ void OscilloscopeWidget::setData(const std::vector<std::complex<float>>& samples
       }
       _captureHead = (_captureHead + n) % CAPTURE_CAPACITY;
       _captureSize = std::min(CAPTURE_CAPACITY, _captureSize + n);
+      _envelope.update(_capture, begin, n);
 
       // Live view always anchors to the newest sample.
       _viewOffset = 0;
    }
 
-   _dirty = true;  // coalesced by the 60 Hz repaint timer
+   _renderClient.markDirty();  // coalesced to one repaint per frame
 }
 
 void OscilloscopeWidget::setAxisRange(float range)
 {
    _axisRange = range;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setTimeSpan(std::size_t sampleCount)
@@ -132,31 +120,31 @@ void OscilloscopeWidget::setTimeSpan(std::size_t sampleCount)
       _timeSpan = std::clamp<std::size_t>(sampleCount, 16, CAPTURE_CAPACITY);
       clampViewOffsetLocked();
    }
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setITraceEnabled(bool enable)
 {
    _iTraceEnabled = enable;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setQTraceEnabled(bool enable)
 {
    _qTraceEnabled = enable;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setSampleRate(double rateHz)
 {
    _sampleRateHz = rateHz;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setGridEnabled(bool enable)
 {
    _gridEnabled = enable;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setPaused(bool paused)
@@ -184,7 +172,7 @@ void OscilloscopeWidget::setPaused(bool paused)
       emit triggerDisarmed();
    }
 
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 bool OscilloscopeWidget::isPaused() const
@@ -215,13 +203,13 @@ void OscilloscopeWidget::setTriggerEnabled(bool enabled)
    {
       emit triggerDisarmed();
    }
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 void OscilloscopeWidget::setTriggerLevel(float level)
 {
    _triggerLevel = level;
-   safeUpdate(this);
+   _renderClient.markDirty();
 }
 
 bool OscilloscopeWidget::isTriggerEnabled() const
@@ -245,6 +233,7 @@ QSize OscilloscopeWidget::minimumSizeHint() const
 
 void OscilloscopeWidget::paintEvent(QPaintEvent* /*event*/)
 {
+   GPPROFILE_SCOPE("OscilloscopeWidget::paintEvent");
    QPainter painter(this);
    painter.setRenderHint(QPainter::Antialiasing, true);
 
@@ -479,7 +468,7 @@ void OscilloscopeWidget::drawOneTrace(QPainter& painter, const QRect& area,
 
    if (spp > ENVELOPE_SPP)
    {
-      // Envelope: one min + one max per pixel column.
+      // Envelope: one min + one max per pixel column, from the pyramid.
       _scratch.resize(static_cast<std::size_t>(W) * 2);
       std::size_t out = 0;
       for (int x = 0; x < W; ++x)
@@ -491,14 +480,9 @@ void OscilloscopeWidget::drawOneTrace(QPainter& painter, const QRect& area,
          if (s1 > viewEnd) s1 = viewEnd;
          if (s1 <= s0) continue;
 
-         float mn = std::numeric_limits<float>::infinity();
-         float mx = -std::numeric_limits<float>::infinity();
-         for (auto i = s0; i < s1; ++i)
-         {
-            const float v = component(_capture[physIdx(i)]);
-            if (v < mn) mn = v;
-            if (v > mx) mx = v;
-         }
+         const auto extent = _envelope.extent(_capture, physIdx(s0), s1 - s0);
+         const float mn = component(extent.lo);
+         const float mx = component(extent.hi);
          const qreal px = static_cast<qreal>(area.left() + x);
          _scratch[out++] = QPointF(px, yFromAmp(mx, area));
          _scratch[out++] = QPointF(px, yFromAmp(mn, area));
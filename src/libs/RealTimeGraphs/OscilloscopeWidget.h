@@ -1,10 +1,13 @@
 #ifndef OSCILLOSCOPEWIDGET_H_
 #define OSCILLOSCOPEWIDGET_H_
 
+// Project headers
+#include "EnvelopePyramid.h"
+#include "RenderClock.h"
+
 // Third-party headers
 #include <QPointF>
 #include <QPushButton>
-#include <QTimer>
 #include <QWidget>
 
 // System headers
@@ -103,7 +106,8 @@ private:
    void drawTriggerLine(QPainter& painter, const QRect& area) const;
 
    // Render a single trace (I or Q) using envelope or polyline mode
-   // depending on samples-per-pixel.  Caller must already hold _mutex.
+   // depending on samples-per-pixel; the envelope reads _envelope, so it
+   // costs O(width) at any zoom.  Caller must already hold _mutex.
    template <typename ComponentFn>
    void drawOneTrace(QPainter& painter, const QRect& area,
                      std::size_t viewBegin, std::size_t viewEnd,
@@ -126,6 +130,7 @@ private:
    std::vector<std::complex<float>> _capture;  // ring, size == capacity
    std::size_t _captureHead{0};                // next write index
    std::size_t _captureSize{0};                // valid element count
+   EnvelopePyramid _envelope{CAPTURE_CAPACITY};  // min/max blocks of _capture
 
    // Display view
    std::size_t _timeSpan{512};
@@ -150,9 +155,8 @@ private:
    QPushButton* _pauseButton{nullptr};
    QPushButton* _triggerButton{nullptr};
 
-   // Repaint throttling: setData() sets _dirty; timer at ~60 Hz repaints.
-   QTimer* _repaintTimer{nullptr};
-   bool _dirty{false};
+   // Repaints at most once per frame, however often data arrives
+   RenderClock::Client _renderClient{[this]() { update(); }};
 
    // Scratch buffer reused across paints to avoid per-frame allocation.
    std::vector<QPointF> _scratch;
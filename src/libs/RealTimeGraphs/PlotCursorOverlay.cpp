@@ -336,6 +336,7 @@ void PlotCursorOverlay::setBandwidthCursorEnabled(bool enabled)
       _bwCursorLocked = false;
       _bwCursorLockedY.reset();
       _linkedBwLockActive = false;
+      setBandwidthLevels(std::nullopt, std::nullopt);
    }
 }
 
@@ -362,6 +363,7 @@ bool PlotCursorOverlay::lockBandwidthCursor(const QPoint& pos,
    _bwCursorLockedX         = data.x;
    _bwCursorLockedHalfWidth = _bwCursorHalfWidthFrac;
    _bwCursorLockedY         = data.y;
+   setBandwidthLevels(std::nullopt, std::nullopt);
    return true;
 }
 
@@ -371,12 +373,14 @@ void PlotCursorOverlay::lockBandwidthCursorAt(double xData)
    _bwCursorLockedX         = xData;
    _bwCursorLockedHalfWidth = _bwCursorHalfWidthFrac;
    _bwCursorLockedY.reset(); // No Y info from peer sync
+   setBandwidthLevels(std::nullopt, std::nullopt);
 }
 
 void PlotCursorOverlay::unlockBandwidthCursor()
 {
    _bwCursorLocked = false;
    _bwCursorLockedY.reset();
+   setBandwidthLevels(std::nullopt, std::nullopt);
 }
 
 void PlotCursorOverlay::setLinkedBandwidthLock(double xData,
@@ -397,6 +401,13 @@ void PlotCursorOverlay::setBandwidthNoiseFloorEnabled(bool enabled)
    _bwNoiseFloorEnabled = enabled;
 }
 
+void PlotCursorOverlay::setBandwidthLevels(std::optional<double> noiseFloorY,
+                                           std::optional<double> bandPowerY)
+{
+   _bwMeasuredNoiseFloorY = noiseFloorY;
+   _bwMeasuredPowerY      = bandPowerY;
+}
+
 void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
                                              const QRect& area) const
 {
@@ -408,6 +419,7 @@ void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
    auto drawBand = [&](double centerX,
                        double halfWidth,
                        std::optional<double> noiseFloorY,
+                       std::optional<double> bandPowerY,
                        const QColor& bandColor,
                        const QColor& edgeColor,
                        Qt::PenStyle edgeStyle)
@@ -494,6 +506,14 @@ void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
                "BW: " + _formatBandwidth(halfWidth);
             const QRect bwRect(x1 + PAD, labelY, bandWidth - (2 * PAD), LINE_H);
             painter.drawText(bwRect, Qt::AlignHCenter | Qt::AlignTop, bwLabel);
+            labelY += LINE_H;
+         }
+
+         if (_formatY && bandPowerY.has_value() && bandWidth > 60)
+         {
+            const QString powerLabel = "P: " + _formatY(*bandPowerY);
+            const QRect powerRect(x1 + PAD, labelY, bandWidth - (2 * PAD), LINE_H);
+            painter.drawText(powerRect, Qt::AlignHCenter | Qt::AlignTop, powerLabel);
          }
       }
    };
@@ -501,9 +521,11 @@ void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
    // Draw selected (locked) band first so hover preview can be seen on top.
    if (_bwCursorLocked)
    {
+      // A measured noise floor replaces the level picked at lock time
       drawBand(_bwCursorLockedX,
                _bwCursorLockedHalfWidth,
-               _bwCursorLockedY,
+               _bwMeasuredNoiseFloorY.has_value() ? _bwMeasuredNoiseFloorY : _bwCursorLockedY,
+               _bwMeasuredPowerY,
                QColor(160, 160, 160, 60),
                QColor(190, 190, 190, 160),
                Qt::SolidLine);
@@ -513,6 +535,7 @@ void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
       drawBand(_linkedBwLockX,
                _linkedBwLockHalfWidth,
                std::nullopt,
+               std::nullopt,
                QColor(160, 160, 160, 60),
                QColor(190, 190, 190, 160),
                Qt::SolidLine);
@@ -525,6 +548,7 @@ void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
       drawBand(hoverData.x,
                _bwCursorHalfWidthFrac,
                std::optional<double>(hoverData.y),
+               std::nullopt,
                QColor(160, 160, 160, 35),
                QColor(0, 255, 0, 255),
                Qt::SolidLine);
@@ -534,6 +558,7 @@ void PlotCursorOverlay::drawBandwidthCursor(QPainter& painter,
       drawBand(*_linkedTrackingX,
                _bwCursorHalfWidthFrac,
                std::nullopt,
+               std::nullopt,
                QColor(160, 160, 160, 35),
                QColor(0, 255, 0, 255),
                Qt::SolidLine);
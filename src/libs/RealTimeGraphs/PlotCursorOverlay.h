@@ -170,6 +170,13 @@ public:
       return _bwNoiseFloorEnabled;
    }
 
+   /**
+    * @brief Set or clear the levels measured in the locked band.
+    * A noise floor replaces the Y picked at lock time; a band power is
+    * labelled under the bandwidth.  Locking or unlocking clears both.
+    */
+   void setBandwidthLevels(std::optional<double> noiseFloorY, std::optional<double> bandPowerY);
+
    /** @brief Set or clear a linked bandwidth cursor lock from another widget. */
    void setLinkedBandwidthLock(double xData, double halfWidthFrac);
 
@@ -223,6 +230,8 @@ private:
    double _bwCursorLockedHalfWidth{0.0}; ///< half-width snapshot at lock time
    std::optional<double> _bwCursorLockedY;  ///< Y (noise floor) snapshot at lock time
    bool _bwNoiseFloorEnabled{false};
+   std::optional<double> _bwMeasuredNoiseFloorY;  ///< From setBandwidthLevels()
+   std::optional<double> _bwMeasuredPowerY;
 
    // Linked bandwidth cursor lock from another widget
    bool _linkedBwLockActive{false};
@@ -0,0 +1,112 @@
+#include "PlotRasterizer.h"
+
+#include <Profiler.h>
+#include <ThreadConfig.h>
+
+#include <utility>
+
+namespace RealTimeGraphs
+{
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+PlotRasterizer::PlotRasterizer(RenderFn render, ReadyFn ready)
+   : _render{std::move(render)}
+   , _ready{std::move(ready)}
+{
+   _thread = std::thread([this]() { run(); });
+}
+
+PlotRasterizer::~PlotRasterizer()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+   }
+   _wake.notify_one();
+   _thread.join();
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void PlotRasterizer::setView(const View& view)
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      if (view == _view)
+      {
+         return;
+      }
+      _view    = view;
+      _pending = true;
+   }
+   _wake.notify_one();
+}
+
+void PlotRasterizer::requestFrame()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _pending = true;
+   }
+   _wake.notify_one();
+}
+
+QImage PlotRasterizer::latestFrame() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _front;
+}
+
+// ============================================================================
+// Worker
+// ============================================================================
+
+void PlotRasterizer::run()
+{
+   CommonUtils::configureCurrentThread("RealTimeGraphs.raster");
+
+   std::unique_lock<std::mutex> lock(_mutex);
+   while (true)
+   {
+      _wake.wait(lock, [this]() { return _stop || _pending; });
+      if (_stop)
+      {
+         return;
+      }
+      _pending = false;
+      const View view = _view;
+      if (view.size.isEmpty())
+      {
+         continue;
+      }
+
+      // Paint outside the lock: requests meanwhile set _pending again
+      QImage frame = std::move(_back);
+      lock.unlock();
+      {
+         GPPROFILE_SCOPE("PlotRasterizer::frame");
+         const QSize pixels = (QSizeF(view.size) * view.devicePixelRatio).toSize();
+         if (frame.size() != pixels)
+         {
+            frame = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+         }
+         frame.setDevicePixelRatio(view.devicePixelRatio);
+
+         QPainter painter(&frame);
+         _render(painter, QRect(QPoint(0, 0), view.size), view);
+      }
+      lock.lock();
+
+      _back = std::exchange(_front, std::move(frame));
+      lock.unlock();
+      _ready();
+      lock.lock();
+   }
+}
+
+} // namespace RealTimeGraphs
@@ -0,0 +1,93 @@
+#ifndef PLOTRASTERIZER_H_
+#define PLOTRASTERIZER_H_
+
+// Third-party headers
+#include <QImage>
+#include <QPainter>
+#include <QRect>
+#include <QSize>
+
+// System headers
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class PlotRasterizer
+ * @brief Paints a plot area into double-buffered images on a worker thread.
+ *
+ * requestFrame() wakes the worker, which paints the back image through the
+ * render callback and swaps it to the front; requests arriving meanwhile
+ * coalesce into one more frame.  The GUI thread only blits latestFrame(),
+ * a shallow copy, so colorizing and drawing the plot content no longer
+ * hold up input handling.  If the GUI still holds a frame when the worker
+ * reuses its buffer, QPainter detaches it: the worker never paints an
+ * image being blitted.
+ *
+ * The view (size, device pixel ratio and visible X range) is published by
+ * the GUI thread; a change renders a new frame.
+ */
+class PlotRasterizer
+{
+public:
+   /** @brief What a frame shows, as seen by the GUI thread. */
+   struct View
+   {
+      QSize size;                    ///< Plot area size in device-independent pixels
+      qreal devicePixelRatio{1.0};
+      double xStart{0.0};            ///< Visible start as a fraction of the data
+      double xEnd{1.0};              ///< Visible end as a fraction of the data
+
+      bool operator==(const View&) const = default;
+   };
+
+   /**
+    * @brief Paint a whole frame of `area` (origin 0, 0).  Worker thread;
+    * the callee guards its own data.
+    */
+   using RenderFn = std::function<void(QPainter& painter, const QRect& area, const View& view)>;
+
+   /** @brief Called on the worker thread when a frame is ready. */
+   using ReadyFn = std::function<void()>;
+
+   /** @brief Start the worker thread. */
+   PlotRasterizer(RenderFn render, ReadyFn ready);
+
+   /** @brief Stop and join the worker; a frame in progress is finished first. */
+   ~PlotRasterizer();
+
+   PlotRasterizer(const PlotRasterizer&) = delete;
+   PlotRasterizer& operator=(const PlotRasterizer&) = delete;
+
+   /** @brief Publish the view; renders a frame if it changed.  Thread-safe. */
+   void setView(const View& view);
+
+   /** @brief Render a frame of the current view.  Thread-safe. */
+   void requestFrame();
+
+   /** @brief The latest completed frame (null before the first). Thread-safe. */
+   [[nodiscard]] QImage latestFrame() const;
+
+private:
+   void run();
+
+   RenderFn _render;
+   ReadyFn _ready;
+
+   mutable std::mutex _mutex;
+   std::condition_variable _wake;
+   View _view;
+   bool _pending{false};
+   bool _stop{false};
+   QImage _front;   ///< Latest completed frame
+   QImage _back;    ///< Buffer for the next frame, reused
+   std::thread _thread;
+};
+
+} // namespace RealTimeGraphs
+
+#endif // PLOTRASTERIZER_H_
@@ -1,5 +1,11 @@
 #include "PlotWidgetBase.h"
 #include "CommonGuiUtils.h"
+#include "GlPlotSurface.h"
+
+#include <GeneralLogger.h>
+
+#include <QMetaObject>
+#include <QPainter>
 
 #include <algorithm>
 #include <cmath>
@@ -25,6 +31,62 @@ PlotWidgetBase::PlotWidgetBase(QWidget* parent)
 // Public API
 // ============================================================================
 
+void PlotWidgetBase::setRenderBackend(RenderBackend backend)
+{
+   if (backend == RenderBackend::Threaded && !hasThreadedRaster())
+   {
+      GPWARN("PlotWidgetBase: this plot has no threaded rasterizer; using raster painting");
+      backend = RenderBackend::Raster;
+   }
+   if (backend == renderBackend())
+   {
+      return;
+   }
+
+   // Destroying the surface runs releaseGpu() with its context current;
+   // destroying the rasterizer joins its worker, so no rasterizePlot()
+   // call outlives the switch
+   delete _glSurface;
+   _glSurface = nullptr;
+   _rasterizer.reset();
+
+   if (backend == RenderBackend::OpenGl)
+   {
+      _glSurface = new GlPlotSurface(
+         this,
+         [this](QPainter& painter)
+         {
+            if (_glSurface->failed())
+            {
+               fallBackToRaster();
+            }
+            paintFrame(painter);
+         },
+         [this]() { return initializeGpu(); },
+         [this]() { releaseGpu(); });
+      _glSurface->setGeometry(rect());
+      _glSurface->lower();   // keep embedded children (the color bar) on top
+      _glSurface->show();
+   }
+   else if (backend == RenderBackend::Threaded)
+   {
+      _rasterizer = std::make_unique<PlotRasterizer>(
+         [this](QPainter& painter, const QRect& area, const PlotRasterizer::View& view)
+         { rasterizePlot(painter, area, view); },
+         [this]() { _renderClient.markDirty(); });
+   }
+   repaintPlot();
+}
+
+PlotWidgetBase::RenderBackend PlotWidgetBase::renderBackend() const
+{
+   if (_glSurface != nullptr)
+   {
+      return RenderBackend::OpenGl;
+   }
+   return (_rasterizer != nullptr) ? RenderBackend::Threaded : RenderBackend::Raster;
+}
+
 void PlotWidgetBase::setFrequencyRange(double centerFreqHz, double bandwidthHz)
 {
    _centerFreqHz = centerFreqHz;
@@ -38,7 +100,7 @@ void PlotWidgetBase::setFrequencyRange(double centerFreqHz, double bandwidthHz)
    }
 
    emit xViewChanged(_viewXStart, _viewXEnd);
-   update();
+   repaintPlot();
 }
 
 QSize PlotWidgetBase::minimumSizeHint() const
@@ -59,19 +121,19 @@ void PlotWidgetBase::setXViewRange(double xStart, double xEnd)
    _viewXStart = xStart;
    _viewXEnd   = xEnd;
    onViewRangeChanged();
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::setLinkedCursorX(double xData)
 {
    _cursorOverlay.setLinkedTrackingX(xData);
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::clearLinkedCursorX()
 {
    _cursorOverlay.clearLinkedTrackingX();
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::setLinkedMeasCursors(double x1Valid, double x1,
@@ -88,7 +150,7 @@ void PlotWidgetBase::setLinkedMeasCursors(double x1Valid, double x1,
       opt2 = x2;
    }
    _cursorOverlay.setLinkedMeasCursors(opt1, opt2);
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::clearMeasCursors()
@@ -96,10 +158,10 @@ void PlotWidgetBase::clearMeasCursors()
    if (_cursorOverlay.clearCursors())
    {
       emitMeasCursorsChanged();
-      update();
+      repaintPlot();
    }
    _cursorOverlay.setLinkedMeasCursors(std::nullopt, std::nullopt);
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::setBandwidthCursorEnabled(bool enabled)
@@ -110,38 +172,149 @@ void PlotWidgetBase::setBandwidthCursorEnabled(bool enabled)
    {
       syncBandwidthOverlay();
    }
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::setBandwidthNoiseFloorEnabled(bool enabled)
 {
    _cursorOverlay.setBandwidthNoiseFloorEnabled(enabled);
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::setBandwidthCursorHalfWidthHz(double hz)
 {
    _bwSelector.setHalfWidthHz(hz);
    syncBandwidthOverlay();
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::lockBandwidthCursorAt(double xData)
 {
    _cursorOverlay.lockBandwidthCursorAt(xData);
-   update();
+   repaintPlot();
 }
 
 void PlotWidgetBase::unlockBandwidthCursor()
 {
    _cursorOverlay.unlockBandwidthCursor();
-   update();
+   repaintPlot();
+}
+
+void PlotWidgetBase::setBandwidthLevels(std::optional<double> noiseFloorDb,
+                                        std::optional<double> bandPowerDb)
+{
+   if (!_cursorOverlay.isBandwidthCursorLocked())
+   {
+      return;
+   }
+   _cursorOverlay.setBandwidthLevels(noiseFloorDb, bandPowerDb);
+   repaintPlot();
+}
+
+// ============================================================================
+// Events
+// ============================================================================
+
+void PlotWidgetBase::paintEvent(QPaintEvent* /*event*/)
+{
+   // With the OpenGl backend the surface covers the widget and paints
+   if (_glSurface != nullptr)
+   {
+      return;
+   }
+   QPainter painter(this);
+   paintFrame(painter);
+}
+
+void PlotWidgetBase::resizeEvent(QResizeEvent* event)
+{
+   QWidget::resizeEvent(event);
+   if (_glSurface != nullptr)
+   {
+      _glSurface->setGeometry(rect());
+   }
 }
 
 // ============================================================================
 // Protected helpers
 // ============================================================================
 
+bool PlotWidgetBase::initializeGpu()
+{
+   return false;
+}
+
+void PlotWidgetBase::releaseGpu()
+{
+   // Default: nothing to release.
+}
+
+bool PlotWidgetBase::hasThreadedRaster() const
+{
+   return false;
+}
+
+void PlotWidgetBase::rasterizePlot(QPainter& /*painter*/, const QRect& /*area*/,
+                                   const PlotRasterizer::View& /*view*/)
+{
+   // Default: nothing; only called if hasThreadedRaster() is overridden.
+}
+
+bool PlotWidgetBase::drawRasterizedPlot(QPainter& painter, const QRect& area)
+{
+   if (_rasterizer == nullptr)
+   {
+      return false;
+   }
+
+   // A changed size or X range renders a frame for it; meanwhile the
+   // latest one is stretched over the area
+   _rasterizer->setView({area.size(), devicePixelRatioF(), _viewXStart, _viewXEnd});
+   const QImage frame = _rasterizer->latestFrame();
+   if (frame.isNull())
+   {
+      painter.fillRect(area, QColor(15, 15, 20));
+   }
+   else
+   {
+      painter.drawImage(QRectF(area), frame);
+   }
+   return true;
+}
+
+void PlotWidgetBase::repaintPlot()
+{
+   // The surface and the rasterizer are only touched on the GUI thread, in
+   // the clock's tick
+   _contentDirty.store(true);
+   _renderClient.markDirty();
+}
+
+void PlotWidgetBase::repaintNow()
+{
+   // A finished rasterized frame only marks the client: blit, don't re-render
+   if (_rasterizer != nullptr && _contentDirty.exchange(false))
+   {
+      _rasterizer->requestFrame();
+   }
+
+   if (_glSurface != nullptr)
+   {
+      _glSurface->update();
+   }
+   else
+   {
+      update();
+   }
+}
+
+void PlotWidgetBase::fallBackToRaster()
+{
+   // Queued: this may run inside the surface's own paintGL()
+   QMetaObject::invokeMethod(
+      this, [this]() { setRenderBackend(RenderBackend::Raster); }, Qt::QueuedConnection);
+}
+
 void PlotWidgetBase::onViewRangeChanged()
 {
    // Default: nothing.  Subclasses override (e.g. for color-bar sync).
@@ -199,7 +372,7 @@ bool PlotWidgetBase::processCursorMove(const QPoint& pos)
       const double dataX = _viewXStart +
                          (std::clamp(xFrac, 0.0, 1.0) * (_viewXEnd - _viewXStart));
       emit trackingCursorXChanged(dataX);
-      update();
+      repaintPlot();
       return true;
    }
    return false;
@@ -210,7 +383,7 @@ void PlotWidgetBase::processLeaveEvent(QEvent* event)
    if (_cursorOverlay.handleLeave())
    {
       emit trackingCursorLeft();
-      update();
+      repaintPlot();
    }
    QWidget::leaveEvent(event);
 }
@@ -224,7 +397,7 @@ bool PlotWidgetBase::processBandwidthWheel(int angleDelta)
    _bwSelector.adjustHalfWidth(-angleDelta);
    syncBandwidthOverlay();
    emit bandwidthCursorHalfWidthChanged(_bwSelector.halfWidthHz());
-   update();
+   repaintPlot();
    return true;
 }
 
@@ -251,7 +424,7 @@ bool PlotWidgetBase::processBandwidthClick(const QPoint& pos)
       }
       emit bandwidthCursorHalfWidthChanged(_bwSelector.halfWidthHz());
    }
-   update();
+   repaintPlot();
    return true;
 }
 
@@ -260,13 +433,13 @@ bool PlotWidgetBase::processMiddleButtonPress()
    if (_cursorOverlay.clearCursors())
    {
       emitMeasCursorsChanged();
-      update();
+      repaintPlot();
    }
    if (_bwSelector.isEnabled() && _cursorOverlay.isBandwidthCursorLocked())
    {
       _cursorOverlay.unlockBandwidthCursor();
       emit bandwidthCursorUnlocked();
-      update();
+      repaintPlot();
    }
    emit requestPeerCursorClear();
    return true;
@@ -282,7 +455,7 @@ bool PlotWidgetBase::processMeasCursorDoubleClick(QMouseEvent* event)
       {
          emit requestPeerCursorClear();
          emitMeasCursorsChanged();
-         update();
+         repaintPlot();
       }
       return true;
    }
@@ -292,7 +465,7 @@ bool PlotWidgetBase::processMeasCursorDoubleClick(QMouseEvent* event)
       {
          emit requestPeerCursorClear();
          emitMeasCursorsChanged();
-         update();
+         repaintPlot();
       }
       return true;
    }
@@ -4,31 +4,71 @@
 // Project headers
 #include "BandwidthSelector.h"
 #include "PlotCursorOverlay.h"
+#include "PlotRasterizer.h"
+#include "RenderClock.h"
 
 // Third-party headers
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QWidget>
 
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+class QPainter;
+
 namespace RealTimeGraphs
 {
 
+class GlPlotSurface; // forward declaration
+
 /**
  * @class PlotWidgetBase
  * @brief Abstract base class for frequency-domain plot widgets.
  *
  * Centralises the cursor overlay, bandwidth selector, and the shared
  * mouse-interaction logic that is common to SpectrumWidget and
- * WaterfallWidget.  Subclasses implement `plotArea()` and provide
- * their own painting, zooming, and panning.
+ * WaterfallWidget.  Subclasses implement `plotArea()` and `paintFrame()`
+ * and provide their own zooming and panning.
+ *
+ * A frame is painted with QPainter on the widget, or, with the OpenGl
+ * render backend, on a GlPlotSurface covering it: the subclass then draws
+ * its plot content with a GL renderer created in `initializeGpu()`.  If
+ * OpenGL is unavailable the widget falls back to raster painting.
+ *
+ * With the Threaded backend a PlotRasterizer paints the plot content on a
+ * worker thread through `rasterizePlot()`, and `paintFrame()` blits the
+ * latest image with `drawRasterizedPlot()` before drawing labels and
+ * cursors as usual.  Subclasses opt in with `hasThreadedRaster()`.
  */
 class PlotWidgetBase : public QWidget
 {
    Q_OBJECT
 
 public:
+   /** @brief How frames are painted. */
+   enum class RenderBackend : std::uint8_t
+   {
+      Raster,   ///< QPainter on the widget
+      OpenGl,   ///< Plot content on the GPU, through a GlPlotSurface
+      Threaded  ///< Plot content rasterized into an image on a worker thread
+   };
+
    explicit PlotWidgetBase(QWidget* parent = nullptr);
 
+   /**
+    * @brief Select the render backend (default Raster).
+    * Falls back to Raster by itself if the OpenGL resources cannot be created,
+    * and stays Raster for Threaded if the subclass does not support it.
+    */
+   void setRenderBackend(RenderBackend backend);
+
+   /** @brief The render backend in use. */
+   [[nodiscard]] RenderBackend renderBackend() const;
+
    /**
     * @brief Set the frequency range so the x-axis shows real frequencies.
     * @param centerFreqHz  Centre frequency in Hz.
@@ -74,6 +114,13 @@ public slots:
    /** @brief Unlock bandwidth cursor (from peer). */
    void unlockBandwidthCursor();
 
+   /**
+    * @brief Show levels measured in the locked band (e.g. SpectrumData::levels).
+    * The noise floor replaces the level picked when the band was locked.
+    * Call on the GUI thread; std::nullopt clears a value.
+    */
+   void setBandwidthLevels(std::optional<double> noiseFloorDb, std::optional<double> bandPowerDb);
+
 signals:
    /** @brief Emitted when the user zooms or pans the X axis. */
    void xViewChanged(double xStart, double xEnd);
@@ -107,9 +154,59 @@ signals:
    void bandwidthCursorUnlocked();
 
 protected:
+   void paintEvent(QPaintEvent* event) override;
+   void resizeEvent(QResizeEvent* event) override;
+
    /** @brief Compute the plot area rectangle.  Subclasses must implement this. */
    [[nodiscard]] virtual QRect plotArea() const = 0;
 
+   /**
+    * @brief Paint a whole frame.  Subclasses must implement this.
+    * The painter is on the widget, or on the GL surface with the OpenGl
+    * backend (the context is then current for native painting).
+    */
+   virtual void paintFrame(QPainter& painter) = 0;
+
+   /**
+    * @brief Create the GL renderer; the context is current.
+    * @return False if it cannot be created (the default).
+    */
+   virtual bool initializeGpu();
+
+   /** @brief Destroy the GL renderer; the context is current. */
+   virtual void releaseGpu();
+
+   /** @brief True if the subclass implements rasterizePlot() (default false). */
+   [[nodiscard]] virtual bool hasThreadedRaster() const;
+
+   /**
+    * @brief Paint the whole plot area for the Threaded backend.
+    * Runs on the rasterizer's worker thread: read shared state under the
+    * subclass's mutex, and the visible X range from `view`, not the members.
+    * @param area  The plot area, at the origin.
+    */
+   virtual void rasterizePlot(QPainter& painter, const QRect& area,
+                              const PlotRasterizer::View& view);
+
+   /**
+    * @brief With the Threaded backend, blit the latest rasterized plot.
+    * Also publishes the current view to the rasterizer (GUI thread).
+    * @return False with another backend: paint the plot content directly.
+    */
+   bool drawRasterizedPlot(QPainter& painter, const QRect& area);
+
+   /** @brief The GL surface while the OpenGl backend is selected. */
+   [[nodiscard]] GlPlotSurface* glSurface() const { return _glSurface; }
+
+   /**
+    * @brief Repaint the widget or its GL surface in the next RenderClock frame.
+    * Thread-safe — can be called from a producer thread.
+    */
+   void repaintPlot();
+
+   /** @brief Switch to the Raster backend once control returns to the event loop. */
+   void fallBackToRaster();
+
    /**
     * @brief Virtual hook called when the view X range changes.
     * Override to perform additional synchronisation (e.g. color-bar update).
@@ -181,6 +278,16 @@ protected:
    static constexpr int MARGIN_TOP       = 10;
    static constexpr int MARGIN_BOTTOM    = 25;
    static constexpr int COLOR_BAR_WIDTH  = 68;
+
+private:
+   // RenderClock tick: start a rasterized frame if the content changed, and
+   // repaint whichever of the widget and surface shows the plot.
+   void repaintNow();
+
+   GlPlotSurface* _glSurface{nullptr};   ///< Child surface, OpenGl backend only
+   std::atomic<bool> _contentDirty{false};   ///< repaintPlot() since the last tick
+   RenderClock::Client _renderClient{[this]() { repaintNow(); }};
+   std::unique_ptr<PlotRasterizer> _rasterizer;   ///< Threaded backend only
 };
 
 } // namespace RealTimeGraphs
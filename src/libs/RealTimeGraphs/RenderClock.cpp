@@ -0,0 +1,132 @@
+#include "RenderClock.h"
+
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
+#include <utility>
+
+namespace RealTimeGraphs
+{
+
+// ============================================================================
+// Client
+// ============================================================================
+
+RenderClock::Client::Client(std::function<void()> repaint)
+   : _repaint{std::move(repaint)}
+   , _clock{&RenderClock::instance()}
+{
+   _clock->attach(this);
+}
+
+RenderClock::Client::~Client()
+{
+   if (_clock != nullptr)
+   {
+      _clock->detach(this);
+   }
+}
+
+void RenderClock::Client::markDirty()
+{
+   // Already dirty: the clock is running and will not stop before this tick
+   if (!_dirty.exchange(true) && _clock != nullptr)
+   {
+      _clock->wake();
+   }
+}
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+RenderClock& RenderClock::instance()
+{
+   static QPointer<RenderClock> clock;
+   if (clock.isNull())
+   {
+      clock = new RenderClock(QCoreApplication::instance());
+   }
+   return *clock;
+}
+
+RenderClock::RenderClock(QObject* parent)
+   : QObject(parent)
+{
+   _timer.setTimerType(Qt::PreciseTimer);
+   connect(&_timer, &QTimer::timeout, this, [this]() { tick(); });
+}
+
+void RenderClock::attach(Client* client)
+{
+   _clients.push_back(client);
+}
+
+void RenderClock::detach(Client* client)
+{
+   std::erase(_clients, client);
+}
+
+void RenderClock::wake()
+{
+   if (_armed.exchange(true))
+   {
+      return;
+   }
+   QMetaObject::invokeMethod(
+      this,
+      [this]()
+      {
+         if (!_timer.isActive())
+         {
+            _timer.start(frameIntervalMs());
+         }
+      },
+      Qt::AutoConnection);
+}
+
+void RenderClock::tick()
+{
+   bool repainted = false;
+   for (std::size_t i = 0; i < _clients.size(); ++i)
+   {
+      Client* client = _clients[i];
+      if (client->_dirty.exchange(false))
+      {
+         client->_repaint();
+         repainted = true;
+      }
+   }
+   if (repainted)
+   {
+      return;
+   }
+
+   // Idle.  A client marked between the scan and disarming did not wake
+   // the clock, so look once more before stopping.
+   _armed.store(false);
+   const bool pending = std::ranges::any_of(_clients, [](const Client* client)
+                                            { return client->_dirty.load(); });
+   if (pending)
+   {
+      _armed.store(true);
+      return;
+   }
+   _timer.stop();
+}
+
+int RenderClock::frameIntervalMs()
+{
+   constexpr double FALLBACK_RATE_HZ = 60.0;
+   const QScreen* screen = QGuiApplication::primaryScreen();
+   const double rate = (screen != nullptr && screen->refreshRate() > 1.0)
+                          ? screen->refreshRate()
+                          : FALLBACK_RATE_HZ;
+
+   // Rounded down: a tick per refresh at least
+   return std::max(1, static_cast<int>(1000.0 / rate));
+}
+
+} // namespace RealTimeGraphs
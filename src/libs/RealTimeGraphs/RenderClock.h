@@ -0,0 +1,91 @@
+#ifndef RENDERCLOCK_H_
+#define RENDERCLOCK_H_
+
+// Third-party headers
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+// System headers
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class RenderClock
+ * @brief One frame clock for all plot widgets of the application.
+ *
+ * Widgets do not post a repaint per data arrival: they mark their Client
+ * dirty, which is an atomic store, and the clock repaints every dirty
+ * client together once per display refresh.  An event is posted only to
+ * wake the clock from idle, so the event-loop load no longer follows the
+ * data rate, and the widgets of a window update in the same frame.
+ *
+ * The tick interval is the primary screen's refresh period, rounded down
+ * so no refresh is missed.  QWidget offers no vsync callback; GL surfaces
+ * are held to vsync by their buffer swap.  The timer stops after a frame
+ * with nothing to repaint.
+ *
+ * Lives on the GUI thread and is owned by the application object.
+ */
+class RenderClock : public QObject
+{
+public:
+   /**
+    * @class Client
+    * @brief A widget's registration with the clock.
+    *
+    * Create and destroy on the GUI thread, typically as a widget member;
+    * markDirty() may be called from any thread.
+    */
+   class Client
+   {
+   public:
+      /** @param repaint  Called on the GUI thread in a tick after markDirty(). */
+      explicit Client(std::function<void()> repaint);
+      ~Client();
+
+      Client(const Client&) = delete;
+      Client& operator=(const Client&) = delete;
+
+      /** @brief Request a repaint in the next frame.  Thread-safe. */
+      void markDirty();
+
+   private:
+      friend class RenderClock;
+
+      std::function<void()> _repaint;
+      std::atomic<bool> _dirty{false};
+      QPointer<RenderClock> _clock;
+   };
+
+   /** @brief The application's clock, created on first use (GUI thread). */
+   [[nodiscard]] static RenderClock& instance();
+
+private:
+   explicit RenderClock(QObject* parent);
+
+   // GUI thread: Client registration.
+   void attach(Client* client);
+   void detach(Client* client);
+
+   // Any thread: start the timer if it is idle.
+   void wake();
+
+   // Repaint the dirty clients; stop when there were none.
+   void tick();
+
+   // Refresh period of the primary screen in ms.
+   [[nodiscard]] static int frameIntervalMs();
+
+   QTimer _timer;
+   std::vector<Client*> _clients;
+   std::atomic<bool> _armed{false};   ///< Timer running or start posted
+};
+
+} // namespace RealTimeGraphs
+
+#endif // RENDERCLOCK_H_
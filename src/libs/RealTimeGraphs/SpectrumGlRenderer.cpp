@@ -0,0 +1,178 @@
+#include "SpectrumGlRenderer.h"
+
+#include "GlPlotSurface.h"
+
+#include <QOpenGLContext>
+
+#include <cstddef>
+
+namespace RealTimeGraphs
+{
+
+namespace
+{
+
+// point = (bin fraction, normalised level); x maps through the visible range
+constexpr const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 point;
+uniform vec2 xRange;
+out float level;
+void main()
+{
+   level = point.y;
+   float x = (point.x - xRange.x) / (xRange.y - xRange.x);
+   gl_Position = vec4((x * 2.0) - 1.0, (point.y * 2.0) - 1.0, 0.0, 1.0);
+}
+)";
+
+// solid == 0: LUT color of the level (the height, under the fill), alpha
+// from `color`; solid == 1: `color` as is
+constexpr const char* FRAGMENT_SHADER = R"(#version 330 core
+uniform sampler2D lut;
+uniform int solid;
+uniform vec4 color;
+in float level;
+out vec4 fragColor;
+void main()
+{
+   if (solid == 1)
+   {
+      fragColor = color;
+      return;
+   }
+   int index = int(clamp(level, 0.0, 1.0) * 255.0);
+   fragColor = vec4(texelFetch(lut, ivec2(index, 0), 0).rgb, color.a);
+}
+)";
+
+constexpr GLint LUT_UNIT = 0;
+
+// Opacities of the raster path: gradient fill 70, trace 220 (of 255)
+constexpr float FILL_ALPHA  = 70.0F / 255.0F;
+constexpr float TRACE_ALPHA = 220.0F / 255.0F;
+
+constexpr GLint FLOATS_PER_VERTEX = 2;
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+SpectrumGlRenderer::SpectrumGlRenderer()
+   : _context{QOpenGLContext::currentContext()}
+   , _gl{_context->extraFunctions()}
+{
+   _program = GlPlotSurface::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+   if (_program == nullptr || !_vao.create() || !_vertices.create())
+   {
+      _program.reset();
+      return;
+   }
+   _vertices.setUsagePattern(QOpenGLBuffer::StreamDraw);
+   _lutTexture = GlPlotSurface::createLutTexture(*_gl);
+}
+
+SpectrumGlRenderer::~SpectrumGlRenderer()
+{
+   // Otherwise the texture goes with its context when it is destroyed
+   if (QOpenGLContext::currentContext() == _context)
+   {
+      _gl->glDeleteTextures(1, &_lutTexture);
+   }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void SpectrumGlRenderer::setColorMap(const ColorMap& colorMap)
+{
+   GlPlotSurface::uploadLut(*_gl, _lutTexture, colorMap);
+}
+
+void SpectrumGlRenderer::draw(const QRect& viewport, double xStart, double xEnd,
+                              std::span<const float> spectrum, std::span<const Trace> holds)
+{
+   if (xEnd <= xStart)
+   {
+      return;
+   }
+
+   _gl->glViewport(viewport.x(), viewport.y(), viewport.width(), viewport.height());
+   _gl->glEnable(GL_SCISSOR_TEST);
+   _gl->glScissor(viewport.x(), viewport.y(), viewport.width(), viewport.height());
+   _gl->glDisable(GL_DEPTH_TEST);
+   _gl->glEnable(GL_BLEND);
+   _gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+   _gl->glActiveTexture(GL_TEXTURE0 + LUT_UNIT);
+   _gl->glBindTexture(GL_TEXTURE_2D, _lutTexture);
+
+   _program->bind();
+   _program->setUniformValue("lut", LUT_UNIT);
+   _program->setUniformValue("xRange", static_cast<GLfloat>(xStart),
+                             static_cast<GLfloat>(xEnd));
+   _vao.bind();
+   _vertices.bind();
+
+   // Gradient fill under the curve, then the trace colored by level
+   const GLsizei pairs = upload(spectrum);
+   _program->setUniformValue("solid", 0);
+   _program->setUniformValue("color", 0.0F, 0.0F, 0.0F, FILL_ALPHA);
+   drawStrip(GL_TRIANGLE_STRIP, pairs, false);
+   _program->setUniformValue("color", 0.0F, 0.0F, 0.0F, TRACE_ALPHA);
+   drawStrip(GL_LINE_STRIP, pairs, true);
+
+   _program->setUniformValue("solid", 1);
+   for (const Trace& hold : holds)
+   {
+      _program->setUniformValue("color", hold.color);
+      drawStrip(GL_LINE_STRIP, upload(hold.levels), true);
+   }
+
+   _vertices.release();
+   _vao.release();
+   _program->release();
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+GLsizei SpectrumGlRenderer::upload(std::span<const float> levels)
+{
+   const std::size_t bins = levels.size();
+   _staging.resize(bins * 2 * FLOATS_PER_VERTEX);
+   for (std::size_t i = 0; i < bins; ++i)
+   {
+      const auto x = static_cast<float>((static_cast<double>(i) + 0.5) /
+                                        static_cast<double>(bins));
+      float* pair = _staging.data() + (i * 2 * FLOATS_PER_VERTEX);
+      pair[0] = x;
+      pair[1] = levels[i];
+      pair[2] = x;
+      pair[3] = 0.0F;
+   }
+
+   // Reallocating each frame lets the driver orphan the previous buffer
+   _vertices.allocate(_staging.data(), static_cast<int>(_staging.size() * sizeof(float)));
+   return static_cast<GLsizei>(bins);
+}
+
+void SpectrumGlRenderer::drawStrip(GLenum mode, GLsizei pairs, bool levelsOnly)
+{
+   if (pairs < 2)
+   {
+      return;
+   }
+
+   // A level vertex is every other one: skip its baseline with the stride
+   const GLsizei vertexBytes = FLOATS_PER_VERTEX * static_cast<GLsizei>(sizeof(float));
+   _gl->glEnableVertexAttribArray(0);
+   _gl->glVertexAttribPointer(0, FLOATS_PER_VERTEX, GL_FLOAT, GL_FALSE,
+                              levelsOnly ? 2 * vertexBytes : vertexBytes, nullptr);
+   _gl->glDrawArrays(mode, 0, levelsOnly ? pairs : 2 * pairs);
+}
+
+} // namespace RealTimeGraphs
@@ -0,0 +1,90 @@
+#ifndef SPECTRUMGLRENDERER_H_
+#define SPECTRUMGLRENDERER_H_
+
+// Project headers
+#include "ColorMap.h"
+
+// Third-party headers
+#include <QColor>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QRect>
+
+// System headers
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class SpectrumGlRenderer
+ * @brief Draws spectrum traces with OpenGL from a vertex buffer.
+ *
+ * A trace is uploaded once per frame as a vertex pair per bin, the level
+ * and the baseline below it: drawn as a triangle strip that is the fill
+ * under the curve, and every other vertex as a line strip that is the
+ * trace.  The vertices carry bin fractions and normalised levels; the
+ * vertex shader maps them through the visible X range, so zooming and
+ * panning only change a uniform.  The fill takes its color from the
+ * ColorMap LUT by height and the trace by level, as the color bar does.
+ *
+ * Every call needs the GL context current.
+ */
+class SpectrumGlRenderer
+{
+public:
+   /** @brief A hold trace: normalised levels drawn in one color. */
+   struct Trace
+   {
+      std::span<const float> levels;
+      QColor color;
+   };
+
+   /** @brief Create the GL resources; check isValid() afterwards. */
+   SpectrumGlRenderer();
+   ~SpectrumGlRenderer();
+
+   SpectrumGlRenderer(const SpectrumGlRenderer&) = delete;
+   SpectrumGlRenderer& operator=(const SpectrumGlRenderer&) = delete;
+
+   /** @brief True if the shaders compiled and the buffers exist. */
+   [[nodiscard]] bool isValid() const { return _program != nullptr; }
+
+   /** @brief Upload a palette's LUT. */
+   void setColorMap(const ColorMap& colorMap);
+
+   /**
+    * @brief Draw the spectrum, filled and colored by level, then hold traces.
+    * @param viewport  GL viewport of the plot area.
+    * @param xStart    Visible start as a fraction of the bins.
+    * @param xEnd      Visible end as a fraction of the bins.
+    * @param spectrum  Normalised levels [0, 1], one per bin.
+    * @param holds     Hold traces drawn over it.
+    */
+   void draw(const QRect& viewport, double xStart, double xEnd,
+             std::span<const float> spectrum, std::span<const Trace> holds);
+
+private:
+   // Upload a vertex pair per bin; returns the pair count.
+   GLsizei upload(std::span<const float> levels);
+
+   // Draw the uploaded pairs as a strip: both vertices, or the levels only.
+   void drawStrip(GLenum mode, GLsizei pairs, bool levelsOnly);
+
+   QOpenGLContext* _context;      ///< Context the resources belong to
+   QOpenGLExtraFunctions* _gl;
+   std::unique_ptr<QOpenGLShaderProgram> _program;
+   QOpenGLVertexArrayObject _vao;
+   QOpenGLBuffer _vertices{QOpenGLBuffer::VertexBuffer};
+   GLuint _lutTexture{0};
+   std::vector<float> _staging;   ///< (bin fraction, level) pairs for the buffer
+};
+
+} // namespace RealTimeGraphs
+
+#endif // SPECTRUMGLRENDERER_H_
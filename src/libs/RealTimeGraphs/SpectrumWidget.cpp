@@ -1,16 +1,19 @@
 #include "SpectrumWidget.h"
 #include "ColorBarWidget.h"
 #include "CommonGuiUtils.h"
+#include "GlPlotSurface.h"
+#include "SpectrumGlRenderer.h"
 
 #include <GeneralLogger.h>
+#include <Profiler.h>
 
 #include <QLinearGradient>
 #include <QPainter>
-#include <QPainterPath>
 #include <QPaintEvent>
 #include <QResizeEvent>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
@@ -18,6 +21,14 @@
 namespace RealTimeGraphs
 {
 
+namespace
+{
+
+const QColor MAX_HOLD_COLOR(255, 255, 255, 200);
+const QColor MIN_HOLD_COLOR(140, 140, 150, 160);
+
+} // namespace
+
 // ============================================================================
 // Construction
 // ============================================================================
@@ -87,11 +98,17 @@ SpectrumWidget::SpectrumWidget(QWidget* parent)
       });
 }
 
+SpectrumWidget::~SpectrumWidget()
+{
+   // Release the GL renderer while this object can still do it
+   setRenderBackend(RenderBackend::Raster);
+}
+
 // ============================================================================
 // Public API
 // ============================================================================
 
-void SpectrumWidget::setData(const std::vector<float>& magnitudes)
+void SpectrumWidget::setData(std::span<const float> magnitudes)
 {
    if (_paused)
    {
@@ -99,7 +116,7 @@ void SpectrumWidget::setData(const std::vector<float>& magnitudes)
    }
    {
       const std::lock_guard<std::mutex> lock(_mutex);
-      _data = magnitudes;
+      _data.assign(magnitudes.begin(), magnitudes.end());
 
       // Update max-hold envelope
       if (_maxHoldEnabled)
@@ -107,7 +124,7 @@ void SpectrumWidget::setData(const std::vector<float>& magnitudes)
          auto sz = magnitudes.size();
          if (_maxHoldData.size() != sz)
          {
-            _maxHoldData = magnitudes;
+            _maxHoldData.assign(magnitudes.begin(), magnitudes.end());
          }
          else
          {
@@ -142,7 +159,42 @@ void SpectrumWidget::setData(const std::vector<float>& magnitudes)
          }
       }
    }
-   safeUpdate(this);
+   repaintPlot();
+}
+
+void SpectrumWidget::setData(std::span<const float> magnitudes,
+                             std::span<const float> maxHold,
+                             std::span<const float> minHold)
+{
+   if (maxHold.empty())
+   {
+      // No producer trace: fall back to the widget's own max hold.
+      setData(magnitudes);
+   }
+   if (_paused)
+   {
+      return;
+   }
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      if (!maxHold.empty())
+      {
+         _data.assign(magnitudes.begin(), magnitudes.end());
+         if (_maxHoldEnabled)
+         {
+            _maxHoldData.assign(maxHold.begin(), maxHold.end());
+         }
+      }
+      if (_minHoldEnabled)
+      {
+         _minHoldData.assign(minHold.begin(), minHold.end());
+      }
+      else
+      {
+         _minHoldData.clear();
+      }
+   }
+   repaintPlot();
 }
 
 void SpectrumWidget::setDbRange(float minDb, float maxDb)
@@ -152,27 +204,29 @@ void SpectrumWidget::setDbRange(float minDb, float maxDb)
    _viewMinDb = static_cast<double>(minDb);
    _viewMaxDb = static_cast<double>(maxDb);
    syncColorBar();
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setInputIsDb(bool isDb)
 {
    _inputIsDb = isDb;
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setColorMap(ColorMap::Palette palette)
 {
    _colorMap = ColorMap(palette);
+   _lutDirty = true;
+   _gradientsDirty = true;
    syncColorBar();
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setGridLines(int hCount, int vCount)
 {
    _numHorizontalGridLines = hCount;
    _numVerticalGridLines = vCount;
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::resetView()
@@ -183,13 +237,13 @@ void SpectrumWidget::resetView()
    _viewXEnd   = 1.0;
    syncColorBar();
    emit xViewChanged(_viewXStart, _viewXEnd);
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setColorBarVisible(bool visible)
 {
    _colorBar->setVisible(visible);
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setXAxisVisible(bool visible)
@@ -198,7 +252,7 @@ void SpectrumWidget::setXAxisVisible(bool visible)
    _cursorOverlay.setMargins(MARGIN_LEFT, MARGIN_RIGHT, MARGIN_TOP,
                              visible ? MARGIN_BOTTOM : MARGIN_BOTTOM_HIDDEN);
    _cursorOverlay.setShowXLabels(visible);
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setMaxHoldEnabled(bool enabled)
@@ -209,7 +263,7 @@ void SpectrumWidget::setMaxHoldEnabled(bool enabled)
       const std::lock_guard<std::mutex> lock(_mutex);
       _maxHoldData.clear();
    }
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void SpectrumWidget::setMaxHoldDecayRate(float dbPerSecond)
@@ -217,10 +271,21 @@ void SpectrumWidget::setMaxHoldDecayRate(float dbPerSecond)
    _maxHoldDecayRate = dbPerSecond;
 }
 
+void SpectrumWidget::setMinHoldEnabled(bool enabled)
+{
+   _minHoldEnabled = enabled;
+   if (!enabled)
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _minHoldData.clear();
+   }
+   repaintPlot();
+}
+
 void SpectrumWidget::setPaused(bool paused)
 {
    _paused = paused;
-   safeUpdate(this);
+   repaintPlot();
 }
 
 bool SpectrumWidget::isPaused() const
@@ -242,7 +307,7 @@ QRect SpectrumWidget::plotArea() const
 
 void SpectrumWidget::resizeEvent(QResizeEvent* event)
 {
-   QWidget::resizeEvent(event);
+   PlotWidgetBase::resizeEvent(event);
    const QRect area = plotArea();
    _colorBar->setGeometry(
       area.right() + 5,
@@ -251,9 +316,9 @@ void SpectrumWidget::resizeEvent(QResizeEvent* event)
       area.height());
 }
 
-void SpectrumWidget::paintEvent(QPaintEvent* /*event*/)
+void SpectrumWidget::paintFrame(QPainter& painter)
 {
-   QPainter painter(this);
+   GPPROFILE_SCOPE("SpectrumWidget::paintFrame");
    painter.setRenderHint(QPainter::Antialiasing, false);
 
    const QRect area = plotArea();
@@ -261,13 +326,21 @@ void SpectrumWidget::paintEvent(QPaintEvent* /*event*/)
    drawBackground(painter, area);
    drawGrid(painter, area);
 
-   // Clip spectrum to the plot area so zoomed/panned data
-   // does not overflow into the label margins.
-   painter.save();
-   painter.setClipRect(area);
-   drawSpectrum(painter, area);
-   drawMaxHold(painter, area);
-   painter.restore();
+   if (_glRenderer != nullptr)
+   {
+      drawTracesGl(painter, area);
+   }
+   else
+   {
+      // Clip spectrum to the plot area so zoomed/panned data
+      // does not overflow into the label margins.
+      painter.save();
+      painter.setClipRect(area);
+      drawSpectrum(painter, area);
+      drawMaxHold(painter, area);
+      drawMinHold(painter, area);
+      painter.restore();
+   }
 
    drawLabels(painter, area);
    drawFps(painter, area);
@@ -285,6 +358,23 @@ void SpectrumWidget::paintEvent(QPaintEvent* /*event*/)
    }
 }
 
+bool SpectrumWidget::initializeGpu()
+{
+   auto renderer = std::make_unique<SpectrumGlRenderer>();
+   if (!renderer->isValid())
+   {
+      return false;
+   }
+   _glRenderer = std::move(renderer);
+   _lutDirty   = true;
+   return true;
+}
+
+void SpectrumWidget::releaseGpu()
+{
+   _glRenderer.reset();
+}
+
 // ============================================================================
 // Drawing helpers
 // ============================================================================
@@ -315,160 +405,223 @@ void SpectrumWidget::drawGrid(QPainter& painter, const QRect& area) const
    }
 }
 
-void SpectrumWidget::drawSpectrum(QPainter& painter, const QRect& area) const
+void SpectrumWidget::drawSpectrum(QPainter& painter, const QRect& area)
 {
-   std::vector<float> snapshot;
    {
       const std::lock_guard<std::mutex> lock(_mutex);
-      snapshot = _data;
+      _traceValues.assign(_data.begin(), _data.end());
    }
 
-   if (snapshot.empty())
+   const std::size_t count = buildTrace(_traceValues, area);
+   if (count == 0)
    {
       return;
    }
+   updateGradients(area);
 
-   auto binCount = static_cast<int>(snapshot.size());
-   double viewWidth = _viewXEnd - _viewXStart;
-   if (viewWidth <= 0.0)
-   {
-      viewWidth = 1.0;
-   }
-
-   // Determine visible bin range (with 1-bin margin for line continuity)
-   const int firstBin = std::max(0,
-      static_cast<int>(std::floor(_viewXStart * static_cast<double>(binCount))) - 1);
-   const int lastBin = std::min(binCount - 1,
-      static_cast<int>(std::ceil(_viewXEnd * static_cast<double>(binCount))));
-
-   // Pre-compute normalised values and positions for visible bins
-   std::vector<float> norms(snapshot.size());
-   std::vector<float> xPts(snapshot.size());
-   std::vector<float> yPts(snapshot.size());
-
-   for (int i = firstBin; i <= lastBin; ++i)
-   {
-      auto si = static_cast<std::size_t>(i);
-      const float norm = toNormalised(snapshot[si]);
-      norms[si] = norm;
-
-      const double binFrac = (static_cast<double>(i) + 0.5) / static_cast<double>(binCount);
-      const double screenFrac = (binFrac - _viewXStart) / viewWidth;
-
-      xPts[si] = static_cast<float>(area.left()) +
-                 (static_cast<float>(screenFrac) * static_cast<float>(area.width()));
-      yPts[si] = static_cast<float>(area.bottom()) -
-                 (norm * static_cast<float>(area.height()));
-   }
-
-   // Build the fill path
-   QPainterPath fillPath;
-   fillPath.moveTo(static_cast<double>(xPts[static_cast<std::size_t>(firstBin)]),
-                   static_cast<double>(area.bottom()));
-   for (int i = firstBin; i <= lastBin; ++i)
-   {
-      fillPath.lineTo(static_cast<double>(xPts[static_cast<std::size_t>(i)]),
-                      static_cast<double>(yPts[static_cast<std::size_t>(i)]));
-   }
-   fillPath.lineTo(static_cast<double>(xPts[static_cast<std::size_t>(lastBin)]),
-                   static_cast<double>(area.bottom()));
-   fillPath.closeSubpath();
+   // _tracePoints is the trace between two baseline points: the fill polygon.
+   // Colored by height like the color bar, so the trace is one polyline.
+   painter.setRenderHint(QPainter::Antialiasing, true);
+   painter.setPen(Qt::NoPen);
+   painter.setBrush(_fillGradient);
+   painter.drawPolygon(_tracePoints.data(), static_cast<int>(count + 2));
+   painter.setBrush(Qt::NoBrush);
+   painter.setPen(QPen(QBrush(_traceGradient), 1.5));
+   painter.drawPolyline(_tracePoints.data() + 1, static_cast<int>(count));
+   painter.setRenderHint(QPainter::Antialiasing, false);
+}
 
-   // Draw gradient fill under the curve matching the color bar
-   QLinearGradient gradient(0, area.top(), 0, area.bottom());
-   constexpr int GRADIENT_STOPS = 16;
-   for (int s = 0; s <= GRADIENT_STOPS; ++s)
+void SpectrumWidget::drawMaxHold(QPainter& painter, const QRect& area)
+{
+   if (!_maxHoldEnabled)
    {
-      const float frac = static_cast<float>(s) / static_cast<float>(GRADIENT_STOPS);
-      // frac 0 = top of plot = high value, frac 1 = bottom = low value
-      const float norm = 1.0F - frac;
-      const Color c = _colorMap.map(norm);
-      gradient.setColorAt(static_cast<double>(frac),
-                          QColor(c.r, c.g, c.b, 70));
+      return;
    }
 
-   painter.setRenderHint(QPainter::Antialiasing, true);
-   painter.fillPath(fillPath, gradient);
-
-   // Draw per-segment colored line on top — each segment uses the
-   // average normalised value of its two endpoints to pick a color.
-   for (int i = firstBin + 1; i <= lastBin; ++i)
    {
-      auto si = static_cast<std::size_t>(i);
-      const float avgNorm = (norms[si - 1] + norms[si]) * 0.5F;
-      const Color c = _colorMap.map(avgNorm);
-      painter.setPen(QPen(QColor(c.r, c.g, c.b, 220), 1.5));
-      painter.drawLine(QPointF(static_cast<double>(xPts[si - 1]),
-                               static_cast<double>(yPts[si - 1])),
-                       QPointF(static_cast<double>(xPts[si]),
-                               static_cast<double>(yPts[si])));
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _traceValues.assign(_maxHoldData.begin(), _maxHoldData.end());
    }
-   painter.setRenderHint(QPainter::Antialiasing, false);
+   drawHoldTrace(painter, area, _traceValues, MAX_HOLD_COLOR);
 }
 
-void SpectrumWidget::drawMaxHold(QPainter& painter, const QRect& area) const
+void SpectrumWidget::drawMinHold(QPainter& painter, const QRect& area)
 {
-   if (!_maxHoldEnabled)
+   if (!_minHoldEnabled)
    {
       return;
    }
 
-   std::vector<float> holdSnapshot;
    {
       const std::lock_guard<std::mutex> lock(_mutex);
-      holdSnapshot = _maxHoldData;
+      _traceValues.assign(_minHoldData.begin(), _minHoldData.end());
    }
+   drawHoldTrace(painter, area, _traceValues, MIN_HOLD_COLOR);
+}
 
-   if (holdSnapshot.empty())
+void SpectrumWidget::drawHoldTrace(QPainter& painter, const QRect& area,
+                                   const std::vector<float>& holdSnapshot,
+                                   const QColor& color)
+{
+   const std::size_t count = buildTrace(holdSnapshot, area);
+   if (count == 0)
    {
       return;
    }
 
-   auto binCount = static_cast<int>(holdSnapshot.size());
+   painter.setRenderHint(QPainter::Antialiasing, true);
+   painter.setPen(QPen(color, 1.0));
+   painter.drawPolyline(_tracePoints.data() + 1, static_cast<int>(count));
+   painter.setRenderHint(QPainter::Antialiasing, false);
+}
+
+std::size_t SpectrumWidget::buildTrace(const std::vector<float>& values, const QRect& area)
+{
+   const auto binCount = static_cast<int>(values.size());
+   const int width = area.width();
    double viewWidth = _viewXEnd - _viewXStart;
    if (viewWidth <= 0.0)
    {
       viewWidth = 1.0;
    }
 
-   // Use int for firstBin/lastBin to avoid UB when the subtraction goes negative.
+   // Visible bin range (with 1-bin margin for line continuity)
    const int firstBin = std::max(0,
       static_cast<int>(std::floor(_viewXStart * static_cast<double>(binCount))) - 1);
    const int lastBin = std::min(binCount - 1,
       static_cast<int>(std::ceil(_viewXEnd * static_cast<double>(binCount))));
+   if (width <= 0 || firstBin >= lastBin)
+   {
+      return 0;
+   }
+
+   const auto bottom = static_cast<double>(area.bottom());
+   const auto height = static_cast<double>(area.height());
+   const auto yPos = [&](float value)
+   { return bottom - (static_cast<double>(toNormalised(value)) * height); };
 
-   if (firstBin >= lastBin)
+   // [0] and [count + 1] are left for the baseline points of the fill
+   std::size_t out = 1;
+   const double binsPerPixel = viewWidth * static_cast<double>(binCount)
+                             / static_cast<double>(width);
+   constexpr double ENVELOPE_BINS_PER_PIXEL = 2.0;
+
+   if (binsPerPixel > ENVELOPE_BINS_PER_PIXEL)
    {
-      return;
+      // Envelope: the max and min of each pixel column's bins (normalising
+      // is monotonic, so only those two are normalised)
+      _tracePoints.resize((static_cast<std::size_t>(width) * 2) + 2);
+      const auto binAt = [&](int x)
+      {
+         const double frac = _viewXStart + ((static_cast<double>(x) / width) * viewWidth);
+         return std::clamp(static_cast<int>(frac * static_cast<double>(binCount)), 0, binCount);
+      };
+      for (int x = 0; x < width; ++x)
+      {
+         const int b0 = binAt(x);
+         const int b1 = binAt(x + 1);
+         if (b1 <= b0)
+         {
+            continue;
+         }
+         const auto [mn, mx] = std::minmax_element(values.begin() + b0, values.begin() + b1);
+         const auto px = static_cast<double>(area.left() + x);
+         _tracePoints[out++] = QPointF(px, yPos(*mx));
+         _tracePoints[out++] = QPointF(px, yPos(*mn));
+      }
+   }
+   else
+   {
+      // Full resolution: one point per visible bin
+      _tracePoints.resize(static_cast<std::size_t>(lastBin - firstBin) + 3);
+      for (int i = firstBin; i <= lastBin; ++i)
+      {
+         const double binFrac = (static_cast<double>(i) + 0.5) / static_cast<double>(binCount);
+         const double screenFrac = (binFrac - _viewXStart) / viewWidth;
+         const double px = static_cast<double>(area.left()) +
+                           (screenFrac * static_cast<double>(width));
+         _tracePoints[out++] = QPointF(px, yPos(values[static_cast<std::size_t>(i)]));
+      }
    }
 
-   // Compute screen positions for max-hold bins
-   std::vector<QPointF> pts;
-   pts.reserve(static_cast<std::size_t>(lastBin - firstBin) + 1);
+   const std::size_t count = out - 1;
+   if (count < 2)
+   {
+      return 0;
+   }
+   _tracePoints[0]   = QPointF(_tracePoints[1].x(), bottom);
+   _tracePoints[out] = QPointF(_tracePoints[count].x(), bottom);
+   return count;
+}
 
-   for (int i = firstBin; i <= lastBin; ++i)
+void SpectrumWidget::updateGradients(const QRect& area)
+{
+   if (!_gradientsDirty && _gradientTop == area.top() && _gradientBottom == area.bottom())
    {
-      auto si = static_cast<std::size_t>(i);
-      const float norm = toNormalised(holdSnapshot[si]);
+      return;
+   }
 
-      const double binFrac = (static_cast<double>(i) + 0.5) / static_cast<double>(binCount);
-      const double screenFrac = (binFrac - _viewXStart) / viewWidth;
+   // Fill and trace colors by height, matching the color bar
+   _fillGradient  = QLinearGradient(0, area.top(), 0, area.bottom());
+   _traceGradient = QLinearGradient(0, area.top(), 0, area.bottom());
+   constexpr int GRADIENT_STOPS = 16;
+   for (int s = 0; s <= GRADIENT_STOPS; ++s)
+   {
+      const float frac = static_cast<float>(s) / static_cast<float>(GRADIENT_STOPS);
+      // frac 0 = top of plot = high value, frac 1 = bottom = low value
+      const Color c = _colorMap.map(1.0F - frac);
+      _fillGradient.setColorAt(static_cast<double>(frac), QColor(c.r, c.g, c.b, 70));
+      _traceGradient.setColorAt(static_cast<double>(frac), QColor(c.r, c.g, c.b, 220));
+   }
+   _gradientTop    = area.top();
+   _gradientBottom = area.bottom();
+   _gradientsDirty = false;
+}
 
-      const double xPos = static_cast<double>(area.left()) +
-                          (screenFrac * static_cast<double>(area.width()));
-      const double yPos = static_cast<double>(area.bottom()) -
-                          (static_cast<double>(norm) * static_cast<double>(area.height()));
-      pts.emplace_back(xPos, yPos);
+void SpectrumWidget::drawTracesGl(QPainter& painter, const QRect& area)
+{
+   // Normalise under the lock, straight from the shared buffers
+   const auto normalise = [this](const std::vector<float>& values, std::vector<float>& levels)
+   {
+      levels.resize(values.size());
+      std::ranges::transform(values, levels.begin(),
+                             [this](float value) { return toNormalised(value); });
+   };
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      normalise(_data, _glSpectrum);
+      _glMaxHold.clear();
+      _glMinHold.clear();
+      if (_maxHoldEnabled)
+      {
+         normalise(_maxHoldData, _glMaxHold);
+      }
+      if (_minHoldEnabled)
+      {
+         normalise(_minHoldData, _glMinHold);
+      }
    }
 
-   // Draw white max-hold line
-   painter.setRenderHint(QPainter::Antialiasing, true);
-   painter.setPen(QPen(QColor(255, 255, 255, 200), 1.0));
-   for (std::size_t i = 1; i < pts.size(); ++i)
+   std::array<SpectrumGlRenderer::Trace, 2> holds;
+   std::size_t holdCount = 0;
+   if (!_glMaxHold.empty())
    {
-      painter.drawLine(pts[i - 1], pts[i]);
+      holds[holdCount++] = {_glMaxHold, MAX_HOLD_COLOR};
    }
-   painter.setRenderHint(QPainter::Antialiasing, false);
+   if (!_glMinHold.empty())
+   {
+      holds[holdCount++] = {_glMinHold, MIN_HOLD_COLOR};
+   }
+
+   painter.beginNativePainting();
+   if (_lutDirty)
+   {
+      _glRenderer->setColorMap(_colorMap);
+      _lutDirty = false;
+   }
+   _glRenderer->draw(glSurface()->glViewport(area), _viewXStart, _viewXEnd, _glSpectrum,
+                     std::span(holds.data(), holdCount));
+   painter.endNativePainting();
 }
 
 void SpectrumWidget::drawFps(QPainter& painter, const QRect& area) const
@@ -594,7 +747,7 @@ void SpectrumWidget::wheelEvent(QWheelEvent* event)
 
    syncColorBar();
    emit xViewChanged(_viewXStart, _viewXEnd);
-   update();
+   repaintPlot();
    event->accept();
 }
 
@@ -699,7 +852,7 @@ void SpectrumWidget::mouseMoveEvent(QMouseEvent* event)
 
       syncColorBar();
       emit xViewChanged(_viewXStart, _viewXEnd);
-      update();
+      repaintPlot();
       event->accept();
    }
    else
@@ -5,16 +5,24 @@
 #include "PlotWidgetBase.h"
 #include "ColorMap.h"
 
+// Third-party headers
+#include <QLinearGradient>
+#include <QPointF>
+
 // System headers
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <vector>
 
 namespace RealTimeGraphs
 {
 
-class ColorBarStrip; // forward declaration
+class ColorBarStrip;       // forward declaration
+class SpectrumGlRenderer;  // forward declaration
 
 /**
  * @class SpectrumWidget
@@ -26,6 +34,9 @@ class ColorBarStrip; // forward declaration
  *
  * Call `setData()` from any thread; the widget double-buffers the data
  * and schedules a repaint.
+ *
+ * With the OpenGl render backend the traces are drawn from a vertex
+ * buffer by SpectrumGlRenderer; grid, labels and cursors stay QPainter.
  */
 class SpectrumWidget : public PlotWidgetBase
 {
@@ -33,13 +44,28 @@ class SpectrumWidget : public PlotWidgetBase
 
 public:
    explicit SpectrumWidget(QWidget* parent = nullptr);
+   ~SpectrumWidget() override;
+
+   SpectrumWidget(const SpectrumWidget&) = delete;
+   SpectrumWidget& operator=(const SpectrumWidget&) = delete;
 
    /**
-    * @brief Replace the current spectrum data.  The vector is copied.
+    * @brief Replace the current spectrum data.  The values are copied.
     * Thread-safe — can be called from a producer thread.
     * @param magnitudes  Linear magnitudes (0 … 1 normalised).
     */
-   void setData(const std::vector<float>& magnitudes);
+   void setData(std::span<const float> magnitudes);
+
+   /**
+    * @brief Replace the spectrum together with producer-computed hold traces.
+    * Non-empty traces are drawn as given and the widget skips its own
+    * max-hold update.  Thread-safe.
+    * @param magnitudes  Spectrum values (same units as setData()).
+    * @param maxHold     Max-hold trace, or empty to use the widget's own.
+    * @param minHold     Min-hold trace, or empty for none.
+    */
+   void setData(std::span<const float> magnitudes, std::span<const float> maxHold,
+                std::span<const float> minHold);
 
    /** @brief Set the dB display range (e.g., -120 to 0). */
    void setDbRange(float minDb, float maxDb);
@@ -75,6 +101,9 @@ public:
    /** @brief Set the decay rate for max hold (dB per second).  Default is 10 dB/s. */
    void setMaxHoldDecayRate(float dbPerSecond);
 
+   /** @brief Show or hide the min-hold trace passed to setData(). */
+   void setMinHoldEnabled(bool enabled);
+
    /** @brief Pause or resume live data updates. */
    void setPaused(bool paused);
 
@@ -86,7 +115,9 @@ signals:
    void dbRangeChanged(float minDb, float maxDb);
 
 protected:
-   void paintEvent(QPaintEvent* event) override;
+   void paintFrame(QPainter& painter) override;
+   bool initializeGpu() override;
+   void releaseGpu() override;
    void resizeEvent(QResizeEvent* event) override;
    void wheelEvent(QWheelEvent* event) override;
    void mousePressEvent(QMouseEvent* event) override;
@@ -101,11 +132,26 @@ protected:
 private:
    void drawBackground(QPainter& painter, const QRect& area) const;
    void drawGrid(QPainter& painter, const QRect& area) const;
-   void drawSpectrum(QPainter& painter, const QRect& area) const;
-   void drawMaxHold(QPainter& painter, const QRect& area) const;
+   void drawSpectrum(QPainter& painter, const QRect& area);
+   void drawMaxHold(QPainter& painter, const QRect& area);
+   void drawMinHold(QPainter& painter, const QRect& area);
+   void drawHoldTrace(QPainter& painter, const QRect& area, const std::vector<float>& holdSnapshot,
+                      const QColor& color);
    void drawLabels(QPainter& painter, const QRect& area) const;
    void drawFps(QPainter& painter, const QRect& area) const;
 
+   // Draw the spectrum and hold traces with the GL renderer.
+   void drawTracesGl(QPainter& painter, const QRect& area);
+
+   // Build the polyline of a trace in _tracePoints[1 .. count], with baseline
+   // points at [0] and [count + 1] closing the fill polygon.  One point per
+   // visible bin, or a max/min pair per pixel column when bins outnumber
+   // pixels.  Returns count, or 0 if fewer than two points are visible.
+   std::size_t buildTrace(const std::vector<float>& values, const QRect& area);
+
+   // Rebuild the fill and trace gradients for a new plot area or palette.
+   void updateGradients(const QRect& area);
+
    // Convert a linear magnitude to normalised [0, 1] within the current view range.
    [[nodiscard]] float toNormalised(float value) const;
 
@@ -116,6 +162,7 @@ private:
    bool _paused{false};
    std::vector<float> _data;
    std::vector<float> _maxHoldData;  ///< Per-bin max-hold values (in same units as _data)
+   std::vector<float> _minHoldData;  ///< Producer-supplied min-hold values
 
    ColorMap _colorMap{ColorMap::Palette::Viridis};
    float _minDb{-120.0F};
@@ -125,6 +172,7 @@ private:
    int _numVerticalGridLines{6};
    bool _maxHoldEnabled{false};
    float _maxHoldDecayRate{10.0F};  ///< dB per second
+   bool _minHoldEnabled{false};
 
    // Current Y-axis view range (may differ from data range when zoomed/panned)
    double _viewMinDb{-120.0};
@@ -142,9 +190,26 @@ private:
    double _panStartXStart{0.0};
    double _panStartXEnd{0.0};
 
+   // Raster paint scratch, reused across frames (GUI thread)
+   std::vector<float> _traceValues;     ///< Snapshot of the trace being drawn
+   std::vector<QPointF> _tracePoints;   ///< Baseline, polyline, baseline
+   QLinearGradient _fillGradient;
+   QLinearGradient _traceGradient;
+   int _gradientTop{0};
+   int _gradientBottom{-1};
+   bool _gradientsDirty{true};
+
    // Embedded color bar
    ColorBarStrip* _colorBar{nullptr};
 
+   // GPU renderer, OpenGl backend only (GUI thread), and its per-frame
+   // normalised traces
+   std::unique_ptr<SpectrumGlRenderer> _glRenderer;
+   bool _lutDirty{true};
+   std::vector<float> _glSpectrum;
+   std::vector<float> _glMaxHold;
+   std::vector<float> _glMinHold;
+
    // Spectrum-specific layout constants
    static constexpr int MARGIN_BOTTOM_HIDDEN = 2;
 
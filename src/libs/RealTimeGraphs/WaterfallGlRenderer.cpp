@@ -0,0 +1,159 @@
+#include "WaterfallGlRenderer.h"
+
+#include "GlPlotSurface.h"
+
+#include <QOpenGLContext>
+
+namespace RealTimeGraphs
+{
+
+namespace
+{
+
+// Full-viewport quad from the vertex index; uv (0, 0) is the top left
+constexpr const char* VERTEX_SHADER = R"(#version 330 core
+out vec2 uv;
+void main()
+{
+   vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));
+   uv = vec2(corner.x, 1.0 - corner.y);
+   gl_Position = vec4((corner * 2.0) - 1.0, 0.0, 1.0);
+}
+)";
+
+// Row `age` below the top is `age` slots before the newest, modulo the ring
+constexpr const char* FRAGMENT_SHADER = R"(#version 330 core
+uniform sampler2D levels;
+uniform sampler2D lut;
+uniform int newestSlot;
+uniform int rowCount;
+uniform int capacity;
+uniform vec2 xRange;
+in vec2 uv;
+out vec4 fragColor;
+void main()
+{
+   int bins = textureSize(levels, 0).x;
+   int age  = min(int(uv.y * float(rowCount)), rowCount - 1);
+   int slot = (newestSlot - age + capacity) % capacity;
+   int bin  = clamp(int(mix(xRange.x, xRange.y, uv.x) * float(bins)), 0, bins - 1);
+   float level = texelFetch(levels, ivec2(bin, slot), 0).r;
+   fragColor = texelFetch(lut, ivec2(int((level * 255.0) + 0.5), 0), 0);
+}
+)";
+
+constexpr GLint LEVEL_UNIT = 0;
+constexpr GLint LUT_UNIT   = 1;
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+WaterfallGlRenderer::WaterfallGlRenderer()
+   : _context{QOpenGLContext::currentContext()}
+   , _gl{_context->extraFunctions()}
+{
+   _program = GlPlotSurface::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+   if (_program == nullptr || !_vao.create())
+   {
+      _program.reset();
+      return;
+   }
+
+   _gl->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &_maxTextureSize);
+   _lutTexture = GlPlotSurface::createLutTexture(*_gl);
+
+   _gl->glGenTextures(1, &_levelTexture);
+   _gl->glBindTexture(GL_TEXTURE_2D, _levelTexture);
+   _gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+   _gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+   _gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+   _gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+WaterfallGlRenderer::~WaterfallGlRenderer()
+{
+   // Otherwise the textures go with their context when it is destroyed
+   if (QOpenGLContext::currentContext() == _context)
+   {
+      _gl->glDeleteTextures(1, &_levelTexture);
+      _gl->glDeleteTextures(1, &_lutTexture);
+   }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void WaterfallGlRenderer::setColorMap(const ColorMap& colorMap)
+{
+   GlPlotSurface::uploadLut(*_gl, _lutTexture, colorMap);
+}
+
+bool WaterfallGlRenderer::allocate(std::size_t binCount, std::size_t capacity,
+                                   std::span<const uint8_t> levels)
+{
+   const auto maxSize = static_cast<std::size_t>(_maxTextureSize);
+   if (binCount > maxSize || capacity > maxSize)
+   {
+      return false;
+   }
+
+   _binCount = binCount;
+   _capacity = capacity;
+   _gl->glBindTexture(GL_TEXTURE_2D, _levelTexture);
+   _gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   _gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_R8,
+                     static_cast<GLsizei>(binCount), static_cast<GLsizei>(capacity),
+                     0, GL_RED, GL_UNSIGNED_BYTE, levels.data());
+   return true;
+}
+
+void WaterfallGlRenderer::uploadRow(std::size_t slot, std::span<const uint8_t> levels)
+{
+   _gl->glBindTexture(GL_TEXTURE_2D, _levelTexture);
+   _gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   _gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(slot),
+                        static_cast<GLsizei>(levels.size()), 1,
+                        GL_RED, GL_UNSIGNED_BYTE, levels.data());
+}
+
+void WaterfallGlRenderer::draw(const QRect& viewport, std::size_t newestSlot,
+                               std::size_t rowCount, double xStart, double xEnd)
+{
+   if (_binCount == 0 || _capacity == 0 || rowCount == 0)
+   {
+      return;
+   }
+
+   _gl->glViewport(viewport.x(), viewport.y(), viewport.width(), viewport.height());
+   _gl->glEnable(GL_SCISSOR_TEST);
+   _gl->glScissor(viewport.x(), viewport.y(), viewport.width(), viewport.height());
+   _gl->glDisable(GL_BLEND);
+   _gl->glDisable(GL_DEPTH_TEST);
+
+   _gl->glActiveTexture(GL_TEXTURE0 + LEVEL_UNIT);
+   _gl->glBindTexture(GL_TEXTURE_2D, _levelTexture);
+   _gl->glActiveTexture(GL_TEXTURE0 + LUT_UNIT);
+   _gl->glBindTexture(GL_TEXTURE_2D, _lutTexture);
+
+   _program->bind();
+   _program->setUniformValue("levels", LEVEL_UNIT);
+   _program->setUniformValue("lut", LUT_UNIT);
+   _program->setUniformValue("newestSlot", static_cast<GLint>(newestSlot));
+   _program->setUniformValue("rowCount", static_cast<GLint>(rowCount));
+   _program->setUniformValue("capacity", static_cast<GLint>(_capacity));
+   _program->setUniformValue("xRange", static_cast<GLfloat>(xStart),
+                             static_cast<GLfloat>(xEnd));
+
+   _vao.bind();
+   _gl->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+   _vao.release();
+   _program->release();
+
+   _gl->glActiveTexture(GL_TEXTURE0);
+}
+
+} // namespace RealTimeGraphs
@@ -0,0 +1,94 @@
+#ifndef WATERFALLGLRENDERER_H_
+#define WATERFALLGLRENDERER_H_
+
+// Project headers
+#include "ColorMap.h"
+
+// Third-party headers
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QRect>
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class WaterfallGlRenderer
+ * @brief Draws a WaterfallHistory ring with OpenGL.
+ *
+ * The ring of 8-bit levels is mirrored in a single-channel texture of the
+ * same `bins x capacity` layout, so a new row is one glTexSubImage2D of
+ * `bins` bytes into its slot and the ring is never shifted.  A fragment
+ * shader finds each pixel's slot from the newest slot and row count and
+ * colors the level from the ColorMap LUT in a second texture: a palette
+ * change re-uploads 1 KiB, not the history.
+ *
+ * Every call needs the GL context current (GlPlotSurface's handlers and
+ * paint pass provide it).
+ */
+class WaterfallGlRenderer
+{
+public:
+   /** @brief Create the GL resources; check isValid() afterwards. */
+   WaterfallGlRenderer();
+   ~WaterfallGlRenderer();
+
+   WaterfallGlRenderer(const WaterfallGlRenderer&) = delete;
+   WaterfallGlRenderer& operator=(const WaterfallGlRenderer&) = delete;
+
+   /** @brief True if the shaders compiled and the textures exist. */
+   [[nodiscard]] bool isValid() const { return _program != nullptr; }
+
+   /** @brief Upload a palette's LUT. */
+   void setColorMap(const ColorMap& colorMap);
+
+   /**
+    * @brief Reallocate the level texture for a ring layout and upload it.
+    * @param binCount  Levels per row.
+    * @param capacity  Rows in the ring.
+    * @param levels    The whole ring, `capacity x binCount` levels.
+    * @return False if the layout exceeds the maximum texture size.
+    */
+   [[nodiscard]] bool allocate(std::size_t binCount, std::size_t capacity,
+                               std::span<const uint8_t> levels);
+
+   /** @brief Upload one row of levels into its ring slot. */
+   void uploadRow(std::size_t slot, std::span<const uint8_t> levels);
+
+   [[nodiscard]] std::size_t binCount() const { return _binCount; }
+   [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+   /**
+    * @brief Draw the rows, newest at the top, into a viewport.
+    * @param viewport    GL viewport of the plot area.
+    * @param newestSlot  Ring slot of the newest row.
+    * @param rowCount    Rows to show, spread over the viewport height.
+    * @param xStart      Visible start as a fraction of the bins.
+    * @param xEnd        Visible end as a fraction of the bins.
+    */
+   void draw(const QRect& viewport, std::size_t newestSlot, std::size_t rowCount,
+             double xStart, double xEnd);
+
+private:
+   QOpenGLContext* _context;      ///< Context the resources belong to
+   QOpenGLExtraFunctions* _gl;
+   std::unique_ptr<QOpenGLShaderProgram> _program;
+   QOpenGLVertexArrayObject _vao;
+   GLuint _levelTexture{0};
+   GLuint _lutTexture{0};
+   GLint _maxTextureSize{0};
+   std::size_t _binCount{0};
+   std::size_t _capacity{0};
+};
+
+} // namespace RealTimeGraphs
+
+#endif // WATERFALLGLRENDERER_H_
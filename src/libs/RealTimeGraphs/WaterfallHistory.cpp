@@ -0,0 +1,195 @@
+#include "WaterfallHistory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace RealTimeGraphs
+{
+
+namespace
+{
+
+// Weight of the newest row interval in the smoothed row rate
+constexpr double RATE_SMOOTHING = 0.1;
+
+// Headroom over the measured rate, so jitter does not force a reallocation
+constexpr double CAPACITY_HEADROOM = 1.25;
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+WaterfallHistory::WaterfallHistory(double maxAgeSec)
+   : _maxAgeSec{maxAgeSec}
+{
+}
+
+uint8_t WaterfallHistory::quantize(float normalised)
+{
+   const float clamped = std::clamp(normalised, 0.0F, 1.0F);
+   return static_cast<uint8_t>(std::min(clamped * 255.0F, 255.0F));
+}
+
+// ============================================================================
+// Rows
+// ============================================================================
+
+std::span<uint8_t> WaterfallHistory::append(std::size_t binCount, Clock::time_point time)
+{
+   if (binCount != _binCount)
+   {
+      _binCount = binCount;
+      clear();
+      _levels.assign(_capacity * _binCount, 0);
+      updateMemory();
+   }
+
+   if (_size > 0)
+   {
+      const double interval =
+         std::chrono::duration<double>(time - _times[slot(_size - 1)]).count();
+      if (interval > 0.0)
+      {
+         _rowRate = (_rowRate > 0.0)
+                       ? ((1.0 - RATE_SMOOTHING) * _rowRate) + (RATE_SMOOTHING / interval)
+                       : 1.0 / interval;
+      }
+   }
+
+   prune(time);
+   const std::size_t affordable = rowsForBudget();
+   if (_size == _capacity || _capacity > affordable)
+   {
+      const std::size_t wanted =
+         std::min(std::max({2 * _capacity, rowsForMaxAge(), MIN_CAPACITY_ROWS}), affordable);
+      if (_size >= wanted)
+      {
+         _memory.recordRelief();
+      }
+      while (_size >= wanted)
+      {
+         dropOldest();
+      }
+      if (wanted != _capacity)
+      {
+         reallocate(wanted);
+      }
+   }
+
+   const std::size_t newest = slot(_size);
+   _times[newest] = time;
+   ++_size;
+   return {_levels.data() + (newest * _binCount), _binCount};
+}
+
+void WaterfallHistory::setMaxAge(double seconds, Clock::time_point now)
+{
+   _maxAgeSec = seconds;
+   prune(now);
+
+   const std::size_t needed = std::max({rowsForMaxAge(), _size, MIN_CAPACITY_ROWS});
+   if (_capacity > 2 * needed)
+   {
+      reallocate(needed);
+   }
+}
+
+void WaterfallHistory::clear()
+{
+   _oldest = 0;
+   _size   = 0;
+}
+
+std::span<const uint8_t> WaterfallHistory::row(std::size_t index) const
+{
+   return {_levels.data() + (slot(index) * _binCount), _binCount};
+}
+
+WaterfallHistory::Clock::time_point WaterfallHistory::timestamp(std::size_t index) const
+{
+   return _times[slot(index)];
+}
+
+std::optional<std::pair<uint8_t, uint8_t>> WaterfallHistory::levelRange() const
+{
+   if (_size == 0 || _binCount == 0)
+   {
+      return std::nullopt;
+   }
+
+   uint8_t lowest  = MAX_LEVEL;
+   uint8_t highest = 0;
+   for (std::size_t i = 0; i < _size; ++i)
+   {
+      const auto [rowMin, rowMax] = std::ranges::minmax(row(i));
+      lowest  = std::min(lowest, rowMin);
+      highest = std::max(highest, rowMax);
+   }
+   return std::make_pair(lowest, highest);
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+void WaterfallHistory::prune(Clock::time_point now)
+{
+   const auto maxAge = std::chrono::duration<double>(_maxAgeSec);
+   while (_size > 0 && std::chrono::duration<double>(now - _times[_oldest]) > maxAge)
+   {
+      dropOldest();
+   }
+}
+
+void WaterfallHistory::dropOldest()
+{
+   if (_evicted)
+   {
+      _evicted(row(0), _times[_oldest]);
+   }
+   _oldest = (_oldest + 1) % _capacity;
+   --_size;
+}
+
+void WaterfallHistory::reallocate(std::size_t capacity)
+{
+   std::vector<uint8_t> levels(capacity * _binCount);
+   std::vector<Clock::time_point> times(capacity);
+   for (std::size_t i = 0; i < _size; ++i)
+   {
+      const auto source = row(i);
+      std::ranges::copy(source, levels.begin() + static_cast<std::ptrdiff_t>(i * _binCount));
+      times[i] = timestamp(i);
+   }
+
+   _levels   = std::move(levels);
+   _times    = std::move(times);
+   _capacity = capacity;
+   _oldest   = 0;
+   updateMemory();
+}
+
+std::size_t WaterfallHistory::rowsForMaxAge() const
+{
+   return static_cast<std::size_t>(std::ceil(_rowRate * _maxAgeSec * CAPACITY_HEADROOM)) + 1;
+}
+
+std::size_t WaterfallHistory::rowsForBudget() const
+{
+   const std::size_t budget = _memory.budget();
+   if (budget == 0)
+   {
+      return std::numeric_limits<std::size_t>::max();
+   }
+   return std::max<std::size_t>(budget / (_binCount + sizeof(Clock::time_point)), 1);
+}
+
+void WaterfallHistory::updateMemory()
+{
+   _memory.setBytes(_levels.size() + (_times.size() * sizeof(Clock::time_point)));
+}
+
+} // namespace RealTimeGraphs
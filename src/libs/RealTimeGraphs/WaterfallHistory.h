@@ -0,0 +1,159 @@
+#ifndef WATERFALLHISTORY_H_
+#define WATERFALLHISTORY_H_
+
+// Project headers
+#include "MemoryBudget.h"
+
+// System headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class WaterfallHistory
+ * @brief Age-limited waterfall rows in one contiguous ring of 8-bit levels.
+ *
+ * Each row is a normalised spectrum quantized to 256 levels, the resolution
+ * of the ColorMap LUT, so a level indexes the LUT directly and colorizing
+ * loses nothing.  Rows live back to back in a single `capacity x bins`
+ * byte array with a parallel timestamp ring: a quarter of the memory of
+ * float rows and no allocation per row, and the array can be uploaded as
+ * is (e.g. as a single-channel texture, rows `[oldestSlot(), +size())`
+ * modulo capacity).
+ *
+ * The capacity follows the history actually needed: rows older than the
+ * maximum age are dropped as new ones arrive, and when the ring is full of
+ * rows still within the age it is reallocated for the row rate measured so
+ * far times the maximum age (at least doubling).  Lowering the maximum age
+ * gives the surplus back.  Rows dropped for their age can be handed to
+ * an eviction handler first (e.g. a WaterfallTileCache for scrollback).
+ *
+ * The ring is accounted as MEMORY_ACCOUNT in the MemoryRegistry.  Under a
+ * budget it never grows past the rows the budget affords; once full, the
+ * oldest row is dropped (through the eviction handler, like an aged one)
+ * for each new row, so the history gets shorter instead of larger.
+ *
+ * Thread-safety: none; WaterfallWidget guards it with its mutex.
+ */
+class WaterfallHistory
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   /** @brief Receives a row about to be dropped for its age, oldest first. */
+   using EvictionHandler =
+      std::function<void(std::span<const uint8_t> levels, Clock::time_point time)>;
+
+   /** @brief Fewest rows allocated once the first row arrives. */
+   static constexpr std::size_t MIN_CAPACITY_ROWS = 64;
+
+   /** @brief MemoryRegistry name of the ring's account. */
+   static constexpr const char* MEMORY_ACCOUNT = "waterfall.history";
+
+   /** @brief Highest quantized level (normalised 1.0). */
+   static constexpr uint8_t MAX_LEVEL = 255;
+
+   /** @param maxAgeSec  Maximum age (in seconds) of rows to keep. */
+   explicit WaterfallHistory(double maxAgeSec);
+
+   /**
+    * @brief Quantize a normalised value as ColorMap::map() indexes its LUT.
+    * @param normalised  Value in [0, 1]; clamped.
+    */
+   [[nodiscard]] static uint8_t quantize(float normalised);
+
+   /**
+    * @brief Add a row and return it for the caller to fill with levels.
+    *
+    * Drops rows older than the maximum age first, and the oldest rows if
+    * the memory budget allows no more.  A bin count other than the current
+    * rows' clears the history.
+    *
+    * @param binCount  Bins in the row.
+    * @param time      Arrival time of the row.
+    * @return The row's levels, valid until the next call that changes rows.
+    */
+   [[nodiscard]] std::span<uint8_t> append(std::size_t binCount, Clock::time_point time);
+
+   /** @brief Set the maximum age and drop rows older than it at `now`. */
+   void setMaxAge(double seconds, Clock::time_point now);
+
+   /** @brief Hand rows dropped for their age to `handler` (none to stop). */
+   void setEvictionHandler(EvictionHandler handler) { _evicted = std::move(handler); }
+
+   /** @brief Maximum age (in seconds) of rows kept. */
+   [[nodiscard]] double maxAge() const { return _maxAgeSec; }
+
+   /** @brief Drop every row (the storage is kept). */
+   void clear();
+
+   [[nodiscard]] std::size_t size() const { return _size; }
+   [[nodiscard]] bool empty() const { return _size == 0; }
+   [[nodiscard]] std::size_t binCount() const { return _binCount; }
+   [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+   /** @brief Levels of a row, 0 = oldest. */
+   [[nodiscard]] std::span<const uint8_t> row(std::size_t index) const;
+
+   /** @brief Arrival time of a row, 0 = oldest. */
+   [[nodiscard]] Clock::time_point timestamp(std::size_t index) const;
+
+   /** @brief Lowest and highest level over all rows, if any. */
+   [[nodiscard]] std::optional<std::pair<uint8_t, uint8_t>> levelRange() const;
+
+   /** @brief Rows per second measured from arrival times (0 until known). */
+   [[nodiscard]] double rowRate() const { return _rowRate; }
+
+   /** @brief The whole ring, `capacity() x binCount()` levels. */
+   [[nodiscard]] std::span<const uint8_t> storage() const { return _levels; }
+
+   /** @brief Ring slot of the oldest row. */
+   [[nodiscard]] std::size_t oldestSlot() const { return _oldest; }
+
+private:
+   // Drop rows older than the maximum age at `now`.
+   void prune(Clock::time_point now);
+
+   // Hand the oldest row to the eviction handler and drop it.
+   void dropOldest();
+
+   // Move the rows, oldest first, into a ring of `capacity` rows.
+   void reallocate(std::size_t capacity);
+
+   // Rows the measured rate needs over the maximum age.
+   [[nodiscard]] std::size_t rowsForMaxAge() const;
+
+   // Rows the memory budget affords (SIZE_MAX without a budget).
+   [[nodiscard]] std::size_t rowsForBudget() const;
+
+   // Report the ring's size to the memory account.
+   void updateMemory();
+
+   [[nodiscard]] std::size_t slot(std::size_t index) const
+   {
+      return (_oldest + index) % _capacity;
+   }
+
+   double _maxAgeSec;
+   std::size_t _binCount{0};
+   std::size_t _capacity{0};
+   std::size_t _oldest{0};
+   std::size_t _size{0};
+   std::vector<uint8_t> _levels;              ///< capacity x binCount
+   std::vector<Clock::time_point> _times;     ///< capacity
+   double _rowRate{0.0};                      ///< Smoothed rows per second
+   EvictionHandler _evicted;
+   CommonUtils::MemoryAccount _memory{MEMORY_ACCOUNT, CommonUtils::MemoryRelief::DropHistory};
+};
+
+} // namespace RealTimeGraphs
+
+#endif // WATERFALLHISTORY_H_
@@ -0,0 +1,274 @@
+#include "WaterfallTileCache.h"
+
+#include <GeneralLogger.h>
+#include <Profiler.h>
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace RealTimeGraphs
+{
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+std::unique_ptr<WaterfallTileCache> WaterfallTileCache::create(const std::string& path,
+                                                               std::size_t maxBytes)
+{
+   const std::size_t capacity = std::max(maxBytes, MIN_BYTES);
+
+   const int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0600);
+   if (fd < 0)
+   {
+      GPERROR("Failed to create waterfall cache {}: {}", path, errno);
+      return nullptr;
+   }
+   // Only the mapping needs the file from here on
+   ::unlink(path.c_str());
+
+   // Sparse: disk is used as tiles are written
+   if (ftruncate(fd, static_cast<off_t>(capacity)) < 0)
+   {
+      GPERROR("Failed to size waterfall cache {} to {} bytes: {}", path, capacity, errno);
+      ::close(fd);
+      return nullptr;
+   }
+   void* mapped = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (mapped == MAP_FAILED)
+   {
+      GPERROR("Failed to map waterfall cache {}: {}", path, errno);
+      return nullptr;
+   }
+
+   return std::unique_ptr<WaterfallTileCache>(
+      new WaterfallTileCache(static_cast<uint8_t*>(mapped), capacity));
+}
+
+WaterfallTileCache::WaterfallTileCache(uint8_t* mapped, std::size_t capacity)
+   : _mapped{mapped}
+   , _capacity{capacity}
+{
+}
+
+WaterfallTileCache::~WaterfallTileCache()
+{
+   munmap(_mapped, _capacity);
+}
+
+// ============================================================================
+// Rows
+// ============================================================================
+
+void WaterfallTileCache::append(std::span<const uint8_t> levels, Clock::time_point time)
+{
+   if (levels.size() != _binCount)
+   {
+      clear();
+      _binCount = levels.size();
+   }
+   if (_binCount == 0)
+   {
+      return;
+   }
+
+   _openTimes.push_back(time.time_since_epoch().count());
+   _openLevels.insert(_openLevels.end(), levels.begin(), levels.end());
+   if (_openTimes.size() >= tileRows())
+   {
+      seal();
+   }
+}
+
+void WaterfallTileCache::clear()
+{
+   _tiles.clear();
+   _decoded.clear();
+   _openTimes.clear();
+   _openLevels.clear();
+   _writeOffset = 0;
+}
+
+std::optional<WaterfallTileCache::Row> WaterfallTileCache::rowAt(Clock::time_point time)
+{
+   const Clock::rep key = time.time_since_epoch().count();
+   const auto rowOf = [this, key](const std::vector<Clock::rep>& times,
+                                  const std::vector<uint8_t>& levels)
+   {
+      // Last row at or before `time`; the caller checked there is one
+      const auto index = static_cast<std::size_t>(
+         std::distance(times.begin(), std::ranges::upper_bound(times, key)) - 1);
+      return Row{{levels.data() + (index * _binCount), _binCount},
+                 Clock::time_point(Clock::duration(times[index]))};
+   };
+
+   // The tile being filled holds the newest rows
+   if (!_openTimes.empty() && key >= _openTimes.front())
+   {
+      return rowOf(_openTimes, _openLevels);
+   }
+
+   // Otherwise the last sealed tile starting at or before `time`
+   const auto tile = std::ranges::upper_bound(_tiles, time, {}, &Tile::first);
+   if (tile == _tiles.begin())
+   {
+      return std::nullopt;
+   }
+   const Decoded* decoded = decode(*std::prev(tile));
+   if (decoded == nullptr)
+   {
+      return std::nullopt;
+   }
+   return rowOf(decoded->times, decoded->levels);
+}
+
+std::optional<WaterfallTileCache::Clock::time_point> WaterfallTileCache::oldestTime() const
+{
+   if (!_tiles.empty())
+   {
+      return _tiles.front().first;
+   }
+   if (!_openTimes.empty())
+   {
+      return Clock::time_point(Clock::duration(_openTimes.front()));
+   }
+   return std::nullopt;
+}
+
+std::size_t WaterfallTileCache::size() const
+{
+   std::size_t rows = _openTimes.size();
+   for (const Tile& tile : _tiles)
+   {
+      rows += tile.rows;
+   }
+   return rows;
+}
+
+std::size_t WaterfallTileCache::storedBytes() const
+{
+   std::size_t bytes = 0;
+   for (const Tile& tile : _tiles)
+   {
+      bytes += tile.bytes;
+   }
+   return bytes;
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+void WaterfallTileCache::seal()
+{
+   GPPROFILE_SCOPE("WaterfallTileCache::seal");
+
+   const std::size_t rows      = _openTimes.size();
+   const std::size_t timeBytes = rows * sizeof(Clock::rep);
+
+   // Times, then each row as its difference from the previous one
+   _scratch.resize(timeBytes + _openLevels.size());
+   std::memcpy(_scratch.data(), _openTimes.data(), timeBytes);
+   uint8_t* delta = _scratch.data() + timeBytes;
+   std::copy_n(_openLevels.data(), _binCount, delta);
+   for (std::size_t i = _binCount; i < _openLevels.size(); ++i)
+   {
+      delta[i] = static_cast<uint8_t>(_openLevels[i] - _openLevels[i - _binCount]);
+   }
+
+   const int bound = LZ4_compressBound(static_cast<int>(_scratch.size()));
+   _compressed.resize(static_cast<std::size_t>(bound));
+   const int written = LZ4_compress_default(reinterpret_cast<const char*>(_scratch.data()),
+                                            _compressed.data(), static_cast<int>(_scratch.size()),
+                                            bound);
+   const Tile tile{_nextId++, 0, static_cast<std::size_t>(written), rows,
+                   Clock::time_point(Clock::duration(_openTimes.front()))};
+   _openTimes.clear();
+   _openLevels.clear();
+   if (written <= 0 || tile.bytes > _capacity)
+   {
+      return;
+   }
+
+   // The tiles of the previous lap follow the write offset, oldest first.
+   // At the end of the file the rest of that lap is given up.
+   if (_writeOffset + tile.bytes > _capacity)
+   {
+      while (!_tiles.empty() && _tiles.front().offset >= _writeOffset)
+      {
+         _tiles.pop_front();
+      }
+      _writeOffset = 0;
+   }
+   while (!_tiles.empty() && _tiles.front().offset >= _writeOffset &&
+          _tiles.front().offset < _writeOffset + tile.bytes)
+   {
+      _tiles.pop_front();
+   }
+
+   std::memcpy(_mapped + _writeOffset, _compressed.data(), tile.bytes);
+   _tiles.push_back(tile);
+   _tiles.back().offset = _writeOffset;
+   _writeOffset += tile.bytes;
+}
+
+const WaterfallTileCache::Decoded* WaterfallTileCache::decode(const Tile& tile)
+{
+   const auto cached = std::ranges::find(_decoded, tile.id, &Decoded::id);
+   if (cached != _decoded.end())
+   {
+      _decoded.splice(_decoded.begin(), _decoded, cached);
+      return &_decoded.front();
+   }
+
+   // Reuse the buffers of the least recently used tile
+   if (_decoded.size() >= CACHED_TILES)
+   {
+      _decoded.splice(_decoded.begin(), _decoded, std::prev(_decoded.end()));
+   }
+   else
+   {
+      _decoded.emplace_front();
+   }
+   Decoded& decoded = _decoded.front();
+
+   GPPROFILE_SCOPE("WaterfallTileCache::decode");
+   const std::size_t timeBytes = tile.rows * sizeof(Clock::rep);
+   _scratch.resize(timeBytes + (tile.rows * _binCount));
+   const int read = LZ4_decompress_safe(reinterpret_cast<const char*>(_mapped + tile.offset),
+                                        reinterpret_cast<char*>(_scratch.data()),
+                                        static_cast<int>(tile.bytes),
+                                        static_cast<int>(_scratch.size()));
+   if (read != static_cast<int>(_scratch.size()))
+   {
+      _decoded.pop_front();
+      return nullptr;
+   }
+
+   decoded.id = tile.id;
+   decoded.times.resize(tile.rows);
+   std::memcpy(decoded.times.data(), _scratch.data(), timeBytes);
+   decoded.levels.resize(tile.rows * _binCount);
+   const uint8_t* delta = _scratch.data() + timeBytes;
+   std::copy_n(delta, _binCount, decoded.levels.data());
+   for (std::size_t i = _binCount; i < decoded.levels.size(); ++i)
+   {
+      decoded.levels[i] = static_cast<uint8_t>(delta[i] + decoded.levels[i - _binCount]);
+   }
+   return &decoded;
+}
+
+std::size_t WaterfallTileCache::tileRows() const
+{
+   return std::max<std::size_t>(1, TILE_BYTES / _binCount);
+}
+
+} // namespace RealTimeGraphs
@@ -0,0 +1,152 @@
+#ifndef WATERFALLTILECACHE_H_
+#define WATERFALLTILECACHE_H_
+
+// System headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace RealTimeGraphs
+{
+
+/**
+ * @class WaterfallTileCache
+ * @brief Waterfall rows older than the in-memory history, compressed in
+ *        time-indexed tiles in a memory-mapped cache file.
+ *
+ * Rows (8-bit levels, as in WaterfallHistory) are gathered into a tile of
+ * about TILE_BYTES; a full tile is delta-coded against the previous row,
+ * so a slowly changing spectrum becomes runs of zeros, LZ4-compressed and
+ * copied into the mapping.  The file is a ring of `maxBytes`: when it is
+ * full, the oldest tiles are overwritten, so disk use is bounded and the
+ * scrollback covers as much time as the spectrum compresses into.  Only
+ * the tile index (a few words per tile) stays in memory.
+ *
+ * rowAt() finds a tile by time and decodes it into an LRU of CACHED_TILES
+ * tiles, so panning through a stretch decodes each tile once.  The file is
+ * unlinked as soon as it is open: it never outlives the process.
+ *
+ * Thread-safety: none; WaterfallWidget guards it with its mutex.
+ */
+class WaterfallTileCache
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   /** @brief Target raw (uncompressed) size of a tile. */
+   static constexpr std::size_t TILE_BYTES = std::size_t{256} << 10;
+
+   /** @brief Decoded tiles kept for rowAt(). */
+   static constexpr std::size_t CACHED_TILES = 16;
+
+   /** @brief Smallest cache file; larger requests are honoured as given. */
+   static constexpr std::size_t MIN_BYTES = std::size_t{4} << 20;
+
+   /** @brief A row found by rowAt(). */
+   struct Row
+   {
+      std::span<const uint8_t> levels;   ///< Valid until the next non-const call
+      Clock::time_point time;            ///< Arrival time of the row
+   };
+
+   /**
+    * @brief Create the cache file and map it.
+    * @param path      File to create (replaced if it exists, unlinked once open).
+    * @param maxBytes  Size of the file ring; at least MIN_BYTES.
+    * @return The cache, or nullptr on failure (logged)
+    */
+   static std::unique_ptr<WaterfallTileCache> create(const std::string& path,
+                                                     std::size_t maxBytes);
+
+   ~WaterfallTileCache();
+
+   WaterfallTileCache(const WaterfallTileCache&) = delete;
+   WaterfallTileCache& operator=(const WaterfallTileCache&) = delete;
+
+   /**
+    * @brief Add a row, newer than every row before it.
+    * A bin count other than the current rows' clears the cache.
+    */
+   void append(std::span<const uint8_t> levels, Clock::time_point time);
+
+   /** @brief Drop every row. */
+   void clear();
+
+   /**
+    * @brief The latest row at or before `time`.
+    * @return The row, or std::nullopt if every row is newer (or there are none)
+    */
+   [[nodiscard]] std::optional<Row> rowAt(Clock::time_point time);
+
+   /** @brief Arrival time of the oldest row, if any. */
+   [[nodiscard]] std::optional<Clock::time_point> oldestTime() const;
+
+   [[nodiscard]] bool empty() const { return _tiles.empty() && _openTimes.empty(); }
+   [[nodiscard]] std::size_t binCount() const { return _binCount; }
+
+   /** @brief Rows held, in sealed tiles and the one being filled. */
+   [[nodiscard]] std::size_t size() const;
+
+   /** @brief Bytes of the file ring. */
+   [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+   /** @brief Compressed bytes of the sealed tiles. */
+   [[nodiscard]] std::size_t storedBytes() const;
+
+private:
+   // A sealed tile in the file ring.
+   struct Tile
+   {
+      uint64_t id;               ///< Sequence number, the LRU key
+      std::size_t offset;        ///< Byte offset in the file
+      std::size_t bytes;         ///< Compressed size
+      std::size_t rows;
+      Clock::time_point first;   ///< Arrival time of the first row
+   };
+
+   // A decoded tile in the LRU.
+   struct Decoded
+   {
+      uint64_t id{0};
+      std::vector<Clock::rep> times;
+      std::vector<uint8_t> levels;   ///< rows x binCount
+   };
+
+   WaterfallTileCache(uint8_t* mapped, std::size_t capacity);
+
+   // Compress the open tile into the file ring, overwriting the oldest
+   // tiles it needs room from.
+   void seal();
+
+   // The decoded tile, from the LRU or the file; nullptr if it is corrupt.
+   const Decoded* decode(const Tile& tile);
+
+   // Rows per tile at the current bin count.
+   [[nodiscard]] std::size_t tileRows() const;
+
+   uint8_t* _mapped;
+   std::size_t _capacity;
+   std::size_t _writeOffset{0};
+
+   std::size_t _binCount{0};
+   uint64_t _nextId{0};
+   std::deque<Tile> _tiles;              ///< Sealed tiles, oldest first
+
+   std::vector<Clock::rep> _openTimes;   ///< Tile being filled
+   std::vector<uint8_t> _openLevels;
+   std::vector<uint8_t> _scratch;        ///< Raw tile for (de)compression
+   std::vector<char> _compressed;
+
+   std::list<Decoded> _decoded;          ///< Most recently used first
+};
+
+} // namespace RealTimeGraphs
+
+#endif // WATERFALLTILECACHE_H_
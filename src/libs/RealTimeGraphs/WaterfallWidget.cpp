@@ -2,6 +2,11 @@
 
 #include "ColorBarWidget.h"
 #include "CommonGuiUtils.h"
+#include "GlPlotSurface.h"
+#include "WaterfallGlRenderer.h"
+
+#include <GeneralLogger.h>
+#include <Profiler.h>
 
 #include <QPainter>
 #include <QPaintEvent>
@@ -9,9 +14,10 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
-#include <limits>
 
 namespace RealTimeGraphs
 {
@@ -22,7 +28,7 @@ namespace RealTimeGraphs
 
 WaterfallWidget::WaterfallWidget(QWidget* parent, double maxAgeSec)
    : PlotWidgetBase(parent)
-   , _maxAgeSec{maxAgeSec}
+   , _history{maxAgeSec}
 {
    _colorBar = new ColorBarStrip(this);
    _colorBar->setDbRange(_minDb, _maxDb);
@@ -64,18 +70,22 @@ WaterfallWidget::WaterfallWidget(QWidget* parent, double maxAgeSec)
          // yVal is row fraction: 0 = newest, 1 = oldest
          // Map to a row index and get its timestamp
          const std::lock_guard<std::mutex> lock(_mutex);
-         const auto rowCount = static_cast<int>(_rows.size());
+         const auto rowCount = static_cast<int>(_history.size());
          if (rowCount == 0)
          {
             return {};
          }
+         if (const auto age = scrollbackAge(yVal))
+         {
+            return QString::fromStdString(formatAge(*age));
+         }
          // frac 0 (top) -> newest = index rowCount-1
          // frac 1 (bottom) -> oldest = index 0
          const auto rowIdx = static_cast<std::size_t>(
             std::clamp(static_cast<int>(std::lround(
                           (1.0 - yVal) * static_cast<double>(rowCount - 1))),
                        0, rowCount - 1));
-         const auto& ts = _timestamps[rowIdx];
+         const auto ts = _history.timestamp(rowIdx);
          const auto now = std::chrono::steady_clock::now();
          const double ageSec = std::chrono::duration<double>(now - ts).count();
          return QString::fromStdString(formatAge(ageSec));
@@ -90,7 +100,7 @@ WaterfallWidget::WaterfallWidget(QWidget* parent, double maxAgeSec)
       {
          // Compute time delta between the two row fractions
          const std::lock_guard<std::mutex> lock(_mutex);
-         const auto rowCount = static_cast<int>(_rows.size());
+         const auto rowCount = static_cast<int>(_history.size());
          if (rowCount == 0)
          {
             return {};
@@ -102,9 +112,17 @@ WaterfallWidget::WaterfallWidget(QWidget* parent, double maxAgeSec)
                              (1.0 - frac) * static_cast<double>(rowCount - 1))),
                           0, rowCount - 1));
          };
-         const auto& ts1 = _timestamps[toRowIdx(y1)];
-         const auto& ts2 = _timestamps[toRowIdx(y2)];
-         const double deltaSec = std::chrono::duration<double>(ts1 - ts2).count();
+         double deltaSec = 0.0;
+         if (const auto age1 = scrollbackAge(y1))
+         {
+            deltaSec = *scrollbackAge(y2) - *age1;
+         }
+         else
+         {
+            const auto ts1 = _history.timestamp(toRowIdx(y1));
+            const auto ts2 = _history.timestamp(toRowIdx(y2));
+            deltaSec = std::chrono::duration<double>(ts1 - ts2).count();
+         }
          const QString sign = (deltaSec < 0.0) ? "-" : "";
          return QString::fromUtf8("\u0394t: ") + sign
               + QString::fromStdString(formatAge(std::abs(deltaSec)));
@@ -122,28 +140,40 @@ WaterfallWidget::WaterfallWidget(QWidget* parent, double maxAgeSec)
       });
 }
 
+WaterfallWidget::~WaterfallWidget()
+{
+   // Release the GL renderer while this object can still do it
+   setRenderBackend(RenderBackend::Raster);
+}
+
 // ============================================================================
 // Public API
 // ============================================================================
 
-void WaterfallWidget::addRow(const std::vector<float>& magnitudes)
+void WaterfallWidget::addRow(std::span<const float> magnitudes)
 {
-   // Normalise the incoming row
-   std::vector<float> normRow;
-   normRow.reserve(magnitudes.size());
-   for (const float val : magnitudes)
-   {
-      normRow.push_back(toNormalised(val));
-   }
-
    {
+      // Quantized straight into the history's ring: no per-row allocation
       const std::lock_guard<std::mutex> lock(_mutex);
-      _binCount = static_cast<int>(magnitudes.size());
-      _rows.push_back(normRow);
-      _timestamps.push_back(std::chrono::steady_clock::now());
-      pruneOldRows();
+      if (_history.binCount() != magnitudes.size())
+      {
+         _imageDirty = true;
+      }
+      const auto row = _history.append(magnitudes.size(), std::chrono::steady_clock::now());
+      if (_inputIsDb)
+      {
+         ColorMap::quantizeRow(magnitudes, row, _minDb, _maxDb);
+      }
+      else
+      {
+         for (std::size_t i = 0; i < magnitudes.size(); ++i)
+         {
+            row[i] = WaterfallHistory::quantize(toNormalised(magnitudes[i]));
+         }
+      }
+      ++_pendingRows;
    }
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void WaterfallWidget::setDbRange(float minDb, float maxDb)
@@ -151,20 +181,26 @@ void WaterfallWidget::setDbRange(float minDb, float maxDb)
    _minDb = minDb;
    _maxDb = maxDb;
    _colorBar->setDbRange(minDb, maxDb);
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void WaterfallWidget::setInputIsDb(bool isDb)
 {
    _inputIsDb = isDb;
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void WaterfallWidget::setColorMap(ColorMap::Palette palette)
 {
-   _colorMap = ColorMap(palette);
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _colorMap         = ColorMap(palette);
+      _imageDirty       = true;
+      _scrollImageDirty = true;
+      _lutDirty         = true;
+   }
    _colorBar->setColorMap(_colorMap);
-   safeUpdate(this);
+   repaintPlot();
 }
 
 QRect WaterfallWidget::plotArea() const
@@ -177,43 +213,98 @@ QRect WaterfallWidget::plotArea() const
 void WaterfallWidget::setColorBarVisible(bool visible)
 {
    _colorBar->setVisible(visible);
-   safeUpdate(this);
+   repaintPlot();
 }
 
 void WaterfallWidget::setMaxAge(double seconds)
 {
    const std::lock_guard<std::mutex> lock(_mutex);
-   _maxAgeSec = seconds;
-   pruneOldRows();
+   _history.setMaxAge(seconds, std::chrono::steady_clock::now());
+   _scrollImageDirty = true;
 }
 
-std::optional<std::pair<float, float>> WaterfallWidget::getAmplitudeRange() const
+bool WaterfallWidget::enableScrollback(const std::string& cacheFile, std::size_t maxBytes)
 {
+   auto cache = WaterfallTileCache::create(cacheFile, maxBytes);
+   if (cache == nullptr)
+   {
+      return false;
+   }
+
    const std::lock_guard<std::mutex> lock(_mutex);
+   _tileCache = std::move(cache);
+   // Called by the history under _mutex
+   _history.setEvictionHandler(
+      [this](std::span<const uint8_t> levels, WaterfallHistory::Clock::time_point time)
+      { _tileCache->append(levels, time); });
+   return true;
+}
 
-   if (_rows.empty())
+void WaterfallWidget::disableScrollback()
+{
    {
-      return std::nullopt;
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _history.setEvictionHandler({});
+      _tileCache.reset();
+      _scrollbackEnd.reset();
    }
+   repaintPlot();
+}
 
-   float minNorm = std::numeric_limits<float>::max();
-   float maxNorm = std::numeric_limits<float>::lowest();
-
-   for (const auto & row : _rows)
+void WaterfallWidget::setTimeOffset(double seconds)
+{
    {
-      if (!row.empty())
+      const std::lock_guard<std::mutex> lock(_mutex);
+      const auto now = std::chrono::steady_clock::now();
+
+      // Scroll back no further than puts the oldest row at the bottom
+      double maxOffset = 0.0;
+      if (_tileCache != nullptr)
+      {
+         const auto oldest = _tileCache->oldestTime().value_or(
+            _history.empty() ? now : _history.timestamp(0));
+         maxOffset = std::chrono::duration<double>(now - oldest).count() - _history.maxAge();
+      }
+
+      const double offset = std::min(seconds, maxOffset);
+      if (offset > 0.0)
       {
-         const auto [rowMin, rowMax] = std::ranges::minmax_element(row);
-         minNorm = std::min(minNorm, *rowMin);
-         maxNorm = std::max(maxNorm, *rowMax);
+         _scrollbackEnd = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(offset));
+      }
+      else
+      {
+         _scrollbackEnd.reset();
       }
    }
+   repaintPlot();
+}
+
+double WaterfallWidget::timeOffset() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (!_scrollbackEnd.has_value())
+   {
+      return 0.0;
+   }
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - *_scrollbackEnd)
+      .count();
+}
+
+std::optional<std::pair<float, float>> WaterfallWidget::getAmplitudeRange() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
 
-   if (minNorm == std::numeric_limits<float>::max())
+   const auto levels = _history.levelRange();
+   if (!levels.has_value())
    {
       return std::nullopt;
    }
 
+   constexpr auto LEVELS = static_cast<float>(WaterfallHistory::MAX_LEVEL);
+   const float minNorm = static_cast<float>(levels->first) / LEVELS;
+   const float maxNorm = static_cast<float>(levels->second) / LEVELS;
+
    // Convert normalized [0, 1] values back to dB.
    // Inverse of: norm = (db - _minDb) / (_maxDb - _minDb)
    const float minDb = (minNorm * (_maxDb - _minDb)) + _minDb;
@@ -226,9 +317,9 @@ std::optional<std::pair<float, float>> WaterfallWidget::getAmplitudeRange() cons
 // Events
 // ============================================================================
 
-void WaterfallWidget::paintEvent(QPaintEvent* /*event*/)
+void WaterfallWidget::paintFrame(QPainter& painter)
 {
-   QPainter painter(this);
+   GPPROFILE_SCOPE("WaterfallWidget::paintFrame");
    painter.setRenderHint(QPainter::Antialiasing, false);
 
    const QRect pArea = plotArea();
@@ -236,20 +327,17 @@ void WaterfallWidget::paintEvent(QPaintEvent* /*event*/)
    // Background
    painter.fillRect(rect(), QColor(25, 25, 30));
 
-   // Build and draw the spectrogram image
-   rebuildImage();
-
-   if (!_image.isNull())
+   // Spectrogram rows (Threaded: colorized and drawn on the rasterizer's thread)
+   if (!drawRasterizedPlot(painter, pArea))
    {
-      // Draw only the visible portion of the full image
-      const int srcX = static_cast<int>(_viewXStart * _image.width());
-      const int srcW = static_cast<int>((_viewXEnd - _viewXStart) * _image.width());
-      const QRect srcRect(srcX, 0, std::max(1, srcW), _image.height());
-      painter.drawImage(pArea, _image, srcRect);
-   }
-   else
-   {
-      painter.fillRect(pArea, QColor(15, 15, 20));
+      if (_glRenderer != nullptr)
+      {
+         drawRowsGl(painter, pArea);
+      }
+      else
+      {
+         drawRowsRaster(painter, pArea, _viewXStart, _viewXEnd);
+      }
    }
 
    // Draw border around plot area
@@ -274,7 +362,7 @@ void WaterfallWidget::paintEvent(QPaintEvent* /*event*/)
 
 void WaterfallWidget::resizeEvent(QResizeEvent* event)
 {
-   QWidget::resizeEvent(event);
+   PlotWidgetBase::resizeEvent(event);
 
    const QRect area = plotArea();
    _colorBar->setGeometry(
@@ -283,7 +371,7 @@ void WaterfallWidget::resizeEvent(QResizeEvent* event)
       COLOR_BAR_WIDTH,
       area.height());
 
-   update();
+   repaintPlot();
 }
 
 void WaterfallWidget::wheelEvent(QWheelEvent* event)
@@ -294,6 +382,24 @@ void WaterfallWidget::wheelEvent(QWheelEvent* event)
    const bool inPlot   = area.contains(pos.toPoint());
    const bool inXMargin = (pos.y() > area.bottom() &&
                            pos.x() >= area.left() && pos.x() <= area.right());
+   const bool inTimeAxis = (pos.x() < area.left() &&
+                            pos.y() >= area.top() && pos.y() <= area.bottom());
+
+   // Scrollback: wheel over the time axis moves a quarter window per notch,
+   // up going back in time
+   if (inTimeAxis && _tileCache != nullptr)
+   {
+      constexpr double NOTCH = 120.0;
+      double window = 0.0;
+      {
+         const std::lock_guard<std::mutex> lock(_mutex);
+         window = _history.maxAge();
+      }
+      const double notches = event->angleDelta().y() / NOTCH;
+      setTimeOffset(timeOffset() + (notches * window / 4.0));
+      event->accept();
+      return;
+   }
 
    if (!inPlot && !inXMargin)
    {
@@ -323,7 +429,7 @@ void WaterfallWidget::wheelEvent(QWheelEvent* event)
    _viewXEnd   = std::min(1.0, newXEnd);
 
    emit xViewChanged(_viewXStart, _viewXEnd);
-   update();
+   repaintPlot();
    event->accept();
 }
 
@@ -389,7 +495,7 @@ void WaterfallWidget::mouseMoveEvent(QMouseEvent* event)
       _viewXStart = std::max(0.0, newXStart);
       _viewXEnd   = std::min(1.0, newXEnd);
       emit xViewChanged(_viewXStart, _viewXEnd);
-      update();
+      repaintPlot();
       event->accept();
    }
    else
@@ -423,11 +529,11 @@ void WaterfallWidget::mouseDoubleClickEvent(QMouseEvent* event)
 
    if (event->button() == Qt::MiddleButton)
    {
-      // Reset X view to full range
+      // Reset X view to full range, and back to live
       _viewXStart = 0.0;
       _viewXEnd   = 1.0;
       emit xViewChanged(_viewXStart, _viewXEnd);
-      update();
+      setTimeOffset(0.0);
       event->accept();
    }
    else
@@ -441,57 +547,312 @@ void WaterfallWidget::leaveEvent(QEvent* event)
    processLeaveEvent(event);
 }
 
+bool WaterfallWidget::initializeGpu()
+{
+   auto renderer = std::make_unique<WaterfallGlRenderer>();
+   if (!renderer->isValid())
+   {
+      return false;
+   }
+
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _glRenderer = std::move(renderer);
+   _lutDirty   = true;
+   _image      = QImage();   // the texture holds the rows now
+   return true;
+}
+
+void WaterfallWidget::releaseGpu()
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _glRenderer.reset();
+   _imageDirty = true;
+}
+
 // ============================================================================
 // Internals
 // ============================================================================
 
-void WaterfallWidget::pruneOldRows()
+bool WaterfallWidget::hasThreadedRaster() const
 {
-   // Caller must hold _mutex.
-   const auto now = std::chrono::steady_clock::now();
-   const auto maxAge = std::chrono::duration<double>(_maxAgeSec);
-   while (!_timestamps.empty()
-          && std::chrono::duration<double>(now - _timestamps.front()) > maxAge)
+   return true;
+}
+
+void WaterfallWidget::rasterizePlot(QPainter& painter, const QRect& area,
+                                    const PlotRasterizer::View& view)
+{
+   drawRowsRaster(painter, area, view.xStart, view.xEnd);
+}
+
+void WaterfallWidget::drawRowsRaster(QPainter& painter, const QRect& area,
+                                     double xStart, double xEnd)
+{
+   if (drawScrollback(painter, area, xStart, xEnd))
    {
-      _rows.pop_front();
-      _timestamps.pop_front();
+      return;
+   }
+
+   // Colorize the new rows and draw the spectrogram ring
+   const int rowCount = updateImage();
+   if (rowCount == 0)
+   {
+      painter.fillRect(area, QColor(15, 15, 20));
+      return;
+   }
+
+   // Draw only the visible columns.  The rows run from _ringTop down,
+   // wrapping to the top of the image: two sub-rectangles when they wrap.
+   const int srcX = static_cast<int>(xStart * _image.width());
+   const int srcW = std::max(1, static_cast<int>((xEnd - xStart) * _image.width()));
+   const int firstRows = std::min(rowCount, _image.height() - _ringTop);
+   const int splitY = area.top() + static_cast<int>(
+      (static_cast<int64_t>(area.height()) * firstRows) / rowCount);
+
+   painter.drawImage(QRect(area.left(), area.top(), area.width(), splitY - area.top()),
+                     _image, QRect(srcX, _ringTop, srcW, firstRows));
+   if (firstRows < rowCount)
+   {
+      painter.drawImage(QRect(area.left(), splitY, area.width(),
+                              area.top() + area.height() - splitY),
+                        _image, QRect(srcX, 0, srcW, rowCount - firstRows));
    }
 }
 
-void WaterfallWidget::rebuildImage()
+void WaterfallWidget::drawRowsGl(QPainter& painter, const QRect& area)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
+   // The scrolled-back window is sampled on the CPU, whatever the backend
+   if (drawScrollback(painter, area, _viewXStart, _viewXEnd))
+   {
+      return;
+   }
+
+   painter.fillRect(area, QColor(15, 15, 20));
+
+   painter.beginNativePainting();
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      if (_lutDirty)
+      {
+         _glRenderer->setColorMap(_colorMap);
+         _lutDirty = false;
+      }
+      if (uploadRows())
+      {
+         const std::size_t rowCount   = _history.size();
+         const std::size_t newestSlot = (_history.oldestSlot() + rowCount - 1) % _history.capacity();
+         _glRenderer->draw(glSurface()->glViewport(area), newestSlot, rowCount,
+                           _viewXStart, _viewXEnd);
+      }
+   }
+   painter.endNativePainting();
+}
+
+bool WaterfallWidget::drawScrollback(QPainter& painter, const QRect& area,
+                                     double xStart, double xEnd)
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      if (!_scrollbackEnd.has_value())
+      {
+         return false;
+      }
+      if (_scrollImageDirty || _scrollImageEnd != _scrollbackEnd ||
+          _scrollImage.height() != area.height())
+      {
+         fillScrollImage(area.height());
+      }
+   }
+
+   if (_scrollImage.isNull())
+   {
+      painter.fillRect(area, QColor(15, 15, 20));
+      return true;
+   }
+   const int srcX = static_cast<int>(xStart * _scrollImage.width());
+   const int srcW = std::max(1, static_cast<int>((xEnd - xStart) * _scrollImage.width()));
+   painter.drawImage(area, _scrollImage, QRect(srcX, 0, srcW, _scrollImage.height()));
+   return true;
+}
+
+void WaterfallWidget::fillScrollImage(int lines)
+{
+   // Caller must hold _mutex.
+   GPPROFILE_SCOPE("WaterfallWidget::fillScrollImage");
+   _scrollImageEnd   = _scrollbackEnd;
+   _scrollImageDirty = false;
 
-   auto rowCount = static_cast<int>(_rows.size());
-   if (rowCount == 0 || _binCount == 0)
+   const std::size_t binCount = _history.empty() ? _tileCache->binCount() : _history.binCount();
+   if (binCount == 0 || lines <= 0)
    {
-      _image = QImage();
+      _scrollImage = QImage();
       return;
    }
+   if (_scrollImage.width() != static_cast<int>(binCount) || _scrollImage.height() != lines)
+   {
+      _scrollImage = QImage(static_cast<int>(binCount), lines, QImage::Format_RGBA8888);
+   }
+   _scrollImage.fill(QColor(15, 15, 20));
 
-   // Create an image with one pixel per bin horizontally, one per row vertically.
-   // Most recent row is at top (row index 0 in image), oldest at bottom.
-   _image = QImage(_binCount, rowCount, QImage::Format_RGBA8888);
+   // A row stands for the time until the next; further away is a gap
+   const double rate = _history.rowRate();
+   const double maxGapSec = (rate > 0.0) ? std::max(1.0, 4.0 / rate) : 1.0;
 
-   for (int r = 0; r < rowCount; ++r)
+   // Line 0 is the newest, as in the live view
+   using Duration = WaterfallHistory::Clock::duration;
+   const double window = _history.maxAge();
+   for (int y = 0; y < lines; ++y)
+   {
+      const std::chrono::duration<double> before(
+         window * (static_cast<double>(y) + 0.5) / static_cast<double>(lines));
+      const auto time = *_scrollbackEnd - std::chrono::duration_cast<Duration>(before);
+      const auto row = scrollbackRow(time);
+      if (!row.has_value() || row->levels.size() != binCount ||
+          std::chrono::duration<double>(time - row->time).count() > maxGapSec)
+      {
+         continue;
+      }
+      auto* scanLine = reinterpret_cast<uint32_t*>(_scrollImage.scanLine(y));
+      _colorMap.colorizeRow(row->levels, std::span<uint32_t>(scanLine, binCount));
+   }
+}
+
+std::optional<WaterfallTileCache::Row>
+WaterfallWidget::scrollbackRow(WaterfallHistory::Clock::time_point time)
+{
+   // Caller must hold _mutex.  Rows in memory are newer than the cache's.
+   if (!_history.empty() && time >= _history.timestamp(0))
+   {
+      std::size_t lo = 0;
+      std::size_t hi = _history.size();
+      while (hi - lo > 1)
+      {
+         const std::size_t mid = lo + ((hi - lo) / 2);
+         if (_history.timestamp(mid) <= time)
+         {
+            lo = mid;
+         }
+         else
+         {
+            hi = mid;
+         }
+      }
+      return WaterfallTileCache::Row{_history.row(lo), _history.timestamp(lo)};
+   }
+   if (_tileCache == nullptr)
+   {
+      return std::nullopt;
+   }
+   return _tileCache->rowAt(time);
+}
+
+std::optional<double> WaterfallWidget::scrollbackAge(double yFrac) const
+{
+   // Caller must hold _mutex.
+   if (!_scrollbackEnd.has_value())
+   {
+      return std::nullopt;
+   }
+   const double endAge =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - *_scrollbackEnd).count();
+   return endAge + (std::clamp(yFrac, 0.0, 1.0) * _history.maxAge());
+}
+
+bool WaterfallWidget::uploadRows()
+{
+   // Caller must hold _mutex.
+   const std::size_t pending = std::min(_pendingRows, _history.size());
+   _pendingRows = 0;
+   if (_history.empty())
+   {
+      return false;
+   }
+
+   // A new layout (bin count or reallocated ring) uploads the whole ring
+   if (_glRenderer->binCount() != _history.binCount() ||
+       _glRenderer->capacity() != _history.capacity())
+   {
+      if (!_glRenderer->allocate(_history.binCount(), _history.capacity(), _history.storage()))
+      {
+         GPWARN("WaterfallWidget: {} x {} levels exceed the GL texture size; "
+                "falling back to raster painting",
+                _history.binCount(), _history.capacity());
+         fallBackToRaster();
+         return false;
+      }
+      return true;
+   }
+
+   // Otherwise one glTexSubImage2D per new row, into its slot
+   for (std::size_t i = _history.size() - pending; i < _history.size(); ++i)
    {
-      // Logical index: 0 = oldest.  We want newest at image top.
-      const int logicalIdx = rowCount - 1 - r;
-      const auto& row = _rows[static_cast<std::size_t>(logicalIdx)];
+      _glRenderer->uploadRow((_history.oldestSlot() + i) % _history.capacity(), _history.row(i));
+   }
+   return true;
+}
 
-      auto* scanLine = reinterpret_cast<uint8_t*>(_image.scanLine(r));
-      const int cols = std::min(_binCount, static_cast<int>(row.size()));
+int WaterfallWidget::updateImage()
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
 
-      for (int c = 0; c < cols; ++c)
+   const auto rowCount = static_cast<int>(_history.size());
+   const auto binCount = static_cast<int>(_history.binCount());
+   if (rowCount == 0 || binCount == 0)
+   {
+      _pendingRows = 0;
+      return 0;
+   }
+
+   if (_imageDirty || _image.width() != binCount || _image.height() < rowCount)
+   {
+      rebuildImage();
+   }
+   else
+   {
+      // Oldest new row first, so the newest ends up at _ringTop
+      const std::size_t pending = std::min(_pendingRows, _history.size());
+      for (std::size_t i = _history.size() - pending; i < _history.size(); ++i)
       {
-         const Color clr = _colorMap.map(row[static_cast<std::size_t>(c)]);
-         const int offset = c * 4;
-         scanLine[offset + 0] = clr.r;
-         scanLine[offset + 1] = clr.g;
-         scanLine[offset + 2] = clr.b;
-         scanLine[offset + 3] = clr.a;
+         _ringTop = (_ringTop == 0) ? _image.height() - 1 : _ringTop - 1;
+         colorizeRow(_history.row(i), _ringTop);
       }
    }
+   _pendingRows = 0;
+   return rowCount;
+}
+
+void WaterfallWidget::rebuildImage()
+{
+   // Caller must hold _mutex.
+   const auto rowCount = static_cast<int>(_history.size());
+
+   const auto binCount = static_cast<int>(_history.binCount());
+
+   // Grow by doubling so a lengthening history rebuilds only log(n) times
+   int capacity = (_image.width() == binCount) ? std::max(_image.height(), MIN_RING_ROWS)
+                                               : MIN_RING_ROWS;
+   while (capacity < rowCount)
+   {
+      capacity *= 2;
+   }
+   if (_image.width() != binCount || _image.height() != capacity)
+   {
+      _image = QImage(binCount, capacity, QImage::Format_RGBA8888);
+   }
+
+   // Newest row at line 0, oldest below it
+   _ringTop = 0;
+   for (int r = 0; r < rowCount; ++r)
+   {
+      colorizeRow(_history.row(static_cast<std::size_t>(rowCount - 1 - r)), r);
+   }
+   _imageDirty = false;
+}
+
+void WaterfallWidget::colorizeRow(std::span<const uint8_t> row, int imageRow)
+{
+   // Levels index the LUT directly (WaterfallHistory::quantize matches map())
+   auto* scanLine = reinterpret_cast<uint32_t*>(_image.scanLine(imageRow));
+   _colorMap.colorizeRow(row, std::span<uint32_t>(scanLine, row.size()));
 }
 
 float WaterfallWidget::toNormalised(float value) const
@@ -554,15 +915,30 @@ void WaterfallWidget::drawTimeLabels(QPainter& painter, const QRect& area) const
 
    const std::lock_guard<std::mutex> lock(_mutex);
 
-   const auto rowCount = static_cast<int>(_rows.size());
-   if (rowCount == 0)
+   const auto rowCount = static_cast<int>(_history.size());
+   if (rowCount == 0 && !_scrollbackEnd.has_value())
    {
       return;
    }
 
    constexpr int Y_TICKS = 6;
+   constexpr int LABEL_HEIGHT = 12;
    const auto now = std::chrono::steady_clock::now();
 
+   // Scrolled back: ages across the window
+   if (_scrollbackEnd.has_value())
+   {
+      for (int i = 0; i <= Y_TICKS; ++i)
+      {
+         const double frac = static_cast<double>(i) / static_cast<double>(Y_TICKS);
+         const int yPos = area.top() + static_cast<int>(frac * static_cast<double>(area.height()));
+         const QString label = QString::fromStdString(formatAge(*scrollbackAge(frac)));
+         painter.drawText(0, yPos - (LABEL_HEIGHT / 2), MARGIN_LEFT - 5, LABEL_HEIGHT,
+                          Qt::AlignRight | Qt::AlignVCenter, label);
+      }
+      return;
+   }
+
    // Newest row is logical index (rowCount - 1), oldest is index 0.
    for (int i = 0; i <= Y_TICKS; ++i)
    {
@@ -576,12 +952,11 @@ void WaterfallWidget::drawTimeLabels(QPainter& painter, const QRect& area) const
          std::clamp(static_cast<int>(std::lround(
                        (1.0F - frac) * static_cast<float>(rowCount - 1))),
                     0, rowCount - 1));
-      const auto& ts = _timestamps[rowIdx];
+      const auto ts = _history.timestamp(rowIdx);
 
       const double ageSec = std::chrono::duration<double>(now - ts).count();
       const QString label = QString::fromStdString(formatAge(ageSec));
 
-      constexpr int LABEL_HEIGHT = 12;
       painter.drawText(0, yPos - (LABEL_HEIGHT / 2), MARGIN_LEFT - 5, LABEL_HEIGHT,
                        Qt::AlignRight | Qt::AlignVCenter, label);
    }
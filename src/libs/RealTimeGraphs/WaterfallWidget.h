@@ -4,15 +4,18 @@
 // Project headers
 #include "PlotWidgetBase.h"
 #include "ColorMap.h"
+#include "WaterfallHistory.h"
+#include "WaterfallTileCache.h"
 
 // Third-party headers
 #include <QImage>
 
 // System headers
-#include <chrono>
-#include <deque>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -20,7 +23,8 @@
 namespace RealTimeGraphs
 {
 
-class ColorBarStrip; // forward declaration
+class ColorBarStrip;        // forward declaration
+class WaterfallGlRenderer;  // forward declaration
 
 /**
  * @class WaterfallWidget
@@ -28,8 +32,24 @@ class ColorBarStrip; // forward declaration
  *
  * Each call to `addRow()` pushes a new frequency-domain row onto the
  * display.  The most recent row appears at the bottom; older rows scroll
- * upward and are eventually discarded.  Internally uses a `CircularBuffer`
- * of `QImage` scan lines.
+ * upward and are eventually discarded.  The history is kept as 8-bit
+ * levels in a WaterfallHistory ring.
+ *
+ * The colorized rows live in a ring image kept across repaints: a repaint
+ * colorizes only the rows added since the last one, each into the line
+ * above the previous newest, and draws the ring as two sub-rectangles when
+ * it wraps.  The whole image is recolorized only when the palette or the
+ * bin count changes, or the history outgrows the ring.
+ *
+ * With the OpenGl render backend the ring itself is mirrored in a texture
+ * instead (WaterfallGlRenderer): a repaint uploads only the new rows and
+ * the colormap is applied by a fragment shader.
+ *
+ * With scrollback enabled, rows older than the maximum age move to a
+ * WaterfallTileCache on disk instead of being dropped.  Scrolling back
+ * (wheel over the time axis, or setTimeOffset()) shows a window of the
+ * maximum age ending in the past, sampled one row per pixel line from the
+ * history and the cache; the window stays put while new rows arrive.
  */
 class WaterfallWidget : public PlotWidgetBase
 {
@@ -41,13 +61,17 @@ public:
     * @param maxAgeSec  Maximum age (in seconds) of rows to keep in history.
     */
    explicit WaterfallWidget(QWidget* parent = nullptr, double maxAgeSec = 20.0);
+   ~WaterfallWidget() override;
+
+   WaterfallWidget(const WaterfallWidget&) = delete;
+   WaterfallWidget& operator=(const WaterfallWidget&) = delete;
 
    /**
-    * @brief Append a new spectrum row.  The vector is copied.
+    * @brief Append a new spectrum row.  The values are copied.
     * Thread-safe — can be called from a producer thread.
     * @param magnitudes  Linear magnitudes (0 … 1 normalised) or dB values.
     */
-   void addRow(const std::vector<float>& magnitudes);
+   void addRow(std::span<const float> magnitudes);
 
    /** @brief Set the dB display range (e.g., -120 to 0). */
    void setDbRange(float minDb, float maxDb);
@@ -61,9 +85,30 @@ public:
    /** @brief Show or hide the built-in color-bar legend. */
    void setColorBarVisible(bool visible);
 
-   /** @brief Set the maximum age (in seconds) of rows to keep. */
+   /** @brief Set the maximum age (in seconds) of rows to keep in memory (and to show). */
    void setMaxAge(double seconds);
 
+   /**
+    * @brief Keep rows older than the maximum age in a compressed cache file,
+    * so hours of history can be scrolled back through.
+    * @param cacheFile  File to create; unlinked once open.
+    * @param maxBytes   Size of the file; past it the oldest rows are overwritten.
+    * @return false if the cache could not be created (logged)
+    */
+   bool enableScrollback(const std::string& cacheFile, std::size_t maxBytes);
+
+   /** @brief Drop the scrollback cache and return to the live view. */
+   void disableScrollback();
+
+   /**
+    * @brief Show the window ending `seconds` ago (0 = live).  Clamped so
+    * the oldest row held is at most at the bottom; needs scrollback.
+    */
+   void setTimeOffset(double seconds);
+
+   /** @brief How long ago the shown window ends (0 = live). */
+   [[nodiscard]] double timeOffset() const;
+
    /**
     * @brief Get the minimum and maximum amplitude values (in dB) from all rows in history.
     * Returns std::nullopt if no data is available.
@@ -72,7 +117,12 @@ public:
    [[nodiscard]] std::optional<std::pair<float, float>> getAmplitudeRange() const;
 
 protected:
-   void paintEvent(QPaintEvent* event) override;
+   void paintFrame(QPainter& painter) override;
+   bool initializeGpu() override;
+   void releaseGpu() override;
+   [[nodiscard]] bool hasThreadedRaster() const override;
+   void rasterizePlot(QPainter& painter, const QRect& area,
+                      const PlotRasterizer::View& view) override;
    void resizeEvent(QResizeEvent* event) override;
    void wheelEvent(QWheelEvent* event) override;
    void mousePressEvent(QMouseEvent* event) override;
@@ -84,9 +134,45 @@ protected:
    [[nodiscard]] QRect plotArea() const override;
 
 private:
-   // Rebuild the off-screen image from circular buffer contents.
+   /** @brief Fewest rows the ring image is allocated with. */
+   static constexpr int MIN_RING_ROWS = 256;
+
+   // Bring the ring image up to date with _rows; returns the rows to show.
+   int updateImage();
+
+   // Recolorize every row into a ring large enough for them.  Caller must
+   // hold _mutex.
    void rebuildImage();
 
+   // Colorize one row of levels into a line of the ring image.
+   void colorizeRow(std::span<const uint8_t> row, int imageRow);
+
+   // Draw the visible columns of the rows from the ring image.
+   void drawRowsRaster(QPainter& painter, const QRect& area, double xStart, double xEnd);
+
+   // Draw the scrolled-back window; false when live.
+   bool drawScrollback(QPainter& painter, const QRect& area, double xStart, double xEnd);
+
+   // Sample the scrolled-back window into _scrollImage, one row per line.
+   // Caller must hold _mutex.
+   void fillScrollImage(int lines);
+
+   // The latest row at or before `time`, in memory or in the cache.  Caller
+   // must hold _mutex.
+   [[nodiscard]] std::optional<WaterfallTileCache::Row>
+   scrollbackRow(WaterfallHistory::Clock::time_point time);
+
+   // Age at a row fraction (0 = top) of the scrolled-back window; nullopt
+   // when live.  Caller must hold _mutex.
+   [[nodiscard]] std::optional<double> scrollbackAge(double yFrac) const;
+
+   // Draw the rows with the GL renderer.
+   void drawRowsGl(QPainter& painter, const QRect& area);
+
+   // Bring the GL texture up to date with the history; false if there is
+   // nothing to draw.  Caller must hold _mutex.
+   bool uploadRows();
+
    // Draw frequency tick labels along the x-axis.
    void drawFrequencyLabels(QPainter& painter, const QRect& area) const;
 
@@ -99,22 +185,42 @@ private:
    // Convert a linear magnitude to normalised [0, 1] within the dB range.
    [[nodiscard]] float toNormalised(float value) const;
 
-   // Prune rows from the front of _rows/_timestamps that are older than _maxAgeSec.
-   void pruneOldRows();
-
    mutable std::mutex _mutex;
 
-   double _maxAgeSec;
-   int _binCount{0};
+   /** @brief Quantized normalised rows and their arrival times. */
+   WaterfallHistory _history;
 
-   /** @brief Each element is a spectrum row (vector of normalised values). */
-   std::deque<std::vector<float>> _rows;
+   /** @brief Ring of colorized rows: the newest at line _ringTop, older ones
+    *  below it, wrapping to the top.  Only touched by the thread drawing
+    *  the rows: the GUI thread, or the rasterizer's with Threaded. */
+   QImage _image;
+   int _ringTop{0};
 
-   /** @brief Timestamp for each row (parallel to _rows). */
-   std::deque<std::chrono::steady_clock::time_point> _timestamps;
+   /** @brief Rows added since the image was last brought up to date. */
+   std::size_t _pendingRows{0};
 
-   /** @brief Off-screen rendered spectrogram image. */
-   QImage _image;
+   /** @brief Palette or bin count changed: recolorize every row. */
+   bool _imageDirty{true};
+
+   /** @brief Rows older than the history, for scrollback (null if disabled). */
+   std::unique_ptr<WaterfallTileCache> _tileCache;
+
+   /** @brief End of the shown window when scrolled back; live if unset. */
+   std::optional<WaterfallHistory::Clock::time_point> _scrollbackEnd;
+
+   /** @brief The scrolled-back window, newest line at the top, and the end
+    *  it was sampled for.  Drawing thread only, like _image. */
+   QImage _scrollImage;
+   std::optional<WaterfallHistory::Clock::time_point> _scrollImageEnd;
+
+   /** @brief Palette changed: resample the scrolled-back window. */
+   bool _scrollImageDirty{true};
+
+   /** @brief GPU renderer, OpenGl backend only (GUI thread). */
+   std::unique_ptr<WaterfallGlRenderer> _glRenderer;
+
+   /** @brief Palette changed: upload the LUT to the GL renderer. */
+   bool _lutDirty{true};
 
    ColorMap _colorMap{ColorMap::Palette::Viridis};
    float _minDb{-120.0F};
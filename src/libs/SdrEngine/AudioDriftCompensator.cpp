@@ -0,0 +1,199 @@
+// Project headers
+#include "AudioDriftCompensator.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Catmull-Rom spline through x0..x3, evaluated between x1 (t = 0) and x2.
+inline float catmullRom(float x0, float x1, float x2, float x3, float t)
+{
+   const float a = (-0.5F * x0) + (1.5F * x1) - (1.5F * x2) + (0.5F * x3);
+   const float b = x0 - (2.5F * x1) + (2.0F * x2) - (0.5F * x3);
+   const float c = 0.5F * (x2 - x0);
+   return (((a * t + b) * t) + c) * t + x1;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction / configuration
+// ============================================================================
+
+AudioDriftCompensator::AudioDriftCompensator(std::size_t channels, double targetFillFrames)
+   : _channels{std::max<std::size_t>(channels, 1)}
+   , _targetFill{std::max(targetFillFrames, 1.0)}
+   , _smoothedFill{_targetFill}
+{
+   reset();
+}
+
+void AudioDriftCompensator::configure(std::size_t channels, double targetFillFrames)
+{
+   _channels = std::max<std::size_t>(channels, 1);
+   _targetFill = std::max(targetFillFrames, 1.0);
+   reset();
+}
+
+void AudioDriftCompensator::reset()
+{
+   _ratio = 1.0;
+   _smoothedFill = _targetFill;
+   _integral = 0.0;
+   _position = 0.0;
+   _history.assign(HISTORY_FRAMES * _channels, 0.0F);
+}
+
+std::size_t AudioDriftCompensator::outputBound(std::size_t frames) const
+{
+   return static_cast<std::size_t>(
+             std::ceil(static_cast<double>(frames + HISTORY_FRAMES) * (1.0 + MAX_CORRECTION))) + 1;
+}
+
+// ============================================================================
+// Accessors
+// ============================================================================
+
+double AudioDriftCompensator::getRatio() const
+{
+   return _ratio;
+}
+
+double AudioDriftCompensator::getSmoothedFill() const
+{
+   return _smoothedFill;
+}
+
+double AudioDriftCompensator::getTargetFill() const
+{
+   return _targetFill;
+}
+
+// ============================================================================
+// Control loop
+// ============================================================================
+
+void AudioDriftCompensator::updateRatio(double fillFrames, std::size_t elapsedFrames)
+{
+   // Time is measured in target periods: the fill error then moves by the
+   // correction itself per period, whatever the target.
+   const double periods = static_cast<double>(elapsedFrames) / _targetFill;
+
+   // Block-wise production and consumption make the instantaneous fill
+   // saw-tooth; only its average says anything about drift.
+   const double alpha = periods / (FILL_SMOOTHING_PERIODS + periods);
+   _smoothedFill += alpha * (fillFrames - _smoothedFill);
+
+   const double error = (_smoothedFill - _targetFill) / _targetFill;
+   const double integralLimit = MAX_CORRECTION / INTEGRAL_GAIN;
+   _integral = std::clamp(_integral + error * periods, -integralLimit, integralLimit);
+
+   // Too full: produce fewer frames than we are given, and vice versa.
+   const double correction = (PROPORTIONAL_GAIN * error) + (INTEGRAL_GAIN * _integral);
+   _ratio = 1.0 - std::clamp(correction, -MAX_CORRECTION, MAX_CORRECTION);
+}
+
+// ============================================================================
+// Resampling
+// ============================================================================
+
+std::size_t AudioDriftCompensator::process(const float* in, std::size_t frames,
+                                           std::size_t fillFrames, float* out)
+{
+   return process(in, frames, fillFrames, std::span<float>(out, outputBound(frames) * _channels), {});
+}
+
+std::size_t AudioDriftCompensator::process(const float* in, std::size_t frames, std::size_t fillFrames,
+                                           std::span<float> first, std::span<float> second)
+{
+   const std::size_t channels = _channels;
+   return resample([in, channels](std::size_t k, std::size_t c) { return in[(k * channels) + c]; },
+                   frames, fillFrames, first, second);
+}
+
+std::size_t AudioDriftCompensator::processPlanar(std::span<const float* const> planes, std::size_t frames,
+                                                 std::size_t fillFrames, std::span<float> first,
+                                                 std::span<float> second)
+{
+   if (planes.size() < _channels)
+   {
+      return 0;
+   }
+   return resample([planes](std::size_t k, std::size_t c) { return planes[c][k]; },
+                   frames, fillFrames, first, second);
+}
+
+template <typename Input>
+std::size_t AudioDriftCompensator::resample(const Input& input, std::size_t frames, std::size_t fillFrames,
+                                            std::span<float> first, std::span<float> second)
+{
+   if (frames == 0)
+   {
+      return 0;
+   }
+   updateRatio(static_cast<double>(fillFrames), frames);
+
+   const auto blockFrames = static_cast<std::ptrdiff_t>(frames);
+   const auto historyFrames = static_cast<std::ptrdiff_t>(HISTORY_FRAMES);
+   const auto sampleAt = [&](std::ptrdiff_t k, std::size_t c) -> float
+   {
+      return (k < 0) ? _history[(static_cast<std::size_t>(k + historyFrames) * _channels) + c]
+                     : input(static_cast<std::size_t>(k), c);
+   };
+
+   // Whole frames that fit in the two regions; the rest are discarded.
+   const std::size_t capacityFrames = (first.size() + second.size()) / _channels;
+
+   const double step = 1.0 / _ratio;
+   std::size_t produced = 0;
+   while (true)
+   {
+      const double base = std::floor(_position);
+      const auto k = static_cast<std::ptrdiff_t>(base);
+      if (k + 2 >= blockFrames)
+      {
+         break;
+      }
+      if (produced < capacityFrames)
+      {
+         const auto t = static_cast<float>(_position - base);
+         std::size_t slot = produced * _channels;
+         for (std::size_t c = 0; c < _channels; ++c, ++slot)
+         {
+            const float y = catmullRom(sampleAt(k - 1, c), sampleAt(k, c), sampleAt(k + 1, c),
+                                       sampleAt(k + 2, c), t);
+            if (slot < first.size())
+            {
+               first[slot] = y;
+            }
+            else
+            {
+               second[slot - first.size()] = y;
+            }
+         }
+      }
+      ++produced;
+      _position += step;
+   }
+   _position -= static_cast<double>(frames);
+
+   // Keep the last HISTORY_FRAMES frames of history + block.  Shifting in
+   // ascending order only ever reads slots not yet overwritten.
+   for (std::ptrdiff_t h = 0; h < historyFrames; ++h)
+   {
+      const std::ptrdiff_t k = blockFrames - historyFrames + h;
+      for (std::size_t c = 0; c < _channels; ++c)
+      {
+         _history[(static_cast<std::size_t>(h) * _channels) + c] = sampleAt(k, c);
+      }
+   }
+   return produced;
+}
+
+} // namespace SdrEngine
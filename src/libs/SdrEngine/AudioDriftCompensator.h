@@ -0,0 +1,158 @@
+#ifndef AUDIODRIFTCOMPENSATOR_H_
+#define AUDIODRIFTCOMPENSATOR_H_
+
+// System headers
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class AudioDriftCompensator
+ * @brief Fine resampler that absorbs the clock difference between the SDR
+ *        and the sound card by steering an audio ring's fill level.
+ *
+ * Audio is produced at the SDR's idea of the audio rate and played at the
+ * sound card's, which typically differ by tens of ppm: the ring between
+ * them slowly fills until it overflows, or drains until it underruns.
+ * Before each block is written to the ring, process() measures the fill
+ * level, smooths it over FILL_SMOOTHING_PERIODS target latencies and runs
+ * a PI controller that nudges the output/input ratio by at most
+ * ±MAX_CORRECTION (0.5 %, under ten cents of pitch).  The block is then
+ * resampled with cubic (Catmull-Rom) interpolation at that ratio, so the
+ * fill level — and with it the latency — settles at the target.
+ *
+ * Output can go straight into the two writable regions of an
+ * AudioRing::prepareWrite(), and planar (one buffer per channel) input is
+ * interleaved in the same pass, so a DemodAudio block reaches the ring
+ * with a single copy.
+ *
+ * Thread-safety: not thread-safe; call from the producer thread only.
+ */
+class AudioDriftCompensator
+{
+public:
+   /// Largest relative rate correction applied.
+   static constexpr double MAX_CORRECTION = 0.005;
+
+   /// Proportional gain: correction per unit of relative fill error.
+   static constexpr double PROPORTIONAL_GAIN = 0.005;
+
+   /// Integral gain per target period, critically damping the loop.
+   static constexpr double INTEGRAL_GAIN = PROPORTIONAL_GAIN * PROPORTIONAL_GAIN / 4.0;
+
+   /// Time constant of the fill-level smoothing, in target latencies.
+   static constexpr double FILL_SMOOTHING_PERIODS = 20.0;
+
+   /// Input frames kept from the previous block for interpolation.
+   static constexpr std::size_t HISTORY_FRAMES = 3;
+
+   /**
+    * @brief Construct a compensator.
+    * @param channels          Interleaved channels per frame.
+    * @param targetFillFrames  Ring fill level to hold, in frames.
+    */
+   explicit AudioDriftCompensator(std::size_t channels = 2, double targetFillFrames = 2400.0);
+
+   /**
+    * @brief Change the layout and target, then reset().
+    * @param channels          Interleaved channels per frame.
+    * @param targetFillFrames  Ring fill level to hold, in frames.
+    */
+   void configure(std::size_t channels, double targetFillFrames);
+
+   /** @brief Clear the interpolation history and controller state. */
+   void reset();
+
+   /**
+    * @brief Upper bound on the frames process() returns for `frames` input.
+    * @param frames  Input frames.
+    * @return Output frames to size the destination for.
+    */
+   [[nodiscard]] std::size_t outputBound(std::size_t frames) const;
+
+   /**
+    * @brief Update the ratio from the fill level, then resample one block.
+    * @param in          Interleaved input, `frames * channels` samples.
+    * @param frames      Input frames.
+    * @param fillFrames  Frames currently queued in the ring.
+    * @param out         Destination, at least `outputBound(frames)` frames.
+    * @return Number of frames written to `out`.
+    */
+   std::size_t process(const float* in, std::size_t frames, std::size_t fillFrames, float* out);
+
+   /**
+    * @brief As process(), writing interleaved frames across two regions
+    *        (e.g. AudioRing::prepareWrite()).
+    *
+    * Frames that do not fit entirely in the regions are discarded.
+    *
+    * @param in          Interleaved input, `frames * channels` samples.
+    * @param frames      Input frames.
+    * @param fillFrames  Frames currently queued in the ring.
+    * @param first       First output region.
+    * @param second      Continuation of `first` (may be empty).
+    * @return Frames generated; the first `(first.size() + second.size()) /
+    *         channels` of them were stored.
+    */
+   std::size_t process(const float* in, std::size_t frames, std::size_t fillFrames,
+                       std::span<float> first, std::span<float> second);
+
+   /**
+    * @brief As process(), but from planar input: one buffer per channel,
+    *        interleaved while resampling.
+    * @param planes      One pointer per channel, each `frames` samples.
+    * @param frames      Input frames.
+    * @param fillFrames  Frames currently queued in the ring.
+    * @param first       First output region.
+    * @param second      Continuation of `first` (may be empty).
+    * @return Frames generated; see the interleaved overload.
+    */
+   std::size_t processPlanar(std::span<const float* const> planes, std::size_t frames,
+                             std::size_t fillFrames, std::span<float> first, std::span<float> second);
+
+   /**
+    * @brief Get the current output/input ratio (1.0 = no correction).
+    * @return Ratio in [1 - MAX_CORRECTION, 1 + MAX_CORRECTION].
+    */
+   [[nodiscard]] double getRatio() const;
+
+   /**
+    * @brief Get the smoothed fill level the controller acts on.
+    * @return Fill level in frames.
+    */
+   [[nodiscard]] double getSmoothedFill() const;
+
+   /**
+    * @brief Get the fill level the controller steers to.
+    * @return Target fill in frames.
+    */
+   [[nodiscard]] double getTargetFill() const;
+
+private:
+   // Run the smoothing filter and PI controller for `elapsedFrames` input.
+   void updateRatio(double fillFrames, std::size_t elapsedFrames);
+
+   // Resample one block; `input(k, c)` reads channel c of block frame k.
+   template <typename Input>
+   std::size_t resample(const Input& input, std::size_t frames, std::size_t fillFrames,
+                        std::span<float> first, std::span<float> second);
+
+   std::size_t _channels;
+   double _targetFill;
+
+   double _ratio{1.0};
+   double _smoothedFill;
+   double _integral{0.0};
+
+   // Read position relative to the current block's first frame; frames
+   // -HISTORY_FRAMES..-1 are the tail of the previous block.
+   double _position{0.0};
+   std::vector<float> _history;
+};
+
+} // namespace SdrEngine
+
+#endif // AUDIODRIFTCOMPENSATOR_H_
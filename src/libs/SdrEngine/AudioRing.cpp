@@ -0,0 +1,111 @@
+// Project headers
+#include "AudioRing.h"
+
+// System headers
+#include <cstring>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Construction / reset
+// ============================================================================
+
+AudioRing::AudioRing(std::size_t minCapacity)
+{
+   reset(minCapacity);
+}
+
+void AudioRing::reset(std::size_t minCapacity)
+{
+   _ring.reset(minCapacity);
+   _overflowSamples.store(0, std::memory_order_relaxed);
+   _underruns.store(0, std::memory_order_relaxed);
+   _underrunSamples.store(0, std::memory_order_relaxed);
+}
+
+void AudioRing::drain()
+{
+   _ring.drain();
+}
+
+// ============================================================================
+// State queries
+// ============================================================================
+
+std::size_t AudioRing::available() const
+{
+   return _ring.available();
+}
+
+std::size_t AudioRing::freeSpace() const
+{
+   return _ring.freeSpace();
+}
+
+uint64_t AudioRing::overflowCount() const
+{
+   return _overflowSamples.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioRing::underrunCount() const
+{
+   return _underruns.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioRing::underrunSamples() const
+{
+   return _underrunSamples.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+AudioRing::WriteRegions AudioRing::prepareWrite(std::size_t count)
+{
+   return _ring.prepareWrite(count);
+}
+
+void AudioRing::commitWrite(std::size_t count)
+{
+   _ring.commitWrite(count);
+}
+
+void AudioRing::recordOverflow(std::size_t droppedSamples)
+{
+   _overflowSamples.fetch_add(droppedSamples, std::memory_order_relaxed);
+}
+
+std::size_t AudioRing::write(const float* samples, std::size_t count)
+{
+   const std::size_t written = _ring.write(samples, count);
+   if (written < count)
+   {
+      recordOverflow(count - written);
+   }
+   return written;
+}
+
+// ============================================================================
+// Consumer side
+// ============================================================================
+
+std::size_t AudioRing::read(float* dest, std::size_t count)
+{
+   return _ring.read(dest, count);
+}
+
+std::size_t AudioRing::readOrSilence(float* dest, std::size_t count)
+{
+   const std::size_t n = read(dest, count);
+   if (n < count)
+   {
+      std::memset(dest + n, 0, (count - n) * sizeof(float));
+      _underruns.fetch_add(1, std::memory_order_relaxed);
+      _underrunSamples.fetch_add(count - n, std::memory_order_relaxed);
+   }
+   return n;
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,133 @@
+#ifndef AUDIORING_H_
+#define AUDIORING_H_
+
+// Project headers
+#include "SpscRingBuffer.h"
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace SdrEngine
+{
+
+/**
+ * @class AudioRing
+ * @brief Preallocated, lock-free single-producer / single-consumer ring of
+ *        interleaved float audio samples.
+ *
+ * Sits between the thread that produces demodulated audio and the sound
+ * card's pull callback.  A CommonUtils::SpscRingBuffer holds the samples:
+ * both sides copy in at most two contiguous chunks (one before and one
+ * after the wrap point) and never take a lock or allocate after `reset()`.
+ * The producer may instead reserve the writable regions, render into them
+ * directly and commit.
+ *
+ * A full ring drops the producer's excess samples (`overflowCount()`); an
+ * empty ring makes `readOrSilence()` zero-fill and count an underrun.
+ *
+ * Thread-safety: exactly one producer thread and one consumer thread may
+ * operate concurrently.  `reset()` must only be called while neither is
+ * active.
+ */
+class AudioRing
+{
+public:
+   /** @brief Up to two contiguous spans covering the reserved write range. */
+   using WriteRegions = CommonUtils::SpscRingBuffer<float>::WriteRegions;
+
+   /**
+    * @brief Construct a ring holding at least `minCapacity` samples.
+    * The capacity is rounded up to the next power of two.  A capacity of
+    * zero leaves the ring unallocated until `reset()` is called.
+    */
+   explicit AudioRing(std::size_t minCapacity = 0);
+
+   // Non-copyable, non-movable (atomics are shared between threads).
+   AudioRing(const AudioRing&) = delete;
+   AudioRing& operator=(const AudioRing&) = delete;
+   AudioRing(AudioRing&&) = delete;
+   AudioRing& operator=(AudioRing&&) = delete;
+   ~AudioRing() = default;
+
+   /**
+    * @brief Reallocate (if needed), empty the ring and clear all counters.
+    * Not thread-safe — call only while no producer or consumer is running.
+    * @param minCapacity  Minimum number of samples the ring must hold.
+    */
+   void reset(std::size_t minCapacity);
+
+   /**
+    * @brief Empty the ring from the consumer side, keeping the counters.
+    * Safe to call from the consumer thread while the producer runs.
+    */
+   void drain();
+
+   /** @brief Storage capacity in samples (always a power of two, or zero). */
+   [[nodiscard]] std::size_t capacity() const { return _ring.capacity(); }
+
+   /** @brief Number of samples ready to be read. */
+   [[nodiscard]] std::size_t available() const;
+
+   /** @brief Number of samples that can be written without dropping. */
+   [[nodiscard]] std::size_t freeSpace() const;
+
+   /** @brief Total samples dropped because the ring was full. */
+   [[nodiscard]] uint64_t overflowCount() const;
+
+   /** @brief Number of readOrSilence() calls that ran out of samples. */
+   [[nodiscard]] uint64_t underrunCount() const;
+
+   /** @brief Total samples zero-filled by readOrSilence(). */
+   [[nodiscard]] uint64_t underrunSamples() const;
+
+   // -- Producer side -------------------------------------------------------
+
+   /**
+    * @brief Reserve space for up to `count` samples.
+    * The returned regions may be shorter than requested if the ring is
+    * nearly full.  Follow with `commitWrite()`.
+    */
+   [[nodiscard]] WriteRegions prepareWrite(std::size_t count);
+
+   /** @brief Publish `count` samples previously written via prepareWrite(). */
+   void commitWrite(std::size_t count);
+
+   /** @brief Record samples the producer had to discard. */
+   void recordOverflow(std::size_t droppedSamples);
+
+   /**
+    * @brief Copy `count` samples into the ring, dropping what does not fit.
+    * @return Number of samples actually written.
+    */
+   std::size_t write(const float* samples, std::size_t count);
+
+   // -- Consumer side -------------------------------------------------------
+
+   /**
+    * @brief Copy up to `count` samples out of the ring and consume them.
+    * @return Number of samples actually read.
+    */
+   std::size_t read(float* dest, std::size_t count);
+
+   /**
+    * @brief Fill `dest` with exactly `count` samples, zero-filling whatever
+    *        the ring cannot supply and counting that as an underrun.
+    * @return Number of real (non-silence) samples copied.
+    */
+   std::size_t readOrSilence(float* dest, std::size_t count);
+
+private:
+   static constexpr std::size_t CACHE_LINE = 64;
+
+   CommonUtils::SpscRingBuffer<float> _ring;
+
+   alignas(CACHE_LINE) std::atomic<uint64_t> _overflowSamples{0};
+   std::atomic<uint64_t> _underruns{0};
+   std::atomic<uint64_t> _underrunSamples{0};
+};
+
+} // namespace SdrEngine
+
+#endif // AUDIORING_H_
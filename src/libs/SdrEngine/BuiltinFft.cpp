@@ -0,0 +1,122 @@
+// Project headers
+#include "BuiltinFft.h"
+
+// System headers
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Largest length whose indices fit the 32-bit bit-reversal table.
+constexpr std::size_t MAX_SIZE = std::size_t{1} << 30;
+
+} // anonymous namespace
+
+BuiltinFft::BuiltinFft(std::size_t size)
+   : _size{supports(size) ? size : 1}
+{
+   const std::size_t n = _size;
+   const auto bits     = static_cast<unsigned>(std::countr_zero(n));
+
+   _bitReverse.resize(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      uint32_t reversed = 0;
+      for (unsigned b = 0; b < bits; ++b)
+      {
+         reversed |= static_cast<uint32_t>((i >> b) & 1U) << (bits - 1 - b);
+      }
+      _bitReverse[i] = reversed;
+   }
+
+   // Pass of half-length h needs exp(-i pi k / h) for k < h.
+   _twiddles.resize(2 * (n > 1 ? n - 1 : 0));
+   for (std::size_t h = 1; h < n; h *= 2)
+   {
+      float* w = _twiddles.data() + (2 * (h - 1));
+      for (std::size_t k = 0; k < h; ++k)
+      {
+         const double angle = -std::numbers::pi * static_cast<double>(k) / static_cast<double>(h);
+         w[2 * k]       = static_cast<float>(std::cos(angle));
+         w[(2 * k) + 1] = static_cast<float>(std::sin(angle));
+      }
+   }
+}
+
+bool BuiltinFft::supports(std::size_t size)
+{
+   return size >= 1 && size <= MAX_SIZE && std::has_single_bit(size);
+}
+
+void BuiltinFft::forward(const float* in, float* out) const
+{
+   const std::size_t n = _size;
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const std::size_t j = _bitReverse[i];
+      out[2 * i]       = in[2 * j];
+      out[(2 * i) + 1] = in[(2 * j) + 1];
+   }
+
+   // h = 1: twiddle 1.
+   for (std::size_t i = 0; i + 1 < n; i += 2)
+   {
+      float* a       = out + (2 * i);
+      const float re = a[2];
+      const float im = a[3];
+      a[2] = a[0] - re;
+      a[3] = a[1] - im;
+      a[0] += re;
+      a[1] += im;
+   }
+
+   // h = 2: twiddles 1 and -i.
+   for (std::size_t i = 0; i + 3 < n; i += 4)
+   {
+      float* a = out + (2 * i);
+      float re = a[4];
+      float im = a[5];
+      a[4] = a[0] - re;
+      a[5] = a[1] - im;
+      a[0] += re;
+      a[1] += im;
+      re   = a[7];    // (-i) * (a6 + i a7) = a7 - i a6
+      im   = -a[6];
+      a[6] = a[2] - re;
+      a[7] = a[3] - im;
+      a[2] += re;
+      a[3] += im;
+   }
+
+   for (std::size_t h = 4; h < n; h *= 2)
+   {
+      const float* w = _twiddles.data() + (2 * (h - 1));
+      for (std::size_t start = 0; start < n; start += 2 * h)
+      {
+         float* lo = out + (2 * start);
+         float* hi = lo + (2 * h);
+         for (std::size_t k = 0; k < h; ++k)
+         {
+            const float wr = w[2 * k];
+            const float wi = w[(2 * k) + 1];
+            const float br = hi[2 * k];
+            const float bi = hi[(2 * k) + 1];
+            const float tr = (br * wr) - (bi * wi);
+            const float ti = (br * wi) + (bi * wr);
+            const float ar = lo[2 * k];
+            const float ai = lo[(2 * k) + 1];
+            hi[2 * k]       = ar - tr;
+            hi[(2 * k) + 1] = ai - ti;
+            lo[2 * k]       = ar + tr;
+            lo[(2 * k) + 1] = ai + ti;
+         }
+      }
+   }
+}
+
+} // namespace SdrEngine
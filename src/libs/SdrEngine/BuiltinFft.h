@@ -0,0 +1,66 @@
+#ifndef BUILTINFFT_H_
+#define BUILTINFFT_H_
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class BuiltinFft
+ * @brief Self-contained forward complex FFT for power-of-two sizes.
+ *
+ * The fallback FFT backend: no third-party library, so it builds wherever
+ * SdrEngine does.  An iterative radix-2 decimation-in-time transform: the
+ * input is copied to the output in bit-reversed order (from a table), then
+ * log2(n) butterfly passes run in place.  Twiddles are computed once in
+ * double precision and stored per pass, so every pass reads them
+ * contiguously; the first two passes need no multiplications at all.
+ *
+ * Same sign convention and scaling as FFTW_FORWARD (unnormalised,
+ * `X[k] = sum x[j] exp(-2 pi i jk / n)`).
+ *
+ * Thread-safety: forward() only reads the tables, so one instance may run
+ * on several threads with separate buffers.
+ */
+class BuiltinFft
+{
+public:
+   /**
+    * @brief Build the tables for one size.
+    * @param size  Transform length; must satisfy supports().
+    */
+   explicit BuiltinFft(std::size_t size);
+
+   /**
+    * @brief Check whether a length can be transformed.
+    * @param size  Transform length.
+    * @return true for powers of two from 1 to 2^30.
+    */
+   [[nodiscard]] static bool supports(std::size_t size);
+
+   /**
+    * @brief Get the transform length.
+    * @return Length in complex samples.
+    */
+   [[nodiscard]] std::size_t size() const { return _size; }
+
+   /**
+    * @brief Forward transform of interleaved complex floats, out of place.
+    * @param in   `size()` complex values (2 * size() floats).
+    * @param out  `size()` complex values; must not overlap `in`.
+    */
+   void forward(const float* in, float* out) const;
+
+private:
+   std::size_t _size;
+   std::vector<uint32_t> _bitReverse;   // Input index of each output slot.
+   std::vector<float> _twiddles;        // Interleaved; pass of half-length h at [2(h-1), 4h - 2).
+};
+
+} // namespace SdrEngine
+
+#endif // BUILTINFFT_H_
@@ -1,6 +1,7 @@
 // Project headers
 #include "ChannelFilter.h"
 #include "GeneralLogger.h"
+#include "Profiler.h"
 
 // Third-party headers
 #include <liquid/liquid.h>
@@ -13,6 +14,112 @@
 namespace SdrEngine
 {
 
+// ============================================================================
+// Stage — one configuration with its liquid-dsp state
+// ============================================================================
+
+struct ChannelFilter::Stage
+{
+   Stage(double centerOffset, double bandwidth, double inputRate);
+   ~Stage();
+
+   Stage(const Stage&) = delete;
+   Stage& operator=(const Stage&) = delete;
+   Stage(Stage&&) = delete;
+   Stage& operator=(Stage&&) = delete;
+
+   void reset();
+
+   const double centerOffsetHz;
+   const double bandwidthHz;
+   const double inputSampleRate;
+   const std::size_t decimation;
+
+   // liquid-dsp objects
+   nco_crcf nco{nullptr};
+   firdecim_crcf decimator{nullptr};
+
+   // Preallocated work buffers.
+   std::vector<IqSample> mixed;     ///< Mixed-down chunk, whole decimation groups.
+   std::vector<IqSample> pending;   ///< Mixed samples of an incomplete group.
+
+   Stage* next{nullptr};   ///< Link in the retired list.
+};
+
+ChannelFilter::Stage::Stage(double centerOffset, double bandwidth, double inputRate)
+   : centerOffsetHz{centerOffset}
+   , bandwidthHz{bandwidth}
+   , inputSampleRate{inputRate}
+   // Largest integer decimation that keeps the output rate >= BW.
+   , decimation{static_cast<std::size_t>(std::max(1.0, std::floor(inputRate / bandwidth)))}
+{
+   // --- NCO: frequency shift ---
+   // Convert offset in Hz to normalised angular frequency (radians/sample).
+   const double normFreq =
+      2.0 * std::numbers::pi * centerOffsetHz / inputSampleRate;
+   nco = nco_crcf_create(LIQUID_NCO);
+   nco_crcf_set_frequency(nco, static_cast<float>(normFreq));
+
+   // --- Decimating FIR low-pass filter ---
+   // Cutoff = half the channel bandwidth, normalised to the input rate.
+   // Use a Kaiser-windowed FIR with 60 dB stop-band attenuation whose length
+   // grows with the decimation, so the transition band stays a fixed share
+   // of the output rate.  Only every decimation-th output is computed.
+   const auto cutoffNorm = static_cast<float>(bandwidthHz / (2.0 * inputSampleRate));
+   constexpr std::size_t FILTER_SEMI_LEN     = 25;   // minimum length = 2*m+1
+   constexpr std::size_t SEMI_LEN_PER_OUTPUT = 8;    // taps/2 per output sample
+   constexpr float STOP_BAND_ATTEN           = 60.0F;   // dB
+
+   const std::size_t taps =
+      (2 * std::max(FILTER_SEMI_LEN, SEMI_LEN_PER_OUTPUT * decimation)) + 1;
+   std::vector<float> h(taps);
+   liquid_firdes_kaiser(static_cast<unsigned int>(taps), cutoffNorm, STOP_BAND_ATTEN,
+                        0.0F,   // fractional sample offset
+                        h.data());
+
+   // Unity DC gain, so the channel keeps the wideband signal's scale.
+   float sum = 0.0F;
+   for (const float tap : h)
+   {
+      sum += tap;
+   }
+   if (sum != 0.0F)
+   {
+      for (float& tap : h)
+      {
+         tap /= sum;
+      }
+   }
+   decimator = firdecim_crcf_create(static_cast<unsigned int>(decimation), h.data(),
+                                    static_cast<unsigned int>(taps));
+
+   // --- Work buffers ---
+   // Mix in chunks that stay resident in L1/L2 between the two passes.
+   constexpr std::size_t MIX_CHUNK_SAMPLES = 2048;
+   mixed.assign(std::max<std::size_t>(1, MIX_CHUNK_SAMPLES / decimation) * decimation,
+                IqSample{0.0F, 0.0F});
+   pending.reserve(decimation);
+}
+
+ChannelFilter::Stage::~Stage()
+{
+   if (nco != nullptr)
+   {
+      nco_crcf_destroy(nco);
+   }
+   if (decimator != nullptr)
+   {
+      firdecim_crcf_destroy(decimator);
+   }
+}
+
+void ChannelFilter::Stage::reset()
+{
+   nco_crcf_reset(nco);
+   firdecim_crcf_reset(decimator);
+   pending.clear();
+}
+
 // ============================================================================
 // Construction / destruction
 // ============================================================================
@@ -21,7 +128,8 @@ ChannelFilter::ChannelFilter() = default;
 
 ChannelFilter::~ChannelFilter()
 {
-   destroyDspObjects();
+   delete _published.exchange(nullptr, std::memory_order_acquire);
+   collectRetired();
 }
 
 // ============================================================================
@@ -31,7 +139,7 @@ ChannelFilter::~ChannelFilter()
 void ChannelFilter::configure(double centerOffsetHz, double bandwidthHz,
                               double inputSampleRate)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
+   const std::lock_guard<std::mutex> lock(_configMutex);
 
    if (bandwidthHz <= 0.0 || inputSampleRate <= 0.0)
    {
@@ -52,23 +160,25 @@ void ChannelFilter::configure(double centerOffsetHz, double bandwidthHz,
       return;
    }
 
-   _centerOffsetHz  = centerOffsetHz;
-   _bandwidthHz     = clampedBw;
-   _inputSampleRate = inputSampleRate;
+   // Build the new state here, off the processing thread, then hand it over.
+   auto stage = std::make_unique<Stage>(centerOffsetHz, clampedBw, inputSampleRate);
+   const double outputRate = inputSampleRate / static_cast<double>(stage->decimation);
+   const std::size_t decimation = stage->decimation;
 
-   // Compute decimation: output rate should be at least the channel BW.
-   // We pick the largest integer decimation that keeps the output rate ≥ BW.
-   const double idealDecimation = inputSampleRate / clampedBw;
-   _decimationRate  = std::max(1.0, std::floor(idealDecimation));
-   _outputSampleRate = inputSampleRate / _decimationRate;
+   _centerOffsetHz   = centerOffsetHz;
+   _bandwidthHz      = clampedBw;
+   _inputSampleRate  = inputSampleRate;
+   _outputSampleRate = outputRate;
 
-   destroyDspObjects();
-   createDspObjects();
+   // A stage process() never picked up is dropped here.
+   const std::unique_ptr<Stage> unused{
+      _published.exchange(stage.release(), std::memory_order_acq_rel)};
    _configured = true;
+   collectRetired();
 
    GPINFO("ChannelFilter configured: offset={:.0f} Hz, bw={:.0f} Hz, "
-          "decim={:.0f}x, output rate={:.0f} Hz",
-          _centerOffsetHz, _bandwidthHz, _decimationRate, _outputSampleRate);
+          "decim={}x, output rate={:.0f} Hz",
+          centerOffsetHz, clampedBw, decimation, outputRate);
 }
 
 void ChannelFilter::configureFromMinMax(double minFreqHz, double maxFreqHz,
@@ -84,19 +194,16 @@ void ChannelFilter::configureFromMinMax(double minFreqHz, double maxFreqHz,
 
 bool ChannelFilter::isConfigured() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _configured;
 }
 
 void ChannelFilter::setEnabled(bool enabled)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    _enabled = enabled;
 }
 
 bool ChannelFilter::isEnabled() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _enabled;
 }
 
@@ -107,49 +214,84 @@ bool ChannelFilter::isEnabled() const
 std::vector<IqSample> ChannelFilter::process(
    const std::vector<IqSample>& input)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
+   std::vector<IqSample> output;
+   process(input, output);
+   return output;
+}
+
+void ChannelFilter::process(std::span<const IqSample> input, std::vector<IqSample>& output)
+{
+   processInto(input, output);
+}
+
+void ChannelFilter::process(std::span<const IqSample> input, std::pmr::vector<IqSample>& output)
+{
+   processInto(input, output);
+}
 
-   if (!_enabled || !_configured || input.empty())
+template <typename Vector>
+void ChannelFilter::processInto(std::span<const IqSample> input, Vector& output)
+{
+   GPPROFILE_SCOPE("ChannelFilter::process");
+   adoptStage();
+
+   output.clear();
+   if (!_enabled.load(std::memory_order_relaxed) || _stage == nullptr || input.empty())
    {
-      return {};
+      return;
    }
 
-   // 1. Frequency-shift: mix down the selected channel to baseband.
-   std::vector<IqSample> shifted(input.size());
-   for (std::size_t i = 0; i < input.size(); ++i)
+   Stage& stage = *_stage;
+   const std::size_t decim = stage.decimation;
+   output.resize((stage.pending.size() + input.size()) / decim);
+   auto* out = reinterpret_cast<liquid_float_complex*>(output.data());
+
+   // liquid's block API takes non-const input pointers but does not write them.
+   auto* in = reinterpret_cast<liquid_float_complex*>(const_cast<IqSample*>(input.data()));
+   std::size_t pos = 0;
+
+   // 1. Complete the group left over from the previous call.
+   if (!stage.pending.empty())
    {
-      liquid_float_complex out;
-      nco_crcf_mix_down(_nco, input[i], &out);
-      nco_crcf_step(_nco);
-      shifted[i] = out;
+      const std::size_t take = std::min(decim - stage.pending.size(), input.size());
+      const std::size_t have = stage.pending.size();
+      stage.pending.resize(have + take);
+      nco_crcf_mix_block_down(stage.nco, in,
+                              reinterpret_cast<liquid_float_complex*>(stage.pending.data() + have),
+                              static_cast<unsigned int>(take));
+      pos = take;
+      if (stage.pending.size() == decim)
+      {
+         firdecim_crcf_execute(stage.decimator,
+                               reinterpret_cast<liquid_float_complex*>(stage.pending.data()),
+                               out++);
+         stage.pending.clear();
+      }
    }
 
-   // 2. Low-pass filter to the channel bandwidth.
-   std::vector<IqSample> filtered(shifted.size());
-   for (std::size_t i = 0; i < shifted.size(); ++i)
+   // 2. Mix down a cache-sized chunk of whole groups, then run the
+   //    decimating FIR over it while it is still hot.
+   const std::size_t chunkGroups = stage.mixed.size() / decim;
+   while (input.size() - pos >= decim)
    {
-      liquid_float_complex out;
-      firfilt_crcf_push(_filter, shifted[i]);
-      firfilt_crcf_execute(_filter, &out);
-      filtered[i] = out;
+      const std::size_t groups = std::min((input.size() - pos) / decim, chunkGroups);
+      const std::size_t count  = groups * decim;
+      auto* mixed = reinterpret_cast<liquid_float_complex*>(stage.mixed.data());
+      nco_crcf_mix_block_down(stage.nco, in + pos, mixed, static_cast<unsigned int>(count));
+      firdecim_crcf_execute_block(stage.decimator, mixed, static_cast<unsigned int>(groups), out);
+      out += groups;
+      pos += count;
    }
 
-   // 3. Decimate (arbitrary-rate resampler).
-   // Maximum possible output length.
-   const auto maxOut = static_cast<std::size_t>(
-      std::ceil(static_cast<double>(filtered.size()) / _decimationRate) + 16);
-   std::vector<IqSample> decimated(maxOut);
-
-   unsigned int numWritten = 0;
-   msresamp_crcf_execute(
-      _resampler,
-      reinterpret_cast<liquid_float_complex*>(filtered.data()),
-      static_cast<unsigned int>(filtered.size()),
-      reinterpret_cast<liquid_float_complex*>(decimated.data()),
-      &numWritten);
-
-   decimated.resize(numWritten);
-   return decimated;
+   // 3. Keep the mixed tail for the next call.
+   if (pos < input.size())
+   {
+      const std::size_t have = stage.pending.size();
+      stage.pending.resize(have + (input.size() - pos));
+      nco_crcf_mix_block_down(stage.nco, in + pos,
+                              reinterpret_cast<liquid_float_complex*>(stage.pending.data() + have),
+                              static_cast<unsigned int>(input.size() - pos));
+   }
 }
 
 // ============================================================================
@@ -158,88 +300,65 @@ std::vector<IqSample> ChannelFilter::process(
 
 double ChannelFilter::getOutputSampleRate() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _outputSampleRate;
 }
 
 double ChannelFilter::getChannelBandwidth() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _bandwidthHz;
 }
 
 double ChannelFilter::getCenterOffset() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _centerOffsetHz;
 }
 
 void ChannelFilter::reset()
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
-   if (_nco != nullptr)
-   {
-      nco_crcf_reset(_nco);
-   }
-   if (_filter != nullptr)
-   {
-      firfilt_crcf_reset(_filter);
-   }
-   if (_resampler != nullptr)
-   {
-      msresamp_crcf_reset(_resampler);
-   }
+   _resetRequested.store(true, std::memory_order_release);
 }
 
 // ============================================================================
 // Internal helpers
 // ============================================================================
 
-void ChannelFilter::destroyDspObjects()
+void ChannelFilter::adoptStage()
 {
-   if (_nco != nullptr)
+   if (_published.load(std::memory_order_relaxed) != nullptr)
    {
-      nco_crcf_destroy(_nco);
-      _nco = nullptr;
+      Stage* next = _published.exchange(nullptr, std::memory_order_acquire);
+      if (next != nullptr)
+      {
+         // Hand the old stage back for configure() to free: no deallocation
+         // (or liquid-dsp teardown) on the processing thread.
+         Stage* old = _stage.release();
+         _stage.reset(next);
+         if (old != nullptr)
+         {
+            old->next = _retired.load(std::memory_order_relaxed);
+            while (!_retired.compare_exchange_weak(old->next, old, std::memory_order_release,
+                                                   std::memory_order_relaxed))
+            {
+            }
+         }
+      }
    }
-   if (_filter != nullptr)
-   {
-      firfilt_crcf_destroy(_filter);
-      _filter = nullptr;
-   }
-   if (_resampler != nullptr)
+
+   if (_resetRequested.load(std::memory_order_relaxed) &&
+       _resetRequested.exchange(false, std::memory_order_acquire) && _stage != nullptr)
    {
-      msresamp_crcf_destroy(_resampler);
-      _resampler = nullptr;
+      _stage->reset();
    }
 }
 
-void ChannelFilter::createDspObjects()
+void ChannelFilter::collectRetired()
 {
-   // --- NCO: frequency shift ---
-   // Convert offset in Hz to normalised angular frequency (radians/sample).
-   const double normFreq =
-      2.0 * std::numbers::pi * _centerOffsetHz / _inputSampleRate;
-   _nco = nco_crcf_create(LIQUID_NCO);
-   nco_crcf_set_frequency(_nco, static_cast<float>(normFreq));
-
-   // --- FIR low-pass filter ---
-   // Cutoff = half the channel bandwidth, normalised to the input rate.
-   // Use a Kaiser-windowed FIR with 60 dB stop-band attenuation.
-   auto cutoffNorm = static_cast<float>(_bandwidthHz / (2.0 * _inputSampleRate));
-   constexpr unsigned int FILTER_SEMI_LEN = 25;  // filter length = 2*m+1
-   constexpr float STOP_BAND_ATTEN = 60.0F;      // dB
-
-   _filter = firfilt_crcf_create_kaiser(
-      (2 * FILTER_SEMI_LEN) + 1,
-      cutoffNorm,
-      STOP_BAND_ATTEN,
-      0.0F);   // fractional sample offset
-
-   // --- Arbitrary-rate resampler (decimator) ---
-   const float resampRate = 1.0F / static_cast<float>(_decimationRate);
-   constexpr float RESAMP_ATTEN = 60.0F;  // stop-band attenuation dB
-   _resampler = msresamp_crcf_create(resampRate, RESAMP_ATTEN);
+   Stage* stage = _retired.exchange(nullptr, std::memory_order_acquire);
+   while (stage != nullptr)
+   {
+      const std::unique_ptr<Stage> owned{stage};
+      stage = owned->next;
+   }
 }
 
 } // namespace SdrEngine
@@ -5,14 +5,14 @@
 #include "SdrTypes.h"
 
 // System headers
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <span>
 #include <vector>
 
-// Forward declarations
-struct nco_crcf_s;
-struct msresamp_crcf_s;
-struct firfilt_crcf_s;
-
 namespace SdrEngine
 {
 /**
@@ -22,10 +22,20 @@ namespace SdrEngine
  *
  * Uses liquid-dsp primitives:
  *   - `nco_crcf`      — Numerically Controlled Oscillator for frequency shift
- *   - `firfilt_crcf`  — FIR low-pass filter (Kaiser window design)
- *   - `msresamp_crcf` — Multi-stage arbitrary-rate resampler for decimation
+ *   - `firdecim_crcf` — Polyphase decimating FIR low-pass (Kaiser window
+ *                       design); only the kept output samples are computed
+ *
+ * Mixing and decimation run back to back over cache-sized chunks, so each
+ * input sample is touched once and the FIR costs `taps / decimation`
+ * multiply-adds per input sample.
  *
- * Thread-safety: all public methods are protected by an internal mutex.
+ * Thread-safety: process() runs on one thread at a time (the processing
+ * thread) and takes no lock.  configure() builds the new liquid-dsp state
+ * on the caller's thread and publishes it with an atomic pointer swap;
+ * process() adopts it at the start of its next call, and the state it
+ * replaces is freed by a later configure() (or the destructor), never on
+ * the processing thread.  setEnabled(), reset() and the getters are atomic
+ * and may be called from any thread.
  */
 class ChannelFilter
 {
@@ -48,7 +58,7 @@ public:
    ChannelFilter(const ChannelFilter&) = delete;
    ChannelFilter& operator=(const ChannelFilter&) = delete;
 
-   // Non-movable (liquid-dsp objects are opaque pointers).
+   // Non-movable (the processing thread owns state published by pointer).
    ChannelFilter(ChannelFilter&&) = delete;
    ChannelFilter& operator=(ChannelFilter&&) = delete;
 
@@ -103,6 +113,28 @@ public:
    [[nodiscard]] std::vector<IqSample> process(
       const std::vector<IqSample>& input);
 
+   /**
+    * @brief Filter a block of wideband I/Q samples into caller storage.
+    *
+    * Allocation-free once `output` has grown to the block's output size.
+    * Input need not be a multiple of the decimation; the remainder is kept
+    * for the next call.
+    *
+    * @param input   Wideband complex I/Q samples at the input sample rate.
+    * @param output  Replaced with the filtered, decimated samples at the
+    *                channel rate; cleared if disabled / not configured.
+    */
+   void process(std::span<const IqSample> input, std::vector<IqSample>& output);
+
+   /**
+    * @brief Same as process(input, output), for a vector backed by the
+    *        caller's memory resource (e.g. a per-frame arena).
+    *
+    * @param input   Wideband complex I/Q samples at the input sample rate.
+    * @param output  Replaced with the filtered, decimated samples.
+    */
+   void process(std::span<const IqSample> input, std::pmr::vector<IqSample>& output);
+
    /**
     * @brief Get the output sample rate after decimation.
     * @return The output sample rate after decimation (Hz).
@@ -123,29 +155,39 @@ public:
 
    /**
     * @brief Reset internal filter state (e.g. after a frequency change).
+    * Applied by the next process() call.
     */
    void reset();
 
 private:
-   void destroyDspObjects();
-   void createDspObjects();
+   struct Stage;   // Configuration and liquid-dsp state built by configure().
+
+   // Shared body of the process() output-vector overloads.
+   template <typename Vector>
+   void processInto(std::span<const IqSample> input, Vector& output);
+
+   // Switch to the stage configure() published, if any, and apply a
+   // requested reset.  Processing thread only.
+   void adoptStage();
+
+   // Free the stages process() has replaced.
+   void collectRetired();
 
-   mutable std::mutex _mutex;
+   std::mutex _configMutex;   ///< Serialises configure(); never taken by process().
 
-   bool _enabled{false};
-   bool _configured{false};
+   std::atomic<bool> _enabled{false};
+   std::atomic<bool> _configured{false};
+   std::atomic<bool> _resetRequested{false};
 
-   // Configuration
-   double _centerOffsetHz{0.0};
-   double _bandwidthHz{0.0};
-   double _inputSampleRate{0.0};
-   double _outputSampleRate{0.0};
-   double _decimationRate{1.0};
+   // Latest configuration, as reported by the getters.
+   std::atomic<double> _centerOffsetHz{0.0};
+   std::atomic<double> _bandwidthHz{0.0};
+   std::atomic<double> _inputSampleRate{0.0};
+   std::atomic<double> _outputSampleRate{0.0};
 
-   // liquid-dsp objects
-   nco_crcf_s* _nco{nullptr};
-   firfilt_crcf_s* _filter{nullptr};
-   msresamp_crcf_s* _resampler{nullptr};
+   std::atomic<Stage*> _published{nullptr};   ///< configure() -> process().
+   std::atomic<Stage*> _retired{nullptr};     ///< process() -> configure(), via Stage::next.
+   std::unique_ptr<Stage> _stage;             ///< Used by process() only.
 };
 
 } // namespace SdrEngine
@@ -0,0 +1,294 @@
+// Project headers
+#include "Channelizer.h"
+#include "FftwPlanner.h"
+#include "GeneralLogger.h"
+
+// Third-party headers
+#include <fftw3.h>
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Kaiser window shape; beta = 7 gives roughly 70 dB stop-band attenuation.
+constexpr double KAISER_BETA = 7.0;
+
+// Zeroth-order modified Bessel function of the first kind (power series).
+double besselI0(double x)
+{
+   double sum  = 1.0;
+   double term = 1.0;
+   const double halfX = x / 2.0;
+   for (int k = 1; k < 50; ++k)
+   {
+      term *= (halfX / k) * (halfX / k);
+      sum += term;
+      if (term < sum * 1.0e-12)
+      {
+         break;
+      }
+   }
+   return sum;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+Channelizer::Channelizer() = default;
+
+Channelizer::~Channelizer()
+{
+   destroyFft();
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void Channelizer::configure(std::size_t numChannels, double inputSampleRate,
+                            std::size_t tapsPerChannel)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+
+   if (numChannels < 2 || numChannels > MAX_CHANNELS || inputSampleRate <= 0.0 ||
+       tapsPerChannel == 0)
+   {
+      GPWARN("Channelizer::configure: invalid parameters "
+             "(channels={}, rate={}, taps/channel={})",
+             numChannels, inputSampleRate, tapsPerChannel);
+      return;
+   }
+
+   // Check if configuration actually changed.
+   if (_configured && _numChannels == numChannels && _inputSampleRate == inputSampleRate &&
+       _tapsPerChannel == tapsPerChannel)
+   {
+      return;
+   }
+
+   _numChannels     = numChannels;
+   _inputSampleRate = inputSampleRate;
+   _tapsPerChannel  = tapsPerChannel;
+   _configured      = false;
+
+   destroyFft();
+   _fftIn  = fftwf_alloc_real(2 * numChannels);
+   _fftOut = fftwf_alloc_real(2 * numChannels);
+   if (_fftIn == nullptr || _fftOut == nullptr)
+   {
+      GPERROR("Channelizer: FFTW allocation failed for {} channels", numChannels);
+      destroyFft();
+      return;
+   }
+   {
+      const std::lock_guard<std::mutex> plannerLock(fftwPlannerMutex());
+      _plan = fftwf_plan_dft_1d(static_cast<int>(numChannels),
+                                reinterpret_cast<fftwf_complex*>(_fftIn),
+                                reinterpret_cast<fftwf_complex*>(_fftOut),
+                                FFTW_BACKWARD, FFTW_MEASURE);
+   }
+   if (_plan == nullptr)
+   {
+      GPERROR("Channelizer: FFTW plan failed for {} channels", numChannels);
+      destroyFft();
+      return;
+   }
+
+   designPrototype();
+   _history.assign(_taps.size() - 1, IqSample{0.0F, 0.0F});
+   _configured = true;
+
+   GPINFO("Channelizer configured: {} channels of {:.0f} Hz, {} taps/channel",
+          _numChannels, _inputSampleRate / static_cast<double>(_numChannels), _tapsPerChannel);
+}
+
+bool Channelizer::isConfigured() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _configured;
+}
+
+void Channelizer::setEnabled(bool enabled)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _enabled = enabled;
+}
+
+bool Channelizer::isEnabled() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _enabled;
+}
+
+std::size_t Channelizer::getChannelCount() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _configured ? _numChannels : 0;
+}
+
+double Channelizer::getOutputSampleRate() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _configured ? _inputSampleRate / static_cast<double>(_numChannels) : 0.0;
+}
+
+double Channelizer::getChannelOffset(std::size_t channel) const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (!_configured)
+   {
+      return 0.0;
+   }
+   const auto half = static_cast<double>(_numChannels / 2);
+   return (static_cast<double>(channel) - half) * _inputSampleRate /
+          static_cast<double>(_numChannels);
+}
+
+std::size_t Channelizer::getTapsPerChannel() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _tapsPerChannel;
+}
+
+void Channelizer::reset()
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (_configured)
+   {
+      _history.assign(_taps.size() - 1, IqSample{0.0F, 0.0F});
+   }
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+void Channelizer::process(std::span<const IqSample> input,
+                          std::vector<std::vector<IqSample>>& channels)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+
+   if (!_enabled || !_configured)
+   {
+      for (auto& channel : channels)
+      {
+         channel.clear();
+      }
+      return;
+   }
+
+   const std::size_t m       = _numChannels;
+   const std::size_t half    = m / 2;
+   const std::size_t histLen = _taps.size() - 1;
+
+   _history.insert(_history.end(), input.begin(), input.end());
+   const std::size_t outputs = (_history.size() - histLen) / m;
+
+   channels.resize(m);
+   for (auto& channel : channels)
+   {
+      channel.resize(outputs);
+   }
+
+   // Channel k of an M-band analysis filterbank decimated by M is
+   //   y_k[n] = sum_r e^{+j2πkr/M} * u_r,  u_r = sum_p h[r + pM] x[nM - r - pM],
+   // i.e. a polyphase partial sum per branch followed by one backward FFT.
+   auto* u = reinterpret_cast<IqSample*>(_fftIn);
+   const auto* y = reinterpret_cast<const IqSample*>(_fftOut);
+   std::size_t newestIndex = histLen + m - 1;
+   for (std::size_t n = 0; n < outputs; ++n, newestIndex += m)
+   {
+      const IqSample* newest = _history.data() + newestIndex;
+      std::fill(u, u + m, IqSample{0.0F, 0.0F});
+      for (std::size_t p = 0; p < _tapsPerChannel; ++p)
+      {
+         const float* h    = _taps.data() + (p * m);
+         const IqSample* x = newest - (p * m);
+         for (std::size_t r = 0; r < m; ++r)
+         {
+            u[r] += h[r] * *(x - r);
+         }
+      }
+
+      fftwf_execute(_plan);
+
+      // FFT bin k is centred at +k·fs/M; channel (k + M/2) mod M orders the
+      // channels from lowest to highest frequency.
+      for (std::size_t k = 0; k < m; ++k)
+      {
+         channels[(k + half) % m][n] = y[k];
+      }
+   }
+
+   // Keep the last taps-1 consumed samples plus any partial block.
+   const std::size_t consumed = outputs * m;
+   _history.erase(_history.begin(), _history.begin() + static_cast<std::ptrdiff_t>(consumed));
+}
+
+// ============================================================================
+// Internal helpers
+// ============================================================================
+
+void Channelizer::designPrototype()
+{
+   const std::size_t len = _numChannels * _tapsPerChannel;
+   _taps.resize(len);
+
+   // Windowed sinc, cutoff fs / 2M (cycles / sample = 0.5 / M).
+   const double cutoff = 0.5 / static_cast<double>(_numChannels);
+   const double centre = static_cast<double>(len - 1) / 2.0;
+   const double i0Beta = besselI0(KAISER_BETA);
+   double sum = 0.0;
+   std::vector<double> taps(len);
+   for (std::size_t i = 0; i < len; ++i)
+   {
+      const double t    = static_cast<double>(i) - centre;
+      const double arg  = 2.0 * cutoff * t;
+      const double sinc = (t == 0.0) ? 1.0
+                                     : std::sin(std::numbers::pi * arg) / (std::numbers::pi * arg);
+      const double ratio  = (len > 1) ? (2.0 * static_cast<double>(i) / static_cast<double>(len - 1)) - 1.0
+                                      : 0.0;
+      const double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - (ratio * ratio)))) /
+                            i0Beta;
+      taps[i] = sinc * window;
+      sum += taps[i];
+   }
+
+   // Unity DC gain: a tone at a channel centre keeps its amplitude.
+   for (std::size_t i = 0; i < len; ++i)
+   {
+      _taps[i] = static_cast<float>(taps[i] / sum);
+   }
+}
+
+void Channelizer::destroyFft()
+{
+   if (_plan != nullptr)
+   {
+      const std::lock_guard<std::mutex> plannerLock(fftwPlannerMutex());
+      fftwf_destroy_plan(_plan);
+      _plan = nullptr;
+   }
+   if (_fftIn != nullptr)
+   {
+      fftwf_free(_fftIn);
+      _fftIn = nullptr;
+   }
+   if (_fftOut != nullptr)
+   {
+      fftwf_free(_fftOut);
+      _fftOut = nullptr;
+   }
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,154 @@
+#ifndef CHANNELIZER_H_
+#define CHANNELIZER_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <vector>
+
+// Forward declaration — avoids exposing fftw3.h in the header.
+struct fftwf_plan_s;
+
+namespace SdrEngine
+{
+
+/**
+ * @class Channelizer
+ * @brief Splits a wideband I/Q stream into M evenly spaced, decimated
+ *        channels with a critically sampled polyphase FFT filterbank.
+ *
+ * Channel `c` is centred `(c - M/2) * fs / M` from the wideband centre and
+ * runs at `fs / M`, so channel M/2 is the DC channel and the channels are
+ * ordered from lowest to highest frequency, like a DC-centred spectrum.
+ *
+ * Every M input samples cost one M-point FFT plus `tapsPerChannel`
+ * multiply-adds per input sample — independent of how many channels are
+ * consumed, unlike running one ChannelFilter per channel at full rate.
+ *
+ * The prototype low-pass is a Kaiser-windowed sinc with cutoff `fs / 2M`
+ * and unity DC gain, `M * tapsPerChannel` taps long.
+ *
+ * Thread-safety: all public methods are protected by an internal mutex.
+ */
+class Channelizer
+{
+public:
+   /** @brief Default prototype filter taps per polyphase branch. */
+   static constexpr std::size_t DEFAULT_TAPS_PER_CHANNEL = 12;
+
+   /** @brief Largest accepted channel count. */
+   static constexpr std::size_t MAX_CHANNELS = 4096;
+
+   /** @brief Construct an unconfigured, disabled Channelizer. */
+   Channelizer();
+
+   /** @brief Destroy the Channelizer and release FFTW resources. */
+   ~Channelizer();
+
+   // Non-copyable.
+   Channelizer(const Channelizer&) = delete;
+   Channelizer& operator=(const Channelizer&) = delete;
+
+   // Non-movable (owns FFTW plan / buffers).
+   Channelizer(Channelizer&&) = delete;
+   Channelizer& operator=(Channelizer&&) = delete;
+
+   /**
+    * @brief Configure the filterbank.  Resets the filter history.
+    *
+    * @param numChannels      Number of channels M (2 .. MAX_CHANNELS).
+    * @param inputSampleRate  Wideband sample rate in Hz.
+    * @param tapsPerChannel   Prototype taps per branch (>= 1); more taps
+    *                         give sharper channel edges at linear cost.
+    */
+   void configure(std::size_t numChannels, double inputSampleRate,
+                  std::size_t tapsPerChannel = DEFAULT_TAPS_PER_CHANNEL);
+
+   /**
+    * @brief Check if the filterbank has been configured.
+    * @return true if configure() has been called with valid parameters.
+    */
+   [[nodiscard]] bool isConfigured() const;
+
+   /**
+    * @brief Enable or disable the channelizer.
+    * When disabled, process() produces no output.
+    */
+   void setEnabled(bool enabled);
+
+   /**
+    * @brief Check if the channelizer is enabled.
+    * @return true if the channelizer is enabled.
+    */
+   [[nodiscard]] bool isEnabled() const;
+
+   /**
+    * @brief Channelize a block of wideband I/Q samples.
+    *
+    * Input need not be a multiple of M; leftover samples are kept for the
+    * next call, so output is continuous across blocks.
+    *
+    * @param input     Wideband complex I/Q samples at the input sample rate.
+    * @param channels  Resized to M; `channels[c]` receives channel c's new
+    *                  samples (existing capacity is reused).  All channels
+    *                  are cleared when disabled / not configured.
+    */
+   void process(std::span<const IqSample> input, std::vector<std::vector<IqSample>>& channels);
+
+   /**
+    * @brief Get the number of channels.
+    * @return M, or 0 if not configured.
+    */
+   [[nodiscard]] std::size_t getChannelCount() const;
+
+   /**
+    * @brief Get the per-channel output sample rate.
+    * @return Input rate / M (Hz), or 0 if not configured.
+    */
+   [[nodiscard]] double getOutputSampleRate() const;
+
+   /**
+    * @brief Get the centre-frequency offset of a channel.
+    * @return `(channel - M/2) * fs / M` in Hz.
+    */
+   [[nodiscard]] double getChannelOffset(std::size_t channel) const;
+
+   /**
+    * @brief Get the configured prototype taps per branch.
+    * @return Taps per polyphase branch.
+    */
+   [[nodiscard]] std::size_t getTapsPerChannel() const;
+
+   /** @brief Clear the filter history (e.g. after retuning). */
+   void reset();
+
+private:
+   void destroyFft();
+   void designPrototype();
+
+   mutable std::mutex _mutex;
+
+   bool _enabled{false};
+   bool _configured{false};
+
+   // Configuration
+   std::size_t _numChannels{0};
+   std::size_t _tapsPerChannel{DEFAULT_TAPS_PER_CHANNEL};
+   double _inputSampleRate{0.0};
+
+   std::vector<float> _taps;         ///< Prototype, M * tapsPerChannel long.
+   std::vector<IqSample> _history;   ///< Last taps-1 inputs + unconsumed samples.
+
+   // FFTW M-point backward transform (interleaved complex buffers).
+   float* _fftIn{nullptr};
+   float* _fftOut{nullptr};
+   fftwf_plan_s* _plan{nullptr};
+};
+
+} // namespace SdrEngine
+
+#endif // CHANNELIZER_H_
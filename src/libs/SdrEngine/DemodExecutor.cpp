@@ -0,0 +1,316 @@
+// Project headers
+#include "DemodExecutor.h"
+
+// System headers
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// DemodChannel
+// ============================================================================
+
+DemodChannel::DemodChannel(int id, std::size_t queueDepth)
+   : _id{id}
+   , _queueDepth{std::max<std::size_t>(queueDepth, 1)}
+   , _audioHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>>()}
+{
+}
+
+DemodChannel::~DemodChannel()
+{
+   // Stop the listener thread before the pool its frames return to.
+   _audioHandler.reset();
+}
+
+int DemodChannel::getId() const
+{
+   return _id;
+}
+
+void DemodChannel::configure(DemodMode mode, double inputSampleRate, double audioSampleRate)
+{
+   _demod.configure(mode, inputSampleRate, audioSampleRate);
+}
+
+DemodMode DemodChannel::getMode() const
+{
+   return _demod.getMode();
+}
+
+double DemodChannel::getAudioSampleRate() const
+{
+   return _demod.getAudioSampleRate();
+}
+
+void DemodChannel::reset()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_queueMutex);
+      _pending.clear();
+   }
+   _demod.reset();
+}
+
+DemodChannelStats DemodChannel::getStats() const
+{
+   DemodChannelStats stats;
+   stats.submitted = _submitted.load(std::memory_order_relaxed);
+   stats.processed = _processed.load(std::memory_order_relaxed);
+   stats.dropped   = _dropped.load(std::memory_order_relaxed);
+   stats.busyNs    = _busyNs.load(std::memory_order_relaxed);
+   const std::lock_guard<std::mutex> lock(_queueMutex);
+   stats.queueDepth = _pending.size();
+   return stats;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>& DemodChannel::audioDataHandler()
+{
+   return *_audioHandler;
+}
+
+bool DemodChannel::enqueue(std::shared_ptr<const IqBuffer> block)
+{
+   _submitted.fetch_add(1, std::memory_order_relaxed);
+   const std::lock_guard<std::mutex> lock(_queueMutex);
+   while (_pending.size() >= _queueDepth)
+   {
+      _pending.pop_front();
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+   }
+   _pending.push_back(std::move(block));
+   if (_scheduled)
+   {
+      return false;
+   }
+   _scheduled = true;
+   return true;
+}
+
+bool DemodChannel::drain(std::size_t maxBlocks)
+{
+   for (std::size_t i = 0; i < maxBlocks; ++i)
+   {
+      std::shared_ptr<const IqBuffer> block;
+      {
+         const std::lock_guard<std::mutex> lock(_queueMutex);
+         if (_pending.empty())
+         {
+            _scheduled = false;
+            return false;
+         }
+         block = std::move(_pending.front());
+         _pending.pop_front();
+      }
+
+      const auto began = std::chrono::steady_clock::now();
+      auto audio = _audioPool.acquire();
+      _demod.demodulateInto(block->samples, *audio);
+      audio->sourceTime = block->sourceTime();
+      if (!audio->left.empty())
+      {
+         _audioHandler->signalData(std::move(audio));
+      }
+      _processed.fetch_add(1, std::memory_order_relaxed);
+      _busyNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 std::chrono::steady_clock::now() - began)
+                                                 .count()),
+                        std::memory_order_relaxed);
+   }
+
+   // Turn used up: stay scheduled only if more blocks are waiting.
+   const std::lock_guard<std::mutex> lock(_queueMutex);
+   _scheduled = !_pending.empty();
+   return _scheduled;
+}
+
+// ============================================================================
+// DemodExecutor — construction / destruction
+// ============================================================================
+
+DemodExecutor::DemodExecutor(std::size_t workers)
+{
+   if (workers == 0)
+   {
+      workers = defaultWorkerCount();
+   }
+   _queues.reserve(workers);
+   for (std::size_t i = 0; i < workers; ++i)
+   {
+      _queues.push_back(std::make_unique<WorkerQueue>());
+   }
+   _threads.reserve(workers);
+   for (std::size_t i = 0; i < workers; ++i)
+   {
+      _threads.emplace_back(&DemodExecutor::workerLoop, this, i);
+   }
+}
+
+DemodExecutor::~DemodExecutor()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_wakeMutex);
+      _stopping = true;
+   }
+   _wake.notify_all();
+   for (auto& thread : _threads)
+   {
+      thread.join();
+   }
+}
+
+std::size_t DemodExecutor::workerCount() const
+{
+   return _threads.size();
+}
+
+uint64_t DemodExecutor::getStealCount() const
+{
+   return _steals.load(std::memory_order_relaxed);
+}
+
+std::size_t DemodExecutor::defaultWorkerCount()
+{
+   return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+// ============================================================================
+// Channels
+// ============================================================================
+
+int DemodExecutor::addChannel(DemodMode mode, double inputSampleRate, double audioSampleRate,
+                              std::size_t queueDepth)
+{
+   const std::lock_guard<std::mutex> lock(_channelMutex);
+   const int id    = _nextChannelId++;
+   auto newChannel = std::make_shared<DemodChannel>(id, queueDepth);
+   newChannel->configure(mode, inputSampleRate, audioSampleRate);
+   _channels.push_back(std::move(newChannel));
+   return id;
+}
+
+bool DemodExecutor::removeChannel(int id)
+{
+   const std::lock_guard<std::mutex> lock(_channelMutex);
+   const auto it = std::find_if(_channels.begin(), _channels.end(),
+                                [id](const auto& c) { return c->getId() == id; });
+   if (it == _channels.end())
+   {
+      return false;
+   }
+   _channels.erase(it);
+   return true;
+}
+
+std::shared_ptr<DemodChannel> DemodExecutor::channel(int id) const
+{
+   const std::lock_guard<std::mutex> lock(_channelMutex);
+   const auto it = std::find_if(_channels.begin(), _channels.end(),
+                                [id](const auto& c) { return c->getId() == id; });
+   return (it == _channels.end()) ? nullptr : *it;
+}
+
+std::size_t DemodExecutor::getChannelCount() const
+{
+   const std::lock_guard<std::mutex> lock(_channelMutex);
+   return _channels.size();
+}
+
+bool DemodExecutor::submit(int id, std::shared_ptr<const IqBuffer> block)
+{
+   auto target = channel(id);
+   if (!target)
+   {
+      return false;
+   }
+   if (target->enqueue(std::move(block)))
+   {
+      // Channels start on a fixed home worker; stealing rebalances.
+      const auto home = static_cast<std::size_t>(id) % _queues.size();
+      schedule(std::move(target), home);
+   }
+   return true;
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+void DemodExecutor::schedule(std::shared_ptr<DemodChannel> channel, std::size_t worker)
+{
+   {
+      // Count and push together, so takeTask() never sees a task that
+      // has not been counted yet.
+      const std::lock_guard<std::mutex> wakeLock(_wakeMutex);
+      const std::lock_guard<std::mutex> lock(_queues[worker]->mutex);
+      _queues[worker]->tasks.push_back(std::move(channel));
+      ++_queuedTasks;
+   }
+   _wake.notify_one();
+}
+
+std::shared_ptr<DemodChannel> DemodExecutor::takeTask(std::size_t self)
+{
+   std::shared_ptr<DemodChannel> task;
+   {
+      WorkerQueue& own = *_queues[self];
+      const std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty())
+      {
+         task = std::move(own.tasks.front());
+         own.tasks.pop_front();
+      }
+   }
+   for (std::size_t i = 1; !task && i < _queues.size(); ++i)
+   {
+      WorkerQueue& victim = *_queues[(self + i) % _queues.size()];
+      const std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty())
+      {
+         task = std::move(victim.tasks.back());
+         victim.tasks.pop_back();
+         _steals.fetch_add(1, std::memory_order_relaxed);
+      }
+   }
+
+   if (task)
+   {
+      const std::lock_guard<std::mutex> lock(_wakeMutex);
+      --_queuedTasks;
+   }
+   return task;
+}
+
+void DemodExecutor::workerLoop(std::size_t self)
+{
+   while (true)
+   {
+      auto task = takeTask(self);
+      if (!task)
+      {
+         std::unique_lock<std::mutex> lock(_wakeMutex);
+         _wake.wait(lock, [this] { return _stopping || _queuedTasks > 0; });
+         if (_stopping)
+         {
+            return;
+         }
+         continue;
+      }
+
+      if (_stopping.load(std::memory_order_relaxed))
+      {
+         return;
+      }
+
+      if (task->drain(BLOCKS_PER_TURN))
+      {
+         // Back of our own deque: other channels get a turn first.
+         schedule(std::move(task), self);
+      }
+   }
+}
+
+} // namespace SdrEngine
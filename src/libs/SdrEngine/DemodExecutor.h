@@ -0,0 +1,268 @@
+#ifndef DEMODEXECUTOR_H_
+#define DEMODEXECUTOR_H_
+
+// Project headers
+#include "DataHandler.h"
+#include "Demodulator.h"
+#include "FramePool.h"
+#include "SdrTypes.h"
+
+// System headers
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class DemodChannelStats
+ * @brief Snapshot of one DemodChannel's counters.
+ */
+struct DemodChannelStats
+{
+   uint64_t submitted{0};      ///< Blocks accepted by DemodExecutor::submit().
+   uint64_t processed{0};      ///< Blocks demodulated.
+   uint64_t dropped{0};        ///< Oldest blocks discarded because the queue was full.
+   uint64_t busyNs{0};         ///< Total time spent demodulating.
+   std::size_t queueDepth{0};  ///< Blocks waiting to be demodulated.
+};
+
+/**
+ * @class DemodChannel
+ * @brief One audio channel run by DemodExecutor: a Demodulator, its queue
+ *        of pending I/Q blocks and the DataHandler its audio is published on.
+ *
+ * Blocks are demodulated in submission order, by one worker at a time.
+ *
+ * Thread-safety: every public method may be called from any thread.
+ */
+class DemodChannel
+{
+public:
+   /**
+    * @brief Construct an unconfigured channel.
+    * @param id          Executor-assigned identifier.
+    * @param queueDepth  Pending blocks kept before the oldest is dropped.
+    */
+   DemodChannel(int id, std::size_t queueDepth);
+
+   /** @brief Destroy the channel; its DataHandler stops first. */
+   ~DemodChannel();
+
+   // Non-copyable, non-movable (owns DSP objects and a handler).
+   DemodChannel(const DemodChannel&) = delete;
+   DemodChannel& operator=(const DemodChannel&) = delete;
+   DemodChannel(DemodChannel&&) = delete;
+   DemodChannel& operator=(DemodChannel&&) = delete;
+
+   /**
+    * @brief Get the executor-assigned identifier.
+    * @return Channel id.
+    */
+   [[nodiscard]] int getId() const;
+
+   /**
+    * @brief (Re)configure the demodulator; see Demodulator::configure().
+    * @param mode             Demodulation mode.
+    * @param inputSampleRate  I/Q sample rate of the submitted blocks (Hz).
+    * @param audioSampleRate  Audio output rate (Hz).
+    */
+   void configure(DemodMode mode, double inputSampleRate,
+                  double audioSampleRate = Demodulator::DEFAULT_AUDIO_RATE);
+
+   /**
+    * @brief Get the demodulation mode.
+    * @return Mode set by configure().
+    */
+   [[nodiscard]] DemodMode getMode() const;
+
+   /**
+    * @brief Get the audio output sample rate.
+    * @return Audio rate in Hz.
+    */
+   [[nodiscard]] double getAudioSampleRate() const;
+
+   /** @brief Discard pending blocks and reset the demodulator state. */
+   void reset();
+
+   /**
+    * @brief Get the channel's counters.
+    * @return Counter snapshot.
+    */
+   [[nodiscard]] DemodChannelStats getStats() const;
+
+   /** @brief DataHandler that publishes this channel's audio, in order. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>& audioDataHandler();
+
+private:
+   friend class DemodExecutor;
+
+   // Queue a block.  Returns true if the channel must be scheduled (it was
+   // idle); a full queue drops its oldest block.
+   bool enqueue(std::shared_ptr<const IqBuffer> block);
+
+   // Demodulate up to maxBlocks queued blocks in order.  Returns true if
+   // blocks remain and the channel must be scheduled again.
+   bool drain(std::size_t maxBlocks);
+
+   const int _id;
+   const std::size_t _queueDepth;
+
+   mutable std::mutex _queueMutex;
+   std::deque<std::shared_ptr<const IqBuffer>> _pending;   // Guarded by _queueMutex.
+   bool _scheduled{false};                                  // Guarded by _queueMutex.
+
+   Demodulator _demod;
+
+   std::atomic<uint64_t> _submitted{0};
+   std::atomic<uint64_t> _processed{0};
+   std::atomic<uint64_t> _dropped{0};
+   std::atomic<uint64_t> _busyNs{0};
+
+   // Only the worker currently draining the channel touches the pool.
+   static constexpr std::size_t FRAME_POOL_DEPTH = 16;
+   FramePool<DemodAudio> _audioPool{FRAME_POOL_DEPTH};
+
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>> _audioHandler;
+};
+
+/**
+ * @class DemodExecutor
+ * @brief Runs many Demodulator instances concurrently on a work-stealing
+ *        thread pool.
+ *
+ * Each channel is added with addChannel() and fed with submit(), which only
+ * queues the block, so a DataHandler listener can hand off demodulation
+ * without holding up the other listeners.  A channel with queued blocks is
+ * placed on one worker's deque as a single task; the worker demodulates a
+ * few of its blocks in order and re-queues it if more are waiting.  Idle
+ * workers steal tasks from the back of the other deques, so ten or more
+ * channels spread over every core.  A channel is never on two deques at
+ * once, which keeps its audio in submission order.
+ *
+ * Thread-safety: every public method may be called from any thread.
+ */
+class DemodExecutor
+{
+public:
+   /// Pending blocks per channel before the oldest is dropped.
+   static constexpr std::size_t DEFAULT_QUEUE_DEPTH = 32;
+
+   /// Blocks a worker demodulates from one channel before moving on.
+   static constexpr std::size_t BLOCKS_PER_TURN = 4;
+
+   /**
+    * @brief Start the worker threads.
+    * @param workers  Number of threads (0 = defaultWorkerCount()).
+    */
+   explicit DemodExecutor(std::size_t workers = 0);
+
+   /** @brief Stop the workers; queued blocks are discarded. */
+   ~DemodExecutor();
+
+   // Non-copyable, non-movable (workers hold `this`).
+   DemodExecutor(const DemodExecutor&) = delete;
+   DemodExecutor& operator=(const DemodExecutor&) = delete;
+   DemodExecutor(DemodExecutor&&) = delete;
+   DemodExecutor& operator=(DemodExecutor&&) = delete;
+
+   /**
+    * @brief Add a demodulation channel.
+    * @param mode             Demodulation mode.
+    * @param inputSampleRate  I/Q sample rate of the blocks to be submitted (Hz).
+    * @param audioSampleRate  Audio output rate (Hz).
+    * @param queueDepth       Pending blocks kept before the oldest is dropped.
+    * @return The new channel's id.
+    */
+   int addChannel(DemodMode mode, double inputSampleRate,
+                  double audioSampleRate = Demodulator::DEFAULT_AUDIO_RATE,
+                  std::size_t queueDepth = DEFAULT_QUEUE_DEPTH);
+
+   /**
+    * @brief Remove a channel.  A block being demodulated still finishes.
+    * @param id  Channel id returned by addChannel().
+    * @return true if the channel existed.
+    */
+   bool removeChannel(int id);
+
+   /**
+    * @brief Look up a channel to reconfigure it or register listeners.
+    * @param id  Channel id returned by addChannel().
+    * @return The channel, or nullptr if no channel has that id.
+    */
+   [[nodiscard]] std::shared_ptr<DemodChannel> channel(int id) const;
+
+   /**
+    * @brief Get the number of channels.
+    * @return Channel count.
+    */
+   [[nodiscard]] std::size_t getChannelCount() const;
+
+   /**
+    * @brief Queue an I/Q block for a channel; never blocks on demodulation.
+    * @param id     Channel id returned by addChannel().
+    * @param block  Block at the channel's input rate.
+    * @return false if no channel has that id.
+    */
+   bool submit(int id, std::shared_ptr<const IqBuffer> block);
+
+   /**
+    * @brief Get the number of worker threads.
+    * @return Worker threads.
+    */
+   [[nodiscard]] std::size_t workerCount() const;
+
+   /**
+    * @brief Get how many tasks were taken from another worker's deque.
+    * @return Steal count since construction.
+    */
+   [[nodiscard]] uint64_t getStealCount() const;
+
+   /**
+    * @brief Worker count that uses every hardware thread.
+    * @return `hardware_concurrency()`, at least 1.
+    */
+   [[nodiscard]] static std::size_t defaultWorkerCount();
+
+private:
+   /// One worker's task deque: owner pops the front, thieves the back.
+   struct WorkerQueue
+   {
+      std::mutex mutex;
+      std::deque<std::shared_ptr<DemodChannel>> tasks;
+   };
+
+   void workerLoop(std::size_t self);
+
+   // Put a channel on a worker's deque and wake a worker.
+   void schedule(std::shared_ptr<DemodChannel> channel, std::size_t worker);
+
+   // Take the next task: own deque first, then steal.  nullptr if none.
+   [[nodiscard]] std::shared_ptr<DemodChannel> takeTask(std::size_t self);
+
+   mutable std::mutex _channelMutex;
+   std::vector<std::shared_ptr<DemodChannel>> _channels;   // Guarded by _channelMutex.
+   int _nextChannelId{0};                                   // Guarded by _channelMutex.
+
+   std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+   std::mutex _wakeMutex;
+   std::condition_variable _wake;
+   std::size_t _queuedTasks{0};          // Guarded by _wakeMutex.
+   std::atomic<bool> _stopping{false};   // Written under _wakeMutex.
+
+   std::atomic<uint64_t> _steals{0};
+
+   std::vector<std::thread> _threads;
+};
+
+} // namespace SdrEngine
+
+#endif // DEMODEXECUTOR_H_
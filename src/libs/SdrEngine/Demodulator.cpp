@@ -7,8 +7,8 @@
 
 // System headers
 #include <cmath>
+#include <algorithm>
 #include <cstddef>
-#include <numbers>
 
 namespace SdrEngine
 {
@@ -29,7 +29,7 @@ Demodulator::~Demodulator()
 // ============================================================================
 
 void Demodulator::configure(DemodMode mode, double inputSampleRate,
-                            double audioSampleRate)
+                            double audioSampleRate, size_t maxBlockSamples)
 {
    const std::lock_guard lock(_mutex);
 
@@ -45,6 +45,7 @@ void Demodulator::configure(DemodMode mode, double inputSampleRate,
    _audioSampleRate = audioSampleRate;
 
    destroyDspObjects();
+   reserveScratch(maxBlockSamples);
 
    switch (_mode)
    {
@@ -81,15 +82,83 @@ DemodMode Demodulator::getMode() const
 // ============================================================================
 
 DemodAudio Demodulator::demodulate(const std::vector<IqSample>& iqSamples)
+{
+   DemodAudio result;
+   demodulateInto(iqSamples, result);
+   return result;
+}
+
+size_t Demodulator::demodulateInto(std::span<const IqSample> iqSamples,
+                                   std::span<float> interleaved)
+{
+   const std::lock_guard lock(_mutex);
+
+   if (!_configured || iqSamples.empty())
+   {
+      return 0;
+   }
+   if (interleaved.size() < 2 * outputBound(iqSamples.size()))
+   {
+      GPWARN("Demodulator::demodulateInto: output holds {} floats, need {}",
+             interleaved.size(), 2 * outputBound(iqSamples.size()));
+      return 0;
+   }
+
+   const BlockAudio block = demodulateBlock(iqSamples);
+   for (size_t i = 0; i < block.frames; ++i)
+   {
+      interleaved[2 * i] = block.left[i];
+      interleaved[(2 * i) + 1] = block.right[i];
+   }
+   return block.frames;
+}
+
+size_t Demodulator::demodulateInto(std::span<const IqSample> iqSamples,
+                                   DemodAudio& audio)
+{
+   return demodulateChannels(iqSamples, audio.left, audio.right);
+}
+
+size_t Demodulator::demodulateInto(std::span<const IqSample> iqSamples,
+                                   std::pmr::vector<float>& left,
+                                   std::pmr::vector<float>& right)
+{
+   return demodulateChannels(iqSamples, left, right);
+}
+
+template <typename Vector>
+size_t Demodulator::demodulateChannels(std::span<const IqSample> iqSamples,
+                                       Vector& left, Vector& right)
 {
    const std::lock_guard lock(_mutex);
 
+   left.clear();
+   right.clear();
    if (!_configured || iqSamples.empty())
    {
-      return {};
+      return 0;
    }
 
+   const BlockAudio block = demodulateBlock(iqSamples);
+   left.assign(block.left, block.left + block.frames);
+   right.assign(block.right, block.right + block.frames);
+   return block.frames;
+}
+
+size_t Demodulator::maxOutputFrames(size_t numInputSamples) const
+{
+   const std::lock_guard lock(_mutex);
+   return outputBound(numInputSamples);
+}
+
+Demodulator::BlockAudio Demodulator::demodulateBlock(
+   std::span<const IqSample> iqSamples)
+{
+   reserveScratch(iqSamples.size());
+
    const auto numIn = static_cast<unsigned int>(iqSamples.size());
+   float* baseband = _basebandL.data();
+   BlockAudio block;
 
    switch (_mode)
    {
@@ -104,13 +173,12 @@ DemodAudio Demodulator::demodulate(const std::vector<IqSample>& iqSamples)
          }
 
          // FM discriminator.
-         std::vector<float> baseband(numIn);
          freqdem_demodulate_block(
             _fmDemod,
             const_cast<liquid_float_complex*>(
                reinterpret_cast<const liquid_float_complex*>(
                   iqSamples.data())),
-            numIn, baseband.data());
+            numIn, baseband);
 
          // De-emphasis.
          if (_deemphasisL != nullptr)
@@ -123,13 +191,11 @@ DemodAudio Demodulator::demodulate(const std::vector<IqSample>& iqSamples)
             }
          }
 
-         // Resample.
-         auto audio = resample(baseband);
-
-         DemodAudio result;
-         result.right = audio;    // copy for stereo output
-         result.left = std::move(audio);
-         return result;
+         // Resample; both channels carry the same data.
+         block.left = resample(_resamplerL, baseband, numIn,
+                               _audioL.data(), block.frames);
+         block.right = block.left;
+         return block;
       }
 
       // ---------------------------------------------------------------
@@ -142,64 +208,54 @@ DemodAudio Demodulator::demodulate(const std::vector<IqSample>& iqSamples)
             return {};
          }
 
-         // FM discriminator → composite MPX signal.
-         std::vector<float> composite(numIn);
+         // FM discriminator → composite MPX signal, decoded in place
+         // into left (over the composite) and right at the decimated
+         // rate.  Without a decoder both channels carry the composite.
          freqdem_demodulate_block(
             _fmDemod,
             const_cast<liquid_float_complex*>(
                reinterpret_cast<const liquid_float_complex*>(
                   iqSamples.data())),
-            numIn, composite.data());
-
-         // Stereo decode.
-         std::vector<float> leftBaseband;
-         std::vector<float> rightBaseband;
-         stereoDecodeBlock(composite.data(), numIn,
-                           leftBaseband, rightBaseband);
+            numIn, baseband);
+         float* right = _basebandR.data();
+         size_t decoded = numIn;
+         if (_stereoDecoder.isConfigured())
+         {
+            decoded = _stereoDecoder.process(baseband, baseband, right, numIn);
+         }
+         else
+         {
+            std::copy(baseband, baseband + numIn, right);
+         }
 
-         // De-emphasis on each channel.
+         // De-emphasis on each channel, after decimation.
          if (_deemphasisL != nullptr)
          {
-            for (float & i : leftBaseband)
+            for (size_t i = 0; i < decoded; ++i)
             {
                float out = 0.0F;
-               iirfilt_rrrf_execute(_deemphasisL, i, &out);
-               i = out;
+               iirfilt_rrrf_execute(_deemphasisL, baseband[i], &out);
+               baseband[i] = out;
             }
          }
          if (_deemphasisR != nullptr)
          {
-            for (float & i : rightBaseband)
+            for (size_t i = 0; i < decoded; ++i)
             {
                float out = 0.0F;
-               iirfilt_rrrf_execute(_deemphasisR, i, &out);
-               i = out;
+               iirfilt_rrrf_execute(_deemphasisR, right[i], &out);
+               right[i] = out;
             }
          }
 
          // Resample each channel separately.
-         DemodAudio result;
-         result.left = resample(leftBaseband);
-         // For the right channel, use _resamplerR directly.
-         if (_resamplerR != nullptr)
-         {
-            auto numR = static_cast<unsigned int>(rightBaseband.size());
-            auto ratio =
-               static_cast<float>(_audioSampleRate / _inputSampleRate);
-            const auto maxOut =
-               static_cast<size_t>((static_cast<float>(numR) * ratio) + 64);
-            result.right.resize(maxOut);
-            unsigned int numWritten = 0;
-            msresamp_rrrf_execute(_resamplerR,
-                                 rightBaseband.data(), numR,
-                                 result.right.data(), &numWritten);
-            result.right.resize(numWritten);
-         }
-         else
-         {
-            result.right = std::move(rightBaseband);
-         }
-         return result;
+         size_t framesR = 0;
+         block.left = resample(_resamplerL, baseband, decoded,
+                               _audioL.data(), block.frames);
+         block.right = resample(_resamplerR, right, decoded,
+                                _audioR.data(), framesR);
+         block.frames = std::min(block.frames, framesR);
+         return block;
       }
 
       // ---------------------------------------------------------------
@@ -213,7 +269,6 @@ DemodAudio Demodulator::demodulate(const std::vector<IqSample>& iqSamples)
          }
 
          // Envelope detection sample-by-sample.
-         std::vector<float> baseband(numIn);
          for (unsigned int i = 0; i < numIn; ++i)
          {
             liquid_float_complex sample;
@@ -233,13 +288,11 @@ DemodAudio Demodulator::demodulate(const std::vector<IqSample>& iqSamples)
             }
          }
 
-         // Resample.
-         auto audio = resample(baseband);
-
-         DemodAudio result;
-         result.right = audio;
-         result.left = std::move(audio);
-         return result;
+         // Resample; both channels carry the same data.
+         block.left = resample(_resamplerL, baseband, numIn,
+                               _audioL.data(), block.frames);
+         block.right = block.left;
+         return block;
       }
    }
 
@@ -305,28 +358,6 @@ void Demodulator::destroyDspObjects()
       _deemphasisR = nullptr;
    }
 
-   // Stereo
-   if (_pilotBpf != nullptr)
-   {
-      firfilt_rrrf_destroy(_pilotBpf);
-      _pilotBpf = nullptr;
-   }
-   if (_pilotPll != nullptr)
-   {
-      nco_crcf_destroy(_pilotPll);
-      _pilotPll = nullptr;
-   }
-   if (_monoLpf != nullptr)
-   {
-      firfilt_rrrf_destroy(_monoLpf);
-      _monoLpf = nullptr;
-   }
-   if (_diffLpf != nullptr)
-   {
-      firfilt_rrrf_destroy(_diffLpf);
-      _diffLpf = nullptr;
-   }
-
    // AM
    if (_amDemod != nullptr)
    {
@@ -416,78 +447,36 @@ void Demodulator::createFmStereoObjects()
    auto kf = static_cast<float>(FM_DEVIATION_HZ / _inputSampleRate);
    _fmDemod = freqdem_create(kf);
 
-   // --- Stereo MPX decode filters ---
-   // All filters work at _inputSampleRate (the FM baseband rate).
-   const auto fs = static_cast<float>(_inputSampleRate);
-
-   // 1) Band-pass filter for 19 kHz pilot tone.
-   //    Centre = 19 kHz, BW ≈ 500 Hz.
-   //    Design a real-valued band-pass via liquid FIR.
-   {
-      constexpr float PILOT_FREQ = 19000.0F;
-      constexpr float BPF_BW = 500.0F; // ±250 Hz around 19 kHz
-      // Normalised frequencies for liquid firdespm method:
-      // Use a relatively short filter (61 taps) for low latency.
-      const unsigned int bpfLen = 127;
-      const float f0 = (PILOT_FREQ - BPF_BW / 2.0F) / fs;
-      const float f1 = (PILOT_FREQ + BPF_BW / 2.0F) / fs;
-      // Design using parks-mcclellan (firdespm).
-      // Bands: [0, f0-δ], [f0, f1], [f1+δ, 0.5]
-      const float delta = 0.002F; // transition band width (normalised)
-      constexpr unsigned int NUM_BANDS = 3;
-      float bands[NUM_BANDS * 2] = {
-         0.0F,          f0 - delta,   // stop-band
-         f0,            f1,           // pass-band
-         f1 + delta,    0.5F          // stop-band
-      };
-      float des[NUM_BANDS] = {0.0F, 1.0F, 0.0F};
-      float weights[NUM_BANDS] = {1.0F, 1.0F, 1.0F};
-      const liquid_firdespm_btype btype = LIQUID_FIRDESPM_BANDPASS;
-      std::vector<float> h(bpfLen);
-      firdespm_run(bpfLen, NUM_BANDS, bands, des, weights, nullptr,
-                   btype, h.data());
-      _pilotBpf = firfilt_rrrf_create(h.data(), bpfLen);
-   }
-
-   // 2) Pilot PLL (NCO running at 19 kHz, we use it doubled for 38 kHz).
+   // Stereo MPX decode, decimated as far as the audio rate allows so
+   // de-emphasis and the resampler run on fewer samples.
+   double decodedRate = _inputSampleRate;
+   const size_t decimation =
+      FmStereoDecoder::decimationFor(_inputSampleRate, _audioSampleRate);
+   if (_stereoDecoder.configure(_inputSampleRate, decimation, _scratchSamples))
    {
-      auto pilotOmega = 2.0F * static_cast<float>(std::numbers::pi) * 19000.0F / fs;
-      _pilotPll = nco_crcf_create(LIQUID_NCO);
-      nco_crcf_set_frequency(_pilotPll, pilotOmega);
-      nco_crcf_pll_set_bandwidth(_pilotPll, 0.002F);
+      decodedRate = _inputSampleRate / static_cast<double>(decimation);
    }
-
-   // 3) Low-pass filter for L+R (mono): cutoff 15 kHz.
+   else
    {
-      const unsigned int lpfLen = 65;
-      const float fc = 15000.0F / fs; // normalised cutoff
-      std::vector<float> h(lpfLen);
-      liquid_firdes_kaiser(lpfLen, fc, 60.0F, 0.0F, h.data());
-      _monoLpf = firfilt_rrrf_create(h.data(), lpfLen);
-   }
-
-   // 4) Low-pass filter for L-R (after mixing down from 38 kHz): cutoff 15 kHz.
-   {
-      const unsigned int lpfLen = 65;
-      const float fc = 15000.0F / fs;
-      std::vector<float> h(lpfLen);
-      liquid_firdes_kaiser(lpfLen, fc, 60.0F, 0.0F, h.data());
-      _diffLpf = firfilt_rrrf_create(h.data(), lpfLen);
+      GPWARN("Demodulator FM Stereo: {:.0f} Hz is below the {:.0f} Hz the "
+             "L-R sub-carrier needs, decoding mono",
+             _inputSampleRate, FmStereoDecoder::MIN_INPUT_RATE);
    }
 
    // De-emphasis for both channels.
    constexpr double TAU = 75.0e-6;
-   _deemphasisL = createDeemphasisFilter(TAU, _inputSampleRate);
-   _deemphasisR = createDeemphasisFilter(TAU, _inputSampleRate);
+   _deemphasisL = createDeemphasisFilter(TAU, decodedRate);
+   _deemphasisR = createDeemphasisFilter(TAU, decodedRate);
 
    // Resampler — one per channel.
-   _resamplerL = createResampler(_inputSampleRate, _audioSampleRate);
-   _resamplerR = createResampler(_inputSampleRate, _audioSampleRate);
+   _resamplerL = createResampler(decodedRate, _audioSampleRate);
+   _resamplerR = createResampler(decodedRate, _audioSampleRate);
 
    if (_resamplerL != nullptr)
    {
-      GPINFO("Demodulator FM Stereo: resampler ratio = {:.4f}",
-             _audioSampleRate / _inputSampleRate);
+      GPINFO("Demodulator FM Stereo: decimation = {}, resampler ratio = {:.4f}",
+             _stereoDecoder.isConfigured() ? decimation : 1,
+             _audioSampleRate / decodedRate);
    }
 }
 
@@ -512,89 +501,56 @@ void Demodulator::createAmObjects()
 }
 
 // ============================================================================
-// Internal — resample helper
+// Internal — scratch buffers and resample helper
 // ============================================================================
 
-std::vector<float> Demodulator::resample(const std::vector<float>& input) const
+size_t Demodulator::outputBound(size_t numSamples) const
 {
-   if (input.empty())
+   if (_inputSampleRate <= 0.0)
    {
-      return {};
+      return numSamples;
    }
+   auto ratio = static_cast<float>(_audioSampleRate / _inputSampleRate);
+   return std::max(numSamples,
+                   static_cast<size_t>((static_cast<float>(numSamples) * ratio) + 64));
+}
 
+void Demodulator::reserveScratch(size_t numSamples)
+{
+   if (numSamples > _scratchSamples)
+   {
+      _scratchSamples = numSamples;
+      _basebandL.resize(_scratchSamples);
+      _basebandR.resize(_scratchSamples);
+   }
+   // The bound also moves with the rates on reconfigure.
+   const size_t maxOut = outputBound(_scratchSamples);
+   if (_audioL.size() < maxOut)
+   {
+      _audioL.resize(maxOut);
+      _audioR.resize(maxOut);
+   }
+}
+
+const float* Demodulator::resample(msresamp_rrrf_s* resampler, float* input,
+                                   size_t numSamples, float* output,
+                                   size_t& numOut) const
+{
    // If no resampler needed, pass through.
-   // Select the resampler for the "left" channel; for stereo right, caller
-   // should resample separately using _resamplerR.  This helper always uses L.
-   msresamp_rrrf_s* resampler = _resamplerL;
    if (resampler == nullptr)
    {
+      numOut = numSamples;
       return input;
    }
 
-   const auto numIn = static_cast<unsigned int>(input.size());
-   auto ratio = static_cast<float>(_audioSampleRate / _inputSampleRate);
-   const auto maxOut =
-      static_cast<size_t>((static_cast<float>(numIn) * ratio) + 64);
-   std::vector<float> output(maxOut);
    unsigned int numWritten = 0;
-
-   msresamp_rrrf_execute(resampler,
-                         const_cast<float*>(input.data()), numIn,
-                         output.data(), &numWritten);
-   output.resize(numWritten);
+   msresamp_rrrf_execute(resampler, input,
+                         static_cast<unsigned int>(numSamples),
+                         output, &numWritten);
+   numOut = numWritten;
    return output;
 }
 
-// ============================================================================
-// Internal — FM Stereo MPX decode
-// ============================================================================
-
-void Demodulator::stereoDecodeBlock(const float* composite, size_t numSamples,
-                                    std::vector<float>& left,
-                                    std::vector<float>& right)
-{
-   left.resize(numSamples);
-   right.resize(numSamples);
-
-   for (size_t i = 0; i < numSamples; ++i)
-   {
-      const float x = composite[i];
-
-      // ---- Extract mono (L+R) via low-pass filter ----
-      float mono = 0.0F;
-      firfilt_rrrf_push(_monoLpf, x);
-      firfilt_rrrf_execute(_monoLpf, &mono);
-
-      // ---- Extract 19 kHz pilot ----
-      float pilot = 0.0F;
-      firfilt_rrrf_push(_pilotBpf, x);
-      firfilt_rrrf_execute(_pilotBpf, &pilot);
-
-      // ---- PLL: lock NCO to pilot ----
-      // Compute phase error: pilot * sin(NCO) — pushes NCO towards lock.
-      liquid_float_complex ncoOut;
-      nco_crcf_cexpf(_pilotPll, &ncoOut);
-      // Phase error = pilot * Im(nco) = pilot * sin(θ).
-      const float phaseError = pilot * ncoOut.imag();
-      nco_crcf_pll_step(_pilotPll, phaseError);
-      nco_crcf_step(_pilotPll);
-
-      // ---- Generate 38 kHz carrier (double the NCO phase) ----
-      // cos(2θ) = 2·cos²(θ) - 1
-      const float cos2theta = (2.0F * ncoOut.real() * ncoOut.real()) - 1.0F;
-
-      // ---- Mix composite with 38 kHz to recover L-R ----
-      const float diffRaw = x * cos2theta * 2.0F; // ×2 to compensate DSB-SC
-      float diff = 0.0F;
-      firfilt_rrrf_push(_diffLpf, diffRaw);
-      firfilt_rrrf_execute(_diffLpf, &diff);
-
-      // ---- Matrix: L = (mono + diff)/2, R = (mono - diff)/2 ----
-      left[i] = (mono + diff) * 0.5F;
-      right[i] = (mono - diff) * 0.5F;
-   }
-}
-
 // ============================================================================
 // Utility
 // ============================================================================
@@ -2,12 +2,16 @@
 #define DEMODULATOR_H_
 
 // Project headers
+#include "FmStereoDecoder.h"
 #include "SdrTypes.h"
 
 // System headers
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <mutex>
+#include <span>
 #include <vector>
 
 // Forward declarations for liquid-dsp types.
@@ -15,8 +19,6 @@ struct freqdem_s;
 struct ampmodem_s;
 struct msresamp_rrrf_s;
 struct iirfilt_rrrf_s;
-struct firfilt_rrrf_s;
-struct nco_crcf_s;
 
 namespace SdrEngine
 {
@@ -41,6 +43,7 @@ struct DemodAudio
 {
    std::vector<float> left;
    std::vector<float> right;
+   std::chrono::steady_clock::time_point sourceTime;   ///< IqBuffer::sourceTime() of the input block.
 };
 
 /**
@@ -50,10 +53,12 @@ struct DemodAudio
  * Supports three modes:
  *   - **FM Mono**:   freqdem → de-emphasis → resample
  *   - **FM Stereo**: freqdem → stereo MPX decode (19 kHz pilot PLL,
- *                    38 kHz L-R extraction) → de-emphasis → resample
+ *                    38 kHz L-R extraction, decimating) → de-emphasis
+ *                    → resample
  *   - **AM**:        envelope detector (ampmodem) → DC-removal → resample
  *
- * Uses liquid-dsp primitives throughout.
+ * Uses liquid-dsp primitives, except for the stereo MPX decode, which
+ * runs block-wise in FmStereoDecoder on the DspKernels FIR.
  * Designed to consume the output of ChannelFilter.
  *
  * Thread-safety: all public methods are protected by an internal mutex.
@@ -64,6 +69,9 @@ public:
    /// Default audio output sample rate.
    static constexpr double DEFAULT_AUDIO_RATE = 48000.0;
 
+   /// Default largest input block the scratch buffers are sized for.
+   static constexpr size_t DEFAULT_MAX_BLOCK_SAMPLES = 16384;
+
    /**
     * @brief Construct an unconfigured Demodulator.
     */
@@ -87,9 +95,14 @@ public:
     * @param inputSampleRate  Sample rate of the incoming IQ data (Hz).
     *                         This should be the ChannelFilter output rate.
     * @param audioSampleRate  Desired audio output rate (Hz). Default 48 kHz.
+    * @param maxBlockSamples  Largest input block expected per call; the
+    *                         scratch buffers are preallocated for it so
+    *                         demodulateInto() does not allocate.  Larger
+    *                         blocks still work but grow the buffers once.
     */
    void configure(DemodMode mode, double inputSampleRate,
-                  double audioSampleRate = DEFAULT_AUDIO_RATE);
+                  double audioSampleRate = DEFAULT_AUDIO_RATE,
+                  size_t maxBlockSamples = DEFAULT_MAX_BLOCK_SAMPLES);
 
    /**
     * @brief Check if the demodulator has been configured.
@@ -112,6 +125,54 @@ public:
    [[nodiscard]] DemodAudio demodulate(
       const std::vector<IqSample>& iqSamples);
 
+   /**
+    * @brief Demodulate a block into a caller-provided interleaved buffer.
+    *
+    * Runs on the preallocated scratch buffers and writes L/R frames
+    * straight into @p interleaved, so no memory is allocated per call.
+    *
+    * @param iqSamples    Filtered complex I/Q samples from ChannelFilter.
+    * @param interleaved  Output (L0, R0, L1, R1, ...); must hold at least
+    *                     2 × maxOutputFrames(iqSamples.size()) floats.
+    * @return Number of stereo frames written (0 if unconfigured, the input
+    *         is empty or @p interleaved is too small).
+    */
+   [[nodiscard]] size_t demodulateInto(std::span<const IqSample> iqSamples,
+                                       std::span<float> interleaved);
+
+   /**
+    * @brief Demodulate a block into an existing DemodAudio.
+    *
+    * Reuses the capacity of @p audio's vectors (e.g. a pooled frame), so
+    * steady-state calls do not allocate.
+    *
+    * @param iqSamples  Filtered complex I/Q samples from ChannelFilter.
+    * @param audio      Receives the left and right channels.
+    * @return Number of frames written to each channel.
+    */
+   size_t demodulateInto(std::span<const IqSample> iqSamples,
+                         DemodAudio& audio);
+
+   /**
+    * @brief Demodulate a block into channel vectors backed by the caller's
+    *        memory resource (e.g. a per-frame arena).
+    *
+    * @param iqSamples  Filtered complex I/Q samples from ChannelFilter.
+    * @param left       Replaced with the left channel.
+    * @param right      Replaced with the right channel.
+    * @return Number of frames written to each channel.
+    */
+   size_t demodulateInto(std::span<const IqSample> iqSamples,
+                         std::pmr::vector<float>& left,
+                         std::pmr::vector<float>& right);
+
+   /**
+    * @brief Upper bound on the frames produced from one input block.
+    * @param numInputSamples  Size of the I/Q block to be demodulated.
+    * @return Maximum stereo frames demodulateInto() may write.
+    */
+   [[nodiscard]] size_t maxOutputFrames(size_t numInputSamples) const;
+
    /**
     * @brief Get the audio output sample rate.
     * @return Audio output sample rate in Hz.
@@ -124,19 +185,38 @@ public:
    void reset();
 
 private:
+   /// Demodulated block held in the scratch buffers.
+   struct BlockAudio
+   {
+      const float* left{nullptr};
+      const float* right{nullptr};
+      size_t frames{0};
+   };
+
    void destroyDspObjects();
    void createFmMonoObjects();
    void createFmStereoObjects();
    void createAmObjects();
 
-   // Common resample step (mono input → mono output).
-   [[nodiscard]] std::vector<float> resample(
-      const std::vector<float>& input) const;
+   // Grow the scratch buffers to hold a block of numSamples inputs.
+   void reserveScratch(size_t numSamples);
+
+   // Upper bound on resampler output for numSamples inputs (lock held).
+   [[nodiscard]] size_t outputBound(size_t numSamples) const;
 
-   // FM composite → stereo decode.
-   void stereoDecodeBlock(const float* composite, size_t numSamples,
-                          std::vector<float>& left,
-                          std::vector<float>& right);
+   // Shared body of the vector demodulateInto() overloads.
+   template <typename Vector>
+   size_t demodulateChannels(std::span<const IqSample> iqSamples,
+                             Vector& left, Vector& right);
+
+   // Demodulate into the scratch buffers (lock held).
+   [[nodiscard]] BlockAudio demodulateBlock(std::span<const IqSample> iqSamples);
+
+   // Resample one channel into output; passes input through when no
+   // resampler is needed.  Returns the samples now valid at the result.
+   [[nodiscard]] const float* resample(msresamp_rrrf_s* resampler, float* input,
+                                       size_t numSamples, float* output,
+                                       size_t& numOut) const;
 
    mutable std::mutex _mutex;
 
@@ -147,6 +227,13 @@ private:
    double _inputSampleRate{0.0};
    double _audioSampleRate{DEFAULT_AUDIO_RATE};
 
+   // Scratch buffers, sized in configure() and reused by every call.
+   size_t _scratchSamples{0};         // Largest input block they hold.
+   std::vector<float> _basebandL;     // Discriminator / envelope / left.
+   std::vector<float> _basebandR;     // Stereo right (FmStereo only).
+   std::vector<float> _audioL;        // Resampled left / mono.
+   std::vector<float> _audioR;        // Resampled right (FmStereo only).
+
    // === FM objects ===
    freqdem_s* _fmDemod{nullptr};
 
@@ -154,15 +241,10 @@ private:
    iirfilt_rrrf_s* _deemphasisL{nullptr};
    iirfilt_rrrf_s* _deemphasisR{nullptr};
 
-   // === FM Stereo objects ===
-   // Band-pass filter to isolate 19 kHz pilot.
-   firfilt_rrrf_s* _pilotBpf{nullptr};
-   // PLL NCO locked to the pilot, running at 2× (38 kHz).
-   nco_crcf_s* _pilotPll{nullptr};
-   // Low-pass filter to isolate L+R (mono sum) from composite.
-   firfilt_rrrf_s* _monoLpf{nullptr};
-   // Low-pass filter to isolate L-R after mixing with 38 kHz.
-   firfilt_rrrf_s* _diffLpf{nullptr};
+   // === FM Stereo ===
+   // Composite → L/R at the decimated rate (unconfigured below
+   // FmStereoDecoder::MIN_INPUT_RATE, when the mode falls back to mono).
+   FmStereoDecoder _stereoDecoder;
 
    // === AM objects ===
    ampmodem_s* _amDemod{nullptr};
@@ -0,0 +1,139 @@
+#ifndef DEVICESTREAMSTATS_H_
+#define DEVICESTREAMSTATS_H_
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace SdrEngine
+{
+
+/**
+ * @class DeviceStreamStats
+ * @brief Snapshot of a device's streaming health since streaming started.
+ */
+struct DeviceStreamStats
+{
+   uint64_t samplesReceived{0};   ///< Complex samples delivered to the consumer.
+   uint64_t reads{0};             ///< Successful reads (blocks delivered).
+   uint64_t shortReads{0};        ///< Reads that returned fewer samples than requested.
+   uint64_t overflows{0};         ///< Driver-reported overflows (samples lost upstream).
+   uint64_t timeouts{0};          ///< Reads that timed out with no data.
+   uint64_t errors{0};            ///< Other read errors.
+   double elapsedSec{0.0};        ///< Time from stream start to the latest read.
+
+   /**
+    * @brief Get the mean number of samples per successful read.
+    * @return Samples per read, or 0 if nothing was read.
+    */
+   [[nodiscard]] double averageReadSize() const
+   {
+      return (reads == 0) ? 0.0
+                          : static_cast<double>(samplesReceived) / static_cast<double>(reads);
+   }
+
+   /**
+    * @brief Get the sample rate actually delivered by the device.
+    * Compare with the configured rate to spot a device that cannot keep up.
+    * @return Samples per second, or 0 before the first read.
+    */
+   [[nodiscard]] double achievedSampleRateHz() const
+   {
+      return (elapsedSec <= 0.0) ? 0.0 : static_cast<double>(samplesReceived) / elapsedSec;
+   }
+};
+
+/**
+ * @class DeviceStreamCounters
+ * @brief Lock-free accumulators updated by a device's stream thread.
+ *
+ * The stream thread calls start() before its first read and one of the
+ * record functions after every read; any thread may take a snapshot().
+ */
+class DeviceStreamCounters
+{
+public:
+   /** @brief Zero all counters and restart the clock.  Call before streaming. */
+   void start()
+   {
+      _samples.store(0, std::memory_order_relaxed);
+      _reads.store(0, std::memory_order_relaxed);
+      _shortReads.store(0, std::memory_order_relaxed);
+      _overflows.store(0, std::memory_order_relaxed);
+      _timeouts.store(0, std::memory_order_relaxed);
+      _errors.store(0, std::memory_order_relaxed);
+      _lastReadNs.store(0, std::memory_order_relaxed);
+      _startNs.store(nowNs(), std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Account one successful read.
+    * @param samples    Samples returned.
+    * @param requested  Samples asked for (a smaller read counts as short).
+    */
+   void recordRead(std::size_t samples, std::size_t requested)
+   {
+      _samples.fetch_add(samples, std::memory_order_relaxed);
+      _reads.fetch_add(1, std::memory_order_relaxed);
+      if (samples < requested)
+      {
+         _shortReads.fetch_add(1, std::memory_order_relaxed);
+      }
+      _lastReadNs.store(nowNs(), std::memory_order_relaxed);
+   }
+
+   /** @brief Account one driver-reported overflow. */
+   void recordOverflow() { _overflows.fetch_add(1, std::memory_order_relaxed); }
+
+   /** @brief Account one read that timed out. */
+   void recordTimeout() { _timeouts.fetch_add(1, std::memory_order_relaxed); }
+
+   /** @brief Account one failed read. */
+   void recordError() { _errors.fetch_add(1, std::memory_order_relaxed); }
+
+   /**
+    * @brief Get the current counter values.
+    * @return Snapshot of every counter.
+    */
+   [[nodiscard]] DeviceStreamStats snapshot() const
+   {
+      DeviceStreamStats out;
+      out.samplesReceived = _samples.load(std::memory_order_relaxed);
+      out.reads           = _reads.load(std::memory_order_relaxed);
+      out.shortReads      = _shortReads.load(std::memory_order_relaxed);
+      out.overflows       = _overflows.load(std::memory_order_relaxed);
+      out.timeouts        = _timeouts.load(std::memory_order_relaxed);
+      out.errors          = _errors.load(std::memory_order_relaxed);
+
+      const int64_t lastNs  = _lastReadNs.load(std::memory_order_relaxed);
+      const int64_t startNs = _startNs.load(std::memory_order_relaxed);
+      if (lastNs > startNs)
+      {
+         out.elapsedSec = static_cast<double>(lastNs - startNs) / 1.0e9;
+      }
+      return out;
+   }
+
+private:
+   static int64_t nowNs()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+         .count();
+   }
+
+   std::atomic<uint64_t> _samples{0};
+   std::atomic<uint64_t> _reads{0};
+   std::atomic<uint64_t> _shortReads{0};
+   std::atomic<uint64_t> _overflows{0};
+   std::atomic<uint64_t> _timeouts{0};
+   std::atomic<uint64_t> _errors{0};
+   std::atomic<int64_t> _startNs{0};
+   std::atomic<int64_t> _lastReadNs{0};
+};
+
+} // namespace SdrEngine
+
+#endif // DEVICESTREAMSTATS_H_
@@ -0,0 +1,162 @@
+// Project headers
+#include "DisplayIqTap.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Settings
+// ============================================================================
+
+void DisplayIqTap::setConfig(const DisplayTapConfig& config)
+{
+   DisplayTapConfig clean = config;
+   clean.samplesPerSec   = (clean.samplesPerSec > 0.0) ? clean.samplesPerSec : 1.0;
+   clean.framesPerSec    = (clean.framesPerSec > 0.0) ? clean.framesPerSec : 1.0;
+   clean.snapshotSamples = std::max<std::size_t>(clean.snapshotSamples, 1);
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _config = clean;
+   _rateHz = 0.0;   // Restart with the next frame.
+}
+
+DisplayTapConfig DisplayIqTap::config() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _config;
+}
+
+void DisplayIqTap::setBudgetDivisor(std::size_t divisor)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   divisor = std::max<std::size_t>(divisor, 1);
+   if (divisor != _divisor)
+   {
+      _divisor = divisor;
+      _rateHz  = 0.0;   // Restart with the next frame.
+   }
+}
+
+std::size_t DisplayIqTap::budgetDivisor() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _divisor;
+}
+
+void DisplayIqTap::reset()
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _pending.reset();
+   _rateHz = 0.0;
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+std::shared_ptr<IqBuffer> DisplayIqTap::process(const IqBuffer& in, FramePool<IqBuffer>& pool)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (in.samples.empty() || in.sampleRateHz <= 0.0)
+   {
+      return nullptr;
+   }
+   if (in.sampleRateHz != _rateHz || in.centerFreqHz != _centerFreqHz)
+   {
+      restart(in);
+   }
+   if (!_pending)
+   {
+      _pending = pool.acquire();
+      _pending->samples.clear();
+      _pending->samples.reserve(_target);
+   }
+
+   if (_config.mode == DisplayTapMode::Decimate)
+   {
+      decimate(in);
+   }
+   else
+   {
+      snapshot(in);
+   }
+   if (_pending->samples.size() < _target)
+   {
+      return nullptr;
+   }
+
+   _pending->centerFreqHz = in.centerFreqHz;
+   _pending->sampleRateHz = in.sampleRateHz / static_cast<double>(_step);
+   _pending->timestamp    = in.timestamp;
+   _pending->stages       = in.stages;
+   return std::exchange(_pending, nullptr);
+}
+
+void DisplayIqTap::restart(const IqBuffer& in)
+{
+   _pending.reset();
+   _rateHz       = in.sampleRateHz;
+   _centerFreqHz = in.centerFreqHz;
+   _skip         = 0;
+   // Both budgets shrink, so frames keep their size and come less often.
+   const auto divisor  = static_cast<double>(_divisor);
+   const double budget = _config.samplesPerSec / divisor;
+   const double fps    = _config.framesPerSec / divisor;
+
+   if (_config.mode == DisplayTapMode::Decimate)
+   {
+      _step = static_cast<std::size_t>(std::max(1.0, std::ceil(_rateHz / budget)));
+      const double outRate = _rateHz / static_cast<double>(_step);
+      _target = static_cast<std::size_t>(std::max(1.0, std::ceil(outRate / fps)));
+      _gap    = 0;
+   }
+   else
+   {
+      // Blocks per second within both budgets; the gap pads each block out
+      // to its share of the stream (none if the stream is slower).
+      const auto block       = static_cast<double>(_config.snapshotSamples);
+      const double perSecond = std::min(budget / block, fps);
+      const double interval  = _rateHz / perSecond;
+      _step   = 1;
+      _target = _config.snapshotSamples;
+      _gap    = static_cast<uint64_t>(std::max(0.0, std::round(interval - block)));
+   }
+}
+
+void DisplayIqTap::decimate(const IqBuffer& in)
+{
+   const std::size_t n = in.samples.size();
+   auto& out           = _pending->samples;
+   std::size_t i       = static_cast<std::size_t>(_skip);
+   for (; i < n; i += _step)
+   {
+      out.push_back(in.samples[i]);
+   }
+   _skip = i - n;
+}
+
+void DisplayIqTap::snapshot(const IqBuffer& in)
+{
+   const std::size_t n = in.samples.size();
+   auto& out           = _pending->samples;
+
+   // Still in the gap before the next block.
+   const auto passed = static_cast<std::size_t>(std::min<uint64_t>(_skip, n));
+   _skip -= passed;
+   const std::size_t take = std::min(_target - out.size(), n - passed);
+   out.insert(out.end(), in.samples.begin() + static_cast<std::ptrdiff_t>(passed),
+              in.samples.begin() + static_cast<std::ptrdiff_t>(passed + take));
+
+   // A completed block: the rest of this frame is part of the next gap.
+   if (out.size() == _target)
+   {
+      const std::size_t rest = n - passed - take;
+      _skip = (_gap > rest) ? _gap - rest : 0;
+   }
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,133 @@
+#ifndef DISPLAYIQTAP_H_
+#define DISPLAYIQTAP_H_
+
+// Project headers
+#include "FramePool.h"
+#include "SdrTypes.h"
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace SdrEngine
+{
+
+/** @brief How a DisplayIqTap reduces the stream to its budget. */
+enum class DisplayTapMode : uint8_t
+{
+   Decimate,   ///< Every Nth sample, continuous at a reduced rate (scope overview).
+   Snapshot    ///< Contiguous full-rate blocks, spaced out in time (waveform detail).
+};
+
+/** @brief Which I/Q stream feeds the display tap. */
+enum class DisplayTapSource : uint8_t
+{
+   Wideband,       ///< The raw stream (iqDataHandler()).
+   ChannelFilter   ///< The channel filter's output (filteredIqDataHandler()).
+};
+
+/**
+ * @class DisplayTapConfig
+ * @brief Parameters of DisplayIqTap.
+ */
+struct DisplayTapConfig
+{
+   DisplayTapSource source{DisplayTapSource::Wideband};
+   DisplayTapMode mode{DisplayTapMode::Decimate};
+   double samplesPerSec{65'536.0};     ///< Output budget, whatever the input rate.
+   double framesPerSec{30.0};          ///< Most frames published per second.
+   std::size_t snapshotSamples{2048};  ///< Snapshot: samples per block.
+};
+
+/**
+ * @class DisplayIqTap
+ * @brief Cuts an I/Q stream down to a fixed sample budget for displays.
+ *
+ * Constellation and oscilloscope views show a few thousand points, so
+ * handing them every full-rate frame only costs copies and listener
+ * wake-ups that grow with the sample rate.  The tap emits at most
+ * `samplesPerSec` samples in at most `framesPerSec` frames, whatever the
+ * input rate:
+ *   - Decimate: keeps every Nth sample (N = ceil(rate / budget)), with the
+ *     phase carried across frames, so the output is a continuous stream at
+ *     `rate / N`.  No filter: points stay on the received symbols, which is
+ *     what a constellation wants.
+ *   - Snapshot: copies `snapshotSamples` contiguous samples at the full
+ *     rate, then skips ahead so the blocks stay within the budget.  Blocks
+ *     may span input frames.
+ *
+ * At most one frame is returned per input frame: when decimating, a long
+ * input frame makes the output frame longer; in snapshot mode, the rest of
+ * the input frame counts towards the gap to the next block.  Output frames
+ * come from the caller's FramePool and carry the rate of their samples
+ * (`rate / N` when decimating).  A change of input rate or tuning drops
+ * the partial frame.
+ *
+ * Thread-safety: all methods lock an internal mutex, so the source stage
+ * may change threads (wideband / channel filter) while running.
+ */
+class DisplayIqTap
+{
+public:
+   /**
+    * @brief Replace the configuration; restarts the output.
+    * A non-positive budget or frame rate counts as 1; zero snapshot samples as 1.
+    */
+   void setConfig(const DisplayTapConfig& config);
+
+   /**
+    * @brief Get the configuration.
+    * @return Current configuration.
+    */
+   [[nodiscard]] DisplayTapConfig config() const;
+
+   /**
+    * @brief Divide the sample and frame budgets, to shed load without
+    *        touching the configuration; restarts the output when changed.
+    * @param divisor  1 for the configured budgets (0 counts as 1).
+    */
+   void setBudgetDivisor(std::size_t divisor);
+
+   /**
+    * @brief Get the budget divisor.
+    * @return Divisor set by setBudgetDivisor(), 1 by default.
+    */
+   [[nodiscard]] std::size_t budgetDivisor() const;
+
+   /**
+    * @brief Take one input frame.
+    * @param in    I/Q frame with its rate and tuning set.
+    * @param pool  Source of output frames.
+    * @return A completed display frame, or nullptr if none is due yet.
+    */
+   std::shared_ptr<IqBuffer> process(const IqBuffer& in, FramePool<IqBuffer>& pool);
+
+   /** @brief Drop the partial output frame. */
+   void reset();
+
+private:
+   // Start over for the rate and tuning of `in` (and the current config).
+   void restart(const IqBuffer& in);
+
+   // Copy the kept samples of `in` into _pending.
+   void decimate(const IqBuffer& in);
+   void snapshot(const IqBuffer& in);
+
+   mutable std::mutex _mutex;
+   DisplayTapConfig _config;
+   std::size_t _divisor{1};              // Of the budgets in _config.
+
+   std::shared_ptr<IqBuffer> _pending;   // Output frame in progress.
+   std::size_t _target{1};               // Samples that complete _pending.
+   double _rateHz{0.0};                  // Input rate and tuning _pending belongs to.
+   double _centerFreqHz{0.0};
+   std::size_t _step{1};                 // Decimate: keep one sample in _step.
+   uint64_t _gap{0};                     // Snapshot: samples between blocks.
+   uint64_t _skip{0};                    // Input samples to pass over before the next kept one.
+};
+
+} // namespace SdrEngine
+
+#endif // DISPLAYIQTAP_H_
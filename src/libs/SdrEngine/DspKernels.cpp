@@ -0,0 +1,1592 @@
+// Project headers
+#include "DspKernels.h"
+
+// System headers
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SDRENGINE_KERNELS_AVX2 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define SDRENGINE_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// ============================================================================
+// Fast log2 — shared constants so every path rounds the same way
+// ============================================================================
+
+// log2(1 + t) ≈ t * (C1 + t * (C2 + t * (C3 + t * C4))) for t in [0, 1).
+// Least-squares fit on Chebyshev nodes with p(0) = 0; max error 1.19e-4.
+constexpr float LOG2_C1 = 1.43863803F;
+constexpr float LOG2_C2 = -0.677743267F;
+constexpr float LOG2_C3 = 0.321879707F;
+constexpr float LOG2_C4 = -0.0828606982F;
+
+constexpr float DB_PER_LOG2 = 3.01029995664F;   // 10 * log10(2)
+
+constexpr uint32_t MANTISSA_MASK = 0x007FFFFFU;
+constexpr uint32_t ONE_BITS      = 0x3F800000U;   // 1.0F
+constexpr int EXPONENT_BIAS      = 127;
+
+float fastLog2Scalar(float x)
+{
+   const auto bits   = std::bit_cast<uint32_t>(x);
+   const auto expo   = static_cast<float>(static_cast<int>(bits >> 23U) - EXPONENT_BIAS);
+   const float t     = std::bit_cast<float>((bits & MANTISSA_MASK) | ONE_BITS) - 1.0F;
+   const float poly  = t * (LOG2_C1 + (t * (LOG2_C2 + (t * (LOG2_C3 + (t * LOG2_C4))))));
+   return expo + poly;
+}
+
+// ============================================================================
+// Scalar implementations
+// ============================================================================
+
+void windowScalar(const IqSample* src, const float* window, float* dst, std::size_t n)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      dst[2 * i]       = src[i].real() * window[i];
+      dst[(2 * i) + 1] = src[i].imag() * window[i];
+   }
+}
+
+void powerScalar(const float* spectrum, float* dst, std::size_t n, float scale)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const float re = spectrum[2 * i];
+      const float im = spectrum[(2 * i) + 1];
+      dst[i] = ((re * re) + (im * im)) * scale;
+   }
+}
+
+void powerDbScalar(const float* spectrum, float* dst, std::size_t n, float scale,
+                   float floorPower)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const float re = spectrum[2 * i];
+      const float im = spectrum[(2 * i) + 1];
+      const float p  = std::max(((re * re) + (im * im)) * scale, floorPower);
+      dst[i] = DB_PER_LOG2 * fastLog2Scalar(p);
+   }
+}
+
+void toDbScalar(const float* power, float* dst, std::size_t n, float scale, float floorPower)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      dst[i] = DB_PER_LOG2 * fastLog2Scalar(std::max(power[i] * scale, floorPower));
+   }
+}
+
+void averageScalar(float* avg, const float* x, std::size_t n, float alpha, float scale)
+{
+   const float beta = (1.0F - alpha) * scale;
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      avg[i] = (alpha * avg[i]) + (beta * x[i]);
+   }
+}
+
+void maxHoldScalar(const float* hold, const float* x, float* dst, std::size_t n, float decay)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      dst[i] = std::max(hold[i] - decay, x[i]);
+   }
+}
+
+void minHoldScalar(const float* hold, const float* x, float* dst, std::size_t n)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      dst[i] = std::min(hold[i], x[i]);
+   }
+}
+
+float maxValueScalar(const float* src, std::size_t n)
+{
+   return *std::max_element(src, src + n);
+}
+
+float sumScalar(const float* src, std::size_t n)
+{
+   float sum = 0.0F;
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      sum += src[i];
+   }
+   return sum;
+}
+
+void bucketsScalar(const float* src, uint16_t* dst, std::size_t n, float lowest, float invWidth,
+                   float last)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      // `> 0` is false for NaN, which lands in bucket 0 like the vector paths
+      const float v = (src[i] - lowest) * invWidth;
+      dst[i] = static_cast<uint16_t>((v > 0.0F) ? std::min(v, last) : 0.0F);
+   }
+}
+
+void pairwiseMaxScalar(const float* src, float* dst, std::size_t nOut)
+{
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      dst[i] = std::max(src[2 * i], src[(2 * i) + 1]);
+   }
+}
+
+void pairwiseMinScalar(const float* src, float* dst, std::size_t nOut)
+{
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      dst[i] = std::min(src[2 * i], src[(2 * i) + 1]);
+   }
+}
+
+void pairwiseMeanScalar(const float* src, float* dst, std::size_t nOut)
+{
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      dst[i] = 0.5F * (src[2 * i] + src[(2 * i) + 1]);
+   }
+}
+
+// Sliding sums restart from a direct sum this often (see slidingSum()).
+constexpr std::size_t SLIDING_SUM_RESTART = 256;
+
+// Continue sliding sums over [begin, end), given dst[begin - 1].
+void slideScalar(const float* src, float* dst, std::size_t begin, std::size_t end,
+                 std::size_t window)
+{
+   for (std::size_t i = begin; i < end; ++i)
+   {
+      dst[i] = dst[i - 1] + (src[i + window - 1] - src[i - 1]);
+   }
+}
+
+void slidingSumScalar(const float* src, float* dst, std::size_t nOut, std::size_t window)
+{
+   for (std::size_t block = 0; block < nOut; block += SLIDING_SUM_RESTART)
+   {
+      dst[block] = sumScalar(src + block, window);
+      slideScalar(src, dst, block + 1, std::min(nOut, block + SLIDING_SUM_RESTART), window);
+   }
+}
+
+void excessScalar(const float* x, const float* leadSum, const float* lagSum, float* dst,
+                  std::size_t n, float scale)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      dst[i] = x[i] - ((leadSum[i] + lagSum[i]) * scale);
+   }
+}
+
+std::size_t findAtLeastScalar(const float* src, std::size_t n, float threshold)
+{
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      if (src[i] >= threshold)
+      {
+         return i;
+      }
+   }
+   return n;
+}
+
+void firDecimateScalar(const float* x, const float* taps, std::size_t numTaps, float* y,
+                       std::size_t nOut, std::size_t decimation)
+{
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      const float* window = x + (i * decimation);
+      float acc = 0.0F;
+      for (std::size_t k = 0; k < numTaps; ++k)
+      {
+         acc += taps[k] * window[k];
+      }
+      y[i] = acc;
+   }
+}
+
+// Integer I/Q → float: `count` scalar values (2 per complex sample).
+template <typename Int>
+void intToFloatScalar(const Int* src, float* dst, std::size_t count, float scale)
+{
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      dst[i] = static_cast<float>(src[i]) * scale;
+   }
+}
+
+// Float → saturated int16: `count` scalar values.  fmax() maps NaN to the
+// lowest value, as the AVX2 path does.
+void floatToInt16Scalar(const float* src, int16_t* dst, std::size_t count, float scale)
+{
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      const float v = std::fmin(std::fmax(src[i] * scale, -32768.0F), 32767.0F);
+      dst[i]        = static_cast<int16_t>(std::lrint(v));
+   }
+}
+
+// Scale `n` interleaved complex samples to float and remove DC with the
+// single-pole tracker m += alpha * (x - m), y = x - m.  `m` is updated.
+template <typename T>
+void dcBlockScalar(const T* src, float* dst, std::size_t n, float scale, float alpha,
+                   IqSample& mean)
+{
+   float mr = mean.real();
+   float mi = mean.imag();
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const float xr = static_cast<float>(src[2 * i]) * scale;
+      const float xi = static_cast<float>(src[(2 * i) + 1]) * scale;
+      mr += alpha * (xr - mr);
+      mi += alpha * (xi - mi);
+      dst[2 * i]       = xr - mr;
+      dst[(2 * i) + 1] = xi - mi;
+   }
+   mean = {mr, mi};
+}
+
+// Powers of the DC tracker's decay b = 1 - alpha, computed in double so the
+// vector paths track the scalar recursion closely.
+struct DcDecay
+{
+   float b1, b2, b3, b4;
+};
+
+DcDecay dcDecay(float alpha)
+{
+   const double b = 1.0 - static_cast<double>(alpha);
+   return {static_cast<float>(b), static_cast<float>(b * b), static_cast<float>(b * b * b),
+           static_cast<float>(b * b * b * b)};
+}
+
+// ============================================================================
+// AVX2 implementations (x86-64, chosen at run time)
+// ============================================================================
+
+#if defined(SDRENGINE_KERNELS_AVX2)
+
+bool cpuHasAvx2()
+{
+   static const bool HAS_AVX2 = __builtin_cpu_supports("avx2") != 0;
+   return HAS_AVX2;
+}
+
+__attribute__((target("avx2"))) __m256 fastLog2Avx2(__m256 x)
+{
+   const __m256i bits = _mm256_castps_si256(x);
+   const __m256 expo  = _mm256_cvtepi32_ps(
+      _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(EXPONENT_BIAS)));
+   const __m256i mant = _mm256_or_si256(
+      _mm256_and_si256(bits, _mm256_set1_epi32(static_cast<int>(MANTISSA_MASK))),
+      _mm256_set1_epi32(static_cast<int>(ONE_BITS)));
+   const __m256 t = _mm256_sub_ps(_mm256_castsi256_ps(mant), _mm256_set1_ps(1.0F));
+
+   __m256 poly = _mm256_set1_ps(LOG2_C4);
+   poly = _mm256_add_ps(_mm256_mul_ps(poly, t), _mm256_set1_ps(LOG2_C3));
+   poly = _mm256_add_ps(_mm256_mul_ps(poly, t), _mm256_set1_ps(LOG2_C2));
+   poly = _mm256_add_ps(_mm256_mul_ps(poly, t), _mm256_set1_ps(LOG2_C1));
+   return _mm256_add_ps(expo, _mm256_mul_ps(poly, t));
+}
+
+// Sum re² + im² for 8 consecutive complex bins in bin order.
+__attribute__((target("avx2"))) __m256 power8Avx2(const float* spectrum)
+{
+   const __m256 a = _mm256_loadu_ps(spectrum);
+   const __m256 b = _mm256_loadu_ps(spectrum + 8);
+   // hadd pairs within 128-bit lanes → (a01 a23 b01 b23 | a45 a67 b45 b67).
+   const __m256 h = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+   // Reorder 64-bit halves to (a01 a23 a45 a67 | b01 b23 b45 b67).
+   return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), 0xD8));
+}
+
+__attribute__((target("avx2")))
+void windowAvx2(const IqSample* src, const float* window, float* dst, std::size_t n)
+{
+   const auto* in = reinterpret_cast<const float*>(src);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const __m128 w   = _mm_loadu_ps(window + i);
+      const __m256 w2  = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(w, w)),
+                                              _mm_unpackhi_ps(w, w), 1);
+      _mm256_storeu_ps(dst + (2 * i), _mm256_mul_ps(_mm256_loadu_ps(in + (2 * i)), w2));
+   }
+   windowScalar(src + i, window + i, dst + (2 * i), n - i);
+}
+
+__attribute__((target("avx2")))
+void powerAvx2(const float* spectrum, float* dst, std::size_t n, float scale)
+{
+   const __m256 s = _mm256_set1_ps(scale);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(power8Avx2(spectrum + (2 * i)), s));
+   }
+   powerScalar(spectrum + (2 * i), dst + i, n - i, scale);
+}
+
+__attribute__((target("avx2")))
+void powerDbAvx2(const float* spectrum, float* dst, std::size_t n, float scale, float floorPower)
+{
+   const __m256 s  = _mm256_set1_ps(scale);
+   const __m256 fl = _mm256_set1_ps(floorPower);
+   const __m256 k  = _mm256_set1_ps(DB_PER_LOG2);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256 p = _mm256_max_ps(_mm256_mul_ps(power8Avx2(spectrum + (2 * i)), s), fl);
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(k, fastLog2Avx2(p)));
+   }
+   powerDbScalar(spectrum + (2 * i), dst + i, n - i, scale, floorPower);
+}
+
+__attribute__((target("avx2")))
+void toDbAvx2(const float* power, float* dst, std::size_t n, float scale, float floorPower)
+{
+   const __m256 s  = _mm256_set1_ps(scale);
+   const __m256 fl = _mm256_set1_ps(floorPower);
+   const __m256 k  = _mm256_set1_ps(DB_PER_LOG2);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256 p = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(power + i), s), fl);
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(k, fastLog2Avx2(p)));
+   }
+   toDbScalar(power + i, dst + i, n - i, scale, floorPower);
+}
+
+__attribute__((target("avx2")))
+void averageAvx2(float* avg, const float* x, std::size_t n, float alpha, float scale)
+{
+   const __m256 a = _mm256_set1_ps(alpha);
+   const __m256 b = _mm256_set1_ps((1.0F - alpha) * scale);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256 v = _mm256_add_ps(_mm256_mul_ps(a, _mm256_loadu_ps(avg + i)),
+                                     _mm256_mul_ps(b, _mm256_loadu_ps(x + i)));
+      _mm256_storeu_ps(avg + i, v);
+   }
+   averageScalar(avg + i, x + i, n - i, alpha, scale);
+}
+
+__attribute__((target("avx2")))
+void maxHoldAvx2(const float* hold, const float* x, float* dst, std::size_t n, float decay)
+{
+   const __m256 d = _mm256_set1_ps(decay);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      _mm256_storeu_ps(dst + i, _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(hold + i), d),
+                                              _mm256_loadu_ps(x + i)));
+   }
+   maxHoldScalar(hold + i, x + i, dst + i, n - i, decay);
+}
+
+__attribute__((target("avx2")))
+void minHoldAvx2(const float* hold, const float* x, float* dst, std::size_t n)
+{
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      _mm256_storeu_ps(dst + i, _mm256_min_ps(_mm256_loadu_ps(hold + i), _mm256_loadu_ps(x + i)));
+   }
+   minHoldScalar(hold + i, x + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2")))
+float maxValueAvx2(const float* src, std::size_t n)
+{
+   if (n < 8)
+   {
+      return maxValueScalar(src, n);
+   }
+   __m256 m = _mm256_loadu_ps(src);
+   std::size_t i = 8;
+   for (; i + 8 <= n; i += 8)
+   {
+      m = _mm256_max_ps(m, _mm256_loadu_ps(src + i));
+   }
+   __m128 r = _mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+   r = _mm_max_ps(r, _mm_movehl_ps(r, r));
+   r = _mm_max_ss(r, _mm_shuffle_ps(r, r, 1));
+   float result = _mm_cvtss_f32(r);
+   for (; i < n; ++i)
+   {
+      result = std::max(result, src[i]);
+   }
+   return result;
+}
+
+__attribute__((target("avx2"))) float horizontalSumAvx2(__m256 v)
+{
+   __m128 r = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+   r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+   r = _mm_add_ss(r, _mm_shuffle_ps(r, r, 1));
+   return _mm_cvtss_f32(r);
+}
+
+__attribute__((target("avx2")))
+float sumAvx2(const float* src, std::size_t n)
+{
+   __m256 acc = _mm256_setzero_ps();
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      acc = _mm256_add_ps(acc, _mm256_loadu_ps(src + i));
+   }
+   return horizontalSumAvx2(acc) + sumScalar(src + i, n - i);
+}
+
+// Buckets of 8 values as int32.  max(v, 0) returns 0 for NaN (the second
+// operand wins).
+__attribute__((target("avx2")))
+__m256i bucket8Avx2(const float* src, __m256 lowest, __m256 invWidth, __m256 last)
+{
+   const __m256 v = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src), lowest), invWidth);
+   return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), last));
+}
+
+__attribute__((target("avx2")))
+void bucketsAvx2(const float* src, uint16_t* dst, std::size_t n, float lowest, float invWidth,
+                 float last)
+{
+   const __m256 vLowest = _mm256_set1_ps(lowest);
+   const __m256 vInv    = _mm256_set1_ps(invWidth);
+   const __m256 vLast   = _mm256_set1_ps(last);
+   std::size_t i = 0;
+   for (; i + 16 <= n; i += 16)
+   {
+      // packus works within 128-bit lanes; restore the order afterwards
+      const __m256i packed = _mm256_packus_epi32(bucket8Avx2(src + i, vLowest, vInv, vLast),
+                                                 bucket8Avx2(src + i + 8, vLowest, vInv, vLast));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_permute4x64_epi64(packed, 0xD8));
+   }
+   bucketsScalar(src + i, dst + i, n - i, lowest, invWidth, last);
+}
+
+// One dot product of taps with the input window per output; two
+// accumulators hide the add latency for the usual 60-130 tap filters.
+__attribute__((target("avx2")))
+void firDecimateAvx2(const float* x, const float* taps, std::size_t numTaps, float* y,
+                     std::size_t nOut, std::size_t decimation)
+{
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      const float* window = x + (i * decimation);
+      __m256 acc0 = _mm256_setzero_ps();
+      __m256 acc1 = _mm256_setzero_ps();
+      std::size_t k = 0;
+      for (; k + 16 <= numTaps; k += 16)
+      {
+         acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(taps + k),
+                                                  _mm256_loadu_ps(window + k)));
+         acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(taps + k + 8),
+                                                  _mm256_loadu_ps(window + k + 8)));
+      }
+      for (; k + 8 <= numTaps; k += 8)
+      {
+         acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(taps + k),
+                                                  _mm256_loadu_ps(window + k)));
+      }
+      float acc = horizontalSumAvx2(_mm256_add_ps(acc0, acc1));
+      for (; k < numTaps; ++k)
+      {
+         acc += taps[k] * window[k];
+      }
+      y[i] = acc;
+   }
+}
+
+// Split 16 consecutive floats into their even and odd elements, in order.
+__attribute__((target("avx2"))) void deinterleave16Avx2(const float* src, __m256& even, __m256& odd)
+{
+   const __m256 a = _mm256_loadu_ps(src);
+   const __m256 b = _mm256_loadu_ps(src + 8);
+   // shuffle works per 128-bit lane → (a0 a2 b0 b2 | a4 a6 b4 b6); fix the 64-bit order.
+   even = _mm256_castpd_ps(_mm256_permute4x64_pd(
+      _mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), 0xD8));
+   odd = _mm256_castpd_ps(_mm256_permute4x64_pd(
+      _mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), 0xD8));
+}
+
+__attribute__((target("avx2")))
+void pairwiseMaxAvx2(const float* src, float* dst, std::size_t nOut)
+{
+   std::size_t i = 0;
+   for (; i + 8 <= nOut; i += 8)
+   {
+      __m256 even;
+      __m256 odd;
+      deinterleave16Avx2(src + (2 * i), even, odd);
+      _mm256_storeu_ps(dst + i, _mm256_max_ps(even, odd));
+   }
+   pairwiseMaxScalar(src + (2 * i), dst + i, nOut - i);
+}
+
+__attribute__((target("avx2")))
+void pairwiseMinAvx2(const float* src, float* dst, std::size_t nOut)
+{
+   std::size_t i = 0;
+   for (; i + 8 <= nOut; i += 8)
+   {
+      __m256 even;
+      __m256 odd;
+      deinterleave16Avx2(src + (2 * i), even, odd);
+      _mm256_storeu_ps(dst + i, _mm256_min_ps(even, odd));
+   }
+   pairwiseMinScalar(src + (2 * i), dst + i, nOut - i);
+}
+
+__attribute__((target("avx2")))
+void pairwiseMeanAvx2(const float* src, float* dst, std::size_t nOut)
+{
+   const __m256 half = _mm256_set1_ps(0.5F);
+   std::size_t i = 0;
+   for (; i + 8 <= nOut; i += 8)
+   {
+      __m256 even;
+      __m256 odd;
+      deinterleave16Avx2(src + (2 * i), even, odd);
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(half, _mm256_add_ps(even, odd)));
+   }
+   pairwiseMeanScalar(src + (2 * i), dst + i, nOut - i);
+}
+
+// Shift 8 floats up by `Lanes` positions, zero-filling lane 0 upwards.
+template <int Lanes>
+__attribute__((target("avx2"))) __m256 shiftLanesAvx2(__m256 v)
+{
+   const __m256i index = _mm256_setr_epi32(std::max(0 - Lanes, 0), std::max(1 - Lanes, 0),
+                                           std::max(2 - Lanes, 0), std::max(3 - Lanes, 0),
+                                           std::max(4 - Lanes, 0), std::max(5 - Lanes, 0),
+                                           std::max(6 - Lanes, 0), std::max(7 - Lanes, 0));
+   return _mm256_blend_ps(_mm256_permutevar8x32_ps(v, index), _mm256_setzero_ps(),
+                          (1 << Lanes) - 1);
+}
+
+// Eight steps of the sliding-sum recurrence at once: the differences
+// src[i+window-1] - src[i-1] are prefix-summed in three log steps and
+// added to the previous sum, broadcast across the vector.
+__attribute__((target("avx2")))
+void slidingSumAvx2(const float* src, float* dst, std::size_t nOut, std::size_t window)
+{
+   const __m256i lastLane = _mm256_set1_epi32(7);
+   for (std::size_t block = 0; block < nOut; block += SLIDING_SUM_RESTART)
+   {
+      const std::size_t end = std::min(nOut, block + SLIDING_SUM_RESTART);
+      dst[block] = sumScalar(src + block, window);
+      __m256 carry = _mm256_set1_ps(dst[block]);
+      std::size_t i = block + 1;
+      for (; i + 8 <= end; i += 8)
+      {
+         __m256 d = _mm256_sub_ps(_mm256_loadu_ps(src + i + window - 1),
+                                  _mm256_loadu_ps(src + i - 1));
+         d = _mm256_add_ps(d, shiftLanesAvx2<1>(d));
+         d = _mm256_add_ps(d, shiftLanesAvx2<2>(d));
+         d = _mm256_add_ps(d, shiftLanesAvx2<4>(d));
+         const __m256 sums = _mm256_add_ps(d, carry);
+         _mm256_storeu_ps(dst + i, sums);
+         carry = _mm256_permutevar8x32_ps(sums, lastLane);
+      }
+      slideScalar(src, dst, i, end, window);
+   }
+}
+
+__attribute__((target("avx2")))
+void excessAvx2(const float* x, const float* leadSum, const float* lagSum, float* dst,
+                std::size_t n, float scale)
+{
+   const __m256 s = _mm256_set1_ps(scale);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256 ref = _mm256_add_ps(_mm256_loadu_ps(leadSum + i), _mm256_loadu_ps(lagSum + i));
+      _mm256_storeu_ps(dst + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(ref, s)));
+   }
+   excessScalar(x + i, leadSum + i, lagSum + i, dst + i, n - i, scale);
+}
+
+__attribute__((target("avx2")))
+std::size_t findAtLeastAvx2(const float* src, std::size_t n, float threshold)
+{
+   const __m256 t = _mm256_set1_ps(threshold);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      const auto mask = static_cast<unsigned>(
+         _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(src + i), t, _CMP_GE_OQ)));
+      if (mask != 0)
+      {
+         return i + static_cast<std::size_t>(std::countr_zero(mask));
+      }
+   }
+   return i + findAtLeastScalar(src + i, n - i, threshold);
+}
+
+__attribute__((target("avx2")))
+void cs8ToFloatAvx2(const int8_t* src, float* dst, std::size_t count, float scale)
+{
+   const __m256 s = _mm256_set1_ps(scale);
+   std::size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(raw));
+      const __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(raw, 8)));
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(lo, s));
+      _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(hi, s));
+   }
+   intToFloatScalar(src + i, dst + i, count - i, scale);
+}
+
+__attribute__((target("avx2")))
+void cs16ToFloatAvx2(const int16_t* src, float* dst, std::size_t count, float scale)
+{
+   const __m256 s = _mm256_set1_ps(scale);
+   std::size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw)), s));
+   }
+   intToFloatScalar(src + i, dst + i, count - i, scale);
+}
+
+__attribute__((target("avx2")))
+void floatToInt16Avx2(const float* src, int16_t* dst, std::size_t count, float scale)
+{
+   // Clamp before converting: out-of-range cvtps gives INT_MIN for both signs.
+   const __m256 s  = _mm256_set1_ps(scale);
+   const __m256 lo = _mm256_set1_ps(-32768.0F);
+   const __m256 hi = _mm256_set1_ps(32767.0F);
+   std::size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), s), lo), hi);
+      const __m256 b =
+         _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), s), lo), hi);
+      // packs works per 128-bit lane; restore the order afterwards.
+      const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_permute4x64_epi64(packed, 0xD8));
+   }
+   floatToInt16Scalar(src + i, dst + i, count - i, scale);
+}
+
+// Load 4 interleaved complex samples (8 values) as floats.
+__attribute__((target("avx2"))) __m256 load8Avx2(const int8_t* src)
+{
+   return _mm256_cvtepi32_ps(
+      _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+}
+
+__attribute__((target("avx2"))) __m256 load8Avx2(const int16_t* src)
+{
+   return _mm256_cvtepi32_ps(
+      _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+}
+
+__attribute__((target("avx2"))) __m256 load8Avx2(const float* src)
+{
+   return _mm256_loadu_ps(src);
+}
+
+// Shift a vector of 4 complex values up by `Lanes` complex positions, zero-filling.
+template <int Lanes>
+__attribute__((target("avx2"))) __m256 shiftComplexAvx2(__m256 v)
+{
+   const __m256d d = _mm256_castps_pd(v);
+   if constexpr (Lanes == 1)
+   {
+      return _mm256_castpd_ps(_mm256_blend_pd(
+         _mm256_permute4x64_pd(d, _MM_SHUFFLE(2, 1, 0, 0)), _mm256_setzero_pd(), 0x1));
+   }
+   else
+   {
+      return _mm256_castpd_ps(_mm256_blend_pd(
+         _mm256_permute4x64_pd(d, _MM_SHUFFLE(1, 0, 0, 0)), _mm256_setzero_pd(), 0x3));
+   }
+}
+
+// The recursion m_k = b * m_{k-1} + a * x_k is solved for 4 samples at once
+// as a log-step prefix scan: u = a*x; u += b*shift1(u); u += b²*shift2(u);
+// then m_k = u_k + b^(k+1) * m_prev.
+template <typename T>
+__attribute__((target("avx2")))
+void dcBlockAvx2(const T* src, float* dst, std::size_t n, float scale, float alpha, IqSample& mean)
+{
+   const DcDecay d   = dcDecay(alpha);
+   const __m256 s    = _mm256_set1_ps(scale);
+   const __m256 a    = _mm256_set1_ps(alpha);
+   const __m256 b1   = _mm256_set1_ps(d.b1);
+   const __m256 b2   = _mm256_set1_ps(d.b2);
+   const __m256 bPow = _mm256_setr_ps(d.b1, d.b1, d.b2, d.b2, d.b3, d.b3, d.b4, d.b4);
+   __m256 m = _mm256_setr_ps(mean.real(), mean.imag(), mean.real(), mean.imag(),
+                             mean.real(), mean.imag(), mean.real(), mean.imag());
+
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const __m256 x = _mm256_mul_ps(load8Avx2(src + (2 * i)), s);
+      __m256 u = _mm256_mul_ps(x, a);
+      u = _mm256_add_ps(u, _mm256_mul_ps(b1, shiftComplexAvx2<1>(u)));
+      u = _mm256_add_ps(u, _mm256_mul_ps(b2, shiftComplexAvx2<2>(u)));
+      const __m256 mk = _mm256_add_ps(u, _mm256_mul_ps(bPow, m));
+      _mm256_storeu_ps(dst + (2 * i), _mm256_sub_ps(x, mk));
+      m = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(mk), _MM_SHUFFLE(3, 3, 3, 3)));
+   }
+
+   alignas(16) float last[4];
+   _mm_store_ps(last, _mm256_castps256_ps128(m));
+   mean = {last[0], last[1]};
+   dcBlockScalar(src + (2 * i), dst + (2 * i), n - i, scale, alpha, mean);
+}
+
+#endif // SDRENGINE_KERNELS_AVX2
+
+// ============================================================================
+// NEON implementations (AArch64 / ARMv7 with NEON)
+// ============================================================================
+
+#if defined(SDRENGINE_KERNELS_NEON)
+
+float32x4_t fastLog2Neon(float32x4_t x)
+{
+   const uint32x4_t bits = vreinterpretq_u32_f32(x);
+   const float32x4_t expo = vcvtq_f32_s32(
+      vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(EXPONENT_BIAS)));
+   const uint32x4_t mant = vorrq_u32(vandq_u32(bits, vdupq_n_u32(MANTISSA_MASK)),
+                                     vdupq_n_u32(ONE_BITS));
+   const float32x4_t t = vsubq_f32(vreinterpretq_f32_u32(mant), vdupq_n_f32(1.0F));
+
+   float32x4_t poly = vdupq_n_f32(LOG2_C4);
+   poly = vaddq_f32(vmulq_f32(poly, t), vdupq_n_f32(LOG2_C3));
+   poly = vaddq_f32(vmulq_f32(poly, t), vdupq_n_f32(LOG2_C2));
+   poly = vaddq_f32(vmulq_f32(poly, t), vdupq_n_f32(LOG2_C1));
+   return vaddq_f32(expo, vmulq_f32(poly, t));
+}
+
+float32x4_t power4Neon(const float* spectrum)
+{
+   const float32x4x2_t v = vld2q_f32(spectrum);   // De-interleaves re / im.
+   return vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1]));
+}
+
+void windowNeon(const IqSample* src, const float* window, float* dst, std::size_t n)
+{
+   const auto* in = reinterpret_cast<const float*>(src);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const float32x4_t w = vld1q_f32(window + i);
+      float32x4x2_t v = vld2q_f32(in + (2 * i));
+      v.val[0] = vmulq_f32(v.val[0], w);
+      v.val[1] = vmulq_f32(v.val[1], w);
+      vst2q_f32(dst + (2 * i), v);
+   }
+   windowScalar(src + i, window + i, dst + (2 * i), n - i);
+}
+
+void powerNeon(const float* spectrum, float* dst, std::size_t n, float scale)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      vst1q_f32(dst + i, vmulq_n_f32(power4Neon(spectrum + (2 * i)), scale));
+   }
+   powerScalar(spectrum + (2 * i), dst + i, n - i, scale);
+}
+
+void powerDbNeon(const float* spectrum, float* dst, std::size_t n, float scale, float floorPower)
+{
+   const float32x4_t fl = vdupq_n_f32(floorPower);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const float32x4_t p = vmaxq_f32(vmulq_n_f32(power4Neon(spectrum + (2 * i)), scale), fl);
+      vst1q_f32(dst + i, vmulq_n_f32(fastLog2Neon(p), DB_PER_LOG2));
+   }
+   powerDbScalar(spectrum + (2 * i), dst + i, n - i, scale, floorPower);
+}
+
+void toDbNeon(const float* power, float* dst, std::size_t n, float scale, float floorPower)
+{
+   const float32x4_t fl = vdupq_n_f32(floorPower);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const float32x4_t p = vmaxq_f32(vmulq_n_f32(vld1q_f32(power + i), scale), fl);
+      vst1q_f32(dst + i, vmulq_n_f32(fastLog2Neon(p), DB_PER_LOG2));
+   }
+   toDbScalar(power + i, dst + i, n - i, scale, floorPower);
+}
+
+void averageNeon(float* avg, const float* x, std::size_t n, float alpha, float scale)
+{
+   const float beta = (1.0F - alpha) * scale;
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const float32x4_t v = vmlaq_n_f32(vmulq_n_f32(vld1q_f32(x + i), beta),
+                                        vld1q_f32(avg + i), alpha);
+      vst1q_f32(avg + i, v);
+   }
+   averageScalar(avg + i, x + i, n - i, alpha, scale);
+}
+
+void maxHoldNeon(const float* hold, const float* x, float* dst, std::size_t n, float decay)
+{
+   const float32x4_t d = vdupq_n_f32(decay);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      vst1q_f32(dst + i, vmaxq_f32(vsubq_f32(vld1q_f32(hold + i), d), vld1q_f32(x + i)));
+   }
+   maxHoldScalar(hold + i, x + i, dst + i, n - i, decay);
+}
+
+void minHoldNeon(const float* hold, const float* x, float* dst, std::size_t n)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      vst1q_f32(dst + i, vminq_f32(vld1q_f32(hold + i), vld1q_f32(x + i)));
+   }
+   minHoldScalar(hold + i, x + i, dst + i, n - i);
+}
+
+float maxValueNeon(const float* src, std::size_t n)
+{
+   if (n < 4)
+   {
+      return maxValueScalar(src, n);
+   }
+   float32x4_t m = vld1q_f32(src);
+   std::size_t i = 4;
+   for (; i + 4 <= n; i += 4)
+   {
+      m = vmaxq_f32(m, vld1q_f32(src + i));
+   }
+   float32x2_t r = vpmax_f32(vget_low_f32(m), vget_high_f32(m));
+   r = vpmax_f32(r, r);
+   float result = vget_lane_f32(r, 0);
+   for (; i < n; ++i)
+   {
+      result = std::max(result, src[i]);
+   }
+   return result;
+}
+
+float sumNeon(const float* src, std::size_t n)
+{
+   float32x4_t acc = vdupq_n_f32(0.0F);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      acc = vaddq_f32(acc, vld1q_f32(src + i));
+   }
+   return vaddvq_f32(acc) + sumScalar(src + i, n - i);
+}
+
+// Buckets of 4 values.  vmaxnm returns the number when one operand is NaN,
+// so NaN lands in bucket 0.
+uint16x4_t bucket4Neon(const float* src, float32x4_t lowest, float32x4_t invWidth,
+                       float32x4_t last)
+{
+   const float32x4_t v = vmulq_f32(vsubq_f32(vld1q_f32(src), lowest), invWidth);
+   return vmovn_u32(vcvtq_u32_f32(vminq_f32(vmaxnmq_f32(v, vdupq_n_f32(0.0F)), last)));
+}
+
+void bucketsNeon(const float* src, uint16_t* dst, std::size_t n, float lowest, float invWidth,
+                 float last)
+{
+   const float32x4_t vLowest = vdupq_n_f32(lowest);
+   const float32x4_t vInv    = vdupq_n_f32(invWidth);
+   const float32x4_t vLast   = vdupq_n_f32(last);
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      vst1q_u16(dst + i, vcombine_u16(bucket4Neon(src + i, vLowest, vInv, vLast),
+                                      bucket4Neon(src + i + 4, vLowest, vInv, vLast)));
+   }
+   bucketsScalar(src + i, dst + i, n - i, lowest, invWidth, last);
+}
+
+void firDecimateNeon(const float* x, const float* taps, std::size_t numTaps, float* y,
+                     std::size_t nOut, std::size_t decimation)
+{
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      const float* window = x + (i * decimation);
+      float32x4_t acc0 = vdupq_n_f32(0.0F);
+      float32x4_t acc1 = vdupq_n_f32(0.0F);
+      std::size_t k = 0;
+      for (; k + 8 <= numTaps; k += 8)
+      {
+         acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(taps + k), vld1q_f32(window + k)));
+         acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(taps + k + 4), vld1q_f32(window + k + 4)));
+      }
+      for (; k + 4 <= numTaps; k += 4)
+      {
+         acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(taps + k), vld1q_f32(window + k)));
+      }
+      const float32x4_t sum = vaddq_f32(acc0, acc1);
+      float32x2_t r = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+      r = vpadd_f32(r, r);
+      float acc = vget_lane_f32(r, 0);
+      for (; k < numTaps; ++k)
+      {
+         acc += taps[k] * window[k];
+      }
+      y[i] = acc;
+   }
+}
+
+void pairwiseMaxNeon(const float* src, float* dst, std::size_t nOut)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= nOut; i += 4)
+   {
+      const float32x4x2_t v = vld2q_f32(src + (2 * i));   // De-interleaves even / odd.
+      vst1q_f32(dst + i, vmaxq_f32(v.val[0], v.val[1]));
+   }
+   pairwiseMaxScalar(src + (2 * i), dst + i, nOut - i);
+}
+
+void pairwiseMinNeon(const float* src, float* dst, std::size_t nOut)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= nOut; i += 4)
+   {
+      const float32x4x2_t v = vld2q_f32(src + (2 * i));
+      vst1q_f32(dst + i, vminq_f32(v.val[0], v.val[1]));
+   }
+   pairwiseMinScalar(src + (2 * i), dst + i, nOut - i);
+}
+
+void pairwiseMeanNeon(const float* src, float* dst, std::size_t nOut)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= nOut; i += 4)
+   {
+      const float32x4x2_t v = vld2q_f32(src + (2 * i));
+      vst1q_f32(dst + i, vmulq_n_f32(vaddq_f32(v.val[0], v.val[1]), 0.5F));
+   }
+   pairwiseMeanScalar(src + (2 * i), dst + i, nOut - i);
+}
+
+// Four steps of the sliding-sum recurrence at once (see slidingSumAvx2()).
+void slidingSumNeon(const float* src, float* dst, std::size_t nOut, std::size_t window)
+{
+   const float32x4_t zero = vdupq_n_f32(0.0F);
+   for (std::size_t block = 0; block < nOut; block += SLIDING_SUM_RESTART)
+   {
+      const std::size_t end = std::min(nOut, block + SLIDING_SUM_RESTART);
+      dst[block] = sumScalar(src + block, window);
+      float32x4_t carry = vdupq_n_f32(dst[block]);
+      std::size_t i = block + 1;
+      for (; i + 4 <= end; i += 4)
+      {
+         float32x4_t d = vsubq_f32(vld1q_f32(src + i + window - 1), vld1q_f32(src + i - 1));
+         d = vaddq_f32(d, vextq_f32(zero, d, 3));
+         d = vaddq_f32(d, vextq_f32(zero, d, 2));
+         const float32x4_t sums = vaddq_f32(d, carry);
+         vst1q_f32(dst + i, sums);
+         carry = vdupq_laneq_f32(sums, 3);
+      }
+      slideScalar(src, dst, i, end, window);
+   }
+}
+
+void excessNeon(const float* x, const float* leadSum, const float* lagSum, float* dst,
+                std::size_t n, float scale)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      const float32x4_t ref = vaddq_f32(vld1q_f32(leadSum + i), vld1q_f32(lagSum + i));
+      vst1q_f32(dst + i, vmlsq_n_f32(vld1q_f32(x + i), ref, scale));
+   }
+   excessScalar(x + i, leadSum + i, lagSum + i, dst + i, n - i, scale);
+}
+
+std::size_t findAtLeastNeon(const float* src, std::size_t n, float threshold)
+{
+   const float32x4_t t = vdupq_n_f32(threshold);
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      if (vmaxvq_u32(vcgeq_f32(vld1q_f32(src + i), t)) != 0)
+      {
+         break;
+      }
+   }
+   return i + findAtLeastScalar(src + i, n - i, threshold);
+}
+
+void cs8ToFloatNeon(const int8_t* src, float* dst, std::size_t count, float scale)
+{
+   std::size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const int16x8_t wide = vmovl_s8(vld1_s8(src + i));
+      vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide))), scale));
+      vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide))), scale));
+   }
+   intToFloatScalar(src + i, dst + i, count - i, scale);
+}
+
+void cs16ToFloatNeon(const int16_t* src, float* dst, std::size_t count, float scale)
+{
+   std::size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const int16x8_t raw = vld1q_s16(src + i);
+      vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw))), scale));
+      vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw))), scale));
+   }
+   intToFloatScalar(src + i, dst + i, count - i, scale);
+}
+
+void floatToInt16Neon(const float* src, int16_t* dst, std::size_t count, float scale)
+{
+   // Both narrowing steps saturate.
+   std::size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const int32x4_t a = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), scale));
+      const int32x4_t b = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), scale));
+      vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+   }
+   floatToInt16Scalar(src + i, dst + i, count - i, scale);
+}
+
+// Load 4 interleaved complex samples (8 values) as two float vectors.
+void load8Neon(const int8_t* src, float32x4_t& lo, float32x4_t& hi)
+{
+   const int16x8_t wide = vmovl_s8(vld1_s8(src));
+   lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+   hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+}
+
+void load8Neon(const int16_t* src, float32x4_t& lo, float32x4_t& hi)
+{
+   const int16x8_t raw = vld1q_s16(src);
+   lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw)));
+   hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw)));
+}
+
+void load8Neon(const float* src, float32x4_t& lo, float32x4_t& hi)
+{
+   lo = vld1q_f32(src);
+   hi = vld1q_f32(src + 4);
+}
+
+// Two complex samples of the DC recursion (see dcBlockAvx2); `m` holds the
+// previous mean in both halves and is advanced.
+float32x4_t dcStep2Neon(float32x4_t x, float32x4_t& m, float alpha, float b1,
+                        float32x4_t bPow)
+{
+   float32x4_t u = vmulq_n_f32(x, alpha);
+   u = vaddq_f32(u, vmulq_n_f32(vcombine_f32(vdup_n_f32(0.0F), vget_low_f32(u)), b1));
+   const float32x4_t mk = vaddq_f32(u, vmulq_f32(bPow, m));
+   m = vcombine_f32(vget_high_f32(mk), vget_high_f32(mk));
+   return vsubq_f32(x, mk);
+}
+
+template <typename T>
+void dcBlockNeon(const T* src, float* dst, std::size_t n, float scale, float alpha, IqSample& mean)
+{
+   const DcDecay d = dcDecay(alpha);
+   const float bPowInit[4] = {d.b1, d.b1, d.b2, d.b2};
+   const float meanInit[4] = {mean.real(), mean.imag(), mean.real(), mean.imag()};
+   const float32x4_t bPow = vld1q_f32(bPowInit);
+   float32x4_t m = vld1q_f32(meanInit);
+
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      float32x4_t lo;
+      float32x4_t hi;
+      load8Neon(src + (2 * i), lo, hi);
+      vst1q_f32(dst + (2 * i), dcStep2Neon(vmulq_n_f32(lo, scale), m, alpha, d.b1, bPow));
+      vst1q_f32(dst + (2 * i) + 4, dcStep2Neon(vmulq_n_f32(hi, scale), m, alpha, d.b1, bPow));
+   }
+
+   mean = {vgetq_lane_f32(m, 0), vgetq_lane_f32(m, 1)};
+   dcBlockScalar(src + (2 * i), dst + (2 * i), n - i, scale, alpha, mean);
+}
+
+#endif // SDRENGINE_KERNELS_NEON
+
+} // anonymous namespace
+
+// ============================================================================
+// Public dispatch
+// ============================================================================
+
+const char* dspKernelIsa()
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   return cpuHasAvx2() ? "avx2" : "scalar";
+#elif defined(SDRENGINE_KERNELS_NEON)
+   return "neon";
+#else
+   return "scalar";
+#endif
+}
+
+void applyWindowInterleaved(const IqSample* src, const float* window, float* dst, std::size_t n)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      windowAvx2(src, window, dst, n);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   windowNeon(src, window, dst, n);
+   return;
+#endif
+   windowScalar(src, window, dst, n);
+}
+
+void powerInterleaved(const float* spectrum, float* dst, std::size_t n, float scale)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      powerAvx2(spectrum, dst, n, scale);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   powerNeon(spectrum, dst, n, scale);
+   return;
+#endif
+   powerScalar(spectrum, dst, n, scale);
+}
+
+void powerDbInterleaved(const float* spectrum, float* dst, std::size_t n, float scale,
+                        float floorPower)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      powerDbAvx2(spectrum, dst, n, scale, floorPower);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   powerDbNeon(spectrum, dst, n, scale, floorPower);
+   return;
+#endif
+   powerDbScalar(spectrum, dst, n, scale, floorPower);
+}
+
+void powerToDb(const float* power, float* dst, std::size_t n, float scale, float floorPower)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      toDbAvx2(power, dst, n, scale, floorPower);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   toDbNeon(power, dst, n, scale, floorPower);
+   return;
+#endif
+   toDbScalar(power, dst, n, scale, floorPower);
+}
+
+void exponentialAverage(float* avg, const float* x, std::size_t n, float alpha, float scale)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      averageAvx2(avg, x, n, alpha, scale);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   averageNeon(avg, x, n, alpha, scale);
+   return;
+#endif
+   averageScalar(avg, x, n, alpha, scale);
+}
+
+void maxHoldUpdate(const float* hold, const float* x, float* dst, std::size_t n, float decay)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      maxHoldAvx2(hold, x, dst, n, decay);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   maxHoldNeon(hold, x, dst, n, decay);
+   return;
+#endif
+   maxHoldScalar(hold, x, dst, n, decay);
+}
+
+void minHoldUpdate(const float* hold, const float* x, float* dst, std::size_t n)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      minHoldAvx2(hold, x, dst, n);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   minHoldNeon(hold, x, dst, n);
+   return;
+#endif
+   minHoldScalar(hold, x, dst, n);
+}
+
+float maxValue(const float* src, std::size_t n)
+{
+   if (n == 0)
+   {
+      return 0.0F;
+   }
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      return maxValueAvx2(src, n);
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   return maxValueNeon(src, n);
+#endif
+   return maxValueScalar(src, n);
+}
+
+float sumValues(const float* src, std::size_t n)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      return sumAvx2(src, n);
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   return sumNeon(src, n);
+#endif
+   return sumScalar(src, n);
+}
+
+void histogramBuckets(const float* src, uint16_t* dst, std::size_t n, float lowest,
+                      float invWidth, uint16_t lastBucket)
+{
+   const auto last = static_cast<float>(lastBucket);
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      bucketsAvx2(src, dst, n, lowest, invWidth, last);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   bucketsNeon(src, dst, n, lowest, invWidth, last);
+   return;
+#endif
+   bucketsScalar(src, dst, n, lowest, invWidth, last);
+}
+
+void pairwiseMax(const float* src, float* dst, std::size_t nOut)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      pairwiseMaxAvx2(src, dst, nOut);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   pairwiseMaxNeon(src, dst, nOut);
+   return;
+#endif
+   pairwiseMaxScalar(src, dst, nOut);
+}
+
+void pairwiseMin(const float* src, float* dst, std::size_t nOut)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      pairwiseMinAvx2(src, dst, nOut);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   pairwiseMinNeon(src, dst, nOut);
+   return;
+#endif
+   pairwiseMinScalar(src, dst, nOut);
+}
+
+void pairwiseMean(const float* src, float* dst, std::size_t nOut)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      pairwiseMeanAvx2(src, dst, nOut);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   pairwiseMeanNeon(src, dst, nOut);
+   return;
+#endif
+   pairwiseMeanScalar(src, dst, nOut);
+}
+
+void slidingSum(const float* src, float* dst, std::size_t nOut, std::size_t window)
+{
+   if (window == 0)
+   {
+      std::fill(dst, dst + nOut, 0.0F);
+      return;
+   }
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      slidingSumAvx2(src, dst, nOut, window);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   slidingSumNeon(src, dst, nOut, window);
+   return;
+#endif
+   slidingSumScalar(src, dst, nOut, window);
+}
+
+void excessOverReference(const float* x, const float* leadSum, const float* lagSum, float* dst,
+                         std::size_t n, float scale)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      excessAvx2(x, leadSum, lagSum, dst, n, scale);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   excessNeon(x, leadSum, lagSum, dst, n, scale);
+   return;
+#endif
+   excessScalar(x, leadSum, lagSum, dst, n, scale);
+}
+
+std::size_t findFirstAtLeast(const float* src, std::size_t n, float threshold)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      return findAtLeastAvx2(src, n, threshold);
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   return findAtLeastNeon(src, n, threshold);
+#endif
+   return findAtLeastScalar(src, n, threshold);
+}
+
+void firDecimate(const float* x, const float* taps, std::size_t numTaps, float* y,
+                 std::size_t nOut, std::size_t decimation)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      firDecimateAvx2(x, taps, numTaps, y, nOut, decimation);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   firDecimateNeon(x, taps, numTaps, y, nOut, decimation);
+   return;
+#endif
+   firDecimateScalar(x, taps, numTaps, y, nOut, decimation);
+}
+
+void convertCs8ToIq(const int8_t* src, IqSample* dst, std::size_t n, float scale)
+{
+   auto* out = reinterpret_cast<float*>(dst);
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      cs8ToFloatAvx2(src, out, 2 * n, scale);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   cs8ToFloatNeon(src, out, 2 * n, scale);
+   return;
+#endif
+   intToFloatScalar(src, out, 2 * n, scale);
+}
+
+void convertCs16ToIq(const int16_t* src, IqSample* dst, std::size_t n, float scale)
+{
+   auto* out = reinterpret_cast<float*>(dst);
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      cs16ToFloatAvx2(src, out, 2 * n, scale);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   cs16ToFloatNeon(src, out, 2 * n, scale);
+   return;
+#endif
+   intToFloatScalar(src, out, 2 * n, scale);
+}
+
+void convertIqToCs16(const IqSample* src, int16_t* dst, std::size_t n, float scale)
+{
+   const auto* in = reinterpret_cast<const float*>(src);
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      floatToInt16Avx2(in, dst, 2 * n, scale);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   floatToInt16Neon(in, dst, 2 * n, scale);
+   return;
+#endif
+   floatToInt16Scalar(in, dst, 2 * n, scale);
+}
+
+void convertToIq(const RawIqBlock& block, std::size_t first, IqSample* dst, std::size_t count)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   const float scale = 1.0F / block.fullScale;
+   switch (block.format)
+   {
+      case IqSampleFormat::CF32:
+         std::memcpy(dst, static_cast<const IqSample*>(block.data) + first,
+                     count * sizeof(IqSample));
+         break;
+      case IqSampleFormat::CS16:
+         convertCs16ToIq(static_cast<const int16_t*>(block.data) + (2 * first), dst, count, scale);
+         break;
+      case IqSampleFormat::CS8:
+         convertCs8ToIq(static_cast<const int8_t*>(block.data) + (2 * first), dst, count, scale);
+         break;
+   }
+}
+
+void convertToCs16(const RawIqBlock& block, std::size_t first, int16_t* dst, std::size_t count)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   switch (block.format)
+   {
+      case IqSampleFormat::CF32:
+         convertIqToCs16(static_cast<const IqSample*>(block.data) + first, dst, count,
+                         CS16_FULL_SCALE);
+         break;
+      case IqSampleFormat::CS16:
+         std::memcpy(dst, static_cast<const int16_t*>(block.data) + (2 * first),
+                     2 * count * sizeof(int16_t));
+         break;
+      case IqSampleFormat::CS8:
+         std::copy_n(static_cast<const int8_t*>(block.data) + (2 * first), 2 * count, dst);
+         break;
+   }
+}
+
+float cs16FullScale(const RawIqBlock& block)
+{
+   return (block.format == IqSampleFormat::CF32) ? CS16_FULL_SCALE : block.fullScale;
+}
+
+float dcBlockerAlpha(float timeConstantSec, double sampleRateHz)
+{
+   if (timeConstantSec <= 0.0F || sampleRateHz <= 0.0)
+   {
+      return 1.0F;
+   }
+   return static_cast<float>(-std::expm1(-1.0 / (static_cast<double>(timeConstantSec) * sampleRateHz)));
+}
+
+namespace
+{
+
+template <typename T>
+void dcBlockDispatch(const T* src, float* dst, std::size_t n, float scale, float alpha,
+                     IqSample& mean)
+{
+#if defined(SDRENGINE_KERNELS_AVX2)
+   if (cpuHasAvx2())
+   {
+      dcBlockAvx2(src, dst, n, scale, alpha, mean);
+      return;
+   }
+#elif defined(SDRENGINE_KERNELS_NEON)
+   dcBlockNeon(src, dst, n, scale, alpha, mean);
+   return;
+#endif
+   dcBlockScalar(src, dst, n, scale, alpha, mean);
+}
+
+} // anonymous namespace
+
+void convertToIqDcBlocked(const RawIqBlock& block, std::size_t first, IqSample* dst,
+                          std::size_t count, DcBlockerState& state)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   auto* out = reinterpret_cast<float*>(dst);
+   const float scale = 1.0F / block.fullScale;
+   switch (block.format)
+   {
+      case IqSampleFormat::CF32:
+         dcBlockDispatch(static_cast<const float*>(block.data) + (2 * first), out, count, 1.0F,
+                         state.alpha, state.mean);
+         break;
+      case IqSampleFormat::CS16:
+         dcBlockDispatch(static_cast<const int16_t*>(block.data) + (2 * first), out, count, scale,
+                         state.alpha, state.mean);
+         break;
+      case IqSampleFormat::CS8:
+         dcBlockDispatch(static_cast<const int8_t*>(block.data) + (2 * first), out, count, scale,
+                         state.alpha, state.mean);
+         break;
+   }
+}
+
+void fftShift(const float* src, float* dst, std::size_t n)
+{
+   // src[0, n - half) → dst[half, n);  src[n - half, n) → dst[0, half).
+   const std::size_t half = n / 2;
+   std::copy(src, src + (n - half), dst + half);
+   std::copy(src + (n - half), src + n, dst);
+}
+
+float fastLog10Db(float x)
+{
+   return DB_PER_LOG2 * fastLog2Scalar(x);
+}
+
+} // namespace SdrEngine
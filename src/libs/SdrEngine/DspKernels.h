@@ -0,0 +1,270 @@
+#ifndef DSPKERNELS_H_
+#define DSPKERNELS_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Vectorised inner loops for the FFT and demodulation paths.
+//
+// Each kernel has an AVX2 (x86-64, selected at run time), NEON (AArch64)
+// and scalar implementation; all produce the same results to within the
+// documented tolerance.  Buffers need no particular alignment.
+// ============================================================================
+
+/**
+ * @brief Name of the instruction set the kernels dispatch to on this CPU.
+ * @return "avx2", "neon" or "scalar".
+ */
+[[nodiscard]] const char* dspKernelIsa();
+
+/**
+ * @brief Multiply complex samples by a real window into interleaved floats.
+ *
+ * `dst[2i] = src[i].real() * window[i]`, `dst[2i+1] = src[i].imag() * window[i]`.
+ *
+ * @param src     `n` complex samples.
+ * @param window  `n` window coefficients.
+ * @param dst     `2n` floats (FFTW interleaved complex layout).
+ * @param n       Number of samples.
+ */
+void applyWindowInterleaved(const IqSample* src, const float* window, float* dst, std::size_t n);
+
+/**
+ * @brief Scaled power of interleaved complex bins: `dst[i] = (re² + im²) * scale`.
+ * @param spectrum  `2n` floats (interleaved re/im).
+ * @param dst       `n` output values.
+ * @param n         Number of bins.
+ * @param scale     Multiplier applied to every bin (e.g. 1 / norm²).
+ */
+void powerInterleaved(const float* spectrum, float* dst, std::size_t n, float scale);
+
+/**
+ * @brief Scaled power of interleaved complex bins in dB:
+ *        `dst[i] = 10 * log10(max((re² + im²) * scale, floorPower))`.
+ *
+ * Uses fastLog10Db(); absolute error is below 0.001 dB.
+ *
+ * @param floorPower  Smallest power passed to the log (must be a normal float).
+ */
+void powerDbInterleaved(const float* spectrum, float* dst, std::size_t n, float scale,
+                        float floorPower);
+
+/**
+ * @brief Convert linear power values to dB:
+ *        `dst[i] = 10 * log10(max(power[i] * scale, floorPower))`.
+ * `power` and `dst` may alias.  Same accuracy as powerDbInterleaved().
+ */
+void powerToDb(const float* power, float* dst, std::size_t n, float scale, float floorPower);
+
+/**
+ * @brief Exponential moving average in place:
+ *        `avg[i] = alpha * avg[i] + (1 - alpha) * x[i] * scale`.
+ * @param avg    `n` running averages, updated in place.
+ * @param x      `n` new values.
+ * @param alpha  Weight of the previous average, in [0, 1].
+ * @param scale  Multiplier applied to `x` (e.g. 1 / segments).
+ */
+void exponentialAverage(float* avg, const float* x, std::size_t n, float alpha, float scale);
+
+/**
+ * @brief Decaying peak hold: `dst[i] = max(hold[i] - decay, x[i])`.
+ * `dst` may alias `hold` or `x`.
+ */
+void maxHoldUpdate(const float* hold, const float* x, float* dst, std::size_t n, float decay);
+
+/**
+ * @brief Minimum hold: `dst[i] = min(hold[i], x[i])`.
+ * `dst` may alias `hold` or `x`.
+ */
+void minHoldUpdate(const float* hold, const float* x, float* dst, std::size_t n);
+
+/**
+ * @brief Largest of `n` values.
+ * @return The maximum, or 0 for an empty range.
+ */
+[[nodiscard]] float maxValue(const float* src, std::size_t n);
+
+/**
+ * @brief Sum of `n` values.
+ * The vector paths keep one partial sum per lane, so the result can differ
+ * from a sequential sum by float rounding.
+ * @return The sum, or 0 for an empty range.
+ */
+[[nodiscard]] float sumValues(const float* src, std::size_t n);
+
+/**
+ * @brief Histogram bucket of each value:
+ *        `dst[i] = clamp(floor((src[i] - lowest) * invWidth), 0, lastBucket)`.
+ * Values below `lowest` and NaN go to bucket 0, values above the range to
+ * `lastBucket`.
+ * @param src         `n` values.
+ * @param dst         `n` bucket indices.
+ * @param lowest      Lower edge of bucket 0.
+ * @param invWidth    1 / bucket width.
+ * @param lastBucket  Highest bucket index.
+ */
+void histogramBuckets(const float* src, uint16_t* dst, std::size_t n, float lowest,
+                      float invWidth, uint16_t lastBucket);
+
+/**
+ * @brief Halve a trace by pairs: `dst[i] = max(src[2i], src[2i+1])`.
+ * @param src   `2 * nOut` values.
+ * @param dst   `nOut` outputs (must not overlap `src`).
+ * @param nOut  Number of output values.
+ */
+void pairwiseMax(const float* src, float* dst, std::size_t nOut);
+
+/** @brief Halve a trace by pairs: `dst[i] = min(src[2i], src[2i+1])`. */
+void pairwiseMin(const float* src, float* dst, std::size_t nOut);
+
+/** @brief Halve a trace by pairs: `dst[i] = (src[2i] + src[2i+1]) / 2`. */
+void pairwiseMean(const float* src, float* dst, std::size_t nOut);
+
+/**
+ * @brief Sums of a sliding window: `dst[i] = sum_k src[i + k]`, `k < window`.
+ *
+ * Runs the recurrence `dst[i] = dst[i-1] + src[i+window-1] - src[i-1]`;
+ * the vector paths solve it for a whole vector at once with a prefix scan.
+ * The running sum is restarted from a direct sum every 256 outputs, so
+ * float rounding cannot drift across long traces.
+ *
+ * @param src     `nOut + window - 1` values.
+ * @param dst     `nOut` sums (must not overlap `src`).
+ * @param nOut    Number of sums.
+ * @param window  Values per sum (>= 1).
+ */
+void slidingSum(const float* src, float* dst, std::size_t nOut, std::size_t window);
+
+/**
+ * @brief Excess of each value over the mean of two reference windows:
+ *        `dst[i] = x[i] - (leadSum[i] + lagSum[i]) * scale`.
+ * `dst` may alias `x`.
+ * @param scale  1 / number of values in the two windows together.
+ */
+void excessOverReference(const float* x, const float* leadSum, const float* lagSum, float* dst,
+                         std::size_t n, float scale);
+
+/**
+ * @brief Index of the first value at or above a threshold.
+ * The vector paths test a whole vector per compare, so long runs below the
+ * threshold (noise between signals) are skipped quickly.  NaN never matches.
+ * @return The index, or `n` if no value reaches `threshold`.
+ */
+[[nodiscard]] std::size_t findFirstAtLeast(const float* src, std::size_t n, float threshold);
+
+/**
+ * @brief Real FIR filter with output decimation, as a sliding dot product:
+ *        `y[i] = sum_k taps[k] * x[i * decimation + k]`.
+ *
+ * `taps` are applied in correlation order, so pass a filter's impulse
+ * response reversed (symmetric filters need no reversal).  Only the kept
+ * outputs are computed.
+ *
+ * @param x           `(nOut - 1) * decimation + numTaps` input values.
+ * @param taps        `numTaps` coefficients.
+ * @param y           `nOut` outputs (must not overlap `x`).
+ * @param nOut        Number of outputs.
+ * @param decimation  Input step between outputs (>= 1).
+ */
+void firDecimate(const float* x, const float* taps, std::size_t numTaps, float* y,
+                 std::size_t nOut, std::size_t decimation);
+
+/**
+ * @brief Convert interleaved signed 8-bit I/Q (SoapySDR CS8) to IqSample.
+ * @param src    `2n` values (I, Q, I, Q, ...).
+ * @param dst    `n` output samples.
+ * @param n      Number of complex samples.
+ * @param scale  Multiplier applied to every value (1 / full scale).
+ */
+void convertCs8ToIq(const int8_t* src, IqSample* dst, std::size_t n, float scale);
+
+/** @brief Convert interleaved signed 16-bit I/Q (SoapySDR CS16) to IqSample. */
+void convertCs16ToIq(const int16_t* src, IqSample* dst, std::size_t n, float scale);
+
+/**
+ * @brief Convert IqSample to interleaved signed 16-bit I/Q, the inverse of
+ *        convertCs16ToIq(): `dst[2i] = round(src[i].real() * scale)`, etc.
+ * Values beyond the int16 range saturate; NaN gives an unspecified value.
+ * @param src    `n` samples.
+ * @param dst    `2n` values (I, Q, I, Q, ...).
+ * @param n      Number of complex samples.
+ * @param scale  Multiplier applied before rounding (full scale).
+ */
+void convertIqToCs16(const IqSample* src, int16_t* dst, std::size_t n, float scale);
+
+/**
+ * @brief Convert samples `[first, first + count)` of a native-format block
+ *        to IqSample, scaled by `1 / block.fullScale` (CF32 is copied as is).
+ */
+void convertToIq(const RawIqBlock& block, std::size_t first, IqSample* dst, std::size_t count);
+
+/**
+ * @brief Copy samples `[first, first + count)` of a native-format block to
+ *        interleaved int16 at full scale cs16FullScale(block).
+ * CS16 is copied as is and CS8 widened, so integer sources lose nothing;
+ * CF32 is converted with convertIqToCs16().
+ * @param dst  `2 * count` values (I, Q, I, Q, ...).
+ */
+void convertToCs16(const RawIqBlock& block, std::size_t first, int16_t* dst, std::size_t count);
+
+/**
+ * @brief The int16 value that convertToCs16() output for `block` maps to 1.0.
+ * @return `block.fullScale` for integer formats, CS16_FULL_SCALE for CF32.
+ */
+[[nodiscard]] float cs16FullScale(const RawIqBlock& block);
+
+/**
+ * @class DcBlockerState
+ * @brief Running state of the single-pole DC blocker (see convertToIqDcBlocked()).
+ */
+struct DcBlockerState
+{
+   float alpha{1.0e-4F};   ///< Per-sample tracking factor, from dcBlockerAlpha().
+   IqSample mean{};        ///< Current DC estimate; carried across blocks.
+};
+
+/**
+ * @brief Tracking factor for a DC blocker with the given time constant.
+ * @return `1 - exp(-1 / (tau * fs))`, or 1 for a non-positive input.
+ */
+[[nodiscard]] float dcBlockerAlpha(float timeConstantSec, double sampleRateHz);
+
+/**
+ * @brief convertToIq() fused with a single-pole DC blocker, in one pass.
+ *
+ * Per sample: `m += alpha * (x - m)`, `dst = x - m`.  The vector paths
+ * solve four steps of the recursion at once with a prefix scan, so the
+ * result matches the scalar recursion to float rounding.  Unlike a
+ * per-block mean, the output does not depend on how input is chunked.
+ * `dst` may alias a CF32 block's data.
+ */
+void convertToIqDcBlocked(const RawIqBlock& block, std::size_t first, IqSample* dst,
+                          std::size_t count, DcBlockerState& state);
+
+/**
+ * @brief Out-of-place fftshift as two contiguous copies (no per-bin modulo).
+ *
+ * Equivalent to `dst[(i + n / 2) % n] = src[i]` for every `i`.
+ */
+void fftShift(const float* src, float* dst, std::size_t n);
+
+/**
+ * @brief Scalar form of the fast `10 * log10(x)` used by the dB kernels.
+ *
+ * Splits `x` into exponent and mantissa and evaluates a 4th-order
+ * polynomial for log2 of the mantissa (max error 1.2e-4 in log2, i.e.
+ * about 0.0004 dB).  `x` must be a positive normal float.
+ */
+[[nodiscard]] float fastLog10Db(float x);
+
+} // namespace SdrEngine
+
+#endif // DSPKERNELS_H_
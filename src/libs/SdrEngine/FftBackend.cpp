@@ -0,0 +1,423 @@
+// Project headers
+#include "FftBackend.h"
+#include "BuiltinFft.h"
+#include "FftwPlanner.h"
+#include "GeneralLogger.h"
+
+// Third-party headers
+#include <fftw3.h>
+
+// System headers
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <utility>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// ============================================================================
+// FFTW
+// ============================================================================
+
+// 1-D plan measured at construction; many-plans for batches of 1, 2, 4, ...
+// frames built on first use with FFTW_ESTIMATE.
+class FftwTransform final : public FftTransform
+{
+public:
+   explicit FftwTransform(std::size_t size);
+   ~FftwTransform() override;
+
+   FftwTransform(const FftwTransform&) = delete;
+   FftwTransform& operator=(const FftwTransform&) = delete;
+   FftwTransform(FftwTransform&&) = delete;
+   FftwTransform& operator=(FftwTransform&&) = delete;
+
+   [[nodiscard]] FftBackend backend() const override { return FftBackend::Fftw; }
+   [[nodiscard]] bool valid() const override { return _plan != nullptr; }
+   [[nodiscard]] float* input() override { return _in; }
+   [[nodiscard]] const float* output() const override { return _out; }
+   void execute() override;
+
+   [[nodiscard]] bool prepareBatch(std::size_t frames, std::size_t capacity) override;
+   [[nodiscard]] float* batchInput() override { return _batchIn; }
+   [[nodiscard]] const float* batchOutput() const override { return _batchOut; }
+   void executeBatch(std::size_t frames) override;
+   void releaseBatch() override;
+
+private:
+   static constexpr std::size_t BATCH_PLAN_SLOTS = 8;   // Up to 128 frames.
+
+   float* _in{nullptr};
+   float* _out{nullptr};
+   fftwf_plan_s* _plan{nullptr};
+
+   float* _batchIn{nullptr};
+   float* _batchOut{nullptr};
+   std::array<fftwf_plan_s*, BATCH_PLAN_SLOTS> _batchPlans{};
+};
+
+FftwTransform::FftwTransform(std::size_t size)
+   : FftTransform{size}
+{
+   // Allocate FFTW-aligned buffers (interleaved complex = 2× floats).
+   _in  = fftwf_alloc_real(2 * size);
+   _out = fftwf_alloc_real(2 * size);
+   if (_in == nullptr || _out == nullptr)
+   {
+      GPERROR("FFTW memory allocation failed for FFT size {}", size);
+      return;
+   }
+
+   // Create a complex-to-complex plan (DFT_1D, forward).  MEASURE is fast
+   // when the wisdom already covers this size.
+   const std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+   _plan = fftwf_plan_dft_1d(static_cast<int>(size), reinterpret_cast<fftwf_complex*>(_in),
+                             reinterpret_cast<fftwf_complex*>(_out), FFTW_FORWARD, FFTW_MEASURE);
+}
+
+FftwTransform::~FftwTransform()
+{
+   releaseBatch();
+   if (_plan != nullptr)
+   {
+      const std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+      fftwf_destroy_plan(_plan);
+   }
+   if (_in != nullptr)
+   {
+      fftwf_free(_in);
+   }
+   if (_out != nullptr)
+   {
+      fftwf_free(_out);
+   }
+}
+
+void FftwTransform::execute()
+{
+   if (_plan != nullptr)
+   {
+      fftwf_execute(_plan);
+   }
+}
+
+bool FftwTransform::prepareBatch(std::size_t frames, std::size_t capacity)
+{
+   const auto slot = static_cast<std::size_t>(std::countr_zero(frames));
+   if (!std::has_single_bit(frames) || frames > capacity || slot >= _batchPlans.size())
+   {
+      return false;
+   }
+   if (_batchPlans[slot] != nullptr)
+   {
+      return true;
+   }
+
+   const std::size_t n = size();
+   if (_batchIn == nullptr)
+   {
+      const std::size_t floats = 2 * n * capacity;
+      _batchIn  = fftwf_alloc_real(floats);
+      _batchOut = fftwf_alloc_real(floats);
+      if (_batchIn == nullptr || _batchOut == nullptr)
+      {
+         GPERROR("FFTW batch allocation failed for FFT size {}", n);
+         releaseBatch();
+         return false;
+      }
+   }
+
+   // Never wait on the planner from the processing thread: a background
+   // MEASURE run can hold it for seconds.  Try again on the next batch.
+   const std::unique_lock<std::mutex> lock(fftwPlannerMutex(), std::try_to_lock);
+   if (!lock.owns_lock())
+   {
+      return false;
+   }
+
+   // FFTW_ESTIMATE: batch plans are built lazily on the processing thread,
+   // so they must not stall it the way a MEASURE run would.
+   const int length = static_cast<int>(n);
+   _batchPlans[slot] = fftwf_plan_many_dft(
+      1, &length, static_cast<int>(frames),
+      reinterpret_cast<fftwf_complex*>(_batchIn), nullptr, 1, length,
+      reinterpret_cast<fftwf_complex*>(_batchOut), nullptr, 1, length,
+      FFTW_FORWARD, FFTW_ESTIMATE);
+   return _batchPlans[slot] != nullptr;
+}
+
+void FftwTransform::executeBatch(std::size_t frames)
+{
+   fftwf_execute(_batchPlans[static_cast<std::size_t>(std::countr_zero(frames))]);
+}
+
+void FftwTransform::releaseBatch()
+{
+   {
+      const std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+      for (auto& batch : _batchPlans)
+      {
+         if (batch != nullptr)
+         {
+            fftwf_destroy_plan(batch);
+            batch = nullptr;
+         }
+      }
+   }
+   if (_batchIn != nullptr)
+   {
+      fftwf_free(_batchIn);
+      _batchIn = nullptr;
+   }
+   if (_batchOut != nullptr)
+   {
+      fftwf_free(_batchOut);
+      _batchOut = nullptr;
+   }
+}
+
+// ============================================================================
+// Builtin
+// ============================================================================
+
+// BuiltinFft with its own buffers; a batch is a loop over its frames.
+class BuiltinTransform final : public FftTransform
+{
+public:
+   explicit BuiltinTransform(std::size_t size)
+      : FftTransform{size}
+      , _fft{size}
+      , _in(2 * size)
+      , _out(2 * size)
+   {
+   }
+
+   [[nodiscard]] FftBackend backend() const override { return FftBackend::Builtin; }
+   [[nodiscard]] bool valid() const override { return BuiltinFft::supports(size()); }
+   [[nodiscard]] float* input() override { return _in.data(); }
+   [[nodiscard]] const float* output() const override { return _out.data(); }
+
+   void execute() override
+   {
+      if (valid())
+      {
+         _fft.forward(_in.data(), _out.data());
+      }
+   }
+
+   [[nodiscard]] bool prepareBatch(std::size_t frames, std::size_t capacity) override
+   {
+      if (!valid() || frames > capacity)
+      {
+         return false;
+      }
+      _batchIn.resize(2 * size() * capacity);
+      _batchOut.resize(2 * size() * capacity);
+      return true;
+   }
+
+   [[nodiscard]] float* batchInput() override { return _batchIn.data(); }
+   [[nodiscard]] const float* batchOutput() const override { return _batchOut.data(); }
+
+   void executeBatch(std::size_t frames) override
+   {
+      for (std::size_t f = 0; f < frames; ++f)
+      {
+         _fft.forward(_batchIn.data() + (2 * size() * f), _batchOut.data() + (2 * size() * f));
+      }
+   }
+
+   void releaseBatch() override
+   {
+      _batchIn  = {};
+      _batchOut = {};
+   }
+
+private:
+   BuiltinFft _fft;
+   std::vector<float> _in;
+   std::vector<float> _out;
+   std::vector<float> _batchIn;
+   std::vector<float> _batchOut;
+};
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+// Concrete backends, in order of preference when they tie.
+constexpr std::array<FftBackend, 2> CONCRETE_BACKENDS = {FftBackend::Fftw, FftBackend::Builtin};
+
+// A benchmark repeats a transform for at least this long.
+constexpr std::chrono::microseconds BENCHMARK_MIN_TIME{1000};
+constexpr int BENCHMARK_MIN_RUNS = 3;
+
+std::unique_ptr<FftTransform> makeConcrete(FftBackend backend, std::size_t size)
+{
+   if (backend == FftBackend::Builtin)
+   {
+      return BuiltinFft::supports(size) ? std::make_unique<BuiltinTransform>(size) : nullptr;
+   }
+   auto transform = std::make_unique<FftwTransform>(size);
+   return transform->valid() ? std::move(transform) : nullptr;
+}
+
+// Best time of one execute(), in nanoseconds.
+double timeTransform(FftTransform& transform)
+{
+   std::mt19937 rng(1);
+   std::uniform_real_distribution<float> noise(-1.0F, 1.0F);
+   std::generate_n(transform.input(), 2 * transform.size(), [&] { return noise(rng); });
+   transform.execute();   // Warm the caches.
+
+   using Clock = std::chrono::steady_clock;
+   auto best        = Clock::duration::max();
+   const auto began = Clock::now();
+   int runs         = 0;
+   while (runs < BENCHMARK_MIN_RUNS || Clock::now() - began < BENCHMARK_MIN_TIME)
+   {
+      const auto start = Clock::now();
+      transform.execute();
+      best = std::min(best, Clock::now() - start);
+      ++runs;
+   }
+   return std::chrono::duration<double, std::nano>(best).count();
+}
+
+// Time every backend that can do `size`; the transforms are kept, so the
+// winner can be used without planning it again.
+std::vector<std::pair<FftBackendTiming, std::unique_ptr<FftTransform>>> runBenchmark(
+   std::size_t size)
+{
+   std::vector<std::pair<FftBackendTiming, std::unique_ptr<FftTransform>>> results;
+   for (const FftBackend backend : CONCRETE_BACKENDS)
+   {
+      if (auto transform = makeConcrete(backend, size))
+      {
+         const double ns = timeTransform(*transform);
+         results.emplace_back(FftBackendTiming{backend, ns}, std::move(transform));
+      }
+   }
+   std::stable_sort(results.begin(), results.end(), [](const auto& a, const auto& b)
+                    { return a.first.nsPerTransform < b.first.nsPerTransform; });
+   return results;
+}
+
+// Backend chosen for each size benchmarked so far.
+std::mutex& selectionMutex()
+{
+   static std::mutex mutex;
+   return mutex;
+}
+
+std::map<std::size_t, FftBackend>& selections()
+{
+   static std::map<std::size_t, FftBackend> chosen;
+   return chosen;
+}
+
+// Benchmark `size`, remember the winner and hand back its transform.
+std::unique_ptr<FftTransform> selectAndMake(std::size_t size)
+{
+   auto results = runBenchmark(size);
+   if (results.empty())
+   {
+      return nullptr;
+   }
+   const FftBackendTiming& best = results.front().first;
+   {
+      const std::lock_guard<std::mutex> lock(selectionMutex());
+      selections().emplace(size, best.backend);
+   }
+   GPINFO("FFT backend for size {}: {} ({:.1f} us per transform)", size,
+          fftBackendName(best.backend), best.nsPerTransform / 1000.0);
+   return std::move(results.front().second);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+const char* fftBackendName(FftBackend backend)
+{
+   switch (backend)
+   {
+   case FftBackend::Auto:
+      return "auto";
+   case FftBackend::Fftw:
+      return "fftw";
+   case FftBackend::Builtin:
+      return "builtin";
+   }
+   return "unknown";
+}
+
+std::unique_ptr<FftTransform> makeFftTransform(FftBackend backend, std::size_t size)
+{
+   if (backend == FftBackend::Auto)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(selectionMutex());
+         const auto it = selections().find(size);
+         backend = (it != selections().end()) ? it->second : FftBackend::Auto;
+      }
+      if (backend == FftBackend::Auto)
+      {
+         if (auto transform = selectAndMake(size))
+         {
+            return transform;
+         }
+         backend = FftBackend::Fftw;
+      }
+   }
+
+   if (auto transform = makeConcrete(backend, size))
+   {
+      return transform;
+   }
+   const FftBackend other = (backend == FftBackend::Fftw) ? FftBackend::Builtin : FftBackend::Fftw;
+   if (auto transform = makeConcrete(other, size))
+   {
+      GPWARN("FFT backend {} cannot do size {}; using {}", fftBackendName(backend), size,
+             fftBackendName(other));
+      return transform;
+   }
+   GPERROR("No FFT backend can do size {}", size);
+   return std::make_unique<BuiltinTransform>(size);   // Invalid: transforms nothing.
+}
+
+FftBackend selectFftBackend(std::size_t size)
+{
+   {
+      const std::lock_guard<std::mutex> lock(selectionMutex());
+      const auto it = selections().find(size);
+      if (it != selections().end())
+      {
+         return it->second;
+      }
+   }
+   const auto transform = selectAndMake(size);
+   return (transform != nullptr) ? transform->backend() : FftBackend::Fftw;
+}
+
+std::vector<FftBackendTiming> benchmarkFftBackends(std::size_t size)
+{
+   std::vector<FftBackendTiming> timings;
+   for (auto& result : runBenchmark(size))
+   {
+      timings.push_back(result.first);
+   }
+   return timings;
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,141 @@
+#ifndef FFTBACKEND_H_
+#define FFTBACKEND_H_
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/** @brief Library that computes FftProcessor's transforms. */
+enum class FftBackend : uint8_t
+{
+   Auto,      ///< Fastest on this machine, measured once per size (selectFftBackend()).
+   Fftw,      ///< FFTW single precision, MEASURE-planned.
+   Builtin    ///< BuiltinFft: no dependency, powers of two only.
+};
+
+/**
+ * @brief Get a backend's display name.
+ * @return "auto", "fftw" or "builtin".
+ */
+[[nodiscard]] const char* fftBackendName(FftBackend backend);
+
+/**
+ * @class FftTransform
+ * @brief One forward complex FFT size on one backend, with its own buffers.
+ *
+ * The caller writes interleaved complex floats into input(), calls
+ * execute() and reads output().  Batches of back-to-back frames use the
+ * batch buffers, where the backend has a faster path for them (FFTW
+ * many-plans).
+ *
+ * Thread-safety: none; the owner serialises all calls.
+ */
+class FftTransform
+{
+public:
+   virtual ~FftTransform() = default;
+
+   FftTransform(const FftTransform&) = delete;
+   FftTransform& operator=(const FftTransform&) = delete;
+   FftTransform(FftTransform&&) = delete;
+   FftTransform& operator=(FftTransform&&) = delete;
+
+   /** @brief Backend that computes this transform (never Auto). */
+   [[nodiscard]] virtual FftBackend backend() const = 0;
+
+   /** @brief Transform length in complex samples. */
+   [[nodiscard]] std::size_t size() const { return _size; }
+
+   /** @brief false if the backend could not set the size up (execute() is then a no-op). */
+   [[nodiscard]] virtual bool valid() const = 0;
+
+   /** @brief Input of execute(): size() interleaved complex values. */
+   [[nodiscard]] virtual float* input() = 0;
+
+   /** @brief Output of execute(): size() interleaved complex values. */
+   [[nodiscard]] virtual const float* output() const = 0;
+
+   /** @brief Transform input() into output(). */
+   virtual void execute() = 0;
+
+   /**
+    * @brief Get ready to transform `frames` frames at once.
+    * Never blocks on other threads: if a batch cannot be set up right now,
+    * the caller transforms the frames one by one.
+    * @param frames    Frames in this batch (a power of two, at most `capacity`).
+    * @param capacity  Largest batch the caller will ask for (sizes the buffers).
+    * @return true if batchInput() / executeBatch() may be used for `frames`.
+    */
+   [[nodiscard]] virtual bool prepareBatch(std::size_t frames, std::size_t capacity) = 0;
+
+   /** @brief Input of executeBatch(): frame f at `2 * size() * f`. */
+   [[nodiscard]] virtual float* batchInput() = 0;
+
+   /** @brief Output of executeBatch(), laid out like batchInput(). */
+   [[nodiscard]] virtual const float* batchOutput() const = 0;
+
+   /** @brief Transform `frames` frames of batchInput(), after prepareBatch(frames). */
+   virtual void executeBatch(std::size_t frames) = 0;
+
+   /** @brief Free the batch buffers (e.g. while the transform is parked in a cache). */
+   virtual void releaseBatch() = 0;
+
+protected:
+   explicit FftTransform(std::size_t size) : _size{size} {}
+
+private:
+   std::size_t _size;
+};
+
+/**
+ * @class FftBackendTiming
+ * @brief One backend's result in benchmarkFftBackends().
+ */
+struct FftBackendTiming
+{
+   FftBackend backend{FftBackend::Fftw};
+   double nsPerTransform{0.0};   ///< Best of the timed runs.
+};
+
+/**
+ * @brief Create a transform of one size.
+ *
+ * Auto resolves through selectFftBackend().  A backend that cannot handle
+ * the size (BuiltinFft and non-powers of two, a failed FFTW plan) falls
+ * back to the other, so the result is invalid only if none can.
+ *
+ * @param backend  Backend to use.
+ * @param size     Transform length.
+ * @return The transform (check valid()).
+ */
+[[nodiscard]] std::unique_ptr<FftTransform> makeFftTransform(FftBackend backend, std::size_t size);
+
+/**
+ * @brief Pick the fastest backend for a size on this machine.
+ *
+ * The first call for a size runs benchmarkFftBackends() (a few
+ * milliseconds, more for very large sizes); the choice is cached for the
+ * process, so later calls and FftProcessor plans of that size are free.
+ *
+ * @param size  Transform length.
+ * @return Fftw or Builtin.
+ */
+[[nodiscard]] FftBackend selectFftBackend(std::size_t size);
+
+/**
+ * @brief Time every backend that supports a size.
+ * Each runs a warm-up transform, then repeats for at least a millisecond
+ * (and three runs); the best run counts.
+ * @param size  Transform length.
+ * @return One timing per usable backend, fastest first.
+ */
+[[nodiscard]] std::vector<FftBackendTiming> benchmarkFftBackends(std::size_t size);
+
+} // namespace SdrEngine
+
+#endif // FFTBACKEND_H_
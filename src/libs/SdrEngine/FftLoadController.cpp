@@ -0,0 +1,196 @@
+// Project headers
+#include "FftLoadController.h"
+
+// System headers
+#include <algorithm>
+#include <utility>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Construction / configuration
+// ============================================================================
+
+FftLoadController::FftLoadController(const FftLoadConfig& config)
+{
+   configure(config);
+}
+
+void FftLoadController::configure(const FftLoadConfig& config)
+{
+   const FftLoadConfig defaults;
+   _config = config;
+   if (_config.targetUtilization <= 0.0)
+   {
+      _config.targetUtilization = defaults.targetUtilization;
+   }
+   if (_config.backlogFrames == 0)
+   {
+      _config.backlogFrames = defaults.backlogFrames;
+   }
+   if (_config.intervalSec <= 0.0)
+   {
+      _config.intervalSec = defaults.intervalSec;
+   }
+   if (_config.settleIntervals == 0)
+   {
+      _config.settleIntervals = defaults.settleIntervals;
+   }
+   if (_config.minOutputRate <= 0.0F)
+   {
+      _config.minOutputRate = defaults.minOutputRate;
+   }
+   _config.maxDisplayDivisor = std::max<std::size_t>(_config.maxDisplayDivisor, 1);
+   reset();
+}
+
+void FftLoadController::reset()
+{
+   _steps.clear();
+   _measuring   = false;
+   _skipPeriod  = false;
+   _calmPeriods = 0;
+   _utilization = 0.0;
+}
+
+// ============================================================================
+// Control
+// ============================================================================
+
+std::optional<FftLoadAdjustment> FftLoadController::update(
+   const FftLoadInput& input, std::chrono::steady_clock::time_point now)
+{
+   // Counters restart with the engine: measure from here.
+   if (!_measuring || input.fft.busyNs < _fftBusyNs ||
+       input.conditioning.busyNs < _conditioningBusyNs)
+   {
+      _measuring          = true;
+      _periodStart        = now;
+      _fftBusyNs          = input.fft.busyNs;
+      _conditioningBusyNs = input.conditioning.busyNs;
+      return std::nullopt;
+   }
+   const double elapsedSec = std::chrono::duration<double>(now - _periodStart).count();
+   if (elapsedSec < _config.intervalSec)
+   {
+      return std::nullopt;
+   }
+
+   const double fftBusy          = static_cast<double>(input.fft.busyNs - _fftBusyNs);
+   const double conditioningBusy =
+      static_cast<double>(input.conditioning.busyNs - _conditioningBusyNs);
+   _utilization        = std::max(fftBusy, conditioningBusy) / (elapsedSec * 1.0e9);
+   _periodStart        = now;
+   _fftBusyNs          = input.fft.busyNs;
+   _conditioningBusyNs = input.conditioning.busyNs;
+
+   // A step takes effect mid-period and the backlog needs time to drain.
+   if (std::exchange(_skipPeriod, false))
+   {
+      return std::nullopt;
+   }
+
+   const std::size_t backlog = input.fft.queueDepth;
+   if (_utilization > _config.targetUtilization || backlog >= _config.backlogFrames)
+   {
+      _calmPeriods = 0;
+      auto adjustment = degrade(input);
+      if (adjustment)
+      {
+         adjustment->utilization = _utilization;
+         adjustment->backlog     = backlog;
+         _skipPeriod             = true;
+      }
+      return adjustment;
+   }
+   if (_utilization >= _config.targetUtilization / 2.0 || backlog > 0 || _steps.empty())
+   {
+      _calmPeriods = 0;
+      return std::nullopt;
+   }
+   if (++_calmPeriods < _config.settleIntervals)
+   {
+      return std::nullopt;
+   }
+
+   FftLoadAdjustment adjustment;
+   adjustment.knob        = _steps.back().knob;
+   adjustment.degraded    = false;
+   adjustment.before      = apply(input.requested);
+   _steps.pop_back();
+   adjustment.after       = apply(input.requested);
+   adjustment.utilization = _utilization;
+   adjustment.backlog     = backlog;
+   _calmPeriods           = 0;
+   _skipPeriod            = true;
+   return adjustment;
+}
+
+std::optional<FftLoadAdjustment> FftLoadController::degrade(const FftLoadInput& input)
+{
+   const FftLoadSettings current = apply(input.requested);
+   Step step;
+   if (current.overlapPercent > 0.0F)
+   {
+      const float half = current.overlapPercent / 2.0F;
+      step = Step{FftLoadKnob::Overlap, (half < MIN_OVERLAP_PERCENT) ? 0.0 : half};
+   }
+   else
+   {
+      // The rate actually published: never above the segment rate.
+      double rate = input.segmentRateHz;
+      if (current.outputRate > 0.0F && (rate <= 0.0 || current.outputRate < rate))
+      {
+         rate = current.outputRate;
+      }
+      const auto minRate = static_cast<double>(_config.minOutputRate);
+      if (rate > minRate)
+      {
+         step = Step{FftLoadKnob::OutputRate, std::max(minRate, rate / 2.0)};
+      }
+      else if (input.displayTapActive && current.displayDivisor < _config.maxDisplayDivisor)
+      {
+         step = Step{FftLoadKnob::DisplayTap,
+                     static_cast<double>(
+                        std::min(current.displayDivisor * 2, _config.maxDisplayDivisor))};
+      }
+      else
+      {
+         return std::nullopt;   // Nothing left to turn down.
+      }
+   }
+
+   _steps.push_back(step);
+   FftLoadAdjustment adjustment;
+   adjustment.knob   = step.knob;
+   adjustment.before = current;
+   adjustment.after  = apply(input.requested);
+   return adjustment;
+}
+
+FftLoadSettings FftLoadController::apply(const FftLoadSettings& requested) const
+{
+   FftLoadSettings out = requested;
+   for (const Step& step : _steps)
+   {
+      switch (step.knob)
+      {
+         case FftLoadKnob::Overlap:
+            out.overlapPercent = std::min(out.overlapPercent, static_cast<float>(step.limit));
+            break;
+         case FftLoadKnob::OutputRate:
+            out.outputRate = (out.outputRate > 0.0F)
+                                ? std::min(out.outputRate, static_cast<float>(step.limit))
+                                : static_cast<float>(step.limit);
+            break;
+         case FftLoadKnob::DisplayTap:
+            out.displayDivisor =
+               std::max(out.displayDivisor, static_cast<std::size_t>(step.limit));
+            break;
+      }
+   }
+   return out;
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,188 @@
+#ifndef FFTLOADCONTROLLER_H_
+#define FFTLOADCONTROLLER_H_
+
+// Project headers
+#include "PipelineStats.h"
+
+// System headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/** @brief Setting an FftLoadController turns down to shed load. */
+enum class FftLoadKnob : uint8_t
+{
+   Overlap,      ///< Welch segment overlap (fewer FFTs per second).
+   OutputRate,   ///< Spectrum frames published per second.
+   DisplayTap    ///< Display tap budget (stronger decimation).
+};
+
+/**
+ * @class FftLoadConfig
+ * @brief Parameters of FftLoadController.
+ */
+struct FftLoadConfig
+{
+   double targetUtilization{0.7};    ///< Busy fraction of the busiest stage to stay under.
+   std::size_t backlogFrames{4};     ///< FFT input queue depth that counts as falling behind.
+   double intervalSec{0.5};          ///< Measurement period.
+   std::size_t settleIntervals{6};   ///< Calm periods before one adjustment is undone.
+   float minOutputRate{5.0F};        ///< The frame rate is never lowered below this (Hz).
+   std::size_t maxDisplayDivisor{8}; ///< The display tap budget is cut to at most 1/N.
+};
+
+/**
+ * @class FftLoadSettings
+ * @brief The settings an FftLoadController adjusts.
+ */
+struct FftLoadSettings
+{
+   float overlapPercent{0.0F};      ///< Welch overlap in percent.
+   float outputRate{0.0F};          ///< Spectrum output rate in Hz (0 = every segment).
+   std::size_t displayDivisor{1};   ///< Display tap budget divisor (1 = as configured).
+
+   bool operator==(const FftLoadSettings&) const = default;
+};
+
+/**
+ * @class FftLoadAdjustment
+ * @brief One step taken by an FftLoadController.
+ */
+struct FftLoadAdjustment
+{
+   FftLoadKnob knob{FftLoadKnob::Overlap};
+   bool degraded{true};           ///< true: load shed; false: an earlier step undone.
+   FftLoadSettings before;        ///< Effective settings before the step.
+   FftLoadSettings after;         ///< Effective settings after it.
+   double utilization{0.0};       ///< Busy fraction that triggered it.
+   std::size_t backlog{0};        ///< FFT input queue depth that triggered it.
+};
+
+/**
+ * @class FftLoadInput
+ * @brief What an FftLoadController sees of the pipeline at one point in time.
+ */
+struct FftLoadInput
+{
+   PipelineStageStats fft;            ///< FFT stage counters, with its queue depth.
+   PipelineStageStats conditioning;   ///< Conditioning stage counters (runs the display tap).
+   FftLoadSettings requested;         ///< Settings the user asked for.
+   double segmentRateHz{0.0};         ///< FFT segments per second at the effective overlap.
+   bool displayTapActive{false};      ///< The display tap publishes.
+};
+
+/**
+ * @class FftLoadController
+ * @brief Keeps the spectrum pipeline under a CPU target by turning down
+ *        overlap, output frame rate and display tap budget.
+ *
+ * FFT size, sample rate, overlap and averaging are chosen independently,
+ * so some combinations (65536 points at 20 MS/s with 75 % overlap) cost
+ * more than the machine has: the FFT stage's backlog, and with it the
+ * latency, grows until the sample ring overflows.  update() is fed the
+ * cumulative stage timers; every `intervalSec` it measures the busy
+ * fraction of the FFT and conditioning stages and the FFT input backlog.
+ *
+ * Above `targetUtilization`, or with `backlogFrames` queued, it takes one
+ * step, in this order while a step is left:
+ *   - Overlap: halve it (to 0 below MIN_OVERLAP_PERCENT), which halves
+ *     the FFTs per second at most;
+ *   - OutputRate: halve the publication rate, down to `minOutputRate`,
+ *     which halves the averaging, level and hold work and what listeners
+ *     draw;
+ *   - DisplayTap: double the display tap's decimation, up to
+ *     `maxDisplayDivisor`.
+ * Each step roughly halves the load it acts on, so after `settleIntervals`
+ * periods under half the target, with no backlog, the latest step is
+ * undone.  Steps are limits on the requested settings, which the user may
+ * still change: apply() gives the settings to run with.
+ *
+ * Thread-safety: not thread-safe; call from the FFT stage only.
+ */
+class FftLoadController
+{
+public:
+   /** @brief Overlap below which a halving step goes straight to 0 %. */
+   static constexpr float MIN_OVERLAP_PERCENT = 10.0F;
+
+   /**
+    * @brief Construct a controller with no step taken.
+    * @param config  Targets and limits.
+    */
+   explicit FftLoadController(const FftLoadConfig& config = {});
+
+   /**
+    * @brief Replace the configuration, then reset().
+    * @param config  Targets and limits (non-positive values count as the defaults).
+    */
+   void configure(const FftLoadConfig& config);
+
+   /**
+    * @brief Get the configuration.
+    * @return Current configuration.
+    */
+   [[nodiscard]] const FftLoadConfig& config() const { return _config; }
+
+   /** @brief Undo every step and restart the measurement. */
+   void reset();
+
+   /**
+    * @brief Account the pipeline's progress; at the end of a period, take
+    *        or undo at most one step.
+    * @param input  Cumulative stage counters and the current settings.
+    * @param now    Time of the counters.
+    * @return The step taken, if any.
+    */
+   std::optional<FftLoadAdjustment> update(const FftLoadInput& input,
+                                           std::chrono::steady_clock::time_point now);
+
+   /**
+    * @brief Limit the requested settings by the steps taken.
+    * @param requested  Settings the user asked for.
+    * @return Settings to run with.
+    */
+   [[nodiscard]] FftLoadSettings apply(const FftLoadSettings& requested) const;
+
+   /**
+    * @brief Get the number of steps in force.
+    * @return 0 when nothing is turned down.
+    */
+   [[nodiscard]] std::size_t level() const { return _steps.size(); }
+
+   /**
+    * @brief Get the busy fraction measured over the last complete period.
+    * @return Busy fraction of the busiest watched stage (may exceed 1 briefly).
+    */
+   [[nodiscard]] double utilization() const { return _utilization; }
+
+private:
+   // A limit on one knob; later steps on a knob are tighter.
+   struct Step
+   {
+      FftLoadKnob knob{FftLoadKnob::Overlap};
+      double limit{0.0};
+   };
+
+   // Push the next step, if one is left.
+   std::optional<FftLoadAdjustment> degrade(const FftLoadInput& input);
+
+   FftLoadConfig _config;
+   std::vector<Step> _steps;
+
+   bool _measuring{false};
+   bool _skipPeriod{false};           // The period a step was taken in: not yet settled.
+   std::chrono::steady_clock::time_point _periodStart;
+   uint64_t _fftBusyNs{0};            // At _periodStart.
+   uint64_t _conditioningBusyNs{0};
+   std::size_t _calmPeriods{0};
+   double _utilization{0.0};
+};
+
+} // namespace SdrEngine
+
+#endif // FFTLOADCONTROLLER_H_
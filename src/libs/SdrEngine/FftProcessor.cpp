@@ -1,15 +1,21 @@
 // Project headers
 #include "FftProcessor.h"
+#include "DspKernels.h"
+#include "FftwPlanner.h"
 #include "GeneralLogger.h"
+#include "Profiler.h"
+#include "ThreadConfig.h"
 
 // Third-party headers
 #include <fftw3.h>
 
 // System headers
 #include <algorithm>
+#include <bit>
 #include <cmath>
 #include <cstring>
 #include <numbers>
+#include <tuple>
 #include <utility>
 
 namespace SdrEngine
@@ -69,51 +75,186 @@ void fillFlatTop(std::vector<float>& w, size_t n)
    }
 }
 
+// ============================================================================
+// Per-frame kernels (shared by single-frame and batched paths)
+// ============================================================================
+
+// Smallest linear power converted to dB (-300 dB); guards against log(0)
+// and keeps the fast log away from denormals.
+constexpr float POWER_FLOOR = 1.0e-30F;
+
+// Window `count` samples into an interleaved FFTW input frame of
+// window.size() bins, zero-padding the remainder.
+void applyWindow(float* dst, const std::complex<float>* src, std::size_t count,
+                 const std::vector<float>& window)
+{
+   const std::size_t n = window.size();
+   const std::size_t copyLen = std::min(count, n);
+   applyWindowInterleaved(src, window.data(), dst, copyLen);
+   std::fill(dst + (2 * copyLen), dst + (2 * n), 0.0F);
+}
+
+// Interleaved FFT output → normalised magnitude in dB, DC-centred.  The
+// fftshift is done as two contiguous runs: bins [0, n - half) land at
+// [half, n) and the rest wrap to the front.
+void toMagnitudeDb(const float* spectrum, float* dst, std::size_t n, float normFactor)
+{
+   const float scale = 1.0F / (normFactor * normFactor);
+   const auto half = n / 2;
+   powerDbInterleaved(spectrum, dst + half, n - half, scale, POWER_FLOOR);
+   powerDbInterleaved(spectrum + (2 * (n - half)), dst, half, scale, POWER_FLOOR);
+}
+
+// Interleaved FFT output → normalised linear power, DC-centred.
+void toPower(const float* spectrum, float* dst, std::size_t n, float normFactor)
+{
+   const float scale = 1.0F / (normFactor * normFactor);
+   const auto half = n / 2;
+   powerInterleaved(spectrum, dst + half, n - half, scale);
+   powerInterleaved(spectrum + (2 * (n - half)), dst, half, scale);
+}
+
+constexpr float DB_FLOOR = -300.0F;   // 10 * log10(POWER_FLOOR).
+
 } // anonymous namespace
 
+// ============================================================================
+// Plan, WindowTable, Update — state handed to the processing thread
+// ============================================================================
+
+struct FftProcessor::Plan
+{
+   Plan(size_t size, FftBackend backend);
+
+   [[nodiscard]] bool valid() const { return transform->valid(); }
+
+   // Ready the backend for a batch of `frames` (a power of two).  false if
+   // it cannot right now (e.g. another thread is inside the FFTW planner),
+   // in which case the caller falls back to single-frame transforms.
+   [[nodiscard]] bool prepareBatch(std::size_t frames)
+   {
+      return frames <= MAX_BATCH_FRAMES &&
+             transform->prepareBatch(frames, batchFramesFor(fftSize));
+   }
+
+   const size_t fftSize;
+   const FftBackend requested;              // As asked for (may be Auto).
+   std::unique_ptr<FftTransform> transform;
+};
+
+FftProcessor::Plan::Plan(size_t size, FftBackend backend)
+   : fftSize{size}
+   , requested{backend}
+   , transform{makeFftTransform(backend, size)}
+{
+}
+
+struct FftProcessor::WindowTable
+{
+   WindowTable(size_t size, WindowFunction func);
+
+   std::vector<float> coeffs;
+   float norm{1.0F};   // Coherent gain, so the per-frame path does not re-sum.
+};
+
+FftProcessor::WindowTable::WindowTable(size_t size, WindowFunction func)
+{
+   switch (func)
+   {
+      case WindowFunction::Rectangular:
+         fillRectangular(coeffs, size);
+         break;
+      case WindowFunction::Hanning:
+         fillHanning(coeffs, size);
+         break;
+      case WindowFunction::BlackmanHarris:
+         fillBlackmanHarris(coeffs, size);
+         break;
+      case WindowFunction::FlatTop:
+         fillFlatTop(coeffs, size);
+         break;
+   }
+
+   float windowSum = 0.0F;
+   for (const float w : coeffs)
+   {
+      windowSum += w;
+   }
+   norm = (windowSum > 0.0F) ? windowSum : 1.0F;
+}
+
+// Published by a setter with the plan (null: keep the running one) and the
+// window to use next; after adoption it carries the replaced pair back.
+struct FftProcessor::Update
+{
+   std::unique_ptr<Plan> plan;
+   std::unique_ptr<WindowTable> window;
+   uint64_t seq{0};
+   Update* next{nullptr};   // Link in the retired stack.
+};
+
+std::size_t FftProcessor::batchFramesFor(size_t fftSize)
+{
+   const std::size_t bySize = MAX_BATCH_SAMPLES / std::max<std::size_t>(fftSize, 1);
+   return std::bit_floor(std::clamp<std::size_t>(bySize, 1, MAX_BATCH_FRAMES));
+}
+
 // ============================================================================
 // Construction / destruction
 // ============================================================================
 
-FftProcessor::FftProcessor(size_t fftSize, WindowFunction windowFunc)
-   : _fftSize{fftSize}
+FftProcessor::FftProcessor(size_t fftSize, WindowFunction windowFunc, FftBackend backend)
+   : _active{std::make_unique<Plan>(fftSize, backend)}
+   , _window{std::make_unique<WindowTable>(fftSize, windowFunc)}
+   , _runningSize{fftSize}
+   , _runningBackend{_active->transform->backend()}
+   , _fftSize{fftSize}
    , _windowFunc{windowFunc}
+   , _activeBackend{_active->transform->backend()}
+   , _backend{backend}
 {
-   rebuild();
+   GPINFO("FftProcessor: built {} plan for FFT size {}",
+          fftBackendName(_active->transform->backend()), fftSize);
 }
 
 FftProcessor::~FftProcessor()
 {
-   destroy();
+   cancelPrepare();
+   delete _pending.exchange(nullptr, std::memory_order_acquire);
+   Update* update = _retired.exchange(nullptr, std::memory_order_acquire);
+   while (update != nullptr)
+   {
+      delete std::exchange(update, update->next);
+   }
 }
 
 FftProcessor::FftProcessor(FftProcessor&& other) noexcept
-   : _fftSize{other._fftSize}
-   , _windowFunc{other._windowFunc}
-   , _in{other._in}
-   , _out{other._out}
-   , _plan{other._plan}
-   , _window{std::move(other._window)}
 {
-   other._in   = nullptr;
-   other._out  = nullptr;
-   other._plan = nullptr;
+   *this = std::move(other);
 }
 
 FftProcessor& FftProcessor::operator=(FftProcessor&& other) noexcept
 {
    if (this != &other)
    {
-      destroy();
-      _fftSize    = other._fftSize;
-      _windowFunc = other._windowFunc;
-      _in         = other._in;
-      _out        = other._out;
-      _plan       = other._plan;
-      _window     = std::move(other._window);
-      other._in   = nullptr;
-      other._out  = nullptr;
-      other._plan = nullptr;
+      // The worker captures `other`, so it must finish before its state
+      // moves.  Neither side may be processing during a move.
+      cancelPrepare();
+      other.cancelPrepare();
+      delete _pending.exchange(other._pending.exchange(nullptr));
+      collectRetired();
+      other.collectRetired();
+      _active         = std::move(other._active);
+      _window         = std::move(other._window);
+      _adoptedSeq     = other._adoptedSeq.load();
+      _runningSize    = other._runningSize.load();
+      _runningBackend = other._runningBackend.load();
+      _publishedSeq   = other._publishedSeq;
+      _fftSize        = other._fftSize.load();
+      _windowFunc     = other._windowFunc.load();
+      _activeBackend  = other._activeBackend.load();
+      _backend        = other._backend.load();
+      _planCache      = std::move(other._planCache);
    }
    return *this;
 }
@@ -124,162 +265,453 @@ FftProcessor& FftProcessor::operator=(FftProcessor&& other) noexcept
 
 void FftProcessor::setFftSize(size_t fftSize)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
-   if (fftSize == _fftSize)
+   const std::lock_guard<std::mutex> resizeLock(_resizeMutex);
+   if (_fftSize == fftSize)
+   {
+      return;
+   }
+
+   // A plan the processing thread never picked up goes back to the cache.
+   auto update = retractUpdate();
+   if (update != nullptr && update->plan != nullptr)
+   {
+      cachePlan(std::move(update->plan));
+   }
+   collectRetired();
+   if (update == nullptr)
+   {
+      update = std::make_unique<Update>();
+   }
+
+   // Plan and window the new size here, so process() keeps running on the
+   // old plan until it adopts the update.
+   bool prepared = true;
+   FftBackend backend = _runningBackend;
+   if (_runningSize != fftSize)
+   {
+      update->plan = takeCachedPlan(fftSize);
+      prepared     = (update->plan != nullptr);
+      if (!prepared)
+      {
+         update->plan = std::make_unique<Plan>(fftSize, _backend);
+      }
+      backend = update->plan->transform->backend();
+   }
+   update->window = std::make_unique<WindowTable>(fftSize, _windowFunc);
+
+   _fftSize       = fftSize;
+   _activeBackend = backend;
+   publishUpdate(std::move(update));
+
+   GPINFO("FftProcessor: switched to FFT size {} ({} {})", fftSize, fftBackendName(backend),
+          prepared ? "prepared plan" : "planned on demand");
+}
+
+void FftProcessor::setBackend(FftBackend backend)
+{
+   const std::lock_guard<std::mutex> resizeLock(_resizeMutex);
+   if (_backend.exchange(backend) == backend)
    {
       return;
    }
-   _fftSize = fftSize;
-   rebuild();
+
+   // Plans of the old backend are no use now; cachePlan() drops them.
+   cancelPrepare();
+   std::ignore = retractUpdate();
+   collectRetired();
+   std::map<size_t, std::unique_ptr<Plan>> stale;
+   {
+      const std::lock_guard<std::mutex> lock(_cacheMutex);
+      stale.swap(_planCache);
+   }
+
+   const size_t fftSize = _fftSize;
+   auto update    = std::make_unique<Update>();
+   update->plan   = std::make_unique<Plan>(fftSize, backend);
+   update->window = std::make_unique<WindowTable>(fftSize, _windowFunc);
+   const FftBackend active = update->plan->transform->backend();
+   _activeBackend = active;
+   publishUpdate(std::move(update));
+   GPINFO("FftProcessor: backend {} ({} for FFT size {})", fftBackendName(backend),
+          fftBackendName(active), fftSize);
+}
+
+FftBackend FftProcessor::getBackend() const
+{
+   return _backend;
+}
+
+FftBackend FftProcessor::getActiveBackend() const
+{
+   return _activeBackend;
 }
 
 size_t FftProcessor::getFftSize() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _fftSize;
 }
 
 void FftProcessor::setWindowFunction(WindowFunction windowFunc)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
-   if (windowFunc == _windowFunc)
+   const std::lock_guard<std::mutex> resizeLock(_resizeMutex);
+   if (_windowFunc.exchange(windowFunc) == windowFunc)
    {
       return;
    }
-   _windowFunc = windowFunc;
-   buildWindow();
+
+   // Re-window a pending plan switch, or publish a window-only update.
+   auto update = retractUpdate();
+   if (update == nullptr)
+   {
+      update = std::make_unique<Update>();
+   }
+   update->window = std::make_unique<WindowTable>(_fftSize, windowFunc);
+   publishUpdate(std::move(update));
 }
 
 WindowFunction FftProcessor::getWindowFunction() const
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
    return _windowFunc;
 }
 
-// ============================================================================
-// Processing
-// ============================================================================
+void FftProcessor::adoptUpdate() const
+{
+   if (_pending.load(std::memory_order_relaxed) == nullptr)
+   {
+      return;
+   }
+   Update* update = _pending.exchange(nullptr, std::memory_order_acquire);
+   if (update == nullptr)
+   {
+      return;   // Retracted meanwhile.
+   }
 
-std::vector<float> FftProcessor::process(
-   const std::vector<std::complex<float>>& samples) const
+   if (update->plan != nullptr)
+   {
+      std::swap(_active, update->plan);
+      _runningSize.store(_active->fftSize, std::memory_order_relaxed);
+      _runningBackend.store(_active->transform->backend(), std::memory_order_relaxed);
+   }
+   std::swap(_window, update->window);
+   const uint64_t seq = update->seq;
+
+   // The replaced plan and window go back for a setter to cache or free.
+   update->next = _retired.load(std::memory_order_relaxed);
+   while (!_retired.compare_exchange_weak(update->next, update, std::memory_order_release,
+                                          std::memory_order_relaxed))
+   {
+   }
+   _adoptedSeq.store(seq, std::memory_order_release);
+}
+
+void FftProcessor::publishUpdate(std::unique_ptr<Update> update)
 {
-   const std::lock_guard<std::mutex> lock(_mutex);
-   const auto n = static_cast<std::size_t>(_fftSize);
+   update->seq = ++_publishedSeq;
+   _pending.store(update.release(), std::memory_order_release);
+}
 
-   // Apply window and copy into FFTW input buffer (interleaved real/imag).
-   const std::size_t copyLen = std::min(samples.size(), n);
-   for (std::size_t i = 0; i < copyLen; ++i)
+std::unique_ptr<FftProcessor::Update> FftProcessor::retractUpdate()
+{
+   std::unique_ptr<Update> update{_pending.exchange(nullptr, std::memory_order_acquire)};
+   if (update != nullptr)
    {
-      _in[2 * i]     = samples[i].real() * _window[i];
-      _in[(2 * i) + 1] = samples[i].imag() * _window[i];
+      _publishedSeq = update->seq - 1;
+      return update;
    }
-   // Zero-pad if necessary.
-   for (std::size_t i = copyLen; i < n; ++i)
+
+   // The processing thread took it: let it finish the swap, a few
+   // instructions, so _runningSize describes what it now runs.
+   while (_adoptedSeq.load(std::memory_order_acquire) != _publishedSeq)
    {
-      _in[2 * i]     = 0.0F;
-      _in[(2 * i) + 1] = 0.0F;
+      std::this_thread::yield();
    }
+   return nullptr;
+}
 
-   // Execute the FFT.
-   fftwf_execute(_plan);
+void FftProcessor::collectRetired() const
+{
+   Update* update = _retired.exchange(nullptr, std::memory_order_acquire);
+   while (update != nullptr)
+   {
+      const std::unique_ptr<Update> owned{std::exchange(update, update->next)};
+      if (owned->plan != nullptr)
+      {
+         owned->plan->transform->releaseBatch();
+         cachePlan(std::move(owned->plan));
+      }
+   }
+}
 
-   // Convert complex output → magnitude in dB, with DC-centring (fftshift).
-   std::vector<float> magnitudesDb(n);
-   const auto half = n / 2;
+// ============================================================================
+// Plan management
+// ============================================================================
 
-   // Normalisation factor — window coherent gain.
-   float windowSum = 0.0F;
-   for (std::size_t i = 0; i < n; ++i)
+void FftProcessor::prepareFftSizes(std::vector<size_t> fftSizes)
+{
+   cancelPrepare();
+   _cancelPrepare.store(false, std::memory_order_relaxed);
+
+   _prepareThread = std::thread([this, sizes = std::move(fftSizes)]()
    {
-      windowSum += _window[i];
+      CommonUtils::configureCurrentThread("FftProcessor.prepare");
+      for (const size_t size : sizes)
+      {
+         if (_cancelPrepare.load(std::memory_order_relaxed))
+         {
+            break;
+         }
+         if (size == 0 || isPlanReady(size))
+         {
+            continue;
+         }
+
+         auto plan = std::make_unique<Plan>(size, _backend);
+         if (!plan->valid())
+         {
+            continue;
+         }
+         cachePlan(std::move(plan));
+         GPINFO("FftProcessor: prepared plan for FFT size {}", size);
+      }
+   });
+}
+
+void FftProcessor::waitForPreparedPlans()
+{
+   if (_prepareThread.joinable())
+   {
+      _prepareThread.join();
    }
-   const float normFactor = (windowSum > 0.0F) ? windowSum : 1.0F;
+}
 
-   for (std::size_t i = 0; i < n; ++i)
+bool FftProcessor::isPlanReady(size_t fftSize) const
+{
+   if (_fftSize == fftSize || _runningSize == fftSize)
    {
-      const float re  = _out[2 * i];
-      const float im  = _out[(2 * i) + 1];
-      const float mag = std::sqrt((re * re) + (im * im)) / normFactor;
+      return true;
+   }
+   collectRetired();
+   const std::lock_guard<std::mutex> lock(_cacheMutex);
+   return _planCache.contains(fftSize);
+}
 
-      // Guard against log10(0).
-      constexpr float FLOOR = 1.0e-20F;
-      const float dB = 20.0F * std::log10(std::max(mag, FLOOR));
+bool FftProcessor::loadWisdom(const std::string& path)
+{
+   const std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+   if (fftwf_import_wisdom_from_filename(path.c_str()) == 0)
+   {
+      GPINFO("FftProcessor: no FFTW wisdom loaded from {}", path);
+      return false;
+   }
+   GPINFO("FftProcessor: loaded FFTW wisdom from {}", path);
+   return true;
+}
 
-      // fftshift: swap lower and upper halves.
-      const std::size_t dst = (i + half) % n;
-      magnitudesDb[dst] = dB;
+bool FftProcessor::saveWisdom(const std::string& path)
+{
+   const std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+   if (fftwf_export_wisdom_to_filename(path.c_str()) == 0)
+   {
+      GPWARN("FftProcessor: failed to save FFTW wisdom to {}", path);
+      return false;
    }
+   return true;
+}
 
-   return magnitudesDb;
+std::unique_ptr<FftProcessor::Plan> FftProcessor::takeCachedPlan(size_t fftSize)
+{
+   const std::lock_guard<std::mutex> lock(_cacheMutex);
+   auto node = _planCache.extract(fftSize);
+   return node.empty() ? nullptr : std::move(node.mapped());
+}
+
+void FftProcessor::cachePlan(std::unique_ptr<Plan> plan) const
+{
+   std::unique_ptr<Plan> replaced;
+   if (plan->requested != _backend)
+   {
+      replaced = std::move(plan);   // Planned before a setBackend().
+   }
+   else
+   {
+      const std::lock_guard<std::mutex> lock(_cacheMutex);
+      auto& slot = _planCache[plan->fftSize];
+      replaced = std::exchange(slot, std::move(plan));
+   }
+   // `replaced` (if any) is destroyed here, outside the cache lock.
+}
+
+void FftProcessor::cancelPrepare()
+{
+   _cancelPrepare.store(true, std::memory_order_relaxed);
+   if (_prepareThread.joinable())
+   {
+      _prepareThread.join();
+   }
 }
 
 // ============================================================================
-// Internal helpers
+// Processing
 // ============================================================================
 
-void FftProcessor::rebuild()
+std::vector<float> FftProcessor::process(
+   const std::vector<std::complex<float>>& samples) const
 {
-   destroy();
+   std::vector<float> magnitudesDb;
+   process(samples, magnitudesDb);
+   return magnitudesDb;
+}
 
-   const auto n = static_cast<std::size_t>(_fftSize);
+void FftProcessor::process(const std::vector<std::complex<float>>& samples,
+                           std::vector<float>& magnitudesDb) const
+{
+   processInto(samples, magnitudesDb);
+}
 
-   // Allocate FFTW-aligned buffers (interleaved complex = 2× floats).
-   _in  = fftwf_alloc_real(2 * n);
-   _out = fftwf_alloc_real(2 * n);
+void FftProcessor::process(const std::vector<std::complex<float>>& samples,
+                           std::pmr::vector<float>& magnitudesDb) const
+{
+   processInto(samples, magnitudesDb);
+}
 
-   if (_in == nullptr || _out == nullptr)
+template <typename Vector>
+void FftProcessor::processInto(std::span<const std::complex<float>> samples,
+                               Vector& magnitudesDb) const
+{
+   GPPROFILE_SCOPE("FftProcessor::process");
+   adoptUpdate();
+   const std::size_t n = _active->fftSize;
+   magnitudesDb.resize(n);
+   if (!_active->valid())
    {
-      GPERROR("FFTW memory allocation failed for FFT size {}", _fftSize);
+      std::fill(magnitudesDb.begin(), magnitudesDb.end(), DB_FLOOR);
       return;
    }
+   const float normFactor = transformFrame(samples.data(), samples.size());
 
-   // Create a complex-to-complex plan (DFT_1D, forward).
-   _plan = fftwf_plan_dft_1d(
-      static_cast<int>(_fftSize),
-      reinterpret_cast<fftwf_complex*>(_in),
-      reinterpret_cast<fftwf_complex*>(_out),
-      FFTW_FORWARD, FFTW_MEASURE);
-
-   buildWindow();
-
-   GPINFO("FftProcessor: rebuilt plan for FFT size {}", _fftSize);
+   // Convert complex output → magnitude in dB, with DC-centring (fftshift).
+   toMagnitudeDb(_active->transform->output(), magnitudesDb.data(), n, normFactor);
 }
 
-void FftProcessor::destroy()
+void FftProcessor::processPower(std::span<const std::complex<float>> samples,
+                                std::vector<float>& power) const
 {
-   if (_plan != nullptr)
+   GPPROFILE_SCOPE("FftProcessor::processPower");
+   adoptUpdate();
+   const std::size_t n = _active->fftSize;
+   power.resize(n);
+   if (!_active->valid())
    {
-      fftwf_destroy_plan(_plan);
-      _plan = nullptr;
+      std::fill(power.begin(), power.end(), 0.0F);
+      return;
    }
-   if (_in != nullptr)
+   const float normFactor = transformFrame(samples.data(), samples.size());
+   toPower(_active->transform->output(), power.data(), n, normFactor);
+}
+
+std::size_t FftProcessor::maxBatchFrames() const
+{
+   return batchFramesFor(_fftSize);
+}
+
+void FftProcessor::processBatch(std::span<const std::complex<float>> samples,
+                                std::size_t frames,
+                                std::vector<float>& magnitudesDb) const
+{
+   GPPROFILE_SCOPE("FftProcessor::processBatch");
+   adoptUpdate();
+   runBatch(samples, frames, _active->fftSize, magnitudesDb, false);
+}
+
+void FftProcessor::processPowerBatch(std::span<const std::complex<float>> samples,
+                                     std::size_t frames, std::size_t hop,
+                                     std::vector<float>& power) const
+{
+   GPPROFILE_SCOPE("FftProcessor::processPowerBatch");
+   adoptUpdate();
+   runBatch(samples, frames, hop, power, true);
+}
+
+float FftProcessor::transformFrame(const std::complex<float>* samples,
+                                   std::size_t count) const
+{
+   // Apply window and copy into FFTW input buffer (interleaved real/imag).
+   applyWindow(_active->transform->input(), samples, count, _window->coeffs);
+
+   // Execute the FFT.
+   _active->transform->execute();
+   return _window->norm;
+}
+
+void FftProcessor::runBatch(std::span<const std::complex<float>> samples,
+                            std::size_t frames, std::size_t hop,
+                            std::vector<float>& out, bool power) const
+{
+   const std::size_t n = _active->fftSize;
+   out.resize(frames * n);
+   if (frames == 0 || n == 0)
    {
-      fftwf_free(_in);
-      _in = nullptr;
+      return;
    }
-   if (_out != nullptr)
+   if (!_active->valid())
    {
-      fftwf_free(_out);
-      _out = nullptr;
+      std::fill(out.begin(), out.end(), power ? 0.0F : DB_FLOOR);
+      return;
    }
-}
 
-void FftProcessor::buildWindow()
-{
-   switch (_windowFunc)
+   Plan& active = *_active;
+   FftTransform& transform = *active.transform;
+   const std::vector<float>& window = _window->coeffs;
+   const float normFactor = _window->norm;
+   const std::size_t maxChunk = batchFramesFor(n);
+
+   // Transform in power-of-two chunks so only log2(maxChunk)+1 plans exist.
+   std::size_t done = 0;
+   while (done < frames)
    {
-      case WindowFunction::Rectangular:
-         fillRectangular(_window, _fftSize);
-         break;
-      case WindowFunction::Hanning:
-         fillHanning(_window, _fftSize);
-         break;
-      case WindowFunction::BlackmanHarris:
-         fillBlackmanHarris(_window, _fftSize);
-         break;
-      case WindowFunction::FlatTop:
-         fillFlatTop(_window, _fftSize);
-         break;
+      const std::size_t chunk = std::bit_floor(std::min(frames - done, maxChunk));
+      if (chunk == 1 || !active.prepareBatch(chunk))
+      {
+         // Single frame, or no many-plan available yet: use the 1-D plan.
+         const std::size_t offset = done * hop;
+         const std::size_t count  = (offset < samples.size()) ? samples.size() - offset : 0;
+         std::ignore = transformFrame(samples.data() + std::min(offset, samples.size()), count);
+         float* row = out.data() + (done * n);
+         if (power)
+         {
+            toPower(transform.output(), row, n, normFactor);
+         }
+         else
+         {
+            toMagnitudeDb(transform.output(), row, n, normFactor);
+         }
+         ++done;
+         continue;
+      }
+
+      for (std::size_t f = 0; f < chunk; ++f)
+      {
+         const std::size_t offset = (done + f) * hop;
+         const std::size_t count  = (offset < samples.size()) ? samples.size() - offset : 0;
+         applyWindow(transform.batchInput() + (2 * n * f),
+                     samples.data() + std::min(offset, samples.size()), count, window);
+      }
+
+      transform.executeBatch(chunk);
+
+      for (std::size_t f = 0; f < chunk; ++f)
+      {
+         float* row = out.data() + ((done + f) * n);
+         if (power)
+         {
+            toPower(transform.batchOutput() + (2 * n * f), row, n, normFactor);
+         }
+         else
+         {
+            toMagnitudeDb(transform.batchOutput() + (2 * n * f), row, n, normFactor);
+         }
+      }
+      done += chunk;
    }
 }
 
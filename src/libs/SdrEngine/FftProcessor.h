@@ -2,28 +2,47 @@
 #define FFTPROCESSOR_H_
 
 // Project headers
+#include "FftBackend.h"
 #include "SdrTypes.h"
 
 // System headers
+#include <atomic>
 #include <complex>
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
-// Forward declaration — avoids exposing fftw3.h in the header.
-struct fftwf_plan_s;
-
 namespace SdrEngine
 {
 
 /**
  * @class FftProcessor
  * @brief Performs windowed FFT on complex I/Q data and produces a magnitude
- * spectrum in dB.  Uses FFTW for the heavy lifting.
+ * spectrum in dB.  The transforms run on an FftBackend: FFTW, the
+ * dependency-free BuiltinFft, or (Auto, the default) whichever of them
+ * benchmarked fastest for the size on this machine (selectFftBackend()).
+ *
+ * Thread-safety: the processing methods (process(), processPower(),
+ * processBatch(), processPowerBatch()) run on one thread at a time, the
+ * SdrEngine processing thread, and never take a lock.  Setters and getters
+ * may be called from any thread and never block them.
  *
- * Thread-safety: all public methods are protected by an internal mutex,
- * so setFftSize / setWindowFunction can be called from the GUI thread
- * while process() runs on the SdrEngine processing thread.
+ * A setter builds the new state on its own thread (a plan, taken from the
+ * cache or planned on the spot, and a window table) and publishes it with
+ * an atomic pointer swap; the next processing call adopts it before its
+ * first frame and hands the state it replaced back through a lock-free
+ * list, to be cached or freed by a later setter.  The old plan therefore
+ * keeps running until the switch, and the processing thread neither
+ * allocates nor frees.  prepareFftSizes() pre-builds plans on a background
+ * thread, and loadWisdom() / saveWisdom() persist FFTW's measurements
+ * across launches.
  */
 class FftProcessor
 {
@@ -33,9 +52,11 @@ public:
     *
     * @param fftSize      Number of FFT bins (must be power of two).
     * @param windowFunc   Windowing function to apply before the FFT.
+    * @param backend      Transform library (see setBackend()).
     */
    explicit FftProcessor(size_t fftSize = 2048,
-                         WindowFunction windowFunc = WindowFunction::BlackmanHarris);
+                         WindowFunction windowFunc = WindowFunction::BlackmanHarris,
+                         FftBackend backend = FftBackend::Auto);
 
    ~FftProcessor();
 
@@ -47,7 +68,12 @@ public:
    FftProcessor(FftProcessor&& other) noexcept;
    FftProcessor& operator=(FftProcessor&& other) noexcept;
 
-   /** @brief Change the FFT size.  Rebuilds internal FFTW plan. */
+   /**
+    * @brief Change the FFT size.
+    * Uses a prepared plan if one exists, otherwise measures a new one on
+    * the calling thread.  process() keeps using the old plan meanwhile and
+    * switches at its next call; getFftSize() reports the new size at once.
+    */
    void setFftSize(size_t fftSize);
 
    /**
@@ -56,6 +82,27 @@ public:
     */
    [[nodiscard]] size_t getFftSize() const;
 
+   /**
+    * @brief Change the transform library.
+    * Re-plans the current size at once (process() keeps the old plan
+    * meanwhile) and drops prepared plans of the old backend.  Auto
+    * benchmarks each size the first time the process plans it.
+    * @param backend  Backend for this and later plans.
+    */
+   void setBackend(FftBackend backend);
+
+   /**
+    * @brief Get the requested backend.
+    * @return Backend as set (may be Auto).
+    */
+   [[nodiscard]] FftBackend getBackend() const;
+
+   /**
+    * @brief Get the backend the active plan runs on.
+    * @return Fftw or Builtin.
+    */
+   [[nodiscard]] FftBackend getActiveBackend() const;
+
    /** @brief Change the windowing function. */
    void setWindowFunction(WindowFunction windowFunc);
 
@@ -79,27 +126,178 @@ public:
    [[nodiscard]] std::vector<float> process(
       const std::vector<std::complex<float>>& samples) const;
 
+   /**
+    * @brief Same as process(samples), but writes into a caller-owned vector.
+    * `magnitudesDb` is resized to fftSize; its existing capacity is reused
+    * so a recycled frame incurs no allocation.
+    */
+   void process(const std::vector<std::complex<float>>& samples,
+                std::vector<float>& magnitudesDb) const;
+
+   /**
+    * @brief Same as process(samples, magnitudesDb), for a vector backed by
+    * the caller's memory resource (e.g. a per-frame arena).
+    */
+   void process(const std::vector<std::complex<float>>& samples,
+                std::pmr::vector<float>& magnitudesDb) const;
+
+   /**
+    * @brief Compute the linear power spectrum of one FFT segment.
+    *
+    * Same windowing, zero-padding and DC-centring as process(), but the
+    * output is |X|² normalised by the window coherent gain, so several
+    * segments can be averaged (Welch) before conversion to dB.
+    *
+    * @param samples  Complex float I/Q data (first fftSize samples used).
+    * @param power    Resized to fftSize and filled with linear power.
+    */
+   void processPower(std::span<const std::complex<float>> samples,
+                     std::vector<float>& power) const;
+
+   // -- Batched processing --------------------------------------------------
+
+   /**
+    * @brief Largest number of frames transformed by one batched backend call.
+    * Larger batches are split internally; this only bounds scratch memory.
+    * @return Frames per FFTW execution for the current FFT size.
+    */
+   [[nodiscard]] std::size_t maxBatchFrames() const;
+
+   /**
+    * @brief Compute the dB magnitude spectra of several back-to-back frames.
+    *
+    * Frame `f` is `samples[f * fftSize, (f + 1) * fftSize)`; frames that run
+    * past the end of `samples` are zero-padded.  All frames are windowed
+    * and transformed in batches (FFTW many-plans) with the same plan.
+    *
+    * @param samples       Contiguous I/Q samples (ideally frames * fftSize long).
+    * @param frames        Number of frames to transform.
+    * @param magnitudesDb  Resized to frames * fftSize; row `f` holds frame
+    *                      `f`'s DC-centred spectrum, as from process().
+    */
+   void processBatch(std::span<const std::complex<float>> samples, std::size_t frames,
+                     std::vector<float>& magnitudesDb) const;
+
+   /**
+    * @brief Batched processPower() for Welch framing.
+    *
+    * Frame `f` starts at `samples[f * hop]`, so `hop < fftSize` gives
+    * overlapping segments.
+    *
+    * @param samples  I/Q samples covering (frames - 1) * hop + fftSize.
+    * @param frames   Number of segments to transform.
+    * @param hop      Distance between segment starts, in samples.
+    * @param power    Resized to frames * fftSize; row `f` is segment `f`'s
+    *                 linear power spectrum.
+    */
+   void processPowerBatch(std::span<const std::complex<float>> samples, std::size_t frames,
+                          std::size_t hop, std::vector<float>& power) const;
+
+   // -- Plan management -----------------------------------------------------
+
+   /**
+    * @brief Pre-build plans for the given sizes on a background thread.
+    * With the Auto backend this is also where each size is benchmarked.
+    * A later setFftSize() to one of them is then a pointer swap.  Calling
+    * again cancels the outstanding request (after its current plan).
+    * @param fftSizes  Sizes to prepare (already-available ones are skipped).
+    */
+   void prepareFftSizes(std::vector<size_t> fftSizes);
+
+   /** @brief Block until the background work from prepareFftSizes() is done. */
+   void waitForPreparedPlans();
+
+   /**
+    * @brief Check whether a plan for `fftSize` is active or cached.
+    * @return true if setFftSize(fftSize) would not need to plan.
+    */
+   [[nodiscard]] bool isPlanReady(size_t fftSize) const;
+
+   /**
+    * @brief Merge FFTW wisdom from a file into the process-wide planner.
+    * @return true if the file existed and was parsed.
+    */
+   static bool loadWisdom(const std::string& path);
+
+   /**
+    * @brief Write the process-wide FFTW wisdom to a file.
+    * @return true on success.
+    */
+   static bool saveWisdom(const std::string& path);
+
 private:
-   // (Re-)create the FFTW plan and window coefficients.
-   void rebuild();
+   struct Plan;          // Backend transform for one FFT size.
+   struct WindowTable;   // Window coefficients and coherent gain.
+   struct Update;        // Published plan and window, then their replaced pair.
+
+   // Upper bounds for one many-plan execution: at most MAX_BATCH_FRAMES
+   // frames and MAX_BATCH_SAMPLES complex samples of scratch per buffer.
+   static constexpr std::size_t MAX_BATCH_FRAMES  = 16;
+   static constexpr std::size_t MAX_BATCH_SAMPLES = std::size_t{1} << 20;
+
+   // Frames per many-plan execution for `fftSize`.
+   [[nodiscard]] static std::size_t batchFramesFor(size_t fftSize);
+
+   // Window + transform `frames` segments `hop` apart into `out` rows as
+   // dB magnitude (power == false) or linear power.
+   void runBatch(std::span<const std::complex<float>> samples, std::size_t frames,
+                 std::size_t hop, std::vector<float>& out, bool power) const;
+
+   // Shared body of the process() output-vector overloads.
+   template <typename Vector>
+   void processInto(std::span<const std::complex<float>> samples, Vector& magnitudesDb) const;
+
+   // Window `count` samples into the active plan's input, run it, and
+   // return the normalisation factor.
+   [[nodiscard]] float transformFrame(const std::complex<float>* samples,
+                                      std::size_t count) const;
+
+   // Processing thread: switch to the published update, if any.
+   void adoptUpdate() const;
+
+   // Setters (under _resizeMutex): hand `update` to the processing thread.
+   void publishUpdate(std::unique_ptr<Update> update);
+
+   // Setters (under _resizeMutex): take back the update not yet adopted, or
+   // wait until the processing thread has finished adopting the last one.
+   [[nodiscard]] std::unique_ptr<Update> retractUpdate();
+
+   // Cache the plans (and free the windows) the processing thread replaced.
+   void collectRetired() const;
+
+   // Remove and return a cached plan for `fftSize`, or null.
+   [[nodiscard]] std::unique_ptr<Plan> takeCachedPlan(size_t fftSize);
+
+   // Store an inactive plan for later reuse (dropped if of another backend).
+   void cachePlan(std::unique_ptr<Plan> plan) const;
 
-   // Destroy the current FFTW plan and free aligned buffers.
-   void destroy();
+   // Stop and join the prepareFftSizes() worker.
+   void cancelPrepare();
 
-   // Populate _window with the selected function.
-   void buildWindow();
+   // -- Processing thread only ----------------------------------------------
+   mutable std::unique_ptr<Plan> _active;          ///< Plan used by process().
+   mutable std::unique_ptr<WindowTable> _window;   ///< Window used by process().
 
-   mutable std::mutex _mutex;  ///< Guards all FFTW resources and window.
+   // -- Hand-over -----------------------------------------------------------
+   mutable std::atomic<Update*> _pending{nullptr};   ///< Setter -> processing.
+   mutable std::atomic<Update*> _retired{nullptr};   ///< Processing -> setters (a stack).
+   mutable std::atomic<uint64_t> _adoptedSeq{0};     ///< Seq of the last adopted update.
+   mutable std::atomic<size_t> _runningSize{0};      ///< _active's size.
+   mutable std::atomic<FftBackend> _runningBackend{FftBackend::Fftw};   ///< _active's.
 
-   size_t _fftSize;
-   WindowFunction _windowFunc;
+   // -- Published configuration (what the next processing call will use) ---
+   std::mutex _resizeMutex;    ///< Serialises the setters; guards _publishedSeq.
+   uint64_t _publishedSeq{0};  ///< Seq of the last update handed over.
+   std::atomic<size_t> _fftSize{0};
+   std::atomic<WindowFunction> _windowFunc{WindowFunction::BlackmanHarris};
+   std::atomic<FftBackend> _activeBackend{FftBackend::Fftw};
+   std::atomic<FftBackend> _backend{FftBackend::Auto};   ///< For new plans.
 
-   // FFTW resources — opaque so we don't expose fftw3.h.
-   float* _in{nullptr};        ///< FFTW input  (real interleaved as pairs).
-   float* _out{nullptr};       ///< FFTW output (complex interleaved).
-   fftwf_plan_s* _plan{nullptr};
+   mutable std::mutex _cacheMutex;   ///< Guards _planCache.
+   mutable std::map<size_t, std::unique_ptr<Plan>> _planCache;
 
-   std::vector<float> _window;  ///< Pre-computed window coefficients.
+   std::thread _prepareThread;
+   std::atomic<bool> _cancelPrepare{false};
 };
 
 } // namespace SdrEngine
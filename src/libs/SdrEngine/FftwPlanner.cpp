@@ -0,0 +1,13 @@
+// Project headers
+#include "FftwPlanner.h"
+
+namespace SdrEngine
+{
+
+std::mutex& fftwPlannerMutex()
+{
+   static std::mutex mutex;
+   return mutex;
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,24 @@
+#ifndef FFTWPLANNER_H_
+#define FFTWPLANNER_H_
+
+// System headers
+#include <mutex>
+
+namespace SdrEngine
+{
+
+/**
+ * @brief Process-wide lock for FFTW's planner.
+ *
+ * FFTW plan creation / destruction and wisdom import / export are not
+ * thread-safe, while executing an existing plan is.  Every planner call in
+ * SdrEngine (FftBackend, FftProcessor, Channelizer) holds this mutex; fftwf_execute()
+ * never takes it.
+ *
+ * @return The shared planner mutex.
+ */
+[[nodiscard]] std::mutex& fftwPlannerMutex();
+
+} // namespace SdrEngine
+
+#endif // FFTWPLANNER_H_
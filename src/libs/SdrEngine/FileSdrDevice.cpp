@@ -0,0 +1,604 @@
+// Project headers
+#include "FileSdrDevice.h"
+#include "DspKernels.h"
+#include "GeneralLogger.h"
+#include "ThreadConfig.h"
+#include "Vita49FileReader.h"
+#include "WorkerPool.h"
+
+// System headers
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Samples of VITA 49 playback decoded ahead in one batch.
+constexpr std::size_t VITA49_BATCH_SAMPLES = 256 * 1024;
+
+// Most threads, besides the stream thread, that decode a VITA 49 batch.
+constexpr std::size_t VITA49_DECODE_WORKERS = 7;
+
+// Bytes per complex sample of a raw capture.
+std::size_t bytesPerSample(IqFileFormat format)
+{
+   switch (format)
+   {
+   case IqFileFormat::CS16:
+      return 2 * sizeof(int16_t);
+   case IqFileFormat::CS8:
+      return 2 * sizeof(int8_t);
+   case IqFileFormat::CF32:
+   case IqFileFormat::Vita49:
+      break;
+   }
+   return sizeof(IqSample);
+}
+
+IqSampleFormat sampleFormatOf(IqFileFormat format)
+{
+   switch (format)
+   {
+   case IqFileFormat::CS16:
+      return IqSampleFormat::CS16;
+   case IqFileFormat::CS8:
+      return IqSampleFormat::CS8;
+   case IqFileFormat::CF32:
+   case IqFileFormat::Vita49:
+      break;
+   }
+   return IqSampleFormat::CF32;
+}
+
+float fullScaleOf(IqFileFormat format)
+{
+   switch (format)
+   {
+   case IqFileFormat::CS16:
+      return 32768.0F;
+   case IqFileFormat::CS8:
+      return 128.0F;
+   case IqFileFormat::CF32:
+   case IqFileFormat::Vita49:
+      break;
+   }
+   return 1.0F;
+}
+
+} // namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+FileSdrDevice::FileSdrDevice() = default;
+
+FileSdrDevice::FileSdrDevice(std::string path, IqFileFormat format)
+   : _path{std::move(path)}
+   , _format{format}
+{
+}
+
+FileSdrDevice::~FileSdrDevice()
+{
+   FileSdrDevice::close();
+}
+
+// ============================================================================
+// File playback
+// ============================================================================
+
+bool FileSdrDevice::setFile(std::string path, IqFileFormat format)
+{
+   if (isOpen())
+   {
+      GPWARN("FileSdrDevice::setFile() — close the device first");
+      return false;
+   }
+   _path   = std::move(path);
+   _format = format;
+   return true;
+}
+
+const std::string& FileSdrDevice::getFilePath() const
+{
+   return _path;
+}
+
+IqFileFormat FileSdrDevice::getFileFormat() const
+{
+   return _format;
+}
+
+void FileSdrDevice::setPacing(PlaybackPacing pacing)
+{
+   _pacing.store(pacing, std::memory_order_relaxed);
+}
+
+PlaybackPacing FileSdrDevice::getPacing() const
+{
+   return _pacing.load(std::memory_order_relaxed);
+}
+
+void FileSdrDevice::setLooping(bool enabled)
+{
+   _looping.store(enabled, std::memory_order_relaxed);
+}
+
+bool FileSdrDevice::isLooping() const
+{
+   return _looping.load(std::memory_order_relaxed);
+}
+
+uint64_t FileSdrDevice::getTotalSamples() const
+{
+   return _totalSamples;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool FileSdrDevice::open(int deviceIndex)
+{
+   if (isOpen())
+   {
+      GPWARN("FileSdrDevice::open() — file already open, closing first");
+      close();
+   }
+   if (deviceIndex != 0)
+   {
+      GPERROR("FileSdrDevice: device index {} out of range (only 0)", deviceIndex);
+      return false;
+   }
+
+   if (_format == IqFileFormat::Vita49)
+   {
+      if (!openVita49())
+      {
+         unmap();
+         return false;
+      }
+      GPINFO("Opened I/Q file '{}' ({} samples)", _path, _totalSamples);
+      return true;
+   }
+
+   _fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+   if (_fd < 0)
+   {
+      GPERROR("FileSdrDevice: cannot open '{}': {}", _path, std::strerror(errno));
+      return false;
+   }
+
+   struct stat info{};
+   if (::fstat(_fd, &info) != 0 || info.st_size <= 0)
+   {
+      GPERROR("FileSdrDevice: '{}' is empty or unreadable", _path);
+      unmap();
+      return false;
+   }
+   _mappingBytes = static_cast<std::size_t>(info.st_size);
+
+   void* mapped = ::mmap(nullptr, _mappingBytes, PROT_READ, MAP_PRIVATE, _fd, 0);
+   if (mapped == MAP_FAILED)
+   {
+      GPERROR("FileSdrDevice: mmap of '{}' failed: {}", _path, std::strerror(errno));
+      _mappingBytes = 0;
+      unmap();
+      return false;
+   }
+   _mapping = static_cast<const uint8_t*>(mapped);
+   // Playback reads front to back; let the kernel read ahead aggressively.
+   ::madvise(mapped, _mappingBytes, MADV_SEQUENTIAL);
+
+   // A trailing partial sample (truncated capture) is ignored.
+   _totalSamples = _mappingBytes / bytesPerSample(_format);
+   if (_totalSamples == 0)
+   {
+      GPERROR("FileSdrDevice: '{}' is shorter than one sample", _path);
+      unmap();
+      return false;
+   }
+
+   GPINFO("Opened I/Q file '{}' ({} samples)", _path, _totalSamples);
+   return true;
+}
+
+void FileSdrDevice::close()
+{
+   stopStreaming();
+   if (_streamThread.joinable())
+   {
+      _streamThread.join();   // Playback that ended on its own.
+   }
+   if (isOpen())
+   {
+      unmap();
+      GPINFO("Closed I/Q file '{}'", _path);
+   }
+}
+
+bool FileSdrDevice::isOpen() const
+{
+   return _mapping != nullptr || _vita49 != nullptr;
+}
+
+void FileSdrDevice::unmap()
+{
+   if (_mapping != nullptr)
+   {
+      // munmap() takes a mutable pointer; the mapping itself stays read-only.
+      ::munmap(const_cast<uint8_t*>(_mapping), _mappingBytes);
+      _mapping = nullptr;
+   }
+   if (_fd >= 0)
+   {
+      ::close(_fd);
+      _fd = -1;
+   }
+   _vita49.reset();
+   _mappingBytes = 0;
+   _totalSamples = 0;
+}
+
+bool FileSdrDevice::openVita49()
+{
+   _vita49 = std::make_unique<Vita49_2::Vita49FileReader>(Vita49_2::ByteOrder::BigEndian);
+   if (!_vita49->open(_path))
+   {
+      GPERROR("FileSdrDevice: {}", _vita49->error());
+      return false;
+   }
+
+   const auto index   = _vita49->index();
+   bool haveRate      = false;
+   bool haveFrequency = false;
+   for (std::size_t i = 0; i < index.size(); ++i)
+   {
+      _totalSamples += index[i].sampleCount;
+      if (!Vita49_2::isContextPacket(index[i].packetType) || (haveRate && haveFrequency))
+      {
+         continue;
+      }
+      const auto packet = _vita49->packet(i);
+      const auto fields = packet.has_value() ? packet->contextFields() : std::nullopt;
+      if (fields.has_value())
+      {
+         if (!haveRate && fields->sampleRate.has_value() && *fields->sampleRate > 0.0)
+         {
+            _sampleRateHz.store(static_cast<uint32_t>(std::lround(*fields->sampleRate)),
+                                std::memory_order_relaxed);
+            haveRate = true;
+         }
+         if (!haveFrequency && fields->rfFrequency.has_value() && *fields->rfFrequency > 0.0)
+         {
+            _centerFreqHz.store(static_cast<uint64_t>(std::llround(*fields->rfFrequency)),
+                                std::memory_order_relaxed);
+            haveFrequency = true;
+         }
+      }
+   }
+   if (_vita49->indexedBytes() < _vita49->bytes().size())
+   {
+      GPWARN("FileSdrDevice: truncated or malformed VITA 49 packet at byte {}, ignoring the rest",
+             _vita49->indexedBytes());
+   }
+   if (_totalSamples == 0)
+   {
+      GPERROR("FileSdrDevice: '{}' holds no VITA 49 signal data", _path);
+      return false;
+   }
+   return true;
+}
+
+// ============================================================================
+// Tuning
+// ============================================================================
+
+bool FileSdrDevice::setCenterFrequency(uint64_t frequencyHz)
+{
+   _centerFreqHz.store(frequencyHz, std::memory_order_relaxed);
+   return true;
+}
+
+uint64_t FileSdrDevice::getCenterFrequency() const
+{
+   return _centerFreqHz.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Sample rate
+// ============================================================================
+
+bool FileSdrDevice::setSampleRate(uint32_t rateHz)
+{
+   if (rateHz == 0)
+   {
+      return false;
+   }
+   _sampleRateHz.store(rateHz, std::memory_order_relaxed);
+   return true;
+}
+
+uint32_t FileSdrDevice::getSampleRate() const
+{
+   return _sampleRateHz.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Gain
+// ============================================================================
+
+bool FileSdrDevice::setAutoGain(bool /*enabled*/)
+{
+   return true;
+}
+
+bool FileSdrDevice::setGain(int tenthsDb)
+{
+   _gainTenthsDb.store(tenthsDb, std::memory_order_relaxed);
+   return true;
+}
+
+int FileSdrDevice::getGain() const
+{
+   return _gainTenthsDb.load(std::memory_order_relaxed);
+}
+
+std::vector<int> FileSdrDevice::getGainValues() const
+{
+   return {0};
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+bool FileSdrDevice::startStreaming(IqCallback callback, std::size_t bufferSize)
+{
+   return beginStreaming(std::move(callback), nullptr, bufferSize);
+}
+
+bool FileSdrDevice::startRawStreaming(RawIqCallback callback, std::size_t bufferSize)
+{
+   return beginStreaming(nullptr, std::move(callback), bufferSize);
+}
+
+bool FileSdrDevice::beginStreaming(IqCallback callback, RawIqCallback rawCallback,
+                                   std::size_t bufferSize)
+{
+   if (!isOpen())
+   {
+      GPERROR("Cannot start streaming — file not open");
+      return false;
+   }
+   if (_streaming)
+   {
+      GPWARN("Already streaming");
+      return false;
+   }
+   if (bufferSize == 0)
+   {
+      GPWARN("FileSdrDevice: buffer size must be positive");
+      return false;
+   }
+   if (_streamThread.joinable())
+   {
+      _streamThread.join();   // Previous playback ended on its own.
+   }
+
+   _callback    = std::move(callback);
+   _rawCallback = std::move(rawCallback);
+   _streaming   = true;
+   _streamCounters.start();
+   if (_format == IqFileFormat::Vita49)
+   {
+      _streamThread = std::thread(&FileSdrDevice::vita49StreamThread, this);
+   }
+   else
+   {
+      _streamThread = std::thread(&FileSdrDevice::rawStreamThread, this, bufferSize);
+   }
+   return true;
+}
+
+void FileSdrDevice::stopStreaming()
+{
+   if (!_streaming)
+   {
+      return;
+   }
+   _streaming = false;
+
+   if (_streamThread.joinable())
+   {
+      _streamThread.join();
+   }
+   GPINFO("Streaming stopped");
+}
+
+bool FileSdrDevice::isStreaming() const
+{
+   return _streaming;
+}
+
+DeviceStreamStats FileSdrDevice::getStreamStats() const
+{
+   return _streamCounters.snapshot();
+}
+
+void FileSdrDevice::setStreamThreadRole(std::string role)
+{
+   _streamThreadRole = role.empty() ? std::string("FileSdr.stream") : std::move(role);
+}
+
+void FileSdrDevice::pace(std::size_t samples)
+{
+   if (_pacing.load(std::memory_order_relaxed) == PlaybackPacing::RealTime)
+   {
+      _clock.pace(samples, static_cast<double>(_sampleRateHz.load(std::memory_order_relaxed)),
+                  _streaming);
+   }
+}
+
+void FileSdrDevice::rawStreamThread(std::size_t samplesPerBuffer)
+{
+   CommonUtils::configureCurrentThread(_streamThreadRole);
+   const std::size_t sampleBytes = bytesPerSample(_format);
+   const IqSampleFormat format   = sampleFormatOf(_format);
+   const float fullScale         = fullScaleOf(_format);
+
+   // Only startStreaming() consumers of integer captures need a copy.
+   std::vector<IqSample> converted;
+   if (_callback && format != IqSampleFormat::CF32)
+   {
+      converted.resize(samplesPerBuffer);
+   }
+
+   _clock.start();
+   uint64_t position = 0;
+   while (_streaming)
+   {
+      if (position >= _totalSamples)
+      {
+         if (!isLooping())
+         {
+            break;
+         }
+         position = 0;
+      }
+      const auto count = static_cast<std::size_t>(
+         std::min<uint64_t>(samplesPerBuffer, _totalSamples - position));
+      pace(count);
+      if (!_streaming)
+      {
+         break;
+      }
+
+      const RawIqBlock block{_mapping + (position * sampleBytes), format, count, fullScale};
+      _streamCounters.recordRead(count, samplesPerBuffer);
+      if (_rawCallback)
+      {
+         _rawCallback(block);
+      }
+      else if (format == IqSampleFormat::CF32)
+      {
+         // The mapping is page aligned and CF32 samples are 8 bytes, so
+         // every block is a properly aligned IqSample array.
+         _callback(static_cast<const IqSample*>(block.data), count);
+      }
+      else
+      {
+         convertToIq(block, 0, converted.data(), count);
+         _callback(converted.data(), count);
+      }
+      position += count;
+   }
+   _streaming = false;
+}
+
+void FileSdrDevice::vita49StreamThread()
+{
+   CommonUtils::configureCurrentThread(_streamThreadRole);
+   // Batches of packets are decoded ahead into one buffer, in parallel,
+   // then handed out a packet at a time.
+   CommonUtils::WorkerPool workers(
+      std::min(CommonUtils::WorkerPool::defaultWorkerCount(), VITA49_DECODE_WORKERS));
+   const auto parallelFor = [&workers](std::size_t count, const std::function<void(std::size_t)>& task)
+   {
+      workers.run(count, task);
+   };
+   const auto index = _vita49->index();
+   std::vector<IqSample> samples(VITA49_BATCH_SAMPLES);
+
+   _clock.start();
+   std::size_t next = 0;
+   while (_streaming)
+   {
+      if (next >= index.size())
+      {
+         if (!isLooping())
+         {
+            break;
+         }
+         next = 0;
+      }
+
+      // At least one packet, then as many as fit the batch.
+      std::size_t end          = next;
+      std::size_t batchSamples = 0;
+      while (end < index.size() &&
+             (end == next || batchSamples + index[end].sampleCount <= samples.size()))
+      {
+         batchSamples += index[end].sampleCount;
+         ++end;
+      }
+      samples.resize(std::max(samples.size(), batchSamples));
+      if (_vita49->decodeSamples(next, end - next, samples, Vita49_2::DEFAULT_SCALE_FACTOR,
+                                 parallelFor) != batchSamples)
+      {
+         _streamCounters.recordError();
+      }
+
+      std::size_t offset = 0;
+      for (; next < end && _streaming; ++next)
+      {
+         const std::size_t count = index[next].sampleCount;
+         if (count == 0)
+         {
+            continue;   // Context packet.
+         }
+         pace(count);
+         if (!_streaming)
+         {
+            break;
+         }
+
+         _streamCounters.recordRead(count, count);
+         if (_rawCallback)
+         {
+            _rawCallback(RawIqBlock{samples.data() + offset, IqSampleFormat::CF32, count, 1.0F});
+         }
+         else
+         {
+            _callback(samples.data() + offset, count);
+         }
+         offset += count;
+      }
+   }
+   _streaming = false;
+}
+
+// ============================================================================
+// Device info
+// ============================================================================
+
+std::string FileSdrDevice::getName() const
+{
+   return "I/Q file: " + (_path.empty() ? std::string("(none)") : _path);
+}
+
+std::vector<DeviceInfo> FileSdrDevice::enumerateDevices() const
+{
+   if (_path.empty())
+   {
+      return {};
+   }
+   DeviceInfo info;
+   info.index        = 0;
+   info.name         = _path;
+   info.manufacturer = "file";
+   return {info};
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,209 @@
+#ifndef FILESDRDEVICE_H_
+#define FILESDRDEVICE_H_
+
+// Project headers
+#include "ISdrDevice.h"
+#include "PlaybackClock.h"
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Vita49_2
+{
+class Vita49FileReader;
+}
+
+namespace SdrEngine
+{
+
+/**
+ * @brief On-disk layout of an I/Q capture played by FileSdrDevice.
+ */
+enum class IqFileFormat : uint8_t
+{
+   CF32,     ///< Raw interleaved 32-bit float (e.g. GNU Radio, SDR++).
+   CS16,     ///< Raw interleaved signed 16-bit integer, host byte order.
+   CS8,      ///< Raw interleaved signed 8-bit integer.
+   Vita49    ///< Big-endian VITA 49.2 packets (as written by Vita49FileCodec).
+};
+
+/**
+ * @class FileSdrDevice
+ * @brief ISdrDevice that plays an I/Q capture file.
+ *
+ * Gives the pipeline reproducible input for regression tests and lets
+ * benchmarks measure SdrEngine's sustainable throughput without hardware.
+ *
+ * open() memory-maps the file read-only.  Raw captures are delivered
+ * straight from the mapping: startRawStreaming() hands out RawIqBlocks that
+ * point into it for every format, and startStreaming() does so for CF32
+ * (CS16 / CS8 are converted with the DspKernels first).  VITA 49 files are
+ * opened through a Vita49FileReader (whose sidecar index makes reopening
+ * large recordings immediate), take their sample rate and centre frequency
+ * from the first context packet that carries them, and are delivered one
+ * signal data packet per block.  Their big-endian payload cannot be used in
+ * place, so batches of packets are decoded ahead on a WorkerPool.
+ *
+ * Tuning and gain are accepted and reported back but do not change the
+ * samples.  The sample rate sets the RealTime pace.  Without looping the
+ * stream ends (isStreaming() turns false) after the last sample.
+ *
+ * Thread-safety: same as ISdrDevice; the pacing, looping and sample rate
+ * may be changed while streaming.
+ */
+class FileSdrDevice : public ISdrDevice
+{
+public:
+   /** @brief Default sample rate of a raw capture until one is set. */
+   static constexpr uint32_t DEFAULT_SAMPLE_RATE = 2'048'000;
+
+   FileSdrDevice();
+
+   /**
+    * @brief Construct a device for one capture file.
+    * @param path    Capture to play.
+    * @param format  Layout of the file.
+    */
+   FileSdrDevice(std::string path, IqFileFormat format);
+
+   ~FileSdrDevice() override;
+
+   // -- File playback -------------------------------------------------------
+
+   /**
+    * @brief Select the capture to play.  Only while closed.
+    * @param path    Capture to play.
+    * @param format  Layout of the file.
+    * @return true on success, false if the device is open.
+    */
+   [[nodiscard]] bool setFile(std::string path, IqFileFormat format);
+
+   /**
+    * @brief Get the capture path.
+    * @return Path set by setFile() or the constructor.
+    */
+   [[nodiscard]] const std::string& getFilePath() const;
+
+   /**
+    * @brief Get the capture layout.
+    * @return Format set by setFile() or the constructor.
+    */
+   [[nodiscard]] IqFileFormat getFileFormat() const;
+
+   /**
+    * @brief Set how fast samples are delivered.
+    * @param pacing  RealTime (default) or AsFastAsPossible.
+    */
+   void setPacing(PlaybackPacing pacing);
+
+   /**
+    * @brief Get the playback pacing.
+    * @return Current pacing.
+    */
+   [[nodiscard]] PlaybackPacing getPacing() const;
+
+   /**
+    * @brief Restart from the beginning instead of ending the stream.
+    * @param enabled  true to loop forever (default false).
+    */
+   void setLooping(bool enabled);
+
+   /**
+    * @brief Check if playback loops.
+    * @return true if looping is enabled.
+    */
+   [[nodiscard]] bool isLooping() const;
+
+   /**
+    * @brief Get the number of complex samples in the open file.
+    * @return Sample count, or 0 while closed.
+    */
+   [[nodiscard]] uint64_t getTotalSamples() const;
+
+   // -- ISdrDevice ----------------------------------------------------------
+
+   /**
+    * @brief Map the capture file.
+    * @param deviceIndex  Must be 0 (the file is the only "device").
+    * @return true on success.
+    */
+   [[nodiscard]] bool open(int deviceIndex = 0) override;
+   void close() override;
+   [[nodiscard]] bool isOpen() const override;
+
+   [[nodiscard]] bool setCenterFrequency(uint64_t frequencyHz) override;
+   [[nodiscard]] uint64_t getCenterFrequency() const override;
+
+   [[nodiscard]] bool setSampleRate(uint32_t rateHz) override;
+   [[nodiscard]] uint32_t getSampleRate() const override;
+
+   [[nodiscard]] bool setAutoGain(bool enabled) override;
+   [[nodiscard]] bool setGain(int tenthsDb) override;
+   [[nodiscard]] int getGain() const override;
+   [[nodiscard]] std::vector<int> getGainValues() const override;
+
+   [[nodiscard]] bool startStreaming(IqCallback callback,
+                                    std::size_t bufferSize = 8192) override;
+   [[nodiscard]] bool startRawStreaming(RawIqCallback callback,
+                                       std::size_t bufferSize = 8192) override;
+   void stopStreaming() override;
+   [[nodiscard]] bool isStreaming() const override;
+   [[nodiscard]] DeviceStreamStats getStreamStats() const override;
+   void setStreamThreadRole(std::string role) override;
+
+   [[nodiscard]] std::string getName() const override;
+   [[nodiscard]] std::vector<DeviceInfo> enumerateDevices() const override;
+
+private:
+   // Open the VITA 49 file: count its samples and take the rate /
+   // frequency from context packets.
+   [[nodiscard]] bool openVita49();
+
+   // Launch the playback thread.  Exactly one of the callbacks must be set.
+   [[nodiscard]] bool beginStreaming(IqCallback callback, RawIqCallback rawCallback,
+                                     std::size_t bufferSize);
+
+   // Thread bodies: deliver raw blocks / decoded VITA 49 packets.
+   void rawStreamThread(std::size_t samplesPerBuffer);
+   void vita49StreamThread();
+
+   // Sleep until a block of `samples` is due at the RealTime pace.
+   void pace(std::size_t samples);
+
+   // Release the mapping, file descriptor and VITA 49 reader.
+   void unmap();
+
+   std::string _path;
+   IqFileFormat _format{IqFileFormat::CF32};
+
+   int _fd{-1};
+   const uint8_t* _mapping{nullptr};
+   std::size_t _mappingBytes{0};
+   uint64_t _totalSamples{0};
+   std::unique_ptr<Vita49_2::Vita49FileReader> _vita49;   // VITA 49 files only.
+
+   std::atomic<uint64_t> _centerFreqHz{0};
+   std::atomic<uint32_t> _sampleRateHz{DEFAULT_SAMPLE_RATE};
+   std::atomic<int> _gainTenthsDb{0};
+   std::atomic<PlaybackPacing> _pacing{PlaybackPacing::RealTime};
+   std::atomic<bool> _looping{false};
+
+   std::atomic<bool> _streaming{false};
+   DeviceStreamCounters _streamCounters;   // Written by the stream thread.
+   std::thread _streamThread;
+   std::string _streamThreadRole{"FileSdr.stream"};   // Set while stopped.
+   IqCallback _callback;               ///< Set by startStreaming().
+   RawIqCallback _rawCallback;         ///< Set by startRawStreaming().
+
+   PlaybackClock _clock;   // Owned by the stream thread.
+};
+
+} // namespace SdrEngine
+
+#endif // FILESDRDEVICE_H_
@@ -0,0 +1,329 @@
+// Project headers
+#include "FmStereoDecoder.h"
+#include "DspKernels.h"
+#include "GeneralLogger.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Lowest output rate that keeps the 19 kHz+ stop band from aliasing into
+// the 15 kHz audio band.
+constexpr double MIN_OUTPUT_RATE = FmStereoDecoder::AUDIO_CUTOFF_HZ + FmStereoDecoder::PILOT_HZ;
+
+// L+R / L-R low-pass: flat to 15 kHz, 50 dB down by the pilot.
+constexpr double LPF_STOP_HZ    = FmStereoDecoder::PILOT_HZ;
+constexpr double LPF_ATTEN_DB   = 50.0;
+
+// Pilot band-pass: 19 kHz ± 1 kHz, 40 dB down over the audio band and the
+// lower L-R sideband (below 15 kHz and above 23 kHz).
+constexpr double PILOT_HALF_PASS_HZ = 1000.0;
+constexpr double PILOT_TRANSITION_HZ = 3000.0;
+constexpr double PILOT_ATTEN_DB      = 40.0;
+
+constexpr std::size_t MAX_TAPS = 511;
+
+// PLL: critically damped enough to ride out audio leakage, settles in tens
+// of milliseconds.
+constexpr double PLL_NATURAL_HZ = 50.0;
+constexpr double PLL_DAMPING    = 0.707;
+
+// Below this pilot amplitude the PLL coasts at its last frequency.
+constexpr float MIN_PILOT_LEVEL = 1.0e-4F;
+
+// Zeroth-order modified Bessel function of the first kind (power series).
+double besselI0(double x)
+{
+   double sum  = 1.0;
+   double term = 1.0;
+   const double halfX = x / 2.0;
+   for (int k = 1; k < 50; ++k)
+   {
+      term *= (halfX / k) * (halfX / k);
+      sum += term;
+      if (term < sum * 1.0e-12)
+      {
+         break;
+      }
+   }
+   return sum;
+}
+
+// Odd Kaiser-window length for a transition of `transition` cycles/sample.
+std::size_t kaiserLength(double attenDb, double transition)
+{
+   const double taps = std::ceil((attenDb - 8.0) / (2.285 * 2.0 * std::numbers::pi * transition));
+   const auto len = std::min(static_cast<std::size_t>(taps), MAX_TAPS);
+   return len | 1U;
+}
+
+// Kaiser-window shape for a stop-band attenuation.
+double kaiserBeta(double attenDb)
+{
+   if (attenDb > 50.0)
+   {
+      return 0.1102 * (attenDb - 8.7);
+   }
+   return (0.5842 * std::pow(attenDb - 21.0, 0.4)) + (0.07886 * (attenDb - 21.0));
+}
+
+// Windowed-sinc low-pass with unity DC gain, cutoff in cycles/sample,
+// optionally shifted up to `centre` cycles/sample as a band-pass with unity
+// gain there.
+std::vector<float> designFilter(std::size_t len, double cutoff, double attenDb, double centre = 0.0)
+{
+   const double mid    = static_cast<double>(len - 1) / 2.0;
+   const double beta   = kaiserBeta(attenDb);
+   const double i0Beta = besselI0(beta);
+   std::vector<double> taps(len);
+   double sum = 0.0;
+   for (std::size_t i = 0; i < len; ++i)
+   {
+      const double t     = static_cast<double>(i) - mid;
+      const double arg   = 2.0 * cutoff * t;
+      const double sinc  = (t == 0.0) ? 1.0
+                                      : std::sin(std::numbers::pi * arg) / (std::numbers::pi * arg);
+      const double ratio = t / mid;
+      const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - (ratio * ratio)))) / i0Beta;
+      taps[i] = sinc * window;
+      sum += taps[i];
+   }
+
+   std::vector<float> out(len);
+   for (std::size_t i = 0; i < len; ++i)
+   {
+      double tap = taps[i] / sum;
+      if (centre > 0.0)
+      {
+         const double t = static_cast<double>(i) - mid;
+         tap *= 2.0 * std::cos(2.0 * std::numbers::pi * centre * t);
+      }
+      out[i] = static_cast<float>(tap);
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Streaming FIR
+// ============================================================================
+
+void FmStereoDecoder::StreamingFir::design(std::vector<float> coefficients, std::size_t factor,
+                                           std::size_t maxBlock)
+{
+   taps       = std::move(coefficients);
+   decimation = factor;
+   buffer.reserve(taps.size() - 1 + maxBlock);
+   reset();
+}
+
+void FmStereoDecoder::StreamingFir::reset()
+{
+   buffer.assign(taps.size() - 1, 0.0F);
+   offset = 0;
+}
+
+std::size_t FmStereoDecoder::StreamingFir::process(const float* in, std::size_t n, float* out)
+{
+   const std::size_t history = taps.size() - 1;
+   buffer.resize(history + n);
+   std::copy(in, in + n, buffer.begin() + static_cast<std::ptrdiff_t>(history));
+
+   // Every output whose window ends inside the buffer; the next window
+   // starts at offset + outputs * decimation, at or past the new block.
+   const std::size_t total = history + n;
+   std::size_t outputs = 0;
+   if (total >= offset + taps.size())
+   {
+      outputs = ((total - offset - taps.size()) / decimation) + 1;
+      firDecimate(buffer.data() + offset, taps.data(), taps.size(), out, outputs, decimation);
+   }
+   offset = offset + (outputs * decimation) - n;
+
+   std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(n), buffer.end(), buffer.begin());
+   buffer.resize(history);
+   return outputs;
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+std::size_t FmStereoDecoder::decimationFor(double inputRate, double audioRate)
+{
+   const double outputRate = std::max(audioRate, MIN_OUTPUT_RATE);
+   if (inputRate <= outputRate)
+   {
+      return 1;
+   }
+   return static_cast<std::size_t>(inputRate / outputRate);
+}
+
+bool FmStereoDecoder::configure(double inputRate, std::size_t decimation,
+                                std::size_t maxBlockSamples)
+{
+   _configured = false;
+   if (inputRate < MIN_INPUT_RATE || decimation == 0 ||
+       inputRate / static_cast<double>(decimation) < MIN_OUTPUT_RATE)
+   {
+      GPWARN("FmStereoDecoder::configure: unsupported rate {:.0f} Hz / decimation {}",
+             inputRate, decimation);
+      return false;
+   }
+   _inputRate = inputRate;
+
+   const double lpfCutoff = (AUDIO_CUTOFF_HZ + LPF_STOP_HZ) / 2.0 / inputRate;
+   const std::size_t lpfLen =
+      kaiserLength(LPF_ATTEN_DB, (LPF_STOP_HZ - AUDIO_CUTOFF_HZ) / inputRate);
+   const auto lpf = designFilter(lpfLen, lpfCutoff, LPF_ATTEN_DB);
+   _sumLpf.design(lpf, decimation, maxBlockSamples);
+   _diffLpf.design(lpf, decimation, maxBlockSamples);
+
+   const std::size_t bpfLen = kaiserLength(PILOT_ATTEN_DB, PILOT_TRANSITION_HZ / inputRate);
+   _pilotBpf.design(designFilter(bpfLen, (PILOT_HALF_PASS_HZ + (PILOT_TRANSITION_HZ / 2.0)) / inputRate,
+                                 PILOT_ATTEN_DB, PILOT_HZ / inputRate),
+                    1, maxBlockSamples);
+   _pilotDelay = static_cast<float>(bpfLen - 1) / 2.0F;
+
+   _pilot.resize(maxBlockSamples);
+   _diffIn.resize(maxBlockSamples);
+
+   for (std::size_t i = 0; i < SINE_TABLE_SIZE; ++i)
+   {
+      _sine[i] = static_cast<float>(std::sin(2.0 * std::numbers::pi * static_cast<double>(i) /
+                                             static_cast<double>(SINE_TABLE_SIZE)));
+   }
+
+   // Phase detector gain is pi per turn once the pilot is normalised
+   // (0.5 * sin(2 pi dphase)); see process().
+   const double omega = 2.0 * std::numbers::pi * PLL_NATURAL_HZ / inputRate;
+   _alpha      = static_cast<float>(2.0 * PLL_DAMPING * omega / std::numbers::pi);
+   _beta       = static_cast<float>(omega * omega / std::numbers::pi);
+   _centreFreq = static_cast<float>(PILOT_HZ / inputRate);
+
+   reset();
+   _configured = true;
+   GPINFO("FmStereoDecoder: {:.0f} Hz / {}, pilot BPF {} taps, L+R/L-R LPF {} taps",
+          inputRate, decimation, bpfLen, lpfLen);
+   return true;
+}
+
+bool FmStereoDecoder::isConfigured() const
+{
+   return _configured;
+}
+
+void FmStereoDecoder::reset()
+{
+   _pilotBpf.reset();
+   _sumLpf.reset();
+   _diffLpf.reset();
+   _phase      = 0.0F;
+   _freq       = _centreFreq;
+   _pilotLevel = 0.0F;
+}
+
+std::size_t FmStereoDecoder::outputBound(std::size_t n) const
+{
+   return (n / _sumLpf.decimation) + 1;
+}
+
+std::size_t FmStereoDecoder::getDecimation() const
+{
+   return _sumLpf.decimation;
+}
+
+float FmStereoDecoder::getPilotLevel() const
+{
+   return _pilotLevel;
+}
+
+double FmStereoDecoder::getPilotFrequency() const
+{
+   return static_cast<double>(_freq) * _inputRate;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+std::size_t FmStereoDecoder::process(const float* composite, float* left, float* right,
+                                     std::size_t n)
+{
+   if (!_configured || n == 0)
+   {
+      return 0;
+   }
+   if (_pilot.size() < n)
+   {
+      _pilot.resize(n);
+      _diffIn.resize(n);
+   }
+
+   // 1) Pilot band-pass for the whole block (no decimation: one output per
+   //    input), then its amplitude, used to normalise the phase detector.
+   static_cast<void>(_pilotBpf.process(composite, n, _pilot.data()));
+   double power = 0.0;
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      power += static_cast<double>(_pilot[i]) * static_cast<double>(_pilot[i]);
+   }
+   _pilotLevel = static_cast<float>(std::sqrt(2.0 * power / static_cast<double>(n)));
+   const float norm = (_pilotLevel > MIN_PILOT_LEVEL) ? 1.0F / _pilotLevel : 0.0F;
+
+   // 2) PLL and sub-carrier mix.  For a pilot cos(2 pi phi), pilot * sin(2 pi
+   //    theta) averages 0.5 * sin(2 pi (theta - phi)), which the loop drives
+   //    to zero.  The pilot lags the composite by the band-pass delay, so
+   //    the carrier phase is advanced by freq * delay; with the pilot at
+   //    sin(psi) the sub-carrier sin(2 psi) is then -sin(2 pi * 2 theta').
+   constexpr std::size_t MASK = SINE_TABLE_SIZE - 1;
+   constexpr auto TABLE = static_cast<float>(SINE_TABLE_SIZE);
+   float phase = _phase;
+   float freq  = _freq;
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const auto index = static_cast<std::size_t>(phase * TABLE) & MASK;
+      const auto index2 =
+         static_cast<std::size_t>(2.0F * (phase + (freq * _pilotDelay)) * TABLE) & MASK;
+      const float error = _pilot[i] * _sine[index] * norm;
+      _diffIn[i] = -2.0F * composite[i] * _sine[index2];   // x2 for the DSB-SC loss.
+
+      freq -= _beta * error;
+      phase += freq - (_alpha * error);
+      if (phase >= 1.0F)
+      {
+         phase -= 1.0F;
+      }
+      else if (phase < 0.0F)
+      {
+         phase += 1.0F;
+      }
+   }
+   _phase = phase;
+   _freq  = freq;
+
+   // 3) Decimating L+R and L-R low-pass filters.  The sum filter copies the
+   //    composite before writing, so left may alias it.
+   const std::size_t outputs = _sumLpf.process(composite, n, left);
+   static_cast<void>(_diffLpf.process(_diffIn.data(), n, right));
+
+   // 4) Matrix.
+   for (std::size_t i = 0; i < outputs; ++i)
+   {
+      const float sum  = left[i];
+      const float diff = right[i];
+      left[i]  = (sum + diff) * 0.5F;
+      right[i] = (sum - diff) * 0.5F;
+   }
+   return outputs;
+}
+
+} // namespace SdrEngine
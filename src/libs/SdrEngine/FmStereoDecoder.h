@@ -0,0 +1,151 @@
+#ifndef FMSTEREODECODER_H_
+#define FMSTEREODECODER_H_
+
+// System headers
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class FmStereoDecoder
+ * @brief Block-based FM broadcast stereo (MPX) decoder.
+ *
+ * Splits the FM discriminator output (the composite) into left and right
+ * audio, one block at a time:
+ *   1. 19 kHz pilot band-pass over the whole block (firDecimate()).
+ *   2. Second-order PLL locked to the pilot.  The 38 kHz sub-carrier is
+ *      read from a sine table at twice the PLL phase, advanced by the
+ *      band-pass group delay, and mixed with the composite to bring L-R
+ *      back to baseband.
+ *   3. 15 kHz L+R and L-R low-pass filters run as decimating FIR kernels,
+ *      so only every getDecimation()-th output is computed.
+ *   4. L = (sum + diff) / 2, R = (sum - diff) / 2 at the decimated rate.
+ *
+ * The output rate is input rate / getDecimation(): de-emphasis and the
+ * final resample run after the decoder, on fewer samples.  The filters are
+ * Kaiser-windowed sincs designed here, so no liquid-dsp objects are
+ * involved.
+ *
+ * Thread-safety: none; owned and serialised by one Demodulator.
+ */
+class FmStereoDecoder
+{
+public:
+   /// Stereo pilot tone frequency (Hz).
+   static constexpr double PILOT_HZ = 19000.0;
+
+   /// Audio bandwidth kept in the L+R and L-R channels (Hz).
+   static constexpr double AUDIO_CUTOFF_HZ = 15000.0;
+
+   /// Lowest composite rate that carries the full L-R band (38 ± 15 kHz).
+   static constexpr double MIN_INPUT_RATE = 2.0 * (2.0 * PILOT_HZ + AUDIO_CUTOFF_HZ);
+
+   /**
+    * @brief Largest decimation that keeps the output at or above audioRate.
+    * @param inputRate  Composite sample rate (Hz).
+    * @param audioRate  Final audio rate (Hz).
+    * @return Decimation factor, at least 1.
+    */
+   [[nodiscard]] static std::size_t decimationFor(double inputRate, double audioRate);
+
+   /**
+    * @brief Design the filters and reset the state.
+    * @param inputRate        Composite sample rate (Hz), at least MIN_INPUT_RATE.
+    * @param decimation       Output decimation factor (>= 1).
+    * @param maxBlockSamples  Largest block process() will usually see; the
+    *                         work buffers are preallocated for it.
+    * @return false (and left unconfigured) for an invalid rate or factor.
+    */
+   [[nodiscard]] bool configure(double inputRate, std::size_t decimation,
+                                std::size_t maxBlockSamples);
+
+   /**
+    * @brief Check whether configure() succeeded.
+    * @return true once the decoder can process blocks.
+    */
+   [[nodiscard]] bool isConfigured() const;
+
+   /**
+    * @brief Clear the filter histories and re-centre the PLL.
+    */
+   void reset();
+
+   /**
+    * @brief Decode one composite block.
+    * @param composite  `n` composite samples.
+    * @param left       Receives the left channel; may alias @p composite.
+    * @param right      Receives the right channel.
+    * @param n          Number of composite samples.
+    * @return Output samples written to each channel (at most outputBound(n)).
+    */
+   std::size_t process(const float* composite, float* left, float* right, std::size_t n);
+
+   /**
+    * @brief Upper bound on the outputs produced from `n` composite samples.
+    * @return `n / decimation + 1`.
+    */
+   [[nodiscard]] std::size_t outputBound(std::size_t n) const;
+
+   /**
+    * @brief Get the output decimation factor.
+    * @return Decimation set by configure().
+    */
+   [[nodiscard]] std::size_t getDecimation() const;
+
+   /**
+    * @brief Get the pilot amplitude measured over the last block.
+    * @return Peak pilot amplitude in composite units.
+    */
+   [[nodiscard]] float getPilotLevel() const;
+
+   /**
+    * @brief Get the frequency the PLL is tracking.
+    * @return Pilot frequency estimate (Hz).
+    */
+   [[nodiscard]] double getPilotFrequency() const;
+
+private:
+   /// FIR over a stream of blocks: keeps the last numTaps - 1 inputs and
+   /// the decimation phase between calls.
+   struct StreamingFir
+   {
+      std::vector<float> taps;      // Correlation order (symmetric here).
+      std::vector<float> buffer;    // History followed by the current block.
+      std::size_t decimation{1};
+      std::size_t offset{0};        // Start of the next output's window.
+
+      void design(std::vector<float> coefficients, std::size_t factor, std::size_t maxBlock);
+      void reset();
+      std::size_t process(const float* in, std::size_t n, float* out);
+   };
+
+   static constexpr std::size_t SINE_TABLE_SIZE = 4096;
+
+   bool _configured{false};
+   double _inputRate{0.0};
+
+   StreamingFir _pilotBpf;
+   StreamingFir _sumLpf;
+   StreamingFir _diffLpf;
+
+   std::vector<float> _pilot;    // Band-passed pilot of the current block.
+   std::vector<float> _diffIn;   // Composite mixed down by the sub-carrier.
+
+   std::array<float, SINE_TABLE_SIZE> _sine{};
+
+   // PLL state, in turns (cycles) and turns per sample.
+   float _phase{0.0F};
+   float _freq{0.0F};
+   float _centreFreq{0.0F};
+   float _alpha{0.0F};           // Phase gain.
+   float _beta{0.0F};            // Frequency gain.
+   float _pilotDelay{0.0F};      // Pilot band-pass group delay (samples).
+   float _pilotLevel{0.0F};
+};
+
+} // namespace SdrEngine
+
+#endif // FMSTEREODECODER_H_
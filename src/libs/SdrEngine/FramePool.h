@@ -0,0 +1,205 @@
+#ifndef FRAMEPOOL_H_
+#define FRAMEPOOL_H_
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class FramePoolStats
+ * @brief Snapshot of a FramePool's recycling counters.
+ */
+struct FramePoolStats
+{
+   uint64_t hits{0};        ///< acquire() calls served from the free list.
+   uint64_t misses{0};      ///< acquire() calls that had to allocate.
+   std::size_t pooled{0};   ///< Frames currently idle in the free list.
+};
+
+/**
+ * @class FramePool
+ * @brief Recycles heap-allocated frames (IqBuffer, SpectrumData, ...) so the
+ *        processing loop does not allocate FFT-sized buffers every cycle.
+ *
+ * `acquire()` returns a `shared_ptr` whose deleter hands the object back to
+ * the pool once the last holder (typically the last DataHandler listener)
+ * releases it.  Recycled objects keep their vectors' capacity, so after a
+ * short warm-up reusing a frame costs no allocation.  Callers must
+ * overwrite every field they publish — recycled frames carry stale data.
+ *
+ * The free list lives in a shared state object captured by every deleter,
+ * so frames still held by listeners may safely outlive the pool itself.
+ * At most `maxPooled` idle frames are kept; extra returns are deleted.
+ *
+ * The shared_ptr control block of each acquire() comes from a pool
+ * resource in the shared state, so steady-state acquire / release cycles
+ * stay off the global heap entirely.
+ *
+ * Thread-safety: acquire() and frame release may happen on any thread.
+ */
+template <typename T>
+class FramePool
+{
+public:
+   /**
+    * @brief Construct an empty pool.
+    * @param maxPooled  Maximum number of idle frames retained for reuse.
+    */
+   explicit FramePool(std::size_t maxPooled = 16)
+      : _state{std::make_shared<State>()}
+   {
+      _state->maxPooled = maxPooled;
+      _state->free.reserve(maxPooled);
+   }
+
+   // Non-copyable, non-movable (deleters reference the shared state).
+   FramePool(const FramePool&) = delete;
+   FramePool& operator=(const FramePool&) = delete;
+   FramePool(FramePool&&) = delete;
+   FramePool& operator=(FramePool&&) = delete;
+   ~FramePool() = default;
+
+   /**
+    * @brief Take a frame from the pool, allocating a new one if empty.
+    * @return Frame that returns itself to the pool when released.
+    */
+   [[nodiscard]] std::shared_ptr<T> acquire()
+   {
+      std::unique_ptr<T> frame;
+      {
+         const std::lock_guard<std::mutex> lock(_state->mutex);
+         if (!_state->free.empty())
+         {
+            frame = std::move(_state->free.back());
+            _state->free.pop_back();
+         }
+      }
+
+      if (frame)
+      {
+         _state->hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+         _state->misses.fetch_add(1, std::memory_order_relaxed);
+         frame = std::make_unique<T>();
+      }
+      return wrap(std::move(frame));
+   }
+
+   /**
+    * @brief Allocate frames up front so the first cycles hit the pool.
+    * @param count  Number of frames to add (capped at maxPooled).
+    * @param init   Called once per new frame, e.g. to reserve vector storage.
+    */
+   template <typename Init>
+   void prefill(std::size_t count, Init&& init)
+   {
+      const std::lock_guard<std::mutex> lock(_state->mutex);
+      while (count-- > 0 && _state->free.size() < _state->maxPooled)
+      {
+         auto frame = std::make_unique<T>();
+         init(*frame);
+         _state->free.push_back(std::move(frame));
+      }
+   }
+
+   /** @brief Drop all idle frames (outstanding frames are unaffected). */
+   void clear()
+   {
+      const std::lock_guard<std::mutex> lock(_state->mutex);
+      _state->free.clear();
+   }
+
+   /**
+    * @brief Get the current hit/miss counters.
+    * @return Snapshot of the pool statistics.
+    */
+   [[nodiscard]] FramePoolStats stats() const
+   {
+      FramePoolStats out;
+      out.hits   = _state->hits.load(std::memory_order_relaxed);
+      out.misses = _state->misses.load(std::memory_order_relaxed);
+      const std::lock_guard<std::mutex> lock(_state->mutex);
+      out.pooled = _state->free.size();
+      return out;
+   }
+
+   /** @brief Zero the hit/miss counters. */
+   void resetStats()
+   {
+      _state->hits.store(0, std::memory_order_relaxed);
+      _state->misses.store(0, std::memory_order_relaxed);
+   }
+
+private:
+   struct State
+   {
+      std::mutex mutex;
+      std::vector<std::unique_ptr<T>> free;
+      std::size_t maxPooled{0};
+      std::atomic<uint64_t> hits{0};
+      std::atomic<uint64_t> misses{0};
+      std::pmr::synchronized_pool_resource blocks;   // shared_ptr control blocks.
+   };
+
+   // Allocates control blocks from State::blocks.  Holding the state keeps
+   // the resource alive until the last block has been returned to it.
+   template <typename U>
+   struct BlockAllocator
+   {
+      using value_type = U;
+
+      explicit BlockAllocator(std::shared_ptr<State> owner) : state(std::move(owner)) {}
+
+      template <typename V>
+      BlockAllocator(const BlockAllocator<V>& other) : state(other.state) {}
+
+      U* allocate(std::size_t n)
+      {
+         return static_cast<U*>(state->blocks.allocate(n * sizeof(U), alignof(U)));
+      }
+
+      void deallocate(U* p, std::size_t n)
+      {
+         state->blocks.deallocate(p, n * sizeof(U), alignof(U));
+      }
+
+      template <typename V>
+      bool operator==(const BlockAllocator<V>& other) const
+      {
+         return state == other.state;
+      }
+
+      std::shared_ptr<State> state;
+   };
+
+   std::shared_ptr<T> wrap(std::unique_ptr<T> frame)
+   {
+      std::shared_ptr<State> state = _state;
+      return std::shared_ptr<T>(frame.release(), [state](T* raw)
+      {
+         std::unique_ptr<T> owned(raw);
+         const std::lock_guard<std::mutex> lock(state->mutex);
+         if (state->free.size() < state->maxPooled)
+         {
+            state->free.push_back(std::move(owned));
+         }
+      }, BlockAllocator<T>(state));
+   }
+
+   std::shared_ptr<State> _state;
+};
+
+} // namespace SdrEngine
+
+#endif // FRAMEPOOL_H_
@@ -2,12 +2,15 @@
 #define ISDRDEVICE_H_
 
 // Project headers
+#include "DeviceStreamStats.h"
 #include "SdrTypes.h"
 
 // System headers
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace SdrEngine
@@ -20,6 +23,12 @@ namespace SdrEngine
  */
 using IqCallback = std::function<void(const IqSample* samples, std::size_t numSamples)>;
 
+/**
+ * @brief Callback invoked by the device with samples in its native format.
+ * The block's data is only valid for the duration of the call.
+ */
+using RawIqCallback = std::function<void(const RawIqBlock& block)>;
+
 /**
  * @class ISdrDevice
  * @brief Abstract interface for a Software Defined Radio device.
@@ -115,6 +124,28 @@ public:
    [[nodiscard]] virtual bool startStreaming(IqCallback callback,
                                             std::size_t bufferSize = 8192) = 0;
 
+   /**
+    * @brief Start asynchronous streaming in the device's native sample format.
+    *
+    * Lets the consumer convert integer samples itself (e.g. straight into
+    * its ring buffer) instead of the driver converting to float first.  The
+    * default forwards startStreaming() blocks as CF32.
+    *
+    * @param callback     Function to receive native-format sample blocks.
+    * @param bufferSize   Requested number of samples per callback invocation.
+    * @return true if streaming started successfully.
+    */
+   [[nodiscard]] virtual bool startRawStreaming(RawIqCallback callback,
+                                               std::size_t bufferSize = 8192)
+   {
+      return startStreaming(
+         [cb = std::move(callback)](const IqSample* samples, std::size_t numSamples)
+         {
+            cb(RawIqBlock{samples, IqSampleFormat::CF32, numSamples, 1.0F});
+         },
+         bufferSize);
+   }
+
    /** @brief Stop asynchronous streaming. */
    virtual void stopStreaming() = 0;
 
@@ -124,6 +155,23 @@ public:
     */
    [[nodiscard]] virtual bool isStreaming() const = 0;
 
+   /**
+    * @brief Get streaming health counters (samples, overflows, timeouts).
+    * Reset when streaming starts.  Devices that do not track them report
+    * all zeros.
+    * @return Snapshot of the stream counters.
+    */
+   [[nodiscard]] virtual DeviceStreamStats getStreamStats() const { return {}; }
+
+   /**
+    * @brief Set the CommonUtils::ThreadConfig role of the streaming thread,
+    *        e.g. to pin each of several devices of one type separately.
+    * Takes effect on the next startStreaming().  Devices without a thread
+    * of their own ignore it.
+    * @param role  Thread role (empty: the device type's default role).
+    */
+   virtual void setStreamThreadRole(std::string role) { std::ignore = role; }
+
    // -- Device info ---------------------------------------------------------
 
    /**
@@ -0,0 +1,529 @@
+// Project headers
+#include "IqRecorder.h"
+#include "DspKernels.h"
+#include "GeneralLogger.h"
+#include "ThreadConfig.h"
+#include "Vita49Codec.h"
+
+// System headers
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <span>
+#include <utility>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Alignment and size granule of the recording buffers (O_DIRECT needs both).
+constexpr std::size_t PAGE_BYTES = CommonUtils::FileSink::ALIGNMENT;
+
+// Samples per VITA 49 signal data packet (well under the 65535-word limit).
+constexpr std::size_t VITA49_SAMPLES_PER_PACKET = 8192;
+
+// Stream identifier of recorded VITA 49 packets.
+constexpr uint32_t VITA49_STREAM_ID = 1;
+
+std::size_t roundUpToPage(std::size_t bytes)
+{
+   return std::max(PAGE_BYTES, ((bytes + PAGE_BYTES - 1) / PAGE_BYTES) * PAGE_BYTES);
+}
+
+std::string utcNowIso8601()
+{
+   const std::time_t now = std::time(nullptr);
+   std::tm utc{};
+   gmtime_r(&now, &utc);
+   std::array<char, 32> text{};
+   std::strftime(text.data(), text.size(), "%Y-%m-%dT%H:%M:%SZ", &utc);
+   return text.data();
+}
+
+} // namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+void IqRecorder::AlignedFree::operator()(std::byte* p) const
+{
+   std::free(p);
+}
+
+IqRecorder::IqRecorder(std::size_t bufferBytes, std::size_t bufferCount)
+   : _bufferBytes{roundUpToPage(bufferBytes)}
+   , _sink(_bufferBytes, std::max<std::size_t>(bufferCount, 2))
+   , _blocks(_sink.bufferCount())
+{
+   _sink.setWriteHandler([this](std::size_t bytes, bool ok) { onWritten(bytes, ok); });
+}
+
+IqRecorder::~IqRecorder()
+{
+   detach();
+   stop();
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+bool IqRecorder::start(const std::string& path, RecordingFormat format, bool directIo,
+                       IqStorage samples)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (_recording)
+   {
+      GPWARN("IqRecorder::start() — already recording to {}", _dataPath);
+      return false;
+   }
+
+   _format      = format;
+   _samples     = (format == RecordingFormat::Vita49) ? IqStorage::Cf32 : samples;
+   _sampleBytes = (_samples == IqStorage::Cs16) ? 2 * sizeof(int16_t) : sizeof(IqSample);
+   _dataPath = (format == RecordingFormat::SigMf) ? path + ".sigmf-data" : path;
+   _metaPath = (format == RecordingFormat::SigMf) ? path + ".sigmf-meta" : std::string{};
+
+   // VITA 49 packets are not page-sized, so they always go through the cache.
+   if (!_sink.open(_dataPath, directIo && format != RecordingFormat::Vita49))
+   {
+      GPERROR("IqRecorder: cannot create {}: {}", _dataPath, std::strerror(errno));
+      _dataPath.clear();
+      _metaPath.clear();
+      return false;
+   }
+
+   // Raw / SigMf blocks are taken from the sink's pool as they are needed.
+   _free.clear();
+   _full.clear();
+   if (_format == RecordingFormat::Vita49)
+   {
+      if (!_staging)
+      {
+         _staging.reset(static_cast<std::byte*>(
+            std::aligned_alloc(PAGE_BYTES, _bufferBytes * _blocks.size())));
+      }
+      for (std::size_t i = 0; i < _blocks.size(); ++i)
+      {
+         _blocks[i].data = _staging.get() + (i * _bufferBytes);
+         _free.push_back(&_blocks[i]);
+      }
+   }
+   for (auto& block : _blocks)
+   {
+      block.usedBytes = 0;
+   }
+   _filling         = nullptr;
+   _captures.clear();
+   _sampleRateHz    = 0.0;
+   _samplesAccepted = 0;
+   _startedUtc      = utcNowIso8601();
+
+   _contextFreqHz      = -1.0;
+   _contextRateHz      = -1.0;
+   _dataPacketCount    = 0;
+   _contextPacketCount = 0;
+
+   _samplesWritten.store(0, std::memory_order_relaxed);
+   _buffersWritten.store(0, std::memory_order_relaxed);
+   _droppedBuffers.store(0, std::memory_order_relaxed);
+   _droppedSamples.store(0, std::memory_order_relaxed);
+   _startTime = std::chrono::steady_clock::now();
+   _stopTime  = _startTime;
+
+   _recording  = true;
+   _stopWriter = false;
+   _writer     = std::thread(&IqRecorder::writerThread, this);
+
+   GPINFO("IqRecorder: recording to {} ({} x {} KiB buffers{}{}{})", _dataPath, _blocks.size(),
+          _bufferBytes / 1024, _sink.usesUring() ? ", io_uring" : "",
+          _sink.directIo() ? ", O_DIRECT" : "", _samples == IqStorage::Cs16 ? ", CS16" : "");
+   return true;
+}
+
+void IqRecorder::stop()
+{
+   {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      if (!_recording)
+      {
+         return;
+      }
+      _recording = false;
+      if (_filling != nullptr)
+      {
+         submitLocked();
+      }
+      _stopWriter = true;
+      _stopTime   = std::chrono::steady_clock::now();
+   }
+   _cv.notify_all();
+   _freeCv.notify_all();
+   if (_writer.joinable())
+   {
+      _writer.join();
+   }
+
+   _sink.close();
+   if (_format == RecordingFormat::SigMf)
+   {
+      writeSigMfMeta();
+   }
+
+   const auto s = stats();
+   GPINFO("IqRecorder: stopped {} — {} samples, {:.1f} MB/s, {} buffers dropped", _dataPath,
+          s.samplesWritten, s.throughputMBps(), s.droppedBuffers);
+}
+
+bool IqRecorder::isRecording() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _recording;
+}
+
+std::string IqRecorder::getDataPath() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _recording ? _dataPath : std::string{};
+}
+
+void IqRecorder::write(const IqBuffer& buffer)
+{
+   std::unique_lock<std::mutex> lock(_mutex);
+   writeLocked(lock, buffer, false);
+}
+
+void IqRecorder::writeWaiting(const IqBuffer& buffer)
+{
+   std::unique_lock<std::mutex> lock(_mutex);
+   writeLocked(lock, buffer, true);
+}
+
+void IqRecorder::writeLocked(std::unique_lock<std::mutex>& lock, const IqBuffer& buffer,
+                             bool waitForWriter)
+{
+   if (!_recording || buffer.samples.empty())
+   {
+      return;
+   }
+
+   if (_sampleRateHz <= 0.0)
+   {
+      _sampleRateHz = buffer.sampleRateHz;
+   }
+   if (_captures.empty() || _captures.back().centerFreqHz != buffer.centerFreqHz)
+   {
+      _captures.push_back(Capture{_samplesAccepted, buffer.centerFreqHz});
+   }
+   // A VITA 49 block carries one context, so a retune closes the block.
+   if (_format == RecordingFormat::Vita49 && _filling != nullptr &&
+       (_filling->centerFreqHz != buffer.centerFreqHz ||
+        _filling->sampleRateHz != buffer.sampleRateHz))
+   {
+      submitLocked();
+   }
+
+   // Buffers are a whole number of pages, so samples never straddle two.
+   const IqSample* src   = buffer.samples.data();
+   std::size_t remaining = buffer.samples.size();
+   while (remaining > 0)
+   {
+      if (_filling == nullptr && waitForWriter)
+      {
+         // Another writer may take the freed block first and start filling it.
+         _freeCv.wait(lock,
+                      [this] { return hasFreeLocked() || _filling != nullptr || !_recording; });
+         if (!_recording)
+         {
+            return;
+         }
+      }
+      if (_filling == nullptr)
+      {
+         _filling = acquireLocked(buffer);
+         if (_filling == nullptr)
+         {
+            _droppedBuffers.fetch_add(1, std::memory_order_relaxed);
+            _droppedSamples.fetch_add(remaining, std::memory_order_relaxed);
+            return;
+         }
+      }
+      const std::size_t count =
+         std::min(remaining, (_bufferBytes - _filling->usedBytes) / _sampleBytes);
+      std::byte* dst = _filling->data + _filling->usedBytes;
+      if (_samples == IqStorage::Cs16)
+      {
+         convertIqToCs16(src, reinterpret_cast<int16_t*>(dst), count, CS16_FULL_SCALE);
+      }
+      else
+      {
+         std::memcpy(dst, src, count * sizeof(IqSample));
+      }
+      _filling->usedBytes += count * _sampleBytes;
+      _samplesAccepted += count;
+      src += count;
+      remaining -= count;
+
+      if (_filling->usedBytes == _bufferBytes)
+      {
+         submitLocked();
+      }
+   }
+}
+
+IqRecorder::Block* IqRecorder::acquireLocked(const IqBuffer& buffer)
+{
+   Block* block = nullptr;
+   if (_format == RecordingFormat::Vita49)
+   {
+      if (_free.empty())
+      {
+         return nullptr;
+      }
+      block = _free.front();
+      _free.pop_front();
+   }
+   else
+   {
+      // Samples are converted straight into the buffer the sink writes from.
+      std::byte* data = _sink.acquire();
+      if (data == nullptr)
+      {
+         return nullptr;
+      }
+      block       = &_blocks[_sink.indexOf(data)];
+      block->data = data;
+   }
+   block->usedBytes    = 0;
+   block->centerFreqHz = buffer.centerFreqHz;
+   block->sampleRateHz = buffer.sampleRateHz;
+   return block;
+}
+
+bool IqRecorder::hasFreeLocked() const
+{
+   return (_format == RecordingFormat::Vita49) ? !_free.empty() : _sink.freeCount() > 0;
+}
+
+void IqRecorder::releaseLocked(Block* block)
+{
+   if (_format == RecordingFormat::Vita49)
+   {
+      _free.push_back(block);
+   }
+   else
+   {
+      _sink.release(block->data);
+   }
+}
+
+void IqRecorder::submitLocked()
+{
+   if (_filling->usedBytes == 0)
+   {
+      releaseLocked(_filling);
+   }
+   else
+   {
+      _full.push_back(_filling);
+      _cv.notify_one();
+   }
+   _filling = nullptr;
+}
+
+// ============================================================================
+// Subscription
+// ============================================================================
+
+void IqRecorder::attach(CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& handler)
+{
+   detach();
+   const std::lock_guard<std::mutex> lock(_subscriptionMutex);
+   _handler    = &handler;
+   _listenerId = handler.registerListener(
+      [this](const std::shared_ptr<const IqBuffer>& buffer)
+      {
+         if (buffer)
+         {
+            write(*buffer);
+         }
+      });
+}
+
+void IqRecorder::detach()
+{
+   const std::lock_guard<std::mutex> lock(_subscriptionMutex);
+   if (_handler != nullptr)
+   {
+      // Waits for a dispatch in progress, so write() is not running after this.
+      _handler->unregisterListener(_listenerId);
+      _handler    = nullptr;
+      _listenerId = -1;
+   }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+IqRecorderStats IqRecorder::stats() const
+{
+   const auto sink = _sink.stats();
+   IqRecorderStats out;
+   out.samplesWritten = _samplesWritten.load(std::memory_order_relaxed);
+   out.bytesWritten   = sink.bytesWritten;
+   out.buffersWritten = _buffersWritten.load(std::memory_order_relaxed);
+   out.droppedBuffers = _droppedBuffers.load(std::memory_order_relaxed);
+   out.droppedSamples = _droppedSamples.load(std::memory_order_relaxed);
+   out.writeErrors    = sink.writeErrors;
+
+   const std::lock_guard<std::mutex> lock(_mutex);
+   const auto end = _recording ? std::chrono::steady_clock::now() : _stopTime;
+   out.elapsedSec = std::chrono::duration<double>(end - _startTime).count();
+   return out;
+}
+
+// ============================================================================
+// Writer thread
+// ============================================================================
+
+void IqRecorder::writerThread()
+{
+   CommonUtils::configureCurrentThread("IqRecorder.writer");
+   std::unique_lock<std::mutex> lock(_mutex);
+   while (true)
+   {
+      _cv.wait(lock, [this] { return _stopWriter || !_full.empty(); });
+      if (_full.empty())
+      {
+         break;   // Stopped and drained.
+      }
+      Block* block = _full.front();
+      _full.pop_front();
+
+      lock.unlock();
+      writeBlock(*block);
+      lock.lock();
+
+      // Raw / SigMf blocks return to the sink's pool once written.
+      if (_format == RecordingFormat::Vita49)
+      {
+         block->usedBytes = 0;
+         _free.push_back(block);
+         _freeCv.notify_all();
+      }
+   }
+}
+
+void IqRecorder::writeBlock(Block& block)
+{
+   if (_format != RecordingFormat::Vita49)
+   {
+      // Counted by onWritten() once on disk.  Only the final block of a
+      // recording can be partial; the sink finishes an O_DIRECT file with
+      // a buffered write for it.
+      _sink.submit(block.data, block.usedBytes);
+      return;
+   }
+   if (writeVita49(block))
+   {
+      _samplesWritten.fetch_add(block.usedBytes / _sampleBytes, std::memory_order_relaxed);
+      _buffersWritten.fetch_add(1, std::memory_order_relaxed);
+   }
+}
+
+void IqRecorder::onWritten(std::size_t bytes, bool ok)
+{
+   // _format and _sampleBytes are only changed while the sink is closed.
+   if (_format == RecordingFormat::Vita49)
+   {
+      return;
+   }
+   if (ok)
+   {
+      _samplesWritten.fetch_add(bytes / _sampleBytes, std::memory_order_relaxed);
+      _buffersWritten.fetch_add(1, std::memory_order_relaxed);
+   }
+   {
+      // Orders the wake-up after a writeWaiting() predicate check.
+      const std::lock_guard<std::mutex> lock(_mutex);
+   }
+   _freeCv.notify_all();
+}
+
+bool IqRecorder::writeVita49(const Block& block)
+{
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+
+   if (block.centerFreqHz != _contextFreqHz || block.sampleRateHz != _contextRateHz)
+   {
+      Vita49_2::ContextFields context;
+      context.rfFrequency = block.centerFreqHz;
+      context.sampleRate  = block.sampleRateHz;
+      const auto bytes = codec.encodeContext(VITA49_STREAM_ID, context, _contextPacketCount);
+      _contextPacketCount = static_cast<uint8_t>((_contextPacketCount + 1) & 0xFU);
+      if (!_sink.append(bytes.data(), bytes.size()))
+      {
+         return false;
+      }
+      _contextFreqHz = block.centerFreqHz;
+      _contextRateHz = block.sampleRateHz;
+   }
+
+   // Packetize the whole block into one reused buffer; the sink packs it
+   // into its own buffers and writes them in the background
+   Vita49_2::SignalDataStream stream;
+   stream.streamId            = VITA49_STREAM_ID;
+   stream.packetCount         = _dataPacketCount;
+   stream.maxSamplesPerPacket = VITA49_SAMPLES_PER_PACKET;
+   const std::span<const IqSample> samples(reinterpret_cast<const IqSample*>(block.data),
+                                           block.usedBytes / sizeof(IqSample));
+   _packetBytes.clear();
+   codec.packetizeSignalData(stream, samples, _packetBytes);
+   _dataPacketCount = stream.packetCount;
+   return _sink.append(_packetBytes.data(), _packetBytes.size());
+}
+
+void IqRecorder::writeSigMfMeta() const
+{
+   std::ofstream meta(_metaPath, std::ios::trunc);
+   if (!meta)
+   {
+      GPWARN("IqRecorder: cannot create SigMF metadata {}", _metaPath);
+      return;
+   }
+   meta << std::setprecision(15);
+   meta << "{\n"
+        << "  \"global\": {\n"
+        << "    \"core:datatype\": \""
+        << (_samples == IqStorage::Cs16 ? "ci16_le" : "cf32_le") << "\",\n"
+        << "    \"core:sample_rate\": " << _sampleRateHz << ",\n"
+        << "    \"core:version\": \"1.0.0\",\n"
+        << "    \"core:recorder\": \"RadioWizard\"\n"
+        << "  },\n"
+        << "  \"captures\": [";
+   for (std::size_t i = 0; i < _captures.size(); ++i)
+   {
+      meta << (i == 0 ? "\n" : ",\n")
+           << "    {\"core:sample_start\": " << _captures[i].sampleStart
+           << ", \"core:frequency\": " << _captures[i].centerFreqHz;
+      if (i == 0)
+      {
+         meta << ", \"core:datetime\": \"" << _startedUtc << "\"";
+      }
+      meta << "}";
+   }
+   meta << "\n  ],\n"
+        << "  \"annotations\": []\n"
+        << "}\n";
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,276 @@
+#ifndef IQRECORDER_H_
+#define IQRECORDER_H_
+
+// Project headers
+#include "DataHandler.h"
+#include "FileSink.h"
+#include "SdrTypes.h"
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @brief File layout written by IqRecorder.
+ */
+enum class RecordingFormat : uint8_t
+{
+   Raw,     ///< Interleaved CF32 (or CS16) samples, nothing else.
+   SigMf,   ///< `<path>.sigmf-data` (CF32 or CS16) plus a `<path>.sigmf-meta` JSON sidecar.
+   Vita49   ///< Big-endian VITA 49.2 context and signal data packets.
+};
+
+/**
+ * @class IqRecorderStats
+ * @brief Snapshot of an IqRecorder's progress since start().
+ */
+struct IqRecorderStats
+{
+   uint64_t samplesWritten{0};   ///< Complex samples on disk.
+   uint64_t bytesWritten{0};     ///< File bytes written (including VITA 49 framing).
+   uint64_t buffersWritten{0};   ///< Recording buffers flushed to disk.
+   uint64_t droppedBuffers{0};   ///< Incoming IqBuffers that lost samples (writer behind).
+   uint64_t droppedSamples{0};   ///< Complex samples lost to those drops.
+   uint64_t writeErrors{0};      ///< Failed buffer writes (their samples are lost).
+   double elapsedSec{0.0};       ///< Time since start() (until stop()).
+
+   /**
+    * @brief Get the average disk throughput.
+    * @return Megabytes (10^6 bytes) written per second.
+    */
+   [[nodiscard]] double throughputMBps() const
+   {
+      return (elapsedSec <= 0.0) ? 0.0 : static_cast<double>(bytesWritten) / elapsedSec / 1.0e6;
+   }
+};
+
+/**
+ * @class IqRecorder
+ * @brief Records an IqBuffer stream to disk at full rate on its own thread.
+ *
+ * write() (or a DataHandler listener installed by attach()) copies samples
+ * into a set of large, page-aligned buffers; a dedicated writer thread
+ * hands full buffers to a CommonUtils::FileSink, which keeps several
+ * writes in flight through io_uring, optionally with O_DIRECT so
+ * multi-MS/s recordings do not fill the page cache.  Raw and SigMF samples
+ * are converted straight into the sink's registered buffers and written
+ * from there; VITA 49 blocks are packetized by the writer thread and
+ * appended.  The producer never waits for the disk: when every buffer is
+ * queued or in flight, incoming samples are dropped and counted instead.
+ *
+ * The sample rate and centre frequency are taken from the stream.  SigMF
+ * recordings start a new capture segment on every retune; VITA 49
+ * recordings write a context packet before the first block and after every
+ * change.
+ *
+ * Thread-safety: all methods may be called from any thread.  write()
+ * holds an internal mutex only while copying into the filling buffer.
+ */
+class IqRecorder
+{
+public:
+   /** @brief Default size of each recording buffer. */
+   static constexpr std::size_t DEFAULT_BUFFER_BYTES = std::size_t{4} << 20;
+
+   /** @brief Default number of recording buffers. */
+   static constexpr std::size_t DEFAULT_BUFFER_COUNT = 4;
+
+   /**
+    * @brief Construct an idle recorder.  Raw / SigMF recordings use the
+    * FileSink's buffers; a VITA 49 recording allocates as many staging
+    * buffers again the first time.
+    * @param bufferBytes  Size of each buffer; rounded up to a whole page.
+    * @param bufferCount  Number of buffers (at least 2: one filling, one writing).
+    */
+   explicit IqRecorder(std::size_t bufferBytes = DEFAULT_BUFFER_BYTES,
+                       std::size_t bufferCount = DEFAULT_BUFFER_COUNT);
+
+   /** @brief Stop recording (flushing what is buffered) and detach. */
+   ~IqRecorder();
+
+   // Non-copyable, non-movable (owns a writer thread).
+   IqRecorder(const IqRecorder&) = delete;
+   IqRecorder& operator=(const IqRecorder&) = delete;
+   IqRecorder(IqRecorder&&) = delete;
+   IqRecorder& operator=(IqRecorder&&) = delete;
+
+   // -- Recording -----------------------------------------------------------
+
+   /**
+    * @brief Create the output file(s) and start the writer thread.
+    * @param path       Output file; for SigMf the base name of the data / meta pair.
+    * @param format     File layout.
+    * @param directIo   Bypass the page cache with O_DIRECT (Raw / SigMf only).
+    *                   Falls back to buffered writes where unsupported.
+    * @param samples    Cs16 writes int16 at CS16_FULL_SCALE (SigMF `ci16_le`),
+    *                   halving the file and buffer size (Raw / SigMf only).
+    * @return true on success, false if already recording or the file cannot be created.
+    */
+   [[nodiscard]] bool start(const std::string& path, RecordingFormat format,
+                            bool directIo = false, IqStorage samples = IqStorage::Cf32);
+
+   /** @brief Flush buffered samples, close the file(s) and write the SigMF sidecar. */
+   void stop();
+
+   /**
+    * @brief Check if a recording is in progress.
+    * @return true between start() and stop().
+    */
+   [[nodiscard]] bool isRecording() const;
+
+   /**
+    * @brief Path of the file receiving samples.
+    * @return Data file path, or empty while idle.
+    */
+   [[nodiscard]] std::string getDataPath() const;
+
+   /**
+    * @brief Record one block.  Ignored while idle.  Never blocks on the disk.
+    * @param buffer  Samples and their rate / frequency.
+    */
+   void write(const IqBuffer& buffer);
+
+   /**
+    * @brief Record one block, waiting for the writer thread instead of
+    * dropping when every buffer is queued.  For stored samples that must
+    * reach the file whole (e.g. SdrEngine snapshots), not for live streams.
+    * Returns early, dropping the rest, if the recording is stopped.
+    * @param buffer  Samples and their rate / frequency.
+    */
+   void writeWaiting(const IqBuffer& buffer);
+
+   // -- Subscription --------------------------------------------------------
+
+   /**
+    * @brief Record every IqBuffer published by a handler (e.g.
+    * SdrEngine::iqDataHandler() or a VFO's channel).  Replaces any previous
+    * subscription.  The handler must outlive the subscription.
+    * @param handler  Stream to record.
+    */
+   void attach(CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& handler);
+
+   /** @brief Remove the subscription installed by attach(). */
+   void detach();
+
+   // -- Statistics ----------------------------------------------------------
+
+   /**
+    * @brief Get the progress of the current (or last) recording.
+    * @return Counters since start().
+    */
+   [[nodiscard]] IqRecorderStats stats() const;
+
+private:
+   // Page-aligned staging storage.
+   struct AlignedFree
+   {
+      void operator()(std::byte* p) const;
+   };
+
+   // A recording buffer and the stream metadata of its samples: a sink
+   // buffer (Raw / SigMf) or one of _staging (Vita49).
+   struct Block
+   {
+      std::byte* data{nullptr};
+      std::size_t usedBytes{0};
+      double centerFreqHz{0.0};
+      double sampleRateHz{0.0};
+   };
+
+   // SigMF capture segment: a retune at a sample index.
+   struct Capture
+   {
+      uint64_t sampleStart{0};
+      double centerFreqHz{0.0};
+   };
+
+   // Take a free block for filling, stamped with the stream metadata
+   // (nullptr if the writer holds them all).
+   [[nodiscard]] Block* acquireLocked(const IqBuffer& buffer);
+
+   // Check if acquireLocked() would find a block.
+   [[nodiscard]] bool hasFreeLocked() const;
+
+   // Give back an unused block.
+   void releaseLocked(Block* block);
+
+   // write() / writeWaiting() with _mutex held.
+   void writeLocked(std::unique_lock<std::mutex>& lock, const IqBuffer& buffer,
+                    bool waitForWriter);
+
+   // Queue the filling block for the writer.
+   void submitLocked();
+
+   // Writer thread body.
+   void writerThread();
+
+   // Hand one block to the sink in the recording's format.
+   void writeBlock(Block& block);
+   [[nodiscard]] bool writeVita49(const Block& block);
+
+   // Sink completion: count written samples, wake writeWaiting().
+   void onWritten(std::size_t bytes, bool ok);
+
+   // Emit `<base>.sigmf-meta`.
+   void writeSigMfMeta() const;
+
+   const std::size_t _bufferBytes;
+   CommonUtils::FileSink _sink;
+   std::vector<Block> _blocks;
+   std::unique_ptr<std::byte[], AlignedFree> _staging;   // Vita49 blocks, on first use.
+
+   // Recording state, guarded by _mutex.
+   mutable std::mutex _mutex;
+   std::condition_variable _cv;
+   std::condition_variable _freeCv;   // A block went back to _free.
+   bool _recording{false};
+   bool _stopWriter{false};
+   RecordingFormat _format{RecordingFormat::Raw};
+   IqStorage _samples{IqStorage::Cf32};
+   std::size_t _sampleBytes{sizeof(IqSample)};   // Per sample on disk.
+   std::string _dataPath;
+   std::string _metaPath;
+   Block* _filling{nullptr};
+   std::deque<Block*> _free;          // Vita49 only; otherwise the sink's pool.
+   std::deque<Block*> _full;
+   std::vector<Capture> _captures;
+   double _sampleRateHz{0.0};
+   uint64_t _samplesAccepted{0};
+   std::string _startedUtc;   // ISO 8601, for the SigMF capture datetime.
+
+   std::thread _writer;
+
+   // Writer-thread state (VITA 49 framing).
+   std::vector<uint8_t> _packetBytes;
+   double _contextFreqHz{-1.0};
+   double _contextRateHz{-1.0};
+   uint8_t _dataPacketCount{0};
+   uint8_t _contextPacketCount{0};
+
+   std::atomic<uint64_t> _samplesWritten{0};
+   std::atomic<uint64_t> _buffersWritten{0};
+   std::atomic<uint64_t> _droppedBuffers{0};
+   std::atomic<uint64_t> _droppedSamples{0};
+   std::chrono::steady_clock::time_point _startTime;   // Guarded by _mutex.
+   std::chrono::steady_clock::time_point _stopTime;    // Guarded by _mutex.
+
+   std::mutex _subscriptionMutex;
+   CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>* _handler{nullptr};
+   int _listenerId{-1};
+};
+
+} // namespace SdrEngine
+
+#endif // IQRECORDER_H_
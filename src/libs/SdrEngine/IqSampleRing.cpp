@@ -0,0 +1,260 @@
+// Project headers
+#include "IqSampleRing.h"
+#include "DspKernels.h"
+
+// System headers
+#include <algorithm>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Construction / reset
+// ============================================================================
+
+IqSampleRing::IqSampleRing(std::size_t minCapacity, IqStorage storage)
+{
+   reset(minCapacity, storage);
+}
+
+void IqSampleRing::reset(std::size_t minCapacity, IqStorage storage)
+{
+   _storage = storage;
+   _ring.reset(storage == IqStorage::Cf32 ? minCapacity : 0);
+   _values.reset(storage == IqStorage::Cs16 ? 2 * minCapacity : 0);
+   _cs16FullScale.store(CS16_FULL_SCALE, std::memory_order_relaxed);
+   _overflowSamples.store(0, std::memory_order_relaxed);
+   _interrupted.store(false, std::memory_order_relaxed);
+   for (auto& mark : _arrivals)
+   {
+      mark.endPos.store(ArrivalMark::INVALID, std::memory_order_relaxed);
+   }
+   _nextArrival = 0;
+   _dataSignal.fetch_add(1, std::memory_order_release);
+}
+
+// ============================================================================
+// State queries
+// ============================================================================
+
+std::size_t IqSampleRing::capacity() const
+{
+   return (_storage == IqStorage::Cf32) ? _ring.capacity() : _values.capacity() / 2;
+}
+
+std::size_t IqSampleRing::available() const
+{
+   return (_storage == IqStorage::Cf32) ? _ring.available() : _values.available() / 2;
+}
+
+std::size_t IqSampleRing::freeSpace() const
+{
+   return (_storage == IqStorage::Cf32) ? _ring.freeSpace() : _values.freeSpace() / 2;
+}
+
+std::size_t IqSampleRing::writeCount() const
+{
+   return (_storage == IqStorage::Cf32) ? _ring.writeCount() : _values.writeCount() / 2;
+}
+
+std::size_t IqSampleRing::readCount() const
+{
+   return (_storage == IqStorage::Cf32) ? _ring.readCount() : _values.readCount() / 2;
+}
+
+uint64_t IqSampleRing::overflowCount() const
+{
+   return _overflowSamples.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+IqSampleRing::WriteRegions IqSampleRing::prepareWrite(std::size_t count)
+{
+   return _ring.prepareWrite(count);
+}
+
+IqSampleRing::Cs16WriteRegions IqSampleRing::prepareWriteCs16(std::size_t count)
+{
+   return _values.prepareWrite(2 * count);
+}
+
+void IqSampleRing::setCs16FullScale(float fullScale)
+{
+   _cs16FullScale.store(fullScale, std::memory_order_relaxed);
+}
+
+void IqSampleRing::commitWrite(std::size_t count)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   if (_storage == IqStorage::Cf32)
+   {
+      _ring.commitWrite(count);
+   }
+   else
+   {
+      _values.commitWrite(2 * count);
+   }
+   _dataSignal.fetch_add(1, std::memory_order_release);
+   _dataSignal.notify_one();
+}
+
+void IqSampleRing::commitWrite(std::size_t count, std::chrono::steady_clock::time_point arrived)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   // Stamp before publishing, so the consumer always finds a mark for the
+   // samples it can see.
+   const std::size_t endPos = writeCount() + count;
+   auto& mark = _arrivals[_nextArrival++ % ARRIVAL_MARKS];
+   mark.endPos.store(ArrivalMark::INVALID, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_release);
+   mark.arrivalNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           arrived.time_since_epoch()).count(),
+                        std::memory_order_relaxed);
+   mark.endPos.store(endPos, std::memory_order_release);
+   commitWrite(count);
+}
+
+void IqSampleRing::recordOverflow(std::size_t droppedSamples)
+{
+   _overflowSamples.fetch_add(droppedSamples, std::memory_order_relaxed);
+}
+
+std::size_t IqSampleRing::write(const IqSample* samples, std::size_t count)
+{
+   std::size_t written = 0;
+   if (_storage == IqStorage::Cf32)
+   {
+      const auto regions = prepareWrite(count);
+      std::copy_n(samples, regions.first.size(), regions.first.begin());
+      std::copy_n(samples + regions.first.size(), regions.second.size(),
+                  regions.second.begin());
+      written = regions.size();
+   }
+   else
+   {
+      const auto regions = prepareWriteCs16(count);
+      const float scale  = cs16FullScale();
+      const std::size_t head = regions.first.size() / 2;
+      convertIqToCs16(samples, regions.first.data(), head, scale);
+      convertIqToCs16(samples + head, regions.second.data(), regions.second.size() / 2, scale);
+      written = regions.size() / 2;
+   }
+   commitWrite(written);
+   if (written < count)
+   {
+      recordOverflow(count - written);
+   }
+   return written;
+}
+
+// ============================================================================
+// Consumer side
+// ============================================================================
+
+bool IqSampleRing::waitForSamples(std::size_t count)
+{
+   count = std::min(count, capacity());
+   for (;;)
+   {
+      // Sample the signal before checking state so a commit that lands
+      // between the check and the wait still wakes us.
+      const uint32_t signal = _dataSignal.load(std::memory_order_acquire);
+      if (_interrupted.load(std::memory_order_acquire))
+      {
+         return false;
+      }
+      if (available() >= count)
+      {
+         return true;
+      }
+      _dataSignal.wait(signal, std::memory_order_acquire);
+   }
+}
+
+void IqSampleRing::interrupt()
+{
+   _interrupted.store(true, std::memory_order_release);
+   _dataSignal.fetch_add(1, std::memory_order_release);
+   _dataSignal.notify_all();
+}
+
+IqSampleRing::ReadRegions IqSampleRing::peek(std::size_t count) const
+{
+   return _ring.peek(count);
+}
+
+IqSampleRing::Cs16ReadRegions IqSampleRing::peekCs16(std::size_t count) const
+{
+   return _values.peek(2 * count);
+}
+
+float IqSampleRing::cs16FullScale() const
+{
+   return _cs16FullScale.load(std::memory_order_relaxed);
+}
+
+void IqSampleRing::consume(std::size_t count)
+{
+   if (_storage == IqStorage::Cf32)
+   {
+      _ring.consume(count);
+   }
+   else
+   {
+      _values.consume(2 * count);
+   }
+}
+
+std::size_t IqSampleRing::read(IqSample* dest, std::size_t count)
+{
+   if (_storage == IqStorage::Cf32)
+   {
+      return _ring.read(dest, count);
+   }
+   const auto regions = peekCs16(count);
+   const float scale  = 1.0F / cs16FullScale();
+   const std::size_t head = regions.first.size() / 2;
+   convertCs16ToIq(regions.first.data(), dest, head, scale);
+   convertCs16ToIq(regions.second.data(), dest + head, regions.second.size() / 2, scale);
+   consume(regions.size() / 2);
+   return regions.size() / 2;
+}
+
+std::chrono::steady_clock::time_point IqSampleRing::lastReadArrival() const
+{
+   // The newest consumed sample is at readPos - 1; it arrived with the
+   // earliest stamped commit that ends at or after readPos.
+   const std::size_t readPos = readCount();
+   std::size_t bestEnd = ArrivalMark::INVALID;
+   int64_t bestNs      = 0;
+   for (const auto& mark : _arrivals)
+   {
+      const std::size_t endPos = mark.endPos.load(std::memory_order_acquire);
+      const int64_t ns         = mark.arrivalNs.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (endPos == ArrivalMark::INVALID || endPos < readPos || endPos >= bestEnd ||
+          mark.endPos.load(std::memory_order_relaxed) != endPos)
+      {
+         continue;   // Unused, already consumed, not the earliest, or being rewritten.
+      }
+      bestEnd = endPos;
+      bestNs  = ns;
+   }
+   if (bestEnd == ArrivalMark::INVALID)
+   {
+      return {};
+   }
+   using Clock = std::chrono::steady_clock;
+   return Clock::time_point{std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds{bestNs})};
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,218 @@
+#ifndef IQSAMPLERING_H_
+#define IQSAMPLERING_H_
+
+// Project headers
+#include "SdrTypes.h"
+#include "SpscRingBuffer.h"
+
+// System headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace SdrEngine
+{
+
+/**
+ * @class IqSampleRing
+ * @brief Preallocated, lock-free single-producer / single-consumer ring of
+ *        I/Q samples.
+ *
+ * Sits between the device stream thread (producer) and the SdrEngine
+ * processing thread (consumer).  The samples live in a
+ * CommonUtils::SpscRingBuffer: the producer reserves contiguous regions,
+ * writes into them directly, then commits; the consumer peeks contiguous
+ * regions and releases them once copied.  Neither side takes a lock or
+ * allocates after `reset()`.  This class adds blocking waits, overflow
+ * counting and arrival stamps.
+ *
+ * When the ring is full the producer's excess samples are dropped and
+ * counted in `overflowCount()` — the device is never blocked.
+ *
+ * The producer may stamp each commit with its arrival time; the consumer
+ * then asks when the newest sample it consumed arrived (latency tracing).
+ *
+ * With IqStorage::Cs16 the ring holds interleaved int16 instead (half the
+ * memory and bandwidth).  The producer fills prepareWriteCs16() regions and
+ * announces their full scale; read() converts to IqSample, or the consumer
+ * peeks the int16 regions with peekCs16() and converts them itself, e.g.
+ * fused with DC blocking.  The float-only calls (prepareWrite(), peek())
+ * return empty regions in Cs16 mode and vice versa; write(), read(),
+ * consume() and the counters work in both.
+ *
+ * Thread-safety: exactly one producer thread and one consumer thread may
+ * operate concurrently.  `reset()` must only be called while neither is
+ * active.
+ */
+class IqSampleRing
+{
+public:
+   using WriteRegions = CommonUtils::SpscRingBuffer<IqSample>::WriteRegions;
+   using ReadRegions  = CommonUtils::SpscRingBuffer<IqSample>::ReadRegions;
+   using Cs16WriteRegions = CommonUtils::SpscRingBuffer<int16_t>::WriteRegions;
+   using Cs16ReadRegions  = CommonUtils::SpscRingBuffer<int16_t>::ReadRegions;
+
+   /**
+    * @brief Construct a ring holding at least `minCapacity` samples.
+    * The capacity is rounded up to the next power of two.  A capacity of
+    * zero leaves the ring unallocated until `reset()` is called.
+    */
+   explicit IqSampleRing(std::size_t minCapacity = 0, IqStorage storage = IqStorage::Cf32);
+
+   // Non-copyable, non-movable (atomics are shared between threads).
+   IqSampleRing(const IqSampleRing&) = delete;
+   IqSampleRing& operator=(const IqSampleRing&) = delete;
+   IqSampleRing(IqSampleRing&&) = delete;
+   IqSampleRing& operator=(IqSampleRing&&) = delete;
+   ~IqSampleRing() = default;
+
+   /**
+    * @brief Reallocate (if needed), empty the ring and clear all counters.
+    * Not thread-safe — call only while no producer or consumer is running.
+    * The storage not selected is released.
+    * @param minCapacity  Minimum number of samples the ring must hold.
+    * @param storage      Sample format in memory.
+    */
+   void reset(std::size_t minCapacity, IqStorage storage = IqStorage::Cf32);
+
+   /** @brief Sample format in memory. */
+   [[nodiscard]] IqStorage storage() const { return _storage; }
+
+   /** @brief Storage capacity in samples (always a power of two, or zero). */
+   [[nodiscard]] std::size_t capacity() const;
+
+   /** @brief Number of samples ready to be read. */
+   [[nodiscard]] std::size_t available() const;
+
+   /** @brief Number of samples that can be written without dropping. */
+   [[nodiscard]] std::size_t freeSpace() const;
+
+   /** @brief Total samples dropped because the ring was full. */
+   [[nodiscard]] uint64_t overflowCount() const;
+
+   // -- Producer side -------------------------------------------------------
+
+   /**
+    * @brief Reserve space for up to `count` samples.
+    * The returned regions may be shorter than requested if the ring is
+    * nearly full.  Follow with `commitWrite()`.  Cf32 storage only.
+    */
+   [[nodiscard]] WriteRegions prepareWrite(std::size_t count);
+
+   /**
+    * @brief Reserve space for up to `count` samples as interleaved int16
+    * (two values per sample; regions never split a sample).  Follow with
+    * `commitWrite()` in samples.  Cs16 storage only.
+    */
+   [[nodiscard]] Cs16WriteRegions prepareWriteCs16(std::size_t count);
+
+   /**
+    * @brief Set the int16 value that maps to 1.0 (default CS16_FULL_SCALE).
+    * It applies to every sample read afterwards, including those already
+    * queued, so it is meant to follow the device's fixed native scale.
+    * Cs16 storage only.
+    */
+   void setCs16FullScale(float fullScale);
+
+   /** @brief Publish `count` samples previously written via prepareWrite(). */
+   void commitWrite(std::size_t count);
+
+   /**
+    * @brief Publish `count` samples and remember that they arrived at `arrived`.
+    * The last ARRIVAL_MARKS stamped commits are kept for lastReadArrival().
+    */
+   void commitWrite(std::size_t count, std::chrono::steady_clock::time_point arrived);
+
+   /** @brief Record samples the producer had to discard. */
+   void recordOverflow(std::size_t droppedSamples);
+
+   /**
+    * @brief Copy `count` samples into the ring, dropping what does not fit.
+    * Cs16 storage converts them at CS16_FULL_SCALE (set with setCs16FullScale()).
+    * @return Number of samples actually written.
+    */
+   std::size_t write(const IqSample* samples, std::size_t count);
+
+   // -- Consumer side -------------------------------------------------------
+
+   /**
+    * @brief Block until at least `count` samples are readable.
+    * @return false if `interrupt()` was called before enough data arrived.
+    */
+   [[nodiscard]] bool waitForSamples(std::size_t count);
+
+   /** @brief Wake a consumer blocked in waitForSamples() and make it return false. */
+   void interrupt();
+
+   /**
+    * @brief View up to `count` readable samples without consuming them.
+    * Follow with `consume()` once the data has been used.  Cf32 storage only.
+    */
+   [[nodiscard]] ReadRegions peek(std::size_t count) const;
+
+   /**
+    * @brief View up to `count` readable samples as interleaved int16 (two
+    * values per sample) without consuming them.  Scale by
+    * `1 / cs16FullScale()`.  Cs16 storage only.
+    */
+   [[nodiscard]] Cs16ReadRegions peekCs16(std::size_t count) const;
+
+   /** @brief Full scale of the int16 samples (see setCs16FullScale()). */
+   [[nodiscard]] float cs16FullScale() const;
+
+   /** @brief Release `count` samples previously returned by peek(). */
+   void consume(std::size_t count);
+
+   /**
+    * @brief Copy up to `count` samples out of the ring and consume them.
+    * Cs16 storage converts them with convertCs16ToIq().
+    * @return Number of samples actually read.
+    */
+   std::size_t read(IqSample* dest, std::size_t count);
+
+   /**
+    * @brief Get the arrival time of the most recently consumed sample.
+    * If the backlog spans more than ARRIVAL_MARKS stamped commits, the
+    * oldest surviving stamp is returned (an underestimate of the age).
+    * @return Arrival stamp, or a default time_point if none covers it.
+    */
+   [[nodiscard]] std::chrono::steady_clock::time_point lastReadArrival() const;
+
+   /** @brief Stamped commits remembered for lastReadArrival(). */
+   static constexpr std::size_t ARRIVAL_MARKS = 64;
+
+private:
+   static constexpr std::size_t CACHE_LINE = 64;
+
+   // One stamped commit: every sample before `endPos` had arrived by
+   // `arrivalNs`.  `endPos` is invalidated while the slot is rewritten.
+   struct ArrivalMark
+   {
+      static constexpr std::size_t INVALID = ~std::size_t{0};
+      std::atomic<std::size_t> endPos{INVALID};
+      std::atomic<int64_t> arrivalNs{0};
+   };
+
+   // Positions in samples, whichever buffer holds them.
+   [[nodiscard]] std::size_t writeCount() const;
+   [[nodiscard]] std::size_t readCount() const;
+
+   IqStorage _storage{IqStorage::Cf32};
+   CommonUtils::SpscRingBuffer<IqSample> _ring;   // Cf32 storage.
+   CommonUtils::SpscRingBuffer<int16_t> _values;  // Cs16 storage (2 per sample).
+   std::atomic<float> _cs16FullScale{CS16_FULL_SCALE};
+
+   // Bumped on every commit / interrupt so the consumer can futex-wait.
+   alignas(CACHE_LINE) std::atomic<uint32_t> _dataSignal{0};
+   std::atomic<bool> _interrupted{false};
+   std::atomic<uint64_t> _overflowSamples{0};
+
+   std::array<ArrivalMark, ARRIVAL_MARKS> _arrivals{};
+   std::size_t _nextArrival{0};   // Producer only.
+};
+
+} // namespace SdrEngine
+
+#endif // IQSAMPLERING_H_
@@ -0,0 +1,154 @@
+// Project headers
+#include "IqSnapshotRing.h"
+#include "DspKernels.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SdrEngine
+{
+
+void IqSnapshotRing::reset(std::size_t capacity, SnapshotStorage storage)
+{
+   _capacity = capacity;
+   _storage  = storage;
+   if (storage == SnapshotStorage::Cf32)
+   {
+      _values = {};
+      _samples.resize(capacity);
+      _samples.shrink_to_fit();
+   }
+   else
+   {
+      _samples = {};
+      _values.resize(2 * capacity);
+      _values.shrink_to_fit();
+   }
+   _written.store(0, std::memory_order_relaxed);
+   _claimed.store(0, std::memory_order_relaxed);
+   _lastArrivalNs.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Producer
+// ============================================================================
+
+void IqSnapshotRing::write(const IqSample* samples, std::size_t count,
+                           std::chrono::steady_clock::time_point arrived)
+{
+   if (_capacity == 0 || count == 0)
+   {
+      return;
+   }
+   const uint64_t start = _written.load(std::memory_order_relaxed);
+   const uint64_t end   = start + count;
+
+   // Only the newest `capacity` samples of a huge block survive anyway.
+   const std::size_t skip = (count > _capacity) ? count - _capacity : 0;
+   samples += skip;
+   count -= skip;
+
+   // Claim before overwriting, so a reader copying the old samples sees it.
+   _claimed.store(end, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_release);
+
+   const auto slot         = static_cast<std::size_t>((start + skip) % _capacity);
+   const std::size_t first = std::min(count, _capacity - slot);
+   copyIn(slot, samples, first);
+   copyIn(0, samples + first, count - first);
+
+   _lastArrivalNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           arrived.time_since_epoch()).count(),
+                        std::memory_order_relaxed);
+   _written.store(end, std::memory_order_release);
+}
+
+void IqSnapshotRing::copyIn(std::size_t slot, const IqSample* src, std::size_t count)
+{
+   if (count == 0)
+   {
+      return;
+   }
+   if (_storage == SnapshotStorage::Cf32)
+   {
+      std::memcpy(_samples.data() + slot, src, count * sizeof(IqSample));
+   }
+   else
+   {
+      convertIqToCs16(src, _values.data() + (2 * slot), count, CS16_FULL_SCALE);
+   }
+}
+
+// ============================================================================
+// Readers
+// ============================================================================
+
+uint64_t IqSnapshotRing::written() const
+{
+   return _written.load(std::memory_order_acquire);
+}
+
+uint64_t IqSnapshotRing::oldest() const
+{
+   const uint64_t end = _claimed.load(std::memory_order_acquire);
+   return (end > _capacity) ? end - _capacity : 0;
+}
+
+uint64_t IqSnapshotRing::sampleAt(std::chrono::steady_clock::time_point when,
+                                  double sampleRateHz) const
+{
+   const uint64_t newest = written();
+   const std::chrono::steady_clock::time_point arrived{
+      std::chrono::nanoseconds{_lastArrivalNs.load(std::memory_order_relaxed)}};
+   const double backSec = std::chrono::duration<double>(arrived - when).count();
+   const double index   = static_cast<double>(newest) - (backSec * sampleRateHz);
+   const auto low       = static_cast<double>(oldest());
+   return static_cast<uint64_t>(std::llround(std::clamp(index, low, static_cast<double>(newest))));
+}
+
+std::size_t IqSnapshotRing::read(uint64_t first, IqSample* dst, std::size_t count) const
+{
+   if (_capacity == 0 || count == 0)
+   {
+      return count;
+   }
+
+   // Skip what is already gone, copy the rest, then drop whatever the
+   // producer claimed while the copy ran.
+   std::size_t lost = static_cast<std::size_t>(
+      std::min<uint64_t>(count, (oldest() > first) ? oldest() - first : 0));
+   const uint64_t from     = first + lost;
+   const std::size_t n     = count - lost;
+   const auto slot         = static_cast<std::size_t>(from % _capacity);
+   const std::size_t part  = std::min(n, _capacity - slot);
+   copyOut(slot, dst + lost, part);
+   copyOut(0, dst + lost + part, n - part);
+
+   std::atomic_thread_fence(std::memory_order_acquire);
+   const uint64_t floor = oldest();
+   if (floor > from)
+   {
+      lost = static_cast<std::size_t>(std::min<uint64_t>(count, floor - first));
+   }
+   return lost;
+}
+
+void IqSnapshotRing::copyOut(std::size_t slot, IqSample* dst, std::size_t count) const
+{
+   if (count == 0)
+   {
+      return;
+   }
+   if (_storage == SnapshotStorage::Cf32)
+   {
+      std::memcpy(dst, _samples.data() + slot, count * sizeof(IqSample));
+   }
+   else
+   {
+      convertCs16ToIq(_values.data() + (2 * slot), dst, count, 1.0F / CS16_FULL_SCALE);
+   }
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,123 @@
+#ifndef IQSNAPSHOTRING_H_
+#define IQSNAPSHOTRING_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/** @brief Sample storage of an IqSnapshotRing (Cs16 at CS16_FULL_SCALE). */
+using SnapshotStorage = IqStorage;
+
+/**
+ * @class IqSnapshotRing
+ * @brief Large overwrite-oldest history of the I/Q stream, read back by
+ *        absolute sample index.
+ *
+ * One producer appends every captured block with at most two bulk copies
+ * (or two convertIqToCs16() passes for Cs16 storage) and never waits.
+ * Samples are numbered from the last reset(); the ring holds the newest
+ * `capacity()` of them, so a reader can copy out a window that started
+ * long before it asked (pre-trigger capture).
+ *
+ * Readers run concurrently with the producer, which may be overwriting
+ * the oldest samples while they are copied.  Positions work like a
+ * seqlock: the producer claims the region it is about to overwrite before
+ * copying, and read() checks the claim after its copy, reporting any
+ * samples that were overwritten meanwhile instead of returning them.
+ *
+ * The producer also stamps each append with its time, so readers can turn
+ * a trigger time into a sample index (sampleAt()).
+ *
+ * Thread-safety: one producer thread calls write(); any number of threads
+ * call the read side.  reset() only while neither runs.
+ */
+class IqSnapshotRing
+{
+public:
+   /**
+    * @brief Reallocate (if needed) and empty the ring.
+    * Not thread-safe — call only while no producer or reader is running.
+    * @param capacity  Samples held; 0 releases the storage.
+    * @param storage   Sample format in memory.
+    */
+   void reset(std::size_t capacity, SnapshotStorage storage);
+
+   /** @brief Samples held once the ring is full (0 while unallocated). */
+   [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+   /** @brief Sample format in memory. */
+   [[nodiscard]] SnapshotStorage storage() const { return _storage; }
+
+   /**
+    * @brief Append samples, overwriting the oldest.  Never blocks.
+    * @param samples  `count` samples.
+    * @param count    Number of samples.
+    * @param arrived  When the block was captured (for sampleAt()).
+    */
+   void write(const IqSample* samples, std::size_t count,
+              std::chrono::steady_clock::time_point arrived);
+
+   /**
+    * @brief Total samples appended since reset(); the index of the next one.
+    * @return Samples written.
+    */
+   [[nodiscard]] uint64_t written() const;
+
+   /**
+    * @brief Oldest sample index still held.
+    * @return `written() - capacity()`, or 0 before the ring has filled.
+    */
+   [[nodiscard]] uint64_t oldest() const;
+
+   /**
+    * @brief Index of the sample captured at a given time, extrapolated from
+    * the newest append at `sampleRateHz`.  Clamped to [oldest(), written()].
+    * @param when          Time of interest (e.g. a detection's first sighting).
+    * @param sampleRateHz  Current stream rate.
+    * @return Sample index.
+    */
+   [[nodiscard]] uint64_t sampleAt(std::chrono::steady_clock::time_point when,
+                                   double sampleRateHz) const;
+
+   /**
+    * @brief Copy samples `[first, first + count)` out of the ring.
+    *
+    * The range must already be written (`first + count <= written()`).
+    * Samples older than the ring (or overwritten during the copy) are
+    * not returned: the result is the number of leading samples lost, and
+    * `dst[lost, count)` holds the rest.
+    *
+    * @param first  Index of the first sample.
+    * @param dst    `count` output samples.
+    * @param count  Number of samples.
+    * @return Leading samples lost to overwriting (0 if the whole range was intact).
+    */
+   [[nodiscard]] std::size_t read(uint64_t first, IqSample* dst, std::size_t count) const;
+
+private:
+   // Copy `count` samples from ring slot `slot` (no wrap) into dst / out of src.
+   void copyOut(std::size_t slot, IqSample* dst, std::size_t count) const;
+   void copyIn(std::size_t slot, const IqSample* src, std::size_t count);
+
+   std::size_t _capacity{0};
+   SnapshotStorage _storage{SnapshotStorage::Cf32};
+   std::vector<IqSample> _samples;   // Cf32 storage.
+   std::vector<int16_t> _values;     // Cs16 storage (2 per sample).
+
+   std::atomic<uint64_t> _written{0};   // Published: samples fully copied in.
+   std::atomic<uint64_t> _claimed{0};   // Written plus the append in progress.
+   std::atomic<int64_t> _lastArrivalNs{0};
+};
+
+} // namespace SdrEngine
+
+#endif // IQSNAPSHOTRING_H_
@@ -0,0 +1,108 @@
+#ifndef PIPELINESTATS_H_
+#define PIPELINESTATS_H_
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace SdrEngine
+{
+
+/**
+ * @class PipelineStageStats
+ * @brief Snapshot of one SdrEngine pipeline stage's timing counters.
+ */
+struct PipelineStageStats
+{
+   uint64_t frames{0};              ///< Frames processed by the stage.
+   uint64_t busyNs{0};              ///< Total time spent working (excludes waits).
+   uint64_t maxFrameNs{0};          ///< Slowest single record() call.
+   std::size_t queueDepth{0};       ///< Frames waiting at the stage input.
+   std::size_t queueHighWater{0};   ///< Deepest the input queue has been.
+
+   /**
+    * @brief Get the mean processing time per frame.
+    * @return Mean time per frame in microseconds, or 0 if no frames yet.
+    */
+   [[nodiscard]] double meanFrameUs() const
+   {
+      return (frames == 0) ? 0.0
+                           : static_cast<double>(busyNs) / static_cast<double>(frames) / 1.0e3;
+   }
+};
+
+/**
+ * @class PipelineStats
+ * @brief Timing counters for every SdrEngine pipeline stage.
+ */
+struct PipelineStats
+{
+   PipelineStageStats conditioning;    ///< Ring read, DC removal, raw I/Q publish.
+   PipelineStageStats fft;             ///< Welch framing, FFT, spectrum publish.
+   PipelineStageStats channelFilter;   ///< Channel filter and filtered I/Q publish.
+   PipelineStageStats channelizer;     ///< Polyphase filterbank and per-channel publish.
+   PipelineStageStats vfos;            ///< All VFOs, processed in parallel.
+   PipelineStageStats detector;        ///< CFAR detection and detection publish.
+   PipelineStageStats sweep;           ///< Per-step FFT and stitching (sweep mode only).
+};
+
+/**
+ * @class PipelineStageCounters
+ * @brief Lock-free accumulators updated by a stage's worker thread.
+ *
+ * The worker calls `record()` once per frame or batch; any thread may read a
+ * consistent-enough snapshot via `snapshot()` at any time.
+ */
+class PipelineStageCounters
+{
+public:
+   /**
+    * @brief Account `frames` processed frames that together took `elapsed`.
+    * Stages that drain a backlog in one batch record it with one call.
+    */
+   void record(std::chrono::steady_clock::duration elapsed, std::size_t frames = 1)
+   {
+      const auto ns = static_cast<uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+      _frames.fetch_add(frames, std::memory_order_relaxed);
+      _busyNs.fetch_add(ns, std::memory_order_relaxed);
+
+      // Only the owning worker writes _maxFrameNs, so load/store suffices.
+      if (ns > _maxFrameNs.load(std::memory_order_relaxed))
+      {
+         _maxFrameNs.store(ns, std::memory_order_relaxed);
+      }
+   }
+
+   /** @brief Zero all counters.  Call only while the worker is stopped. */
+   void reset()
+   {
+      _frames.store(0, std::memory_order_relaxed);
+      _busyNs.store(0, std::memory_order_relaxed);
+      _maxFrameNs.store(0, std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Get the current counter values.
+    * @return Snapshot with the queue fields left at zero.
+    */
+   [[nodiscard]] PipelineStageStats snapshot() const
+   {
+      PipelineStageStats out;
+      out.frames     = _frames.load(std::memory_order_relaxed);
+      out.busyNs     = _busyNs.load(std::memory_order_relaxed);
+      out.maxFrameNs = _maxFrameNs.load(std::memory_order_relaxed);
+      return out;
+   }
+
+private:
+   std::atomic<uint64_t> _frames{0};
+   std::atomic<uint64_t> _busyNs{0};
+   std::atomic<uint64_t> _maxFrameNs{0};
+};
+
+} // namespace SdrEngine
+
+#endif // PIPELINESTATS_H_
@@ -0,0 +1,77 @@
+#ifndef PLAYBACKCLOCK_H_
+#define PLAYBACKCLOCK_H_
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace SdrEngine
+{
+
+/**
+ * @brief How fast a software device (file playback, signal generator)
+ *        delivers samples.
+ */
+enum class PlaybackPacing : uint8_t
+{
+   RealTime,          ///< At the configured sample rate, like real hardware.
+   AsFastAsPossible   ///< Back to back ("flood"), limited only by the consumer.
+};
+
+/**
+ * @class PlaybackClock
+ * @brief Paces a software device's stream thread at a sample rate.
+ *
+ * The stream thread calls start() once and pace() before delivering each
+ * block.  Time is accumulated per block rather than derived from a sample
+ * count, so a rate change mid-stream only affects the blocks after it.
+ */
+class PlaybackClock
+{
+public:
+   /** @brief Restart the clock at "now, nothing delivered". */
+   void start()
+   {
+      _start     = std::chrono::steady_clock::now();
+      _playedSec = 0.0;
+   }
+
+   /**
+    * @brief Sleep until a block of `samples` is due at `rateHz`.
+    * Sleeps in short steps and returns early once `running` turns false.
+    * @param samples  Samples in the block about to be delivered.
+    * @param rateHz   Current sample rate (Hz); non-positive does not pace.
+    * @param running  Stream flag checked while sleeping.
+    */
+   void pace(std::size_t samples, double rateHz, const std::atomic<bool>& running)
+   {
+      if (rateHz <= 0.0)
+      {
+         return;
+      }
+      _playedSec += static_cast<double>(samples) / rateHz;
+      const auto due = _start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(_playedSec));
+      for (auto now = std::chrono::steady_clock::now(); running && now < due;
+           now = std::chrono::steady_clock::now())
+      {
+         std::this_thread::sleep_for(
+            std::min<std::chrono::steady_clock::duration>(due - now, MAX_SLEEP));
+      }
+   }
+
+private:
+   // Longest single sleep, so stopping a stream is never kept waiting.
+   static constexpr std::chrono::milliseconds MAX_SLEEP{10};
+
+   std::chrono::steady_clock::time_point _start;
+   double _playedSec{0.0};
+};
+
+} // namespace SdrEngine
+
+#endif // PLAYBACKCLOCK_H_
@@ -1,5 +1,6 @@
 // Project headers
 #include "SdrCommonUtils.h"
+#include "DspKernels.h"
 
 // System headers
 #include <algorithm>
@@ -8,16 +9,30 @@ namespace SdrEngine
 {
 
 std::vector<float> decimateSpectrum(
-   const std::vector<float>& magnitudesDb,
+   std::span<const float> magnitudesDb,
    std::size_t maxBins)
 {
-   if (magnitudesDb.size() <= maxBins || maxBins == 0)
+   if (maxBins == 0)
    {
-      return magnitudesDb;
+      return {magnitudesDb.begin(), magnitudesDb.end()};
    }
+   std::vector<float> decimated(std::min(magnitudesDb.size(), maxBins));
+   decimateSpectrum(magnitudesDb, decimated);
+   return decimated;
+}
 
-   std::vector<float> decimated;
-   decimated.reserve(maxBins);
+std::size_t decimateSpectrum(std::span<const float> magnitudesDb, std::span<float> out)
+{
+   const std::size_t maxBins = out.size();
+   if (maxBins == 0)
+   {
+      return 0;
+   }
+   if (magnitudesDb.size() <= maxBins)
+   {
+      std::ranges::copy(magnitudesDb, out.begin());
+      return magnitudesDb.size();
+   }
 
    const std::size_t binSize = magnitudesDb.size() / maxBins;
    const std::size_t remainder = magnitudesDb.size() % maxBins;
@@ -27,18 +42,90 @@ std::vector<float> decimateSpectrum(
    {
       // Distribute remainder across bins to handle non-divisible sizes.
       const std::size_t currentBinSize = binSize + (i < remainder ? 1 : 0);
+      out[i] = maxValue(magnitudesDb.data() + srcIdx, currentBinSize);
+      srcIdx += currentBinSize;
+   }
+   return maxBins;
+}
+
+void buildSpectrumPyramid(SpectrumData& frame, std::size_t minPoints)
+{
+   // Count the tiers first so the (pooled) tier vector keeps its storage.
+   std::size_t tierCount = 0;
+   for (std::size_t size = frame.magnitudesDb.size();
+        size > 1 && (size + 1) / 2 >= minPoints; size = (size + 1) / 2)
+   {
+      ++tierCount;
+   }
+   frame.tiers.resize(tierCount);
 
-      float maxVal = magnitudesDb[srcIdx];
-      for (std::size_t j = 1; j < currentBinSize; ++j)
+   const float* srcMax  = frame.magnitudesDb.data();
+   const float* srcMin  = srcMax;
+   const float* srcMean = srcMax;
+   std::size_t srcSize  = frame.magnitudesDb.size();
+   std::size_t binsPerPoint = 1;
+
+   for (auto& tier : frame.tiers)
+   {
+      const std::size_t pairs  = srcSize / 2;
+      const std::size_t points = (srcSize + 1) / 2;
+      binsPerPoint *= 2;
+
+      tier.binsPerPoint = binsPerPoint;
+      tier.maxDb.resize(points);
+      tier.minDb.resize(points);
+      tier.meanDb.resize(points);
+      pairwiseMax(srcMax, tier.maxDb.data(), pairs);
+      pairwiseMin(srcMin, tier.minDb.data(), pairs);
+      pairwiseMean(srcMean, tier.meanDb.data(), pairs);
+
+      // An odd trailing value becomes a point of its own.
+      if (points > pairs)
       {
-         maxVal = std::max(maxVal, magnitudesDb[srcIdx + j]);
+         tier.maxDb[pairs]  = srcMax[srcSize - 1];
+         tier.minDb[pairs]  = srcMin[srcSize - 1];
+         tier.meanDb[pairs] = srcMean[srcSize - 1];
       }
 
-      decimated.push_back(maxVal);
-      srcIdx += currentBinSize;
+      srcMax  = tier.maxDb.data();
+      srcMin  = tier.minDb.data();
+      srcMean = tier.meanDb.data();
+      srcSize = points;
    }
+}
 
-   return decimated;
+SpectrumView selectSpectrumView(const SpectrumData& frame, std::size_t firstBin,
+                                std::size_t binCount, std::size_t maxPoints)
+{
+   const std::size_t totalBins = frame.magnitudesDb.size();
+   firstBin = std::min(firstBin, totalBins);
+   const std::size_t endBin = firstBin + std::min(binCount, totalBins - firstBin);
+
+   // Full resolution if it fits (or no pyramid was published).
+   SpectrumView view;
+   view.binsPerPoint = 1;
+   view.firstBin     = firstBin;
+   const std::span<const float> full(frame.magnitudesDb);
+   view.maxDb  = full.subspan(firstBin, endBin - firstBin);
+   view.minDb  = view.maxDb;
+   view.meanDb = view.maxDb;
+
+   for (const auto& tier : frame.tiers)
+   {
+      if (view.maxDb.size() <= maxPoints)
+      {
+         break;
+      }
+      const std::size_t first = firstBin / tier.binsPerPoint;
+      const std::size_t last  = std::min(tier.maxDb.size(),
+                                         (endBin + tier.binsPerPoint - 1) / tier.binsPerPoint);
+      view.binsPerPoint = tier.binsPerPoint;
+      view.firstBin     = first * tier.binsPerPoint;
+      view.maxDb  = std::span<const float>(tier.maxDb).subspan(first, last - first);
+      view.minDb  = std::span<const float>(tier.minDb).subspan(first, last - first);
+      view.meanDb = std::span<const float>(tier.meanDb).subspan(first, last - first);
+   }
+   return view;
 }
 
 } // namespace SdrEngine
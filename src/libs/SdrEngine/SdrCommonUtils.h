@@ -1,8 +1,12 @@
 #ifndef SDRCOMMONUTILS_H_
 #define SDRCOMMONUTILS_H_
 
+// Project headers
+#include "SdrTypes.h"
+
 // System headers
 #include <cstddef>
+#include <span>
 #include <vector>
 
 namespace SdrEngine
@@ -22,9 +26,63 @@ namespace SdrEngine
  * @return Decimated spectrum with at most @p maxBins entries.
  */
 [[nodiscard]] std::vector<float> decimateSpectrum(
-   const std::vector<float>& magnitudesDb,
+   std::span<const float> magnitudesDb,
    std::size_t maxBins = 2048);
 
+/**
+ * @brief decimateSpectrum() into caller storage, without allocating.
+ *
+ * Groups are formed as above with `maxBins = out.size()`; an input of at
+ * most `out.size()` bins is copied unchanged.
+ *
+ * @param magnitudesDb  Input spectrum magnitudes (typically in dB).
+ * @param out           Output storage; its size is the largest bin count.
+ * @return Number of values written to the front of @p out.
+ */
+std::size_t decimateSpectrum(std::span<const float> magnitudesDb, std::span<float> out);
+
+/**
+ * @brief Fill `frame.tiers` with a min / max / mean pyramid of `magnitudesDb`.
+ *
+ * Tier k merges 2^(k+1) bins per point; tiers stop before one would have
+ * fewer than @p minPoints points.  Reuses the frame's existing tier storage.
+ *
+ * @param frame      Frame whose `magnitudesDb` is already filled.
+ * @param minPoints  Smallest tier size to build.
+ */
+void buildSpectrumPyramid(SpectrumData& frame, std::size_t minPoints);
+
+/**
+ * @struct SpectrumView
+ * @brief Non-owning view of one resolution of a SpectrumData frame.
+ *
+ * At full resolution the three traces are all `magnitudesDb`.
+ */
+struct SpectrumView
+{
+   std::span<const float> maxDb;     ///< Peak per point.
+   std::span<const float> minDb;     ///< Minimum per point.
+   std::span<const float> meanDb;    ///< Mean per point.
+   std::size_t binsPerPoint{1};      ///< Full-resolution bins per point.
+   std::size_t firstBin{0};          ///< Full-resolution bin of the first point.
+};
+
+/**
+ * @brief Select the finest resolution that shows a bin range in at most
+ *        @p maxPoints points, without copying.
+ *
+ * If the frame has no pyramid (or it is not deep enough), the view is the
+ * coarsest available and may hold more than @p maxPoints points.
+ *
+ * @param frame      Published spectrum frame (the view borrows its storage).
+ * @param firstBin   First full-resolution bin of the range.
+ * @param binCount   Number of full-resolution bins in the range.
+ * @param maxPoints  Largest acceptable number of points.
+ * @return View covering (at least) the requested range.
+ */
+[[nodiscard]] SpectrumView selectSpectrumView(const SpectrumData& frame, std::size_t firstBin,
+                                              std::size_t binCount, std::size_t maxPoints);
+
 } // namespace SdrEngine
 
 #endif // SDRCOMMONUTILS_H_
@@ -0,0 +1,242 @@
+// Project headers
+#include "SdrDeviceGroup.h"
+#include "GeneralLogger.h"
+
+// System headers
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+SdrDeviceGroup::SdrDeviceGroup()
+   : _mergedHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>>(
+        CommonUtils::OverflowPolicy::DropOldest, MERGED_PUBLISH_CAPACITY)}
+{
+   _mergedHandler->setName("SdrDeviceGroup.mergedSpectrum");
+}
+
+SdrDeviceGroup::~SdrDeviceGroup()
+{
+   stop();
+   // Destroy the engines before the merged handler their listeners feed.
+   _members.clear();
+   _mergedHandler.reset();
+}
+
+// ============================================================================
+// Members
+// ============================================================================
+
+std::size_t SdrDeviceGroup::addDevice(std::unique_ptr<ISdrDevice> device, int deviceIndex,
+                                      const CommonUtils::ThreadSettings& threads)
+{
+   const std::size_t member = _members.size();
+   const std::string name   = memberName(member);
+
+   // Before the engine exists, so its DataHandler workers are pinned too.
+   if (threads != CommonUtils::ThreadSettings{})
+   {
+      CommonUtils::ThreadConfig::instance().set(name + ".*", threads);
+      CommonUtils::ThreadConfig::instance().set("DataHandler." + name + ".*", threads);
+   }
+
+   auto entry         = std::make_unique<Member>();
+   entry->engine      = std::make_unique<SdrEngine>(name);
+   entry->deviceIndex = deviceIndex;
+   if (device)
+   {
+      device->setStreamThreadRole(name + ".stream");
+   }
+   entry->engine->setDevice(std::move(device));
+   _members.push_back(std::move(entry));
+   return member;
+}
+
+std::size_t SdrDeviceGroup::size() const
+{
+   return _members.size();
+}
+
+SdrEngine& SdrDeviceGroup::engine(std::size_t member)
+{
+   return *_members.at(member)->engine;
+}
+
+std::string SdrDeviceGroup::memberName(std::size_t member)
+{
+   return std::string(SdrEngine::DEFAULT_NAME) + ".dev" + std::to_string(member);
+}
+
+// ============================================================================
+// Start / stop
+// ============================================================================
+
+bool SdrDeviceGroup::start()
+{
+   if (_running)
+   {
+      GPWARN("SdrDeviceGroup already running");
+      return false;
+   }
+   if (_members.empty())
+   {
+      GPERROR("SdrDeviceGroup has no devices");
+      return false;
+   }
+
+   // Start the members side by side, each from a thread on its own CPUs so
+   // the buffers start() allocates land on the member's NUMA node.
+   std::vector<char> started(_members.size(), 0);
+   {
+      std::vector<std::thread> starters;
+      starters.reserve(_members.size());
+      for (std::size_t m = 0; m < _members.size(); ++m)
+      {
+         starters.emplace_back(
+            [this, m, &started]
+            {
+               CommonUtils::configureCurrentThread(memberName(m) + ".start");
+               Member& member = *_members[m];
+               started[m]     = member.engine->start(member.deviceIndex) ? 1 : 0;
+            });
+      }
+      for (auto& starter : starters)
+      {
+         starter.join();
+      }
+   }
+   if (std::count(started.begin(), started.end(), 0) > 0)
+   {
+      for (std::size_t m = 0; m < _members.size(); ++m)
+      {
+         if (started[m] == 0)
+         {
+            GPERROR("{} failed to start on device {}", memberName(m), _members[m]->deviceIndex);
+         }
+         _members[m]->engine->stop();
+      }
+      return false;
+   }
+
+   {
+      const std::lock_guard<std::mutex> lock(_mergeMutex);
+      for (auto& member : _members)
+      {
+         member->latest.reset();
+         member->fresh = false;
+      }
+      _lastMerge = std::chrono::steady_clock::now();
+   }
+   _mergedFrames = 0;
+
+   // Only each member's newest spectrum is merged; never hold up an engine.
+   for (std::size_t m = 0; m < _members.size(); ++m)
+   {
+      _members[m]->spectrumListenerId = _members[m]->engine->spectrumDataHandler().registerListener(
+         [this, m](const std::shared_ptr<const SpectrumData>& spectrum) { onSpectrum(m, spectrum); },
+         CommonUtils::ListenerOptions{CommonUtils::DispatchMode::DedicatedThread,
+                                      CommonUtils::OverflowPolicy::LatestOnly, 1, nullptr});
+   }
+
+   _running = true;
+   GPINFO("SdrDeviceGroup started {} devices", _members.size());
+   return true;
+}
+
+void SdrDeviceGroup::stop()
+{
+   for (auto& member : _members)
+   {
+      if (member->spectrumListenerId >= 0)
+      {
+         member->engine->spectrumDataHandler().unregisterListener(member->spectrumListenerId);
+         member->spectrumListenerId = -1;
+      }
+      member->engine->stop();
+   }
+   {
+      const std::lock_guard<std::mutex> lock(_mergeMutex);
+      for (auto& member : _members)
+      {
+         member->latest.reset();
+      }
+   }
+   _running = false;
+}
+
+bool SdrDeviceGroup::isRunning() const
+{
+   return _running;
+}
+
+// ============================================================================
+// Merged spectrum
+// ============================================================================
+
+void SdrDeviceGroup::setMergedSpectrumEnabled(bool enabled)
+{
+   _mergedEnabled = enabled;
+}
+
+bool SdrDeviceGroup::isMergedSpectrumEnabled() const
+{
+   return _mergedEnabled;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>&
+SdrDeviceGroup::mergedSpectrumDataHandler()
+{
+   return *_mergedHandler;
+}
+
+uint64_t SdrDeviceGroup::getMergedFrameCount() const
+{
+   return _mergedFrames;
+}
+
+void SdrDeviceGroup::onSpectrum(std::size_t member,
+                                const std::shared_ptr<const SpectrumData>& spectrum)
+{
+   if (!spectrum || !_mergedEnabled.load(std::memory_order_relaxed))
+   {
+      return;
+   }
+
+   std::shared_ptr<SpectrumData> merged;
+   {
+      const std::lock_guard<std::mutex> lock(_mergeMutex);
+      _members[member]->latest = spectrum;
+      _members[member]->fresh  = true;
+
+      const auto now = std::chrono::steady_clock::now();
+      const bool complete =
+         std::all_of(_members.begin(), _members.end(), [](const auto& m) { return m->fresh; });
+      if (!complete && now - _lastMerge < MERGE_STALL_TIMEOUT)
+      {
+         return;
+      }
+
+      _mergeInputs.clear();
+      for (auto& m : _members)
+      {
+         _mergeInputs.push_back(m->latest.get());
+         m->fresh = false;
+      }
+      _lastMerge = now;
+      merged     = _mergedPool.acquire();
+      if (!_merger.merge(_mergeInputs, *merged))
+      {
+         return;
+      }
+   }
+   ++_mergedFrames;
+   _mergedHandler->signalData(std::move(merged));
+}
+
+} // namespace SdrEngine
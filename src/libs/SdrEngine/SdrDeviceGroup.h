@@ -0,0 +1,172 @@
+#ifndef SDRDEVICEGROUP_H_
+#define SDRDEVICEGROUP_H_
+
+// Project headers
+#include "DataHandler.h"
+#include "FramePool.h"
+#include "ISdrDevice.h"
+#include "SdrEngine.h"
+#include "SdrTypes.h"
+#include "SpectrumMerger.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class SdrDeviceGroup
+ * @brief Several SDR devices in one process, each with its own SdrEngine.
+ *
+ * Every member device drives an independent capture → FFT → VFO pipeline
+ * (a complete SdrEngine named "SdrEngine.dev<n>"), so N devices use N
+ * sets of stage threads and nothing is shared between them but the
+ * process.  Configure and listen to each through engine(n).
+ *
+ * Pinning: a member added with ThreadSettings registers them in
+ * CommonUtils::ThreadConfig for "SdrEngine.dev<n>.*" (stage threads, the
+ * device's stream thread, which takes role "SdrEngine.dev<n>.stream") and
+ * "DataHandler.SdrEngine.dev<n>.*" (its publishers).  Members added without
+ * settings follow whatever ThreadConfig already holds for those roles.
+ *
+ * NUMA: each member is started on a thread of role "SdrEngine.dev<n>.start",
+ * so with its pinning in place the sample ring and pre-filled frame pools
+ * are first touched — and so placed — on the member's node; frames
+ * allocated later come from its pinned stage threads the same way.  All
+ * members start concurrently.
+ *
+ * Merged spectrum: with setMergedSpectrumEnabled(), the newest spectrum of
+ * every member is joined by a SpectrumMerger into one trace across their
+ * (adjacent) frequencies and published on mergedSpectrumDataHandler()
+ * ("SdrDeviceGroup.mergedSpectrum").  A merge happens once every member has
+ * delivered a new spectrum, or MERGE_STALL_TIMEOUT after the previous merge
+ * if one of them has stalled.
+ *
+ * Thread-safety: addDevice(), start() and stop() from one controlling
+ * thread; the rest from any thread.
+ */
+class SdrDeviceGroup
+{
+public:
+   /// Longest a merge waits for a member whose spectra have stopped.
+   static constexpr std::chrono::milliseconds MERGE_STALL_TIMEOUT{250};
+
+   SdrDeviceGroup();
+   ~SdrDeviceGroup();
+
+   // Non-copyable, non-movable (engines hold listeners into the group).
+   SdrDeviceGroup(const SdrDeviceGroup&) = delete;
+   SdrDeviceGroup& operator=(const SdrDeviceGroup&) = delete;
+   SdrDeviceGroup(SdrDeviceGroup&&) = delete;
+   SdrDeviceGroup& operator=(SdrDeviceGroup&&) = delete;
+
+   /**
+    * @brief Add a device with its own engine.  Only while stopped.
+    * @param device       Device to capture from.
+    * @param deviceIndex  Index passed to ISdrDevice::open().
+    * @param threads      Pinning for all of the member's threads; default:
+    *                     leave ThreadConfig as it is.
+    * @return The member index n (engine "SdrEngine.dev<n>").
+    */
+   std::size_t addDevice(std::unique_ptr<ISdrDevice> device, int deviceIndex,
+                         const CommonUtils::ThreadSettings& threads = {});
+
+   /**
+    * @brief Get the number of member devices.
+    * @return Member count.
+    */
+   [[nodiscard]] std::size_t size() const;
+
+   /**
+    * @brief Get a member's engine, to configure it or register listeners.
+    * @param member  Index returned by addDevice().
+    * @return The member's engine.
+    */
+   [[nodiscard]] SdrEngine& engine(std::size_t member);
+
+   /**
+    * @brief Get the engine name of a member.
+    * @param member  Member index.
+    * @return "SdrEngine.dev<member>".
+    */
+   [[nodiscard]] static std::string memberName(std::size_t member);
+
+   /**
+    * @brief Start every member, each on a thread pinned like the member.
+    * @return true if all started; otherwise none is left running.
+    */
+   [[nodiscard]] bool start();
+
+   /** @brief Stop every member. */
+   void stop();
+
+   /**
+    * @brief Check if the members run.
+    * @return true between a successful start() and stop().
+    */
+   [[nodiscard]] bool isRunning() const;
+
+   // -- Merged spectrum -----------------------------------------------------
+
+   /** @brief Enable / disable the merged spectrum (default: disabled). */
+   void setMergedSpectrumEnabled(bool enabled);
+
+   /**
+    * @brief Check if the merged spectrum is published.
+    * @return true if merged spectra are published.
+    */
+   [[nodiscard]] bool isMergedSpectrumEnabled() const;
+
+   /**
+    * @brief Get the DataHandler the merged spectra are published on.
+    * @return Merged spectrum handler.
+    */
+   CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& mergedSpectrumDataHandler();
+
+   /**
+    * @brief Get the number of merged spectra published.
+    * @return Merged frames since start().
+    */
+   [[nodiscard]] uint64_t getMergedFrameCount() const;
+
+private:
+   struct Member
+   {
+      std::unique_ptr<SdrEngine> engine;
+      int deviceIndex{0};
+      int spectrumListenerId{-1};
+      std::shared_ptr<const SpectrumData> latest;   // Guarded by _mergeMutex.
+      bool fresh{false};                            // Guarded by _mergeMutex.
+   };
+
+   // Take a member's newest spectrum and merge when the set is complete.
+   void onSpectrum(std::size_t member, const std::shared_ptr<const SpectrumData>& spectrum);
+
+   std::vector<std::unique_ptr<Member>> _members;
+   std::atomic<bool> _running{false};
+
+   // -- Merged spectrum -----------------------------------------------------
+   static constexpr std::size_t MERGED_PUBLISH_CAPACITY = 4;
+   static constexpr std::size_t MERGED_POOL_DEPTH       = 8;
+   std::atomic<bool> _mergedEnabled{false};
+   std::atomic<uint64_t> _mergedFrames{0};
+   std::mutex _mergeMutex;
+   SpectrumMerger _merger;                                   // Guarded by _mergeMutex.
+   std::vector<const SpectrumData*> _mergeInputs;            // Guarded by _mergeMutex.
+   std::chrono::steady_clock::time_point _lastMerge;         // Guarded by _mergeMutex.
+   FramePool<SpectrumData> _mergedPool{MERGED_POOL_DEPTH};
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>> _mergedHandler;
+};
+
+} // namespace SdrEngine
+
+#endif // SDRDEVICEGROUP_H_
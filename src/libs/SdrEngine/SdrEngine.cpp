@@ -1,27 +1,86 @@
 // Project headers
 #include "SdrEngine.h"
 #include "GeneralLogger.h"
+#include "Profiler.h"
+#include "SdrCommonUtils.h"
+#include "ThreadConfig.h"
+
+// Third-party headers
+#include "spdlog/fmt/fmt.h"
 
 // System headers
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <span>
+#include <thread>
 #include <utility>
 
 namespace SdrEngine
 {
 
+namespace
+{
+
+// How often a snapshot waiting for its post-trigger samples looks again.
+constexpr std::chrono::milliseconds SNAPSHOT_POLL{5};
+
+// Bytes a queued spectrum keeps alive.
+size_t spectrumBytes(const std::shared_ptr<const SpectrumData>& spectrum)
+{
+   size_t bytes = sizeof(SpectrumData) +
+                  ((spectrum->magnitudesDb.capacity() + spectrum->maxHoldDb.capacity() +
+                    spectrum->minHoldDb.capacity()) * sizeof(float));
+   for (const SpectrumTier& tier : spectrum->tiers)
+   {
+      bytes += sizeof(SpectrumTier) +
+               ((tier.maxDb.capacity() + tier.minDb.capacity() + tier.meanDb.capacity()) *
+                sizeof(float));
+   }
+   return bytes;
+}
+
+// Bytes a queued I/Q block keeps alive.
+size_t iqBytes(const std::shared_ptr<const IqBuffer>& buffer)
+{
+   return sizeof(IqBuffer) + (buffer->samples.capacity() * sizeof(IqSample));
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // Construction / destruction
 // ============================================================================
 
-SdrEngine::SdrEngine()
-   : _fft{2048, WindowFunction::BlackmanHarris}
-   , _spectrumHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>>()}
-   , _iqHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>()}
-   , _filteredIqHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>()}
+SdrEngine::SdrEngine(std::string name)
+   : _name{std::move(name)}
+   , _fft{2048, WindowFunction::BlackmanHarris}
+   , _spectrumHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>>(
+        CommonUtils::OverflowPolicy::DropOldest, SPECTRUM_PUBLISH_CAPACITY)}
+   , _sweepHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>>(
+        CommonUtils::OverflowPolicy::LatestOnly)}
+   , _zoomSpectrumHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>>(
+        CommonUtils::OverflowPolicy::DropOldest, SPECTRUM_PUBLISH_CAPACITY)}
+   , _iqHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>(
+        CommonUtils::OverflowPolicy::DropOldest, IQ_PUBLISH_CAPACITY)}
+   , _filteredIqHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>(
+        CommonUtils::OverflowPolicy::DropOldest, FILTERED_IQ_PUBLISH_CAPACITY)}
+   , _detectionHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const DetectionReport>>>(
+        CommonUtils::OverflowPolicy::DropOldest, DETECTION_PUBLISH_CAPACITY)}
+   , _displayIqHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>(
+        CommonUtils::OverflowPolicy::DropOldest, DISPLAY_IQ_PUBLISH_CAPACITY)}
 {
+   _spectrumHandler->setName(_name + ".spectrum");
+   _sweepHandler->setName(_name + ".sweep");
+   _zoomSpectrumHandler->setName(_name + ".zoomSpectrum");
+   _iqHandler->setName(_name + ".iq");
+   _filteredIqHandler->setName(_name + ".filteredIq");
+   _detectionHandler->setName(_name + ".detections");
+   _displayIqHandler->setName(_name + ".displayIq");
+   _spectrumHandler->setMemoryAccounting(SPECTRUM_QUEUE_ACCOUNT, spectrumBytes);
+   _iqHandler->setMemoryAccounting(IQ_QUEUE_ACCOUNT, iqBytes);
 }
 
 SdrEngine::~SdrEngine()
@@ -29,8 +88,24 @@ SdrEngine::~SdrEngine()
    stop();
    // Destroy handlers before the engine goes away so listener threads exit.
    _spectrumHandler.reset();
+   _sweepHandler.reset();
+   _zoomSpectrumHandler.reset();
    _iqHandler.reset();
    _filteredIqHandler.reset();
+   _detectionHandler.reset();
+   _displayIqHandler.reset();
+   _channelHandlers.clear();
+   {
+      const std::lock_guard<std::mutex> lock(_demodExecutorMutex);
+      _demodExecutor.reset();
+   }
+   const std::lock_guard<std::mutex> lock(_vfoMutex);
+   _vfos.clear();
+}
+
+const std::string& SdrEngine::getName() const
+{
+   return _name;
 }
 
 // ============================================================================
@@ -68,7 +143,8 @@ std::vector<DeviceInfo> SdrEngine::enumerateDevices() const
 bool SdrEngine::setCenterFrequency(uint64_t frequencyHz)
 {
    _centerFreqHz = frequencyHz;
-   if (_device && _device->isOpen())
+   // A running sweep owns the tuner; the cached value applies on the next start().
+   if (_device && _device->isOpen() && !(_running && _sweepEnabled))
    {
       return _device->setCenterFrequency(frequencyHz);
    }
@@ -154,9 +230,31 @@ size_t SdrEngine::getFftSize() const
    return _fft.getFftSize();
 }
 
+void SdrEngine::prepareFftSizes(std::vector<size_t> fftSizes)
+{
+   _fft.prepareFftSizes(std::move(fftSizes));
+}
+
+void SdrEngine::setFftBackend(FftBackend backend)
+{
+   _fft.setBackend(backend);
+   _zoomFft.setBackend(backend);
+}
+
+FftBackend SdrEngine::getFftBackend() const
+{
+   return _fft.getBackend();
+}
+
+FftBackend SdrEngine::getActiveFftBackend() const
+{
+   return _fft.getActiveBackend();
+}
+
 void SdrEngine::setWindowFunction(WindowFunction windowFunc)
 {
    _fft.setWindowFunction(windowFunc);
+   _zoomFft.setWindowFunction(windowFunc);
 }
 
 WindowFunction SdrEngine::getWindowFunction() const
@@ -166,12 +264,157 @@ WindowFunction SdrEngine::getWindowFunction() const
 
 void SdrEngine::setFftAverageAlpha(float alpha)
 {
-   _fftAlpha = std::clamp(alpha, 0.0F, 1.0F);
+   _spectrumStats.setAverageAlpha(alpha);
+   _zoomStats.setAverageAlpha(alpha);
 }
 
 float SdrEngine::getFftAverageAlpha() const
 {
-   return _fftAlpha;
+   return _spectrumStats.getAverageAlpha();
+}
+
+void SdrEngine::setMaxHoldEnabled(bool enabled)
+{
+   _spectrumStats.setMaxHoldEnabled(enabled);
+}
+
+bool SdrEngine::isMaxHoldEnabled() const
+{
+   return _spectrumStats.isMaxHoldEnabled();
+}
+
+void SdrEngine::setMaxHoldDecayRate(float dbPerSecond)
+{
+   _spectrumStats.setMaxHoldDecayRate(dbPerSecond);
+}
+
+float SdrEngine::getMaxHoldDecayRate() const
+{
+   return _spectrumStats.getMaxHoldDecayRate();
+}
+
+void SdrEngine::setMinHoldEnabled(bool enabled)
+{
+   _spectrumStats.setMinHoldEnabled(enabled);
+}
+
+bool SdrEngine::isMinHoldEnabled() const
+{
+   return _spectrumStats.isMinHoldEnabled();
+}
+
+void SdrEngine::resetSpectrumHolds()
+{
+   _spectrumStats.resetHolds();
+}
+
+void SdrEngine::setSpectrumPyramidEnabled(bool enabled)
+{
+   _spectrumPyramidEnabled = enabled;
+}
+
+bool SdrEngine::isSpectrumPyramidEnabled() const
+{
+   return _spectrumPyramidEnabled;
+}
+
+void SdrEngine::setSpectrumLevelsEnabled(bool enabled)
+{
+   _spectrumLevels.setEnabled(enabled);
+}
+
+bool SdrEngine::isSpectrumLevelsEnabled() const
+{
+   return _spectrumLevels.isEnabled();
+}
+
+void SdrEngine::setNoiseFloorPercentile(float percent)
+{
+   _spectrumLevels.setPercentile(percent);
+}
+
+float SdrEngine::getNoiseFloorPercentile() const
+{
+   return _spectrumLevels.getPercentile();
+}
+
+void SdrEngine::setNoiseFloorTimeConstant(float seconds)
+{
+   _spectrumLevels.setTimeConstant(seconds);
+}
+
+float SdrEngine::getNoiseFloorTimeConstant() const
+{
+   return _spectrumLevels.getTimeConstant();
+}
+
+void SdrEngine::setMeasurementBand(double minFreqHz, double maxFreqHz)
+{
+   _spectrumLevels.setBand(minFreqHz, maxFreqHz);
+}
+
+void SdrEngine::clearMeasurementBand()
+{
+   _spectrumLevels.clearBand();
+}
+
+void SdrEngine::setFftOverlapPercent(float percent)
+{
+   if (!std::isfinite(percent))
+   {
+      GPWARN("Ignoring non-finite FFT overlap {}", percent);
+      return;
+   }
+   _fftOverlapPercent = std::clamp(percent, 0.0F, MAX_FFT_OVERLAP_PERCENT);
+}
+
+float SdrEngine::getFftOverlapPercent() const
+{
+   return _fftOverlapPercent;
+}
+
+void SdrEngine::setSpectrumOutputRate(float framesPerSecond)
+{
+   _spectrumOutputRate = std::max(framesPerSecond, 0.0F);
+}
+
+float SdrEngine::getSpectrumOutputRate() const
+{
+   return _spectrumOutputRate;
+}
+
+void SdrEngine::setLoadControlEnabled(bool enabled)
+{
+   _loadControlEnabled        = enabled;
+   _loadControlRestartPending = true;
+}
+
+bool SdrEngine::isLoadControlEnabled() const
+{
+   return _loadControlEnabled;
+}
+
+void SdrEngine::setLoadControlConfig(const FftLoadConfig& config)
+{
+   {
+      const std::lock_guard<std::mutex> lock(_loadControlMutex);
+      _loadControlConfig = config;
+   }
+   _loadControlRestartPending = true;
+}
+
+FftLoadConfig SdrEngine::getLoadControlConfig() const
+{
+   const std::lock_guard<std::mutex> lock(_loadControlMutex);
+   return _loadControlConfig;
+}
+
+EngineLoadControlStats SdrEngine::getLoadControlStats() const
+{
+   const std::lock_guard<std::mutex> lock(_loadControlMutex);
+   EngineLoadControlStats stats = _loadControlStats;
+   stats.enabled = _loadControlEnabled;
+   return stats;
 }
 
 void SdrEngine::setDcSpikeRemovalEnabled(bool enabled)
@@ -184,6 +427,16 @@ bool SdrEngine::isDcSpikeRemovalEnabled() const
    return _dcSpikeRemovalEnabled;
 }
 
+void SdrEngine::setDcBlockerTimeConstant(float seconds)
+{
+   _dcTimeConstantSec = std::max(seconds, MIN_DC_TIME_CONSTANT_S);
+}
+
+float SdrEngine::getDcBlockerTimeConstant() const
+{
+   return _dcTimeConstantSec;
+}
+
 // ============================================================================
 // Channel filter controls
 // ============================================================================
@@ -205,6 +458,8 @@ void SdrEngine::configureChannelFilterFromMinMax(double minFreqHz, double maxFre
 void SdrEngine::setChannelFilterEnabled(bool enabled)
 {
    _channelFilter.setEnabled(enabled);
+   // The zoom average must not span the time the filter was off.
+   _zoomRestartPending = true;
 }
 
 bool SdrEngine::isChannelFilterEnabled() const
@@ -218,255 +473,1596 @@ const ChannelFilter& SdrEngine::channelFilter() const
 }
 
 // ============================================================================
-// Start / stop
+// Zoom FFT controls
 // ============================================================================
 
-bool SdrEngine::start(int deviceIndex)
+void SdrEngine::setZoomFftEnabled(bool enabled)
+{
+   _zoomFftEnabled     = enabled;
+   _zoomRestartPending = true;
+}
+
+bool SdrEngine::isZoomFftEnabled() const
+{
+   return _zoomFftEnabled;
+}
+
+void SdrEngine::setZoomFftSize(size_t fftSize)
+{
+   _zoomFft.setFftSize(fftSize);
+}
+
+size_t SdrEngine::getZoomFftSize() const
+{
+   return _zoomFft.getFftSize();
+}
+
+// ============================================================================
+// Channelizer controls
+// ============================================================================
+
+bool SdrEngine::configureChannelizer(std::size_t numChannels, std::size_t tapsPerChannel)
 {
    if (_running)
    {
-      GPWARN("SdrEngine already running");
-      return false;
-   }
-   if (!_device)
-   {
-      GPERROR("No SDR device set");
+      GPWARN("SdrEngine: channelizer can only be reconfigured while stopped");
       return false;
    }
 
-   // Open the device.
-   if (!_device->open(deviceIndex))
+   _channelizer.configure(numChannels, static_cast<double>(_sampleRateHz.load()), tapsPerChannel);
+   if (getChannelizerChannelCount() != numChannels)
    {
-      GPERROR("Failed to open device at index {}", deviceIndex);
       return false;
    }
 
-   // Apply cached tuning.
-   std::ignore = _device->setCenterFrequency(_centerFreqHz);
-   std::ignore = _device->setSampleRate(_sampleRateHz);
-
-   // Start the processing thread.
-   _running = true;
-   _procThread = std::thread(&SdrEngine::processingLoop, this);
-
-   // Start streaming — the callback feeds the accumulation buffer.
-   const auto bufSize = static_cast<std::size_t>(_fft.getFftSize());
-   if (!_device->startStreaming(
-          [this](const IqSample* samples, std::size_t n) { onIqData(samples, n); },
-          bufSize))
+   // Grow only — existing handlers keep their listeners.
+   const std::lock_guard<std::mutex> lock(_channelPolicyMutex);
+   while (_channelHandlers.size() < numChannels)
    {
-      GPERROR("Failed to start streaming");
-      _running = false;
-      _bufCv.notify_all();
-      if (_procThread.joinable())
-      {
-         _procThread.join();
-      }
-      _device->close();
-      return false;
+      _channelHandlers.push_back(std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>(
+         _channelPolicy, _channelPolicyCapacity));
+      _channelHandlers.back()->setName(_name + ".channel." + std::to_string(_channelHandlers.size() - 1));
    }
-
-   GPINFO("SdrEngine started (freq={} Hz, rate={} Hz, fft={})",
-          _centerFreqHz.load(), _sampleRateHz.load(), _fft.getFftSize());
    return true;
 }
 
-void SdrEngine::stop()
+void SdrEngine::setChannelizerEnabled(bool enabled)
 {
-   if (!_running)
-   {
-      return;
-   }
+   _channelizer.setEnabled(enabled);
+}
 
-   // Stop streaming first (blocks until device thread exits).
-   if (_device && _device->isStreaming())
-   {
-      _device->stopStreaming();
-   }
+bool SdrEngine::isChannelizerEnabled() const
+{
+   return _channelizer.isEnabled();
+}
 
-   // Signal processing thread to exit.
-   _running = false;
-   _bufCv.notify_all();
+std::size_t SdrEngine::getChannelizerChannelCount() const
+{
+   return _channelizer.getChannelCount();
+}
 
-   if (_procThread.joinable())
-   {
-      _procThread.join();
-   }
+const Channelizer& SdrEngine::channelizer() const
+{
+   return _channelizer;
+}
 
-   if (_device && _device->isOpen())
-   {
-      _device->close();
-   }
+// ============================================================================
+// Signal detector
+// ============================================================================
 
-   GPINFO("SdrEngine stopped");
+void SdrEngine::setDetectorEnabled(bool enabled)
+{
+   _detectorEnabled        = enabled;
+   _detectorRestartPending = true;
 }
 
-bool SdrEngine::isRunning() const
+bool SdrEngine::isDetectorEnabled() const
 {
-   return _running;
+   return _detectorEnabled;
+}
+
+void SdrEngine::setDetectorConfig(const DetectorConfig& config)
+{
+   _detector.setConfig(config);
+}
+
+DetectorConfig SdrEngine::getDetectorConfig() const
+{
+   return _detector.config();
 }
 
 // ============================================================================
-// Data handlers
+// Display tap
 // ============================================================================
 
-CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& SdrEngine::spectrumDataHandler()
+void SdrEngine::setDisplayTapEnabled(bool enabled)
 {
-   return *_spectrumHandler;
+   _displayTapEnabled = enabled;
+   _displayTap.reset();
 }
 
-CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& SdrEngine::iqDataHandler()
+bool SdrEngine::isDisplayTapEnabled() const
 {
-   return *_iqHandler;
+   return _displayTapEnabled;
 }
 
-CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& SdrEngine::filteredIqDataHandler()
+void SdrEngine::setDisplayTapConfig(const DisplayTapConfig& config)
 {
-   return *_filteredIqHandler;
+   _displayTap.setConfig(config);
+   _displayTapSource = config.source;
+}
+
+DisplayTapConfig SdrEngine::getDisplayTapConfig() const
+{
+   return _displayTap.config();
 }
 
 // ============================================================================
-// Device callback → accumulation buffer
+// Pre-trigger snapshots
 // ============================================================================
 
-void SdrEngine::onIqData(const IqSample* samples, std::size_t numSamples)
+void SdrEngine::configureSnapshots(double historySec, SnapshotStorage storage)
 {
-   // Samples arrive as complex float directly from the device.
-   std::vector<std::complex<float>> chunk(samples, samples + numSamples);
+   _snapshotHistorySec = std::max(historySec, 0.0);
+   _snapshotStorage    = storage;
+}
 
-   // Remove DC offset if enabled (suppresses LO leakage spike).
-   if (_dcSpikeRemovalEnabled && !chunk.empty())
-   {
-      // Calculate mean I and Q.
-      std::complex<float> mean{0.0F, 0.0F};
-      for (const auto& sample : chunk)
-      {
-         mean += sample;
-      }
-      mean /= static_cast<float>(chunk.size());
+double SdrEngine::getSnapshotHistorySec() const
+{
+   return _snapshotHistorySec;
+}
 
-      // Subtract mean from each sample.
-      for (auto& sample : chunk)
-      {
-         sample -= mean;
-      }
+bool SdrEngine::triggerSnapshot(const SnapshotRequest& request)
+{
+   if (!_running || _snapshotRing.capacity() == 0 || request.path.empty())
+   {
+      ++_snapshotsRejected;
+      return false;
    }
 
+   const auto rate       = static_cast<double>(_sampleRateHz.load());
+   const uint64_t trigger = request.triggerTime
+                               ? _snapshotRing.sampleAt(*request.triggerTime, rate)
+                               : _snapshotRing.written();
+   const auto pre  = static_cast<uint64_t>(std::max(request.preSec, 0.0) * rate);
+   const auto post = static_cast<uint64_t>(std::max(request.postSec, 0.0) * rate);
+
+   SnapshotJob job;
+   job.request      = request;
+   job.first        = (trigger > pre) ? trigger - pre : 0;
+   job.end          = trigger + post;
+   job.centerFreqHz = static_cast<double>(_centerFreqHz.load());
+   job.sampleRateHz = rate;
+   if (!_snapshotQueue.tryPush(std::move(job)))
    {
-      const std::lock_guard<std::mutex> lock(_bufMutex);
-      _accumBuf.insert(_accumBuf.end(), chunk.begin(), chunk.end());
+      ++_snapshotsRejected;
+      return false;
    }
-   _bufCv.notify_one();
+   // A window reaching back before the stream started was never captured.
+   _snapshotSamplesLost += (trigger < pre) ? pre - trigger : 0;
+   ++_snapshotsTriggered;
+   return true;
+}
+
+SnapshotStats SdrEngine::getSnapshotStats() const
+{
+   SnapshotStats stats;
+   stats.triggered      = _snapshotsTriggered;
+   stats.rejected       = _snapshotsRejected;
+   stats.completed      = _snapshotsCompleted;
+   stats.failed         = _snapshotsFailed;
+   stats.samplesWritten = _snapshotSamplesWritten;
+   stats.samplesLost    = _snapshotSamplesLost;
+   return stats;
 }
 
 // ============================================================================
-// Processing thread
+// VFOs
 // ============================================================================
 
-void SdrEngine::processingLoop()
+int SdrEngine::addVfo(double centerOffsetHz, double bandwidthHz)
 {
-   GPINFO("Processing thread started");
-
-   std::vector<std::complex<float>> block;
+   const std::lock_guard<std::mutex> lock(_vfoMutex);
+   const int id = _nextVfoId++;
+   auto newVfo  = std::make_shared<Vfo>(id);
+   newVfo->configure(centerOffsetHz, bandwidthHz, static_cast<double>(_sampleRateHz.load()));
+   _vfos.push_back(std::move(newVfo));
+   _vfoCount = _vfos.size();
+   return id;
+}
 
-   while (_running)
+bool SdrEngine::removeVfo(int id)
+{
+   const std::lock_guard<std::mutex> lock(_vfoMutex);
+   const auto it = std::find_if(_vfos.begin(), _vfos.end(),
+                                [id](const auto& v) { return v->getId() == id; });
+   if (it == _vfos.end())
    {
+      return false;
+   }
+   _vfos.erase(it);
+   _vfoCount = _vfos.size();
+   return true;
+}
 
-      {
-         std::unique_lock<std::mutex> lock(_bufMutex);
+std::shared_ptr<Vfo> SdrEngine::vfo(int id) const
+{
+   const std::lock_guard<std::mutex> lock(_vfoMutex);
+   const auto it = std::find_if(_vfos.begin(), _vfos.end(),
+                                [id](const auto& v) { return v->getId() == id; });
+   return (it == _vfos.end()) ? nullptr : *it;
+}
 
-         // Wait until we have enough samples for one FFT frame.
-         // Read size once per iteration — size may change between iterations
-         // if the GUI thread calls setFftSize(), which is fine.
-         const auto needed = static_cast<std::size_t>(_fft.getFftSize());
-         _bufCv.wait(lock, [&] {
-            return _accumBuf.size() >= needed || !_running;
-         });
+std::vector<int> SdrEngine::vfoIds() const
+{
+   const std::lock_guard<std::mutex> lock(_vfoMutex);
+   std::vector<int> ids;
+   ids.reserve(_vfos.size());
+   for (const auto& v : _vfos)
+   {
+      ids.push_back(v->getId());
+   }
+   return ids;
+}
 
-         if (!_running)
-         {
-            break;
-         }
+std::size_t SdrEngine::getVfoCount() const
+{
+   return _vfoCount;
+}
 
-         // Take exactly one FFT frame from the front using the same
-         // size we waited for.
-         block.assign(_accumBuf.begin(),
-                      _accumBuf.begin() + static_cast<std::ptrdiff_t>(needed));
-         _accumBuf.erase(_accumBuf.begin(),
-                         _accumBuf.begin() + static_cast<std::ptrdiff_t>(needed));
-      }
+// ============================================================================
+// Demodulation
+// ============================================================================
 
-      // Publish raw I/Q for constellation viewers.
-      auto iqBuf = std::make_shared<IqBuffer>();
-      iqBuf->samples      = block;
-      iqBuf->centerFreqHz = static_cast<double>(_centerFreqHz.load());
-      iqBuf->sampleRateHz = static_cast<double>(_sampleRateHz.load());
-      iqBuf->timestamp    = std::chrono::steady_clock::now();
-      _iqHandler->signalData(iqBuf);
+DemodExecutor& SdrEngine::demodExecutor()
+{
+   const std::lock_guard<std::mutex> lock(_demodExecutorMutex);
+   if (!_demodExecutor)
+   {
+      _demodExecutor = std::make_unique<DemodExecutor>();
+      GPINFO("SdrEngine: demodulation executor started with {} workers",
+             _demodExecutor->workerCount());
+   }
+   return *_demodExecutor;
+}
 
-      // Channel-filter the I/Q block and publish if enabled.
-      if (_channelFilter.isEnabled())
-      {
-         auto filteredSamples = _channelFilter.process(block);
-         if (!filteredSamples.empty())
-         {
-            auto filteredBuf = std::make_shared<IqBuffer>();
-            filteredBuf->samples      = std::move(filteredSamples);
-            filteredBuf->centerFreqHz = iqBuf->centerFreqHz +
-                                       _channelFilter.getCenterOffset();
-            filteredBuf->sampleRateHz = _channelFilter.getOutputSampleRate();
-            filteredBuf->timestamp    = iqBuf->timestamp;
-            _filteredIqHandler->signalData(filteredBuf);
-         }
-      }
+// ============================================================================
+// Wideband sweep
+// ============================================================================
 
-      // Run the FFT.
-      auto magnitudesDb = _fft.process(block);
+bool SdrEngine::configureSweep(const SweepConfig& config)
+{
+   if (_running)
+   {
+      GPWARN("Cannot configure the sweep while running");
+      return false;
+   }
+   if (!_sweep.configure(config, static_cast<double>(_sampleRateHz.load()), _fft.getFftSize()))
+   {
+      return false;
+   }
+   _sweepConfig = config;
+   GPINFO("Sweep configured: {} - {} Hz in {} steps of {:.0f} Hz", config.startHz, config.stopHz,
+          _sweep.getStepCount(), _sweep.stepWidthHz());
+   return true;
+}
 
-      // Apply FFT averaging (exponential moving average).
-      const float alpha = _fftAlpha.load();
-      if (alpha > 0.0F)
+void SdrEngine::setSweepEnabled(bool enabled)
+{
+   if (_running)
+   {
+      GPWARN("Cannot change sweep mode while running");
+      return;
+   }
+   _sweepEnabled = enabled;
+}
+
+bool SdrEngine::isSweepEnabled() const
+{
+   return _sweepEnabled;
+}
+
+const SpectrumSweep& SdrEngine::sweep() const
+{
+   return _sweep;
+}
+
+SweepStats SdrEngine::getSweepStats() const
+{
+   SweepStats stats;
+   stats.passes       = _sweepPasses.load();
+   stats.stepsPerPass = _sweep.getStepCount();
+   stats.lastPassSec  = static_cast<double>(_sweepLastPassNs.load()) / 1.0e9;
+   stats.meanPassSec  = (stats.passes == 0)
+      ? 0.0
+      : static_cast<double>(_sweepTotalPassNs.load()) / 1.0e9 / static_cast<double>(stats.passes);
+   return stats;
+}
+
+// ============================================================================
+// Start / stop
+// ============================================================================
+
+bool SdrEngine::start(int deviceIndex)
+{
+   if (_running)
+   {
+      GPWARN("SdrEngine already running");
+      return false;
+   }
+   if (!_device)
+   {
+      GPERROR("No SDR device set");
+      return false;
+   }
+
+   // Re-plan the sweep for the current sample rate and FFT size.
+   const bool sweeping = _sweepEnabled;
+   if (sweeping && !_sweep.configure(_sweepConfig, static_cast<double>(_sampleRateHz.load()),
+                                     _fft.getFftSize()))
+   {
+      GPERROR("Sweep mode enabled without a valid sweep configuration");
+      return false;
+   }
+
+   // Open the device.
+   if (!_device->open(deviceIndex))
+   {
+      GPERROR("Failed to open device at index {}", deviceIndex);
+      return false;
+   }
+
+   // Apply cached tuning.
+   std::ignore = _device->setCenterFrequency(_centerFreqHz);
+   std::ignore = _device->setSampleRate(_sampleRateHz);
+
+   // Size the sample ring before either side starts touching it.
+   const std::size_t fftSize = _fft.getFftSize();
+   _ring.reset(std::max({MIN_RING_CAPACITY, fftSize * RING_FRAMES,
+                         sweeping ? _sweep.captureSamples() * 2 : 0}),
+               _ringStorage);
+   _dcState = DcBlockerState{};
+
+   // The snapshot history is allocated here, once; the conditioning stage
+   // only copies into it.
+   const double historySec = sweeping ? 0.0 : _snapshotHistorySec.load();
+   _snapshotRing.reset(
+      static_cast<std::size_t>(std::ceil(historySec * static_cast<double>(_sampleRateHz.load()))),
+      _snapshotStorage);
+   _snapshotsTriggered     = 0;
+   _snapshotsRejected      = 0;
+   _snapshotsCompleted     = 0;
+   _snapshotsFailed        = 0;
+   _snapshotSamplesWritten = 0;
+   _snapshotSamplesLost    = 0;
+
+   _spectrumStats.reset();
+   _spectrumLevels.reset();
+   _zoomStats.reset();
+   _zoom = ZoomWelchState{};
+
+   // Follow any sample-rate change made since configureChannelizer().
+   if (_channelizer.isConfigured())
+   {
+      _channelizer.configure(_channelizer.getChannelCount(),
+                             static_cast<double>(_sampleRateHz.load()),
+                             _channelizer.getTapsPerChannel());
+      _channelizer.reset();
+   }
+   {
+      const std::lock_guard<std::mutex> lock(_vfoMutex);
+      for (const auto& v : _vfos)
+      {
+         v->configure(v->getCenterOffset(), v->getBandwidth(),
+                      static_cast<double>(_sampleRateHz.load()));
+         v->reset();
+      }
+   }
+
+   // Pre-size a few output frames so the first cycles do not allocate.
+   constexpr std::size_t PREFILL_FRAMES = 4;
+   _iqPool.resetStats();
+   _filteredIqPool.resetStats();
+   _channelPool.resetStats();
+   _spectrumPool.resetStats();
+   _zoomSpectrumPool.resetStats();
+   _detectionPool.resetStats();
+   _displayIqPool.resetStats();
+   _displayTap.reset();
+   _iqPool.prefill(PREFILL_FRAMES, [fftSize](IqBuffer& buf) { buf.samples.reserve(fftSize); });
+   _spectrumPool.prefill(PREFILL_FRAMES,
+                         [fftSize](SpectrumData& spec) { spec.magnitudesDb.reserve(fftSize); });
+
+   // Start the pipeline stages, consumers first.
+   _fftQueue.reopen();
+   _filterQueue.reopen();
+   _channelizerQueue.reopen();
+   _vfoQueue.reopen();
+   _detectorQueue.reopen();
+   _snapshotQueue.reopen();
+   _conditioningCounters.reset();
+   _fftCounters.reset();
+   _filterCounters.reset();
+   _channelizerCounters.reset();
+   _vfoCounters.reset();
+   _detectorCounters.reset();
+   _sweepCounters.reset();
+   {
+      const std::lock_guard<std::mutex> lock(_loadControlMutex);
+      _loadControlStats = EngineLoadControlStats{};
+   }
+   _loadControlRestartPending = true;
+   resetLatencyStats();
+   _sweepPasses      = 0;
+   _sweepLastPassNs  = 0;
+   _sweepTotalPassNs = 0;
+   _vfoWorkers =
+      std::make_unique<CommonUtils::WorkerPool>(CommonUtils::WorkerPool::defaultWorkerCount());
+   _running = true;
+   _fftThread          = std::thread(&SdrEngine::fftLoop, this);
+   _filterThread       = std::thread(&SdrEngine::channelFilterLoop, this);
+   _channelizerThread  = std::thread(&SdrEngine::channelizerLoop, this);
+   _vfoThread          = std::thread(&SdrEngine::vfoLoop, this);
+   _detectorThread     = std::thread(&SdrEngine::detectorLoop, this);
+   _snapshotThread     = std::thread(&SdrEngine::snapshotLoop, this);
+   // In sweep mode the sweep stage takes the ring in place of conditioning;
+   // the other stages then idle.
+   _conditioningThread = sweeping ? std::thread(&SdrEngine::sweepLoop, this)
+                                  : std::thread(&SdrEngine::conditioningLoop, this);
+
+   // Start streaming in the device's native format — the callback
+   // converts straight into the sample ring.
+   if (!_device->startRawStreaming([this](const RawIqBlock& block) { onIqData(block); },
+                                   fftSize))
+   {
+      GPERROR("Failed to start streaming");
+      shutdownPipeline();
+      _device->close();
+      return false;
+   }
+
+   GPINFO("SdrEngine started (freq={} Hz, rate={} Hz, fft={})",
+          _centerFreqHz.load(), _sampleRateHz.load(), _fft.getFftSize());
+   return true;
+}
+
+void SdrEngine::stop()
+{
+   if (!_running)
+   {
+      return;
+   }
+
+   // Stop streaming first (blocks until device thread exits).
+   if (_device && _device->isStreaming())
+   {
+      _device->stopStreaming();
+   }
+
+   shutdownPipeline();
+
+   if (_device && _device->isOpen())
+   {
+      _device->close();
+   }
+
+   const uint64_t dropped = _ring.overflowCount();
+   if (dropped > 0)
+   {
+      GPWARN("SdrEngine dropped {} samples (processing fell behind)", dropped);
+   }
+   GPINFO("SdrEngine stopped");
+}
+
+void SdrEngine::shutdownPipeline()
+{
+   _running = false;
+   _ring.interrupt();
+   _fftQueue.close();
+   _filterQueue.close();
+   _channelizerQueue.close();
+   _vfoQueue.close();
+   _detectorQueue.close();
+   _snapshotQueue.close();
+
+   for (auto* thread : {&_conditioningThread, &_fftThread, &_filterThread, &_channelizerThread,
+                        &_vfoThread, &_detectorThread, &_snapshotThread})
+   {
+      if (thread->joinable())
       {
-         const std::lock_guard<std::mutex> lock(_avgMutex);
-         
-         // Initialize averaging buffer on first run or size change.
-         if (_fftAverage.size() != magnitudesDb.size())
+         thread->join();
+      }
+   }
+   _vfoWorkers.reset();
+}
+
+bool SdrEngine::isRunning() const
+{
+   return _running;
+}
+
+void SdrEngine::setSampleRingStorage(IqStorage storage)
+{
+   _ringStorage = storage;
+}
+
+IqStorage SdrEngine::getSampleRingStorage() const
+{
+   return _ringStorage;
+}
+
+uint64_t SdrEngine::getOverflowCount() const
+{
+   return _ring.overflowCount();
+}
+
+EngineFramePoolStats SdrEngine::getFramePoolStats() const
+{
+   return {_iqPool.stats(), _filteredIqPool.stats(), _channelPool.stats(), _spectrumPool.stats(),
+           _zoomSpectrumPool.stats(), _detectionPool.stats(), _displayIqPool.stats()};
+}
+
+PipelineStats SdrEngine::getPipelineStats() const
+{
+   PipelineStats stats;
+   stats.conditioning = _conditioningCounters.snapshot();
+   // The ring holds raw samples; report its backlog in FFT-sized frames.
+   stats.conditioning.queueDepth = _ring.available() / std::max<std::size_t>(_fft.getFftSize(), 1);
+
+   stats.fft = _fftCounters.snapshot();
+   stats.fft.queueDepth     = _fftQueue.size();
+   stats.fft.queueHighWater = _fftQueue.highWaterMark();
+
+   stats.channelFilter = _filterCounters.snapshot();
+   stats.channelFilter.queueDepth     = _filterQueue.size();
+   stats.channelFilter.queueHighWater = _filterQueue.highWaterMark();
+
+   stats.channelizer = _channelizerCounters.snapshot();
+   stats.channelizer.queueDepth     = _channelizerQueue.size();
+   stats.channelizer.queueHighWater = _channelizerQueue.highWaterMark();
+
+   stats.vfos = _vfoCounters.snapshot();
+   stats.vfos.queueDepth     = _vfoQueue.size();
+   stats.vfos.queueHighWater = _vfoQueue.highWaterMark();
+
+   stats.detector = _detectorCounters.snapshot();
+   stats.detector.queueDepth     = _detectorQueue.size();
+   stats.detector.queueHighWater = _detectorQueue.highWaterMark();
+
+   stats.sweep = _sweepCounters.snapshot();
+   return stats;
+}
+
+void SdrEngine::setPublishPolicy(EnginePublisher publisher, CommonUtils::OverflowPolicy policy,
+                                 std::size_t capacity)
+{
+   switch (publisher)
+   {
+   case EnginePublisher::Spectrum:
+      _spectrumHandler->setOverflowPolicy(policy, capacity);
+      break;
+   case EnginePublisher::Sweep:
+      _sweepHandler->setOverflowPolicy(policy, capacity);
+      break;
+   case EnginePublisher::Iq:
+      _iqHandler->setOverflowPolicy(policy, capacity);
+      break;
+   case EnginePublisher::FilteredIq:
+      _filteredIqHandler->setOverflowPolicy(policy, capacity);
+      break;
+   case EnginePublisher::Channelizer:
+   {
+      const std::lock_guard<std::mutex> lock(_channelPolicyMutex);
+      _channelPolicy         = policy;
+      _channelPolicyCapacity = capacity;
+      for (auto& handler : _channelHandlers)
+      {
+         handler->setOverflowPolicy(policy, capacity);
+      }
+      break;
+   }
+   case EnginePublisher::ZoomSpectrum:
+      _zoomSpectrumHandler->setOverflowPolicy(policy, capacity);
+      break;
+   case EnginePublisher::Detections:
+      _detectionHandler->setOverflowPolicy(policy, capacity);
+      break;
+   case EnginePublisher::DisplayIq:
+      _displayIqHandler->setOverflowPolicy(policy, capacity);
+      break;
+   }
+}
+
+EnginePublishStats SdrEngine::getPublishStats() const
+{
+   const auto statsOf = [](const auto& handler) {
+      return PublisherStats{handler.droppedCount(), handler.coalescedCount(), handler.highWaterMark()};
+   };
+
+   EnginePublishStats stats;
+   stats.spectrum   = statsOf(*_spectrumHandler);
+   stats.sweep      = statsOf(*_sweepHandler);
+   stats.iq         = statsOf(*_iqHandler);
+   stats.filteredIq = statsOf(*_filteredIqHandler);
+   stats.zoomSpectrum = statsOf(*_zoomSpectrumHandler);
+   stats.detections   = statsOf(*_detectionHandler);
+   stats.displayIq    = statsOf(*_displayIqHandler);
+
+   const std::lock_guard<std::mutex> lock(_channelPolicyMutex);
+   for (const auto& handler : _channelHandlers)
+   {
+      const PublisherStats channel = statsOf(*handler);
+      stats.channelizer.dropped += channel.dropped;
+      stats.channelizer.coalesced += channel.coalesced;
+      stats.channelizer.queueHighWater =
+         std::max(stats.channelizer.queueHighWater, channel.queueHighWater);
+   }
+   return stats;
+}
+
+EngineHealthStats SdrEngine::getHealthStats() const
+{
+   EngineHealthStats stats;
+   if (_device)
+   {
+      stats.device = _device->getStreamStats();
+   }
+   stats.ringOverflowSamples = _ring.overflowCount();
+   stats.publish             = getPublishStats();
+   stats.memory              = CommonUtils::MemoryRegistry::instance().totals();
+   return stats;
+}
+
+void SdrEngine::logHealthStats() const
+{
+   const EngineHealthStats stats = getHealthStats();
+   const auto& dev = stats.device;
+   if (stats.hasSampleLoss())
+   {
+      GPWARN("Stream health: {} samples in {} reads ({:.0f}/read, {:.0f} S/s), "
+             "{} device overflows, {} timeouts, {} errors, {} samples dropped at the ring, "
+             "{} frames dropped for listeners",
+             dev.samplesReceived, dev.reads, dev.averageReadSize(), dev.achievedSampleRateHz(),
+             dev.overflows, dev.timeouts, dev.errors, stats.ringOverflowSamples,
+             stats.droppedFrames());
+   }
+   else
+   {
+      GPINFO("Stream health: {} samples in {} reads ({:.0f}/read, {:.0f} S/s), "
+             "{} timeouts, {} errors, {} frames dropped for listeners",
+             dev.samplesReceived, dev.reads, dev.averageReadSize(), dev.achievedSampleRateHz(),
+             dev.timeouts, dev.errors, stats.droppedFrames());
+   }
+   CommonUtils::MemoryRegistry::instance().logStats();
+}
+
+// ============================================================================
+// Latency tracing
+// ============================================================================
+
+void SdrEngine::setLatencyTracingEnabled(bool enabled)
+{
+   if (_latencyTracing.exchange(enabled) != enabled)
+   {
+      installLatencyObservers(enabled);
+   }
+}
+
+bool SdrEngine::isLatencyTracingEnabled() const
+{
+   return _latencyTracing;
+}
+
+EngineLatencyStats SdrEngine::getLatencyStats() const
+{
+   return {_spectrumLatency.summary(), _iqLatency.summary(), _filteredIqLatency.summary()};
+}
+
+void SdrEngine::resetLatencyStats()
+{
+   _spectrumLatency.reset();
+   _iqLatency.reset();
+   _filteredIqLatency.reset();
+}
+
+void SdrEngine::logLatencyStats() const
+{
+   const auto logHop = [](const char* stream, const char* hop, const LatencySummary& s) {
+      if (s.count > 0)
+      {
+         GPINFO("Latency {:<11} {:<10} n={:<8} mean={:>9.1f} p50={:>9.1f} p90={:>9.1f} "
+                "p99={:>9.1f} max={:>9.1f} us",
+                stream, hop, s.count, s.meanUs, s.p50Us, s.p90Us, s.p99Us, s.maxUs);
+      }
+   };
+   const auto logStream = [&logHop](const char* stream, const StageLatencyStats& s) {
+      logHop(stream, "ring", s.ringWait);
+      logHop(stream, "processing", s.processing);
+      logHop(stream, "publish", s.publish);
+      logHop(stream, "queueing", s.queueing);
+      logHop(stream, "listeners", s.listeners);
+      logHop(stream, "end-to-end", s.endToEnd);
+   };
+
+   const EngineLatencyStats stats = getLatencyStats();
+   logStream("spectrum", stats.spectrum);
+   logStream("iq", stats.iq);
+   logStream("filtered-iq", stats.filteredIq);
+}
+
+void SdrEngine::installLatencyObservers(bool enabled)
+{
+   using TimePoint = StageTimestamps::TimePoint;
+   if (!enabled)
+   {
+      _spectrumHandler->setDispatchObserver({});
+      _iqHandler->setDispatchObserver({});
+      _filteredIqHandler->setDispatchObserver({});
+      return;
+   }
+
+   _spectrumHandler->setDispatchObserver(
+      [this](const std::shared_ptr<const SpectrumData>& frame, TimePoint start, TimePoint end) {
+         _spectrumLatency.record(frame->stages, start, end);
+      });
+   _iqHandler->setDispatchObserver(
+      [this](const std::shared_ptr<const IqBuffer>& frame, TimePoint start, TimePoint end) {
+         _iqLatency.record(frame->stages, start, end);
+      });
+   _filteredIqHandler->setDispatchObserver(
+      [this](const std::shared_ptr<const IqBuffer>& frame, TimePoint start, TimePoint end) {
+         _filteredIqLatency.record(frame->stages, start, end);
+      });
+}
+
+// ============================================================================
+// Data handlers
+// ============================================================================
+
+CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& SdrEngine::spectrumDataHandler()
+{
+   return *_spectrumHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& SdrEngine::zoomSpectrumDataHandler()
+{
+   return *_zoomSpectrumHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const DetectionReport>>& SdrEngine::detectionDataHandler()
+{
+   return *_detectionHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& SdrEngine::sweepDataHandler()
+{
+   return *_sweepHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& SdrEngine::iqDataHandler()
+{
+   return *_iqHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& SdrEngine::filteredIqDataHandler()
+{
+   return *_filteredIqHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& SdrEngine::displayIqDataHandler()
+{
+   return *_displayIqHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& SdrEngine::channelizerDataHandler(
+   std::size_t channel)
+{
+   return *_channelHandlers.at(channel);
+}
+
+// ============================================================================
+// Device callback → sample ring
+// ============================================================================
+
+void SdrEngine::onIqData(const RawIqBlock& block)
+{
+   // Keep the device thread to a single pass: native samples are converted
+   // (and DC-blocked) directly into the ring's free regions, or for Cs16
+   // storage copied as int16 and left for conditioning to convert.  Samples
+   // that do not fit are dropped and counted.
+   std::size_t written = 0;
+   if (_ring.storage() == IqStorage::Cs16)
+   {
+      const auto regions = _ring.prepareWriteCs16(block.numSamples);
+      const std::size_t head = regions.first.size() / 2;
+      convertToCs16(block, 0, regions.first.data(), head);
+      convertToCs16(block, head, regions.second.data(), regions.second.size() / 2);
+      _ring.setCs16FullScale(cs16FullScale(block));
+      written = regions.size() / 2;
+   }
+   else
+   {
+      const auto regions = _ring.prepareWrite(block.numSamples);
+      if (_dcSpikeRemovalEnabled)
+      {
+         _dcState.alpha =
+            dcBlockerAlpha(_dcTimeConstantSec, static_cast<double>(_sampleRateHz.load()));
+         convertToIqDcBlocked(block, 0, regions.first.data(), regions.first.size(), _dcState);
+         convertToIqDcBlocked(block, regions.first.size(), regions.second.data(),
+                              regions.second.size(), _dcState);
+      }
+      else
+      {
+         convertToIq(block, 0, regions.first.data(), regions.first.size());
+         convertToIq(block, regions.first.size(), regions.second.data(), regions.second.size());
+      }
+      written = regions.size();
+   }
+
+   if (_latencyTracing.load(std::memory_order_relaxed))
+   {
+      _ring.commitWrite(written, std::chrono::steady_clock::now());
+   }
+   else
+   {
+      _ring.commitWrite(written);
+   }
+   if (written < block.numSamples)
+   {
+      _ring.recordOverflow(block.numSamples - written);
+   }
+}
+
+void SdrEngine::readRing(IqSample* dst, std::size_t count)
+{
+   if (_ring.storage() == IqStorage::Cf32 || !_dcSpikeRemovalEnabled)
+   {
+      std::ignore = _ring.read(dst, count);
+      return;
+   }
+
+   // Convert and DC-block in one pass, as onIqData() does for Cf32 storage.
+   _dcState.alpha = dcBlockerAlpha(_dcTimeConstantSec, static_cast<double>(_sampleRateHz.load()));
+   const auto regions     = _ring.peekCs16(count);
+   const float fullScale  = _ring.cs16FullScale();
+   const std::size_t head = regions.first.size() / 2;
+   const RawIqBlock first{regions.first.data(), IqSampleFormat::CS16, head, fullScale};
+   const RawIqBlock second{regions.second.data(), IqSampleFormat::CS16,
+                           regions.second.size() / 2, fullScale};
+   convertToIqDcBlocked(first, 0, dst, first.numSamples, _dcState);
+   convertToIqDcBlocked(second, 0, dst + head, second.numSamples, _dcState);
+   _ring.consume(regions.size() / 2);
+}
+
+// ============================================================================
+// Pipeline stages
+// ============================================================================
+
+void SdrEngine::conditioningLoop()
+{
+   GPINFO("Conditioning stage started");
+   CommonUtils::configureCurrentThread(_name + ".conditioning");
+
+   while (_running)
+   {
+      // Wait until we have enough samples for one FFT frame.  Read the
+      // size once per iteration — the GUI thread may call setFftSize()
+      // between iterations, which is fine.
+      const auto needed = std::min(_fft.getFftSize(), _ring.capacity());
+      if (!_ring.waitForSamples(needed) || !_running)
+      {
+         break;
+      }
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::conditioningLoop");
+
+      // Take exactly one FFT frame straight into a pooled buffer.
+      auto iqBuf = _iqPool.acquire();
+      iqBuf->samples.resize(needed);
+      readRing(iqBuf->samples.data(), needed);
+      _snapshotRing.write(iqBuf->samples.data(), needed, began);
+
+      iqBuf->centerFreqHz = static_cast<double>(_centerFreqHz.load());
+      iqBuf->sampleRateHz = static_cast<double>(_sampleRateHz.load());
+      iqBuf->timestamp    = began;
+      iqBuf->stages       = {};
+      if (_latencyTracing.load(std::memory_order_relaxed))
+      {
+         iqBuf->stages.deviceRead  = _ring.lastReadArrival();
+         iqBuf->stages.ringDequeue = began;
+         iqBuf->stages.processed   = std::chrono::steady_clock::now();
+         iqBuf->stages.published   = iqBuf->stages.processed;
+      }
+
+      // Publish raw I/Q for constellation viewers.
+      const std::shared_ptr<const IqBuffer> frame = std::move(iqBuf);
+      _iqHandler->signalData(frame);
+      tapForDisplay(*frame, DisplayTapSource::Wideband);
+      _conditioningCounters.record(std::chrono::steady_clock::now() - began);
+
+      // Fan out to the downstream stages.  push() blocks while a stage is
+      // behind; that back-pressure is absorbed by the sample ring.
+      if (_channelFilter.isEnabled() && !_filterQueue.push(frame))
+      {
+         break;
+      }
+      if (_channelizer.isEnabled() && !_channelizerQueue.push(frame))
+      {
+         break;
+      }
+      if (_vfoCount > 0 && !_vfoQueue.push(frame))
+      {
+         break;
+      }
+      if (!_fftQueue.push(frame))
+      {
+         break;
+      }
+   }
+
+   GPINFO("Conditioning stage exiting");
+}
+
+void SdrEngine::channelFilterLoop()
+{
+   GPINFO("Channel-filter stage started");
+   CommonUtils::configureCurrentThread(_name + ".channelFilter");
+
+   while (auto frame = _filterQueue.pop())
+   {
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::channelFilterLoop");
+      const IqBuffer& in = **frame;
+
+      // Filter straight into a pooled frame; an empty result just goes
+      // back to the pool.
+      auto filteredBuf = _filteredIqPool.acquire();
+      _channelFilter.process(in.samples, filteredBuf->samples);
+      if (!filteredBuf->samples.empty())
+      {
+         filteredBuf->centerFreqHz = in.centerFreqHz + _channelFilter.getCenterOffset();
+         filteredBuf->sampleRateHz = _channelFilter.getOutputSampleRate();
+         filteredBuf->timestamp    = in.timestamp;
+         filteredBuf->stages       = in.stages;
+         if (in.stages.isTraced())
+         {
+            filteredBuf->stages.processed = std::chrono::steady_clock::now();
+            filteredBuf->stages.published = filteredBuf->stages.processed;
+         }
+         if (_zoomFftEnabled)
+         {
+            zoomFft(*filteredBuf);
+         }
+         const std::shared_ptr<const IqBuffer> filtered = std::move(filteredBuf);
+         _filteredIqHandler->signalData(filtered);
+         tapForDisplay(*filtered, DisplayTapSource::ChannelFilter);
+      }
+      _filterCounters.record(std::chrono::steady_clock::now() - began);
+   }
+
+   GPINFO("Channel-filter stage exiting");
+}
+
+void SdrEngine::tapForDisplay(const IqBuffer& frame, DisplayTapSource source)
+{
+   if (!_displayTapEnabled || _displayTapSource != source)
+   {
+      return;
+   }
+   if (auto display = _displayTap.process(frame, _displayIqPool))
+   {
+      _displayIqHandler->signalData(std::move(display));
+   }
+}
+
+void SdrEngine::zoomFft(const IqBuffer& filtered)
+{
+   GPPROFILE_SCOPE("SdrEngine::zoomFft");
+   ZoomWelchState& zoom = _zoom;
+
+   // A new channel, a retune or a pause of the filter starts over.
+   if (_zoomRestartPending.exchange(false) || filtered.centerFreqHz != zoom.centerFreqHz ||
+       filtered.sampleRateHz != zoom.sampleRateHz)
+   {
+      zoom.history.clear();
+      zoom.powerSum.clear();
+      zoom.segments            = 0;
+      zoom.samplesSincePublish = 0.0;
+      zoom.centerFreqHz        = filtered.centerFreqHz;
+      zoom.sampleRateHz        = filtered.sampleRateHz;
+      _zoomStats.reset();
+   }
+   zoom.history.insert(zoom.history.end(), filtered.samples.begin(), filtered.samples.end());
+
+   // Same Welch framing as fftLoop(), at the channel rate.
+   const std::size_t segmentLen = _zoomFft.getFftSize();
+   const std::size_t maxBatch   = _zoomFft.maxBatchFrames();
+   const float overlap = _fftOverlapPercent.load() / 100.0F;
+   const std::size_t hop = std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::lround(static_cast<float>(segmentLen) * (1.0F - overlap))));
+
+   const float outputRate = _spectrumOutputRate.load();
+   const double publishInterval =
+      (outputRate > 0.0F) ? zoom.sampleRateHz / static_cast<double>(outputRate) : 0.0;
+
+   std::size_t segStart = 0;
+   while (segStart + segmentLen <= zoom.history.size())
+   {
+      const std::size_t ready = ((zoom.history.size() - segStart - segmentLen) / hop) + 1;
+      const std::size_t batch = std::min(ready, maxBatch);
+      _zoomFft.processPowerBatch(std::span<const IqSample>(zoom.history).subspan(segStart), batch,
+                                 hop, zoom.segmentPower);
+      segStart += batch * hop;
+
+      // Zoom FFT size changed under us — restart the average.
+      const std::size_t bins = zoom.segmentPower.size() / batch;
+      if (zoom.powerSum.size() != bins)
+      {
+         zoom.powerSum.assign(bins, 0.0F);
+         zoom.segments            = 0;
+         zoom.samplesSincePublish = 0.0;
+      }
+
+      for (std::size_t b = 0; b < batch; ++b)
+      {
+         const float* row = zoom.segmentPower.data() + (b * bins);
+         for (std::size_t i = 0; i < bins; ++i)
+         {
+            zoom.powerSum[i] += row[i];
+         }
+         ++zoom.segments;
+         zoom.samplesSincePublish += static_cast<double>(hop);
+
+         if (zoom.samplesSincePublish >= publishInterval)
+         {
+            publishZoomSpectrum(filtered.stages);
+            std::fill(zoom.powerSum.begin(), zoom.powerSum.end(), 0.0F);
+            zoom.segments            = 0;
+            zoom.samplesSincePublish = 0.0;
+         }
+      }
+   }
+
+   zoom.history.erase(zoom.history.begin(),
+                      zoom.history.begin() +
+                         static_cast<std::ptrdiff_t>(std::min(segStart, zoom.history.size())));
+}
+
+void SdrEngine::publishZoomSpectrum(const StageTimestamps& source)
+{
+   auto spectrum = _zoomSpectrumPool.acquire();
+   spectrum->stages = source;
+   if (source.isTraced())
+   {
+      spectrum->stages.processed = std::chrono::steady_clock::now();
+   }
+
+   // The channel sits at DC of the filtered stream, so there is no DC
+   // spike to suppress, and no holds or pyramid: the frame is small.
+   const float invSegments = 1.0F / static_cast<float>(std::max<std::size_t>(_zoom.segments, 1));
+   _zoomStats.computeDb(_zoom.powerSum, invSegments, spectrum->magnitudesDb);
+   spectrum->centerFreqHz = _zoom.centerFreqHz;
+   spectrum->bandwidthHz  = _zoom.sampleRateHz;
+   spectrum->fftSize      = spectrum->magnitudesDb.size();
+
+   if (source.isTraced())
+   {
+      spectrum->stages.published = std::chrono::steady_clock::now();
+   }
+   _zoomSpectrumHandler->signalData(std::move(spectrum));
+}
+
+void SdrEngine::channelizerLoop()
+{
+   GPINFO("Channelizer stage started");
+   CommonUtils::configureCurrentThread(_name + ".channelizer");
+
+   // Per-channel scratch, reused across frames.
+   std::vector<std::vector<IqSample>> channelSamples;
+
+   while (auto frame = _channelizerQueue.pop())
+   {
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::channelizerLoop");
+      const IqBuffer& in = **frame;
+
+      _channelizer.process(in.samples, channelSamples);
+      StageTimestamps stages = in.stages;
+      if (stages.isTraced())
+      {
+         stages.processed = std::chrono::steady_clock::now();
+         stages.published = stages.processed;
+      }
+      const double outputRate = _channelizer.getOutputSampleRate();
+      const std::size_t channels = std::min(channelSamples.size(), _channelHandlers.size());
+      for (std::size_t c = 0; c < channels; ++c)
+      {
+         if (channelSamples[c].empty())
+         {
+            continue;
+         }
+         auto channelBuf = _channelPool.acquire();
+         channelBuf->samples.assign(channelSamples[c].begin(), channelSamples[c].end());
+         channelBuf->centerFreqHz = in.centerFreqHz + _channelizer.getChannelOffset(c);
+         channelBuf->sampleRateHz = outputRate;
+         channelBuf->timestamp    = in.timestamp;
+         channelBuf->stages       = stages;
+         _channelHandlers[c]->signalData(std::move(channelBuf));
+      }
+      _channelizerCounters.record(std::chrono::steady_clock::now() - began);
+   }
+
+   GPINFO("Channelizer stage exiting");
+}
+
+void SdrEngine::vfoLoop()
+{
+   GPINFO("VFO stage started ({} workers)", _vfoWorkers->workerCount());
+   CommonUtils::configureCurrentThread(_name + ".vfo");
+
+   // Snapshot of the VFO list, reused across frames.  Holding shared_ptrs
+   // lets removeVfo() run while a frame is in flight.
+   std::vector<std::shared_ptr<Vfo>> active;
+
+   while (auto frame = _vfoQueue.pop())
+   {
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::vfoLoop");
+      {
+         const std::lock_guard<std::mutex> lock(_vfoMutex);
+         active.assign(_vfos.begin(), _vfos.end());
+      }
+
+      const IqBuffer& in = **frame;
+      _vfoWorkers->run(active.size(), [&active, &in](std::size_t i) { active[i]->process(in); });
+      active.clear();
+      _vfoCounters.record(std::chrono::steady_clock::now() - began);
+   }
+
+   GPINFO("VFO stage exiting");
+}
+
+void SdrEngine::detectorLoop()
+{
+   GPINFO("Detector stage started");
+   CommonUtils::configureCurrentThread(_name + ".detector");
+
+   while (auto frame = _detectorQueue.pop())
+   {
+      // Behind: only the newest spectrum matters, the events track across
+      // whatever frames were skipped.
+      std::size_t taken = 1;
+      while (auto newer = _detectorQueue.tryPop())
+      {
+         frame = std::move(newer);
+         ++taken;
+      }
+
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::detectorLoop");
+      if (_detectorRestartPending.exchange(false))
+      {
+         _detector.reset();
+      }
+
+      auto report = _detectionPool.acquire();
+      if (_detector.process(**frame, *report, began))
+      {
+         _detectionHandler->signalData(std::move(report));
+      }
+      _detectorCounters.record(std::chrono::steady_clock::now() - began, taken);
+   }
+
+   GPINFO("Detector stage exiting");
+}
+
+void SdrEngine::snapshotLoop()
+{
+   GPINFO("Snapshot stage started");
+   CommonUtils::configureCurrentThread(_name + ".snapshot");
+
+   IqBuffer chunk;   // Reused across snapshots.
+   while (auto job = _snapshotQueue.pop())
+   {
+      IqRecorder recorder;
+      if (!recorder.start(job->request.path, job->request.format))
+      {
+         GPERROR("Snapshot: cannot create {}", job->request.path);
+         ++_snapshotsFailed;
+         continue;
+      }
+      chunk.centerFreqHz = job->centerFreqHz;
+      chunk.sampleRateHz = job->sampleRateHz;
+
+      // Write what is captured now; wait for the rest of the window.
+      uint64_t pos = job->first;
+      while (pos < job->end)
+      {
+         const uint64_t available = _snapshotRing.written();
+         if (pos >= available)
+         {
+            if (!_running)
+            {
+               break;   // Stopped: the rest of the window never arrives.
+            }
+            std::this_thread::sleep_for(SNAPSHOT_POLL);
+            continue;
+         }
+         const auto count = static_cast<std::size_t>(
+            std::min<uint64_t>({SNAPSHOT_CHUNK_SAMPLES, available - pos, job->end - pos}));
+         chunk.samples.resize(count);
+         const std::size_t lost = _snapshotRing.read(pos, chunk.samples.data(), count);
+         chunk.samples.erase(chunk.samples.begin(),
+                             chunk.samples.begin() + static_cast<std::ptrdiff_t>(lost));
+         recorder.writeWaiting(chunk);
+         _snapshotSamplesWritten += count - lost;
+         _snapshotSamplesLost += lost;
+         pos += count;
+      }
+      _snapshotSamplesLost += job->end - pos;
+      recorder.stop();
+      ++_snapshotsCompleted;
+      GPINFO("Snapshot written to {} ({} samples)", job->request.path,
+             recorder.stats().samplesWritten);
+   }
+
+   GPINFO("Snapshot stage exiting");
+}
+
+void SdrEngine::fftLoop()
+{
+   GPINFO("FFT stage started");
+   CommonUtils::configureCurrentThread(_name + ".fft");
+
+   // Welch state: samples not yet fully covered by a segment, the latest
+   // segment's power, and the running power sum since the last publication.
+   std::vector<IqSample> segmentHistory;
+   std::vector<float> segmentPower;
+   std::vector<float> powerSum;
+   std::size_t segmentsAveraged    = 0;
+   double samplesSincePublish      = 0.0;
+   StageTimestamps newestStages;
+
+   while (auto frame = _fftQueue.pop())
+   {
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::fftLoop");
+
+      // Welch framing: slide FFT segments across the new samples at the
+      // configured hop, summing linear power until the next publication.
+      // If the stage fell behind, drain the backlog now so the segments
+      // below are transformed in large batches.
+      std::size_t framesTaken = 1;
+      segmentHistory.insert(segmentHistory.end(), (*frame)->samples.begin(),
+                            (*frame)->samples.end());
+      newestStages = (*frame)->stages;
+      frame.reset();
+      while (framesTaken < STAGE_QUEUE_DEPTH)
+      {
+         auto next = _fftQueue.tryPop();
+         if (!next)
          {
-            _fftAverage = magnitudesDb;
+            break;
          }
-         else
+         segmentHistory.insert(segmentHistory.end(), (*next)->samples.begin(),
+                               (*next)->samples.end());
+         newestStages = (*next)->stages;
+         ++framesTaken;
+      }
+
+      // The load controller may run with less overlap or a lower rate
+      // than requested.
+      const FftLoadSettings requested{_fftOverlapPercent.load(), _spectrumOutputRate.load(), 1};
+      if (_loadControlRestartPending.exchange(false))
+      {
+         restartLoadControl(requested);
+      }
+      const FftLoadSettings settings =
+         _loadControlEnabled ? _loadController.apply(requested) : requested;
+
+      const std::size_t segmentLen = _fft.getFftSize();
+      const std::size_t maxBatch   = _fft.maxBatchFrames();
+      const float overlap = settings.overlapPercent / 100.0F;
+      const std::size_t hop = std::max<std::size_t>(
+         1, static_cast<std::size_t>(std::lround(static_cast<float>(segmentLen) * (1.0F - overlap))));
+
+      const float outputRate = settings.outputRate;
+      const double publishInterval = (outputRate > 0.0F)
+         ? static_cast<double>(_sampleRateHz.load()) / static_cast<double>(outputRate)
+         : 0.0;
+
+      std::size_t segStart = 0;
+      while (segStart + segmentLen <= segmentHistory.size())
+      {
+         const std::size_t ready = ((segmentHistory.size() - segStart - segmentLen) / hop) + 1;
+         const std::size_t batch = std::min(ready, maxBatch);
+         _fft.processPowerBatch(std::span<const IqSample>(segmentHistory).subspan(segStart),
+                                batch, hop, segmentPower);
+         segStart += batch * hop;
+
+         // FFT size changed under us — restart the average.
+         const std::size_t bins = segmentPower.size() / batch;
+         if (powerSum.size() != bins)
+         {
+            powerSum.assign(bins, 0.0F);
+            segmentsAveraged    = 0;
+            samplesSincePublish = 0.0;
+         }
+
+         for (std::size_t b = 0; b < batch; ++b)
          {
-            // EMA: avg[n] = alpha * avg[n-1] + (1 - alpha) * new[n]
-            for (std::size_t i = 0; i < magnitudesDb.size(); ++i)
+            const float* row = segmentPower.data() + (b * bins);
+            for (std::size_t i = 0; i < bins; ++i)
             {
-               _fftAverage[i] = (alpha * _fftAverage[i]) + ((1.0F - alpha) * magnitudesDb[i]);
+               powerSum[i] += row[i];
+            }
+            ++segmentsAveraged;
+            samplesSincePublish += static_cast<double>(hop);
+
+            if (samplesSincePublish >= publishInterval)
+            {
+               publishSpectrum(powerSum, segmentsAveraged,
+                               samplesSincePublish / static_cast<double>(_sampleRateHz.load()),
+                               newestStages);
+               std::fill(powerSum.begin(), powerSum.end(), 0.0F);
+               segmentsAveraged    = 0;
+               samplesSincePublish = 0.0;
             }
-            magnitudesDb = _fftAverage;
          }
       }
 
-      // Suppress center bin DC spike if enabled (interpolate from neighbors).
-      if (_dcSpikeRemovalEnabled && magnitudesDb.size() > 2)
+      // Keep the samples the next segment still needs (< one FFT).
+      segmentHistory.erase(segmentHistory.begin(),
+                           segmentHistory.begin() +
+                              static_cast<std::ptrdiff_t>(std::min(segStart, segmentHistory.size())));
+      _fftCounters.record(std::chrono::steady_clock::now() - began, framesTaken);
+      if (_loadControlEnabled)
+      {
+         controlLoad(requested, hop);
+      }
+   }
+
+   GPINFO("FFT stage exiting");
+}
+
+void SdrEngine::restartLoadControl(const FftLoadSettings& requested)
+{
+   const std::lock_guard<std::mutex> lock(_loadControlMutex);
+   _loadController.configure(_loadControlConfig);
+   _displayTap.setBudgetDivisor(1);
+   _loadControlStats.utilization = 0.0;
+   _loadControlStats.level       = 0;
+   _loadControlStats.effective   = requested;
+}
+
+void SdrEngine::controlLoad(const FftLoadSettings& requested, std::size_t hop)
+{
+   FftLoadInput input;
+   input.fft              = _fftCounters.snapshot();
+   input.fft.queueDepth   = _fftQueue.size();
+   input.conditioning     = _conditioningCounters.snapshot();
+   input.requested        = requested;
+   input.segmentRateHz    = static_cast<double>(_sampleRateHz.load()) / static_cast<double>(hop);
+   input.displayTapActive = _displayTapEnabled;
+   const auto adjustment  = _loadController.update(input, std::chrono::steady_clock::now());
+
+   const std::lock_guard<std::mutex> lock(_loadControlMutex);
+   _loadControlStats.utilization = _loadController.utilization();
+   _loadControlStats.level       = _loadController.level();
+   _loadControlStats.effective   = _loadController.apply(requested);
+   if (!adjustment)
+   {
+      return;
+   }
+   _displayTap.setBudgetDivisor(adjustment->after.displayDivisor);
+   _loadControlStats.lastAdjustment = adjustment;
+   ++(adjustment->degraded ? _loadControlStats.degradations : _loadControlStats.restorations);
+
+   const FftLoadSettings& from = adjustment->before;
+   const FftLoadSettings& to   = adjustment->after;
+   std::string change;
+   switch (adjustment->knob)
+   {
+      case FftLoadKnob::Overlap:
+         change = fmt::format("overlap {:.1f} % -> {:.1f} %", from.overlapPercent,
+                              to.overlapPercent);
+         break;
+      case FftLoadKnob::OutputRate:
+         change = (from.outputRate > 0.0F)
+                     ? fmt::format("spectrum rate {:.1f} -> {:.1f} Hz", from.outputRate,
+                                   to.outputRate)
+                     : fmt::format("spectrum rate every segment -> {:.1f} Hz", to.outputRate);
+         break;
+      case FftLoadKnob::DisplayTap:
+         change = fmt::format("display tap budget 1/{} -> 1/{}", from.displayDivisor,
+                              to.displayDivisor);
+         break;
+   }
+   if (adjustment->degraded)
+   {
+      GPWARN("FFT load {:.0f} % (backlog {} frames): lowering {}", 100.0 * adjustment->utilization,
+             adjustment->backlog, change);
+   }
+   else
+   {
+      GPINFO("FFT load {:.0f} %: restoring {}", 100.0 * adjustment->utilization, change);
+   }
+}
+
+void SdrEngine::publishSpectrum(const std::vector<float>& powerSum, std::size_t segments,
+                                double elapsedSec, const StageTimestamps& source)
+{
+   auto spectrum = _spectrumPool.acquire();
+   spectrum->stages = source;
+   if (source.isTraced())
+   {
+      spectrum->stages.processed = std::chrono::steady_clock::now();
+   }
+   auto& magnitudesDb = spectrum->magnitudesDb;
+
+   // Mean power, averaged across frames in linear power, then → dB.
+   const float invSegments = 1.0F / static_cast<float>(std::max<std::size_t>(segments, 1));
+   _spectrumStats.computeDb(powerSum, invSegments, magnitudesDb);
+
+   // Suppress center bin DC spike if enabled (interpolate from neighbors).
+   if (_dcSpikeRemovalEnabled && magnitudesDb.size() > 2)
+   {
+      const std::size_t centerBin = magnitudesDb.size() / 2;
+      // Interpolate center bin from immediate neighbors.
+      if (centerBin > 0 && centerBin < magnitudesDb.size() - 1)
+      {
+         magnitudesDb[centerBin] = (magnitudesDb[centerBin - 1] + magnitudesDb[centerBin + 1]) / 2.0F;
+      }
+   }
+
+   // Publish spectrum data (full resolution — consumers decimate as needed).
+   spectrum->centerFreqHz  = static_cast<double>(_centerFreqHz.load());
+   spectrum->bandwidthHz   = static_cast<double>(_sampleRateHz.load());
+   spectrum->fftSize       = magnitudesDb.size();
+
+   // Noise floor and band power, measured on what is published.
+   _spectrumLevels.update(*spectrum, powerSum, invSegments, _spectrumStats.getAverageAlpha(),
+                          elapsedSec);
+
+   // Peak / minimum hold traces continue from the previous frame.
+   _spectrumStats.updateHolds(spectrum, elapsedSec);
+   if (_spectrumPyramidEnabled)
+   {
+      buildSpectrumPyramid(*spectrum, SPECTRUM_PYRAMID_MIN_POINTS);
+   }
+   else
+   {
+      spectrum->tiers.clear();
+   }
+   if (source.isTraced())
+   {
+      spectrum->stages.published = std::chrono::steady_clock::now();
+   }
+   std::shared_ptr<const SpectrumData> published = std::move(spectrum);
+   if (_detectorEnabled)
+   {
+      // Never waits: a full queue means the detector is behind and will
+      // skip ahead anyway.
+      std::ignore = _detectorQueue.tryPush(published);
+   }
+   _spectrumHandler->signalData(std::move(published));
+}
+
+// ============================================================================
+// Sweep stage
+// ============================================================================
+
+void SdrEngine::sweepLoop()
+{
+   GPINFO("Sweep stage started ({} steps of {:.0f} Hz)", _sweep.getStepCount(),
+          _sweep.stepWidthHz());
+   CommonUtils::configureCurrentThread(_name + ".sweep");
+
+   constexpr float POWER_FLOOR = 1.0e-30F;
+   const std::size_t steps    = _sweep.getStepCount();
+   const std::size_t averages = _sweep.config().averages;
+   const std::size_t fftSize  = _sweep.captureSamples() / averages;
+   // A one-step "sweep" never retunes, so there is nothing to settle.
+   const std::size_t settle = (steps > 1) ? _sweep.settleSamples() : 0;
+
+   std::vector<IqSample> capture(_sweep.captureSamples());
+   std::vector<float> segmentPower;
+   std::vector<float> stepDb(fftSize);
+
+   auto frame = _sweepPool.acquire();
+   _sweep.beginPass(*frame);
+   auto passBegan      = std::chrono::steady_clock::now();
+   std::size_t step    = 0;
+   std::size_t discard = retuneForSweep(0);
+
+   while (_running)
+   {
+      // Drop what predates the retune plus the settling time, then capture.
+      if (!discardSamples(discard + settle) || !_ring.waitForSamples(capture.size()) ||
+          !_running)
       {
-         const std::size_t centerBin = magnitudesDb.size() / 2;
-         // Interpolate center bin from immediate neighbors.
-         if (centerBin > 0 && centerBin < magnitudesDb.size() - 1)
+         break;
+      }
+      readRing(capture.data(), capture.size());
+      const auto began = std::chrono::steady_clock::now();
+      GPPROFILE_SCOPE("SdrEngine::sweepLoop");
+
+      // Retune straight away so the hardware settles while this step is
+      // processed; samples keep arriving in the ring meanwhile.
+      const std::size_t next = (step + 1) % steps;
+      discard = (next != step) ? retuneForSweep(next) : 0;
+
+      // Welch average of the step's segments → dB.
+      _fft.processPowerBatch(capture, averages, fftSize, segmentPower);
+      if (segmentPower.size() != averages * fftSize)
+      {
+         GPWARN("FFT size changed during the sweep; stopping sweep stage");
+         break;
+      }
+      std::copy(segmentPower.begin(),
+                segmentPower.begin() + static_cast<std::ptrdiff_t>(fftSize), stepDb.begin());
+      for (std::size_t a = 1; a < averages; ++a)
+      {
+         const float* row = segmentPower.data() + (a * fftSize);
+         for (std::size_t i = 0; i < fftSize; ++i)
          {
-            magnitudesDb[centerBin] = (magnitudesDb[centerBin - 1] + magnitudesDb[centerBin + 1]) / 2.0F;
+            stepDb[i] += row[i];
          }
       }
+      powerToDb(stepDb.data(), stepDb.data(), fftSize,
+                1.0F / static_cast<float>(averages), POWER_FLOOR);
+
+      // Each step has its own DC spike at its centre bin.
+      if (_dcSpikeRemovalEnabled && fftSize > 2)
+      {
+         const std::size_t centerBin = fftSize / 2;
+         stepDb[centerBin] = (stepDb[centerBin - 1] + stepDb[centerBin + 1]) / 2.0F;
+      }
+      _sweep.addStep(step, stepDb, *frame);
+      _sweepCounters.record(std::chrono::steady_clock::now() - began);
 
-      // Publish spectrum data (full resolution — consumers decimate as needed).
-      auto spectrum = std::make_shared<SpectrumData>();
-      spectrum->magnitudesDb  = std::move(magnitudesDb);
-      spectrum->centerFreqHz  = static_cast<double>(_centerFreqHz.load());
-      spectrum->bandwidthHz   = static_cast<double>(_sampleRateHz.load());
-      spectrum->fftSize       = _fft.getFftSize();
-      _spectrumHandler->signalData(spectrum);
-      block.clear();
+      if (next == 0)
+      {
+         const auto now = std::chrono::steady_clock::now();
+         const auto passNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - passBegan).count());
+         _sweepLastPassNs = passNs;
+         _sweepTotalPassNs.fetch_add(passNs);
+         ++_sweepPasses;
+         _sweepHandler->signalData(std::shared_ptr<const SpectrumData>(std::move(frame)));
+
+         frame = _sweepPool.acquire();
+         _sweep.beginPass(*frame);
+         passBegan = now;
+      }
+      step = next;
    }
 
-   GPINFO("Processing thread exiting");
+   GPINFO("Sweep stage exiting");
+}
+
+std::size_t SdrEngine::retuneForSweep(std::size_t step)
+{
+   if (!_device->setCenterFrequency(_sweep.stepFrequency(step)))
+   {
+      GPWARN("Sweep retune to {} Hz failed", _sweep.stepFrequency(step));
+   }
+   return _ring.available();
+}
+
+bool SdrEngine::discardSamples(std::size_t count)
+{
+   while (count > 0)
+   {
+      if (!_ring.waitForSamples(1) || !_running)
+      {
+         return false;
+      }
+      const std::size_t n = std::min(count, _ring.available());
+      _ring.consume(n);
+      count -= n;
+   }
+   return true;
 }
 
 } // namespace SdrEngine
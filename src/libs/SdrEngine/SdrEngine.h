@@ -2,44 +2,258 @@
 #define SDRENGINE_H_
 
 // Project headers
+#include "BoundedQueue.h"
 #include "ChannelFilter.h"
+#include "Channelizer.h"
 #include "DataHandler.h"
+#include "DemodExecutor.h"
+#include "DisplayIqTap.h"
+#include "DspKernels.h"
+#include "FftLoadController.h"
 #include "FftProcessor.h"
+#include "FramePool.h"
 #include "ISdrDevice.h"
+#include "IqRecorder.h"
+#include "IqSampleRing.h"
+#include "IqSnapshotRing.h"
+#include "MemoryBudget.h"
+#include "PipelineStats.h"
 #include "SdrTypes.h"
+#include "SignalDetector.h"
+#include "SpectrumLevelEstimator.h"
+#include "SpectrumStatistics.h"
+#include "SpectrumSweep.h"
+#include "StageLatencyHistograms.h"
+#include "Vfo.h"
+#include "WorkerPool.h"
 
 // System headers
 #include <atomic>
+#include <chrono>
 #include <complex>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
 #include <vector>
 
 namespace SdrEngine
 {
 
+/**
+ * @class EngineFramePoolStats
+ * @brief Recycling statistics for each of the engine's frame pools.
+ */
+struct EngineFramePoolStats
+{
+   FramePoolStats iq;           ///< Raw IqBuffer frames.
+   FramePoolStats filteredIq;   ///< Channel-filtered IqBuffer frames.
+   FramePoolStats channelizer;  ///< Per-channel filterbank IqBuffer frames.
+   FramePoolStats spectrum;     ///< SpectrumData frames.
+   FramePoolStats zoomSpectrum; ///< Zoom-FFT SpectrumData frames.
+   FramePoolStats detections;   ///< DetectionReport frames.
+   FramePoolStats displayIq;    ///< Display tap IqBuffer frames.
+};
+
+/**
+ * @brief Output streams whose DataHandler overflow policy SdrEngine manages.
+ */
+enum class EnginePublisher : std::uint8_t
+{
+   Spectrum,     ///< spectrumDataHandler()
+   Sweep,        ///< sweepDataHandler()
+   Iq,           ///< iqDataHandler()
+   FilteredIq,   ///< filteredIqDataHandler()
+   Channelizer,  ///< Every channelizerDataHandler(c)
+   ZoomSpectrum, ///< zoomSpectrumDataHandler()
+   Detections,   ///< detectionDataHandler()
+   DisplayIq     ///< displayIqDataHandler()
+};
+
+/**
+ * @class PublisherStats
+ * @brief Backpressure counters of one engine output stream.
+ */
+struct PublisherStats
+{
+   uint64_t dropped{0};             ///< Frames discarded by the overflow policy.
+   uint64_t coalesced{0};           ///< Of those, frames superseded by a newer one (latest-only).
+   std::size_t queueHighWater{0};   ///< Deepest listener backlog seen, in frames.
+};
+
+/**
+ * @class EnginePublishStats
+ * @brief Backpressure counters for each of the engine's output streams.
+ * Channelizer counters are summed over all channels (high-water: maximum).
+ */
+struct EnginePublishStats
+{
+   PublisherStats spectrum;
+   PublisherStats sweep;
+   PublisherStats iq;
+   PublisherStats filteredIq;
+   PublisherStats channelizer;
+   PublisherStats zoomSpectrum;
+   PublisherStats detections;
+   PublisherStats displayIq;
+};
+
+/**
+ * @class EngineLatencyStats
+ * @brief Per-hop latency percentiles of the traced output streams.
+ */
+struct EngineLatencyStats
+{
+   StageLatencyStats spectrum;     ///< I/Q → FFT → spectrumDataHandler() listeners.
+   StageLatencyStats iq;           ///< I/Q → iqDataHandler() listeners.
+   StageLatencyStats filteredIq;   ///< I/Q → channel filter → filteredIqDataHandler() listeners.
+};
+
+/**
+ * @class SnapshotRequest
+ * @brief One pre-trigger capture: the I/Q around a trigger, written to a file.
+ */
+struct SnapshotRequest
+{
+   std::string path;                                 ///< Output file (base name for SigMF).
+   RecordingFormat format{RecordingFormat::SigMf};
+   double preSec{1.0};                               ///< Seconds before the trigger.
+   double postSec{1.0};                              ///< Seconds after the trigger.
+   /// When the trigger happened (e.g. SignalEvent::firstSeen); unset = now.
+   std::optional<std::chrono::steady_clock::time_point> triggerTime;
+};
+
+/**
+ * @class SnapshotStats
+ * @brief Pre-trigger snapshot counters since start().
+ */
+struct SnapshotStats
+{
+   uint64_t triggered{0};        ///< Requests accepted.
+   uint64_t rejected{0};         ///< Requests refused (not running, disabled, queue full).
+   uint64_t completed{0};        ///< Snapshots written (possibly truncated).
+   uint64_t failed{0};           ///< Snapshots whose file could not be created.
+   uint64_t samplesWritten{0};   ///< Samples handed to the recorders.
+   uint64_t samplesLost{0};      ///< Window samples already overwritten or never captured.
+};
+
+/**
+ * @class EngineLoadControlStats
+ * @brief State of the FFT load controller (see SdrEngine::setLoadControlEnabled()).
+ */
+struct EngineLoadControlStats
+{
+   bool enabled{false};
+   double utilization{0.0};      ///< Busy fraction of the busiest watched stage, last period.
+   std::size_t level{0};         ///< Adjustments in force.
+   uint64_t degradations{0};     ///< Adjustments made to shed load.
+   uint64_t restorations{0};     ///< Adjustments undone once load fell.
+   FftLoadSettings effective;    ///< Overlap, output rate and display divisor in use.
+   std::optional<FftLoadAdjustment> lastAdjustment;
+};
+
+/**
+ * @class EngineHealthStats
+ * @brief Sample and frame loss along the whole chain, device to listeners.
+ */
+struct EngineHealthStats
+{
+   DeviceStreamStats device;            ///< Driver reads, overflows and timeouts.
+   uint64_t ringOverflowSamples{0};     ///< Samples dropped because the sample ring was full.
+   EnginePublishStats publish;          ///< Frames dropped for slow listeners.
+   CommonUtils::MemoryTotals memory;    ///< Every MemoryRegistry account in the process.
+
+   /**
+    * @brief Check if any I/Q samples were lost before processing.
+    * @return true if the driver or the sample ring dropped samples.
+    */
+   [[nodiscard]] bool hasSampleLoss() const
+   {
+      return device.overflows > 0 || ringOverflowSamples > 0;
+   }
+
+   /**
+    * @brief Get the frames dropped across every publisher.
+    * @return Total dropped frames.
+    */
+   [[nodiscard]] uint64_t droppedFrames() const
+   {
+      return publish.spectrum.dropped + publish.sweep.dropped + publish.iq.dropped +
+             publish.filteredIq.dropped + publish.channelizer.dropped +
+             publish.zoomSpectrum.dropped + publish.detections.dropped +
+             publish.displayIq.dropped;
+   }
+};
+
 /**
  * @class SdrEngine
  * @brief High-level SDR controller.
  *
- * Owns an ISdrDevice, an FftProcessor, and two DataHandlers:
+ * Owns an ISdrDevice, an FftProcessor, and two main DataHandlers:
  *   - `spectrumDataHandler()`  — publishes SpectrumData after each FFT.
  *   - `iqDataHandler()`        — publishes IqBuffer (raw complex I/Q chunks).
+ * Optional stages (channel filter, zoom FFT, channelizer, VFOs, signal
+ * detector, display tap) publish on their own DataHandlers.
  *
  * The data pipeline is entirely Qt-free.  The MainWindow (or any other
  * consumer) registers listeners on the DataHandlers to receive results.
  *
- * Threading model:
- *   Device callback thread → lock-free append to internal accumulation buffer
- *   Processing thread      → takes accumulated I/Q, runs FFT, publishes
+ * Threading model (each stage on its own thread, joined by bounded queues):
+ *   Device callback thread → one pass: native → float conversion and IIR
+ *                            DC blocking, straight into an SPSC sample ring
+ *                            (with Cs16 ring storage: native → int16 copy,
+ *                            DC blocking moves to conditioning)
+ *   Conditioning thread    → reads FFT-sized blocks from the ring,
+ *                            publishes raw I/Q (and its display tap),
+ *                            fans frames out to:
+ *     FFT thread           → Welch framing, FFT, spectrum publish
+ *     Channel-filter thread→ channel extraction, filtered I/Q publish,
+ *                            zoom FFT of the channel, zoom spectrum publish
+ *     Channelizer thread   → polyphase filterbank, per-channel I/Q publish
+ *     VFO thread           → every Vfo in parallel on a worker pool
+ *   Detector thread        → CFAR detection on each published spectrum,
+ *                            detection report publish
+ *   Snapshot thread        → copies triggered windows out of the snapshot
+ *                            ring into an IqRecorder
+ *   Demodulation workers   → DemodExecutor channels, fed by listeners via
+ *                            submit() and independent of start() / stop()
+ *   Sweep thread (sweep mode, in place of conditioning) → retune, discard
+ *                            settling samples, FFT and stitch each step
+ *
+ * A slow FFT or filter stage fills its queue, which stalls conditioning;
+ * the sample ring then absorbs the backlog and, if it too fills, drops
+ * samples (counted in getOverflowCount()) — the device is never blocked.
+ *
+ * Listeners are decoupled by their DataHandler's queue, which the engine
+ * bounds per publisher (setPublishPolicy()).  By default a slow listener
+ * loses frames (counted in getPublishStats()) rather than stalling a stage.
+ * Each publisher is named ("SdrEngine.spectrum", "SdrEngine.iq",
+ * "SdrEngine.channel.<c>", ...) in CommonUtils::DataHandlerRegistry, which
+ * reports its queue latency, backlog and per-listener callback time.  The
+ * prefix is the engine's name, as is that of the stage threads' roles
+ * ("SdrEngine.fft", ...); SdrDeviceGroup names each of its engines apart.
  */
 class SdrEngine
 {
 public:
-   SdrEngine();
+   /// Name of a default-constructed engine.
+   static constexpr const char* DEFAULT_NAME = "SdrEngine";
+
+   /// CommonUtils::MemoryRegistry accounts of the spectrum and raw I/Q
+   /// publish queues (each engine's queue gets the whole budget).
+   static constexpr const char* SPECTRUM_QUEUE_ACCOUNT = "engine.spectrumQueue";
+   static constexpr const char* IQ_QUEUE_ACCOUNT       = "engine.iqQueue";
+
+   /**
+    * @brief Construct a stopped engine.
+    * @param name  Prefix of the engine's DataHandler names and thread roles
+    *              ("<name>.spectrum", "<name>.fft", ...), so several engines
+    *              in one process can be told apart and pinned separately.
+    */
+   explicit SdrEngine(std::string name = DEFAULT_NAME);
    ~SdrEngine();
 
    // Non-copyable, non-movable.
@@ -48,6 +262,12 @@ public:
    SdrEngine(SdrEngine&&) = delete;
    SdrEngine& operator=(SdrEngine&&) = delete;
 
+   /**
+    * @brief Get the name given at construction.
+    * @return Engine name.
+    */
+   [[nodiscard]] const std::string& getName() const;
+
    // -- Device management ---------------------------------------------------
 
    /**
@@ -122,6 +342,32 @@ public:
     */
    [[nodiscard]] size_t getFftSize() const;
 
+   /**
+    * @brief Pre-build FFT plans for the given sizes on a background thread,
+    * so a later setFftSize() to one of them switches without planning.
+    */
+   void prepareFftSizes(std::vector<size_t> fftSizes);
+
+   /**
+    * @brief Choose the FFT library for the main and zoom FFTs.
+    * Auto (the default) benchmarks the backends for each FFT size the first
+    * time it is planned and keeps the fastest (selectFftBackend()).
+    * @param backend  Backend to use.
+    */
+   void setFftBackend(FftBackend backend);
+
+   /**
+    * @brief Get the requested FFT backend.
+    * @return Backend as set (may be Auto).
+    */
+   [[nodiscard]] FftBackend getFftBackend() const;
+
+   /**
+    * @brief Get the backend the main FFT currently runs on.
+    * @return Fftw or Builtin.
+    */
+   [[nodiscard]] FftBackend getActiveFftBackend() const;
+
    /** @brief Change the windowing function. */
    void setWindowFunction(WindowFunction windowFunc);
 
@@ -133,7 +379,8 @@ public:
 
    /**
     * @brief Set the FFT averaging alpha (0.0 = no averaging, 1.0 = full smoothing).
-    * Alpha is the coefficient for the exponential moving average:
+    * Alpha is the coefficient for the exponential moving average, which runs
+    * on linear power across published frames:
     *   avg[n] = alpha * avg[n-1] + (1 - alpha) * new[n]
     * @param alpha  Averaging coefficient [0.0, 1.0].
     */
@@ -145,9 +392,191 @@ public:
     */
    [[nodiscard]] float getFftAverageAlpha() const;
 
+   /**
+    * @brief Publish a decaying peak-hold trace in SpectrumData::maxHoldDb.
+    * @param enabled  true to compute the trace, false to leave it empty.
+    */
+   void setMaxHoldEnabled(bool enabled);
+
+   /**
+    * @brief Check if the max-hold trace is computed.
+    * @return true if SpectrumData frames carry maxHoldDb.
+    */
+   [[nodiscard]] bool isMaxHoldEnabled() const;
+
+   /**
+    * @brief Set how fast the max-hold trace falls back (stream time).
+    * @param dbPerSecond  Decay in dB per second (0 = hold forever).
+    */
+   void setMaxHoldDecayRate(float dbPerSecond);
+
+   /**
+    * @brief Get the max-hold decay rate.
+    * @return Decay in dB per second.
+    */
+   [[nodiscard]] float getMaxHoldDecayRate() const;
+
+   /**
+    * @brief Publish a minimum-hold trace in SpectrumData::minHoldDb.
+    * @param enabled  true to compute the trace, false to leave it empty.
+    */
+   void setMinHoldEnabled(bool enabled);
+
+   /**
+    * @brief Check if the min-hold trace is computed.
+    * @return true if SpectrumData frames carry minHoldDb.
+    */
+   [[nodiscard]] bool isMinHoldEnabled() const;
+
+   /** @brief Restart the max- and min-hold traces from the next frame. */
+   void resetSpectrumHolds();
+
+   /**
+    * @brief Publish a min / max / mean resolution pyramid in SpectrumData::tiers.
+    * Display consumers pick a tier with selectSpectrumView() instead of
+    * decimating every frame themselves.
+    * @param enabled  true to build the pyramid, false to leave `tiers` empty.
+    */
+   void setSpectrumPyramidEnabled(bool enabled);
+
+   /**
+    * @brief Check if the resolution pyramid is built.
+    * @return true if SpectrumData frames carry tiers.
+    */
+   [[nodiscard]] bool isSpectrumPyramidEnabled() const;
+
+   /** @brief Smallest pyramid tier built by the engine (points). */
+   static constexpr std::size_t SPECTRUM_PYRAMID_MIN_POINTS = 256;
+
+   /**
+    * @brief Publish a running noise floor and band power in SpectrumData::levels.
+    * See SpectrumLevelEstimator for how they are measured.
+    * @param enabled  true to measure, false to leave `levels` invalid.
+    */
+   void setSpectrumLevelsEnabled(bool enabled);
+
+   /**
+    * @brief Check if the noise floor and band power are measured.
+    * @return true if SpectrumData frames carry valid levels.
+    */
+   [[nodiscard]] bool isSpectrumLevelsEnabled() const;
+
+   /**
+    * @brief Set the percentile of the bins read as the noise floor.
+    * @param percent  Percentile, clamped to [1, 99] (50 = median).
+    */
+   void setNoiseFloorPercentile(float percent);
+
+   /**
+    * @brief Get the noise-floor percentile.
+    * @return Percentile in [1, 99].
+    */
+   [[nodiscard]] float getNoiseFloorPercentile() const;
+
+   /**
+    * @brief Set how long the noise-floor estimate remembers a frame (stream time).
+    * @param seconds  Time constant of the running histogram.
+    */
+   void setNoiseFloorTimeConstant(float seconds);
+
+   /**
+    * @brief Get the noise-floor time constant.
+    * @return Time constant in seconds.
+    */
+   [[nodiscard]] float getNoiseFloorTimeConstant() const;
+
+   /**
+    * @brief Measure the total power of `[minFreqHz, maxFreqHz]` in SpectrumData::levels.
+    * Typically the locked bandwidth cursor.
+    * @param minFreqHz  Lower band edge (absolute frequency).
+    * @param maxFreqHz  Upper band edge (absolute frequency).
+    */
+   void setMeasurementBand(double minFreqHz, double maxFreqHz);
+
+   /** @brief Stop measuring band power. */
+   void clearMeasurementBand();
+
+   /**
+    * @brief Set the overlap between consecutive FFT segments (Welch framing).
+    * Each segment starts `fftSize * (1 - percent / 100)` samples after the
+    * previous one.  0 % gives back-to-back, non-overlapping segments.
+    * @param percent  Overlap in percent, clamped to [0, MAX_FFT_OVERLAP_PERCENT];
+    *                 a non-finite value is ignored.
+    */
+   void setFftOverlapPercent(float percent);
+
+   /**
+    * @brief Get the FFT segment overlap.
+    * @return Overlap in percent.
+    */
+   [[nodiscard]] float getFftOverlapPercent() const;
+
+   /**
+    * @brief Set the target rate at which SpectrumData frames are published.
+    * All FFT segments computed between two publications are averaged in
+    * linear power, so a lower rate means less downstream load and lower
+    * variance.  0 publishes every segment.  The effective rate can never
+    * exceed the segment rate (sampleRate / hop).
+    * @param framesPerSecond  Target output rate in Hz (negative treated as 0).
+    */
+   void setSpectrumOutputRate(float framesPerSecond);
+
+   /**
+    * @brief Get the target spectrum output rate.
+    * @return Output rate in Hz, or 0 if every segment is published.
+    */
+   [[nodiscard]] float getSpectrumOutputRate() const;
+
+   /** @brief Upper bound accepted by setFftOverlapPercent(). */
+   static constexpr float MAX_FFT_OVERLAP_PERCENT = 95.0F;
+
+   /**
+    * @brief Let the engine turn down overlap, output rate and display tap
+    *        budget to stay under a CPU target.
+    *
+    * FFT size, sample rate and averaging are chosen independently, and a
+    * combination the machine cannot sustain makes the FFT stage's backlog
+    * and latency grow until samples are dropped.  While enabled, an
+    * FftLoadController on the FFT stage watches the FFT and conditioning
+    * stage timers and the FFT backlog, and limits the settings above step
+    * by step until the load fits, then lifts the limits one by one once
+    * there is headroom again.  Each step is logged and counted in
+    * getLoadControlStats(); the getters keep returning the requested
+    * settings.  Disabling lifts every limit.
+    *
+    * @param enabled  true to adapt the settings to the load.
+    */
+   void setLoadControlEnabled(bool enabled);
+
+   /**
+    * @brief Check if the load controller is enabled.
+    * @return true if enabled.
+    */
+   [[nodiscard]] bool isLoadControlEnabled() const;
+
+   /**
+    * @brief Set the load controller's target and limits; lifts every limit.
+    * @param config  Controller settings (see FftLoadConfig).
+    */
+   void setLoadControlConfig(const FftLoadConfig& config);
+
+   /**
+    * @brief Get the load controller's settings.
+    * @return Controller settings.
+    */
+   [[nodiscard]] FftLoadConfig getLoadControlConfig() const;
+
+   /**
+    * @brief Get the load controller's state and adjustment counters.
+    * Reset on each start().
+    * @return Snapshot of the controller.
+    */
+   [[nodiscard]] EngineLoadControlStats getLoadControlStats() const;
+
    /**
     * @brief Enable or disable DC spike removal (local oscillator leakage suppression).
-    * When enabled, removes DC offset from IQ samples and interpolates the center FFT bin.
+    * When enabled, a single-pole DC blocker runs on the I/Q stream and the
+    * center FFT bin is interpolated.
     * @param enabled  true to remove DC spike, false to disable.
     */
    void setDcSpikeRemovalEnabled(bool enabled);
@@ -158,6 +587,26 @@ public:
     */
    [[nodiscard]] bool isDcSpikeRemovalEnabled() const;
 
+   /**
+    * @brief Set the DC blocker time constant.
+    * Longer values track the DC offset more slowly and notch a narrower
+    * band around 0 Hz.  Applies from the next device block.
+    * @param seconds  Time constant, clamped to at least MIN_DC_TIME_CONSTANT_S.
+    */
+   void setDcBlockerTimeConstant(float seconds);
+
+   /**
+    * @brief Get the DC blocker time constant.
+    * @return Time constant in seconds.
+    */
+   [[nodiscard]] float getDcBlockerTimeConstant() const;
+
+   /** @brief Lower bound accepted by setDcBlockerTimeConstant(). */
+   static constexpr float MIN_DC_TIME_CONSTANT_S = 1.0e-5F;
+
+   /** @brief Default DC blocker time constant. */
+   static constexpr float DEFAULT_DC_TIME_CONSTANT_S = 0.01F;
+
    // -- Channel filter controls ---------------------------------------------
 
    /**
@@ -189,6 +638,288 @@ public:
     */
    [[nodiscard]] const ChannelFilter& channelFilter() const;
 
+   // -- Zoom FFT controls ---------------------------------------------------
+
+   /**
+    * @brief Enable or disable the zoom FFT of the channel filter's output.
+    *
+    * While the channel filter is enabled, a second, small FftProcessor runs
+    * Welch averaging on its decimated output and publishes the channel's
+    * spectrum on zoomSpectrumDataHandler().  Its resolution is
+    * `channel rate / getZoomFftSize()` instead of `sample rate / getFftSize()`,
+    * at a fraction of the cost of raising the wideband FFT size.  Overlap,
+    * output rate, averaging and window follow the wideband settings.
+    */
+   void setZoomFftEnabled(bool enabled);
+
+   /**
+    * @brief Check if the zoom FFT runs (while the channel filter is enabled).
+    * @return true if the zoom FFT is enabled.
+    */
+   [[nodiscard]] bool isZoomFftEnabled() const;
+
+   /** @brief Change the zoom FFT size (takes effect on the next segment). */
+   void setZoomFftSize(size_t fftSize);
+
+   /**
+    * @brief Get the zoom FFT size.
+    * @return Current zoom FFT size.
+    */
+   [[nodiscard]] size_t getZoomFftSize() const;
+
+   /** @brief Default zoom FFT size. */
+   static constexpr size_t DEFAULT_ZOOM_FFT_SIZE = 1024;
+
+   // -- Channelizer controls ------------------------------------------------
+
+   /**
+    * @brief Configure the polyphase filterbank channelizer.
+    *
+    * Splits the full sample rate into `numChannels` channels of
+    * `rate / numChannels` each; channel `c` is published on
+    * `channelizerDataHandler(c)`.  Only allowed while stopped.  Handlers
+    * persist across reconfiguration, so registered listeners stay attached.
+    *
+    * @param numChannels     Number of channels (2 .. Channelizer::MAX_CHANNELS).
+    * @param tapsPerChannel  Prototype filter taps per channel.
+    * @return true if the channelizer is configured with `numChannels`.
+    */
+   [[nodiscard]] bool configureChannelizer(
+      std::size_t numChannels, std::size_t tapsPerChannel = Channelizer::DEFAULT_TAPS_PER_CHANNEL);
+
+   /** @brief Enable or disable the channelizer stage. */
+   void setChannelizerEnabled(bool enabled);
+
+   /**
+    * @brief Check if the channelizer is enabled.
+    * @return true if the channelizer is enabled.
+    */
+   [[nodiscard]] bool isChannelizerEnabled() const;
+
+   /**
+    * @brief Get the number of configured channelizer channels.
+    * @return Channel count, or 0 if not configured.
+    */
+   [[nodiscard]] std::size_t getChannelizerChannelCount() const;
+
+   /**
+    * @brief Get the reference to the channelizer (for advanced queries).
+    * @return Reference to the channelizer.
+    */
+   [[nodiscard]] const Channelizer& channelizer() const;
+
+   // -- VFOs ----------------------------------------------------------------
+
+   /**
+    * @brief Add an independently tuned receiver.
+    *
+    * Each VFO filters (and optionally demodulates) its own channel from the
+    * same wideband frames; all VFOs run in parallel on a worker pool, so
+    * adding one costs a core rather than time on a shared thread.  May be
+    * called while running.
+    *
+    * @param centerOffsetHz  Offset from the centre frequency (Hz).
+    * @param bandwidthHz     Channel bandwidth (Hz).
+    * @return The new VFO's id.
+    */
+   int addVfo(double centerOffsetHz, double bandwidthHz);
+
+   /**
+    * @brief Remove a VFO.  Frames already being processed still finish.
+    * @param id  VFO id returned by addVfo().
+    * @return true if the VFO existed.
+    */
+   bool removeVfo(int id);
+
+   /**
+    * @brief Look up a VFO to retune it or register listeners.
+    * @param id  VFO id returned by addVfo().
+    * @return The VFO, or nullptr if no VFO has that id.
+    */
+   [[nodiscard]] std::shared_ptr<Vfo> vfo(int id) const;
+
+   /**
+    * @brief Get the ids of every VFO, in creation order.
+    * @return VFO ids.
+    */
+   [[nodiscard]] std::vector<int> vfoIds() const;
+
+   /**
+    * @brief Get the number of VFOs.
+    * @return VFO count.
+    */
+   [[nodiscard]] std::size_t getVfoCount() const;
+
+   // -- Demodulation --------------------------------------------------------
+
+   /**
+    * @brief Get the executor that runs stand-alone demodulation channels.
+    *
+    * Listeners hand I/Q blocks to DemodExecutor::submit() instead of
+    * demodulating inline, so a slow demodulator never holds up the other
+    * listeners on the same DataHandler.  Created, and its workers started,
+    * on first use.
+    *
+    * @return The engine's demodulation executor.
+    */
+   [[nodiscard]] DemodExecutor& demodExecutor();
+
+   // -- Wideband sweep ------------------------------------------------------
+
+   /**
+    * @brief Configure a sweep over a range wider than the sample rate.
+    *
+    * While sweep mode is enabled, start() runs a sweep instead of the normal
+    * pipeline: the engine steps the centre frequency across the range,
+    * discards `settleTimeSec` of samples after every retune, FFTs each step
+    * and stitches the central bins of all steps into one SpectrumData per
+    * pass, published on sweepDataHandler().  The next retune is issued as
+    * soon as a step's samples are captured, so the hardware settles while
+    * the previous step is processed.  Only allowed while stopped.
+    *
+    * @param config  Range and per-step settings.
+    * @return true if the range can be planned at the current sample rate
+    *         and FFT size.
+    */
+   [[nodiscard]] bool configureSweep(const SweepConfig& config);
+
+   /**
+    * @brief Enable or disable sweep mode.  Only allowed while stopped.
+    * @param enabled  true to sweep on the next start().
+    */
+   void setSweepEnabled(bool enabled);
+
+   /**
+    * @brief Check if sweep mode is enabled.
+    * @return true if start() runs a sweep.
+    */
+   [[nodiscard]] bool isSweepEnabled() const;
+
+   /**
+    * @brief Get the plan of the configured sweep.
+    * @return Sweep plan (valid after configureSweep() succeeded).
+    */
+   [[nodiscard]] const SpectrumSweep& sweep() const;
+
+   /**
+    * @brief Get pass timing of the running (or last) sweep.  Reset on each start().
+    * @return Sweep statistics.
+    */
+   [[nodiscard]] SweepStats getSweepStats() const;
+
+   // -- Signal detector -----------------------------------------------------
+
+   /**
+    * @brief Enable or disable signal detection on the wideband spectrum.
+    *
+    * A SignalDetector runs CFAR over every spectrum the FFT stage publishes,
+    * on a thread of its own, and publishes a DetectionReport on
+    * detectionDataHandler() for each frame that starts, continues or ends
+    * an event.  If it falls behind, it skips to the newest spectrum rather
+    * than hold up the FFT stage.  Enabling restarts event tracking.
+    *
+    * @param enabled  true to detect.
+    */
+   void setDetectorEnabled(bool enabled);
+
+   /**
+    * @brief Check if signal detection runs.
+    * @return true if the detector is enabled.
+    */
+   [[nodiscard]] bool isDetectorEnabled() const;
+
+   /**
+    * @brief Set the CFAR method, thresholds and event hysteresis.
+    * Takes effect with the next analysed spectrum.
+    * @param config  Detector settings (see DetectorConfig).
+    */
+   void setDetectorConfig(const DetectorConfig& config);
+
+   /**
+    * @brief Get the detector settings.
+    * @return Detector settings.
+    */
+   [[nodiscard]] DetectorConfig getDetectorConfig() const;
+
+   // -- Display tap ---------------------------------------------------------
+
+   /**
+    * @brief Enable or disable the display-rate I/Q feed.
+    *
+    * Constellation and oscilloscope views draw a few thousand points, so
+    * they should listen on displayIqDataHandler() rather than take every
+    * full-rate frame.  A DisplayIqTap in the source stage (conditioning or
+    * channel filter) cuts the stream to the configured budget, by
+    * decimation or by contiguous snapshots, so the display's listener and
+    * widget cost stay flat whatever the sample rate.
+    *
+    * @param enabled  true to publish on displayIqDataHandler().
+    */
+   void setDisplayTapEnabled(bool enabled);
+
+   /**
+    * @brief Check if the display tap publishes.
+    * @return true if enabled.
+    */
+   [[nodiscard]] bool isDisplayTapEnabled() const;
+
+   /**
+    * @brief Set the tap's source stream, mode and budget.
+    * Takes effect with the next frame; a partial display frame is dropped.
+    * @param config  Tap settings (see DisplayTapConfig).
+    */
+   void setDisplayTapConfig(const DisplayTapConfig& config);
+
+   /**
+    * @brief Get the display tap settings.
+    * @return Tap settings.
+    */
+   [[nodiscard]] DisplayTapConfig getDisplayTapConfig() const;
+
+   // -- Pre-trigger snapshots -----------------------------------------------
+
+   /**
+    * @brief Keep a history of the raw I/Q for triggerSnapshot().
+    *
+    * The conditioning stage appends every frame to an IqSnapshotRing of
+    * `historySec` at the sample rate, with bulk copies.  Takes effect at
+    * the next start(); the ring is not resized by a later rate change, so
+    * a higher rate shortens the history.  Not used in sweep mode.
+    *
+    * @param historySec  Seconds of I/Q kept (0 = no snapshots).
+    * @param storage     Cs16 halves the memory, at 16-bit resolution.
+    */
+   void configureSnapshots(double historySec, SnapshotStorage storage = SnapshotStorage::Cf32);
+
+   /**
+    * @brief Get the configured snapshot history.
+    * @return Seconds of I/Q kept (0 = no snapshots).
+    */
+   [[nodiscard]] double getSnapshotHistorySec() const;
+
+   /**
+    * @brief Write the I/Q from `preSec` before to `postSec` after a trigger
+    * to a file, without pausing the stream.
+    *
+    * The request is queued for the snapshot thread, which writes the part
+    * already captured at once and the rest as it arrives, through an
+    * IqRecorder.  Samples older than the history are lost (counted in
+    * getSnapshotStats()); a snapshot still waiting at stop() is cut short.
+    * Triggers can come from anywhere: a detectionDataHandler() listener,
+    * an oscilloscope trigger, or a remote command.
+    *
+    * @param request  Window, output file and trigger time.
+    * @return true if queued; false while stopped, without a history, or
+    *         with too many snapshots pending.
+    */
+   [[nodiscard]] bool triggerSnapshot(const SnapshotRequest& request);
+
+   /**
+    * @brief Get the snapshot counters.
+    * @return Counters since start().
+    */
+   [[nodiscard]] SnapshotStats getSnapshotStats() const;
+
    // -- Start / stop --------------------------------------------------------
 
    /**
@@ -207,23 +938,205 @@ public:
     */
    [[nodiscard]] bool isRunning() const;
 
+   /**
+    * @brief Choose how the sample ring holds I/Q.  Takes effect at the next
+    * start().
+    *
+    * Cs16 halves the ring's memory and the device thread's write bandwidth:
+    * integer devices are copied as is, and the conversion to float (fused
+    * with DC blocking) runs on the conditioning thread.  Float devices lose
+    * resolution below 1 / 32767 of full scale.
+    *
+    * @param storage  Sample format in the ring (default Cf32).
+    */
+   void setSampleRingStorage(IqStorage storage);
+
+   /**
+    * @brief Get the configured sample ring format.
+    * @return Format used from the next start().
+    */
+   [[nodiscard]] IqStorage getSampleRingStorage() const;
+
+   /**
+    * @brief Get the number of I/Q samples dropped because the processing
+    *        thread fell behind the device (sample ring full).
+    * Reset to zero on each start().
+    * @return Total dropped samples since the last start().
+    */
+   [[nodiscard]] uint64_t getOverflowCount() const;
+
+   /**
+    * @brief Get hit/miss counters of the recycled output frame pools.
+    * A steady-state miss count that keeps climbing means listeners hold
+    * frames longer than the pool depth allows.  Reset on each start().
+    * @return Per-pool statistics.
+    */
+   [[nodiscard]] EngineFramePoolStats getFramePoolStats() const;
+
+   /**
+    * @brief Get per-stage timing counters and queue depths.
+    * Reset on each start().
+    * @return Snapshot of every pipeline stage.
+    */
+   [[nodiscard]] PipelineStats getPipelineStats() const;
+
+   /**
+    * @brief Choose what a publisher does when its listeners fall behind.
+    *
+    * Defaults: Sweep keeps only the latest pass; Spectrum, ZoomSpectrum, Iq and
+    * Channelizer drop the oldest frame beyond a few frames of backlog;
+    * FilteredIq (which usually feeds audio) allows a deeper backlog before
+    * dropping.  OverflowPolicy::Block holds the producing stage back
+    * instead, which eventually overflows the sample ring.  Streams that
+    * only feed displays are best set to OverflowPolicy::LatestOnly; the
+    * frames it replaces are reported as `coalesced`.
+    *
+    * @param publisher  Output stream to configure.
+    * @param policy     Overflow behaviour of its DataHandler queue.
+    * @param capacity   Maximum queued frames (see DataHandler::setOverflowPolicy()).
+    */
+   void setPublishPolicy(EnginePublisher publisher, CommonUtils::OverflowPolicy policy,
+                         std::size_t capacity = 1);
+
+   /**
+    * @brief Get the dropped-frame and backlog counters of every publisher.
+    * Counters accumulate for the engine's lifetime.
+    * @return Per-publisher statistics.
+    */
+   [[nodiscard]] EnginePublishStats getPublishStats() const;
+
+   /**
+    * @brief Get device, sample-ring and publisher loss counters in one snapshot.
+    * Device and ring counters reset on each start(); publisher counters
+    * accumulate for the engine's lifetime.
+    * @return Combined health counters (device fields zero without a device).
+    */
+   [[nodiscard]] EngineHealthStats getHealthStats() const;
+
+   /**
+    * @brief Write getHealthStats() to the log, as a warning if samples were
+    *        lost, followed by the MemoryRegistry accounts.
+    */
+   void logHealthStats() const;
+
+   // -- Latency tracing -----------------------------------------------------
+
+   /**
+    * @brief Enable or disable per-stage latency tracing.
+    *
+    * While enabled, every frame carries StageTimestamps (device read, ring
+    * dequeue, DSP done, publish) and the engine measures listener start /
+    * end around each dispatch of the spectrum, raw I/Q and filtered I/Q
+    * streams, accumulating each hop into a LatencyHistogram.  Disabled by
+    * default; costs a few clock reads per frame when on.
+    *
+    * @param enabled  true to stamp frames and record histograms.
+    */
+   void setLatencyTracingEnabled(bool enabled);
+
+   /**
+    * @brief Check if latency tracing is enabled.
+    * @return true while frames are being stamped.
+    */
+   [[nodiscard]] bool isLatencyTracingEnabled() const;
+
+   /**
+    * @brief Get per-hop latency percentiles.  Reset on each start().
+    * @return Snapshot of every traced stream.
+    */
+   [[nodiscard]] EngineLatencyStats getLatencyStats() const;
+
+   /** @brief Zero the latency histograms. */
+   void resetLatencyStats();
+
+   /** @brief Write the latency percentiles of every traced stream to the log. */
+   void logLatencyStats() const;
+
    // -- Data outputs --------------------------------------------------------
 
    /** @brief DataHandler that publishes SpectrumData after each FFT frame. */
    [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& spectrumDataHandler();
 
+   /** @brief DataHandler that publishes SpectrumData of the channel filter's output. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& zoomSpectrumDataHandler();
+
+   /** @brief DataHandler that publishes DetectionReport of the signal detector. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const DetectionReport>>& detectionDataHandler();
+
+   /** @brief DataHandler that publishes one stitched SpectrumData per sweep pass. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>& sweepDataHandler();
+
    /** @brief DataHandler that publishes IqBuffer chunks for constellation display. */
    [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& iqDataHandler();
 
    /** @brief DataHandler that publishes filtered (channel-extracted) IqBuffer chunks. */
    [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& filteredIqDataHandler();
 
+   /** @brief DataHandler that publishes the display tap's budgeted IqBuffer frames. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& displayIqDataHandler();
+
+   /**
+    * @brief DataHandler that publishes one channelizer channel's IqBuffer chunks.
+    * @param channel  Channel index, `< getChannelizerChannelCount()`.
+    * @throws std::out_of_range if the channel was never configured.
+    */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& channelizerDataHandler(
+      std::size_t channel);
+
 private:
    // Called from the device's async callback thread.
-   void onIqData(const IqSample* samples, std::size_t numSamples);
+   void onIqData(const RawIqBlock& block);
+
+   // Signal every stage to exit, wake any blocked waits, and join threads.
+   void shutdownPipeline();
+
+   // Pipeline stage thread bodies.
+   void conditioningLoop();
+   void fftLoop();
+   void channelFilterLoop();
+   void channelizerLoop();
+   void vfoLoop();
+   void detectorLoop();
+   void snapshotLoop();
+   void sweepLoop();
+
+   // Tune the device to a sweep step.  Returns the samples already in the
+   // ring, which predate the retune and must be discarded.
+   std::size_t retuneForSweep(std::size_t step);
+
+   // Take `count` samples (<= available) out of the ring as float, DC-blocked
+   // here if the ring holds Cs16.
+   void readRing(IqSample* dst, std::size_t count);
+
+   // Consume `count` samples from the ring as they arrive.
+   // Returns false if the pipeline is shutting down.
+   bool discardSamples(std::size_t count);
 
-   // Processing thread body.
-   void processingLoop();
+   // Convert an accumulated Welch power sum to dB, apply EMA / DC-bin
+   // suppression, hold traces and the resolution pyramid, and publish one
+   // SpectrumData frame.
+   // `elapsedSec` is the stream time covered since the previous frame.
+   // `source` is the trace of the newest I/Q frame in the average.
+   void publishSpectrum(const std::vector<float>& powerSum, std::size_t segments,
+                        double elapsedSec, const StageTimestamps& source);
+
+   // Welch framing of the zoom FFT over one filtered frame; publishes
+   // through publishZoomSpectrum().  Channel-filter thread only.
+   void zoomFft(const IqBuffer& filtered);
+   void publishZoomSpectrum(const StageTimestamps& source);
+
+   // FFT-thread side of the load controller: pick up a new configuration
+   // (undoing every step), or measure and log / apply one step.
+   void restartLoadControl(const FftLoadSettings& requested);
+   void controlLoad(const FftLoadSettings& requested, std::size_t hop);
+
+   // Feed a frame of the given stream to the display tap and publish its output.
+   void tapForDisplay(const IqBuffer& frame, DisplayTapSource source);
+
+   // Install or remove the dispatch observers that feed the latency histograms.
+   void installLatencyObservers(bool enabled);
+
+   const std::string _name;
 
    // -- Device & DSP --------------------------------------------------------
    std::unique_ptr<ISdrDevice> _device;
@@ -231,32 +1144,188 @@ private:
 
    // -- Data handlers -------------------------------------------------------
    std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>> _spectrumHandler;
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>> _sweepHandler;
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>>> _zoomSpectrumHandler;
    std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>> _iqHandler;
    std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>> _filteredIqHandler;
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const DetectionReport>>> _detectionHandler;
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>> _displayIqHandler;
+   std::vector<std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>>
+      _channelHandlers;                                // One per channelizer channel.
 
-   // -- Accumulation buffer (device callback → processing thread) -----------
-   std::mutex _bufMutex;
-   std::vector<std::complex<float>> _accumBuf;
-   std::condition_variable _bufCv;
+   // Default overflow policies (see setPublishPolicy()).  Capacities stay
+   // well below the frame pool depths so dropped frames recycle.
+   static constexpr std::size_t SPECTRUM_PUBLISH_CAPACITY    = 4;
+   static constexpr std::size_t IQ_PUBLISH_CAPACITY          = 4;
+   static constexpr std::size_t FILTERED_IQ_PUBLISH_CAPACITY = 16;
+   static constexpr std::size_t CHANNEL_PUBLISH_CAPACITY     = 16;
+   static constexpr std::size_t DETECTION_PUBLISH_CAPACITY   = 16;
+   static constexpr std::size_t DISPLAY_IQ_PUBLISH_CAPACITY  = 4;
+   // Applied to channel handlers created by later configureChannelizer() calls.
+   mutable std::mutex _channelPolicyMutex;
+   CommonUtils::OverflowPolicy _channelPolicy{CommonUtils::OverflowPolicy::DropOldest};
+   std::size_t _channelPolicyCapacity{CHANNEL_PUBLISH_CAPACITY};
 
-   // -- Processing thread ---------------------------------------------------
-   std::thread _procThread;
+   // -- Sample ring (device callback → processing thread) -------------------
+   // Sized at start() to hold several frames of the largest FFT so short
+   // processing stalls are absorbed without dropping samples.
+   static constexpr std::size_t MIN_RING_CAPACITY = 1U << 20;
+   static constexpr std::size_t RING_FRAMES       = 4;
+   IqSampleRing _ring;
+   std::atomic<IqStorage> _ringStorage{IqStorage::Cf32};
+
+   // -- Output frame pools --------------------------------------------------
+   // Published frames return here once the last listener drops them, so
+   // the pipeline stages reuse FFT-sized buffers instead of allocating.
+   // Deep enough to cover both stage queues plus frames held by listeners.
+   static constexpr std::size_t FRAME_POOL_DEPTH = 32;
+   FramePool<IqBuffer> _iqPool{FRAME_POOL_DEPTH};
+   FramePool<IqBuffer> _filteredIqPool{FRAME_POOL_DEPTH};
+   FramePool<SpectrumData> _spectrumPool{FRAME_POOL_DEPTH};
+   // Every wideband frame yields one small buffer per channel.
+   static constexpr std::size_t CHANNEL_POOL_DEPTH = 512;
+   FramePool<IqBuffer> _channelPool{CHANNEL_POOL_DEPTH};
+   // One stitched frame per pass; passes are slow, so a few suffice.
+   static constexpr std::size_t SWEEP_POOL_DEPTH = 4;
+   FramePool<SpectrumData> _sweepPool{SWEEP_POOL_DEPTH};
+   FramePool<SpectrumData> _zoomSpectrumPool{FRAME_POOL_DEPTH};
+   FramePool<DetectionReport> _detectionPool{FRAME_POOL_DEPTH};
+   FramePool<IqBuffer> _displayIqPool{FRAME_POOL_DEPTH};
+
+   // -- Pipeline stages -----------------------------------------------------
+   using FrameQueue = CommonUtils::BoundedQueue<std::shared_ptr<const IqBuffer>>;
+   static constexpr std::size_t STAGE_QUEUE_DEPTH = 8;
+   FrameQueue _fftQueue{STAGE_QUEUE_DEPTH};
+   FrameQueue _filterQueue{STAGE_QUEUE_DEPTH};
+   FrameQueue _channelizerQueue{STAGE_QUEUE_DEPTH};
+   FrameQueue _vfoQueue{STAGE_QUEUE_DEPTH};
+   // Published spectra for the detector; never blocks the FFT stage.
+   CommonUtils::BoundedQueue<std::shared_ptr<const SpectrumData>> _detectorQueue{STAGE_QUEUE_DEPTH};
+
+   PipelineStageCounters _conditioningCounters;
+   PipelineStageCounters _fftCounters;
+   PipelineStageCounters _filterCounters;
+   PipelineStageCounters _channelizerCounters;
+   PipelineStageCounters _vfoCounters;
+   PipelineStageCounters _detectorCounters;
+   PipelineStageCounters _sweepCounters;
+
+   std::thread _conditioningThread;
+   std::thread _fftThread;
+   std::thread _filterThread;
+   std::thread _channelizerThread;
+   std::thread _vfoThread;
+   std::thread _detectorThread;
+   std::thread _snapshotThread;
    std::atomic<bool> _running{false};
 
    // -- Cached tuning info --------------------------------------------------
    std::atomic<uint64_t> _centerFreqHz{100'000'000};   // 100 MHz default
    std::atomic<uint32_t> _sampleRateHz{2'400'000};     // 2.4 MS/s default
 
-   // -- FFT averaging -------------------------------------------------------
-   std::atomic<float> _fftAlpha{0.0F};                 // 0.0 = no averaging
-   std::mutex _avgMutex;
-   std::vector<float> _fftAverage;                     // Running average buffer
+   // -- Spectrum averaging and hold traces ----------------------------------
+   SpectrumStatistics _spectrumStats;
+   SpectrumLevelEstimator _spectrumLevels;
+   std::atomic<bool> _spectrumPyramidEnabled{false};
+
+   // -- Welch framing -------------------------------------------------------
+   std::atomic<float> _fftOverlapPercent{0.0F};        // 0 = no overlap
+   std::atomic<float> _spectrumOutputRate{0.0F};       // 0 = every segment
+
+   // -- Load control --------------------------------------------------------
+   FftLoadController _loadController;                  // FFT thread only.
+   std::atomic<bool> _loadControlEnabled{false};
+   std::atomic<bool> _loadControlRestartPending{false};   // Reconfigure, lift every limit.
+   mutable std::mutex _loadControlMutex;
+   FftLoadConfig _loadControlConfig;                   // Guarded by _loadControlMutex.
+   EngineLoadControlStats _loadControlStats;           // Guarded by _loadControlMutex.
 
    // -- DC spike removal ----------------------------------------------------
    std::atomic<bool> _dcSpikeRemovalEnabled{true};     // Default: enabled
+   std::atomic<float> _dcTimeConstantSec{DEFAULT_DC_TIME_CONSTANT_S};
+   DcBlockerState _dcState;                            // Ring producer (Cf32) or consumer (Cs16).
 
    // -- Channel filter -------------------------------------------------------
    ChannelFilter _channelFilter;
+
+   // -- Zoom FFT ------------------------------------------------------------
+   FftProcessor _zoomFft{DEFAULT_ZOOM_FFT_SIZE};
+   SpectrumStatistics _zoomStats;                      // Averaging only, no holds.
+   std::atomic<bool> _zoomFftEnabled{false};
+   std::atomic<bool> _zoomRestartPending{false};       // Drop the Welch state below.
+   // Welch state of the channel being zoomed.  Channel-filter thread only.
+   struct ZoomWelchState
+   {
+      std::vector<IqSample> history;                   // Samples not yet fully segmented.
+      std::vector<float> segmentPower;
+      std::vector<float> powerSum;                     // Since the last publication.
+      std::size_t segments{0};
+      double samplesSincePublish{0.0};
+      double centerFreqHz{0.0};                        // Of the filtered stream.
+      double sampleRateHz{0.0};
+   };
+   ZoomWelchState _zoom;
+
+   // -- Channelizer ---------------------------------------------------------
+   Channelizer _channelizer;
+
+   // -- Signal detector -----------------------------------------------------
+   SignalDetector _detector;                           // Detector thread only (but config).
+   std::atomic<bool> _detectorEnabled{false};
+   std::atomic<bool> _detectorRestartPending{false};   // Drop the tracked events.
+
+   // -- Display tap ---------------------------------------------------------
+   DisplayIqTap _displayTap;
+   std::atomic<bool> _displayTapEnabled{false};
+   std::atomic<DisplayTapSource> _displayTapSource{DisplayTapSource::Wideband};
+
+   // -- Pre-trigger snapshots -----------------------------------------------
+   // A triggered window in absolute sample indices of the snapshot ring.
+   struct SnapshotJob
+   {
+      SnapshotRequest request;
+      uint64_t first{0};
+      uint64_t end{0};
+      double centerFreqHz{0.0};
+      double sampleRateHz{0.0};
+   };
+   static constexpr std::size_t SNAPSHOT_QUEUE_DEPTH = 16;
+   static constexpr std::size_t SNAPSHOT_CHUNK_SAMPLES = std::size_t{1} << 18;
+   IqSnapshotRing _snapshotRing;                       // Sized on start().
+   CommonUtils::BoundedQueue<SnapshotJob> _snapshotQueue{SNAPSHOT_QUEUE_DEPTH};
+   std::atomic<double> _snapshotHistorySec{0.0};
+   std::atomic<SnapshotStorage> _snapshotStorage{SnapshotStorage::Cf32};
+   std::atomic<uint64_t> _snapshotsTriggered{0};
+   std::atomic<uint64_t> _snapshotsRejected{0};
+   std::atomic<uint64_t> _snapshotsCompleted{0};
+   std::atomic<uint64_t> _snapshotsFailed{0};
+   std::atomic<uint64_t> _snapshotSamplesWritten{0};
+   std::atomic<uint64_t> _snapshotSamplesLost{0};
+
+   // -- Wideband sweep ------------------------------------------------------
+   SweepConfig _sweepConfig;                           // Set while stopped.
+   SpectrumSweep _sweep;                               // Re-planned on start().
+   std::atomic<bool> _sweepEnabled{false};
+   std::atomic<uint64_t> _sweepPasses{0};
+   std::atomic<uint64_t> _sweepLastPassNs{0};
+   std::atomic<uint64_t> _sweepTotalPassNs{0};
+
+   // -- Latency tracing -----------------------------------------------------
+   std::atomic<bool> _latencyTracing{false};
+   StageLatencyHistograms _spectrumLatency;
+   StageLatencyHistograms _iqLatency;
+   StageLatencyHistograms _filteredIqLatency;
+
+   // -- VFOs ----------------------------------------------------------------
+   mutable std::mutex _vfoMutex;
+   std::vector<std::shared_ptr<Vfo>> _vfos;            // Guarded by _vfoMutex.
+   int _nextVfoId{0};                                  // Guarded by _vfoMutex.
+   std::atomic<std::size_t> _vfoCount{0};
+   std::unique_ptr<CommonUtils::WorkerPool> _vfoWorkers;   // Lives while running.
+
+   // -- Demodulation --------------------------------------------------------
+   std::mutex _demodExecutorMutex;
+   std::unique_ptr<DemodExecutor> _demodExecutor;      // Created on first use.
 };
 
 } // namespace SdrEngine
@@ -4,6 +4,7 @@
 // System headers
 #include <chrono>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -14,6 +15,59 @@ namespace SdrEngine
 /** @brief Single I/Q sample as interleaved float. */
 using IqSample = std::complex<float>;
 
+/** @brief Wire format of I/Q samples as delivered by a device driver. */
+enum class IqSampleFormat : uint8_t
+{
+   CF32,   ///< Interleaved 32-bit float (IqSample layout).
+   CS16,   ///< Interleaved signed 16-bit integer.
+   CS8     ///< Interleaved signed 8-bit integer.
+};
+
+/** @brief How I/Q samples are held in the engine's rings and recordings. */
+enum class IqStorage : uint8_t
+{
+   Cf32,   ///< IqSample as is (8 bytes per sample).
+   Cs16    ///< Interleaved int16 (4 bytes per sample), converted to float where processed.
+};
+
+/** @brief The int16 value that IqStorage::Cs16 maps to 1.0 unless stated otherwise. */
+constexpr float CS16_FULL_SCALE = 32767.0F;
+
+/**
+ * @class RawIqBlock
+ * @brief A block of interleaved I/Q samples in a device's native format.
+ */
+struct RawIqBlock
+{
+   const void* data{nullptr};
+   IqSampleFormat format{IqSampleFormat::CF32};
+   std::size_t numSamples{0};   ///< Complex samples (I/Q pairs).
+   float fullScale{1.0F};       ///< Integer magnitude that maps to 1.0.
+};
+
+/**
+ * @class StageTimestamps
+ * @brief When a frame passed each SdrEngine pipeline stage.
+ *
+ * Only stamped while latency tracing is enabled
+ * (SdrEngine::setLatencyTracingEnabled()); otherwise every field is the
+ * default (epoch) time_point.  Frames derived from another frame inherit
+ * its `deviceRead` and `ringDequeue`.  Listener start / end are measured by
+ * the engine around the DataHandler dispatch and are not stored here.
+ */
+struct StageTimestamps
+{
+   using TimePoint = std::chrono::steady_clock::time_point;
+
+   TimePoint deviceRead;    ///< Device callback delivered the frame's newest sample.
+   TimePoint ringDequeue;   ///< Conditioning stage took the frame from the sample ring.
+   TimePoint processed;     ///< Producing stage finished its DSP (FFT, filter, ...).
+   TimePoint published;     ///< Frame handed to its DataHandler.
+
+   /** @brief True if the frame was stamped (tracing was enabled). */
+   [[nodiscard]] bool isTraced() const { return ringDequeue != TimePoint{}; }
+};
+
 /**
  * @class IqBuffer
  * @brief A chunk of I/Q samples with metadata.
@@ -24,6 +78,45 @@ struct IqBuffer
    double centerFreqHz{0.0};
    double sampleRateHz{0.0};
    std::chrono::steady_clock::time_point timestamp;
+   StageTimestamps stages;   ///< Latency trace (see StageTimestamps).
+
+   /**
+    * @brief Earliest known time the block's newest sample was in hand: the
+    *        device read when traced, otherwise the ring dequeue `timestamp`.
+    */
+   [[nodiscard]] std::chrono::steady_clock::time_point sourceTime() const
+   {
+      return (stages.deviceRead != StageTimestamps::TimePoint{}) ? stages.deviceRead : timestamp;
+   }
+};
+
+/**
+ * @class SpectrumTier
+ * @brief One level of a SpectrumData resolution pyramid.
+ */
+struct SpectrumTier
+{
+   std::size_t binsPerPoint{0};   ///< Full-resolution bins merged into each point.
+   std::vector<float> maxDb;      ///< Peak of each group.
+   std::vector<float> minDb;      ///< Minimum of each group.
+   std::vector<float> meanDb;     ///< Mean of each group (of the dB values).
+};
+
+/**
+ * @class SpectrumLevels
+ * @brief Noise floor and band power measured by the engine on a spectrum
+ *        (see SdrEngine::setSpectrumLevelsEnabled()).
+ */
+struct SpectrumLevels
+{
+   bool valid{false};          ///< False while the measurement is disabled.
+   float noiseFloorDb{0.0F};   ///< Running percentile of the bins, per bin.
+   bool hasBand{false};        ///< A measurement band is set and overlaps the span.
+   double bandLowHz{0.0};      ///< First and last bin centre inside the band.
+   double bandHighHz{0.0};
+   std::size_t bandBins{0};    ///< Bins summed into bandPowerDb.
+   float bandPowerDb{0.0F};    ///< Total power of the band's bins.
+   float bandNoiseDb{0.0F};    ///< noiseFloorDb integrated over the same bins.
 };
 
 /**
@@ -33,9 +126,14 @@ struct IqBuffer
 struct SpectrumData
 {
    std::vector<float> magnitudesDb;   ///< Power in dB (typically negative).
+   std::vector<float> maxHoldDb;      ///< Decaying peak-hold trace (empty when disabled).
+   std::vector<float> minHoldDb;      ///< Minimum-hold trace (empty when disabled).
+   std::vector<SpectrumTier> tiers;   ///< Halving pyramid, finest first (empty when disabled).
+   SpectrumLevels levels;             ///< Noise floor and band power (invalid when disabled).
    double centerFreqHz{0.0};
    double bandwidthHz{0.0};
    size_t fftSize{0};
+   StageTimestamps stages;   ///< Of the newest I/Q frame in the average.
 };
 
 /** @brief FFT windowing function choices. */
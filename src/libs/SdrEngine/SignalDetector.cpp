@@ -0,0 +1,350 @@
+// Project headers
+#include "SignalDetector.h"
+#include "DspKernels.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Most events tracked at once; further detections are ignored until some
+// end.  Bounds the matching cost when the threshold is set into the noise.
+constexpr std::size_t MAX_TRACKS = 1024;
+
+// OS-CFAR ranks the references on a histogram of this resolution (the
+// noise estimate is the middle of the ranked bucket).
+constexpr float OS_LOWEST_DB     = -200.0F;
+constexpr float OS_BUCKET_DB     = 0.25F;
+constexpr std::size_t OS_BUCKETS = 1000;   // Up to +50 dB.
+
+} // anonymous namespace
+
+// ============================================================================
+// Settings
+// ============================================================================
+
+void SignalDetector::setConfig(const DetectorConfig& config)
+{
+   DetectorConfig clean = config;
+   clean.referenceBins  = std::max<std::size_t>(clean.referenceBins, 1);
+   clean.osRank         = std::clamp(clean.osRank, 0.0F, 1.0F);
+   clean.hysteresisDb   = std::max(clean.hysteresisDb, 0.0F);
+   clean.minBins        = std::max<std::size_t>(clean.minBins, 1);
+   clean.confirmFrames  = std::max<std::size_t>(clean.confirmFrames, 1);
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   _config = clean;
+}
+
+DetectorConfig SignalDetector::config() const
+{
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   return _config;
+}
+
+const std::vector<float>& SignalDetector::excessDb() const
+{
+   return _excess;
+}
+
+std::size_t SignalDetector::trackedCount() const
+{
+   return _tracks.size();
+}
+
+void SignalDetector::reset()
+{
+   _tracks.clear();
+   _clusters.clear();
+   _excess.clear();
+   _frames = 0;
+}
+
+// ============================================================================
+// Detection
+// ============================================================================
+
+bool SignalDetector::process(const SpectrumData& frame, DetectionReport& report,
+                             std::chrono::steady_clock::time_point now)
+{
+   const DetectorConfig config = this->config();
+   report.events.clear();
+   report.centerFreqHz = frame.centerFreqHz;
+   report.bandwidthHz  = frame.bandwidthHz;
+   report.fftSize      = frame.magnitudesDb.size();
+   report.frame        = _frames++;
+   report.stages       = frame.stages;
+
+   // A frame too short for the reference windows detects nothing; tracked
+   // events then run out their hold frames.
+   _clusters.clear();
+   if (computeExcess(frame.magnitudesDb.data(), frame.magnitudesDb.size(), config))
+   {
+      findClusters(config);
+   }
+   updateTracks(config, frame, report, now);
+   return !report.events.empty();
+}
+
+bool SignalDetector::computeExcess(const float* db, std::size_t n, const DetectorConfig& config)
+{
+   const std::size_t w     = config.referenceBins;
+   const std::size_t g     = config.guardBins;
+   const std::size_t reach = g + w;   // From a bin to the far end of a reference window.
+   if (n <= 2 * reach)
+   {
+      _excess.clear();
+      return false;
+   }
+   _excess.resize(n);
+   float* excess = _excess.data();
+
+   if (config.method == CfarMethod::OrderedStatistic)
+   {
+      orderedStatisticNoise(db, n, config);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         excess[i] = db[i] - _noise[i];
+      }
+      return true;
+   }
+
+   // _sums[j] sums bins [j, j + w): bin i leads with _sums[i - reach] and
+   // lags with _sums[i + g + 1].  Near the edges only one side exists.
+   _sums.resize(n - w + 1);
+   const float* sums = _sums.data();
+   slidingSum(db, _sums.data(), _sums.size(), w);
+   excessOverReference(db + reach, sums, sums + reach + g + 1, excess + reach, n - (2 * reach),
+                       0.5F / static_cast<float>(w));
+   const float oneSide = 1.0F / static_cast<float>(w);
+   for (std::size_t i = 0; i < reach; ++i)
+   {
+      excess[i] = db[i] - (sums[i + g + 1] * oneSide);
+      const std::size_t j = n - reach + i;
+      excess[j] = db[j] - (sums[j - reach] * oneSide);
+   }
+   return true;
+}
+
+void SignalDetector::orderedStatisticNoise(const float* db, std::size_t n,
+                                           const DetectorConfig& config)
+{
+   const std::size_t w     = config.referenceBins;
+   const std::size_t g     = config.guardBins;
+   const std::size_t reach = g + w;
+   _noise.resize(n);
+   _buckets.resize(n);
+   _counts.assign(OS_BUCKETS, 0);
+   histogramBuckets(db, _buckets.data(), n, OS_LOWEST_DB, 1.0F / OS_BUCKET_DB,
+                    static_cast<uint16_t>(OS_BUCKETS - 1));
+
+   // The references of bin i, clipped to the frame, as a histogram.  The
+   // ranked bucket `rank` moves only as far as the distribution does.
+   std::size_t size  = 0;
+   std::size_t rank  = 0;
+   std::size_t below = 0;   // References in buckets under `rank`.
+   const auto add = [&](std::size_t bin) {
+      const uint16_t b = _buckets[bin];
+      ++_counts[b];
+      ++size;
+      below += (b < rank) ? 1U : 0U;
+   };
+   const auto remove = [&](std::size_t bin) {
+      const uint16_t b = _buckets[bin];
+      --_counts[b];
+      --size;
+      below -= (b < rank) ? 1U : 0U;
+   };
+
+   for (std::size_t i = g + 1; i < std::min(n, reach + 1); ++i)
+   {
+      add(i);   // Lag window of bin 0.
+   }
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const auto k = static_cast<std::size_t>(
+         std::lround(config.osRank * static_cast<float>(size - 1)));
+      while (below > k)
+      {
+         below -= _counts[--rank];
+      }
+      while (below + _counts[rank] <= k)
+      {
+         below += _counts[rank++];
+      }
+      _noise[i] = OS_LOWEST_DB + ((static_cast<float>(rank) + 0.5F) * OS_BUCKET_DB);
+
+      // Slide both windows to bin i + 1.
+      if (i >= reach)
+      {
+         remove(i - reach);
+      }
+      if (i >= g)
+      {
+         add(i - g);
+      }
+      if (i + g + 1 < n)
+      {
+         remove(i + g + 1);
+      }
+      if (i + reach + 1 < n)
+      {
+         add(i + reach + 1);
+      }
+   }
+}
+
+void SignalDetector::findClusters(const DetectorConfig& config)
+{
+   const float* excess = _excess.data();
+   const std::size_t n = _excess.size();
+   const float holdDb  = config.thresholdDb - config.hysteresisDb;
+   std::size_t pos     = 0;
+
+   while (pos < n)
+   {
+      pos += findFirstAtLeast(excess + pos, n - pos, holdDb);
+      if (pos >= n)
+      {
+         break;
+      }
+      Cluster run{pos, pos, pos, false};
+      for (; pos < n && excess[pos] >= holdDb; ++pos)
+      {
+         run.peak   = (excess[pos] > excess[run.peak]) ? pos : run.peak;
+         run.strong = run.strong || excess[pos] >= config.thresholdDb;
+      }
+      run.last = pos - 1;
+
+      if (!_clusters.empty() && run.first - _clusters.back().last - 1 <= config.mergeGapBins)
+      {
+         Cluster& prev = _clusters.back();
+         prev.last   = run.last;
+         prev.peak   = (excess[run.peak] > excess[prev.peak]) ? run.peak : prev.peak;
+         prev.strong = prev.strong || run.strong;
+      }
+      else
+      {
+         _clusters.push_back(run);
+      }
+   }
+
+   std::erase_if(_clusters, [&config](const Cluster& c)
+                 { return c.last - c.first + 1 < config.minBins; });
+}
+
+void SignalDetector::updateTracks(const DetectorConfig& config, const SpectrumData& frame,
+                                  DetectionReport& report,
+                                  std::chrono::steady_clock::time_point now)
+{
+   const std::size_t n    = frame.magnitudesDb.size();
+   const double hzPerBin  = (n > 0) ? frame.bandwidthHz / static_cast<double>(n) : 0.0;
+   const double tolerance = static_cast<double>(config.mergeGapBins) * hzPerBin;
+   const auto binHz = [&frame, n, hzPerBin](std::size_t bin) {
+      return frame.centerFreqHz +
+             ((static_cast<double>(bin) - static_cast<double>(n / 2)) * hzPerBin);
+   };
+   const auto describe = [&](const Cluster& c, SignalEvent& event) {
+      const double low  = binHz(c.first) - (hzPerBin / 2.0);
+      const double high = binHz(c.last) + (hzPerBin / 2.0);
+      event.centerHz    = (low + high) / 2.0;
+      event.bandwidthHz = high - low;
+      event.peakHz      = binHz(c.peak);
+      event.snrDb       = _excess[c.peak];
+      event.peakDb      = frame.magnitudesDb[c.peak];
+      event.noiseDb     = event.peakDb - event.snrDb;
+   };
+
+   for (Track& track : _tracks)
+   {
+      track.matched = false;
+   }
+
+   // Clusters and tracks both ascend in frequency; each cluster continues
+   // the first unmatched track it overlaps.
+   const std::size_t existing = _tracks.size();
+   std::size_t firstCandidate = 0;
+   for (const Cluster& c : _clusters)
+   {
+      const double low  = binHz(c.first) - (hzPerBin / 2.0);
+      const double high = binHz(c.last) + (hzPerBin / 2.0);
+      while (firstCandidate < existing && _tracks[firstCandidate].matched &&
+             _tracks[firstCandidate].highHz + tolerance < low)
+      {
+         ++firstCandidate;
+      }
+
+      Track* match = nullptr;
+      for (std::size_t t = firstCandidate; t < existing && _tracks[t].lowHz - tolerance <= high; ++t)
+      {
+         if (!_tracks[t].matched && _tracks[t].highHz + tolerance >= low)
+         {
+            match = &_tracks[t];
+            break;
+         }
+      }
+
+      if (match == nullptr)
+      {
+         // Only a full-threshold detection opens an event.
+         if (!c.strong || _tracks.size() >= MAX_TRACKS)
+         {
+            continue;
+         }
+         Track track;
+         track.event.id        = _nextId++;
+         track.event.firstSeen = now;
+         _tracks.push_back(track);
+         match = &_tracks.back();
+      }
+
+      Track& track = *match;
+      describe(c, track.event);
+      track.lowHz            = low;
+      track.highHz           = high;
+      track.misses           = 0;
+      track.matched          = true;
+      track.event.lastSeen   = now;
+      ++track.event.frames;
+      if (track.confirmed)
+      {
+         track.event.state = SignalEventState::Active;
+         report.events.push_back(track.event);
+      }
+      else if (track.event.frames >= config.confirmFrames)
+      {
+         track.confirmed   = true;
+         track.event.state = SignalEventState::Started;
+         report.events.push_back(track.event);
+      }
+   }
+
+   // Tracks not seen this frame: unconfirmed ones were not consecutive and
+   // are dropped; confirmed ones hold, then end.
+   std::erase_if(_tracks, [&config, &report](Track& track) {
+      if (track.matched)
+      {
+         return false;
+      }
+      if (!track.confirmed)
+      {
+         return true;
+      }
+      ++track.misses;
+      track.event.state = (track.misses > config.holdFrames) ? SignalEventState::Ended
+                                                             : SignalEventState::Active;
+      report.events.push_back(track.event);
+      return track.event.state == SignalEventState::Ended;
+   });
+
+   std::sort(_tracks.begin(), _tracks.end(),
+             [](const Track& a, const Track& b) { return a.lowHz < b.lowHz; });
+   std::sort(report.events.begin(), report.events.end(),
+             [](const SignalEvent& a, const SignalEvent& b) { return a.centerHz < b.centerHz; });
+}
+
+} // namespace SdrEngine
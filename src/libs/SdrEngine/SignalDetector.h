@@ -0,0 +1,205 @@
+#ifndef SIGNALDETECTOR_H_
+#define SIGNALDETECTOR_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/** @brief How a CFAR detector estimates the noise around each bin. */
+enum class CfarMethod : uint8_t
+{
+   CellAveraging,     ///< Mean of the reference bins (CA-CFAR).
+   OrderedStatistic   ///< A rank of the sorted reference bins (OS-CFAR).
+};
+
+/**
+ * @class DetectorConfig
+ * @brief Parameters of SignalDetector.
+ */
+struct DetectorConfig
+{
+   CfarMethod method{CfarMethod::CellAveraging};
+   std::size_t referenceBins{32};   ///< Noise reference bins on each side of a bin.
+   std::size_t guardBins{4};        ///< Bins skipped between a bin and its references.
+   float osRank{0.75F};             ///< OS-CFAR: rank of the noise estimate, as a fraction.
+   float thresholdDb{10.0F};        ///< Excess over the noise that opens a detection.
+   float hysteresisDb{3.0F};        ///< A detection holds down to thresholdDb - hysteresisDb.
+   std::size_t mergeGapBins{2};     ///< Detections this close are one signal.
+   std::size_t minBins{1};          ///< Narrower detections are ignored.
+   std::size_t confirmFrames{2};    ///< Consecutive frames before an event is reported.
+   std::size_t holdFrames{3};       ///< Missed frames before an event ends.
+};
+
+/** @brief Life cycle of a SignalEvent. */
+enum class SignalEventState : uint8_t
+{
+   Started,   ///< First report of a confirmed signal.
+   Active,    ///< Still present in this frame (or within its hold frames).
+   Ended      ///< Last report: missed for more than DetectorConfig::holdFrames.
+};
+
+/**
+ * @class SignalEvent
+ * @brief One signal found by SignalDetector, tracked across frames.
+ */
+struct SignalEvent
+{
+   uint64_t id{0};                 ///< Stable for the event's lifetime.
+   SignalEventState state{SignalEventState::Started};
+   double centerHz{0.0};           ///< Middle of the detected bins (absolute).
+   double bandwidthHz{0.0};        ///< Span of the detected bins.
+   double peakHz{0.0};             ///< Bin with the largest excess over the noise.
+   float snrDb{0.0F};              ///< Largest excess over the noise estimate.
+   float peakDb{0.0F};             ///< Level at peakHz.
+   float noiseDb{0.0F};            ///< Noise estimate at peakHz.
+   uint64_t frames{0};             ///< Frames the signal was detected in.
+   std::chrono::steady_clock::time_point firstSeen;
+   std::chrono::steady_clock::time_point lastSeen;
+};
+
+/**
+ * @class DetectionReport
+ * @brief The events of one analysed SpectrumData frame.
+ */
+struct DetectionReport
+{
+   std::vector<SignalEvent> events;   ///< Started, active and just-ended events, by frequency.
+   double centerFreqHz{0.0};          ///< Tuning of the analysed frame.
+   double bandwidthHz{0.0};
+   std::size_t fftSize{0};
+   uint64_t frame{0};                 ///< Frames analysed before this one.
+   StageTimestamps stages;            ///< Of the analysed spectrum.
+};
+
+/**
+ * @class SignalDetector
+ * @brief CFAR detection on spectrum frames, clustered into tracked events.
+ *
+ * Each bin's excess over its noise estimate is compared with a threshold.
+ * The noise comes from `referenceBins` on both sides, `guardBins` away
+ * (one side only near the edges).  The detector works on the dB trace
+ * (log-CFAR), so thresholds are plain dB and no bin is converted to linear:
+ *   - CellAveraging: the mean of the reference bins.  Both windows come out
+ *     of one slidingSum() pass, and excessOverReference() forms every
+ *     bin's excess, so a 64K-bin frame costs a few vector passes.
+ *   - OrderedStatistic: the `osRank` quantile of the reference bins, which
+ *     ignores strong neighbours.  The bins are bucketed to 0.25 dB with
+ *     histogramBuckets() and the references kept as a histogram that slides
+ *     with the bin, so finding the rank costs a few steps per bin rather
+ *     than a sort (the estimate is within 0.125 dB).
+ *
+ * Hysteresis in frequency: a run of bins at least `thresholdDb -
+ * hysteresisDb` over the noise is a detection if one of its bins reaches
+ * `thresholdDb`, or if it continues an event already reported.  Runs at
+ * most `mergeGapBins` apart merge.  findFirstAtLeast() skips the noise
+ * between runs a vector at a time.
+ *
+ * Hysteresis in time: detections are matched to tracked events by
+ * overlapping frequency.  An event is reported (Started) after
+ * `confirmFrames` consecutive frames and ends (Ended) after missing more
+ * than `holdFrames`; in between it is reported as Active every frame.
+ * Events are tracked in absolute frequency, so they survive retuning as
+ * long as they stay in the span.
+ *
+ * Thread-safety: setConfig() / config() from any thread; process() and
+ * reset() from one thread.
+ */
+class SignalDetector
+{
+public:
+   /**
+    * @brief Replace the configuration; takes effect with the next frame.
+    * Zero `confirmFrames` or `minBins` count as 1; `osRank` is clamped to [0, 1].
+    */
+   void setConfig(const DetectorConfig& config);
+
+   /**
+    * @brief Get the configuration.
+    * @return Current configuration.
+    */
+   [[nodiscard]] DetectorConfig config() const;
+
+   /**
+    * @brief Analyse one frame and report the events it changes.
+    * @param frame   Spectrum with `magnitudesDb` and tuning set.
+    * @param report  Filled with the frame's events (cleared first).
+    * @param now     Time stamped into started / seen events.
+    * @return true if the report holds any event.
+    */
+   bool process(const SpectrumData& frame, DetectionReport& report,
+                std::chrono::steady_clock::time_point now);
+
+   /**
+    * @brief Get the excess over the noise of each bin of the last frame.
+    * @return Per-bin excess in dB (empty before the first frame).
+    */
+   [[nodiscard]] const std::vector<float>& excessDb() const;
+
+   /**
+    * @brief Get the number of events being tracked, confirmed or not.
+    * @return Tracked events.
+    */
+   [[nodiscard]] std::size_t trackedCount() const;
+
+   /** @brief Forget every event without reporting it. */
+   void reset();
+
+private:
+   // A run of detected bins in the current frame.
+   struct Cluster
+   {
+      std::size_t first{0};   // First bin.
+      std::size_t last{0};    // Last bin (inclusive).
+      std::size_t peak{0};    // Bin of the largest excess.
+      bool strong{false};     // Some bin reaches the full threshold.
+   };
+
+   // An event across frames.
+   struct Track
+   {
+      SignalEvent event;
+      double lowHz{0.0};
+      double highHz{0.0};
+      std::size_t misses{0};
+      bool confirmed{false};
+      bool matched{false};
+   };
+
+   // Fill _excess for the frame.  false if the frame is too short.
+   bool computeExcess(const float* db, std::size_t n, const DetectorConfig& config);
+   void orderedStatisticNoise(const float* db, std::size_t n, const DetectorConfig& config);
+
+   // Runs of _excess at or above the hold threshold into _clusters.
+   void findClusters(const DetectorConfig& config);
+
+   // Match _clusters to _tracks and emit the changes into `report`.
+   void updateTracks(const DetectorConfig& config, const SpectrumData& frame,
+                     DetectionReport& report, std::chrono::steady_clock::time_point now);
+
+   mutable std::mutex _configMutex;
+   DetectorConfig _config;
+
+   // process() thread only.
+   std::vector<float> _sums;      // Sliding sums of the reference windows.
+   std::vector<float> _excess;    // Per-bin excess over the noise.
+   std::vector<float> _noise;     // OS-CFAR noise estimate.
+   std::vector<uint16_t> _buckets;   // OS-CFAR histogram bucket of each bin.
+   std::vector<uint32_t> _counts;    // OS-CFAR sliding reference histogram.
+   std::vector<Cluster> _clusters;
+   std::vector<Track> _tracks;    // Sorted by lowHz.
+   uint64_t _nextId{1};
+   uint64_t _frames{0};
+};
+
+} // namespace SdrEngine
+
+#endif // SIGNALDETECTOR_H_
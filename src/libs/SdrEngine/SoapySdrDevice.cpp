@@ -1,11 +1,14 @@
 // Project headers
 #include "SoapySdrDevice.h"
+#include "DspKernels.h"
 #include "GeneralLogger.h"
+#include "ThreadConfig.h"
 
 // Third-party headers
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcpp"
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/Errors.hpp>
 #include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Types.hpp>
 #include <SoapySDR/Version.hpp>
@@ -14,11 +17,89 @@
 // System headers
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 #include <utility>
 
 namespace SdrEngine
 {
 
+namespace
+{
+
+// Last SoapySDR::Device::enumerate() result, shared by every instance.
+struct ProbeCache
+{
+   std::mutex probeMutex;   // Serialises enumerate(); held for the whole probe.
+   std::mutex mutex;        // Guards the fields below; never held while probing.
+   bool valid{false};
+   SoapySDR::KwargsList results;
+};
+
+ProbeCache& probeCache()
+{
+   static ProbeCache cache;
+   return cache;
+}
+
+// Device arguments from the cache, probing first if `refresh` is set or
+// nothing is cached.  A caller that arrives while another thread probes
+// waits for that probe and, unless refreshing, uses its result.
+SoapySDR::KwargsList probedArgs(bool refresh)
+{
+   ProbeCache& cache = probeCache();
+   const std::lock_guard<std::mutex> probeLock(cache.probeMutex);
+   if (!refresh)
+   {
+      const std::lock_guard<std::mutex> lock(cache.mutex);
+      if (cache.valid)
+      {
+         return cache.results;
+      }
+   }
+
+   auto results = SoapySDR::Device::enumerate();
+   const std::lock_guard<std::mutex> lock(cache.mutex);
+   cache.results = results;
+   cache.valid   = true;
+   return results;
+}
+
+std::vector<DeviceInfo> toDeviceInfos(const SoapySDR::KwargsList& results)
+{
+   std::vector<DeviceInfo> devices;
+   devices.reserve(results.size());
+
+   for (std::size_t i = 0; i < results.size(); ++i)
+   {
+      const auto& args = results[i];
+      DeviceInfo info;
+      info.index = static_cast<int>(i);
+
+      auto it = args.find("label");
+      info.name = (it != args.end()) ? it->second : "Unknown";
+
+      it = args.find("driver");
+      info.manufacturer = (it != args.end()) ? it->second : "";
+
+      it = args.find("product");
+      if (it != args.end())
+      {
+         info.product = it->second;
+      }
+
+      it = args.find("serial");
+      if (it != args.end())
+      {
+         info.serial = it->second;
+      }
+
+      devices.push_back(std::move(info));
+   }
+   return devices;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // Construction / destruction
 // ============================================================================
@@ -49,28 +130,40 @@ bool SoapySdrDevice::open(int deviceIndex)
       SoapySdrDevice::close();
    }
 
-   // Enumerate all available devices.
-   const auto results = SoapySDR::Device::enumerate();
+   if (deviceIndex < 0)
+   {
+      GPERROR("Device index {} out of range", deviceIndex);
+      return false;
+   }
+   const auto index = static_cast<std::size_t>(deviceIndex);
+
+   // Reuse the last probe; probe again only if it does not cover the index.
+   auto results = probedArgs(false);
+   if (index >= results.size())
+   {
+      results = probedArgs(true);
+   }
    if (results.empty())
    {
       GPERROR("No SoapySDR devices found");
       return false;
    }
-
-   if (deviceIndex < 0 ||
-       static_cast<std::size_t>(deviceIndex) >= results.size())
+   if (index >= results.size())
    {
       GPERROR("Device index {} out of range (found {})",
               deviceIndex, results.size());
       return false;
    }
 
-   const auto& args = results[static_cast<std::size_t>(deviceIndex)];
+   const auto& args = results[index];
 
    auto* dev = SoapySDR::Device::make(args);
    if (dev == nullptr)
    {
       GPERROR("SoapySDR::Device::make() returned nullptr");
+      // The cached arguments may be stale (device unplugged); re-probe next time.
+      const std::lock_guard<std::mutex> lock(probeCache().mutex);
+      probeCache().valid = false;
       return false;
    }
    _device = dev;
@@ -270,6 +363,18 @@ std::vector<int> SoapySdrDevice::getGainValues() const
 
 bool SoapySdrDevice::startStreaming(IqCallback callback,
                                    std::size_t bufferSize)
+{
+   return beginStreaming(std::move(callback), nullptr, bufferSize);
+}
+
+bool SoapySdrDevice::startRawStreaming(RawIqCallback callback,
+                                      std::size_t bufferSize)
+{
+   return beginStreaming(nullptr, std::move(callback), bufferSize);
+}
+
+bool SoapySdrDevice::beginStreaming(IqCallback callback, RawIqCallback rawCallback,
+                                   std::size_t bufferSize)
 {
    if (_device == nullptr)
    {
@@ -282,12 +387,34 @@ bool SoapySdrDevice::startStreaming(IqCallback callback,
       return false;
    }
 
-   // Set up the RX stream in CF32 (complex float 32-bit) format.
-   // This gives full-precision I/Q samples without any lossy conversion.
-   _stream = _device->setupStream(SOAPY_SDR_RX, SOAPY_SDR_CF32);
+   // Request the hardware's native integer format so the driver hands over
+   // its buffers without an extra float conversion pass.  CS12 and other
+   // packed formats are requested as CS16, which every such driver offers.
+   double fullScale = 0.0;
+   const std::string native = _device->getNativeStreamFormat(SOAPY_SDR_RX, 0, fullScale);
+   std::string format = SOAPY_SDR_CF32;
+   _streamFormat = IqSampleFormat::CF32;
+   _fullScale    = 1.0F;
+   if (fullScale > 0.0)
+   {
+      if (native == SOAPY_SDR_CS8)
+      {
+         format        = SOAPY_SDR_CS8;
+         _streamFormat = IqSampleFormat::CS8;
+      }
+      else if (native == SOAPY_SDR_CS12 || native == SOAPY_SDR_CS16)
+      {
+         format        = SOAPY_SDR_CS16;
+         _streamFormat = IqSampleFormat::CS16;
+      }
+      _fullScale = (_streamFormat == IqSampleFormat::CF32) ? 1.0F
+                                                           : static_cast<float>(fullScale);
+   }
+
+   _stream = _device->setupStream(SOAPY_SDR_RX, format);
    if (_stream == nullptr)
    {
-      GPERROR("SoapySDR::Device::setupStream() failed");
+      GPERROR("SoapySDR::Device::setupStream({}) failed", format);
       return false;
    }
 
@@ -299,8 +426,12 @@ bool SoapySdrDevice::startStreaming(IqCallback callback,
       return false;
    }
 
-   _callback  = std::move(callback);
-   _streaming = true;
+   GPINFO("Streaming {} (native {}, full scale {})", format, native, _fullScale);
+
+   _callback    = std::move(callback);
+   _rawCallback = std::move(rawCallback);
+   _streaming   = true;
+   _streamCounters.start();
    _streamThread =
       std::thread(&SoapySdrDevice::streamThread, this, bufferSize);
    return true;
@@ -332,11 +463,29 @@ bool SoapySdrDevice::isStreaming() const
    return _streaming;
 }
 
+DeviceStreamStats SoapySdrDevice::getStreamStats() const
+{
+   return _streamCounters.snapshot();
+}
+
+void SoapySdrDevice::setStreamThreadRole(std::string role)
+{
+   _streamThreadRole = role.empty() ? std::string("SoapySdr.stream") : std::move(role);
+}
+
 void SoapySdrDevice::streamThread(std::size_t samplesPerBuffer)
 {
-   // CF32 buffer: each sample is float I + float Q = 8 bytes.
-   std::vector<float> cf32Buf(samplesPerBuffer * 2);
-   void* buffs[] = {cf32Buf.data()};
+   CommonUtils::configureCurrentThread(_streamThreadRole);
+   // Native-format buffer, sized for the widest format (CF32) so it is
+   // suitably aligned for every one.  Converted to IqSample only for
+   // startStreaming() consumers; raw consumers convert into their own storage.
+   std::vector<IqSample> rawBuf(samplesPerBuffer);
+   std::vector<IqSample> converted;
+   if (_callback && _streamFormat != IqSampleFormat::CF32)
+   {
+      converted.resize(samplesPerBuffer);
+   }
+   void* buffs[] = {rawBuf.data()};
 
    while (_streaming)
    {
@@ -345,11 +494,24 @@ void SoapySdrDevice::streamThread(std::size_t samplesPerBuffer)
       const auto numRead = _device->readStream(
          _stream, buffs, samplesPerBuffer, flags, timeNs, 100000);
 
+      if (numRead == SOAPY_SDR_TIMEOUT)
+      {
+         _streamCounters.recordTimeout();
+         continue;
+      }
+      if (numRead == SOAPY_SDR_OVERFLOW)
+      {
+         // The driver lost samples, but the stream keeps running.
+         _streamCounters.recordOverflow();
+         continue;
+      }
       if (numRead < 0)
       {
+         _streamCounters.recordError();
          if (_streaming)
          {
-            GPERROR("SoapySDR readStream error: {}", numRead);
+            GPERROR_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND, "SoapySDR readStream error: {} ({})",
+                            numRead, SoapySDR::errToStr(numRead));
          }
          break;
       }
@@ -357,14 +519,25 @@ void SoapySdrDevice::streamThread(std::size_t samplesPerBuffer)
       {
          continue;
       }
+      _streamCounters.recordRead(static_cast<std::size_t>(numRead), samplesPerBuffer);
 
-      // cf32Buf is interleaved float I/Q — reinterpret as IqSample.
-      const auto* samples =
-         reinterpret_cast<const IqSample*>(cf32Buf.data());
-
-      if (_callback)
+      const RawIqBlock block{rawBuf.data(), _streamFormat,
+                             static_cast<std::size_t>(numRead), _fullScale};
+      if (_rawCallback)
+      {
+         _rawCallback(block);
+      }
+      else if (_callback)
       {
-         _callback(samples, static_cast<std::size_t>(numRead));
+         if (_streamFormat == IqSampleFormat::CF32)
+         {
+            _callback(rawBuf.data(), block.numSamples);
+         }
+         else
+         {
+            convertToIq(block, 0, converted.data(), block.numSamples);
+            _callback(converted.data(), block.numSamples);
+         }
       }
    }
    _streaming = false;
@@ -385,37 +558,30 @@ std::string SoapySdrDevice::getName() const
 
 std::vector<DeviceInfo> SoapySdrDevice::enumerateDevices() const
 {
-   const auto results = SoapySDR::Device::enumerate();
-   std::vector<DeviceInfo> devices;
-   devices.reserve(results.size());
-
-   for (std::size_t i = 0; i < results.size(); ++i)
-   {
-      const auto& args = results[i];
-      DeviceInfo info;
-      info.index = static_cast<int>(i);
-
-      auto it = args.find("label");
-      info.name = (it != args.end()) ? it->second : "Unknown";
+   return probeDevices();
+}
 
-      it = args.find("driver");
-      info.manufacturer = (it != args.end()) ? it->second : "";
+// ============================================================================
+// Probe cache
+// ============================================================================
 
-      it = args.find("product");
-      if (it != args.end())
-      {
-         info.product = it->second;
-      }
+std::vector<DeviceInfo> SoapySdrDevice::probeDevices()
+{
+   return toDeviceInfos(probedArgs(true));
+}
 
-      it = args.find("serial");
-      if (it != args.end())
-      {
-         info.serial = it->second;
-      }
+std::vector<DeviceInfo> SoapySdrDevice::cachedDevices()
+{
+   ProbeCache& cache = probeCache();
+   const std::lock_guard<std::mutex> lock(cache.mutex);
+   return toDeviceInfos(cache.results);
+}
 
-      devices.push_back(std::move(info));
-   }
-   return devices;
+bool SoapySdrDevice::hasProbed()
+{
+   ProbeCache& cache = probeCache();
+   const std::lock_guard<std::mutex> lock(cache.mutex);
+   return cache.valid;
 }
 
 } // namespace SdrEngine
@@ -30,8 +30,15 @@ namespace SdrEngine
  * ADALM-PLUTO, HackRF, LimeSDR, Airspy, etc.).
  *
  * Streaming runs in a dedicated thread using readStream().
- * Samples are requested in CF32 format (native float) for full
- * precision — no lossy integer-to-float conversion is needed.
+ * Samples are requested in the hardware's native format (CS8 for RTL-SDR,
+ * CS16 for most others) so the driver does not convert to float on its own
+ * thread.  startRawStreaming() hands those blocks to the consumer as is;
+ * startStreaming() converts them with the vectorised DspKernels.
+ *
+ * Probing the SoapySDR modules can take seconds, so the last probe is
+ * cached process-wide: cachedDevices() returns it without touching the
+ * hardware, and open() takes the device arguments from it instead of
+ * probing again.  Run probeDevices() off the GUI thread.
  */
 class SoapySdrDevice : public ISdrDevice
 {
@@ -58,13 +65,45 @@ public:
 
    [[nodiscard]] bool startStreaming(IqCallback callback,
                                     std::size_t bufferSize = 8192) override;
+   [[nodiscard]] bool startRawStreaming(RawIqCallback callback,
+                                       std::size_t bufferSize = 8192) override;
    void stopStreaming() override;
    [[nodiscard]] bool isStreaming() const override;
+   [[nodiscard]] DeviceStreamStats getStreamStats() const override;
+   void setStreamThreadRole(std::string role) override;
 
    [[nodiscard]] std::string getName() const override;
+   /** @brief Probe the hardware (see probeDevices()). */
    [[nodiscard]] std::vector<DeviceInfo> enumerateDevices() const override;
 
+   // -- Probe cache ---------------------------------------------------------
+
+   /**
+    * @brief Probe every SoapySDR module and cache the result.
+    * Blocks for as long as the modules take (seconds for some); concurrent
+    * calls run one at a time.
+    * @return Devices found, indexed as open() expects.
+    */
+   [[nodiscard]] static std::vector<DeviceInfo> probeDevices();
+
+   /**
+    * @brief Get the result of the last probe without touching the hardware.
+    * @return Devices of the last probeDevices() / open(); empty before the first.
+    */
+   [[nodiscard]] static std::vector<DeviceInfo> cachedDevices();
+
+   /**
+    * @brief Check whether a probe has completed in this process.
+    * @return true once cachedDevices() reflects the hardware.
+    */
+   [[nodiscard]] static bool hasProbed();
+
 private:
+   // Pick the native stream format, set up and activate the RX stream, and
+   // launch the read thread.  Exactly one of the callbacks must be set.
+   [[nodiscard]] bool beginStreaming(IqCallback callback, RawIqCallback rawCallback,
+                                     std::size_t bufferSize);
+
    // Thread body that runs the synchronous read loop.
    void streamThread(std::size_t samplesPerBuffer);
 
@@ -77,8 +116,13 @@ private:
    std::string _deviceLabel;   ///< Human-readable name of opened device.
 
    std::atomic<bool> _streaming{false};
+   DeviceStreamCounters _streamCounters;   // Written by the stream thread.
    std::thread _streamThread;
-   IqCallback _callback;
+   std::string _streamThreadRole{"SoapySdr.stream"};   // Set while stopped.
+   IqCallback _callback;               ///< Set by startStreaming().
+   RawIqCallback _rawCallback;         ///< Set by startRawStreaming().
+   IqSampleFormat _streamFormat{IqSampleFormat::CF32};
+   float _fullScale{1.0F};             ///< Native integer full scale.
 };
 
 } // namespace SdrEngine
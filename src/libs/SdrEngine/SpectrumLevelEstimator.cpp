@@ -0,0 +1,209 @@
+// Project headers
+#include "SpectrumLevelEstimator.h"
+#include "DspKernels.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Smallest band power passed to the log, as in SpectrumStatistics.
+constexpr float POWER_FLOOR = 1.0e-30F;
+
+} // anonymous namespace
+
+// ============================================================================
+// Settings
+// ============================================================================
+
+void SpectrumLevelEstimator::setEnabled(bool enabled)
+{
+   _enabled = enabled;
+}
+
+bool SpectrumLevelEstimator::isEnabled() const
+{
+   return _enabled;
+}
+
+void SpectrumLevelEstimator::setPercentile(float percent)
+{
+   _percentile = std::clamp(percent, 1.0F, 99.0F);
+}
+
+float SpectrumLevelEstimator::getPercentile() const
+{
+   return _percentile;
+}
+
+void SpectrumLevelEstimator::setTimeConstant(float seconds)
+{
+   _timeConstantSec = std::max(seconds, 0.0F);
+}
+
+float SpectrumLevelEstimator::getTimeConstant() const
+{
+   return _timeConstantSec;
+}
+
+void SpectrumLevelEstimator::setBand(double minFreqHz, double maxFreqHz)
+{
+   if (minFreqHz > maxFreqHz)
+   {
+      std::swap(minFreqHz, maxFreqHz);
+   }
+   const std::lock_guard<std::mutex> lock(_bandMutex);
+   _band = {true, minFreqHz, maxFreqHz};
+}
+
+void SpectrumLevelEstimator::clearBand()
+{
+   const std::lock_guard<std::mutex> lock(_bandMutex);
+   _band = {};
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+void SpectrumLevelEstimator::update(SpectrumData& frame, std::span<const float> powerSum,
+                                    float powerScale, float averageAlpha, double elapsedSec)
+{
+   SpectrumLevels& levels = frame.levels;
+   levels = {};
+   const std::size_t n = frame.magnitudesDb.size();
+   if (!_enabled || n == 0)
+   {
+      _histogram.clear();
+      return;
+   }
+
+   // Bucket every bin, then count: the counting is the only scalar pass.
+   _buckets.resize(n);
+   histogramBuckets(frame.magnitudesDb.data(), _buckets.data(), n, LOWEST_DB, 1.0F / BUCKET_DB,
+                    static_cast<uint16_t>(BUCKETS - 1));
+   _frameCounts.fill(0.0F);
+   for (const uint16_t bucket : _buckets)
+   {
+      _frameCounts[bucket] += 1.0F;
+   }
+
+   // The level per bin depends on the FFT size, so a new size starts over.
+   float alpha = 0.0F;
+   if (_histogram.size() == BUCKETS && _binCount == n)
+   {
+      const double tau = _timeConstantSec.load();
+      alpha = (tau > 0.0) ? static_cast<float>(std::exp(-std::max(elapsedSec, 0.0) / tau))
+                          : 0.0F;
+   }
+   else
+   {
+      _histogram.assign(BUCKETS, 0.0F);
+      _binCount = n;
+   }
+   exponentialAverage(_histogram.data(), _frameCounts.data(), BUCKETS, alpha,
+                      1.0F / static_cast<float>(n));
+
+   levels.valid        = true;
+   levels.noiseFloorDb = percentileDb(_percentile);
+   levels.hasBand      = measureBand(frame, powerSum, powerScale, averageAlpha, levels);
+}
+
+void SpectrumLevelEstimator::reset()
+{
+   _histogram.clear();
+   _binCount  = 0;
+   _bandCount = 0;
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+float SpectrumLevelEstimator::percentileDb(float percent) const
+{
+   const float target = sumValues(_histogram.data(), BUCKETS) * (percent / 100.0F);
+
+   // Interpolate inside the bucket the target share falls in.
+   float below = 0.0F;
+   for (std::size_t b = 0; b < BUCKETS; ++b)
+   {
+      const float share = _histogram[b];
+      if (share > 0.0F && below + share >= target)
+      {
+         const float within = std::clamp((target - below) / share, 0.0F, 1.0F);
+         return LOWEST_DB + ((static_cast<float>(b) + within) * BUCKET_DB);
+      }
+      below += share;
+   }
+   return LOWEST_DB + (static_cast<float>(BUCKETS) * BUCKET_DB);
+}
+
+bool SpectrumLevelEstimator::measureBand(const SpectrumData& frame,
+                                         std::span<const float> powerSum, float powerScale,
+                                         float averageAlpha, SpectrumLevels& levels)
+{
+   Band band;
+   {
+      const std::lock_guard<std::mutex> lock(_bandMutex);
+      band = _band;
+   }
+   const std::size_t n = frame.magnitudesDb.size();
+   if (!band.set || frame.bandwidthHz <= 0.0 || powerSum.size() != n)
+   {
+      _bandCount = 0;
+      return false;
+   }
+
+   // Bin i is centred on centre + (i - n / 2) * hzPerBin (DC in the middle).
+   const double hzPerBin = frame.bandwidthHz / static_cast<double>(n);
+   const double half     = static_cast<double>(n / 2);
+   const double lowBin   = std::ceil(((band.minHz - frame.centerFreqHz) / hzPerBin) + half);
+   const double highBin  = std::floor(((band.maxHz - frame.centerFreqHz) / hzPerBin) + half);
+   double first = std::max(lowBin, 0.0);
+   double last  = std::min(highBin, static_cast<double>(n - 1));
+   if (first > last)
+   {
+      // Narrower than a bin: the bin holding the band's centre, if any.
+      const double centre = std::round(
+         ((((band.minHz + band.maxHz) / 2.0) - frame.centerFreqHz) / hzPerBin) + half);
+      if (centre < 0.0 || centre > static_cast<double>(n - 1))
+      {
+         _bandCount = 0;
+         return false;
+      }
+      first = centre;
+      last  = centre;
+   }
+
+   const auto firstBin = static_cast<std::size_t>(first);
+   const auto count    = static_cast<std::size_t>(last - first) + 1;
+   const float power   = sumValues(powerSum.data() + firstBin, count) * powerScale;
+
+   // Average like the trace; a different set of bins starts over.
+   if (averageAlpha > 0.0F && firstBin == _bandFirst && count == _bandCount)
+   {
+      _bandPower = (averageAlpha * _bandPower) + ((1.0F - averageAlpha) * power);
+   }
+   else
+   {
+      _bandPower = power;
+   }
+   _bandFirst = firstBin;
+   _bandCount = count;
+
+   levels.bandLowHz   = frame.centerFreqHz + ((first - half) * hzPerBin);
+   levels.bandHighHz  = frame.centerFreqHz + ((last - half) * hzPerBin);
+   levels.bandBins    = count;
+   levels.bandPowerDb = 10.0F * std::log10(std::max(_bandPower, POWER_FLOOR));
+   levels.bandNoiseDb = levels.noiseFloorDb + (10.0F * std::log10(static_cast<float>(count)));
+   return true;
+}
+
+} // namespace SdrEngine
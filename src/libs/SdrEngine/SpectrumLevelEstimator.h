@@ -0,0 +1,150 @@
+#ifndef SPECTRUMLEVELESTIMATOR_H_
+#define SPECTRUMLEVELESTIMATOR_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class SpectrumLevelEstimator
+ * @brief Noise floor and band power of the published spectrum, updated
+ *        incrementally in the engine so displays only read numbers.
+ *
+ * The noise floor is a percentile (the median by default) of a histogram
+ * of the bins' dB values in BUCKET_DB buckets.  Each frame's histogram is
+ * built with histogramBuckets() and blended into the running one with
+ * exponentialAverage(), weighted by its share of the time constant, so the
+ * estimate covers both the bins and the recent frames at a cost of one pass
+ * over the bins plus one over the buckets.  It is a percentile of dB values,
+ * not a mean noise power: for unaveraged noise it reads about 1.6 dB below
+ * the mean.
+ *
+ * Band power is the total linear power of the bins whose centres fall in
+ * the measurement band (the locked bandwidth cursor), summed with
+ * sumValues() and averaged with the same coefficient as the spectrum trace.
+ *
+ * Thread-safety: the setters may be called from any thread; update() and
+ * reset() must be called from one producer thread.
+ */
+class SpectrumLevelEstimator
+{
+public:
+   /** @brief Lower edge of the histogram; lower bins count as this level. */
+   static constexpr float LOWEST_DB = -200.0F;
+
+   /** @brief Histogram resolution. */
+   static constexpr float BUCKET_DB = 0.25F;
+
+   /** @brief Histogram buckets; they reach up to +50 dB. */
+   static constexpr std::size_t BUCKETS = 1000;
+
+   /** @brief Default percentile of the bins read as the noise floor. */
+   static constexpr float DEFAULT_PERCENTILE = 50.0F;
+
+   /** @brief Default time constant of the running histogram. */
+   static constexpr float DEFAULT_TIME_CONSTANT_S = 2.0F;
+
+   /** @brief Enable or disable the measurement (frames carry invalid levels when off). */
+   void setEnabled(bool enabled);
+
+   /**
+    * @brief Check if the measurement runs.
+    * @return true if frames carry SpectrumData::levels.
+    */
+   [[nodiscard]] bool isEnabled() const;
+
+   /**
+    * @brief Set the percentile of the bins read as the noise floor.
+    * @param percent  Clamped to [1, 99].
+    */
+   void setPercentile(float percent);
+
+   /**
+    * @brief Get the noise-floor percentile.
+    * @return Percentile in [1, 99].
+    */
+   [[nodiscard]] float getPercentile() const;
+
+   /**
+    * @brief Set how long the running histogram remembers a frame.
+    * @param seconds  Stream time; values below one frame restart it every frame.
+    */
+   void setTimeConstant(float seconds);
+
+   /**
+    * @brief Get the histogram time constant.
+    * @return Time constant in seconds.
+    */
+   [[nodiscard]] float getTimeConstant() const;
+
+   /**
+    * @brief Measure the power of the bins in `[minFreqHz, maxFreqHz]`.
+    * Swapped limits are reordered.
+    */
+   void setBand(double minFreqHz, double maxFreqHz);
+
+   /** @brief Stop measuring band power. */
+   void clearBand();
+
+   /**
+    * @brief Fill `frame.levels` for the frame about to be published.
+    *
+    * @param frame         Frame with its `magnitudesDb` and tuning set.
+    * @param powerSum      Summed linear power per bin, in `magnitudesDb` order.
+    * @param powerScale    Multiplier turning `powerSum` into mean power.
+    * @param averageAlpha  Averaging coefficient of the trace, applied to band power.
+    * @param elapsedSec    Time since the previous frame (drives the histogram decay).
+    */
+   void update(SpectrumData& frame, std::span<const float> powerSum, float powerScale,
+               float averageAlpha, double elapsedSec);
+
+   /** @brief Drop all running state.  Call only while the producer is stopped. */
+   void reset();
+
+private:
+   // Measurement band as set by the user.
+   struct Band
+   {
+      bool set{false};
+      double minHz{0.0};
+      double maxHz{0.0};
+   };
+
+   // Percentile of the running histogram, in dB.
+   [[nodiscard]] float percentileDb(float percent) const;
+
+   // Fill the band fields of `levels`; false if the band is not in the span.
+   bool measureBand(const SpectrumData& frame, std::span<const float> powerSum,
+                    float powerScale, float averageAlpha, SpectrumLevels& levels);
+
+   std::atomic<bool> _enabled{false};
+   std::atomic<float> _percentile{DEFAULT_PERCENTILE};
+   std::atomic<float> _timeConstantSec{DEFAULT_TIME_CONSTANT_S};
+
+   mutable std::mutex _bandMutex;
+   Band _band;
+
+   // Producer thread only.
+   std::size_t _binCount{0};                 ///< Bins of the frames in the histogram.
+   std::vector<float> _histogram;            ///< Running share of bins per bucket.
+   std::array<float, BUCKETS> _frameCounts{};
+   std::vector<uint16_t> _buckets;           ///< Bucket of each bin of the current frame.
+   std::size_t _bandFirst{0};                ///< Bins of the averaged band power.
+   std::size_t _bandCount{0};
+   float _bandPower{0.0F};
+};
+
+} // namespace SdrEngine
+
+#endif // SPECTRUMLEVELESTIMATOR_H_
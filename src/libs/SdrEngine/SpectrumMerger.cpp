@@ -0,0 +1,122 @@
+// Project headers
+#include "SpectrumMerger.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace SdrEngine
+{
+
+bool SpectrumMerger::merge(std::span<const SpectrumData* const> inputs, SpectrumData& merged)
+{
+   _segments.clear();
+   double hzPerBin = std::numeric_limits<double>::max();
+   double lowHz    = std::numeric_limits<double>::max();
+   double highHz   = std::numeric_limits<double>::lowest();
+   for (const SpectrumData* frame : inputs)
+   {
+      const std::size_t n = (frame != nullptr) ? frame->magnitudesDb.size() : 0;
+      if (n == 0 || frame->bandwidthHz <= 0.0)
+      {
+         continue;
+      }
+      Segment segment;
+      segment.frame     = frame;
+      segment.hzPerBin  = frame->bandwidthHz / static_cast<double>(n);
+      segment.lowEdgeHz = frame->centerFreqHz - (static_cast<double>(n / 2) * segment.hzPerBin);
+      segment.ownLowHz  = segment.lowEdgeHz;
+      segment.ownHighHz = segment.lowEdgeHz + frame->bandwidthHz;
+      hzPerBin = std::min(hzPerBin, segment.hzPerBin);
+      lowHz    = std::min(lowHz, segment.ownLowHz);
+      highHz   = std::max(highHz, segment.ownHighHz);
+      _segments.push_back(segment);
+   }
+   if (_segments.empty())
+   {
+      return false;
+   }
+   const double span = std::ceil(((highHz - lowHz) / hzPerBin) - 1.0e-6);
+   if (span > static_cast<double>(MAX_BINS))
+   {
+      return false;
+   }
+   const auto total = static_cast<std::size_t>(span);
+
+   // Overlaps are split halfway between neighbouring centres.
+   std::sort(_segments.begin(), _segments.end(), [](const Segment& a, const Segment& b)
+             { return a.frame->centerFreqHz < b.frame->centerFreqHz; });
+   for (std::size_t k = 0; k + 1 < _segments.size(); ++k)
+   {
+      const double seam =
+         (_segments[k].frame->centerFreqHz + _segments[k + 1].frame->centerFreqHz) / 2.0;
+      _segments[k].ownHighHz    = std::min(_segments[k].ownHighHz, seam);
+      _segments[k + 1].ownLowHz = std::max(_segments[k + 1].ownLowHz, seam);
+   }
+
+   merged.magnitudesDb.resize(total);
+   merged.maxHoldDb.clear();
+   merged.minHoldDb.clear();
+   merged.tiers.clear();
+   merged.levels       = {};
+   merged.stages       = {};
+   merged.fftSize      = total;
+   merged.bandwidthHz  = static_cast<double>(total) * hzPerBin;
+   merged.centerFreqHz = lowHz + (static_cast<double>(total / 2) * hzPerBin);
+
+   // Output bin j lies at lowHz + j * hzPerBin.
+   float* out = merged.magnitudesDb.data();
+   std::size_t filledTo = 0;   // End of the bins written so far.
+   for (const Segment& segment : _segments)
+   {
+      const auto& in = segment.frame->magnitudesDb;
+      const auto first = static_cast<std::size_t>(
+         std::max(0.0, std::ceil(((segment.ownLowHz - lowHz) / hzPerBin) - 1.0e-6)));
+      const auto last = std::min(
+         total, static_cast<std::size_t>(std::max(
+                   0.0, std::ceil(((segment.ownHighHz - lowHz) / hzPerBin) - 1.0e-6))));
+      const std::size_t begin = std::max(first, filledTo);
+      if (begin >= last)
+      {
+         continue;
+      }
+
+      if (segment.hzPerBin == hzPerBin)
+      {
+         // Same resolution: a straight copy, offset to the nearest bin.
+         const double offset = std::round(
+            ((lowHz + (static_cast<double>(begin) * hzPerBin)) - segment.lowEdgeHz) / hzPerBin);
+         auto src = static_cast<std::ptrdiff_t>(offset);
+         for (std::size_t j = begin; j < last; ++j, ++src)
+         {
+            out[j] = in[static_cast<std::size_t>(
+               std::clamp<std::ptrdiff_t>(src, 0, static_cast<std::ptrdiff_t>(in.size()) - 1))];
+         }
+      }
+      else
+      {
+         for (std::size_t j = begin; j < last; ++j)
+         {
+            const double bin = std::round(
+               ((lowHz + (static_cast<double>(j) * hzPerBin)) - segment.lowEdgeHz) /
+               segment.hzPerBin);
+            out[j] = in[static_cast<std::size_t>(
+               std::clamp(bin, 0.0, static_cast<double>(in.size() - 1)))];
+         }
+      }
+
+      // A gap before this segment takes the lower of its two borders.
+      if (begin > filledTo)
+      {
+         const float level =
+            (filledTo > 0) ? std::min(out[filledTo - 1], out[begin]) : out[begin];
+         std::fill(out + filledTo, out + begin, level);
+      }
+      filledTo = last;
+   }
+   std::fill(out + filledTo, out + total, (filledTo > 0) ? out[filledTo - 1] : 0.0F);
+   return true;
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,64 @@
+#ifndef SPECTRUMMERGER_H_
+#define SPECTRUMMERGER_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class SpectrumMerger
+ * @brief Joins the spectra of devices tuned to adjacent frequencies into one
+ *        trace (see SdrDeviceGroup).
+ *
+ * The merged trace spans from the lowest input's lower edge to the highest
+ * input's upper edge at the finest input resolution.  Where inputs overlap,
+ * each output bin comes from the input whose centre is nearest, so the
+ * seams fall halfway between centres and the rolled-off band edges are
+ * dropped, as SpectrumSweep does for its steps.  Inputs of a different
+ * resolution are sampled at their nearest bin.  Bins no input covers are
+ * filled with the lower of the levels on either side of the gap.
+ *
+ * Bin i of a frame lies at `centerFreqHz + (i - fftSize / 2) * hzPerBin`,
+ * as everywhere in the engine; the merged frame follows the same rule.
+ *
+ * Thread-safety: none; one merger per producing thread.
+ */
+class SpectrumMerger
+{
+public:
+   /// Largest merged trace; inputs too far apart to merge are refused.
+   static constexpr std::size_t MAX_BINS = std::size_t{1} << 22;
+
+   /**
+    * @brief Merge the latest spectrum of each device.
+    * @param inputs  One frame per device in any order; null or empty frames
+    *                are skipped.
+    * @param merged  Receives the trace; holds, pyramid and levels are cleared.
+    * @return false if no input is usable or the span exceeds MAX_BINS.
+    */
+   bool merge(std::span<const SpectrumData* const> inputs, SpectrumData& merged);
+
+private:
+   // One input and the band it contributes.
+   struct Segment
+   {
+      const SpectrumData* frame{nullptr};
+      double lowEdgeHz{0.0};    // Frequency of bin 0.
+      double hzPerBin{0.0};
+      double ownLowHz{0.0};     // Contributed band [ownLowHz, ownHighHz).
+      double ownHighHz{0.0};
+   };
+
+   std::vector<Segment> _segments;   // Scratch, sorted by centre frequency.
+};
+
+} // namespace SdrEngine
+
+#endif // SPECTRUMMERGER_H_
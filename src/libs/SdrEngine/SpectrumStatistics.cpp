@@ -0,0 +1,155 @@
+// Project headers
+#include "SpectrumStatistics.h"
+#include "DspKernels.h"
+
+// System headers
+#include <algorithm>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Smallest mean power passed to the log: a -300 dB floor, which matches
+// FftProcessor::process().
+constexpr float POWER_FLOOR = 1.0e-30F;
+
+} // anonymous namespace
+
+// ============================================================================
+// Settings
+// ============================================================================
+
+void SpectrumStatistics::setAverageAlpha(float alpha)
+{
+   _alpha = std::clamp(alpha, 0.0F, 1.0F);
+}
+
+float SpectrumStatistics::getAverageAlpha() const
+{
+   return _alpha;
+}
+
+void SpectrumStatistics::setMaxHoldEnabled(bool enabled)
+{
+   _maxHoldEnabled = enabled;
+}
+
+bool SpectrumStatistics::isMaxHoldEnabled() const
+{
+   return _maxHoldEnabled;
+}
+
+void SpectrumStatistics::setMaxHoldDecayRate(float dbPerSecond)
+{
+   _maxHoldDecayDbPerSec = std::max(dbPerSecond, 0.0F);
+}
+
+float SpectrumStatistics::getMaxHoldDecayRate() const
+{
+   return _maxHoldDecayDbPerSec;
+}
+
+void SpectrumStatistics::setMinHoldEnabled(bool enabled)
+{
+   _minHoldEnabled = enabled;
+}
+
+bool SpectrumStatistics::isMinHoldEnabled() const
+{
+   return _minHoldEnabled;
+}
+
+void SpectrumStatistics::resetHolds()
+{
+   _holdResetPending = true;
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+void SpectrumStatistics::computeDb(const std::vector<float>& powerSum, float scale,
+                                   std::vector<float>& dbOut)
+{
+   const std::size_t n = powerSum.size();
+   dbOut.resize(n);
+
+   const float alpha = _alpha.load();
+   if (alpha <= 0.0F)
+   {
+      _averagePower.clear();
+      powerToDb(powerSum.data(), dbOut.data(), n, scale, POWER_FLOOR);
+      return;
+   }
+
+   // Start (or restart after an FFT size change) from the current frame.
+   if (_averagePower.size() != n)
+   {
+      _averagePower.assign(n, 0.0F);
+      exponentialAverage(_averagePower.data(), powerSum.data(), n, 0.0F, scale);
+   }
+   else
+   {
+      exponentialAverage(_averagePower.data(), powerSum.data(), n, alpha, scale);
+   }
+   powerToDb(_averagePower.data(), dbOut.data(), n, 1.0F, POWER_FLOOR);
+}
+
+void SpectrumStatistics::updateHolds(const std::shared_ptr<SpectrumData>& frame, double elapsedSec)
+{
+   const std::size_t n = frame->magnitudesDb.size();
+   const float* current = frame->magnitudesDb.data();
+
+   // A reset request or a size change restarts both traces.
+   const bool restart = _holdResetPending.exchange(false);
+   const SpectrumData* previous = (restart || !_previous) ? nullptr : _previous.get();
+
+   if (_maxHoldEnabled)
+   {
+      frame->maxHoldDb.resize(n);
+      if (previous != nullptr && previous->maxHoldDb.size() == n)
+      {
+         const auto decay = static_cast<float>(
+            static_cast<double>(_maxHoldDecayDbPerSec.load()) * std::max(elapsedSec, 0.0));
+         maxHoldUpdate(previous->maxHoldDb.data(), current, frame->maxHoldDb.data(), n, decay);
+      }
+      else
+      {
+         std::copy(current, current + n, frame->maxHoldDb.begin());
+      }
+   }
+   else
+   {
+      frame->maxHoldDb.clear();
+   }
+
+   if (_minHoldEnabled)
+   {
+      frame->minHoldDb.resize(n);
+      if (previous != nullptr && previous->minHoldDb.size() == n)
+      {
+         minHoldUpdate(previous->minHoldDb.data(), current, frame->minHoldDb.data(), n);
+      }
+      else
+      {
+         std::copy(current, current + n, frame->minHoldDb.begin());
+      }
+   }
+   else
+   {
+      frame->minHoldDb.clear();
+   }
+
+   _previous = frame;
+}
+
+void SpectrumStatistics::reset()
+{
+   _averagePower.clear();
+   _previous.reset();
+   _holdResetPending = false;
+}
+
+} // namespace SdrEngine
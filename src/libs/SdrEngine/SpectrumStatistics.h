@@ -0,0 +1,117 @@
+#ifndef SPECTRUMSTATISTICS_H_
+#define SPECTRUMSTATISTICS_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class SpectrumStatistics
+ * @brief Per-bin spectrum traces computed once in the engine: exponential
+ *        averaging in linear power, decaying max hold and min hold.
+ *
+ * Averaging runs on linear power before the dB conversion, so the mean is
+ * not biased low the way an average of dB values is.  Hold traces are
+ * written straight into the outgoing frame from the previous frame's
+ * traces, so no per-frame copies are made.  All loops use the DspKernels.
+ *
+ * Thread-safety: the setters may be called from any thread; computeDb()
+ * and updateHolds() must be called from one producer thread.
+ */
+class SpectrumStatistics
+{
+public:
+   /** @brief Default max-hold decay rate. */
+   static constexpr float DEFAULT_MAX_HOLD_DECAY_DB_PER_S = 10.0F;
+
+   /**
+    * @brief Set the averaging coefficient (0 = off, towards 1 = smoother).
+    *   avg[n] = alpha * avg[n-1] + (1 - alpha) * power[n]
+    * @param alpha  Clamped to [0, 1].
+    */
+   void setAverageAlpha(float alpha);
+
+   /**
+    * @brief Get the averaging coefficient.
+    * @return Averaging coefficient in [0, 1].
+    */
+   [[nodiscard]] float getAverageAlpha() const;
+
+   /** @brief Enable or disable the decaying max-hold trace. */
+   void setMaxHoldEnabled(bool enabled);
+
+   /**
+    * @brief Check if max hold is enabled.
+    * @return true if frames carry a max-hold trace.
+    */
+   [[nodiscard]] bool isMaxHoldEnabled() const;
+
+   /**
+    * @brief Set how fast the max-hold trace falls back (dB per second).
+    * @param dbPerSecond  Negative values become 0 (infinite hold).
+    */
+   void setMaxHoldDecayRate(float dbPerSecond);
+
+   /**
+    * @brief Get the max-hold decay rate.
+    * @return Decay rate in dB per second.
+    */
+   [[nodiscard]] float getMaxHoldDecayRate() const;
+
+   /** @brief Enable or disable the min-hold trace. */
+   void setMinHoldEnabled(bool enabled);
+
+   /**
+    * @brief Check if min hold is enabled.
+    * @return true if frames carry a min-hold trace.
+    */
+   [[nodiscard]] bool isMinHoldEnabled() const;
+
+   /** @brief Restart both hold traces from the next frame. */
+   void resetHolds();
+
+   /**
+    * @brief Average a power spectrum and convert it to dB.
+    * @param powerSum  Summed linear power per bin.
+    * @param scale     Multiplier turning `powerSum` into mean power.
+    * @param dbOut     Resized to the bin count; receives the (averaged) dB.
+    */
+   void computeDb(const std::vector<float>& powerSum, float scale, std::vector<float>& dbOut);
+
+   /**
+    * @brief Fill the hold traces of `frame` from its `magnitudesDb`.
+    *
+    * The traces continue from the previous frame passed here, and `frame`
+    * becomes the reference for the next call.
+    *
+    * @param frame       Frame about to be published.
+    * @param elapsedSec  Time since the previous frame (drives max-hold decay).
+    */
+   void updateHolds(const std::shared_ptr<SpectrumData>& frame, double elapsedSec);
+
+   /** @brief Drop all running state.  Call only while the producer is stopped. */
+   void reset();
+
+private:
+   std::atomic<float> _alpha{0.0F};
+   std::atomic<bool> _maxHoldEnabled{false};
+   std::atomic<float> _maxHoldDecayDbPerSec{DEFAULT_MAX_HOLD_DECAY_DB_PER_S};
+   std::atomic<bool> _minHoldEnabled{false};
+   std::atomic<bool> _holdResetPending{false};
+
+   // Producer thread only.
+   std::vector<float> _averagePower;               ///< Linear-power EMA state.
+   std::shared_ptr<const SpectrumData> _previous;  ///< Source of the hold traces.
+};
+
+} // namespace SdrEngine
+
+#endif // SPECTRUMSTATISTICS_H_
@@ -0,0 +1,110 @@
+// Project headers
+#include "SpectrumSweep.h"
+#include "GeneralLogger.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+namespace SdrEngine
+{
+
+bool SpectrumSweep::configure(const SweepConfig& config, double sampleRateHz, std::size_t fftSize)
+{
+   _configured = false;
+   if (config.stopHz <= config.startHz || sampleRateHz <= 0.0 || fftSize < 2 ||
+       config.averages == 0 || config.settleTimeSec < 0.0 || config.usableFraction <= 0.0 ||
+       config.usableFraction > 1.0)
+   {
+      GPWARN("SpectrumSweep::configure: invalid parameters "
+             "(start={} Hz, stop={} Hz, rate={} Hz, fft={}, averages={}, usable={})",
+             config.startHz, config.stopHz, sampleRateHz, fftSize, config.averages,
+             config.usableFraction);
+      return false;
+   }
+
+   // Keep an even number of bins so the kept band is centred on DC.
+   auto kept = static_cast<std::size_t>(static_cast<double>(fftSize) * config.usableFraction);
+   kept = std::max<std::size_t>(2, kept & ~std::size_t{1});
+
+   _config        = config;
+   _fftSize       = fftSize;
+   _binsPerStep   = kept;
+   _stepWidthHz   = sampleRateHz * static_cast<double>(kept) / static_cast<double>(fftSize);
+   _stepCount     = static_cast<std::size_t>(
+      std::ceil(static_cast<double>(config.stopHz - config.startHz) / _stepWidthHz));
+   _settleSamples = static_cast<std::size_t>(std::lround(config.settleTimeSec * sampleRateHz));
+   _configured    = true;
+   return true;
+}
+
+bool SpectrumSweep::isConfigured() const
+{
+   return _configured;
+}
+
+const SweepConfig& SpectrumSweep::config() const
+{
+   return _config;
+}
+
+std::size_t SpectrumSweep::getStepCount() const
+{
+   return _configured ? _stepCount : 0;
+}
+
+uint64_t SpectrumSweep::stepFrequency(std::size_t step) const
+{
+   return _config.startHz +
+          static_cast<uint64_t>(std::llround((static_cast<double>(step) + 0.5) * _stepWidthHz));
+}
+
+double SpectrumSweep::stepWidthHz() const
+{
+   return _stepWidthHz;
+}
+
+std::size_t SpectrumSweep::binsPerStep() const
+{
+   return _binsPerStep;
+}
+
+std::size_t SpectrumSweep::totalBins() const
+{
+   return getStepCount() * _binsPerStep;
+}
+
+std::size_t SpectrumSweep::settleSamples() const
+{
+   return _settleSamples;
+}
+
+std::size_t SpectrumSweep::captureSamples() const
+{
+   return _config.averages * _fftSize;
+}
+
+void SpectrumSweep::beginPass(SpectrumData& frame) const
+{
+   const double spanHz = static_cast<double>(getStepCount()) * _stepWidthHz;
+   frame.magnitudesDb.resize(totalBins());
+   frame.centerFreqHz = static_cast<double>(_config.startHz) + (spanHz / 2.0);
+   frame.bandwidthHz  = spanHz;
+   frame.fftSize      = frame.magnitudesDb.size();
+}
+
+void SpectrumSweep::addStep(std::size_t step, std::span<const float> stepDb,
+                            SpectrumData& frame) const
+{
+   if (step >= getStepCount() || stepDb.size() != _fftSize ||
+       frame.magnitudesDb.size() != totalBins())
+   {
+      return;
+   }
+   const std::size_t trim = (_fftSize - _binsPerStep) / 2;
+   const auto kept = stepDb.subspan(trim, _binsPerStep);
+   std::copy(kept.begin(), kept.end(),
+             frame.magnitudesDb.begin() + static_cast<std::ptrdiff_t>(step * _binsPerStep));
+}
+
+} // namespace SdrEngine
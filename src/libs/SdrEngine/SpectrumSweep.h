@@ -0,0 +1,150 @@
+#ifndef SPECTRUMSWEEP_H_
+#define SPECTRUMSWEEP_H_
+
+// Project headers
+#include "SdrTypes.h"
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @class SweepConfig
+ * @brief Parameters of a wideband retune-and-stitch sweep.
+ */
+struct SweepConfig
+{
+   uint64_t startHz{0};            ///< Lower edge of the swept range.
+   uint64_t stopHz{0};             ///< Upper edge of the swept range.
+   double settleTimeSec{0.005};    ///< Samples discarded after each retune, as time.
+   std::size_t averages{4};        ///< FFT segments averaged per step.
+   double usableFraction{0.75};    ///< Central share of each step's bins kept (0 .. 1].
+};
+
+/**
+ * @class SweepStats
+ * @brief Timing of completed sweep passes.
+ */
+struct SweepStats
+{
+   uint64_t passes{0};            ///< Passes published since start().
+   std::size_t stepsPerPass{0};   ///< Retune steps in one pass.
+   double lastPassSec{0.0};       ///< Wall time of the latest pass.
+   double meanPassSec{0.0};       ///< Mean wall time per pass.
+};
+
+/**
+ * @class SpectrumSweep
+ * @brief Step plan and stitching for a sweep wider than the sample rate.
+ *
+ * The range is covered by steps of `usableFraction * sampleRate` each.
+ * Only the central `binsPerStep()` bins of every step's DC-centred
+ * spectrum are kept (the band edges roll off in the device's anti-alias
+ * filter), so adjacent steps butt together without overlap:
+ *
+ *   step k covers [startHz + k * W, startHz + (k + 1) * W),  W = stepWidthHz()
+ *
+ * The stitched trace spans `getStepCount() * W`, which may slightly exceed
+ * `stopHz` so the whole range is covered.
+ *
+ * Thread-safety: none; SdrEngine configures it only while stopped.
+ */
+class SpectrumSweep
+{
+public:
+   /**
+    * @brief Plan the steps for a range.
+    * @param config        Range and per-step settings.
+    * @param sampleRateHz  Device sample rate (Hz).
+    * @param fftSize       Bins per step spectrum.
+    * @return true if the plan is valid; otherwise the sweep is unconfigured.
+    */
+   bool configure(const SweepConfig& config, double sampleRateHz, std::size_t fftSize);
+
+   /**
+    * @brief Check if a valid plan exists.
+    * @return true after a successful configure().
+    */
+   [[nodiscard]] bool isConfigured() const;
+
+   /**
+    * @brief Get the configuration of the current plan.
+    * @return Sweep configuration.
+    */
+   [[nodiscard]] const SweepConfig& config() const;
+
+   /**
+    * @brief Get the number of retune steps per pass.
+    * @return Steps per pass, or 0 if not configured.
+    */
+   [[nodiscard]] std::size_t getStepCount() const;
+
+   /**
+    * @brief Get the centre frequency to tune for a step.
+    * @param step  Step index, `< getStepCount()`.
+    * @return Centre frequency (Hz).
+    */
+   [[nodiscard]] uint64_t stepFrequency(std::size_t step) const;
+
+   /**
+    * @brief Get the width of spectrum each step contributes.
+    * @return Step width (Hz).
+    */
+   [[nodiscard]] double stepWidthHz() const;
+
+   /**
+    * @brief Get the number of bins kept from each step.
+    * @return Kept bins per step.
+    */
+   [[nodiscard]] std::size_t binsPerStep() const;
+
+   /**
+    * @brief Get the number of bins in the stitched trace.
+    * @return `getStepCount() * binsPerStep()`.
+    */
+   [[nodiscard]] std::size_t totalBins() const;
+
+   /**
+    * @brief Get the samples to discard after each retune.
+    * @return Settling samples.
+    */
+   [[nodiscard]] std::size_t settleSamples() const;
+
+   /**
+    * @brief Get the samples captured per step.
+    * @return `averages * fftSize`.
+    */
+   [[nodiscard]] std::size_t captureSamples() const;
+
+   /**
+    * @brief Prepare a frame to receive a pass: sizes the trace and fills
+    *        in the wideband centre, bandwidth and bin count.
+    */
+   void beginPass(SpectrumData& frame) const;
+
+   /**
+    * @brief Copy one step's kept bins into their place in the stitched trace.
+    * @param step    Step index.
+    * @param stepDb  The step's DC-centred spectrum (`fftSize` bins).
+    * @param frame   Frame prepared by beginPass().
+    */
+   void addStep(std::size_t step, std::span<const float> stepDb, SpectrumData& frame) const;
+
+private:
+   SweepConfig _config;
+   bool _configured{false};
+   std::size_t _fftSize{0};
+   std::size_t _stepCount{0};
+   std::size_t _binsPerStep{0};
+   std::size_t _settleSamples{0};
+   double _stepWidthHz{0.0};
+};
+
+} // namespace SdrEngine
+
+#endif // SPECTRUMSWEEP_H_
@@ -0,0 +1,55 @@
+// Project headers
+#include "StageLatencyHistograms.h"
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// StageLatencyHistograms
+// ============================================================================
+
+void StageLatencyHistograms::record(const StageTimestamps& stages,
+                                    StageTimestamps::TimePoint listenerStart,
+                                    StageTimestamps::TimePoint listenerEnd)
+{
+   if (!stages.isTraced())
+   {
+      return;
+   }
+   // A frame whose ring stamp was lost (backlog beyond the ring's arrival
+   // marks) still reports the hops after the dequeue.
+   const bool hasDeviceRead = stages.deviceRead != StageTimestamps::TimePoint{};
+   if (hasDeviceRead)
+   {
+      _ringWait.record(stages.ringDequeue - stages.deviceRead);
+      _endToEnd.record(listenerEnd - stages.deviceRead);
+   }
+   _processing.record(stages.processed - stages.ringDequeue);
+   _publish.record(stages.published - stages.processed);
+   _queueing.record(listenerStart - stages.published);
+   _listeners.record(listenerEnd - listenerStart);
+}
+
+void StageLatencyHistograms::reset()
+{
+   _ringWait.reset();
+   _processing.reset();
+   _publish.reset();
+   _queueing.reset();
+   _listeners.reset();
+   _endToEnd.reset();
+}
+
+StageLatencyStats StageLatencyHistograms::summary() const
+{
+   StageLatencyStats out;
+   out.ringWait   = _ringWait.summary();
+   out.processing = _processing.summary();
+   out.publish    = _publish.summary();
+   out.queueing   = _queueing.summary();
+   out.listeners  = _listeners.summary();
+   out.endToEnd   = _endToEnd.summary();
+   return out;
+}
+
+} // namespace SdrEngine
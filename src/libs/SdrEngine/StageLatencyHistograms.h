@@ -0,0 +1,67 @@
+#ifndef STAGELATENCYHISTOGRAMS_H_
+#define STAGELATENCYHISTOGRAMS_H_
+
+// Project headers
+#include "LatencyHistogram.h"
+#include "SdrTypes.h"
+
+namespace SdrEngine
+{
+
+using CommonUtils::LatencyHistogram;
+using CommonUtils::LatencySummary;
+
+/**
+ * @class StageLatencyStats
+ * @brief Latency of each hop along one published stream.
+ */
+struct StageLatencyStats
+{
+   LatencySummary ringWait;     ///< Device read → ring dequeue.
+   LatencySummary processing;   ///< Ring dequeue → DSP done (stage queues and DSP).
+   LatencySummary publish;      ///< DSP done → handed to the DataHandler.
+   LatencySummary queueing;     ///< Handed over → first listener starts (DataHandler queue).
+   LatencySummary listeners;    ///< First listener starts → last listener returns.
+   LatencySummary endToEnd;     ///< Device read → last listener returns.
+};
+
+/**
+ * @class StageLatencyHistograms
+ * @brief One LatencyHistogram per hop of a traced stream.
+ *
+ * Fed from a DataHandler dispatch observer with the frame's
+ * StageTimestamps and the measured listener start / end.
+ */
+class StageLatencyHistograms
+{
+public:
+   /**
+    * @brief Record every hop of one traced frame.  Untraced frames are ignored.
+    * @param stages         Timestamps carried by the frame.
+    * @param listenerStart  When the DataHandler started dispatching it.
+    * @param listenerEnd    When the last listener returned.
+    */
+   void record(const StageTimestamps& stages, StageTimestamps::TimePoint listenerStart,
+               StageTimestamps::TimePoint listenerEnd);
+
+   /** @brief Zero every histogram. */
+   void reset();
+
+   /**
+    * @brief Get the percentiles of every hop.
+    * @return Per-hop summaries.
+    */
+   [[nodiscard]] StageLatencyStats summary() const;
+
+private:
+   LatencyHistogram _ringWait;
+   LatencyHistogram _processing;
+   LatencyHistogram _publish;
+   LatencyHistogram _queueing;
+   LatencyHistogram _listeners;
+   LatencyHistogram _endToEnd;
+};
+
+} // namespace SdrEngine
+
+#endif // STAGELATENCYHISTOGRAMS_H_
@@ -0,0 +1,399 @@
+// Project headers
+#include "SyntheticSdrDevice.h"
+#include "GeneralLogger.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <utility>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// Shortest loop accepted by setLoopLength().
+constexpr std::size_t MIN_LOOP_SAMPLES = 1024;
+
+// Fixed seed, so every run generates the same noise.
+constexpr uint32_t NOISE_SEED = 0x5eed;
+
+} // namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+SyntheticSdrDevice::SyntheticSdrDevice()
+{
+   _signals.push_back(SyntheticSignal{});   // One tone at the centre.
+}
+
+SyntheticSdrDevice::~SyntheticSdrDevice()
+{
+   SyntheticSdrDevice::close();
+}
+
+// ============================================================================
+// Signal generation
+// ============================================================================
+
+bool SyntheticSdrDevice::setSignals(std::vector<SyntheticSignal> signals)
+{
+   if (_streaming)
+   {
+      GPWARN("SyntheticSdrDevice::setSignals() — stop streaming first");
+      return false;
+   }
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   _signals = std::move(signals);
+   return true;
+}
+
+std::vector<SyntheticSignal> SyntheticSdrDevice::getSignals() const
+{
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   return _signals;
+}
+
+bool SyntheticSdrDevice::setNoiseLevel(float rms)
+{
+   if (_streaming || rms < 0.0F)
+   {
+      GPWARN("SyntheticSdrDevice::setNoiseLevel({}) rejected", rms);
+      return false;
+   }
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   _noiseRms = rms;
+   return true;
+}
+
+float SyntheticSdrDevice::getNoiseLevel() const
+{
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   return _noiseRms;
+}
+
+bool SyntheticSdrDevice::setLoopLength(std::size_t samples)
+{
+   if (_streaming || samples < MIN_LOOP_SAMPLES)
+   {
+      GPWARN("SyntheticSdrDevice::setLoopLength({}) rejected", samples);
+      return false;
+   }
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   _loopLength = samples;
+   return true;
+}
+
+std::size_t SyntheticSdrDevice::getLoopLength() const
+{
+   const std::lock_guard<std::mutex> lock(_configMutex);
+   return _loopLength;
+}
+
+double SyntheticSdrDevice::getFrequencyResolution() const
+{
+   return static_cast<double>(getSampleRate()) / static_cast<double>(getLoopLength());
+}
+
+void SyntheticSdrDevice::setPacing(PlaybackPacing pacing)
+{
+   _pacing.store(pacing, std::memory_order_relaxed);
+}
+
+PlaybackPacing SyntheticSdrDevice::getPacing() const
+{
+   return _pacing.load(std::memory_order_relaxed);
+}
+
+void SyntheticSdrDevice::renderLoop(std::size_t blockSize)
+{
+   std::vector<SyntheticSignal> signals;
+   float noiseRms = 0.0F;
+   std::size_t length = 0;
+   {
+      const std::lock_guard<std::mutex> lock(_configMutex);
+      signals  = _signals;
+      noiseRms = _noiseRms;
+      length   = _loopLength;
+   }
+   const double rate = static_cast<double>(getSampleRate());
+   const auto len    = static_cast<int64_t>(length);
+
+   // One full turn in `length` steps: a carrier k steps per sample is exactly
+   // periodic over the loop, whatever its frequency on the grid.
+   std::vector<IqSample> turn(length);
+   for (std::size_t i = 0; i < length; ++i)
+   {
+      const double phase = 2.0 * std::numbers::pi * static_cast<double>(i) /
+                           static_cast<double>(length);
+      turn[i] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+   }
+   const auto at = [&turn, len](int64_t step)
+   {
+      const int64_t wrapped = ((step % len) + len) % len;
+      return turn[static_cast<std::size_t>(wrapped)];
+   };
+   const auto stepsFor = [len, rate](double hz)
+   {
+      return static_cast<int64_t>(std::llround(hz * static_cast<double>(len) / rate));
+   };
+
+   _loop.assign(length + blockSize, IqSample{});
+   for (const auto& signal : signals)
+   {
+      const int64_t carrier = stepsFor(signal.offsetHz);
+      const int64_t tone    = std::max<int64_t>(1, stepsFor(signal.modulationHz));
+      switch (signal.type)
+      {
+      case SyntheticSignalType::Tone:
+         for (int64_t n = 0; n < len; ++n)
+         {
+            _loop[static_cast<std::size_t>(n)] += signal.amplitude * at(carrier * n);
+         }
+         break;
+
+      case SyntheticSignalType::AmCarrier:
+      {
+         const float depth = std::clamp(signal.depth, 0.0F, 1.0F);
+         const float scale = signal.amplitude / (1.0F + depth);   // Peak = amplitude.
+         for (int64_t n = 0; n < len; ++n)
+         {
+            const float envelope = 1.0F + (depth * at(tone * n).real());
+            _loop[static_cast<std::size_t>(n)] += (scale * envelope) * at(carrier * n);
+         }
+         break;
+      }
+
+      case SyntheticSignalType::FmCarrier:
+      {
+         // Phase deviation (modulation index) in table steps, against the
+         // tone frequency actually on the grid.
+         const double toneHz = static_cast<double>(tone) * rate / static_cast<double>(len);
+         const double peakSteps = (signal.deviationHz / toneHz) * static_cast<double>(len) /
+                                  (2.0 * std::numbers::pi);
+         for (int64_t n = 0; n < len; ++n)
+         {
+            const auto deviation = static_cast<int64_t>(
+               std::llround(peakSteps * static_cast<double>(at(tone * n).imag())));
+            _loop[static_cast<std::size_t>(n)] += signal.amplitude * at((carrier * n) + deviation);
+         }
+         break;
+      }
+      }
+   }
+
+   if (noiseRms > 0.0F)
+   {
+      std::mt19937 rng(NOISE_SEED);
+      std::normal_distribution<float> gaussian(0.0F, noiseRms / std::numbers::sqrt2_v<float>);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+         _loop[n] += IqSample{gaussian(rng), gaussian(rng)};
+      }
+   }
+
+   for (std::size_t n = length; n < _loop.size(); ++n)
+   {
+      _loop[n] = _loop[n % length];
+   }
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool SyntheticSdrDevice::open(int deviceIndex)
+{
+   if (deviceIndex != 0)
+   {
+      GPERROR("SyntheticSdrDevice: device index {} out of range (only 0)", deviceIndex);
+      return false;
+   }
+   _open = true;
+   return true;
+}
+
+void SyntheticSdrDevice::close()
+{
+   stopStreaming();
+   if (_streamThread.joinable())
+   {
+      _streamThread.join();
+   }
+   _open = false;
+}
+
+bool SyntheticSdrDevice::isOpen() const
+{
+   return _open;
+}
+
+// ============================================================================
+// Tuning
+// ============================================================================
+
+bool SyntheticSdrDevice::setCenterFrequency(uint64_t frequencyHz)
+{
+   _centerFreqHz.store(frequencyHz, std::memory_order_relaxed);
+   return true;
+}
+
+uint64_t SyntheticSdrDevice::getCenterFrequency() const
+{
+   return _centerFreqHz.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Sample rate
+// ============================================================================
+
+bool SyntheticSdrDevice::setSampleRate(uint32_t rateHz)
+{
+   if (rateHz == 0)
+   {
+      return false;
+   }
+   _sampleRateHz.store(rateHz, std::memory_order_relaxed);
+   return true;
+}
+
+uint32_t SyntheticSdrDevice::getSampleRate() const
+{
+   return _sampleRateHz.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Gain
+// ============================================================================
+
+bool SyntheticSdrDevice::setAutoGain(bool /*enabled*/)
+{
+   return true;
+}
+
+bool SyntheticSdrDevice::setGain(int tenthsDb)
+{
+   _gainTenthsDb.store(tenthsDb, std::memory_order_relaxed);
+   return true;
+}
+
+int SyntheticSdrDevice::getGain() const
+{
+   return _gainTenthsDb.load(std::memory_order_relaxed);
+}
+
+std::vector<int> SyntheticSdrDevice::getGainValues() const
+{
+   return {0};
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+bool SyntheticSdrDevice::startStreaming(IqCallback callback, std::size_t bufferSize)
+{
+   if (!_open)
+   {
+      GPERROR("Cannot start streaming — device not open");
+      return false;
+   }
+   if (_streaming)
+   {
+      GPWARN("Already streaming");
+      return false;
+   }
+   if (bufferSize == 0)
+   {
+      GPWARN("SyntheticSdrDevice: buffer size must be positive");
+      return false;
+   }
+
+   renderLoop(bufferSize);
+   GPINFO("SyntheticSdrDevice: {} samples/loop at {} Hz, frequency grid {:.1f} Hz",
+          getLoopLength(), getSampleRate(), getFrequencyResolution());
+
+   _callback  = std::move(callback);
+   _streaming = true;
+   _streamCounters.start();
+   _streamThread = std::thread(&SyntheticSdrDevice::streamThread, this, bufferSize);
+   return true;
+}
+
+void SyntheticSdrDevice::stopStreaming()
+{
+   if (!_streaming)
+   {
+      return;
+   }
+   _streaming = false;
+
+   if (_streamThread.joinable())
+   {
+      _streamThread.join();
+   }
+   GPINFO("Streaming stopped");
+}
+
+bool SyntheticSdrDevice::isStreaming() const
+{
+   return _streaming;
+}
+
+DeviceStreamStats SyntheticSdrDevice::getStreamStats() const
+{
+   return _streamCounters.snapshot();
+}
+
+void SyntheticSdrDevice::setStreamThreadRole(std::string role)
+{
+   _streamThreadRole = role.empty() ? std::string("SyntheticSdr.stream") : std::move(role);
+}
+
+void SyntheticSdrDevice::streamThread(std::size_t samplesPerBuffer)
+{
+   CommonUtils::configureCurrentThread(_streamThreadRole);
+   const std::size_t length = _loop.size() - samplesPerBuffer;
+   std::size_t position     = 0;
+   _clock.start();
+   while (_streaming)
+   {
+      if (_pacing.load(std::memory_order_relaxed) == PlaybackPacing::RealTime)
+      {
+         _clock.pace(samplesPerBuffer, static_cast<double>(getSampleRate()), _streaming);
+         if (!_streaming)
+         {
+            break;
+         }
+      }
+      _streamCounters.recordRead(samplesPerBuffer, samplesPerBuffer);
+      _callback(_loop.data() + position, samplesPerBuffer);
+      position = (position + samplesPerBuffer) % length;
+   }
+}
+
+// ============================================================================
+// Device info
+// ============================================================================
+
+std::string SyntheticSdrDevice::getName() const
+{
+   return "Synthetic signal generator";
+}
+
+std::vector<DeviceInfo> SyntheticSdrDevice::enumerateDevices() const
+{
+   DeviceInfo info;
+   info.index        = 0;
+   info.name         = getName();
+   info.manufacturer = "RadioWizard";
+   return {info};
+}
+
+} // namespace SdrEngine
@@ -0,0 +1,198 @@
+#ifndef SYNTHETICSDRDEVICE_H_
+#define SYNTHETICSDRDEVICE_H_
+
+// Project headers
+#include "ISdrDevice.h"
+#include "PlaybackClock.h"
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SdrEngine
+{
+
+/**
+ * @brief Kind of signal produced by SyntheticSdrDevice.
+ */
+enum class SyntheticSignalType : uint8_t
+{
+   Tone,        ///< Unmodulated carrier.
+   FmCarrier,   ///< Carrier frequency-modulated by a sine tone.
+   AmCarrier    ///< Carrier amplitude-modulated by a sine tone.
+};
+
+/**
+ * @class SyntheticSignal
+ * @brief One signal in a SyntheticSdrDevice's output.
+ */
+struct SyntheticSignal
+{
+   SyntheticSignalType type{SyntheticSignalType::Tone};
+   double offsetHz{0.0};           ///< Carrier offset from the centre frequency.
+   float amplitude{0.5F};          ///< Peak magnitude; 1.0 is full scale.
+   double modulationHz{1'000.0};   ///< FM / AM modulating tone.
+   double deviationHz{5'000.0};    ///< FM peak deviation.
+   float depth{0.5F};              ///< AM modulation depth, 0..1.
+};
+
+/**
+ * @class SyntheticSdrDevice
+ * @brief ISdrDevice that generates tones, FM / AM carriers and noise.
+ *
+ * Load-tests SdrEngine, the demodulators and the widgets at sample rates
+ * no attached hardware reaches.  Generation is nearly free: when streaming
+ * starts, the signals are rendered once, with a phase lookup table, into a
+ * loop buffer of getLoopLength() samples, and the stream thread then hands
+ * out consecutive blocks of it without copying.  To loop seamlessly every
+ * frequency is rounded to a multiple of getFrequencyResolution()
+ * (sample rate / loop length), and the noise repeats with the loop.
+ *
+ * PlaybackPacing::RealTime delivers at the configured sample rate;
+ * AsFastAsPossible ("flood") delivers back to back to find the pipeline's
+ * throughput ceiling.
+ *
+ * Signals are relative to the centre frequency, so retuning does not move
+ * them; tuning and gain are only reported back.  Signals, noise, loop
+ * length and sample rate take effect when streaming (re)starts.
+ */
+class SyntheticSdrDevice : public ISdrDevice
+{
+public:
+   /** @brief Default sample rate until one is set. */
+   static constexpr uint32_t DEFAULT_SAMPLE_RATE = 2'048'000;
+
+   /** @brief Default loop buffer length (complex samples). */
+   static constexpr std::size_t DEFAULT_LOOP_SAMPLES = std::size_t{1} << 18;
+
+   SyntheticSdrDevice();
+   ~SyntheticSdrDevice() override;
+
+   // -- Signal generation ---------------------------------------------------
+
+   /**
+    * @brief Replace the generated signals.  Not while streaming.
+    * @param signals  Signals to sum (may be empty for noise only).
+    * @return true on success.
+    */
+   [[nodiscard]] bool setSignals(std::vector<SyntheticSignal> signals);
+
+   /**
+    * @brief Get the generated signals.
+    * @return Signals set by setSignals().
+    */
+   [[nodiscard]] std::vector<SyntheticSignal> getSignals() const;
+
+   /**
+    * @brief Set the complex Gaussian noise level.  Not while streaming.
+    * @param rms  RMS magnitude (1.0 = full scale); 0 disables noise.
+    * @return true on success.
+    */
+   [[nodiscard]] bool setNoiseLevel(float rms);
+
+   /**
+    * @brief Get the noise level.
+    * @return RMS magnitude.
+    */
+   [[nodiscard]] float getNoiseLevel() const;
+
+   /**
+    * @brief Set the loop buffer length.  Not while streaming.
+    * Longer loops give a finer frequency grid and less repetitive noise.
+    * @param samples  Complex samples, at least 1024.
+    * @return true on success.
+    */
+   [[nodiscard]] bool setLoopLength(std::size_t samples);
+
+   /**
+    * @brief Get the loop buffer length.
+    * @return Complex samples per loop.
+    */
+   [[nodiscard]] std::size_t getLoopLength() const;
+
+   /**
+    * @brief Get the grid every generated frequency is rounded to.
+    * @return Sample rate / loop length (Hz).
+    */
+   [[nodiscard]] double getFrequencyResolution() const;
+
+   /**
+    * @brief Set how fast samples are delivered.
+    * @param pacing  RealTime (default) or AsFastAsPossible (flood).
+    */
+   void setPacing(PlaybackPacing pacing);
+
+   /**
+    * @brief Get the delivery pacing.
+    * @return Current pacing.
+    */
+   [[nodiscard]] PlaybackPacing getPacing() const;
+
+   // -- ISdrDevice ----------------------------------------------------------
+
+   /**
+    * @brief Open the generator.
+    * @param deviceIndex  Must be 0.
+    * @return true on success.
+    */
+   [[nodiscard]] bool open(int deviceIndex = 0) override;
+   void close() override;
+   [[nodiscard]] bool isOpen() const override;
+
+   [[nodiscard]] bool setCenterFrequency(uint64_t frequencyHz) override;
+   [[nodiscard]] uint64_t getCenterFrequency() const override;
+
+   [[nodiscard]] bool setSampleRate(uint32_t rateHz) override;
+   [[nodiscard]] uint32_t getSampleRate() const override;
+
+   [[nodiscard]] bool setAutoGain(bool enabled) override;
+   [[nodiscard]] bool setGain(int tenthsDb) override;
+   [[nodiscard]] int getGain() const override;
+   [[nodiscard]] std::vector<int> getGainValues() const override;
+
+   [[nodiscard]] bool startStreaming(IqCallback callback,
+                                    std::size_t bufferSize = 8192) override;
+   void stopStreaming() override;
+   [[nodiscard]] bool isStreaming() const override;
+   [[nodiscard]] DeviceStreamStats getStreamStats() const override;
+   void setStreamThreadRole(std::string role) override;
+
+   [[nodiscard]] std::string getName() const override;
+   [[nodiscard]] std::vector<DeviceInfo> enumerateDevices() const override;
+
+private:
+   // Render the loop, followed by a copy of its first `blockSize` samples
+   // so every block starting inside the loop is contiguous.
+   void renderLoop(std::size_t blockSize);
+
+   // Thread body that hands out loop blocks.
+   void streamThread(std::size_t samplesPerBuffer);
+
+   mutable std::mutex _configMutex;   // Guards the generator settings.
+   std::vector<SyntheticSignal> _signals;
+   float _noiseRms{0.0F};
+   std::size_t _loopLength{DEFAULT_LOOP_SAMPLES};
+
+   std::atomic<bool> _open{false};
+   std::atomic<uint64_t> _centerFreqHz{100'000'000};
+   std::atomic<uint32_t> _sampleRateHz{DEFAULT_SAMPLE_RATE};
+   std::atomic<int> _gainTenthsDb{0};
+   std::atomic<PlaybackPacing> _pacing{PlaybackPacing::RealTime};
+
+   std::atomic<bool> _streaming{false};
+   DeviceStreamCounters _streamCounters;   // Written by the stream thread.
+   std::thread _streamThread;
+   std::string _streamThreadRole{"SyntheticSdr.stream"};   // Set while stopped.
+   IqCallback _callback;
+   std::vector<IqSample> _loop;   // Rendered before the stream thread starts.
+   PlaybackClock _clock;          // Owned by the stream thread.
+};
+
+} // namespace SdrEngine
+
+#endif // SYNTHETICSDRDEVICE_H_
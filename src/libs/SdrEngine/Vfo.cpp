@@ -0,0 +1,163 @@
+// Project headers
+#include "Vfo.h"
+
+// System headers
+#include <chrono>
+#include <utility>
+
+namespace SdrEngine
+{
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+Vfo::Vfo(int id)
+   : _id{id}
+   , _iqHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>>()}
+   , _audioHandler{std::make_unique<CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>>()}
+{
+   _filter.setEnabled(true);
+}
+
+Vfo::~Vfo()
+{
+   // Stop listener threads before the pools their frames return to.
+   _iqHandler.reset();
+   _audioHandler.reset();
+}
+
+int Vfo::getId() const
+{
+   return _id;
+}
+
+// ============================================================================
+// Tuning
+// ============================================================================
+
+void Vfo::configure(double centerOffsetHz, double bandwidthHz, double inputSampleRate)
+{
+   _filter.configure(centerOffsetHz, bandwidthHz, inputSampleRate);
+
+   const std::lock_guard<std::mutex> lock(_mutex);
+   if (_demodEnabled)
+   {
+      configureDemodLocked();
+   }
+}
+
+double Vfo::getCenterOffset() const
+{
+   return _filter.getCenterOffset();
+}
+
+double Vfo::getBandwidth() const
+{
+   return _filter.getChannelBandwidth();
+}
+
+double Vfo::getOutputSampleRate() const
+{
+   return _filter.getOutputSampleRate();
+}
+
+// ============================================================================
+// Demodulation
+// ============================================================================
+
+void Vfo::setDemodulator(DemodMode mode, double audioSampleRate)
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _demodMode       = mode;
+   _audioSampleRate = audioSampleRate;
+   _demodEnabled    = true;
+   configureDemodLocked();
+}
+
+void Vfo::clearDemodulator()
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   _demodEnabled = false;
+}
+
+bool Vfo::hasDemodulator() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _demodEnabled;
+}
+
+DemodMode Vfo::getDemodMode() const
+{
+   const std::lock_guard<std::mutex> lock(_mutex);
+   return _demodMode;
+}
+
+void Vfo::configureDemodLocked()
+{
+   const double channelRate = _filter.getOutputSampleRate();
+   if (channelRate > 0.0)
+   {
+      _demod.configure(_demodMode, channelRate, _audioSampleRate);
+      _demod.reset();
+   }
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+void Vfo::process(const IqBuffer& wideband)
+{
+   auto iqBuf = _iqPool.acquire();
+   _filter.process(wideband.samples, iqBuf->samples);
+   if (iqBuf->samples.empty())
+   {
+      return;
+   }
+   iqBuf->centerFreqHz = wideband.centerFreqHz + _filter.getCenterOffset();
+   iqBuf->sampleRateHz = _filter.getOutputSampleRate();
+   iqBuf->timestamp    = wideband.timestamp;
+   iqBuf->stages       = wideband.stages;
+   if (wideband.stages.isTraced())
+   {
+      iqBuf->stages.processed = std::chrono::steady_clock::now();
+      iqBuf->stages.published = iqBuf->stages.processed;
+   }
+   const std::shared_ptr<const IqBuffer> channel = std::move(iqBuf);
+   _iqHandler->signalData(channel);
+
+   if (!hasDemodulator() || !_demod.isConfigured())
+   {
+      return;
+   }
+   auto audio = _audioPool.acquire();
+   _demod.demodulateInto(channel->samples, *audio);
+   audio->sourceTime = channel->sourceTime();
+   if (!audio->left.empty())
+   {
+      _audioHandler->signalData(std::move(audio));
+   }
+}
+
+void Vfo::reset()
+{
+   _filter.reset();
+   _demod.reset();
+}
+
+// ============================================================================
+// Data handlers
+// ============================================================================
+
+CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& Vfo::iqDataHandler()
+{
+   return *_iqHandler;
+}
+
+CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>& Vfo::audioDataHandler()
+{
+   return *_audioHandler;
+}
+
+} // namespace SdrEngine
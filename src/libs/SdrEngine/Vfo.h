@@ -0,0 +1,146 @@
+#ifndef VFO_H_
+#define VFO_H_
+
+// Project headers
+#include "ChannelFilter.h"
+#include "DataHandler.h"
+#include "Demodulator.h"
+#include "FramePool.h"
+#include "SdrTypes.h"
+
+// System headers
+#include <memory>
+#include <mutex>
+
+namespace SdrEngine
+{
+
+/**
+ * @class Vfo
+ * @brief One independently tuned receiver inside SdrEngine.
+ *
+ * A VFO ("variable-frequency oscillator") extracts one channel from the
+ * wideband stream with its own ChannelFilter and, optionally, demodulates
+ * it.  Results are published on the VFO's own DataHandlers:
+ *   - `iqDataHandler()`    — channel-filtered IqBuffer chunks.
+ *   - `audioDataHandler()` — DemodAudio, while a demodulator is set.
+ *
+ * SdrEngine calls process() for every VFO in parallel on its worker pool,
+ * each with the same captured wideband block.
+ *
+ * Thread-safety: configuration methods may be called from any thread
+ * while process() runs.
+ */
+class Vfo
+{
+public:
+   /**
+    * @brief Construct an unconfigured VFO.
+    * @param id  Engine-assigned identifier.
+    */
+   explicit Vfo(int id);
+
+   /** @brief Destroy the VFO; its DataHandlers stop first. */
+   ~Vfo();
+
+   // Non-copyable, non-movable (owns DSP objects and handlers).
+   Vfo(const Vfo&) = delete;
+   Vfo& operator=(const Vfo&) = delete;
+   Vfo(Vfo&&) = delete;
+   Vfo& operator=(Vfo&&) = delete;
+
+   /**
+    * @brief Get the engine-assigned identifier.
+    * @return VFO id.
+    */
+   [[nodiscard]] int getId() const;
+
+   /**
+    * @brief Tune the VFO.  Reconfigures the demodulator if one is set.
+    * @param centerOffsetHz   Offset from the wideband centre (Hz).
+    * @param bandwidthHz      Channel bandwidth (Hz).
+    * @param inputSampleRate  Wideband sample rate (Hz).
+    */
+   void configure(double centerOffsetHz, double bandwidthHz, double inputSampleRate);
+
+   /**
+    * @brief Get the configured centre-frequency offset.
+    * @return Offset from the wideband centre (Hz).
+    */
+   [[nodiscard]] double getCenterOffset() const;
+
+   /**
+    * @brief Get the configured channel bandwidth.
+    * @return Channel bandwidth (Hz).
+    */
+   [[nodiscard]] double getBandwidth() const;
+
+   /**
+    * @brief Get the channel-filtered output sample rate.
+    * @return Output sample rate (Hz), or 0 if not configured.
+    */
+   [[nodiscard]] double getOutputSampleRate() const;
+
+   /**
+    * @brief Demodulate this VFO's channel and publish audio.
+    * @param mode             Demodulation mode.
+    * @param audioSampleRate  Audio output rate (Hz).
+    */
+   void setDemodulator(DemodMode mode, double audioSampleRate = Demodulator::DEFAULT_AUDIO_RATE);
+
+   /** @brief Stop demodulating; only filtered I/Q is published. */
+   void clearDemodulator();
+
+   /**
+    * @brief Check if a demodulator is set.
+    * @return true while audio is being produced.
+    */
+   [[nodiscard]] bool hasDemodulator() const;
+
+   /**
+    * @brief Get the demodulation mode.
+    * @return Mode of the current (or last) demodulator.
+    */
+   [[nodiscard]] DemodMode getDemodMode() const;
+
+   /**
+    * @brief Filter (and demodulate) one wideband block and publish results.
+    * @param wideband  Raw I/Q frame from the conditioning stage.
+    */
+   void process(const IqBuffer& wideband);
+
+   /** @brief Reset filter and demodulator state (e.g. after retuning). */
+   void reset();
+
+   /** @brief DataHandler that publishes this VFO's filtered IqBuffer chunks. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>& iqDataHandler();
+
+   /** @brief DataHandler that publishes this VFO's demodulated audio. */
+   [[nodiscard]] CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>& audioDataHandler();
+
+private:
+   // Reconfigure the demodulator for the filter's current output rate.
+   void configureDemodLocked();
+
+   const int _id;
+
+   mutable std::mutex _mutex;          // Guards demodulator settings.
+   bool _demodEnabled{false};
+   DemodMode _demodMode{DemodMode::FmMono};
+   double _audioSampleRate{Demodulator::DEFAULT_AUDIO_RATE};
+
+   ChannelFilter _filter;
+   Demodulator _demod;
+
+   // Only the worker running process() touches these.
+   static constexpr std::size_t FRAME_POOL_DEPTH = 16;
+   FramePool<IqBuffer> _iqPool{FRAME_POOL_DEPTH};
+   FramePool<DemodAudio> _audioPool{FRAME_POOL_DEPTH};
+
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>>> _iqHandler;
+   std::unique_ptr<CommonUtils::DataHandler<std::shared_ptr<const DemodAudio>>> _audioHandler;
+};
+
+} // namespace SdrEngine
+
+#endif // VFO_H_
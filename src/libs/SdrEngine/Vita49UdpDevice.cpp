@@ -0,0 +1,535 @@
+// Project headers
+#include "Vita49UdpDevice.h"
+#include "ContextCache.h"
+#include "GeneralLogger.h"
+#include "IoContext.h"
+#include "PacketSequencer.h"
+#include "PacketView.h"
+#include "ThreadConfig.h"
+
+// System headers
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace SdrEngine
+{
+
+namespace
+{
+
+// How long the receive thread waits for data before checking for stop.
+constexpr int POLL_TIMEOUT_MS = 100;
+
+bool isMulticast(const in_addr& address)
+{
+   return IN_MULTICAST(ntohl(address.s_addr));
+}
+
+} // namespace
+
+// ============================================================================
+// Construction / destruction
+// ============================================================================
+
+Vita49UdpDevice::Vita49UdpDevice()
+   : Vita49UdpDevice("0.0.0.0", 0)
+{
+}
+
+Vita49UdpDevice::Vita49UdpDevice(std::string address, uint16_t port)
+   : _address{std::move(address)}
+   , _port{port}
+   , _contextCache{std::make_unique<Vita49_2::ContextCache>(
+        [this](uint32_t /*streamId*/, const Vita49_2::ContextFields& fields)
+        { applyContext(fields); })}
+{
+}
+
+Vita49UdpDevice::~Vita49UdpDevice()
+{
+   Vita49UdpDevice::close();
+}
+
+// ============================================================================
+// Network
+// ============================================================================
+
+bool Vita49UdpDevice::setEndpoint(std::string address, uint16_t port)
+{
+   if (isOpen())
+   {
+      GPWARN("Vita49UdpDevice::setEndpoint() — close the device first");
+      return false;
+   }
+   _address = std::move(address);
+   _port    = port;
+   return true;
+}
+
+void Vita49UdpDevice::setStreamFilter(std::optional<uint32_t> streamId)
+{
+   _streamFilter = streamId;
+}
+
+void Vita49UdpDevice::setReorderWindow(std::size_t packets)
+{
+   _reorderWindow = packets;
+}
+
+uint16_t Vita49UdpDevice::getBoundPort() const
+{
+   return isOpen() ? _boundPort : _port;
+}
+
+uint64_t Vita49UdpDevice::getLostPackets() const
+{
+   return _lostPackets.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool Vita49UdpDevice::open(int deviceIndex)
+{
+   if (isOpen())
+   {
+      GPWARN("Vita49UdpDevice::open() — socket already open, closing first");
+      close();
+   }
+   if (deviceIndex != 0)
+   {
+      GPERROR("Vita49UdpDevice: device index {} out of range (only 0)", deviceIndex);
+      return false;
+   }
+
+   sockaddr_in local{};
+   local.sin_family = AF_INET;
+   local.sin_port   = htons(_port);
+   if (::inet_pton(AF_INET, _address.c_str(), &local.sin_addr) != 1)
+   {
+      GPERROR("Vita49UdpDevice: '{}' is not an IPv4 address", _address);
+      return false;
+   }
+
+   _socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+   if (_socket < 0)
+   {
+      GPERROR("Vita49UdpDevice: socket() failed: {}", std::strerror(errno));
+      return false;
+   }
+
+   // Bursts at 10 GbE rates outrun one scheduling quantum; let the kernel
+   // queue as much as it allows.
+   const int reuse = 1;
+   ::setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+   const int requested = RECEIVE_BUFFER_BYTES;
+   ::setsockopt(_socket, SOL_SOCKET, SO_RCVBUF, &requested, sizeof(requested));
+   int granted           = 0;
+   socklen_t grantedSize = sizeof(granted);
+   ::getsockopt(_socket, SOL_SOCKET, SO_RCVBUF, &granted, &grantedSize);
+
+   if (::bind(_socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0)
+   {
+      GPERROR("Vita49UdpDevice: cannot bind {}:{}: {}", _address, _port, std::strerror(errno));
+      close();
+      return false;
+   }
+   if (isMulticast(local.sin_addr))
+   {
+      ip_mreq group{};
+      group.imr_multiaddr        = local.sin_addr;
+      group.imr_interface.s_addr = htonl(INADDR_ANY);
+      if (::setsockopt(_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group, sizeof(group)) != 0)
+      {
+         GPERROR("Vita49UdpDevice: cannot join {}: {}", _address, std::strerror(errno));
+         close();
+         return false;
+      }
+   }
+
+   sockaddr_in bound{};
+   socklen_t boundSize = sizeof(bound);
+   ::getsockname(_socket, reinterpret_cast<sockaddr*>(&bound), &boundSize);
+   _boundPort = ntohs(bound.sin_port);
+
+   GPINFO("Listening for VITA 49 on {}:{} (receive buffer {} bytes)", _address, _boundPort,
+          granted);
+   return true;
+}
+
+void Vita49UdpDevice::close()
+{
+   stopStreaming();
+   if (_socket >= 0)
+   {
+      ::close(_socket);
+      _socket    = -1;
+      _boundPort = 0;
+      GPINFO("Closed VITA 49 socket {}:{}", _address, _port);
+   }
+}
+
+bool Vita49UdpDevice::isOpen() const
+{
+   return _socket >= 0;
+}
+
+// ============================================================================
+// Tuning
+// ============================================================================
+
+bool Vita49UdpDevice::setCenterFrequency(uint64_t frequencyHz)
+{
+   _centerFreqHz.store(frequencyHz, std::memory_order_relaxed);
+   return true;
+}
+
+uint64_t Vita49UdpDevice::getCenterFrequency() const
+{
+   return _centerFreqHz.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Sample rate
+// ============================================================================
+
+bool Vita49UdpDevice::setSampleRate(uint32_t rateHz)
+{
+   if (rateHz == 0)
+   {
+      return false;
+   }
+   _sampleRateHz.store(rateHz, std::memory_order_relaxed);
+   return true;
+}
+
+uint32_t Vita49UdpDevice::getSampleRate() const
+{
+   return _sampleRateHz.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Gain
+// ============================================================================
+
+bool Vita49UdpDevice::setAutoGain(bool /*enabled*/)
+{
+   return true;
+}
+
+bool Vita49UdpDevice::setGain(int tenthsDb)
+{
+   _gainTenthsDb.store(tenthsDb, std::memory_order_relaxed);
+   return true;
+}
+
+int Vita49UdpDevice::getGain() const
+{
+   return _gainTenthsDb.load(std::memory_order_relaxed);
+}
+
+std::vector<int> Vita49UdpDevice::getGainValues() const
+{
+   return {0};
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+bool Vita49UdpDevice::startStreaming(IqCallback callback, std::size_t /*bufferSize*/)
+{
+   return beginStreaming(std::move(callback), nullptr);
+}
+
+bool Vita49UdpDevice::startRawStreaming(RawIqCallback callback, std::size_t /*bufferSize*/)
+{
+   return beginStreaming(nullptr, std::move(callback));
+}
+
+bool Vita49UdpDevice::beginStreaming(IqCallback callback, RawIqCallback rawCallback)
+{
+   if (!isOpen())
+   {
+      GPERROR("Cannot start streaming — socket not open");
+      return false;
+   }
+   if (_streaming)
+   {
+      GPWARN("Already streaming");
+      return false;
+   }
+
+   _callback        = std::move(callback);
+   _rawCallback     = std::move(rawCallback);
+   _followedStream  = _streamFilter;
+   _payloadFormat   = Vita49_2::PayloadFormat::Int16;
+   _sequencer       = std::make_unique<Vita49_2::PacketSequencer>(
+      [this](const Vita49_2::PacketView& packet) { deliverPacket(packet); },
+      [this](const Vita49_2::PacketSequencer::Gap& gap) { fillGap(gap.packets, gap.samples); },
+      _reorderWindow);
+   _contextCache->clear();
+   _lostPackets.store(0, std::memory_order_relaxed);
+   _streaming = true;
+   _streamCounters.start();
+   if (_ioContext != nullptr)
+   {
+      std::promise<void> done;
+      _ioTaskDone = done.get_future();
+      _ioContext->spawn(receiveTask(*_ioContext, std::move(done)));
+   }
+   else
+   {
+      _streamThread = std::thread(&Vita49UdpDevice::receiveThread, this);
+   }
+   return true;
+}
+
+void Vita49UdpDevice::stopStreaming()
+{
+   if (!_streaming)
+   {
+      return;
+   }
+   _streaming = false;
+
+   if (_streamThread.joinable())
+   {
+      _streamThread.join();
+   }
+   if (_ioTaskDone.valid())
+   {
+      _ioTaskDone.wait();
+      _ioTaskDone = {};
+   }
+   GPINFO("Streaming stopped");
+}
+
+bool Vita49UdpDevice::isStreaming() const
+{
+   return _streaming;
+}
+
+DeviceStreamStats Vita49UdpDevice::getStreamStats() const
+{
+   return _streamCounters.snapshot();
+}
+
+void Vita49UdpDevice::setStreamThreadRole(std::string role)
+{
+   _streamThreadRole = role.empty() ? std::string("Vita49Udp.recv") : std::move(role);
+}
+
+void Vita49UdpDevice::setIoContext(CommonUtils::IoContext* context)
+{
+   _ioContext = context;
+}
+
+Vita49UdpDevice::ReceiveSlots::ReceiveSlots()
+   : datagrams(RECV_BATCH * MAX_DATAGRAM_BYTES)
+   , iovecs(RECV_BATCH)
+   , messages(RECV_BATCH)
+{
+   for (std::size_t i = 0; i < RECV_BATCH; ++i)
+   {
+      iovecs[i].iov_base             = datagrams.data() + (i * MAX_DATAGRAM_BYTES);
+      iovecs[i].iov_len              = MAX_DATAGRAM_BYTES;
+      messages[i].msg_hdr.msg_iov    = &iovecs[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+   }
+}
+
+void Vita49UdpDevice::receiveThread()
+{
+   CommonUtils::configureCurrentThread(_streamThreadRole);
+
+   ReceiveSlots slots;
+   pollfd waiter{_socket, POLLIN, 0};
+   while (_streaming)
+   {
+      const int ready = ::poll(&waiter, 1, POLL_TIMEOUT_MS);
+      if (ready == 0)
+      {
+         _streamCounters.recordTimeout();
+         continue;
+      }
+      if (ready < 0)
+      {
+         if (errno != EINTR)
+         {
+            _streamCounters.recordError();
+         }
+         continue;
+      }
+      receiveBatch(slots);
+   }
+}
+
+CommonUtils::IoTask Vita49UdpDevice::receiveTask(CommonUtils::IoContext& context,
+                                                 std::promise<void> done)
+{
+   // `done` also completes (broken) if the coroutine is destroyed with the
+   // context, so stopStreaming() never waits for a task that cannot run.
+   ReceiveSlots slots;
+   while (_streaming)
+   {
+      if (co_await context.readable(_socket, std::chrono::milliseconds(POLL_TIMEOUT_MS)) ==
+          CommonUtils::IoWait::Timeout)
+      {
+         _streamCounters.recordTimeout();
+         continue;
+      }
+      receiveBatch(slots);
+   }
+   context.forget(_socket);
+   done.set_value();
+}
+
+void Vita49UdpDevice::receiveBatch(ReceiveSlots& slots)
+{
+   auto& [datagrams, iovecs, messages] = slots;
+   const int received = ::recvmmsg(_socket, messages.data(), static_cast<unsigned>(RECV_BATCH),
+                                   MSG_DONTWAIT, nullptr);
+   if (received <= 0)
+   {
+      if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      {
+         _streamCounters.recordError();
+      }
+      return;
+   }
+
+   _batchFilled = 0;
+   for (std::size_t i = 0; i < static_cast<std::size_t>(received); ++i)
+   {
+      if ((messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0)
+      {
+         _streamCounters.recordError();   // Larger than MAX_DATAGRAM_BYTES.
+         continue;
+      }
+      decodeDatagram(static_cast<const uint8_t*>(iovecs[i].iov_base), messages[i].msg_len);
+   }
+   const std::size_t filled = _batchFilled;
+   if (filled == 0 || !_streaming)
+   {
+      return;
+   }
+
+   _streamCounters.recordRead(filled, filled);
+   if (_rawCallback)
+   {
+      _rawCallback(RawIqBlock{_batch.data(), IqSampleFormat::CF32, filled, 1.0F});
+   }
+   else
+   {
+      _callback(_batch.data(), filled);
+   }
+}
+
+void Vita49UdpDevice::decodeDatagram(const uint8_t* data, std::size_t bytes)
+{
+   std::size_t consumed = 0;
+   const Vita49_2::PacketStreamView stream({data, bytes}, Vita49_2::ByteOrder::BigEndian);
+   for (auto packet = stream.begin(); packet != stream.end(); ++packet)
+   {
+      consumed = packet.offset() + packet->bytes().size();
+      const auto streamId = packet->header().streamId;
+      if (_followedStream.has_value() && streamId.has_value() && *streamId != *_followedStream)
+      {
+         continue;
+      }
+      if (packet->isSignalData() && !_followedStream.has_value() && streamId.has_value())
+      {
+         _followedStream = streamId;
+         GPINFO("Vita49UdpDevice: following stream 0x{:08X}", *streamId);
+      }
+
+      // Tagged with the format announced by now, in case it is held
+      Vita49_2::PacketView view = *packet;
+      view.setPayloadFormat(_payloadFormat);
+      _sequencer->push(view);
+   }
+   if (consumed < bytes)
+   {
+      _streamCounters.recordError();   // Malformed packet or trailing garbage.
+   }
+}
+
+void Vita49UdpDevice::deliverPacket(const Vita49_2::PacketView& packet)
+{
+   if (packet.isSignalData())
+   {
+      const std::size_t count = packet.sampleCount();
+      if (_batch.size() < _batchFilled + count)
+      {
+         _batch.resize(_batchFilled + count);
+      }
+      _batchFilled += packet.decodeSamples({_batch.data() + _batchFilled, count});
+   }
+   else if (packet.isContext())
+   {
+      _contextCache->update(packet);   // Applies the fields on change.
+   }
+}
+
+void Vita49UdpDevice::fillGap(uint32_t packets, uint64_t samples)
+{
+   _streamCounters.recordOverflow();
+   _lostPackets.fetch_add(packets, std::memory_order_relaxed);
+
+   const auto zeros = static_cast<std::size_t>(
+      std::min<uint64_t>(samples, MAX_GAP_FILL_SAMPLES));
+   if (_batch.size() < _batchFilled + zeros)
+   {
+      _batch.resize(_batchFilled + zeros);
+   }
+   std::fill_n(_batch.begin() + static_cast<std::ptrdiff_t>(_batchFilled), zeros, IqSample{});
+   _batchFilled += zeros;
+}
+
+void Vita49UdpDevice::applyContext(const Vita49_2::ContextFields& fields)
+{
+   if (fields.sampleRate.has_value() && *fields.sampleRate > 0.0)
+   {
+      _sampleRateHz.store(static_cast<uint32_t>(std::lround(*fields.sampleRate)),
+                          std::memory_order_relaxed);
+   }
+   if (fields.rfFrequency.has_value() && *fields.rfFrequency > 0.0)
+   {
+      _centerFreqHz.store(static_cast<uint64_t>(std::llround(*fields.rfFrequency)),
+                          std::memory_order_relaxed);
+   }
+   if (fields.payloadFormat.has_value())
+   {
+      _payloadFormat = *fields.payloadFormat;
+   }
+}
+
+// ============================================================================
+// Device info
+// ============================================================================
+
+std::string Vita49UdpDevice::getName() const
+{
+   return "VITA 49 UDP: " + _address + ":" + std::to_string(getBoundPort());
+}
+
+std::vector<DeviceInfo> Vita49UdpDevice::enumerateDevices() const
+{
+   DeviceInfo info;
+   info.index        = 0;
+   info.name         = _address + ":" + std::to_string(getBoundPort());
+   info.manufacturer = "VITA 49 / UDP";
+   return {info};
+}
+
+} // namespace SdrEngine
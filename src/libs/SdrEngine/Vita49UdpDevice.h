@@ -0,0 +1,246 @@
+#ifndef VITA49UDPDEVICE_H_
+#define VITA49UDPDEVICE_H_
+
+// Project headers
+#include "ISdrDevice.h"
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+namespace CommonUtils
+{
+class IoContext;
+class IoTask;
+}
+
+namespace Vita49_2
+{
+enum class PayloadFormat : uint8_t;
+struct ContextFields;
+class ContextCache;
+class PacketSequencer;
+class PacketView;
+}
+
+namespace SdrEngine
+{
+
+/**
+ * @class Vita49UdpDevice
+ * @brief ISdrDevice fed by a VITA 49.2 signal data stream over UDP.
+ *
+ * Lets the whole pipeline run on a networked front-end that emits VITA 49
+ * (one or more big-endian packets per datagram).  open() binds a UDP
+ * socket (joining the group if the address is multicast) with a large
+ * receive buffer; the stream thread drains it with recvmmsg(), up to
+ * RECV_BATCH datagrams per system call, decodes every signal data packet
+ * of the batch into one buffer and delivers it as a single CF32 block.
+ *
+ * The sender owns tuning and format: sample rate, centre frequency and
+ * payload format (16-bit until announced otherwise) are taken from its
+ * context packets.  setSampleRate() / setCenterFrequency() only set the
+ * values reported until the first context packet says otherwise.  Repeated
+ * context packets are compared with the previous one (Vita49_2::ContextCache)
+ * and only applied when their fields change.
+ *
+ * Signal data packets go through a Vita49_2::PacketSequencer: duplicates
+ * are dropped, reordered packets are put back in order within the reorder
+ * window (setReorderWindow(), off by default), and each loss counts one
+ * overflow in getStreamStats() and its missing packets in getLostPackets().
+ * The lost samples are delivered as zeros (up to MAX_GAP_FILL_SAMPLES per
+ * gap), so the sample clock downstream stays continuous.  Without a stream
+ * filter the device follows the first signal data stream it receives and
+ * ignores the others.
+ *
+ * By default the stream runs on a thread of its own.  With setIoContext()
+ * it runs as a coroutine on a shared CommonUtils::IoContext instead, so
+ * many streams can be received by a few I/O threads.
+ *
+ * Thread-safety: same as ISdrDevice.
+ */
+class Vita49UdpDevice : public ISdrDevice
+{
+public:
+   /** @brief Datagrams taken from the socket per recvmmsg() call. */
+   static constexpr std::size_t RECV_BATCH = 32;
+
+   /** @brief Largest datagram accepted; larger ones are counted as errors. */
+   static constexpr std::size_t MAX_DATAGRAM_BYTES = 65'536;
+
+   /** @brief Receive buffer requested from the kernel (capped by rmem_max). */
+   static constexpr int RECEIVE_BUFFER_BYTES = 32 * 1024 * 1024;
+
+   /** @brief Most zeros delivered for one gap in the stream. */
+   static constexpr std::size_t MAX_GAP_FILL_SAMPLES = 1U << 20;
+
+   Vita49UdpDevice();
+
+   /**
+    * @brief Construct a device listening on one endpoint.
+    * @param address  Local IPv4 address, or a multicast group to join.
+    * @param port     UDP port (0 = any free port, see getBoundPort()).
+    */
+   Vita49UdpDevice(std::string address, uint16_t port);
+
+   ~Vita49UdpDevice() override;
+
+   // -- Network -------------------------------------------------------------
+
+   /**
+    * @brief Select the endpoint to listen on.  Only while closed.
+    * @param address  Local IPv4 address, or a multicast group to join.
+    * @param port     UDP port (0 = any free port).
+    * @return true on success, false if the device is open.
+    */
+   [[nodiscard]] bool setEndpoint(std::string address, uint16_t port);
+
+   /**
+    * @brief Only accept signal data and context packets of one stream.
+    * Takes effect the next time streaming starts.
+    * @param streamId  Stream ID to follow, or std::nullopt for the first seen.
+    */
+   void setStreamFilter(std::optional<uint32_t> streamId);
+
+   /**
+    * @brief Hold up to `packets` signal data packets to undo reordering.
+    * Takes effect the next time streaming starts.  Each held packet delays
+    * the declaration of a loss, not the packets that arrive in order.
+    * @param packets  Window size (0 = off; capped at 7 by the 4-bit count).
+    */
+   void setReorderWindow(std::size_t packets);
+
+   /**
+    * @brief Receive on an I/O context instead of a thread of the device's own.
+    * Takes effect the next time streaming starts; the stream thread role
+    * is then not used.  The context must outlive streaming, and callbacks
+    * run on its thread, so they must not block it for long.
+    * @param context  Context to run on, or nullptr for an own thread.
+    */
+   void setIoContext(CommonUtils::IoContext* context);
+
+   /**
+    * @brief Get the port the socket is bound to.
+    * @return Bound port while open, otherwise the configured one.
+    */
+   [[nodiscard]] uint16_t getBoundPort() const;
+
+   /**
+    * @brief Get the signal data packets missed since streaming started.
+    * @return Missing packets, from packetCount (and sample-count timestamp) gaps.
+    */
+   [[nodiscard]] uint64_t getLostPackets() const;
+
+   // -- ISdrDevice ----------------------------------------------------------
+
+   /**
+    * @brief Bind the UDP socket.
+    * @param deviceIndex  Must be 0 (the endpoint is the only "device").
+    * @return true on success.
+    */
+   [[nodiscard]] bool open(int deviceIndex = 0) override;
+   void close() override;
+   [[nodiscard]] bool isOpen() const override;
+
+   [[nodiscard]] bool setCenterFrequency(uint64_t frequencyHz) override;
+   [[nodiscard]] uint64_t getCenterFrequency() const override;
+
+   [[nodiscard]] bool setSampleRate(uint32_t rateHz) override;
+   [[nodiscard]] uint32_t getSampleRate() const override;
+
+   [[nodiscard]] bool setAutoGain(bool enabled) override;
+   [[nodiscard]] bool setGain(int tenthsDb) override;
+   [[nodiscard]] int getGain() const override;
+   [[nodiscard]] std::vector<int> getGainValues() const override;
+
+   [[nodiscard]] bool startStreaming(IqCallback callback,
+                                    std::size_t bufferSize = 8192) override;
+   [[nodiscard]] bool startRawStreaming(RawIqCallback callback,
+                                       std::size_t bufferSize = 8192) override;
+   void stopStreaming() override;
+   [[nodiscard]] bool isStreaming() const override;
+   [[nodiscard]] DeviceStreamStats getStreamStats() const override;
+   void setStreamThreadRole(std::string role) override;
+
+   [[nodiscard]] std::string getName() const override;
+   [[nodiscard]] std::vector<DeviceInfo> enumerateDevices() const override;
+
+private:
+   // Launch the receive thread.  Exactly one of the callbacks must be set.
+   [[nodiscard]] bool beginStreaming(IqCallback callback, RawIqCallback rawCallback);
+
+   // One slot per datagram of a recvmmsg() batch.
+   struct ReceiveSlots
+   {
+      ReceiveSlots();
+
+      std::vector<uint8_t> datagrams;
+      std::vector<iovec> iovecs;
+      std::vector<mmsghdr> messages;
+   };
+
+   // Thread body: wait for datagrams with poll() and receive them.
+   void receiveThread();
+
+   // Coroutine body: the same, waiting on `context`; fulfils `done` on exit.
+   CommonUtils::IoTask receiveTask(CommonUtils::IoContext& context, std::promise<void> done);
+
+   // Receive, decode and deliver the datagrams queued on the socket.
+   void receiveBatch(ReceiveSlots& slots);
+
+   // Pass the packets of one datagram to the sequencer.
+   void decodeDatagram(const uint8_t* data, std::size_t bytes);
+
+   // Sequencer output: append a packet's samples to the batch, or take
+   // its context.
+   void deliverPacket(const Vita49_2::PacketView& packet);
+
+   // Sequencer output: count a loss and zero-fill it in the batch.
+   void fillGap(uint32_t packets, uint64_t samples);
+
+   // Take rate, frequency and payload format from changed context fields.
+   void applyContext(const Vita49_2::ContextFields& fields);
+
+   std::string _address{"0.0.0.0"};
+   uint16_t _port{0};
+   int _socket{-1};
+   uint16_t _boundPort{0};
+
+   std::atomic<uint64_t> _centerFreqHz{0};
+   std::atomic<uint32_t> _sampleRateHz{0};
+   std::atomic<int> _gainTenthsDb{0};
+
+   // The filter and window are taken when streaming starts; from then on
+   // the followed stream, sequencer, payload format and batch belong to the
+   // receive thread.
+   std::optional<uint32_t> _streamFilter;
+   std::optional<uint32_t> _followedStream;
+   Vita49_2::PayloadFormat _payloadFormat{};
+   std::unique_ptr<Vita49_2::ContextCache> _contextCache;
+   std::size_t _reorderWindow{0};
+   std::unique_ptr<Vita49_2::PacketSequencer> _sequencer;
+   std::vector<IqSample> _batch;       // Grows to the largest batch seen.
+   std::size_t _batchFilled{0};
+   std::atomic<uint64_t> _lostPackets{0};
+
+   std::atomic<bool> _streaming{false};
+   DeviceStreamCounters _streamCounters;   // Written by the receive thread.
+   std::thread _streamThread;
+   CommonUtils::IoContext* _ioContext{nullptr};   // Set while stopped.
+   std::future<void> _ioTaskDone;      // Valid while receiveTask() runs.
+   std::string _streamThreadRole{"Vita49Udp.recv"};   // Set while stopped.
+   IqCallback _callback;               ///< Set by startStreaming().
+   RawIqCallback _rawCallback;         ///< Set by startRawStreaming().
+};
+
+} // namespace SdrEngine
+
+#endif // VITA49UDPDEVICE_H_
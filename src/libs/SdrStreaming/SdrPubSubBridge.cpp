@@ -0,0 +1,235 @@
+// Project headers
+#include "SdrPubSubBridge.h"
+#include "GeneralLogger.h"
+#include "HighBandwidthPublisher.h"
+#include "SharedMemoryPublisher.h"
+#include "SignalFrameCodec.h"
+
+// System headers
+#include <array>
+#include <google/protobuf/arena.h>
+#include <utility>
+
+namespace SdrStreaming
+{
+
+namespace
+{
+
+// Arena block holding an attachment's message (its payloads live on the heap).
+constexpr std::size_t ARENA_BLOCK_BYTES = 4096;
+
+std::chrono::steady_clock::duration intervalFor(double rateHz)
+{
+   if (rateHz <= 0.0)
+   {
+      return std::chrono::steady_clock::duration::zero();
+   }
+   return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / rateHz));
+}
+
+google::protobuf::ArenaOptions arenaOptions(std::array<char, ARENA_BLOCK_BYTES>& block)
+{
+   google::protobuf::ArenaOptions options;
+   options.initial_block      = block.data();
+   options.initial_block_size = block.size();
+   return options;
+}
+
+} // namespace
+
+struct SdrPubSubBridge::Attachment
+{
+   Attachment(std::string topicName, const SpectrumCodecOptions& codec)
+      : topic(std::move(topicName))
+      , spectrumEncoder(codec)
+      , arena(arenaOptions(arenaBlock))
+   {
+   }
+
+   std::string topic;
+   SpectrumFrameEncoder spectrumEncoder;
+   uint64_t sequence{0};
+   std::chrono::steady_clock::time_point lastSent;
+   std::function<void()> unregister;
+
+   // Declared before the arena, which allocates from it.
+   alignas(std::max_align_t) std::array<char, ARENA_BLOCK_BYTES> arenaBlock{};
+   google::protobuf::Arena arena;
+   messages::SpectrumFrame* spectrumFrame{nullptr};
+   messages::IqFrame* iqFrame{nullptr};
+};
+
+SdrPubSubBridge::SdrPubSubBridge(PublishFunction publish, const BridgeOptions& options)
+   : _publish(std::move(publish))
+   , _options(options)
+   , _spectrumInterval(intervalFor(options.maxSpectrumRateHz))
+{
+}
+
+SdrPubSubBridge::SdrPubSubBridge(HighBandwidthPublisher& publisher, const BridgeOptions& options)
+   : SdrPubSubBridge(
+        [&publisher](const std::string& topic, const google::protobuf::Message& message)
+        {
+           return publisher.publish(topic, message);
+        },
+        options)
+{
+}
+
+SdrPubSubBridge::SdrPubSubBridge(SharedMemoryPublisher& publisher, const BridgeOptions& options)
+   : SdrPubSubBridge(
+        [&publisher](const std::string& topic, const google::protobuf::Message& message)
+        {
+           return publisher.publish(topic, message);
+        },
+        options)
+{
+}
+
+SdrPubSubBridge::~SdrPubSubBridge()
+{
+   detachAll();
+}
+
+// ============================================================================
+// Attachments
+// ============================================================================
+
+void SdrPubSubBridge::attachSpectrum(
+   CommonUtils::DataHandler<std::shared_ptr<const SdrEngine::SpectrumData>>& handler,
+   const std::string& topic)
+{
+   auto attachment = std::make_unique<Attachment>(topic, _options.spectrumCodec);
+   attachment->spectrumFrame = google::protobuf::Arena::CreateMessage<messages::SpectrumFrame>(&attachment->arena);
+
+   // Only the newest spectrum is worth sending; never hold up the engine.
+   Attachment* target = attachment.get();
+   const int id = handler.registerListener(
+      [this, target](const std::shared_ptr<const SdrEngine::SpectrumData>& spectrum)
+      {
+         if (spectrum)
+         {
+            publishSpectrum(*target, *spectrum);
+         }
+      },
+      CommonUtils::ListenerOptions{CommonUtils::DispatchMode::DedicatedThread,
+                                   CommonUtils::OverflowPolicy::LatestOnly, 1, nullptr});
+   if (id < 0)
+   {
+      GPWARN("Cannot publish spectrum on {}: data handler stopped", topic);
+      return;
+   }
+   attachment->unregister = [&handler, id] { handler.unregisterListener(id); };
+
+   const std::lock_guard<std::mutex> lock(_attachmentsMutex);
+   _attachments.push_back(std::move(attachment));
+}
+
+void SdrPubSubBridge::attachIq(CommonUtils::DataHandler<std::shared_ptr<const SdrEngine::IqBuffer>>& handler,
+                               const std::string& topic)
+{
+   auto attachment = std::make_unique<Attachment>(topic, _options.spectrumCodec);
+   attachment->iqFrame = google::protobuf::Arena::CreateMessage<messages::IqFrame>(&attachment->arena);
+
+   // A gap is unavoidable when the link is too slow; drop whole old buffers.
+   Attachment* target = attachment.get();
+   const int id = handler.registerListener(
+      [this, target](const std::shared_ptr<const SdrEngine::IqBuffer>& buffer)
+      {
+         if (buffer)
+         {
+            publishIq(*target, *buffer);
+         }
+      },
+      CommonUtils::ListenerOptions{CommonUtils::DispatchMode::DedicatedThread,
+                                   CommonUtils::OverflowPolicy::DropOldest, _options.iqQueueCapacity, nullptr});
+   if (id < 0)
+   {
+      GPWARN("Cannot publish I/Q on {}: data handler stopped", topic);
+      return;
+   }
+   attachment->unregister = [&handler, id] { handler.unregisterListener(id); };
+
+   const std::lock_guard<std::mutex> lock(_attachmentsMutex);
+   _attachments.push_back(std::move(attachment));
+}
+
+void SdrPubSubBridge::detachAll()
+{
+   const std::lock_guard<std::mutex> lock(_attachmentsMutex);
+   for (const auto& attachment : _attachments)
+   {
+      // Waits for a dispatch in progress, so the attachment is idle after this.
+      attachment->unregister();
+   }
+   _attachments.clear();
+}
+
+// ============================================================================
+// Publishing (attachment dispatch threads)
+// ============================================================================
+
+void SdrPubSubBridge::publishSpectrum(Attachment& attachment, const SdrEngine::SpectrumData& spectrum)
+{
+   const auto now = std::chrono::steady_clock::now();
+   if (attachment.sequence > 0 && now - attachment.lastSent < _spectrumInterval)
+   {
+      _spectrumFramesSkipped.fetch_add(1, std::memory_order_relaxed);
+      return;
+   }
+   attachment.lastSent = now;
+
+   messages::SpectrumFrame& frame = *attachment.spectrumFrame;
+   attachment.spectrumEncoder.encode(spectrum, frame);
+   frame.set_sequence(attachment.sequence++);
+   if (send(attachment, frame))
+   {
+      _spectrumFramesSent.fetch_add(1, std::memory_order_relaxed);
+   }
+   else
+   {
+      attachment.spectrumEncoder.requestKeyframe();   // Receivers cannot apply the next delta
+   }
+}
+
+void SdrPubSubBridge::publishIq(Attachment& attachment, const SdrEngine::IqBuffer& buffer)
+{
+   messages::IqFrame& frame = *attachment.iqFrame;
+   encodeIqFrame(buffer, _options.iqEncoding, frame);
+   frame.set_sequence(attachment.sequence++);
+   if (send(attachment, frame))
+   {
+      _iqFramesSent.fetch_add(1, std::memory_order_relaxed);
+   }
+}
+
+bool SdrPubSubBridge::send(Attachment& attachment, const google::protobuf::Message& message)
+{
+   if (!_publish(attachment.topic, message))
+   {
+      _publishFailures.fetch_add(1, std::memory_order_relaxed);
+      GPWARN_LIMITED(CommonUtils::HOT_PATH_LOGS_PER_SECOND, "Failed to publish frame on {}", attachment.topic);
+      return false;
+   }
+   _payloadBytes.fetch_add(message.ByteSizeLong(), std::memory_order_relaxed);
+   return true;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+BridgeStats SdrPubSubBridge::stats() const
+{
+   BridgeStats out;
+   out.spectrumFramesSent    = _spectrumFramesSent.load(std::memory_order_relaxed);
+   out.spectrumFramesSkipped = _spectrumFramesSkipped.load(std::memory_order_relaxed);
+   out.iqFramesSent          = _iqFramesSent.load(std::memory_order_relaxed);
+   out.publishFailures       = _publishFailures.load(std::memory_order_relaxed);
+   out.payloadBytes          = _payloadBytes.load(std::memory_order_relaxed);
+   return out;
+}
+
+} // namespace SdrStreaming
@@ -0,0 +1,164 @@
+#ifndef SDRPUBSUBBRIDGE_H_
+#define SDRPUBSUBBRIDGE_H_
+
+// Project headers
+#include "DataHandler.h"
+#include "SdrTypes.h"
+#include "SpectrumCodec.h"
+#include "signal_data.pb.h"
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google::protobuf
+{
+class Message;
+}
+
+class HighBandwidthPublisher;
+class SharedMemoryPublisher;
+
+namespace SdrStreaming
+{
+
+/**
+ * @class BridgeOptions
+ * @brief What an SdrPubSubBridge sends, bounding its network cost.
+ */
+struct BridgeOptions
+{
+   messages::IqEncoding iqEncoding{messages::IQ_ENCODING_CS16};   ///< CS16 halves CF32.
+   double maxSpectrumRateHz{30.0};     ///< Spectrum frames per second per topic (0 = every frame).
+   SpectrumCodecOptions spectrumCodec{.maxPoints = 2048};   ///< Spectrum resolution, delta and LZ4.
+   std::size_t iqQueueCapacity{16};    ///< IqBuffers queued per topic before the oldest is dropped.
+};
+
+/**
+ * @class BridgeStats
+ * @brief Snapshot of an SdrPubSubBridge's counters since construction.
+ */
+struct BridgeStats
+{
+   uint64_t spectrumFramesSent{0};      ///< SpectrumFrames published.
+   uint64_t spectrumFramesSkipped{0};   ///< Spectra not sent because of maxSpectrumRateHz.
+   uint64_t iqFramesSent{0};            ///< IqFrames published.
+   uint64_t publishFailures{0};         ///< Frames the publisher refused.
+   uint64_t payloadBytes{0};            ///< Serialized size of the frames published.
+};
+
+/**
+ * @class SdrPubSubBridge
+ * @brief Publishes SdrEngine spectrum and I/Q streams as signal_data.proto frames.
+ *
+ * attachSpectrum() / attachIq() register a listener on an SdrEngine
+ * DataHandler; each frame is encoded (SignalFrameCodec.h) and published on
+ * the given topic.  Every attachment has its own dispatch thread, so a
+ * slow network never stalls the engine: spectra are coalesced to the
+ * newest (DataHandler LatestOnly) and additionally thinned to
+ * maxSpectrumRateHz, and I/Q drops its oldest buffers once
+ * iqQueueCapacity are waiting.  The cost on the wire is therefore bounded
+ * by the options, not by the engine's frame rate or the number of remote
+ * GUIs (which all join the same multicast or shared-memory stream).
+ *
+ * Spectra go through a SpectrumFrameEncoder per attachment
+ * (`spectrumCodec`); with delta coding, a frame the publisher refuses
+ * makes the next one a key frame.
+ *
+ * Each attachment encodes into one message allocated on its own protobuf
+ * Arena.  The message is kept across frames, so its `bytes` payloads keep
+ * their capacity and a steady stream encodes without allocating.
+ *
+ * Thread-safety: attach / detach / stats may be called from any thread.
+ * The DataHandlers must outlive their attachment.
+ */
+class SdrPubSubBridge
+{
+public:
+   /**
+    * @brief Sends one frame; returns false if it was not sent.
+    * Called concurrently from the attachments' dispatch threads.
+    */
+   using PublishFunction = std::function<bool(const std::string& topic, const google::protobuf::Message& message)>;
+
+   /**
+    * @brief Construct a bridge around any publisher.
+    * @param publish  Called for every frame.
+    * @param options  Rate, resolution and encoding limits.
+    */
+   explicit SdrPubSubBridge(PublishFunction publish, const BridgeOptions& options = {});
+
+   /** @brief Construct a bridge publishing on a multicast publisher (which must outlive it). */
+   explicit SdrPubSubBridge(HighBandwidthPublisher& publisher, const BridgeOptions& options = {});
+
+   /** @brief Construct a bridge publishing on a same-host publisher (which must outlive it). */
+   explicit SdrPubSubBridge(SharedMemoryPublisher& publisher, const BridgeOptions& options = {});
+
+   /** @brief Detach from every DataHandler. */
+   ~SdrPubSubBridge();
+
+   // Non-copyable, non-movable (listeners capture this).
+   SdrPubSubBridge(const SdrPubSubBridge&) = delete;
+   SdrPubSubBridge& operator=(const SdrPubSubBridge&) = delete;
+   SdrPubSubBridge(SdrPubSubBridge&&) = delete;
+   SdrPubSubBridge& operator=(SdrPubSubBridge&&) = delete;
+
+   /**
+    * @brief Publish a spectrum stream (e.g. SdrEngine::spectrumDataHandler()).
+    * @param handler  Stream to publish.
+    * @param topic    PubSub topic of the SpectrumFrames.
+    */
+   void attachSpectrum(CommonUtils::DataHandler<std::shared_ptr<const SdrEngine::SpectrumData>>& handler,
+                       const std::string& topic);
+
+   /**
+    * @brief Publish an I/Q stream (e.g. SdrEngine::iqDataHandler()).
+    * @param handler  Stream to publish.
+    * @param topic    PubSub topic of the IqFrames.
+    */
+   void attachIq(CommonUtils::DataHandler<std::shared_ptr<const SdrEngine::IqBuffer>>& handler,
+                 const std::string& topic);
+
+   /** @brief Remove every attachment; no frame is being published once this returns. */
+   void detachAll();
+
+   /**
+    * @brief Get the bridge's counters.
+    * @return Counters since construction.
+    */
+   [[nodiscard]] BridgeStats stats() const;
+
+private:
+   // One attached stream: its topic, sequence and reused message.
+   struct Attachment;
+
+   void publishSpectrum(Attachment& attachment, const SdrEngine::SpectrumData& spectrum);
+   void publishIq(Attachment& attachment, const SdrEngine::IqBuffer& buffer);
+
+   // Publish the attachment's encoded message; counts bytes and failures.
+   bool send(Attachment& attachment, const google::protobuf::Message& message);
+
+   PublishFunction _publish;
+   const BridgeOptions _options;
+   const std::chrono::steady_clock::duration _spectrumInterval;
+
+   std::mutex _attachmentsMutex;
+   std::vector<std::unique_ptr<Attachment>> _attachments;
+
+   std::atomic<uint64_t> _spectrumFramesSent{0};
+   std::atomic<uint64_t> _spectrumFramesSkipped{0};
+   std::atomic<uint64_t> _iqFramesSent{0};
+   std::atomic<uint64_t> _publishFailures{0};
+   std::atomic<uint64_t> _payloadBytes{0};
+};
+
+} // namespace SdrStreaming
+
+#endif // SDRPUBSUBBRIDGE_H_
@@ -0,0 +1,141 @@
+// Project headers
+#include "SignalFrameCodec.h"
+
+// System headers
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace SdrStreaming
+{
+
+static_assert(std::endian::native == std::endian::little,
+              "signal_data.proto payloads are little-endian; add byte swapping for this target");
+
+namespace
+{
+
+// CS16 code of full scale (+1.0).
+constexpr float CS16_FULL_SCALE = 32767.0F;
+
+int64_t toNanoseconds(std::chrono::steady_clock::time_point time)
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+int16_t toCs16(float value)
+{
+   const float scaled = std::clamp(value * CS16_FULL_SCALE, -CS16_FULL_SCALE - 1.0F, CS16_FULL_SCALE);
+   return static_cast<int16_t>(std::lrintf(scaled));
+}
+
+} // namespace
+
+// ============================================================================
+// IQ
+// ============================================================================
+
+void encodeIqFrame(const SdrEngine::IqBuffer& buffer, messages::IqEncoding encoding,
+                   messages::IqFrame& frame)
+{
+   const std::size_t n = buffer.samples.size();
+   frame.set_timestamp_ns(toNanoseconds(buffer.sourceTime()));
+   frame.set_center_freq_hz(buffer.centerFreqHz);
+   frame.set_sample_rate_hz(buffer.sampleRateHz);
+   frame.set_num_samples(static_cast<uint32_t>(n));
+
+   std::string& payload = *frame.mutable_samples();
+   if (encoding == messages::IQ_ENCODING_CF32)
+   {
+      frame.set_encoding(messages::IQ_ENCODING_CF32);
+      frame.set_scale(1.0F);
+      payload.resize(n * sizeof(SdrEngine::IqSample));
+      if (n > 0)
+      {
+         std::memcpy(payload.data(), buffer.samples.data(), payload.size());
+      }
+      return;
+   }
+
+   frame.set_encoding(messages::IQ_ENCODING_CS16);
+   frame.set_scale(CS16_FULL_SCALE);
+   payload.resize(n * 2 * sizeof(int16_t));
+   char* out = payload.data();
+   for (const SdrEngine::IqSample& sample : buffer.samples)
+   {
+      const int16_t pair[2] = {toCs16(sample.real()), toCs16(sample.imag())};
+      std::memcpy(out, pair, sizeof(pair));
+      out += sizeof(pair);
+   }
+}
+
+bool decodeIqFrame(const messages::IqFrame& frame, SdrEngine::IqBuffer& buffer)
+{
+   const std::size_t n = frame.num_samples();
+   const std::string& payload = frame.samples();
+   buffer.centerFreqHz = frame.center_freq_hz();
+   buffer.sampleRateHz = frame.sample_rate_hz();
+
+   switch (frame.encoding())
+   {
+      case messages::IQ_ENCODING_CF32:
+         if (payload.size() != n * sizeof(SdrEngine::IqSample))
+         {
+            return false;
+         }
+         buffer.samples.resize(n);
+         if (n > 0)
+         {
+            std::memcpy(buffer.samples.data(), payload.data(), payload.size());
+         }
+         return true;
+
+      case messages::IQ_ENCODING_CS16:
+      {
+         if (payload.size() != n * 2 * sizeof(int16_t) || frame.scale() <= 0.0F)
+         {
+            return false;
+         }
+         const float scale = 1.0F / frame.scale();
+         buffer.samples.resize(n);
+         const char* in = payload.data();
+         for (SdrEngine::IqSample& sample : buffer.samples)
+         {
+            int16_t pair[2];
+            std::memcpy(pair, in, sizeof(pair));
+            in += sizeof(pair);
+            sample = {static_cast<float>(pair[0]) * scale, static_cast<float>(pair[1]) * scale};
+         }
+         return true;
+      }
+
+      default:
+         return false;
+   }
+}
+
+// ============================================================================
+// Spectrum
+// ============================================================================
+
+void encodeSpectrumFrame(const SdrEngine::SpectrumData& spectrum, std::size_t maxPoints,
+                         messages::SpectrumFrame& frame)
+{
+   SpectrumCodecOptions options;
+   options.maxPoints = maxPoints;
+   SpectrumFrameEncoder encoder(options);
+   encoder.encode(spectrum, frame);
+}
+
+bool decodeSpectrumFrame(const messages::SpectrumFrame& frame, SdrEngine::SpectrumData& spectrum)
+{
+   SpectrumFrameDecoder decoder;
+   return !frame.delta() && decoder.decode(frame, spectrum);
+}
+
+} // namespace SdrStreaming
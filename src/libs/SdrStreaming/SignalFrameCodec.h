@@ -0,0 +1,64 @@
+#ifndef SIGNALFRAMECODEC_H_
+#define SIGNALFRAMECODEC_H_
+
+// Project headers
+#include "SdrTypes.h"
+#include "SpectrumCodec.h"
+#include "signal_data.pb.h"
+
+// System headers
+#include <cstddef>
+
+namespace SdrStreaming
+{
+
+/**
+ * @brief Encode an IqBuffer into an IqFrame.
+ *
+ * CS16 halves the payload of CF32; samples are scaled by 32767 and clipped
+ * to the int16 range, so the stream must stay within +/-1.0 full scale.
+ * Every field but `sequence` is written.  The frame's `samples` string is
+ * resized, not reallocated, so reusing one frame keeps its buffer.
+ *
+ * @param buffer    Samples and tuning to encode.
+ * @param encoding  IQ_ENCODING_CS16 or IQ_ENCODING_CF32 (anything else: CS16).
+ * @param frame     Output frame.
+ */
+void encodeIqFrame(const SdrEngine::IqBuffer& buffer, messages::IqEncoding encoding,
+                   messages::IqFrame& frame);
+
+/**
+ * @brief Decode an IqFrame back into samples.
+ * @param frame   Frame produced by encodeIqFrame().
+ * @param buffer  Output; `samples`, `centerFreqHz` and `sampleRateHz` are set.
+ * @return false if the encoding is unknown or the payload size does not
+ *         match `num_samples`.
+ */
+bool decodeIqFrame(const messages::IqFrame& frame, SdrEngine::IqBuffer& buffer);
+
+/**
+ * @brief Encode a SpectrumData into a self-contained 8-bit SpectrumFrame.
+ *
+ * A stateless SpectrumFrameEncoder with default options and @p maxPoints:
+ * peak-decimated, quantized to the frame's own range, no delta.
+ *
+ * @param spectrum   Spectrum to encode.
+ * @param maxPoints  Largest number of points sent (0 = full resolution).
+ * @param frame      Output frame; every field but `sequence` is written.
+ */
+void encodeSpectrumFrame(const SdrEngine::SpectrumData& spectrum, std::size_t maxPoints,
+                         messages::SpectrumFrame& frame);
+
+/**
+ * @brief Decode a SpectrumFrame back into dB traces.
+ * @param frame     Frame produced by encodeSpectrumFrame().
+ * @param spectrum  Output; the traces, `centerFreqHz`, `bandwidthHz` and
+ *                  `fftSize` are set.  The traces have one value per point.
+ * @return false if the frame is malformed or a delta frame (decode streams
+ *         with SpectrumFrameDecoder).
+ */
+bool decodeSpectrumFrame(const messages::SpectrumFrame& frame, SdrEngine::SpectrumData& spectrum);
+
+} // namespace SdrStreaming
+
+#endif // SIGNALFRAMECODEC_H_
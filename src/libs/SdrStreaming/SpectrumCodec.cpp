@@ -0,0 +1,394 @@
+// Project headers
+#include "SpectrumCodec.h"
+
+// System headers
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <lz4.h>
+
+namespace SdrStreaming
+{
+
+namespace
+{
+
+constexpr uint32_t MAX_CODE_8  = 0xFFU;
+constexpr uint32_t MAX_CODE_16 = 0xFFFFU;
+
+uint32_t maxCodeFor(uint32_t bitsPerCode)
+{
+   return (bitsPerCode == 16) ? MAX_CODE_16 : MAX_CODE_8;
+}
+
+// Peak- (or, with `useMin`, minimum-) decimate `in` by `binsPerPoint`.
+void decimate(const std::vector<float>& in, std::size_t binsPerPoint, bool useMin, std::vector<float>& out)
+{
+   out.clear();
+   if (binsPerPoint <= 1)
+   {
+      out.assign(in.begin(), in.end());
+      return;
+   }
+   out.reserve((in.size() + binsPerPoint - 1) / binsPerPoint);
+   for (std::size_t first = 0; first < in.size(); first += binsPerPoint)
+   {
+      const auto begin = in.begin() + static_cast<std::ptrdiff_t>(first);
+      const auto end   = in.begin() + static_cast<std::ptrdiff_t>(std::min(in.size(), first + binsPerPoint));
+      out.push_back(useMin ? *std::min_element(begin, end) : *std::max_element(begin, end));
+   }
+}
+
+// Widen [lo, hi] to cover the finite values of `trace`.
+void extendRange(const std::vector<float>& trace, float& lo, float& hi)
+{
+   for (const float value : trace)
+   {
+      if (std::isfinite(value))
+      {
+         lo = std::min(lo, value);
+         hi = std::max(hi, value);
+      }
+   }
+}
+
+void quantize(const std::vector<float>& trace, float offset, float step, uint32_t maxCode,
+              std::vector<uint16_t>& codes)
+{
+   const float top = static_cast<float>(maxCode);
+   codes.resize(trace.size());
+   for (std::size_t i = 0; i < trace.size(); ++i)
+   {
+      const float value = trace[i];
+      // NaN and -inf go to the bottom, +inf to the top
+      const float code = std::isnan(value) ? 0.0F : std::clamp(std::round((value - offset) / step), 0.0F, top);
+      codes[i] = static_cast<uint16_t>(code);
+   }
+}
+
+// Serialize codes: bytes, or low-byte and high-byte planes.
+void pack(const std::vector<uint16_t>& codes, uint32_t bitsPerCode, std::string& out)
+{
+   const std::size_t n = codes.size();
+   out.resize((bitsPerCode == 16) ? 2 * n : n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      out[i] = static_cast<char>(codes[i] & 0xFFU);
+   }
+   if (bitsPerCode == 16)
+   {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         out[n + i] = static_cast<char>(codes[i] >> 8U);
+      }
+   }
+}
+
+void unpack(const std::string& in, uint32_t bitsPerCode, std::size_t n, std::vector<uint16_t>& codes)
+{
+   codes.resize(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const auto low = static_cast<uint8_t>(in[i]);
+      const auto high = (bitsPerCode == 16) ? static_cast<uint8_t>(in[n + i]) : uint8_t{0};
+      codes[i] = static_cast<uint16_t>(low | (high << 8U));
+   }
+}
+
+// Store `packed` in `out`, LZ4-compressed if asked.
+void store(const std::string& packed, bool lz4, std::string& out)
+{
+   if (!lz4 || packed.empty())
+   {
+      out.assign(packed);
+      return;
+   }
+   const int bound = LZ4_compressBound(static_cast<int>(packed.size()));
+   out.resize(static_cast<std::size_t>(bound));
+   const int written = LZ4_compress_default(packed.data(), out.data(), static_cast<int>(packed.size()), bound);
+   out.resize(static_cast<std::size_t>(std::max(written, 0)));
+}
+
+// Recover the packed codes of one trace; false if the payload is corrupt.
+bool load(const std::string& payload, bool lz4, std::size_t packedSize, std::string& packed)
+{
+   if (!lz4)
+   {
+      if (payload.size() != packedSize)
+      {
+         return false;
+      }
+      packed.assign(payload);
+      return true;
+   }
+   packed.resize(packedSize);
+   const int read = LZ4_decompress_safe(payload.data(), packed.data(), static_cast<int>(payload.size()),
+                                        static_cast<int>(packedSize));
+   return read >= 0 && static_cast<std::size_t>(read) == packedSize;
+}
+
+const std::string& tracePayload(const messages::SpectrumFrame& frame, std::size_t trace)
+{
+   switch (trace)
+   {
+      case 0:  return frame.magnitudes();
+      case 1:  return frame.max_hold();
+      default: return frame.min_hold();
+   }
+}
+
+std::string* mutableTracePayload(messages::SpectrumFrame& frame, std::size_t trace)
+{
+   switch (trace)
+   {
+      case 0:  return frame.mutable_magnitudes();
+      case 1:  return frame.mutable_max_hold();
+      default: return frame.mutable_min_hold();
+   }
+}
+
+} // namespace
+
+// ============================================================================
+// SpectrumFrameEncoder
+// ============================================================================
+
+SpectrumFrameEncoder::SpectrumFrameEncoder(const SpectrumCodecOptions& options)
+   : _options(options)
+   , _maxCode(maxCodeFor(options.bitsPerCode))
+{
+}
+
+void SpectrumFrameEncoder::encode(const SdrEngine::SpectrumData& spectrum, messages::SpectrumFrame& frame)
+{
+   const std::size_t bins = spectrum.magnitudesDb.size();
+   const std::size_t maxPoints = _options.maxPoints;
+   const std::size_t binsPerPoint = (maxPoints == 0 || bins <= maxPoints)
+                                       ? 1
+                                       : (bins + maxPoints - 1) / maxPoints;
+   decimate(spectrum.magnitudesDb, binsPerPoint, false, _decimated[0]);
+   decimate(spectrum.maxHoldDb, binsPerPoint, false, _decimated[1]);
+   decimate(spectrum.minHoldDb, binsPerPoint, true, _decimated[2]);
+
+   float offset = 0.0F;
+   float step = 0.0F;
+   const bool fixedRange = _options.rangeDb > 0.0F;
+   if (fixedRange)
+   {
+      offset = _options.referenceLevelDb - _options.rangeDb;
+      step   = _options.rangeDb / static_cast<float>(_maxCode);
+   }
+   else
+   {
+      float lo = std::numeric_limits<float>::max();
+      float hi = std::numeric_limits<float>::lowest();
+      for (const auto& trace : _decimated)
+      {
+         extendRange(trace, lo, hi);
+      }
+      if (lo > hi)
+      {
+         lo = hi = 0.0F;   // No finite value at all
+      }
+      offset = lo;
+      step   = std::max((hi - lo) / static_cast<float>(_maxCode), MIN_DB_STEP);
+   }
+   for (std::size_t t = 0; t < TRACES; ++t)
+   {
+      quantize(_decimated[t], offset, step, _maxCode, _codes[t]);
+   }
+
+   // Deltas need a fixed range and a receiver holding the same traces
+   bool delta = _options.delta && fixedRange && !_keyframeRequested &&
+                _framesSinceKeyframe + 1 < _options.keyframeInterval;
+   for (std::size_t t = 0; t < TRACES && delta; ++t)
+   {
+      delta = _codes[t].size() == _reference[t].size();
+   }
+   if (delta)
+   {
+      ++_framesSinceKeyframe;
+      const auto deadband = static_cast<int>(_options.deltaDeadbandCodes);
+      for (std::size_t t = 0; t < TRACES; ++t)
+      {
+         std::vector<uint16_t>& codes = _codes[t];
+         std::vector<uint16_t>& reference = _reference[t];
+         for (std::size_t i = 0; i < codes.size(); ++i)
+         {
+            const int change = static_cast<int>(codes[i]) - static_cast<int>(reference[i]);
+            if (std::abs(change) <= deadband)
+            {
+               codes[i] = 0;
+               continue;
+            }
+            reference[i] = codes[i];
+            codes[i] = static_cast<uint16_t>(static_cast<uint32_t>(change) & _maxCode);
+         }
+      }
+   }
+   else
+   {
+      _framesSinceKeyframe = 0;
+      _keyframeRequested = false;
+      _reference = _codes;
+   }
+
+   const auto& stages = spectrum.stages;
+   const auto timestamp = (stages.deviceRead != SdrEngine::StageTimestamps::TimePoint{})
+                             ? stages.deviceRead
+                             : std::chrono::steady_clock::now();
+   frame.set_timestamp_ns(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count());
+   frame.set_center_freq_hz(spectrum.centerFreqHz);
+   frame.set_bandwidth_hz(spectrum.bandwidthHz);
+   frame.set_fft_size(static_cast<uint32_t>(spectrum.fftSize));
+   frame.set_bins_per_point(static_cast<uint32_t>(binsPerPoint));
+   frame.set_db_offset(offset);
+   frame.set_db_step(step);
+   frame.set_bits_per_code(_options.bitsPerCode == 16 ? 16 : 8);
+   frame.set_delta(delta);
+   frame.set_lz4(_options.lz4);
+   frame.set_num_points(static_cast<uint32_t>(_codes[0].size()));
+   for (std::size_t t = 0; t < TRACES; ++t)
+   {
+      std::string* payload = mutableTracePayload(frame, t);
+      if (_codes[t].empty())
+      {
+         payload->clear();
+         continue;
+      }
+      pack(_codes[t], frame.bits_per_code(), _packed);
+      store(_packed, _options.lz4, *payload);
+   }
+}
+
+// ============================================================================
+// SpectrumFrameDecoder
+// ============================================================================
+
+bool SpectrumFrameDecoder::apply(const messages::SpectrumFrame& frame)
+{
+   const uint32_t bits = (frame.bits_per_code() == 0) ? 8 : frame.bits_per_code();
+   if (bits != 8 && bits != 16)
+   {
+      return false;
+   }
+   const std::size_t bytesPerCode = bits / 8;
+   std::size_t points = frame.num_points();
+   if (points == 0 && !frame.lz4())
+   {
+      points = frame.magnitudes().size() / bytesPerCode;
+   }
+
+   if (frame.delta())
+   {
+      const bool continues = _valid && frame.sequence() == _sequence + 1 && bits == _bitsPerCode &&
+                             _codes[0].size() == points;
+      if (!continues)
+      {
+         ++_discardedDeltas;
+         _valid = false;
+         return false;
+      }
+   }
+
+   const uint32_t mask = maxCodeFor(bits);
+   for (std::size_t t = 0; t < TRACES; ++t)
+   {
+      const std::string& payload = tracePayload(frame, t);
+      if (payload.empty())
+      {
+         _codes[t].clear();
+         continue;
+      }
+      if (!load(payload, frame.lz4(), points * bytesPerCode, _unpacked))
+      {
+         _valid = false;
+         return false;
+      }
+      if (!frame.delta())
+      {
+         unpack(_unpacked, bits, points, _codes[t]);
+         continue;
+      }
+      if (_codes[t].size() != points)
+      {
+         _valid = false;   // Trace appeared without a key frame
+         return false;
+      }
+      unpack(_unpacked, bits, points, _incoming);
+      for (std::size_t i = 0; i < points; ++i)
+      {
+         _codes[t][i] = static_cast<uint16_t>((static_cast<uint32_t>(_codes[t][i]) + _incoming[i]) & mask);
+      }
+   }
+
+   _valid       = true;
+   _sequence    = frame.sequence();
+   _bitsPerCode = bits;
+   return true;
+}
+
+bool SpectrumFrameDecoder::decode(const messages::SpectrumFrame& frame, SdrEngine::SpectrumData& spectrum)
+{
+   if (!apply(frame))
+   {
+      return false;
+   }
+   spectrum.centerFreqHz = frame.center_freq_hz();
+   spectrum.bandwidthHz  = frame.bandwidth_hz();
+   spectrum.fftSize      = frame.fft_size();
+   std::vector<float>* traces[TRACES] = {&spectrum.magnitudesDb, &spectrum.maxHoldDb, &spectrum.minHoldDb};
+   for (std::size_t t = 0; t < TRACES; ++t)
+   {
+      const std::vector<uint16_t>& codes = _codes[t];
+      std::vector<float>& trace = *traces[t];
+      trace.resize(codes.size());
+      for (std::size_t i = 0; i < codes.size(); ++i)
+      {
+         trace[i] = frame.db_offset() + static_cast<float>(codes[i]) * frame.db_step();
+      }
+   }
+   return true;
+}
+
+bool SpectrumFrameDecoder::decodeNormalized(const messages::SpectrumFrame& frame, float minDb, float maxDb,
+                                            std::vector<float>& normalised)
+{
+   if (!apply(frame) || maxDb <= minDb)
+   {
+      return false;
+   }
+   const float offset = (frame.db_offset() - minDb) / (maxDb - minDb);
+   const float step   = frame.db_step() / (maxDb - minDb);
+   const std::vector<uint16_t>& codes = _codes[0];
+   normalised.resize(codes.size());
+
+   if (_bitsPerCode == 16)
+   {
+      for (std::size_t i = 0; i < codes.size(); ++i)
+      {
+         normalised[i] = std::clamp(offset + static_cast<float>(codes[i]) * step, 0.0F, 1.0F);
+      }
+      return true;
+   }
+
+   const std::array<float, 4> key = {frame.db_offset(), frame.db_step(), minDb, maxDb};
+   if (_lut.empty() || key != _lutKey)
+   {
+      _lut.resize(MAX_CODE_8 + 1);
+      for (std::size_t code = 0; code < _lut.size(); ++code)
+      {
+         _lut[code] = std::clamp(offset + static_cast<float>(code) * step, 0.0F, 1.0F);
+      }
+      _lutKey = key;
+   }
+   for (std::size_t i = 0; i < codes.size(); ++i)
+   {
+      normalised[i] = _lut[codes[i]];
+   }
+   return true;
+}
+
+} // namespace SdrStreaming
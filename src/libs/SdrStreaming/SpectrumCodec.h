@@ -0,0 +1,159 @@
+#ifndef SPECTRUMCODEC_H_
+#define SPECTRUMCODEC_H_
+
+// Project headers
+#include "SdrTypes.h"
+#include "signal_data.pb.h"
+
+// System headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SdrStreaming
+{
+
+/// Smallest SpectrumFrame quantization step, in dB (flat spectra).
+constexpr float MIN_DB_STEP = 0.01F;
+
+/**
+ * @class SpectrumCodecOptions
+ * @brief How a SpectrumFrameEncoder trades spectrum fidelity for bandwidth.
+ *
+ * The defaults send full-resolution 8-bit frames quantized to each frame's
+ * own range.  For a bounded network cost set `maxPoints` to the display
+ * width and a fixed range: with 8-bit codes, `delta`, a deadband of one
+ * code and `lz4`, a slowly changing 65536-bin spectrum decimated to 4096
+ * points costs well under 1/16 of its float32 size.
+ */
+struct SpectrumCodecOptions
+{
+   std::size_t maxPoints{0};         ///< Peak-decimate wider spectra (0 = full resolution).
+   uint32_t bitsPerCode{8};          ///< 8 or 16.
+   float referenceLevelDb{0.0F};     ///< Top of the fixed range (codes saturate above).
+   float rangeDb{0.0F};              ///< Fixed range below the reference (0 = per-frame range).
+   bool delta{false};                ///< Send differences from the previous frame (fixed range only).
+   uint32_t keyframeInterval{30};    ///< Frames between key frames when `delta` (late joiners wait this long).
+   uint32_t deltaDeadbandCodes{0};   ///< Code changes this small are not sent.
+   bool lz4{false};                  ///< LZ4-compress the trace payloads.
+};
+
+/**
+ * @class SpectrumFrameEncoder
+ * @brief Encodes a stream of SpectrumData into SpectrumFrames.
+ *
+ * Spectra wider than `maxPoints` are peak-decimated first: each point is
+ * the maximum of `bins_per_point` adjacent bins (the minimum, for the
+ * min-hold trace), so narrow carriers survive the reduction.  The three
+ * traces then share one offset / step; -inf (empty bins) encodes as code 0.
+ *
+ * In delta mode the encoder tracks the codes the receiver holds, so the
+ * deadband error never accumulates: a point is resent once it drifts
+ * more than `deltaDeadbandCodes` from what the receiver shows.  Runs of
+ * unchanged points become runs of zero bytes, which LZ4 removes.
+ *
+ * Not thread-safe; use one encoder per stream.
+ */
+class SpectrumFrameEncoder
+{
+public:
+   /**
+    * @brief Construct an encoder.
+    * @param options  Quantization, delta and compression settings.
+    */
+   explicit SpectrumFrameEncoder(const SpectrumCodecOptions& options = {});
+
+   /**
+    * @brief Encode the next spectrum of the stream.
+    *
+    * Writes every field but `sequence`, which the caller must increment by
+    * one for every frame it sends (delta frames refer to sequence - 1).
+    * Payload strings are resized, not reallocated, so reusing one frame
+    * keeps its buffers.
+    *
+    * @param spectrum  Spectrum to encode.
+    * @param frame     Output frame.
+    */
+   void encode(const SdrEngine::SpectrumData& spectrum, messages::SpectrumFrame& frame);
+
+   /** @brief Make the next frame a key frame (e.g. after a frame was lost). */
+   void requestKeyframe() { _keyframeRequested = true; }
+
+   /** @brief Options given at construction. */
+   [[nodiscard]] const SpectrumCodecOptions& options() const { return _options; }
+
+private:
+   static constexpr std::size_t TRACES = 3;   // Magnitudes, max hold, min hold.
+
+   const SpectrumCodecOptions _options;
+   const uint32_t _maxCode;
+   bool _keyframeRequested{true};
+   uint32_t _framesSinceKeyframe{0};
+
+   std::array<std::vector<float>, TRACES> _decimated;
+   std::array<std::vector<uint16_t>, TRACES> _codes;
+   std::array<std::vector<uint16_t>, TRACES> _reference;   // What the receiver holds.
+   std::string _packed;
+};
+
+/**
+ * @class SpectrumFrameDecoder
+ * @brief Decodes a stream of SpectrumFrames, key and delta frames alike.
+ *
+ * decodeNormalized() feeds a display directly: it maps the magnitude
+ * codes to [0, 1] within the display's dB range through a lookup table,
+ * so nothing is converted to dB first.
+ *
+ * Not thread-safe; use one decoder per stream.
+ */
+class SpectrumFrameDecoder
+{
+public:
+   /**
+    * @brief Decode the next frame into dB traces.
+    * @param frame     Received frame.
+    * @param spectrum  Output; the traces, `centerFreqHz`, `bandwidthHz` and
+    *                  `fftSize` are set.  The traces have one value per point.
+    * @return false if the frame is malformed, or is a delta frame whose
+    *         predecessor was not decoded (wait for the next key frame).
+    */
+   bool decode(const messages::SpectrumFrame& frame, SdrEngine::SpectrumData& spectrum);
+
+   /**
+    * @brief Decode the next frame's magnitude trace into display units.
+    * @param frame      Received frame.
+    * @param minDb      Level shown as 0.
+    * @param maxDb      Level shown as 1 (greater than minDb).
+    * @param normalised Output; one value per point, clamped to [0, 1].
+    * @return false as for decode().
+    */
+   bool decodeNormalized(const messages::SpectrumFrame& frame, float minDb, float maxDb,
+                         std::vector<float>& normalised);
+
+   /** @brief Delta frames discarded because their predecessor was missing. */
+   [[nodiscard]] uint64_t discardedDeltas() const { return _discardedDeltas; }
+
+private:
+   static constexpr std::size_t TRACES = 3;
+
+   // Bring the held codes up to `frame`.
+   bool apply(const messages::SpectrumFrame& frame);
+
+   std::array<std::vector<uint16_t>, TRACES> _codes;
+   std::vector<uint16_t> _incoming;
+   std::string _unpacked;
+   bool _valid{false};
+   uint64_t _sequence{0};
+   uint32_t _bitsPerCode{0};
+   uint64_t _discardedDeltas{0};
+
+   // decodeNormalized() lookup table (8-bit codes) and the mapping it is for.
+   std::vector<float> _lut;
+   std::array<float, 4> _lutKey{};
+};
+
+} // namespace SdrStreaming
+
+#endif // SPECTRUMCODEC_H_
@@ -0,0 +1,103 @@
+#include "ContextCache.h"
+#include "ByteSwap.h"
+#include "PacketView.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace Vita49_2
+{
+
+namespace
+{
+
+constexpr uint32_t CIF0_CHANGE_INDICATOR = (1u << 31);
+constexpr size_t CIF0_BYTES = 4;
+
+uint32_t readCif0(const uint8_t* p, ByteOrder order)
+{
+   return (order == ByteOrder::BigEndian) ? readU32BE(p) : readU32LE(p);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+ContextCache::ContextCache(ChangeCallback onChange, bool trustChangeIndicator)
+   : _onChange(std::move(onChange))
+   , _trustChangeIndicator(trustChangeIndicator)
+{
+}
+
+// ============================================================================
+// update
+// ============================================================================
+
+ContextCache::Update ContextCache::update(const PacketView& packet)
+{
+   const auto streamId = packet.header().streamId;
+   const auto payload  = packet.payload();
+   if (!packet.isContext() || !streamId.has_value() || payload.size() < CIF0_BYTES)
+   {
+      return Update::Invalid;
+   }
+
+   const ByteOrder order = packet.byteOrder();
+   const uint32_t cif0   = readCif0(payload.data(), order);
+
+   auto entry = std::find_if(_entries.begin(), _entries.end(),
+                             [&](const Entry& e) { return e.streamId == *streamId; });
+   if (entry != _entries.end())
+   {
+      if (_trustChangeIndicator && (cif0 & CIF0_CHANGE_INDICATOR) == 0)
+      {
+         return Update::Unchanged;
+      }
+      const auto& cached = entry->payload;
+      if (cached.size() == payload.size() &&
+          readCif0(cached.data(), order) == (cif0 & ~CIF0_CHANGE_INDICATOR) &&
+          std::memcmp(cached.data() + CIF0_BYTES, payload.data() + CIF0_BYTES,
+                      payload.size() - CIF0_BYTES) == 0)
+      {
+         return Update::Unchanged;
+      }
+   }
+
+   auto fields = packet.contextFields();
+   if (!fields.has_value())
+   {
+      return Update::Invalid;
+   }
+   if (entry == _entries.end())
+   {
+      entry = _entries.insert(_entries.end(), Entry{*streamId, {}, {}});
+   }
+
+   // Keep the indicator out of the stored word so only field values compare
+   entry->payload.assign(payload.begin(), payload.end());
+   const size_t indicatorByte = (order == ByteOrder::BigEndian) ? 0 : CIF0_BYTES - 1;
+   entry->payload[indicatorByte] &= 0x7Fu;
+   entry->fields = std::move(*fields);
+
+   if (_onChange)
+   {
+      _onChange(*streamId, entry->fields);
+   }
+   return Update::Changed;
+}
+
+// ============================================================================
+// fields
+// ============================================================================
+
+const ContextFields* ContextCache::fields(uint32_t streamId) const
+{
+   const auto entry = std::find_if(_entries.begin(), _entries.end(),
+                                   [&](const Entry& e) { return e.streamId == streamId; });
+   return (entry != _entries.end()) ? &entry->fields : nullptr;
+}
+
+} // namespace Vita49_2
@@ -0,0 +1,94 @@
+#ifndef CONTEXTCACHE_H_
+#define CONTEXTCACHE_H_
+
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Vita49_2
+{
+
+class PacketView;
+
+/**
+ * @class ContextCache
+ * @brief Last context fields of each stream, updated only on real changes.
+ *
+ * A sender repeats its context packets (typically once per second or with
+ * every few data packets) although the values rarely change; decoding each
+ * one and re-applying its sample rate and frequency makes the receiver
+ * retune for nothing.  update() instead compares the packet's CIF payload
+ * (CIF0 word through the last field, without the header's count and
+ * timestamps) with the stream's previous one in a single memcmp, and only
+ * when it differs decodes the fields, stores them and calls the change
+ * callback.
+ *
+ * The Change Indicator (CIF0 bit 31) is excluded from the comparison, so a
+ * sender toggling it alone does not fire a change.  Senders do not all set
+ * it (this library's writers leave it clear), so by default the bytes
+ * decide; with @p trustChangeIndicator a clear indicator is taken at its
+ * word and the packet is reported unchanged without comparing.
+ *
+ * Thread-safety: none; one cache belongs to one receive loop.
+ */
+class ContextCache
+{
+public:
+   /// Called with the stream ID and its new fields on every change
+   using ChangeCallback = std::function<void(uint32_t streamId, const ContextFields& fields)>;
+
+   /** @brief Outcome of update() */
+   enum class Update : uint8_t
+   {
+      Changed,     ///< First packet of the stream or other field values
+      Unchanged,   ///< Same fields as the stream's previous packet
+      Invalid      ///< Not a context packet, or its fields do not decode
+   };
+
+   /**
+    * @param onChange Called on every change (may be empty)
+    * @param trustChangeIndicator Report packets with the Change Indicator
+    *        clear as unchanged without comparing them
+    */
+   explicit ContextCache(ChangeCallback onChange = {}, bool trustChangeIndicator = false);
+
+   /**
+    * @brief Compare a context packet with its stream's previous one.
+    *
+    * @param packet A context packet
+    * @return Whether its fields changed; the cache and callback are only
+    *         touched for Update::Changed
+    */
+   Update update(const PacketView& packet);
+
+   /**
+    * @brief Fields of the stream's last changed packet.
+    * @return The fields, or nullptr if the stream has not been seen
+    */
+   [[nodiscard]] const ContextFields* fields(uint32_t streamId) const;
+
+   /** @brief Number of streams with cached fields. */
+   [[nodiscard]] size_t streamCount() const { return _entries.size(); }
+
+   /** @brief Forget every stream; the next packet of each is a change. */
+   void clear() { _entries.clear(); }
+
+private:
+   struct Entry
+   {
+      uint32_t streamId;
+      std::vector<uint8_t> payload;   ///< CIF payload, Change Indicator cleared
+      ContextFields fields;
+   };
+
+   ChangeCallback _onChange;
+   bool _trustChangeIndicator;
+   std::vector<Entry> _entries;   ///< Few streams: a linear search wins
+};
+
+} // namespace Vita49_2
+
+#endif // CONTEXTCACHE_H_
@@ -85,6 +85,59 @@ uint32_t gainToFixed(double dB)
    return static_cast<uint32_t>(static_cast<uint16_t>(val));
 }
 
+// ============================================================================
+// Data Packet Payload Format (2 words)
+// ============================================================================
+//
+// Word 1: bit 31 packing method (1 = link-efficient), bits 30-29 real/complex
+// type (01 = complex cartesian), bits 28-24 data item format (00000 = signed
+// fixed point, 01110 = IEEE-754 single precision), bits 11-6 item packing
+// field size - 1, bits 5-0 data item size - 1.  Word 2 (repeat count and
+// vector size - 1) is 0: one sample per vector.
+
+constexpr uint32_t PAYLOAD_LINK_EFFICIENT    = (1u << 31);
+constexpr uint32_t PAYLOAD_COMPLEX_CARTESIAN = (1u << 29);
+constexpr uint32_t PAYLOAD_SIGNED_FIXED      = (0x00u << 24);
+constexpr uint32_t PAYLOAD_IEEE_SINGLE       = (0x0Eu << 24);
+
+/// Descriptor word 1 for a format with `bits`-bit items in `bits`-bit fields
+constexpr uint32_t payloadDescriptor(uint32_t flags, uint32_t bits)
+{
+   return PAYLOAD_COMPLEX_CARTESIAN | flags | ((bits - 1) << 6) | (bits - 1);
+}
+
+constexpr uint32_t PAYLOAD_INT16   = payloadDescriptor(PAYLOAD_SIGNED_FIXED, 16);
+constexpr uint32_t PAYLOAD_INT8    = payloadDescriptor(PAYLOAD_SIGNED_FIXED, 8);
+constexpr uint32_t PAYLOAD_INT12   = payloadDescriptor(PAYLOAD_LINK_EFFICIENT | PAYLOAD_SIGNED_FIXED, 12);
+constexpr uint32_t PAYLOAD_FLOAT32 = payloadDescriptor(PAYLOAD_IEEE_SINGLE, 32);
+
+/// Fields the formats are told apart by: packing, type, item format and sizes
+constexpr uint32_t PAYLOAD_DESCRIPTOR_MASK = 0xFF000FFFu;
+
+uint32_t payloadFormatToDescriptor(PayloadFormat format)
+{
+   switch (format)
+   {
+      case PayloadFormat::Int8:        return PAYLOAD_INT8;
+      case PayloadFormat::Int12Packed: return PAYLOAD_INT12;
+      case PayloadFormat::Float32:     return PAYLOAD_FLOAT32;
+      default:                         return PAYLOAD_INT16;
+   }
+}
+
+/// std::nullopt for descriptors of formats the codec does not handle
+std::optional<PayloadFormat> payloadFormatFromDescriptor(uint32_t word)
+{
+   switch (word & PAYLOAD_DESCRIPTOR_MASK)
+   {
+      case PAYLOAD_INT16:   return PayloadFormat::Int16;
+      case PAYLOAD_INT8:    return PayloadFormat::Int8;
+      case PAYLOAD_INT12:   return PayloadFormat::Int12Packed;
+      case PAYLOAD_FLOAT32: return PayloadFormat::Float32;
+      default:              return std::nullopt;
+   }
+}
+
 // ============================================================================
 // CIF0 bit positions
 // ============================================================================
@@ -100,6 +153,7 @@ constexpr uint32_t CIF0_REF_LEVEL       = (1u << 24);
 constexpr uint32_t CIF0_GAIN            = (1u << 23);
 constexpr uint32_t CIF0_OVER_RANGE      = (1u << 22);
 constexpr uint32_t CIF0_SAMPLE_RATE     = (1u << 21);
+constexpr uint32_t CIF0_PAYLOAD_FORMAT  = (1u << 15);
 
 /// Returns the size in 32-bit words of the data for a CIF0 bit position.
 /// Returns 0 for flag-only bits, -1 for unknown/variable-sized fields.
@@ -257,8 +311,11 @@ std::optional<ContextPacket::DecodeResult> ContextPacket::decode(
             fields.sampleRate = freqFromFixed(raw);
             break;
          }
+         case 15:
+            fields.payloadFormat = payloadFormatFromDescriptor(readWord(data + offset, order));
+            break;
          default:
-            // Skip unsupported field (bits 20-15)
+            // Skip unsupported field (bits 20-16)
             break;
       }
 
@@ -362,6 +419,13 @@ std::vector<uint8_t> ContextPacket::encode(
       appendDWord(fieldData, fixed, order);
    }
 
+   if (fields.payloadFormat.has_value())
+   {
+      cif0 |= CIF0_PAYLOAD_FORMAT;
+      appendWord(fieldData, payloadFormatToDescriptor(fields.payloadFormat.value()), order);
+      appendWord(fieldData, 0, order);
+   }
+
    // Build header
    PacketHeader header;
    header.packetType     = PacketType::IFContext;
@@ -22,7 +22,7 @@ namespace Vita49_2
  * a 32-bit bitmask where each bit indicates the presence of a
  * specific context field in the packet body.
  *
- * Supported CIF0 fields (bits 31-21):
+ * Supported CIF0 fields (bits 31-21, 15):
  *   Bit 31: Change Indicator (flag only, no data)
  *   Bit 30: Reference Point ID (1 word)
  *   Bit 29: Bandwidth (2 words, 64-bit fixed-point Hz)
@@ -34,8 +34,10 @@ namespace Vita49_2
  *   Bit 23: Gain/Attenuation (1 word, 16-bit fixed-point dB)
  *   Bit 22: Over-Range Count (1 word)
  *   Bit 21: Sample Rate (2 words, 64-bit fixed-point Hz)
+ *   Bit 15: Data Packet Payload Format (2 words; the PayloadFormats only,
+ *           others decode as absent)
  *
- * Fields at bits 20-8 are skipped during decode if present.
+ * Fields at bits 20-16 are skipped during decode if present.
  */
 class ContextPacket
 {
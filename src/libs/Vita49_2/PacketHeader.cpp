@@ -88,6 +88,7 @@ bool PacketHeaderCodec::parse(const uint8_t* data, size_t length,
       if (offset + 8 > packetBytes) return false;
       const uint32_t classWord1 = readWord(data + offset, order);
       const uint32_t classWord2 = readWord(data + offset + 4, order);
+      header.padBitCount            = static_cast<uint8_t>((classWord1 >> 27) & 0x1Fu);
       header.classIdOUI             = classWord1 & 0x00FFFFFFu;
       header.informationClassCode   = static_cast<uint16_t>((classWord2 >> 16) & 0xFFFFu);
       header.packetClassCode        = static_cast<uint16_t>(classWord2 & 0xFFFFu);
@@ -120,6 +121,13 @@ bool PacketHeaderCodec::parse(const uint8_t* data, size_t length,
 
 void PacketHeaderCodec::serialize(const PacketHeader& header, ByteOrder order,
                                   std::vector<uint8_t>& out)
+{
+   const size_t pos = out.size();
+   out.resize(pos + sizeInBytes(header));
+   out.resize(pos + serialize(header, order, out.data() + pos));
+}
+
+size_t PacketHeaderCodec::serialize(const PacketHeader& header, ByteOrder order, uint8_t* out)
 {
    // ---- Build Word 0 ----
    uint32_t word0 = 0;
@@ -136,48 +144,47 @@ void PacketHeaderCodec::serialize(const PacketHeader& header, ByteOrder order,
    word0 |= (static_cast<uint32_t>(header.packetCount) & 0xFu) << 16;
    word0 |= static_cast<uint32_t>(header.packetSize) & 0xFFFFu;
 
-   size_t pos = out.size();
-   out.resize(pos + 4);
-   writeWord(out.data() + pos, word0, order);
+   size_t pos = 0;
+   writeWord(out + pos, word0, order);
+   pos += 4;
 
    // ---- Stream ID ----
    if (hasStreamId(header.packetType) && header.streamId.has_value())
    {
-      pos = out.size();
-      out.resize(pos + 4);
-      writeWord(out.data() + pos, header.streamId.value(), order);
+      writeWord(out + pos, header.streamId.value(), order);
+      pos += 4;
    }
 
    // ---- Class ID (2 words) ----
    if (header.classIdPresent && header.classIdOUI.has_value())
    {
-      pos = out.size();
-      out.resize(pos + 8);
-      const uint32_t classWord1 = header.classIdOUI.value() & 0x00FFFFFFu;
+      const uint32_t classWord1 = ((static_cast<uint32_t>(header.padBitCount) & 0x1Fu) << 27) |
+                                  (header.classIdOUI.value() & 0x00FFFFFFu);
       uint32_t classWord2 = 0;
       if (header.informationClassCode.has_value())
          classWord2 |= static_cast<uint32_t>(header.informationClassCode.value()) << 16;
       if (header.packetClassCode.has_value())
          classWord2 |= static_cast<uint32_t>(header.packetClassCode.value());
-      writeWord(out.data() + pos, classWord1, order);
-      writeWord(out.data() + pos + 4, classWord2, order);
+      writeWord(out + pos, classWord1, order);
+      writeWord(out + pos + 4, classWord2, order);
+      pos += 8;
    }
 
    // ---- Integer Timestamp ----
    if (header.tsiType != TSI::None && header.integerTimestamp.has_value())
    {
-      pos = out.size();
-      out.resize(pos + 4);
-      writeWord(out.data() + pos, header.integerTimestamp.value(), order);
+      writeWord(out + pos, header.integerTimestamp.value(), order);
+      pos += 4;
    }
 
    // ---- Fractional Timestamp (64-bit) ----
    if (header.tsfType != TSF::None && header.fractionalTimestamp.has_value())
    {
-      pos = out.size();
-      out.resize(pos + 8);
-      writeDWord(out.data() + pos, header.fractionalTimestamp.value(), order);
+      writeDWord(out + pos, header.fractionalTimestamp.value(), order);
+      pos += 8;
    }
+
+   return pos;
 }
 
 // ============================================================================
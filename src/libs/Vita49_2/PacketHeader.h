@@ -46,6 +46,16 @@ public:
    static void serialize(const PacketHeader& header, ByteOrder order,
                          std::vector<uint8_t>& out);
 
+   /**
+    * @brief Serialize a VITA 49.2 packet header into a caller's buffer.
+    *
+    * @param header The header to serialize (packetSize must already be set)
+    * @param order Byte order for serialization
+    * @param out [out] Destination with room for sizeInBytes(header) bytes
+    * @return Number of bytes written
+    */
+   static size_t serialize(const PacketHeader& header, ByteOrder order, uint8_t* out);
+
    /**
     * @brief Calculate the header size in 32-bit words.
     *
@@ -0,0 +1,259 @@
+#include "PacketSequencer.h"
+#include "PacketView.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Vita49_2
+{
+
+namespace
+{
+
+// The 4-bit packetCount wraps after 16 packets
+constexpr uint8_t COUNT_MASK = 0x0F;
+constexpr size_t COUNT_RANGE = 16;
+
+uint8_t countOf(const PacketView& packet)
+{
+   return packet.header().packetCount & COUNT_MASK;
+}
+
+// Packets from `expected` to `count`, modulo the count range
+uint8_t distance(uint8_t expected, uint8_t count)
+{
+   return static_cast<uint8_t>((count - expected) & COUNT_MASK);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+PacketSequencer::PacketSequencer(PacketCallback onPacket, GapCallback onGap,
+                                 size_t reorderWindow)
+   : _onPacket(std::move(onPacket))
+   , _onGap(std::move(onGap))
+   , _window(std::min(reorderWindow, MAX_REORDER_WINDOW))
+{
+}
+
+// ============================================================================
+// push
+// ============================================================================
+
+void PacketSequencer::push(const PacketView& packet)
+{
+   if (!packet.isSignalData())
+   {
+      _onPacket(packet);
+      return;
+   }
+
+   Stream& stream = streamFor(packet.header().streamId);
+   if (!stream.started)
+   {
+      deliver(stream, packet);
+      return;
+   }
+
+   // Without a window only a repeat of the last packet is behind; with one,
+   // a packet given up on is up to two windows behind by the time it comes
+   const uint8_t count    = countOf(packet);
+   const uint8_t ahead    = distance(stream.expected, count);
+   const size_t lateRange = std::min((2 * _window) + 1, COUNT_RANGE / 2);
+   if (ahead >= COUNT_RANGE - lateRange)
+   {
+      ++_duplicates;
+      return;
+   }
+
+   if (ahead == 0)
+   {
+      if (!stream.held.empty())
+      {
+         ++_reordered;
+      }
+      deliver(stream, packet);
+      drain(stream);
+      return;
+   }
+   if (ahead > _window)
+   {
+      // No window could fill this hole; whatever is held goes first
+      flushStream(stream);
+      deliver(stream, packet);
+      return;
+   }
+   if (std::any_of(stream.held.begin(), stream.held.end(),
+                   [count](const Held& held) { return held.count == count; }))
+   {
+      ++_duplicates;
+      return;
+   }
+
+   std::vector<uint8_t> bytes;
+   if (!_spare.empty())
+   {
+      bytes = std::move(_spare.back());
+      _spare.pop_back();
+   }
+   bytes.assign(packet.bytes().begin(), packet.bytes().end());
+   stream.held.push_back({count, packet.byteOrder(), packet.payloadFormat(), std::move(bytes)});
+
+   while (stream.held.size() > _window)
+   {
+      skipToHeld(stream);
+   }
+}
+
+// ============================================================================
+// flush / reset
+// ============================================================================
+
+void PacketSequencer::flush()
+{
+   for (auto& stream : _streams)
+   {
+      flushStream(stream);
+   }
+}
+
+void PacketSequencer::reset()
+{
+   for (auto& stream : _streams)
+   {
+      for (auto& held : stream.held)
+      {
+         _spare.push_back(std::move(held.bytes));
+      }
+   }
+   _streams.clear();
+}
+
+// ============================================================================
+// Sequencing
+// ============================================================================
+
+PacketSequencer::Stream& PacketSequencer::streamFor(const std::optional<uint32_t>& streamId)
+{
+   const auto found = std::find_if(_streams.begin(), _streams.end(),
+                                   [&](const Stream& s) { return s.streamId == streamId; });
+   if (found != _streams.end())
+   {
+      return *found;
+   }
+   Stream& stream  = _streams.emplace_back();
+   stream.streamId = streamId;
+   stream.held.reserve(_window + 1);
+   return stream;
+}
+
+void PacketSequencer::deliver(Stream& stream, const PacketView& packet)
+{
+   const PacketHeader& header = packet.header();
+   const uint8_t count   = countOf(packet);
+   const size_t samples  = packet.sampleCount();
+   const bool sampleTime = header.tsfType == TSF::SampleCount &&
+                           header.fractionalTimestamp.has_value();
+
+   if (stream.started)
+   {
+      Gap gap;
+      gap.streamId = stream.streamId;
+      gap.packets  = distance(stream.expected, count);
+      gap.samples  = static_cast<uint64_t>(gap.packets) * stream.lastSamples;
+
+      // Sample-count timestamps within the same second give the exact gap,
+      // and see losses that wrapped the count
+      if (sampleTime && stream.nextTimestamp.has_value() &&
+          header.integerTimestamp == stream.timestampSecond)
+      {
+         const uint64_t timestamp = *header.fractionalTimestamp;
+         gap.samples = (timestamp > *stream.nextTimestamp) ? timestamp - *stream.nextTimestamp : 0;
+         if (stream.lastSamples > 0)
+         {
+            const auto fromSamples = static_cast<uint32_t>(
+               (gap.samples + stream.lastSamples - 1) / stream.lastSamples);
+            gap.packets = std::max(gap.packets, fromSamples);
+         }
+      }
+
+      if (gap.packets > 0 || gap.samples > 0)
+      {
+         _lostPackets += gap.packets;
+         _lostSamples += gap.samples;
+         if (_onGap)
+         {
+            _onGap(gap);
+         }
+      }
+   }
+
+   _onPacket(packet);
+   ++_delivered;
+
+   stream.started     = true;
+   stream.expected    = static_cast<uint8_t>((count + 1) & COUNT_MASK);
+   stream.lastSamples = samples;
+   if (sampleTime)
+   {
+      stream.nextTimestamp   = *header.fractionalTimestamp + samples;
+      stream.timestampSecond = header.integerTimestamp;
+   }
+   else
+   {
+      stream.nextTimestamp.reset();
+   }
+}
+
+void PacketSequencer::drain(Stream& stream)
+{
+   for (;;)
+   {
+      const auto next = std::find_if(stream.held.begin(), stream.held.end(),
+                                     [&](const Held& held) { return held.count == stream.expected; });
+      if (next == stream.held.end())
+      {
+         return;
+      }
+      deliverHeld(stream, static_cast<size_t>(next - stream.held.begin()));
+   }
+}
+
+void PacketSequencer::skipToHeld(Stream& stream)
+{
+   const auto nearest = std::min_element(stream.held.begin(), stream.held.end(),
+                                         [&](const Held& a, const Held& b)
+                                         {
+                                            return distance(stream.expected, a.count) <
+                                                   distance(stream.expected, b.count);
+                                         });
+   deliverHeld(stream, static_cast<size_t>(nearest - stream.held.begin()));
+   drain(stream);
+}
+
+void PacketSequencer::flushStream(Stream& stream)
+{
+   while (!stream.held.empty())
+   {
+      skipToHeld(stream);
+   }
+}
+
+void PacketSequencer::deliverHeld(Stream& stream, size_t index)
+{
+   Held held = std::move(stream.held[index]);
+   stream.held.erase(stream.held.begin() + static_cast<ptrdiff_t>(index));
+
+   // Parsed once already, so this cannot fail
+   const auto view = PacketView::parse(held.bytes, held.order, held.format);
+   if (view.has_value())
+   {
+      deliver(stream, *view);
+   }
+   _spare.push_back(std::move(held.bytes));
+}
+
+} // namespace Vita49_2
@@ -0,0 +1,151 @@
+#ifndef PACKETSEQUENCER_H_
+#define PACKETSEQUENCER_H_
+
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace Vita49_2
+{
+
+class PacketView;
+
+/**
+ * @class PacketSequencer
+ * @brief Puts each stream's signal data packets in order and reports losses.
+ *
+ * push() reads only the header: the 4-bit packetCount tells, per Stream ID,
+ * whether a packet is the next one, ahead of it (packets are missing or
+ * were reordered) or behind it (a duplicate, or too late to use).  Packets
+ * are passed on in sequence and every hole is reported as a Gap before the
+ * packet that follows it, in samples, so a receiver can zero-fill and keep
+ * its sample clock continuous.  The gap is exact when the packets carry
+ * sample-count fractional timestamps (which also catch losses of 16
+ * packets or more, invisible to the count); otherwise it is the number of
+ * missing packets times the previous packet's sample count.  Without such
+ * timestamps the count alone cannot tell a loss of 16 - L or more packets
+ * (L = 2N + 1 for a window of N, at most 8) from a late packet.
+ *
+ * With a reorder window of N, a packet ahead of the sequence is copied and
+ * held until the missing ones arrive or N packets are waiting, whichever
+ * comes first; only then is the hole declared lost.  A packet further
+ * ahead than the window is a loss at once.  Packets in sequence
+ * are passed on without a copy, so a window costs nothing while the
+ * network keeps order.  Packets other than signal data are passed on at
+ * once.  Packets without a Stream ID share one sequence.
+ *
+ * Thread-safety: none; one sequencer belongs to one receive loop.
+ */
+class PacketSequencer
+{
+public:
+   /** @brief Packets missing from a stream before the next delivered one. */
+   struct Gap
+   {
+      std::optional<uint32_t> streamId;
+      uint32_t packets{0};   ///< Missing packets
+      uint64_t samples{0};   ///< Missing samples, to zero-fill
+   };
+
+   /// Receives the packets in sequence; held ones point into the sequencer
+   /// and are only valid during the call
+   using PacketCallback = std::function<void(const PacketView&)>;
+   using GapCallback    = std::function<void(const Gap&)>;
+
+   /// Largest reorder window: further ahead than half the count range, a
+   /// packet cannot be told from a late one
+   static constexpr size_t MAX_REORDER_WINDOW = 7;
+
+   /**
+    * @brief Construct a sequencer.
+    *
+    * @param onPacket Called for every packet passed on
+    * @param onGap Called before a packet that follows lost ones (may be empty)
+    * @param reorderWindow Packets held while waiting for missing ones
+    *        (0 = report losses at once; capped at MAX_REORDER_WINDOW)
+    */
+   PacketSequencer(PacketCallback onPacket, GapCallback onGap, size_t reorderWindow = 0);
+
+   /** @brief Sequence one packet. */
+   void push(const PacketView& packet);
+
+   /** @brief Pass on every held packet, reporting the holes before them. */
+   void flush();
+
+   /** @brief Forget all streams and held packets; counters are kept. */
+   void reset();
+
+   [[nodiscard]] size_t reorderWindow() const { return _window; }
+
+   /** @brief Signal data packets passed on. */
+   [[nodiscard]] uint64_t delivered() const { return _delivered; }
+
+   /** @brief Packets reported lost in gaps. */
+   [[nodiscard]] uint64_t lostPackets() const { return _lostPackets; }
+
+   /** @brief Samples reported lost in gaps. */
+   [[nodiscard]] uint64_t lostSamples() const { return _lostSamples; }
+
+   /** @brief Packets dropped as duplicates or too late to reorder. */
+   [[nodiscard]] uint64_t duplicates() const { return _duplicates; }
+
+   /** @brief Packets that arrived late but within the window. */
+   [[nodiscard]] uint64_t reordered() const { return _reordered; }
+
+private:
+   struct Held
+   {
+      uint8_t count;
+      ByteOrder order;
+      PayloadFormat format;
+      std::vector<uint8_t> bytes;
+   };
+
+   struct Stream
+   {
+      std::optional<uint32_t> streamId;
+      bool started{false};
+      uint8_t expected{0};                       ///< packetCount of the next packet
+      size_t lastSamples{0};                     ///< Samples in the last packet
+      std::optional<uint64_t> nextTimestamp;     ///< Sample count expected next
+      std::optional<uint32_t> timestampSecond;   ///< Its integer timestamp
+      std::vector<Held> held;
+   };
+
+   Stream& streamFor(const std::optional<uint32_t>& streamId);
+
+   // Report the gap before `packet`, pass it on and advance the sequence
+   void deliver(Stream& stream, const PacketView& packet);
+
+   // Pass on held packets that are next in sequence
+   void drain(Stream& stream);
+
+   // Declare the hole before the nearest held packet lost and drain
+   void skipToHeld(Stream& stream);
+
+   // Pass on every held packet of the stream, gaps first
+   void flushStream(Stream& stream);
+
+   // Pass on held[index] and recycle its buffer
+   void deliverHeld(Stream& stream, size_t index);
+
+   PacketCallback _onPacket;
+   GapCallback _onGap;
+   size_t _window;
+   std::vector<Stream> _streams;                ///< Few streams: a linear search wins
+   std::vector<std::vector<uint8_t>> _spare;    ///< Buffers of released packets
+
+   uint64_t _delivered{0};
+   uint64_t _lostPackets{0};
+   uint64_t _lostSamples{0};
+   uint64_t _duplicates{0};
+   uint64_t _reordered{0};
+};
+
+} // namespace Vita49_2
+
+#endif // PACKETSEQUENCER_H_
@@ -0,0 +1,164 @@
+#include "PacketView.h"
+#include "ByteSwap.h"
+#include "ContextPacket.h"
+#include "PacketHeader.h"
+#include "SignalDataPacket.h"
+
+#include <algorithm>
+
+namespace Vita49_2
+{
+
+// ============================================================================
+// PacketView
+// ============================================================================
+
+PacketView::PacketView(std::span<const uint8_t> bytes, size_t headerBytes,
+                       ByteOrder order, PayloadFormat format, const PacketHeader& header)
+   : _bytes(bytes)
+   , _headerBytes(headerBytes)
+   , _order(order)
+   , _format(format)
+   , _header(header)
+{
+}
+
+std::optional<PacketView> PacketView::parse(std::span<const uint8_t> data, ByteOrder order,
+                                            PayloadFormat format)
+{
+   PacketHeader header;
+   size_t headerBytes = 0;
+   if (!PacketHeaderCodec::parse(data.data(), data.size(), order, header, headerBytes))
+   {
+      return std::nullopt;
+   }
+
+   const size_t packetBytes  = static_cast<size_t>(header.packetSize) * 4;
+   const size_t trailerBytes = header.trailerPresent ? 4 : 0;
+   if (headerBytes + trailerBytes > packetBytes)
+   {
+      return std::nullopt;
+   }
+
+   return PacketView(data.first(packetBytes), headerBytes, order, format, header);
+}
+
+std::span<const uint8_t> PacketView::payload() const
+{
+   const size_t trailerBytes = _header.trailerPresent ? 4 : 0;
+   return _bytes.subspan(_headerBytes, _bytes.size() - _headerBytes - trailerBytes);
+}
+
+std::optional<uint32_t> PacketView::trailer() const
+{
+   if (!_header.trailerPresent)
+   {
+      return std::nullopt;
+   }
+   const uint8_t* word = _bytes.data() + _bytes.size() - 4;
+   return (_order == ByteOrder::BigEndian) ? readU32BE(word) : readU32LE(word);
+}
+
+size_t PacketView::sampleCount() const
+{
+   if (!isSignalData())
+   {
+      return 0;
+   }
+   const size_t payloadBytes = payload().size();
+   const size_t padding      = std::min<size_t>(_header.padBitCount / 8, payloadBytes);
+   return (payloadBytes - padding) / bytesPerSample(_format);
+}
+
+size_t PacketView::decodeSamples(std::span<IQSample> out, float scaleFactor,
+                                 size_t firstSample) const
+{
+   const size_t available = sampleCount();
+   if (scaleFactor == 0.0f || firstSample >= available)
+   {
+      return 0;
+   }
+
+   const size_t count = std::min(out.size(), available - firstSample);
+   SignalDataPacket::decodeSamples(payload().data() + (firstSample * bytesPerSample(_format)),
+                                   count, _order, scaleFactor, out.data(), _format);
+   return count;
+}
+
+std::optional<ContextFields> PacketView::contextFields() const
+{
+   if (!isContext())
+   {
+      return std::nullopt;
+   }
+
+   size_t consumed = 0;
+   auto decoded = ContextPacket::decode(_bytes.data(), _bytes.size(), _order, consumed);
+   if (!decoded.has_value())
+   {
+      return std::nullopt;
+   }
+   return decoded->fields;
+}
+
+// ============================================================================
+// PacketStreamView
+// ============================================================================
+
+PacketStreamView::PacketStreamView(std::span<const uint8_t> data, ByteOrder order,
+                                   PayloadFormat format)
+   : _data(data)
+   , _order(order)
+   , _format(format)
+{
+}
+
+size_t PacketStreamView::bytesParsed() const
+{
+   size_t end = 0;
+   for (auto it = begin(); it != this->end(); ++it)
+   {
+      end = it.offset() + it->bytes().size();
+   }
+   return end;
+}
+
+PacketStreamView::Iterator::Iterator(std::span<const uint8_t> data, ByteOrder order,
+                                     PayloadFormat format)
+   : _data(data)
+   , _order(order)
+   , _format(format)
+{
+   parseCurrent();
+}
+
+PacketStreamView::Iterator& PacketStreamView::Iterator::operator++()
+{
+   _offset += _current->bytes().size();
+   parseCurrent();
+   return *this;
+}
+
+void PacketStreamView::Iterator::parseCurrent()
+{
+   _current.reset();
+   if (_offset >= _data.size())
+   {
+      return;
+   }
+
+   const auto rest = _data.subspan(_offset);
+   if (_decoder.has_value() && _decoder->matches(rest.data(), rest.size()))
+   {
+      _current = _decoder->view(rest, _format);
+      return;
+   }
+
+   _current = PacketView::parse(rest, _order, _format);
+   if (_current.has_value() && _current->isSignalData())
+   {
+      _decoder = SignalDataDecoder::select(rest.data(), rest.size(), _order);
+   }
+}
+
+} // namespace Vita49_2
@@ -0,0 +1,182 @@
+#ifndef PACKETVIEW_H_
+#define PACKETVIEW_H_
+
+#include "SignalDataDecoder.h"
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+
+namespace Vita49_2
+{
+
+/**
+ * @class PacketView
+ * @brief Non-owning view of one VITA 49.2 packet in a caller's buffer.
+ *
+ * parse() decodes only the header; the payload stays where it is and is
+ * exposed as a span.  Samples are converted on request, into a buffer the
+ * caller provides, so indexing, stream-ID filtering and timestamp searches
+ * never allocate.  The view is valid as long as the underlying buffer.
+ *
+ * The payload format is not in the data packet itself but announced by
+ * the stream's context packets, so the caller supplies it (default Int16).
+ */
+class PacketView
+{
+public:
+   /**
+    * @brief Parse the header of the packet at the start of a buffer.
+    *
+    * @param data Buffer starting at a packet; may hold further packets
+    * @param order Byte order of the packet
+    * @param format Sample format of a data packet's payload
+    * @return View of the packet, or std::nullopt if the header is invalid,
+    *         the packet is truncated, or a data packet's header and trailer
+    *         do not fit its size
+    */
+   [[nodiscard]] static std::optional<PacketView> parse(
+      std::span<const uint8_t> data, ByteOrder order = ByteOrder::BigEndian,
+      PayloadFormat format = PayloadFormat::Int16);
+
+   [[nodiscard]] const PacketHeader& header() const { return _header; }
+   [[nodiscard]] ByteOrder byteOrder() const { return _order; }
+
+   /** @brief Sample format sampleCount() and decodeSamples() assume. */
+   [[nodiscard]] PayloadFormat payloadFormat() const { return _format; }
+
+   /** @brief Set the sample format, e.g. once the stream's context is known. */
+   void setPayloadFormat(PayloadFormat format) { _format = format; }
+
+   [[nodiscard]] bool isSignalData() const { return isDataPacket(_header.packetType); }
+   [[nodiscard]] bool isContext() const { return isContextPacket(_header.packetType); }
+
+   /** @brief The whole packet, header to trailer. */
+   [[nodiscard]] std::span<const uint8_t> bytes() const { return _bytes; }
+
+   /** @brief The packet body between header and trailer. */
+   [[nodiscard]] std::span<const uint8_t> payload() const;
+
+   /** @brief The trailer word of data packets that carry one. */
+   [[nodiscard]] std::optional<uint32_t> trailer() const;
+
+   /** @brief Number of I/Q pairs in a signal data packet (0 otherwise). */
+   [[nodiscard]] size_t sampleCount() const;
+
+   /**
+    * @brief Convert samples of a signal data packet into a caller's buffer.
+    *
+    * @param out Destination; up to out.size() samples are written
+    * @param scaleFactor Division factor for int16-to-float conversion
+    * @param firstSample Index of the first sample to convert, so a large
+    *        packet can be decoded in pieces
+    * @return Number of samples written (0 for non-data packets)
+    */
+   size_t decodeSamples(std::span<IQSample> out,
+                        float scaleFactor = DEFAULT_SCALE_FACTOR,
+                        size_t firstSample = 0) const;
+
+   /**
+    * @brief Decode the fields of a context packet.
+    * @return The fields, or std::nullopt if this is not a valid context packet
+    */
+   [[nodiscard]] std::optional<ContextFields> contextFields() const;
+
+private:
+   friend class SignalDataDecoder;
+
+   PacketView(std::span<const uint8_t> bytes, size_t headerBytes,
+              ByteOrder order, PayloadFormat format, const PacketHeader& header);
+
+   std::span<const uint8_t> _bytes;
+   size_t _headerBytes;
+   ByteOrder _order;
+   PayloadFormat _format;
+   PacketHeader _header;
+};
+
+/**
+ * @class PacketStreamView
+ * @brief Range of PacketViews over a buffer of concatenated packets.
+ *
+ * Iteration parses one header per step and stops at the end of the buffer
+ * or at the first packet that does not parse, as Vita49Codec::parseStream()
+ * does.  bytesParsed() tells how far a finished iteration got.  Data packets
+ * with the layout of the last one are parsed by its SignalDataDecoder.
+ *
+ * @code
+ * for (const PacketView& packet : PacketStreamView(buffer))
+ * {
+ *    if (packet.isSignalData() && packet.header().streamId == wanted) { ... }
+ * }
+ * @endcode
+ */
+class PacketStreamView
+{
+public:
+   /**
+    * @class Iterator
+    * @brief Input iterator yielding one PacketView per packet.
+    */
+   class Iterator
+   {
+   public:
+      using value_type      = PacketView;
+      using difference_type = std::ptrdiff_t;
+
+      Iterator() = default;
+
+      const PacketView& operator*() const { return *_current; }
+      const PacketView* operator->() const { return &*_current; }
+
+      Iterator& operator++();
+      void operator++(int) { ++*this; }
+
+      /** @brief Byte offset of the current packet from the start of the stream. */
+      [[nodiscard]] size_t offset() const { return _offset; }
+
+      bool operator==(std::default_sentinel_t) const { return !_current.has_value(); }
+
+   private:
+      friend class PacketStreamView;
+      Iterator(std::span<const uint8_t> data, ByteOrder order, PayloadFormat format);
+      void parseCurrent();
+
+      std::span<const uint8_t> _data;
+      ByteOrder _order{ByteOrder::BigEndian};
+      PayloadFormat _format{PayloadFormat::Int16};
+      size_t _offset{0};
+      std::optional<PacketView> _current;
+      std::optional<SignalDataDecoder> _decoder;   // Layout of the last data packet
+   };
+
+   /**
+    * @param data Buffer of concatenated packets; must outlive the views
+    * @param order Byte order of the packets
+    * @param format Sample format the data packet views start with
+    */
+   explicit PacketStreamView(std::span<const uint8_t> data,
+                             ByteOrder order = ByteOrder::BigEndian,
+                             PayloadFormat format = PayloadFormat::Int16);
+
+   [[nodiscard]] Iterator begin() const { return Iterator(_data, _order, _format); }
+   [[nodiscard]] std::default_sentinel_t end() const { return {}; }
+
+   /**
+    * @brief Bytes covered by the packets that parse, from the start.
+    * @return Equal to the buffer size for a well-formed stream
+    */
+   [[nodiscard]] size_t bytesParsed() const;
+
+private:
+   std::span<const uint8_t> _data;
+   ByteOrder _order;
+   PayloadFormat _format;
+};
+
+} // namespace Vita49_2
+
+#endif // PACKETVIEW_H_
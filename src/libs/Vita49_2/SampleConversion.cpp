@@ -0,0 +1,921 @@
+#include "SampleConversion.h"
+#include "ByteSwap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VITA49_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define VITA49_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Vita49_2
+{
+
+namespace
+{
+
+constexpr float INT16_MIN_F = -32768.0f;
+constexpr float INT16_MAX_F = 32767.0f;
+constexpr float INT8_MIN_F  = -128.0f;
+constexpr float INT8_MAX_F  = 127.0f;
+constexpr float INT12_MIN_F = -2048.0f;
+constexpr float INT12_MAX_F = 2047.0f;
+
+#if defined(VITA49_KERNELS_X86) || defined(VITA49_KERNELS_NEON)
+
+// Byte shuffles (pshufb / tbl) between four packed 12-bit pairs and eight
+// 16-bit lanes.  Unpacking puts I in the top 12 bits of the even lanes and
+// Q in the bottom 12 bits of the odd ones; packing takes the three low
+// bytes of each 32-bit `I << 12 | Q`.  0x80 selects a zero byte.
+constexpr uint8_t INT12_UNPACK_BE[16] = {1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10};
+constexpr uint8_t INT12_UNPACK_LE[16] = {1, 2, 0, 1, 4, 5, 3, 4, 7, 8, 6, 7, 10, 11, 9, 10};
+constexpr uint8_t INT12_PACK_BE[16] = {2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                       0x80, 0x80, 0x80, 0x80};
+constexpr uint8_t INT12_PACK_LE[16] = {0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                       0x80, 0x80, 0x80, 0x80};
+
+// Lane multipliers moving Q up to the top of the odd lanes, like I
+constexpr int16_t INT12_ALIGN[8] = {1, 16, 1, 16, 1, 16, 1, 16};
+
+#endif
+
+// ============================================================================
+// Scalar implementations (reference; also handle the vector loops' tails)
+// ============================================================================
+
+void int16ToFloatScalar(const uint8_t* src, float* dst, size_t count,
+                        ByteOrder order, float invScale)
+{
+   for (size_t i = 0; i < count; ++i)
+   {
+      const int16_t value = (order == ByteOrder::BigEndian) ? readI16BE(src + (2 * i))
+                                                            : readI16LE(src + (2 * i));
+      dst[i] = static_cast<float>(value) * invScale;
+   }
+}
+
+// Scale, zero NaN, clamp to [lo, hi] and round half away from zero.
+int32_t roundClamped(float value, float scale, float lo, float hi)
+{
+   // Clamp before rounding so out-of-range input never overflows lroundf
+   const float scaled = value * scale;
+   return static_cast<int32_t>(std::lroundf(std::isnan(scaled) ? 0.0f
+                                                               : std::clamp(scaled, lo, hi)));
+}
+
+void floatToInt16Scalar(const float* src, uint8_t* dst, size_t count,
+                        ByteOrder order, float scale)
+{
+   for (size_t i = 0; i < count; ++i)
+   {
+      const auto rounded = static_cast<int16_t>(roundClamped(src[i], scale, INT16_MIN_F, INT16_MAX_F));
+
+      if (order == ByteOrder::BigEndian)
+         writeI16BE(dst + (2 * i), rounded);
+      else
+         writeI16LE(dst + (2 * i), rounded);
+   }
+}
+
+void int8ToFloatScalar(const uint8_t* src, float* dst, size_t count, float invScale)
+{
+   for (size_t i = 0; i < count; ++i)
+   {
+      dst[i] = static_cast<float>(static_cast<int8_t>(src[i])) * invScale;
+   }
+}
+
+void floatToInt8Scalar(const float* src, uint8_t* dst, size_t count, float scale)
+{
+   for (size_t i = 0; i < count; ++i)
+   {
+      dst[i] = static_cast<uint8_t>(roundClamped(src[i], scale, INT8_MIN_F, INT8_MAX_F));
+   }
+}
+
+void int12ToFloatScalar(const uint8_t* src, float* dst, size_t count,
+                        ByteOrder order, float invScale)
+{
+   for (size_t i = 0; i + 2 <= count; i += 2)
+   {
+      const uint8_t* p = src + (3 * i / 2);
+      const uint32_t pair = (order == ByteOrder::BigEndian)
+         ? (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2]
+         : (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[0];
+      // Sign-extend each half from the top of a 32-bit value
+      dst[i]     = static_cast<float>(static_cast<int32_t>(pair << 8) >> 20) * invScale;
+      dst[i + 1] = static_cast<float>(static_cast<int32_t>(pair << 20) >> 20) * invScale;
+   }
+}
+
+void floatToInt12Scalar(const float* src, uint8_t* dst, size_t count,
+                        ByteOrder order, float scale)
+{
+   for (size_t i = 0; i + 2 <= count; i += 2)
+   {
+      const auto iValue = static_cast<uint32_t>(roundClamped(src[i], scale, INT12_MIN_F, INT12_MAX_F));
+      const auto qValue = static_cast<uint32_t>(roundClamped(src[i + 1], scale, INT12_MIN_F, INT12_MAX_F));
+      const uint32_t pair = ((iValue & 0xFFFu) << 12) | (qValue & 0xFFFu);
+
+      uint8_t* p = dst + (3 * i / 2);
+      const bool big = (order == ByteOrder::BigEndian);
+      p[big ? 0 : 2] = static_cast<uint8_t>(pair >> 16);
+      p[1]           = static_cast<uint8_t>(pair >> 8);
+      p[big ? 2 : 0] = static_cast<uint8_t>(pair);
+   }
+}
+
+void float32ToFloatScalar(const uint8_t* src, float* dst, size_t count, ByteOrder order)
+{
+   for (size_t i = 0; i < count; ++i)
+   {
+      const uint32_t bits = (order == ByteOrder::BigEndian) ? readU32BE(src + (4 * i))
+                                                            : readU32LE(src + (4 * i));
+      dst[i] = std::bit_cast<float>(bits);
+   }
+}
+
+void floatToFloat32Scalar(const float* src, uint8_t* dst, size_t count, ByteOrder order)
+{
+   for (size_t i = 0; i < count; ++i)
+   {
+      const auto bits = std::bit_cast<uint32_t>(src[i]);
+      if (order == ByteOrder::BigEndian)
+         writeU32BE(dst + (4 * i), bits);
+      else
+         writeU32LE(dst + (4 * i), bits);
+   }
+}
+
+// ============================================================================
+// x86-64 implementations (AVX2 or SSSE3, chosen at run time)
+// ============================================================================
+
+#if defined(VITA49_KERNELS_X86)
+
+bool cpuHasAvx2()
+{
+   static const bool HAS_AVX2 = __builtin_cpu_supports("avx2") != 0;
+   return HAS_AVX2;
+}
+
+bool cpuHasSsse3()
+{
+   static const bool HAS_SSSE3 = __builtin_cpu_supports("ssse3") != 0;
+   return HAS_SSSE3;
+}
+
+// pshufb control swapping the two bytes of every 16-bit lane.
+__attribute__((target("ssse3"))) __m128i swap16Mask()
+{
+   return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+}
+
+// Round half away from zero, as lroundf(): truncate, then step by one where
+// the (exact) remainder is at least one half.  `v` is already clamped to
+// the int16 range, so the result is too.
+__attribute__((target("ssse3"))) __m128i roundAwaySsse3(__m128 v)
+{
+   const __m128i truncated = _mm_cvttps_epi32(v);
+   const __m128 remainder = _mm_sub_ps(v, _mm_cvtepi32_ps(truncated));
+   const __m128i up   = _mm_castps_si128(_mm_cmpge_ps(remainder, _mm_set1_ps(0.5f)));
+   const __m128i down = _mm_castps_si128(_mm_cmple_ps(remainder, _mm_set1_ps(-0.5f)));
+   return _mm_add_epi32(_mm_sub_epi32(truncated, up), down);
+}
+
+// pshufb control reversing the four bytes of every 32-bit lane.
+__attribute__((target("ssse3"))) __m128i swap32Mask()
+{
+   return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+}
+
+__attribute__((target("ssse3"))) __m128i loadMask(const uint8_t* mask)
+{
+   return _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+// Scale, zero NaNs and clamp 4 floats to [lo, hi].
+__attribute__((target("ssse3")))
+__m128 scaleAndClampSsse3(const float* src, __m128 scale, float lo, float hi)
+{
+   const __m128 v = _mm_mul_ps(_mm_loadu_ps(src), scale);
+   const __m128 notNan = _mm_and_ps(v, _mm_cmpord_ps(v, v));
+   return _mm_min_ps(_mm_max_ps(notNan, _mm_set1_ps(lo)), _mm_set1_ps(hi));
+}
+
+// Convert 8 int16 lanes to float and store them.
+__attribute__((target("ssse3"))) void storeInt16AsFloatSsse3(__m128i v, float* dst, __m128 scale)
+{
+   // Sign-extend by placing each value in the top half of a 32-bit lane
+   const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+   const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+   _mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+   _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+}
+
+// 12 bytes (four packed 12-bit pairs) into the low bytes of a register.
+__attribute__((target("ssse3"))) __m128i load12Ssse3(const uint8_t* src)
+{
+   int32_t tail = 0;
+   std::memcpy(&tail, src + 8, sizeof(tail));
+   return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)),
+                             _mm_cvtsi32_si128(tail));
+}
+
+__attribute__((target("ssse3"))) void store12Ssse3(uint8_t* dst, __m128i bytes)
+{
+   _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), bytes);
+   const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+   std::memcpy(dst + 8, &tail, sizeof(tail));
+}
+
+// Eight 16-bit lanes of I/Q pairs (Q in the top half of each 32-bit lane)
+// as 32-bit `I << 12 | Q`, 12 bits each.
+__attribute__((target("ssse3"))) __m128i packInt12Ssse3(__m128i pairs)
+{
+   return _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pairs, 12), _mm_set1_epi32(0xFFF000)),
+                       _mm_and_si128(_mm_srli_epi32(pairs, 16), _mm_set1_epi32(0xFFF)));
+}
+
+__attribute__((target("ssse3")))
+void int16ToFloatSsse3(const uint8_t* src, float* dst, size_t count, ByteOrder order, float invScale)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m128i mask = swap16Mask();
+   const __m128 s = _mm_set1_ps(invScale);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (2 * i)));
+      if (swap)
+      {
+         raw = _mm_shuffle_epi8(raw, mask);
+      }
+      storeInt16AsFloatSsse3(raw, dst + i, s);
+   }
+   int16ToFloatScalar(src + (2 * i), dst + i, count - i, order, invScale);
+}
+
+__attribute__((target("ssse3")))
+void floatToInt16Ssse3(const float* src, uint8_t* dst, size_t count, ByteOrder order, float scale)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m128i mask = swap16Mask();
+   const __m128 s = _mm_set1_ps(scale);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const __m128i lo = roundAwaySsse3(scaleAndClampSsse3(src + i, s, INT16_MIN_F, INT16_MAX_F));
+      const __m128i hi = roundAwaySsse3(scaleAndClampSsse3(src + i + 4, s, INT16_MIN_F, INT16_MAX_F));
+      __m128i packed = _mm_packs_epi32(lo, hi);
+      if (swap)
+      {
+         packed = _mm_shuffle_epi8(packed, mask);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (2 * i)), packed);
+   }
+   floatToInt16Scalar(src + i, dst + (2 * i), count - i, order, scale);
+}
+
+__attribute__((target("ssse3")))
+void int8ToFloatSsse3(const uint8_t* src, float* dst, size_t count, float invScale)
+{
+   const __m128 s = _mm_set1_ps(invScale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      // Sign-extend by placing each byte in the top half of a 16-bit lane
+      storeInt16AsFloatSsse3(_mm_srai_epi16(_mm_unpacklo_epi8(raw, raw), 8), dst + i, s);
+      storeInt16AsFloatSsse3(_mm_srai_epi16(_mm_unpackhi_epi8(raw, raw), 8), dst + i + 8, s);
+   }
+   int8ToFloatScalar(src + i, dst + i, count - i, invScale);
+}
+
+__attribute__((target("ssse3")))
+void floatToInt8Ssse3(const float* src, uint8_t* dst, size_t count, float scale)
+{
+   const __m128 s = _mm_set1_ps(scale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      __m128i quarters[4];
+      for (size_t q = 0; q < 4; ++q)
+      {
+         quarters[q] = roundAwaySsse3(scaleAndClampSsse3(src + i + (4 * q), s, INT8_MIN_F, INT8_MAX_F));
+      }
+      const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(quarters[0], quarters[1]),
+                                             _mm_packs_epi32(quarters[2], quarters[3]));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+   }
+   floatToInt8Scalar(src + i, dst + i, count - i, scale);
+}
+
+__attribute__((target("ssse3")))
+void int12ToFloatSsse3(const uint8_t* src, float* dst, size_t count, ByteOrder order, float invScale)
+{
+   const __m128i mask = loadMask(order == ByteOrder::BigEndian ? INT12_UNPACK_BE : INT12_UNPACK_LE);
+   const __m128i align = _mm_loadu_si128(reinterpret_cast<const __m128i*>(INT12_ALIGN));
+   const __m128 s = _mm_set1_ps(invScale);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const __m128i lanes = _mm_shuffle_epi8(load12Ssse3(src + (3 * i / 2)), mask);
+      // Both halves now end at bit 15: the arithmetic shift sign-extends them
+      storeInt16AsFloatSsse3(_mm_srai_epi16(_mm_mullo_epi16(lanes, align), 4), dst + i, s);
+   }
+   int12ToFloatScalar(src + (3 * i / 2), dst + i, count - i, order, invScale);
+}
+
+__attribute__((target("ssse3")))
+void floatToInt12Ssse3(const float* src, uint8_t* dst, size_t count, ByteOrder order, float scale)
+{
+   const __m128i mask = loadMask(order == ByteOrder::BigEndian ? INT12_PACK_BE : INT12_PACK_LE);
+   const __m128 s = _mm_set1_ps(scale);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const __m128i lo = roundAwaySsse3(scaleAndClampSsse3(src + i, s, INT12_MIN_F, INT12_MAX_F));
+      const __m128i hi = roundAwaySsse3(scaleAndClampSsse3(src + i + 4, s, INT12_MIN_F, INT12_MAX_F));
+      const __m128i pairs = packInt12Ssse3(_mm_packs_epi32(lo, hi));
+      store12Ssse3(dst + (3 * i / 2), _mm_shuffle_epi8(pairs, mask));
+   }
+   floatToInt12Scalar(src + i, dst + (3 * i / 2), count - i, order, scale);
+}
+
+__attribute__((target("ssse3")))
+void float32ToFloatSsse3(const uint8_t* src, float* dst, size_t count, ByteOrder order)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m128i mask = swap32Mask();
+   size_t i = 0;
+   for (; i + 4 <= count; i += 4)
+   {
+      __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (4 * i)));
+      if (swap)
+      {
+         raw = _mm_shuffle_epi8(raw, mask);
+      }
+      _mm_storeu_ps(dst + i, _mm_castsi128_ps(raw));
+   }
+   float32ToFloatScalar(src + (4 * i), dst + i, count - i, order);
+}
+
+__attribute__((target("ssse3")))
+void floatToFloat32Ssse3(const float* src, uint8_t* dst, size_t count, ByteOrder order)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m128i mask = swap32Mask();
+   size_t i = 0;
+   for (; i + 4 <= count; i += 4)
+   {
+      __m128i raw = _mm_castps_si128(_mm_loadu_ps(src + i));
+      if (swap)
+      {
+         raw = _mm_shuffle_epi8(raw, mask);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (4 * i)), raw);
+   }
+   floatToFloat32Scalar(src + i, dst + (4 * i), count - i, order);
+}
+
+__attribute__((target("avx2"))) __m256i roundAwayAvx2(__m256 v)
+{
+   const __m256i truncated = _mm256_cvttps_epi32(v);
+   const __m256 remainder = _mm256_sub_ps(v, _mm256_cvtepi32_ps(truncated));
+   const __m256i up   = _mm256_castps_si256(_mm256_cmp_ps(remainder, _mm256_set1_ps(0.5f), _CMP_GE_OQ));
+   const __m256i down = _mm256_castps_si256(_mm256_cmp_ps(remainder, _mm256_set1_ps(-0.5f), _CMP_LE_OQ));
+   return _mm256_add_epi32(_mm256_sub_epi32(truncated, up), down);
+}
+
+__attribute__((target("avx2")))
+__m256 scaleAndClampAvx2(const float* src, __m256 scale, float lo, float hi)
+{
+   const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src), scale);
+   const __m256 notNan = _mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_ORD_Q));
+   return _mm256_min_ps(_mm256_max_ps(notNan, _mm256_set1_ps(lo)), _mm256_set1_ps(hi));
+}
+
+// Round, clamp and pack 16 floats to 16-bit lanes in order.
+__attribute__((target("avx2")))
+__m256i roundToInt16Avx2(const float* src, __m256 scale, float lo, float hi)
+{
+   const __m256i first  = roundAwayAvx2(scaleAndClampAvx2(src, scale, lo, hi));
+   const __m256i second = roundAwayAvx2(scaleAndClampAvx2(src + 8, scale, lo, hi));
+   // packs works per 128-bit lane: restore the order of the four quarters
+   return _mm256_permute4x64_epi64(_mm256_packs_epi32(first, second), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+__attribute__((target("avx2")))
+void int16ToFloatAvx2(const uint8_t* src, float* dst, size_t count, ByteOrder order, float invScale)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m128i mask = swap16Mask();
+   const __m256 s = _mm256_set1_ps(invScale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (2 * i)));
+      __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (2 * i) + 16));
+      if (swap)
+      {
+         lo = _mm_shuffle_epi8(lo, mask);
+         hi = _mm_shuffle_epi8(hi, mask);
+      }
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo)), s));
+      _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi)), s));
+   }
+   int16ToFloatScalar(src + (2 * i), dst + i, count - i, order, invScale);
+}
+
+__attribute__((target("avx2")))
+void floatToInt16Avx2(const float* src, uint8_t* dst, size_t count, ByteOrder order, float scale)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m256i mask = _mm256_broadcastsi128_si256(swap16Mask());
+   const __m256 s = _mm256_set1_ps(scale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      __m256i packed = roundToInt16Avx2(src + i, s, INT16_MIN_F, INT16_MAX_F);
+      if (swap)
+      {
+         packed = _mm256_shuffle_epi8(packed, mask);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (2 * i)), packed);
+   }
+   floatToInt16Scalar(src + i, dst + (2 * i), count - i, order, scale);
+}
+
+__attribute__((target("avx2")))
+void int8ToFloatAvx2(const uint8_t* src, float* dst, size_t count, float invScale)
+{
+   const __m256 s = _mm256_set1_ps(invScale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m256i lo = _mm256_cvtepi8_epi32(raw);
+      const __m256i hi = _mm256_cvtepi8_epi32(_mm_srli_si128(raw, 8));
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), s));
+      _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), s));
+   }
+   int8ToFloatScalar(src + i, dst + i, count - i, invScale);
+}
+
+__attribute__((target("avx2")))
+void floatToInt8Avx2(const float* src, uint8_t* dst, size_t count, float scale)
+{
+   const __m256 s = _mm256_set1_ps(scale);
+   // packs interleaves 4-byte groups across the two lanes; this puts them back
+   const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+   size_t i = 0;
+   for (; i + 32 <= count; i += 32)
+   {
+      __m256i eighths[4];
+      for (size_t q = 0; q < 4; ++q)
+      {
+         eighths[q] = roundAwayAvx2(scaleAndClampAvx2(src + i + (8 * q), s, INT8_MIN_F, INT8_MAX_F));
+      }
+      const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(eighths[0], eighths[1]),
+                                                _mm256_packs_epi32(eighths[2], eighths[3]));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_permutevar8x32_epi32(packed, order));
+   }
+   floatToInt8Scalar(src + i, dst + i, count - i, scale);
+}
+
+__attribute__((target("avx2")))
+void int12ToFloatAvx2(const uint8_t* src, float* dst, size_t count, ByteOrder order, float invScale)
+{
+   const __m256i mask = _mm256_broadcastsi128_si256(
+      loadMask(order == ByteOrder::BigEndian ? INT12_UNPACK_BE : INT12_UNPACK_LE));
+   const __m256i align = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(INT12_ALIGN)));
+   const __m256 s = _mm256_set1_ps(invScale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const uint8_t* in = src + (3 * i / 2);
+      const __m256i raw = _mm256_set_m128i(load12Ssse3(in + 12), load12Ssse3(in));
+      const __m256i lanes = _mm256_srai_epi16(
+         _mm256_mullo_epi16(_mm256_shuffle_epi8(raw, mask), align), 4);
+      const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(lanes));
+      const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(lanes, 1));
+      _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), s));
+      _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), s));
+   }
+   int12ToFloatScalar(src + (3 * i / 2), dst + i, count - i, order, invScale);
+}
+
+__attribute__((target("avx2")))
+void floatToInt12Avx2(const float* src, uint8_t* dst, size_t count, ByteOrder order, float scale)
+{
+   const __m256i mask = _mm256_broadcastsi128_si256(
+      loadMask(order == ByteOrder::BigEndian ? INT12_PACK_BE : INT12_PACK_LE));
+   const __m256 s = _mm256_set1_ps(scale);
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const __m256i pairs = roundToInt16Avx2(src + i, s, INT12_MIN_F, INT12_MAX_F);
+      const __m256i packed = _mm256_or_si256(
+         _mm256_and_si256(_mm256_slli_epi32(pairs, 12), _mm256_set1_epi32(0xFFF000)),
+         _mm256_and_si256(_mm256_srli_epi32(pairs, 16), _mm256_set1_epi32(0xFFF)));
+      const __m256i bytes = _mm256_shuffle_epi8(packed, mask);
+      uint8_t* out = dst + (3 * i / 2);
+      store12Ssse3(out, _mm256_castsi256_si128(bytes));
+      store12Ssse3(out + 12, _mm256_extracti128_si256(bytes, 1));
+   }
+   floatToInt12Scalar(src + i, dst + (3 * i / 2), count - i, order, scale);
+}
+
+__attribute__((target("avx2")))
+void float32ToFloatAvx2(const uint8_t* src, float* dst, size_t count, ByteOrder order)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m256i mask = _mm256_broadcastsi128_si256(swap32Mask());
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (4 * i)));
+      if (swap)
+      {
+         raw = _mm256_shuffle_epi8(raw, mask);
+      }
+      _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(raw));
+   }
+   float32ToFloatScalar(src + (4 * i), dst + i, count - i, order);
+}
+
+__attribute__((target("avx2")))
+void floatToFloat32Avx2(const float* src, uint8_t* dst, size_t count, ByteOrder order)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   const __m256i mask = _mm256_broadcastsi128_si256(swap32Mask());
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      __m256i raw = _mm256_castps_si256(_mm256_loadu_ps(src + i));
+      if (swap)
+      {
+         raw = _mm256_shuffle_epi8(raw, mask);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (4 * i)), raw);
+   }
+   floatToFloat32Scalar(src + i, dst + (4 * i), count - i, order);
+}
+
+#endif // VITA49_KERNELS_X86
+
+// ============================================================================
+// NEON implementations (little-endian AArch64)
+// ============================================================================
+
+#if defined(VITA49_KERNELS_NEON)
+
+// Convert 8 int16 lanes to float and store them.
+void storeInt16AsFloatNeon(int16x8_t v, float* dst, float invScale)
+{
+   vst1q_f32(dst, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), invScale));
+   vst1q_f32(dst + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), invScale));
+}
+
+// FCVTAS rounds half away from zero (NaN -> 0); clamp the result to [lo, hi]
+int32x4_t roundClampedNeon(const float* src, float scale, int32_t lo, int32_t hi)
+{
+   const int32x4_t rounded = vcvtaq_s32_f32(vmulq_n_f32(vld1q_f32(src), scale));
+   return vminq_s32(vmaxq_s32(rounded, vdupq_n_s32(lo)), vdupq_n_s32(hi));
+}
+
+void int16ToFloatNeon(const uint8_t* src, float* dst, size_t count, ByteOrder order, float invScale)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      uint8x16_t bytes = vld1q_u8(src + (2 * i));
+      if (swap)
+      {
+         bytes = vrev16q_u8(bytes);
+      }
+      storeInt16AsFloatNeon(vreinterpretq_s16_u8(bytes), dst + i, invScale);
+   }
+   int16ToFloatScalar(src + (2 * i), dst + i, count - i, order, invScale);
+}
+
+void floatToInt16Neon(const float* src, uint8_t* dst, size_t count, ByteOrder order, float scale)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      // FCVTAS rounds half away from zero (NaN -> 0); the narrowing saturates
+      const int32x4_t lo = vcvtaq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), scale));
+      const int32x4_t hi = vcvtaq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), scale));
+      uint8x16_t bytes = vreinterpretq_u8_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+      if (swap)
+      {
+         bytes = vrev16q_u8(bytes);
+      }
+      vst1q_u8(dst + (2 * i), bytes);
+   }
+   floatToInt16Scalar(src + i, dst + (2 * i), count - i, order, scale);
+}
+
+void int8ToFloatNeon(const uint8_t* src, float* dst, size_t count, float invScale)
+{
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      const int8x16_t raw = vld1q_s8(reinterpret_cast<const int8_t*>(src + i));
+      storeInt16AsFloatNeon(vmovl_s8(vget_low_s8(raw)), dst + i, invScale);
+      storeInt16AsFloatNeon(vmovl_s8(vget_high_s8(raw)), dst + i + 8, invScale);
+   }
+   int8ToFloatScalar(src + i, dst + i, count - i, invScale);
+}
+
+void floatToInt8Neon(const float* src, uint8_t* dst, size_t count, float scale)
+{
+   size_t i = 0;
+   for (; i + 16 <= count; i += 16)
+   {
+      // FCVTAS rounds half away from zero (NaN -> 0); the narrowings saturate
+      int32x4_t quarters[4];
+      for (size_t q = 0; q < 4; ++q)
+      {
+         quarters[q] = vcvtaq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + (4 * q)), scale));
+      }
+      const int16x8_t lo = vcombine_s16(vqmovn_s32(quarters[0]), vqmovn_s32(quarters[1]));
+      const int16x8_t hi = vcombine_s16(vqmovn_s32(quarters[2]), vqmovn_s32(quarters[3]));
+      vst1q_s8(reinterpret_cast<int8_t*>(dst + i), vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi)));
+   }
+   floatToInt8Scalar(src + i, dst + i, count - i, scale);
+}
+
+void int12ToFloatNeon(const uint8_t* src, float* dst, size_t count, ByteOrder order, float invScale)
+{
+   const uint8x16_t mask = vld1q_u8(order == ByteOrder::BigEndian ? INT12_UNPACK_BE : INT12_UNPACK_LE);
+   const int16x8_t align = vld1q_s16(INT12_ALIGN);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      // 12 bytes: four packed pairs
+      const uint8_t* in = src + (3 * i / 2);
+      uint32_t tail = 0;
+      std::memcpy(&tail, in + 8, sizeof(tail));
+      const uint8x16_t raw = vcombine_u8(vld1_u8(in), vreinterpret_u8_u32(vdup_n_u32(tail)));
+      const int16x8_t lanes = vreinterpretq_s16_u8(vqtbl1q_u8(raw, mask));
+      // Both halves now end at bit 15: the arithmetic shift sign-extends them
+      storeInt16AsFloatNeon(vshrq_n_s16(vmulq_s16(lanes, align), 4), dst + i, invScale);
+   }
+   int12ToFloatScalar(src + (3 * i / 2), dst + i, count - i, order, invScale);
+}
+
+void floatToInt12Neon(const float* src, uint8_t* dst, size_t count, ByteOrder order, float scale)
+{
+   const uint8x16_t mask = vld1q_u8(order == ByteOrder::BigEndian ? INT12_PACK_BE : INT12_PACK_LE);
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8)
+   {
+      const int32x4_t lo = roundClampedNeon(src + i, scale, -2048, 2047);
+      const int32x4_t hi = roundClampedNeon(src + i + 4, scale, -2048, 2047);
+      // One sample per 32-bit lane, Q in the top half: make it I << 12 | Q
+      const uint32x4_t pairs = vreinterpretq_u32_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+      const uint32x4_t packed = vorrq_u32(vandq_u32(vshlq_n_u32(pairs, 12), vdupq_n_u32(0xFFF000)),
+                                          vandq_u32(vshrq_n_u32(pairs, 16), vdupq_n_u32(0xFFF)));
+      const uint8x16_t bytes = vqtbl1q_u8(vreinterpretq_u8_u32(packed), mask);
+
+      uint8_t* out = dst + (3 * i / 2);
+      vst1_u8(out, vget_low_u8(bytes));
+      const uint32_t tail = vgetq_lane_u32(vreinterpretq_u32_u8(bytes), 2);
+      std::memcpy(out + 8, &tail, sizeof(tail));
+   }
+   floatToInt12Scalar(src + i, dst + (3 * i / 2), count - i, order, scale);
+}
+
+void float32ToFloatNeon(const uint8_t* src, float* dst, size_t count, ByteOrder order)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   size_t i = 0;
+   for (; i + 4 <= count; i += 4)
+   {
+      uint8x16_t bytes = vld1q_u8(src + (4 * i));
+      if (swap)
+      {
+         bytes = vrev32q_u8(bytes);
+      }
+      vst1q_f32(dst + i, vreinterpretq_f32_u8(bytes));
+   }
+   float32ToFloatScalar(src + (4 * i), dst + i, count - i, order);
+}
+
+void floatToFloat32Neon(const float* src, uint8_t* dst, size_t count, ByteOrder order)
+{
+   const bool swap = (order == ByteOrder::BigEndian);
+   size_t i = 0;
+   for (; i + 4 <= count; i += 4)
+   {
+      uint8x16_t bytes = vreinterpretq_u8_f32(vld1q_f32(src + i));
+      if (swap)
+      {
+         bytes = vrev32q_u8(bytes);
+      }
+      vst1q_u8(dst + (4 * i), bytes);
+   }
+   floatToFloat32Scalar(src + i, dst + (4 * i), count - i, order);
+}
+
+#endif // VITA49_KERNELS_NEON
+
+} // anonymous namespace
+
+// ============================================================================
+// Public dispatch
+// ============================================================================
+
+const char* sampleConversionIsa()
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      return "avx2";
+   }
+   return cpuHasSsse3() ? "ssse3" : "scalar";
+#elif defined(VITA49_KERNELS_NEON)
+   return "neon";
+#else
+   return "scalar";
+#endif
+}
+
+void convertInt16ToFloat(const uint8_t* src, float* dst, size_t count,
+                         ByteOrder order, float invScale)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      int16ToFloatAvx2(src, dst, count, order, invScale);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      int16ToFloatSsse3(src, dst, count, order, invScale);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   int16ToFloatNeon(src, dst, count, order, invScale);
+   return;
+#endif
+   int16ToFloatScalar(src, dst, count, order, invScale);
+}
+
+void convertFloatToInt16(const float* src, uint8_t* dst, size_t count,
+                         ByteOrder order, float scale)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      floatToInt16Avx2(src, dst, count, order, scale);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      floatToInt16Ssse3(src, dst, count, order, scale);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   floatToInt16Neon(src, dst, count, order, scale);
+   return;
+#endif
+   floatToInt16Scalar(src, dst, count, order, scale);
+}
+
+void convertInt8ToFloat(const uint8_t* src, float* dst, size_t count, float invScale)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      int8ToFloatAvx2(src, dst, count, invScale);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      int8ToFloatSsse3(src, dst, count, invScale);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   int8ToFloatNeon(src, dst, count, invScale);
+   return;
+#endif
+   int8ToFloatScalar(src, dst, count, invScale);
+}
+
+void convertFloatToInt8(const float* src, uint8_t* dst, size_t count, float scale)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      floatToInt8Avx2(src, dst, count, scale);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      floatToInt8Ssse3(src, dst, count, scale);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   floatToInt8Neon(src, dst, count, scale);
+   return;
+#endif
+   floatToInt8Scalar(src, dst, count, scale);
+}
+
+void convertInt12ToFloat(const uint8_t* src, float* dst, size_t count,
+                         ByteOrder order, float invScale)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      int12ToFloatAvx2(src, dst, count, order, invScale);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      int12ToFloatSsse3(src, dst, count, order, invScale);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   int12ToFloatNeon(src, dst, count, order, invScale);
+   return;
+#endif
+   int12ToFloatScalar(src, dst, count, order, invScale);
+}
+
+void convertFloatToInt12(const float* src, uint8_t* dst, size_t count,
+                         ByteOrder order, float scale)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      floatToInt12Avx2(src, dst, count, order, scale);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      floatToInt12Ssse3(src, dst, count, order, scale);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   floatToInt12Neon(src, dst, count, order, scale);
+   return;
+#endif
+   floatToInt12Scalar(src, dst, count, order, scale);
+}
+
+void convertFloat32ToFloat(const uint8_t* src, float* dst, size_t count, ByteOrder order)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      float32ToFloatAvx2(src, dst, count, order);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      float32ToFloatSsse3(src, dst, count, order);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   float32ToFloatNeon(src, dst, count, order);
+   return;
+#endif
+   float32ToFloatScalar(src, dst, count, order);
+}
+
+void convertFloatToFloat32(const float* src, uint8_t* dst, size_t count, ByteOrder order)
+{
+#if defined(VITA49_KERNELS_X86)
+   if (cpuHasAvx2())
+   {
+      floatToFloat32Avx2(src, dst, count, order);
+      return;
+   }
+   if (cpuHasSsse3())
+   {
+      floatToFloat32Ssse3(src, dst, count, order);
+      return;
+   }
+#elif defined(VITA49_KERNELS_NEON)
+   floatToFloat32Neon(src, dst, count, order);
+   return;
+#endif
+   floatToFloat32Scalar(src, dst, count, order);
+}
+
+} // namespace Vita49_2
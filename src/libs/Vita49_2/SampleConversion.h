@@ -0,0 +1,135 @@
+#ifndef SAMPLECONVERSION_H_
+#define SAMPLECONVERSION_H_
+
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Vita49_2
+{
+
+// ============================================================================
+// Vectorised integer/float <-> float conversion of signal data payloads.
+//
+// Payloads are streams of values (I, Q, I, Q, ...) in the packet's byte
+// order: 16-bit, 8-bit, 12-bit packed in pairs, or IEEE-754 floats (see
+// PayloadFormat).  Each kernel has an AVX2 and SSSE3 (x86-64, selected at
+// run time), NEON (AArch64) and scalar implementation; all give
+// bit-identical results.  Buffers need no particular alignment.
+// ============================================================================
+
+/**
+ * @brief Name of the instruction set the conversions dispatch to on this CPU.
+ * @return "avx2", "ssse3", "neon" or "scalar".
+ */
+[[nodiscard]] const char* sampleConversionIsa();
+
+/**
+ * @brief Convert 16-bit values to float: `dst[i] = float(int16(src[i])) * invScale`.
+ *
+ * @param src Payload bytes (`2 * count`)
+ * @param dst `count` output floats
+ * @param count Number of values (twice the number of I/Q samples)
+ * @param order Byte order of the payload
+ * @param invScale Multiplier applied to every value (1 / scale factor)
+ */
+void convertInt16ToFloat(const uint8_t* src, float* dst, size_t count,
+                         ByteOrder order, float invScale);
+
+/**
+ * @brief Convert floats to 16-bit values:
+ *        `dst[i] = clamp(lroundf(src[i] * scale), -32768, 32767)`.
+ *
+ * Ties round away from zero, as lroundf() does; out-of-range values
+ * saturate and NaN becomes 0.
+ *
+ * @param src `count` input floats
+ * @param dst Payload bytes (`2 * count`)
+ * @param count Number of values (twice the number of I/Q samples)
+ * @param order Byte order to write
+ * @param scale Multiplier applied before rounding (the scale factor)
+ */
+void convertFloatToInt16(const float* src, uint8_t* dst, size_t count,
+                         ByteOrder order, float scale);
+
+/**
+ * @brief Convert 8-bit values to float: `dst[i] = float(int8(src[i])) * invScale`.
+ *
+ * Single bytes have no byte order, so one layout serves both.
+ *
+ * @param src Payload bytes (`count`)
+ * @param dst `count` output floats
+ * @param count Number of values (twice the number of I/Q samples)
+ * @param invScale Multiplier applied to every value
+ */
+void convertInt8ToFloat(const uint8_t* src, float* dst, size_t count, float invScale);
+
+/**
+ * @brief Convert floats to 8-bit values:
+ *        `dst[i] = clamp(lroundf(src[i] * scale), -128, 127)`.
+ *
+ * Rounding, saturation and NaN as in convertFloatToInt16().
+ *
+ * @param src `count` input floats
+ * @param dst Payload bytes (`count`)
+ * @param count Number of values (twice the number of I/Q samples)
+ * @param scale Multiplier applied before rounding
+ */
+void convertFloatToInt8(const float* src, uint8_t* dst, size_t count, float scale);
+
+/**
+ * @brief Convert packed 12-bit I/Q pairs to float.
+ *
+ * Each pair is a 24-bit value `I << 12 | Q` (two's complement halves) in
+ * three bytes of the given byte order, so a big-endian payload is the
+ * VITA 49 link-efficient packing.
+ *
+ * @param src Payload bytes (`3 * count / 2`)
+ * @param dst `count` output floats
+ * @param count Number of values; must be even
+ * @param order Byte order of each 24-bit pair
+ * @param invScale Multiplier applied to every value
+ */
+void convertInt12ToFloat(const uint8_t* src, float* dst, size_t count,
+                         ByteOrder order, float invScale);
+
+/**
+ * @brief Convert floats to packed 12-bit I/Q pairs:
+ *        `clamp(lroundf(src[i] * scale), -2048, 2047)`.
+ *
+ * Layout as in convertInt12ToFloat(); rounding, saturation and NaN as in
+ * convertFloatToInt16().
+ *
+ * @param src `count` input floats
+ * @param dst Payload bytes (`3 * count / 2`)
+ * @param count Number of values; must be even
+ * @param order Byte order of each 24-bit pair
+ * @param scale Multiplier applied before rounding
+ */
+void convertFloatToInt12(const float* src, uint8_t* dst, size_t count,
+                         ByteOrder order, float scale);
+
+/**
+ * @brief Read IEEE-754 single precision values in the given byte order.
+ *
+ * @param src Payload bytes (`4 * count`)
+ * @param dst `count` output floats
+ * @param count Number of values (twice the number of I/Q samples)
+ * @param order Byte order of the payload
+ */
+void convertFloat32ToFloat(const uint8_t* src, float* dst, size_t count, ByteOrder order);
+
+/**
+ * @brief Write floats as IEEE-754 single precision values, unchanged.
+ *
+ * @param src `count` input floats
+ * @param dst Payload bytes (`4 * count`)
+ * @param count Number of values (twice the number of I/Q samples)
+ * @param order Byte order to write
+ */
+void convertFloatToFloat32(const float* src, uint8_t* dst, size_t count, ByteOrder order);
+
+} // namespace Vita49_2
+
+#endif // SAMPLECONVERSION_H_
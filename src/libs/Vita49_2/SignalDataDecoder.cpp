@@ -0,0 +1,220 @@
+#include "SignalDataDecoder.h"
+#include "ByteSwap.h"
+#include "PacketView.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace Vita49_2
+{
+
+namespace
+{
+
+// Layout key bits, indexing PARSERS
+constexpr size_t KEY_LITTLE_ENDIAN = 0x01;
+constexpr size_t KEY_STREAM_ID     = 0x02;
+constexpr size_t KEY_CLASS_ID      = 0x04;
+constexpr size_t KEY_TSI           = 0x08;
+constexpr size_t KEY_TSF           = 0x10;
+constexpr size_t KEY_TRAILER       = 0x20;
+constexpr size_t KEY_COUNT         = 0x40;
+
+template <ByteOrder Order>
+uint32_t readWord(const uint8_t* p)
+{
+   if constexpr (Order == ByteOrder::BigEndian)
+   {
+      return readU32BE(p);
+   }
+   else
+   {
+      return readU32LE(p);
+   }
+}
+
+template <ByteOrder Order>
+uint64_t readDWord(const uint8_t* p)
+{
+   if constexpr (Order == ByteOrder::BigEndian)
+   {
+      return readU64BE(p);
+   }
+   else
+   {
+      return readU64LE(p);
+   }
+}
+
+uint32_t readWord(const uint8_t* p, ByteOrder order)
+{
+   return (order == ByteOrder::BigEndian) ? readU32BE(p) : readU32LE(p);
+}
+
+// PacketHeaderCodec::parse() with the optional fields fixed at compile time
+template <ByteOrder Order, bool StreamId, bool ClassId, bool Tsi, bool Tsf, bool Trailer>
+bool parseHeader(const uint8_t* data, size_t length, uint32_t layout,
+                 PacketHeader& header, size_t& headerBytes)
+{
+   constexpr size_t HEADER_BYTES =
+      4 * (1 + (StreamId ? 1 : 0) + (ClassId ? 2 : 0) + (Tsi ? 1 : 0) + (Tsf ? 2 : 0));
+   constexpr size_t MIN_PACKET_BYTES = HEADER_BYTES + (Trailer ? 4 : 0);
+
+   if (length < 4)
+   {
+      return false;
+   }
+   const uint32_t word0 = readWord<Order>(data);
+   const size_t packetBytes = static_cast<size_t>(word0 & 0xFFFFu) * 4;
+   if ((word0 & SignalDataDecoder::LAYOUT_MASK) != layout ||
+       packetBytes < MIN_PACKET_BYTES || packetBytes > length)
+   {
+      return false;
+   }
+
+   header.packetType     = static_cast<PacketType>((word0 >> 28) & 0xFu);
+   header.classIdPresent = ClassId;
+   header.trailerPresent = Trailer;
+   header.tsiType        = static_cast<TSI>((word0 >> 22) & 0x3u);
+   header.tsfType        = static_cast<TSF>((word0 >> 20) & 0x3u);
+   header.packetCount    = static_cast<uint8_t>((word0 >> 16) & 0xFu);
+   header.packetSize     = static_cast<uint16_t>(word0 & 0xFFFFu);
+
+   const uint8_t* field = data + 4;
+   if constexpr (StreamId)
+   {
+      header.streamId = readWord<Order>(field);
+      field += 4;
+   }
+   if constexpr (ClassId)
+   {
+      const uint32_t classWord1   = readWord<Order>(field);
+      const uint32_t classWord2   = readWord<Order>(field + 4);
+      header.padBitCount          = static_cast<uint8_t>((classWord1 >> 27) & 0x1Fu);
+      header.classIdOUI           = classWord1 & 0x00FFFFFFu;
+      header.informationClassCode = static_cast<uint16_t>((classWord2 >> 16) & 0xFFFFu);
+      header.packetClassCode      = static_cast<uint16_t>(classWord2 & 0xFFFFu);
+      field += 8;
+   }
+   if constexpr (Tsi)
+   {
+      header.integerTimestamp = readWord<Order>(field);
+      field += 4;
+   }
+   if constexpr (Tsf)
+   {
+      header.fractionalTimestamp = readDWord<Order>(field);
+   }
+
+   headerBytes = HEADER_BYTES;
+   return true;
+}
+
+template <size_t Key>
+constexpr SignalDataDecoder::HeaderParser parserFor()
+{
+   constexpr ByteOrder ORDER =
+      ((Key & KEY_LITTLE_ENDIAN) != 0) ? ByteOrder::LittleEndian : ByteOrder::BigEndian;
+   return &parseHeader<ORDER, (Key & KEY_STREAM_ID) != 0, (Key & KEY_CLASS_ID) != 0,
+                       (Key & KEY_TSI) != 0, (Key & KEY_TSF) != 0, (Key & KEY_TRAILER) != 0>;
+}
+
+template <size_t... Keys>
+constexpr std::array<SignalDataDecoder::HeaderParser, sizeof...(Keys)> makeParsers(
+   std::index_sequence<Keys...> /*keys*/)
+{
+   return {parserFor<Keys>()...};
+}
+
+constexpr auto PARSERS = makeParsers(std::make_index_sequence<KEY_COUNT>());
+
+} // anonymous namespace
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+SignalDataDecoder::SignalDataDecoder(ByteOrder order, uint32_t layout, HeaderParser parser)
+   : _order(order)
+   , _layout(layout)
+   , _parser(parser)
+{
+}
+
+std::optional<SignalDataDecoder> SignalDataDecoder::select(
+   const uint8_t* data, size_t length, ByteOrder order)
+{
+   if (data == nullptr || length < 4)
+   {
+      return std::nullopt;
+   }
+
+   const uint32_t word0 = readWord(data, order);
+   const auto type      = static_cast<PacketType>((word0 >> 28) & 0xFu);
+   if (!isDataPacket(type))
+   {
+      return std::nullopt;
+   }
+
+   size_t key = 0;
+   if (order == ByteOrder::LittleEndian)  key |= KEY_LITTLE_ENDIAN;
+   if (hasStreamId(type))                 key |= KEY_STREAM_ID;
+   if (((word0 >> 27) & 0x1u) != 0)       key |= KEY_CLASS_ID;
+   if (((word0 >> 22) & 0x3u) != 0)       key |= KEY_TSI;
+   if (((word0 >> 20) & 0x3u) != 0)       key |= KEY_TSF;
+   if (((word0 >> 26) & 0x1u) != 0)       key |= KEY_TRAILER;
+
+   return SignalDataDecoder(order, word0 & LAYOUT_MASK, PARSERS[key]);
+}
+
+bool SignalDataDecoder::matches(const uint8_t* data, size_t length) const
+{
+   return data != nullptr && length >= 4 && (readWord(data, _order) & LAYOUT_MASK) == _layout;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+std::optional<SignalDataPacket::DecodeResult> SignalDataDecoder::decode(
+   const uint8_t* data, size_t length, float scaleFactor,
+   size_t& bytesConsumed, PayloadFormat format) const
+{
+   SignalDataPacket::DecodeResult result;
+   size_t headerBytes = 0;
+   if (data == nullptr || scaleFactor == 0.0f ||
+       !_parser(data, length, _layout, result.header, headerBytes))
+   {
+      return std::nullopt;
+   }
+
+   // Samples fill the payload up to its pad bits
+   const size_t packetBytes  = static_cast<size_t>(result.header.packetSize) * 4;
+   const size_t payloadBytes = packetBytes - headerBytes - (result.header.trailerPresent ? 4 : 0);
+   const size_t padding      = std::min<size_t>(result.header.padBitCount / 8, payloadBytes);
+   const size_t numSamples   = (payloadBytes - padding) / bytesPerSample(format);
+
+   result.samples.resize(numSamples);
+   SignalDataPacket::decodeSamples(data + headerBytes, numSamples, _order, scaleFactor,
+                                   result.samples.data(), format);
+
+   bytesConsumed = packetBytes;
+   return result;
+}
+
+std::optional<PacketView> SignalDataDecoder::view(std::span<const uint8_t> data,
+                                                  PayloadFormat format) const
+{
+   PacketHeader header;
+   size_t headerBytes = 0;
+   if (data.data() == nullptr || !_parser(data.data(), data.size(), _layout, header, headerBytes))
+   {
+      return std::nullopt;
+   }
+
+   const size_t packetBytes = static_cast<size_t>(header.packetSize) * 4;
+   return PacketView(data.first(packetBytes), headerBytes, _order, format, header);
+}
+
+} // namespace Vita49_2
@@ -0,0 +1,101 @@
+#ifndef SIGNALDATADECODER_H_
+#define SIGNALDATADECODER_H_
+
+#include "SignalDataPacket.h"
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Vita49_2
+{
+
+class PacketView;
+
+/**
+ * @class SignalDataDecoder
+ * @brief Signal data decoder specialized for one stream's header layout.
+ *
+ * In a steady stream every data packet has the same layout: byte order,
+ * packet type, Class ID, trailer and timestamp types.  select() picks,
+ * from the first packet, a header parser compiled for that layout (one of
+ * 64 instantiations over byte order, Stream ID, Class ID, TSI, TSF and
+ * trailer presence), so the following packets are parsed without testing
+ * each optional field: a single compare of header word 0 confirms the
+ * layout, and the payload goes straight to the sample conversion.
+ *
+ * A packet with another layout makes matches() false and decode() / view()
+ * return std::nullopt; callers then parse it generically and select a new
+ * decoder, as Vita49Codec::parseStream() and PacketStreamView do.
+ */
+class SignalDataDecoder
+{
+public:
+   /// Bits of header word 0 a decoder is specialized for: packet type,
+   /// Class ID, trailer, TSI and TSF (not packet count or size)
+   static constexpr uint32_t LAYOUT_MASK = 0xFCF00000u;
+
+   /**
+    * @brief Select the decoder for the layout of a data packet.
+    *
+    * @param data Start of the packet
+    * @param length Available bytes in the buffer
+    * @param order Byte order of the packet
+    * @return The decoder, or std::nullopt if this is not a data packet
+    */
+   [[nodiscard]] static std::optional<SignalDataDecoder> select(
+      const uint8_t* data, size_t length, ByteOrder order);
+
+   /** @brief Whether the packet at @p data has this decoder's layout. */
+   [[nodiscard]] bool matches(const uint8_t* data, size_t length) const;
+
+   /**
+    * @brief SignalDataPacket::decode() for a packet of this layout.
+    *
+    * @param data Start of the packet
+    * @param length Available bytes in the buffer
+    * @param scaleFactor Division factor for int16-to-float conversion
+    * @param bytesConsumed [out] Number of bytes consumed by the packet
+    * @param format Sample format of the payload
+    * @return Decoded result, or std::nullopt if the packet has another
+    *         layout, is truncated or is too short for its header
+    */
+   [[nodiscard]] std::optional<SignalDataPacket::DecodeResult> decode(
+      const uint8_t* data, size_t length, float scaleFactor,
+      size_t& bytesConsumed,
+      PayloadFormat format = PayloadFormat::Int16) const;
+
+   /**
+    * @brief PacketView::parse() for a packet of this layout.
+    *
+    * @param data Buffer starting at the packet
+    * @param format Sample format of the payload
+    * @return View of the packet, or std::nullopt as for decode()
+    */
+   [[nodiscard]] std::optional<PacketView> view(
+      std::span<const uint8_t> data,
+      PayloadFormat format = PayloadFormat::Int16) const;
+
+   [[nodiscard]] ByteOrder byteOrder() const { return _order; }
+
+   /** @brief Header word 0 of the layout, masked by LAYOUT_MASK. */
+   [[nodiscard]] uint32_t layout() const { return _layout; }
+
+   /// Parses a header of one layout: fills the header and its size in
+   /// bytes, false if word 0 is not `layout` or the packet does not fit
+   using HeaderParser = bool (*)(const uint8_t* data, size_t length, uint32_t layout,
+                                 PacketHeader& header, size_t& headerBytes);
+
+private:
+   SignalDataDecoder(ByteOrder order, uint32_t layout, HeaderParser parser);
+
+   ByteOrder _order;
+   uint32_t _layout;
+   HeaderParser _parser;
+};
+
+} // namespace Vita49_2
+
+#endif // SIGNALDATADECODER_H_
@@ -1,13 +1,34 @@
 #include "SignalDataPacket.h"
-#include "ByteSwap.h"
 #include "PacketHeader.h"
+#include "SampleConversion.h"
 
 #include <algorithm>
-#include <cmath>
+#include <numeric>
 
 namespace Vita49_2
 {
 
+namespace
+{
+
+// Header words of an IF Data With Stream ID packet
+size_t headerWords(TSI tsiType, TSF tsfType, bool classIdPresent)
+{
+   size_t words = 2;  // word 0 + stream ID
+   if (classIdPresent)       words += 2;
+   if (tsiType != TSI::None) words += 1;
+   if (tsfType != TSF::None) words += 2;
+   return words;
+}
+
+// Zero bytes completing the last payload word of `sampleCount` samples
+size_t padBytes(size_t sampleCount, PayloadFormat format)
+{
+   return (4 - ((sampleCount * bytesPerSample(format)) % 4)) % 4;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // decode
 // ============================================================================
@@ -15,7 +36,8 @@ namespace Vita49_2
 std::optional<SignalDataPacket::DecodeResult> SignalDataPacket::decode(
    const uint8_t* data, size_t length,
    ByteOrder order, float scaleFactor,
-   size_t& bytesConsumed)
+   size_t& bytesConsumed,
+   PayloadFormat format)
 {
    if (data == nullptr || length < 4 || scaleFactor == 0.0f)
    {
@@ -44,38 +66,13 @@ std::optional<SignalDataPacket::DecodeResult> SignalDataPacket::decode(
       return std::nullopt;
    }
 
+   // Samples fill the payload up to its pad bits
    const size_t payloadBytes = packetBytes - headerBytes - trailerBytes;
+   const size_t padding      = std::min<size_t>(header.padBitCount / 8, payloadBytes);
+   const size_t numSamples   = (payloadBytes - padding) / bytesPerSample(format);
 
-   // Each I/Q pair = 4 bytes (16-bit I + 16-bit Q)
-   const size_t numSamples = payloadBytes / 4;
-
-   IQSamples samples;
-   samples.reserve(numSamples);
-
-   const uint8_t* payload = data + headerBytes;
-   const float invScale = 1.0f / scaleFactor;
-
-   for (size_t i = 0; i < numSamples; ++i)
-   {
-      const uint8_t* word = payload + (i * 4);
-      int16_t iVal;
-      int16_t qVal;
-
-      if (order == ByteOrder::BigEndian)
-      {
-         iVal = readI16BE(word);
-         qVal = readI16BE(word + 2);
-      }
-      else
-      {
-         iVal = readI16LE(word);
-         qVal = readI16LE(word + 2);
-      }
-
-      samples.emplace_back(
-         static_cast<float>(iVal) * invScale,
-         static_cast<float>(qVal) * invScale);
-   }
+   IQSamples samples(numSamples);
+   decodeSamples(data + headerBytes, numSamples, order, scaleFactor, samples.data(), format);
 
    bytesConsumed = packetBytes;
 
@@ -85,13 +82,66 @@ std::optional<SignalDataPacket::DecodeResult> SignalDataPacket::decode(
    return result;
 }
 
+// ============================================================================
+// decodeSamples
+// ============================================================================
+
+void SignalDataPacket::decodeSamples(const uint8_t* payload, size_t count,
+                                     ByteOrder order, float scaleFactor,
+                                     IQSample* out, PayloadFormat format)
+{
+   // std::complex<float> is laid out as float[2]: I, Q
+   auto* values = reinterpret_cast<float*>(out);
+   switch (format)
+   {
+      case PayloadFormat::Int8:
+         convertInt8ToFloat(payload, values, 2 * count, 256.0f / scaleFactor);
+         break;
+      case PayloadFormat::Int12Packed:
+         convertInt12ToFloat(payload, values, 2 * count, order, 16.0f / scaleFactor);
+         break;
+      case PayloadFormat::Float32:
+         convertFloat32ToFloat(payload, values, 2 * count, order);
+         break;
+      default:
+         convertInt16ToFloat(payload, values, 2 * count, order, 1.0f / scaleFactor);
+         break;
+   }
+}
+
 // ============================================================================
 // encode
 // ============================================================================
 
 std::vector<uint8_t> SignalDataPacket::encode(
    uint32_t streamId,
-   const IQSamples& samples,
+   std::span<const IQSample> samples,
+   uint8_t packetCount,
+   ByteOrder order,
+   float scaleFactor,
+   TSI tsiType,
+   TSF tsfType,
+   uint32_t intTimestamp,
+   uint64_t fracTimestamp,
+   bool includeTrailer,
+   PayloadFormat format)
+{
+   const size_t packetBytes = encodedSize(samples.size(), tsiType, tsfType, includeTrailer, format);
+   if (packetBytes == 0)
+   {
+      return {};
+   }
+
+   std::vector<uint8_t> out(packetBytes);
+   (void)encodeInto(out, streamId, samples, packetCount, order, scaleFactor,
+                    tsiType, tsfType, intTimestamp, fracTimestamp, includeTrailer, format);
+   return out;
+}
+
+size_t SignalDataPacket::encodeInto(
+   std::span<uint8_t> out,
+   uint32_t streamId,
+   std::span<const IQSample> samples,
    uint8_t packetCount,
    ByteOrder order,
    float scaleFactor,
@@ -99,17 +149,28 @@ std::vector<uint8_t> SignalDataPacket::encode(
    TSF tsfType,
    uint32_t intTimestamp,
    uint64_t fracTimestamp,
-   bool includeTrailer)
+   bool includeTrailer,
+   PayloadFormat format)
 {
+   const size_t packetBytes = encodedSize(samples.size(), tsiType, tsfType, includeTrailer, format);
+   if (packetBytes == 0 || out.size() < packetBytes)
+   {
+      return 0;
+   }
+
+   const size_t sampleBytes = samples.size() * bytesPerSample(format);
+   const size_t padding     = padBytes(samples.size(), format);
+
    // Build header
    PacketHeader header;
    header.packetType     = PacketType::IFDataWithStreamId;
-   header.classIdPresent = false;
+   header.classIdPresent = (padding != 0);
    header.trailerPresent = includeTrailer;
    header.tsiType        = tsiType;
    header.tsfType        = tsfType;
    header.packetCount    = packetCount & 0xF;
    header.streamId       = streamId;
+   header.packetSize     = static_cast<uint16_t>(packetBytes / 4);
 
    if (tsiType != TSI::None)
    {
@@ -119,57 +180,57 @@ std::vector<uint8_t> SignalDataPacket::encode(
    {
       header.fractionalTimestamp = fracTimestamp;
    }
-
-   const size_t headerWords  = PacketHeaderCodec::sizeInWords(header);
-   const size_t trailerWords = includeTrailer ? 1 : 0;
-   const size_t payloadWords = samples.size();
-   const size_t totalWords   = headerWords + payloadWords + trailerWords;
-
-   if (totalWords > MAX_PACKET_SIZE_WORDS)
+   if (header.classIdPresent)
    {
-      return {};
+      header.classIdOUI           = 0;
+      header.informationClassCode = 0;
+      header.packetClassCode      = 0;
+      header.padBitCount          = static_cast<uint8_t>(padding * 8);
    }
 
-   header.packetSize = static_cast<uint16_t>(totalWords);
-
-   std::vector<uint8_t> out;
-   out.reserve(totalWords * 4);
+   // Serialize header, then the I/Q payload and its padding, then the
+   // trailer (all zeros)
+   uint8_t* cursor = out.data();
+   cursor += PacketHeaderCodec::serialize(header, order, cursor);
 
-   // Serialize header
-   PacketHeaderCodec::serialize(header, order, out);
-
-   // Serialize I/Q payload
-   for (const auto& sample : samples)
+   const auto* values = reinterpret_cast<const float*>(samples.data());
+   switch (format)
    {
-      auto iRaw = static_cast<int>(std::lroundf(sample.real() * scaleFactor));
-      auto qRaw = static_cast<int>(std::lroundf(sample.imag() * scaleFactor));
-      auto i16  = static_cast<int16_t>(std::clamp(iRaw, -32768, 32767));
-      auto q16  = static_cast<int16_t>(std::clamp(qRaw, -32768, 32767));
-
-      uint8_t word[4];
-      if (order == ByteOrder::BigEndian)
-      {
-         writeI16BE(word, i16);
-         writeI16BE(word + 2, q16);
-      }
-      else
-      {
-         writeI16LE(word, i16);
-         writeI16LE(word + 2, q16);
-      }
-      out.insert(out.end(), word, word + 4);
+      case PayloadFormat::Int8:
+         convertFloatToInt8(values, cursor, 2 * samples.size(), scaleFactor / 256.0f);
+         break;
+      case PayloadFormat::Int12Packed:
+         convertFloatToInt12(values, cursor, 2 * samples.size(), order, scaleFactor / 16.0f);
+         break;
+      case PayloadFormat::Float32:
+         convertFloatToFloat32(values, cursor, 2 * samples.size(), order);
+         break;
+      default:
+         convertFloatToInt16(values, cursor, 2 * samples.size(), order, scaleFactor);
+         break;
    }
+   std::fill_n(cursor + sampleBytes, padding + (includeTrailer ? 4 : 0), uint8_t{0});
+
+   return packetBytes;
+}
 
-   // Serialize trailer (all zeros)
-   if (includeTrailer)
+// ============================================================================
+// encodedSize
+// ============================================================================
+
+size_t SignalDataPacket::encodedSize(size_t sampleCount, TSI tsiType, TSF tsfType,
+                                     bool includeTrailer, PayloadFormat format)
+{
+   const size_t maxSamples = maxSamplesPerPacket(tsiType, tsfType, false, includeTrailer, format);
+   if (maxSamples == 0 || sampleCount > maxSamples)
    {
-      out.push_back(0);
-      out.push_back(0);
-      out.push_back(0);
-      out.push_back(0);
+      return 0;
    }
 
-   return out;
+   const size_t padding      = padBytes(sampleCount, format);
+   const size_t payloadBytes = (sampleCount * bytesPerSample(format)) + padding;
+   const size_t trailerWords = includeTrailer ? 1 : 0;
+   return ((headerWords(tsiType, tsfType, padding != 0) + trailerWords) * 4) + payloadBytes;
 }
 
 // ============================================================================
@@ -178,22 +239,24 @@ std::vector<uint8_t> SignalDataPacket::encode(
 
 size_t SignalDataPacket::maxSamplesPerPacket(
    TSI tsiType, TSF tsfType,
-   bool classIdPresent, bool includeTrailer)
+   bool classIdPresent, bool includeTrailer,
+   PayloadFormat format)
 {
-   size_t headerWords = 2;  // word 0 + stream ID (IF Data With Stream ID)
-   if (classIdPresent)    headerWords += 2;
-   if (tsiType != TSI::None) headerWords += 1;
-   if (tsfType != TSF::None) headerWords += 2;
+   // Samples that fill whole words; with fewer, the Class ID counts pad bits
+   const size_t sampleBytes    = bytesPerSample(format);
+   const size_t samplesPerUnit = 4 / std::gcd(sampleBytes, size_t{4});
+   const bool reserveClassId   = classIdPresent || (samplesPerUnit > 1);
 
    const size_t trailerWords = includeTrailer ? 1 : 0;
-   const size_t overhead = headerWords + trailerWords;
+   const size_t overhead = headerWords(tsiType, tsfType, reserveClassId) + trailerWords;
 
    if (overhead >= MAX_PACKET_SIZE_WORDS)
    {
       return 0;
    }
 
-   return MAX_PACKET_SIZE_WORDS - overhead;
+   const size_t samples = ((MAX_PACKET_SIZE_WORDS - overhead) * 4) / sampleBytes;
+   return samples - (samples % samplesPerUnit);
 }
 
 } // namespace Vita49_2
@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace Vita49_2
@@ -15,13 +16,19 @@ namespace Vita49_2
  * @class SignalDataPacket
  * @brief Encodes and decodes VITA 49.2 Signal Data (IF Data) packets.
  *
- * Signal Data packets carry 16-bit signed I/Q sample pairs.
- * Each 32-bit payload word contains one I/Q pair:
+ * Signal Data packets carry I/Q sample pairs in one of the PayloadFormats,
+ * by default 16-bit signed, one pair per 32-bit payload word:
  *   - Upper 16 bits: In-phase (I) component
  *   - Lower 16 bits: Quadrature (Q) component
  *
  * The scale factor controls the integer-to-float conversion:
  *   float_value = int16_value / scaleFactor
+ * 8-bit and 12-bit values are the top bits of that int16 value; Float32
+ * payloads hold the float values themselves and ignore the scale factor.
+ *
+ * Formats with several samples per word pad a partial last word with zero
+ * bits, counted in the Class ID's pad bit field, so those packets carry a
+ * Class ID (OUI and codes 0) when their sample count needs it.
  */
 class SignalDataPacket
 {
@@ -43,12 +50,31 @@ public:
     * @param order Byte order of the packet
     * @param scaleFactor Division factor for int16-to-float conversion
     * @param bytesConsumed [out] Number of bytes consumed by the packet
+    * @param format Sample format of the payload
     * @return Decoded result, or std::nullopt on error
     */
    [[nodiscard]] static std::optional<DecodeResult> decode(
       const uint8_t* data, size_t length,
       ByteOrder order, float scaleFactor,
-      size_t& bytesConsumed);
+      size_t& bytesConsumed,
+      PayloadFormat format = PayloadFormat::Int16);
+
+   /**
+    * @brief Convert packed I/Q samples to floats.
+    *
+    * The conversion behind decode() and PacketView::decodeSamples().
+    *
+    * @param payload Start of the samples (bytesPerSample(format) each)
+    * @param count Number of samples to convert
+    * @param order Byte order of the payload
+    * @param scaleFactor Division factor for int16-to-float conversion
+    * @param out [out] Destination for @p count samples
+    * @param format Sample format of the payload
+    */
+   static void decodeSamples(const uint8_t* payload, size_t count,
+                             ByteOrder order, float scaleFactor,
+                             IQSample* out,
+                             PayloadFormat format = PayloadFormat::Int16);
 
    /**
     * @brief Encode a single Signal Data packet.
@@ -63,11 +89,45 @@ public:
     * @param intTimestamp Integer timestamp value (used if tsiType != None)
     * @param fracTimestamp Fractional timestamp value (used if tsfType != None)
     * @param includeTrailer Whether to include a trailer word
+    * @param format Sample format of the payload
     * @return Serialized packet bytes, or empty vector if samples exceed max
     */
    [[nodiscard]] static std::vector<uint8_t> encode(
       uint32_t streamId,
-      const IQSamples& samples,
+      std::span<const IQSample> samples,
+      uint8_t packetCount,
+      ByteOrder order,
+      float scaleFactor,
+      TSI tsiType = TSI::None,
+      TSF tsfType = TSF::None,
+      uint32_t intTimestamp = 0,
+      uint64_t fracTimestamp = 0,
+      bool includeTrailer = false,
+      PayloadFormat format = PayloadFormat::Int16);
+
+   /**
+    * @brief Encode a single Signal Data packet into a caller's buffer.
+    *
+    * Same packet as encode(), written to @p out without allocating.
+    *
+    * @param out [out] Destination; needs encodedSize() bytes
+    * @param streamId Stream identifier
+    * @param samples I/Q samples to encode
+    * @param packetCount 4-bit sequence counter (0-15)
+    * @param order Byte order for serialization
+    * @param scaleFactor Multiplication factor for float-to-int16 conversion
+    * @param tsiType Integer timestamp type (default: None)
+    * @param tsfType Fractional timestamp type (default: None)
+    * @param intTimestamp Integer timestamp value (used if tsiType != None)
+    * @param fracTimestamp Fractional timestamp value (used if tsfType != None)
+    * @param includeTrailer Whether to include a trailer word
+    * @param format Sample format of the payload
+    * @return Bytes written, or 0 if samples exceed max or @p out is too small
+    */
+   [[nodiscard]] static size_t encodeInto(
+      std::span<uint8_t> out,
+      uint32_t streamId,
+      std::span<const IQSample> samples,
       uint8_t packetCount,
       ByteOrder order,
       float scaleFactor,
@@ -75,22 +135,45 @@ public:
       TSF tsfType = TSF::None,
       uint32_t intTimestamp = 0,
       uint64_t fracTimestamp = 0,
-      bool includeTrailer = false);
+      bool includeTrailer = false,
+      PayloadFormat format = PayloadFormat::Int16);
+
+   /**
+    * @brief Size in bytes of an encoded packet carrying @p sampleCount samples.
+    *
+    * @param sampleCount Number of I/Q samples
+    * @param tsiType Integer timestamp type
+    * @param tsfType Fractional timestamp type
+    * @param includeTrailer Whether trailer is included
+    * @param format Sample format of the payload
+    * @return Packet size, or 0 if the samples do not fit in one packet
+    */
+   [[nodiscard]] static size_t encodedSize(
+      size_t sampleCount,
+      TSI tsiType = TSI::None,
+      TSF tsfType = TSF::None,
+      bool includeTrailer = false,
+      PayloadFormat format = PayloadFormat::Int16);
 
    /**
     * @brief Calculate the maximum number of I/Q samples that fit in one packet.
     *
+    * Always whole payload words, so a full packet needs no pad bits; room
+    * for the Class ID is kept wherever a shorter packet might need it.
+    *
     * @param tsiType Integer timestamp type
     * @param tsfType Fractional timestamp type
     * @param classIdPresent Whether Class ID is included
     * @param includeTrailer Whether trailer is included
+    * @param format Sample format of the payload
     * @return Maximum sample count
     */
    [[nodiscard]] static size_t maxSamplesPerPacket(
       TSI tsiType = TSI::None,
       TSF tsfType = TSF::None,
       bool classIdPresent = false,
-      bool includeTrailer = false);
+      bool includeTrailer = false,
+      PayloadFormat format = PayloadFormat::Int16);
 };
 
 } // namespace Vita49_2
@@ -1,12 +1,96 @@
 #include "Vita49Codec.h"
+#include "ByteSwap.h"
 #include "ContextPacket.h"
+#include "SignalDataDecoder.h"
 #include "SignalDataPacket.h"
 
 #include <algorithm>
+#include <cmath>
+#include <utility>
 
 namespace Vita49_2
 {
 
+namespace
+{
+
+constexpr uint64_t PICOSECONDS_PER_SECOND = 1'000'000'000'000ULL;
+
+// Payload formats announced by context packets, per stream
+using AnnouncedFormats = std::vector<std::pair<uint32_t, PayloadFormat>>;
+
+uint32_t readWord(const uint8_t* p, ByteOrder order)
+{
+   return (order == ByteOrder::BigEndian) ? readU32BE(p) : readU32LE(p);
+}
+
+// Format of the data packet at `data`: announced for its stream, or `fallback`
+PayloadFormat formatFor(const AnnouncedFormats& announced, const uint8_t* data, size_t length,
+                        ByteOrder order, PayloadFormat fallback)
+{
+   if (announced.empty() || length < 8 ||
+       !hasStreamId(static_cast<PacketType>((readWord(data, order) >> 28) & 0xFu)))
+   {
+      return fallback;
+   }
+   const uint32_t streamId = readWord(data + 4, order);
+   const auto it = std::find_if(announced.begin(), announced.end(),
+                                [streamId](const auto& entry) { return entry.first == streamId; });
+   return (it != announced.end()) ? it->second : fallback;
+}
+
+// ParsedPacket of a decoded signal data packet
+std::optional<ParsedPacket> signalDataPacket(std::optional<SignalDataPacket::DecodeResult> decoded)
+{
+   if (!decoded.has_value())
+   {
+      return std::nullopt;
+   }
+
+   ParsedPacket result;
+   result.type    = ParsedPacket::Type::SignalData;
+   result.header  = decoded->header;
+   result.samples = std::move(decoded->samples);
+   return result;
+}
+
+// Samples per packet of a stream: its limit, capped at what fits
+size_t samplesPerPacket(const SignalDataStream& stream, PayloadFormat format)
+{
+   const size_t fits = SignalDataPacket::maxSamplesPerPacket(
+      stream.tsiType, stream.tsfType, false, stream.includeTrailer, format);
+   return (stream.maxSamplesPerPacket == 0) ? fits : std::min(stream.maxSamplesPerPacket, fits);
+}
+
+// Timestamps of the sample `offset` samples after the stream's next packet
+void timestampsAt(const SignalDataStream& stream, size_t offset,
+                  uint32_t& intTimestamp, uint64_t& fracTimestamp)
+{
+   uint32_t seconds   = stream.intTimestamp;
+   uint64_t fraction  = stream.fracTimestamp;
+
+   if (stream.tsfType == TSF::SampleCount)
+   {
+      fraction += offset;
+   }
+   else if (stream.tsfType == TSF::RealTime && stream.sampleRateHz > 0.0)
+   {
+      // Measured from the stream position rather than summed per packet,
+      // so rounding to whole picoseconds does not accumulate
+      const long double elapsed = static_cast<long double>(offset) *
+                                  static_cast<long double>(PICOSECONDS_PER_SECOND) /
+                                  static_cast<long double>(stream.sampleRateHz);
+      const uint64_t picoseconds = fraction + static_cast<uint64_t>(std::llround(elapsed));
+      seconds  += static_cast<uint32_t>(picoseconds / PICOSECONDS_PER_SECOND);
+      fraction  = picoseconds % PICOSECONDS_PER_SECOND;
+   }
+
+   intTimestamp  = seconds;
+   fracTimestamp = fraction;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // Constructor
 // ============================================================================
@@ -31,6 +115,8 @@ std::vector<ParsedPacket> Vita49Codec::parseStream(
       return results;
    }
 
+   AnnouncedFormats announced;
+   std::optional<SignalDataDecoder> decoder;   // Layout of the last data packet
    size_t offset = 0;
    while (offset < length)
    {
@@ -41,12 +127,36 @@ std::vector<ParsedPacket> Vita49Codec::parseStream(
       }
 
       size_t consumed = 0;
-      auto packet = parsePacket(data + offset, remaining, consumed);
+      const PayloadFormat format =
+         formatFor(announced, data + offset, remaining, _byteOrder, _payloadFormat);
+      std::optional<ParsedPacket> packet;
+      if (decoder.has_value() && decoder->matches(data + offset, remaining))
+      {
+         packet = signalDataPacket(
+            decoder->decode(data + offset, remaining, _scaleFactor, consumed, format));
+      }
+      else
+      {
+         packet = parsePacket(data + offset, remaining, consumed, format);
+         if (packet.has_value() && packet->type == ParsedPacket::Type::SignalData)
+         {
+            decoder = SignalDataDecoder::select(data + offset, remaining, _byteOrder);
+         }
+      }
       if (!packet.has_value() || consumed == 0)
       {
          break;   // Parse error or zero progress
       }
 
+      const auto& fields = packet->contextFields;
+      if (packet->type == ParsedPacket::Type::Context && fields.payloadFormat.has_value() &&
+          packet->header.streamId.has_value())
+      {
+         const uint32_t streamId = packet->header.streamId.value();
+         std::erase_if(announced, [streamId](const auto& entry) { return entry.first == streamId; });
+         announced.emplace_back(streamId, fields.payloadFormat.value());
+      }
+
       results.push_back(std::move(packet.value()));
       offset += consumed;
    }
@@ -57,6 +167,13 @@ std::vector<ParsedPacket> Vita49Codec::parseStream(
 std::optional<ParsedPacket> Vita49Codec::parsePacket(
    const uint8_t* data, size_t length,
    size_t& bytesConsumed) const
+{
+   return parsePacket(data, length, bytesConsumed, _payloadFormat);
+}
+
+std::optional<ParsedPacket> Vita49Codec::parsePacket(
+   const uint8_t* data, size_t length,
+   size_t& bytesConsumed, PayloadFormat format) const
 {
    if (data == nullptr || length < 4)
    {
@@ -64,41 +181,19 @@ std::optional<ParsedPacket> Vita49Codec::parsePacket(
    }
 
    // Peek at packet type from word 0
-   uint32_t word0;
-   if (_byteOrder == ByteOrder::BigEndian)
-   {
-      word0 = (static_cast<uint32_t>(data[0]) << 24) |
-              (static_cast<uint32_t>(data[1]) << 16) |
-              (static_cast<uint32_t>(data[2]) << 8)  |
-               static_cast<uint32_t>(data[3]);
-   }
-   else
-   {
-      word0 =  static_cast<uint32_t>(data[0])        |
-              (static_cast<uint32_t>(data[1]) << 8)  |
-              (static_cast<uint32_t>(data[2]) << 16) |
-              (static_cast<uint32_t>(data[3]) << 24);
-   }
+   const uint32_t word0 = readWord(data, _byteOrder);
 
    auto packetType = static_cast<PacketType>((word0 >> 28) & 0xFu);
 
-   ParsedPacket result;
-
    if (isDataPacket(packetType))
    {
-      auto decoded = SignalDataPacket::decode(
-         data, length, _byteOrder, _scaleFactor, bytesConsumed);
+      return signalDataPacket(SignalDataPacket::decode(
+         data, length, _byteOrder, _scaleFactor, bytesConsumed, format));
+   }
 
-      if (!decoded.has_value())
-      {
-         return std::nullopt;
-      }
+   ParsedPacket result;
 
-      result.type    = ParsedPacket::Type::SignalData;
-      result.header  = decoded->header;
-      result.samples = std::move(decoded->samples);
-   }
-   else if (isContextPacket(packetType))
+   if (isContextPacket(packetType))
    {
       auto decoded = ContextPacket::decode(
          data, length, _byteOrder, bytesConsumed);
@@ -129,6 +224,21 @@ std::optional<ParsedPacket> Vita49Codec::parsePacket(
    return result;
 }
 
+PacketStreamView Vita49Codec::viewStream(const uint8_t* data, size_t length) const
+{
+   if (data == nullptr)
+   {
+      return PacketStreamView({}, _byteOrder, _payloadFormat);
+   }
+   return PacketStreamView(std::span<const uint8_t>(data, length), _byteOrder, _payloadFormat);
+}
+
+size_t Vita49Codec::decodeSamples(const PacketView& packet, std::span<IQSample> out,
+                                  size_t firstSample) const
+{
+   return packet.decodeSamples(out, _scaleFactor, firstSample);
+}
+
 // ============================================================================
 // Encoding
 // ============================================================================
@@ -143,51 +253,107 @@ std::vector<uint8_t> Vita49Codec::encodeSignalData(
    uint64_t fracTimestamp,
    bool includeTrailer) const
 {
-   const size_t maxPerPacket = SignalDataPacket::maxSamplesPerPacket(
-      tsiType, tsfType, false, includeTrailer);
+   // Handle the empty-samples case: produce one packet with no payload
+   if (samples.empty())
+   {
+      return SignalDataPacket::encode(
+         streamId, samples, startPacketCount, _byteOrder, _scaleFactor,
+         tsiType, tsfType, intTimestamp, fracTimestamp, includeTrailer, _payloadFormat);
+   }
+
+   SignalDataStream stream;
+   stream.streamId       = streamId;
+   stream.tsiType        = tsiType;
+   stream.tsfType        = tsfType;
+   stream.includeTrailer = includeTrailer;
 
+   const size_t maxPerPacket = samplesPerPacket(stream, _payloadFormat);
    if (maxPerPacket == 0)
    {
       return {};
    }
 
-   std::vector<uint8_t> result;
+   // Every packet carries the caller's timestamps, as it always has
+   std::vector<uint8_t> result(packetizedSize(stream, samples.size()));
 
-   size_t offset      = 0;
-   uint8_t pktCount   = startPacketCount;
+   const std::span<const IQSample> all(samples);
+   size_t written    = 0;
+   uint8_t pktCount  = startPacketCount;
 
-   while (offset < samples.size())
+   for (size_t offset = 0; offset < all.size(); offset += maxPerPacket)
    {
-      const size_t count = std::min(maxPerPacket, samples.size() - offset);
+      const size_t count = std::min(maxPerPacket, all.size() - offset);
 
-      const IQSamples chunk(
-         samples.begin() + static_cast<ptrdiff_t>(offset),
-         samples.begin() + static_cast<ptrdiff_t>(offset + count));
+      written += SignalDataPacket::encodeInto(
+         std::span<uint8_t>(result).subspan(written), streamId, all.subspan(offset, count),
+         pktCount, _byteOrder, _scaleFactor,
+         tsiType, tsfType, intTimestamp, fracTimestamp, includeTrailer, _payloadFormat);
+      pktCount = static_cast<uint8_t>((pktCount + 1) & 0xF);
+   }
 
-      auto packet = SignalDataPacket::encode(
-         streamId, chunk, pktCount, _byteOrder, _scaleFactor,
-         tsiType, tsfType, intTimestamp, fracTimestamp, includeTrailer);
+   return result;
+}
 
-      if (packet.empty())
-      {
-         break;
-      }
+size_t Vita49Codec::packetizedSize(const SignalDataStream& stream, size_t sampleCount) const
+{
+   const size_t perPacket = samplesPerPacket(stream, _payloadFormat);
+   if (perPacket == 0 || sampleCount == 0)
+   {
+      return 0;
+   }
 
-      result.insert(result.end(), packet.begin(), packet.end());
-      offset   += count;
-      pktCount  = (pktCount + 1) & 0xF;
+   const size_t fullPackets = sampleCount / perPacket;
+   const size_t rest        = sampleCount % perPacket;
+   const auto size = [this, &stream](size_t count)
+   {
+      return SignalDataPacket::encodedSize(count, stream.tsiType, stream.tsfType,
+                                           stream.includeTrailer, _payloadFormat);
+   };
+
+   return (fullPackets * size(perPacket)) + ((rest != 0) ? size(rest) : 0);
+}
+
+size_t Vita49Codec::packetizeSignalData(SignalDataStream& stream,
+                                        std::span<const IQSample> samples,
+                                        std::span<uint8_t> out) const
+{
+   const size_t total = packetizedSize(stream, samples.size());
+   if (total == 0 || out.size() < total)
+   {
+      return 0;
    }
 
-   // Handle the empty-samples case: produce one packet with no payload
-   if (samples.empty())
+   const size_t perPacket = samplesPerPacket(stream, _payloadFormat);
+   size_t written         = 0;
+   uint8_t pktCount       = stream.packetCount;
+
+   for (size_t offset = 0; offset < samples.size(); offset += perPacket)
    {
-      auto packet = SignalDataPacket::encode(
-         streamId, samples, startPacketCount, _byteOrder, _scaleFactor,
-         tsiType, tsfType, intTimestamp, fracTimestamp, includeTrailer);
-      return packet;
+      const size_t count = std::min(perPacket, samples.size() - offset);
+
+      uint32_t intTimestamp  = 0;
+      uint64_t fracTimestamp = 0;
+      timestampsAt(stream, offset, intTimestamp, fracTimestamp);
+
+      written += SignalDataPacket::encodeInto(
+         out.subspan(written), stream.streamId, samples.subspan(offset, count),
+         pktCount, _byteOrder, _scaleFactor, stream.tsiType, stream.tsfType,
+         intTimestamp, fracTimestamp, stream.includeTrailer, _payloadFormat);
+      pktCount = static_cast<uint8_t>((pktCount + 1) & 0xF);
    }
 
-   return result;
+   stream.packetCount = pktCount;
+   timestampsAt(stream, samples.size(), stream.intTimestamp, stream.fracTimestamp);
+   return written;
+}
+
+size_t Vita49Codec::packetizeSignalData(SignalDataStream& stream,
+                                        std::span<const IQSample> samples,
+                                        std::vector<uint8_t>& out) const
+{
+   const size_t start = out.size();
+   out.resize(start + packetizedSize(stream, samples.size()));
+   return packetizeSignalData(stream, samples, std::span<uint8_t>(out).subspan(start));
 }
 
 std::vector<uint8_t> Vita49Codec::encodeContext(
@@ -228,4 +394,14 @@ float Vita49Codec::scaleFactor() const
    return _scaleFactor;
 }
 
+void Vita49Codec::setPayloadFormat(PayloadFormat format)
+{
+   _payloadFormat = format;
+}
+
+PayloadFormat Vita49Codec::payloadFormat() const
+{
+   return _payloadFormat;
+}
+
 } // namespace Vita49_2
@@ -1,11 +1,13 @@
 #ifndef VITA49CODEC_H_
 #define VITA49CODEC_H_
 
+#include "PacketView.h"
 #include "Vita49Types.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace Vita49_2
@@ -31,15 +33,38 @@ struct ParsedPacket
    ContextFields contextFields;    ///< Populated for Context packets
 };
 
+/**
+ * @class SignalDataStream
+ * @brief State of an outgoing signal data stream, for Vita49Codec::packetizeSignalData().
+ *
+ * packetCount and the timestamps describe the next packet to be written
+ * and are advanced by every packetizeSignalData() call, so a long capture
+ * can be packetized block by block with a continuous sequence.
+ */
+struct SignalDataStream
+{
+   uint32_t streamId{0};              ///< Stream identifier
+   uint8_t packetCount{0};            ///< 4-bit counter of the next packet
+   TSI tsiType{TSI::None};            ///< Integer timestamp type
+   TSF tsfType{TSF::None};            ///< Fractional timestamp type
+   uint32_t intTimestamp{0};          ///< Integer timestamp of the next packet
+   uint64_t fracTimestamp{0};         ///< Fractional timestamp of the next packet
+   double sampleRateHz{0.0};          ///< Advances TSF::RealTime stamps (0 leaves them)
+   size_t maxSamplesPerPacket{0};     ///< Packet size limit (0: as many as fit)
+   bool includeTrailer{false};        ///< Whether packets carry a trailer word
+};
+
 /**
  * @class Vita49Codec
  * @brief High-level VITA 49.2 codec for encoding and decoding packet streams.
  *
  * This class wraps SignalDataPacket and ContextPacket to provide
  * convenient stream-oriented encoding/decoding. It handles:
- *   - Concatenated packet streams (multiple packets in one buffer)
- *   - Automatic packet splitting for large sample vectors
- *   - Configurable byte order and scale factor
+ *   - Concatenated packet streams (multiple packets in one buffer),
+ *     decoded eagerly (parseStream) or viewed in place (viewStream)
+ *   - Automatic packet splitting for large sample vectors, into a new
+ *     vector (encodeSignalData) or a caller's buffer (packetizeSignalData)
+ *   - Configurable byte order, scale factor and payload format
  *
  * @note This is a pure codec — no networking. Pass raw byte buffers
  *       from HighBandwidthSubscriber / HighBandwidthPublisher.
@@ -64,7 +89,9 @@ public:
     * @brief Parse a stream of concatenated VITA 49.2 packets.
     *
     * Iterates through the buffer, decoding packets one at a time
-    * until the buffer is exhausted or a parse error occurs.
+    * until the buffer is exhausted or a parse error occurs.  Signal data
+    * is decoded in the codec's payload format, or in the one the last
+    * context packet of its stream in the buffer announced.
     *
     * @param data Pointer to the raw byte buffer
     * @param length Length of the buffer in bytes
@@ -76,6 +103,8 @@ public:
    /**
     * @brief Parse a single VITA 49.2 packet from the buffer.
     *
+    * Signal data is decoded in the codec's payload format.
+    *
     * @param data Pointer to the start of the packet
     * @param length Available bytes in the buffer
     * @param bytesConsumed [out] Number of bytes consumed
@@ -85,6 +114,31 @@ public:
       const uint8_t* data, size_t length,
       size_t& bytesConsumed) const;
 
+   /**
+    * @brief View a stream of concatenated packets without decoding them.
+    *
+    * Headers are parsed as the range is iterated; payloads stay in
+    * @p data.  Use this when most packets only need their header.
+    *
+    * @param data Pointer to the raw byte buffer (must outlive the views)
+    * @param length Length of the buffer in bytes
+    * @return Range of PacketViews in the codec's byte order and payload format
+    */
+   [[nodiscard]] PacketStreamView viewStream(const uint8_t* data, size_t length) const;
+
+   /**
+    * @brief Convert a viewed packet's samples with the codec's scale factor.
+    *
+    * The packet's own payload format applies (see PacketView::payloadFormat()).
+    *
+    * @param packet Signal data packet from viewStream() or PacketView::parse()
+    * @param out Destination; up to out.size() samples are written
+    * @param firstSample Index of the first sample to convert
+    * @return Number of samples written
+    */
+   size_t decodeSamples(const PacketView& packet, std::span<IQSample> out,
+                        size_t firstSample = 0) const;
+
    // ========================================================================
    // Encoding
    // ========================================================================
@@ -116,6 +170,53 @@ public:
       uint64_t fracTimestamp = 0,
       bool includeTrailer = false) const;
 
+   /**
+    * @brief Bytes packetizeSignalData() writes for @p sampleCount samples.
+    *
+    * @param stream Stream whose packet layout to use
+    * @param sampleCount Number of I/Q samples
+    * @return Total size of the packets (0 for no samples)
+    */
+   [[nodiscard]] size_t packetizedSize(const SignalDataStream& stream,
+                                       size_t sampleCount) const;
+
+   /**
+    * @brief Split I/Q samples into Signal Data packets written back to back.
+    *
+    * Packets carry stream.maxSamplesPerPacket samples (the last one the
+    * rest), incrementing packet counts from stream.packetCount and
+    * timestamps from stream.intTimestamp / fracTimestamp: TSF::SampleCount
+    * stamps advance by the samples before each packet, TSF::RealTime
+    * stamps by the time they span at stream.sampleRateHz, carrying whole
+    * seconds into the integer timestamp.  On success @p stream is advanced
+    * past the samples.  Nothing is allocated, so the result can go to a
+    * single write()/writev() and PacketStreamView finds the packet
+    * boundaries for sendmmsg().
+    *
+    * @param stream [in,out] Stream state; advanced on success
+    * @param samples I/Q samples to encode (none: no packets)
+    * @param out [out] Destination; needs packetizedSize() bytes
+    * @return Bytes written, or 0 if @p out is too small (nothing written)
+    */
+   size_t packetizeSignalData(SignalDataStream& stream,
+                              std::span<const IQSample> samples,
+                              std::span<uint8_t> out) const;
+
+   /**
+    * @brief packetizeSignalData() appending to a vector.
+    *
+    * The vector grows only when its capacity is exceeded, so reusing one
+    * buffer per stream makes packetization allocation-free once warm.
+    *
+    * @param stream [in,out] Stream state; advanced past the samples
+    * @param samples I/Q samples to encode
+    * @param out [out] Packets are appended to this vector
+    * @return Bytes appended
+    */
+   size_t packetizeSignalData(SignalDataStream& stream,
+                              std::span<const IQSample> samples,
+                              std::vector<uint8_t>& out) const;
+
    /**
     * @brief Encode a Context packet.
     *
@@ -147,9 +248,22 @@ public:
    void setScaleFactor(float factor);
    [[nodiscard]] float scaleFactor() const;
 
+   /**
+    * @brief Sample format of encoded signal data, and of decoded signal
+    *        data whose stream has not announced one.
+    */
+   void setPayloadFormat(PayloadFormat format);
+   [[nodiscard]] PayloadFormat payloadFormat() const;
+
 private:
+   // parsePacket() decoding signal data in a given format
+   [[nodiscard]] std::optional<ParsedPacket> parsePacket(
+      const uint8_t* data, size_t length,
+      size_t& bytesConsumed, PayloadFormat format) const;
+
    ByteOrder _byteOrder;
    float _scaleFactor;
+   PayloadFormat _payloadFormat{PayloadFormat::Int16};
 };
 
 } // namespace Vita49_2
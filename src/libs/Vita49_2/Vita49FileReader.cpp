@@ -0,0 +1,476 @@
+#include "Vita49FileReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace Vita49_2
+{
+
+namespace
+{
+
+// Window handed to madvise(MADV_WILLNEED) ahead of the read cursor
+constexpr size_t READ_AHEAD_BYTES = 8 * 1024 * 1024;
+
+constexpr char SIDECAR_MAGIC[8] = {'V', '4', '9', 'I', 'D', 'X', '1', '\0'};
+
+// Start of a sidecar file, followed by `entries` PacketIndexEntry records.
+// Host byte order: the sidecar is a cache next to the recording, not an
+// interchange format, and is rebuilt whenever anything does not match.
+struct SidecarHeader
+{
+   char magic[8]{};
+   uint32_t entryBytes{0};
+   uint32_t byteOrder{0};
+   uint64_t fileBytes{0};
+   int64_t modifiedNs{0};
+   uint64_t indexedBytes{0};
+   uint64_t entries{0};
+};
+
+static_assert(sizeof(PacketIndexEntry) == 32, "index entries are stored as 32-byte records");
+static_assert(std::is_trivially_copyable_v<PacketIndexEntry>);
+static_assert(std::is_trivially_copyable_v<SidecarHeader>);
+
+// Ordering of timestamped packets: integer seconds, then fraction
+bool before(const PacketIndexEntry& entry, uint32_t integerTimestamp, uint64_t fractionalTimestamp)
+{
+   return (entry.integerTimestamp != integerTimestamp)
+      ? entry.integerTimestamp < integerTimestamp
+      : entry.fractionalTimestamp < fractionalTimestamp;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Constructor / Destructor
+// ============================================================================
+
+Vita49FileReader::Vita49FileReader(ByteOrder order)
+   : _order(order)
+{
+}
+
+Vita49FileReader::~Vita49FileReader()
+{
+   close();
+}
+
+// ============================================================================
+// open / close
+// ============================================================================
+
+bool Vita49FileReader::open(const std::string& path, bool useSidecar)
+{
+   close();
+   _error.clear();
+
+   _fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+   if (_fd < 0)
+   {
+      _error = "cannot open '" + path + "': " + std::strerror(errno);
+      return false;
+   }
+
+   struct stat info{};
+   if (::fstat(_fd, &info) != 0 || info.st_size <= 0)
+   {
+      _error = "'" + path + "' is empty or unreadable";
+      close();
+      return false;
+   }
+   _fileBytes    = static_cast<uint64_t>(info.st_size);
+   _modifiedNs   = (static_cast<int64_t>(info.st_mtim.tv_sec) * 1'000'000'000) + info.st_mtim.tv_nsec;
+   _mappingBytes = static_cast<size_t>(info.st_size);
+
+   void* mapped = ::mmap(nullptr, _mappingBytes, PROT_READ, MAP_PRIVATE, _fd, 0);
+   if (mapped == MAP_FAILED)
+   {
+      _error = "mmap of '" + path + "' failed: " + std::strerror(errno);
+      _mappingBytes = 0;
+      close();
+      return false;
+   }
+   _mapping = static_cast<const uint8_t*>(mapped);
+   // Both the index scan and playback run front to back
+   ::madvise(mapped, _mappingBytes, MADV_SEQUENTIAL);
+
+   const std::string sidecar = sidecarPath(path);
+   _indexFromSidecar = useSidecar && loadSidecar(sidecar);
+   if (!_indexFromSidecar)
+   {
+      buildIndex();
+      if (useSidecar && !_index.empty())
+      {
+         saveSidecar(sidecar);
+      }
+   }
+
+   if (_index.empty())
+   {
+      _error = "'" + path + "' holds no VITA 49 packets";
+      close();
+      return false;
+   }
+
+   _timed.clear();
+   for (size_t i = 0; i < _index.size(); ++i)
+   {
+      if (_index[i].hasTimestamp())
+      {
+         _timed.push_back(i);
+      }
+   }
+   return true;
+}
+
+void Vita49FileReader::close()
+{
+   if (_mapping != nullptr)
+   {
+      // munmap() takes a mutable pointer; the mapping itself stays read-only.
+      ::munmap(const_cast<uint8_t*>(_mapping), _mappingBytes);
+      _mapping = nullptr;
+   }
+   if (_fd >= 0)
+   {
+      ::close(_fd);
+      _fd = -1;
+   }
+   _mappingBytes = 0;
+   _fileBytes    = 0;
+   _modifiedNs   = 0;
+   _index.clear();
+   _timed.clear();
+   _indexedBytes     = 0;
+   _indexFromSidecar = false;
+   _cursor           = 0;
+   _readAheadEnd     = 0;
+}
+
+std::string Vita49FileReader::sidecarPath(const std::string& path)
+{
+   return path + ".v49idx";
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+void Vita49FileReader::buildIndex()
+{
+   _index.clear();
+   _indexedBytes = 0;
+
+   // Payload formats announced by context packets so far, per stream
+   std::unordered_map<uint32_t, PayloadFormat> formats;
+
+   const PacketStreamView stream({_mapping, _mappingBytes}, _order);
+   for (auto packet = stream.begin(); packet != stream.end(); ++packet)
+   {
+      const PacketHeader& header = packet->header();
+
+      PacketView current = *packet;
+      if (current.isContext() && header.streamId.has_value())
+      {
+         const auto fields = current.contextFields();
+         if (fields.has_value() && fields->payloadFormat.has_value())
+         {
+            formats[*header.streamId] = *fields->payloadFormat;
+         }
+      }
+      else if (current.isSignalData() && header.streamId.has_value())
+      {
+         const auto format = formats.find(*header.streamId);
+         if (format != formats.end())
+         {
+            current.setPayloadFormat(format->second);
+         }
+      }
+
+      PacketIndexEntry entry;
+      entry.offset      = packet.offset();
+      entry.sampleCount = static_cast<uint32_t>(current.sampleCount());
+      entry.packetWords = header.packetSize;
+      entry.packetType  = header.packetType;
+      entry.flags       = static_cast<uint8_t>(static_cast<uint8_t>(current.payloadFormat())
+                                               << PacketIndexEntry::FORMAT_SHIFT);
+      if (header.streamId.has_value())
+      {
+         entry.streamId = *header.streamId;
+         entry.flags   |= PacketIndexEntry::HAS_STREAM_ID;
+      }
+      if (header.tsiType != TSI::None || header.tsfType != TSF::None)
+      {
+         entry.integerTimestamp    = header.integerTimestamp.value_or(0);
+         entry.fractionalTimestamp = header.fractionalTimestamp.value_or(0);
+         entry.flags              |= PacketIndexEntry::HAS_TIMESTAMP;
+      }
+      _index.push_back(entry);
+
+      _indexedBytes = packet.offset() + packet->bytes().size();
+   }
+}
+
+bool Vita49FileReader::loadSidecar(const std::string& path)
+{
+   std::ifstream file(path, std::ios::binary);
+   if (!file.is_open())
+   {
+      return false;
+   }
+
+   SidecarHeader header;
+   file.read(reinterpret_cast<char*>(&header), sizeof(header));
+   if (!file ||
+       std::memcmp(header.magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC)) != 0 ||
+       header.entryBytes != sizeof(PacketIndexEntry) ||
+       header.byteOrder != static_cast<uint32_t>(_order) ||
+       header.fileBytes != _fileBytes ||
+       header.modifiedNs != _modifiedNs ||
+       header.indexedBytes > _fileBytes ||
+       header.entries > _fileBytes / 4)
+   {
+      return false;
+   }
+
+   _index.resize(static_cast<size_t>(header.entries));
+   file.read(reinterpret_cast<char*>(_index.data()),
+             static_cast<std::streamsize>(_index.size() * sizeof(PacketIndexEntry)));
+   const bool inBounds = std::all_of(_index.begin(), _index.end(),
+      [&header](const PacketIndexEntry& entry)
+      {
+         return entry.packetWords != 0 && entry.offset + entry.bytes() <= header.indexedBytes;
+      });
+   if (!file || !inBounds)
+   {
+      _index.clear();
+      return false;
+   }
+   _indexedBytes = static_cast<size_t>(header.indexedBytes);
+   return true;
+}
+
+void Vita49FileReader::saveSidecar(const std::string& path) const
+{
+   SidecarHeader header;
+   std::memcpy(header.magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+   header.entryBytes   = sizeof(PacketIndexEntry);
+   header.byteOrder    = static_cast<uint32_t>(_order);
+   header.fileBytes    = _fileBytes;
+   header.modifiedNs   = _modifiedNs;
+   header.indexedBytes = _indexedBytes;
+   header.entries      = _index.size();
+
+   // Written aside and renamed, so a reader never sees a half-written index.
+   // A read-only directory just means the next open scans again.
+   const std::string partial = path + ".tmp";
+   {
+      std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+      if (!file.is_open())
+      {
+         return;
+      }
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char*>(_index.data()),
+                 static_cast<std::streamsize>(_index.size() * sizeof(PacketIndexEntry)));
+      if (!file.good())
+      {
+         file.close();
+         std::remove(partial.c_str());
+         return;
+      }
+   }
+   if (std::rename(partial.c_str(), path.c_str()) != 0)
+   {
+      std::remove(partial.c_str());
+   }
+}
+
+std::optional<PacketView> Vita49FileReader::packet(size_t packetIndex) const
+{
+   if (packetIndex >= _index.size())
+   {
+      return std::nullopt;
+   }
+   return view(_index[packetIndex]);
+}
+
+std::optional<PacketView> Vita49FileReader::view(const PacketIndexEntry& entry) const
+{
+   return PacketView::parse({_mapping + entry.offset, entry.bytes()}, _order,
+                            entry.payloadFormat());
+}
+
+size_t Vita49FileReader::findTime(uint32_t integerTimestamp, uint64_t fractionalTimestamp,
+                                  std::optional<uint32_t> streamId) const
+{
+   auto it = std::lower_bound(_timed.begin(), _timed.end(), 0,
+      [&](size_t position, int)
+      {
+         return before(_index[position], integerTimestamp, fractionalTimestamp);
+      });
+
+   // Packets of other streams between here and the wanted one are stepped over
+   for (; it != _timed.end(); ++it)
+   {
+      const PacketIndexEntry& entry = _index[*it];
+      if (!streamId.has_value() || (entry.hasStreamId() && entry.streamId == *streamId))
+      {
+         return *it;
+      }
+   }
+   return _index.size();
+}
+
+// ============================================================================
+// Bulk decoding
+// ============================================================================
+
+uint64_t Vita49FileReader::sampleCount(size_t firstPacket, size_t packetCount) const
+{
+   const size_t first = std::min(firstPacket, _index.size());
+   const size_t end   = first + std::min(packetCount, _index.size() - first);
+
+   uint64_t samples = 0;
+   for (size_t i = first; i < end; ++i)
+   {
+      samples += _index[i].sampleCount;
+   }
+   return samples;
+}
+
+size_t Vita49FileReader::decodeSamples(size_t firstPacket, size_t packetCount,
+                                       std::span<IQSample> out, float scaleFactor,
+                                       const ParallelFor& parallelFor) const
+{
+   const size_t first = std::min(firstPacket, _index.size());
+   const size_t end   = first + std::min(packetCount, _index.size() - first);
+
+   // Cut the range into tasks of whole packets, each knowing where its
+   // samples go
+   struct Task
+   {
+      size_t firstPacket;
+      size_t endPacket;
+      size_t outOffset;
+   };
+   std::vector<Task> tasks;
+   size_t total = 0;
+   size_t taskSamples = 0;
+   for (size_t i = first; i < end; ++i)
+   {
+      if (tasks.empty() || taskSamples >= DECODE_CHUNK_SAMPLES)
+      {
+         tasks.push_back(Task{i, i, total});
+         taskSamples = 0;
+      }
+      tasks.back().endPacket = i + 1;
+      taskSamples += _index[i].sampleCount;
+      total       += _index[i].sampleCount;
+   }
+   if (total == 0 || out.size() < total)
+   {
+      return 0;
+   }
+
+   const auto decodeTask = [&](size_t t)
+   {
+      size_t offset = tasks[t].outOffset;
+      for (size_t i = tasks[t].firstPacket; i < tasks[t].endPacket; ++i)
+      {
+         const PacketIndexEntry& entry = _index[i];
+         if (entry.sampleCount == 0)
+         {
+            continue;
+         }
+         const std::span<IQSample> dst = out.subspan(offset, entry.sampleCount);
+         const auto data = view(entry);
+         const size_t decoded = data.has_value() ? data->decodeSamples(dst, scaleFactor) : 0;
+         // Only a damaged sidecar could disagree with the packet; keep the layout
+         std::fill(dst.begin() + static_cast<ptrdiff_t>(decoded), dst.end(), IQSample{});
+         offset += entry.sampleCount;
+      }
+   };
+
+   if (parallelFor && tasks.size() > 1)
+   {
+      parallelFor(tasks.size(), decodeTask);
+   }
+   else
+   {
+      for (size_t t = 0; t < tasks.size(); ++t)
+      {
+         decodeTask(t);
+      }
+   }
+   return total;
+}
+
+// ============================================================================
+// Sequential reading
+// ============================================================================
+
+std::optional<PacketView> Vita49FileReader::next()
+{
+   if (_cursor >= _index.size())
+   {
+      return std::nullopt;
+   }
+   const PacketIndexEntry& entry = _index[_cursor++];
+
+   // Keep at least half a window requested ahead of what is being read
+   if (entry.offset + entry.bytes() + (READ_AHEAD_BYTES / 2) > _readAheadEnd)
+   {
+      readAhead(entry.offset);
+   }
+   return view(entry);
+}
+
+void Vita49FileReader::seek(size_t packetIndex)
+{
+   _cursor       = std::min(packetIndex, _index.size());
+   _readAheadEnd = 0;
+   if (_cursor < _index.size())
+   {
+      readAhead(_index[_cursor].offset);
+   }
+}
+
+bool Vita49FileReader::seekToTime(uint32_t integerTimestamp, uint64_t fractionalTimestamp,
+                                  std::optional<uint32_t> streamId)
+{
+   const size_t position = findTime(integerTimestamp, fractionalTimestamp, streamId);
+   if (position >= _index.size())
+   {
+      return false;
+   }
+   seek(position);
+   return true;
+}
+
+void Vita49FileReader::readAhead(size_t offset)
+{
+   static const auto pageBytes = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+   const size_t start = (offset / pageBytes) * pageBytes;
+   const size_t end   = std::min(_mappingBytes, offset + READ_AHEAD_BYTES);
+   if (start >= end)
+   {
+      return;
+   }
+   // The mapping is read-only; madvise() only takes a mutable pointer.
+   ::madvise(const_cast<uint8_t*>(_mapping + start), end - start, MADV_WILLNEED);
+   _readAheadEnd = end;
+}
+
+} // namespace Vita49_2
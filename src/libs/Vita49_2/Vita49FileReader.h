@@ -0,0 +1,241 @@
+#ifndef VITA49FILEREADER_H_
+#define VITA49FILEREADER_H_
+
+#include "PacketView.h"
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Vita49_2
+{
+
+/**
+ * @class PacketIndexEntry
+ * @brief Where one packet of a VITA 49 file is and what its header says.
+ *
+ * 32 bytes per packet, so the index of a multi-gigabyte recording fits
+ * comfortably in memory and in its sidecar file.
+ */
+struct PacketIndexEntry
+{
+   static constexpr uint8_t HAS_STREAM_ID = 0x1;
+   static constexpr uint8_t HAS_TIMESTAMP = 0x2;
+   static constexpr uint8_t FORMAT_SHIFT  = 2;      ///< PayloadFormat in flag bits 2-3
+   static constexpr uint8_t FORMAT_MASK   = 0xC;
+
+   uint64_t offset{0};                ///< Byte offset of the packet in the file
+   uint64_t fractionalTimestamp{0};   ///< TSF value (0 if absent)
+   uint32_t integerTimestamp{0};      ///< TSI value (0 if absent)
+   uint32_t streamId{0};              ///< Stream ID (0 if absent)
+   uint32_t sampleCount{0};           ///< I/Q pairs (signal data packets only)
+   uint16_t packetWords{0};           ///< Packet size in 32-bit words
+   PacketType packetType{PacketType::IFDataWithStreamId};
+   uint8_t flags{0};                  ///< HAS_STREAM_ID | HAS_TIMESTAMP | format
+
+   [[nodiscard]] bool hasStreamId() const { return (flags & HAS_STREAM_ID) != 0; }
+   [[nodiscard]] bool hasTimestamp() const { return (flags & HAS_TIMESTAMP) != 0; }
+   [[nodiscard]] size_t bytes() const { return static_cast<size_t>(packetWords) * 4; }
+
+   /** @brief Payload format of a signal data packet, as its stream's context announced. */
+   [[nodiscard]] PayloadFormat payloadFormat() const
+   {
+      return static_cast<PayloadFormat>((flags & FORMAT_MASK) >> FORMAT_SHIFT);
+   }
+};
+
+/**
+ * @class Vita49FileReader
+ * @brief Memory-mapped reader for VITA 49.2 recordings of any size.
+ *
+ * open() maps the file read-only and loads its packet index: from the
+ * sidecar file (`<path>.v49idx`) when it matches the recording's size and
+ * modification time, otherwise by scanning the packet headers once and
+ * writing a fresh sidecar, so every later open is immediate.  Nothing is
+ * read into memory up front; packets are PacketViews into the mapping.
+ *
+ * Sequential reading (next()) advises the kernel to read ahead of the
+ * cursor; seekToTime() finds a position by binary search of the index.
+ * The search assumes timestamps do not decrease through the file, as in
+ * any recording; packets without a timestamp are skipped by it.
+ * decodeSamples() converts whole packet ranges, split across a thread pool.
+ * Signal data is read in the payload format the last context packet of
+ * its stream announced (Int16 before any does).
+ *
+ * @note const members (index, packets, decodeSamples()) may be used from
+ *       several threads at once; the cursor belongs to one thread.
+ */
+class Vita49FileReader
+{
+public:
+   /// Runs task(0) .. task(count - 1), possibly concurrently, and returns
+   /// once all finished (e.g. CommonUtils::WorkerPool::run)
+   using ParallelFor = std::function<void(size_t count, const std::function<void(size_t)>& task)>;
+
+   /// Samples decoded per parallel task by decodeSamples()
+   static constexpr size_t DECODE_CHUNK_SAMPLES = 32 * 1024;
+
+   /**
+    * @param order Byte order of the recording (default: BigEndian per VITA standard)
+    */
+   explicit Vita49FileReader(ByteOrder order = ByteOrder::BigEndian);
+   ~Vita49FileReader();
+
+   Vita49FileReader(const Vita49FileReader&) = delete;
+   Vita49FileReader& operator=(const Vita49FileReader&) = delete;
+
+   /**
+    * @brief Map a recording and load or build its packet index.
+    *
+    * A trailing truncated or malformed packet ends the index; the bytes
+    * before it stay readable.
+    *
+    * @param path Recording to open
+    * @param useSidecar Load the index from, and save it to, `<path>.v49idx`
+    * @return false if the file cannot be mapped or holds no packets (see error())
+    */
+   [[nodiscard]] bool open(const std::string& path, bool useSidecar = true);
+
+   /** @brief Unmap the recording and drop its index. */
+   void close();
+
+   [[nodiscard]] bool isOpen() const { return _mapping != nullptr; }
+
+   /** @brief Why the last open() failed. */
+   [[nodiscard]] const std::string& error() const { return _error; }
+
+   /** @brief Whether the index came from the sidecar rather than a scan. */
+   [[nodiscard]] bool indexFromSidecar() const { return _indexFromSidecar; }
+
+   /** @brief Sidecar index file used for @p path. */
+   [[nodiscard]] static std::string sidecarPath(const std::string& path);
+
+   // ========================================================================
+   // Index
+   // ========================================================================
+
+   /** @brief Packets in the index, in file order. */
+   [[nodiscard]] std::span<const PacketIndexEntry> index() const { return _index; }
+
+   [[nodiscard]] size_t packetCount() const { return _index.size(); }
+
+   /** @brief Bytes covered by the index (less than the file if its end is damaged). */
+   [[nodiscard]] size_t indexedBytes() const { return _indexedBytes; }
+
+   /** @brief The whole mapped file. */
+   [[nodiscard]] std::span<const uint8_t> bytes() const { return {_mapping, _mappingBytes}; }
+
+   /**
+    * @brief View one packet.
+    * @param packetIndex Position in index()
+    * @return The packet, or std::nullopt if the index is out of range
+    */
+   [[nodiscard]] std::optional<PacketView> packet(size_t packetIndex) const;
+
+   /**
+    * @brief Index of the first timestamped packet at or after a time.
+    *
+    * @param integerTimestamp Target TSI value
+    * @param fractionalTimestamp Target TSF value
+    * @param streamId Only consider packets of this stream
+    * @return Position in index(), or packetCount() if no packet qualifies
+    */
+   [[nodiscard]] size_t findTime(uint32_t integerTimestamp, uint64_t fractionalTimestamp,
+                                 std::optional<uint32_t> streamId = std::nullopt) const;
+
+   // ========================================================================
+   // Bulk decoding
+   // ========================================================================
+
+   /**
+    * @brief I/Q samples carried by the signal data packets of an index range.
+    *
+    * @param firstPacket Position in index() of the first packet
+    * @param packetCount Number of packets (clamped to the end of the index)
+    * @return Sample count, from the index alone
+    */
+   [[nodiscard]] uint64_t sampleCount(size_t firstPacket, size_t packetCount) const;
+
+   /**
+    * @brief Decode the signal data packets of an index range into one array.
+    *
+    * Each packet's samples follow those of the packet before it (other
+    * packet types add none), at offsets known from the index, so the range
+    * is split into tasks of about DECODE_CHUNK_SAMPLES that decode straight
+    * into @p out independently.  With @p parallelFor they run on the
+    * caller's thread pool, otherwise one after another on this thread.
+    *
+    * @param firstPacket Position in index() of the first packet
+    * @param packetCount Number of packets (clamped to the end of the index)
+    * @param out Destination; must hold sampleCount(firstPacket, packetCount)
+    * @param scaleFactor Division factor for int16-to-float conversion
+    * @param parallelFor Runs the decode tasks (empty: inline)
+    * @return Samples written, or 0 if @p out is too small
+    */
+   size_t decodeSamples(size_t firstPacket, size_t packetCount, std::span<IQSample> out,
+                        float scaleFactor = DEFAULT_SCALE_FACTOR,
+                        const ParallelFor& parallelFor = {}) const;
+
+   // ========================================================================
+   // Sequential reading
+   // ========================================================================
+
+   /**
+    * @brief Read the packet at the cursor and advance it.
+    * @return The packet, or std::nullopt at the end of the index
+    */
+   [[nodiscard]] std::optional<PacketView> next();
+
+   /** @brief Move the cursor to a packet (clamped to the end). */
+   void seek(size_t packetIndex);
+
+   /**
+    * @brief Move the cursor to findTime().
+    * @return false (cursor unchanged) if no packet is at or after the time
+    */
+   bool seekToTime(uint32_t integerTimestamp, uint64_t fractionalTimestamp,
+                   std::optional<uint32_t> streamId = std::nullopt);
+
+   /** @brief Index of the packet next() returns. */
+   [[nodiscard]] size_t tell() const { return _cursor; }
+
+private:
+   // Scan the mapping's headers into _index.
+   void buildIndex();
+
+   // Load / store _index from / to the sidecar; false if it is missing or stale.
+   [[nodiscard]] bool loadSidecar(const std::string& path);
+   void saveSidecar(const std::string& path) const;
+
+   // Ask the kernel to read the window of the file ahead of `offset`.
+   void readAhead(size_t offset);
+
+   // View of an indexed packet, in its payload format.
+   [[nodiscard]] std::optional<PacketView> view(const PacketIndexEntry& entry) const;
+
+   ByteOrder _order;
+   std::string _error;
+
+   int _fd{-1};
+   const uint8_t* _mapping{nullptr};
+   size_t _mappingBytes{0};
+   uint64_t _fileBytes{0};
+   int64_t _modifiedNs{0};
+
+   std::vector<PacketIndexEntry> _index;
+   std::vector<size_t> _timed;    // Positions in _index of timestamped packets
+   size_t _indexedBytes{0};
+   bool _indexFromSidecar{false};
+
+   size_t _cursor{0};
+   size_t _readAheadEnd{0};       // End of the window last passed to madvise()
+};
+
+} // namespace Vita49_2
+
+#endif // VITA49FILEREADER_H_
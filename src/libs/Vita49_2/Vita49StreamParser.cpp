@@ -0,0 +1,156 @@
+#include "Vita49StreamParser.h"
+#include "ByteSwap.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Vita49_2
+{
+
+namespace
+{
+
+// Bytes taken from the stream before a header word can be checked
+constexpr size_t WORD_BYTES = 4;
+
+// Packet types 8-15 are reserved by VITA 49.2
+constexpr uint32_t LAST_PACKET_TYPE = 0x7;
+
+} // anonymous namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+Vita49StreamParser::Vita49StreamParser(PacketCallback callback, ByteOrder order,
+                                       size_t maxPacketBytes)
+   : _callback(std::move(callback))
+   , _order(order)
+   , _maxPacketBytes(std::min(maxPacketBytes, MAX_PACKET_SIZE_BYTES))
+{
+}
+
+// ============================================================================
+// feed
+// ============================================================================
+
+size_t Vita49StreamParser::feed(std::span<const uint8_t> chunk)
+{
+   const uint64_t packetsBefore = _packets;
+
+   // ---- Complete the packet carried over from the previous chunk ----
+   while (!_pending.empty())
+   {
+      if (_pending.size() < WORD_BYTES)
+      {
+         const size_t take = std::min(WORD_BYTES - _pending.size(), chunk.size());
+         _pending.insert(_pending.end(), chunk.begin(), chunk.begin() + static_cast<ptrdiff_t>(take));
+         chunk = chunk.subspan(take);
+         if (_pending.size() < WORD_BYTES)
+         {
+            return 0;
+         }
+      }
+
+      const size_t packetBytes = packetBytesAt(_pending.data());
+      if (packetBytes == 0)
+      {
+         // Only the header word is pending here; slide it by a byte
+         _pending.erase(_pending.begin());
+         ++_discardedBytes;
+         continue;
+      }
+
+      const size_t take = std::min(packetBytes - _pending.size(), chunk.size());
+      _pending.insert(_pending.end(), chunk.begin(), chunk.begin() + static_cast<ptrdiff_t>(take));
+      chunk = chunk.subspan(take);
+      if (_pending.size() < packetBytes)
+      {
+         return static_cast<size_t>(_packets - packetsBefore);
+      }
+
+      deliver(_pending);
+      _pending.clear();
+   }
+
+   // ---- Packets wholly inside the chunk are viewed in place ----
+   size_t offset = 0;
+   while (chunk.size() - offset >= WORD_BYTES)
+   {
+      const size_t packetBytes = packetBytesAt(chunk.data() + offset);
+      if (packetBytes == 0)
+      {
+         ++offset;
+         ++_discardedBytes;
+         continue;
+      }
+      if (packetBytes > chunk.size() - offset)
+      {
+         break;
+      }
+
+      deliver(chunk.subspan(offset, packetBytes));
+      offset += packetBytes;
+   }
+
+   // ---- Keep the tail for the next chunk ----
+   _pending.assign(chunk.begin() + static_cast<ptrdiff_t>(offset), chunk.end());
+
+   return static_cast<size_t>(_packets - packetsBefore);
+}
+
+void Vita49StreamParser::reset()
+{
+   _pending.clear();
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+size_t Vita49StreamParser::packetBytesAt(const uint8_t* word) const
+{
+   const uint32_t word0 = (_order == ByteOrder::BigEndian) ? readU32BE(word) : readU32LE(word);
+
+   const uint32_t type = (word0 >> 28) & 0xFu;
+   const size_t packetWords = word0 & 0xFFFFu;
+   if (type > LAST_PACKET_TYPE || packetWords == 0 || packetWords * 4 > _maxPacketBytes)
+   {
+      return 0;
+   }
+
+   // The header (and data-packet trailer) the word announces must fit the packet
+   const auto packetType = static_cast<PacketType>(type);
+   const auto tsiType    = static_cast<TSI>((word0 >> 22) & 0x3u);
+   const auto tsfType    = static_cast<TSF>((word0 >> 20) & 0x3u);
+   size_t overheadWords  = 1;
+   if (hasStreamId(packetType))         overheadWords += 1;
+   if (((word0 >> 27) & 0x1u) != 0)    overheadWords += 2;
+   if (tsiType != TSI::None)            overheadWords += 1;
+   if (tsfType != TSF::None)            overheadWords += 2;
+   if (isDataPacket(packetType) && ((word0 >> 26) & 0x1u) != 0)
+   {
+      overheadWords += 1;
+   }
+
+   return (overheadWords <= packetWords) ? packetWords * 4 : 0;
+}
+
+void Vita49StreamParser::deliver(std::span<const uint8_t> packet)
+{
+   // packetBytesAt() has checked everything PacketView::parse() checks
+   const auto view = PacketView::parse(packet, _order);
+   if (!view.has_value())
+   {
+      _discardedBytes += packet.size();
+      return;
+   }
+
+   ++_packets;
+   if (_callback)
+   {
+      _callback(*view);
+   }
+}
+
+} // namespace Vita49_2
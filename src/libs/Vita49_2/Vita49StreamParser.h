@@ -0,0 +1,99 @@
+#ifndef VITA49STREAMPARSER_H_
+#define VITA49STREAMPARSER_H_
+
+#include "PacketView.h"
+#include "Vita49Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Vita49_2
+{
+
+/**
+ * @class Vita49StreamParser
+ * @brief Incremental parser for VITA 49.2 packets arriving as a byte stream.
+ *
+ * feed() accepts chunks of any size, as read from a TCP socket or a file,
+ * and hands each complete packet to the callback as a PacketView.  Packets
+ * that lie wholly inside a chunk are viewed in place; only a packet split
+ * across chunks is copied, once, into an internal buffer that is reused
+ * for the life of the parser.
+ *
+ * Each header word is checked before its packet is accepted (known packet
+ * type, non-zero size within maxPacketBytes, room for the header fields it
+ * announces).  A word that fails is skipped one byte at a time until a
+ * plausible header appears again, so the parser recovers from corrupt or
+ * misaligned input; skipped bytes are counted in discardedBytes().
+ *
+ * @code
+ * Vita49StreamParser parser([&](const PacketView& packet) { handle(packet); });
+ * while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0)
+ * {
+ *    parser.feed({buf, static_cast<size_t>(n)});
+ * }
+ * @endcode
+ *
+ * @note Not thread-safe; feed one parser from one thread.
+ */
+class Vita49StreamParser
+{
+public:
+   /// Receives each complete packet; the view is only valid during the call
+   using PacketCallback = std::function<void(const PacketView&)>;
+
+   /**
+    * @brief Construct a stream parser.
+    *
+    * @param callback Called for every complete packet, in stream order
+    * @param order Byte order of the stream (default: BigEndian per VITA standard)
+    * @param maxPacketBytes Largest packet accepted; a lower bound (e.g. the
+    *        datagram size of a UDP source) makes corrupt sizes cheaper to reject
+    */
+   explicit Vita49StreamParser(PacketCallback callback,
+                               ByteOrder order = ByteOrder::BigEndian,
+                               size_t maxPacketBytes = MAX_PACKET_SIZE_BYTES);
+
+   /**
+    * @brief Parse the next chunk of the stream.
+    *
+    * @param chunk Bytes following those of the previous call
+    * @return Number of packets delivered to the callback
+    */
+   size_t feed(std::span<const uint8_t> chunk);
+
+   /** @brief Drop any partial packet, e.g. after reconnecting. */
+   void reset();
+
+   /** @brief Bytes of an incomplete packet held until the next feed(). */
+   [[nodiscard]] size_t pendingBytes() const { return _pending.size(); }
+
+   /** @brief Packets delivered since construction. */
+   [[nodiscard]] uint64_t packets() const { return _packets; }
+
+   /** @brief Bytes skipped while resynchronising on corrupt input. */
+   [[nodiscard]] uint64_t discardedBytes() const { return _discardedBytes; }
+
+private:
+   // Size of the packet whose header word is at `word`, or 0 if the word
+   // cannot start a packet.
+   [[nodiscard]] size_t packetBytesAt(const uint8_t* word) const;
+
+   // Hand a complete packet to the callback.
+   void deliver(std::span<const uint8_t> packet);
+
+   PacketCallback _callback;
+   ByteOrder _order;
+   size_t _maxPacketBytes;
+
+   std::vector<uint8_t> _pending;   // Partial packet carried between feeds
+   uint64_t _packets{0};
+   uint64_t _discardedBytes{0};
+};
+
+} // namespace Vita49_2
+
+#endif // VITA49STREAMPARSER_H_
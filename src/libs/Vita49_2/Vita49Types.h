@@ -2,6 +2,7 @@
 #define VITA49TYPES_H_
 
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -50,6 +51,23 @@ enum class ByteOrder : uint8_t
    LittleEndian    ///< Non-standard, for interop with LE systems
 };
 
+/**
+ * @brief Sample format of a signal data payload.
+ *
+ * Announced per stream by the Data Packet Payload Format field of its
+ * context packets (CIF0 bit 15).  Integer formats share one full scale:
+ * the scale factor is that of 16-bit samples and narrower samples keep
+ * its top bits, so a stream can change format without changing scale.
+ * Float32 stores the samples themselves, losslessly.
+ */
+enum class PayloadFormat : uint8_t
+{
+   Int16,         ///< 16-bit I, 16-bit Q: one sample per word (default)
+   Int8,          ///< 8-bit I, 8-bit Q: two samples per word
+   Int12Packed,   ///< 12-bit I, 12-bit Q, link-efficient: four samples per three words
+   Float32        ///< IEEE-754 single precision I and Q: one sample per two words
+};
+
 // ============================================================================
 // Structures
 // ============================================================================
@@ -79,6 +97,7 @@ struct PacketHeader
    TSF tsfType{TSF::None};
    uint8_t packetCount{0};       ///< 4-bit sequence counter (0-15)
    uint16_t packetSize{0};       ///< Total packet size in 32-bit words
+   uint8_t padBitCount{0};       ///< Class ID pad bits ending the payload (0-31)
 
    std::optional<uint32_t> streamId;
    std::optional<uint32_t> classIdOUI;             ///< 24-bit OUI
@@ -109,6 +128,7 @@ struct ContextFields
    std::optional<double> gain;                      ///< CIF0 bit 23, 1 word, dB
    std::optional<uint32_t> overRangeCount;          ///< CIF0 bit 22, 1 word
    std::optional<double> sampleRate;                ///< CIF0 bit 21, 2 words, Hz
+   std::optional<PayloadFormat> payloadFormat;      ///< CIF0 bit 15, 2 words
 };
 
 // ============================================================================
@@ -175,6 +195,18 @@ constexpr double GAIN_RADIX = 128.0;       // 2^7
           type == PacketType::ExtContext;
 }
 
+/** @brief Bytes one I/Q sample occupies in a payload of the given format */
+[[nodiscard]] inline size_t bytesPerSample(PayloadFormat format)
+{
+   switch (format)
+   {
+      case PayloadFormat::Int8:        return 2;
+      case PayloadFormat::Int12Packed: return 3;
+      case PayloadFormat::Float32:     return 8;
+      default:                         return 4;
+   }
+}
+
 } // namespace Vita49_2
 
 #endif // VITA49TYPES_H_
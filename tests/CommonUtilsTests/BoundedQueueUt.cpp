@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include "BoundedQueue.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using CommonUtils::BoundedQueue;
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+TEST(BoundedQueueTest, Constructor_ValidCapacity_CreatesEmptyOpenQueue)
+{
+   const BoundedQueue<int> queue(4);
+   EXPECT_EQ(queue.capacity(), 4U);
+   EXPECT_EQ(queue.size(), 0U);
+   EXPECT_FALSE(queue.isClosed());
+}
+
+TEST(BoundedQueueTest, Constructor_ZeroCapacity_Throws)
+{
+   EXPECT_THROW(BoundedQueue<int>(0), std::invalid_argument);
+}
+
+// ============================================================================
+// Push / pop
+// ============================================================================
+
+TEST(BoundedQueueTest, PushPop_PreservesFifoOrder)
+{
+   BoundedQueue<int> queue(4);
+   EXPECT_TRUE(queue.push(1));
+   EXPECT_TRUE(queue.push(2));
+   EXPECT_TRUE(queue.push(3));
+
+   EXPECT_EQ(queue.pop(), 1);
+   EXPECT_EQ(queue.pop(), 2);
+   EXPECT_EQ(queue.pop(), 3);
+   EXPECT_EQ(queue.size(), 0U);
+}
+
+TEST(BoundedQueueTest, TryPush_WhenFull_ReturnsFalse)
+{
+   BoundedQueue<int> queue(2);
+   EXPECT_TRUE(queue.tryPush(1));
+   EXPECT_TRUE(queue.tryPush(2));
+   EXPECT_FALSE(queue.tryPush(3));
+   EXPECT_EQ(queue.size(), 2U);
+}
+
+TEST(BoundedQueueTest, TryPop_WhenEmpty_ReturnsNullopt)
+{
+   BoundedQueue<int> queue(2);
+   EXPECT_FALSE(queue.tryPop().has_value());
+}
+
+TEST(BoundedQueueTest, MoveOnlyType_IsSupported)
+{
+   BoundedQueue<std::unique_ptr<int>> queue(2);
+   EXPECT_TRUE(queue.push(std::make_unique<int>(7)));
+   auto item = queue.pop();
+   ASSERT_TRUE(item.has_value());
+   EXPECT_EQ(**item, 7);
+}
+
+TEST(BoundedQueueTest, HighWaterMark_TracksLargestSize)
+{
+   BoundedQueue<int> queue(8);
+   queue.push(1);
+   queue.push(2);
+   queue.push(3);
+   std::ignore = queue.pop();
+   std::ignore = queue.pop();
+   EXPECT_EQ(queue.highWaterMark(), 3U);
+}
+
+// ============================================================================
+// Close / reopen
+// ============================================================================
+
+TEST(BoundedQueueTest, Close_PopDrainsRemainingThenReturnsNullopt)
+{
+   BoundedQueue<int> queue(4);
+   queue.push(5);
+   queue.close();
+
+   EXPECT_FALSE(queue.push(6));
+   EXPECT_EQ(queue.pop(), 5);
+   EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(BoundedQueueTest, Close_WakesBlockedConsumer)
+{
+   BoundedQueue<int> queue(4);
+   bool gotItem = true;
+   std::thread consumer([&] { gotItem = queue.pop().has_value(); });
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   queue.close();
+   consumer.join();
+   EXPECT_FALSE(gotItem);
+}
+
+TEST(BoundedQueueTest, Close_WakesBlockedProducer)
+{
+   BoundedQueue<int> queue(1);
+   queue.push(1);
+   bool pushed = true;
+   std::thread producer([&] { pushed = queue.push(2); });
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   queue.close();
+   producer.join();
+   EXPECT_FALSE(pushed);
+}
+
+TEST(BoundedQueueTest, Reopen_ClearsItemsAndAcceptsPushes)
+{
+   BoundedQueue<int> queue(2);
+   queue.push(1);
+   queue.close();
+   queue.reopen();
+
+   EXPECT_FALSE(queue.isClosed());
+   EXPECT_EQ(queue.size(), 0U);
+   EXPECT_EQ(queue.highWaterMark(), 0U);
+   EXPECT_TRUE(queue.push(2));
+}
+
+// ============================================================================
+// Threading
+// ============================================================================
+
+TEST(BoundedQueueTest, ProducerConsumer_FullQueueAppliesBackPressure)
+{
+   constexpr int TOTAL = 10'000;
+   BoundedQueue<int> queue(8);
+
+   std::thread producer([&]
+   {
+      for (int i = 0; i < TOTAL; ++i)
+      {
+         ASSERT_TRUE(queue.push(i));
+      }
+      queue.close();
+   });
+
+   std::vector<int> received;
+   while (auto item = queue.pop())
+   {
+      received.push_back(*item);
+   }
+   producer.join();
+
+   ASSERT_EQ(received.size(), static_cast<std::size_t>(TOTAL));
+   for (int i = 0; i < TOTAL; ++i)
+   {
+      EXPECT_EQ(received[static_cast<std::size_t>(i)], i);
+   }
+   EXPECT_LE(queue.highWaterMark(), queue.capacity());
+}
@@ -4,6 +4,7 @@
 
 #include <complex>
 #include <cstddef>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -542,3 +543,78 @@ TEST(CircularBufferTest, MultipleClearCycles_StayConsistent)
       EXPECT_EQ(buf[2], (cycle * 10) + 4);
    }
 }
+
+// ============================================================================
+// Bulk push and spans
+// ============================================================================
+
+TEST(CircularBufferTest, PushSpan_WrapsAcrossEnd)
+{
+   CircularBuffer<int> buf(5);
+   buf.push(std::vector<int>{1, 2, 3});
+   buf.push(std::vector<int>{4, 5, 6, 7});
+   EXPECT_TRUE(buf.full());
+   EXPECT_EQ(buf.toVector(), (std::vector<int>{3, 4, 5, 6, 7}));
+   EXPECT_EQ(buf.back(), 7);
+}
+
+TEST(CircularBufferTest, PushSpan_LongerThanCapacity_KeepsNewest)
+{
+   CircularBuffer<int> buf(4);
+   buf.push(1);
+   const std::vector<int> values{10, 11, 12, 13, 14, 15};
+   buf.push(std::span<const int>(values));
+   EXPECT_EQ(buf.toVector(), (std::vector<int>{12, 13, 14, 15}));
+   buf.push(16);
+   EXPECT_EQ(buf.toVector(), (std::vector<int>{13, 14, 15, 16}));
+}
+
+TEST(CircularBufferTest, PushSpan_MatchesSinglePushes)
+{
+   for (const std::size_t capacity : {std::size_t{7}, std::size_t{8}})
+   {
+      CircularBuffer<int> bulk(capacity);
+      CircularBuffer<int> single(capacity);
+      int next = 0;
+      for (std::size_t chunk = 0; chunk < 12; ++chunk)
+      {
+         std::vector<int> values(chunk);
+         for (auto& value : values)
+         {
+            value = next++;
+            single.push(value);
+         }
+         bulk.push(values);
+         ASSERT_EQ(bulk.toVector(), single.toVector()) << "capacity " << capacity << " chunk " << chunk;
+      }
+   }
+}
+
+TEST(CircularBufferTest, Spans_NotFull_SecondIsEmpty)
+{
+   CircularBuffer<int> buf(4);
+   buf.push(std::vector<int>{1, 2});
+   const auto [older, newer] = buf.spans();
+   EXPECT_EQ(std::vector<int>(older.begin(), older.end()), (std::vector<int>{1, 2}));
+   EXPECT_TRUE(newer.empty());
+}
+
+TEST(CircularBufferTest, Spans_Wrapped_AreChronological)
+{
+   CircularBuffer<int> buf(4);
+   buf.push(std::vector<int>{1, 2, 3, 4, 5, 6});
+   buf.push(7);
+   const auto [older, newer] = buf.spans();
+   std::vector<int> joined(older.begin(), older.end());
+   joined.insert(joined.end(), newer.begin(), newer.end());
+   EXPECT_EQ(joined, (std::vector<int>{4, 5, 6, 7}));
+   EXPECT_EQ(older.size() + newer.size(), buf.size());
+}
+
+TEST(CircularBufferTest, Spans_Empty_BothEmpty)
+{
+   const CircularBuffer<int> buf(3);
+   const auto [older, newer] = buf.spans();
+   EXPECT_TRUE(older.empty());
+   EXPECT_TRUE(newer.empty());
+}
@@ -6,23 +6,31 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 
 TEST(DataHandlerTest, SignalDataNotifiesListeners) 
 {
-    CommonUtils::DataHandler<int> handler;
     std::atomic<int> count{0};
     std::mutex mtx;
     std::condition_variable cv;
+    // Declared last: its worker is joined before the listeners' state goes.
+    CommonUtils::DataHandler<int> handler;
 
     auto listener1 = [&](const int& data) {
         EXPECT_EQ(data, 42);
-        count.fetch_add(1);
+        {
+            const std::lock_guard<std::mutex> lk(mtx);
+            count.fetch_add(1);
+        }
         cv.notify_one();
     };
 
     auto listener2 = [&](const int& data) {
         EXPECT_EQ(data, 42);
-        count.fetch_add(1);
+        {
+            const std::lock_guard<std::mutex> lk(mtx);
+            count.fetch_add(1);
+        }
         cv.notify_one();
     };
 
@@ -32,23 +40,28 @@ TEST(DataHandlerTest, SignalDataNotifiesListeners)
     handler.signalData(42);
 
     // Wait up to 500ms for both listeners to be called
-    std::unique_lock<std::mutex> lk(mtx);
-    const bool ok = cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return count.load() >= 2; });
-    EXPECT_TRUE(ok);
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        const bool ok = cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return count.load() >= 2; });
+        EXPECT_TRUE(ok);
+    }
 }
 
 TEST(DataHandlerTest, ExpiredListenersAreRemoved) 
 {
-    CommonUtils::DataHandler<int> handler;
-
     // Use atomic counters and cv to observe listener calls
     std::atomic<int> count{0};
     std::mutex mtx;
     std::condition_variable cv;
+    // Declared last: its worker is joined before the listeners' state goes.
+    CommonUtils::DataHandler<int> handler;
 
     auto listener1 = [&](const int& data) {
         EXPECT_EQ(data, 42);
-        count.fetch_add(1);
+        {
+            const std::lock_guard<std::mutex> lk(mtx);
+            count.fetch_add(1);
+        }
         cv.notify_one();
     };
 
@@ -56,7 +69,10 @@ TEST(DataHandlerTest, ExpiredListenersAreRemoved)
 
     auto listener2 = [&](const int& data) {
         EXPECT_EQ(data, 42);
-        count.fetch_add(1);
+        {
+            const std::lock_guard<std::mutex> lk(mtx);
+            count.fetch_add(1);
+        }
         cv.notify_one();
     };
 
@@ -65,9 +81,11 @@ TEST(DataHandlerTest, ExpiredListenersAreRemoved)
     handler.signalData(42);
 
     // Wait up to 500ms for both listeners to be called
-    std::unique_lock<std::mutex> lk(mtx);
-    const bool ok = cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return count.load() >= 2; });
-    EXPECT_TRUE(ok);
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        const bool ok = cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return count.load() >= 2; });
+        EXPECT_TRUE(ok);
+    }
 
     // There should be two listeners registered
     EXPECT_EQ(handler.watermarkInfo().first, 2U);
@@ -78,4 +96,612 @@ TEST(DataHandlerTest, ExpiredListenersAreRemoved)
     handler.unregisterListener(regId2);
     EXPECT_EQ(handler.watermarkInfo().first, 0U);
 
-}
\ No newline at end of file
+}
+namespace
+{
+
+// Listener that records every item and, until released, blocks on the first
+// one so the producer can fill the queue behind it.
+struct GatedListener
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<int> received;
+    bool entered = false;
+    bool released = false;
+
+    void operator()(const int& data)
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lk, [&]{ return released; });
+        received.push_back(data);
+        cv.notify_all();
+    }
+
+    bool waitEntered()
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        return cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return entered; });
+    }
+
+    void release()
+    {
+        const std::lock_guard<std::mutex> lk(mtx);
+        released = true;
+        cv.notify_all();
+    }
+
+    bool waitReceived(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        return cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return received.size() >= count; });
+    }
+};
+
+} // anonymous namespace
+
+TEST(DataHandlerTest, DefaultPolicy_IsUnbounded)
+{
+    CommonUtils::DataHandler<int> handler;
+    EXPECT_EQ(handler.overflowPolicy(), CommonUtils::OverflowPolicy::Unbounded);
+
+    GatedListener gate;
+    handler.registerListener([&](const int& data) { gate(data); });
+    handler.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+    for (int i = 1; i <= 10; ++i)
+    {
+        handler.signalData(i);
+    }
+    EXPECT_EQ(handler.queuedCount(), 10U);
+    EXPECT_EQ(handler.highWaterMark(), 10U);
+
+    gate.release();
+    ASSERT_TRUE(gate.waitReceived(11));
+    EXPECT_EQ(handler.droppedCount(), 0U);
+}
+
+TEST(DataHandlerTest, LatestOnly_DeliversNewestAndCountsDrops)
+{
+    CommonUtils::DataHandler<int> handler;
+    handler.setOverflowPolicy(CommonUtils::OverflowPolicy::LatestOnly, 8);
+    EXPECT_EQ(handler.capacity(), 1U);
+
+    GatedListener gate;
+    handler.registerListener([&](const int& data) { gate(data); });
+    handler.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+    for (int i = 1; i <= 5; ++i)
+    {
+        handler.signalData(i);
+    }
+    EXPECT_EQ(handler.queuedCount(), 1U);
+
+    gate.release();
+    ASSERT_TRUE(gate.waitReceived(2));
+    EXPECT_EQ(gate.received, (std::vector<int>{0, 5}));
+    EXPECT_EQ(handler.droppedCount(), 4U);
+    EXPECT_EQ(handler.coalescedCount(), 4U);
+}
+
+TEST(DataHandlerTest, ConstructorPolicy_BoundsQueueFromTheStart)
+{
+    CommonUtils::DataHandler<int> handler(CommonUtils::OverflowPolicy::DropOldest, 2);
+    EXPECT_EQ(handler.overflowPolicy(), CommonUtils::OverflowPolicy::DropOldest);
+    EXPECT_EQ(handler.capacity(), 2U);
+
+    CommonUtils::DataHandler<int> latest(CommonUtils::OverflowPolicy::LatestOnly, 8);
+    EXPECT_EQ(latest.capacity(), 1U);
+}
+
+TEST(DataHandlerTest, DropNewest_KeepsQueuedItemsAndRejectsIncoming)
+{
+    CommonUtils::DataHandler<int> handler(CommonUtils::OverflowPolicy::DropNewest, 3);
+
+    GatedListener gate;
+    handler.registerListener([&](const int& data) { gate(data); });
+    handler.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+    for (int i = 1; i <= 6; ++i)
+    {
+        handler.signalData(i);
+    }
+    EXPECT_EQ(handler.queuedCount(), 3U);
+
+    gate.release();
+    ASSERT_TRUE(gate.waitReceived(4));
+    EXPECT_EQ(gate.received, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(handler.droppedCount(), 3U);
+    EXPECT_EQ(handler.coalescedCount(), 0U);
+}
+
+TEST(DataHandlerTest, DropOldest_KeepsNewestCapacityItems)
+{
+    CommonUtils::DataHandler<int> handler;
+    handler.setOverflowPolicy(CommonUtils::OverflowPolicy::DropOldest, 3);
+
+    GatedListener gate;
+    handler.registerListener([&](const int& data) { gate(data); });
+    handler.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+    for (int i = 1; i <= 6; ++i)
+    {
+        handler.signalData(i);
+    }
+
+    gate.release();
+    ASSERT_TRUE(gate.waitReceived(4));
+    EXPECT_EQ(gate.received, (std::vector<int>{0, 4, 5, 6}));
+    EXPECT_EQ(handler.droppedCount(), 3U);
+    EXPECT_EQ(handler.coalescedCount(), 0U);
+    EXPECT_EQ(handler.highWaterMark(), 3U);
+}
+
+TEST(DataHandlerTest, SetOverflowPolicy_TrimsQueuedBacklog)
+{
+    CommonUtils::DataHandler<int> handler;
+
+    GatedListener gate;
+    handler.registerListener([&](const int& data) { gate(data); });
+    handler.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+    for (int i = 1; i <= 5; ++i)
+    {
+        handler.signalData(i);
+    }
+    handler.setOverflowPolicy(CommonUtils::OverflowPolicy::DropOldest, 2);
+    EXPECT_EQ(handler.queuedCount(), 2U);
+    EXPECT_EQ(handler.droppedCount(), 3U);
+
+    gate.release();
+    ASSERT_TRUE(gate.waitReceived(3));
+    EXPECT_EQ(gate.received, (std::vector<int>{0, 4, 5}));
+}
+
+TEST(DataHandlerTest, Block_HoldsProducerUntilListenerCatchesUp)
+{
+    CommonUtils::DataHandler<int> handler;
+    handler.setOverflowPolicy(CommonUtils::OverflowPolicy::Block, 2);
+
+    GatedListener gate;
+    handler.registerListener([&](const int& data) { gate(data); });
+    handler.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+
+    std::atomic<int> sent{0};
+    std::thread producer([&] {
+        for (int i = 1; i <= 5; ++i)
+        {
+            handler.signalData(i);
+            sent.store(i);
+        }
+    });
+
+    // Two items fit behind the blocked listener; the third waits.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(sent.load(), 2);
+
+    gate.release();
+    producer.join();
+    ASSERT_TRUE(gate.waitReceived(6));
+    EXPECT_EQ(gate.received, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    EXPECT_EQ(handler.droppedCount(), 0U);
+}
+
+TEST(DataHandlerTest, DispatchObserver_SeesEveryItemAfterListeners)
+{
+    CommonUtils::DataHandler<int> handler;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<int> observed;
+    std::atomic<int> listenerCalls{0};
+    bool orderOk = true;
+
+    handler.registerListener([&](const int&) { listenerCalls.fetch_add(1); });
+    handler.setDispatchObserver(
+        [&](const int& data, auto start, auto end)
+        {
+            const std::lock_guard<std::mutex> lk(mtx);
+            orderOk = orderOk && (start <= end) &&
+                      (listenerCalls.load() == static_cast<int>(observed.size()) + 1);
+            observed.push_back(data);
+            cv.notify_one();
+        });
+
+    handler.signalData(1);
+    handler.signalData(2);
+
+    std::unique_lock<std::mutex> lk(mtx);
+    ASSERT_TRUE(cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return observed.size() >= 2; }));
+    EXPECT_EQ(observed, (std::vector<int>{1, 2}));
+    EXPECT_TRUE(orderOk);
+}
+
+TEST(DataHandlerTest, DedicatedThreadListener_DoesNotDelayInlineListener)
+{
+    CommonUtils::DataHandler<int> handler;
+
+    GatedListener slow;
+    CommonUtils::ListenerOptions options;
+    options.mode     = CommonUtils::DispatchMode::DedicatedThread;
+    options.overflow = CommonUtils::OverflowPolicy::LatestOnly;
+    const int slowId = handler.registerListener([&](const int& data) { slow(data); }, options);
+
+    GatedListener fast;
+    fast.release();
+    handler.registerListener([&](const int& data) { fast(data); });
+
+    handler.signalData(0);
+    ASSERT_TRUE(slow.waitEntered());
+    for (int i = 1; i <= 5; ++i)
+    {
+        handler.signalData(i);
+    }
+    // The inline listener keeps up while the dedicated one is stuck on item 0.
+    ASSERT_TRUE(fast.waitReceived(6));
+
+    slow.release();
+    ASSERT_TRUE(slow.waitReceived(2));
+    EXPECT_EQ(slow.received, (std::vector<int>{0, 5}));
+    EXPECT_EQ(handler.listenerDroppedCount(slowId), 4U);
+    EXPECT_EQ(handler.droppedCount(), 0U);
+}
+
+TEST(DataHandlerTest, SharedPoolListeners_EachSeeEveryItemInOrder)
+{
+    CommonUtils::TaskPool pool(2);
+    CommonUtils::DataHandler<int> handler;
+
+    CommonUtils::ListenerOptions options;
+    options.mode     = CommonUtils::DispatchMode::SharedPool;
+    options.overflow = CommonUtils::OverflowPolicy::Unbounded;
+    options.pool     = &pool;
+
+    GatedListener first;
+    GatedListener second;
+    first.release();
+    second.release();
+    handler.registerListener([&](const int& data) { first(data); }, options);
+    handler.registerListener([&](const int& data) { second(data); }, options);
+
+    std::vector<int> expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        handler.signalData(i);
+        expected.push_back(i);
+    }
+    ASSERT_TRUE(first.waitReceived(100));
+    ASSERT_TRUE(second.waitReceived(100));
+    EXPECT_EQ(first.received, expected);
+    EXPECT_EQ(second.received, expected);
+}
+
+TEST(DataHandlerTest, SharedPoolListener_FloodedChannel_DoesNotStarveOthers)
+{
+    // One worker: the flooded listener's drain re-posts itself every batch
+    // and must let the other listener's drain run in between.
+    CommonUtils::TaskPool pool(1);
+    CommonUtils::DataHandler<int> flooded;
+    CommonUtils::DataHandler<int> quiet;
+
+    CommonUtils::ListenerOptions options;
+    options.mode     = CommonUtils::DispatchMode::SharedPool;
+    options.overflow = CommonUtils::OverflowPolicy::Unbounded;
+    options.pool     = &pool;
+
+    constexpr int FLOOD = 10000;
+    GatedListener gate;
+    std::atomic<int> floodedSeen{0};
+    flooded.registerListener([&](const int& data) {
+        if (data == 0)
+        {
+            gate(data);
+        }
+        floodedSeen.fetch_add(1);
+    }, options);
+
+    GatedListener second;
+    second.release();
+    std::atomic<int> floodedSeenBySecond{-1};
+    quiet.registerListener([&](const int& data) {
+        floodedSeenBySecond.store(floodedSeen.load());
+        second(data);
+    }, options);
+
+    // Hold the worker in the flooded drain while both backlogs build up.
+    flooded.signalData(0);
+    ASSERT_TRUE(gate.waitEntered());
+    for (int i = 1; i < FLOOD; ++i)
+    {
+        flooded.signalData(i);
+    }
+    quiet.signalData(7);
+    gate.release();
+
+    ASSERT_TRUE(second.waitReceived(1));
+    EXPECT_EQ(second.received, std::vector<int>{7});
+    EXPECT_LT(floodedSeenBySecond.load(), FLOOD);
+}
+
+TEST(DataHandlerTest, UnregisterQueuedListener_StopsDelivery)
+{
+    for (const auto mode : {CommonUtils::DispatchMode::DedicatedThread, CommonUtils::DispatchMode::SharedPool})
+    {
+        CommonUtils::DataHandler<int> handler;
+        CommonUtils::ListenerOptions options;
+        options.mode = mode;
+
+        std::atomic<int> calls{0};
+        const int id = handler.registerListener([&](const int&) { calls.fetch_add(1); }, options);
+        GatedListener marker;
+        marker.release();
+        handler.registerListener([&](const int& data) { marker(data); });
+
+        handler.signalData(1);
+        ASSERT_TRUE(marker.waitReceived(1));
+        handler.unregisterListener(id);
+        const int before = calls.load();
+
+        handler.signalData(2);
+        ASSERT_TRUE(marker.waitReceived(2));
+        EXPECT_EQ(calls.load(), before);
+    }
+}
+
+TEST(DataHandlerTest, BlockListener_RegistersFromCallback_DoesNotDeadlock)
+{
+    // The worker waits for room in the Block listener's queue while the
+    // listener's own thread (un)registers listeners on the same handler.
+    std::atomic<int> calls{0};
+    CommonUtils::DataHandler<int> handler;
+    CommonUtils::ListenerOptions options;
+    options.mode     = CommonUtils::DispatchMode::DedicatedThread;
+    options.overflow = CommonUtils::OverflowPolicy::Block;
+    options.capacity = 1;
+    handler.registerListener([&](const int&) {
+        handler.unregisterListener(handler.registerListener([](const int&) {}));
+        calls.fetch_add(1);
+    }, options);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        handler.signalData(i);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (calls.load() < 50 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(calls.load(), 50);
+}
+
+TEST(DataHandlerTest, InlineListener_UnregistersItself)
+{
+    std::atomic<int> calls{0};
+    GatedListener marker;
+    marker.release();
+    CommonUtils::DataHandler<int> handler;
+    int id = -1;
+    id = handler.registerListener([&](const int&) {
+        calls.fetch_add(1);
+        handler.unregisterListener(id);
+    });
+    handler.registerListener([&](const int& data) { marker(data); });
+
+    handler.signalData(1);
+    handler.signalData(2);
+    ASSERT_TRUE(marker.waitReceived(2));
+    EXPECT_EQ(calls.load(), 1);
+}
+
+TEST(DataHandlerTest, Destroy_WhileBlockListenerStalled_ClosesItsQueue)
+{
+    // Arrange: the listener stalls on item 0, item 1 fills its queue and the
+    // worker waits for room to hand over item 2.
+    GatedListener gate;
+    auto handler = std::make_unique<CommonUtils::DataHandler<int>>();
+    CommonUtils::ListenerOptions options;
+    options.mode     = CommonUtils::DispatchMode::DedicatedThread;
+    options.overflow = CommonUtils::OverflowPolicy::Block;
+    options.capacity = 1;
+    handler->registerListener([&](const int& data) { gate(data); }, options);
+    for (int i = 0; i < 3; ++i)
+    {
+        handler->signalData(i);
+    }
+    ASSERT_TRUE(gate.waitEntered());
+
+    // Act: teardown waits for the running call, then stops
+    std::thread destroyer([&handler] { handler.reset(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gate.release();
+    destroyer.join();
+
+    // Assert: nothing queued behind the stalled call was delivered
+    EXPECT_EQ(gate.received, std::vector<int>{0});
+}
+
+namespace
+{
+
+// Counts how often items were copied on their way to the listener.
+struct CopyCounted
+{
+    static inline std::atomic<int> copies{0};
+    int value = 0;
+
+    explicit CopyCounted(int v) : value(v) {}
+    CopyCounted(const CopyCounted& other) : value(other.value) { copies.fetch_add(1); }
+    CopyCounted(CopyCounted&&) noexcept = default;
+    CopyCounted& operator=(const CopyCounted& other)
+    {
+        value = other.value;
+        copies.fetch_add(1);
+        return *this;
+    }
+    CopyCounted& operator=(CopyCounted&&) noexcept = default;
+};
+
+} // anonymous namespace
+
+TEST(DataHandlerTest, SignalDataRvalueAndEmplace_DeliverWithoutCopies)
+{
+    CommonUtils::DataHandler<CopyCounted> handler;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<int> received;
+    handler.registerListener([&](const CopyCounted& data) {
+        const std::lock_guard<std::mutex> lk(mtx);
+        received.push_back(data.value);
+        cv.notify_all();
+    });
+
+    CopyCounted::copies = 0;
+    CopyCounted moved(1);
+    handler.signalData(std::move(moved));
+    handler.emplace(2);
+
+    std::unique_lock<std::mutex> lk(mtx);
+    ASSERT_TRUE(cv.wait_for(lk, std::chrono::milliseconds(500), [&]{ return received.size() >= 2; }));
+    EXPECT_EQ(received, (std::vector<int>{1, 2}));
+    EXPECT_EQ(CopyCounted::copies.load(), 0);
+}
+
+TEST(DataHandlerTest, SignalDataLvalue_CopiesOnce)
+{
+    CommonUtils::DataHandler<CopyCounted> handler;
+    std::atomic<int> calls{0};
+    handler.registerListener([&](const CopyCounted&) { calls.fetch_add(1); });
+
+    CopyCounted::copies = 0;
+    const CopyCounted item(3);
+    handler.signalData(item);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (calls.load() == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(CopyCounted::copies.load(), 1);
+}
+
+TEST(DataHandlerTest, Stats_ReportQueueLatencyDepthAndListenerTime)
+{
+    CommonUtils::DataHandler<int> handler;
+    std::mutex gateMutex;
+    std::unique_lock<std::mutex> gate(gateMutex);
+    std::atomic<int> calls{0};
+    const int id = handler.registerListener([&](const int& data) {
+        if (data == 0)
+        {
+            const std::lock_guard<std::mutex> wait(gateMutex);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        calls.fetch_add(1);
+    });
+
+    // Item 0 holds the worker so the rest queue up behind it.
+    handler.signalData(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = 1; i <= 4; ++i)
+    {
+        handler.signalData(i);
+    }
+    gate.unlock();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (calls.load() < 5 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(calls.load(), 5);
+
+    const CommonUtils::DataHandlerStats stats = handler.stats();
+    EXPECT_EQ(stats.dispatched, 5U);
+    EXPECT_EQ(stats.queued, 0U);
+    EXPECT_EQ(stats.maxQueueDepth, 4U);
+    EXPECT_GT(stats.itemsPerSecond, 0.0);
+    EXPECT_EQ(stats.queueLatency.count, 5U);
+    EXPECT_GE(stats.queueLatency.maxUs, 2000.0);
+    ASSERT_EQ(stats.listeners.size(), 1U);
+    EXPECT_EQ(stats.listeners[0].id, id);
+    EXPECT_EQ(stats.listeners[0].callback.count, 5U);
+    EXPECT_GE(stats.listeners[0].callback.p50Us, 1000.0);
+
+    handler.resetStats();
+    const CommonUtils::DataHandlerStats reset = handler.stats();
+    EXPECT_EQ(reset.dispatched, 0U);
+    EXPECT_EQ(reset.maxQueueDepth, 0U);
+    EXPECT_EQ(reset.queueLatency.count, 0U);
+    EXPECT_EQ(reset.listeners[0].callback.count, 0U);
+}
+
+TEST(DataHandlerTest, SetName_MakesStatsQueryableByName)
+{
+    {
+        CommonUtils::DataHandler<int> handler;
+        handler.setName("DataHandlerTest.named");
+        EXPECT_EQ(handler.name(), "DataHandlerTest.named");
+
+        const auto stats = CommonUtils::DataHandlerRegistry::instance().stats("DataHandlerTest.named");
+        ASSERT_TRUE(stats.has_value());
+        EXPECT_EQ(stats->name, "DataHandlerTest.named");
+    }
+    EXPECT_FALSE(CommonUtils::DataHandlerRegistry::instance().stats("DataHandlerTest.named").has_value());
+}
+
+TEST(DataHandlerTest, MemoryAccounting_CoalescesOldestOverBudget)
+{
+    CommonUtils::MemoryRegistry::instance().setBudget("DataHandlerTest.queue", 250);
+    CommonUtils::DataHandler<int> handler;
+    handler.setMemoryAccounting("DataHandlerTest.queue", [](const int&) { return size_t{100}; });
+    std::mutex gateMutex;
+    std::mutex seenMutex;
+    std::vector<int> seen;
+    handler.registerListener([&](const int& data) {
+        if (data == 0)
+        {
+            const std::lock_guard<std::mutex> wait(gateMutex);
+        }
+        const std::lock_guard<std::mutex> lock(seenMutex);
+        seen.push_back(data);
+    });
+    std::unique_lock<std::mutex> gate(gateMutex);
+
+    // Item 0 holds the worker; only two of the four behind it fit 250 bytes.
+    handler.signalData(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = 1; i <= 4; ++i)
+    {
+        handler.signalData(i);
+    }
+    EXPECT_EQ(handler.stats().queuedBytes, 200U);
+    EXPECT_EQ(handler.coalescedCount(), 2U);
+    EXPECT_EQ(handler.droppedCount(), 2U);
+
+    gate.unlock();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (handler.queuedCount() > 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    {
+        const std::lock_guard<std::mutex> lock(seenMutex);
+        EXPECT_EQ(seen, (std::vector<int>{0, 3, 4}));
+    }
+    EXPECT_EQ(handler.stats().queuedBytes, 0U);
+
+    for (const auto& account : CommonUtils::MemoryRegistry::instance().allStats())
+    {
+        if (account.name == "DataHandlerTest.queue")
+        {
+            EXPECT_EQ(account.currentBytes, 0U);
+            EXPECT_EQ(account.peakBytes, 200U);
+            EXPECT_EQ(account.reliefs, 2U);
+            EXPECT_EQ(account.relief, CommonUtils::MemoryRelief::Coalesce);
+        }
+    }
+    CommonUtils::MemoryRegistry::instance().setBudget("DataHandlerTest.queue", 0);
+}
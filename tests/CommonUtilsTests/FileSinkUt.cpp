@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include "FileSink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using CommonUtils::FileSink;
+
+namespace
+{
+
+std::vector<uint8_t> readFile(const std::string& path)
+{
+   std::ifstream in(path, std::ios::binary);
+   return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// Byte i of the stream is (i * 7 + i / 4096) mod 256, so misplaced pages show.
+uint8_t patternAt(std::size_t i)
+{
+   return static_cast<uint8_t>((i * 7) + (i / 4096));
+}
+
+void fill(std::byte* buffer, std::size_t first, std::size_t bytes)
+{
+   for (std::size_t i = 0; i < bytes; ++i)
+   {
+      buffer[i] = static_cast<std::byte>(patternAt(first + i));
+   }
+}
+
+void expectPattern(const std::vector<uint8_t>& bytes, std::size_t expectedSize)
+{
+   ASSERT_EQ(bytes.size(), expectedSize);
+   for (std::size_t i = 0; i < bytes.size(); ++i)
+   {
+      if (bytes[i] != patternAt(i))
+      {
+         FAIL() << "byte " << i;
+      }
+   }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Buffers
+// ============================================================================
+
+TEST(FileSinkTest, Constructor_RoundsBuffersToAlignment)
+{
+   const FileSink sink(5000, 0);
+   EXPECT_EQ(sink.bufferBytes(), 2 * FileSink::ALIGNMENT);
+   EXPECT_EQ(sink.bufferCount(), 1U);
+}
+
+TEST(FileSinkTest, Acquire_EmptyPoolOrClosed_ReturnsNull)
+{
+   FileSink sink(4096, 2);
+   EXPECT_EQ(sink.acquire(), nullptr);   // Not open.
+
+   ASSERT_TRUE(sink.open(::testing::TempDir() + "filesink_pool.bin"));
+   std::byte* first  = sink.acquire();
+   std::byte* second = sink.acquire();
+   ASSERT_NE(first, nullptr);
+   ASSERT_NE(second, nullptr);
+   EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % FileSink::ALIGNMENT, 0U);
+   EXPECT_EQ(sink.acquire(), nullptr);
+   EXPECT_EQ(sink.freeCount(), 0U);
+
+   sink.release(first);
+   EXPECT_EQ(sink.acquire(), first);
+   sink.release(first);
+   sink.release(second);
+   EXPECT_TRUE(sink.close());
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+TEST(FileSinkTest, Submit_WritesBuffersInFileOrder)
+{
+   constexpr std::size_t BUFFERS = 12;
+   FileSink sink(8192, 3);
+   const std::string path = ::testing::TempDir() + "filesink_submit.bin";
+   ASSERT_TRUE(sink.open(path));
+
+   for (std::size_t b = 0; b < BUFFERS; ++b)
+   {
+      std::byte* buffer = sink.acquire(true);
+      ASSERT_NE(buffer, nullptr);
+      fill(buffer, b * 8192, 8192);
+      sink.submit(buffer, 8192);
+   }
+   EXPECT_TRUE(sink.close());
+   EXPECT_FALSE(sink.isOpen());
+
+   expectPattern(readFile(path), BUFFERS * 8192);
+   const auto stats = sink.stats();
+   EXPECT_EQ(stats.bytesWritten, BUFFERS * 8192U);
+   EXPECT_EQ(stats.writes, BUFFERS);
+   EXPECT_EQ(stats.writeErrors, 0U);
+   EXPECT_GE(stats.peakInFlight, 1U);
+   EXPECT_LE(stats.peakInFlight, 3U);
+}
+
+TEST(FileSinkTest, Append_PacksAcrossBuffersAndFlushesTail)
+{
+   FileSink sink(4096, 2);
+   const std::string path = ::testing::TempDir() + "filesink_append.bin";
+   ASSERT_TRUE(sink.open(path));
+
+   // Odd-sized pieces straddle buffer boundaries.
+   constexpr std::size_t TOTAL = (5 * 4096) + 123;
+   std::vector<std::byte> bytes(TOTAL);
+   fill(bytes.data(), 0, TOTAL);
+   std::size_t offset = 0;
+   while (offset < TOTAL)
+   {
+      const std::size_t piece = std::min<std::size_t>(1000, TOTAL - offset);
+      ASSERT_TRUE(sink.append(bytes.data() + offset, piece));
+      offset += piece;
+   }
+   EXPECT_TRUE(sink.close());
+
+   expectPattern(readFile(path), TOTAL);
+   EXPECT_EQ(sink.stats().writes, 6U);
+   EXPECT_FALSE(sink.append(bytes.data(), 1));   // Closed.
+}
+
+TEST(FileSinkTest, DirectIo_PartialTail_StillWrittenExactly)
+{
+   // O_DIRECT may be unsupported (tmpfs): the sink then writes buffered.
+   FileSink sink(8192, 2);
+   const std::string path = ::testing::TempDir() + "filesink_direct.bin";
+   ASSERT_TRUE(sink.open(path, true));
+
+   std::byte* buffer = sink.acquire(true);
+   fill(buffer, 0, 8192);
+   sink.submit(buffer, 8192);
+   buffer = sink.acquire(true);
+   fill(buffer, 8192, 1000);
+   sink.submit(buffer, 1000);
+   EXPECT_FALSE(sink.directIo());   // Dropped (or never had) for the tail.
+   EXPECT_TRUE(sink.close());
+
+   expectPattern(readFile(path), 9192);
+}
+
+TEST(FileSinkTest, WriteHandler_ToldOfEveryCompletedWrite)
+{
+   FileSink sink(4096, 2);
+   std::atomic<std::size_t> bytes{0};
+   std::atomic<int> calls{0};
+   sink.setWriteHandler(
+      [&](std::size_t written, bool ok)
+      {
+         EXPECT_TRUE(ok);
+         bytes += written;
+         ++calls;
+      });
+   ASSERT_TRUE(sink.open(::testing::TempDir() + "filesink_handler.bin"));
+   for (int i = 0; i < 6; ++i)
+   {
+      std::byte* buffer = sink.acquire(true);
+      fill(buffer, 0, 4096);
+      sink.submit(buffer, 4096);
+   }
+   sink.close();
+
+   EXPECT_EQ(bytes.load(), 6U * 4096U);
+   EXPECT_EQ(calls.load(), 6);
+}
+
+TEST(FileSinkTest, FailedWrites_CountedAndReportedByClose)
+{
+   FileSink sink(4096, 2);
+   ASSERT_TRUE(sink.open("/dev/full"));   // Every write fails with ENOSPC.
+   std::byte* buffer = sink.acquire(true);
+   fill(buffer, 0, 4096);
+   sink.submit(buffer, 4096);
+   EXPECT_FALSE(sink.close());
+   EXPECT_EQ(sink.stats().writeErrors, 1U);
+   EXPECT_EQ(sink.stats().bytesWritten, 0U);
+
+   EXPECT_FALSE(sink.open("/nonexistent-dir/file.bin"));
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "GeneralLogger.h"
+
+#include "spdlog/sinks/ringbuffer_sink.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using CommonUtils::GeneralLogger;
+using CommonUtils::LogRateLimiter;
+
+namespace
+{
+
+// Points the general logger at a ring-buffer sink for the test's lifetime.
+class CapturedLog
+{
+public:
+   CapturedLog()
+      : _sink(std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(64))
+      , _saved(GeneralLogger::s_generalLogger)
+   {
+      _sink->set_pattern("%l %v");
+      GeneralLogger::s_generalLogger = std::make_shared<spdlog::async_logger>(
+         "capturedLog", _sink, spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+      GeneralLogger::s_generalLogger->set_level(spdlog::level::debug);
+   }
+
+   ~CapturedLog()
+   {
+      GeneralLogger::flushDeferred();
+      GeneralLogger::s_generalLogger = _saved;
+   }
+
+   CapturedLog(const CapturedLog&) = delete;
+   CapturedLog& operator=(const CapturedLog&) = delete;
+
+   // Wait for the deferred worker and spdlog's thread to deliver `count` lines.
+   std::vector<std::string> lines(std::size_t count)
+   {
+      GeneralLogger::flushDeferred();
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+      std::vector<std::string> out = _sink->last_formatted();
+      while (out.size() < count && std::chrono::steady_clock::now() < deadline)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(5));
+         out = _sink->last_formatted();
+      }
+      for (auto& line : out)
+      {
+         while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+         {
+            line.pop_back();
+         }
+      }
+      return out;
+   }
+
+private:
+   std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> _sink;
+   std::shared_ptr<spdlog::async_logger> _saved;
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// LogRateLimiter
+// ============================================================================
+
+TEST(LogRateLimiterTest, Allow_StopsAtBudgetAndReportsSuppressedNextWindow)
+{
+   LogRateLimiter limiter(3);
+   int allowed = 0;
+   std::uint64_t suppressed = 0;
+   for (int i = 0; i < 10; ++i)
+   {
+      allowed += limiter.allow(suppressed) ? 1 : 0;
+   }
+   EXPECT_EQ(allowed, 3);
+   EXPECT_EQ(suppressed, 0U);
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(1050));
+   ASSERT_TRUE(limiter.allow(suppressed));
+   EXPECT_EQ(suppressed, 7U);
+}
+
+// ============================================================================
+// *_LIMITED macros
+// ============================================================================
+
+TEST(GeneralLoggerTest, LimitedMacro_LogsAtMostBudgetPerCallSite)
+{
+   CapturedLog log;
+   for (int i = 0; i < 100; ++i)
+   {
+      GPWARN_LIMITED(5, "packet {} failed", i);
+   }
+   const auto lines = log.lines(5);
+   ASSERT_EQ(lines.size(), 5U);
+   EXPECT_EQ(lines.front(), "warning packet 0 failed");
+   EXPECT_EQ(lines.back(), "warning packet 4 failed");
+}
+
+TEST(GeneralLoggerTest, LimitedMacro_CopiesStringArgumentsBeforeDeferring)
+{
+   CapturedLog log;
+   {
+      std::string reason = "overflow";
+      GPERROR_LIMITED(10, "stream error: {} ({})", reason.c_str(), std::string_view(reason));
+      reason.assign("clobbered");
+   }
+   const auto lines = log.lines(1);
+   ASSERT_EQ(lines.size(), 1U);
+   EXPECT_EQ(lines.front(), "error stream error: overflow (overflow)");
+}
+
+TEST(GeneralLoggerTest, LimitedMacro_BelowLoggerLevel_IsDropped)
+{
+   CapturedLog log;
+   GeneralLogger::s_generalLogger->set_level(spdlog::level::warn);
+   GPINFO_LIMITED(10, "not shown {}", 1);
+   GPWARN_LIMITED(10, "shown {}", 2);
+   const auto lines = log.lines(1);
+   ASSERT_EQ(lines.size(), 1U);
+   EXPECT_EQ(lines.front(), "warning shown 2");
+}
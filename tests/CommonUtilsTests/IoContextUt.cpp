@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include "IoContext.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using CommonUtils::IoContext;
+using CommonUtils::IoTask;
+using CommonUtils::IoWait;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+constexpr auto WAIT_LIMIT = 5s;
+
+// Non-blocking connected datagram socket pair, closed on destruction.
+class SocketPair
+{
+public:
+   SocketPair()
+   {
+      EXPECT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, _fds.data()),
+                0);
+   }
+
+   ~SocketPair()
+   {
+      ::close(_fds[0]);
+      ::close(_fds[1]);
+   }
+
+   SocketPair(const SocketPair&) = delete;
+   SocketPair& operator=(const SocketPair&) = delete;
+
+   [[nodiscard]] int local() const { return _fds[0]; }
+   [[nodiscard]] int peer() const { return _fds[1]; }
+
+private:
+   std::array<int, 2> _fds{-1, -1};
+};
+
+IoTask sleepThenRecord(IoContext& io, IoContext::Clock::duration delay, int id,
+                       std::mutex& mutex, std::vector<int>& order, std::promise<void>& last)
+{
+   co_await io.sleepFor(delay);
+   const std::lock_guard<std::mutex> lock(mutex);
+   order.push_back(id);
+   if (order.size() == 3)
+   {
+      last.set_value();
+   }
+}
+
+IoTask awaitReadable(IoContext& io, int fd, std::chrono::milliseconds timeout,
+                     std::promise<IoWait>& result)
+{
+   const IoWait wait = co_await io.readable(fd, timeout);
+   io.forget(fd);
+   result.set_value(wait);
+}
+
+IoTask awaitWritable(IoContext& io, int fd, std::promise<IoWait>& result)
+{
+   result.set_value(co_await io.writable(fd));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Running coroutines and functions
+// ============================================================================
+
+TEST(IoContextTest, Spawn_RunsOnLoopThread)
+{
+   IoContext io;
+   EXPECT_FALSE(io.isLoopThread());
+
+   std::promise<bool> onLoop;
+   auto task = [](IoContext& context, std::promise<bool>& result) -> IoTask
+   {
+      co_await context.sleepFor(0ms);
+      result.set_value(context.isLoopThread());
+   };
+   io.spawn(task(io, onLoop));
+
+   auto future = onLoop.get_future();
+   ASSERT_EQ(future.wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_TRUE(future.get());
+}
+
+TEST(IoContextTest, Post_RunsFunctionsInOrder)
+{
+   IoContext io;
+   std::vector<int> order;
+   std::promise<void> done;
+   for (int i = 0; i < 5; ++i)
+   {
+      io.post([&order, i] { order.push_back(i); });
+   }
+   io.post([&done] { done.set_value(); });
+
+   ASSERT_EQ(done.get_future().wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+// ============================================================================
+// Timers
+// ============================================================================
+
+TEST(IoContextTest, SleepFor_ResumesInDeadlineOrder)
+{
+   IoContext io;
+   std::mutex mutex;
+   std::vector<int> order;
+   std::promise<void> last;
+   const auto start = IoContext::Clock::now();
+   io.spawn(sleepThenRecord(io, 60ms, 3, mutex, order, last));
+   io.spawn(sleepThenRecord(io, 20ms, 1, mutex, order, last));
+   io.spawn(sleepThenRecord(io, 40ms, 2, mutex, order, last));
+
+   ASSERT_EQ(last.get_future().wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_GE(IoContext::Clock::now() - start, 60ms);
+   const std::lock_guard<std::mutex> lock(mutex);
+   EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+   EXPECT_EQ(io.waitingCount(), 0U);
+}
+
+// ============================================================================
+// Descriptors
+// ============================================================================
+
+TEST(IoContextTest, Readable_ResumesWhenDataArrives)
+{
+   IoContext io;
+   const SocketPair sockets;
+   std::promise<IoWait> result;
+   io.spawn(awaitReadable(io, sockets.local(), {}, result));
+
+   auto future = result.get_future();
+   EXPECT_EQ(future.wait_for(20ms), std::future_status::timeout);
+   EXPECT_EQ(io.waitingCount(), 1U);
+
+   const char byte = 'x';
+   ASSERT_EQ(::send(sockets.peer(), &byte, 1, 0), 1);
+   ASSERT_EQ(future.wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_EQ(future.get(), IoWait::Ready);
+}
+
+TEST(IoContextTest, Readable_TimesOutWithoutData)
+{
+   IoContext io;
+   const SocketPair sockets;
+   std::promise<IoWait> result;
+   const auto start = IoContext::Clock::now();
+   io.spawn(awaitReadable(io, sockets.local(), 20ms, result));
+
+   auto future = result.get_future();
+   ASSERT_EQ(future.wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_EQ(future.get(), IoWait::Timeout);
+   EXPECT_GE(IoContext::Clock::now() - start, 20ms);
+}
+
+TEST(IoContextTest, ReaderAndWriter_ShareOneDescriptor)
+{
+   IoContext io;
+   const SocketPair sockets;
+   std::promise<IoWait> read;
+   std::promise<IoWait> written;
+   io.spawn(awaitReadable(io, sockets.local(), {}, read));
+   io.spawn(awaitWritable(io, sockets.local(), written));
+
+   // The socket is writable at once; the reader stays armed after that.
+   auto writeFuture = written.get_future();
+   ASSERT_EQ(writeFuture.wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_EQ(writeFuture.get(), IoWait::Ready);
+   auto readFuture = read.get_future();
+   EXPECT_EQ(readFuture.wait_for(20ms), std::future_status::timeout);
+
+   const char byte = 'x';
+   ASSERT_EQ(::send(sockets.peer(), &byte, 1, 0), 1);
+   ASSERT_EQ(readFuture.wait_for(WAIT_LIMIT), std::future_status::ready);
+   EXPECT_EQ(readFuture.get(), IoWait::Ready);
+}
+
+// ============================================================================
+// Shutdown
+// ============================================================================
+
+TEST(IoContextTest, Destructor_DestroysWaitingCoroutines)
+{
+   // Set when the coroutine frame (and with it this local) is destroyed.
+   struct Flag
+   {
+      std::atomic<int>& destroyed;
+      ~Flag() { ++destroyed; }
+   };
+   auto waitForever = [](IoContext& context, int fd, std::atomic<int>& destroyed,
+                         std::promise<void>& started) -> IoTask
+   {
+      const Flag flag{destroyed};
+      started.set_value();
+      co_await context.readable(fd, 10s);
+   };
+
+   const SocketPair sockets;
+   std::atomic<int> destroyed{0};
+   std::promise<void> started;
+   {
+      IoContext io;
+      io.spawn(waitForever(io, sockets.local(), destroyed, started));
+      ASSERT_EQ(started.get_future().wait_for(WAIT_LIMIT), std::future_status::ready);
+      EXPECT_EQ(destroyed.load(), 0);
+
+      // Spawned after stop(): never started, destroyed at once.
+      io.stop();
+      std::promise<void> unused;
+      io.spawn(waitForever(io, sockets.local(), destroyed, unused));
+   }
+   EXPECT_EQ(destroyed.load(), 1);
+}
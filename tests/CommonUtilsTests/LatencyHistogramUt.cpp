@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "LatencyHistogram.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using CommonUtils::LatencyHistogram;
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+TEST(LatencyHistogramTest, Empty_ReportsZero)
+{
+   const LatencyHistogram histogram;
+   EXPECT_EQ(histogram.count(), 0U);
+   EXPECT_DOUBLE_EQ(histogram.percentileNs(0.5), 0.0);
+   const auto summary = histogram.summary();
+   EXPECT_EQ(summary.count, 0U);
+   EXPECT_DOUBLE_EQ(summary.maxUs, 0.0);
+}
+
+TEST(LatencyHistogramTest, SmallValues_AreExact)
+{
+   LatencyHistogram histogram;
+   histogram.record(nanoseconds(3));
+   EXPECT_DOUBLE_EQ(histogram.percentileNs(1.0), 3.0);
+}
+
+TEST(LatencyHistogramTest, Percentiles_WithinBucketResolution)
+{
+   LatencyHistogram histogram;
+   // 1 .. 1000 us, uniformly.
+   for (int us = 1; us <= 1000; ++us)
+   {
+      histogram.record(microseconds(us));
+   }
+   const double tolerance = 1.0 / static_cast<double>(LatencyHistogram::SUB_BUCKETS);
+   EXPECT_NEAR(histogram.percentileNs(0.50) / 500.0e3, 1.0, tolerance);
+   EXPECT_NEAR(histogram.percentileNs(0.90) / 900.0e3, 1.0, tolerance);
+   EXPECT_NEAR(histogram.percentileNs(0.99) / 990.0e3, 1.0, tolerance);
+
+   const auto summary = histogram.summary();
+   EXPECT_EQ(summary.count, 1000U);
+   EXPECT_NEAR(summary.meanUs, 500.5, 1.0e-6);
+   EXPECT_DOUBLE_EQ(summary.maxUs, 1000.0);
+   EXPECT_LE(summary.p99Us, summary.maxUs);
+}
+
+TEST(LatencyHistogramTest, NegativeDuration_CountsAsZero)
+{
+   LatencyHistogram histogram;
+   histogram.record(nanoseconds(-50));
+   EXPECT_EQ(histogram.count(), 1U);
+   EXPECT_DOUBLE_EQ(histogram.percentileNs(1.0), 0.0);
+}
+
+TEST(LatencyHistogramTest, Reset_ClearsCounts)
+{
+   LatencyHistogram histogram;
+   histogram.record(microseconds(5));
+   histogram.reset();
+   EXPECT_EQ(histogram.count(), 0U);
+   EXPECT_DOUBLE_EQ(histogram.summary().maxUs, 0.0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecords_AreAllCounted)
+{
+   constexpr int THREADS = 4;
+   constexpr int PER_THREAD = 10000;
+   LatencyHistogram histogram;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < THREADS; ++t)
+   {
+      threads.emplace_back([&histogram, t] {
+         for (int i = 0; i < PER_THREAD; ++i)
+         {
+            histogram.record(nanoseconds(100 * (t + 1)));
+         }
+      });
+   }
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+   EXPECT_EQ(histogram.count(), static_cast<uint64_t>(THREADS * PER_THREAD));
+   EXPECT_DOUBLE_EQ(histogram.summary().maxUs, 0.4);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include "DataHandler.h"
+#include "LockFreeDataHandler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using CommonUtils::LockFreeDataHandler;
+
+namespace
+{
+
+// Collects received items and lets the test wait for a count.
+struct Collector
+{
+   std::mutex mtx;
+   std::condition_variable cv;
+   std::vector<int> received;
+
+   void operator()(const int& data)
+   {
+      const std::lock_guard<std::mutex> lk(mtx);
+      received.push_back(data);
+      cv.notify_all();
+   }
+
+   bool waitReceived(std::size_t count)
+   {
+      std::unique_lock<std::mutex> lk(mtx);
+      return cv.wait_for(lk, std::chrono::seconds(2), [&] { return received.size() >= count; });
+   }
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+TEST(LockFreeDataHandlerTest, SignalData_ReachesEveryListenerInOrder)
+{
+   LockFreeDataHandler<int> handler;
+   Collector first;
+   Collector second;
+   handler.registerListener([&](const int& data) { first(data); });
+   handler.registerListener([&](const int& data) { second(data); });
+   EXPECT_EQ(handler.listenerCount(), 2U);
+
+   for (int i = 0; i < 100; ++i)
+   {
+      handler.signalData(i);
+   }
+   ASSERT_TRUE(first.waitReceived(100));
+   ASSERT_TRUE(second.waitReceived(100));
+
+   std::vector<int> expected(100);
+   for (int i = 0; i < 100; ++i)
+   {
+      expected[static_cast<std::size_t>(i)] = i;
+   }
+   EXPECT_EQ(first.received, expected);
+   EXPECT_EQ(second.received, expected);
+}
+
+TEST(LockFreeDataHandlerTest, SlowListener_ItemsAreDispatchedInBatches)
+{
+   LockFreeDataHandler<int> handler;
+   std::mutex gateMutex;
+   std::unique_lock<std::mutex> gate(gateMutex);
+   Collector collector;
+   handler.registerListener([&](const int& data) {
+      if (data == 0)
+      {
+         const std::lock_guard<std::mutex> wait(gateMutex);
+      }
+      collector(data);
+   });
+
+   handler.signalData(0);
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   for (int i = 1; i <= 50; ++i)
+   {
+      handler.signalData(i);
+   }
+   gate.unlock();
+
+   ASSERT_TRUE(collector.waitReceived(51));
+   EXPECT_EQ(handler.deliveredCount(), 51U);
+   // Item 0 alone, then the 50 queued behind it in one batch.
+   EXPECT_EQ(handler.batchCount(), 2U);
+}
+
+TEST(LockFreeDataHandlerTest, UnregisterListener_StopsDelivery)
+{
+   LockFreeDataHandler<int> handler;
+   std::atomic<int> calls{0};
+   const int id = handler.registerListener([&](const int&) { calls.fetch_add(1); });
+   Collector collector;
+   handler.registerListener([&](const int& data) { collector(data); });
+
+   handler.signalData(1);
+   ASSERT_TRUE(collector.waitReceived(1));
+   handler.unregisterListener(id);
+   EXPECT_EQ(handler.listenerCount(), 1U);
+
+   const int before = calls.load();
+   handler.signalData(2);
+   ASSERT_TRUE(collector.waitReceived(2));
+   EXPECT_EQ(calls.load(), before);
+}
+
+TEST(LockFreeDataHandlerTest, ThrowingListener_DoesNotStopOthers)
+{
+   LockFreeDataHandler<int> handler;
+   handler.registerListener([](const int&) { throw std::runtime_error("listener failure"); });
+   Collector collector;
+   handler.registerListener([&](const int& data) { collector(data); });
+
+   handler.signalData(5);
+   ASSERT_TRUE(collector.waitReceived(1));
+   EXPECT_EQ(collector.received.front(), 5);
+}
+
+TEST(LockFreeDataHandlerTest, MoveOnlyPayload_IsMovedToListeners)
+{
+   LockFreeDataHandler<std::unique_ptr<int>> handler;
+   Collector collector;
+   handler.registerListener([&](const std::unique_ptr<int>& data) { collector(*data); });
+
+   handler.signalData(std::make_unique<int>(1));
+   handler.emplace(new int(2));
+   ASSERT_TRUE(collector.waitReceived(2));
+   EXPECT_EQ(collector.received, (std::vector<int>{1, 2}));
+}
+
+// ============================================================================
+// Microbenchmark
+// ============================================================================
+
+namespace
+{
+
+// Time for `producers` threads to push `items` each through `handler`
+// until one listener has seen them all; returns items per second.
+template <typename Handler>
+double measureThroughput(Handler& handler, int producers, int items)
+{
+   const auto total = static_cast<std::uint64_t>(producers) * static_cast<std::uint64_t>(items);
+   std::atomic<std::uint64_t> received{0};
+   handler.registerListener([&](const int&) { received.fetch_add(1, std::memory_order_relaxed); });
+
+   const auto start = std::chrono::steady_clock::now();
+   std::vector<std::thread> threads;
+   for (int p = 0; p < producers; ++p)
+   {
+      threads.emplace_back([&handler, items] {
+         for (int i = 0; i < items; ++i)
+         {
+            handler.signalData(i);
+         }
+      });
+   }
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+   while (received.load(std::memory_order_relaxed) < total)
+   {
+      std::this_thread::yield();
+   }
+   const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+   return static_cast<double>(total) / elapsed.count();
+}
+
+} // anonymous namespace
+
+TEST(LockFreeDataHandlerTest, Benchmark_ThroughputVersusDataHandler)
+{
+   constexpr int PRODUCERS = 4;
+   constexpr int ITEMS = 50000;
+
+   double locked = 0.0;
+   {
+      CommonUtils::DataHandler<int> handler;
+      locked = measureThroughput(handler, PRODUCERS, ITEMS);
+   }
+   double lockFree = 0.0;
+   std::uint64_t batches = 0;
+   {
+      LockFreeDataHandler<int> handler;
+      lockFree = measureThroughput(handler, PRODUCERS, ITEMS);
+      batches = handler.batchCount();
+   }
+
+   std::cout << "[ BENCH    ] " << PRODUCERS << " producers x " << ITEMS << " items\n"
+             << "[ BENCH    ] DataHandler:         " << locked / 1e6 << " M items/s\n"
+             << "[ BENCH    ] LockFreeDataHandler: " << lockFree / 1e6 << " M items/s ("
+             << static_cast<double>(PRODUCERS * ITEMS) / static_cast<double>(batches)
+             << " items/batch)\n";
+   RecordProperty("DataHandlerItemsPerSec", std::to_string(locked));
+   RecordProperty("LockFreeDataHandlerItemsPerSec", std::to_string(lockFree));
+
+   // Timing depends on the machine; only delivery is checked.
+   EXPECT_GT(locked, 0.0);
+   EXPECT_GT(lockFree, 0.0);
+}
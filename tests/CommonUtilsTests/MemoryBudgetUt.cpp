@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "MemoryBudget.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using CommonUtils::MemoryAccount;
+using CommonUtils::MemoryAccountStats;
+using CommonUtils::MemoryRegistry;
+using CommonUtils::MemoryRelief;
+
+namespace
+{
+
+// Stats of the first live account called `name`.
+std::optional<MemoryAccountStats> findAccount(std::string_view name)
+{
+   for (const auto& account : MemoryRegistry::instance().allStats())
+   {
+      if (account.name == name)
+      {
+         return account;
+      }
+   }
+   return std::nullopt;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// MemoryAccount
+// ============================================================================
+
+TEST(MemoryBudgetTest, Account_TracksCurrentAndPeak)
+{
+   MemoryAccount account("MemoryBudgetTest.peak", MemoryRelief::DropHistory);
+   account.setBytes(1000);
+   account.addBytes(500);
+   account.subBytes(1200);
+   EXPECT_EQ(account.bytes(), 300U);
+
+   account.subBytes(1000);
+   EXPECT_EQ(account.bytes(), 0U);
+
+   const auto stats = findAccount("MemoryBudgetTest.peak");
+   ASSERT_TRUE(stats.has_value());
+   EXPECT_EQ(stats->currentBytes, 0U);
+   EXPECT_EQ(stats->peakBytes, 1500U);
+   EXPECT_EQ(stats->budgetBytes, 0U);
+   EXPECT_EQ(stats->relief, MemoryRelief::DropHistory);
+}
+
+TEST(MemoryBudgetTest, Unregistered_OnDestruction)
+{
+   {
+      const MemoryAccount account("MemoryBudgetTest.scoped", MemoryRelief::Coalesce);
+      EXPECT_TRUE(findAccount("MemoryBudgetTest.scoped").has_value());
+   }
+   EXPECT_FALSE(findAccount("MemoryBudgetTest.scoped").has_value());
+}
+
+// ============================================================================
+// Budgets
+// ============================================================================
+
+TEST(MemoryBudgetTest, Budget_AppliesToExistingAndNewAccounts)
+{
+   auto& registry = MemoryRegistry::instance();
+   MemoryAccount before("MemoryBudgetTest.budget", MemoryRelief::ShrinkPersistence);
+   EXPECT_EQ(before.budget(), 0U);
+   EXPECT_TRUE(before.fits(1U << 30));
+
+   registry.setBudget("MemoryBudgetTest.budget", 4096);
+   const MemoryAccount after("MemoryBudgetTest.budget", MemoryRelief::ShrinkPersistence);
+   EXPECT_EQ(before.budget(), 4096U);
+   EXPECT_EQ(after.budget(), 4096U);
+   EXPECT_EQ(registry.budget("MemoryBudgetTest.budget"), 4096U);
+
+   EXPECT_TRUE(before.fits(4096));
+   EXPECT_FALSE(before.fits(4097));
+   before.setBytes(5000);
+   EXPECT_TRUE(before.overBudget());
+   EXPECT_FALSE(after.overBudget());
+
+   registry.setBudget("MemoryBudgetTest.budget", 0);
+   EXPECT_EQ(before.budget(), 0U);
+   EXPECT_FALSE(before.overBudget());
+}
+
+TEST(MemoryBudgetTest, Reliefs_CountedPerAccount)
+{
+   MemoryAccount account("MemoryBudgetTest.reliefs", MemoryRelief::Coalesce);
+   account.recordRelief();
+   account.recordRelief();
+
+   const auto stats = findAccount("MemoryBudgetTest.reliefs");
+   ASSERT_TRUE(stats.has_value());
+   EXPECT_EQ(stats->reliefs, 2U);
+   EXPECT_STREQ(CommonUtils::memoryReliefName(stats->relief), "coalesce");
+}
+
+// ============================================================================
+// Totals
+// ============================================================================
+
+TEST(MemoryBudgetTest, Totals_SumAccountsAndKeepPeak)
+{
+   auto& registry = MemoryRegistry::instance();
+   const auto base = registry.totals();
+
+   registry.setBudget("MemoryBudgetTest.totals", 100);
+   {
+      MemoryAccount a("MemoryBudgetTest.totals", MemoryRelief::DropHistory);
+      MemoryAccount b("MemoryBudgetTest.totals", MemoryRelief::DropHistory);
+      a.setBytes(300);
+      b.setBytes(50);
+
+      const auto totals = registry.totals();
+      EXPECT_EQ(totals.accounts, base.accounts + 2);
+      EXPECT_EQ(totals.currentBytes, base.currentBytes + 350);
+      EXPECT_EQ(totals.overBudget, base.overBudget + 1);
+      EXPECT_GE(totals.peakBytes, totals.currentBytes);
+   }
+   registry.setBudget("MemoryBudgetTest.totals", 0);
+
+   const auto after = registry.totals();
+   EXPECT_EQ(after.accounts, base.accounts);
+   EXPECT_EQ(after.currentBytes, base.currentBytes);
+   EXPECT_GE(after.peakBytes, base.currentBytes + 350);
+}
+
+TEST(MemoryBudgetTest, ConcurrentUpdates_Balance)
+{
+   MemoryAccount account("MemoryBudgetTest.concurrent", MemoryRelief::DropHistory);
+   std::vector<std::thread> threads;
+   for (int t = 0; t < 4; ++t)
+   {
+      threads.emplace_back(
+         [&account]
+         {
+            for (int i = 0; i < 10000; ++i)
+            {
+               account.addBytes(64);
+               account.subBytes(64);
+            }
+         });
+   }
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+   EXPECT_EQ(account.bytes(), 0U);
+   EXPECT_LE(account.stats().peakBytes, 4U * 64U);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "MpscQueue.h"
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using CommonUtils::MpscQueue;
+
+// ============================================================================
+// Single thread
+// ============================================================================
+
+TEST(MpscQueueTest, NewQueue_IsEmpty)
+{
+   MpscQueue<int> queue;
+   EXPECT_TRUE(queue.empty());
+   EXPECT_FALSE(queue.tryPop().has_value());
+}
+
+TEST(MpscQueueTest, PushPop_PreservesFifoOrder)
+{
+   MpscQueue<int> queue;
+   queue.push(1);
+   queue.push(2);
+   queue.push(3);
+   EXPECT_FALSE(queue.empty());
+
+   EXPECT_EQ(queue.tryPop(), 1);
+   EXPECT_EQ(queue.tryPop(), 2);
+   EXPECT_EQ(queue.tryPop(), 3);
+   EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, MoveOnlyItems_AreMovedThrough)
+{
+   MpscQueue<std::unique_ptr<int>> queue;
+   queue.push(std::make_unique<int>(7));
+   auto item = queue.tryPop();
+   ASSERT_TRUE(item.has_value());
+   EXPECT_EQ(**item, 7);
+}
+
+TEST(MpscQueueTest, Destructor_ReleasesQueuedItems)
+{
+   auto tracked = std::make_shared<int>(0);
+   {
+      MpscQueue<std::shared_ptr<int>> queue;
+      queue.push(tracked);
+      queue.push(tracked);
+      EXPECT_EQ(tracked.use_count(), 3);
+   }
+   EXPECT_EQ(tracked.use_count(), 1);
+}
+
+// ============================================================================
+// Concurrency
+// ============================================================================
+
+TEST(MpscQueueTest, ConcurrentProducers_EveryItemArrivesInProducerOrder)
+{
+   constexpr int PRODUCERS = 4;
+   constexpr int ITEMS = 20000;
+   MpscQueue<std::pair<int, int>> queue;
+
+   std::vector<std::thread> producers;
+   for (int p = 0; p < PRODUCERS; ++p)
+   {
+      producers.emplace_back([&queue, p] {
+         for (int i = 0; i < ITEMS; ++i)
+         {
+            queue.push({p, i});
+         }
+      });
+   }
+
+   std::vector<int> next(PRODUCERS, 0);
+   int received = 0;
+   bool ordered = true;
+   while (received < PRODUCERS * ITEMS)
+   {
+      auto item = queue.tryPop();
+      if (!item)
+      {
+         std::this_thread::yield();
+         continue;
+      }
+      ordered = ordered && (item->second == next[static_cast<std::size_t>(item->first)]);
+      ++next[static_cast<std::size_t>(item->first)];
+      ++received;
+   }
+   for (auto& producer : producers)
+   {
+      producer.join();
+   }
+
+   EXPECT_TRUE(ordered);
+   EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, Emplace_ConstructsInPlace)
+{
+   MpscQueue<std::pair<int, std::vector<int>>> queue;
+   queue.emplace(4, std::vector<int>{1, 2});
+   auto item = queue.tryPop();
+   ASSERT_TRUE(item.has_value());
+   EXPECT_EQ(item->first, 4);
+   EXPECT_EQ(item->second, (std::vector<int>{1, 2}));
+}
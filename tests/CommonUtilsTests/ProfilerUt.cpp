@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include "Profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using CommonUtils::Profiler;
+
+namespace
+{
+
+std::size_t countOf(const std::string& text, const std::string& needle)
+{
+   std::size_t count = 0;
+   for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1))
+   {
+      ++count;
+   }
+   return count;
+}
+
+// Start each test with recording off and nothing buffered.
+class ProfilerTest : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      Profiler::setEnabled(false);
+      Profiler::clear();
+   }
+
+   void TearDown() override
+   {
+      Profiler::setEnabled(false);
+      Profiler::clear();
+   }
+};
+
+} // namespace
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+TEST_F(ProfilerTest, Disabled_RecordsNothing)
+{
+   {
+      GPPROFILE_SCOPE("ProfilerTest.disabled");
+   }
+   EXPECT_EQ(Profiler::chromeTraceJson().find("ProfilerTest.disabled"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, Enabled_RecordsCompleteEventWithDuration)
+{
+   Profiler::setEnabled(true);
+   {
+      GPPROFILE_SCOPE("ProfilerTest.sleep");
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+   }
+   const std::string json = Profiler::chromeTraceJson();
+
+   const auto pos = json.find(R"("name":"ProfilerTest.sleep","ph":"X")");
+   ASSERT_NE(pos, std::string::npos) << json;
+   const auto durPos = json.find("\"dur\":", pos);
+   ASSERT_NE(durPos, std::string::npos);
+   EXPECT_GE(std::stod(json.substr(durPos + 6)), 2000.0); // Microseconds.
+}
+
+TEST_F(ProfilerTest, NestedScopes_AreAllRecorded)
+{
+   Profiler::setEnabled(true);
+   {
+      GPPROFILE_SCOPE("ProfilerTest.outer");
+      for (int i = 0; i < 3; ++i)
+      {
+         GPPROFILE_SCOPE("ProfilerTest.inner");
+      }
+   }
+   const std::string json = Profiler::chromeTraceJson();
+   EXPECT_EQ(countOf(json, "ProfilerTest.outer"), 1U);
+   EXPECT_EQ(countOf(json, "ProfilerTest.inner"), 3U);
+}
+
+TEST_F(ProfilerTest, Export_DrainsRecordedZones)
+{
+   Profiler::setEnabled(true);
+   {
+      GPPROFILE_SCOPE("ProfilerTest.once");
+   }
+   EXPECT_EQ(countOf(Profiler::chromeTraceJson(), "ProfilerTest.once"), 1U);
+   EXPECT_EQ(countOf(Profiler::chromeTraceJson(), "ProfilerTest.once"), 0U);
+}
+
+// ============================================================================
+// Threads
+// ============================================================================
+
+TEST_F(ProfilerTest, Threads_AreNamedAndKeptAfterExit)
+{
+   Profiler::setEnabled(true);
+   std::thread worker([] {
+      Profiler::setThreadName("Profiler \"worker\"");
+      for (int i = 0; i < 10; ++i)
+      {
+         GPPROFILE_SCOPE("ProfilerTest.worker");
+      }
+   });
+   worker.join();
+
+   const std::string json = Profiler::chromeTraceJson();
+   EXPECT_NE(json.find(R"("name":"thread_name")"), std::string::npos);
+   EXPECT_NE(json.find(R"(Profiler \"worker\")"), std::string::npos) << json;
+   EXPECT_EQ(countOf(json, "ProfilerTest.worker"), 10U);
+}
+
+TEST_F(ProfilerTest, FullBuffer_DropsAndCounts)
+{
+   Profiler::setEnabled(true);
+   std::thread worker([] {
+      for (std::size_t i = 0; i < Profiler::EVENTS_PER_THREAD + 100; ++i)
+      {
+         GPPROFILE_SCOPE("ProfilerTest.flood");
+      }
+   });
+   worker.join();
+
+   EXPECT_EQ(Profiler::droppedCount(), 100U);
+   EXPECT_EQ(countOf(Profiler::chromeTraceJson(), "ProfilerTest.flood"), Profiler::EVENTS_PER_THREAD);
+   Profiler::clear();
+   EXPECT_EQ(Profiler::droppedCount(), 0U);
+}
+
+// ============================================================================
+// File export
+// ============================================================================
+
+TEST_F(ProfilerTest, WriteChromeTrace_WritesJsonFile)
+{
+   Profiler::setEnabled(true);
+   {
+      GPPROFILE_SCOPE("ProfilerTest.file");
+   }
+   const std::string path = ::testing::TempDir() + "profiler_ut.json";
+   ASSERT_TRUE(Profiler::writeChromeTrace(path));
+
+   std::ifstream file(path);
+   std::stringstream contents;
+   contents << file.rdbuf();
+   EXPECT_EQ(contents.str().rfind("{\"displayTimeUnit\"", 0), 0U);
+   EXPECT_NE(contents.str().find("ProfilerTest.file"), std::string::npos);
+   std::remove(path.c_str());
+
+   EXPECT_FALSE(Profiler::writeChromeTrace("/nonexistent-dir/profile.json"));
+}
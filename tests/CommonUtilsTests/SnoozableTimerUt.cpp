@@ -191,3 +191,28 @@ TEST_F(SnoozableTimerTest, SnoozeTimeoutSnoozeAgain) {
     std::this_thread::sleep_for(std::chrono::milliseconds(110));
     EXPECT_EQ(snExecutionCount, 2);
 }
+
+// Test snoozing on a shared wheel
+TEST_F(SnoozableTimerTest, WheelBackedSnooze) {
+    CommonUtils::TimerWheel wheel;
+    SnoozableTimer executor(_incrementCount, 100, &wheel);
+    executor.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    executor.snooze();
+    std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    EXPECT_EQ(snExecutionCount, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_EQ(snExecutionCount, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(110));
+    EXPECT_EQ(snExecutionCount, 1);
+
+    executor.updateSnoozePeriod(50);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(snExecutionCount, 2);
+    executor.stop();
+    EXPECT_EQ(wheel.timerCount(), 0U);
+
+    executor.snooze(); // Stopped: no effect.
+    std::this_thread::sleep_for(std::chrono::milliseconds(110));
+    EXPECT_EQ(snExecutionCount, 2);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include "SpscRingBuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using CommonUtils::SpscRingBuffer;
+
+// ============================================================================
+// Single thread
+// ============================================================================
+
+TEST(SpscRingBufferTest, Capacity_RoundsUpToPowerOfTwo)
+{
+   SpscRingBuffer<int> ring(100);
+   EXPECT_EQ(ring.capacity(), 128U);
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.freeSpace(), 128U);
+
+   const SpscRingBuffer<int> unallocated;
+   EXPECT_EQ(unallocated.capacity(), 0U);
+}
+
+TEST(SpscRingBufferTest, WriteRead_PreservesOrderAcrossWrap)
+{
+   SpscRingBuffer<int> ring(8);
+   std::vector<int> out(8);
+   int next = 0;
+   int expected = 0;
+   for (int round = 0; round < 10; ++round)
+   {
+      std::vector<int> in(5);
+      for (auto& value : in)
+      {
+         value = next++;
+      }
+      ASSERT_EQ(ring.write(in.data(), in.size()), 5U);
+      ASSERT_EQ(ring.read(out.data(), 5), 5U);
+      for (std::size_t i = 0; i < 5; ++i)
+      {
+         EXPECT_EQ(out[i], expected++);
+      }
+   }
+   EXPECT_EQ(ring.writeCount(), 50U);
+   EXPECT_EQ(ring.readCount(), 50U);
+}
+
+TEST(SpscRingBufferTest, Write_FullRing_WritesOnlyWhatFits)
+{
+   SpscRingBuffer<int> ring(4);
+   const std::vector<int> in{1, 2, 3, 4, 5, 6};
+   EXPECT_EQ(ring.write(in.data(), in.size()), 4U);
+   EXPECT_EQ(ring.freeSpace(), 0U);
+
+   std::vector<int> out(6);
+   EXPECT_EQ(ring.read(out.data(), out.size()), 4U);
+   EXPECT_EQ(std::vector<int>(out.begin(), out.begin() + 4), (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(SpscRingBufferTest, PrepareCommit_SplitsAtWrapPoint)
+{
+   SpscRingBuffer<int> ring(8);
+   const std::vector<int> six(6, 0);
+   ring.write(six.data(), six.size());
+   ring.consume(6);
+
+   auto regions = ring.prepareWrite(5);
+   ASSERT_EQ(regions.first.size(), 2U);
+   ASSERT_EQ(regions.second.size(), 3U);
+   int value = 10;
+   for (int& slot : regions.first)
+   {
+      slot = value++;
+   }
+   for (int& slot : regions.second)
+   {
+      slot = value++;
+   }
+   EXPECT_EQ(ring.available(), 0U);
+   ring.commitWrite(regions.size());
+
+   const auto read = ring.peek(8);
+   ASSERT_EQ(read.size(), 5U);
+   std::vector<int> joined(read.first.begin(), read.first.end());
+   joined.insert(joined.end(), read.second.begin(), read.second.end());
+   EXPECT_EQ(joined, (std::vector<int>{10, 11, 12, 13, 14}));
+   EXPECT_EQ(ring.available(), 5U);
+
+   ring.consume(2);
+   EXPECT_EQ(ring.peek(8).first.front(), 12);
+}
+
+TEST(SpscRingBufferTest, Drain_DiscardsReadableElements)
+{
+   SpscRingBuffer<int> ring(4);
+   const std::vector<int> in{1, 2, 3};
+   ring.write(in.data(), in.size());
+   ring.drain();
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.peek(4).size(), 0U);
+}
+
+// ============================================================================
+// Concurrency
+// ============================================================================
+
+TEST(SpscRingBufferTest, ProducerConsumer_StreamArrivesIntact)
+{
+   constexpr std::uint32_t TOTAL = 500000;
+   SpscRingBuffer<std::uint32_t> ring(1024);
+
+   std::thread producer([&ring] {
+      std::uint32_t next = 0;
+      while (next < TOTAL)
+      {
+         auto regions = ring.prepareWrite(std::min<std::uint32_t>(97, TOTAL - next));
+         for (auto& slot : regions.first)
+         {
+            slot = next++;
+         }
+         for (auto& slot : regions.second)
+         {
+            slot = next++;
+         }
+         ring.commitWrite(regions.size());
+         if (regions.size() == 0)
+         {
+            std::this_thread::yield();
+         }
+      }
+   });
+
+   std::uint32_t expected = 0;
+   bool intact = true;
+   while (expected < TOTAL)
+   {
+      const auto regions = ring.peek(256);
+      for (const auto value : regions.first)
+      {
+         intact = intact && (value == expected++);
+      }
+      for (const auto value : regions.second)
+      {
+         intact = intact && (value == expected++);
+      }
+      ring.consume(regions.size());
+      if (regions.size() == 0)
+      {
+         std::this_thread::yield();
+      }
+   }
+   producer.join();
+
+   EXPECT_TRUE(intact);
+   EXPECT_EQ(ring.available(), 0U);
+}
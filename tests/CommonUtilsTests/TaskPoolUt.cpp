@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using CommonUtils::TaskPool;
+using CommonUtils::TaskPriority;
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+TEST(TaskPoolTest, Constructor_StartsAtLeastOneThread)
+{
+   const TaskPool pool(0);
+   EXPECT_EQ(pool.threadCount(), 1U);
+}
+
+TEST(TaskPoolTest, Shared_IsOneInstanceWithSeveralThreads)
+{
+   EXPECT_EQ(&TaskPool::shared(), &TaskPool::shared());
+   EXPECT_GE(TaskPool::shared().threadCount(), 2U);
+}
+
+// ============================================================================
+// post()
+// ============================================================================
+
+TEST(TaskPoolTest, Post_RunsEveryTaskOnPoolThreads)
+{
+   constexpr int TASKS = 200;
+   std::mutex mtx;
+   std::condition_variable cv;
+   std::set<std::thread::id> threads;
+   int done = 0;
+   {
+      TaskPool pool(3);
+      for (int i = 0; i < TASKS; ++i)
+      {
+         pool.post([&] {
+            const std::lock_guard<std::mutex> lk(mtx);
+            threads.insert(std::this_thread::get_id());
+            ++done;
+            cv.notify_all();
+         });
+      }
+      std::unique_lock<std::mutex> lk(mtx);
+      ASSERT_TRUE(cv.wait_for(lk, std::chrono::seconds(2), [&] { return done == TASKS; }));
+   }
+   EXPECT_EQ(threads.count(std::this_thread::get_id()), 0U);
+   EXPECT_LE(threads.size(), 3U);
+}
+
+TEST(TaskPoolTest, Destructor_RunsTasksStillQueued)
+{
+   std::atomic<int> done{0};
+   {
+      TaskPool pool(1);
+      pool.post([] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+      for (int i = 0; i < 10; ++i)
+      {
+         pool.post([&] { done.fetch_add(1); });
+      }
+   }
+   EXPECT_EQ(done.load(), 10);
+}
+
+TEST(TaskPoolTest, Post_FromTask_IsAccepted)
+{
+   std::atomic<bool> inner{false};
+   {
+      TaskPool pool(1);
+      pool.post([&] { pool.post([&] { inner.store(true); }); });
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+      while (!inner.load() && std::chrono::steady_clock::now() < deadline)
+      {
+         std::this_thread::yield();
+      }
+   }
+   EXPECT_TRUE(inner.load());
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+TEST(TaskPoolTest, Priorities_MostUrgentQueuedTaskRunsFirst)
+{
+   std::mutex mtx;
+   std::condition_variable cv;
+   bool release = false;
+   std::vector<std::string> order;
+   {
+      TaskPool pool(1);
+      pool.post([&] {
+         std::unique_lock<std::mutex> lk(mtx);
+         cv.wait(lk, [&] { return release; });
+      });
+      const auto record = [&](const char* name) {
+         return [&, name] {
+            const std::lock_guard<std::mutex> lk(mtx);
+            order.emplace_back(name);
+         };
+      };
+      pool.post(record("housekeeping"), {TaskPriority::Housekeeping});
+      pool.post(record("display"));
+      pool.post(record("realtime"), {TaskPriority::RealTime});
+      {
+         const std::lock_guard<std::mutex> lk(mtx);
+         release = true;
+      }
+      cv.notify_all();
+   }
+   EXPECT_EQ(order, (std::vector<std::string>{"realtime", "display", "housekeeping"}));
+}
+
+TEST(TaskPoolTest, PinnedTasks_RunInOrderOnTheirWorker)
+{
+   constexpr int TASKS = 100;
+   std::mutex mtx;
+   std::set<std::thread::id> threads;
+   std::vector<int> order;
+   {
+      TaskPool pool(3);
+      for (int i = 0; i < TASKS; ++i)
+      {
+         pool.post([&, i] {
+            const std::lock_guard<std::mutex> lk(mtx);
+            threads.insert(std::this_thread::get_id());
+            order.push_back(i);
+         }, {TaskPriority::RealTime, 1});
+      }
+   }
+   EXPECT_EQ(threads.size(), 1U);
+   ASSERT_EQ(order.size(), static_cast<size_t>(TASKS));
+   EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST(TaskPoolTest, IdleWorkers_StealFromBusyOne)
+{
+   constexpr int TASKS = 64;
+   std::mutex mtx;
+   std::set<std::thread::id> threads;
+   std::atomic<int> done{0};
+   TaskPool pool(4);
+   // Posted from a worker, every task lands on that worker's own deque.
+   pool.post([&] {
+      for (int i = 0; i < TASKS; ++i)
+      {
+         pool.post([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            const std::lock_guard<std::mutex> lk(mtx);
+            threads.insert(std::this_thread::get_id());
+            done.fetch_add(1);
+         });
+      }
+   });
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (done.load() < TASKS && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   EXPECT_EQ(done.load(), TASKS);
+   EXPECT_GT(pool.stealCount(), 0U);
+   const std::lock_guard<std::mutex> lk(mtx);
+   EXPECT_GT(threads.size(), 1U);
+}
+
+// ============================================================================
+// Continuations
+// ============================================================================
+
+TEST(TaskPoolTest, Then_ChainsContinuationsInOrder)
+{
+   TaskPool pool(3);
+   std::mutex mtx;
+   std::vector<int> order;
+   const auto step = [&](int n) {
+      return [&, n] {
+         std::this_thread::sleep_for(std::chrono::milliseconds(2));
+         const std::lock_guard<std::mutex> lk(mtx);
+         order.push_back(n);
+      };
+   };
+   const auto last = pool.submit(step(1))
+                        .then(step(2), {TaskPriority::RealTime})
+                        .then(step(3), {TaskPriority::Housekeeping});
+   ASSERT_TRUE(last.valid());
+   last.wait();
+   EXPECT_TRUE(last.done());
+   const std::lock_guard<std::mutex> lk(mtx);
+   EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TaskPoolTest, Then_OnFinishedTask_PostsImmediately)
+{
+   TaskPool pool(1);
+   const auto first = pool.submit([] {});
+   first.wait();
+
+   std::atomic<bool> ran{false};
+   first.then([&] { ran.store(true); }).wait();
+   EXPECT_TRUE(ran.load());
+   EXPECT_FALSE(CommonUtils::TaskHandle{}.valid());
+}
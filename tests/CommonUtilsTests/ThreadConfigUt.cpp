@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "ThreadConfig.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using CommonUtils::ThreadConfig;
+using CommonUtils::ThreadSettings;
+
+namespace
+{
+
+class ThreadConfigTest : public ::testing::Test
+{
+protected:
+   void SetUp() override { ThreadConfig::instance().clear(); }
+   void TearDown() override { ThreadConfig::instance().clear(); }
+};
+
+} // namespace
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+TEST_F(ThreadConfigTest, SettingsFor_UnconfiguredRoleIsEmpty)
+{
+   EXPECT_FALSE(ThreadConfig::instance().settingsFor("SdrEngine.fft").has_value());
+}
+
+TEST_F(ThreadConfigTest, SettingsFor_ExactBeatsLongestPrefixBeatsShorterPrefix)
+{
+   auto& config = ThreadConfig::instance();
+   config.set("*", ThreadSettings{{0}, -1, 0});
+   config.set("SdrEngine.*", ThreadSettings{{1}, -1, 0});
+   config.set("SdrEngine.f*", ThreadSettings{{2}, -1, 0});
+   config.set("SdrEngine.fft", ThreadSettings{{3}, -1, 10});
+
+   EXPECT_EQ(config.settingsFor("SdrEngine.fft")->cpus, std::vector<int>{3});
+   EXPECT_EQ(config.settingsFor("SdrEngine.fftExtra")->cpus, std::vector<int>{2});
+   EXPECT_EQ(config.settingsFor("SdrEngine.vfo")->cpus, std::vector<int>{1});
+   EXPECT_EQ(config.settingsFor("PubSub.x.receive")->cpus, std::vector<int>{0});
+}
+
+TEST_F(ThreadConfigTest, Set_ReplacesExistingEntry)
+{
+   auto& config = ThreadConfig::instance();
+   config.set("SoapySdr.stream", ThreadSettings{{1}, -1, 0});
+   config.set("SoapySdr.stream", ThreadSettings{{}, 0, 80});
+
+   const auto settings = config.settingsFor("SoapySdr.stream");
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(*settings, (ThreadSettings{{}, 0, 80}));
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+TEST_F(ThreadConfigTest, Load_ParsesRolesCpuListsNumaAndPriority)
+{
+   auto& config = ThreadConfig::instance();
+   std::string error;
+   ASSERT_TRUE(config.load("# stream thread first\n"
+                           "SoapySdr.stream   cpus=2 priority=80\n"
+                           "\n"
+                           "SdrEngine.*       numa=0   # whole node\n"
+                           "DataHandler.*     cpus=4-7,12\r\n",
+                           &error)) << error;
+
+   EXPECT_EQ(*config.settingsFor("SoapySdr.stream"), (ThreadSettings{{2}, -1, 80}));
+   EXPECT_EQ(*config.settingsFor("SdrEngine.fft"), (ThreadSettings{{}, 0, 0}));
+   EXPECT_EQ(*config.settingsFor("DataHandler.SdrEngine.iq"), (ThreadSettings{{4, 5, 6, 7, 12}, -1, 0}));
+}
+
+TEST_F(ThreadConfigTest, Load_RejectsMalformedLinesAndAddsNothing)
+{
+   auto& config = ThreadConfig::instance();
+   for (const char* bad : {"A cpus=\n", "A cpus=3-1\n", "A cpus=x\n", "A numa=-1\n",
+                           "A priority=100\n", "A colour=red\n", "A cpus\n"})
+   {
+      std::string error;
+      EXPECT_FALSE(config.load(std::string("Good cpus=0\n") + bad, &error)) << bad;
+      EXPECT_NE(error.find("line 2"), std::string::npos) << error;
+      EXPECT_FALSE(config.settingsFor("Good").has_value());
+   }
+}
+
+TEST_F(ThreadConfigTest, LoadFile_ReadsFileAndReportsMissingFile)
+{
+   const std::string path = ::testing::TempDir() + "thread_config_ut.conf";
+   {
+      std::ofstream file(path);
+      file << "TaskPool cpus=0\n";
+   }
+   auto& config = ThreadConfig::instance();
+   EXPECT_TRUE(config.loadFile(path));
+   EXPECT_TRUE(config.settingsFor("TaskPool").has_value());
+   std::remove(path.c_str());
+
+   std::string error;
+   EXPECT_FALSE(config.loadFile("/nonexistent-dir/threads.conf", &error));
+   EXPECT_FALSE(error.empty());
+}
+
+// ============================================================================
+// Applying
+// ============================================================================
+
+#ifdef __linux__
+TEST_F(ThreadConfigTest, ApplyToCurrentThread_SetsNameAndAffinity)
+{
+   ThreadConfig::instance().set("ThreadConfigTest.pinned", ThreadSettings{{0}, -1, 0});
+
+   bool applied = false;
+   std::string name;
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   std::thread worker([&] {
+      applied = CommonUtils::configureCurrentThread("ThreadConfigTest.pinned");
+      char buffer[16] = {};
+      pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+      name = buffer;
+      pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+   });
+   worker.join();
+
+   EXPECT_TRUE(applied);
+   EXPECT_EQ(name, "ThreadConfigTes"); // OS names are capped at 15 characters.
+   EXPECT_EQ(CPU_COUNT(&set), 1);
+   EXPECT_TRUE(CPU_ISSET(0, &set));
+}
+
+TEST_F(ThreadConfigTest, Apply_ConfiguresAnotherThread)
+{
+   ThreadConfig::instance().set("Other", ThreadSettings{{0}, -1, 0});
+   std::atomic<bool> release{false};
+   std::thread worker([&release] {
+      while (!release)
+      {
+         std::this_thread::yield();
+      }
+   });
+
+   EXPECT_TRUE(ThreadConfig::instance().apply(worker, "Other"));
+   char buffer[16] = {};
+   pthread_getname_np(worker.native_handle(), buffer, sizeof(buffer));
+   EXPECT_STREQ(buffer, "Other");
+   release = true;
+   worker.join();
+}
+
+TEST_F(ThreadConfigTest, Apply_MissingNumaNodeFailsButThreadRuns)
+{
+   ThreadConfig::instance().set("Numa", ThreadSettings{{}, 4096, 0});
+   bool applied = true;
+   std::thread worker([&applied] { applied = CommonUtils::configureCurrentThread("Numa"); });
+   worker.join();
+   EXPECT_FALSE(applied);
+}
+#endif
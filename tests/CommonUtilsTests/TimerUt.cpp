@@ -50,3 +50,39 @@ TEST(TimerTest, Cancel)
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
     EXPECT_FALSE(flag);
 }
+
+// Test one-time and periodic execution on a shared wheel
+TEST(TimerTest, WheelBackedExecution)
+{
+    CommonUtils::TimerWheel wheel;
+    CommonUtils::Timer oneShot(&wheel);
+    CommonUtils::Timer periodic(&wheel);
+    std::atomic<bool> flag{false};
+    std::atomic<int> counter{0};
+
+    oneShot.startOneShot([&flag]()
+    {
+        flag = true;
+    }, 100);
+    periodic.startPeriodic([&counter]()
+    {
+        ++counter;
+    }, 100);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(450));
+    periodic.stop();
+    EXPECT_TRUE(flag);
+    EXPECT_GE(counter, 3);
+
+    // Restarting a fired one-shot reuses the wheel without leaking a timer.
+    flag = false;
+    oneShot.startOneShot([&flag]()
+    {
+        flag = true;
+    }, 500);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    oneShot.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_FALSE(flag);
+    EXPECT_EQ(wheel.timerCount(), 0U);
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include "TimerWheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using CommonUtils::TimerWheel;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Poll until `done()` or the timeout; returns the final `done()`.
+template <typename Predicate>
+bool waitFor(Predicate done, std::chrono::milliseconds timeout = 2000ms)
+{
+   const auto deadline = std::chrono::steady_clock::now() + timeout;
+   while (!done() && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(1ms);
+   }
+   return done();
+}
+
+} // namespace
+
+// ============================================================================
+// schedule()
+// ============================================================================
+
+TEST(TimerWheelTest, Schedule_OneShotFiresOnceAfterDelay)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto start = std::chrono::steady_clock::now();
+   std::atomic<std::chrono::steady_clock::time_point> firedAt{start};
+
+   const auto id = wheel.schedule(50ms, [&] {
+      firedAt = std::chrono::steady_clock::now();
+      ++calls;
+   });
+   EXPECT_NE(id, TimerWheel::INVALID_TIMER);
+
+   ASSERT_TRUE(waitFor([&] { return calls.load() == 1; }));
+   EXPECT_GE(firedAt.load() - start, 50ms);
+   std::this_thread::sleep_for(100ms);
+   EXPECT_EQ(calls.load(), 1);
+   EXPECT_EQ(wheel.timerCount(), 1U); // Idle, still registered.
+}
+
+TEST(TimerWheelTest, Schedule_PeriodicFiresRepeatedly)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto id = wheel.schedule(20ms, [&] { ++calls; }, 20ms);
+
+   std::this_thread::sleep_for(230ms);
+   EXPECT_TRUE(wheel.cancel(id));
+   EXPECT_GE(calls.load(), 8);
+   EXPECT_LE(calls.load(), 12);
+}
+
+TEST(TimerWheelTest, Schedule_DelayBeyondFirstLevelCascades)
+{
+   // 300 ticks lands on the second level and must move down to fire.
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto start = std::chrono::steady_clock::now();
+   wheel.schedule(300ms, [&] { ++calls; });
+
+   std::this_thread::sleep_for(250ms);
+   EXPECT_EQ(calls.load(), 0);
+   ASSERT_TRUE(waitFor([&] { return calls.load() == 1; }));
+   EXPECT_GE(std::chrono::steady_clock::now() - start, 300ms);
+}
+
+TEST(TimerWheelTest, Schedule_ManyTimersAllFireInOrder)
+{
+   TimerWheel wheel;
+   std::mutex mtx;
+   std::vector<int> order;
+   for (int i = 9; i >= 0; --i)
+   {
+      wheel.schedule(std::chrono::milliseconds(10 + (i * 30)), [&, i] {
+         const std::lock_guard<std::mutex> lk(mtx);
+         order.push_back(i);
+      });
+   }
+
+   ASSERT_TRUE(waitFor([&] {
+      const std::lock_guard<std::mutex> lk(mtx);
+      return order.size() == 10;
+   }));
+   for (int i = 0; i < 10; ++i)
+   {
+      EXPECT_EQ(order[static_cast<std::size_t>(i)], i);
+   }
+}
+
+// ============================================================================
+// reschedule() / disarm() / cancel()
+// ============================================================================
+
+TEST(TimerWheelTest, Reschedule_DefersPendingTimer)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto id = wheel.schedule(60ms, [&] { ++calls; });
+
+   for (int i = 0; i < 5; ++i)
+   {
+      std::this_thread::sleep_for(30ms);
+      EXPECT_TRUE(wheel.reschedule(id, 60ms));
+   }
+   EXPECT_EQ(calls.load(), 0);
+   ASSERT_TRUE(waitFor([&] { return calls.load() == 1; }));
+}
+
+TEST(TimerWheelTest, Reschedule_RearmsFiredOneShot)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto id = wheel.schedule(10ms, [&] { ++calls; });
+   ASSERT_TRUE(waitFor([&] { return calls.load() == 1; }));
+
+   EXPECT_TRUE(wheel.reschedule(id, 10ms));
+   ASSERT_TRUE(waitFor([&] { return calls.load() == 2; }));
+}
+
+TEST(TimerWheelTest, Reschedule_UnknownIdFails)
+{
+   TimerWheel wheel;
+   EXPECT_FALSE(wheel.reschedule(12345, 10ms));
+   EXPECT_FALSE(wheel.setPeriod(12345, 10ms));
+   EXPECT_FALSE(wheel.disarm(12345));
+   EXPECT_FALSE(wheel.cancel(12345));
+}
+
+TEST(TimerWheelTest, Disarm_StopsCallsButKeepsTimer)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto id = wheel.schedule(50ms, [&] { ++calls; });
+   EXPECT_TRUE(wheel.disarm(id));
+
+   std::this_thread::sleep_for(100ms);
+   EXPECT_EQ(calls.load(), 0);
+   EXPECT_EQ(wheel.timerCount(), 1U);
+}
+
+TEST(TimerWheelTest, Cancel_PreventsCallAndUnregisters)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   const auto id = wheel.schedule(50ms, [&] { ++calls; });
+   EXPECT_TRUE(wheel.cancel(id));
+   EXPECT_EQ(wheel.timerCount(), 0U);
+
+   std::this_thread::sleep_for(100ms);
+   EXPECT_EQ(calls.load(), 0);
+   EXPECT_FALSE(wheel.cancel(id));
+}
+
+TEST(TimerWheelTest, Cancel_FromOwnCallbackDoesNotDeadlock)
+{
+   TimerWheel wheel;
+   std::atomic<int> calls{0};
+   std::atomic<TimerWheel::TimerId> id{TimerWheel::INVALID_TIMER};
+   id = wheel.schedule(10ms, [&] {
+      ++calls;
+      wheel.cancel(id.load());
+   }, 10ms);
+
+   ASSERT_TRUE(waitFor([&] { return wheel.timerCount() == 0; }));
+   std::this_thread::sleep_for(50ms);
+   EXPECT_EQ(calls.load(), 1);
+}
+
+TEST(TimerWheelTest, Cancel_WaitsForRunningCallback)
+{
+   TimerWheel wheel(1ms, 2);
+   std::atomic<bool> entered{false};
+   std::atomic<bool> finished{false};
+   const auto id = wheel.schedule(1ms, [&] {
+      entered = true;
+      std::this_thread::sleep_for(50ms);
+      finished = true;
+   });
+
+   ASSERT_TRUE(waitFor([&] { return entered.load(); }));
+   EXPECT_TRUE(wheel.cancel(id));
+   EXPECT_TRUE(finished.load());
+}
+
+// ============================================================================
+// Callback threads
+// ============================================================================
+
+TEST(TimerWheelTest, CallbackThreads_SlowCallbackDoesNotDelayOthers)
+{
+   TimerWheel wheel(1ms, 2);
+   std::atomic<bool> release{false};
+   std::atomic<int> fast{0};
+   wheel.schedule(5ms, [&] {
+      while (!release)
+      {
+         std::this_thread::sleep_for(1ms);
+      }
+   });
+   wheel.schedule(20ms, [&] { ++fast; }, 20ms);
+
+   EXPECT_TRUE(waitFor([&] { return fast.load() >= 3; }, 500ms));
+   release = true;
+}
+
+TEST(TimerWheelTest, Shared_IsOneInstance)
+{
+   EXPECT_EQ(&TimerWheel::shared(), &TimerWheel::shared());
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using CommonUtils::WorkerPool;
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+TEST(WorkerPoolTest, Constructor_StartsRequestedWorkers)
+{
+   const WorkerPool pool(3);
+   EXPECT_EQ(pool.workerCount(), 3U);
+}
+
+TEST(WorkerPoolTest, DefaultWorkerCount_LeavesOneThreadForCaller)
+{
+   const auto hardware = std::thread::hardware_concurrency();
+   if (hardware > 1)
+   {
+      EXPECT_EQ(WorkerPool::defaultWorkerCount(), hardware - 1);
+   }
+   else
+   {
+      EXPECT_EQ(WorkerPool::defaultWorkerCount(), 0U);
+   }
+}
+
+// ============================================================================
+// run()
+// ============================================================================
+
+TEST(WorkerPoolTest, Run_CallsEveryIndexExactlyOnce)
+{
+   WorkerPool pool(4);
+   std::vector<std::atomic<int>> calls(100);
+   pool.run(calls.size(), [&calls](std::size_t i) { ++calls[i]; });
+   for (const auto& count : calls)
+   {
+      EXPECT_EQ(count.load(), 1);
+   }
+}
+
+TEST(WorkerPoolTest, Run_NoWorkers_RunsInlineOnCaller)
+{
+   WorkerPool pool(0);
+   const auto caller = std::this_thread::get_id();
+   int calls = 0;
+   pool.run(5, [&](std::size_t)
+   {
+      EXPECT_EQ(std::this_thread::get_id(), caller);
+      ++calls;
+   });
+   EXPECT_EQ(calls, 5);
+}
+
+TEST(WorkerPoolTest, Run_ZeroTasks_ReturnsImmediately)
+{
+   WorkerPool pool(2);
+   bool called = false;
+   pool.run(0, [&called](std::size_t) { called = true; });
+   EXPECT_FALSE(called);
+}
+
+TEST(WorkerPoolTest, Run_SpreadsTasksAcrossThreads)
+{
+   WorkerPool pool(3);
+   std::mutex mutex;
+   std::set<std::thread::id> threads;
+   pool.run(4, [&](std::size_t)
+   {
+      // Long enough that one thread cannot take every task.
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      const std::lock_guard<std::mutex> lock(mutex);
+      threads.insert(std::this_thread::get_id());
+   });
+   EXPECT_GT(threads.size(), 1U);
+}
+
+TEST(WorkerPoolTest, Run_RepeatedRuns_WaitForCompletion)
+{
+   WorkerPool pool(2);
+   std::atomic<int> total{0};
+   for (int round = 0; round < 200; ++round)
+   {
+      pool.run(3, [&total](std::size_t) { ++total; });
+      EXPECT_EQ(total.load(), (round + 1) * 3);
+   }
+}
@@ -6,7 +6,19 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
 #include "HighBandwidthPublisher.h"
+#include "HighBandwidthSubscriber.h"
 
 class HighBandwidthPublisherTest : public ::testing::Test
 {
@@ -22,6 +34,92 @@ protected:
    {
    }
 
+   // Helpers to call private methods
+   static bool callSendFragments(HighBandwidthPublisher& pub, const std::string& topic,
+                                 const std::string& payload)
+   {
+      return pub.sendFragments(topic, reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+   }
+   static void callDisableGso(HighBandwidthPublisher& pub) { pub.disableGso(0); }
+   static int getSocket(const HighBandwidthPublisher& pub) { return pub._socket; }
+
+   // Bind a plain UDP socket on 127.0.0.1 to capture the publisher's datagrams.
+   static int openReceiver(uint16_t port)
+   {
+      const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+      const int rcvbuf = 4 * 1024 * 1024;
+      setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+      {
+         close(sock);
+         return -1;
+      }
+      return sock;
+   }
+
+   // Read datagrams until `count` have arrived or nothing comes for 500 ms.
+   static std::vector<std::vector<uint8_t>> receive(int sock, size_t count)
+   {
+      std::vector<std::vector<uint8_t>> datagrams;
+      std::vector<uint8_t> buffer(65536);
+      pollfd pfd{sock, POLLIN, 0};
+      while (datagrams.size() < count && poll(&pfd, 1, 500) > 0)
+      {
+         const ssize_t len = recv(sock, buffer.data(), buffer.size(), 0);
+         if (len < 0)
+         {
+            break;
+         }
+         datagrams.emplace_back(buffer.begin(), buffer.begin() + len);
+      }
+      return datagrams;
+   }
+
+   // Check sizes and headers of one message's fragments and reassemble them.
+   static void expectMessage(const std::vector<std::vector<uint8_t>>& datagrams, size_t mtu,
+                             const std::string& topic, const std::string& payload)
+   {
+      ASSERT_FALSE(datagrams.empty());
+      std::string reassembled;
+      for (size_t i = 0; i < datagrams.size(); ++i)
+      {
+         const auto& datagram = datagrams[i];
+         ASSERT_GE(datagram.size(), sizeof(FragmentHeader));
+         if (i + 1 < datagrams.size())
+         {
+            EXPECT_EQ(datagram.size(), mtu) << "fragment " << i;
+         }
+         FragmentHeader header{};
+         std::memcpy(&header, datagram.data(), sizeof(header));
+         EXPECT_EQ(header.fragmentNum, i);
+         EXPECT_EQ(header.totalFragments, datagrams.size());
+         size_t offset = sizeof(FragmentHeader);
+         if (i == 0)
+         {
+            ASSERT_EQ(header.topicLen, topic.size());
+            EXPECT_EQ(std::string(datagram.begin() + sizeof(FragmentHeader),
+                                  datagram.begin() + static_cast<long>(offset + topic.size())), topic);
+            offset += topic.size();
+         }
+         reassembled.append(datagram.begin() + static_cast<long>(offset), datagram.end());
+      }
+      EXPECT_EQ(reassembled, payload);
+   }
+
+   static std::string makePayload(size_t size)
+   {
+      std::string payload(size, '\0');
+      for (size_t i = 0; i < size; ++i)
+      {
+         payload[i] = static_cast<char>((i * 31) + (i >> 8));
+      }
+      return payload;
+   }
+
    uint16_t _testPort;
    std::string _testMulticastAddr;
 };
@@ -64,3 +162,279 @@ TEST_F(HighBandwidthPublisherTest, Port_ReturnsCorrectPort)
    // Act & Assert
    EXPECT_EQ(publisher.port(), customPort);
 }
+
+TEST_F(HighBandwidthPublisherTest, SendFragments_LargeMessage_ArrivesAsMtuSizedFragments)
+{
+   // Arrange: 200 fragments, several GSO super-datagrams when offload is on
+   const uint16_t port = 15672;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 512);
+   const std::string payload = makePayload(100'000);
+
+   // Act
+   ASSERT_TRUE(callSendFragments(publisher, "big", payload));
+   const auto datagrams = receive(receiver, 201);
+   close(receiver);
+
+   // Assert
+   EXPECT_EQ(datagrams.size(), 201U);
+   expectMessage(datagrams, 512, "ns/big", payload);
+}
+
+TEST_F(HighBandwidthPublisherTest, SendFragments_WithoutGso_SendsSameFragments)
+{
+   // Arrange
+   const uint16_t port = 15673;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 512);
+   callDisableGso(publisher);
+   const std::string payload = makePayload(30'000);
+
+   // Act
+   ASSERT_TRUE(callSendFragments(publisher, "big", payload));
+   const auto datagrams = receive(receiver, 61);
+   close(receiver);
+
+   // Assert
+   EXPECT_FALSE(publisher.gsoEnabled());
+   EXPECT_EQ(datagrams.size(), 61U);
+   expectMessage(datagrams, 512, "ns/big", payload);
+}
+
+TEST_F(HighBandwidthPublisherTest, SendFragments_SmallMessage_IsOneDatagram)
+{
+   // Arrange
+   const uint16_t port = 15674;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port);
+
+   // Act
+   ASSERT_TRUE(callSendFragments(publisher, "small", "hello"));
+   const auto datagrams = receive(receiver, 1);
+   close(receiver);
+
+   // Assert
+   ASSERT_EQ(datagrams.size(), 1U);
+   expectMessage(datagrams, 1400, "ns/small", "hello");
+}
+
+TEST_F(HighBandwidthPublisherTest, SendFragments_WithFec_AppendsXorParityPerGroup)
+{
+   // Arrange: 61 data fragments in groups of 8 -> 8 parity fragments
+   const uint16_t port = 15675;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 512);
+   publisher.setFecGroupSize(8);
+   const std::string payload = makePayload(30'000);
+
+   // Act
+   ASSERT_TRUE(callSendFragments(publisher, "big", payload));
+   const auto datagrams = receive(receiver, 69);
+   close(receiver);
+
+   // Assert - each parity body is the XOR of its group's bodies
+   ASSERT_EQ(datagrams.size(), 69U);
+   EXPECT_EQ(publisher.parityFragmentsSent(), 8U);
+   for (size_t group = 0; group < 8; ++group)
+   {
+      const auto& parity = datagrams[61 + group];
+      FragmentHeader header{};
+      std::memcpy(&header, parity.data(), sizeof(header));
+      EXPECT_EQ(header.fec, FEC_PARITY_FLAG | 8);
+      EXPECT_EQ(header.fragmentNum, group);
+      EXPECT_LE(parity.size(), 512U);
+      std::vector<uint8_t> expected(parity.size() - sizeof(FragmentHeader), 0);
+      uint16_t lengthXor = 0;
+      for (size_t i = group * 8; i < std::min<size_t>(61, (group + 1) * 8); ++i)
+      {
+         for (size_t b = sizeof(FragmentHeader); b < datagrams[i].size(); ++b)
+         {
+            expected[b - sizeof(FragmentHeader)] ^= datagrams[i][b];
+         }
+         lengthXor ^= static_cast<uint16_t>(datagrams[i].size() - sizeof(FragmentHeader));
+      }
+      EXPECT_EQ(header.topicLen, lengthXor);
+      EXPECT_TRUE(std::equal(expected.begin(), expected.end(), parity.begin() + sizeof(FragmentHeader)));
+   }
+}
+
+TEST_F(HighBandwidthPublisherTest, Fec_SubscriberRebuildsDroppedFragments)
+{
+   // Arrange: capture the datagrams, then replay them minus one per group
+   const uint16_t capturePort = 15676;
+   const uint16_t subscriberPort = 15677;
+   const int receiver = openReceiver(capturePort);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", capturePort, 512);
+   publisher.setFecGroupSize(4);
+   const std::string payload = makePayload(5'000);
+   ASSERT_TRUE(callSendFragments(publisher, "fec", payload));
+   const auto datagrams = receive(receiver, 14);
+   close(receiver);
+   ASSERT_EQ(datagrams.size(), 14U);   // 11 data + 3 parity
+
+   HighBandwidthSubscriber subscriber("ns", "239.192.100.3", subscriberPort);
+   std::atomic<bool> delivered{false};
+   std::string received;
+   subscriber.subscribe("fec", [&](const std::string&, const std::string& data) {
+      received = data;
+      delivered = true;
+   });
+   ASSERT_TRUE(subscriber.start());
+
+   // Act
+   const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+   sockaddr_in dest{};
+   dest.sin_family = AF_INET;
+   dest.sin_port = htons(subscriberPort);
+   dest.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   for (size_t i = 0; i < datagrams.size(); ++i)
+   {
+      if (i != 0 && i != 6 && i != 10)
+      {
+         sendto(sender, datagrams[i].data(), datagrams[i].size(), 0,
+                reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+      }
+   }
+   close(sender);
+   for (int i = 0; i < 100 && !delivered; ++i)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+   }
+   subscriber.stop();
+
+   // Assert
+   ASSERT_TRUE(delivered);
+   EXPECT_EQ(received, payload);
+   EXPECT_EQ(subscriber.recoveredFragmentCount(), 3U);
+   EXPECT_EQ(subscriber.recoveredMessageCount(), 1U);
+}
+
+TEST_F(HighBandwidthPublisherTest, Nack_ResendsListedFragmentsToSender)
+{
+   // Arrange: 11 fragments kept in the history
+   const uint16_t port = 15678;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 512);
+   publisher.setRetransmitHistory(1 << 20);
+   const std::string payload = makePayload(5'000);
+   ASSERT_TRUE(callSendFragments(publisher, "big", payload));
+   const auto datagrams = receive(receiver, 11);
+   ASSERT_EQ(datagrams.size(), 11U);
+   EXPECT_EQ(publisher.historyMemoryUsage(), 6 + payload.size());
+
+   FragmentHeader first{};
+   std::memcpy(&first, datagrams[0].data(), sizeof(first));
+   std::vector<uint8_t> nack(sizeof(NackHeader) + (2 * sizeof(uint16_t)));
+   const NackHeader header{NACK_MAGIC, first.messageId, 2, 0};
+   const uint16_t missing[2] = {3, 10};
+   std::memcpy(nack.data(), &header, sizeof(header));
+   std::memcpy(nack.data() + sizeof(header), missing, sizeof(missing));
+
+   sockaddr_in publisherAddr{};
+   socklen_t addrLen = sizeof(publisherAddr);
+   ASSERT_EQ(getsockname(getSocket(publisher), reinterpret_cast<sockaddr*>(&publisherAddr), &addrLen), 0);
+   publisherAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+   // Act
+   sendto(receiver, nack.data(), nack.size(), 0, reinterpret_cast<sockaddr*>(&publisherAddr), sizeof(publisherAddr));
+   const auto resent = receive(receiver, 2);
+   close(receiver);
+
+   // Assert - the same datagrams as first sent, back to the NACK's sender
+   ASSERT_EQ(resent.size(), 2U);
+   EXPECT_EQ(resent[0], datagrams[3]);
+   EXPECT_EQ(resent[1], datagrams[10]);
+   EXPECT_EQ(publisher.nackCount(), 1U);
+   EXPECT_EQ(publisher.retransmittedFragmentCount(), 2U);
+
+   // Shrinking the history evicts what no longer fits
+   publisher.setRetransmitHistory(100);
+   EXPECT_EQ(publisher.historyMemoryUsage(), 0U);
+}
+
+TEST_F(HighBandwidthPublisherTest, Pacing_SpreadsLargeMessageAtConfiguredRate)
+{
+   // Arrange: 2 MB/s with a 16 KB burst; a 200 KB message needs ~90 ms
+   const uint16_t port = 15679;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 1400);
+   publisher.setPacingRate(2'000'000, 16 * 1024);
+   const std::string payload = makePayload(200'000);
+
+   // Act
+   const auto start = std::chrono::steady_clock::now();
+   ASSERT_TRUE(callSendFragments(publisher, "paced", payload));
+   const auto elapsed = std::chrono::steady_clock::now() - start;
+   const auto datagrams = receive(receiver, 145);
+   close(receiver);
+
+   // Assert
+   EXPECT_GE(elapsed, std::chrono::milliseconds(80));
+   EXPECT_EQ(datagrams.size(), 145U);
+   expectMessage(datagrams, 1400, "ns/paced", payload);
+}
+
+TEST_F(HighBandwidthPublisherTest, TopicBandwidth_CountsMessagesAndBytesPerTopic)
+{
+   // Arrange
+   const uint16_t port = 15680;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 512);
+
+   // Act: "a" is 2 fragments, "b" is one
+   ASSERT_TRUE(callSendFragments(publisher, "a", std::string(600, 'a')));
+   ASSERT_TRUE(callSendFragments(publisher, "a", std::string(600, 'a')));
+   ASSERT_TRUE(callSendFragments(publisher, "b", "hello"));
+   close(receiver);
+
+   // Assert: payload + "ns/<topic>" + one header per fragment
+   const auto bandwidth = publisher.topicBandwidth();
+   ASSERT_EQ(bandwidth.size(), 2U);
+   EXPECT_EQ(bandwidth.at("a").messages, 2U);
+   EXPECT_EQ(bandwidth.at("a").bytes, 2 * (600 + 4 + (2 * sizeof(FragmentHeader))));
+   EXPECT_EQ(bandwidth.at("b").messages, 1U);
+   EXPECT_EQ(bandwidth.at("b").bytes, 5 + 4 + sizeof(FragmentHeader));
+}
+
+TEST_F(HighBandwidthPublisherTest, Stats_CountsMessagesFragmentsAndFailures)
+{
+   // Arrange
+   const uint16_t port = 15682;
+   const int receiver = openReceiver(port);
+   ASSERT_GE(receiver, 0);
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", port, 512);
+
+   // Act: 2 fragments + 1 fragment, then a message needing too many fragments
+   ASSERT_TRUE(callSendFragments(publisher, "a", std::string(600, 'a')));
+   ASSERT_TRUE(callSendFragments(publisher, "b", "hello"));
+   EXPECT_FALSE(callSendFragments(publisher, "c", std::string(70000 * 512, 'c')));
+   close(receiver);
+
+   // Assert
+   const auto stats = publisher.stats();
+   EXPECT_EQ(stats.messagesSent, 2U);
+   EXPECT_EQ(stats.fragmentsSent, 3U);
+   EXPECT_EQ(stats.bytesSent, 600 + 5 + 8 + (3 * sizeof(FragmentHeader)));
+   EXPECT_EQ(stats.sendFailures, 1U);
+   EXPECT_EQ(stats.parityFragmentsSent, 0U);
+}
+
+TEST_F(HighBandwidthPublisherTest, KernelPacing_AcceptedBySocket)
+{
+   // Arrange
+   HighBandwidthPublisher publisher("ns", "127.0.0.1", 15681);
+   publisher.setPacingRate(1'000'000);
+
+   // Act & Assert: the kernel takes the rate; disabling restores software pacing
+   EXPECT_TRUE(publisher.setKernelPacing(true));
+   EXPECT_TRUE(publisher.setKernelPacing(false));
+   EXPECT_EQ(publisher.pacingRate(), 1'000'000U);
+}
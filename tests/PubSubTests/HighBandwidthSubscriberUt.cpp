@@ -6,12 +6,20 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <arpa/inet.h>
+#include <atomic>
 #include <chrono>
 #include <cstring>
+#include <mutex>
+#include <poll.h>
+#include <sys/socket.h>
 #include <thread>
+#include <unistd.h>
+#include <unordered_map>
 
 #include "GeneralLogger.h"
 #include "HighBandwidthSubscriber.h"
+#include "TaskPool.h"
 #include "HighBandwidthPublisher.h"  // For FragmentHeader
 
 
@@ -32,7 +40,7 @@ protected:
    // Helper to access private members
    static bool isRunning(const HighBandwidthSubscriber& sub) { return sub._running.load(); }
    static bool shouldStop(const HighBandwidthSubscriber& sub) { return sub._shouldStop.load(); }
-   static int getSocket(const HighBandwidthSubscriber& sub) { return sub._socket; }
+   static int getSocket(const HighBandwidthSubscriber& sub) { return sub._shards.front()->socket; }
    static size_t getHandlerCount(HighBandwidthSubscriber& sub)
    {
       const std::lock_guard<std::mutex> lock(sub._handlersMutex);
@@ -40,8 +48,13 @@ protected:
    }
    static size_t getPartialMessageCount(HighBandwidthSubscriber& sub)
    {
-      const std::lock_guard<std::mutex> lock(sub._reassemblyMutex);
-      return sub._partialMessages.size();
+      size_t count = 0;
+      for (auto& shard : sub._shards)
+      {
+         const std::lock_guard<std::mutex> lock(shard->reassemblyMutex);
+         count += shard->partialMessages.size();
+      }
+      return count;
    }
 
    // Helper to call private methods
@@ -50,6 +63,11 @@ protected:
    {
       sub.processFragment(data, len);
    }
+   static void callProcessFragmentFrom(HighBandwidthSubscriber& sub, const std::vector<uint8_t>& fragment,
+                                       const sockaddr_in& source)
+   {
+      sub.processFragment(sub.shardFor(fragment.data()), fragment.data(), fragment.size(), &source);
+   }
    static void callDeliverMessage(HighBandwidthSubscriber& sub, const std::string& topic, const std::string& payload)
    {
       sub.deliverMessage(topic, payload);
@@ -65,7 +83,7 @@ protected:
       header.fragmentNum = fragNum;
       header.totalFragments = totalFrags;
       header.topicLen = (fragNum == 0) ? static_cast<uint16_t>(topic.size()) : 0;
-      header.reserved = 0;
+      header.fec = 0;
 
       buffer.resize(sizeof(FragmentHeader) + (fragNum == 0 ? topic.size() : 0) + payload.size());
       std::memcpy(buffer.data(), &header, sizeof(header));
@@ -81,15 +99,108 @@ protected:
       return buffer;
    }
 
+   // Helper to split a message as the publisher does: every fragment but
+   // the last carries `fragmentSize` bytes of topic + payload
+   static std::vector<std::vector<uint8_t>> createFragments(uint32_t msgId, const std::string& topic,
+                                                            const std::string& payload, size_t fragmentSize)
+   {
+      const std::string wire = topic + payload;
+      const auto total = static_cast<uint16_t>((wire.size() + fragmentSize - 1) / fragmentSize);
+      std::vector<std::vector<uint8_t>> fragments;
+      for (uint16_t i = 0; i < total; ++i)
+      {
+         const std::string chunk = wire.substr(i * fragmentSize, fragmentSize);
+         fragments.push_back(i == 0 ? createFragment(msgId, 0, total, topic, chunk.substr(topic.size()))
+                                    : createFragment(msgId, i, total, topic, chunk));
+      }
+      return fragments;
+   }
+
+   // Helper to add XOR parity as the publisher does: data fragments carry the
+   // group size and topic length, and one parity fragment follows per group
+   static std::vector<std::vector<uint8_t>> createFecFragments(uint32_t msgId, const std::string& topic,
+                                                               const std::string& payload, size_t fragmentSize,
+                                                               uint16_t groupSize)
+   {
+      auto fragments = createFragments(msgId, topic, payload, fragmentSize);
+      const size_t total = fragments.size();
+      for (size_t group = 0; group * groupSize < total; ++group)
+      {
+         std::vector<uint8_t> parity(sizeof(FragmentHeader), 0);
+         uint16_t lengthXor = 0;
+         for (size_t i = group * groupSize; i < std::min(total, (group + 1) * groupSize); ++i)
+         {
+            auto* header = reinterpret_cast<FragmentHeader*>(fragments[i].data());
+            header->fec = groupSize;
+            header->topicLen = static_cast<uint16_t>(topic.size());
+            const size_t length = fragments[i].size() - sizeof(FragmentHeader);
+            parity.resize(std::max(parity.size(), fragments[i].size()), 0);
+            for (size_t b = 0; b < length; ++b)
+            {
+               parity[sizeof(FragmentHeader) + b] ^= fragments[i][sizeof(FragmentHeader) + b];
+            }
+            lengthXor ^= static_cast<uint16_t>(length);
+         }
+         FragmentHeader header{};
+         header.messageId = msgId;
+         header.fragmentNum = static_cast<uint16_t>(group);
+         header.totalFragments = static_cast<uint16_t>(total);
+         header.topicLen = lengthXor;
+         header.fec = FEC_PARITY_FLAG | groupSize;
+         std::memcpy(parity.data(), &header, sizeof(header));
+         fragments.push_back(std::move(parity));
+      }
+      return fragments;
+   }
+
+   static size_t getPooledBufferCount(HighBandwidthSubscriber& sub)
+   {
+      size_t count = 0;
+      for (auto& shard : sub._shards)
+      {
+         const std::lock_guard<std::mutex> lock(shard->reassemblyMutex);
+         count += shard->bufferPool.size();
+      }
+      return count;
+   }
+
    // Helper to add a partial message directly for testing cleanup
    static void addPartialMessage(HighBandwidthSubscriber& sub, uint32_t msgId,
                                   std::chrono::steady_clock::time_point timestamp)
    {
-      const std::lock_guard<std::mutex> lock(sub._reassemblyMutex);
+      auto& shard = *sub._shards[(msgId & 0xFFU) % sub._shards.size()];
+      const std::lock_guard<std::mutex> lock(shard.reassemblyMutex);
       PartialMessage pm;
       pm.totalFragments = 2;
       pm.firstFragmentTime = timestamp;
-      sub._partialMessages[msgId] = pm;
+      shard.partialMessages[msgId] = pm;
+   }
+
+   // Send raw datagrams to the subscriber's port on loopback (or to `address`)
+   static void sendDatagrams(uint16_t port, const std::vector<std::vector<uint8_t>>& datagrams,
+                             const char* address = "127.0.0.1")
+   {
+      const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+      sockaddr_in dest{};
+      dest.sin_family = AF_INET;
+      dest.sin_port = htons(port);
+      inet_pton(AF_INET, address, &dest.sin_addr);
+      for (const auto& datagram : datagrams)
+      {
+         sendto(sock, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+      }
+      close(sock);
+   }
+
+   // Wait up to one second for a condition set by the receive thread
+   template <typename Predicate>
+   static bool waitFor(Predicate predicate)
+   {
+      for (int i = 0; i < 100 && !predicate(); ++i)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      return predicate();
    }
 
    uint16_t _testPort;
@@ -334,6 +445,38 @@ TEST_F(HighBandwidthSubscriberTest, CleanupStaleMessages_WithNoMessages_DoesNotC
    EXPECT_EQ(getPartialMessageCount(subscriber), 0);
 }
 
+TEST_F(HighBandwidthSubscriberTest, CleanupStaleMessages_OverMemoryBudget_EvictsOldestFirst)
+{
+   // Arrange - budget for two incomplete messages, four fresh ones held
+   auto& registry = CommonUtils::MemoryRegistry::instance();
+   registry.setBudget(HighBandwidthSubscriber::MEMORY_ACCOUNT, 2 * sizeof(PartialMessage) + 64);
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort, 10000);
+   const auto now = std::chrono::steady_clock::now();
+   for (uint32_t msgId = 1; msgId <= 4; ++msgId)
+   {
+      addPartialMessage(subscriber, msgId, now - std::chrono::milliseconds(50 - msgId));
+   }
+
+   // Act
+   callCleanupStaleMessages(subscriber);
+
+   // Assert - the two oldest went, and the account fits the budget
+   EXPECT_EQ(getPartialMessageCount(subscriber), 2);
+   EXPECT_EQ(subscriber.stats().evictedMessages, 2U);
+   EXPECT_EQ(subscriber.stats().expiredMessages, 0U);
+   bool found = false;
+   for (const auto& account : registry.allStats())
+   {
+      if (account.name == HighBandwidthSubscriber::MEMORY_ACCOUNT && account.reliefs == 1)
+      {
+         found = true;
+         EXPECT_LE(account.currentBytes, account.budgetBytes);
+      }
+   }
+   EXPECT_TRUE(found);
+   registry.setBudget(HighBandwidthSubscriber::MEMORY_ACCOUNT, 0);
+}
+
 // =============================================================================
 // ProcessFragment Tests (Private Method)
 // =============================================================================
@@ -388,3 +531,576 @@ TEST_F(HighBandwidthSubscriberTest, ProcessFragment_FirstOfMultiple_AddsToPartia
    // Assert - Should be stored as partial
    EXPECT_EQ(getPartialMessageCount(subscriber), 1);
 }
+
+TEST_F(HighBandwidthSubscriberTest, ProcessFragment_OutOfOrderWithDuplicates_ReassemblesPayload)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   std::string receivedTopic;
+   std::string receivedData;
+   int calls = 0;
+   subscriber.subscribe("big", [&](const std::string& topic, const std::string& data) {
+      receivedTopic = topic;
+      receivedData = data;
+      ++calls;
+   });
+   std::string payload(1000, '\0');
+   for (size_t i = 0; i < payload.size(); ++i)
+   {
+      payload[i] = static_cast<char>('a' + (i % 26));
+   }
+   auto fragments = createFragments(7, "ns/big", payload, 64);
+   ASSERT_EQ(fragments.size(), 16U);
+
+   // Act - last fragment first, then the rest backwards, with repeats
+   for (auto it = fragments.rbegin(); it != fragments.rend(); ++it)
+   {
+      callProcessFragment(subscriber, fragments.back().data(), fragments.back().size());
+      callProcessFragment(subscriber, it->data(), it->size());
+   }
+
+   // Assert
+   EXPECT_EQ(calls, 1);
+   EXPECT_EQ(receivedTopic, "ns/big");
+   EXPECT_EQ(receivedData, payload);
+   EXPECT_EQ(getPartialMessageCount(subscriber), 0);
+}
+
+TEST_F(HighBandwidthSubscriberTest, ProcessFragment_ViewHandler_SeesPayloadAndReusesBuffer)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   std::vector<std::string> received;
+   std::vector<const char*> buffers;
+   subscriber.subscribeView("v", [&](std::string_view topic, std::string_view data) {
+      EXPECT_EQ(topic, "ns/v");
+      received.emplace_back(data);
+      buffers.push_back(data.data());
+   });
+   const std::string first(500, 'x');
+   const std::string second(300, 'y');
+
+   // Act - the second message fits the pooled buffer of the first
+   for (const auto& fragment : createFragments(1, "ns/v", first, 100))
+   {
+      callProcessFragment(subscriber, fragment.data(), fragment.size());
+   }
+   EXPECT_EQ(getPooledBufferCount(subscriber), 1U);
+   for (const auto& fragment : createFragments(2, "ns/v", second, 100))
+   {
+      callProcessFragment(subscriber, fragment.data(), fragment.size());
+   }
+
+   // Assert
+   ASSERT_EQ(received.size(), 2U);
+   EXPECT_EQ(received[0], first);
+   EXPECT_EQ(received[1], second);
+   EXPECT_EQ(buffers[0], buffers[1]);
+}
+
+TEST_F(HighBandwidthSubscriberTest, ProcessFragment_InconsistentFragmentSize_DiscardsMessage)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   int calls = 0;
+   subscriber.subscribe("t", [&calls](const std::string&, const std::string&) { ++calls; });
+
+   // Act - middle fragments of different sizes
+   const auto a = createFragment(9, 0, 3, "ns/t", std::string(60, 'a'));
+   const auto b = createFragment(9, 1, 3, "ns/t", std::string(10, 'b'));
+   callProcessFragment(subscriber, a.data(), a.size());
+   callProcessFragment(subscriber, b.data(), b.size());
+
+   // Assert
+   EXPECT_EQ(calls, 0);
+   EXPECT_EQ(getPartialMessageCount(subscriber), 0);
+}
+
+// =============================================================================
+// Batched Receive Tests
+// =============================================================================
+
+TEST_F(HighBandwidthSubscriberTest, ReceiveLoop_BurstOfDatagrams_AllDelivered)
+{
+   // Arrange - more datagrams than one recvmmsg batch
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   subscriber.setReceiveBufferSize(1 << 20);
+   std::atomic<int> delivered{0};
+   subscriber.subscribe("burst", [&delivered](const std::string&, const std::string&) { ++delivered; });
+   ASSERT_TRUE(subscriber.start());
+
+   std::vector<std::vector<uint8_t>> datagrams;
+   for (uint32_t id = 0; id < 200; ++id)
+   {
+      datagrams.push_back(createFragment(id, 0, 1, "ns/burst", "payload"));
+   }
+
+   // Act
+   sendDatagrams(_testPort, datagrams);
+
+   // Assert
+   EXPECT_TRUE(waitFor([&delivered] { return delivered.load() == 200; })) << delivered.load();
+   subscriber.stop();
+}
+
+TEST_F(HighBandwidthSubscriberTest, ReceiveLoop_OversizedDatagram_IsDropped)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   subscriber.setMaxDatagramSize(256);
+   std::vector<std::string> received;
+   std::mutex receivedMutex;
+   subscriber.subscribe("t", [&](const std::string&, const std::string& data) {
+      const std::lock_guard<std::mutex> lock(receivedMutex);
+      received.push_back(data);
+   });
+   ASSERT_TRUE(subscriber.start());
+
+   // Act
+   sendDatagrams(_testPort, {createFragment(1, 0, 1, "ns/t", std::string(1000, 'x')),
+                             createFragment(2, 0, 1, "ns/t", "small")});
+
+   // Assert - only the datagram that fits a slot arrives
+   EXPECT_TRUE(waitFor([&] {
+      const std::lock_guard<std::mutex> lock(receivedMutex);
+      return !received.empty();
+   }));
+   subscriber.stop();
+   ASSERT_EQ(received.size(), 1U);
+   EXPECT_EQ(received[0], "small");
+}
+
+TEST_F(HighBandwidthSubscriberTest, ReceiveBufferSize_ReportsGrantedSizeAfterStart)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort);
+   subscriber.setReceiveBufferSize(64 * 1024);
+   EXPECT_EQ(subscriber.receiveBufferSize(), 0);
+
+   // Act
+   ASSERT_TRUE(subscriber.start());
+
+   // Assert - Linux grants twice the request, up to net.core.rmem_max
+   EXPECT_GE(subscriber.receiveBufferSize(), 64 * 1024);
+   subscriber.stop();
+}
+
+// =============================================================================
+// Sharded Receive Tests
+// =============================================================================
+
+TEST_F(HighBandwidthSubscriberTest, SetShardCount_ClampsAndIsRejectedWhileRunning)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort);
+   EXPECT_EQ(subscriber.shardCount(), 1U);
+
+   // Act / Assert
+   EXPECT_TRUE(subscriber.setShardCount(0));
+   EXPECT_EQ(subscriber.shardCount(), 1U);
+   EXPECT_TRUE(subscriber.setShardCount(3));
+   ASSERT_TRUE(subscriber.start());
+   EXPECT_FALSE(subscriber.setShardCount(2));
+   EXPECT_EQ(subscriber.shardCount(), 3U);
+   subscriber.stop();
+   EXPECT_TRUE(subscriber.setShardCount(2));
+}
+
+TEST_F(HighBandwidthSubscriberTest, Sharded_FragmentedMessages_EachDeliveredOnce)
+{
+   // Arrange - unicast datagrams are steered to the shard owning their message ID
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.setShardCount(4));
+   subscriber.setReceiveBufferSize(1 << 20);
+   std::vector<int> counts(100, 0);
+   std::atomic<int> delivered{0};
+   std::atomic<bool> corrupted{false};
+   std::mutex countsMutex;
+   subscriber.subscribe("t", [&](const std::string&, const std::string& data) {
+      const size_t id = std::stoul(data.substr(0, data.find(':')));
+      corrupted = corrupted || data.size() != 300 || id >= counts.size();
+      const std::lock_guard<std::mutex> lock(countsMutex);
+      ++counts[id % counts.size()];
+      ++delivered;
+   });
+   ASSERT_TRUE(subscriber.start());
+
+   std::vector<std::vector<uint8_t>> datagrams;
+   for (uint32_t id = 0; id < counts.size(); ++id)
+   {
+      std::string payload = std::to_string(id) + ":";
+      payload.resize(300, 'p');
+      for (auto& fragment : createFragments(id, "ns/t", payload, 128))
+      {
+         datagrams.push_back(std::move(fragment));
+      }
+   }
+
+   // Act
+   sendDatagrams(_testPort, datagrams);
+
+   // Assert
+   EXPECT_TRUE(waitFor([&delivered] { return delivered.load() == 100; })) << delivered.load();
+   subscriber.stop();
+   EXPECT_FALSE(corrupted);
+   EXPECT_EQ(counts, std::vector<int>(100, 1));
+   EXPECT_EQ(getPartialMessageCount(subscriber), 0U);
+}
+
+TEST_F(HighBandwidthSubscriberTest, Sharded_MulticastCopies_DeliveredOnce)
+{
+   // Arrange - every shard socket receives a copy of each multicast datagram
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.setShardCount(4));
+   std::atomic<int> delivered{0};
+   subscriber.subscribe("m", [&delivered](const std::string&, const std::string&) { ++delivered; });
+   ASSERT_TRUE(subscriber.start());
+
+   std::vector<std::vector<uint8_t>> datagrams;
+   for (uint32_t id = 0; id < 16; ++id)
+   {
+      datagrams.push_back(createFragment(id, 0, 1, "ns/m", "payload"));
+   }
+
+   // Act
+   sendDatagrams(_testPort, datagrams, _testMulticastAddr.c_str());
+
+   // Assert - give stray duplicates time to show up
+   EXPECT_TRUE(waitFor([&delivered] { return delivered.load() >= 16; })) << delivered.load();
+   std::this_thread::sleep_for(std::chrono::milliseconds(50));
+   subscriber.stop();
+   EXPECT_EQ(delivered.load(), 16);
+}
+
+// =============================================================================
+// Handler Executor Tests
+// =============================================================================
+
+TEST_F(HighBandwidthSubscriberTest, HandlerExecutor_RunsOffReceiveThreadInTopicOrder)
+{
+   // Arrange
+   CommonUtils::TaskPool pool(4);
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.setHandlerExecutor(&pool));
+   std::mutex receivedMutex;
+   std::unordered_map<std::string, std::vector<std::string>> received;
+   std::atomic<bool> onCaller{false};
+   const auto caller = std::this_thread::get_id();
+   for (const std::string topic : {"a", "b"})
+   {
+      subscriber.subscribe(topic, [&](const std::string& msgTopic, const std::string& data) {
+         onCaller = onCaller || std::this_thread::get_id() == caller;
+         const std::lock_guard<std::mutex> lock(receivedMutex);
+         received[msgTopic].push_back(data);
+      });
+   }
+   ASSERT_TRUE(subscriber.start());
+
+   // Act - the test thread stands in for the receive thread
+   std::vector<std::string> expected;
+   for (uint32_t i = 0; i < 100; ++i)
+   {
+      expected.push_back(std::to_string(i));
+      for (const char* topic : {"ns/a", "ns/b"})
+      {
+         const auto fragment = createFragment(i, 0, 1, topic, expected.back());
+         callProcessFragment(subscriber, fragment.data(), fragment.size());
+      }
+   }
+   subscriber.stop();
+
+   // Assert - stop() waited for every queued message
+   EXPECT_FALSE(onCaller);
+   EXPECT_EQ(received["ns/a"], expected);
+   EXPECT_EQ(received["ns/b"], expected);
+   EXPECT_EQ(subscriber.droppedMessageCount(), 0U);
+}
+
+TEST_F(HighBandwidthSubscriberTest, HandlerExecutor_FullTopicQueue_DropsNewest)
+{
+   // Arrange - the handler holds the only pool thread on the first message
+   CommonUtils::TaskPool pool(1);
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.setHandlerExecutor(&pool, 2));
+   std::atomic<bool> entered{false};
+   std::atomic<bool> release{false};
+   std::vector<std::string> received;
+   subscriber.subscribe("t", [&](const std::string&, const std::string& data) {
+      entered = true;
+      while (!release)
+      {
+         std::this_thread::yield();
+      }
+      received.push_back(data);
+   });
+   ASSERT_TRUE(subscriber.start());
+   const auto send = [&subscriber](uint32_t id) {
+      const auto fragment = createFragment(id, 0, 1, "ns/t", std::to_string(id));
+      callProcessFragment(subscriber, fragment.data(), fragment.size());
+   };
+
+   // Act
+   send(0);
+   ASSERT_TRUE(waitFor([&entered] { return entered.load(); }));
+   for (uint32_t id = 1; id < 5; ++id)
+   {
+      send(id);
+   }
+   release = true;
+   subscriber.stop();
+
+   // Assert
+   EXPECT_EQ(subscriber.droppedMessageCount(), 2U);
+   EXPECT_EQ(received, (std::vector<std::string>{"0", "1", "2"}));
+}
+
+TEST_F(HighBandwidthSubscriberTest, SetHandlerExecutor_RejectedWhileRunning)
+{
+   // Arrange
+   CommonUtils::TaskPool pool(1);
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.start());
+
+   // Act / Assert
+   EXPECT_FALSE(subscriber.setHandlerExecutor(&pool));
+   subscriber.stop();
+   EXPECT_TRUE(subscriber.setHandlerExecutor(&pool));
+   EXPECT_TRUE(subscriber.setHandlerExecutor(nullptr));
+}
+
+// =============================================================================
+// Forward Error Correction Tests
+// =============================================================================
+
+TEST_F(HighBandwidthSubscriberTest, ProcessFragment_OneLossPerParityGroup_IsRecovered)
+{
+   // Arrange - 10 data fragments in groups of 4 (+3 parity)
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   std::vector<std::string> received;
+   subscriber.subscribe("t", [&received](const std::string&, const std::string& data) { received.push_back(data); });
+   std::string payload(1200, '\0');
+   for (size_t i = 0; i < payload.size(); ++i)
+   {
+      payload[i] = static_cast<char>(i * 7);
+   }
+   const auto fragments = createFecFragments(9, "ns/t", payload, 128, 4);
+   ASSERT_EQ(fragments.size(), 13U);
+
+   // Act - lose fragment 0 (topic), 5 and the short last fragment 9; parity first
+   for (size_t i : {10U, 11U, 12U, 1U, 2U, 3U, 4U, 6U, 7U, 8U})
+   {
+      callProcessFragment(subscriber, fragments[i].data(), fragments[i].size());
+   }
+
+   // Assert
+   ASSERT_EQ(received.size(), 1U);
+   EXPECT_EQ(received[0], payload);
+   EXPECT_EQ(subscriber.recoveredFragmentCount(), 3U);
+   EXPECT_EQ(subscriber.recoveredMessageCount(), 1U);
+   EXPECT_EQ(getPartialMessageCount(subscriber), 0U);
+}
+
+TEST_F(HighBandwidthSubscriberTest, ProcessFragment_TwoLossesInOneGroup_AreNotRecovered)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   int received = 0;
+   subscriber.subscribe("t", [&received](const std::string&, const std::string&) { ++received; });
+   const auto fragments = createFecFragments(3, "ns/t", std::string(600, 'x'), 128, 4);
+
+   // Act - lose fragments 1 and 2 of group 0
+   for (size_t i = 0; i < fragments.size(); ++i)
+   {
+      if (i != 1 && i != 2)
+      {
+         callProcessFragment(subscriber, fragments[i].data(), fragments[i].size());
+      }
+   }
+
+   // Assert
+   EXPECT_EQ(received, 0);
+   EXPECT_EQ(subscriber.recoveredFragmentCount(), 0U);
+   EXPECT_EQ(getPartialMessageCount(subscriber), 1U);
+}
+
+// =============================================================================
+// NACK Tests
+// =============================================================================
+
+TEST_F(HighBandwidthSubscriberTest, Nack_MissingFragments_AreRequestedFromPublisher)
+{
+   // Arrange - a socket stands in for the publisher
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.setNackInterval(20));
+   int received = 0;
+   subscriber.subscribe("t", [&received](const std::string&, const std::string&) { ++received; });
+   ASSERT_TRUE(subscriber.start());
+
+   const int publisher = socket(AF_INET, SOCK_DGRAM, 0);
+   sockaddr_in publisherAddr{};
+   publisherAddr.sin_family = AF_INET;
+   publisherAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   ASSERT_EQ(bind(publisher, reinterpret_cast<sockaddr*>(&publisherAddr), sizeof(publisherAddr)), 0);
+   socklen_t addrLen = sizeof(publisherAddr);
+   getsockname(publisher, reinterpret_cast<sockaddr*>(&publisherAddr), &addrLen);
+
+   const auto fragments = createFragments(5, "ns/t", std::string(600, 'n'), 128);
+   ASSERT_EQ(fragments.size(), 5U);
+
+   // Act - lose fragments 1 and 3, then let the NACK interval pass
+   for (size_t i : {0U, 2U, 4U})
+   {
+      callProcessFragmentFrom(subscriber, fragments[i], publisherAddr);
+   }
+   std::vector<uint8_t> nack(1024);
+   pollfd pfd{publisher, POLLIN, 0};
+   ASSERT_GT(poll(&pfd, 1, 1000), 0);
+   const ssize_t nackLen = recv(publisher, nack.data(), nack.size(), 0);
+   close(publisher);
+
+   // Assert - one NACK listing exactly the missing fragments
+   ASSERT_EQ(nackLen, static_cast<ssize_t>(sizeof(NackHeader) + (2 * sizeof(uint16_t))));
+   NackHeader header{};
+   std::memcpy(&header, nack.data(), sizeof(header));
+   EXPECT_EQ(header.magic, NACK_MAGIC);
+   EXPECT_EQ(header.messageId, 5U);
+   ASSERT_EQ(header.count, 2U);
+   uint16_t missing[2] = {};
+   std::memcpy(missing, nack.data() + sizeof(NackHeader), sizeof(missing));
+   EXPECT_EQ(missing[0], 1U);
+   EXPECT_EQ(missing[1], 3U);
+   EXPECT_TRUE(waitFor([&subscriber] { return subscriber.nackCount() >= 1; }));
+
+   // Retransmissions complete the message; a late duplicate is ignored
+   callProcessFragmentFrom(subscriber, fragments[1], publisherAddr);
+   callProcessFragmentFrom(subscriber, fragments[3], publisherAddr);
+   callProcessFragmentFrom(subscriber, fragments[3], publisherAddr);
+   subscriber.stop();
+   EXPECT_EQ(received, 1);
+   EXPECT_EQ(getPartialMessageCount(subscriber), 0U);
+}
+
+TEST_F(HighBandwidthSubscriberTest, SetNackInterval_RejectedWhileRunning)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.start());
+
+   // Act / Assert
+   EXPECT_FALSE(subscriber.setNackInterval(50));
+   subscriber.stop();
+   EXPECT_TRUE(subscriber.setNackInterval(50));
+}
+
+TEST_F(HighBandwidthSubscriberTest, Housekeeping_ExpiresStaleMessagesWithoutTraffic)
+{
+   // Arrange - a 50 ms timeout, and NACKs to make housekeeping tick every 10 ms
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort, 50);
+   ASSERT_TRUE(subscriber.setNackInterval(20));
+   ASSERT_TRUE(subscriber.start());
+   const auto fragments = createFragments(7, "test/t", std::string(300, 'x'), 128);
+
+   // Act - half a message, then silence
+   sendDatagrams(_testPort, {fragments[0]});
+
+   // Assert - expired by the timer, not by the (idle) receive thread
+   EXPECT_TRUE(waitFor([&] { return subscriber.stats().expiredMessages == 1; }));
+   EXPECT_EQ(getPartialMessageCount(subscriber), 0U);
+   subscriber.stop();
+}
+
+TEST_F(HighBandwidthSubscriberTest, BusyPoll_DeliversAndIsRejectedWhileRunning)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("ns", _testMulticastAddr, _testPort);
+   ASSERT_TRUE(subscriber.setBusyPoll(500));
+   std::atomic<int> delivered{0};
+   subscriber.subscribe("t", [&delivered](const std::string&, const std::string&) { ++delivered; });
+   ASSERT_TRUE(subscriber.start());
+   EXPECT_FALSE(subscriber.setBusyPoll(0));
+
+   // Act - spaced out, so the thread both spins and falls back to poll()
+   for (uint32_t id = 0; id < 5; ++id)
+   {
+      sendDatagrams(_testPort, {createFragment(id, 0, 1, "ns/t", "payload")});
+      std::this_thread::sleep_for(std::chrono::milliseconds(id % 2 == 0 ? 0 : 5));
+   }
+
+   // Assert
+   EXPECT_TRUE(waitFor([&delivered] { return delivered.load() == 5; })) << delivered.load();
+   subscriber.stop();
+   EXPECT_EQ(subscriber.busyPollBudget(), 500);
+   EXPECT_TRUE(subscriber.setBusyPoll(0));
+}
+
+// =============================================================================
+// Stats Tests
+// =============================================================================
+
+TEST_F(HighBandwidthSubscriberTest, Stats_CountsDuplicatesDropsAndExpiredMessages)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort, 100);
+   const auto fragments = createFragments(1, "test/t", std::string(300, 'x'), 128);
+   ASSERT_EQ(fragments.size(), 3U);
+   const auto malformed = createFragment(2, 4, 3, "test/t", "bad");
+
+   // Act - one complete message with a duplicate, a malformed fragment,
+   // and a message that never completes
+   for (size_t i : {0U, 1U, 1U, 2U})
+   {
+      callProcessFragment(subscriber, fragments[i].data(), fragments[i].size());
+   }
+   callProcessFragment(subscriber, malformed.data(), malformed.size());
+   addPartialMessage(subscriber, 3, std::chrono::steady_clock::now() - std::chrono::milliseconds(200));
+   callCleanupStaleMessages(subscriber);
+   const auto stats = subscriber.stats();
+
+   // Assert
+   EXPECT_EQ(stats.datagramsReceived, 5U);
+   EXPECT_EQ(stats.bytesReceived, fragments[0].size() + (2 * fragments[1].size()) + fragments[2].size() +
+                                     malformed.size());
+   EXPECT_EQ(stats.messagesReceived, 1U);
+   EXPECT_EQ(stats.duplicateFragments, 1U);
+   EXPECT_EQ(stats.droppedFragments, 1U);
+   EXPECT_EQ(stats.expiredMessages, 1U);
+   EXPECT_EQ(stats.discardedMessages, 0U);
+   EXPECT_EQ(stats.reassemblyTime.count, 1U);
+   EXPECT_TRUE(stats.sources.empty());   // No sender address without a socket
+}
+
+TEST_F(HighBandwidthSubscriberTest, Stats_TracksMessageIdGapsPerPublisher)
+{
+   // Arrange
+   HighBandwidthSubscriber subscriber("test", _testMulticastAddr, _testPort);
+   sockaddr_in first{};
+   first.sin_family = AF_INET;
+   first.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   first.sin_port = htons(40001);
+   sockaddr_in second = first;
+   second.sin_port = htons(40002);
+
+   // Act - the first publisher skips IDs 3 and 4, then 3 arrives late
+   for (uint32_t id : {1U, 2U, 5U, 3U})
+   {
+      callProcessFragmentFrom(subscriber, createFragment(id, 0, 1, "test/t", "p"), first);
+   }
+   for (uint32_t id : {10U, 11U})
+   {
+      callProcessFragmentFrom(subscriber, createFragment(id, 0, 1, "test/t", "p"), second);
+   }
+   auto sources = subscriber.stats().sources;
+   std::sort(sources.begin(), sources.end(),
+             [](const auto& a, const auto& b) { return a.address < b.address; });
+
+   // Assert
+   ASSERT_EQ(sources.size(), 2U);
+   EXPECT_EQ(sources[0].address, "127.0.0.1:40001");
+   EXPECT_EQ(sources[0].messages, 4U);
+   EXPECT_EQ(sources[0].missingIds, 1U);
+   EXPECT_EQ(sources[0].lateIds, 1U);
+   EXPECT_EQ(sources[0].lastMessageId, 5U);
+   EXPECT_EQ(sources[1].address, "127.0.0.1:40002");
+   EXPECT_EQ(sources[1].messages, 2U);
+   EXPECT_EQ(sources[1].missingIds, 0U);
+}
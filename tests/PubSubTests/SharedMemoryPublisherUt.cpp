@@ -0,0 +1,156 @@
+/**
+ * @file SharedMemoryPublisherUt.cpp
+ * @brief Unit tests for SharedMemoryPublisher and SharedMemorySubscriber classes.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "SharedMemoryPublisher.h"
+#include "SharedMemorySubscriber.h"
+
+class SharedMemoryPublisherTest : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      // Per-process namespace so parallel test runs do not share a segment
+      _namespace = "ShmTest" + std::to_string(getpid());
+   }
+
+   // Helper to call private methods
+   static bool callPublishBytes(SharedMemoryPublisher& pub, const std::string& topic, const std::string& payload)
+   {
+      return pub.publishBytes(topic, reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+   }
+
+   // Wait up to one second for a condition set by the receive thread
+   template <typename Predicate>
+   static bool waitFor(Predicate predicate)
+   {
+      for (int i = 0; i < 100 && !predicate(); ++i)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      return predicate();
+   }
+
+   std::string _namespace;
+};
+
+TEST_F(SharedMemoryPublisherTest, Subscriber_ReceivesSubscribedTopicsInOrder)
+{
+   // Arrange
+   SharedMemoryPublisher publisher(_namespace, 1 << 16);
+   ASSERT_TRUE(publisher.isOpen());
+   SharedMemorySubscriber subscriber(_namespace);
+   std::mutex mutex;
+   std::vector<std::string> received;
+   subscriber.subscribe("iq", [&](const std::string& topic, const std::string& data) {
+      const std::lock_guard<std::mutex> lock(mutex);
+      received.push_back(topic + "=" + data);
+   });
+   ASSERT_TRUE(subscriber.start());
+   ASSERT_TRUE(waitFor([&] { return subscriber.isConnected(); }));
+
+   // Act
+   for (int i = 0; i < 100; ++i)
+   {
+      ASSERT_TRUE(callPublishBytes(publisher, "iq", std::to_string(i)));
+      ASSERT_TRUE(callPublishBytes(publisher, "spectrum", "ignored"));
+   }
+
+   // Assert
+   ASSERT_TRUE(waitFor([&] { return subscriber.receivedCount() == 200; }));
+   subscriber.stop();
+   ASSERT_EQ(received.size(), 100U);
+   for (size_t i = 0; i < received.size(); ++i)
+   {
+      EXPECT_EQ(received[i], _namespace + "/iq=" + std::to_string(i));
+   }
+   EXPECT_EQ(publisher.publishedCount(), 200U);
+   EXPECT_EQ(publisher.droppedMessageCount(), 0U);
+}
+
+TEST_F(SharedMemoryPublisherTest, ViewHandler_SeesPayloadInSharedMemory)
+{
+   // Arrange
+   SharedMemoryPublisher publisher(_namespace, 1 << 20);
+   SharedMemorySubscriber subscriber(_namespace);
+   const std::string frame(100000, 'f');
+   bool matched = false;
+   subscriber.subscribeView("spectrum", [&](std::string_view, std::string_view data) {
+      matched = (data == frame);
+   });
+   ASSERT_TRUE(subscriber.start());
+   ASSERT_TRUE(waitFor([&] { return subscriber.isConnected(); }));
+
+   // Act
+   ASSERT_TRUE(callPublishBytes(publisher, "spectrum", frame));
+
+   // Assert
+   ASSERT_TRUE(waitFor([&] { return subscriber.receivedCount() == 1; }));
+   subscriber.stop();
+   EXPECT_TRUE(matched);
+}
+
+TEST_F(SharedMemoryPublisherTest, SlowSubscriber_PublisherDropsInsteadOfBlocking)
+{
+   // Arrange: a handler that blocks until released
+   SharedMemoryPublisher publisher(_namespace, 4096);
+   SharedMemorySubscriber subscriber(_namespace);
+   std::mutex gate;
+   std::unique_lock<std::mutex> hold(gate);
+   subscriber.subscribe("t", [&gate](const std::string&, const std::string&) {
+      const std::lock_guard<std::mutex> lock(gate);
+   });
+   ASSERT_TRUE(subscriber.start());
+   ASSERT_TRUE(waitFor([&] { return subscriber.isConnected(); }));
+
+   // Act
+   int published = 0;
+   for (int i = 0; i < 20; ++i)
+   {
+      published += callPublishBytes(publisher, "t", std::string(500, 'x')) ? 1 : 0;
+   }
+   hold.unlock();
+
+   // Assert
+   EXPECT_LT(published, 20);
+   EXPECT_EQ(publisher.droppedMessageCount(), static_cast<uint64_t>(20 - published));
+   EXPECT_TRUE(waitFor([&] { return subscriber.receivedCount() == static_cast<uint64_t>(published); }));
+   subscriber.stop();
+}
+
+TEST_F(SharedMemoryPublisherTest, Subscriber_StartedFirst_FollowsPublisherRestart)
+{
+   // Arrange
+   SharedMemorySubscriber subscriber(_namespace);
+   int received = 0;
+   subscriber.subscribe("t", [&received](const std::string&, const std::string&) { ++received; });
+   ASSERT_TRUE(subscriber.start());
+   EXPECT_FALSE(subscriber.isConnected());
+
+   // Act: a publisher appears, goes away and is replaced
+   {
+      SharedMemoryPublisher first(_namespace, 4096);
+      ASSERT_TRUE(waitFor([&] { return subscriber.isConnected(); }));
+      ASSERT_TRUE(callPublishBytes(first, "t", "1"));
+      ASSERT_TRUE(waitFor([&] { return subscriber.receivedCount() == 1; }));
+   }
+   ASSERT_TRUE(waitFor([&] { return !subscriber.isConnected(); }));
+   SharedMemoryPublisher second(_namespace, 4096);
+   ASSERT_TRUE(waitFor([&] { return subscriber.isConnected(); }));
+   ASSERT_TRUE(callPublishBytes(second, "t", "2"));
+
+   // Assert
+   EXPECT_TRUE(waitFor([&] { return subscriber.receivedCount() == 2; }));
+   subscriber.stop();
+   EXPECT_EQ(received, 2);
+}
@@ -0,0 +1,247 @@
+/**
+ * @file SharedMemoryRingUt.cpp
+ * @brief Unit tests for SharedMemoryRing class.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "SharedMemoryRing.h"
+
+class SharedMemoryRingTest : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      // Per-process name so parallel test runs do not share a segment
+      _segment = SharedMemoryRing::segmentName("RingTest" + std::to_string(getpid()));
+   }
+
+   static bool write(SharedMemoryRing& ring, const std::string& record)
+   {
+      uint8_t* destination = ring.reserve(record.size());
+      if (destination == nullptr)
+      {
+         return false;
+      }
+      std::memcpy(destination, record.data(), record.size());
+      ring.commit();
+      return true;
+   }
+
+   static std::string read(SharedMemoryRing& ring, int reader)
+   {
+      const auto record = ring.peek(reader);
+      std::string text(reinterpret_cast<const char*>(record.data()), record.size());
+      ring.consume(reader);
+      return text;
+   }
+
+   std::string _segment;
+};
+
+TEST_F(SharedMemoryRingTest, SegmentName_ReplacesSlashes)
+{
+   EXPECT_EQ(SharedMemoryRing::segmentName("Engine/iq"), "/PubSub.Engine_iq");
+}
+
+TEST_F(SharedMemoryRingTest, Open_WithoutProducer_ReturnsNull)
+{
+   EXPECT_EQ(SharedMemoryRing::open(_segment), nullptr);
+}
+
+TEST_F(SharedMemoryRingTest, EveryReader_SeesRecordsWrittenAfterAttaching)
+{
+   // Arrange
+   auto producer = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(producer, nullptr);
+   auto consumer = SharedMemoryRing::open(_segment);
+   ASSERT_NE(consumer, nullptr);
+   ASSERT_TRUE(write(*producer, "before"));
+   const int first = consumer->attachReader();
+   const int second = consumer->attachReader();
+   ASSERT_GE(first, 0);
+   ASSERT_GE(second, 0);
+
+   // Act
+   ASSERT_TRUE(write(*producer, "one"));
+   ASSERT_TRUE(write(*producer, std::string(100, 'x')));
+
+   // Assert
+   EXPECT_EQ(read(*consumer, first), "one");
+   EXPECT_EQ(read(*consumer, first), std::string(100, 'x'));
+   EXPECT_TRUE(consumer->peek(first).empty());
+   EXPECT_EQ(read(*consumer, second), "one");
+}
+
+TEST_F(SharedMemoryRingTest, Reserve_FullRing_FailsUntilSlowestReaderConsumes)
+{
+   // Arrange: records of 1000 bytes in a 4 KiB ring
+   auto ring = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(ring, nullptr);
+   const int reader = ring->attachReader();
+   ASSERT_GE(reader, 0);
+
+   const auto numbered = [](int i) { return std::string(999, 'r') + static_cast<char>('a' + i); };
+
+   // Act & Assert: fill the ring, then wrap around it many times, reading
+   // each record back intact and in order
+   int written = 0;
+   while (write(*ring, numbered(written)))
+   {
+      ++written;
+   }
+   EXPECT_EQ(written, 4);
+   for (int i = 0; i < 20; ++i)
+   {
+      EXPECT_EQ(read(*ring, reader), numbered(i));
+      EXPECT_TRUE(write(*ring, numbered(i + 4)));
+      EXPECT_FALSE(write(*ring, numbered(0)));
+   }
+   for (int i = 20; i < 24; ++i)
+   {
+      EXPECT_EQ(read(*ring, reader), numbered(i));
+   }
+   EXPECT_FALSE(write(*ring, std::string(ring->maxRecordSize() + 1, 'x')));
+}
+
+TEST_F(SharedMemoryRingTest, Reserve_DetachedOrDeadReader_DoesNotHoldBackProducer)
+{
+   // Arrange: one detached reader and one whose process has exited
+   auto ring = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(ring, nullptr);
+   ring->detachReader(ring->attachReader());
+   const pid_t child = fork();
+   if (child == 0)
+   {
+      auto consumer = SharedMemoryRing::open(_segment);
+      _exit((consumer != nullptr && consumer->attachReader() >= 0) ? 0 : 1);
+   }
+   int status = 0;
+   ASSERT_EQ(waitpid(child, &status, 0), child);
+   ASSERT_EQ(WEXITSTATUS(status), 0);
+
+   // Act & Assert: the ring wraps freely
+   for (int i = 0; i < 50; ++i)
+   {
+      EXPECT_TRUE(write(*ring, std::string(1000, 'd')));
+   }
+}
+
+TEST_F(SharedMemoryRingTest, WaitForData_WokenByCommitAndClose)
+{
+   // Arrange
+   auto producer = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(producer, nullptr);
+   auto consumer = SharedMemoryRing::open(_segment);
+   ASSERT_NE(consumer, nullptr);
+   const int reader = consumer->attachReader();
+
+   // Act: a commit wakes a long wait early
+   std::thread writer([&producer] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      write(*producer, "wake");
+   });
+   const auto start = std::chrono::steady_clock::now();
+   consumer->waitForData(reader, std::chrono::seconds(5));
+   const auto waited = std::chrono::steady_clock::now() - start;
+   writer.join();
+
+   // Assert
+   EXPECT_LT(waited, std::chrono::seconds(2));
+   EXPECT_EQ(read(*consumer, reader), "wake");
+   EXPECT_FALSE(consumer->isClosed());
+   producer.reset();
+   EXPECT_TRUE(consumer->isClosed());
+   EXPECT_EQ(SharedMemoryRing::open(_segment), nullptr);
+}
+
+TEST_F(SharedMemoryRingTest, Create_SegmentIsOwnerOnly)
+{
+   auto ring = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(ring, nullptr);
+
+   const int fd = shm_open(_segment.c_str(), O_RDONLY, 0);
+   ASSERT_GE(fd, 0);
+   struct stat info{};
+   ASSERT_EQ(fstat(fd, &info), 0);
+   close(fd);
+   EXPECT_EQ(info.st_mode & 0777, 0600U);
+}
+
+TEST_F(SharedMemoryRingTest, Create_WhileProducerAlive_Fails)
+{
+   // Arrange
+   auto first = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(first, nullptr);
+   auto consumer = SharedMemoryRing::open(_segment);
+   ASSERT_NE(consumer, nullptr);
+   const int reader = consumer->attachReader();
+
+   // Act
+   auto second = SharedMemoryRing::create(_segment, 4096);
+
+   // Assert: the first producer keeps its segment and its readers
+   EXPECT_EQ(second, nullptr);
+   EXPECT_FALSE(consumer->isClosed());
+   ASSERT_TRUE(write(*first, "still here"));
+   EXPECT_EQ(read(*consumer, reader), "still here");
+}
+
+TEST_F(SharedMemoryRingTest, Create_AfterProducerDied_TakesOverSegment)
+{
+   // Arrange: a producer that exits without closing its segment
+   const pid_t child = fork();
+   if (child == 0)
+   {
+      auto ring = SharedMemoryRing::create(_segment, 4096);
+      _exit((ring != nullptr) ? 0 : 1);   // Skips the destructor
+   }
+   int status = 0;
+   ASSERT_EQ(waitpid(child, &status, 0), child);
+   ASSERT_EQ(WEXITSTATUS(status), 0);
+   auto stale = SharedMemoryRing::open(_segment);
+   ASSERT_NE(stale, nullptr);
+   EXPECT_TRUE(stale->isClosed());
+
+   // Act
+   auto ring = SharedMemoryRing::create(_segment, 4096);
+
+   // Assert
+   ASSERT_NE(ring, nullptr);
+   EXPECT_FALSE(ring->isClosed());
+}
+
+TEST_F(SharedMemoryRingTest, Peek_RecordLargerThanRing_ClosesSegment)
+{
+   // Arrange: a committed record whose header then claims more than the ring
+   auto producer = SharedMemoryRing::create(_segment, 4096);
+   ASSERT_NE(producer, nullptr);
+   auto consumer = SharedMemoryRing::open(_segment);
+   ASSERT_NE(consumer, nullptr);
+   const int reader = consumer->attachReader();
+   uint8_t* record = producer->reserve(16);
+   ASSERT_NE(record, nullptr);
+   producer->commit();
+   // The record header (size, then padding flag) sits just before the record
+   const uint32_t hostileSize = std::numeric_limits<uint32_t>::max();
+   std::memcpy(record - (2 * sizeof(uint32_t)), &hostileSize, sizeof(hostileSize));
+
+   // Act
+   const auto peeked = consumer->peek(reader);
+
+   // Assert
+   EXPECT_TRUE(peeked.empty());
+   EXPECT_TRUE(consumer->isClosed());
+   EXPECT_FALSE(producer->isClosed());
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "CommandService.h"
+#include "HighBandwidthPublisher.h"
+#include "HighBandwidthSubscriber.h"
+#include "SdrEngine.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr const char* TEST_NAME  = "CommandServiceTest";
+constexpr const char* TEST_GROUP = "239.192.100.9";
+constexpr uint16_t TEST_PORT     = 15681;
+constexpr double VFO_OFFSET_HZ    = 100'000.0;
+constexpr double VFO_BANDWIDTH_HZ = 12'500.0;
+
+// A CommandService on an idle engine, driven over its control group.
+class CommandServiceTest : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      messages::ControlSettings settings;
+      settings.set_name(TEST_NAME);
+      settings.set_multicast_group(TEST_GROUP);
+      settings.set_port(TEST_PORT);
+      _vfoId   = _engine.addVfo(VFO_OFFSET_HZ, VFO_BANDWIDTH_HZ);
+      _service = std::make_unique<CommandService>(_engine, std::vector<int>{_vfoId}, settings);
+      ASSERT_TRUE(_service->start());
+
+      _responses = std::make_unique<HighBandwidthSubscriber>(TEST_NAME, TEST_GROUP, TEST_PORT);
+      _responses->subscribe("CommandResponse",
+                            [this](const std::string& /*topic*/, const std::string& data)
+                            {
+                               messages::CommandResponse response;
+                               if (response.ParseFromString(data))
+                               {
+                                  const std::lock_guard<std::mutex> lock(_mutex);
+                                  _received[response.command_id()] = response;
+                                  _cv.notify_all();
+                               }
+                            });
+      ASSERT_TRUE(_responses->start());
+      _publisher = std::make_unique<HighBandwidthPublisher>(TEST_NAME, TEST_GROUP, TEST_PORT);
+   }
+
+   void TearDown() override
+   {
+      _responses->stop();
+      _service->stop();
+   }
+
+   // Send a CONFIGURE command and wait up to one second for its response.
+   std::optional<messages::CommandResponse> configure(
+      const std::map<std::string, std::string>& settings)
+   {
+      messages::Command command;
+      command.set_type(messages::COMMAND_TYPE_CONFIGURE);
+      command.mutable_configure_params()->mutable_settings()->insert(settings.begin(),
+                                                                     settings.end());
+      return send(command);
+   }
+
+   std::optional<messages::CommandResponse> configure(const std::string& key,
+                                                      const std::string& value)
+   {
+      return configure({{key, value}});
+   }
+
+   // Publish `command` under a fresh id and wait up to one second for its response.
+   std::optional<messages::CommandResponse> send(messages::Command command)
+   {
+      const std::string id = "cmd-" + std::to_string(++_nextId);
+      command.set_command_id(id);
+      if (!_publisher->publish("Command", command))
+      {
+         return std::nullopt;
+      }
+
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (!_cv.wait_for(lock, std::chrono::seconds(1), [&] { return _received.count(id) > 0; }))
+      {
+         return std::nullopt;
+      }
+      return _received[id];
+   }
+
+   SdrEngine::SdrEngine _engine;
+   int _vfoId{-1};
+   std::unique_ptr<CommandService> _service;
+   std::unique_ptr<HighBandwidthSubscriber> _responses;
+   std::unique_ptr<HighBandwidthPublisher> _publisher;
+   int _nextId{0};
+
+   std::mutex _mutex;
+   std::condition_variable _cv;
+   std::map<std::string, messages::CommandResponse> _received;
+};
+
+} // anonymous namespace
+
+TEST_F(CommandServiceTest, Configure_FftOverlap_IsApplied)
+{
+   const auto response = configure("fft_overlap_percent", "50");
+   ASSERT_TRUE(response.has_value());
+   EXPECT_TRUE(response->success());
+   EXPECT_FLOAT_EQ(_engine.getFftOverlapPercent(), 50.0F);
+}
+
+TEST_F(CommandServiceTest, Configure_FftOverlapNan_IsRejected)
+{
+   _engine.setFftOverlapPercent(25.0F);
+
+   const auto response = configure("fft_overlap_percent", "nan");
+   ASSERT_TRUE(response.has_value());
+   EXPECT_FALSE(response->success());
+   EXPECT_EQ(response->status(), messages::RESPONSE_STATUS_INVALID);
+   EXPECT_FLOAT_EQ(_engine.getFftOverlapPercent(), 25.0F);
+   EXPECT_EQ(_service->stats().rejected, 1U);
+}
+
+TEST_F(CommandServiceTest, Configure_FftOverlapOutOfRange_IsRejected)
+{
+   _engine.setFftOverlapPercent(25.0F);
+
+   for (const char* value : {"96", "-1", "inf"})
+   {
+      const auto response = configure("fft_overlap_percent", value);
+      ASSERT_TRUE(response.has_value()) << value;
+      EXPECT_FALSE(response->success()) << value;
+      EXPECT_EQ(response->status(), messages::RESPONSE_STATUS_INVALID) << value;
+   }
+   EXPECT_FLOAT_EQ(_engine.getFftOverlapPercent(), 25.0F);
+}
+
+TEST_F(CommandServiceTest, Configure_NonFiniteFloatSettings_AreRejected)
+{
+   _engine.setSpectrumOutputRate(10.0F);
+   _engine.setFftAverageAlpha(0.5F);
+
+   for (const char* key : {"spectrum_rate_hz", "fft_average_alpha", "vfo.0.center_offset_hz",
+                           "vfo.0.bandwidth_hz"})
+   {
+      for (const char* value : {"nan", "inf", "-inf"})
+      {
+         const auto response = configure(key, value);
+         ASSERT_TRUE(response.has_value()) << key << "=" << value;
+         EXPECT_FALSE(response->success()) << key << "=" << value;
+         EXPECT_EQ(response->status(), messages::RESPONSE_STATUS_INVALID) << key << "=" << value;
+      }
+   }
+   EXPECT_FLOAT_EQ(_engine.getSpectrumOutputRate(), 10.0F);
+   EXPECT_FLOAT_EQ(_engine.getFftAverageAlpha(), 0.5F);
+   const auto vfo = _engine.vfo(_vfoId);
+   ASSERT_NE(vfo, nullptr);
+   EXPECT_DOUBLE_EQ(vfo->getCenterOffset(), VFO_OFFSET_HZ);
+   EXPECT_DOUBLE_EQ(vfo->getBandwidth(), VFO_BANDWIDTH_HZ);
+}
+
+TEST_F(CommandServiceTest, Configure_VfoOffset_IsApplied)
+{
+   const auto response = configure("vfo.0.center_offset_hz", "-250000");
+   ASSERT_TRUE(response.has_value());
+   EXPECT_TRUE(response->success()) << response->message();
+
+   const auto vfo = _engine.vfo(_vfoId);
+   ASSERT_NE(vfo, nullptr);
+   EXPECT_DOUBLE_EQ(vfo->getCenterOffset(), -250'000.0);
+}
+
+TEST_F(CommandServiceTest, Configure_VfoOffsetBeyondNyquist_IsRejected)
+{
+   const double nyquistHz = static_cast<double>(_engine.getSampleRate()) / 2.0;
+
+   for (const double offsetHz : {nyquistHz + 1.0, -nyquistHz - 1.0})
+   {
+      const auto response = configure("vfo.0.center_offset_hz", std::to_string(offsetHz));
+      ASSERT_TRUE(response.has_value()) << offsetHz;
+      EXPECT_FALSE(response->success()) << offsetHz;
+      EXPECT_EQ(response->status(), messages::RESPONSE_STATUS_INVALID) << offsetHz;
+   }
+   const auto vfo = _engine.vfo(_vfoId);
+   ASSERT_NE(vfo, nullptr);
+   EXPECT_DOUBLE_EQ(vfo->getCenterOffset(), VFO_OFFSET_HZ);
+}
+
+TEST_F(CommandServiceTest, Configure_VfoOffsetBeyondNewRate_IsRejected)
+{
+   const uint32_t rateHz = _engine.getSampleRate();
+
+   // Fits the current rate, but not the one the same command asks for.
+   const auto response = configure({{"sample_rate_hz", "1000000"},
+                                    {"vfo.0.center_offset_hz", "600000"}});
+   ASSERT_TRUE(response.has_value());
+   EXPECT_FALSE(response->success());
+   EXPECT_EQ(response->status(), messages::RESPONSE_STATUS_INVALID);
+   EXPECT_EQ(_engine.getSampleRate(), rateHz);
+}
+
+TEST_F(CommandServiceTest, Start_NonFiniteSnapshotWindow_IsRejected)
+{
+   for (const char* key : {"pre_sec", "post_sec"})
+   {
+      messages::Command command;
+      command.set_type(messages::COMMAND_TYPE_START);
+      command.mutable_start_params()->set_mode("snapshot");
+      auto& config = *command.mutable_start_params()->mutable_initial_config();
+      config["path"] = "/tmp/CommandServiceTest.sigmf";
+      config[key]    = "inf";
+
+      const auto response = send(command);
+      ASSERT_TRUE(response.has_value()) << key;
+      EXPECT_FALSE(response->success()) << key;
+      EXPECT_EQ(response->status(), messages::RESPONSE_STATUS_INVALID) << key;
+   }
+}
@@ -0,0 +1,18 @@
+/**
+ * @file TestMain.cpp
+ * @brief Custom Google Test main for RadioWizardDaemonTests.
+ *
+ * Initializes the GeneralLogger before running tests.
+ */
+
+#include <gtest/gtest.h>
+#include "GeneralLogger.h"
+
+int main(int argc, char** argv)
+{
+   CommonUtils::GeneralLogger logger;
+   logger.init("RadioWizardDaemonTests");
+
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
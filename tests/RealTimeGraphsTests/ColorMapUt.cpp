@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "ColorMap.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using RealTimeGraphs::ColorMap;
+
+namespace
+{
+
+constexpr float MIN_DB = -120.0F;
+constexpr float MAX_DB = -20.0F;
+
+// A ramp over and beyond the dB range; 37 exercises the vector tail.
+std::vector<float> ramp(std::size_t n)
+{
+   std::vector<float> db(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      db[i] = MIN_DB - 10.0F + (static_cast<float>(i) * 120.0F / static_cast<float>(n));
+   }
+   return db;
+}
+
+} // namespace
+
+TEST(ColorMapTest, PackedLut_MatchesLut)
+{
+   const ColorMap map(ColorMap::Palette::Viridis);
+   for (std::size_t i = 0; i < map.lut().size(); ++i)
+   {
+      const auto& c = map.lut()[i];
+      const auto* bytes = reinterpret_cast<const uint8_t*>(&map.packedLut()[i]);
+      EXPECT_EQ(bytes[0], c.r);
+      EXPECT_EQ(bytes[1], c.g);
+      EXPECT_EQ(bytes[2], c.b);
+      EXPECT_EQ(bytes[3], c.a);
+   }
+}
+
+TEST(ColorMapTest, MapRow_MatchesMap)
+{
+   const ColorMap map(ColorMap::Palette::Inferno);
+   const float invRange = 1.0F / (MAX_DB - MIN_DB);
+   for (const std::size_t n : {std::size_t{1}, std::size_t{8}, std::size_t{37}, std::size_t{1024}})
+   {
+      const auto db = ramp(n);
+      std::vector<uint32_t> out(n);
+      map.mapRow(db, out, MIN_DB, MAX_DB);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         const auto expected = std::bit_cast<uint32_t>(map.map((db[i] - MIN_DB) * invRange));
+         ASSERT_EQ(out[i], expected) << "n " << n << " bin " << i;
+      }
+   }
+}
+
+TEST(ColorMapTest, MapRow_ClampsNonFinite)
+{
+   const ColorMap map(ColorMap::Palette::Jet);
+   const float inf = std::numeric_limits<float>::infinity();
+   const std::vector<float> db{std::numeric_limits<float>::quiet_NaN(), -inf, inf, 1000.0F,
+                               -1000.0F, MIN_DB, MAX_DB, std::numeric_limits<float>::quiet_NaN(),
+                               inf};
+   std::vector<uint32_t> out(db.size());
+   map.mapRow(db, out, MIN_DB, MAX_DB);
+
+   const auto& lut = map.packedLut();
+   const std::vector<uint32_t> expected{lut[0],   lut[0], lut[255], lut[255], lut[0],
+                                        lut[0],   lut[255], lut[0], lut[255]};
+   EXPECT_EQ(out, expected);
+}
+
+TEST(ColorMapTest, MapRow_EmptyRangeUsesMinimum)
+{
+   const ColorMap map(ColorMap::Palette::Grayscale);
+   const std::vector<float> db(11, -50.0F);
+   std::vector<uint32_t> out(db.size());
+   map.mapRow(db, out, -50.0F, -50.0F);
+   for (const auto pixel : out)
+   {
+      EXPECT_EQ(pixel, map.packedLut()[0]);
+   }
+}
+
+TEST(ColorMapTest, QuantizeThenColorize_MatchesMapRow)
+{
+   const ColorMap map(ColorMap::Palette::Turbo);
+   std::mt19937 rng(7);
+   std::uniform_real_distribution<float> dist(MIN_DB - 20.0F, MAX_DB + 20.0F);
+   std::vector<float> db(1029);
+   for (auto& v : db)
+   {
+      v = dist(rng);
+   }
+
+   std::vector<uint8_t> levels(db.size());
+   ColorMap::quantizeRow(db, levels, MIN_DB, MAX_DB);
+   std::vector<uint32_t> colorized(db.size());
+   map.colorizeRow(levels, colorized);
+   std::vector<uint32_t> mapped(db.size());
+   map.mapRow(db, mapped, MIN_DB, MAX_DB);
+
+   EXPECT_EQ(colorized, mapped);
+   for (std::size_t i = 0; i < db.size(); ++i)
+   {
+      ASSERT_EQ(colorized[i], map.packedLut()[levels[i]]);
+   }
+}
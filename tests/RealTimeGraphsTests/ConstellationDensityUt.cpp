@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "ConstellationDensity.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using RealTimeGraphs::ConstellationDensity;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+constexpr std::size_t GRID = 4;
+
+// Levels of a 4 x 4 grid over [-1, 1] at `now`.
+std::vector<uint8_t> levelsAt(const ConstellationDensity& density,
+                              ConstellationDensity::Clock::time_point now)
+{
+   std::vector<uint8_t> levels(GRID * GRID, 0xAA);
+   density.levels(levels, now);
+   return levels;
+}
+
+} // namespace
+
+TEST(ConstellationDensityTest, Accumulate_BinsByIAndQ)
+{
+   ConstellationDensity density(GRID, 1.0F, 1.0);
+   const auto t0 = ConstellationDensity::Clock::now();
+
+   // Top left (-I, +Q) and the cell right of and below the origin
+   const std::vector<std::complex<float>> samples{{-0.9F, 0.9F}, {0.1F, -0.1F}, {0.1F, -0.1F}};
+   density.accumulate(samples, t0);
+
+   const auto levels = levelsAt(density, t0);
+   EXPECT_EQ(levels[(2 * GRID) + 2], 255);   // the peak cell
+   EXPECT_GT(levels[0], 0);
+   EXPECT_LT(levels[0], 255);
+   for (std::size_t i = 0; i < levels.size(); ++i)
+   {
+      if (i != 0 && i != (2 * GRID) + 2)
+      {
+         EXPECT_EQ(levels[i], 0) << i;
+      }
+   }
+}
+
+TEST(ConstellationDensityTest, Accumulate_DiscardsOutOfRangeAndNaN)
+{
+   ConstellationDensity density(GRID, 1.0F, 1.0);
+   const auto t0 = ConstellationDensity::Clock::now();
+   constexpr float NAN_VALUE = std::numeric_limits<float>::quiet_NaN();
+   constexpr float INF_VALUE = std::numeric_limits<float>::infinity();
+
+   const std::vector<std::complex<float>> samples{
+      {1.0F, 0.0F}, {-1.5F, 0.0F}, {0.0F, 2.0F}, {NAN_VALUE, 0.0F},
+      {0.0F, NAN_VALUE}, {INF_VALUE, 0.0F}, {-INF_VALUE, -INF_VALUE}};
+   density.accumulate(samples, t0);
+
+   for (const uint8_t level : levelsAt(density, t0))
+   {
+      EXPECT_EQ(level, 0);
+   }
+
+   // The edge below the range is inside
+   density.accumulate(std::vector<std::complex<float>>{{-1.0F, -0.99F}}, t0);
+   EXPECT_EQ(levelsAt(density, t0)[(3 * GRID) + 0], 255);
+}
+
+TEST(ConstellationDensityTest, Accumulate_OlderCountsDecay)
+{
+   ConstellationDensity density(GRID, 1.0F, 1.0);
+   const auto t0 = ConstellationDensity::Clock::now();
+   density.accumulate(std::vector<std::complex<float>>{{-0.9F, 0.9F}}, t0);
+
+   // After ln(1000) = 6.9 time constants the first cell is below the range
+   density.accumulate(std::vector<std::complex<float>>{{0.9F, -0.9F}}, t0 + 8s);
+   const auto levels = levelsAt(density, t0 + 8s);
+   EXPECT_EQ(levels[0], 0);
+   EXPECT_EQ(levels[(GRID * GRID) - 1], 255);
+
+   // ...and well inside it after one
+   density.accumulate(std::vector<std::complex<float>>{{-0.9F, 0.9F}}, t0 + 9s);
+   const auto later = levelsAt(density, t0 + 9s);
+   EXPECT_EQ(later[0], 255);
+   EXPECT_GT(later[(GRID * GRID) - 1], 100);
+}
+
+TEST(ConstellationDensityTest, Levels_FadeWithoutSamples)
+{
+   ConstellationDensity density(GRID, 1.0F, 1.0);
+   const auto t0 = ConstellationDensity::Clock::now();
+   density.accumulate(std::vector<std::complex<float>>{{0.1F, 0.1F}}, t0);
+
+   const uint8_t fresh  = levelsAt(density, t0)[GRID + 2];
+   const uint8_t faded  = levelsAt(density, t0 + 3s)[GRID + 2];
+   const uint8_t gone   = levelsAt(density, t0 + 10s)[GRID + 2];
+   EXPECT_EQ(fresh, 255);
+   EXPECT_GT(faded, 0);
+   EXPECT_LT(faded, fresh);
+   EXPECT_EQ(gone, 0);
+}
+
+TEST(ConstellationDensityTest, Accumulate_StaysFiniteOverLongRuns)
+{
+   ConstellationDensity density(GRID, 1.0F, 0.5);
+   auto now = ConstellationDensity::Clock::now();
+
+   // Each batch weighs e^2 more than the last: the weight must be rescaled
+   for (int i = 0; i < 200; ++i)
+   {
+      now += 1s;
+      density.accumulate(std::vector<std::complex<float>>{{0.1F, 0.1F}, {-0.1F, -0.1F}}, now);
+   }
+
+   const auto levels = levelsAt(density, now);
+   EXPECT_EQ(levels[GRID + 2], 255);
+   EXPECT_EQ(levels[(2 * GRID) + 1], 255);
+}
+
+TEST(ConstellationDensityTest, SetAxisRange_ClearsCounts)
+{
+   ConstellationDensity density(GRID, 1.0F, 1.0);
+   const auto t0 = ConstellationDensity::Clock::now();
+   density.accumulate(std::vector<std::complex<float>>{{0.1F, 0.1F}}, t0);
+
+   density.setAxisRange(2.0F);
+   EXPECT_FLOAT_EQ(density.axisRange(), 2.0F);
+   for (const uint8_t level : levelsAt(density, t0))
+   {
+      EXPECT_EQ(level, 0);
+   }
+
+   // The new range bins 1.5 inside the grid
+   density.accumulate(std::vector<std::complex<float>>{{1.5F, 1.5F}}, t0);
+   EXPECT_EQ(levelsAt(density, t0)[GRID - 1], 255);
+}
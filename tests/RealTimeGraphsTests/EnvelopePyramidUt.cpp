@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "EnvelopePyramid.h"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using RealTimeGraphs::EnvelopePyramid;
+
+namespace
+{
+
+constexpr std::size_t CAPACITY = 8192;
+
+// Ring plus pyramid, written the way OscilloscopeWidget::setData() does.
+struct Capture
+{
+   std::vector<std::complex<float>> ring = std::vector<std::complex<float>>(CAPACITY);
+   EnvelopePyramid pyramid{CAPACITY};
+   std::size_t head{0};
+
+   void write(const std::vector<std::complex<float>>& samples)
+   {
+      const auto begin = head;
+      for (const auto& sample : samples)
+      {
+         ring[head] = sample;
+         head = (head + 1) % CAPACITY;
+      }
+      pyramid.update(ring, begin, samples.size());
+   }
+};
+
+// Reference: scan every sample of the range.
+EnvelopePyramid::Extent scan(const std::vector<std::complex<float>>& ring, std::size_t begin,
+                             std::size_t count)
+{
+   constexpr float INF = std::numeric_limits<float>::infinity();
+   EnvelopePyramid::Extent extent{{INF, INF}, {-INF, -INF}};
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      const auto& s = ring[(begin + i) % ring.size()];
+      extent.lo = {std::min(extent.lo.real(), s.real()), std::min(extent.lo.imag(), s.imag())};
+      extent.hi = {std::max(extent.hi.real(), s.real()), std::max(extent.hi.imag(), s.imag())};
+   }
+   return extent;
+}
+
+std::vector<std::complex<float>> randomBatch(std::mt19937& rng, std::size_t count)
+{
+   std::uniform_real_distribution<float> value(-1.0F, 1.0F);
+   std::vector<std::complex<float>> batch(count);
+   for (auto& sample : batch)
+   {
+      sample = {value(rng), value(rng)};
+   }
+   return batch;
+}
+
+} // namespace
+
+TEST(EnvelopePyramidTest, Constructor_RejectsUnalignedCapacity)
+{
+   EXPECT_THROW(EnvelopePyramid(0), std::invalid_argument);
+   EXPECT_THROW(EnvelopePyramid(4096 + 16), std::invalid_argument);
+   EXPECT_NO_THROW(EnvelopePyramid(4096 * 3));
+}
+
+TEST(EnvelopePyramidTest, Extent_MatchesScanAcrossWrites)
+{
+   Capture capture;
+   std::mt19937 rng(7);
+   std::uniform_int_distribution<std::size_t> batchSize(1, 3000);
+   std::uniform_int_distribution<std::size_t> index(0, CAPACITY - 1);
+   std::uniform_int_distribution<std::size_t> length(1, CAPACITY);
+
+   // Mixed batch sizes wrap the ring several times
+   for (int batch = 0; batch < 40; ++batch)
+   {
+      capture.write(randomBatch(rng, batchSize(rng)));
+
+      for (int query = 0; query < 50; ++query)
+      {
+         const std::size_t begin = index(rng);
+         const std::size_t count = length(rng);
+         const auto expected = scan(capture.ring, begin, count);
+         const auto actual   = capture.pyramid.extent(capture.ring, begin, count);
+         ASSERT_EQ(actual.lo, expected.lo) << begin << " + " << count;
+         ASSERT_EQ(actual.hi, expected.hi) << begin << " + " << count;
+      }
+   }
+}
+
+TEST(EnvelopePyramidTest, Update_ForgetsOverwrittenPeaks)
+{
+   Capture capture;
+   capture.write(std::vector<std::complex<float>>(CAPACITY, {0.1F, -0.1F}));
+   capture.write({{5.0F, -5.0F}});
+   EXPECT_EQ(capture.pyramid.extent(capture.ring, 0, CAPACITY).hi.real(), 5.0F);
+
+   // One sample at a time round to the peak: its blocks are rebuilt
+   for (std::size_t i = 1; i < CAPACITY; ++i)
+   {
+      capture.write({{0.2F, -0.2F}});
+   }
+   EXPECT_EQ(capture.pyramid.extent(capture.ring, 0, CAPACITY).hi.real(), 5.0F);
+   capture.write({{0.2F, -0.2F}});
+
+   const auto extent = capture.pyramid.extent(capture.ring, 0, CAPACITY);
+   EXPECT_EQ(extent.hi, std::complex<float>(0.2F, -0.2F));
+   EXPECT_EQ(extent.lo, std::complex<float>(0.2F, -0.2F));
+}
+
+TEST(EnvelopePyramidTest, Update_WholeRingBatch)
+{
+   Capture capture;
+   std::mt19937 rng(3);
+   capture.head = 100;
+   capture.write(randomBatch(rng, CAPACITY));
+
+   for (const std::size_t begin : {std::size_t{0}, std::size_t{15}, std::size_t{4095}})
+   {
+      const auto expected = scan(capture.ring, begin, CAPACITY - 1);
+      const auto actual   = capture.pyramid.extent(capture.ring, begin, CAPACITY - 1);
+      EXPECT_EQ(actual.lo, expected.lo);
+      EXPECT_EQ(actual.hi, expected.hi);
+   }
+}
+
+TEST(EnvelopePyramidTest, Extent_IgnoresNaN)
+{
+   Capture capture;
+   constexpr float NAN_VALUE = std::numeric_limits<float>::quiet_NaN();
+   std::vector<std::complex<float>> samples(64, {0.5F, 0.5F});
+   samples[0]  = {NAN_VALUE, NAN_VALUE};
+   samples[20] = {0.75F, NAN_VALUE};
+   capture.write(samples);
+
+   const auto extent = capture.pyramid.extent(capture.ring, 0, 64);
+   EXPECT_EQ(extent.hi, std::complex<float>(0.75F, 0.5F));
+   EXPECT_EQ(extent.lo, std::complex<float>(0.5F, 0.5F));
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "PlotRasterizer.h"
+
+#include <QColor>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using RealTimeGraphs::PlotRasterizer;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Wait up to a second for `frames` to reach `count`.
+bool waitForFrames(const std::atomic<int>& frames, int count)
+{
+   for (int i = 0; i < 1000 && frames.load() < count; ++i)
+   {
+      std::this_thread::sleep_for(1ms);
+   }
+   return frames.load() >= count;
+}
+
+} // namespace
+
+TEST(PlotRasterizerTest, RequestFrame_PaintsTheViewOffThread)
+{
+   std::atomic<int> frames{0};
+   std::thread::id painter;
+   PlotRasterizer rasterizer(
+      [&painter](QPainter& p, const QRect& area, const PlotRasterizer::View& /*view*/)
+      {
+         painter = std::this_thread::get_id();
+         p.fillRect(area, QColor(10, 20, 30));
+      },
+      [&frames]() { ++frames; });
+
+   EXPECT_TRUE(rasterizer.latestFrame().isNull());
+
+   rasterizer.setView({QSize(40, 30), 2.0, 0.0, 1.0});
+   ASSERT_TRUE(waitForFrames(frames, 1));
+
+   const QImage frame = rasterizer.latestFrame();
+   EXPECT_EQ(frame.size(), QSize(80, 60));   // device pixels
+   EXPECT_EQ(frame.pixelColor(79, 59), QColor(10, 20, 30));
+   EXPECT_NE(painter, std::this_thread::get_id());
+}
+
+TEST(PlotRasterizerTest, SetView_RendersOnlyOnChange)
+{
+   std::atomic<int> frames{0};
+   std::atomic<double> lastStart{-1.0};
+   PlotRasterizer rasterizer(
+      [&lastStart](QPainter& /*p*/, const QRect& /*area*/, const PlotRasterizer::View& view)
+      { lastStart = view.xStart; },
+      [&frames]() { ++frames; });
+
+   const PlotRasterizer::View view{QSize(16, 16), 1.0, 0.25, 0.75};
+   rasterizer.setView(view);
+   ASSERT_TRUE(waitForFrames(frames, 1));
+   EXPECT_DOUBLE_EQ(lastStart.load(), 0.25);
+
+   rasterizer.setView(view);
+   std::this_thread::sleep_for(20ms);
+   EXPECT_EQ(frames.load(), 1);
+
+   rasterizer.requestFrame();
+   EXPECT_TRUE(waitForFrames(frames, 2));
+}
+
+TEST(PlotRasterizerTest, RequestFrame_CoalescesWhileBusy)
+{
+   std::atomic<int> frames{0};
+   PlotRasterizer rasterizer(
+      [](QPainter& /*p*/, const QRect& /*area*/, const PlotRasterizer::View& /*view*/)
+      { std::this_thread::sleep_for(20ms); },
+      [&frames]() { ++frames; });
+
+   rasterizer.setView({QSize(8, 8), 1.0, 0.0, 1.0});
+   for (int i = 0; i < 100; ++i)
+   {
+      rasterizer.requestFrame();
+   }
+   ASSERT_TRUE(waitForFrames(frames, 1));
+   std::this_thread::sleep_for(100ms);
+   EXPECT_LE(frames.load(), 3);
+}
+
+TEST(PlotRasterizerTest, EmptyView_RendersNothing)
+{
+   std::atomic<int> frames{0};
+   {
+      PlotRasterizer rasterizer(
+         [](QPainter& /*p*/, const QRect& /*area*/, const PlotRasterizer::View& /*view*/) {},
+         [&frames]() { ++frames; });
+      rasterizer.requestFrame();
+      std::this_thread::sleep_for(20ms);
+   }
+   EXPECT_EQ(frames.load(), 0);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "RenderClock.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <thread>
+
+using RealTimeGraphs::RenderClock;
+
+namespace
+{
+
+// Run the event loop for `ms` milliseconds.
+void processEventsFor(int ms)
+{
+   QElapsedTimer timer;
+   timer.start();
+   while (timer.elapsed() < ms)
+   {
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+   }
+}
+
+} // namespace
+
+TEST(RenderClockTest, MarkDirty_CoalescesToOneRepaint)
+{
+   int repaints = 0;
+   RenderClock::Client client([&repaints]() { ++repaints; });
+
+   for (int i = 0; i < 1000; ++i)
+   {
+      client.markDirty();
+   }
+   EXPECT_EQ(repaints, 0);   // only in a tick
+
+   processEventsFor(100);
+   EXPECT_EQ(repaints, 1);
+}
+
+TEST(RenderClockTest, MarkDirty_FromOtherThread)
+{
+   int repaints = 0;
+   RenderClock::Client client([&repaints]() { ++repaints; });
+
+   std::thread producer([&client]()
+   {
+      for (int i = 0; i < 1000; ++i)
+      {
+         client.markDirty();
+      }
+   });
+   producer.join();
+
+   processEventsFor(100);
+   EXPECT_EQ(repaints, 1);
+}
+
+TEST(RenderClockTest, Tick_RepaintsAllDirtyClientsOnly)
+{
+   int first  = 0;
+   int second = 0;
+   int third  = 0;
+   RenderClock::Client a([&first]() { ++first; });
+   RenderClock::Client b([&second]() { ++second; });
+   RenderClock::Client c([&third]() { ++third; });
+
+   a.markDirty();
+   b.markDirty();
+   processEventsFor(100);
+   EXPECT_EQ(first, 1);
+   EXPECT_EQ(second, 1);
+   EXPECT_EQ(third, 0);
+
+   // Wakes again after going idle
+   c.markDirty();
+   processEventsFor(100);
+   EXPECT_EQ(first, 1);
+   EXPECT_EQ(third, 1);
+}
+
+TEST(RenderClockTest, DestroyedClient_IsNotRepainted)
+{
+   int repaints = 0;
+   {
+      RenderClock::Client client([&repaints]() { ++repaints; });
+      client.markDirty();
+   }
+   processEventsFor(100);
+   EXPECT_EQ(repaints, 0);
+}
@@ -2,14 +2,21 @@
  * @file TestMain.cpp
  * @brief Google Test main for RealTimeGraphsTests.
  *
- * Initializes a QApplication (required for QWidget tests) before running tests.
+ * Initializes the GeneralLogger and a QApplication (required for QWidget
+ * tests) before running tests.
  */
 
 #include <gtest/gtest.h>
+#include "GeneralLogger.h"
+
 #include <QApplication>
 
 int main(int argc, char** argv)
 {
+   // Initialize the GeneralLogger for test output
+   CommonUtils::GeneralLogger logger;
+   logger.init("RealTimeGraphsTests");
+
    QApplication app(argc, argv);
 
    ::testing::InitGoogleTest(&argc, argv);
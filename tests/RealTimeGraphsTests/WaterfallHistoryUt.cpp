@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "ColorMap.h"
+#include "WaterfallHistory.h"
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using RealTimeGraphs::WaterfallHistory;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Append a row whose every bin holds `level`.
+void appendRow(WaterfallHistory& history, std::size_t bins, uint8_t level,
+               WaterfallHistory::Clock::time_point time)
+{
+   const auto row = history.append(bins, time);
+   ASSERT_EQ(row.size(), bins);
+   std::ranges::fill(row, level);
+}
+
+} // namespace
+
+TEST(WaterfallHistoryTest, Quantize_MatchesColorMapIndex)
+{
+   const RealTimeGraphs::ColorMap colorMap(RealTimeGraphs::ColorMap::Palette::Inferno);
+   for (const float value : {-0.5F, 0.0F, 0.001F, 0.25F, 0.5F, 0.999F, 1.0F, 2.0F})
+   {
+      const auto level = WaterfallHistory::quantize(value);
+      const auto expected = colorMap.map(value);
+      const auto actual   = colorMap.lut()[level];
+      EXPECT_EQ(actual.r, expected.r) << value;
+      EXPECT_EQ(actual.g, expected.g) << value;
+      EXPECT_EQ(actual.b, expected.b) << value;
+   }
+   EXPECT_EQ(WaterfallHistory::quantize(1.0F), WaterfallHistory::MAX_LEVEL);
+}
+
+TEST(WaterfallHistoryTest, Rows_KeptInOrderAcrossGrowth)
+{
+   WaterfallHistory history(1000.0);
+   const auto start = WaterfallHistory::Clock::now();
+   constexpr std::size_t ROWS = 3 * WaterfallHistory::MIN_CAPACITY_ROWS;
+   for (std::size_t i = 0; i < ROWS; ++i)
+   {
+      appendRow(history, 16, static_cast<uint8_t>(i), start + (i * 10ms));
+   }
+
+   ASSERT_EQ(history.size(), ROWS);
+   EXPECT_GE(history.capacity(), ROWS);
+   EXPECT_EQ(history.storage().size(), history.capacity() * 16);
+   for (std::size_t i = 0; i < ROWS; ++i)
+   {
+      EXPECT_EQ(history.row(i)[0], static_cast<uint8_t>(i));
+      EXPECT_EQ(history.timestamp(i), start + (i * 10ms));
+   }
+   EXPECT_NEAR(history.rowRate(), 100.0, 1.0);
+}
+
+TEST(WaterfallHistoryTest, OldRows_DroppedAndSlotsReused)
+{
+   WaterfallHistory history(1.0);
+   const auto start = WaterfallHistory::Clock::now();
+
+   // 100 rows/s for 10 s with a 1 s window: the ring settles, then wraps
+   for (std::size_t i = 0; i < 1000; ++i)
+   {
+      appendRow(history, 8, static_cast<uint8_t>(i % 200), start + (i * 10ms));
+   }
+   const std::size_t settled = history.capacity();
+   EXPECT_LE(settled, 256U);
+   EXPECT_LE(history.size(), 101U);
+   EXPECT_EQ(history.row(history.size() - 1)[0], static_cast<uint8_t>(999 % 200));
+
+   for (std::size_t i = 1000; i < 1500; ++i)
+   {
+      appendRow(history, 8, 0, start + (i * 10ms));
+   }
+   EXPECT_EQ(history.capacity(), settled);
+}
+
+TEST(WaterfallHistoryTest, EvictionHandler_ReceivesDroppedRowsOldestFirst)
+{
+   WaterfallHistory history(1.0);
+   std::vector<uint8_t> evictedLevels;
+   std::vector<WaterfallHistory::Clock::time_point> evictedTimes;
+   history.setEvictionHandler(
+      [&](std::span<const uint8_t> levels, WaterfallHistory::Clock::time_point time)
+      {
+         evictedLevels.push_back(levels[0]);
+         evictedTimes.push_back(time);
+      });
+
+   const auto start = WaterfallHistory::Clock::now();
+   for (std::size_t i = 0; i < 300; ++i)
+   {
+      appendRow(history, 8, static_cast<uint8_t>(i), start + (i * 10ms));
+   }
+
+   // Every row is either still held or was handed over, once, in order
+   ASSERT_EQ(evictedLevels.size() + history.size(), 300U);
+   for (std::size_t i = 0; i < evictedLevels.size(); ++i)
+   {
+      EXPECT_EQ(evictedLevels[i], static_cast<uint8_t>(i));
+      EXPECT_EQ(evictedTimes[i], start + (i * 10ms));
+   }
+   EXPECT_EQ(history.row(0)[0], static_cast<uint8_t>(evictedLevels.size()));
+}
+
+TEST(WaterfallHistoryTest, SetMaxAge_ShrinksStorage)
+{
+   WaterfallHistory history(100.0);
+   const auto start = WaterfallHistory::Clock::now();
+   for (std::size_t i = 0; i < 2000; ++i)
+   {
+      appendRow(history, 4, 1, start + (i * 10ms));
+   }
+   const std::size_t large = history.capacity();
+
+   const auto now = start + (1999 * 10ms);
+   history.setMaxAge(0.5, now);
+   EXPECT_LE(history.size(), 51U);
+   EXPECT_LT(history.capacity(), large / 4);
+   EXPECT_EQ(history.timestamp(history.size() - 1), now);
+}
+
+TEST(WaterfallHistoryTest, BinCountChange_ClearsRows)
+{
+   WaterfallHistory history(10.0);
+   const auto start = WaterfallHistory::Clock::now();
+   appendRow(history, 8, 10, start);
+   appendRow(history, 8, 20, start + 10ms);
+   appendRow(history, 4, 30, start + 20ms);
+
+   ASSERT_EQ(history.size(), 1U);
+   EXPECT_EQ(history.binCount(), 4U);
+   EXPECT_EQ(history.row(0).size(), 4U);
+   EXPECT_EQ(history.row(0)[3], 30);
+}
+
+TEST(WaterfallHistoryTest, LevelRange_SpansAllRows)
+{
+   WaterfallHistory history(10.0);
+   EXPECT_FALSE(history.levelRange().has_value());
+
+   const auto start = WaterfallHistory::Clock::now();
+   appendRow(history, 4, 40, start);
+   auto row = history.append(4, start + 10ms);
+   row[0] = 7;
+   row[1] = 90;
+   row[2] = 40;
+   row[3] = 40;
+
+   const auto range = history.levelRange();
+   ASSERT_TRUE(range.has_value());
+   EXPECT_EQ(range->first, 7);
+   EXPECT_EQ(range->second, 90);
+}
+
+TEST(WaterfallHistoryTest, MemoryBudget_CapsRowsAndDropsOldest)
+{
+   constexpr std::size_t BINS     = 64;
+   constexpr std::size_t ROW_COST = BINS + sizeof(WaterfallHistory::Clock::time_point);
+   auto& registry = CommonUtils::MemoryRegistry::instance();
+   registry.setBudget(WaterfallHistory::MEMORY_ACCOUNT, 100 * ROW_COST);
+
+   WaterfallHistory history(1000.0);
+   std::size_t evicted = 0;
+   history.setEvictionHandler(
+      [&](std::span<const uint8_t> /*levels*/, WaterfallHistory::Clock::time_point /*time*/)
+      {
+         ++evicted;
+      });
+
+   const auto start = WaterfallHistory::Clock::now();
+   for (std::size_t i = 0; i < 500; ++i)
+   {
+      appendRow(history, BINS, static_cast<uint8_t>(i), start + (i * 10ms));
+   }
+
+   // Well within the age, but only the newest 100 rows fit the budget
+   EXPECT_EQ(history.capacity(), 100U);
+   EXPECT_EQ(history.size(), 100U);
+   EXPECT_EQ(evicted, 400U);
+   EXPECT_EQ(history.row(99)[0], static_cast<uint8_t>(499));
+
+   bool found = false;
+   for (const auto& account : registry.allStats())
+   {
+      if (account.name == WaterfallHistory::MEMORY_ACCOUNT && account.reliefs > 0)
+      {
+         found = true;
+         EXPECT_LE(account.currentBytes, account.budgetBytes);
+      }
+   }
+   EXPECT_TRUE(found);
+   registry.setBudget(WaterfallHistory::MEMORY_ACCOUNT, 0);
+}
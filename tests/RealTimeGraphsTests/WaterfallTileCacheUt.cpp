@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "WaterfallTileCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using RealTimeGraphs::WaterfallTileCache;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+constexpr std::size_t BINS = 1024;
+constexpr std::size_t TILE_ROWS = WaterfallTileCache::TILE_BYTES / BINS;
+
+std::string cachePath()
+{
+   return (std::filesystem::temp_directory_path() / "WaterfallTileCacheUt.bin").string();
+}
+
+// A slowly drifting spectrum, tagged with its index in bin 0.
+std::vector<uint8_t> rowFor(std::size_t index)
+{
+   std::vector<uint8_t> row(BINS);
+   for (std::size_t b = 0; b < BINS; ++b)
+   {
+      row[b] = static_cast<uint8_t>((b / 8) + (index / 16) + ((b * index) % 61 == 0 ? 9 : 0));
+   }
+   row[0] = static_cast<uint8_t>(index);
+   return row;
+}
+
+} // namespace
+
+TEST(WaterfallTileCacheTest, RowAt_ReturnsLatestRowAtOrBefore)
+{
+   auto cache = WaterfallTileCache::create(cachePath(), 0);
+   ASSERT_NE(cache, nullptr);
+   EXPECT_FALSE(std::filesystem::exists(cachePath()));   // unlinked once open
+
+   const auto start = WaterfallTileCache::Clock::now();
+   constexpr std::size_t ROWS = (3 * TILE_ROWS) + 17;   // sealed tiles and an open one
+   for (std::size_t i = 0; i < ROWS; ++i)
+   {
+      cache->append(rowFor(i), start + (i * 10ms));
+   }
+   EXPECT_EQ(cache->size(), ROWS);
+   EXPECT_EQ(cache->oldestTime(), start);
+   EXPECT_GT(cache->storedBytes(), 0U);
+   EXPECT_LT(cache->storedBytes(), 3 * WaterfallTileCache::TILE_BYTES / 2);
+
+   EXPECT_FALSE(cache->rowAt(start - 1ms).has_value());
+   for (std::size_t i = 0; i < ROWS; i += 7)
+   {
+      const auto exact = cache->rowAt(start + (i * 10ms));
+      ASSERT_TRUE(exact.has_value()) << i;
+      EXPECT_EQ(exact->time, start + (i * 10ms));
+      const auto expected = rowFor(i);
+      ASSERT_TRUE(std::ranges::equal(exact->levels, expected)) << i;
+
+      const auto between = cache->rowAt(start + (i * 10ms) + 9ms);
+      ASSERT_TRUE(between.has_value());
+      EXPECT_EQ(between->levels[0], static_cast<uint8_t>(i));
+   }
+   EXPECT_EQ(cache->rowAt(start + 1h)->levels[0], static_cast<uint8_t>(ROWS - 1));
+}
+
+TEST(WaterfallTileCacheTest, RowAt_DecodesBeyondTheLru)
+{
+   auto cache = WaterfallTileCache::create(cachePath(), 0);
+   ASSERT_NE(cache, nullptr);
+
+   const auto start = WaterfallTileCache::Clock::now();
+   const std::size_t tiles = WaterfallTileCache::CACHED_TILES + 4;
+   for (std::size_t i = 0; i < tiles * TILE_ROWS; ++i)
+   {
+      cache->append(rowFor(i), start + (i * 10ms));
+   }
+
+   // Forward and back again: each tile is decoded again after eviction
+   for (int pass = 0; pass < 2; ++pass)
+   {
+      for (std::size_t t = 0; t < tiles; ++t)
+      {
+         const std::size_t i = (pass == 0) ? t * TILE_ROWS : (tiles - 1 - t) * TILE_ROWS;
+         const auto row = cache->rowAt(start + (i * 10ms));
+         ASSERT_TRUE(row.has_value());
+         ASSERT_TRUE(std::ranges::equal(row->levels, rowFor(i))) << i;
+      }
+   }
+}
+
+TEST(WaterfallTileCacheTest, FullFile_OverwritesOldestTiles)
+{
+   auto cache = WaterfallTileCache::create(cachePath(), WaterfallTileCache::MIN_BYTES);
+   ASSERT_NE(cache, nullptr);
+
+   // Incompressible rows, so the ring wraps several times
+   std::mt19937 rng(3);
+   std::vector<uint8_t> row(BINS);
+   const auto start = WaterfallTileCache::Clock::now();
+   constexpr std::size_t ROWS = 40 * TILE_ROWS;
+   for (std::size_t i = 0; i < ROWS; ++i)
+   {
+      for (auto& level : row)
+      {
+         level = static_cast<uint8_t>(rng());
+      }
+      row[0] = static_cast<uint8_t>(i);
+      cache->append(row, start + (i * 10ms));
+   }
+
+   EXPECT_LE(cache->storedBytes(), cache->capacity());
+   EXPECT_LT(cache->size(), ROWS);
+   const auto oldest = cache->oldestTime();
+   ASSERT_TRUE(oldest.has_value());
+   EXPECT_GT(*oldest, start);
+   EXPECT_FALSE(cache->rowAt(*oldest - 1ms).has_value());
+
+   // Everything still indexed decodes, up to the newest row
+   for (auto t = *oldest; t < start + (ROWS * 10ms); t += 10ms * TILE_ROWS / 2)
+   {
+      const auto found = cache->rowAt(t);
+      ASSERT_TRUE(found.has_value());
+      EXPECT_EQ(found->time, t);
+      EXPECT_EQ(found->levels[0], static_cast<uint8_t>((t - start) / 10ms));
+   }
+}
+
+TEST(WaterfallTileCacheTest, BinCountChange_ClearsRows)
+{
+   auto cache = WaterfallTileCache::create(cachePath(), 0);
+   ASSERT_NE(cache, nullptr);
+
+   const auto start = WaterfallTileCache::Clock::now();
+   for (std::size_t i = 0; i < 2 * TILE_ROWS; ++i)
+   {
+      cache->append(rowFor(i), start + (i * 10ms));
+   }
+   cache->append(std::vector<uint8_t>(16, 5), start + 1h);
+
+   EXPECT_EQ(cache->size(), 1U);
+   EXPECT_EQ(cache->binCount(), 16U);
+   EXPECT_FALSE(cache->rowAt(start + 1s).has_value());
+   EXPECT_EQ(cache->rowAt(start + 2h)->levels[3], 5);
+}
+
+TEST(WaterfallTileCacheTest, Create_FailsForUnwritablePath)
+{
+   EXPECT_EQ(WaterfallTileCache::create("/nonexistent-dir/cache.bin", 0), nullptr);
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include "AudioDriftCompensator.h"
+#include "AudioRing.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <vector>
+
+using SdrEngine::AudioDriftCompensator;
+using SdrEngine::AudioRing;
+
+namespace
+{
+
+constexpr double RATE = 48'000.0;
+constexpr double TARGET_FRAMES = 0.05 * RATE;   // 50 ms.
+
+} // anonymous namespace
+
+// ============================================================================
+// Ratio control
+// ============================================================================
+
+TEST(AudioDriftCompensatorTest, FillAtTarget_PassesSamplesThroughUnchanged)
+{
+   AudioDriftCompensator comp(2, TARGET_FRAMES);
+   std::vector<float> in(2 * 256);
+   for (std::size_t i = 0; i < in.size(); ++i)
+   {
+      in[i] = std::sin(static_cast<float>(i) * 0.01F);
+   }
+   std::vector<float> out(2 * comp.outputBound(256));
+
+   std::vector<float> all;
+   for (int block = 0; block < 4; ++block)
+   {
+      const std::size_t n = comp.process(in.data(), 256, static_cast<std::size_t>(TARGET_FRAMES), out.data());
+      all.insert(all.end(), out.begin(), out.begin() + static_cast<std::ptrdiff_t>(2 * n));
+   }
+   EXPECT_DOUBLE_EQ(comp.getRatio(), 1.0);
+
+   // Unity ratio lands on input frames exactly; the last two frames wait
+   // for the next block.
+   ASSERT_EQ(all.size(), 4 * in.size() - 4);
+   for (std::size_t i = 0; i < all.size(); ++i)
+   {
+      ASSERT_FLOAT_EQ(all[i], in[i % in.size()]) << "sample " << i;
+   }
+}
+
+TEST(AudioDriftCompensatorTest, PlanarIntoRegions_MatchesInterleaved)
+{
+   constexpr std::size_t FRAMES = 300;
+   std::vector<float> left(FRAMES);
+   std::vector<float> right(FRAMES);
+   std::vector<float> interleaved(2 * FRAMES);
+   for (std::size_t i = 0; i < FRAMES; ++i)
+   {
+      left[i] = std::sin(static_cast<float>(i) * 0.03F);
+      right[i] = std::cos(static_cast<float>(i) * 0.07F);
+      interleaved[2 * i] = left[i];
+      interleaved[(2 * i) + 1] = right[i];
+   }
+
+   // Off-target fill so the ratio is not unity.
+   AudioDriftCompensator reference(2, TARGET_FRAMES);
+   AudioDriftCompensator planar(2, TARGET_FRAMES);
+   std::vector<float> expected(2 * reference.outputBound(FRAMES));
+   std::vector<float> split(expected.size());
+   const std::array<const float*, 2> planes = {left.data(), right.data()};
+
+   for (int block = 0; block < 50; ++block)
+   {
+      const std::size_t n = reference.process(interleaved.data(), FRAMES, 0, expected.data());
+      // Split mid-frame to exercise a wrap that is not frame aligned.
+      const std::span<float> all(split);
+      const std::size_t m = planar.processPlanar(planes, FRAMES, 0, all.first(77), all.subspan(77));
+      ASSERT_EQ(n, m);
+      for (std::size_t i = 0; i < 2 * n; ++i)
+      {
+         ASSERT_FLOAT_EQ(split[i], expected[i]) << "block " << block << " sample " << i;
+      }
+   }
+   EXPECT_GT(planar.getRatio(), 1.0);
+}
+
+TEST(AudioDriftCompensatorTest, RegionsTooSmall_StoresWholeFramesOnly)
+{
+   AudioDriftCompensator comp(2, TARGET_FRAMES);
+   std::vector<float> in(2 * 64, 0.25F);
+   std::vector<float> out(9, -1.0F);
+
+   const std::size_t generated = comp.process(in.data(), 64, static_cast<std::size_t>(TARGET_FRAMES),
+                                              std::span<float>(out).first(5), std::span<float>(out).subspan(5, 2));
+   EXPECT_EQ(generated, 62U);
+   for (std::size_t i = 0; i < 6; ++i)
+   {
+      EXPECT_FLOAT_EQ(out[i], 0.25F);
+   }
+   EXPECT_FLOAT_EQ(out[6], -1.0F);   // Half a frame is not written.
+}
+
+TEST(AudioDriftCompensatorTest, OverfullRing_ProducesFewerFrames)
+{
+   AudioDriftCompensator comp(1, TARGET_FRAMES);
+   std::vector<float> in(1024, 0.5F);
+   std::vector<float> out(comp.outputBound(in.size()));
+
+   std::size_t produced = 0;
+   for (int block = 0; block < 500; ++block)
+   {
+      produced += comp.process(in.data(), in.size(), static_cast<std::size_t>(2 * TARGET_FRAMES), out.data());
+   }
+   EXPECT_LT(comp.getRatio(), 1.0);
+   EXPECT_GE(comp.getRatio(), 1.0 - AudioDriftCompensator::MAX_CORRECTION);
+   EXPECT_LT(produced, 500U * in.size());
+}
+
+TEST(AudioDriftCompensatorTest, StarvedRing_ProducesMoreFrames)
+{
+   AudioDriftCompensator comp(1, TARGET_FRAMES);
+   std::vector<float> in(1024, 0.5F);
+   std::vector<float> out(comp.outputBound(in.size()));
+
+   std::size_t produced = 0;
+   for (int block = 0; block < 500; ++block)
+   {
+      produced += comp.process(in.data(), in.size(), 0, out.data());
+   }
+   EXPECT_GT(comp.getRatio(), 1.0);
+   EXPECT_LE(comp.getRatio(), 1.0 + AudioDriftCompensator::MAX_CORRECTION);
+   EXPECT_GT(produced, 500U * in.size());
+}
+
+TEST(AudioDriftCompensatorTest, OutputBound_HoldsAtMaximumRatio)
+{
+   AudioDriftCompensator comp(2, TARGET_FRAMES);
+   std::vector<float> in(2 * 7, 0.0F);
+   for (int block = 0; block < 20000; ++block)
+   {
+      std::vector<float> out(2 * comp.outputBound(7), 0.0F);
+      const std::size_t n = comp.process(in.data(), 7, 0, out.data());
+      ASSERT_LE(n, comp.outputBound(7));
+   }
+}
+
+// ============================================================================
+// Closed loop
+// ============================================================================
+
+TEST(AudioDriftCompensatorTest, ClockDrift_FillSettlesAtTargetWithoutGlitches)
+{
+   // The SDR delivers 200 ppm more audio than the sound card plays, in
+   // bursts of 1700 frames; the card pulls 480 frames at a time.
+   constexpr std::size_t CHANNELS = 2;
+   constexpr double PRODUCER_RATE = RATE * 1.0002;
+   constexpr std::size_t BLOCK_FRAMES = 1700;
+   constexpr std::size_t PULL_FRAMES = 480;
+   constexpr double SECONDS = 240.0;
+
+   AudioRing ring(CHANNELS * static_cast<std::size_t>(8 * TARGET_FRAMES));
+   AudioDriftCompensator comp(CHANNELS, TARGET_FRAMES);
+
+   // Prime the ring to the target, as AudioOutput does before playing.
+   std::vector<float> silence(CHANNELS * static_cast<std::size_t>(TARGET_FRAMES), 0.0F);
+   ring.write(silence.data(), silence.size());
+
+   std::vector<float> block(CHANNELS * BLOCK_FRAMES);
+   std::vector<float> resampled(CHANNELS * comp.outputBound(BLOCK_FRAMES));
+   std::vector<float> pulled(CHANNELS * PULL_FRAMES);
+
+   double producerClock = 0.0;
+   double consumerClock = 0.0;
+   double phase = 0.0;
+   double lateFillSum = 0.0;
+   std::size_t lateFillCount = 0;
+   while (consumerClock < SECONDS)
+   {
+      // Advance whichever side is due next.
+      const double nextBlock = producerClock + (static_cast<double>(BLOCK_FRAMES) / PRODUCER_RATE);
+      const double nextPull = consumerClock + (static_cast<double>(PULL_FRAMES) / RATE);
+      if (nextBlock <= nextPull)
+      {
+         for (std::size_t i = 0; i < BLOCK_FRAMES; ++i)
+         {
+            const auto v = static_cast<float>(std::sin(phase));
+            block[2 * i] = v;
+            block[2 * i + 1] = -v;
+            phase += 2.0 * std::numbers::pi * 440.0 / RATE;
+         }
+         const std::size_t fill = ring.available() / CHANNELS;
+         const std::size_t n = comp.process(block.data(), BLOCK_FRAMES, fill, resampled.data());
+         ring.write(resampled.data(), n * CHANNELS);
+         producerClock = nextBlock;
+         if (producerClock > SECONDS / 2.0)
+         {
+            lateFillSum += static_cast<double>(fill);
+            ++lateFillCount;
+         }
+      }
+      else
+      {
+         ring.readOrSilence(pulled.data(), pulled.size());
+         consumerClock = nextPull;
+      }
+   }
+
+   EXPECT_EQ(ring.overflowCount(), 0U);
+   EXPECT_EQ(ring.underrunCount(), 0U);
+
+   // The fill a new block finds averages out at the target and the ratio
+   // cancels the drift.
+   const double meanFill = lateFillSum / static_cast<double>(lateFillCount);
+   EXPECT_NEAR(meanFill, TARGET_FRAMES, 0.1 * TARGET_FRAMES);
+   EXPECT_NEAR(comp.getRatio(), 1.0 / 1.0002, 1.0e-4);
+}
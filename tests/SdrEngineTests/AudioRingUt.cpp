@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "AudioRing.h"
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using SdrEngine::AudioRing;
+
+namespace
+{
+
+std::vector<float> makeRamp(std::size_t count, float start = 0.0F)
+{
+   std::vector<float> out(count);
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      out[i] = start + static_cast<float>(i);
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+TEST(AudioRingTest, Constructor_RoundsCapacityToPowerOfTwo)
+{
+   const AudioRing ring(1000);
+   EXPECT_EQ(ring.capacity(), 1024U);
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.freeSpace(), 1024U);
+   EXPECT_EQ(ring.overflowCount(), 0U);
+   EXPECT_EQ(ring.underrunCount(), 0U);
+}
+
+TEST(AudioRingTest, Reset_ClearsContentsAndCounters)
+{
+   AudioRing ring(8);
+   const auto data = makeRamp(12);
+   ring.write(data.data(), data.size());
+   std::vector<float> out(16);
+   ring.readOrSilence(out.data(), out.size());
+   EXPECT_EQ(ring.overflowCount(), 4U);
+   EXPECT_EQ(ring.underrunCount(), 1U);
+
+   ring.reset(16);
+   EXPECT_EQ(ring.capacity(), 16U);
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.overflowCount(), 0U);
+   EXPECT_EQ(ring.underrunCount(), 0U);
+   EXPECT_EQ(ring.underrunSamples(), 0U);
+}
+
+// ============================================================================
+// Write / read
+// ============================================================================
+
+TEST(AudioRingTest, WriteAcrossWrap_ReadPreservesOrder)
+{
+   AudioRing ring(8);
+   const auto head = makeRamp(6);
+   ring.write(head.data(), head.size());
+   std::vector<float> out(8);
+   ASSERT_EQ(ring.read(out.data(), 5), 5U);
+
+   // Write position 6; these seven samples wrap after two.
+   const auto tail = makeRamp(7, 100.0F);
+   ASSERT_EQ(ring.write(tail.data(), tail.size()), 7U);
+   ASSERT_EQ(ring.read(out.data(), 8), 8U);
+   EXPECT_FLOAT_EQ(out[0], 5.0F);
+   for (std::size_t i = 0; i < tail.size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(out[i + 1], tail[i]) << "index " << i;
+   }
+}
+
+TEST(AudioRingTest, PrepareWrite_WrapsAndCommitMakesDataVisible)
+{
+   AudioRing ring(8);
+   const auto head = makeRamp(6);
+   ring.write(head.data(), head.size());
+   std::vector<float> out(8);
+   ring.read(out.data(), 6);
+
+   const auto regions = ring.prepareWrite(5);
+   ASSERT_EQ(regions.first.size(), 2U);
+   ASSERT_EQ(regions.second.size(), 3U);
+   for (std::size_t i = 0; i < regions.size(); ++i)
+   {
+      (i < 2 ? regions.first[i] : regions.second[i - 2]) = 50.0F + static_cast<float>(i);
+   }
+   EXPECT_EQ(ring.available(), 0U);
+
+   ring.commitWrite(5);
+   ASSERT_EQ(ring.read(out.data(), 8), 5U);
+   for (std::size_t i = 0; i < 5; ++i)
+   {
+      EXPECT_FLOAT_EQ(out[i], 50.0F + static_cast<float>(i));
+   }
+}
+
+TEST(AudioRingTest, WriteWhenFull_DropsAndCountsOverflow)
+{
+   AudioRing ring(8);
+   const auto data = makeRamp(11);
+   EXPECT_EQ(ring.write(data.data(), data.size()), 8U);
+   EXPECT_EQ(ring.overflowCount(), 3U);
+   EXPECT_EQ(ring.freeSpace(), 0U);
+
+   std::vector<float> out(8);
+   ASSERT_EQ(ring.read(out.data(), out.size()), 8U);
+   EXPECT_FLOAT_EQ(out.back(), 7.0F);
+}
+
+TEST(AudioRingTest, ReadOrSilence_ZeroFillsAndCountsUnderrun)
+{
+   AudioRing ring(16);
+   const auto data = makeRamp(3, 1.0F);
+   ring.write(data.data(), data.size());
+
+   std::vector<float> out(8, -1.0F);
+   EXPECT_EQ(ring.readOrSilence(out.data(), out.size()), 3U);
+   EXPECT_FLOAT_EQ(out[2], 3.0F);
+   for (std::size_t i = 3; i < out.size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(out[i], 0.0F);
+   }
+   EXPECT_EQ(ring.underrunCount(), 1U);
+   EXPECT_EQ(ring.underrunSamples(), 5U);
+
+   // A full read is not an underrun.
+   ring.write(data.data(), data.size());
+   ring.readOrSilence(out.data(), 3);
+   EXPECT_EQ(ring.underrunCount(), 1U);
+}
+
+TEST(AudioRingTest, Drain_EmptiesButKeepsCounters)
+{
+   AudioRing ring(8);
+   const auto data = makeRamp(10);
+   ring.write(data.data(), data.size());
+   ring.drain();
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.overflowCount(), 2U);
+}
+
+// ============================================================================
+// Concurrency
+// ============================================================================
+
+TEST(AudioRingTest, ProducerConsumer_AllSamplesArriveInOrder)
+{
+   static constexpr std::size_t TOTAL = 1'000'000;
+   static constexpr std::size_t CHUNK = 333;
+   AudioRing ring(4096);
+
+   std::thread producer([&ring]
+   {
+      std::vector<float> chunk(CHUNK);
+      std::size_t next = 0;
+      while (next < TOTAL)
+      {
+         const std::size_t n = std::min(CHUNK, TOTAL - next);
+         for (std::size_t i = 0; i < n; ++i)
+         {
+            chunk[i] = static_cast<float>((next + i) % 65536);
+         }
+         // Never overflow: only write what fits.
+         const std::size_t fit = std::min(n, ring.freeSpace());
+         next += ring.write(chunk.data(), fit);
+         if (fit == 0)
+         {
+            std::this_thread::yield();
+         }
+      }
+   });
+
+   std::vector<float> out(512);
+   std::size_t received = 0;
+   bool inOrder = true;
+   while (received < TOTAL)
+   {
+      const std::size_t n = ring.read(out.data(), out.size());
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         inOrder = inOrder && (out[i] == static_cast<float>((received + i) % 65536));
+      }
+      received += n;
+      if (n == 0)
+      {
+         std::this_thread::yield();
+      }
+   }
+   producer.join();
+
+   EXPECT_TRUE(inOrder);
+   EXPECT_EQ(ring.overflowCount(), 0U);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "BuiltinFft.h"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+using SdrEngine::BuiltinFft;
+
+namespace
+{
+
+// Reference DFT in double precision, interleaved in and out.
+std::vector<double> naiveDft(const std::vector<float>& in)
+{
+   const std::size_t n = in.size() / 2;
+   std::vector<double> out(in.size(), 0.0);
+   for (std::size_t k = 0; k < n; ++k)
+   {
+      std::complex<double> sum{0.0, 0.0};
+      for (std::size_t j = 0; j < n; ++j)
+      {
+         const double angle = -2.0 * std::numbers::pi * static_cast<double>((j * k) % n) /
+                              static_cast<double>(n);
+         sum += std::complex<double>{in[2 * j], in[(2 * j) + 1]} *
+                std::polar(1.0, angle);
+      }
+      out[2 * k]       = sum.real();
+      out[(2 * k) + 1] = sum.imag();
+   }
+   return out;
+}
+
+// Deterministic pseudo-random samples in [-1, 1).
+std::vector<float> noise(std::size_t n)
+{
+   std::vector<float> v(2 * n);
+   uint32_t state = 12345;
+   for (float& x : v)
+   {
+      state = (state * 1664525U) + 1013904223U;
+      x     = (static_cast<float>(state >> 8) / 8388608.0F) - 1.0F;
+   }
+   return v;
+}
+
+} // anonymous namespace
+
+TEST(BuiltinFftTest, Supports_PowersOfTwoOnly)
+{
+   EXPECT_TRUE(BuiltinFft::supports(1));
+   EXPECT_TRUE(BuiltinFft::supports(2));
+   EXPECT_TRUE(BuiltinFft::supports(4096));
+   EXPECT_FALSE(BuiltinFft::supports(0));
+   EXPECT_FALSE(BuiltinFft::supports(3));
+   EXPECT_FALSE(BuiltinFft::supports(1000));
+}
+
+TEST(BuiltinFftTest, Forward_MatchesNaiveDft)
+{
+   for (const std::size_t n : {1U, 2U, 4U, 8U, 16U, 64U, 512U})
+   {
+      const BuiltinFft fft{n};
+      ASSERT_EQ(fft.size(), n);
+      const std::vector<float> in = noise(n);
+      std::vector<float> out(2 * n);
+      fft.forward(in.data(), out.data());
+
+      const std::vector<double> expected = naiveDft(in);
+      const double tolerance = 1e-5 * static_cast<double>(n);
+      for (std::size_t i = 0; i < out.size(); ++i)
+      {
+         ASSERT_NEAR(out[i], expected[i], tolerance) << "n=" << n << " i=" << i;
+      }
+   }
+}
+
+TEST(BuiltinFftTest, Forward_ToneLandsInItsBin)
+{
+   constexpr std::size_t N   = 4096;
+   constexpr std::size_t BIN = 300;
+   std::vector<float> in(2 * N);
+   for (std::size_t j = 0; j < N; ++j)
+   {
+      const double angle = 2.0 * std::numbers::pi * static_cast<double>(BIN * j) /
+                           static_cast<double>(N);
+      in[2 * j]       = static_cast<float>(std::cos(angle));
+      in[(2 * j) + 1] = static_cast<float>(std::sin(angle));
+   }
+
+   const BuiltinFft fft{N};
+   std::vector<float> out(2 * N);
+   fft.forward(in.data(), out.data());
+   for (std::size_t k = 0; k < N; ++k)
+   {
+      const float magnitude = std::hypot(out[2 * k], out[(2 * k) + 1]);
+      if (k == BIN)
+      {
+         EXPECT_NEAR(magnitude, static_cast<float>(N), 0.05F);
+      }
+      else
+      {
+         ASSERT_LT(magnitude, 0.05F) << "k=" << k;
+      }
+   }
+}
+
+TEST(BuiltinFftTest, Forward_ImpulseIsFlat)
+{
+   constexpr std::size_t N = 256;
+   std::vector<float> in(2 * N, 0.0F);
+   in[0] = 1.0F;
+
+   const BuiltinFft fft{N};
+   std::vector<float> out(2 * N);
+   fft.forward(in.data(), out.data());
+   for (std::size_t k = 0; k < N; ++k)
+   {
+      EXPECT_FLOAT_EQ(out[2 * k], 1.0F);
+      EXPECT_FLOAT_EQ(out[(2 * k) + 1], 0.0F);
+   }
+}
@@ -1,9 +1,14 @@
 #include <gtest/gtest.h>
 #include "ChannelFilter.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <complex>
+#include <memory_resource>
 #include <numbers>
+#include <span>
+#include <thread>
 #include <vector>
 
 using SdrEngine::ChannelFilter;
@@ -153,6 +158,82 @@ TEST(ChannelFilterTest, Process_OutputSamplesAreFinite)
    }
 }
 
+TEST(ChannelFilterTest, ProcessIntoBuffer_OutputLengthIsInputOverDecimation)
+{
+   ChannelFilter filter;
+   // 200 kHz channel from 2.4 MHz → 12x decimation
+   filter.configure(0.0, 200'000.0, 2'400'000.0);
+   filter.setEnabled(true);
+
+   std::vector<IqSample> output;
+   filter.process(std::vector<IqSample>(4100, {0.5F, -0.3F}), output);
+   EXPECT_EQ(output.size(), 341U);   // 4092 consumed, 8 carried over.
+
+   filter.process(std::vector<IqSample>(4, {0.5F, -0.3F}), output);
+   EXPECT_EQ(output.size(), 1U);
+}
+
+TEST(ChannelFilterTest, ProcessIntoBuffer_ChunkedInput_MatchesSingleBlock)
+{
+   const std::size_t n = 5000;
+   std::vector<IqSample> input(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const float phase =
+         2.0F * std::numbers::pi_v<float> * 0.013F * static_cast<float>(i);
+      input[i] = {std::cos(phase), std::sin(phase)};
+   }
+
+   ChannelFilter whole;
+   whole.configure(50'000.0, 200'000.0, 2'400'000.0);
+   whole.setEnabled(true);
+   std::vector<IqSample> expected;
+   whole.process(input, expected);
+
+   ChannelFilter chunked;
+   chunked.configure(50'000.0, 200'000.0, 2'400'000.0);
+   chunked.setEnabled(true);
+   std::vector<IqSample> actual;
+   std::vector<IqSample> part;
+   const std::span<const IqSample> all(input);
+   for (std::size_t pos = 0; pos < n; pos += 333)
+   {
+      chunked.process(all.subspan(pos, std::min<std::size_t>(333, n - pos)), part);
+      actual.insert(actual.end(), part.begin(), part.end());
+   }
+
+   ASSERT_EQ(actual.size(), expected.size());
+   for (std::size_t i = 0; i < expected.size(); ++i)
+   {
+      EXPECT_NEAR(actual[i].real(), expected[i].real(), 1.0e-4F);
+      EXPECT_NEAR(actual[i].imag(), expected[i].imag(), 1.0e-4F);
+   }
+}
+
+TEST(ChannelFilterTest, ProcessIntoPmrBuffer_MatchesStdVector)
+{
+   const std::vector<IqSample> input(4100, {0.5F, -0.3F});
+
+   ChannelFilter reference;
+   reference.configure(50'000.0, 200'000.0, 2'400'000.0);
+   reference.setEnabled(true);
+   std::vector<IqSample> expected;
+   reference.process(input, expected);
+
+   ChannelFilter filter;
+   filter.configure(50'000.0, 200'000.0, 2'400'000.0);
+   filter.setEnabled(true);
+   std::pmr::monotonic_buffer_resource arena;
+   std::pmr::vector<IqSample> output(&arena);
+   filter.process(input, output);
+
+   ASSERT_EQ(output.size(), expected.size());
+   for (std::size_t i = 0; i < expected.size(); ++i)
+   {
+      EXPECT_EQ(output[i], expected[i]);
+   }
+}
+
 // ============================================================================
 // Processing — DC signal at centre passes through
 // ============================================================================
@@ -219,3 +300,37 @@ TEST(ChannelFilterTest, Reconfigure_ChangesOutputRate)
    // Wider channel → higher output rate (less decimation).
    EXPECT_GT(rate2, rate1);
 }
+
+TEST(ChannelFilterTest, Reconfigure_WhileProcessing_OutputStaysFinite)
+{
+   ChannelFilter filter;
+   filter.configure(0.0, 200'000.0, 2'400'000.0);
+   filter.setEnabled(true);
+
+   std::atomic<bool> done{false};
+   std::atomic<int> badSamples{0};
+   std::thread processing([&]()
+   {
+      const std::vector<IqSample> input(4096, {0.5F, 0.25F});
+      std::vector<IqSample> output;
+      while (!done.load())
+      {
+         filter.process(input, output);
+         badSamples += static_cast<int>(std::count_if(
+            output.begin(), output.end(),
+            [](const IqSample& s) { return !std::isfinite(s.real()) || !std::isfinite(s.imag()); }));
+      }
+   });
+
+   for (int i = 0; i < 200; ++i)
+   {
+      filter.configure((i % 2 == 0) ? 50'000.0 : -50'000.0,
+                       (i % 3 == 0) ? 400'000.0 : 200'000.0, 2'400'000.0);
+      filter.reset();
+   }
+   done = true;
+   processing.join();
+
+   EXPECT_EQ(badSamples.load(), 0);
+   EXPECT_TRUE(filter.isConfigured());
+}
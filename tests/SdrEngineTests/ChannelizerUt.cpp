@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "Channelizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <vector>
+
+using SdrEngine::Channelizer;
+using SdrEngine::IqSample;
+
+namespace
+{
+
+constexpr double SAMPLE_RATE = 1.0e6;
+
+std::vector<IqSample> makeTone(std::size_t count, double freqHz, double rateHz)
+{
+   std::vector<IqSample> out(count);
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      const double phase = 2.0 * std::numbers::pi * freqHz * static_cast<double>(i) / rateHz;
+      out[i] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+   }
+   return out;
+}
+
+// Mean magnitude of the settled tail (skips the filter's start-up transient).
+double tailMagnitude(const std::vector<IqSample>& samples, std::size_t skip)
+{
+   double sum = 0.0;
+   for (std::size_t i = skip; i < samples.size(); ++i)
+   {
+      sum += static_cast<double>(std::abs(samples[i]));
+   }
+   return sum / static_cast<double>(samples.size() - skip);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+TEST(ChannelizerTest, DefaultConstruction_NotConfiguredNotEnabled)
+{
+   const Channelizer channelizer;
+   EXPECT_FALSE(channelizer.isConfigured());
+   EXPECT_FALSE(channelizer.isEnabled());
+   EXPECT_EQ(channelizer.getChannelCount(), 0U);
+   EXPECT_DOUBLE_EQ(channelizer.getOutputSampleRate(), 0.0);
+}
+
+TEST(ChannelizerTest, Configure_InvalidParameters_StaysUnconfigured)
+{
+   Channelizer channelizer;
+   channelizer.configure(1, SAMPLE_RATE);
+   EXPECT_FALSE(channelizer.isConfigured());
+   channelizer.configure(8, 0.0);
+   EXPECT_FALSE(channelizer.isConfigured());
+   channelizer.configure(8, SAMPLE_RATE, 0);
+   EXPECT_FALSE(channelizer.isConfigured());
+}
+
+TEST(ChannelizerTest, Configure_ReportsRateAndChannelOffsets)
+{
+   Channelizer channelizer;
+   channelizer.configure(8, SAMPLE_RATE);
+   ASSERT_TRUE(channelizer.isConfigured());
+   EXPECT_EQ(channelizer.getChannelCount(), 8U);
+   EXPECT_DOUBLE_EQ(channelizer.getOutputSampleRate(), 125.0e3);
+   EXPECT_DOUBLE_EQ(channelizer.getChannelOffset(0), -500.0e3);
+   EXPECT_DOUBLE_EQ(channelizer.getChannelOffset(4), 0.0);
+   EXPECT_DOUBLE_EQ(channelizer.getChannelOffset(5), 125.0e3);
+   EXPECT_DOUBLE_EQ(channelizer.getChannelOffset(7), 375.0e3);
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+TEST(ChannelizerTest, Process_Disabled_ClearsChannels)
+{
+   Channelizer channelizer;
+   channelizer.configure(4, SAMPLE_RATE);
+   std::vector<std::vector<IqSample>> channels(4, std::vector<IqSample>(3));
+   channelizer.process(makeTone(64, 0.0, SAMPLE_RATE), channels);
+   for (const auto& channel : channels)
+   {
+      EXPECT_TRUE(channel.empty());
+   }
+}
+
+TEST(ChannelizerTest, Process_OutputsOneSamplePerChannelPerMInputs)
+{
+   Channelizer channelizer;
+   channelizer.configure(8, SAMPLE_RATE);
+   channelizer.setEnabled(true);
+
+   std::vector<std::vector<IqSample>> channels;
+   channelizer.process(makeTone(100, 0.0, SAMPLE_RATE), channels);
+   ASSERT_EQ(channels.size(), 8U);
+   EXPECT_EQ(channels[0].size(), 12U);   // 96 consumed, 4 carried over.
+
+   channelizer.process(makeTone(4, 0.0, SAMPLE_RATE), channels);
+   EXPECT_EQ(channels[0].size(), 1U);
+}
+
+TEST(ChannelizerTest, Process_ToneAtChannelCentre_AppearsOnlyInThatChannel)
+{
+   constexpr std::size_t M = 8;
+   Channelizer channelizer;
+   channelizer.configure(M, SAMPLE_RATE);
+   channelizer.setEnabled(true);
+
+   // Channel 6 is centred at +250 kHz.
+   std::vector<std::vector<IqSample>> channels;
+   channelizer.process(makeTone(M * 400, 250.0e3, SAMPLE_RATE), channels);
+
+   const std::size_t skip = Channelizer::DEFAULT_TAPS_PER_CHANNEL * 2;
+   EXPECT_NEAR(tailMagnitude(channels[6], skip), 1.0, 0.01);
+   for (std::size_t c = 0; c < M; ++c)
+   {
+      if (c != 6)
+      {
+         EXPECT_LT(tailMagnitude(channels[c], skip), 1.0e-2) << "channel " << c;
+      }
+   }
+}
+
+TEST(ChannelizerTest, Process_ChunkedInput_MatchesSingleBlock)
+{
+   constexpr std::size_t M = 16;
+   const auto input = makeTone(M * 64 + 5, 90.0e3, SAMPLE_RATE);
+
+   Channelizer whole;
+   whole.configure(M, SAMPLE_RATE);
+   whole.setEnabled(true);
+   std::vector<std::vector<IqSample>> expected;
+   whole.process(input, expected);
+
+   Channelizer chunked;
+   chunked.configure(M, SAMPLE_RATE);
+   chunked.setEnabled(true);
+   std::vector<std::vector<IqSample>> actual(M);
+   std::vector<std::vector<IqSample>> part;
+   const std::span<const IqSample> all(input);
+   for (std::size_t pos = 0; pos < input.size(); pos += 37)
+   {
+      chunked.process(all.subspan(pos, std::min<std::size_t>(37, input.size() - pos)), part);
+      for (std::size_t c = 0; c < M; ++c)
+      {
+         actual[c].insert(actual[c].end(), part[c].begin(), part[c].end());
+      }
+   }
+
+   for (std::size_t c = 0; c < M; ++c)
+   {
+      ASSERT_EQ(actual[c].size(), expected[c].size());
+      for (std::size_t i = 0; i < expected[c].size(); ++i)
+      {
+         EXPECT_NEAR(actual[c][i].real(), expected[c][i].real(), 1.0e-5F);
+         EXPECT_NEAR(actual[c][i].imag(), expected[c][i].imag(), 1.0e-5F);
+      }
+   }
+}
+
+TEST(ChannelizerTest, Reset_ClearsHistory)
+{
+   Channelizer channelizer;
+   channelizer.configure(4, SAMPLE_RATE);
+   channelizer.setEnabled(true);
+
+   std::vector<std::vector<IqSample>> first;
+   channelizer.process(makeTone(64, 0.0, SAMPLE_RATE), first);
+   channelizer.reset();
+   std::vector<std::vector<IqSample>> second;
+   channelizer.process(makeTone(64, 0.0, SAMPLE_RATE), second);
+
+   ASSERT_EQ(first[2].size(), second[2].size());
+   for (std::size_t i = 0; i < first[2].size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(first[2][i].real(), second[2][i].real());
+   }
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "DemodExecutor.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using SdrEngine::DemodAudio;
+using SdrEngine::DemodExecutor;
+using SdrEngine::DemodMode;
+using SdrEngine::IqBuffer;
+using SdrEngine::IqSample;
+
+namespace
+{
+
+// Input rate equal to the audio rate: no resampler, so FM mono yields one
+// audio frame per I/Q sample and a block's size identifies it.
+constexpr double RATE = 48'000.0;
+
+std::shared_ptr<const IqBuffer> makeBlock(std::size_t samples)
+{
+   auto block = std::make_shared<IqBuffer>();
+   block->samples.assign(samples, IqSample{1.0F, 0.0F});
+   block->sampleRateHz = RATE;
+   return block;
+}
+
+/// Wait until `done()` holds, for at most five seconds.
+template <typename Predicate>
+bool waitFor(Predicate done)
+{
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (std::chrono::steady_clock::now() < deadline)
+   {
+      if (done())
+      {
+         return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   return done();
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Channels
+// ============================================================================
+
+TEST(DemodExecutorTest, Construct_StartsRequestedWorkers)
+{
+   const DemodExecutor executor(3);
+   EXPECT_EQ(executor.workerCount(), 3U);
+   EXPECT_EQ(executor.getChannelCount(), 0U);
+   EXPECT_GE(DemodExecutor::defaultWorkerCount(), 1U);
+}
+
+TEST(DemodExecutorTest, AddAndRemoveChannel_TracksCount)
+{
+   DemodExecutor executor(2);
+   const int a = executor.addChannel(DemodMode::FmMono, RATE, RATE);
+   const int b = executor.addChannel(DemodMode::AM, RATE, RATE);
+   EXPECT_NE(a, b);
+   EXPECT_EQ(executor.getChannelCount(), 2U);
+   ASSERT_NE(executor.channel(b), nullptr);
+   EXPECT_EQ(executor.channel(b)->getMode(), DemodMode::AM);
+
+   EXPECT_TRUE(executor.removeChannel(a));
+   EXPECT_FALSE(executor.removeChannel(a));
+   EXPECT_EQ(executor.channel(a), nullptr);
+   EXPECT_EQ(executor.getChannelCount(), 1U);
+}
+
+TEST(DemodExecutorTest, Submit_UnknownChannel_ReturnsFalse)
+{
+   DemodExecutor executor(1);
+   EXPECT_FALSE(executor.submit(42, makeBlock(16)));
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+TEST(DemodExecutorTest, Submit_PublishesAudioInOrder)
+{
+   DemodExecutor executor(4);
+   const int id = executor.addChannel(DemodMode::FmMono, RATE, RATE);
+   auto channel = executor.channel(id);
+
+   std::mutex mutex;
+   std::vector<std::size_t> sizes;
+   channel->audioDataHandler().registerListener(
+      [&](const std::shared_ptr<const DemodAudio>& audio)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         sizes.push_back(audio->left.size());
+      });
+
+   constexpr std::size_t BLOCKS = 20;
+   for (std::size_t i = 0; i < BLOCKS; ++i)
+   {
+      ASSERT_TRUE(executor.submit(id, makeBlock(100 + i)));
+   }
+
+   ASSERT_TRUE(waitFor([&] {
+      const std::lock_guard<std::mutex> lock(mutex);
+      return sizes.size() == BLOCKS;
+   }));
+   const std::lock_guard<std::mutex> lock(mutex);
+   for (std::size_t i = 0; i < BLOCKS; ++i)
+   {
+      EXPECT_EQ(sizes[i], 100 + i) << "block " << i;
+   }
+}
+
+TEST(DemodExecutorTest, Submit_AudioCarriesBlockSourceTime)
+{
+   DemodExecutor executor(1);
+   const int id = executor.addChannel(DemodMode::FmMono, RATE, RATE);
+
+   std::mutex mutex;
+   std::vector<std::chrono::steady_clock::time_point> times;
+   executor.channel(id)->audioDataHandler().registerListener(
+      [&](const std::shared_ptr<const DemodAudio>& audio)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         times.push_back(audio->sourceTime);
+      });
+
+   // Untraced block: the ring dequeue timestamp.  Traced: the device read.
+   const auto dequeued = std::chrono::steady_clock::now();
+   auto untraced = std::make_shared<IqBuffer>(*makeBlock(64));
+   untraced->timestamp = dequeued;
+   auto traced = std::make_shared<IqBuffer>(*makeBlock(64));
+   traced->timestamp = dequeued;
+   traced->stages.deviceRead = dequeued - std::chrono::milliseconds(3);
+   ASSERT_TRUE(executor.submit(id, untraced));
+   ASSERT_TRUE(executor.submit(id, traced));
+
+   ASSERT_TRUE(waitFor([&] {
+      const std::lock_guard<std::mutex> lock(mutex);
+      return times.size() == 2;
+   }));
+   const std::lock_guard<std::mutex> lock(mutex);
+   EXPECT_EQ(times[0], dequeued);
+   EXPECT_EQ(times[1], dequeued - std::chrono::milliseconds(3));
+}
+
+TEST(DemodExecutorTest, ManyChannels_EachKeepsItsOrder)
+{
+   DemodExecutor executor(4);
+   constexpr std::size_t CHANNELS = 12;
+   constexpr std::size_t BLOCKS = 30;
+
+   std::mutex mutex;
+   std::vector<std::vector<std::size_t>> sizes(CHANNELS);
+   std::vector<int> ids;
+   for (std::size_t c = 0; c < CHANNELS; ++c)
+   {
+      ids.push_back(executor.addChannel(DemodMode::FmMono, RATE, RATE, BLOCKS));
+      executor.channel(ids.back())->audioDataHandler().registerListener(
+         [&, c](const std::shared_ptr<const DemodAudio>& audio)
+         {
+            const std::lock_guard<std::mutex> lock(mutex);
+            sizes[c].push_back(audio->left.size());
+         });
+   }
+
+   // Interleave submissions across channels, as concurrent listeners would.
+   for (std::size_t i = 0; i < BLOCKS; ++i)
+   {
+      for (std::size_t c = 0; c < CHANNELS; ++c)
+      {
+         ASSERT_TRUE(executor.submit(ids[c], makeBlock(200 + i)));
+      }
+   }
+
+   ASSERT_TRUE(waitFor([&] {
+      const std::lock_guard<std::mutex> lock(mutex);
+      for (const auto& s : sizes)
+      {
+         if (s.size() != BLOCKS)
+         {
+            return false;
+         }
+      }
+      return true;
+   }));
+   const std::lock_guard<std::mutex> lock(mutex);
+   for (std::size_t c = 0; c < CHANNELS; ++c)
+   {
+      for (std::size_t i = 0; i < BLOCKS; ++i)
+      {
+         ASSERT_EQ(sizes[c][i], 200 + i) << "channel " << c << " block " << i;
+      }
+   }
+}
+
+TEST(DemodExecutorTest, FullQueue_DropsOldestAndAccountsEveryBlock)
+{
+   DemodExecutor executor(1);
+   const int id = executor.addChannel(DemodMode::FmMono, RATE, RATE, 2);
+   auto channel = executor.channel(id);
+
+   constexpr std::size_t BLOCKS = 200;
+   for (std::size_t i = 0; i < BLOCKS; ++i)
+   {
+      ASSERT_TRUE(executor.submit(id, makeBlock(4096)));
+   }
+
+   ASSERT_TRUE(waitFor([&] {
+      const auto stats = channel->getStats();
+      return stats.processed + stats.dropped == BLOCKS && stats.queueDepth == 0;
+   }));
+   const auto stats = channel->getStats();
+   EXPECT_EQ(stats.submitted, BLOCKS);
+   EXPECT_GT(stats.processed, 0U);
+}
+
+TEST(DemodExecutorTest, RemoveChannel_WhileBusy_IsSafe)
+{
+   DemodExecutor executor(2);
+   const int id = executor.addChannel(DemodMode::FmStereo, 200'000.0, RATE);
+   for (int i = 0; i < 8; ++i)
+   {
+      executor.submit(id, makeBlock(8192));
+   }
+   EXPECT_TRUE(executor.removeChannel(id));
+   EXPECT_FALSE(executor.submit(id, makeBlock(16)));
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include "Demodulator.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
+#include <memory_resource>
 #include <numbers>
 #include <vector>
 
@@ -42,6 +44,32 @@ std::vector<IqSample> generateFmSignal(size_t numSamples, double sampleRate,
    return signal;
 }
 
+/// Generate an FM stereo broadcast: a tone on the left channel only, a
+/// 10 % pilot, and the composite at full 75 kHz deviation.
+std::vector<IqSample> generateFmStereoSignal(size_t numSamples, double sampleRate,
+                                             double leftToneHz)
+{
+   constexpr double PILOT_HZ = 19'000.0;
+   constexpr double DEVIATION = 75'000.0;
+   std::vector<IqSample> signal(numSamples);
+   double phase = 0.0;
+   const double dt = 1.0 / sampleRate;
+
+   for (size_t i = 0; i < numSamples; ++i)
+   {
+      const double t = static_cast<double>(i) * dt;
+      const double left = std::sin(2.0 * std::numbers::pi * leftToneHz * t);
+      const double pilot = 2.0 * std::numbers::pi * PILOT_HZ * t;
+      const double mpx = (0.45 * left) + (0.45 * left * std::sin(2.0 * pilot)) +
+                         (0.1 * std::sin(pilot));
+
+      phase += 2.0 * std::numbers::pi * DEVIATION * mpx * dt;
+      signal[i] = {static_cast<float>(std::cos(phase)),
+                    static_cast<float>(std::sin(phase))};
+   }
+   return signal;
+}
+
 /// Generate a block of AM-modulated complex samples.
 /// carrier = (1 + m·cos(2π·modFreq·t)) · exp(j·0), i.e. carrier at DC.
 std::vector<IqSample> generateAmSignal(size_t numSamples, double sampleRate,
@@ -391,6 +419,24 @@ TEST(DemodulatorTest, FmStereo_OutputSamplesAreFinite)
    }
 }
 
+TEST(DemodulatorTest, FmStereo_LeftOnlyTone_RightIsQuiet)
+{
+   Demodulator demod;
+   demod.configure(DemodMode::FmStereo, INPUT_RATE, AUDIO_RATE);
+
+   auto signal = generateFmStereoSignal(200'000, INPUT_RATE, 1'000.0);
+   auto result = demod.demodulate(signal);
+   ASSERT_FALSE(result.left.empty());
+
+   // Second half only: the pilot PLL has locked by then.
+   const auto half = static_cast<ptrdiff_t>(result.left.size() / 2);
+   const std::vector<float> left(result.left.begin() + half, result.left.end());
+   const std::vector<float> right(result.right.begin() + half, result.right.end());
+   EXPECT_GT(rms(left), 0.1F);
+   EXPECT_LT(rms(right), rms(left) * 0.1F)
+      << "Less than 20 dB of stereo separation";
+}
+
 // ============================================================================
 // AM — signal processing
 // ============================================================================
@@ -472,6 +518,99 @@ TEST(DemodulatorTest, Am_ModulatedSignal_HasEnergy)
       << "AM modulated signal should produce non-trivial audio energy";
 }
 
+// ============================================================================
+// demodulateInto — preallocated block processing
+// ============================================================================
+
+TEST(DemodulatorTest, DemodulateInto_Interleaved_MatchesDemodulate)
+{
+   for (auto mode : {DemodMode::FmMono, DemodMode::FmStereo, DemodMode::AM})
+   {
+      Demodulator reference;
+      Demodulator demod;
+      reference.configure(mode, INPUT_RATE, AUDIO_RATE);
+      demod.configure(mode, INPUT_RATE, AUDIO_RATE, 4096);
+
+      auto signal = generateFmSignal(4096, INPUT_RATE, 50'000.0, 1'000.0);
+      auto expected = reference.demodulate(signal);
+
+      std::vector<float> interleaved(2 * demod.maxOutputFrames(signal.size()));
+      const size_t frames = demod.demodulateInto(signal, interleaved);
+
+      ASSERT_EQ(frames, expected.left.size()) << SdrEngine::demodModeName(mode);
+      for (size_t i = 0; i < frames; ++i)
+      {
+         EXPECT_FLOAT_EQ(interleaved[2 * i], expected.left[i]);
+         EXPECT_FLOAT_EQ(interleaved[(2 * i) + 1], expected.right[i]);
+      }
+   }
+}
+
+TEST(DemodulatorTest, DemodulateInto_OutputTooSmall_WritesNothing)
+{
+   Demodulator demod;
+   demod.configure(DemodMode::FmMono, INPUT_RATE, AUDIO_RATE);
+
+   auto signal = generateFmSignal(4096, INPUT_RATE, 25'000.0, 1'000.0);
+   std::vector<float> interleaved(16);
+   EXPECT_EQ(demod.demodulateInto(signal, interleaved), 0U);
+}
+
+TEST(DemodulatorTest, DemodulateInto_DemodAudio_ReusesCapacity)
+{
+   Demodulator demod;
+   demod.configure(DemodMode::FmStereo, INPUT_RATE, AUDIO_RATE, 4096);
+
+   auto signal = generateFmSignal(4096, INPUT_RATE, 50'000.0, 1'000.0);
+   SdrEngine::DemodAudio audio;
+   audio.left.reserve(demod.maxOutputFrames(signal.size()));
+   audio.right.reserve(demod.maxOutputFrames(signal.size()));
+   ASSERT_GT(demod.demodulateInto(signal, audio), 0U);
+   const float* left = audio.left.data();
+   const float* right = audio.right.data();
+
+   for (int block = 0; block < 5; ++block)
+   {
+      const size_t frames = demod.demodulateInto(signal, audio);
+      EXPECT_EQ(frames, audio.left.size());
+      EXPECT_EQ(audio.left.size(), audio.right.size());
+      EXPECT_EQ(audio.left.data(), left);
+      EXPECT_EQ(audio.right.data(), right);
+   }
+}
+
+TEST(DemodulatorTest, DemodulateInto_PmrChannels_MatchesDemodulate)
+{
+   Demodulator reference;
+   Demodulator demod;
+   reference.configure(DemodMode::FmStereo, INPUT_RATE, AUDIO_RATE);
+   demod.configure(DemodMode::FmStereo, INPUT_RATE, AUDIO_RATE);
+
+   auto signal = generateFmSignal(4096, INPUT_RATE, 50'000.0, 1'000.0);
+   auto expected = reference.demodulate(signal);
+
+   std::pmr::monotonic_buffer_resource arena;
+   std::pmr::vector<float> left(&arena);
+   std::pmr::vector<float> right(&arena);
+   const size_t frames = demod.demodulateInto(signal, left, right);
+
+   ASSERT_EQ(frames, expected.left.size());
+   EXPECT_TRUE(std::equal(left.begin(), left.end(), expected.left.begin()));
+   EXPECT_TRUE(std::equal(right.begin(), right.end(), expected.right.begin()));
+}
+
+TEST(DemodulatorTest, MaxOutputFrames_BoundsResampledBlock)
+{
+   Demodulator demod;
+   demod.configure(DemodMode::AM, INPUT_RATE, AUDIO_RATE);
+
+   auto signal = generateAmSignal(8192, INPUT_RATE, 1'000.0);
+   const auto result = demod.demodulate(signal);
+   EXPECT_LE(result.left.size(), demod.maxOutputFrames(signal.size()));
+   EXPECT_GE(demod.maxOutputFrames(signal.size()),
+             static_cast<size_t>(static_cast<double>(signal.size()) * AUDIO_RATE / INPUT_RATE));
+}
+
 // ============================================================================
 // Reset
 // ============================================================================
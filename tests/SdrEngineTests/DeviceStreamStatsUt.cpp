@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "DeviceStreamStats.h"
+
+#include <chrono>
+#include <thread>
+
+using SdrEngine::DeviceStreamCounters;
+using SdrEngine::DeviceStreamStats;
+
+TEST(DeviceStreamStatsTest, Empty_DerivedValuesAreZero)
+{
+   const DeviceStreamStats stats;
+   EXPECT_DOUBLE_EQ(stats.averageReadSize(), 0.0);
+   EXPECT_DOUBLE_EQ(stats.achievedSampleRateHz(), 0.0);
+}
+
+TEST(DeviceStreamStatsTest, DerivedValues_FromCounts)
+{
+   DeviceStreamStats stats;
+   stats.samplesReceived = 3000;
+   stats.reads           = 4;
+   stats.elapsedSec      = 0.5;
+   EXPECT_DOUBLE_EQ(stats.averageReadSize(), 750.0);
+   EXPECT_DOUBLE_EQ(stats.achievedSampleRateHz(), 6000.0);
+}
+
+TEST(DeviceStreamCountersTest, Record_AccumulatesEveryOutcome)
+{
+   DeviceStreamCounters counters;
+   counters.start();
+   std::this_thread::sleep_for(std::chrono::milliseconds(2));
+   counters.recordRead(1024, 1024);
+   counters.recordRead(512, 1024);
+   counters.recordOverflow();
+   counters.recordTimeout();
+   counters.recordTimeout();
+   counters.recordError();
+
+   const auto stats = counters.snapshot();
+   EXPECT_EQ(stats.samplesReceived, 1536U);
+   EXPECT_EQ(stats.reads, 2U);
+   EXPECT_EQ(stats.shortReads, 1U);
+   EXPECT_EQ(stats.overflows, 1U);
+   EXPECT_EQ(stats.timeouts, 2U);
+   EXPECT_EQ(stats.errors, 1U);
+   EXPECT_GT(stats.elapsedSec, 0.0);
+   EXPECT_GT(stats.achievedSampleRateHz(), 0.0);
+}
+
+TEST(DeviceStreamCountersTest, Start_ResetsCounters)
+{
+   DeviceStreamCounters counters;
+   counters.start();
+   counters.recordRead(10, 10);
+   counters.recordOverflow();
+   counters.start();
+
+   const auto stats = counters.snapshot();
+   EXPECT_EQ(stats.samplesReceived, 0U);
+   EXPECT_EQ(stats.overflows, 0U);
+   EXPECT_DOUBLE_EQ(stats.elapsedSec, 0.0);
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include "DisplayIqTap.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using SdrEngine::DisplayIqTap;
+using SdrEngine::DisplayTapConfig;
+using SdrEngine::DisplayTapMode;
+using SdrEngine::FramePool;
+using SdrEngine::IqBuffer;
+using SdrEngine::IqSample;
+
+namespace
+{
+
+constexpr double RATE_HZ   = 1.0e6;
+constexpr double CENTER_HZ = 100.0e6;
+
+// A frame whose samples hold their stream index in the real part.
+IqBuffer makeFrame(std::size_t first, std::size_t count, double rateHz = RATE_HZ)
+{
+   IqBuffer frame;
+   frame.sampleRateHz = rateHz;
+   frame.centerFreqHz = CENTER_HZ;
+   frame.samples.resize(count);
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      frame.samples[i] = IqSample{static_cast<float>(first + i), 0.0F};
+   }
+   return frame;
+}
+
+// Feed `total` samples in frames of `frameSize`; returns every output frame.
+std::vector<std::shared_ptr<IqBuffer>> feed(DisplayIqTap& tap, FramePool<IqBuffer>& pool,
+                                            std::size_t total, std::size_t frameSize,
+                                            double rateHz = RATE_HZ)
+{
+   std::vector<std::shared_ptr<IqBuffer>> out;
+   for (std::size_t first = 0; first < total; first += frameSize)
+   {
+      if (auto frame = tap.process(makeFrame(first, frameSize, rateHz), pool))
+      {
+         out.push_back(std::move(frame));
+      }
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+TEST(DisplayIqTapTest, Decimate_KeepsEveryNthSampleAcrossFrames)
+{
+   DisplayIqTap tap;
+   DisplayTapConfig config;
+   config.samplesPerSec = 100'000.0;   // Step 10.
+   config.framesPerSec  = 10.0;        // 10000 samples per frame.
+   tap.setConfig(config);
+   FramePool<IqBuffer> pool{64};
+
+   // An odd input frame size, so the kept phase has to carry over.  Output
+   // frames end on input boundaries, so each runs a little over 10000.
+   const auto out = feed(tap, pool, 1'000'000, 2047);
+   ASSERT_EQ(out.size(), 9U);
+   float expected = 0.0F;
+   for (const auto& frame : out)
+   {
+      EXPECT_DOUBLE_EQ(frame->sampleRateHz, 100'000.0);
+      EXPECT_DOUBLE_EQ(frame->centerFreqHz, CENTER_HZ);
+      EXPECT_GE(frame->samples.size(), 10'000U);
+      for (const IqSample& s : frame->samples)
+      {
+         ASSERT_FLOAT_EQ(s.real(), expected);
+         expected += 10.0F;
+      }
+   }
+}
+
+TEST(DisplayIqTapTest, Decimate_OutputDoesNotScaleWithInputRate)
+{
+   DisplayTapConfig config;
+   config.samplesPerSec = 50'000.0;
+   config.framesPerSec  = 20.0;
+
+   // One second of stream at two rates yields the same budget.
+   for (const double rate : {1.0e6, 20.0e6})
+   {
+      DisplayIqTap tap;
+      tap.setConfig(config);
+      FramePool<IqBuffer> pool{64};
+      const auto out = feed(tap, pool, static_cast<std::size_t>(rate), 4096, rate);
+      std::size_t samples = 0;
+      for (const auto& frame : out)
+      {
+         samples += frame->samples.size();
+      }
+      EXPECT_LE(out.size(), 20U) << rate;
+      EXPECT_NEAR(static_cast<double>(samples), 50'000.0, 2'500.0) << rate;
+   }
+}
+
+TEST(DisplayIqTapTest, BudgetDivisor_FewerFramesOfTheSameSize)
+{
+   DisplayTapConfig config;
+   config.samplesPerSec = 50'000.0;
+   config.framesPerSec  = 20.0;
+   DisplayIqTap tap;
+   tap.setConfig(config);
+   tap.setBudgetDivisor(4);
+   FramePool<IqBuffer> pool{64};
+
+   const auto out = feed(tap, pool, static_cast<std::size_t>(RATE_HZ), 4096);
+   ASSERT_EQ(out.size(), 5U);
+   EXPECT_DOUBLE_EQ(out[0]->sampleRateHz, RATE_HZ / 80.0);   // Budget 12 500 S/s.
+   // 12 500 S/s in 5 frames, each ending with the input frame that completes it.
+   EXPECT_NEAR(static_cast<double>(out[0]->samples.size()), 2500.0, 4096.0 / 80.0);
+   EXPECT_EQ(tap.config().samplesPerSec, 50'000.0);   // Configuration untouched.
+
+   tap.setBudgetDivisor(0);
+   EXPECT_EQ(tap.budgetDivisor(), 1U);
+}
+
+TEST(DisplayIqTapTest, Decimate_SlowStreamPassesThrough)
+{
+   DisplayIqTap tap;
+   DisplayTapConfig config;
+   config.samplesPerSec = 1.0e6;
+   config.framesPerSec  = 100.0;
+   tap.setConfig(config);
+   FramePool<IqBuffer> pool{8};
+
+   const auto out = feed(tap, pool, 4000, 1000, 100'000.0);
+   ASSERT_EQ(out.size(), 4U);   // 1000-sample frames at 100 frames per second.
+   EXPECT_DOUBLE_EQ(out[0]->sampleRateHz, 100'000.0);
+   EXPECT_EQ(out[0]->samples.size(), 1000U);
+   EXPECT_FLOAT_EQ(out[1]->samples[0].real(), 1000.0F);
+}
+
+TEST(DisplayIqTapTest, Snapshot_BlocksAreContiguousAndSpaced)
+{
+   DisplayIqTap tap;
+   DisplayTapConfig config;
+   config.mode            = DisplayTapMode::Snapshot;
+   config.snapshotSamples = 4096;
+   config.samplesPerSec   = 40'960.0;   // 10 blocks per second.
+   config.framesPerSec    = 30.0;
+   tap.setConfig(config);
+   FramePool<IqBuffer> pool{64};
+
+   const auto out = feed(tap, pool, 1'000'000, 1000);
+   ASSERT_EQ(out.size(), 10U);
+   for (std::size_t b = 0; b < out.size(); ++b)
+   {
+      const auto& samples = out[b]->samples;
+      ASSERT_EQ(samples.size(), 4096U);
+      EXPECT_DOUBLE_EQ(out[b]->sampleRateHz, RATE_HZ);
+      const auto start = static_cast<float>(b * 100'000);
+      EXPECT_FLOAT_EQ(samples.front().real(), start);
+      EXPECT_FLOAT_EQ(samples.back().real(), start + 4095.0F);
+   }
+}
+
+TEST(DisplayIqTapTest, Snapshot_FrameRateCapsBlocks)
+{
+   DisplayIqTap tap;
+   DisplayTapConfig config;
+   config.mode            = DisplayTapMode::Snapshot;
+   config.snapshotSamples = 1024;
+   config.samplesPerSec   = 1.0e6;   // Would be ~977 blocks per second.
+   config.framesPerSec    = 25.0;
+   tap.setConfig(config);
+   FramePool<IqBuffer> pool{64};
+
+   const auto out = feed(tap, pool, 2'000'000, 8192);
+   EXPECT_GE(out.size(), 49U);
+   EXPECT_LE(out.size(), 51U);
+}
+
+TEST(DisplayIqTapTest, RateChange_DropsPartialFrame)
+{
+   DisplayIqTap tap;
+   DisplayTapConfig config;
+   config.samplesPerSec = 100'000.0;
+   config.framesPerSec  = 10.0;
+   tap.setConfig(config);
+   FramePool<IqBuffer> pool{8};
+
+   EXPECT_EQ(tap.process(makeFrame(0, 50'000), pool), nullptr);   // 5000 of 10000 kept.
+   const auto out = feed(tap, pool, 500'000, 50'000, 500'000.0);
+   ASSERT_FALSE(out.empty());
+   EXPECT_DOUBLE_EQ(out[0]->sampleRateHz, 100'000.0);
+   EXPECT_FLOAT_EQ(out[0]->samples[0].real(), 0.0F);
+   EXPECT_FLOAT_EQ(out[0]->samples[1].real(), 5.0F);
+   EXPECT_EQ(out[0]->samples.size(), 10'000U);
+}
@@ -0,0 +1,567 @@
+#include <gtest/gtest.h>
+#include "DspKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using SdrEngine::IqSample;
+
+namespace
+{
+
+// Odd length so every kernel also runs its scalar tail.
+constexpr std::size_t N = 1037;
+
+std::vector<float> makeInterleaved(std::size_t bins)
+{
+   std::vector<float> out(2 * bins);
+   for (std::size_t i = 0; i < out.size(); ++i)
+   {
+      out[i] = std::sin(0.37F * static_cast<float>(i)) * (1.0F + static_cast<float>(i % 13));
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+TEST(DspKernelsTest, Isa_IsKnownName)
+{
+   const std::string isa = SdrEngine::dspKernelIsa();
+   EXPECT_TRUE(isa == "avx2" || isa == "neon" || isa == "scalar") << isa;
+}
+
+// ============================================================================
+// Windowing
+// ============================================================================
+
+TEST(DspKernelsTest, ApplyWindowInterleaved_MatchesScalarReference)
+{
+   std::vector<IqSample> src(N);
+   std::vector<float> window(N);
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      src[i]    = {static_cast<float>(i), -0.5F * static_cast<float>(i)};
+      window[i] = 1.0F / static_cast<float>(i + 1);
+   }
+
+   std::vector<float> dst(2 * N, -1.0F);
+   SdrEngine::applyWindowInterleaved(src.data(), window.data(), dst.data(), N);
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      EXPECT_FLOAT_EQ(dst[2 * i], src[i].real() * window[i]);
+      EXPECT_FLOAT_EQ(dst[(2 * i) + 1], src[i].imag() * window[i]);
+   }
+}
+
+// ============================================================================
+// Power / dB
+// ============================================================================
+
+TEST(DspKernelsTest, PowerInterleaved_MatchesScalarReference)
+{
+   const auto spectrum = makeInterleaved(N);
+   std::vector<float> dst(N);
+   SdrEngine::powerInterleaved(spectrum.data(), dst.data(), N, 0.25F);
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      const float re = spectrum[2 * i];
+      const float im = spectrum[(2 * i) + 1];
+      EXPECT_NEAR(dst[i], ((re * re) + (im * im)) * 0.25F, 1.0e-4F) << "bin " << i;
+   }
+}
+
+TEST(DspKernelsTest, PowerDbInterleaved_WithinToleranceOfLog10)
+{
+   const auto spectrum = makeInterleaved(N);
+   std::vector<float> dst(N);
+   SdrEngine::powerDbInterleaved(spectrum.data(), dst.data(), N, 1.0e-3F, 1.0e-30F);
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      const float re = spectrum[2 * i];
+      const float im = spectrum[(2 * i) + 1];
+      const double p = std::max(((re * re) + (im * im)) * 1.0e-3, 1.0e-30);
+      EXPECT_NEAR(dst[i], 10.0 * std::log10(p), 1.0e-3) << "bin " << i;
+   }
+}
+
+TEST(DspKernelsTest, PowerDbInterleaved_ZeroInput_ClampsToFloor)
+{
+   const std::vector<float> zeros(2 * N, 0.0F);
+   std::vector<float> dst(N);
+   SdrEngine::powerDbInterleaved(zeros.data(), dst.data(), N, 1.0F, 1.0e-30F);
+   for (const float v : dst)
+   {
+      EXPECT_NEAR(v, -300.0F, 1.0e-3F);
+   }
+}
+
+TEST(DspKernelsTest, PowerToDb_InPlace_WithinTolerance)
+{
+   std::vector<float> values(N);
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      values[i] = std::pow(10.0F, static_cast<float>(i % 200) / 10.0F - 15.0F);
+   }
+   const auto reference = values;
+
+   SdrEngine::powerToDb(values.data(), values.data(), N, 2.0F, 1.0e-30F);
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      EXPECT_NEAR(values[i], 10.0 * std::log10(2.0 * reference[i]), 1.0e-3) << "bin " << i;
+   }
+}
+
+TEST(DspKernelsTest, FastLog10Db_ExactAtPowersOfTwo)
+{
+   EXPECT_FLOAT_EQ(SdrEngine::fastLog10Db(1.0F), 0.0F);
+   EXPECT_NEAR(SdrEngine::fastLog10Db(1024.0F), 10.0 * std::log10(1024.0), 1.0e-4);
+   EXPECT_NEAR(SdrEngine::fastLog10Db(0.125F), 10.0 * std::log10(0.125), 1.0e-4);
+}
+
+// ============================================================================
+// Spectrum statistics
+// ============================================================================
+
+TEST(DspKernelsTest, ExponentialAverage_MatchesScalarReference)
+{
+   const auto x = makeInterleaved(N / 2);
+   std::vector<float> avg(x.size());
+   for (std::size_t i = 0; i < avg.size(); ++i)
+   {
+      avg[i] = static_cast<float>(i % 7);
+   }
+   auto expected = avg;
+   for (std::size_t i = 0; i < expected.size(); ++i)
+   {
+      expected[i] = (0.75F * expected[i]) + (0.25F * x[i] * 0.5F);
+   }
+
+   SdrEngine::exponentialAverage(avg.data(), x.data(), avg.size(), 0.75F, 0.5F);
+   for (std::size_t i = 0; i < avg.size(); ++i)
+   {
+      EXPECT_NEAR(avg[i], expected[i], 1.0e-5F) << "bin " << i;
+   }
+}
+
+TEST(DspKernelsTest, MaxHoldUpdate_DecaysTowardsCurrent)
+{
+   const auto x = makeInterleaved(N / 2);
+   std::vector<float> hold(x.size());
+   for (std::size_t i = 0; i < hold.size(); ++i)
+   {
+      hold[i] = static_cast<float>(i % 11) - 5.0F;
+   }
+   std::vector<float> dst(x.size());
+
+   SdrEngine::maxHoldUpdate(hold.data(), x.data(), dst.data(), dst.size(), 1.5F);
+   for (std::size_t i = 0; i < dst.size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(dst[i], std::max(hold[i] - 1.5F, x[i])) << "bin " << i;
+   }
+}
+
+TEST(DspKernelsTest, MinHoldUpdate_MatchesScalarReference)
+{
+   const auto x = makeInterleaved(N / 2);
+   std::vector<float> hold(x.size());
+   for (std::size_t i = 0; i < hold.size(); ++i)
+   {
+      hold[i] = static_cast<float>(i % 11) - 5.0F;
+   }
+   std::vector<float> dst(x.size());
+
+   SdrEngine::minHoldUpdate(hold.data(), x.data(), dst.data(), dst.size());
+   for (std::size_t i = 0; i < dst.size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(dst[i], std::min(hold[i], x[i])) << "bin " << i;
+   }
+}
+
+TEST(DspKernelsTest, MaxValue_MatchesMaxElement)
+{
+   const auto x = makeInterleaved(N / 2);
+   for (const std::size_t n : {std::size_t{1}, std::size_t{7}, std::size_t{8}, x.size()})
+   {
+      const float expected = *std::max_element(x.data(), x.data() + n);
+      EXPECT_FLOAT_EQ(SdrEngine::maxValue(x.data(), n), expected) << "n " << n;
+   }
+}
+
+TEST(DspKernelsTest, SumValues_MatchesSequentialSum)
+{
+   const auto x = makeInterleaved(N / 2);
+   for (const std::size_t n : {std::size_t{0}, std::size_t{1}, std::size_t{9}, x.size()})
+   {
+      double expected = 0.0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         expected += x[i];
+      }
+      EXPECT_NEAR(SdrEngine::sumValues(x.data(), n), expected, 1.0e-3) << "n " << n;
+   }
+}
+
+TEST(DspKernelsTest, HistogramBuckets_MatchesScalarReference)
+{
+   auto x = makeInterleaved(N / 2);
+   x[3]  = std::nanf("");
+   x[20] = -1.0e30F;
+   x[41] = 1.0e30F;
+   constexpr float LOWEST    = -8.0F;
+   constexpr float INV_WIDTH = 4.0F;
+   constexpr uint16_t LAST   = 60;
+   std::vector<uint16_t> buckets(x.size());
+   SdrEngine::histogramBuckets(x.data(), buckets.data(), x.size(), LOWEST, INV_WIDTH, LAST);
+   for (std::size_t i = 0; i < x.size(); ++i)
+   {
+      const float v = (x[i] - LOWEST) * INV_WIDTH;
+      const auto expected = std::isnan(v) ? uint16_t{0}
+                                          : static_cast<uint16_t>(std::clamp(
+                                               std::floor(v), 0.0F, static_cast<float>(LAST)));
+      ASSERT_EQ(buckets[i], expected) << "value " << i << " = " << x[i];
+   }
+}
+
+TEST(DspKernelsTest, PairwiseReductions_MatchScalarReference)
+{
+   const auto x = makeInterleaved(N / 2);
+   const std::size_t nOut = x.size() / 2;
+   std::vector<float> mx(nOut);
+   std::vector<float> mn(nOut);
+   std::vector<float> mean(nOut);
+   SdrEngine::pairwiseMax(x.data(), mx.data(), nOut);
+   SdrEngine::pairwiseMin(x.data(), mn.data(), nOut);
+   SdrEngine::pairwiseMean(x.data(), mean.data(), nOut);
+   for (std::size_t i = 0; i < nOut; ++i)
+   {
+      EXPECT_FLOAT_EQ(mx[i], std::max(x[2 * i], x[(2 * i) + 1])) << "point " << i;
+      EXPECT_FLOAT_EQ(mn[i], std::min(x[2 * i], x[(2 * i) + 1])) << "point " << i;
+      EXPECT_FLOAT_EQ(mean[i], 0.5F * (x[2 * i] + x[(2 * i) + 1])) << "point " << i;
+   }
+}
+
+// ============================================================================
+// Sliding windows (CFAR)
+// ============================================================================
+
+TEST(DspKernelsTest, SlidingSum_MatchesDirectSums)
+{
+   // Noise-like dB levels over more than one restart block.
+   std::vector<float> x(4 * N);
+   for (std::size_t i = 0; i < x.size(); ++i)
+   {
+      x[i] = -100.0F + (10.0F * std::sin(0.37F * static_cast<float>(i)));
+   }
+   for (const std::size_t window : {std::size_t{1}, std::size_t{7}, std::size_t{32}})
+   {
+      const std::size_t nOut = x.size() - window + 1;
+      std::vector<float> sums(nOut);
+      SdrEngine::slidingSum(x.data(), sums.data(), nOut, window);
+      for (std::size_t i = 0; i < nOut; ++i)
+      {
+         double expected = 0.0;
+         for (std::size_t k = 0; k < window; ++k)
+         {
+            expected += x[i + k];
+         }
+         ASSERT_NEAR(sums[i], expected, 1.0e-5 * std::abs(expected))
+            << "window " << window << " sum " << i;
+      }
+   }
+}
+
+TEST(DspKernelsTest, ExcessOverReference_MatchesScalarReference)
+{
+   const auto x = makeInterleaved(N / 2);
+   std::vector<float> lead(x.size());
+   std::vector<float> lag(x.size());
+   for (std::size_t i = 0; i < x.size(); ++i)
+   {
+      lead[i] = static_cast<float>(i % 17);
+      lag[i]  = -0.5F * static_cast<float>(i % 11);
+   }
+   std::vector<float> dst(x.size());
+   SdrEngine::excessOverReference(x.data(), lead.data(), lag.data(), dst.data(), x.size(), 0.25F);
+   for (std::size_t i = 0; i < x.size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(dst[i], x[i] - ((lead[i] + lag[i]) * 0.25F)) << "value " << i;
+   }
+}
+
+TEST(DspKernelsTest, FindFirstAtLeast_FindsEveryPosition)
+{
+   std::vector<float> x(N, -1.0F);
+   EXPECT_EQ(SdrEngine::findFirstAtLeast(x.data(), N, 0.0F), N);
+   for (const std::size_t at : {std::size_t{0}, std::size_t{5}, std::size_t{8}, N - 1})
+   {
+      x[at] = 0.0F;
+      EXPECT_EQ(SdrEngine::findFirstAtLeast(x.data(), N, 0.0F), at);
+      x[at] = -1.0F;
+   }
+   x[3] = std::nanf("");
+   EXPECT_EQ(SdrEngine::findFirstAtLeast(x.data(), N, -2.0F), 0U);
+   EXPECT_EQ(SdrEngine::findFirstAtLeast(x.data() + 3, N - 3, 0.0F), N - 3);
+}
+
+// ============================================================================
+// Decimating FIR
+// ============================================================================
+
+TEST(DspKernelsTest, FirDecimate_MatchesScalarReference)
+{
+   const auto x = makeInterleaved(N / 2);
+   // Tap counts that hit the 16-, 8- and 4-wide loops and the scalar tail.
+   for (const std::size_t numTaps : {std::size_t{1}, std::size_t{7}, std::size_t{21},
+                                     std::size_t{65}})
+   {
+      std::vector<float> taps(numTaps);
+      for (std::size_t k = 0; k < numTaps; ++k)
+      {
+         taps[k] = std::cos(0.11F * static_cast<float>(k)) / static_cast<float>(numTaps);
+      }
+      for (const std::size_t decimation : {std::size_t{1}, std::size_t{3}})
+      {
+         const std::size_t nOut = ((x.size() - numTaps) / decimation) + 1;
+         std::vector<float> y(nOut);
+         SdrEngine::firDecimate(x.data(), taps.data(), numTaps, y.data(), nOut, decimation);
+         for (std::size_t i = 0; i < nOut; ++i)
+         {
+            double expected = 0.0;
+            for (std::size_t k = 0; k < numTaps; ++k)
+            {
+               expected += static_cast<double>(taps[k]) * x[(i * decimation) + k];
+            }
+            ASSERT_NEAR(y[i], expected, 1.0e-4)
+               << "taps " << numTaps << " decimation " << decimation << " output " << i;
+         }
+      }
+   }
+}
+
+// ============================================================================
+// Integer → float conversion
+// ============================================================================
+
+TEST(DspKernelsTest, ConvertCs8ToIq_ExactForEveryValue)
+{
+   std::vector<int8_t> src(2 * N);
+   for (std::size_t i = 0; i < src.size(); ++i)
+   {
+      src[i] = static_cast<int8_t>(static_cast<int>(i % 256) - 128);
+   }
+   std::vector<IqSample> dst(N);
+   SdrEngine::convertCs8ToIq(src.data(), dst.data(), N, 1.0F / 128.0F);
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      EXPECT_EQ(dst[i].real(), static_cast<float>(src[2 * i]) / 128.0F) << "i=" << i;
+      EXPECT_EQ(dst[i].imag(), static_cast<float>(src[(2 * i) + 1]) / 128.0F) << "i=" << i;
+   }
+}
+
+TEST(DspKernelsTest, ConvertCs16ToIq_MatchesScalarReference)
+{
+   std::vector<int16_t> src(2 * N);
+   for (std::size_t i = 0; i < src.size(); ++i)
+   {
+      src[i] = static_cast<int16_t>((static_cast<int>(i) * 997) % 65536 - 32768);
+   }
+   std::vector<IqSample> dst(N);
+   SdrEngine::convertCs16ToIq(src.data(), dst.data(), N, 1.0F / 2048.0F);
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      EXPECT_FLOAT_EQ(dst[i].real(), static_cast<float>(src[2 * i]) / 2048.0F) << "i=" << i;
+      EXPECT_FLOAT_EQ(dst[i].imag(), static_cast<float>(src[(2 * i) + 1]) / 2048.0F) << "i=" << i;
+   }
+}
+
+TEST(DspKernelsTest, ConvertIqToCs16_RoundsAndSaturates)
+{
+   std::vector<IqSample> src(N);
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      // Sweeps past full scale at both ends.
+      const float v = (static_cast<float>(i) / static_cast<float>(N) * 2.5F) - 1.25F;
+      src[i] = {v, -v * 0.5F};
+   }
+   src[3] = {1.0e9F, -1.0e9F};
+   std::vector<int16_t> dst(2 * N);
+   SdrEngine::convertIqToCs16(src.data(), dst.data(), N, 32767.0F);
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      const auto expected = [](float v) {
+         return static_cast<int16_t>(std::lrint(std::clamp(v * 32767.0F, -32768.0F, 32767.0F)));
+      };
+      EXPECT_EQ(dst[2 * i], expected(src[i].real())) << "i=" << i;
+      EXPECT_EQ(dst[(2 * i) + 1], expected(src[i].imag())) << "i=" << i;
+   }
+
+   // Round trip through convertCs16ToIq() is within half a step.
+   std::vector<IqSample> back(N);
+   SdrEngine::convertCs16ToIq(dst.data(), back.data(), N, 1.0F / 32767.0F);
+   EXPECT_NEAR(back[N / 2].real(), src[N / 2].real(), 0.5F / 32767.0F);
+}
+
+TEST(DspKernelsTest, ConvertToIq_OffsetIntoBlock_UsesFullScale)
+{
+   const std::vector<int16_t> src = {0, 0, 1024, -1024, 2047, -2048};
+   const SdrEngine::RawIqBlock block{src.data(), SdrEngine::IqSampleFormat::CS16, 3, 2048.0F};
+
+   std::vector<IqSample> dst(2);
+   SdrEngine::convertToIq(block, 1, dst.data(), 2);
+   EXPECT_FLOAT_EQ(dst[0].real(), 0.5F);
+   EXPECT_FLOAT_EQ(dst[0].imag(), -0.5F);
+   EXPECT_FLOAT_EQ(dst[1].imag(), -1.0F);
+}
+
+TEST(DspKernelsTest, ConvertToIq_Cf32_CopiesUnchanged)
+{
+   const std::vector<IqSample> src = {{0.25F, -0.5F}, {1.5F, 2.0F}};
+   const SdrEngine::RawIqBlock block{src.data(), SdrEngine::IqSampleFormat::CF32, 2, 1.0F};
+
+   std::vector<IqSample> dst(2);
+   SdrEngine::convertToIq(block, 0, dst.data(), 2);
+   EXPECT_EQ(dst, src);
+}
+
+TEST(DspKernelsTest, ConvertToCs16_KeepsNativeIntegers)
+{
+   const std::vector<int8_t> cs8 = {1, -2, 127, -128, 5, 6};
+   const SdrEngine::RawIqBlock block8{cs8.data(), SdrEngine::IqSampleFormat::CS8, 3, 128.0F};
+   std::vector<int16_t> dst(4);
+   SdrEngine::convertToCs16(block8, 1, dst.data(), 2);
+   EXPECT_EQ(dst, (std::vector<int16_t>{127, -128, 5, 6}));
+   EXPECT_FLOAT_EQ(SdrEngine::cs16FullScale(block8), 128.0F);
+
+   const std::vector<int16_t> cs16 = {2047, -2048, 7, -7};
+   const SdrEngine::RawIqBlock block16{cs16.data(), SdrEngine::IqSampleFormat::CS16, 2, 2048.0F};
+   SdrEngine::convertToCs16(block16, 0, dst.data(), 2);
+   EXPECT_EQ(dst, cs16);
+   EXPECT_FLOAT_EQ(SdrEngine::cs16FullScale(block16), 2048.0F);
+}
+
+TEST(DspKernelsTest, ConvertToCs16_Cf32_ScaledToCs16FullScale)
+{
+   const std::vector<IqSample> src = {{0.5F, -1.0F}};
+   const SdrEngine::RawIqBlock block{src.data(), SdrEngine::IqSampleFormat::CF32, 1, 1.0F};
+   std::vector<int16_t> dst(2);
+   SdrEngine::convertToCs16(block, 0, dst.data(), 1);
+   EXPECT_EQ(dst, (std::vector<int16_t>{16384, -32767}));
+   EXPECT_FLOAT_EQ(SdrEngine::cs16FullScale(block), SdrEngine::CS16_FULL_SCALE);
+}
+
+// ============================================================================
+// DC blocker
+// ============================================================================
+
+TEST(DspKernelsTest, ConvertToIqDcBlocked_MatchesScalarRecursion)
+{
+   std::vector<int16_t> src(2 * N);
+   for (std::size_t i = 0; i < src.size(); ++i)
+   {
+      src[i] = static_cast<int16_t>(((static_cast<int>(i) * 389) % 4096) - 1500);
+   }
+   const SdrEngine::RawIqBlock block{src.data(), SdrEngine::IqSampleFormat::CS16, N, 2048.0F};
+   SdrEngine::DcBlockerState state{0.01F, {0.1F, -0.2F}};
+
+   std::vector<IqSample> dst(N);
+   SdrEngine::convertToIqDcBlocked(block, 0, dst.data(), N, state);
+
+   double mr = 0.1;
+   double mi = -0.2;
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      const double xr = static_cast<double>(src[2 * i]) / 2048.0;
+      const double xi = static_cast<double>(src[(2 * i) + 1]) / 2048.0;
+      mr += 0.01 * (xr - mr);
+      mi += 0.01 * (xi - mi);
+      ASSERT_NEAR(dst[i].real(), xr - mr, 1.0e-5) << "i=" << i;
+      ASSERT_NEAR(dst[i].imag(), xi - mi, 1.0e-5) << "i=" << i;
+   }
+   EXPECT_NEAR(state.mean.real(), mr, 1.0e-5);
+   EXPECT_NEAR(state.mean.imag(), mi, 1.0e-5);
+}
+
+TEST(DspKernelsTest, ConvertToIqDcBlocked_IndependentOfChunking)
+{
+   std::vector<int8_t> src(2 * N);
+   for (std::size_t i = 0; i < src.size(); ++i)
+   {
+      src[i] = static_cast<int8_t>(((static_cast<int>(i) * 37) % 200) - 60);
+   }
+   const SdrEngine::RawIqBlock block{src.data(), SdrEngine::IqSampleFormat::CS8, N, 128.0F};
+
+   SdrEngine::DcBlockerState whole{0.002F, {}};
+   std::vector<IqSample> expected(N);
+   SdrEngine::convertToIqDcBlocked(block, 0, expected.data(), N, whole);
+
+   SdrEngine::DcBlockerState chunked{0.002F, {}};
+   std::vector<IqSample> actual(N);
+   for (std::size_t first = 0; first < N; first += 7)
+   {
+      const std::size_t count = std::min<std::size_t>(7, N - first);
+      SdrEngine::convertToIqDcBlocked(block, first, actual.data() + first, count, chunked);
+   }
+
+   for (std::size_t i = 0; i < N; ++i)
+   {
+      ASSERT_NEAR(actual[i].real(), expected[i].real(), 1.0e-5) << "i=" << i;
+      ASSERT_NEAR(actual[i].imag(), expected[i].imag(), 1.0e-5) << "i=" << i;
+   }
+}
+
+TEST(DspKernelsTest, ConvertToIqDcBlocked_RemovesConstantOffset)
+{
+   const std::vector<IqSample> src(20000, {0.3F, -0.7F});
+   const SdrEngine::RawIqBlock block{src.data(), SdrEngine::IqSampleFormat::CF32, src.size(), 1.0F};
+   SdrEngine::DcBlockerState state{SdrEngine::dcBlockerAlpha(0.001F, 1.0e6), {}};
+
+   std::vector<IqSample> dst(src.size());
+   SdrEngine::convertToIqDcBlocked(block, 0, dst.data(), dst.size(), state);
+   EXPECT_LT(std::abs(dst.back()), 1.0e-4F);
+   EXPECT_NEAR(state.mean.real(), 0.3F, 1.0e-4F);
+}
+
+TEST(DspKernelsTest, DcBlockerAlpha_MatchesTimeConstant)
+{
+   EXPECT_NEAR(SdrEngine::dcBlockerAlpha(0.01F, 1.0e6), 1.0e-4F, 1.0e-8F);
+   EXPECT_EQ(SdrEngine::dcBlockerAlpha(0.0F, 1.0e6), 1.0F);
+}
+
+// ============================================================================
+// fftshift
+// ============================================================================
+
+TEST(DspKernelsTest, FftShift_MatchesModuloDefinition)
+{
+   for (const std::size_t n : {std::size_t{8}, std::size_t{9}, std::size_t{1}})
+   {
+      std::vector<float> src(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         src[i] = static_cast<float>(i);
+      }
+      std::vector<float> dst(n, -1.0F);
+      SdrEngine::fftShift(src.data(), dst.data(), n);
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         EXPECT_EQ(dst[(i + (n / 2)) % n], src[i]) << "n=" << n << " i=" << i;
+      }
+   }
+}
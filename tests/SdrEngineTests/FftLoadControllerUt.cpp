@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "FftLoadController.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using SdrEngine::FftLoadAdjustment;
+using SdrEngine::FftLoadConfig;
+using SdrEngine::FftLoadController;
+using SdrEngine::FftLoadInput;
+using SdrEngine::FftLoadKnob;
+using SdrEngine::FftLoadSettings;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double SAMPLE_RATE_HZ = 20.0e6;
+constexpr std::size_t FFT_SIZE  = 65536;
+
+// Drives a controller with simulated stage timers, one period per call.
+class LoadSimulation
+{
+public:
+   LoadSimulation(FftLoadController& controller, FftLoadSettings requested)
+      : _controller{controller}
+      , _input{}
+   {
+      _input.requested = requested;
+      _controller.update(input(), _now);   // Starts the first period.
+   }
+
+   // One measurement period with the FFT stage busy `utilization` of the
+   // time and `backlog` frames queued.
+   std::optional<FftLoadAdjustment> period(double utilization, std::size_t backlog = 0)
+   {
+      const auto interval = std::chrono::duration<double>(_controller.config().intervalSec);
+      _now += std::chrono::duration_cast<Clock::duration>(interval);
+      _input.fft.busyNs += static_cast<uint64_t>(utilization * interval.count() * 1.0e9);
+      _input.fft.queueDepth = backlog;
+      return _controller.update(input(), _now);
+   }
+
+   // Periods until the controller acts (or `limit` passed).
+   std::optional<FftLoadAdjustment> untilAdjusted(double utilization, std::size_t limit = 20)
+   {
+      for (std::size_t i = 0; i < limit; ++i)
+      {
+         if (auto adjustment = period(utilization))
+         {
+            return adjustment;
+         }
+      }
+      return std::nullopt;
+   }
+
+   FftLoadSettings settings() const { return _controller.apply(_input.requested); }
+
+   FftLoadInput& raw() { return _input; }
+
+private:
+   // The segment rate follows the overlap in use, as in the FFT stage.
+   const FftLoadInput& input()
+   {
+      const double hop = static_cast<double>(FFT_SIZE) *
+                         (1.0 - static_cast<double>(settings().overlapPercent) / 100.0);
+      _input.segmentRateHz = SAMPLE_RATE_HZ / hop;
+      return _input;
+   }
+
+   FftLoadController& _controller;
+   FftLoadInput _input;
+   Clock::time_point _now{};
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// Shedding load
+// ============================================================================
+
+TEST(FftLoadControllerTest, UnderTarget_NothingChanges)
+{
+   FftLoadController controller;
+   LoadSimulation sim(controller, FftLoadSettings{75.0F, 0.0F, 1});
+   for (int i = 0; i < 20; ++i)
+   {
+      EXPECT_FALSE(sim.period(0.5).has_value());
+   }
+   EXPECT_EQ(controller.level(), 0U);
+   EXPECT_NEAR(controller.utilization(), 0.5, 1.0e-9);
+   EXPECT_EQ(sim.settings(), (FftLoadSettings{75.0F, 0.0F, 1}));
+}
+
+TEST(FftLoadControllerTest, Overloaded_LowersOverlapThenRateThenDisplay)
+{
+   FftLoadConfig config;
+   config.minOutputRate     = 20.0F;
+   config.maxDisplayDivisor = 4;
+   FftLoadController controller(config);
+   LoadSimulation sim(controller, FftLoadSettings{75.0F, 0.0F, 1});
+   sim.raw().displayTapActive = true;
+
+   std::vector<FftLoadAdjustment> steps;
+   while (auto adjustment = sim.untilAdjusted(1.2))
+   {
+      EXPECT_TRUE(adjustment->degraded);
+      EXPECT_DOUBLE_EQ(adjustment->utilization, 1.2);
+      steps.push_back(*adjustment);
+   }
+
+   // 75 -> 37.5 -> 18.75 -> 0 %; 305 segments/s -> 152.6 -> 76.3 -> 38.1
+   // -> 20 Hz; display 1/2 -> 1/4.
+   ASSERT_EQ(steps.size(), 9U);
+   EXPECT_EQ(steps[0].knob, FftLoadKnob::Overlap);
+   EXPECT_FLOAT_EQ(steps[0].after.overlapPercent, 37.5F);
+   EXPECT_FLOAT_EQ(steps[2].before.overlapPercent, 18.75F);
+   EXPECT_FLOAT_EQ(steps[2].after.overlapPercent, 0.0F);
+   EXPECT_EQ(steps[3].knob, FftLoadKnob::OutputRate);
+   EXPECT_FLOAT_EQ(steps[3].before.outputRate, 0.0F);
+   EXPECT_NEAR(steps[3].after.outputRate, SAMPLE_RATE_HZ / FFT_SIZE / 2.0, 0.01);
+   EXPECT_FLOAT_EQ(steps[6].after.outputRate, 20.0F);
+   EXPECT_EQ(steps[7].knob, FftLoadKnob::DisplayTap);
+   EXPECT_EQ(steps[8].after.displayDivisor, 4U);
+   EXPECT_EQ(controller.level(), 9U);
+   EXPECT_EQ(sim.settings(), (FftLoadSettings{0.0F, 20.0F, 4}));
+}
+
+TEST(FftLoadControllerTest, Backlog_CountsAsOverloadAtLowUtilization)
+{
+   FftLoadController controller;
+   LoadSimulation sim(controller, FftLoadSettings{50.0F, 30.0F, 1});
+   EXPECT_FALSE(sim.period(0.3, 3).has_value());
+   const auto adjustment = sim.period(0.3, 4);
+   ASSERT_TRUE(adjustment.has_value());
+   EXPECT_EQ(adjustment->knob, FftLoadKnob::Overlap);
+   EXPECT_EQ(adjustment->backlog, 4U);
+}
+
+TEST(FftLoadControllerTest, AfterStep_NextPeriodIsNotJudged)
+{
+   FftLoadController controller;
+   LoadSimulation sim(controller, FftLoadSettings{75.0F, 0.0F, 1});
+   ASSERT_TRUE(sim.period(1.5).has_value());
+   EXPECT_FALSE(sim.period(1.5).has_value());   // The step is still settling.
+   EXPECT_TRUE(sim.period(1.5).has_value());
+}
+
+TEST(FftLoadControllerTest, RequestedSettingsStillApplyUnderLimits)
+{
+   FftLoadController controller;
+   LoadSimulation sim(controller, FftLoadSettings{75.0F, 30.0F, 1});
+   ASSERT_TRUE(sim.period(1.0).has_value());   // Overlap capped at 37.5 %.
+
+   // A lower request passes through; a higher one stays capped.
+   EXPECT_FLOAT_EQ(controller.apply(FftLoadSettings{25.0F, 30.0F, 1}).overlapPercent, 25.0F);
+   EXPECT_FLOAT_EQ(controller.apply(FftLoadSettings{90.0F, 30.0F, 1}).overlapPercent, 37.5F);
+}
+
+TEST(FftLoadControllerTest, NothingLeft_NoAdjustment)
+{
+   FftLoadController controller;
+   LoadSimulation sim(controller, FftLoadSettings{0.0F, 5.0F, 1});
+   EXPECT_FALSE(sim.untilAdjusted(2.0).has_value());   // No overlap, minimum rate, no tap.
+   EXPECT_EQ(controller.level(), 0U);
+}
+
+// ============================================================================
+// Recovering
+// ============================================================================
+
+TEST(FftLoadControllerTest, Headroom_UndoesStepsLatestFirst)
+{
+   FftLoadConfig config;
+   config.settleIntervals = 3;
+   FftLoadController controller(config);
+   LoadSimulation sim(controller, FftLoadSettings{75.0F, 0.0F, 1});
+   ASSERT_TRUE(sim.untilAdjusted(1.0).has_value());
+   ASSERT_TRUE(sim.untilAdjusted(1.0).has_value());
+   ASSERT_EQ(controller.level(), 2U);
+
+   // Between half the target and the target: holds.
+   for (int i = 0; i < 10; ++i)
+   {
+      EXPECT_FALSE(sim.period(0.5).has_value());
+   }
+
+   // Well under: one step back after three calm periods, then the next.
+   EXPECT_FALSE(sim.period(0.2).has_value());
+   EXPECT_FALSE(sim.period(0.2).has_value());
+   auto adjustment = sim.period(0.2);
+   ASSERT_TRUE(adjustment.has_value());
+   EXPECT_FALSE(adjustment->degraded);
+   EXPECT_FLOAT_EQ(adjustment->before.overlapPercent, 18.75F);
+   EXPECT_FLOAT_EQ(adjustment->after.overlapPercent, 37.5F);
+   adjustment = sim.untilAdjusted(0.2);
+   ASSERT_TRUE(adjustment.has_value());
+   EXPECT_FALSE(adjustment->degraded);
+   EXPECT_EQ(sim.settings(), (FftLoadSettings{75.0F, 0.0F, 1}));
+   EXPECT_FALSE(sim.untilAdjusted(0.2).has_value());
+}
+
+TEST(FftLoadControllerTest, Reset_LiftsEveryLimit)
+{
+   FftLoadController controller;
+   LoadSimulation sim(controller, FftLoadSettings{75.0F, 0.0F, 1});
+   ASSERT_TRUE(sim.period(1.0).has_value());
+   controller.reset();
+   EXPECT_EQ(controller.level(), 0U);
+   EXPECT_EQ(sim.settings(), (FftLoadSettings{75.0F, 0.0F, 1}));
+}
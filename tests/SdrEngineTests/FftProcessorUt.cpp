@@ -1,12 +1,21 @@
 #include <gtest/gtest.h>
 #include "FftProcessor.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <complex>
+#include <cstddef>
+#include <memory_resource>
 #include <numbers>
 #include <numeric>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
+using SdrEngine::FftBackend;
 using SdrEngine::FftProcessor;
 using SdrEngine::WindowFunction;
 
@@ -150,6 +159,309 @@ TEST(FftProcessorTest, Process_OutputSizeMatchesFftSize)
    EXPECT_EQ(result.size(), static_cast<std::size_t>(N));
 }
 
+TEST(FftProcessorTest, Process_PmrVector_MatchesStdVectorAndUsesArena)
+{
+   constexpr int N = 256;
+   const FftProcessor proc(N, WindowFunction::Hanning);
+   const std::vector<std::complex<float>> dc(static_cast<std::size_t>(N), {1.0F, 0.0F});
+   const auto expected = proc.process(dc);
+
+   std::array<std::byte, 4 * N * sizeof(float)> storage{};
+   std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(),
+                                             std::pmr::null_memory_resource());
+   std::pmr::vector<float> magnitudesDb(&arena);
+   proc.process(dc, magnitudesDb);
+
+   ASSERT_EQ(magnitudesDb.size(), expected.size());
+   EXPECT_TRUE(std::equal(expected.begin(), expected.end(), magnitudesDb.begin()));
+}
+
+TEST(FftProcessorTest, ProcessPower_MatchesDbSpectrum)
+{
+   constexpr int N = 256;
+   FftProcessor proc(N, WindowFunction::Hanning);
+
+   std::vector<std::complex<float>> tone(static_cast<std::size_t>(N));
+   for (std::size_t i = 0; i < tone.size(); ++i)
+   {
+      const float phase = 2.0F * std::numbers::pi_v<float> * 10.0F *
+                          static_cast<float>(i) / static_cast<float>(N);
+      tone[i] = {std::cos(phase), std::sin(phase)};
+   }
+
+   const auto db = proc.process(tone);
+   std::vector<float> power;
+   proc.processPower(tone, power);
+   ASSERT_EQ(power.size(), db.size());
+
+   for (std::size_t i = 0; i < power.size(); ++i)
+   {
+      if (db[i] > -150.0F)
+      {
+         EXPECT_NEAR(10.0F * std::log10(power[i]), db[i], 0.01F) << "bin " << i;
+      }
+   }
+}
+
+// ============================================================================
+// Batched processing
+// ============================================================================
+
+namespace
+{
+
+std::vector<std::complex<float>> makeTone(std::size_t count, float cyclesPerSample)
+{
+   std::vector<std::complex<float>> out(count);
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      const float phase = 2.0F * std::numbers::pi_v<float> * cyclesPerSample *
+                          static_cast<float>(i);
+      out[i] = {std::cos(phase), std::sin(phase)};
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+TEST(FftProcessorTest, MaxBatchFrames_IsPowerOfTwoAndBoundedBySize)
+{
+   const FftProcessor small(256);
+   const FftProcessor large(262144);
+   EXPECT_EQ(small.maxBatchFrames(), 16U);
+   EXPECT_EQ(large.maxBatchFrames(), 4U);
+}
+
+TEST(FftProcessorTest, ProcessBatch_MatchesPerFrameProcess)
+{
+   constexpr std::size_t N = 128;
+   constexpr std::size_t FRAMES = 7;   // Exercises the 4 + 2 + 1 chunk split.
+   const FftProcessor proc(N, WindowFunction::Hanning);
+   const auto signal = makeTone(N * FRAMES, 0.07F);
+
+   std::vector<float> batch;
+   proc.processBatch(signal, FRAMES, batch);
+   ASSERT_EQ(batch.size(), N * FRAMES);
+
+   for (std::size_t f = 0; f < FRAMES; ++f)
+   {
+      const std::vector<std::complex<float>> frame(
+         signal.begin() + static_cast<std::ptrdiff_t>(f * N),
+         signal.begin() + static_cast<std::ptrdiff_t>((f + 1) * N));
+      const auto single = proc.process(frame);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+         EXPECT_NEAR(batch[(f * N) + i], single[i], 1.0e-3F) << "frame " << f << " bin " << i;
+      }
+   }
+}
+
+TEST(FftProcessorTest, ProcessPowerBatch_OverlappedSegmentsMatchProcessPower)
+{
+   constexpr std::size_t N = 64;
+   constexpr std::size_t HOP = 16;
+   constexpr std::size_t FRAMES = 5;
+   const FftProcessor proc(N);
+   const auto signal = makeTone(((FRAMES - 1) * HOP) + N, 0.2F);
+
+   std::vector<float> batch;
+   proc.processPowerBatch(signal, FRAMES, HOP, batch);
+   ASSERT_EQ(batch.size(), N * FRAMES);
+
+   std::vector<float> single;
+   for (std::size_t f = 0; f < FRAMES; ++f)
+   {
+      proc.processPower(std::span<const std::complex<float>>(signal).subspan(f * HOP, N), single);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+         EXPECT_NEAR(batch[(f * N) + i], single[i], 1.0e-4F) << "frame " << f << " bin " << i;
+      }
+   }
+}
+
+TEST(FftProcessorTest, ProcessBatch_ShortInput_ZeroPadsTrailingFrames)
+{
+   constexpr std::size_t N = 64;
+   const FftProcessor proc(N);
+   const std::vector<std::complex<float>> oneFrame(N, {1.0F, 0.0F});
+
+   std::vector<float> batch;
+   proc.processBatch(oneFrame, 3, batch);
+   ASSERT_EQ(batch.size(), 3 * N);
+   EXPECT_GT(batch[N / 2], -1.0F);            // DC of the real frame.
+   EXPECT_LT(batch[N + (N / 2)], -200.0F);    // Second frame is all zero.
+}
+
+// ============================================================================
+// Plan management
+// ============================================================================
+
+TEST(FftProcessorTest, PrepareFftSizes_MakesPlansReady)
+{
+   FftProcessor proc(64);
+   EXPECT_TRUE(proc.isPlanReady(64));
+   EXPECT_FALSE(proc.isPlanReady(128));
+
+   proc.prepareFftSizes({128, 256});
+   proc.waitForPreparedPlans();
+
+   EXPECT_TRUE(proc.isPlanReady(128));
+   EXPECT_TRUE(proc.isPlanReady(256));
+   EXPECT_FALSE(proc.isPlanReady(512));
+}
+
+TEST(FftProcessorTest, SetFftSize_PreparedPlan_ProcessesAtNewSize)
+{
+   FftProcessor proc(64, WindowFunction::Rectangular);
+   proc.prepareFftSizes({128});
+   proc.waitForPreparedPlans();
+
+   proc.setFftSize(128);
+   EXPECT_EQ(proc.getFftSize(), 128);
+
+   const std::vector<std::complex<float>> dc(128, {1.0F, 0.0F});
+   const auto result = proc.process(dc);
+   ASSERT_EQ(result.size(), 128U);
+   EXPECT_NEAR(result[64], 0.0F, 0.01F);
+}
+
+TEST(FftProcessorTest, SetFftSize_SwitchBack_KeepsOldPlanCached)
+{
+   FftProcessor proc(64);
+   proc.setFftSize(128);
+   EXPECT_TRUE(proc.isPlanReady(64));
+
+   proc.setFftSize(64);
+   EXPECT_EQ(proc.getFftSize(), 64);
+   const std::vector<std::complex<float>> dc(64, {1.0F, 0.0F});
+   EXPECT_EQ(proc.process(dc).size(), 64U);
+}
+
+TEST(FftProcessorTest, SetWindowFunction_AppliesToPreparedPlan)
+{
+   FftProcessor proc(64, WindowFunction::BlackmanHarris);
+   proc.prepareFftSizes({128});
+   proc.waitForPreparedPlans();
+
+   proc.setWindowFunction(WindowFunction::Rectangular);
+   proc.setFftSize(128);
+
+   // A rectangular window leaves an off-bin tone's leakage far higher
+   // than Blackman-Harris would at the farthest bin.
+   std::vector<std::complex<float>> tone(128);
+   for (std::size_t i = 0; i < tone.size(); ++i)
+   {
+      const float phase = 2.0F * std::numbers::pi_v<float> * 10.5F * static_cast<float>(i) / 128.0F;
+      tone[i] = {std::cos(phase), std::sin(phase)};
+   }
+   const auto result = proc.process(tone);
+   EXPECT_GT(result[0], -60.0F);
+}
+
+TEST(FftProcessorTest, SetFftSize_WhileProcessing_SwitchesAtFrameBoundary)
+{
+   FftProcessor proc(64, WindowFunction::Rectangular);
+   proc.prepareFftSizes({128});
+   proc.waitForPreparedPlans();
+
+   std::atomic<bool> done{false};
+   std::atomic<int> badFrames{0};
+   std::thread processing([&]()
+   {
+      const std::vector<std::complex<float>> dc(128, {1.0F, 0.0F});
+      std::vector<float> result;
+      while (!done.load())
+      {
+         proc.process(dc, result);
+         // Every frame uses one plan and the window of its size: a DC
+         // input peaks at 0 dB in the centre bin.
+         if ((result.size() != 64 && result.size() != 128) ||
+             std::abs(result[result.size() / 2]) > 0.01F)
+         {
+            ++badFrames;
+         }
+      }
+   });
+
+   for (int i = 0; i < 200; ++i)
+   {
+      proc.setFftSize((i % 2 == 0) ? 128 : 64);
+      proc.setWindowFunction((i % 3 == 0) ? WindowFunction::Rectangular
+                                          : WindowFunction::FlatTop);
+      proc.setWindowFunction(WindowFunction::Rectangular);
+   }
+   done = true;
+   processing.join();
+
+   EXPECT_EQ(badFrames.load(), 0);
+   EXPECT_EQ(proc.getFftSize(), 64U);
+   const std::vector<std::complex<float>> dc(64, {1.0F, 0.0F});
+   EXPECT_EQ(proc.process(dc).size(), 64U);
+}
+
+TEST(FftProcessorTest, SaveWisdom_ThenLoad_ReportsResult)
+{
+   const std::string path = ::testing::TempDir() + "fft_wisdom_ut.dat";
+   EXPECT_TRUE(FftProcessor::saveWisdom(path));
+   EXPECT_FALSE(FftProcessor::loadWisdom(::testing::TempDir() + "no_such_dir/wisdom.dat"));
+}
+
+// ============================================================================
+// Backends
+// ============================================================================
+
+TEST(FftProcessorTest, Backends_ProduceTheSameSpectrum)
+{
+   constexpr std::size_t N = 1024;
+   FftProcessor fftw(N, WindowFunction::Hanning, FftBackend::Fftw);
+   FftProcessor builtin(N, WindowFunction::Hanning, FftBackend::Builtin);
+   ASSERT_EQ(fftw.getActiveBackend(), FftBackend::Fftw);
+   ASSERT_EQ(builtin.getActiveBackend(), FftBackend::Builtin);
+
+   const auto signal = makeTone(N * 3, 0.123F);
+   std::vector<float> a;
+   std::vector<float> b;
+   fftw.processBatch(signal, 3, a);
+   builtin.processBatch(signal, 3, b);
+   ASSERT_EQ(a.size(), b.size());
+   for (std::size_t i = 0; i < a.size(); ++i)
+   {
+      // Far below the tone the two differ only in float rounding noise.
+      if (a[i] > -100.0F)
+      {
+         EXPECT_NEAR(a[i], b[i], 1.0e-2F) << "bin " << i;
+      }
+   }
+}
+
+TEST(FftProcessorTest, SetBackend_ReplansCurrentSize)
+{
+   FftProcessor proc(512, WindowFunction::Rectangular, FftBackend::Fftw);
+   proc.setBackend(FftBackend::Builtin);
+   EXPECT_EQ(proc.getBackend(), FftBackend::Builtin);
+   EXPECT_EQ(proc.getActiveBackend(), FftBackend::Builtin);
+   EXPECT_EQ(proc.getFftSize(), 512U);
+
+   // Auto settles on a concrete backend, and the choice is stable.
+   proc.setBackend(FftBackend::Auto);
+   EXPECT_EQ(proc.getBackend(), FftBackend::Auto);
+   EXPECT_NE(proc.getActiveBackend(), FftBackend::Auto);
+   EXPECT_EQ(proc.getActiveBackend(), SdrEngine::selectFftBackend(512));
+}
+
+TEST(FftProcessorTest, BenchmarkFftBackends_SortedFastestFirst)
+{
+   const auto timings = SdrEngine::benchmarkFftBackends(256);
+   ASSERT_EQ(timings.size(), 2U);
+   EXPECT_LE(timings[0].nsPerTransform, timings[1].nsPerTransform);
+   EXPECT_GT(timings[0].nsPerTransform, 0.0);
+
+   // Sizes BuiltinFft cannot do are left to FFTW.
+   const auto odd = SdrEngine::benchmarkFftBackends(1000);
+   ASSERT_EQ(odd.size(), 1U);
+   EXPECT_EQ(odd[0].backend, FftBackend::Fftw);
+}
+
 // ============================================================================
 // Move semantics
 // ============================================================================
@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include "FileSdrDevice.h"
+#include "SdrTypes.h"
+#include "Vita49Codec.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using SdrEngine::FileSdrDevice;
+using SdrEngine::IqFileFormat;
+using SdrEngine::IqSample;
+using SdrEngine::PlaybackPacing;
+using SdrEngine::RawIqBlock;
+
+namespace
+{
+
+template <typename T>
+std::string writeCapture(const std::string& name, const std::vector<T>& values)
+{
+   const std::string path = ::testing::TempDir() + name;
+   std::ofstream out(path, std::ios::binary | std::ios::trunc);
+   out.write(reinterpret_cast<const char*>(values.data()),
+             static_cast<std::streamsize>(values.size() * sizeof(T)));
+   return path;
+}
+
+// Sample n is (n, -n) so order and completeness are easy to check.
+std::vector<IqSample> rampCf32(std::size_t n)
+{
+   std::vector<IqSample> samples(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      samples[i] = {static_cast<float>(i), -static_cast<float>(i)};
+   }
+   return samples;
+}
+
+bool waitForEnd(const FileSdrDevice& device, std::chrono::milliseconds timeout)
+{
+   const auto deadline = std::chrono::steady_clock::now() + timeout;
+   while (device.isStreaming() && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   return !device.isStreaming();
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+TEST(FileSdrDeviceTest, Open_MissingFile_Fails)
+{
+   FileSdrDevice device(::testing::TempDir() + "no_such_capture.cf32", IqFileFormat::CF32);
+   EXPECT_FALSE(device.open());
+   EXPECT_FALSE(device.isOpen());
+   EXPECT_FALSE(device.startStreaming([](const IqSample*, std::size_t) {}));
+}
+
+TEST(FileSdrDeviceTest, Open_RawCapture_CountsSamplesAndIgnoresPartialTail)
+{
+   std::vector<int8_t> bytes(2 * 300 + 1, 1);   // 300 CS8 samples + 1 stray byte
+   FileSdrDevice device(writeCapture("partial.cs8", bytes), IqFileFormat::CS8);
+   ASSERT_TRUE(device.open());
+   EXPECT_EQ(device.getTotalSamples(), 300U);
+   EXPECT_FALSE(device.setFile("other.cs8", IqFileFormat::CS8));
+
+   device.close();
+   EXPECT_FALSE(device.isOpen());
+   EXPECT_EQ(device.getTotalSamples(), 0U);
+   EXPECT_TRUE(device.setFile("other.cs8", IqFileFormat::CS8));
+}
+
+// ============================================================================
+// Playback
+// ============================================================================
+
+TEST(FileSdrDeviceTest, Cf32_AsFastAsPossible_DeliversWholeFileInOrder)
+{
+   const auto samples = rampCf32(1000);
+   FileSdrDevice device(writeCapture("ramp.cf32", samples), IqFileFormat::CF32);
+   ASSERT_TRUE(device.open());
+   device.setPacing(PlaybackPacing::AsFastAsPossible);
+
+   std::vector<IqSample> received;
+   std::vector<const IqSample*> blockStarts;
+   ASSERT_TRUE(device.startStreaming(
+      [&](const IqSample* data, std::size_t n)
+      {
+         blockStarts.push_back(data);
+         received.insert(received.end(), data, data + n);
+      },
+      256));
+   ASSERT_TRUE(waitForEnd(device, std::chrono::seconds(5)));
+
+   EXPECT_EQ(received, samples);
+   ASSERT_EQ(blockStarts.size(), 4U);
+   for (std::size_t b = 1; b < blockStarts.size(); ++b)
+   {
+      // Consecutive blocks are consecutive views into the mapping.
+      EXPECT_EQ(blockStarts[b], blockStarts[b - 1] + 256);
+   }
+
+   const auto stats = device.getStreamStats();
+   EXPECT_EQ(stats.samplesReceived, 1000U);
+   EXPECT_EQ(stats.reads, 4U);
+   EXPECT_EQ(stats.shortReads, 1U);
+}
+
+TEST(FileSdrDeviceTest, Cs16_RawStreaming_HandsOutMappedNativeBlocks)
+{
+   std::vector<int16_t> values(2 * 512);
+   for (std::size_t i = 0; i < values.size(); ++i)
+   {
+      values[i] = static_cast<int16_t>(i);
+   }
+   FileSdrDevice device(writeCapture("ramp.cs16", values), IqFileFormat::CS16);
+   ASSERT_TRUE(device.open());
+   device.setPacing(PlaybackPacing::AsFastAsPossible);
+
+   std::vector<RawIqBlock> blocks;
+   std::vector<int16_t> received;
+   ASSERT_TRUE(device.startRawStreaming(
+      [&](const RawIqBlock& block)
+      {
+         blocks.push_back(block);
+         const auto* data = static_cast<const int16_t*>(block.data);
+         received.insert(received.end(), data, data + (2 * block.numSamples));
+      },
+      128));
+   ASSERT_TRUE(waitForEnd(device, std::chrono::seconds(5)));
+
+   EXPECT_EQ(received, values);
+   ASSERT_EQ(blocks.size(), 4U);
+   for (std::size_t b = 0; b < blocks.size(); ++b)
+   {
+      EXPECT_EQ(blocks[b].format, SdrEngine::IqSampleFormat::CS16);
+      EXPECT_FLOAT_EQ(blocks[b].fullScale, 32768.0F);
+      EXPECT_EQ(blocks[b].data, static_cast<const int16_t*>(blocks[0].data) + (b * 256));
+   }
+}
+
+TEST(FileSdrDeviceTest, Cs8_Streaming_ConvertsToFloat)
+{
+   const std::vector<int8_t> values = {64, -64, -128, 127};
+   FileSdrDevice device(writeCapture("pair.cs8", values), IqFileFormat::CS8);
+   ASSERT_TRUE(device.open());
+   device.setPacing(PlaybackPacing::AsFastAsPossible);
+
+   std::vector<IqSample> received;
+   ASSERT_TRUE(device.startStreaming(
+      [&](const IqSample* data, std::size_t n)
+      { received.insert(received.end(), data, data + n); }));
+   ASSERT_TRUE(waitForEnd(device, std::chrono::seconds(5)));
+
+   ASSERT_EQ(received.size(), 2U);
+   EXPECT_FLOAT_EQ(received[0].real(), 0.5F);
+   EXPECT_FLOAT_EQ(received[0].imag(), -0.5F);
+   EXPECT_FLOAT_EQ(received[1].real(), -1.0F);
+   EXPECT_NEAR(received[1].imag(), 127.0F / 128.0F, 1e-6F);
+}
+
+TEST(FileSdrDeviceTest, Looping_RestartsUntilStopped)
+{
+   FileSdrDevice device(writeCapture("loop.cf32", rampCf32(100)), IqFileFormat::CF32);
+   ASSERT_TRUE(device.open());
+   device.setPacing(PlaybackPacing::AsFastAsPossible);
+   device.setLooping(true);
+
+   std::mutex mutex;
+   std::vector<float> firstOfBlock;
+   ASSERT_TRUE(device.startStreaming(
+      [&](const IqSample* data, std::size_t)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         firstOfBlock.push_back(data[0].real());
+      },
+      100));
+
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (device.getStreamStats().samplesReceived < 500 &&
+          std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   EXPECT_TRUE(device.isStreaming());
+   device.stopStreaming();
+   EXPECT_FALSE(device.isStreaming());
+
+   const std::lock_guard<std::mutex> lock(mutex);
+   ASSERT_GE(firstOfBlock.size(), 5U);
+   for (const float first : firstOfBlock)
+   {
+      EXPECT_FLOAT_EQ(first, 0.0F);
+   }
+}
+
+TEST(FileSdrDeviceTest, RealTime_PacesAtSampleRate)
+{
+   FileSdrDevice device(writeCapture("paced.cf32", rampCf32(2000)), IqFileFormat::CF32);
+   ASSERT_TRUE(device.open());
+   ASSERT_TRUE(device.setSampleRate(20'000));   // 2000 samples = 100 ms
+   EXPECT_EQ(device.getPacing(), PlaybackPacing::RealTime);
+
+   const auto start = std::chrono::steady_clock::now();
+   ASSERT_TRUE(device.startStreaming([](const IqSample*, std::size_t) {}, 200));
+   ASSERT_TRUE(waitForEnd(device, std::chrono::seconds(5)));
+   const auto elapsed = std::chrono::steady_clock::now() - start;
+
+   EXPECT_GE(elapsed, std::chrono::milliseconds(95));
+   EXPECT_EQ(device.getStreamStats().samplesReceived, 2000U);
+}
+
+// ============================================================================
+// VITA 49
+// ============================================================================
+
+TEST(FileSdrDeviceTest, Vita49_TakesContextAndDecodesSignalPackets)
+{
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   Vita49_2::ContextFields context;
+   context.sampleRate  = 1'000'000.0;
+   context.rfFrequency = 100'000'000.0;
+
+   Vita49_2::IQSamples samples(300);
+   for (std::size_t i = 0; i < samples.size(); ++i)
+   {
+      samples[i] = {static_cast<float>(i) / 1000.0F, -0.25F};
+   }
+   std::vector<uint8_t> file = codec.encodeContext(7, context);
+   for (int packet = 0; packet < 2; ++packet)
+   {
+      const auto bytes = codec.encodeSignalData(7, samples, static_cast<uint8_t>(packet));
+      file.insert(file.end(), bytes.begin(), bytes.end());
+   }
+
+   FileSdrDevice device(writeCapture("capture.v49", file), IqFileFormat::Vita49);
+   ASSERT_TRUE(device.open());
+   EXPECT_EQ(device.getSampleRate(), 1'000'000U);
+   EXPECT_EQ(device.getCenterFrequency(), 100'000'000U);
+   EXPECT_EQ(device.getTotalSamples(), 600U);
+   device.setPacing(PlaybackPacing::AsFastAsPossible);
+
+   std::vector<IqSample> received;
+   ASSERT_TRUE(device.startStreaming(
+      [&](const IqSample* data, std::size_t n)
+      { received.insert(received.end(), data, data + n); }));
+   ASSERT_TRUE(waitForEnd(device, std::chrono::seconds(5)));
+
+   ASSERT_EQ(received.size(), 600U);
+   for (std::size_t i = 0; i < received.size(); ++i)
+   {
+      EXPECT_NEAR(received[i].real(), samples[i % 300].real(), 1e-4F);
+      EXPECT_NEAR(received[i].imag(), -0.25F, 1e-4F);
+   }
+   EXPECT_EQ(device.getStreamStats().reads, 2U);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "FramePool.h"
+#include "SdrTypes.h"
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using SdrEngine::FramePool;
+using SdrEngine::IqBuffer;
+using SdrEngine::SpectrumData;
+
+// ============================================================================
+// Acquire / release
+// ============================================================================
+
+TEST(FramePoolTest, Acquire_EmptyPool_CountsMiss)
+{
+   FramePool<IqBuffer> pool;
+   auto frame = pool.acquire();
+   ASSERT_NE(frame, nullptr);
+
+   const auto stats = pool.stats();
+   EXPECT_EQ(stats.hits, 0U);
+   EXPECT_EQ(stats.misses, 1U);
+   EXPECT_EQ(stats.pooled, 0U);
+}
+
+TEST(FramePoolTest, Release_ReturnsFrameForReuse)
+{
+   FramePool<IqBuffer> pool;
+   const IqBuffer* first = nullptr;
+   {
+      auto frame = pool.acquire();
+      frame->samples.resize(1024);
+      first = frame.get();
+   }
+   EXPECT_EQ(pool.stats().pooled, 1U);
+
+   auto again = pool.acquire();
+   EXPECT_EQ(again.get(), first);
+   EXPECT_GE(again->samples.capacity(), 1024U);
+   EXPECT_EQ(pool.stats().hits, 1U);
+}
+
+TEST(FramePoolTest, SharedCopies_ReturnOnlyAfterLastRelease)
+{
+   FramePool<SpectrumData> pool;
+   auto frame = pool.acquire();
+   // Stands in for a DataHandler listener still holding the frame.
+   std::shared_ptr<const SpectrumData> listenerCopy = frame;
+
+   frame.reset();
+   EXPECT_EQ(pool.stats().pooled, 0U);
+
+   listenerCopy.reset();
+   EXPECT_EQ(pool.stats().pooled, 1U);
+}
+
+TEST(FramePoolTest, Release_BeyondMaxPooled_DeletesExtraFrames)
+{
+   FramePool<IqBuffer> pool(2);
+   {
+      auto a = pool.acquire();
+      auto b = pool.acquire();
+      auto c = pool.acquire();
+   }
+   EXPECT_EQ(pool.stats().pooled, 2U);
+}
+
+// ============================================================================
+// Prefill / lifetime
+// ============================================================================
+
+TEST(FramePoolTest, Prefill_FirstAcquiresHit)
+{
+   FramePool<IqBuffer> pool(4);
+   pool.prefill(3, [](IqBuffer& buf) { buf.samples.reserve(256); });
+   EXPECT_EQ(pool.stats().pooled, 3U);
+
+   auto frame = pool.acquire();
+   EXPECT_GE(frame->samples.capacity(), 256U);
+   EXPECT_EQ(pool.stats().hits, 1U);
+   EXPECT_EQ(pool.stats().misses, 0U);
+}
+
+TEST(FramePoolTest, Prefill_CappedAtMaxPooled)
+{
+   FramePool<IqBuffer> pool(2);
+   pool.prefill(10, [](IqBuffer& /*buf*/) {});
+   EXPECT_EQ(pool.stats().pooled, 2U);
+}
+
+TEST(FramePoolTest, Frame_OutlivesPool_ReleaseIsSafe)
+{
+   std::shared_ptr<IqBuffer> frame;
+   {
+      FramePool<IqBuffer> pool;
+      frame = pool.acquire();
+   }
+   frame->samples.resize(8);
+   frame.reset();
+   SUCCEED();
+}
+
+TEST(FramePoolTest, WeakRef_OutlivesPoolAndFrame)
+{
+   // The control block (from the pool's resource) outlives both here.
+   std::weak_ptr<IqBuffer> weak;
+   {
+      FramePool<IqBuffer> pool;
+      auto frame = pool.acquire();
+      weak = frame;
+   }
+   EXPECT_TRUE(weak.expired());
+   weak.reset();
+}
+
+TEST(FramePoolTest, ResetStats_ZeroesCounters)
+{
+   FramePool<IqBuffer> pool;
+   std::ignore = pool.acquire();
+   pool.resetStats();
+   EXPECT_EQ(pool.stats().hits, 0U);
+   EXPECT_EQ(pool.stats().misses, 0U);
+}
+
+TEST(FramePoolTest, ReleaseOnOtherThread_ReturnsToPool)
+{
+   FramePool<IqBuffer> pool;
+   auto frame = pool.acquire();
+   std::thread listener([f = std::move(frame)]() mutable { f.reset(); });
+   listener.join();
+   EXPECT_EQ(pool.stats().pooled, 1U);
+}
@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+#include "DataHandler.h"
+#include "FileSdrDevice.h"
+#include "IqRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using SdrEngine::IqBuffer;
+using SdrEngine::IqRecorder;
+using SdrEngine::IqSample;
+using SdrEngine::RecordingFormat;
+
+namespace
+{
+
+// Sample n of block b is (b * 1000 + n, -n).
+IqBuffer makeBuffer(std::size_t block, std::size_t n, double centerFreqHz = 100e6)
+{
+   IqBuffer buffer;
+   buffer.centerFreqHz = centerFreqHz;
+   buffer.sampleRateHz = 1e6;
+   buffer.samples.resize(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      buffer.samples[i] = {static_cast<float>((block * 1000) + i), -static_cast<float>(i)};
+   }
+   return buffer;
+}
+
+std::string readFile(const std::string& path)
+{
+   std::ifstream in(path, std::ios::binary | std::ios::ate);
+   std::string bytes(static_cast<std::size_t>(std::max<std::streamoff>(in.tellg(), 0)), '\0');
+   in.seekg(0);
+   in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+   return bytes;
+}
+
+std::vector<IqSample> readCf32(const std::string& path)
+{
+   const std::string bytes = readFile(path);
+   std::vector<IqSample> samples(bytes.size() / sizeof(IqSample));
+   std::memcpy(samples.data(), bytes.data(), samples.size() * sizeof(IqSample));
+   return samples;
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+TEST(IqRecorderTest, Start_UnwritablePath_Fails)
+{
+   IqRecorder recorder;
+   EXPECT_FALSE(
+      recorder.start(::testing::TempDir() + "no_such_dir/rec.cf32", RecordingFormat::Raw));
+   EXPECT_FALSE(recorder.isRecording());
+}
+
+TEST(IqRecorderTest, Start_Twice_SecondFails)
+{
+   IqRecorder recorder(4096, 2);
+   const std::string path = ::testing::TempDir() + "twice.cf32";
+   ASSERT_TRUE(recorder.start(path, RecordingFormat::Raw));
+   EXPECT_FALSE(recorder.start(path, RecordingFormat::Raw));
+   EXPECT_EQ(recorder.getDataPath(), path);
+   recorder.stop();
+   EXPECT_FALSE(recorder.isRecording());
+}
+
+TEST(IqRecorderTest, Write_WhileIdle_Ignored)
+{
+   IqRecorder recorder(4096, 2);
+   recorder.write(makeBuffer(0, 100));
+   EXPECT_EQ(recorder.stats().droppedSamples, 0U);
+}
+
+// ============================================================================
+// Raw / SigMF
+// ============================================================================
+
+TEST(IqRecorderTest, Raw_WritesEverySampleInOrder)
+{
+   IqRecorder recorder(4096, 4);   // 512 samples per buffer
+   const std::string path = ::testing::TempDir() + "raw.cf32";
+   ASSERT_TRUE(recorder.start(path, RecordingFormat::Raw));
+
+   std::vector<IqSample> expected;
+   for (std::size_t b = 0; b < 3; ++b)
+   {
+      const IqBuffer buffer = makeBuffer(b, 700);
+      expected.insert(expected.end(), buffer.samples.begin(), buffer.samples.end());
+      recorder.write(buffer);
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));   // Let the writer keep up.
+   }
+   recorder.stop();
+
+   EXPECT_EQ(readCf32(path), expected);
+   const auto stats = recorder.stats();
+   EXPECT_EQ(stats.samplesWritten, 2100U);
+   EXPECT_EQ(stats.bytesWritten, 2100U * sizeof(IqSample));
+   EXPECT_EQ(stats.buffersWritten, 5U);   // 4 full + the partial tail
+   EXPECT_EQ(stats.droppedBuffers, 0U);
+   EXPECT_EQ(stats.writeErrors, 0U);
+   EXPECT_GT(stats.elapsedSec, 0.0);
+}
+
+TEST(IqRecorderTest, DirectIo_PartialTail_StillWrittenExactly)
+{
+   // O_DIRECT falls back to buffered writes on filesystems without it
+   // (e.g. tmpfs); either way the file must hold exactly what was written.
+   IqRecorder recorder(4096, 4);
+   const std::string path = ::testing::TempDir() + "direct.cf32";
+   ASSERT_TRUE(recorder.start(path, RecordingFormat::Raw, true));
+   const IqBuffer buffer = makeBuffer(0, 1000);
+   recorder.write(buffer);
+   recorder.stop();
+
+   EXPECT_EQ(readCf32(path), buffer.samples);
+}
+
+TEST(IqRecorderTest, SigMf_WritesDataAndSidecarWithCaptures)
+{
+   IqRecorder recorder(4096, 4);
+   const std::string base = ::testing::TempDir() + "capture";
+   ASSERT_TRUE(recorder.start(base, RecordingFormat::SigMf));
+   EXPECT_EQ(recorder.getDataPath(), base + ".sigmf-data");
+   recorder.write(makeBuffer(0, 300, 100e6));
+   recorder.write(makeBuffer(1, 200, 101.5e6));
+   recorder.stop();
+
+   EXPECT_EQ(readCf32(base + ".sigmf-data").size(), 500U);
+   const std::string meta = readFile(base + ".sigmf-meta");
+   EXPECT_NE(meta.find("\"core:datatype\": \"cf32_le\""), std::string::npos);
+   EXPECT_NE(meta.find("\"core:sample_rate\": 1000000,"), std::string::npos);
+   EXPECT_NE(meta.find("{\"core:sample_start\": 0, \"core:frequency\": 100000000"),
+             std::string::npos);
+   EXPECT_NE(meta.find("{\"core:sample_start\": 300, \"core:frequency\": 101500000}"),
+             std::string::npos);
+}
+
+TEST(IqRecorderTest, SigMf_Cs16_HalvesDataAndDeclaresCi16)
+{
+   IqRecorder recorder(4096, 4);
+   const std::string base = ::testing::TempDir() + "capture_cs16";
+   ASSERT_TRUE(recorder.start(base, RecordingFormat::SigMf, false, SdrEngine::IqStorage::Cs16));
+   IqBuffer buffer = makeBuffer(0, 1500);
+   for (auto& sample : buffer.samples)
+   {
+      sample *= 1.0F / 2048.0F;   // Keep the ramp inside full scale.
+   }
+   recorder.write(buffer);
+   recorder.stop();
+
+   // 1500 samples span several 4 KiB buffers at 4 bytes each.
+   const std::string data = readFile(base + ".sigmf-data");
+   ASSERT_EQ(data.size(), 1500U * 4U);
+   EXPECT_EQ(recorder.stats().samplesWritten, 1500U);
+   std::vector<int16_t> values(2 * 1500);
+   std::memcpy(values.data(), data.data(), data.size());
+   for (std::size_t i = 0; i < 1500; i += 499)
+   {
+      EXPECT_NEAR(values[2 * i] / 32767.0F, buffer.samples[i].real(), 1.0F / 32767.0F);
+      EXPECT_NEAR(values[(2 * i) + 1] / 32767.0F, buffer.samples[i].imag(), 1.0F / 32767.0F);
+   }
+   EXPECT_NE(readFile(base + ".sigmf-meta").find("\"core:datatype\": \"ci16_le\""),
+             std::string::npos);
+}
+
+// ============================================================================
+// VITA 49
+// ============================================================================
+
+TEST(IqRecorderTest, Vita49_PlaysBackThroughFileSdrDevice)
+{
+   IqRecorder recorder(4096, 4);
+   const std::string path = ::testing::TempDir() + "recorded.v49";
+   ASSERT_TRUE(recorder.start(path, RecordingFormat::Vita49));
+   IqBuffer buffer = makeBuffer(0, 600);
+   for (auto& sample : buffer.samples)
+   {
+      sample /= 1000.0F;   // Keep within the int16 payload's range.
+   }
+   recorder.write(buffer);
+   recorder.stop();
+
+   SdrEngine::FileSdrDevice device(path, SdrEngine::IqFileFormat::Vita49);
+   ASSERT_TRUE(device.open());
+   EXPECT_EQ(device.getSampleRate(), 1'000'000U);
+   EXPECT_EQ(device.getCenterFrequency(), 100'000'000U);
+   ASSERT_EQ(device.getTotalSamples(), 600U);
+
+   device.setPacing(SdrEngine::PlaybackPacing::AsFastAsPossible);
+   std::vector<IqSample> played;
+   ASSERT_TRUE(device.startStreaming(
+      [&](const IqSample* data, std::size_t n) { played.insert(played.end(), data, data + n); }));
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (device.isStreaming() && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   ASSERT_EQ(played.size(), 600U);
+   for (std::size_t i = 0; i < played.size(); ++i)
+   {
+      EXPECT_NEAR(played[i].real(), buffer.samples[i].real(), 1e-4F);
+      EXPECT_NEAR(played[i].imag(), buffer.samples[i].imag(), 1e-4F);
+   }
+}
+
+// ============================================================================
+// Overload and subscription
+// ============================================================================
+
+TEST(IqRecorderTest, WriterBehind_DropsAndCountsInsteadOfBlocking)
+{
+   // One oversized block fills both buffers before the writer can return
+   // either, so everything past 2 x 512 samples is dropped.
+   IqRecorder recorder(4096, 2);
+   ASSERT_TRUE(recorder.start(::testing::TempDir() + "drops.cf32", RecordingFormat::Raw));
+   recorder.write(makeBuffer(0, 5000));
+   recorder.stop();
+
+   const auto stats = recorder.stats();
+   EXPECT_EQ(stats.samplesWritten, 1024U);
+   EXPECT_EQ(stats.droppedBuffers, 1U);
+   EXPECT_EQ(stats.droppedSamples, 5000U - 1024U);
+}
+
+TEST(IqRecorderTest, WriteWaiting_WaitsForWriterInsteadOfDropping)
+{
+   IqRecorder recorder(4096, 2);
+   const std::string path = ::testing::TempDir() + "waiting.cf32";
+   ASSERT_TRUE(recorder.start(path, RecordingFormat::Raw));
+   const IqBuffer buffer = makeBuffer(0, 5000);
+   recorder.writeWaiting(buffer);
+   recorder.stop();
+
+   const auto stats = recorder.stats();
+   EXPECT_EQ(stats.samplesWritten, 5000U);
+   EXPECT_EQ(stats.droppedBuffers, 0U);
+   EXPECT_EQ(readCf32(path), buffer.samples);
+}
+
+TEST(IqRecorderTest, Attach_RecordsPublishedBuffers)
+{
+   CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>> handler;
+   IqRecorder recorder(4096, 4);
+   ASSERT_TRUE(recorder.start(::testing::TempDir() + "attached.cf32", RecordingFormat::Raw));
+   recorder.attach(handler);
+
+   for (std::size_t b = 0; b < 3; ++b)
+   {
+      handler.signalData(std::make_shared<const IqBuffer>(makeBuffer(b, 512)));
+   }
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (recorder.stats().samplesWritten < 1536 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   recorder.detach();
+   recorder.stop();
+
+   EXPECT_EQ(recorder.stats().samplesWritten, 1536U);
+}
@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+#include "IqSampleRing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using SdrEngine::IqSample;
+using SdrEngine::IqSampleRing;
+
+namespace
+{
+
+std::vector<IqSample> makeRamp(std::size_t count, float start = 0.0F)
+{
+   std::vector<IqSample> out(count);
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      const float v = start + static_cast<float>(i);
+      out[i] = {v, -v};
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+TEST(IqSampleRingTest, Constructor_RoundsCapacityToPowerOfTwo)
+{
+   const IqSampleRing ring(1000);
+   EXPECT_EQ(ring.capacity(), 1024U);
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.freeSpace(), 1024U);
+   EXPECT_EQ(ring.overflowCount(), 0U);
+}
+
+TEST(IqSampleRingTest, Reset_ClearsContentsAndCounters)
+{
+   IqSampleRing ring(8);
+   const auto data = makeRamp(12);
+   ring.write(data.data(), data.size());
+   EXPECT_EQ(ring.overflowCount(), 4U);
+
+   ring.reset(16);
+   EXPECT_EQ(ring.capacity(), 16U);
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.overflowCount(), 0U);
+}
+
+// ============================================================================
+// Write / read
+// ============================================================================
+
+TEST(IqSampleRingTest, WriteThenRead_PreservesOrder)
+{
+   IqSampleRing ring(16);
+   const auto data = makeRamp(10);
+   EXPECT_EQ(ring.write(data.data(), data.size()), 10U);
+   EXPECT_EQ(ring.available(), 10U);
+
+   std::vector<IqSample> out(10);
+   EXPECT_EQ(ring.read(out.data(), out.size()), 10U);
+   EXPECT_EQ(out, data);
+   EXPECT_EQ(ring.available(), 0U);
+}
+
+TEST(IqSampleRingTest, WriteAcrossWrap_PeekReturnsTwoRegions)
+{
+   IqSampleRing ring(8);
+   const auto first = makeRamp(6);
+   ring.write(first.data(), first.size());
+   std::vector<IqSample> sink(6);
+   ring.read(sink.data(), sink.size());
+
+   // Write pointer is now at physical index 6; 5 samples wrap around.
+   const auto second = makeRamp(5, 100.0F);
+   ring.write(second.data(), second.size());
+
+   const auto regions = ring.peek(5);
+   EXPECT_EQ(regions.first.size(), 2U);
+   EXPECT_EQ(regions.second.size(), 3U);
+   EXPECT_EQ(regions.first[0], second[0]);
+   EXPECT_EQ(regions.second[0], second[2]);
+
+   std::vector<IqSample> out(5);
+   ring.read(out.data(), out.size());
+   EXPECT_EQ(out, second);
+}
+
+TEST(IqSampleRingTest, PrepareWrite_CommitMakesDataVisible)
+{
+   IqSampleRing ring(8);
+   auto regions = ring.prepareWrite(3);
+   ASSERT_EQ(regions.size(), 3U);
+   regions.first[0] = {1.0F, 2.0F};
+   regions.first[1] = {3.0F, 4.0F};
+   regions.first[2] = {5.0F, 6.0F};
+   EXPECT_EQ(ring.available(), 0U);
+
+   ring.commitWrite(3);
+   EXPECT_EQ(ring.available(), 3U);
+   EXPECT_EQ(ring.peek(1).first[0], IqSample(1.0F, 2.0F));
+}
+
+// ============================================================================
+// Cs16 storage
+// ============================================================================
+
+TEST(IqSampleRingTest, Cs16_WriteConvertsAndReadRestores)
+{
+   IqSampleRing ring(1000, SdrEngine::IqStorage::Cs16);
+   EXPECT_EQ(ring.storage(), SdrEngine::IqStorage::Cs16);
+   EXPECT_EQ(ring.capacity(), 1024U);
+   EXPECT_TRUE(ring.peek(1).first.empty());
+
+   const std::vector<IqSample> data = {{0.5F, -0.25F}, {1.0F, -1.0F}, {0.0F, 0.125F}};
+   EXPECT_EQ(ring.write(data.data(), data.size()), 3U);
+   EXPECT_EQ(ring.available(), 3U);
+   EXPECT_EQ(ring.freeSpace(), 1021U);
+   EXPECT_EQ(ring.peekCs16(1).first[0], 16384);
+
+   std::vector<IqSample> out(3);
+   EXPECT_EQ(ring.read(out.data(), out.size()), 3U);
+   for (std::size_t i = 0; i < data.size(); ++i)
+   {
+      EXPECT_NEAR(out[i].real(), data[i].real(), 1.0F / 32767.0F);
+      EXPECT_NEAR(out[i].imag(), data[i].imag(), 1.0F / 32767.0F);
+   }
+   EXPECT_EQ(ring.available(), 0U);
+}
+
+TEST(IqSampleRingTest, Cs16_NativeScaleAcrossWrap)
+{
+   IqSampleRing ring(8, SdrEngine::IqStorage::Cs16);
+   ring.setCs16FullScale(128.0F);
+   std::vector<IqSample> sink(6);
+   auto regions = ring.prepareWriteCs16(6);
+   ASSERT_EQ(regions.size(), 12U);
+   ring.commitWrite(6);
+   ring.read(sink.data(), sink.size());
+
+   // Five samples from physical index 6 split into 2 + 3, whole samples each.
+   regions = ring.prepareWriteCs16(5);
+   ASSERT_EQ(regions.first.size(), 4U);
+   ASSERT_EQ(regions.second.size(), 6U);
+   std::fill(regions.first.begin(), regions.first.end(), int16_t{64});
+   std::fill(regions.second.begin(), regions.second.end(), int16_t{-32});
+   ring.commitWrite(5);
+   EXPECT_EQ(ring.peekCs16(5).size(), 10U);
+
+   std::vector<IqSample> out(5);
+   EXPECT_EQ(ring.read(out.data(), out.size()), 5U);
+   EXPECT_FLOAT_EQ(out[1].imag(), 0.5F);
+   EXPECT_FLOAT_EQ(out[2].real(), -0.25F);
+   EXPECT_FLOAT_EQ(out[4].imag(), -0.25F);
+}
+
+TEST(IqSampleRingTest, Cs16_FullRingDropsAndCountsOverflow)
+{
+   IqSampleRing ring(4, SdrEngine::IqStorage::Cs16);
+   const auto data = makeRamp(6, 0.0F);
+   std::vector<IqSample> scaled(data.size());
+   std::transform(data.begin(), data.end(), scaled.begin(),
+                  [](IqSample s) { return s * 0.1F; });
+   EXPECT_EQ(ring.write(scaled.data(), scaled.size()), 4U);
+   EXPECT_EQ(ring.overflowCount(), 2U);
+
+   ring.consume(4);
+   EXPECT_EQ(ring.available(), 0U);
+   EXPECT_EQ(ring.freeSpace(), 4U);
+}
+
+TEST(IqSampleRingTest, StampedCommits_ReportArrivalOfNewestConsumedSample)
+{
+   using Clock = std::chrono::steady_clock;
+   IqSampleRing ring(16);
+   EXPECT_EQ(ring.lastReadArrival(), Clock::time_point{});
+
+   const Clock::time_point first{std::chrono::milliseconds(10)};
+   const Clock::time_point second{std::chrono::milliseconds(20)};
+   std::ignore = ring.prepareWrite(4);
+   ring.commitWrite(4, first);
+   std::ignore = ring.prepareWrite(4);
+   ring.commitWrite(4, second);
+
+   std::vector<IqSample> out(3);
+   ring.read(out.data(), 3);   // Newest consumed sample came with the first commit.
+   EXPECT_EQ(ring.lastReadArrival(), first);
+   ring.read(out.data(), 1);
+   EXPECT_EQ(ring.lastReadArrival(), first);
+   ring.read(out.data(), 1);
+   EXPECT_EQ(ring.lastReadArrival(), second);
+
+   ring.reset(16);
+   EXPECT_EQ(ring.lastReadArrival(), Clock::time_point{});
+}
+
+TEST(IqSampleRingTest, WriteWhenFull_DropsAndCountsOverflow)
+{
+   IqSampleRing ring(4);
+   const auto data = makeRamp(6);
+   EXPECT_EQ(ring.write(data.data(), data.size()), 4U);
+   EXPECT_EQ(ring.overflowCount(), 2U);
+   EXPECT_EQ(ring.freeSpace(), 0U);
+
+   // Oldest samples are kept; the excess is dropped.
+   std::vector<IqSample> out(4);
+   ring.read(out.data(), out.size());
+   EXPECT_EQ(out[0], data[0]);
+   EXPECT_EQ(out[3], data[3]);
+}
+
+TEST(IqSampleRingTest, ReadMoreThanAvailable_ReturnsAvailable)
+{
+   IqSampleRing ring(8);
+   const auto data = makeRamp(3);
+   ring.write(data.data(), data.size());
+
+   std::vector<IqSample> out(8);
+   EXPECT_EQ(ring.read(out.data(), out.size()), 3U);
+}
+
+// ============================================================================
+// Blocking and threading
+// ============================================================================
+
+TEST(IqSampleRingTest, WaitForSamples_AlreadyAvailable_ReturnsTrue)
+{
+   IqSampleRing ring(8);
+   const auto data = makeRamp(4);
+   ring.write(data.data(), data.size());
+   EXPECT_TRUE(ring.waitForSamples(4));
+}
+
+TEST(IqSampleRingTest, Interrupt_WakesBlockedConsumer)
+{
+   IqSampleRing ring(8);
+   bool result = true;
+   std::thread consumer([&] { result = ring.waitForSamples(4); });
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   ring.interrupt();
+   consumer.join();
+   EXPECT_FALSE(result);
+}
+
+TEST(IqSampleRingTest, ProducerConsumer_AllSamplesArriveInOrder)
+{
+   constexpr std::size_t TOTAL = 200'000;
+   constexpr std::size_t CHUNK = 1000;
+   IqSampleRing ring(4096);
+   const auto data = makeRamp(TOTAL);
+
+   std::thread producer([&]
+   {
+      std::size_t sent = 0;
+      while (sent < TOTAL)
+      {
+         // Only write what fits so nothing is dropped in this test.
+         const std::size_t n = std::min({CHUNK, TOTAL - sent, ring.freeSpace()});
+         sent += ring.write(data.data() + sent, n);
+         if (n == 0)
+         {
+            std::this_thread::yield();
+         }
+      }
+   });
+
+   std::vector<IqSample> received;
+   received.reserve(TOTAL);
+   std::vector<IqSample> block(512);
+   while (received.size() < TOTAL)
+   {
+      const std::size_t want = std::min(block.size(), TOTAL - received.size());
+      ASSERT_TRUE(ring.waitForSamples(want));
+      const std::size_t got = ring.read(block.data(), want);
+      received.insert(received.end(), block.begin(),
+                      block.begin() + static_cast<std::ptrdiff_t>(got));
+   }
+   producer.join();
+
+   EXPECT_EQ(ring.overflowCount(), 0U);
+   EXPECT_EQ(received, data);
+}
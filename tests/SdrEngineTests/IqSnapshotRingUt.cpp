@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "IqSnapshotRing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using SdrEngine::IqSample;
+using SdrEngine::IqSnapshotRing;
+using SdrEngine::SnapshotStorage;
+
+namespace
+{
+
+// Sample i of the stream is (i, -i / 2) at full scale 1 / 65536.
+std::vector<IqSample> makeSamples(uint64_t first, std::size_t n)
+{
+   std::vector<IqSample> samples(n);
+   for (std::size_t k = 0; k < n; ++k)
+   {
+      const auto i = static_cast<float>(first + k);
+      samples[k]   = {i / 65536.0F, -i / 131072.0F};
+   }
+   return samples;
+}
+
+void append(IqSnapshotRing& ring, std::size_t n,
+            std::chrono::steady_clock::time_point arrived = std::chrono::steady_clock::now())
+{
+   const auto samples = makeSamples(ring.written(), n);
+   ring.write(samples.data(), n, arrived);
+}
+
+} // anonymous namespace
+
+TEST(IqSnapshotRingTest, Unallocated_IgnoresWrites)
+{
+   IqSnapshotRing ring;
+   append(ring, 100);
+   EXPECT_EQ(ring.capacity(), 0U);
+   EXPECT_EQ(ring.written(), 0U);
+}
+
+TEST(IqSnapshotRingTest, ReadBackAcrossWrap_ReturnsSamplesByIndex)
+{
+   IqSnapshotRing ring;
+   ring.reset(1000, SnapshotStorage::Cf32);
+   for (int b = 0; b < 5; ++b)
+   {
+      append(ring, 300);   // 1500 written: indices 500..1499 survive.
+   }
+   EXPECT_EQ(ring.written(), 1500U);
+   EXPECT_EQ(ring.oldest(), 500U);
+
+   std::vector<IqSample> out(600);
+   EXPECT_EQ(ring.read(850, out.data(), out.size()), 0U);
+   EXPECT_EQ(out, makeSamples(850, 600));
+}
+
+TEST(IqSnapshotRingTest, ReadBeforeOldest_ReportsLostPrefix)
+{
+   IqSnapshotRing ring;
+   ring.reset(1000, SnapshotStorage::Cf32);
+   append(ring, 1500);   // One block larger than the ring.
+   EXPECT_EQ(ring.oldest(), 500U);
+
+   std::vector<IqSample> out(300);
+   const std::size_t lost = ring.read(400, out.data(), out.size());
+   ASSERT_EQ(lost, 100U);
+   const auto expected = makeSamples(500, 200);
+   EXPECT_TRUE(std::equal(expected.begin(), expected.end(), out.begin() + 100));
+}
+
+TEST(IqSnapshotRingTest, Cs16Storage_RoundTripsToSixteenBits)
+{
+   IqSnapshotRing ring;
+   ring.reset(4096, SnapshotStorage::Cs16);
+   append(ring, 3000);
+   append(ring, 3000);
+
+   std::vector<IqSample> out(2000);
+   ASSERT_EQ(ring.read(3500, out.data(), out.size()), 0U);
+   const auto expected = makeSamples(3500, 2000);
+   for (std::size_t k = 0; k < out.size(); ++k)
+   {
+      EXPECT_NEAR(out[k].real(), expected[k].real(), 1.0F / 32767.0F) << "k=" << k;
+      EXPECT_NEAR(out[k].imag(), expected[k].imag(), 1.0F / 32767.0F) << "k=" << k;
+   }
+}
+
+TEST(IqSnapshotRingTest, SampleAt_ExtrapolatesFromNewestAppend)
+{
+   IqSnapshotRing ring;
+   ring.reset(10'000, SnapshotStorage::Cf32);
+   const auto now = std::chrono::steady_clock::now();
+   append(ring, 8000, now);
+
+   // 1 kS/s: 2 s before the newest append is sample 6000.
+   EXPECT_EQ(ring.sampleAt(now - std::chrono::seconds(2), 1000.0), 6000U);
+   EXPECT_EQ(ring.sampleAt(now - std::chrono::seconds(60), 1000.0), 0U);   // Clamped.
+   EXPECT_EQ(ring.sampleAt(now + std::chrono::seconds(1), 1000.0), 8000U);
+}
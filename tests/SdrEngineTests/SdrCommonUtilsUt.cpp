@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 #include "SdrCommonUtils.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <numeric>
+#include <span>
 #include <vector>
 
 // ============================================================================
@@ -80,6 +83,24 @@ TEST(SdrCommonUtilsTest, DecimateSpectrum_DefaultMaxBins_Is2048)
    EXPECT_EQ(result.size(), 2048u);
 }
 
+TEST(SdrCommonUtilsTest, DecimateSpectrumInto_MatchesAllocatingVersion)
+{
+   std::vector<float> input(5003);
+   for (std::size_t i = 0; i < input.size(); ++i)
+   {
+      input[i] = std::sin(0.01F * static_cast<float>(i)) * 40.0F;
+   }
+   std::vector<float> out(2048, 1.0e9F);
+   EXPECT_EQ(SdrEngine::decimateSpectrum(input, out), out.size());
+   EXPECT_EQ(out, SdrEngine::decimateSpectrum(input, out.size()));
+
+   // A short input is copied to the front; the rest is left alone
+   const std::vector<float> shortInput = {-1.0F, -2.0F};
+   EXPECT_EQ(SdrEngine::decimateSpectrum(shortInput, out), 2U);
+   EXPECT_FLOAT_EQ(out[1], -2.0F);
+   EXPECT_EQ(SdrEngine::decimateSpectrum(input, std::span<float>{}), 0U);
+}
+
 TEST(SdrCommonUtilsTest, DecimateSpectrum_PreservesMaxInEachGroup)
 {
    // 6 bins → 3 bins: groups of 2.
@@ -95,3 +116,99 @@ TEST(SdrCommonUtilsTest, DecimateSpectrum_PreservesMaxInEachGroup)
    EXPECT_FLOAT_EQ(result[1], -40.0F);
    EXPECT_FLOAT_EQ(result[2], -10.0F);
 }
+
+TEST(SdrCommonUtilsTest, DecimateSpectrum_LargeGroups_MatchesScalarMax)
+{
+   // Groups of 37 exercise the vector body and the scalar tail.
+   std::vector<float> input(37 * 64);
+   for (std::size_t i = 0; i < input.size(); ++i)
+   {
+      input[i] = std::sin(0.1F * static_cast<float>(i)) * static_cast<float>(i % 29);
+   }
+   auto result = SdrEngine::decimateSpectrum(input, 64);
+   ASSERT_EQ(result.size(), 64u);
+   for (std::size_t g = 0; g < 64; ++g)
+   {
+      const auto first = input.begin() + static_cast<std::ptrdiff_t>(g * 37);
+      EXPECT_FLOAT_EQ(result[g], *std::max_element(first, first + 37)) << "group " << g;
+   }
+}
+
+// ============================================================================
+// Resolution pyramid
+// ============================================================================
+
+TEST(SdrCommonUtilsTest, BuildSpectrumPyramid_HalvesUntilMinPoints)
+{
+   SdrEngine::SpectrumData frame;
+   frame.magnitudesDb.resize(1024, -50.0F);
+   SdrEngine::buildSpectrumPyramid(frame, 256);
+
+   ASSERT_EQ(frame.tiers.size(), 2u);
+   EXPECT_EQ(frame.tiers[0].binsPerPoint, 2u);
+   EXPECT_EQ(frame.tiers[0].maxDb.size(), 512u);
+   EXPECT_EQ(frame.tiers[1].binsPerPoint, 4u);
+   EXPECT_EQ(frame.tiers[1].meanDb.size(), 256u);
+}
+
+TEST(SdrCommonUtilsTest, BuildSpectrumPyramid_TiersHoldMaxMinAndMean)
+{
+   SdrEngine::SpectrumData frame;
+   frame.magnitudesDb = {-10.0F, -30.0F, -20.0F, -40.0F, -5.0F};
+   SdrEngine::buildSpectrumPyramid(frame, 1);
+
+   ASSERT_EQ(frame.tiers.size(), 3u);
+   const auto& t0 = frame.tiers[0];
+   ASSERT_EQ(t0.maxDb.size(), 3u);   // Odd trailing bin kept as its own point.
+   EXPECT_FLOAT_EQ(t0.maxDb[0], -10.0F);
+   EXPECT_FLOAT_EQ(t0.minDb[1], -40.0F);
+   EXPECT_FLOAT_EQ(t0.meanDb[0], -20.0F);
+   EXPECT_FLOAT_EQ(t0.maxDb[2], -5.0F);
+
+   const auto& t1 = frame.tiers[1];
+   EXPECT_FLOAT_EQ(t1.maxDb[0], -10.0F);
+   EXPECT_FLOAT_EQ(t1.minDb[0], -40.0F);
+   EXPECT_FLOAT_EQ(t1.meanDb[0], -25.0F);
+   EXPECT_EQ(frame.tiers[2].maxDb.size(), 1u);
+   EXPECT_FLOAT_EQ(frame.tiers[2].maxDb[0], -5.0F);
+}
+
+TEST(SdrCommonUtilsTest, SelectSpectrumView_PicksFinestTierThatFits)
+{
+   SdrEngine::SpectrumData frame;
+   frame.magnitudesDb.resize(4096);
+   for (std::size_t i = 0; i < frame.magnitudesDb.size(); ++i)
+   {
+      frame.magnitudesDb[i] = static_cast<float>(i);
+   }
+   SdrEngine::buildSpectrumPyramid(frame, 256);
+
+   const auto full = SdrEngine::selectSpectrumView(frame, 0, 4096, 1024);
+   EXPECT_EQ(full.binsPerPoint, 4u);
+   EXPECT_EQ(full.maxDb.size(), 1024u);
+   EXPECT_EQ(full.maxDb.data(), frame.tiers[1].maxDb.data());   // No copy.
+
+   // A 100-bin region at bin 1001 fits at full resolution.
+   const auto region = SdrEngine::selectSpectrumView(frame, 1001, 100, 1024);
+   EXPECT_EQ(region.binsPerPoint, 1u);
+   EXPECT_EQ(region.firstBin, 1001u);
+   EXPECT_FLOAT_EQ(region.maxDb[0], 1001.0F);
+
+   // 900 bins into 256 points needs 4 bins per point; the range is widened
+   // to whole points.
+   const auto coarse = SdrEngine::selectSpectrumView(frame, 1001, 900, 256);
+   EXPECT_EQ(coarse.binsPerPoint, 4u);
+   EXPECT_EQ(coarse.firstBin, 1000u);
+   EXPECT_EQ(coarse.maxDb.size(), 226u);
+   EXPECT_FLOAT_EQ(coarse.maxDb[0], 1003.0F);
+   EXPECT_FLOAT_EQ(coarse.minDb[0], 1000.0F);
+}
+
+TEST(SdrCommonUtilsTest, SelectSpectrumView_NoPyramid_ReturnsFullResolution)
+{
+   SdrEngine::SpectrumData frame;
+   frame.magnitudesDb.resize(4096, -70.0F);
+   const auto view = SdrEngine::selectSpectrumView(frame, 0, 4096, 256);
+   EXPECT_EQ(view.binsPerPoint, 1u);
+   EXPECT_EQ(view.maxDb.size(), 4096u);
+}
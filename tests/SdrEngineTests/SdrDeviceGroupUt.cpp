@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "SdrDeviceGroup.h"
+#include "SyntheticSdrDevice.h"
+#include "ThreadConfig.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+using SdrEngine::SdrDeviceGroup;
+using SdrEngine::SpectrumData;
+using SdrEngine::SyntheticSdrDevice;
+using SdrEngine::SyntheticSignal;
+
+namespace
+{
+
+constexpr uint32_t RATE_HZ     = 1'024'000;
+constexpr std::size_t FFT_SIZE = 1024;   // 1 kHz per bin
+
+// A synthetic device carrying one tone `offsetHz` from its centre.
+std::unique_ptr<SyntheticSdrDevice> makeDevice(double offsetHz)
+{
+   auto device = std::make_unique<SyntheticSdrDevice>();
+   SyntheticSignal tone;
+   tone.offsetHz = offsetHz;
+   EXPECT_TRUE(device->setSignals({tone}));
+   EXPECT_TRUE(device->setNoiseLevel(0.001F));
+   return device;
+}
+
+void tune(SdrEngine::SdrEngine& engine, uint64_t centerHz)
+{
+   std::ignore = engine.setSampleRate(RATE_HZ);
+   std::ignore = engine.setCenterFrequency(centerHz);
+   engine.setFftSize(FFT_SIZE);
+}
+
+} // anonymous namespace
+
+TEST(SdrDeviceGroupTest, AddDevice_EachMemberGetsItsOwnEngine)
+{
+   SdrDeviceGroup group;
+   EXPECT_EQ(group.addDevice(makeDevice(0.0), 0), 0U);
+   EXPECT_EQ(group.addDevice(makeDevice(0.0), 1), 1U);
+   EXPECT_EQ(group.size(), 2U);
+   EXPECT_NE(&group.engine(0), &group.engine(1));
+   EXPECT_EQ(group.engine(1).getName(), "SdrEngine.dev1");
+   EXPECT_EQ(group.engine(1).spectrumDataHandler().name(), "SdrEngine.dev1.spectrum");
+   EXPECT_FALSE(group.isRunning());
+}
+
+TEST(SdrDeviceGroupTest, AddDevice_WithThreadSettings_PinsEveryRoleOfTheMember)
+{
+   auto& config = CommonUtils::ThreadConfig::instance();
+   config.clear();
+   CommonUtils::ThreadSettings pinned;
+   pinned.cpus = {0};
+   {
+      SdrDeviceGroup group;
+      std::ignore = group.addDevice(makeDevice(0.0), 0, pinned);
+      std::ignore = group.addDevice(makeDevice(0.0), 1);
+   }
+   EXPECT_EQ(config.settingsFor("SdrEngine.dev0.fft"), pinned);
+   EXPECT_EQ(config.settingsFor("SdrEngine.dev0.stream"), pinned);
+   EXPECT_EQ(config.settingsFor("DataHandler.SdrEngine.dev0.spectrum"), pinned);
+   EXPECT_FALSE(config.settingsFor("SdrEngine.dev1.fft").has_value());
+   config.clear();
+}
+
+TEST(SdrDeviceGroupTest, StartWithoutDevices_Fails)
+{
+   SdrDeviceGroup group;
+   EXPECT_FALSE(group.start());
+}
+
+TEST(SdrDeviceGroupTest, MergedSpectrum_JoinsAdjacentDevices)
+{
+   constexpr uint64_t LOWER_HZ = 100'000'000;
+   constexpr uint64_t UPPER_HZ = LOWER_HZ + RATE_HZ;   // Butts onto the lower band.
+
+   SdrDeviceGroup group;
+   std::ignore = group.addDevice(makeDevice(0.0), 0);
+   std::ignore = group.addDevice(makeDevice(200'000.0), 0);
+   tune(group.engine(0), LOWER_HZ);
+   tune(group.engine(1), UPPER_HZ);
+   group.setMergedSpectrumEnabled(true);
+
+   std::mutex mutex;
+   std::shared_ptr<const SpectrumData> latest;
+   std::atomic<int> frames{0};
+   const int id = group.mergedSpectrumDataHandler().registerListener(
+      [&](const std::shared_ptr<const SpectrumData>& data)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         latest = data;
+         ++frames;
+      });
+
+   ASSERT_TRUE(group.start());
+   EXPECT_TRUE(group.isRunning());
+   EXPECT_TRUE(group.engine(0).isRunning());
+   EXPECT_TRUE(group.engine(1).isRunning());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (frames < 4 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   group.stop();
+   group.mergedSpectrumDataHandler().unregisterListener(id);
+   EXPECT_FALSE(group.engine(0).isRunning());
+
+   const std::lock_guard<std::mutex> lock(mutex);
+   ASSERT_GE(frames.load(), 4);
+   EXPECT_GE(group.getMergedFrameCount(), 4U);
+   ASSERT_NE(latest, nullptr);
+   ASSERT_EQ(latest->magnitudesDb.size(), 2 * FFT_SIZE);
+   EXPECT_DOUBLE_EQ(latest->bandwidthHz, 2.0 * RATE_HZ);
+   EXPECT_DOUBLE_EQ(latest->centerFreqHz, static_cast<double>(UPPER_HZ) - (RATE_HZ / 2.0));
+
+   // The upper device's tone, at its absolute frequency in the merged trace.
+   const auto peak = static_cast<std::size_t>(
+      std::max_element(latest->magnitudesDb.begin() + FFT_SIZE, latest->magnitudesDb.end()) -
+      latest->magnitudesDb.begin());
+   EXPECT_NEAR(static_cast<double>(peak), (FFT_SIZE / 2) + FFT_SIZE + 200.0, 1.0);
+}
+
+TEST(SdrDeviceGroupTest, MergedSpectrumDisabled_PublishesNothing)
+{
+   SdrDeviceGroup group;
+   std::ignore = group.addDevice(makeDevice(0.0), 0);
+   tune(group.engine(0), 100'000'000);
+
+   std::atomic<int> merged{0};
+   std::atomic<int> spectra{0};
+   const int mergedId = group.mergedSpectrumDataHandler().registerListener(
+      [&merged](const std::shared_ptr<const SpectrumData>&) { ++merged; });
+   const int spectrumId = group.engine(0).spectrumDataHandler().registerListener(
+      [&spectra](const std::shared_ptr<const SpectrumData>&) { ++spectra; });
+
+   ASSERT_TRUE(group.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (spectra < 4 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   group.stop();
+   group.mergedSpectrumDataHandler().unregisterListener(mergedId);
+   group.engine(0).spectrumDataHandler().unregisterListener(spectrumId);
+
+   EXPECT_GE(spectra.load(), 4);
+   EXPECT_EQ(merged.load(), 0);
+   EXPECT_EQ(group.getMergedFrameCount(), 0U);
+}
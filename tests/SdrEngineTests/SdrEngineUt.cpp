@@ -3,7 +3,219 @@
 #include "SoapySdrDevice.h"
 #include "SdrTypes.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+/**
+ * Minimal ISdrDevice that delivers a fixed number of samples synchronously
+ * from startStreaming(), so engine tests run without hardware.
+ */
+class FakeSdrDevice : public SdrEngine::ISdrDevice
+{
+public:
+   explicit FakeSdrDevice(std::size_t totalSamples) : _totalSamples{totalSamples} {}
+
+   bool open(int /*deviceIndex*/) override { _open = true; return true; }
+   void close() override { _open = false; }
+   [[nodiscard]] bool isOpen() const override { return _open; }
+
+   bool setCenterFrequency(uint64_t frequencyHz) override { _freq = frequencyHz; return true; }
+   [[nodiscard]] uint64_t getCenterFrequency() const override { return _freq; }
+   bool setSampleRate(uint32_t rateHz) override { _rate = rateHz; return true; }
+   [[nodiscard]] uint32_t getSampleRate() const override { return _rate; }
+
+   bool setAutoGain(bool /*enabled*/) override { return true; }
+   bool setGain(int /*tenthsDb*/) override { return true; }
+   [[nodiscard]] int getGain() const override { return 0; }
+   [[nodiscard]] std::vector<int> getGainValues() const override { return {}; }
+
+   bool startStreaming(SdrEngine::IqCallback callback, std::size_t bufferSize) override
+   {
+      const std::vector<SdrEngine::IqSample> chunk(bufferSize, {0.5F, -0.25F});
+      for (std::size_t sent = 0; sent < _totalSamples; sent += bufferSize)
+      {
+         callback(chunk.data(), std::min(bufferSize, _totalSamples - sent));
+      }
+      _streaming = true;
+      return true;
+   }
+   void stopStreaming() override { _streaming = false; }
+   [[nodiscard]] bool isStreaming() const override { return _streaming; }
+
+   [[nodiscard]] std::string getName() const override { return "Fake"; }
+   [[nodiscard]] std::vector<SdrEngine::DeviceInfo> enumerateDevices() const override
+   {
+      return {};
+   }
+
+private:
+   std::size_t _totalSamples;
+   bool _open{false};
+   bool _streaming{false};
+   uint64_t _freq{0};
+   uint32_t _rate{0};
+};
+
+// Fake device that streams native CS8 blocks: I alternates ±64, Q is 0.
+class FakeCs8SdrDevice : public FakeSdrDevice
+{
+public:
+   using FakeSdrDevice::FakeSdrDevice;
+
+   bool startRawStreaming(SdrEngine::RawIqCallback callback, std::size_t bufferSize) override
+   {
+      std::vector<int8_t> chunk(2 * bufferSize, 0);
+      for (std::size_t i = 0; i < bufferSize; ++i)
+      {
+         chunk[2 * i] = (i % 2 == 0) ? int8_t{64} : int8_t{-64};
+      }
+      callback(SdrEngine::RawIqBlock{chunk.data(), SdrEngine::IqSampleFormat::CS8,
+                                     bufferSize, 128.0F});
+      return FakeSdrDevice::startStreaming([](const SdrEngine::IqSample*, std::size_t) {}, 0);
+   }
+};
+
+// Fake device that streams continuously from its own thread, as hardware
+// does.  It "receives" one tone at a fixed absolute frequency, so the
+// baseband offset follows every retune; like a real anti-alias filter it
+// passes the tone only within ±0.45 fs of the tuned frequency.
+class FakeToneSdrDevice : public FakeSdrDevice
+{
+public:
+   static constexpr double RATE_HZ = 1.0e6;
+
+   explicit FakeToneSdrDevice(uint64_t toneHz) : FakeSdrDevice{0}, _toneHz{toneHz} {}
+   ~FakeToneSdrDevice() override { stopStreaming(); }
+
+   FakeToneSdrDevice(const FakeToneSdrDevice&) = delete;
+   FakeToneSdrDevice& operator=(const FakeToneSdrDevice&) = delete;
+   FakeToneSdrDevice(FakeToneSdrDevice&&) = delete;
+   FakeToneSdrDevice& operator=(FakeToneSdrDevice&&) = delete;
+
+   bool setCenterFrequency(uint64_t frequencyHz) override
+   {
+      _tunedHz = frequencyHz;
+      return true;
+   }
+
+   bool startStreaming(SdrEngine::IqCallback callback, std::size_t bufferSize) override
+   {
+      _stop   = false;
+      _thread = std::thread([this, callback, bufferSize]
+      {
+         std::vector<SdrEngine::IqSample> chunk(bufferSize);
+         double phase = 0.0;
+         while (!_stop)
+         {
+            const double offsetHz = static_cast<double>(_toneHz) -
+                                    static_cast<double>(_tunedHz.load());
+            const double step = 2.0 * 3.14159265358979 * offsetHz / RATE_HZ;
+            const float level = (std::abs(offsetHz) < 0.45 * RATE_HZ) ? 1.0F : 0.0F;
+            for (auto& sample : chunk)
+            {
+               sample = {level * static_cast<float>(std::cos(phase)),
+                         level * static_cast<float>(std::sin(phase))};
+               phase = std::fmod(phase + step, 2.0 * 3.14159265358979);
+            }
+            callback(chunk.data(), chunk.size());
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+         }
+      });
+      return true;
+   }
+
+   void stopStreaming() override
+   {
+      _stop = true;
+      if (_thread.joinable())
+      {
+         _thread.join();
+      }
+   }
+
+   [[nodiscard]] bool isStreaming() const override { return _thread.joinable(); }
+
+private:
+   uint64_t _toneHz;
+   std::atomic<uint64_t> _tunedHz{0};
+   std::atomic<bool> _stop{false};
+   std::thread _thread;
+};
+
+// Start the engine on `device` and return the first raw I/Q frame it publishes.
+std::vector<SdrEngine::IqSample> firstIqFrame(SdrEngine::SdrEngine& engine,
+                                              std::unique_ptr<SdrEngine::ISdrDevice> device)
+{
+   std::atomic<bool> received{false};
+   std::vector<SdrEngine::IqSample> first;
+   const int id = engine.iqDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::IqBuffer>& buf)
+      {
+         if (!received.load())
+         {
+            first = buf->samples;
+            received.store(true);
+         }
+      });
+
+   engine.setDevice(std::move(device));
+   EXPECT_TRUE(engine.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (!received.load() && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+   engine.iqDataHandler().unregisterListener(id);
+   return received.load() ? first : std::vector<SdrEngine::IqSample>{};
+}
+
+// Stream `totalSamples` through a started engine and count SpectrumData frames.
+int countSpectrumFrames(SdrEngine::SdrEngine& engine, std::size_t totalSamples,
+                        int expectedFrames)
+{
+   // Count every frame the pipeline produces, however far the listener lags.
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::Spectrum,
+                           CommonUtils::OverflowPolicy::Unbounded);
+   std::atomic<int> frames{0};
+   const int id = engine.spectrumDataHandler().registerListener(
+      [&frames](const std::shared_ptr<const SdrEngine::SpectrumData>&) { ++frames; });
+
+   engine.setDevice(std::make_unique<FakeSdrDevice>(totalSamples));
+   EXPECT_TRUE(engine.start());
+
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (frames < expectedFrames && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   // Give any surplus frames a chance to show up before counting.
+   std::this_thread::sleep_for(std::chrono::milliseconds(50));
+   engine.stop();
+   engine.spectrumDataHandler().unregisterListener(id);
+   return frames;
+}
+
+} // anonymous namespace
 
 // ============================================================================
 // Construction & defaults
@@ -66,6 +278,552 @@ TEST(SdrEngineTest, SetWindowFunction_ChangesFunction)
    EXPECT_EQ(engine.getWindowFunction(), SdrEngine::WindowFunction::Hanning);
 }
 
+TEST(SdrEngineTest, SetFftOverlapPercent_ClampsToRange)
+{
+   SdrEngine::SdrEngine engine;
+   EXPECT_FLOAT_EQ(engine.getFftOverlapPercent(), 0.0F);
+   engine.setFftOverlapPercent(50.0F);
+   EXPECT_FLOAT_EQ(engine.getFftOverlapPercent(), 50.0F);
+   engine.setFftOverlapPercent(150.0F);
+   EXPECT_FLOAT_EQ(engine.getFftOverlapPercent(), SdrEngine::SdrEngine::MAX_FFT_OVERLAP_PERCENT);
+   engine.setFftOverlapPercent(-5.0F);
+   EXPECT_FLOAT_EQ(engine.getFftOverlapPercent(), 0.0F);
+}
+
+TEST(SdrEngineTest, SetFftOverlapPercent_NonFiniteIsIgnored)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftOverlapPercent(50.0F);
+   engine.setFftOverlapPercent(std::numeric_limits<float>::quiet_NaN());
+   EXPECT_FLOAT_EQ(engine.getFftOverlapPercent(), 50.0F);
+   engine.setFftOverlapPercent(std::numeric_limits<float>::infinity());
+   EXPECT_FLOAT_EQ(engine.getFftOverlapPercent(), 50.0F);
+}
+
+TEST(SdrEngineTest, SetSpectrumOutputRate_NegativeBecomesZero)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setSpectrumOutputRate(30.0F);
+   EXPECT_FLOAT_EQ(engine.getSpectrumOutputRate(), 30.0F);
+   engine.setSpectrumOutputRate(-1.0F);
+   EXPECT_FLOAT_EQ(engine.getSpectrumOutputRate(), 0.0F);
+}
+
+TEST(SdrEngineTest, SetDcBlockerTimeConstant_ClampsToMinimum)
+{
+   SdrEngine::SdrEngine engine;
+   EXPECT_FLOAT_EQ(engine.getDcBlockerTimeConstant(),
+                   SdrEngine::SdrEngine::DEFAULT_DC_TIME_CONSTANT_S);
+   engine.setDcBlockerTimeConstant(0.05F);
+   EXPECT_FLOAT_EQ(engine.getDcBlockerTimeConstant(), 0.05F);
+   engine.setDcBlockerTimeConstant(0.0F);
+   EXPECT_FLOAT_EQ(engine.getDcBlockerTimeConstant(),
+                   SdrEngine::SdrEngine::MIN_DC_TIME_CONSTANT_S);
+}
+
+// ============================================================================
+// Welch framing
+// ============================================================================
+
+TEST(SdrEngineTest, NoOverlapNoRate_PublishesEveryFftFrame)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   engine.setSampleRate(256'000);
+   EXPECT_EQ(countSpectrumFrames(engine, 256 * 10, 10), 10);
+}
+
+TEST(SdrEngineTest, OverlapWithOutputRate_AveragesDownToTargetRate)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   engine.setSampleRate(256'000);
+   engine.setFftOverlapPercent(50.0F);    // hop = 128
+   engine.setSpectrumOutputRate(100.0F);  // publish every 2560 samples
+
+   // 100 blocks → 199 segments → 199 * 128 / 2560 = 9 full output frames.
+   EXPECT_EQ(countSpectrumFrames(engine, 256 * 100, 9), 9);
+}
+
+TEST(SdrEngineTest, PipelineStats_CountFramesPerStage)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   std::ignore = countSpectrumFrames(engine, 256 * 10, 10);
+
+   const auto stats = engine.getPipelineStats();
+   EXPECT_EQ(stats.conditioning.frames, 10U);
+   EXPECT_EQ(stats.fft.frames, 10U);
+   EXPECT_EQ(stats.channelFilter.frames, 0U);   // Filter disabled by default.
+   EXPECT_GT(stats.fft.busyNs, 0U);
+   EXPECT_GE(stats.fft.busyNs, stats.fft.maxFrameNs);
+   EXPECT_LE(stats.fft.queueHighWater, 8U);
+}
+
+TEST(SdrEngineTest, RawCs8Stream_ConvertedIntoIqFrames)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+
+   const auto first = firstIqFrame(engine, std::make_unique<FakeCs8SdrDevice>(0));
+   ASSERT_EQ(first.size(), 256U);
+   // The DC blocker has barely moved after two samples of a zero-mean tone.
+   EXPECT_NEAR(first[0].real(), 0.5F, 1.0e-3F);
+   EXPECT_NEAR(first[1].real(), -0.5F, 1.0e-3F);
+   EXPECT_FLOAT_EQ(first[1].imag(), 0.0F);
+}
+
+TEST(SdrEngineTest, RawCs8Stream_Cs16Ring_ConvertedOnConditioning)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   engine.setSampleRingStorage(SdrEngine::IqStorage::Cs16);
+   EXPECT_EQ(engine.getSampleRingStorage(), SdrEngine::IqStorage::Cs16);
+
+   // Same frames as the float ring: native scale kept, DC blocked after the ring.
+   const auto first = firstIqFrame(engine, std::make_unique<FakeCs8SdrDevice>(0));
+   ASSERT_EQ(first.size(), 256U);
+   EXPECT_NEAR(first[0].real(), 0.5F, 1.0e-3F);
+   EXPECT_NEAR(first[1].real(), -0.5F, 1.0e-3F);
+   EXPECT_FLOAT_EQ(first[1].imag(), 0.0F);
+}
+
+TEST(SdrEngineTest, ConfigureChannelizer_RejectsInvalidChannelCount)
+{
+   SdrEngine::SdrEngine engine;
+   EXPECT_FALSE(engine.configureChannelizer(1));
+   EXPECT_EQ(engine.getChannelizerChannelCount(), 0U);
+   EXPECT_TRUE(engine.configureChannelizer(8));
+   EXPECT_EQ(engine.getChannelizerChannelCount(), 8U);
+   EXPECT_THROW(std::ignore = engine.channelizerDataHandler(8), std::out_of_range);
+}
+
+TEST(SdrEngineTest, Channelizer_PublishesEveryChannelOnItsOwnHandler)
+{
+   constexpr std::size_t CHANNELS = 4;
+   constexpr std::size_t TOTAL    = 256 * 10;
+
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   ASSERT_TRUE(engine.configureChannelizer(CHANNELS));
+   engine.setChannelizerEnabled(true);
+
+   std::array<std::atomic<std::size_t>, CHANNELS> samples{};
+   std::array<std::atomic<bool>, CHANNELS> metadataOk{};
+   std::array<int, CHANNELS> ids{};
+   for (std::size_t c = 0; c < CHANNELS; ++c)
+   {
+      metadataOk[c] = true;
+      const double expectedCenter = 100.0e6 + ((static_cast<double>(c) - 2.0) * 600.0e3);
+      ids[c] = engine.channelizerDataHandler(c).registerListener(
+         [&, c, expectedCenter](const std::shared_ptr<const SdrEngine::IqBuffer>& buf)
+         {
+            samples[c] += buf->samples.size();
+            if (buf->sampleRateHz != 600.0e3 || buf->centerFreqHz != expectedCenter)
+            {
+               metadataOk[c] = false;
+            }
+         });
+   }
+
+   engine.setDevice(std::make_unique<FakeSdrDevice>(TOTAL));
+   ASSERT_TRUE(engine.start());
+   const auto allReceived = [&]
+   {
+      return std::all_of(samples.begin(), samples.end(),
+                         [](const auto& n) { return n.load() >= TOTAL / CHANNELS; });
+   };
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (!allReceived() && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+   for (std::size_t c = 0; c < CHANNELS; ++c)
+   {
+      engine.channelizerDataHandler(c).unregisterListener(ids[c]);
+      EXPECT_EQ(samples[c].load(), TOTAL / CHANNELS) << "channel " << c;
+      EXPECT_TRUE(metadataOk[c].load()) << "channel " << c;
+   }
+   EXPECT_EQ(engine.getPipelineStats().channelizer.frames, 10U);
+}
+
+TEST(SdrEngineTest, AddRemoveVfo_TracksIds)
+{
+   SdrEngine::SdrEngine engine;
+   const int a = engine.addVfo(-100'000.0, 50'000.0);
+   const int b = engine.addVfo(200'000.0, 100'000.0);
+   EXPECT_NE(a, b);
+   EXPECT_EQ(engine.getVfoCount(), 2U);
+   EXPECT_EQ(engine.vfoIds(), (std::vector<int>{a, b}));
+   ASSERT_NE(engine.vfo(b), nullptr);
+   EXPECT_DOUBLE_EQ(engine.vfo(b)->getCenterOffset(), 200'000.0);
+
+   EXPECT_TRUE(engine.removeVfo(a));
+   EXPECT_FALSE(engine.removeVfo(a));
+   EXPECT_EQ(engine.vfo(a), nullptr);
+   EXPECT_EQ(engine.getVfoCount(), 1U);
+}
+
+TEST(SdrEngineTest, Vfos_EachPublishOnTheirOwnHandler)
+{
+   constexpr std::size_t TOTAL = 240 * 10;
+
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(240);
+   const std::array<int, 3> ids{engine.addVfo(-600'000.0, 200'000.0),
+                                engine.addVfo(0.0, 400'000.0),
+                                engine.addVfo(600'000.0, 200'000.0)};
+   const std::array<std::size_t, 3> expected{TOTAL / 12, TOTAL / 6, TOTAL / 12};
+
+   std::array<std::atomic<std::size_t>, 3> samples{};
+   std::array<int, 3> listeners{};
+   for (std::size_t v = 0; v < ids.size(); ++v)
+   {
+      listeners[v] = engine.vfo(ids[v])->iqDataHandler().registerListener(
+         [&samples, v](const std::shared_ptr<const SdrEngine::IqBuffer>& buf)
+         { samples[v] += buf->samples.size(); });
+   }
+
+   engine.setDevice(std::make_unique<FakeSdrDevice>(TOTAL));
+   ASSERT_TRUE(engine.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (std::chrono::steady_clock::now() < deadline &&
+          !(samples[0] >= expected[0] && samples[1] >= expected[1] && samples[2] >= expected[2]))
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+
+   for (std::size_t v = 0; v < ids.size(); ++v)
+   {
+      engine.vfo(ids[v])->iqDataHandler().unregisterListener(listeners[v]);
+      EXPECT_EQ(samples[v].load(), expected[v]) << "VFO " << v;
+   }
+   EXPECT_EQ(engine.getPipelineStats().vfos.frames, 10U);
+}
+
+// ============================================================================
+// Wideband sweep
+// ============================================================================
+
+TEST(SdrEngineTest, ConfigureSweep_RejectsEmptyRange)
+{
+   SdrEngine::SdrEngine engine;
+   SdrEngine::SweepConfig config;
+   config.startHz = 100'000'000;
+   config.stopHz  = 100'000'000;
+   EXPECT_FALSE(engine.configureSweep(config));
+}
+
+TEST(SdrEngineTest, StartSweep_WithoutConfiguration_Fails)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setSweepEnabled(true);
+   engine.setDevice(std::make_unique<FakeSdrDevice>(0));
+   EXPECT_FALSE(engine.start());
+}
+
+TEST(SdrEngineTest, Sweep_StitchesToneAtItsAbsoluteFrequency)
+{
+   constexpr uint64_t START_HZ = 100'000'000;
+   constexpr uint64_t TONE_HZ  = 101'900'000;
+
+   SdrEngine::SdrEngine engine;
+   std::ignore = engine.setSampleRate(1'000'000);
+   engine.setFftSize(256);
+   SdrEngine::SweepConfig config;
+   config.startHz       = START_HZ;
+   config.stopHz        = 103'000'000;
+   config.settleTimeSec = 0.002;
+   config.averages      = 2;
+   ASSERT_TRUE(engine.configureSweep(config));
+   ASSERT_EQ(engine.sweep().getStepCount(), 4U);
+   engine.setSweepEnabled(true);
+
+   std::mutex mutex;
+   std::shared_ptr<const SdrEngine::SpectrumData> pass;
+   const int id = engine.sweepDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::SpectrumData>& data)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         pass = data;
+      });
+
+   engine.setDevice(std::make_unique<FakeToneSdrDevice>(TONE_HZ));
+   ASSERT_TRUE(engine.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (engine.getSweepStats().passes < 2 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+   engine.sweepDataHandler().unregisterListener(id);
+
+   const auto stats = engine.getSweepStats();
+   EXPECT_GE(stats.passes, 2U);
+   EXPECT_EQ(stats.stepsPerPass, 4U);
+   EXPECT_GT(stats.meanPassSec, 0.0);
+
+   const std::lock_guard<std::mutex> lock(mutex);
+   ASSERT_NE(pass, nullptr);
+   ASSERT_EQ(pass->magnitudesDb.size(), 768U);
+   EXPECT_DOUBLE_EQ(pass->bandwidthHz, 3.0e6);
+   const auto peak = static_cast<std::size_t>(
+      std::max_element(pass->magnitudesDb.begin(), pass->magnitudesDb.end()) -
+      pass->magnitudesDb.begin());
+   const double binHz = pass->bandwidthHz / static_cast<double>(pass->magnitudesDb.size());
+   EXPECT_NEAR(static_cast<double>(START_HZ) + (static_cast<double>(peak) * binHz),
+               static_cast<double>(TONE_HZ), 2.0 * binHz);
+}
+
+// ============================================================================
+// Zoom FFT
+// ============================================================================
+
+TEST(SdrEngineTest, ZoomFft_ResolvesToneInsideFilteredChannel)
+{
+   constexpr double CHANNEL_HZ = 100'100'000.0;
+   constexpr uint64_t TONE_HZ  = 100'102'500;   // 32 zoom bins above the channel centre
+
+   SdrEngine::SdrEngine engine;
+   std::ignore = engine.setSampleRate(1'000'000);
+   engine.setFftSize(256);
+   engine.configureChannelFilter(100.0e3, 20.0e3);   // Decimate by 50 to 20 kHz.
+   engine.setChannelFilterEnabled(true);
+   engine.setZoomFftSize(256);                       // 78.125 Hz per bin.
+   engine.setZoomFftEnabled(true);
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::ZoomSpectrum,
+                           CommonUtils::OverflowPolicy::Unbounded);
+
+   std::mutex mutex;
+   std::shared_ptr<const SdrEngine::SpectrumData> latest;
+   std::atomic<int> frames{0};
+   const int id = engine.zoomSpectrumDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::SpectrumData>& data)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         latest = data;
+         ++frames;
+      });
+
+   engine.setDevice(std::make_unique<FakeToneSdrDevice>(TONE_HZ));
+   ASSERT_TRUE(engine.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (frames < 4 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+   engine.zoomSpectrumDataHandler().unregisterListener(id);
+
+   const std::lock_guard<std::mutex> lock(mutex);
+   ASSERT_GE(frames.load(), 4);
+   ASSERT_NE(latest, nullptr);
+   EXPECT_EQ(latest->fftSize, 256U);
+   ASSERT_EQ(latest->magnitudesDb.size(), 256U);
+   EXPECT_DOUBLE_EQ(latest->centerFreqHz, CHANNEL_HZ);
+   EXPECT_DOUBLE_EQ(latest->bandwidthHz, 20.0e3);
+   const auto peak = static_cast<std::size_t>(
+      std::max_element(latest->magnitudesDb.begin(), latest->magnitudesDb.end()) -
+      latest->magnitudesDb.begin());
+   EXPECT_NEAR(static_cast<double>(peak), 160.0, 1.0);
+}
+
+TEST(SdrEngineTest, ZoomFft_Disabled_PublishesNothing)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   engine.configureChannelFilter(100.0e3, 20.0e3);
+   engine.setChannelFilterEnabled(true);
+   EXPECT_FALSE(engine.isZoomFftEnabled());
+   EXPECT_EQ(engine.getZoomFftSize(), SdrEngine::SdrEngine::DEFAULT_ZOOM_FFT_SIZE);
+
+   std::atomic<int> frames{0};
+   const int id = engine.zoomSpectrumDataHandler().registerListener(
+      [&frames](const std::shared_ptr<const SdrEngine::SpectrumData>&) { ++frames; });
+   std::ignore = countSpectrumFrames(engine, 256 * 10, 10);
+   engine.zoomSpectrumDataHandler().unregisterListener(id);
+
+   EXPECT_EQ(engine.getPipelineStats().channelFilter.frames, 10U);
+   EXPECT_EQ(frames.load(), 0);
+}
+
+// ============================================================================
+// Signal detector
+// ============================================================================
+
+TEST(SdrEngineTest, Detector_ReportsToneAsEvent)
+{
+   constexpr uint64_t TONE_HZ = 100'250'000;   // Bin 64 above the centre.
+
+   SdrEngine::SdrEngine engine;
+   std::ignore = engine.setSampleRate(1'000'000);
+   engine.setFftSize(256);
+   SdrEngine::DetectorConfig config;
+   config.referenceBins = 16;
+   engine.setDetectorConfig(config);
+   EXPECT_EQ(engine.getDetectorConfig().referenceBins, 16U);
+   engine.setDetectorEnabled(true);
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::Detections,
+                           CommonUtils::OverflowPolicy::Unbounded);
+
+   std::mutex mutex;
+   std::vector<SdrEngine::SignalEvent> started;
+   const int id = engine.detectionDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::DetectionReport>& report)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         for (const auto& event : report->events)
+         {
+            if (event.state == SdrEngine::SignalEventState::Started)
+            {
+               started.push_back(event);
+            }
+         }
+      });
+
+   const auto toneStarted = [&]
+   {
+      const std::lock_guard<std::mutex> lock(mutex);
+      return std::any_of(started.begin(), started.end(), [](const auto& event)
+                         { return std::abs(event.peakHz - static_cast<double>(TONE_HZ)) < 5'000.0; });
+   };
+
+   engine.setDevice(std::make_unique<FakeToneSdrDevice>(TONE_HZ));
+   ASSERT_TRUE(engine.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (!toneStarted() && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+   engine.detectionDataHandler().unregisterListener(id);
+
+   EXPECT_TRUE(toneStarted());
+   EXPECT_GT(engine.getPipelineStats().detector.frames, 0U);
+}
+
+TEST(SdrEngineTest, Detector_Disabled_PublishesNothing)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   EXPECT_FALSE(engine.isDetectorEnabled());
+
+   std::atomic<int> reports{0};
+   const int id = engine.detectionDataHandler().registerListener(
+      [&reports](const std::shared_ptr<const SdrEngine::DetectionReport>&) { ++reports; });
+   std::ignore = countSpectrumFrames(engine, 256 * 10, 10);
+   engine.detectionDataHandler().unregisterListener(id);
+
+   EXPECT_EQ(engine.getPipelineStats().detector.frames, 0U);
+   EXPECT_EQ(reports.load(), 0);
+}
+
+// ============================================================================
+// Display tap
+// ============================================================================
+
+TEST(SdrEngineTest, DisplayTap_DecimatesToBudget)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   std::ignore = engine.setSampleRate(256'000);
+   SdrEngine::DisplayTapConfig config;
+   config.samplesPerSec = 12'800.0;   // Every 20th sample.
+   config.framesPerSec  = 100.0;      // 128 samples per frame.
+   engine.setDisplayTapConfig(config);
+   engine.setDisplayTapEnabled(true);
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::DisplayIq,
+                           CommonUtils::OverflowPolicy::Unbounded);
+
+   std::atomic<std::size_t> samples{0};
+   std::atomic<int> frames{0};
+   std::atomic<bool> rateOk{true};
+   const int id = engine.displayIqDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::IqBuffer>& frame)
+      {
+         samples += frame->samples.size();
+         ++frames;
+         rateOk = rateOk && frame->sampleRateHz == 12'800.0;
+      });
+
+   // 0.1 s of stream: 25600 samples, of which 1280 kept.
+   std::ignore = countSpectrumFrames(engine, 256 * 100, 100);
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (frames < 9 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.displayIqDataHandler().unregisterListener(id);
+
+   EXPECT_TRUE(rateOk.load());
+   EXPECT_GE(frames.load(), 9);
+   EXPECT_LE(frames.load(), 10);
+   EXPECT_GT(samples.load(), 1'100U);
+   EXPECT_LE(samples.load(), 1'280U);
+   EXPECT_EQ(engine.getPublishStats().displayIq.dropped, 0U);
+}
+
+TEST(SdrEngineTest, DisplayTap_Disabled_PublishesNothing)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   EXPECT_FALSE(engine.isDisplayTapEnabled());
+
+   std::atomic<int> frames{0};
+   const int id = engine.displayIqDataHandler().registerListener(
+      [&frames](const std::shared_ptr<const SdrEngine::IqBuffer>&) { ++frames; });
+   std::ignore = countSpectrumFrames(engine, 256 * 10, 10);
+   engine.displayIqDataHandler().unregisterListener(id);
+
+   EXPECT_EQ(frames.load(), 0);
+}
+
+// ============================================================================
+// Pre-trigger snapshots
+// ============================================================================
+
+TEST(SdrEngineTest, Snapshot_WritesWindowAroundTrigger)
+{
+   SdrEngine::SdrEngine engine;
+   std::ignore = engine.setSampleRate(1'000'000);
+   engine.setFftSize(256);
+   engine.configureSnapshots(0.1, SdrEngine::SnapshotStorage::Cs16);
+   EXPECT_DOUBLE_EQ(engine.getSnapshotHistorySec(), 0.1);
+
+   SdrEngine::SnapshotRequest request;
+   request.path    = ::testing::TempDir() + "snapshot.cf32";
+   request.format  = SdrEngine::RecordingFormat::Raw;
+   request.preSec  = 0.01;   // 10000 samples each side.
+   request.postSec = 0.01;
+   EXPECT_FALSE(engine.triggerSnapshot(request));   // Not running.
+
+   engine.setDevice(std::make_unique<FakeToneSdrDevice>(100'100'000));
+   ASSERT_TRUE(engine.start());
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (engine.getPipelineStats().conditioning.frames < 100 &&
+          std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   ASSERT_TRUE(engine.triggerSnapshot(request));
+   deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (engine.getSnapshotStats().completed < 1 && std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   engine.stop();
+
+   const auto stats = engine.getSnapshotStats();
+   EXPECT_EQ(stats.triggered, 1U);
+   EXPECT_EQ(stats.completed, 1U);
+   EXPECT_EQ(stats.samplesWritten, 20'000U);
+   EXPECT_EQ(stats.samplesLost, 0U);
+   std::ifstream file(request.path, std::ios::binary | std::ios::ate);
+   EXPECT_EQ(static_cast<std::size_t>(file.tellg()), 20'000U * sizeof(SdrEngine::IqSample));
+}
+
 // ============================================================================
 // Device management
 // ============================================================================
@@ -84,6 +842,169 @@ TEST(SdrEngineTest, StartWithoutDevice_ReturnsFalse)
    EXPECT_FALSE(engine.isRunning());
 }
 
+// ============================================================================
+// Publisher backpressure
+// ============================================================================
+
+TEST(SdrEngineTest, DefaultPublishPolicies_AreBounded)
+{
+   using CommonUtils::OverflowPolicy;
+   SdrEngine::SdrEngine engine;
+   EXPECT_EQ(engine.spectrumDataHandler().overflowPolicy(), OverflowPolicy::DropOldest);
+   EXPECT_EQ(engine.sweepDataHandler().overflowPolicy(), OverflowPolicy::LatestOnly);
+   EXPECT_EQ(engine.iqDataHandler().overflowPolicy(), OverflowPolicy::DropOldest);
+   EXPECT_EQ(engine.filteredIqDataHandler().overflowPolicy(), OverflowPolicy::DropOldest);
+   EXPECT_EQ(engine.zoomSpectrumDataHandler().overflowPolicy(), OverflowPolicy::DropOldest);
+   EXPECT_EQ(engine.displayIqDataHandler().overflowPolicy(), OverflowPolicy::DropOldest);
+}
+
+TEST(SdrEngineTest, SetPublishPolicy_Channelizer_AppliesToEveryChannel)
+{
+   using CommonUtils::OverflowPolicy;
+   SdrEngine::SdrEngine engine;
+   ASSERT_TRUE(engine.configureChannelizer(2));
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::Channelizer, OverflowPolicy::LatestOnly);
+   EXPECT_EQ(engine.channelizerDataHandler(1).overflowPolicy(), OverflowPolicy::LatestOnly);
+
+   // Channels added later inherit the policy.
+   ASSERT_TRUE(engine.configureChannelizer(4));
+   EXPECT_EQ(engine.channelizerDataHandler(3).overflowPolicy(), OverflowPolicy::LatestOnly);
+}
+
+TEST(SdrEngineTest, StalledListener_DropsFramesWithoutStallingPipeline)
+{
+   constexpr std::size_t FRAMES = 20;
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::Iq, CommonUtils::OverflowPolicy::LatestOnly);
+
+   // The raw I/Q listener blocks on its first frame until released.
+   std::mutex mtx;
+   std::condition_variable cv;
+   bool released = false;
+   std::atomic<std::size_t> received{0};
+   const int id = engine.iqDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::IqBuffer>&)
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         cv.wait(lock, [&] { return released; });
+         ++received;
+      });
+
+   engine.setDevice(std::make_unique<FakeSdrDevice>(256 * FRAMES));
+   ASSERT_TRUE(engine.start());
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+   while (engine.getPipelineStats().fft.frames < FRAMES &&
+          std::chrono::steady_clock::now() < deadline)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+   }
+   EXPECT_EQ(engine.getPipelineStats().fft.frames, FRAMES);
+
+   {
+      const std::lock_guard<std::mutex> lock(mtx);
+      released = true;
+   }
+   cv.notify_all();
+   engine.stop();
+
+   // One frame was in the listener, one queued behind it; the rest dropped.
+   const auto stats = engine.getPublishStats();
+   EXPECT_EQ(stats.iq.dropped, FRAMES - 2);
+   EXPECT_EQ(stats.iq.queueHighWater, 1U);
+   engine.iqDataHandler().unregisterListener(id);
+}
+
+TEST(SdrEngineTest, HealthStats_CombineDeviceRingAndPublisherCounters)
+{
+   // A device that reports driver overflows through its stream counters.
+   class OverflowingDevice : public FakeSdrDevice
+   {
+   public:
+      using FakeSdrDevice::FakeSdrDevice;
+      [[nodiscard]] SdrEngine::DeviceStreamStats getStreamStats() const override
+      {
+         SdrEngine::DeviceStreamStats stats;
+         stats.samplesReceived = 4096;
+         stats.reads           = 2;
+         stats.overflows       = 3;
+         return stats;
+      }
+   };
+
+   SdrEngine::SdrEngine engine;
+   EXPECT_FALSE(engine.getHealthStats().hasSampleLoss());
+
+   engine.setFftSize(256);
+   engine.setDevice(std::make_unique<OverflowingDevice>(256 * 2));
+   ASSERT_TRUE(engine.start());
+   engine.stop();
+
+   const auto health = engine.getHealthStats();
+   EXPECT_EQ(health.device.overflows, 3U);
+   EXPECT_DOUBLE_EQ(health.device.averageReadSize(), 2048.0);
+   EXPECT_EQ(health.ringOverflowSamples, engine.getOverflowCount());
+   EXPECT_TRUE(health.hasSampleLoss());
+   engine.logHealthStats();
+}
+
+// ============================================================================
+// Latency tracing
+// ============================================================================
+
+TEST(SdrEngineTest, LatencyTracingDisabled_FramesAreUntraced)
+{
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   EXPECT_FALSE(engine.isLatencyTracingEnabled());
+
+   std::atomic<bool> anyTraced{false};
+   const int id = engine.iqDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::IqBuffer>& buf)
+      {
+         anyTraced = anyTraced || buf->stages.isTraced();
+      });
+   std::ignore = countSpectrumFrames(engine, 256 * 4, 4);
+   engine.iqDataHandler().unregisterListener(id);
+
+   EXPECT_FALSE(anyTraced.load());
+   EXPECT_EQ(engine.getLatencyStats().spectrum.listeners.count, 0U);
+}
+
+TEST(SdrEngineTest, LatencyTracing_StampsFramesAndFillsHistograms)
+{
+   constexpr int FRAMES = 8;
+   SdrEngine::SdrEngine engine;
+   engine.setFftSize(256);
+   engine.setLatencyTracingEnabled(true);
+   // The raw I/Q stream has no listener to pace it; keep every frame so it
+   // is counted below.
+   engine.setPublishPolicy(SdrEngine::EnginePublisher::Iq, CommonUtils::OverflowPolicy::Unbounded);
+
+   std::atomic<bool> ordered{true};
+   const int id = engine.spectrumDataHandler().registerListener(
+      [&](const std::shared_ptr<const SdrEngine::SpectrumData>& frame)
+      {
+         const auto& st = frame->stages;
+         ordered = ordered && st.isTraced() && st.deviceRead <= st.ringDequeue &&
+                   st.ringDequeue <= st.processed && st.processed <= st.published;
+      });
+   EXPECT_EQ(countSpectrumFrames(engine, 256 * FRAMES, FRAMES), FRAMES);
+   engine.spectrumDataHandler().unregisterListener(id);
+   EXPECT_TRUE(ordered.load());
+
+   const auto stats = engine.getLatencyStats();
+   EXPECT_EQ(stats.spectrum.endToEnd.count, static_cast<uint64_t>(FRAMES));
+   EXPECT_EQ(stats.spectrum.listeners.count, static_cast<uint64_t>(FRAMES));
+   EXPECT_GE(stats.spectrum.endToEnd.maxUs, stats.spectrum.processing.maxUs);
+   EXPECT_EQ(stats.iq.processing.count, static_cast<uint64_t>(FRAMES));
+   EXPECT_EQ(stats.filteredIq.processing.count, 0U);   // Filter disabled.
+   engine.logLatencyStats();
+
+   engine.resetLatencyStats();
+   EXPECT_EQ(engine.getLatencyStats().spectrum.endToEnd.count, 0U);
+}
+
 // ============================================================================
 // DataHandler access
 // ============================================================================
@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+#include "SignalDetector.h"
+
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using SdrEngine::CfarMethod;
+using SdrEngine::DetectionReport;
+using SdrEngine::DetectorConfig;
+using SdrEngine::SignalDetector;
+using SdrEngine::SignalEventState;
+using SdrEngine::SpectrumData;
+
+namespace
+{
+
+constexpr double CENTER_HZ    = 100.0e6;
+constexpr double BANDWIDTH_HZ = 1.024e6;
+constexpr std::size_t BINS    = 1024;   // 1 kHz per bin
+constexpr float FLOOR_DB      = -100.0F;
+
+// A noise floor of +-1 dB with each carrier {first bin, bins, level} on top.
+struct Carrier
+{
+   std::size_t first;
+   std::size_t bins;
+   float levelDb;
+};
+
+SpectrumData makeFrame(const std::vector<Carrier>& carriers, std::size_t bins = BINS,
+                       unsigned seed = 1)
+{
+   std::mt19937 rng(seed);
+   std::uniform_real_distribution<float> noise(-1.0F, 1.0F);
+   SpectrumData frame;
+   frame.centerFreqHz = CENTER_HZ;
+   frame.bandwidthHz  = BANDWIDTH_HZ * static_cast<double>(bins) / static_cast<double>(BINS);
+   frame.fftSize      = bins;
+   frame.magnitudesDb.resize(bins);
+   for (float& db : frame.magnitudesDb)
+   {
+      db = FLOOR_DB + noise(rng);
+   }
+   for (const Carrier& c : carriers)
+   {
+      for (std::size_t i = c.first; i < c.first + c.bins; ++i)
+      {
+         frame.magnitudesDb[i] = c.levelDb;
+      }
+   }
+   return frame;
+}
+
+double binHz(std::size_t bin)
+{
+   return CENTER_HZ + ((static_cast<double>(bin) - static_cast<double>(BINS / 2)) * 1000.0);
+}
+
+// Feed `frames` copies of a frame; returns the last report.
+DetectionReport feed(SignalDetector& detector, const SpectrumData& frame, std::size_t frames = 1)
+{
+   DetectionReport report;
+   for (std::size_t f = 0; f < frames; ++f)
+   {
+      std::ignore = detector.process(frame, report, std::chrono::steady_clock::now());
+   }
+   return report;
+}
+
+} // anonymous namespace
+
+TEST(SignalDetectorTest, CellAveraging_FindsCarrier)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   detector.setConfig(config);
+
+   const auto report = feed(detector, makeFrame({{600, 10, -70.0F}}));
+   ASSERT_EQ(report.events.size(), 1U);
+   const auto& event = report.events[0];
+   EXPECT_EQ(event.state, SignalEventState::Started);
+   EXPECT_NEAR(event.centerHz, (binHz(600) + binHz(609)) / 2.0, 1.0);
+   EXPECT_NEAR(event.bandwidthHz, 10'000.0, 1.0);
+   EXPECT_NEAR(event.snrDb, 30.0F, 1.5F);
+   EXPECT_NEAR(event.noiseDb, FLOOR_DB, 1.5F);
+   EXPECT_EQ(report.fftSize, BINS);
+}
+
+TEST(SignalDetectorTest, NoiseOnly_ReportsNothing)
+{
+   SignalDetector detector;
+   DetectionReport report;
+   EXPECT_FALSE(detector.process(makeFrame({}), report, std::chrono::steady_clock::now()));
+   EXPECT_TRUE(report.events.empty());
+   EXPECT_EQ(detector.trackedCount(), 0U);
+}
+
+TEST(SignalDetectorTest, CarrierAtEdge_UsesOneSidedReference)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   detector.setConfig(config);
+
+   const auto report = feed(detector, makeFrame({{2, 3, -80.0F}, {BINS - 4, 3, -80.0F}}));
+   ASSERT_EQ(report.events.size(), 2U);
+   EXPECT_NEAR(report.events[0].snrDb, 20.0F, 1.5F);
+   EXPECT_NEAR(report.events[1].snrDb, 20.0F, 1.5F);
+}
+
+TEST(SignalDetectorTest, Lifecycle_ConfirmsHoldsAndEnds)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 3;
+   config.holdFrames    = 2;
+   detector.setConfig(config);
+   const auto on  = makeFrame({{300, 5, -80.0F}});
+   const auto off = makeFrame({});
+
+   EXPECT_TRUE(feed(detector, on, 2).events.empty());   // Not yet confirmed.
+   auto report = feed(detector, on);
+   ASSERT_EQ(report.events.size(), 1U);
+   EXPECT_EQ(report.events[0].state, SignalEventState::Started);
+   EXPECT_EQ(report.events[0].frames, 3U);
+   const auto id = report.events[0].id;
+
+   report = feed(detector, on);
+   ASSERT_EQ(report.events.size(), 1U);
+   EXPECT_EQ(report.events[0].state, SignalEventState::Active);
+   EXPECT_EQ(report.events[0].id, id);
+
+   // Held through two missed frames, ended on the third.
+   for (int f = 0; f < 2; ++f)
+   {
+      report = feed(detector, off);
+      ASSERT_EQ(report.events.size(), 1U);
+      EXPECT_EQ(report.events[0].state, SignalEventState::Active);
+   }
+   report = feed(detector, off);
+   ASSERT_EQ(report.events.size(), 1U);
+   EXPECT_EQ(report.events[0].state, SignalEventState::Ended);
+   EXPECT_EQ(report.events[0].id, id);
+   EXPECT_TRUE(feed(detector, off).events.empty());
+   EXPECT_EQ(detector.trackedCount(), 0U);
+}
+
+TEST(SignalDetectorTest, UnconfirmedDetection_NeedsConsecutiveFrames)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 2;
+   detector.setConfig(config);
+   const auto on  = makeFrame({{300, 5, -80.0F}});
+   const auto off = makeFrame({});
+
+   EXPECT_TRUE(feed(detector, on).events.empty());
+   EXPECT_TRUE(feed(detector, off).events.empty());
+   EXPECT_TRUE(feed(detector, on).events.empty());
+   EXPECT_EQ(feed(detector, on).events.size(), 1U);
+}
+
+TEST(SignalDetectorTest, Hysteresis_WeakSignalOnlyContinuesAnEvent)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   config.thresholdDb   = 10.0F;
+   config.hysteresisDb  = 4.0F;
+   detector.setConfig(config);
+
+   // 8 dB over the noise: between the hold and the open threshold.
+   const auto weak = makeFrame({{300, 5, FLOOR_DB + 8.0F}});
+   EXPECT_TRUE(feed(detector, weak).events.empty());
+
+   const auto strong = makeFrame({{300, 5, FLOOR_DB + 20.0F}});
+   const auto id     = feed(detector, strong).events.at(0).id;
+   const auto report = feed(detector, weak);
+   ASSERT_EQ(report.events.size(), 1U);
+   EXPECT_EQ(report.events[0].state, SignalEventState::Active);
+   EXPECT_EQ(report.events[0].id, id);
+   EXPECT_NEAR(report.events[0].snrDb, 8.0F, 1.5F);
+}
+
+TEST(SignalDetectorTest, NearbyRuns_MergeIntoOneEvent)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   config.mergeGapBins  = 2;
+   detector.setConfig(config);
+
+   // Two bins apart merge; far apart stay separate.
+   const auto report = feed(detector, makeFrame({{300, 4, -80.0F},
+                                                 {306, 4, -80.0F},
+                                                 {700, 4, -80.0F}}));
+   ASSERT_EQ(report.events.size(), 2U);
+   EXPECT_NEAR(report.events[0].bandwidthHz, 10'000.0, 1.0);
+   EXPECT_NEAR(report.events[1].bandwidthHz, 4'000.0, 1.0);
+   EXPECT_LT(report.events[0].centerHz, report.events[1].centerHz);
+}
+
+TEST(SignalDetectorTest, MinBins_DropsNarrowDetections)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   config.minBins       = 3;
+   detector.setConfig(config);
+
+   const auto report = feed(detector, makeFrame({{300, 2, -80.0F}, {700, 5, -80.0F}}));
+   ASSERT_EQ(report.events.size(), 1U);
+   EXPECT_NEAR(report.events[0].centerHz, binHz(702), 1.0);
+}
+
+TEST(SignalDetectorTest, OrderedStatistic_SeesCarrierNextToStrongNeighbour)
+{
+   // A strong carrier in the reference window raises the CA-CFAR mean
+   // enough to hide the weaker one; the OS-CFAR rank ignores it.
+   const auto frame = makeFrame({{500, 4, -88.0F}, {515, 12, -40.0F}});
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   config.referenceBins = 16;
+
+   SignalDetector cellAveraging;
+   cellAveraging.setConfig(config);
+   const auto ca = feed(cellAveraging, frame);
+
+   config.method = CfarMethod::OrderedStatistic;
+   config.osRank = 0.5F;
+   SignalDetector ordered;
+   ordered.setConfig(config);
+   const auto os = feed(ordered, frame);
+
+   const auto weakFound = [](const DetectionReport& r) {
+      for (const auto& e : r.events)
+      {
+         if (e.centerHz < binHz(510))
+         {
+            return true;
+         }
+      }
+      return false;
+   };
+   EXPECT_FALSE(weakFound(ca));
+   EXPECT_TRUE(weakFound(os));
+}
+
+TEST(SignalDetectorTest, ShortFrame_DetectsNothing)
+{
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   detector.setConfig(config);
+   const auto report = feed(detector, makeFrame({{30, 4, -80.0F}}, 64));
+   EXPECT_TRUE(report.events.empty());
+   EXPECT_TRUE(detector.excessDb().empty());
+}
+
+TEST(SignalDetectorTest, LargeFrame_FindsEveryCarrier)
+{
+   // 64K bins with 32 carriers spread across the span.
+   constexpr std::size_t LARGE = 65536;
+   std::vector<Carrier> carriers;
+   for (std::size_t k = 0; k < 32; ++k)
+   {
+      carriers.push_back({1000 + (k * 2000), 8, -75.0F});
+   }
+   SignalDetector detector;
+   DetectorConfig config;
+   config.confirmFrames = 1;
+   detector.setConfig(config);
+
+   const auto report = feed(detector, makeFrame(carriers, LARGE));
+   EXPECT_EQ(report.events.size(), carriers.size());
+   EXPECT_EQ(detector.excessDb().size(), LARGE);
+}
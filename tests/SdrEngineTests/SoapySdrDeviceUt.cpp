@@ -15,6 +15,15 @@ TEST(SoapySdrDeviceTest, DefaultConstruction_NotOpen)
    EXPECT_FALSE(device.isStreaming());
 }
 
+TEST(SoapySdrDeviceTest, GetStreamStats_BeforeStreaming_AllZero)
+{
+   const SdrEngine::SoapySdrDevice device;
+   const auto stats = device.getStreamStats();
+   EXPECT_EQ(stats.samplesReceived, 0U);
+   EXPECT_EQ(stats.overflows, 0U);
+   EXPECT_EQ(stats.timeouts, 0U);
+}
+
 TEST(SoapySdrDeviceTest, GetName_WhenNotOpen_ReturnsDefault)
 {
    SdrEngine::SoapySdrDevice device;
@@ -91,6 +100,22 @@ TEST(SoapySdrDeviceTest, EnumerateDevices_DoesNotCrash)
    static_cast<void>(devices);
 }
 
+TEST(SoapySdrDeviceTest, ProbeDevices_FillsCache)
+{
+   const auto probed = SdrEngine::SoapySdrDevice::probeDevices();
+   EXPECT_TRUE(SdrEngine::SoapySdrDevice::hasProbed());
+
+   // The cache answers without probing, with the same devices and indices.
+   const auto cached = SdrEngine::SoapySdrDevice::cachedDevices();
+   ASSERT_EQ(cached.size(), probed.size());
+   for (std::size_t i = 0; i < cached.size(); ++i)
+   {
+      EXPECT_EQ(cached[i].index, static_cast<int>(i));
+      EXPECT_EQ(cached[i].name, probed[i].name);
+      EXPECT_EQ(cached[i].serial, probed[i].serial);
+   }
+}
+
 // ============================================================================
 // Close / stop when not open
 // ============================================================================
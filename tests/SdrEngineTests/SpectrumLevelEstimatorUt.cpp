@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "SpectrumLevelEstimator.h"
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using SdrEngine::SpectrumData;
+using SdrEngine::SpectrumLevelEstimator;
+
+namespace
+{
+
+constexpr double CENTER_HZ    = 100.0e6;
+constexpr double BANDWIDTH_HZ = 1.024e6;
+constexpr std::size_t BINS    = 1024;   // 1 kHz per bin
+
+// A frame and its linear power: a flat floor with a carrier in bins [600, 610).
+struct Spectrum
+{
+   SpectrumData frame;
+   std::vector<float> power;
+};
+
+Spectrum makeSpectrum(float floorDb, float carrierDb)
+{
+   Spectrum s;
+   s.frame.centerFreqHz = CENTER_HZ;
+   s.frame.bandwidthHz  = BANDWIDTH_HZ;
+   s.frame.fftSize      = BINS;
+   s.frame.magnitudesDb.assign(BINS, floorDb);
+   for (std::size_t i = 600; i < 610; ++i)
+   {
+      s.frame.magnitudesDb[i] = carrierDb;
+   }
+   for (const float db : s.frame.magnitudesDb)
+   {
+      s.power.push_back(std::pow(10.0F, db / 10.0F));
+   }
+   return s;
+}
+
+// Absolute frequency of the centre of bin `i`.
+double binHz(double i)
+{
+   return CENTER_HZ + ((i - static_cast<double>(BINS / 2)) * (BANDWIDTH_HZ / BINS));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Noise floor
+// ============================================================================
+
+TEST(SpectrumLevelEstimatorTest, Update_Disabled_LeavesLevelsInvalid)
+{
+   SpectrumLevelEstimator estimator;
+   auto s = makeSpectrum(-100.0F, -40.0F);
+   s.frame.levels.valid = true;   // as left by an earlier use of a pooled frame
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+   EXPECT_FALSE(s.frame.levels.valid);
+   EXPECT_FALSE(s.frame.levels.hasBand);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_MedianIgnoresNarrowCarrier)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   auto s = makeSpectrum(-100.0F, -40.0F);
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+   ASSERT_TRUE(s.frame.levels.valid);
+   EXPECT_NEAR(s.frame.levels.noiseFloorDb, -100.0F, SpectrumLevelEstimator::BUCKET_DB);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_PercentileOfNoise)
+{
+   // Uniform dB values: the percentile is a straight line through the range.
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   estimator.setPercentile(25.0F);
+   SpectrumData frame;
+   for (std::size_t i = 0; i < 4000; ++i)
+   {
+      frame.magnitudesDb.push_back(-120.0F + (40.0F * static_cast<float>(i) / 4000.0F));
+   }
+   estimator.update(frame, {}, 1.0F, 0.0F, 0.1);
+   EXPECT_NEAR(frame.levels.noiseFloorDb, -110.0F, 0.1F);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_FollowsFloorWithTimeConstant)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   estimator.setTimeConstant(1.0F);
+
+   auto low = makeSpectrum(-100.0F, -40.0F);
+   estimator.update(low.frame, low.power, 1.0F, 0.0F, 0.1);
+
+   // One frame 0.1 s later moves only a tenth of the histogram: still low.
+   auto high = makeSpectrum(-80.0F, -40.0F);
+   estimator.update(high.frame, high.power, 1.0F, 0.0F, 0.1);
+   EXPECT_NEAR(high.frame.levels.noiseFloorDb, -100.0F, 0.5F);
+
+   // After several time constants the new floor holds the median.
+   for (int i = 0; i < 50; ++i)
+   {
+      estimator.update(high.frame, high.power, 1.0F, 0.0F, 0.1);
+   }
+   EXPECT_NEAR(high.frame.levels.noiseFloorDb, -80.0F, SpectrumLevelEstimator::BUCKET_DB);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_OutOfRangeAndNanBinsAreClamped)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   SpectrumData frame;
+   frame.magnitudesDb = {-300.0F, -250.0F, std::nanf(""), 10.0F, 400.0F};
+   estimator.update(frame, {}, 1.0F, 0.0F, 0.1);
+   EXPECT_NEAR(frame.levels.noiseFloorDb, SpectrumLevelEstimator::LOWEST_DB,
+               SpectrumLevelEstimator::BUCKET_DB);
+}
+
+TEST(SpectrumLevelEstimatorTest, SetPercentile_Clamps)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setPercentile(0.0F);
+   EXPECT_FLOAT_EQ(estimator.getPercentile(), 1.0F);
+   estimator.setPercentile(150.0F);
+   EXPECT_FLOAT_EQ(estimator.getPercentile(), 99.0F);
+}
+
+// ============================================================================
+// Band power
+// ============================================================================
+
+TEST(SpectrumLevelEstimatorTest, Update_BandPowerSumsBinsInBand)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   // Edges between bins 599/600 and 609/610: exactly the carrier.
+   estimator.setBand(binHz(609.5), binHz(599.5));
+   auto s = makeSpectrum(-100.0F, -40.0F);
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+
+   const auto& levels = s.frame.levels;
+   ASSERT_TRUE(levels.hasBand);
+   EXPECT_EQ(levels.bandBins, 10U);
+   EXPECT_DOUBLE_EQ(levels.bandLowHz, binHz(600));
+   EXPECT_DOUBLE_EQ(levels.bandHighHz, binHz(609));
+   EXPECT_NEAR(levels.bandPowerDb, -30.0F, 1.0e-3F);           // 10 x -40 dB
+   EXPECT_NEAR(levels.bandNoiseDb, -90.0F, SpectrumLevelEstimator::BUCKET_DB);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_BandPowerAveragedLikeTrace)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   estimator.setBand(binHz(599.5), binHz(609.5));
+
+   auto s = makeSpectrum(-100.0F, -40.0F);
+   estimator.update(s.frame, s.power, 1.0F, 0.5F, 0.1);
+   // Twice the power, half weight: 1.5 x the first frame's power
+   estimator.update(s.frame, s.power, 2.0F, 0.5F, 0.1);
+   EXPECT_NEAR(s.frame.levels.bandPowerDb, -30.0F + (10.0F * std::log10(1.5F)), 1.0e-3F);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_NarrowBandUsesBinAtCentre)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   estimator.setBand(binHz(604.1), binHz(604.3));
+   auto s = makeSpectrum(-100.0F, -40.0F);
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+   ASSERT_TRUE(s.frame.levels.hasBand);
+   EXPECT_EQ(s.frame.levels.bandBins, 1U);
+   EXPECT_NEAR(s.frame.levels.bandPowerDb, -40.0F, 1.0e-3F);
+}
+
+TEST(SpectrumLevelEstimatorTest, Update_BandOutsideSpanOrCleared_HasNoBand)
+{
+   SpectrumLevelEstimator estimator;
+   estimator.setEnabled(true);
+   auto s = makeSpectrum(-100.0F, -40.0F);
+
+   estimator.setBand(CENTER_HZ + 2.0e6, CENTER_HZ + 3.0e6);
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+   EXPECT_TRUE(s.frame.levels.valid);
+   EXPECT_FALSE(s.frame.levels.hasBand);
+
+   estimator.setBand(binHz(0), binHz(10));
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+   EXPECT_TRUE(s.frame.levels.hasBand);
+
+   estimator.clearBand();
+   estimator.update(s.frame, s.power, 1.0F, 0.0F, 0.1);
+   EXPECT_FALSE(s.frame.levels.hasBand);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "SpectrumMerger.h"
+
+#include <cstddef>
+#include <vector>
+
+using SdrEngine::SpectrumData;
+using SdrEngine::SpectrumMerger;
+
+namespace
+{
+
+// A flat frame at `levelDb` with bin `i` (if any) raised to -10 dB.
+SpectrumData makeFrame(double centerHz, double bandwidthHz, std::size_t bins, float levelDb,
+                       std::size_t markedBin = static_cast<std::size_t>(-1))
+{
+   SpectrumData frame;
+   frame.centerFreqHz = centerHz;
+   frame.bandwidthHz  = bandwidthHz;
+   frame.fftSize      = bins;
+   frame.magnitudesDb.assign(bins, levelDb);
+   if (markedBin < bins)
+   {
+      frame.magnitudesDb[markedBin] = -10.0F;
+   }
+   return frame;
+}
+
+// Absolute frequency of bin `i` of a frame.
+double binHz(const SpectrumData& frame, std::size_t i)
+{
+   const double hzPerBin = frame.bandwidthHz / static_cast<double>(frame.magnitudesDb.size());
+   return frame.centerFreqHz +
+          ((static_cast<double>(i) - static_cast<double>(frame.magnitudesDb.size() / 2)) *
+           hzPerBin);
+}
+
+} // anonymous namespace
+
+TEST(SpectrumMergerTest, Merge_NoUsableInput_Fails)
+{
+   SpectrumMerger merger;
+   SpectrumData merged;
+   SpectrumData empty;
+   const std::vector<const SpectrumData*> inputs{nullptr, &empty};
+   EXPECT_FALSE(merger.merge(inputs, merged));
+}
+
+TEST(SpectrumMergerTest, Merge_SingleInput_IsCopied)
+{
+   SpectrumMerger merger;
+   const auto frame = makeFrame(100.0e6, 1.0e6, 1000, -90.0F, 123);
+   SpectrumData merged;
+   const std::vector<const SpectrumData*> inputs{&frame};
+   ASSERT_TRUE(merger.merge(inputs, merged));
+   EXPECT_EQ(merged.fftSize, 1000U);
+   EXPECT_DOUBLE_EQ(merged.centerFreqHz, 100.0e6);
+   EXPECT_DOUBLE_EQ(merged.bandwidthHz, 1.0e6);
+   EXPECT_EQ(merged.magnitudesDb, frame.magnitudesDb);
+}
+
+TEST(SpectrumMergerTest, Merge_AdjacentBands_KeepAbsoluteFrequencies)
+{
+   // 99.5-100.5 MHz and 100.5-101.5 MHz at 1 kHz per bin, given out of order.
+   SpectrumMerger merger;
+   const auto upper = makeFrame(101.0e6, 1.0e6, 1000, -80.0F, 700);   // 101.2 MHz
+   const auto lower = makeFrame(100.0e6, 1.0e6, 1000, -90.0F, 100);   // 99.6 MHz
+   SpectrumData merged;
+   const std::vector<const SpectrumData*> inputs{&upper, &lower};
+   ASSERT_TRUE(merger.merge(inputs, merged));
+
+   ASSERT_EQ(merged.magnitudesDb.size(), 2000U);
+   EXPECT_DOUBLE_EQ(merged.bandwidthHz, 2.0e6);
+   EXPECT_DOUBLE_EQ(binHz(merged, 0), binHz(lower, 0));
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[100], -10.0F);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[1700], -10.0F);
+   EXPECT_DOUBLE_EQ(binHz(merged, 1700), binHz(upper, 700));
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[999], -90.0F);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[1000], -80.0F);
+}
+
+TEST(SpectrumMergerTest, Merge_Overlap_SplitsHalfwayBetweenCentres)
+{
+   // 99.5-100.5 MHz and 100.0-101.0 MHz: the seam falls at 100.25 MHz.
+   SpectrumMerger merger;
+   const auto lower = makeFrame(100.0e6, 1.0e6, 1000, -90.0F);
+   const auto upper = makeFrame(100.5e6, 1.0e6, 1000, -80.0F);
+   SpectrumData merged;
+   const std::vector<const SpectrumData*> inputs{&lower, &upper};
+   ASSERT_TRUE(merger.merge(inputs, merged));
+
+   ASSERT_EQ(merged.magnitudesDb.size(), 1500U);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[749], -90.0F);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[750], -80.0F);
+}
+
+TEST(SpectrumMergerTest, Merge_Gap_FilledWithLowerBorder)
+{
+   // 99.5-100.5 MHz and 101.5-102.5 MHz: nothing covers 100.5-101.5 MHz.
+   SpectrumMerger merger;
+   const auto lower = makeFrame(100.0e6, 1.0e6, 1000, -90.0F);
+   const auto upper = makeFrame(102.0e6, 1.0e6, 1000, -80.0F);
+   SpectrumData merged;
+   const std::vector<const SpectrumData*> inputs{&lower, &upper};
+   ASSERT_TRUE(merger.merge(inputs, merged));
+
+   ASSERT_EQ(merged.magnitudesDb.size(), 3000U);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[1500], -90.0F);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[2000], -80.0F);
+}
+
+TEST(SpectrumMergerTest, Merge_CoarserInput_SampledAtFinestResolution)
+{
+   // The upper device has half the resolution: each of its bins fills two.
+   SpectrumMerger merger;
+   const auto lower = makeFrame(100.0e6, 1.0e6, 1000, -90.0F);
+   const auto upper = makeFrame(101.0e6, 1.0e6, 500, -80.0F, 350);   // 101.2 MHz
+   SpectrumData merged;
+   const std::vector<const SpectrumData*> inputs{&lower, &upper};
+   ASSERT_TRUE(merger.merge(inputs, merged));
+
+   ASSERT_EQ(merged.magnitudesDb.size(), 2000U);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[1700], -10.0F);
+   EXPECT_FLOAT_EQ(merged.magnitudesDb[1702], -80.0F);
+}
+
+TEST(SpectrumMergerTest, Merge_TooWideSpan_Fails)
+{
+   SpectrumMerger merger;
+   const auto low  = makeFrame(100.0e6, 1.0e6, 1000, -90.0F);
+   const auto high = makeFrame(100.0e9, 1.0e6, 1000, -90.0F);
+   SpectrumData merged;
+   const std::vector<const SpectrumData*> inputs{&low, &high};
+   EXPECT_FALSE(merger.merge(inputs, merged));
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "SpectrumStatistics.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using SdrEngine::SpectrumData;
+using SdrEngine::SpectrumStatistics;
+
+namespace
+{
+
+std::shared_ptr<SpectrumData> makeFrame(std::vector<float> db)
+{
+   auto frame = std::make_shared<SpectrumData>();
+   frame->magnitudesDb = std::move(db);
+   frame->fftSize      = frame->magnitudesDb.size();
+   return frame;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Averaging
+// ============================================================================
+
+TEST(SpectrumStatisticsTest, ComputeDb_NoAveraging_ConvertsMeanPower)
+{
+   SpectrumStatistics stats;
+   std::vector<float> db;
+   stats.computeDb({2.0F, 20.0F}, 0.5F, db);
+   ASSERT_EQ(db.size(), 2U);
+   EXPECT_NEAR(db[0], 0.0F, 1.0e-3F);
+   EXPECT_NEAR(db[1], 10.0F, 1.0e-3F);
+}
+
+TEST(SpectrumStatisticsTest, ComputeDb_AveragesInLinearPower)
+{
+   SpectrumStatistics stats;
+   stats.setAverageAlpha(0.5F);
+   std::vector<float> db;
+   stats.computeDb({1.0F}, 1.0F, db);
+   EXPECT_NEAR(db[0], 0.0F, 1.0e-3F);
+
+   // The mean of 1 and 100 (linear) is 50.5, i.e. 17.03 dB — not the 10 dB
+   // an average of the dB values would give.
+   stats.computeDb({100.0F}, 1.0F, db);
+   EXPECT_NEAR(db[0], 10.0 * std::log10(50.5), 1.0e-3);
+}
+
+TEST(SpectrumStatisticsTest, SetAverageAlpha_Clamps)
+{
+   SpectrumStatistics stats;
+   stats.setAverageAlpha(2.0F);
+   EXPECT_FLOAT_EQ(stats.getAverageAlpha(), 1.0F);
+   stats.setAverageAlpha(-1.0F);
+   EXPECT_FLOAT_EQ(stats.getAverageAlpha(), 0.0F);
+}
+
+// ============================================================================
+// Hold traces
+// ============================================================================
+
+TEST(SpectrumStatisticsTest, UpdateHolds_Disabled_LeavesTracesEmpty)
+{
+   SpectrumStatistics stats;
+   auto frame = makeFrame({-10.0F, -20.0F});
+   frame->maxHoldDb = {1.0F};
+   stats.updateHolds(frame, 0.1);
+   EXPECT_TRUE(frame->maxHoldDb.empty());
+   EXPECT_TRUE(frame->minHoldDb.empty());
+}
+
+TEST(SpectrumStatisticsTest, UpdateHolds_MaxHoldDecaysAtConfiguredRate)
+{
+   SpectrumStatistics stats;
+   stats.setMaxHoldEnabled(true);
+   stats.setMaxHoldDecayRate(10.0F);
+
+   auto first = makeFrame({0.0F, -50.0F});
+   stats.updateHolds(first, 0.0);
+   EXPECT_FLOAT_EQ(first->maxHoldDb[0], 0.0F);
+
+   auto second = makeFrame({-40.0F, -30.0F});
+   stats.updateHolds(second, 0.5);
+   EXPECT_FLOAT_EQ(second->maxHoldDb[0], -5.0F);    // 10 dB/s for 0.5 s.
+   EXPECT_FLOAT_EQ(second->maxHoldDb[1], -30.0F);   // New peak wins.
+}
+
+TEST(SpectrumStatisticsTest, UpdateHolds_MinHoldKeepsLowestValue)
+{
+   SpectrumStatistics stats;
+   stats.setMinHoldEnabled(true);
+
+   auto first = makeFrame({-10.0F, -20.0F});
+   stats.updateHolds(first, 0.1);
+   auto second = makeFrame({-30.0F, -5.0F});
+   stats.updateHolds(second, 0.1);
+
+   ASSERT_EQ(second->minHoldDb.size(), 2U);
+   EXPECT_FLOAT_EQ(second->minHoldDb[0], -30.0F);
+   EXPECT_FLOAT_EQ(second->minHoldDb[1], -20.0F);
+}
+
+TEST(SpectrumStatisticsTest, ResetHolds_RestartsFromNextFrame)
+{
+   SpectrumStatistics stats;
+   stats.setMaxHoldEnabled(true);
+   stats.setMaxHoldDecayRate(0.0F);
+
+   stats.updateHolds(makeFrame({0.0F}), 0.1);
+   stats.resetHolds();
+   auto frame = makeFrame({-60.0F});
+   stats.updateHolds(frame, 0.1);
+   EXPECT_FLOAT_EQ(frame->maxHoldDb[0], -60.0F);
+}
+
+TEST(SpectrumStatisticsTest, UpdateHolds_SizeChange_Restarts)
+{
+   SpectrumStatistics stats;
+   stats.setMinHoldEnabled(true);
+
+   stats.updateHolds(makeFrame({-90.0F}), 0.1);
+   auto frame = makeFrame({-10.0F, -20.0F});
+   stats.updateHolds(frame, 0.1);
+   ASSERT_EQ(frame->minHoldDb.size(), 2U);
+   EXPECT_FLOAT_EQ(frame->minHoldDb[0], -10.0F);
+}
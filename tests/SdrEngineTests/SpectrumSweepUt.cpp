@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "SpectrumSweep.h"
+
+#include <cstddef>
+#include <vector>
+
+using SdrEngine::SpectrumData;
+using SdrEngine::SpectrumSweep;
+using SdrEngine::SweepConfig;
+
+namespace
+{
+
+constexpr double SAMPLE_RATE = 1.0e6;
+
+SweepConfig makeConfig(uint64_t startHz, uint64_t stopHz)
+{
+   SweepConfig config;
+   config.startHz        = startHz;
+   config.stopHz         = stopHz;
+   config.settleTimeSec  = 0.002;
+   config.averages       = 2;
+   config.usableFraction = 0.75;
+   return config;
+}
+
+} // anonymous namespace
+
+TEST(SpectrumSweepTest, Configure_InvalidParameters_Rejected)
+{
+   SpectrumSweep sweep;
+   EXPECT_FALSE(sweep.configure(makeConfig(200, 100), SAMPLE_RATE, 256));
+   EXPECT_FALSE(sweep.configure(makeConfig(100, 200), 0.0, 256));
+   auto config = makeConfig(100, 200);
+   config.usableFraction = 1.5;
+   EXPECT_FALSE(sweep.configure(config, SAMPLE_RATE, 256));
+   EXPECT_FALSE(sweep.isConfigured());
+   EXPECT_EQ(sweep.getStepCount(), 0U);
+}
+
+TEST(SpectrumSweepTest, Configure_PlansStepsAcrossRange)
+{
+   SpectrumSweep sweep;
+   ASSERT_TRUE(sweep.configure(makeConfig(100'000'000, 103'000'000), SAMPLE_RATE, 256));
+
+   // 192 of 256 bins kept → 750 kHz per step → 4 steps for 3 MHz.
+   EXPECT_EQ(sweep.binsPerStep(), 192U);
+   EXPECT_DOUBLE_EQ(sweep.stepWidthHz(), 750.0e3);
+   EXPECT_EQ(sweep.getStepCount(), 4U);
+   EXPECT_EQ(sweep.totalBins(), 768U);
+   EXPECT_EQ(sweep.stepFrequency(0), 100'375'000U);
+   EXPECT_EQ(sweep.stepFrequency(3), 102'625'000U);
+   EXPECT_EQ(sweep.settleSamples(), 2000U);
+   EXPECT_EQ(sweep.captureSamples(), 512U);
+}
+
+TEST(SpectrumSweepTest, BeginPass_DescribesStitchedSpan)
+{
+   SpectrumSweep sweep;
+   ASSERT_TRUE(sweep.configure(makeConfig(100'000'000, 103'000'000), SAMPLE_RATE, 256));
+   SpectrumData frame;
+   sweep.beginPass(frame);
+   EXPECT_EQ(frame.magnitudesDb.size(), 768U);
+   EXPECT_EQ(frame.fftSize, 768U);
+   EXPECT_DOUBLE_EQ(frame.bandwidthHz, 3.0e6);
+   EXPECT_DOUBLE_EQ(frame.centerFreqHz, 101.5e6);
+}
+
+TEST(SpectrumSweepTest, AddStep_CopiesCentralBinsIntoPlace)
+{
+   SpectrumSweep sweep;
+   ASSERT_TRUE(sweep.configure(makeConfig(0, 1'500'000), SAMPLE_RATE, 8));
+   // 6 of 8 bins kept per step, trimming one bin at each edge.
+   ASSERT_EQ(sweep.binsPerStep(), 6U);
+   ASSERT_EQ(sweep.getStepCount(), 2U);
+
+   SpectrumData frame;
+   sweep.beginPass(frame);
+   const std::vector<float> first  = {-99.0F, 1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, -99.0F};
+   const std::vector<float> second = {-99.0F, 7.0F, 8.0F, 9.0F, 10.0F, 11.0F, 12.0F, -99.0F};
+   sweep.addStep(1, second, frame);
+   sweep.addStep(0, first, frame);
+
+   for (std::size_t i = 0; i < frame.magnitudesDb.size(); ++i)
+   {
+      EXPECT_FLOAT_EQ(frame.magnitudesDb[i], static_cast<float>(i + 1)) << "bin " << i;
+   }
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "StageLatencyHistograms.h"
+
+#include <chrono>
+
+using SdrEngine::StageLatencyHistograms;
+using SdrEngine::StageTimestamps;
+
+using std::chrono::microseconds;
+
+// ============================================================================
+// StageLatencyHistograms
+// ============================================================================
+
+TEST(StageLatencyHistogramsTest, Record_SplitsFrameIntoHops)
+{
+   using TimePoint = StageTimestamps::TimePoint;
+   const auto at = [](int us) { return TimePoint{microseconds(us)}; };
+
+   StageTimestamps stages;
+   stages.deviceRead  = at(100);
+   stages.ringDequeue = at(300);
+   stages.processed   = at(700);
+   stages.published   = at(710);
+
+   StageLatencyHistograms histograms;
+   histograms.record(stages, at(1710), at(1750));
+   const auto stats = histograms.summary();
+   EXPECT_NEAR(stats.ringWait.maxUs, 200.0, 1.0e-9);
+   EXPECT_NEAR(stats.processing.maxUs, 400.0, 1.0e-9);
+   EXPECT_NEAR(stats.publish.maxUs, 10.0, 1.0e-9);
+   EXPECT_NEAR(stats.queueing.maxUs, 1000.0, 1.0e-9);
+   EXPECT_NEAR(stats.listeners.maxUs, 40.0, 1.0e-9);
+   EXPECT_NEAR(stats.endToEnd.maxUs, 1650.0, 1.0e-9);
+}
+
+TEST(StageLatencyHistogramsTest, UntracedFrame_IsIgnored)
+{
+   StageLatencyHistograms histograms;
+   histograms.record(StageTimestamps{}, StageTimestamps::TimePoint{microseconds(5)},
+                     StageTimestamps::TimePoint{microseconds(6)});
+   EXPECT_EQ(histograms.summary().listeners.count, 0U);
+}
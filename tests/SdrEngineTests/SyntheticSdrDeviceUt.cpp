@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include "SyntheticSdrDevice.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <mutex>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+using SdrEngine::IqSample;
+using SdrEngine::PlaybackPacing;
+using SdrEngine::SyntheticSdrDevice;
+using SdrEngine::SyntheticSignal;
+using SdrEngine::SyntheticSignalType;
+
+namespace
+{
+
+constexpr std::size_t LOOP = 4096;
+
+// Flood the device until `count` samples have been collected.
+std::vector<IqSample> capture(SyntheticSdrDevice& device, std::size_t count,
+                              std::size_t bufferSize = 1000)
+{
+   device.setPacing(PlaybackPacing::AsFastAsPossible);
+   std::mutex mutex;
+   std::vector<IqSample> out;
+   EXPECT_TRUE(device.startStreaming(
+      [&](const IqSample* data, std::size_t n)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         if (out.size() < count)
+         {
+            out.insert(out.end(), data, data + std::min(n, count - out.size()));
+         }
+      },
+      bufferSize));
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (std::chrono::steady_clock::now() < deadline)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         if (out.size() >= count)
+         {
+            break;
+         }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   device.stopStreaming();
+   return out;
+}
+
+SyntheticSdrDevice& configured(SyntheticSdrDevice& device, std::vector<SyntheticSignal> signals,
+                               float noise = 0.0F)
+{
+   EXPECT_TRUE(device.open());
+   EXPECT_TRUE(device.setSampleRate(1'024'000));
+   EXPECT_TRUE(device.setLoopLength(LOOP));   // 250 Hz grid
+   EXPECT_TRUE(device.setSignals(std::move(signals)));
+   EXPECT_TRUE(device.setNoiseLevel(noise));
+   return device;
+}
+
+// Average phase advance per sample, as a frequency.
+double meanFrequencyHz(const std::vector<IqSample>& x, double rateHz)
+{
+   std::complex<double> acc{};
+   for (std::size_t n = 1; n < x.size(); ++n)
+   {
+      acc += std::complex<double>(x[n]) * std::conj(std::complex<double>(x[n - 1]));
+   }
+   return std::arg(acc) * rateHz / (2.0 * std::numbers::pi);
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+TEST(SyntheticSdrDeviceTest, StartStreaming_BeforeOpen_Fails)
+{
+   SyntheticSdrDevice device;
+   EXPECT_FALSE(device.isOpen());
+   EXPECT_FALSE(device.startStreaming([](const IqSample*, std::size_t) {}));
+   EXPECT_FALSE(device.open(1));
+}
+
+TEST(SyntheticSdrDeviceTest, Settings_RejectedWhileStreaming)
+{
+   SyntheticSdrDevice device;
+   ASSERT_TRUE(device.open());
+   ASSERT_TRUE(device.startStreaming([](const IqSample*, std::size_t) {}, 1024));
+   EXPECT_FALSE(device.setSignals({}));
+   EXPECT_FALSE(device.setNoiseLevel(0.1F));
+   EXPECT_FALSE(device.setLoopLength(8192));
+   device.stopStreaming();
+   EXPECT_TRUE(device.setSignals({}));
+   EXPECT_FALSE(device.setLoopLength(16));   // Below the minimum.
+}
+
+// ============================================================================
+// Waveforms
+// ============================================================================
+
+TEST(SyntheticSdrDeviceTest, Tone_IsRoundedToGridAndLoopsSeamlessly)
+{
+   SyntheticSdrDevice device;
+   SyntheticSignal tone;
+   tone.offsetHz  = 10'100.0;   // Rounds to 10'000 on the 250 Hz grid.
+   tone.amplitude = 0.5F;
+   configured(device, {tone});
+   EXPECT_DOUBLE_EQ(device.getFrequencyResolution(), 250.0);
+
+   // 1000-sample blocks do not divide the 4096-sample loop: the stream must
+   // still be one continuous tone across the wraps.
+   const auto x = capture(device, 3 * LOOP);
+   ASSERT_EQ(x.size(), 3 * LOOP);
+   for (std::size_t n = 0; n < x.size(); n += 97)
+   {
+      const double phase = 2.0 * std::numbers::pi * 10'000.0 * static_cast<double>(n) / 1'024'000.0;
+      EXPECT_NEAR(x[n].real(), 0.5 * std::cos(phase), 1e-3) << n;
+      EXPECT_NEAR(x[n].imag(), 0.5 * std::sin(phase), 1e-3) << n;
+   }
+}
+
+TEST(SyntheticSdrDeviceTest, AmCarrier_EnvelopeSpansDepth)
+{
+   SyntheticSdrDevice device;
+   SyntheticSignal am;
+   am.type         = SyntheticSignalType::AmCarrier;
+   am.offsetHz     = -20'000.0;
+   am.amplitude    = 0.8F;
+   am.modulationHz = 1'000.0;
+   am.depth        = 0.5F;
+   configured(device, {am});
+
+   const auto x = capture(device, LOOP);
+   float lo = 1.0F;
+   float hi = 0.0F;
+   for (const auto& s : x)
+   {
+      lo = std::min(lo, std::abs(s));
+      hi = std::max(hi, std::abs(s));
+   }
+   EXPECT_NEAR(hi, 0.8F, 1e-3F);
+   EXPECT_NEAR(lo, 0.8F * 0.5F / 1.5F, 1e-3F);
+   EXPECT_NEAR(meanFrequencyHz(x, 1'024'000.0), -20'000.0, 1.0);
+}
+
+TEST(SyntheticSdrDeviceTest, FmCarrier_ConstantEnvelopeAndPeakDeviation)
+{
+   SyntheticSdrDevice device;
+   SyntheticSignal fm;
+   fm.type         = SyntheticSignalType::FmCarrier;
+   fm.offsetHz     = 50'000.0;
+   fm.amplitude    = 0.5F;
+   fm.modulationHz = 1'000.0;
+   fm.deviationHz  = 25'000.0;
+   configured(device, {fm});
+
+   const auto x = capture(device, LOOP);
+   double maxFreq = -1e9;
+   double minFreq = 1e9;
+   for (std::size_t n = 1; n < x.size(); ++n)
+   {
+      EXPECT_NEAR(std::abs(x[n]), 0.5F, 1e-3F);
+      const double f = std::arg(x[n] * std::conj(x[n - 1])) * 1'024'000.0 /
+                       (2.0 * std::numbers::pi);
+      maxFreq = std::max(maxFreq, f);
+      minFreq = std::min(minFreq, f);
+   }
+   EXPECT_NEAR(meanFrequencyHz(x, 1'024'000.0), 50'000.0, 50.0);
+   EXPECT_NEAR(maxFreq, 75'000.0, 1'500.0);
+   EXPECT_NEAR(minFreq, 25'000.0, 1'500.0);
+}
+
+TEST(SyntheticSdrDeviceTest, Noise_HasRequestedRms)
+{
+   SyntheticSdrDevice device;
+   configured(device, {}, 0.1F);
+
+   const auto x = capture(device, LOOP);
+   double power = 0.0;
+   for (const auto& s : x)
+   {
+      power += std::norm(s);
+   }
+   EXPECT_NEAR(std::sqrt(power / static_cast<double>(x.size())), 0.1, 0.005);
+}
+
+// ============================================================================
+// Pacing
+// ============================================================================
+
+TEST(SyntheticSdrDeviceTest, Flood_OutrunsRealTimeRate)
+{
+   SyntheticSdrDevice device;
+   configured(device, {SyntheticSignal{}});
+   ASSERT_TRUE(device.setSampleRate(1'000));   // Real time would take 1000 s.
+
+   const auto x = capture(device, 1'000'000, 4096);
+   EXPECT_EQ(x.size(), 1'000'000U);
+   const auto stats = device.getStreamStats();
+   EXPECT_GE(stats.samplesReceived, 1'000'000U);
+   EXPECT_EQ(stats.shortReads, 0U);
+}
+
+TEST(SyntheticSdrDeviceTest, RealTime_PacesAtSampleRate)
+{
+   SyntheticSdrDevice device;
+   configured(device, {SyntheticSignal{}});
+   ASSERT_TRUE(device.setSampleRate(100'000));
+   EXPECT_EQ(device.getPacing(), PlaybackPacing::RealTime);
+
+   ASSERT_TRUE(device.startStreaming([](const IqSample*, std::size_t) {}, 1000));
+   std::this_thread::sleep_for(std::chrono::milliseconds(200));
+   device.stopStreaming();
+
+   // ~20 000 samples in 200 ms; allow for a slow, loaded test machine.
+   const auto received = device.getStreamStats().samplesReceived;
+   EXPECT_GE(received, 10'000U);
+   EXPECT_LE(received, 22'000U);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "Vfo.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using SdrEngine::IqBuffer;
+using SdrEngine::IqSample;
+using SdrEngine::Vfo;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+TEST(VfoTest, Construct_KeepsIdAndHasNoDemodulator)
+{
+   const Vfo vfo(7);
+   EXPECT_EQ(vfo.getId(), 7);
+   EXPECT_FALSE(vfo.hasDemodulator());
+   EXPECT_DOUBLE_EQ(vfo.getOutputSampleRate(), 0.0);
+}
+
+TEST(VfoTest, Configure_SetsOffsetBandwidthAndRate)
+{
+   Vfo vfo(0);
+   vfo.configure(-300'000.0, 200'000.0, 2'400'000.0);
+   EXPECT_DOUBLE_EQ(vfo.getCenterOffset(), -300'000.0);
+   EXPECT_DOUBLE_EQ(vfo.getBandwidth(), 200'000.0);
+   EXPECT_DOUBLE_EQ(vfo.getOutputSampleRate(), 200'000.0);   // 12x decimation.
+}
+
+TEST(VfoTest, SetDemodulator_ThenClear_TogglesState)
+{
+   Vfo vfo(0);
+   vfo.configure(0.0, 200'000.0, 2'400'000.0);
+   vfo.setDemodulator(SdrEngine::DemodMode::AM);
+   EXPECT_TRUE(vfo.hasDemodulator());
+   EXPECT_EQ(vfo.getDemodMode(), SdrEngine::DemodMode::AM);
+   vfo.clearDemodulator();
+   EXPECT_FALSE(vfo.hasDemodulator());
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+TEST(VfoTest, Process_PublishesFilteredIqWithChannelMetadata)
+{
+   Vfo vfo(0);
+   vfo.configure(250'000.0, 200'000.0, 2'400'000.0);
+
+   std::mutex mutex;
+   std::vector<std::shared_ptr<const IqBuffer>> received;
+   const int id = vfo.iqDataHandler().registerListener(
+      [&](const std::shared_ptr<const IqBuffer>& buf)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         received.push_back(buf);
+      });
+
+   IqBuffer wideband;
+   wideband.samples.assign(2400, IqSample{0.5F, 0.0F});
+   wideband.centerFreqHz = 100.0e6;
+   wideband.sampleRateHz = 2.4e6;
+   vfo.process(wideband);
+
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (std::chrono::steady_clock::now() < deadline)
+   {
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         if (!received.empty())
+         {
+            break;
+         }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   vfo.iqDataHandler().unregisterListener(id);
+
+   const std::lock_guard<std::mutex> lock(mutex);
+   ASSERT_EQ(received.size(), 1U);
+   EXPECT_EQ(received[0]->samples.size(), 200U);
+   EXPECT_DOUBLE_EQ(received[0]->centerFreqHz, 100.25e6);
+   EXPECT_DOUBLE_EQ(received[0]->sampleRateHz, 200'000.0);
+}
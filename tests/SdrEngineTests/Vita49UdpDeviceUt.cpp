@@ -0,0 +1,331 @@
+#include <gtest/gtest.h>
+#include "IoContext.h"
+#include "SdrTypes.h"
+#include "Vita49Codec.h"
+#include "Vita49UdpDevice.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using SdrEngine::IqSample;
+using SdrEngine::Vita49UdpDevice;
+
+namespace
+{
+
+// Sends datagrams to a device listening on the loopback interface.
+class LoopbackSender
+{
+public:
+   explicit LoopbackSender(uint16_t port)
+      : _socket(::socket(AF_INET, SOCK_DGRAM, 0))
+   {
+      _target.sin_family      = AF_INET;
+      _target.sin_port        = htons(port);
+      _target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   }
+
+   ~LoopbackSender() { ::close(_socket); }
+
+   LoopbackSender(const LoopbackSender&) = delete;
+   LoopbackSender& operator=(const LoopbackSender&) = delete;
+
+   void send(const std::vector<uint8_t>& datagram) const
+   {
+      ::sendto(_socket, datagram.data(), datagram.size(), 0,
+               reinterpret_cast<const sockaddr*>(&_target), sizeof(_target));
+   }
+
+private:
+   int _socket;
+   sockaddr_in _target{};
+};
+
+// Collects every delivered sample.
+struct Collector
+{
+   std::mutex mutex;
+   std::vector<IqSample> samples;
+
+   SdrEngine::IqCallback callback()
+   {
+      return [this](const IqSample* data, std::size_t n)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         samples.insert(samples.end(), data, data + n);
+      };
+   }
+
+   // Wait until `count` samples arrived; false on timeout.
+   bool waitFor(std::size_t count)
+   {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (std::chrono::steady_clock::now() < deadline)
+      {
+         {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (samples.size() >= count)
+            {
+               return true;
+            }
+         }
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      return false;
+   }
+};
+
+Vita49_2::IQSamples ramp(std::size_t n, float offset)
+{
+   Vita49_2::IQSamples samples(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      samples[i] = {offset + (static_cast<float>(i) / 1000.0F), -0.25F};
+   }
+   return samples;
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+TEST(Vita49UdpDeviceTest, Open_BindsEphemeralPortAndRejectsBadAddress)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   ASSERT_TRUE(device.open());
+   EXPECT_TRUE(device.isOpen());
+   EXPECT_NE(device.getBoundPort(), 0U);
+   EXPECT_FALSE(device.setEndpoint("127.0.0.1", 1234));
+
+   device.close();
+   EXPECT_FALSE(device.isOpen());
+   EXPECT_TRUE(device.setEndpoint("not-an-address", 0));
+   EXPECT_FALSE(device.open());
+   EXPECT_FALSE(device.startStreaming([](const IqSample*, std::size_t) {}));
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+TEST(Vita49UdpDeviceTest, Streaming_DecodesSignalDataAndTakesContext)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   ASSERT_TRUE(device.open());
+   Collector collector;
+   ASSERT_TRUE(device.startStreaming(collector.callback()));
+
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   Vita49_2::ContextFields context;
+   context.sampleRate  = 2'000'000.0;
+   context.rfFrequency = 433'920'000.0;
+   const LoopbackSender sender(device.getBoundPort());
+   sender.send(codec.encodeContext(7, context));
+   for (uint8_t packet = 0; packet < 4; ++packet)
+   {
+      sender.send(codec.encodeSignalData(7, ramp(200, 0.2F * packet), packet));
+   }
+
+   ASSERT_TRUE(collector.waitFor(800));
+   device.stopStreaming();
+
+   EXPECT_EQ(device.getSampleRate(), 2'000'000U);
+   EXPECT_EQ(device.getCenterFrequency(), 433'920'000U);
+   ASSERT_EQ(collector.samples.size(), 800U);
+   for (std::size_t i = 0; i < collector.samples.size(); ++i)
+   {
+      const float expected =
+         (0.2F * static_cast<float>(i / 200)) + (static_cast<float>(i % 200) / 1000.0F);
+      EXPECT_NEAR(collector.samples[i].real(), expected, 1e-3F);
+      EXPECT_NEAR(collector.samples[i].imag(), -0.25F, 1e-4F);
+   }
+   EXPECT_EQ(device.getLostPackets(), 0U);
+   EXPECT_EQ(device.getStreamStats().samplesReceived, 800U);
+}
+
+TEST(Vita49UdpDeviceTest, Streaming_FollowsAnnouncedPayloadFormat)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   ASSERT_TRUE(device.open());
+   Collector collector;
+   ASSERT_TRUE(device.startStreaming(collector.callback()));
+
+   Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   codec.setPayloadFormat(Vita49_2::PayloadFormat::Int8);
+   Vita49_2::ContextFields context;
+   context.payloadFormat = Vita49_2::PayloadFormat::Int8;
+   const LoopbackSender sender(device.getBoundPort());
+   sender.send(codec.encodeContext(3, context));
+   sender.send(codec.encodeSignalData(3, ramp(101, 0.5F), 0));
+
+   ASSERT_TRUE(collector.waitFor(101));
+   device.stopStreaming();
+
+   ASSERT_EQ(collector.samples.size(), 101U);
+   EXPECT_NEAR(collector.samples[100].real(), 0.6F, 1.0F / 256.0F);
+   EXPECT_NEAR(collector.samples[100].imag(), -0.25F, 1.0F / 256.0F);
+}
+
+TEST(Vita49UdpDeviceTest, Streaming_AppliesChangedContextMidStream)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   ASSERT_TRUE(device.open());
+   Collector collector;
+   ASSERT_TRUE(device.startStreaming(collector.callback()));
+
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   Vita49_2::ContextFields context;
+   context.sampleRate  = 1'000'000.0;
+   context.rfFrequency = 100'000'000.0;
+   const LoopbackSender sender(device.getBoundPort());
+   sender.send(codec.encodeContext(5, context, 0));
+   sender.send(codec.encodeSignalData(5, ramp(50, 0.0F), 0));
+   sender.send(codec.encodeContext(5, context, 1));
+
+   // Retuned without the Change Indicator set: still taken
+   context.rfFrequency = 101'500'000.0;
+   sender.send(codec.encodeContext(5, context, 2));
+   sender.send(codec.encodeSignalData(5, ramp(50, 0.1F), 1));
+
+   ASSERT_TRUE(collector.waitFor(100));
+   device.stopStreaming();
+
+   EXPECT_EQ(device.getSampleRate(), 1'000'000U);
+   EXPECT_EQ(device.getCenterFrequency(), 101'500'000U);
+}
+
+TEST(Vita49UdpDeviceTest, PacketCountGap_CountsLostPackets)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   ASSERT_TRUE(device.open());
+   Collector collector;
+   ASSERT_TRUE(device.startStreaming(collector.callback()));
+
+   // Counts 14, 15, 0 are in sequence across the 4-bit wrap; 1 and 2 are missing.
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   const LoopbackSender sender(device.getBoundPort());
+   for (const int count : {14, 15, 0, 3, 4})
+   {
+      sender.send(codec.encodeSignalData(1, ramp(10, 0.0F), static_cast<uint8_t>(count)));
+   }
+
+   // The two lost packets arrive as 20 zeros between the third and fourth
+   ASSERT_TRUE(collector.waitFor(70));
+   device.stopStreaming();
+
+   EXPECT_EQ(device.getLostPackets(), 2U);
+   EXPECT_EQ(device.getStreamStats().overflows, 1U);
+   ASSERT_EQ(collector.samples.size(), 70U);
+   EXPECT_NEAR(collector.samples[29].imag(), -0.25F, 1e-4F);
+   for (std::size_t i = 30; i < 50; ++i)
+   {
+      EXPECT_EQ(collector.samples[i], IqSample{});
+   }
+   EXPECT_NEAR(collector.samples[50].imag(), -0.25F, 1e-4F);
+}
+
+TEST(Vita49UdpDeviceTest, ReorderWindow_RestoresPacketOrder)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   device.setReorderWindow(2);
+   ASSERT_TRUE(device.open());
+   Collector collector;
+   ASSERT_TRUE(device.startStreaming(collector.callback()));
+
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   const LoopbackSender sender(device.getBoundPort());
+   for (const int count : {0, 2, 1, 3})
+   {
+      sender.send(codec.encodeSignalData(1, ramp(10, 0.2F * static_cast<float>(count)),
+                                         static_cast<uint8_t>(count)));
+   }
+
+   ASSERT_TRUE(collector.waitFor(40));
+   device.stopStreaming();
+
+   ASSERT_EQ(collector.samples.size(), 40U);
+   for (std::size_t packet = 0; packet < 4; ++packet)
+   {
+      EXPECT_NEAR(collector.samples[packet * 10].real(), 0.2F * static_cast<float>(packet), 1e-3F);
+   }
+   EXPECT_EQ(device.getLostPackets(), 0U);
+}
+
+TEST(Vita49UdpDeviceTest, StreamFilter_IgnoresOtherStreams)
+{
+   Vita49UdpDevice device("127.0.0.1", 0);
+   device.setStreamFilter(0x22);
+   ASSERT_TRUE(device.open());
+   Collector collector;
+   ASSERT_TRUE(device.startStreaming(collector.callback()));
+
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   const LoopbackSender sender(device.getBoundPort());
+   sender.send(codec.encodeSignalData(0x11, ramp(100, 0.5F), 0));
+   sender.send(codec.encodeSignalData(0x22, ramp(30, 0.1F), 0));
+   sender.send(codec.encodeSignalData(0x11, ramp(100, 0.5F), 1));
+   sender.send(codec.encodeSignalData(0x22, ramp(30, 0.1F), 1));
+
+   ASSERT_TRUE(collector.waitFor(60));
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   device.stopStreaming();
+
+   ASSERT_EQ(collector.samples.size(), 60U);
+   EXPECT_NEAR(collector.samples.front().real(), 0.1F, 1e-3F);
+   EXPECT_EQ(device.getLostPackets(), 0U);
+}
+
+// ============================================================================
+// I/O context
+// ============================================================================
+
+TEST(Vita49UdpDeviceTest, IoContext_StreamsShareOneThreadAndRestart)
+{
+   CommonUtils::IoContext io;
+   Vita49UdpDevice first("127.0.0.1", 0);
+   Vita49UdpDevice second("127.0.0.1", 0);
+   first.setIoContext(&io);
+   second.setIoContext(&io);
+   ASSERT_TRUE(first.open());
+   ASSERT_TRUE(second.open());
+
+   Collector firstCollector;
+   Collector secondCollector;
+   ASSERT_TRUE(first.startStreaming(firstCollector.callback()));
+   ASSERT_TRUE(second.startStreaming(secondCollector.callback()));
+
+   const Vita49_2::Vita49Codec codec(Vita49_2::ByteOrder::BigEndian);
+   const LoopbackSender firstSender(first.getBoundPort());
+   const LoopbackSender secondSender(second.getBoundPort());
+   for (uint8_t packet = 0; packet < 3; ++packet)
+   {
+      firstSender.send(codec.encodeSignalData(1, ramp(100, 0.1F), packet));
+      secondSender.send(codec.encodeSignalData(2, ramp(50, 0.3F), packet));
+   }
+   ASSERT_TRUE(firstCollector.waitFor(300));
+   ASSERT_TRUE(secondCollector.waitFor(150));
+   first.stopStreaming();
+   EXPECT_NEAR(secondCollector.samples.front().real(), 0.3F, 1e-3F);
+
+   // The second stream keeps running; the first one can start again.
+   ASSERT_TRUE(first.startStreaming(firstCollector.callback()));
+   secondSender.send(codec.encodeSignalData(2, ramp(50, 0.3F), 3));
+   firstSender.send(codec.encodeSignalData(1, ramp(100, 0.1F), 0));
+   EXPECT_TRUE(secondCollector.waitFor(200));
+   EXPECT_TRUE(firstCollector.waitFor(400));
+   first.stopStreaming();
+   second.stopStreaming();
+
+   EXPECT_EQ(first.getLostPackets(), 0U);
+   EXPECT_EQ(second.getLostPackets(), 0U);
+   EXPECT_EQ(io.waitingCount(), 0U);
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "DataHandler.h"
+#include "SdrPubSubBridge.h"
+#include "SharedMemoryPublisher.h"
+#include "SharedMemorySubscriber.h"
+#include "SignalFrameCodec.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using SdrEngine::IqBuffer;
+using SdrEngine::SpectrumData;
+using SdrStreaming::BridgeOptions;
+using SdrStreaming::SdrPubSubBridge;
+
+namespace
+{
+
+// Wait up to two seconds for a condition set by another thread.
+template <typename Predicate>
+bool waitFor(Predicate predicate)
+{
+   for (int i = 0; i < 200 && !predicate(); ++i)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+   }
+   return predicate();
+}
+
+std::shared_ptr<const SpectrumData> makeSpectrum(std::size_t bins)
+{
+   auto spectrum = std::make_shared<SpectrumData>();
+   spectrum->fftSize = bins;
+   spectrum->magnitudesDb.assign(bins, -90.0F);
+   return spectrum;
+}
+
+// Records every message published through the bridge.
+struct Capture
+{
+   SdrPubSubBridge::PublishFunction function()
+   {
+      return [this](const std::string& topic, const google::protobuf::Message& message)
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         topics.push_back(topic);
+         payloads.push_back(message.SerializeAsString());
+         return accept.load();
+      };
+   }
+
+   std::size_t count()
+   {
+      const std::lock_guard<std::mutex> lock(mutex);
+      return payloads.size();
+   }
+
+   std::mutex mutex;
+   std::vector<std::string> topics;
+   std::vector<std::string> payloads;
+   std::atomic<bool> accept{true};
+};
+
+} // namespace
+
+TEST(SdrPubSubBridgeTest, Spectrum_DecimatedAndSequenced)
+{
+   // Arrange
+   CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>> handler;
+   Capture capture;
+   BridgeOptions options;
+   options.maxSpectrumRateHz = 0.0;
+   options.spectrumCodec.maxPoints = 512;
+   SdrPubSubBridge bridge(capture.function(), options);
+   bridge.attachSpectrum(handler, "spectrum");
+
+   // Act: paced so LatestOnly does not coalesce them
+   for (int i = 0; i < 3; ++i)
+   {
+      handler.signalData(makeSpectrum(4096));
+      ASSERT_TRUE(waitFor([&] { return capture.count() == static_cast<std::size_t>(i + 1); }));
+   }
+
+   // Assert
+   for (std::size_t i = 0; i < 3; ++i)
+   {
+      messages::SpectrumFrame frame;
+      ASSERT_TRUE(frame.ParseFromString(capture.payloads[i]));
+      EXPECT_EQ(capture.topics[i], "spectrum");
+      EXPECT_EQ(frame.sequence(), i);
+      EXPECT_EQ(frame.magnitudes().size(), 512U);
+      EXPECT_EQ(frame.fft_size(), 4096U);
+   }
+   EXPECT_EQ(bridge.stats().spectrumFramesSent, 3U);
+}
+
+TEST(SdrPubSubBridgeTest, Spectrum_RateLimited)
+{
+   // Arrange: at most one frame per 10 s
+   CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>> handler;
+   Capture capture;
+   BridgeOptions options;
+   options.maxSpectrumRateHz = 0.1;
+   SdrPubSubBridge bridge(capture.function(), options);
+   bridge.attachSpectrum(handler, "spectrum");
+
+   // Act
+   handler.signalData(makeSpectrum(64));
+   ASSERT_TRUE(waitFor([&] { return capture.count() == 1; }));
+   for (int i = 0; i < 5; ++i)
+   {
+      handler.signalData(makeSpectrum(64));
+      ASSERT_TRUE(waitFor([&] { return bridge.stats().spectrumFramesSkipped == static_cast<uint64_t>(i + 1); }));
+   }
+
+   // Assert
+   EXPECT_EQ(capture.count(), 1U);
+   EXPECT_EQ(bridge.stats().spectrumFramesSent, 1U);
+}
+
+TEST(SdrPubSubBridgeTest, DeltaSpectrum_FailedPublish_NextFrameIsKeyframe)
+{
+   // Arrange
+   CommonUtils::DataHandler<std::shared_ptr<const SpectrumData>> handler;
+   Capture capture;
+   BridgeOptions options;
+   options.maxSpectrumRateHz     = 0.0;
+   options.spectrumCodec.rangeDb = 120.0F;
+   options.spectrumCodec.delta   = true;
+   SdrPubSubBridge bridge(capture.function(), options);
+   bridge.attachSpectrum(handler, "spectrum");
+   const auto sendOne = [&](std::size_t expected)
+   {
+      handler.signalData(makeSpectrum(64));
+      return waitFor([&] { return capture.count() == expected; });
+   };
+
+   // Act: key, delta, refused, then the recovery frame
+   ASSERT_TRUE(sendOne(1));
+   ASSERT_TRUE(sendOne(2));
+   capture.accept = false;
+   ASSERT_TRUE(sendOne(3));
+   capture.accept = true;
+   ASSERT_TRUE(sendOne(4));
+
+   // Assert
+   std::vector<bool> delta;
+   for (const std::string& payload : capture.payloads)
+   {
+      messages::SpectrumFrame frame;
+      ASSERT_TRUE(frame.ParseFromString(payload));
+      delta.push_back(frame.delta());
+   }
+   EXPECT_EQ(delta, (std::vector<bool>{false, true, true, false}));
+   EXPECT_EQ(bridge.stats().publishFailures, 1U);
+}
+
+TEST(SdrPubSubBridgeTest, PublishFailure_Counted)
+{
+   // Arrange
+   CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>> handler;
+   Capture capture;
+   capture.accept = false;
+   SdrPubSubBridge bridge(capture.function());
+   bridge.attachIq(handler, "iq");
+
+   // Act
+   auto buffer = std::make_shared<IqBuffer>();
+   buffer->samples.resize(16);
+   handler.signalData(buffer);
+
+   // Assert
+   ASSERT_TRUE(waitFor([&] { return bridge.stats().publishFailures == 1; }));
+   EXPECT_EQ(bridge.stats().iqFramesSent, 0U);
+}
+
+TEST(SdrPubSubBridgeTest, Iq_ReachesSharedMemorySubscriberInOrder)
+{
+   // Arrange
+   const std::string name = "BridgeTest" + std::to_string(getpid());
+   SharedMemoryPublisher publisher(name, 1 << 20);
+   ASSERT_TRUE(publisher.isOpen());
+   SharedMemorySubscriber subscriber(name);
+   std::mutex mutex;
+   std::vector<messages::IqFrame> frames;
+   subscriber.subscribeView("iq", [&](std::string_view, std::string_view data) {
+      messages::IqFrame frame;
+      frame.ParseFromArray(data.data(), static_cast<int>(data.size()));
+      const std::lock_guard<std::mutex> lock(mutex);
+      frames.push_back(frame);
+   });
+   ASSERT_TRUE(subscriber.start());
+   ASSERT_TRUE(waitFor([&] { return subscriber.isConnected(); }));
+
+   CommonUtils::DataHandler<std::shared_ptr<const IqBuffer>> handler;
+   BridgeOptions options;
+   options.iqQueueCapacity = 64;
+   SdrPubSubBridge bridge(publisher, options);
+   bridge.attachIq(handler, "iq");
+
+   // Act
+   for (int i = 0; i < 10; ++i)
+   {
+      auto buffer = std::make_shared<IqBuffer>();
+      buffer->samples.assign(1000, {0.5F, -0.25F});
+      buffer->centerFreqHz = 100e6 + i;
+      handler.signalData(buffer);
+   }
+
+   // Assert
+   ASSERT_TRUE(waitFor([&] {
+      const std::lock_guard<std::mutex> lock(mutex);
+      return frames.size() == 10;
+   }));
+   subscriber.stop();
+   for (std::size_t i = 0; i < frames.size(); ++i)
+   {
+      IqBuffer decoded;
+      ASSERT_TRUE(SdrStreaming::decodeIqFrame(frames[i], decoded));
+      EXPECT_EQ(frames[i].sequence(), i);
+      EXPECT_EQ(frames[i].encoding(), messages::IQ_ENCODING_CS16);
+      EXPECT_DOUBLE_EQ(decoded.centerFreqHz, 100e6 + static_cast<double>(i));
+      ASSERT_EQ(decoded.samples.size(), 1000U);
+      EXPECT_NEAR(decoded.samples[999].real(), 0.5F, 1e-4F);
+   }
+   EXPECT_EQ(bridge.stats().iqFramesSent, 10U);
+   EXPECT_GT(bridge.stats().payloadBytes, 10U * 4000U);
+}
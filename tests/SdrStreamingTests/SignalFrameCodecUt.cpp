@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "SignalFrameCodec.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using SdrEngine::IqBuffer;
+using SdrEngine::IqSample;
+using SdrEngine::SpectrumData;
+
+namespace
+{
+
+IqBuffer makeIq(std::size_t n)
+{
+   IqBuffer buffer;
+   buffer.centerFreqHz = 100e6;
+   buffer.sampleRateHz = 2.4e6;
+   buffer.samples.resize(n);
+   for (std::size_t i = 0; i < n; ++i)
+   {
+      const float phase = static_cast<float>(i) * 0.1F;
+      buffer.samples[i] = {0.9F * std::cos(phase), 0.9F * std::sin(phase)};
+   }
+   return buffer;
+}
+
+} // namespace
+
+TEST(SignalFrameCodecTest, Cs16_RoundTripsWithinOneCode)
+{
+   // Arrange
+   const IqBuffer in = makeIq(1000);
+   messages::IqFrame frame;
+   IqBuffer out;
+
+   // Act
+   SdrStreaming::encodeIqFrame(in, messages::IQ_ENCODING_CS16, frame);
+   ASSERT_TRUE(SdrStreaming::decodeIqFrame(frame, out));
+
+   // Assert: 4 bytes per sample
+   EXPECT_EQ(frame.samples().size(), 4000U);
+   EXPECT_EQ(frame.num_samples(), 1000U);
+   EXPECT_DOUBLE_EQ(out.centerFreqHz, 100e6);
+   EXPECT_DOUBLE_EQ(out.sampleRateHz, 2.4e6);
+   ASSERT_EQ(out.samples.size(), in.samples.size());
+   for (std::size_t i = 0; i < in.samples.size(); ++i)
+   {
+      EXPECT_NEAR(out.samples[i].real(), in.samples[i].real(), 1.0 / 32767.0);
+      EXPECT_NEAR(out.samples[i].imag(), in.samples[i].imag(), 1.0 / 32767.0);
+   }
+}
+
+TEST(SignalFrameCodecTest, Cs16_ClipsBeyondFullScale)
+{
+   // Arrange
+   IqBuffer in;
+   in.samples = {IqSample{2.0F, -2.0F}};
+   messages::IqFrame frame;
+   IqBuffer out;
+
+   // Act
+   SdrStreaming::encodeIqFrame(in, messages::IQ_ENCODING_CS16, frame);
+   ASSERT_TRUE(SdrStreaming::decodeIqFrame(frame, out));
+
+   // Assert
+   EXPECT_FLOAT_EQ(out.samples[0].real(), 1.0F);
+   EXPECT_FLOAT_EQ(out.samples[0].imag(), -32768.0F / 32767.0F);
+}
+
+TEST(SignalFrameCodecTest, Cf32_RoundTripsExactly)
+{
+   // Arrange
+   const IqBuffer in = makeIq(100);
+   messages::IqFrame frame;
+   IqBuffer out;
+
+   // Act
+   SdrStreaming::encodeIqFrame(in, messages::IQ_ENCODING_CF32, frame);
+   ASSERT_TRUE(SdrStreaming::decodeIqFrame(frame, out));
+
+   // Assert
+   EXPECT_EQ(frame.samples().size(), 800U);
+   EXPECT_EQ(out.samples, in.samples);
+}
+
+TEST(SignalFrameCodecTest, DecodeIq_TruncatedPayload_Fails)
+{
+   // Arrange
+   messages::IqFrame frame;
+   SdrStreaming::encodeIqFrame(makeIq(10), messages::IQ_ENCODING_CS16, frame);
+   frame.mutable_samples()->pop_back();
+   IqBuffer out;
+
+   // Act & Assert
+   EXPECT_FALSE(SdrStreaming::decodeIqFrame(frame, out));
+}
+
+TEST(SignalFrameCodecTest, Spectrum_QuantizesWithinHalfStep)
+{
+   // Arrange: a -120..-20 dB ramp with a hold trace
+   SpectrumData in;
+   in.fftSize = 256;
+   in.bandwidthHz = 2e6;
+   for (std::size_t i = 0; i < in.fftSize; ++i)
+   {
+      in.magnitudesDb.push_back(-120.0F + (100.0F * static_cast<float>(i) / 255.0F));
+      in.maxHoldDb.push_back(in.magnitudesDb.back() + 3.0F);
+   }
+   messages::SpectrumFrame frame;
+   SpectrumData out;
+
+   // Act
+   SdrStreaming::encodeSpectrumFrame(in, 0, frame);
+   ASSERT_TRUE(SdrStreaming::decodeSpectrumFrame(frame, out));
+
+   // Assert: one byte per bin
+   EXPECT_EQ(frame.magnitudes().size(), 256U);
+   EXPECT_EQ(frame.bins_per_point(), 1U);
+   EXPECT_TRUE(out.minHoldDb.empty());
+   ASSERT_EQ(out.magnitudesDb.size(), in.magnitudesDb.size());
+   ASSERT_EQ(out.maxHoldDb.size(), in.maxHoldDb.size());
+   const float tolerance = (frame.db_step() / 2.0F) + 1e-4F;
+   for (std::size_t i = 0; i < in.magnitudesDb.size(); ++i)
+   {
+      EXPECT_NEAR(out.magnitudesDb[i], in.magnitudesDb[i], tolerance);
+      EXPECT_NEAR(out.maxHoldDb[i], in.maxHoldDb[i], tolerance);
+   }
+   EXPECT_EQ(out.fftSize, 256U);
+   EXPECT_DOUBLE_EQ(out.bandwidthHz, 2e6);
+}
+
+TEST(SignalFrameCodecTest, Spectrum_DecimationKeepsNarrowPeaks)
+{
+   // Arrange: flat noise floor with a one-bin carrier and one empty bin
+   SpectrumData in;
+   in.fftSize = 4096;
+   in.magnitudesDb.assign(in.fftSize, -100.0F);
+   in.magnitudesDb[1234] = -30.0F;
+   in.magnitudesDb[7] = -std::numeric_limits<float>::infinity();
+   in.minHoldDb.assign(in.fftSize, -110.0F);
+   in.minHoldDb[2000] = -140.0F;
+   messages::SpectrumFrame frame;
+   SpectrumData out;
+
+   // Act
+   SdrStreaming::encodeSpectrumFrame(in, 1000, frame);
+   ASSERT_TRUE(SdrStreaming::decodeSpectrumFrame(frame, out));
+
+   // Assert: 5 bins per point, the carrier and the min-hold dip survive
+   EXPECT_EQ(frame.bins_per_point(), 5U);
+   ASSERT_EQ(out.magnitudesDb.size(), 820U);
+   const float tolerance = frame.db_step();
+   EXPECT_NEAR(out.magnitudesDb[1234 / 5], -30.0F, tolerance);
+   EXPECT_NEAR(out.magnitudesDb[0], -100.0F, tolerance);
+   EXPECT_NEAR(out.minHoldDb[2000 / 5], -140.0F, tolerance);
+   EXPECT_NEAR(out.minHoldDb[0], -110.0F, tolerance);
+}
+
+TEST(SignalFrameCodecTest, Spectrum_FlatTraceUsesMinimumStep)
+{
+   // Arrange
+   SpectrumData in;
+   in.magnitudesDb.assign(64, -80.0F);
+   messages::SpectrumFrame frame;
+   SpectrumData out;
+
+   // Act
+   SdrStreaming::encodeSpectrumFrame(in, 0, frame);
+   ASSERT_TRUE(SdrStreaming::decodeSpectrumFrame(frame, out));
+
+   // Assert
+   EXPECT_FLOAT_EQ(frame.db_step(), SdrStreaming::MIN_DB_STEP);
+   EXPECT_FLOAT_EQ(out.magnitudesDb[63], -80.0F);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "SpectrumCodec.h"
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using SdrEngine::SpectrumData;
+using SdrStreaming::SpectrumCodecOptions;
+using SdrStreaming::SpectrumFrameDecoder;
+using SdrStreaming::SpectrumFrameEncoder;
+
+namespace
+{
+
+// Averaged-spectrum-like frames: a -100 dB floor with a carrier at -40 dB,
+// each bin jittering by a fraction of a dB from frame to frame.
+class SpectrumSource
+{
+public:
+   explicit SpectrumSource(std::size_t bins) : _rng(42)
+   {
+      _spectrum.fftSize = bins;
+      _spectrum.magnitudesDb.resize(bins);
+      _base.resize(bins);
+      for (std::size_t i = 0; i < bins; ++i)
+      {
+         const float offset = static_cast<float>(i) - static_cast<float>(bins / 3);
+         _base[i] = -100.0F + (60.0F * std::exp(-(offset * offset) / 200.0F));
+      }
+   }
+
+   const SpectrumData& next()
+   {
+      std::normal_distribution<float> jitter(0.0F, 0.15F);
+      for (std::size_t i = 0; i < _base.size(); ++i)
+      {
+         _spectrum.magnitudesDb[i] = _base[i] + jitter(_rng);
+      }
+      return _spectrum;
+   }
+
+private:
+   std::mt19937 _rng;
+   std::vector<float> _base;
+   SpectrumData _spectrum;
+};
+
+SpectrumCodecOptions streamingOptions()
+{
+   SpectrumCodecOptions options;
+   options.referenceLevelDb   = 0.0F;
+   options.rangeDb            = 128.0F;   // 0.5 dB per 8-bit code
+   options.delta              = true;
+   options.keyframeInterval   = 10;
+   options.deltaDeadbandCodes = 1;
+   options.lz4                = true;
+   return options;
+}
+
+} // namespace
+
+TEST(SpectrumCodecTest, DeltaStream_TracksInputWithinDeadband)
+{
+   // Arrange
+   SpectrumFrameEncoder encoder(streamingOptions());
+   SpectrumFrameDecoder decoder;
+   SpectrumSource source(1024);
+   messages::SpectrumFrame frame;
+   SpectrumData out;
+   const float step = 128.0F / 255.0F;
+
+   for (uint64_t sequence = 0; sequence < 25; ++sequence)
+   {
+      // Act
+      const SpectrumData& in = source.next();
+      encoder.encode(in, frame);
+      frame.set_sequence(sequence);
+      ASSERT_TRUE(decoder.decode(frame, out));
+
+      // Assert: key frames every 10, deadband + rounding error only
+      EXPECT_EQ(frame.delta(), sequence % 10 != 0) << sequence;
+      ASSERT_EQ(out.magnitudesDb.size(), in.magnitudesDb.size());
+      for (std::size_t i = 0; i < in.magnitudesDb.size(); ++i)
+      {
+         ASSERT_NEAR(out.magnitudesDb[i], in.magnitudesDb[i], 1.5F * step + 1e-3F) << sequence << " " << i;
+      }
+   }
+}
+
+TEST(SpectrumCodecTest, DeltaStream_AtLeastSixteenTimesSmallerThanFloat32)
+{
+   // Arrange: full resolution, so only quantization, deltas and LZ4 count
+   constexpr std::size_t BINS = 65536;
+   SpectrumFrameEncoder encoder(streamingOptions());
+   SpectrumSource source(BINS);
+   messages::SpectrumFrame frame;
+
+   // Act
+   std::size_t bytes = 0;
+   constexpr uint64_t FRAMES = 30;
+   for (uint64_t sequence = 0; sequence < FRAMES; ++sequence)
+   {
+      encoder.encode(source.next(), frame);
+      frame.set_sequence(sequence);
+      bytes += frame.ByteSizeLong();
+   }
+
+   // Assert
+   const std::size_t float32Bytes = FRAMES * BINS * sizeof(float);
+   EXPECT_GE(float32Bytes / bytes, 16U) << bytes << " bytes";
+}
+
+TEST(SpectrumCodecTest, MissedFrame_DeltasDiscardedUntilKeyframe)
+{
+   // Arrange
+   SpectrumFrameEncoder encoder(streamingOptions());
+   SpectrumFrameDecoder decoder;
+   SpectrumSource source(256);
+   messages::SpectrumFrame frame;
+   SpectrumData out;
+
+   // Act & Assert: frame 3 is lost
+   for (uint64_t sequence = 0; sequence < 12; ++sequence)
+   {
+      encoder.encode(source.next(), frame);
+      frame.set_sequence(sequence);
+      if (sequence == 3)
+      {
+         continue;
+      }
+      const bool expected = sequence < 3 || sequence >= 10;
+      EXPECT_EQ(decoder.decode(frame, out), expected) << sequence;
+   }
+   EXPECT_EQ(decoder.discardedDeltas(), 6U);
+}
+
+TEST(SpectrumCodecTest, RequestKeyframe_NextFrameIsKeyframe)
+{
+   // Arrange
+   SpectrumFrameEncoder encoder(streamingOptions());
+   SpectrumSource source(64);
+   messages::SpectrumFrame frame;
+   encoder.encode(source.next(), frame);
+   encoder.encode(source.next(), frame);
+   ASSERT_TRUE(frame.delta());
+
+   // Act
+   encoder.requestKeyframe();
+   encoder.encode(source.next(), frame);
+
+   // Assert
+   EXPECT_FALSE(frame.delta());
+}
+
+TEST(SpectrumCodecTest, SixteenBit_RoundTripsWithinHalfStep)
+{
+   // Arrange
+   SpectrumCodecOptions options = streamingOptions();
+   options.bitsPerCode        = 16;
+   options.deltaDeadbandCodes = 0;
+   SpectrumFrameEncoder encoder(options);
+   SpectrumFrameDecoder decoder;
+   SpectrumSource source(512);
+   messages::SpectrumFrame frame;
+   SpectrumData out;
+   const float step = 128.0F / 65535.0F;
+
+   for (uint64_t sequence = 0; sequence < 3; ++sequence)
+   {
+      // Act
+      const SpectrumData& in = source.next();
+      encoder.encode(in, frame);
+      frame.set_sequence(sequence);
+      ASSERT_TRUE(decoder.decode(frame, out));
+
+      // Assert
+      EXPECT_EQ(frame.bits_per_code(), 16U);
+      for (std::size_t i = 0; i < in.magnitudesDb.size(); ++i)
+      {
+         ASSERT_NEAR(out.magnitudesDb[i], in.magnitudesDb[i], (step / 2.0F) + 1e-3F);
+      }
+   }
+}
+
+TEST(SpectrumCodecTest, DecodeNormalized_MapsDisplayRange)
+{
+   // Arrange: -120, -70 and -20 dB against a -100..-40 dB display
+   SpectrumCodecOptions options;
+   options.referenceLevelDb = 0.0F;
+   options.rangeDb          = 127.5F;
+   SpectrumFrameEncoder encoder(options);
+   SpectrumFrameDecoder decoder;
+   SpectrumData in;
+   in.magnitudesDb = {-120.0F, -70.0F, -20.0F};
+   messages::SpectrumFrame frame;
+   std::vector<float> normalised;
+
+   // Act
+   encoder.encode(in, frame);
+   ASSERT_TRUE(decoder.decodeNormalized(frame, -100.0F, -40.0F, normalised));
+
+   // Assert
+   ASSERT_EQ(normalised.size(), 3U);
+   EXPECT_FLOAT_EQ(normalised[0], 0.0F);
+   EXPECT_NEAR(normalised[1], 0.5F, 0.25F / 60.0F);
+   EXPECT_FLOAT_EQ(normalised[2], 1.0F);
+}
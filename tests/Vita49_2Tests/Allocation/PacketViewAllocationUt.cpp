@@ -0,0 +1,98 @@
+/**
+ * @file PacketViewAllocationUt.cpp
+ * @brief Allocation-free header scan test for Vita49_2::PacketStreamView.
+ *
+ * Replaces the global operator new/delete to count allocations, so it is
+ * built as its own executable (UnitTests_Vita49_2_Allocation) rather than
+ * into UnitTests_Vita49_2.
+ */
+
+#include <gtest/gtest.h>
+#include "PacketView.h"
+#include "Vita49Codec.h"
+#include "Vita49TestData.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace Vita49_2;
+using namespace Vita49_2::TestData;
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+namespace
+{
+std::atomic<bool> countAllocations{false};
+std::atomic<size_t> allocations{0};
+} // anonymous namespace
+
+void* operator new(size_t size)
+{
+   if (countAllocations.load(std::memory_order_relaxed))
+   {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+   }
+   if (void* p = std::malloc(size == 0 ? 1 : size))
+   {
+      return p;
+   }
+   throw std::bad_alloc();
+}
+
+// Out of line, so GCC does not pair the inlined free() with a new-expression
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+   ::operator delete(p);
+}
+
+// ============================================================================
+// PacketStreamView
+// ============================================================================
+
+TEST(PacketStreamViewTest, HeaderScan_DoesNotAllocate)
+{
+   Vita49Codec codec;
+   std::vector<uint8_t> stream;
+   for (uint32_t id = 0; id < 50; ++id)
+   {
+      const auto packet = codec.encodeSignalData(id % 5, makeRamp(1000), 0, TSI::UTC, TSF::RealTime, id, 0);
+      stream.insert(stream.end(), packet.begin(), packet.end());
+   }
+   std::array<IQSample, 1000> buffer{};
+
+   // Count stream 3's samples and find its latest timestamp, decoding one packet
+   allocations = 0;
+   countAllocations = true;
+   size_t samples = 0;
+   uint32_t latest = 0;
+   size_t decoded = 0;
+   for (const PacketView& packet : PacketStreamView(stream))
+   {
+      if (packet.header().streamId == 3u)
+      {
+         samples += packet.sampleCount();
+         latest = std::max(latest, packet.header().integerTimestamp.value_or(0));
+         if (decoded == 0)
+         {
+            decoded = packet.decodeSamples(buffer);
+         }
+      }
+   }
+   countAllocations = false;
+
+   EXPECT_EQ(allocations.load(), 0u);
+   EXPECT_EQ(samples, 10u * 1000u);
+   EXPECT_EQ(latest, 48u);
+   EXPECT_EQ(decoded, 1000u);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file ContextCacheUt.cpp
+ * @brief Unit tests for Vita49_2::ContextCache.
+ */
+
+#include <gtest/gtest.h>
+#include "ContextCache.h"
+#include "ContextPacket.h"
+#include "PacketView.h"
+#include "SignalDataPacket.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace Vita49_2;
+
+namespace
+{
+
+ContextFields tuning(double rfFrequency)
+{
+   ContextFields fields;
+   fields.sampleRate  = 2'048'000.0;
+   fields.rfFrequency = rfFrequency;
+   fields.gain        = 12.5;
+   return fields;
+}
+
+// Feeds one encoded packet to the cache
+ContextCache::Update feed(ContextCache& cache, const std::vector<uint8_t>& packet,
+                          ByteOrder order = ByteOrder::BigEndian)
+{
+   const auto view = PacketView::parse(packet, order);
+   EXPECT_TRUE(view.has_value());
+   return view.has_value() ? cache.update(*view) : ContextCache::Update::Invalid;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Change detection
+// ============================================================================
+
+TEST(ContextCacheTest, RepeatedContext_FiresOnlyOnChange)
+{
+   std::vector<double> applied;
+   ContextCache cache([&](uint32_t streamId, const ContextFields& fields)
+                      {
+                         EXPECT_EQ(streamId, 7U);
+                         applied.push_back(fields.rfFrequency.value_or(0.0));
+                      });
+
+   // Count and timestamps differ between repeats; they are not fields
+   const auto first = ContextPacket::encode(7, tuning(100e6), 0, ByteOrder::BigEndian,
+                                            TSI::UTC, TSF::RealTime, 10, 20);
+   const auto again = ContextPacket::encode(7, tuning(100e6), 1, ByteOrder::BigEndian,
+                                            TSI::UTC, TSF::RealTime, 11, 30);
+   const auto moved = ContextPacket::encode(7, tuning(101e6), 2, ByteOrder::BigEndian,
+                                            TSI::UTC, TSF::RealTime, 12, 40);
+
+   EXPECT_EQ(feed(cache, first), ContextCache::Update::Changed);
+   EXPECT_EQ(feed(cache, again), ContextCache::Update::Unchanged);
+   EXPECT_EQ(feed(cache, moved), ContextCache::Update::Changed);
+   EXPECT_EQ(feed(cache, moved), ContextCache::Update::Unchanged);
+
+   ASSERT_EQ(applied.size(), 2U);
+   EXPECT_DOUBLE_EQ(applied[0], 100e6);
+   EXPECT_DOUBLE_EQ(applied[1], 101e6);
+   ASSERT_NE(cache.fields(7), nullptr);
+   EXPECT_DOUBLE_EQ(cache.fields(7)->rfFrequency.value_or(0.0), 101e6);
+}
+
+TEST(ContextCacheTest, ChangeIndicatorAlone_IsNotAChange)
+{
+   auto flagged = tuning(100e6);
+   flagged.changeIndicator = true;
+
+   ContextCache cache;
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, tuning(100e6), 0, ByteOrder::LittleEndian),
+                  ByteOrder::LittleEndian),
+             ContextCache::Update::Changed);
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, flagged, 1, ByteOrder::LittleEndian),
+                  ByteOrder::LittleEndian),
+             ContextCache::Update::Unchanged);
+}
+
+TEST(ContextCacheTest, AddedField_IsAChange)
+{
+   auto withBandwidth = tuning(100e6);
+   withBandwidth.bandwidth = 1.5e6;
+
+   ContextCache cache;
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, tuning(100e6), 0, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, withBandwidth, 1, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+   EXPECT_TRUE(cache.fields(1)->bandwidth.has_value());
+}
+
+TEST(ContextCacheTest, TrustedChangeIndicator_SkipsComparison)
+{
+   auto retuned = tuning(105e6);
+   ContextCache cache({}, true);
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, tuning(100e6), 0, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+
+   // Indicator clear: believed, although the frequency differs
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, retuned, 1, ByteOrder::BigEndian)),
+             ContextCache::Update::Unchanged);
+   EXPECT_DOUBLE_EQ(cache.fields(1)->rfFrequency.value_or(0.0), 100e6);
+
+   retuned.changeIndicator = true;
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, retuned, 2, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+   EXPECT_DOUBLE_EQ(cache.fields(1)->rfFrequency.value_or(0.0), 105e6);
+}
+
+// ============================================================================
+// Streams and errors
+// ============================================================================
+
+TEST(ContextCacheTest, Streams_AreCachedSeparately)
+{
+   ContextCache cache;
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, tuning(100e6), 0, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+   EXPECT_EQ(feed(cache, ContextPacket::encode(2, tuning(100e6), 0, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+   EXPECT_EQ(cache.streamCount(), 2U);
+   EXPECT_EQ(cache.fields(3), nullptr);
+
+   cache.clear();
+   EXPECT_EQ(cache.streamCount(), 0U);
+   EXPECT_EQ(feed(cache, ContextPacket::encode(1, tuning(100e6), 1, ByteOrder::BigEndian)),
+             ContextCache::Update::Changed);
+}
+
+TEST(ContextCacheTest, SignalData_IsInvalid)
+{
+   int calls = 0;
+   ContextCache cache([&](uint32_t, const ContextFields&) { ++calls; });
+   const IQSamples samples(16, {0.5f, -0.5f});
+   EXPECT_EQ(feed(cache, SignalDataPacket::encode(1, samples, 0, ByteOrder::BigEndian,
+                                                     DEFAULT_SCALE_FACTOR)),
+             ContextCache::Update::Invalid);
+   EXPECT_EQ(calls, 0);
+   EXPECT_EQ(cache.streamCount(), 0U);
+}
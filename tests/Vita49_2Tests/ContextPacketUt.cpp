@@ -385,6 +385,51 @@ TEST(ContextPacketTest, RoundTrip_AllSupportedFields_LittleEndian)
    EXPECT_NEAR(decoded->fields.sampleRate.value(),  10000000.0,   FREQ_TOL);
 }
 
+TEST(ContextPacketTest, RoundTrip_PayloadFormat)
+{
+   for (const PayloadFormat format : {PayloadFormat::Int16, PayloadFormat::Int8,
+                                      PayloadFormat::Int12Packed, PayloadFormat::Float32})
+   {
+      for (const ByteOrder order : {ByteOrder::BigEndian, ByteOrder::LittleEndian})
+      {
+         ContextFields original;
+         original.sampleRate    = 1.0e6;
+         original.payloadFormat = format;
+
+         const auto encoded = ContextPacket::encode(0x7, original, 0, order);
+         ASSERT_EQ(encoded.size(), 4u * 7);   // Header, stream ID, CIF0, 2 + 2 field words
+
+         size_t consumed = 0;
+         const auto decoded = ContextPacket::decode(encoded.data(), encoded.size(), order, consumed);
+         ASSERT_TRUE(decoded.has_value());
+         EXPECT_EQ(decoded->fields.payloadFormat, format);
+         EXPECT_NEAR(decoded->fields.sampleRate.value(), 1.0e6, FREQ_TOL);
+      }
+   }
+}
+
+TEST(ContextPacketTest, Decode_PayloadFormatDescriptor)
+{
+   // Link-efficient complex signed 12-bit items (VITA 49.2 9.13.3)
+   uint8_t data[20];
+   writeU32BE(data, 0x40000005);
+   writeU32BE(data + 4, 0x00000001);
+   writeU32BE(data + 8, 0x00008000);
+   writeU32BE(data + 12, 0xA00002CBu);
+   writeU32BE(data + 16, 0x00000000);
+
+   size_t consumed = 0;
+   auto result = ContextPacket::decode(data, sizeof(data), ByteOrder::BigEndian, consumed);
+   ASSERT_TRUE(result.has_value());
+   EXPECT_EQ(result->fields.payloadFormat, PayloadFormat::Int12Packed);
+
+   // Real (not complex) 16-bit items: not a format the codec handles
+   writeU32BE(data + 12, 0x000003CFu);
+   result = ContextPacket::decode(data, sizeof(data), ByteOrder::BigEndian, consumed);
+   ASSERT_TRUE(result.has_value());
+   EXPECT_FALSE(result->fields.payloadFormat.has_value());
+}
+
 TEST(ContextPacketTest, RoundTrip_FieldOrdering)
 {
    ContextFields original;
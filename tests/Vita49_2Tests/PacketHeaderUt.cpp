@@ -78,6 +78,29 @@ TEST(PacketHeaderTest, ParseWithClassId_BigEndian)
    EXPECT_EQ(headerBytes, 16u);
 }
 
+TEST(PacketHeaderTest, ClassIdPadBitCount_RoundTrip)
+{
+   PacketHeader header;
+   header.classIdPresent       = true;
+   header.streamId             = 0x1;
+   header.classIdOUI           = 0x123456;
+   header.informationClassCode = 0;
+   header.packetClassCode      = 0;
+   header.padBitCount          = 24;
+   header.packetSize           = 4;
+
+   std::vector<uint8_t> bytes;
+   PacketHeaderCodec::serialize(header, ByteOrder::BigEndian, bytes);
+   EXPECT_EQ(readU32BE(bytes.data() + 8), 0xC0123456u);   // Pad bits 31-27, OUI 23-0
+
+   PacketHeader parsed;
+   size_t headerBytes = 0;
+   ASSERT_TRUE(PacketHeaderCodec::parse(bytes.data(), bytes.size(), ByteOrder::BigEndian,
+                                        parsed, headerBytes));
+   EXPECT_EQ(parsed.padBitCount, 24u);
+   EXPECT_EQ(parsed.classIdOUI, 0x123456u);
+}
+
 TEST(PacketHeaderTest, ParseWithTimestamps_BigEndian)
 {
    // Type 1, TSI=UTC(01 bits 23-22), TSF=RealTime(10 bits 21-20)
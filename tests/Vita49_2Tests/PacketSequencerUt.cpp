@@ -0,0 +1,210 @@
+/**
+ * @file PacketSequencerUt.cpp
+ * @brief Unit tests for Vita49_2::PacketSequencer.
+ */
+
+#include <gtest/gtest.h>
+#include "ContextPacket.h"
+#include "PacketSequencer.h"
+#include "PacketView.h"
+#include "SignalDataPacket.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+using namespace Vita49_2;
+
+namespace
+{
+
+constexpr size_t SAMPLES_PER_PACKET = 10;
+
+std::vector<uint8_t> dataPacket(uint32_t streamId, uint8_t count)
+{
+   const IQSamples samples(SAMPLES_PER_PACKET, {static_cast<float>(count) / 16.0f, 0.0f});
+   return SignalDataPacket::encode(streamId, samples, count, ByteOrder::BigEndian,
+                                   DEFAULT_SCALE_FACTOR);
+}
+
+// Packet whose fractional timestamp is the count of its first sample
+std::vector<uint8_t> timedPacket(uint8_t count, uint64_t firstSample)
+{
+   const IQSamples samples(SAMPLES_PER_PACKET, {0.25f, 0.0f});
+   return SignalDataPacket::encode(1, samples, count, ByteOrder::BigEndian, DEFAULT_SCALE_FACTOR,
+                                   TSI::UTC, TSF::SampleCount, 1'700'000'000u, firstSample);
+}
+
+// Records what a sequencer passes on: packet counts, and -1 - missing
+// packets for each gap
+struct Recorder
+{
+   std::vector<int> events;
+   uint64_t gapSamples{0};
+
+   PacketSequencer make(size_t window)
+   {
+      return PacketSequencer(
+         [this](const PacketView& packet)
+         {
+            events.push_back(packet.isSignalData() ? packet.header().packetCount : 100);
+         },
+         [this](const PacketSequencer::Gap& gap)
+         {
+            events.push_back(-1 - static_cast<int>(gap.packets));
+            gapSamples += gap.samples;
+         },
+         window);
+   }
+};
+
+void push(PacketSequencer& sequencer, const std::vector<uint8_t>& packet)
+{
+   const auto view = PacketView::parse(packet);
+   ASSERT_TRUE(view.has_value());
+   sequencer.push(*view);
+}
+
+void pushCounts(PacketSequencer& sequencer, std::initializer_list<int> counts,
+                uint32_t streamId = 1)
+{
+   for (const int count : counts)
+   {
+      push(sequencer, dataPacket(streamId, static_cast<uint8_t>(count)));
+   }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Without a reorder window
+// ============================================================================
+
+TEST(PacketSequencerTest, InSequenceAcrossWrap_NoGaps)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(0);
+   pushCounts(sequencer, {13, 14, 15, 0, 1});
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{13, 14, 15, 0, 1}));
+   EXPECT_EQ(sequencer.delivered(), 5U);
+   EXPECT_EQ(sequencer.lostPackets(), 0U);
+}
+
+TEST(PacketSequencerTest, Loss_ReportedInSamplesBeforeNextPacket)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(0);
+   pushCounts(sequencer, {14, 15, 2, 3});
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{14, 15, -3, 2, 3}));
+   EXPECT_EQ(recorder.gapSamples, 2 * SAMPLES_PER_PACKET);
+   EXPECT_EQ(sequencer.lostPackets(), 2U);
+   EXPECT_EQ(sequencer.lostSamples(), 2 * SAMPLES_PER_PACKET);
+}
+
+TEST(PacketSequencerTest, Duplicate_IsDropped)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(0);
+   pushCounts(sequencer, {4, 5, 5, 6});
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{4, 5, 6}));
+   EXPECT_EQ(sequencer.duplicates(), 1U);
+   EXPECT_EQ(sequencer.lostPackets(), 0U);
+}
+
+TEST(PacketSequencerTest, SampleCountTimestamps_GiveExactGapBeyondCountWrap)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(0);
+
+   // 20 packets lost: the count only moves on by 4 (mod 16)
+   push(sequencer, timedPacket(0, 1000));
+   push(sequencer, timedPacket(5, 1000 + (21 * SAMPLES_PER_PACKET)));
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, -21, 5}));
+   EXPECT_EQ(recorder.gapSamples, 20 * SAMPLES_PER_PACKET);
+}
+
+TEST(PacketSequencerTest, StreamsAndOtherPackets_AreIndependent)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(0);
+
+   ContextFields fields;
+   fields.sampleRate = 1e6;
+   pushCounts(sequencer, {0}, 1);
+   pushCounts(sequencer, {7}, 2);
+   push(sequencer, ContextPacket::encode(1, fields, 9, ByteOrder::BigEndian));
+   pushCounts(sequencer, {1}, 1);
+   pushCounts(sequencer, {8}, 2);
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, 7, 100, 1, 8}));
+   EXPECT_EQ(sequencer.delivered(), 4U);
+}
+
+// ============================================================================
+// Reorder window
+// ============================================================================
+
+TEST(PacketSequencerTest, Window_RestoresOrder)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(3);
+   pushCounts(sequencer, {0, 2, 3, 1, 4});
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, 1, 2, 3, 4}));
+   EXPECT_EQ(sequencer.reordered(), 1U);
+   EXPECT_EQ(sequencer.lostPackets(), 0U);
+}
+
+TEST(PacketSequencerTest, Window_Full_DeclaresHoleLost)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(2);
+   pushCounts(sequencer, {0, 2, 3});
+   EXPECT_EQ(recorder.events, (std::vector<int>{0}));
+
+   pushCounts(sequencer, {4});
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, -2, 2, 3, 4}));
+
+   // Too late: already reported lost
+   pushCounts(sequencer, {1, 5});
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, -2, 2, 3, 4, 5}));
+   EXPECT_EQ(sequencer.duplicates(), 1U);
+}
+
+TEST(PacketSequencerTest, Window_BeyondReach_IsLostAtOnce)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(2);
+   pushCounts(sequencer, {0, 2, 6});
+
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, -2, 2, -4, 6}));
+   EXPECT_EQ(sequencer.lostPackets(), 4U);
+}
+
+TEST(PacketSequencerTest, Flush_ReleasesHeldPackets)
+{
+   Recorder recorder;
+   auto sequencer = recorder.make(4);
+   pushCounts(sequencer, {0, 3, 3, 2});
+   EXPECT_EQ(recorder.events, (std::vector<int>{0}));
+   EXPECT_EQ(sequencer.duplicates(), 1U);
+
+   sequencer.flush();
+   EXPECT_EQ(recorder.events, (std::vector<int>{0, -2, 2, 3}));
+
+   // reset() forgets the sequence: the next packet starts it again
+   sequencer.reset();
+   pushCounts(sequencer, {9});
+   EXPECT_EQ(recorder.events.back(), 9);
+   EXPECT_EQ(sequencer.lostPackets(), 1U);
+}
+
+TEST(PacketSequencerTest, Window_IsCapped)
+{
+   Recorder recorder;
+   EXPECT_EQ(recorder.make(100).reorderWindow(), PacketSequencer::MAX_REORDER_WINDOW);
+}
@@ -0,0 +1,212 @@
+/**
+ * @file PacketViewUt.cpp
+ * @brief Unit tests for Vita49_2::PacketView and PacketStreamView.
+ */
+
+#include <gtest/gtest.h>
+#include "PacketView.h"
+#include "Vita49Codec.h"
+#include "Vita49TestData.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace Vita49_2;
+using namespace Vita49_2::TestData;
+
+static constexpr float SCALE     = DEFAULT_SCALE_FACTOR;
+static constexpr float TOLERANCE = (1.0f / SCALE) + 1e-6f;
+
+// ============================================================================
+// PacketView
+// ============================================================================
+
+TEST(PacketViewTest, Parse_SignalData_PayloadPointsIntoBuffer)
+{
+   Vita49Codec codec;
+   const auto encoded = codec.encodeSignalData(0xABCD, makeRamp(8), 3, TSI::GPS, TSF::SampleCount, 42, 99);
+
+   const auto view = PacketView::parse(encoded);
+
+   ASSERT_TRUE(view.has_value());
+   EXPECT_TRUE(view->isSignalData());
+   EXPECT_FALSE(view->isContext());
+   EXPECT_EQ(view->header().streamId, 0xABCDu);
+   EXPECT_EQ(view->header().packetCount, 3u);
+   EXPECT_EQ(view->header().integerTimestamp, 42u);
+   EXPECT_EQ(view->header().fractionalTimestamp, 99u);
+   EXPECT_EQ(view->bytes().data(), encoded.data());
+   EXPECT_EQ(view->bytes().size(), encoded.size());
+   EXPECT_EQ(view->payload().data(), encoded.data() + 20);   // Word 0, stream ID, TSI, TSF
+   EXPECT_EQ(view->sampleCount(), 8u);
+   EXPECT_FALSE(view->trailer().has_value());
+}
+
+TEST(PacketViewTest, DecodeSamples_MatchesEagerDecode)
+{
+   Vita49Codec codec(ByteOrder::LittleEndian);
+   const IQSamples samples = makeRamp(300);
+   const auto encoded = codec.encodeSignalData(0x1, samples, 0, TSI::None, TSF::None, 0, 0, true);
+   const auto eager = codec.parseStream(encoded.data(), encoded.size());
+   ASSERT_EQ(eager.size(), 1u);
+
+   const auto view = PacketView::parse(encoded, ByteOrder::LittleEndian);
+   ASSERT_TRUE(view.has_value());
+   IQSamples out(view->sampleCount());
+   const size_t written = codec.decodeSamples(*view, out);
+
+   ASSERT_EQ(written, samples.size());
+   EXPECT_EQ(out, eager[0].samples);
+   EXPECT_EQ(view->trailer(), 0u);
+}
+
+TEST(PacketViewTest, DecodeSamples_InPiecesIntoSmallBuffer)
+{
+   Vita49Codec codec;
+   const IQSamples samples = makeRamp(250);
+   const auto encoded = codec.encodeSignalData(0x1, samples);
+   const auto view = PacketView::parse(encoded);
+   ASSERT_TRUE(view.has_value());
+
+   std::array<IQSample, 64> chunk{};
+   IQSamples all;
+   size_t first = 0;
+   while (const size_t n = view->decodeSamples(chunk, SCALE, first))
+   {
+      all.insert(all.end(), chunk.begin(), chunk.begin() + static_cast<ptrdiff_t>(n));
+      first += n;
+   }
+
+   ASSERT_EQ(all.size(), samples.size());
+   for (size_t i = 0; i < samples.size(); ++i)
+   {
+      EXPECT_NEAR(all[i].real(), samples[i].real(), TOLERANCE);
+      EXPECT_NEAR(all[i].imag(), samples[i].imag(), TOLERANCE);
+   }
+}
+
+TEST(PacketViewTest, DecodeSamples_PackedFormatFromAnySample)
+{
+   Vita49Codec codec;
+   codec.setPayloadFormat(PayloadFormat::Int12Packed);
+   const IQSamples samples = makeRamp(7);
+   const auto encoded = codec.encodeSignalData(0x1, samples);
+
+   // Read in the default format, the payload looks like 16-bit samples
+   auto view = PacketView::parse(encoded);
+   ASSERT_TRUE(view.has_value());
+   EXPECT_EQ(view->sampleCount(), 5u);
+
+   view->setPayloadFormat(PayloadFormat::Int12Packed);
+   EXPECT_EQ(view->sampleCount(), samples.size());
+   for (size_t first = 0; first < samples.size(); ++first)
+   {
+      IQSamples out(2);
+      const size_t written = view->decodeSamples(out, SCALE, first);
+      ASSERT_EQ(written, std::min<size_t>(2, samples.size() - first));
+      for (size_t i = 0; i < written; ++i)
+      {
+         EXPECT_NEAR(out[i].real(), samples[first + i].real(), 16 * TOLERANCE);
+         EXPECT_NEAR(out[i].imag(), samples[first + i].imag(), 16 * TOLERANCE);
+      }
+   }
+}
+
+TEST(PacketViewTest, Parse_Context_FieldsOnRequest)
+{
+   Vita49Codec codec;
+   ContextFields fields;
+   fields.bandwidth = 1.5e6;
+   const auto encoded = codec.encodeContext(0x7, fields);
+
+   const auto view = PacketView::parse(encoded);
+
+   ASSERT_TRUE(view.has_value());
+   EXPECT_TRUE(view->isContext());
+   EXPECT_EQ(view->sampleCount(), 0u);
+   std::array<IQSample, 4> out{};
+   EXPECT_EQ(view->decodeSamples(out), 0u);
+   const auto decoded = view->contextFields();
+   ASSERT_TRUE(decoded.has_value());
+   EXPECT_DOUBLE_EQ(decoded->bandwidth.value_or(0.0), 1.5e6);
+}
+
+TEST(PacketViewTest, Parse_Truncated_ReturnsNullopt)
+{
+   Vita49Codec codec;
+   const auto encoded = codec.encodeSignalData(0x1, makeRamp(8));
+
+   const std::span<const uint8_t> truncated(encoded.data(), encoded.size() - 4);
+
+   EXPECT_FALSE(PacketView::parse(truncated).has_value());
+   EXPECT_FALSE(PacketView::parse({}).has_value());
+}
+
+// ============================================================================
+// PacketStreamView
+// ============================================================================
+
+TEST(PacketStreamViewTest, IteratesMixedStream)
+{
+   Vita49Codec codec;
+   const auto stream = makeMixedStream(codec, 3);
+
+   std::vector<uint32_t> streamIds;
+   std::vector<size_t> sampleCounts;
+   for (const PacketView& packet : codec.viewStream(stream.data(), stream.size()))
+   {
+      streamIds.push_back(packet.header().streamId.value_or(0));
+      sampleCounts.push_back(packet.sampleCount());
+   }
+
+   EXPECT_EQ(streamIds, (std::vector<uint32_t>{1, 2, 3}));
+   EXPECT_EQ(sampleCounts, (std::vector<size_t>{37, 74, 0}));
+   EXPECT_EQ(codec.viewStream(stream.data(), stream.size()).bytesParsed(), stream.size());
+}
+
+TEST(PacketStreamViewTest, IteratesChangingLayouts)
+{
+   Vita49Codec codec;
+   std::vector<uint8_t> stream;
+   for (uint32_t id = 0; id < 6; ++id)
+   {
+      // Timestamps on every other packet, a trailer on every third
+      const TSI tsi = ((id % 2) != 0) ? TSI::UTC : TSI::None;
+      const TSF tsf = ((id % 2) != 0) ? TSF::SampleCount : TSF::None;
+      const auto packet = codec.encodeSignalData(id, makeRamp(3 + id), 0, tsi, tsf, id, id, (id % 3) == 0);
+      stream.insert(stream.end(), packet.begin(), packet.end());
+   }
+
+   std::vector<uint32_t> streamIds;
+   std::vector<size_t> sampleCounts;
+   std::vector<uint32_t> timestamps;
+   for (const PacketView& packet : codec.viewStream(stream.data(), stream.size()))
+   {
+      streamIds.push_back(packet.header().streamId.value_or(99));
+      sampleCounts.push_back(packet.sampleCount());
+      timestamps.push_back(packet.header().integerTimestamp.value_or(99));
+   }
+
+   EXPECT_EQ(streamIds, (std::vector<uint32_t>{0, 1, 2, 3, 4, 5}));
+   EXPECT_EQ(sampleCounts, (std::vector<size_t>{3, 4, 5, 6, 7, 8}));
+   EXPECT_EQ(timestamps, (std::vector<uint32_t>{99, 1, 99, 3, 99, 5}));
+}
+
+TEST(PacketStreamViewTest, StopsAtTruncatedPacket)
+{
+   Vita49Codec codec;
+   auto stream = makeMixedStream(codec, 3);
+   const size_t full = stream.size();
+   stream.resize(full - 8);
+
+   const PacketStreamView view(stream);
+   size_t packets = 0;
+   for (auto it = view.begin(); it != view.end(); ++it)
+   {
+      ++packets;
+   }
+
+   EXPECT_EQ(packets, 2u);
+   EXPECT_LT(view.bytesParsed(), stream.size());
+}
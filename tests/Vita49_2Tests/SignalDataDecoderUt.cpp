@@ -0,0 +1,198 @@
+/**
+ * @file SignalDataDecoderUt.cpp
+ * @brief Unit tests for Vita49_2::SignalDataDecoder.
+ */
+
+#include <gtest/gtest.h>
+#include "ContextPacket.h"
+#include "PacketHeader.h"
+#include "PacketView.h"
+#include "SampleConversion.h"
+#include "SignalDataDecoder.h"
+#include "SignalDataPacket.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace Vita49_2;
+
+static constexpr float SCALE = DEFAULT_SCALE_FACTOR;
+
+namespace
+{
+
+IQSamples makeRamp(size_t count)
+{
+   IQSamples samples(count);
+   for (size_t i = 0; i < count; ++i)
+   {
+      samples[i] = {static_cast<float>(i) / 256.0f, -static_cast<float>(i) / 512.0f};
+   }
+   return samples;
+}
+
+// Data packet with every optional field chosen by the bits of `layout`:
+// stream ID 0x1, Class ID 0x2, TSI 0x4, TSF 0x8, trailer 0x10
+std::vector<uint8_t> buildPacket(unsigned layout, ByteOrder order, const IQSamples& samples)
+{
+   PacketHeader header;
+   header.packetType = ((layout & 0x1u) != 0) ? PacketType::IFDataWithStreamId
+                                              : PacketType::IFDataWithoutStreamId;
+   header.classIdPresent = (layout & 0x2u) != 0;
+   header.tsiType        = ((layout & 0x4u) != 0) ? TSI::GPS : TSI::None;
+   header.tsfType        = ((layout & 0x8u) != 0) ? TSF::RealTime : TSF::None;
+   header.trailerPresent = (layout & 0x10u) != 0;
+   header.packetCount    = 9;
+   header.streamId             = 0xCAFE0001u;
+   header.classIdOUI           = 0x00123456u;
+   header.informationClassCode = 0x1111;
+   header.packetClassCode      = 0x2222;
+   header.integerTimestamp     = 1'700'000'000u;
+   header.fractionalTimestamp  = 123'456'789'012ULL;
+
+   const size_t headerBytes  = PacketHeaderCodec::sizeInBytes(header);
+   const size_t trailerBytes = header.trailerPresent ? 4 : 0;
+   header.packetSize = static_cast<uint16_t>((headerBytes + (4 * samples.size()) + trailerBytes) / 4);
+
+   std::vector<uint8_t> packet(static_cast<size_t>(header.packetSize) * 4, 0);
+   PacketHeaderCodec::serialize(header, order, packet.data());
+   convertFloatToInt16(reinterpret_cast<const float*>(samples.data()), packet.data() + headerBytes,
+                       2 * samples.size(), order, SCALE);
+   return packet;
+}
+
+void expectSameHeader(const PacketHeader& actual, const PacketHeader& expected)
+{
+   EXPECT_EQ(actual.packetType, expected.packetType);
+   EXPECT_EQ(actual.classIdPresent, expected.classIdPresent);
+   EXPECT_EQ(actual.trailerPresent, expected.trailerPresent);
+   EXPECT_EQ(actual.tsiType, expected.tsiType);
+   EXPECT_EQ(actual.tsfType, expected.tsfType);
+   EXPECT_EQ(actual.packetCount, expected.packetCount);
+   EXPECT_EQ(actual.packetSize, expected.packetSize);
+   EXPECT_EQ(actual.padBitCount, expected.padBitCount);
+   EXPECT_EQ(actual.streamId, expected.streamId);
+   EXPECT_EQ(actual.classIdOUI, expected.classIdOUI);
+   EXPECT_EQ(actual.informationClassCode, expected.informationClassCode);
+   EXPECT_EQ(actual.packetClassCode, expected.packetClassCode);
+   EXPECT_EQ(actual.integerTimestamp, expected.integerTimestamp);
+   EXPECT_EQ(actual.fractionalTimestamp, expected.fractionalTimestamp);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+TEST(SignalDataDecoderTest, Decode_EveryLayoutMatchesGenericDecode)
+{
+   const auto samples = makeRamp(37);
+   for (const ByteOrder order : {ByteOrder::BigEndian, ByteOrder::LittleEndian})
+   {
+      for (unsigned layout = 0; layout < 32; ++layout)
+      {
+         SCOPED_TRACE(testing::Message() << "layout " << layout
+                                         << (order == ByteOrder::BigEndian ? " BE" : " LE"));
+         const auto packet = buildPacket(layout, order, samples);
+
+         const auto decoder = SignalDataDecoder::select(packet.data(), packet.size(), order);
+         ASSERT_TRUE(decoder.has_value());
+         EXPECT_TRUE(decoder->matches(packet.data(), packet.size()));
+
+         size_t expectedBytes = 0;
+         size_t actualBytes   = 0;
+         const auto expected = SignalDataPacket::decode(packet.data(), packet.size(), order, SCALE,
+                                                        expectedBytes);
+         const auto actual = decoder->decode(packet.data(), packet.size(), SCALE, actualBytes);
+         ASSERT_TRUE(expected.has_value());
+         ASSERT_TRUE(actual.has_value());
+         EXPECT_EQ(actualBytes, expectedBytes);
+         expectSameHeader(actual->header, expected->header);
+         EXPECT_EQ(actual->samples, expected->samples);
+
+         const auto generic = PacketView::parse(packet, order);
+         const auto view    = decoder->view(packet);
+         ASSERT_TRUE(generic.has_value());
+         ASSERT_TRUE(view.has_value());
+         expectSameHeader(view->header(), generic->header());
+         EXPECT_EQ(view->payload().data(), generic->payload().data());
+         EXPECT_EQ(view->payload().size(), generic->payload().size());
+         EXPECT_EQ(view->trailer(), generic->trailer());
+      }
+   }
+}
+
+TEST(SignalDataDecoderTest, Decode_PackedFormatHonoursPadBits)
+{
+   const auto samples = makeRamp(5);
+   const auto packet = SignalDataPacket::encode(7, samples, 0, ByteOrder::BigEndian, SCALE,
+                                                TSI::UTC, TSF::SampleCount, 10, 20, false,
+                                                PayloadFormat::Int8);
+   const auto decoder = SignalDataDecoder::select(packet.data(), packet.size(), ByteOrder::BigEndian);
+   ASSERT_TRUE(decoder.has_value());
+
+   size_t consumed = 0;
+   const auto expected = SignalDataPacket::decode(packet.data(), packet.size(), ByteOrder::BigEndian,
+                                                  SCALE, consumed, PayloadFormat::Int8);
+   const auto actual = decoder->decode(packet.data(), packet.size(), SCALE, consumed,
+                                       PayloadFormat::Int8);
+   ASSERT_TRUE(actual.has_value());
+   EXPECT_EQ(actual->header.padBitCount, 16);
+   EXPECT_EQ(actual->samples, expected->samples);
+   EXPECT_EQ(actual->samples.size(), 5U);
+}
+
+// ============================================================================
+// Layout changes and errors
+// ============================================================================
+
+TEST(SignalDataDecoderTest, OtherLayout_IsRejected)
+{
+   const auto samples = makeRamp(8);
+   const auto plain = SignalDataPacket::encode(1, samples, 0, ByteOrder::BigEndian, SCALE);
+   const auto timed = SignalDataPacket::encode(1, samples, 1, ByteOrder::BigEndian, SCALE,
+                                               TSI::UTC, TSF::RealTime, 5, 6);
+   const auto utc   = SignalDataPacket::encode(1, samples, 2, ByteOrder::BigEndian, SCALE,
+                                               TSI::GPS, TSF::RealTime, 5, 6);
+
+   const auto decoder = SignalDataDecoder::select(timed.data(), timed.size(), ByteOrder::BigEndian);
+   ASSERT_TRUE(decoder.has_value());
+
+   // Another packet count and size is the same layout; another TSI type is not
+   EXPECT_TRUE(decoder->matches(timed.data(), timed.size()));
+   EXPECT_FALSE(decoder->matches(plain.data(), plain.size()));
+   EXPECT_FALSE(decoder->matches(utc.data(), utc.size()));
+
+   size_t consumed = 0;
+   EXPECT_FALSE(decoder->decode(plain.data(), plain.size(), SCALE, consumed).has_value());
+   EXPECT_FALSE(decoder->view(utc).has_value());
+}
+
+TEST(SignalDataDecoderTest, Select_OnlyDataPackets)
+{
+   ContextFields fields;
+   fields.sampleRate = 1e6;
+   const auto context = ContextPacket::encode(1, fields, 0, ByteOrder::BigEndian);
+   EXPECT_FALSE(SignalDataDecoder::select(context.data(), context.size(), ByteOrder::BigEndian)
+                   .has_value());
+   EXPECT_FALSE(SignalDataDecoder::select(nullptr, 0, ByteOrder::BigEndian).has_value());
+}
+
+TEST(SignalDataDecoderTest, Decode_TruncatedOrUndersized_ReturnsNullopt)
+{
+   const auto packet = buildPacket(0x1F, ByteOrder::BigEndian, makeRamp(4));
+   const auto decoder = SignalDataDecoder::select(packet.data(), packet.size(), ByteOrder::BigEndian);
+   ASSERT_TRUE(decoder.has_value());
+
+   size_t consumed = 0;
+   EXPECT_FALSE(decoder->decode(packet.data(), packet.size() - 4, SCALE, consumed).has_value());
+   EXPECT_FALSE(decoder->decode(packet.data(), packet.size(), 0.0f, consumed).has_value());
+
+   // Size word smaller than the header and trailer the layout announces
+   auto undersized = packet;
+   undersized[2] = 0;
+   undersized[3] = 3;
+   EXPECT_FALSE(decoder->decode(undersized.data(), undersized.size(), SCALE, consumed).has_value());
+   EXPECT_FALSE(PacketView::parse(undersized).has_value());
+}
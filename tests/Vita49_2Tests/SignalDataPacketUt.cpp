@@ -6,8 +6,14 @@
 #include <gtest/gtest.h>
 #include "SignalDataPacket.h"
 #include "ByteSwap.h"
+#include "SampleConversion.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
 
 using namespace Vita49_2;
 
@@ -276,6 +282,303 @@ TEST(SignalDataPacketTest, Encode_EmptySamples)
    EXPECT_EQ(packet.size(), 8u);
 }
 
+// ============================================================================
+// Vectorised conversion — bit-exact against the scalar reference
+// ============================================================================
+
+namespace
+{
+
+// Odd length, so every kernel also runs its scalar tail.
+constexpr size_t KERNEL_SAMPLES = 1003;
+
+IQSamples makeKernelInput()
+{
+   IQSamples samples(KERNEL_SAMPLES);
+   std::mt19937 gen(7);
+   std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+   for (auto& sample : samples)
+   {
+      sample = {dist(gen), dist(gen)};
+   }
+   // Exact ties, saturation and NaN
+   samples[0] = {0.5f / SCALE, -0.5f / SCALE};
+   samples[1] = {1.5f / SCALE, -2.5f / SCALE};
+   samples[2] = {32767.5f / SCALE, -32768.5f / SCALE};
+   samples[3] = {1.0e6f, -1.0e6f};
+   samples[4] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()};
+   return samples;
+}
+
+int16_t referenceEncode(float value)
+{
+   const float scaled = value * SCALE;
+   if (std::isnan(scaled))
+   {
+      return 0;
+   }
+   return static_cast<int16_t>(std::lroundf(std::clamp(scaled, -32768.0f, 32767.0f)));
+}
+
+} // anonymous namespace
+
+TEST(SignalDataPacketTest, Encode_MatchesScalarReference)
+{
+   const IQSamples samples = makeKernelInput();
+
+   for (const ByteOrder order : {ByteOrder::BigEndian, ByteOrder::LittleEndian})
+   {
+      auto packet = SignalDataPacket::encode(0x1, samples, 0, order, SCALE);
+      ASSERT_EQ(packet.size(), 8 + (4 * KERNEL_SAMPLES));
+
+      for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+      {
+         const uint8_t* word = packet.data() + 8 + (4 * i);
+         const bool big = (order == ByteOrder::BigEndian);
+         EXPECT_EQ(big ? readI16BE(word) : readI16LE(word), referenceEncode(samples[i].real()))
+            << sampleConversionIsa() << " sample " << i;
+         EXPECT_EQ(big ? readI16BE(word + 2) : readI16LE(word + 2), referenceEncode(samples[i].imag()))
+            << sampleConversionIsa() << " sample " << i;
+      }
+   }
+}
+
+TEST(SignalDataPacketTest, Decode_MatchesScalarReference)
+{
+   std::vector<uint8_t> payload(4 * KERNEL_SAMPLES);
+   std::mt19937 gen(11);
+   std::uniform_int_distribution<int> dist(0, 255);
+   std::generate(payload.begin(), payload.end(), [&] { return static_cast<uint8_t>(dist(gen)); });
+   const float invScale = 1.0f / SCALE;
+
+   for (const ByteOrder order : {ByteOrder::BigEndian, ByteOrder::LittleEndian})
+   {
+      IQSamples decoded(KERNEL_SAMPLES);
+      SignalDataPacket::decodeSamples(payload.data(), KERNEL_SAMPLES, order, SCALE, decoded.data());
+
+      for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+      {
+         const uint8_t* word = payload.data() + (4 * i);
+         const bool big = (order == ByteOrder::BigEndian);
+         const float iRef = static_cast<float>(big ? readI16BE(word) : readI16LE(word)) * invScale;
+         const float qRef = static_cast<float>(big ? readI16BE(word + 2) : readI16LE(word + 2)) * invScale;
+         EXPECT_EQ(decoded[i].real(), iRef) << sampleConversionIsa() << " sample " << i;
+         EXPECT_EQ(decoded[i].imag(), qRef) << sampleConversionIsa() << " sample " << i;
+      }
+   }
+}
+
+// ============================================================================
+// Compact and float payload formats
+// ============================================================================
+
+namespace
+{
+
+constexpr ByteOrder ORDERS[] = {ByteOrder::BigEndian, ByteOrder::LittleEndian};
+
+// lroundf() of the clamped, NaN-free scaled value, as the kernels do
+int32_t referenceRound(float value, float scale, float lo, float hi)
+{
+   const float scaled = value * scale;
+   return std::isnan(scaled) ? 0 : static_cast<int32_t>(std::lroundf(std::clamp(scaled, lo, hi)));
+}
+
+// Packed 12-bit pair number `k` of a payload, as `I << 12 | Q`
+uint32_t int12Pair(const uint8_t* payload, size_t k, ByteOrder order)
+{
+   const uint8_t* p = payload + (3 * k);
+   return (order == ByteOrder::BigEndian)
+      ? (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2]
+      : (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[0];
+}
+
+int32_t signExtend12(uint32_t value)
+{
+   return static_cast<int32_t>((value & 0xFFFu) << 20) >> 20;
+}
+
+} // anonymous namespace
+
+TEST(SignalDataPacketTest, Encode_Int8_MatchesScalarReference)
+{
+   const IQSamples samples = makeKernelInput();
+   const auto packet = SignalDataPacket::encode(0x1, samples, 0, ByteOrder::BigEndian, SCALE,
+                                                TSI::None, TSF::None, 0, 0, false,
+                                                PayloadFormat::Int8);
+
+   // Odd sample count: 16 pad bits, so a Class ID follows the stream ID
+   ASSERT_EQ(packet.size(), 16 + (2 * KERNEL_SAMPLES) + 2);
+   const uint8_t* payload = packet.data() + 16;
+   for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+   {
+      EXPECT_EQ(static_cast<int8_t>(payload[2 * i]),
+                referenceRound(samples[i].real(), SCALE / 256.0f, -128.0f, 127.0f))
+         << sampleConversionIsa() << " sample " << i;
+      EXPECT_EQ(static_cast<int8_t>(payload[(2 * i) + 1]),
+                referenceRound(samples[i].imag(), SCALE / 256.0f, -128.0f, 127.0f))
+         << sampleConversionIsa() << " sample " << i;
+   }
+}
+
+TEST(SignalDataPacketTest, Encode_Int12_MatchesScalarReference)
+{
+   const IQSamples samples = makeKernelInput();
+
+   for (const ByteOrder order : ORDERS)
+   {
+      const auto packet = SignalDataPacket::encode(0x1, samples, 0, order, SCALE,
+                                                   TSI::None, TSF::None, 0, 0, false,
+                                                   PayloadFormat::Int12Packed);
+
+      // 3009 payload bytes: 24 pad bits
+      ASSERT_EQ(packet.size(), 16 + (3 * KERNEL_SAMPLES) + 3);
+      for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+      {
+         const uint32_t pair = int12Pair(packet.data() + 16, i, order);
+         EXPECT_EQ(signExtend12(pair >> 12),
+                   referenceRound(samples[i].real(), SCALE / 16.0f, -2048.0f, 2047.0f))
+            << sampleConversionIsa() << " sample " << i;
+         EXPECT_EQ(signExtend12(pair),
+                   referenceRound(samples[i].imag(), SCALE / 16.0f, -2048.0f, 2047.0f))
+            << sampleConversionIsa() << " sample " << i;
+      }
+   }
+}
+
+TEST(SignalDataPacketTest, Decode_CompactFormats_MatchScalarReference)
+{
+   std::vector<uint8_t> payload(8 * KERNEL_SAMPLES);
+   std::mt19937 gen(13);
+   std::uniform_int_distribution<int> dist(0, 255);
+   std::generate(payload.begin(), payload.end(), [&] { return static_cast<uint8_t>(dist(gen)); });
+
+   IQSamples decoded(KERNEL_SAMPLES);
+   SignalDataPacket::decodeSamples(payload.data(), KERNEL_SAMPLES, ByteOrder::BigEndian, SCALE,
+                                   decoded.data(), PayloadFormat::Int8);
+   for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+   {
+      EXPECT_EQ(decoded[i].real(), static_cast<float>(static_cast<int8_t>(payload[2 * i])) * (256.0f / SCALE))
+         << sampleConversionIsa() << " sample " << i;
+      EXPECT_EQ(decoded[i].imag(), static_cast<float>(static_cast<int8_t>(payload[(2 * i) + 1])) * (256.0f / SCALE))
+         << sampleConversionIsa() << " sample " << i;
+   }
+
+   for (const ByteOrder order : ORDERS)
+   {
+      SignalDataPacket::decodeSamples(payload.data(), KERNEL_SAMPLES, order, SCALE,
+                                      decoded.data(), PayloadFormat::Int12Packed);
+      for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+      {
+         const uint32_t pair = int12Pair(payload.data(), i, order);
+         EXPECT_EQ(decoded[i].real(), static_cast<float>(signExtend12(pair >> 12)) * (16.0f / SCALE))
+            << sampleConversionIsa() << " sample " << i;
+         EXPECT_EQ(decoded[i].imag(), static_cast<float>(signExtend12(pair)) * (16.0f / SCALE))
+            << sampleConversionIsa() << " sample " << i;
+      }
+
+      SignalDataPacket::decodeSamples(payload.data(), KERNEL_SAMPLES, order, SCALE,
+                                      decoded.data(), PayloadFormat::Float32);
+      for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+      {
+         const uint8_t* word = payload.data() + (8 * i);
+         const bool big = (order == ByteOrder::BigEndian);
+         const auto iBits = big ? readU32BE(word) : readU32LE(word);
+         const auto qBits = big ? readU32BE(word + 4) : readU32LE(word + 4);
+         // Compare bits: random words include NaNs
+         EXPECT_EQ(std::bit_cast<uint32_t>(decoded[i].real()), iBits) << sampleConversionIsa() << " sample " << i;
+         EXPECT_EQ(std::bit_cast<uint32_t>(decoded[i].imag()), qBits) << sampleConversionIsa() << " sample " << i;
+      }
+   }
+}
+
+TEST(SignalDataPacketTest, RoundTrip_EveryFormatAndByteOrder)
+{
+   IQSamples samples(KERNEL_SAMPLES);
+   std::mt19937 gen(17);
+   std::uniform_real_distribution<float> dist(-0.99f, 0.99f);
+   for (auto& sample : samples)
+   {
+      sample = {dist(gen), dist(gen)};
+   }
+
+   // Half an LSB of each integer format; Float32 is exact
+   const std::pair<PayloadFormat, float> formats[] = {
+      {PayloadFormat::Int16, 0.5f / SCALE},
+      {PayloadFormat::Int8, 128.0f / SCALE},
+      {PayloadFormat::Int12Packed, 8.0f / SCALE},
+      {PayloadFormat::Float32, 0.0f}};
+
+   for (const auto& [format, tolerance] : formats)
+   {
+      for (const ByteOrder order : ORDERS)
+      {
+         const auto packet = SignalDataPacket::encode(0x9, samples, 3, order, SCALE,
+                                                      TSI::UTC, TSF::SampleCount, 77, 1234, true,
+                                                      format);
+         ASSERT_EQ(packet.size(), SignalDataPacket::encodedSize(KERNEL_SAMPLES, TSI::UTC, TSF::SampleCount,
+                                                                true, format));
+
+         size_t consumed = 0;
+         const auto result = SignalDataPacket::decode(packet.data(), packet.size(), order, SCALE,
+                                                      consumed, format);
+         ASSERT_TRUE(result.has_value());
+         EXPECT_EQ(consumed, packet.size());
+         EXPECT_EQ(result->header.fractionalTimestamp, 1234u);
+         ASSERT_EQ(result->samples.size(), KERNEL_SAMPLES);
+         for (size_t i = 0; i < KERNEL_SAMPLES; ++i)
+         {
+            EXPECT_NEAR(result->samples[i].real(), samples[i].real(), tolerance) << "sample " << i;
+            EXPECT_NEAR(result->samples[i].imag(), samples[i].imag(), tolerance) << "sample " << i;
+         }
+      }
+   }
+}
+
+TEST(SignalDataPacketTest, Encode_PartialLastWord_CountsPadBits)
+{
+   const IQSamples samples(5, IQSample{0.25f, -0.25f});
+
+   for (size_t count = 1; count <= samples.size(); ++count)
+   {
+      const std::span<const IQSample> part(samples.data(), count);
+      const auto packet = SignalDataPacket::encode(0x1, part, 0, ByteOrder::BigEndian, SCALE,
+                                                   TSI::None, TSF::None, 0, 0, false,
+                                                   PayloadFormat::Int12Packed);
+      const size_t padBits = ((4 - ((3 * count) % 4)) % 4) * 8;
+
+      size_t consumed = 0;
+      const auto result = SignalDataPacket::decode(packet.data(), packet.size(), ByteOrder::BigEndian,
+                                                   SCALE, consumed, PayloadFormat::Int12Packed);
+      ASSERT_TRUE(result.has_value());
+      EXPECT_EQ(result->header.classIdPresent, padBits != 0) << count << " samples";
+      EXPECT_EQ(result->header.padBitCount, padBits) << count << " samples";
+      EXPECT_EQ(result->samples.size(), count);
+      EXPECT_TRUE(std::all_of(packet.end() - static_cast<std::ptrdiff_t>(padBits / 8), packet.end(),
+                              [](uint8_t byte) { return byte == 0; }));
+   }
+}
+
+TEST(SignalDataPacketTest, MaxSamplesPerPacket_WholeWordsPerFormat)
+{
+   // Room for the Class ID is kept where a short packet needs pad bits
+   EXPECT_EQ(SignalDataPacket::maxSamplesPerPacket(TSI::None, TSF::None, false, false,
+                                                   PayloadFormat::Int8), 131062u);
+   EXPECT_EQ(SignalDataPacket::maxSamplesPerPacket(TSI::None, TSF::None, false, false,
+                                                   PayloadFormat::Int12Packed), 87372u);
+   EXPECT_EQ(SignalDataPacket::maxSamplesPerPacket(TSI::None, TSF::None, false, false,
+                                                   PayloadFormat::Float32), 32766u);
+
+   for (const PayloadFormat format : {PayloadFormat::Int8, PayloadFormat::Int12Packed, PayloadFormat::Float32})
+   {
+      const size_t max = SignalDataPacket::maxSamplesPerPacket(TSI::UTC, TSF::RealTime, false, true, format);
+      EXPECT_LE(SignalDataPacket::encodedSize(max, TSI::UTC, TSF::RealTime, true, format), MAX_PACKET_SIZE_BYTES);
+      EXPECT_LE(SignalDataPacket::encodedSize(max - 1, TSI::UTC, TSF::RealTime, true, format), MAX_PACKET_SIZE_BYTES);
+      EXPECT_GT(SignalDataPacket::encodedSize(max - 1, TSI::UTC, TSF::RealTime, true, format), 0u);
+      EXPECT_EQ(SignalDataPacket::encodedSize(max + 1, TSI::UTC, TSF::RealTime, true, format), 0u);
+   }
+}
+
 // ============================================================================
 // Round-Trip
 // ============================================================================
@@ -4,9 +4,12 @@
  */
 
 #include <gtest/gtest.h>
+#include "SignalDataPacket.h"
 #include "Vita49Codec.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 using namespace Vita49_2;
 
@@ -163,6 +166,48 @@ TEST(Vita49CodecTest, ParseStream_MixedPacketTypes)
    ASSERT_EQ(parsed[1].samples.size(), 2u);
 }
 
+TEST(Vita49CodecTest, ParseStream_LayoutChangesMidStream)
+{
+   Vita49Codec codec;
+   ContextFields fields;
+   fields.sampleRate = 48000.0;
+
+   // Plain, plain, timestamped, context, timestamped with trailer, plain
+   std::vector<std::vector<uint8_t>> packets;
+   packets.push_back(codec.encodeSignalData(0x1, {{0.5f, 0.0f}}, 0));
+   packets.push_back(codec.encodeSignalData(0x1, {{0.25f, 0.0f}}, 1));
+   packets.push_back(codec.encodeSignalData(0x1, {{0.125f, 0.0f}}, 2, TSI::UTC, TSF::SampleCount, 7, 8));
+   packets.push_back(codec.encodeContext(0x1, fields));
+   packets.push_back(codec.encodeSignalData(0x1, {{-0.5f, 0.0f}}, 3, TSI::UTC, TSF::SampleCount, 9, 10, true));
+   packets.push_back(codec.encodeSignalData(0x1, {{-0.25f, 0.0f}}, 4));
+
+   std::vector<uint8_t> stream;
+   for (const auto& packet : packets)
+   {
+      stream.insert(stream.end(), packet.begin(), packet.end());
+   }
+
+   const auto parsed = codec.parseStream(stream.data(), stream.size());
+
+   ASSERT_EQ(parsed.size(), 6u);
+   const float expected[] = {0.5f, 0.25f, 0.125f, 0.0f, -0.5f, -0.25f};
+   for (size_t i = 0; i < parsed.size(); ++i)
+   {
+      if (i == 3)
+      {
+         EXPECT_EQ(parsed[i].type, ParsedPacket::Type::Context);
+         continue;
+      }
+      ASSERT_EQ(parsed[i].samples.size(), 1u);
+      EXPECT_NEAR(parsed[i].samples[0].real(), expected[i], TOLERANCE);
+   }
+   EXPECT_FALSE(parsed[1].header.integerTimestamp.has_value());
+   EXPECT_EQ(parsed[2].header.integerTimestamp, 7u);
+   EXPECT_EQ(parsed[4].header.fractionalTimestamp, 10u);
+   EXPECT_TRUE(parsed[4].header.trailerPresent);
+   EXPECT_EQ(parsed[5].header.tsfType, TSF::None);
+}
+
 TEST(Vita49CodecTest, ParseStream_EmptyBuffer)
 {
    Vita49Codec codec;
@@ -212,6 +257,158 @@ TEST(Vita49CodecTest, EncodeSignalData_EmptySamples)
    EXPECT_TRUE(parsed[0].samples.empty());
 }
 
+TEST(Vita49CodecTest, EncodeSignalData_SplitsLargeVector)
+{
+   Vita49Codec codec;
+   const size_t perPacket = SignalDataPacket::maxSamplesPerPacket();
+   IQSamples samples(perPacket + 10, IQSample{0.25f, -0.25f});
+
+   auto encoded = codec.encodeSignalData(0x1, samples, 15);
+   auto parsed  = codec.parseStream(encoded.data(), encoded.size());
+
+   ASSERT_EQ(parsed.size(), 2u);
+   EXPECT_EQ(parsed[0].samples.size(), perPacket);
+   EXPECT_EQ(parsed[1].samples.size(), 10u);
+   EXPECT_EQ(parsed[0].header.packetCount, 15u);
+   EXPECT_EQ(parsed[1].header.packetCount, 0u);
+}
+
+// ============================================================================
+// packetizeSignalData
+// ============================================================================
+
+namespace
+{
+
+IQSamples makeRamp(size_t count)
+{
+   IQSamples samples(count);
+   for (size_t i = 0; i < count; ++i)
+   {
+      const float v = static_cast<float>(i % 128) / 256.0f;
+      samples[i] = {v, -v};
+   }
+   return samples;
+}
+
+} // anonymous namespace
+
+TEST(Vita49CodecTest, Packetize_SplitsWithCountsAndSampleCountTimestamps)
+{
+   Vita49Codec codec;
+   SignalDataStream stream;
+   stream.streamId            = 0x77;
+   stream.packetCount         = 14;
+   stream.tsiType             = TSI::UTC;
+   stream.tsfType             = TSF::SampleCount;
+   stream.intTimestamp        = 500;
+   stream.fracTimestamp       = 1000;
+   stream.maxSamplesPerPacket = 1000;
+   const IQSamples samples = makeRamp(4500);
+
+   std::vector<uint8_t> buffer(codec.packetizedSize(stream, samples.size()));
+   const size_t written = codec.packetizeSignalData(stream, samples, std::span<uint8_t>(buffer));
+
+   ASSERT_EQ(written, buffer.size());
+   const auto parsed = codec.parseStream(buffer.data(), buffer.size());
+   ASSERT_EQ(parsed.size(), 5u);
+   for (size_t i = 0; i < parsed.size(); ++i)
+   {
+      EXPECT_EQ(parsed[i].header.streamId, 0x77u);
+      EXPECT_EQ(parsed[i].header.packetCount, (14 + i) & 0xF);
+      EXPECT_EQ(parsed[i].header.integerTimestamp, 500u);
+      EXPECT_EQ(parsed[i].header.fractionalTimestamp, 1000 + (i * 1000));
+      EXPECT_EQ(parsed[i].samples.size(), (i < 4) ? 1000u : 500u);
+   }
+
+   // The stream now describes the packet after the last one
+   EXPECT_EQ(stream.packetCount, 3u);
+   EXPECT_EQ(stream.fracTimestamp, 5500u);
+}
+
+TEST(Vita49CodecTest, Packetize_RealTimeCarriesIntoSeconds)
+{
+   Vita49Codec codec;
+   SignalDataStream stream;
+   stream.tsiType             = TSI::GPS;
+   stream.tsfType             = TSF::RealTime;
+   stream.intTimestamp        = 10;
+   stream.fracTimestamp       = 999'000'000'000ULL;   // 1 ms before the second
+   stream.sampleRateHz        = 1.0e6;
+   stream.maxSamplesPerPacket = 1000;                 // 1 ms per packet
+
+   std::vector<uint8_t> buffer;
+   codec.packetizeSignalData(stream, makeRamp(2500), buffer);
+
+   const auto parsed = codec.parseStream(buffer.data(), buffer.size());
+   ASSERT_EQ(parsed.size(), 3u);
+   EXPECT_EQ(parsed[0].header.integerTimestamp, 10u);
+   EXPECT_EQ(parsed[0].header.fractionalTimestamp, 999'000'000'000ULL);
+   EXPECT_EQ(parsed[1].header.integerTimestamp, 11u);
+   EXPECT_EQ(parsed[1].header.fractionalTimestamp, 0u);
+   EXPECT_EQ(parsed[2].header.integerTimestamp, 11u);
+   EXPECT_EQ(parsed[2].header.fractionalTimestamp, 1'000'000'000ULL);
+   EXPECT_EQ(stream.intTimestamp, 11u);
+   EXPECT_EQ(stream.fracTimestamp, 1'500'000'000ULL);
+}
+
+TEST(Vita49CodecTest, Packetize_BlocksMatchOneCall)
+{
+   Vita49Codec codec;
+   SignalDataStream whole;
+   whole.tsiType             = TSI::UTC;
+   whole.tsfType             = TSF::RealTime;
+   whole.sampleRateHz        = 2.4e6;
+   whole.maxSamplesPerPacket = 600;
+   SignalDataStream blocks = whole;
+   const IQSamples samples = makeRamp(6000);
+
+   std::vector<uint8_t> expected;
+   codec.packetizeSignalData(whole, samples, expected);
+
+   std::vector<uint8_t> actual;
+   const std::span<const IQSample> all(samples);
+   for (size_t first = 0; first < all.size(); first += 1800)
+   {
+      codec.packetizeSignalData(blocks, all.subspan(first, std::min<size_t>(1800, all.size() - first)),
+                                actual);
+   }
+
+   EXPECT_EQ(actual, expected);
+   EXPECT_EQ(blocks.packetCount, whole.packetCount);
+   EXPECT_EQ(blocks.fracTimestamp, whole.fracTimestamp);
+}
+
+TEST(Vita49CodecTest, Packetize_MatchesEncodeSignalDataWithoutTimestamps)
+{
+   Vita49Codec codec(ByteOrder::LittleEndian);
+   const IQSamples samples = makeRamp(SignalDataPacket::maxSamplesPerPacket() * 2 + 7);
+   SignalDataStream stream;
+   stream.streamId    = 0x9;
+   stream.packetCount = 3;
+
+   std::vector<uint8_t> packed;
+   codec.packetizeSignalData(stream, samples, packed);
+
+   EXPECT_EQ(packed, codec.encodeSignalData(0x9, samples, 3));
+   EXPECT_EQ(stream.packetCount, 6u);
+}
+
+TEST(Vita49CodecTest, Packetize_BufferTooSmall_WritesNothing)
+{
+   Vita49Codec codec;
+   SignalDataStream stream;
+   stream.maxSamplesPerPacket = 100;
+   const IQSamples samples = makeRamp(250);
+
+   std::vector<uint8_t> buffer(codec.packetizedSize(stream, samples.size()) - 1, 0xEE);
+
+   EXPECT_EQ(codec.packetizeSignalData(stream, samples, std::span<uint8_t>(buffer)), 0u);
+   EXPECT_EQ(stream.packetCount, 0u);
+   EXPECT_TRUE(std::all_of(buffer.begin(), buffer.end(), [](uint8_t b) { return b == 0xEE; }));
+   EXPECT_EQ(codec.packetizedSize(stream, 0), 0u);
+}
+
 // ============================================================================
 // encodeContext
 // ============================================================================
@@ -391,6 +588,59 @@ TEST(Vita49CodecTest, ParseStream_LargeNumberOfSamples)
    }
 }
 
+TEST(Vita49CodecTest, PayloadFormat_EncodesAndDecodesInCodecFormat)
+{
+   Vita49Codec codec;
+   EXPECT_EQ(codec.payloadFormat(), PayloadFormat::Int16);
+   codec.setPayloadFormat(PayloadFormat::Int8);
+
+   IQSamples samples(301);
+   for (size_t i = 0; i < samples.size(); ++i)
+   {
+      samples[i] = {static_cast<float>(i) / 400.0f, -0.5f};
+   }
+   const auto encoded = codec.encodeSignalData(0x1, samples);
+   EXPECT_EQ(encoded.size(), 16 + (2 * samples.size()) + 2);   // Half the bytes of Int16
+
+   const auto parsed = codec.parseStream(encoded.data(), encoded.size());
+   ASSERT_EQ(parsed.size(), 1u);
+   ASSERT_EQ(parsed[0].samples.size(), samples.size());
+   for (size_t i = 0; i < samples.size(); ++i)
+   {
+      EXPECT_NEAR(parsed[0].samples[i].real(), samples[i].real(), 1.0f / 256.0f);
+      EXPECT_NEAR(parsed[0].samples[i].imag(), samples[i].imag(), 1.0f / 256.0f);
+   }
+}
+
+TEST(Vita49CodecTest, ParseStream_FollowsAnnouncedPayloadFormat)
+{
+   Vita49Codec packed;
+   packed.setPayloadFormat(PayloadFormat::Int12Packed);
+   const Vita49Codec plain;
+
+   // Stream 1 announces 12-bit samples; stream 2 stays 16-bit
+   ContextFields fields;
+   fields.payloadFormat = PayloadFormat::Int12Packed;
+   std::vector<uint8_t> stream = plain.encodeContext(0x1, fields);
+   const auto first  = packed.encodeSignalData(0x1, IQSamples(9, IQSample{0.5f, -0.25f}));
+   const auto second = plain.encodeSignalData(0x2, IQSamples(4, IQSample{-0.5f, 0.25f}));
+   stream.insert(stream.end(), first.begin(), first.end());
+   stream.insert(stream.end(), second.begin(), second.end());
+
+   const auto parsed = plain.parseStream(stream.data(), stream.size());
+   ASSERT_EQ(parsed.size(), 3u);
+   EXPECT_EQ(parsed[0].contextFields.payloadFormat, PayloadFormat::Int12Packed);
+   ASSERT_EQ(parsed[1].samples.size(), 9u);
+   EXPECT_EQ(parsed[1].samples[8], IQSample(0.5f, -0.25f));
+   ASSERT_EQ(parsed[2].samples.size(), 4u);
+   EXPECT_EQ(parsed[2].samples[3], IQSample(-0.5f, 0.25f));
+
+   // Without the context packet, the codec's own format applies
+   const auto alone = packed.parseStream(first.data(), first.size());
+   ASSERT_EQ(alone.size(), 1u);
+   EXPECT_EQ(alone[0].samples.size(), 9u);
+}
+
 TEST(Vita49CodecTest, ParseStream_MultipleContextPackets)
 {
    Vita49Codec codec;
@@ -0,0 +1,324 @@
+/**
+ * @file Vita49FileReaderUt.cpp
+ * @brief Unit tests for Vita49_2::Vita49FileReader (memory-mapped recordings).
+ */
+
+#include <gtest/gtest.h>
+#include "Vita49Codec.h"
+#include "Vita49FileReader.h"
+#include "Vita49TestData.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Vita49_2;
+using namespace Vita49_2::TestData;
+
+namespace
+{
+
+constexpr uint32_t STREAM_A = 0x10;
+constexpr uint32_t STREAM_B = 0x20;
+constexpr double SAMPLE_RATE = 1.0e6;
+constexpr size_t SAMPLES_PER_PACKET = 1000;   // 1 ms at SAMPLE_RATE
+
+// A context packet, then 1 ms packets of two interleaved streams starting
+// at 100 s: A at 100.000, B at 100.000, A at 100.001, B at 100.001, ...
+std::vector<uint8_t> makeRecording(const Vita49Codec& codec, size_t packetsPerStream)
+{
+   ContextFields fields;
+   fields.sampleRate = SAMPLE_RATE;
+   std::vector<uint8_t> bytes = codec.encodeContext(STREAM_A, fields);
+
+   SignalDataStream a;
+   a.streamId            = STREAM_A;
+   a.tsiType             = TSI::UTC;
+   a.tsfType             = TSF::RealTime;
+   a.intTimestamp        = 100;
+   a.sampleRateHz        = SAMPLE_RATE;
+   a.maxSamplesPerPacket = SAMPLES_PER_PACKET;
+   SignalDataStream b = a;
+   b.streamId = STREAM_B;
+
+   const IQSamples packet = makeRamp(SAMPLES_PER_PACKET);
+   for (size_t i = 0; i < packetsPerStream; ++i)
+   {
+      codec.packetizeSignalData(a, packet, bytes);
+      codec.packetizeSignalData(b, packet, bytes);
+   }
+   return bytes;
+}
+
+class Vita49FileReaderTest : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      _path = (std::filesystem::temp_directory_path() /
+               ("v49reader_" + std::to_string(::getpid()) + ".v49")).string();
+   }
+
+   void TearDown() override
+   {
+      std::remove(_path.c_str());
+      std::remove(Vita49FileReader::sidecarPath(_path).c_str());
+   }
+
+   void writeRecording(const std::vector<uint8_t>& bytes) const
+   {
+      std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(bytes.data()),
+                 static_cast<std::streamsize>(bytes.size()));
+   }
+
+   std::string _path;
+   Vita49Codec _codec;
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// Index
+// ============================================================================
+
+TEST_F(Vita49FileReaderTest, Open_IndexesEveryPacket)
+{
+   const auto recording = makeRecording(_codec, 50);
+   writeRecording(recording);
+   Vita49FileReader reader;
+
+   ASSERT_TRUE(reader.open(_path, false)) << reader.error();
+
+   ASSERT_EQ(reader.packetCount(), 101u);
+   EXPECT_EQ(reader.indexedBytes(), recording.size());
+   EXPECT_TRUE(isContextPacket(reader.index()[0].packetType));
+   EXPECT_FALSE(reader.index()[0].hasTimestamp());
+   EXPECT_EQ(reader.index()[3].streamId, STREAM_A);
+   EXPECT_EQ(reader.index()[3].integerTimestamp, 100u);
+   EXPECT_EQ(reader.index()[3].fractionalTimestamp, 1'000'000'000u);
+   EXPECT_EQ(reader.index()[3].sampleCount, SAMPLES_PER_PACKET);
+
+   const auto packet = reader.packet(4);
+   ASSERT_TRUE(packet.has_value());
+   EXPECT_EQ(packet->header().streamId, STREAM_B);
+   EXPECT_EQ(packet->bytes().data(), reader.bytes().data() + reader.index()[4].offset);
+   EXPECT_FALSE(reader.packet(101).has_value());
+}
+
+TEST_F(Vita49FileReaderTest, Open_IndexesAnnouncedPayloadFormat)
+{
+   Vita49Codec packed;
+   packed.setPayloadFormat(PayloadFormat::Int8);
+   ContextFields fields;
+   fields.payloadFormat = PayloadFormat::Int8;
+
+   // Stream B's first packet precedes its context packet, so stays 16-bit
+   std::vector<uint8_t> recording = _codec.encodeSignalData(STREAM_B, makeRamp(10));
+   for (const auto& packet : {_codec.encodeContext(STREAM_B, fields),
+                              packed.encodeSignalData(STREAM_B, makeRamp(33)),
+                              _codec.encodeSignalData(STREAM_A, makeRamp(20))})
+   {
+      recording.insert(recording.end(), packet.begin(), packet.end());
+   }
+   writeRecording(recording);
+
+   for (const bool reopen : {false, true})
+   {
+      Vita49FileReader reader;
+      ASSERT_TRUE(reader.open(_path)) << reader.error();
+      EXPECT_EQ(reader.indexFromSidecar(), reopen);
+      ASSERT_EQ(reader.packetCount(), 4u);
+      EXPECT_EQ(reader.index()[0].payloadFormat(), PayloadFormat::Int16);
+      EXPECT_EQ(reader.index()[2].payloadFormat(), PayloadFormat::Int8);
+      EXPECT_EQ(reader.index()[3].payloadFormat(), PayloadFormat::Int16);
+      EXPECT_EQ(reader.sampleCount(0, 4), 63u);
+
+      IQSamples out(63);
+      ASSERT_EQ(reader.decodeSamples(0, 4, out), 63u);
+      EXPECT_NEAR(out[10 + 32].real(), makeRamp(33)[32].real(), 1.0f / 256.0f);
+      EXPECT_EQ(reader.packet(2)->sampleCount(), 33u);
+   }
+}
+
+TEST_F(Vita49FileReaderTest, Open_MissingOrEmptyFile_Fails)
+{
+   Vita49FileReader reader;
+   EXPECT_FALSE(reader.open(_path));
+   EXPECT_FALSE(reader.error().empty());
+
+   writeRecording({});
+   EXPECT_FALSE(reader.open(_path));
+   EXPECT_FALSE(reader.isOpen());
+}
+
+TEST_F(Vita49FileReaderTest, Open_TruncatedTail_IndexesWholePackets)
+{
+   auto recording = makeRecording(_codec, 5);
+   const size_t whole = recording.size();
+   recording.resize(whole - 100);
+   writeRecording(recording);
+   Vita49FileReader reader;
+
+   ASSERT_TRUE(reader.open(_path, false));
+
+   EXPECT_EQ(reader.packetCount(), 10u);
+   EXPECT_LT(reader.indexedBytes(), recording.size());
+}
+
+// ============================================================================
+// Sidecar
+// ============================================================================
+
+TEST_F(Vita49FileReaderTest, Sidecar_WrittenThenReused)
+{
+   writeRecording(makeRecording(_codec, 20));
+
+   Vita49FileReader first;
+   ASSERT_TRUE(first.open(_path));
+   EXPECT_FALSE(first.indexFromSidecar());
+   EXPECT_TRUE(std::filesystem::exists(Vita49FileReader::sidecarPath(_path)));
+
+   Vita49FileReader second;
+   ASSERT_TRUE(second.open(_path));
+   EXPECT_TRUE(second.indexFromSidecar());
+   ASSERT_EQ(second.packetCount(), first.packetCount());
+   for (size_t i = 0; i < first.packetCount(); ++i)
+   {
+      EXPECT_EQ(second.index()[i].offset, first.index()[i].offset);
+      EXPECT_EQ(second.index()[i].fractionalTimestamp, first.index()[i].fractionalTimestamp);
+   }
+}
+
+TEST_F(Vita49FileReaderTest, Sidecar_StaleAfterRewrite_Rebuilt)
+{
+   writeRecording(makeRecording(_codec, 20));
+   {
+      Vita49FileReader reader;
+      ASSERT_TRUE(reader.open(_path));
+   }
+
+   writeRecording(makeRecording(_codec, 30));
+   Vita49FileReader reader;
+   ASSERT_TRUE(reader.open(_path));
+
+   EXPECT_FALSE(reader.indexFromSidecar());
+   EXPECT_EQ(reader.packetCount(), 61u);
+}
+
+// ============================================================================
+// Seeking and sequential reading
+// ============================================================================
+
+TEST_F(Vita49FileReaderTest, FindTime_BinarySearchesTimestamps)
+{
+   writeRecording(makeRecording(_codec, 200));
+   Vita49FileReader reader;
+   ASSERT_TRUE(reader.open(_path, false));
+
+   // The first packets at or after 100.0505 s are stamped 100.051
+   const size_t at = reader.findTime(100, 50'500'000'000ULL);
+   ASSERT_LT(at, reader.packetCount());
+   EXPECT_EQ(reader.index()[at].fractionalTimestamp, 51'000'000'000ULL);
+   EXPECT_EQ(reader.index()[at].streamId, STREAM_A);
+
+   const size_t b = reader.findTime(100, 50'500'000'000ULL, STREAM_B);
+   EXPECT_EQ(b, at + 1);
+   EXPECT_EQ(reader.findTime(0, 0), 1u);                 // First timestamped packet
+   EXPECT_EQ(reader.findTime(101, 0), reader.packetCount());
+   EXPECT_EQ(reader.findTime(0, 0, 0x99), reader.packetCount());
+}
+
+TEST_F(Vita49FileReaderTest, NextAndSeekToTime_IterateFromPosition)
+{
+   writeRecording(makeRecording(_codec, 100));
+   Vita49FileReader reader;
+   ASSERT_TRUE(reader.open(_path, false));
+
+   size_t packets = 0;
+   while (reader.next().has_value())
+   {
+      ++packets;
+   }
+   EXPECT_EQ(packets, reader.packetCount());
+
+   ASSERT_TRUE(reader.seekToTime(100, 90'000'000'000ULL, STREAM_B));
+   std::vector<uint64_t> stamps;
+   while (const auto packet = reader.next())
+   {
+      if (packet->header().streamId == STREAM_B)
+      {
+         stamps.push_back(packet->header().fractionalTimestamp.value_or(0));
+      }
+   }
+   ASSERT_EQ(stamps.size(), 10u);
+   EXPECT_EQ(stamps.front(), 90'000'000'000ULL);
+   EXPECT_EQ(stamps.back(), 99'000'000'000ULL);
+
+   EXPECT_FALSE(reader.seekToTime(200, 0));
+   reader.seek(5);
+   EXPECT_EQ(reader.tell(), 5u);
+}
+
+// ============================================================================
+// Bulk decoding
+// ============================================================================
+
+TEST_F(Vita49FileReaderTest, DecodeSamples_ParallelMatchesPacketByPacket)
+{
+   writeRecording(makeRecording(_codec, 100));
+   Vita49FileReader reader;
+   ASSERT_TRUE(reader.open(_path, false));
+
+   IQSamples expected;
+   while (const auto packet = reader.next())
+   {
+      IQSamples samples(packet->sampleCount());
+      packet->decodeSamples(samples);
+      expected.insert(expected.end(), samples.begin(), samples.end());
+   }
+   ASSERT_EQ(reader.sampleCount(0, reader.packetCount()), expected.size());
+
+   // Every task on its own thread, so overlapping writes would show up
+   size_t tasks = 0;
+   const Vita49FileReader::ParallelFor threaded =
+      [&tasks](size_t count, const std::function<void(size_t)>& task)
+   {
+      tasks = count;
+      std::vector<std::thread> threads;
+      for (size_t i = count; i-- > 0;)
+      {
+         threads.emplace_back(task, i);
+      }
+      for (auto& thread : threads)
+      {
+         thread.join();
+      }
+   };
+   IQSamples parallel(expected.size());
+   EXPECT_EQ(reader.decodeSamples(0, reader.packetCount(), parallel, DEFAULT_SCALE_FACTOR,
+                                  threaded), expected.size());
+   EXPECT_GT(tasks, 1u);
+   EXPECT_EQ(parallel, expected);
+
+   // A sub-range starting past the context packet
+   IQSamples tail(reader.sampleCount(51, 1000));
+   EXPECT_EQ(reader.decodeSamples(51, 1000, tail), 150 * SAMPLES_PER_PACKET);
+   EXPECT_TRUE(std::equal(tail.begin(), tail.end(), expected.begin() + 50 * SAMPLES_PER_PACKET));
+}
+
+TEST_F(Vita49FileReaderTest, DecodeSamples_OutputTooSmall_WritesNothing)
+{
+   writeRecording(makeRecording(_codec, 5));
+   Vita49FileReader reader;
+   ASSERT_TRUE(reader.open(_path, false));
+
+   IQSamples out(reader.sampleCount(0, reader.packetCount()) - 1, IQSample{7.0f, 7.0f});
+   EXPECT_EQ(reader.decodeSamples(0, reader.packetCount(), out), 0u);
+   EXPECT_EQ(out.front(), (IQSample{7.0f, 7.0f}));
+}
@@ -0,0 +1,188 @@
+/**
+ * @file Vita49StreamParserUt.cpp
+ * @brief Unit tests for Vita49_2::Vita49StreamParser (incremental stream parsing).
+ */
+
+#include <gtest/gtest.h>
+#include "Vita49Codec.h"
+#include "Vita49StreamParser.h"
+#include "Vita49TestData.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Vita49_2;
+using namespace Vita49_2::TestData;
+
+namespace
+{
+
+// Collects a copy of every delivered packet.
+struct Collector
+{
+   std::vector<std::vector<uint8_t>> packets;
+   std::vector<uint32_t> streamIds;
+
+   Vita49StreamParser::PacketCallback callback()
+   {
+      return [this](const PacketView& packet)
+      {
+         packets.emplace_back(packet.bytes().begin(), packet.bytes().end());
+         streamIds.push_back(packet.header().streamId.value_or(0));
+      };
+   }
+};
+
+std::vector<std::vector<uint8_t>> expectedPackets(const Vita49Codec& codec,
+                                                   const std::vector<uint8_t>& stream)
+{
+   std::vector<std::vector<uint8_t>> packets;
+   for (const PacketView& packet : codec.viewStream(stream.data(), stream.size()))
+   {
+      packets.emplace_back(packet.bytes().begin(), packet.bytes().end());
+   }
+   return packets;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Chunking
+// ============================================================================
+
+TEST(Vita49StreamParserTest, WholeBuffer_ViewsPacketsInPlace)
+{
+   Vita49Codec codec;
+   const auto stream = makeMixedStream(codec);
+   std::vector<const uint8_t*> starts;
+   Vita49StreamParser parser([&](const PacketView& packet) { starts.push_back(packet.bytes().data()); });
+
+   EXPECT_EQ(parser.feed(stream), 6u);
+
+   ASSERT_EQ(starts.size(), 6u);
+   EXPECT_EQ(starts.front(), stream.data());
+   EXPECT_EQ(parser.pendingBytes(), 0u);
+   EXPECT_EQ(parser.discardedBytes(), 0u);
+}
+
+TEST(Vita49StreamParserTest, ByteAtATime_DeliversEveryPacket)
+{
+   Vita49Codec codec;
+   const auto stream = makeMixedStream(codec);
+   Collector collector;
+   Vita49StreamParser parser(collector.callback());
+
+   for (const uint8_t byte : stream)
+   {
+      parser.feed({&byte, 1});
+   }
+
+   EXPECT_EQ(collector.packets, expectedPackets(codec, stream));
+   EXPECT_EQ(collector.streamIds, (std::vector<uint32_t>{1, 2, 3, 4, 5, 6}));
+   EXPECT_EQ(parser.packets(), 6u);
+   EXPECT_EQ(parser.pendingBytes(), 0u);
+}
+
+TEST(Vita49StreamParserTest, RandomChunks_MatchParseStream)
+{
+   Vita49Codec codec(ByteOrder::LittleEndian);
+   std::vector<uint8_t> stream;
+   for (int i = 0; i < 20; ++i)
+   {
+      const auto more = makeMixedStream(codec);
+      stream.insert(stream.end(), more.begin(), more.end());
+   }
+   Collector collector;
+   Vita49StreamParser parser(collector.callback(), ByteOrder::LittleEndian);
+
+   std::mt19937 rng(7);
+   std::uniform_int_distribution<size_t> chunkSize(1, 1500);
+   for (size_t offset = 0; offset < stream.size();)
+   {
+      const size_t n = std::min(chunkSize(rng), stream.size() - offset);
+      parser.feed({stream.data() + offset, n});
+      offset += n;
+   }
+
+   EXPECT_EQ(collector.packets, expectedPackets(codec, stream));
+   EXPECT_EQ(collector.packets.size(), 120u);
+}
+
+TEST(Vita49StreamParserTest, PartialPacket_HeldUntilCompleted)
+{
+   Vita49Codec codec;
+   const auto packet = codec.encodeSignalData(0x5, makeRamp(64));
+   Collector collector;
+   Vita49StreamParser parser(collector.callback());
+
+   EXPECT_EQ(parser.feed({packet.data(), 10}), 0u);
+   EXPECT_EQ(parser.pendingBytes(), 10u);
+   EXPECT_EQ(parser.feed({packet.data() + 10, packet.size() - 10}), 1u);
+
+   ASSERT_EQ(collector.packets.size(), 1u);
+   EXPECT_EQ(collector.packets[0], packet);
+   EXPECT_EQ(parser.pendingBytes(), 0u);
+}
+
+TEST(Vita49StreamParserTest, Reset_DropsPartialPacket)
+{
+   Vita49Codec codec;
+   const auto packet = codec.encodeSignalData(0x5, makeRamp(64));
+   Collector collector;
+   Vita49StreamParser parser(collector.callback());
+
+   parser.feed({packet.data(), packet.size() / 2});
+   parser.reset();
+   parser.feed(packet);
+
+   ASSERT_EQ(collector.packets.size(), 1u);
+   EXPECT_EQ(collector.packets[0], packet);
+}
+
+// ============================================================================
+// Resynchronisation
+// ============================================================================
+
+TEST(Vita49StreamParserTest, Garbage_SkippedAndRealigned)
+{
+   Vita49Codec codec;
+   const auto first  = codec.encodeSignalData(0x1, makeRamp(20));
+   const auto second = codec.encodeSignalData(0x2, makeRamp(30));
+
+   // Seven bytes of reserved-type garbage leave the second packet misaligned
+   std::vector<uint8_t> stream(first);
+   stream.insert(stream.end(), 7, 0xFF);
+   stream.insert(stream.end(), second.begin(), second.end());
+
+   for (const size_t chunk : {stream.size(), size_t{3}})
+   {
+      Collector collector;
+      Vita49StreamParser parser(collector.callback());
+      for (size_t offset = 0; offset < stream.size(); offset += chunk)
+      {
+         parser.feed({stream.data() + offset, std::min(chunk, stream.size() - offset)});
+      }
+
+      EXPECT_EQ(collector.packets, (std::vector<std::vector<uint8_t>>{first, second}));
+      EXPECT_EQ(parser.discardedBytes(), 7u);
+   }
+}
+
+TEST(Vita49StreamParserTest, ImpossibleHeader_Rejected)
+{
+   Vita49Codec codec;
+   Collector collector;
+   Vita49StreamParser parser(collector.callback(), ByteOrder::BigEndian, 1024);
+
+   // Data packet announcing stream ID, class ID, both timestamps and a trailer in 3 words
+   const std::vector<uint8_t> tooShort = {0x1C, 0xD0, 0x00, 0x03, 0, 0, 0, 0, 0, 0, 0, 0};
+   // Valid layout, but larger than the configured limit
+   const auto tooLarge = codec.encodeSignalData(0x9, makeRamp(512));
+
+   parser.feed(tooShort);
+   parser.feed({tooLarge.data(), 4});
+
+   EXPECT_TRUE(collector.packets.empty());
+   EXPECT_GT(parser.discardedBytes(), 0u);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file Vita49TestData.h
+ * @brief Sample and packet-stream fixtures shared by the Vita49_2 unit tests.
+ */
+
+#ifndef VITA49_2_TESTS_VITA49TESTDATA_H
+#define VITA49_2_TESTS_VITA49TESTDATA_H
+
+#include "Vita49Codec.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Vita49_2::TestData
+{
+
+/**
+ * @brief I/Q ramp: I steps 0, 0.005, ... 0.495 and repeats every 100
+ *        samples; Q is -I.
+ * @param count Samples
+ */
+inline IQSamples makeRamp(size_t count)
+{
+   IQSamples samples(count);
+   for (size_t i = 0; i < count; ++i)
+   {
+      const float v = static_cast<float>(i % 100) / 200.0f;
+      samples[i] = {v, -v};
+   }
+   return samples;
+}
+
+/**
+ * @brief Signal and context packets of assorted sizes, back to back.
+ *
+ * Packet n (1-based) has stream ID n.  Every third packet is a context
+ * packet with a sample rate of n MHz; the others are signal data packets
+ * of `n * 37` ramp samples with a UTC timestamp of n s and a trailer.
+ *
+ * @param codec Encoder
+ * @param count Packets
+ */
+inline std::vector<uint8_t> makeMixedStream(const Vita49Codec& codec, uint32_t count = 6)
+{
+   std::vector<uint8_t> stream;
+   for (uint32_t id = 1; id <= count; ++id)
+   {
+      ContextFields fields;
+      fields.sampleRate = 1.0e6 * id;
+      const auto packet = (id % 3 == 0)
+         ? codec.encodeContext(id, fields)
+         : codec.encodeSignalData(id, makeRamp(id * 37), 0, TSI::UTC, TSF::RealTime, id, 0, true);
+      stream.insert(stream.end(), packet.begin(), packet.end());
+   }
+   return stream;
+}
+
+} // namespace Vita49_2::TestData
+
+#endif // VITA49_2_TESTS_VITA49TESTDATA_H